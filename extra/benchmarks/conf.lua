@@ -0,0 +1,11 @@
+function love.conf(t)
+	t.identity = "love-benchmarks"
+	t.window.title = "LOVE benchmark scenes"
+	t.window.width = 1280
+	t.window.height = 720
+	-- Frame pacing would hide differences between renderers.
+	t.window.vsync = 0
+	t.modules.audio = false
+	t.modules.sound = false
+	t.modules.video = false
+end
@@ -0,0 +1,74 @@
+-- Standard stress scenes, for comparing renderers and catching regressions.
+--
+--   love extra/benchmarks <scene> [options...]
+--   love extra/benchmarks <scene> --bench 600 --benchoutput results.json
+--   love extra/benchmarks <scene> --renderers vulkan --bench 600
+--
+-- Scene options are scene-specific words, for example "sprites instanced" or
+-- "particles gpu". Without --bench the scene runs until closed and shows the
+-- frame rate and draw call count.
+
+local scenenames = {
+	"sprites",
+	"shapes",
+	"text",
+	"canvases",
+	"particles",
+	"physics",
+}
+
+local scene
+
+local function usage()
+	return "Usage: love extra/benchmarks <scene> [options...]\nScenes: " .. table.concat(scenenames, ", ")
+end
+
+function love.load(args)
+	local name = args[1]
+	if not name then
+		error(usage(), 0)
+	end
+
+	local found = false
+	for i,v in ipairs(scenenames) do
+		if v == name then found = true end
+	end
+	if not found then
+		error("Unknown scene '" .. name .. "'.\n" .. usage(), 0)
+	end
+
+	local options = {}
+	for i=2, #args do
+		options[args[i]] = true
+	end
+
+	-- Scenes only use love.math's generator, so every run (and every
+	-- renderer) draws the same thing.
+	love.math.setRandomSeed(0)
+
+	scene = require("scenes." .. name)
+	scene.load(options)
+
+	love.window.setTitle("LOVE benchmark scenes: " .. name)
+end
+
+function love.update(dt)
+	if scene.update then scene.update(dt) end
+end
+
+function love.draw()
+	scene.draw()
+
+	local stats = love.graphics.getStats()
+	love.graphics.origin()
+	love.graphics.setColor(0, 0, 0, 0.75)
+	love.graphics.rectangle("fill", 0, 0, 220, 40)
+	love.graphics.setColor(1, 1, 1, 1)
+	love.graphics.print(string.format("FPS: %d\nDraw calls: %d", love.timer.getFPS(), stats.drawcalls), 4, 4)
+end
+
+function love.keypressed(key)
+	if key == "escape" then
+		love.event.quit()
+	end
+end
@@ -0,0 +1,83 @@
+-- Many small canvases, each drawn into, blurred with a two pass shader and
+-- composited onto the screen every frame. This measures render target
+-- switches and fill rate.
+
+local scene = {}
+
+local CANVAS_COUNT = 64
+local CANVAS_SIZE = 256
+local SHAPES_PER_CANVAS = 50
+
+local canvases = {}
+local scratch
+local blur
+local time = 0
+
+local blurcode = [[
+uniform vec2 direction;
+
+vec4 effect(vec4 color, Image tex, vec2 texcoord, vec2 screencoord)
+{
+	vec4 sum = Texel(tex, texcoord) * 0.227027;
+	sum += Texel(tex, texcoord + direction * 1.384615) * 0.316216;
+	sum += Texel(tex, texcoord - direction * 1.384615) * 0.316216;
+	sum += Texel(tex, texcoord + direction * 3.230769) * 0.070270;
+	sum += Texel(tex, texcoord - direction * 3.230769) * 0.070270;
+	return sum * color;
+}
+]]
+
+function scene.load(options)
+	for i=1, CANVAS_COUNT do
+		canvases[i] = love.graphics.newCanvas(CANVAS_SIZE, CANVAS_SIZE)
+	end
+	scratch = love.graphics.newCanvas(CANVAS_SIZE, CANVAS_SIZE)
+	blur = love.graphics.newShader(blurcode)
+end
+
+function scene.update(dt)
+	time = time + dt
+end
+
+function scene.draw()
+	local lg = love.graphics
+	local sin, cos = math.sin, math.cos
+
+	for i, canvas in ipairs(canvases) do
+		lg.setCanvas(canvas)
+		lg.clear(0, 0, 0, 0)
+		for j=1, SHAPES_PER_CANVAS do
+			local a = time + i * 0.1 + j * 0.7
+			lg.setColor((i % 4) / 3, (j % 5) / 4, 0.5 + 0.5 * sin(a), 1)
+			lg.circle("fill", CANVAS_SIZE * (0.5 + 0.4 * cos(a)), CANVAS_SIZE * (0.5 + 0.4 * sin(a * 1.3)), 8 + (j % 7) * 2)
+		end
+		lg.setColor(1, 1, 1, 1)
+
+		lg.setShader(blur)
+		blur:send("direction", {1 / CANVAS_SIZE, 0})
+		lg.setCanvas(scratch)
+		lg.clear(0, 0, 0, 0)
+		lg.draw(canvas)
+
+		blur:send("direction", {0, 1 / CANVAS_SIZE})
+		lg.setCanvas(canvas)
+		lg.clear(0, 0, 0, 0)
+		lg.draw(scratch)
+		lg.setShader()
+	end
+
+	lg.setCanvas()
+
+	local w, h = lg.getDimensions()
+	local columns = 16
+	local size = w / columns
+	lg.setBlendMode("add")
+	for i, canvas in ipairs(canvases) do
+		local x = ((i - 1) % columns) * size
+		local y = math.floor((i - 1) / columns) * size
+		lg.draw(canvas, x, y, 0, size / CANVAS_SIZE * 2)
+	end
+	lg.setBlendMode("alpha")
+end
+
+return scene
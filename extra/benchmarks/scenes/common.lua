@@ -0,0 +1,17 @@
+local common = {}
+
+-- A small white circle with soft edges, so the scenes don't need image files.
+function common.newBlobTexture(size)
+	size = size or 16
+	local radius = size / 2
+	local data = love.image.newImageData(size, size)
+	data:mapPixel(function(x, y)
+		local dx = x + 0.5 - radius
+		local dy = y + 0.5 - radius
+		local a = math.max(0, 1 - math.sqrt(dx*dx + dy*dy) / radius)
+		return 1, 1, 1, a
+	end)
+	return love.graphics.newTexture(data)
+end
+
+return common
@@ -0,0 +1,42 @@
+-- A single ParticleSystem kept at one million live particles.
+-- Options: "gpu" creates a GPU-simulated ParticleSystem.
+
+local common = require("scenes.common")
+
+local scene = {}
+
+local COUNT = 1000000
+local LIFETIME = 4
+
+local system
+
+function scene.load(options)
+	local texture = common.newBlobTexture(4)
+	system = love.graphics.newParticleSystem(texture, COUNT, options.gpu)
+
+	local w, h = love.graphics.getDimensions()
+	system:setPosition(w / 2, h / 2)
+	system:setEmissionArea("ellipse", w / 4, h / 4)
+	system:setParticleLifetime(LIFETIME)
+	system:setEmissionRate(COUNT / LIFETIME)
+	system:setSpeed(20, 150)
+	system:setSpread(math.pi * 2)
+	system:setLinearAcceleration(0, 20)
+	system:setSizes(1, 0.5)
+	system:setColors(1, 0.8, 0.3, 1, 0.6, 0.1, 0.6, 0)
+
+	-- Start at full load, rather than ramping up over the first lifetime.
+	system:emit(COUNT)
+end
+
+function scene.update(dt)
+	system:update(dt)
+end
+
+function scene.draw()
+	love.graphics.setBlendMode("add")
+	love.graphics.draw(system)
+	love.graphics.setBlendMode("alpha")
+end
+
+return scene
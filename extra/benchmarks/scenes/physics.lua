@@ -0,0 +1,62 @@
+-- 10k dynamic bodies settling into a pile in a box. Bodies are drawn with a
+-- SpriteBatch, so most of the frame is spent in World:update.
+
+local common = require("scenes.common")
+
+local scene = {}
+
+local COUNT = 10000
+local METER = 16
+
+local world
+local bodies = {}
+local batch
+
+function scene.load(options)
+	love.physics.setMeter(METER)
+	world = love.physics.newWorld(0, 9.81 * METER, true)
+
+	local w, h = love.graphics.getDimensions()
+
+	local walls = love.physics.newBody(world, 0, 0, "static")
+	love.physics.newFixture(walls, love.physics.newEdgeShape(0, h, w, h))
+	love.physics.newFixture(walls, love.physics.newEdgeShape(0, 0, 0, h))
+	love.physics.newFixture(walls, love.physics.newEdgeShape(w, 0, w, h))
+
+	local texture = common.newBlobTexture(8)
+	batch = love.graphics.newSpriteBatch(texture, COUNT, "stream")
+
+	local random = love.math.random
+	local columns = math.floor(w / 8) - 2
+
+	for i=1, COUNT do
+		local x = 8 + ((i - 1) % columns) * 8 + random() * 2
+		local y = h - 8 - math.floor((i - 1) / columns) * 8
+		local body = love.physics.newBody(world, x, y, "dynamic")
+		local shape
+		if i % 2 == 0 then
+			shape = love.physics.newCircleShape(3)
+		else
+			shape = love.physics.newRectangleShape(6, 6)
+		end
+		love.physics.newFixture(body, shape, 1)
+		bodies[i] = body
+		batch:add(x, y, 0, 1, 1, 4, 4)
+	end
+end
+
+function scene.update(dt)
+	world:update(dt)
+
+	for i=1, COUNT do
+		local body = bodies[i]
+		local x, y = body:getPosition()
+		batch:set(i, x, y, body:getAngle(), 1, 1, 4, 4)
+	end
+end
+
+function scene.draw()
+	love.graphics.draw(batch)
+end
+
+return scene
@@ -0,0 +1,60 @@
+-- 50k immediate-mode shapes per frame: a mix of filled and outlined
+-- rectangles, circles, polygons and lines, with a color change for each.
+-- This mostly measures automatic batching.
+
+local scene = {}
+
+local COUNT = 50000
+
+local shapes = {}
+local time = 0
+
+function scene.load(options)
+	local w, h = love.graphics.getDimensions()
+	local random = love.math.random
+
+	for i=1, COUNT do
+		shapes[i] = {
+			kind = random(1, 5),
+			x = random() * w,
+			y = random() * h,
+			size = 2 + random() * 10,
+			r = random(), g = random(), b = random(),
+			phase = random() * math.pi * 2,
+		}
+	end
+end
+
+function scene.update(dt)
+	time = time + dt
+end
+
+function scene.draw()
+	local lg = love.graphics
+	local sin = math.sin
+
+	for i=1, COUNT do
+		local s = shapes[i]
+		local x = s.x + sin(time + s.phase) * 10
+		local y = s.y
+		local size = s.size
+
+		lg.setColor(s.r, s.g, s.b, 1)
+
+		if s.kind == 1 then
+			lg.rectangle("fill", x, y, size, size)
+		elseif s.kind == 2 then
+			lg.circle("fill", x, y, size)
+		elseif s.kind == 3 then
+			lg.polygon("fill", x, y - size, x + size, y + size, x - size, y + size)
+		elseif s.kind == 4 then
+			lg.rectangle("line", x, y, size, size)
+		else
+			lg.line(x, y, x + size, y + size)
+		end
+	end
+
+	lg.setColor(1, 1, 1, 1)
+end
+
+return scene
@@ -0,0 +1,90 @@
+-- A screen-filling wall of text which changes every frame. The primary font
+-- only has digits, and the first fallback only has punctuation, so most
+-- glyphs are found in the last fallback. This measures glyph lookup through
+-- fallback fonts, shaping and wrapping as well as drawing. Fallbacks must be
+-- the same type of font as the primary one, and the only TrueType font
+-- available without files is the default one, so these are all ImageFonts.
+-- Options: "static" uses one unchanging TextBatch instead.
+
+local scene = {}
+
+local LINE_COUNT = 60
+
+local font
+local textobject
+local frame = 0
+
+local words = {
+	"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+	"elit", "sed", "do", "eiusmod", "tempor", "incididunt", "labore",
+	"magna", "aliqua", "Ünïcödé", "ÆØÅ", "ßẞ", "ŒœŸ",
+}
+
+-- ImageFonts need a row of glyphs separated by columns of a separator color.
+local function newBlockImageFont(glyphs, glyphwidth, glyphheight)
+	local count = utf8.len(glyphs)
+	local width = 1 + count * (glyphwidth + 1)
+	local data = love.image.newImageData(width, glyphheight)
+
+	data:mapPixel(function(x, y)
+		if x % (glyphwidth + 1) == 0 then
+			return 1, 0, 1, 1
+		end
+		-- A hollow box, so glyphs from this font are easy to spot.
+		local gx = x % (glyphwidth + 1)
+		if gx == 1 or gx == glyphwidth or y == 0 or y == glyphheight - 1 then
+			return 1, 1, 1, 1
+		end
+		return 0, 0, 0, 0
+	end)
+
+	return love.graphics.newImageFont(data, glyphs)
+end
+
+local function buildline(i)
+	local random = love.math.random
+	local parts = {}
+	for j=1, 12 do
+		parts[j] = words[random(1, #words)]
+	end
+	return string.format("%06d %s, %d.", frame * LINE_COUNT + i, table.concat(parts, " "), random(0, 99999))
+end
+
+function scene.load(options)
+	font = newBlockImageFont("0123456789", 6, 12)
+	local punctuation = newBlockImageFont(".,;:!?-", 3, 12)
+	local letters = newBlockImageFont("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZÜïöéÆØÅßẞŒœŸ ", 6, 12)
+	font:setFallbacks(punctuation, letters)
+
+	if options.static then
+		local lines = {}
+		for i=1, LINE_COUNT do
+			lines[i] = buildline(i)
+		end
+		textobject = love.graphics.newTextBatch(font, table.concat(lines, "\n"))
+	end
+end
+
+function scene.update(dt)
+	frame = frame + 1
+end
+
+function scene.draw()
+	if textobject then
+		love.graphics.draw(textobject, 4, 4)
+		return
+	end
+
+	local previousfont = love.graphics.getFont()
+	love.graphics.setFont(font)
+
+	local lineheight = font:getHeight()
+	local w = love.graphics.getWidth()
+	for i=1, LINE_COUNT do
+		love.graphics.printf(buildline(i), 4, 4 + (i - 1) * lineheight, w - 8)
+	end
+
+	love.graphics.setFont(previousfont)
+end
+
+return scene
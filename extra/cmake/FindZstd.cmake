@@ -0,0 +1,25 @@
+# Sets the following variables:
+#
+# ZSTD_FOUND
+# ZSTD_INCLUDE_DIR
+# ZSTD_LIBRARY
+
+set(ZSTD_SEARCH_PATHS
+	/usr/local
+	/usr
+	)
+
+find_path(ZSTD_INCLUDE_DIR
+	NAMES zstd.h
+	PATH_SUFFIXES include
+	PATHS ${ZSTD_SEARCH_PATHS})
+
+find_library(ZSTD_LIBRARY
+	NAMES zstd
+	PATH_SUFFIXES lib
+	PATHS ${ZSTD_SEARCH_PATHS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
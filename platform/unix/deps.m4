@@ -16,6 +16,11 @@ AC_DEFUN([ACLOVE_DEP_VORBISFILE], [
 AC_DEFUN([ACLOVE_DEP_ZLIB], [
 	PKG_CHECK_MODULES([zlib], [zlib], [], [LOVE_MSG_ERROR([zlib])])])
 
+# Optional, adds the zstd compression format to love.data.
+AC_DEFUN([ACLOVE_DEP_ZSTD], [
+	PKG_CHECK_MODULES([zstd], [libzstd], [AC_DEFINE([LOVE_ENABLE_ZSTD], [1], [Define if libzstd is available.])],
+		[AC_MSG_WARN([libzstd not found, the zstd compression format will not be available])])])
+
 AC_DEFUN([ACLOVE_DEP_THEORA], [
 	PKG_CHECK_MODULES([theora], [theoradec], [], [LOVE_MSG_ERROR([libtheora])])])
 
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+// C
+#include <stdio.h>
+
+namespace love
+{
+namespace benchmark
+{
+
+std::atomic<uint64> allocationCount(0);
+std::atomic<uint64> allocationBytes(0);
+
+namespace
+{
+
+struct Measurement
+{
+	uint64 ops = 0;
+	double seconds = 0.0;
+	uint64 allocations = 0;
+	uint64 allocatedBytes = 0;
+};
+
+Measurement measure(const Suite::Operation &op, uint64 ops)
+{
+	Measurement m;
+	m.ops = ops;
+
+	uint64 count = allocationCount.load();
+	uint64 bytes = allocationBytes.load();
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint64 i = 0; i < ops; i++)
+		op();
+
+	auto end = std::chrono::steady_clock::now();
+
+	m.seconds = std::chrono::duration<double>(end - start).count();
+	m.allocations = allocationCount.load() - count;
+	m.allocatedBytes = allocationBytes.load() - bytes;
+	return m;
+}
+
+} // anonymous namespace
+
+void Suite::add(const std::string &name, const Operation &op, uint64 itemsPerOp, uint64 bytesPerOp)
+{
+	benchmarks.push_back({name, op, std::max<uint64>(itemsPerOp, 1), bytesPerOp});
+}
+
+int Suite::run(const Options &options)
+{
+	int failures = 0;
+
+	printf("%-44s %10s %14s %12s %10s %10s %12s\n",
+	       "benchmark", "ops", "ns/op", "ns/item", "MB/s", "allocs/op", "bytes/op");
+
+	for (const Benchmark &b : benchmarks)
+	{
+		if (!options.filter.empty() && b.name.find(options.filter) == std::string::npos)
+			continue;
+
+		Measurement m;
+
+		try
+		{
+			// The first run fills caches and lazily created state.
+			b.op();
+
+			// Grow the number of operations until a run takes long enough to
+			// be meaningful, aiming a little past the minimum time.
+			uint64 ops = 1;
+			while (true)
+			{
+				m = measure(b.op, ops);
+				if (m.seconds >= options.minTime)
+					break;
+
+				double perop = std::max(m.seconds / (double) ops, 1e-9);
+				uint64 predicted = (uint64) (options.minTime * 1.2 / perop);
+				ops = std::max(ops * 2, std::min(predicted, ops * 100));
+			}
+		}
+		catch (Skip &e)
+		{
+			printf("%-44s skipped: %s\n", b.name.c_str(), e.what());
+			continue;
+		}
+		catch (std::exception &e)
+		{
+			printf("%-44s failed: %s\n", b.name.c_str(), e.what());
+			failures++;
+			continue;
+		}
+
+		double nsperop = m.seconds * 1e9 / (double) m.ops;
+
+		char peritem[32] = "-";
+		if (b.itemsPerOp > 1)
+			snprintf(peritem, sizeof(peritem), "%.2f", nsperop / (double) b.itemsPerOp);
+
+		char throughput[32] = "-";
+		if (b.bytesPerOp > 0)
+			snprintf(throughput, sizeof(throughput), "%.1f", (double) b.bytesPerOp * m.ops / m.seconds / (1024.0 * 1024.0));
+
+		printf("%-44s %10llu %14.1f %12s %10s %10.2f %12.1f\n",
+		       b.name.c_str(), (unsigned long long) m.ops, nsperop, peritem, throughput,
+		       (double) m.allocations / (double) m.ops, (double) m.allocatedBytes / (double) m.ops);
+		fflush(stdout);
+	}
+
+	return failures;
+}
+
+} // benchmark
+} // love
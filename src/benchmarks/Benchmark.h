@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Exception.h"
+
+// C++
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace benchmark
+{
+
+/**
+ * Counts of C++ heap allocations (operator new) made by every thread.
+ * Allocations made directly with malloc, e.g. by C libraries, aren't counted.
+ **/
+extern std::atomic<uint64> allocationCount;
+extern std::atomic<uint64> allocationBytes;
+
+/**
+ * Thrown by a benchmark which can't run in this environment, e.g. because
+ * there is no display to create a window on. It's reported but doesn't count
+ * as a failure.
+ **/
+class Skip : public love::Exception
+{
+public:
+
+	Skip(const char *reason) : love::Exception("%s", reason) {}
+
+}; // Skip
+
+/**
+ * A named set of benchmarks. Each benchmark is a function which runs one
+ * operation; the suite repeats it until enough time has passed to get a
+ * stable measurement, and reports the average time and allocations per
+ * operation.
+ **/
+class Suite
+{
+public:
+
+	typedef std::function<void()> Operation;
+
+	struct Options
+	{
+		// Only benchmarks whose name contains this are run.
+		std::string filter;
+
+		// Minimum time spent measuring each benchmark, in seconds.
+		double minTime = 0.25;
+	};
+
+	/**
+	 * Adds a benchmark.
+	 * @param name Names are grouped by prefix, e.g. "data/hash/sha256".
+	 * @param op Runs one operation.
+	 * @param itemsPerOp If more than 1, the time per item is also reported.
+	 * @param bytesPerOp If non-zero, the throughput is also reported.
+	 **/
+	void add(const std::string &name, const Operation &op, uint64 itemsPerOp = 1, uint64 bytesPerOp = 0);
+
+	/**
+	 * Runs the benchmarks and prints a line for each one.
+	 * @return The number of benchmarks which threw an exception.
+	 **/
+	int run(const Options &options);
+
+private:
+
+	struct Benchmark
+	{
+		std::string name;
+		Operation op;
+		uint64 itemsPerOp;
+		uint64 bytesPerOp;
+	};
+
+	std::vector<Benchmark> benchmarks;
+
+}; // Suite
+
+/**
+ * Generates paragraphs of English prose with hard line breaks, like dialogue
+ * or a text log.
+ **/
+std::string generateProse(size_t size);
+
+// Each of these adds the benchmarks for one area of the engine.
+void addDataBenchmarks(Suite &suite);
+void addImageBenchmarks(Suite &suite);
+void addThreadBenchmarks(Suite &suite);
+void addPhysicsBenchmarks(Suite &suite);
+void addFontBenchmarks(Suite &suite);
+void addGraphicsBenchmarks(Suite &suite);
+
+} // benchmark
+} // love
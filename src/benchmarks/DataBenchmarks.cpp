@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "data/Compressor.h"
+#include "data/HashFunction.h"
+
+// C++
+#include <memory>
+#include <vector>
+
+namespace love
+{
+namespace benchmark
+{
+
+using namespace love::data;
+
+// Text-like data made of a small vocabulary, so it compresses about as well as
+// typical game data.
+static std::vector<char> generateText(size_t size)
+{
+	static const char *words[] = {
+		"love", "graphics", "draw", "sprite", "player", "enemy", "level", "score",
+		"update", "physics", "world", "body", "x", "y", "0", "1", "true", "false",
+	};
+
+	std::vector<char> text;
+	text.reserve(size);
+
+	uint32 seed = 12345;
+	while (text.size() < size)
+	{
+		seed = seed * 1664525 + 1013904223;
+		const char *word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+		for (const char *c = word; *c != '\0' && text.size() < size; c++)
+			text.push_back(*c);
+		if (text.size() < size)
+			text.push_back((seed >> 8) % 8 == 0 ? '\n' : ' ');
+	}
+
+	return text;
+}
+
+void addDataBenchmarks(Suite &suite)
+{
+	auto text = std::make_shared<std::vector<char>>(generateText(1024 * 1024));
+
+	for (int i = 0; i < (int) Compressor::FORMAT_MAX_ENUM; i++)
+	{
+		auto format = (Compressor::Format) i;
+		Compressor *compressor = Compressor::getCompressor(format);
+		if (compressor == nullptr || !compressor->isSupported(format))
+			continue;
+
+		const char *formatname = nullptr;
+		if (!Compressor::getConstant(format, formatname))
+			continue;
+
+		size_t compressedsize = 0;
+		char *compressed = compressor->compress(format, text->data(), text->size(), -1, nullptr, compressedsize);
+		auto compresseddata = std::make_shared<std::vector<char>>(compressed, compressed + compressedsize);
+		delete[] compressed;
+
+		std::string name = std::string("data/compress/") + formatname;
+		suite.add(name, [=]()
+		{
+			size_t size = 0;
+			delete[] compressor->compress(format, text->data(), text->size(), -1, nullptr, size);
+		}, 1, text->size());
+
+		name = std::string("data/decompress/") + formatname;
+		suite.add(name, [=]()
+		{
+			size_t size = text->size();
+			delete[] compressor->decompress(format, compresseddata->data(), compresseddata->size(), nullptr, size);
+		}, 1, text->size());
+	}
+
+	for (int i = 0; i < (int) HashFunction::FUNCTION_MAX_ENUM; i++)
+	{
+		auto function = (HashFunction::Function) i;
+		HashFunction *hashfunction = HashFunction::getHashFunction(function);
+		if (hashfunction == nullptr || !hashfunction->isSupported(function))
+			continue;
+
+		const char *functionname = nullptr;
+		if (!HashFunction::getConstant(function, functionname))
+			continue;
+
+		// Small inputs show per-call overhead, large ones throughput.
+		for (size_t size : {64, 64 * 1024})
+		{
+			std::string name = std::string("data/hash/") + functionname + (size < 1024 ? "/64B" : "/64KiB");
+			suite.add(name, [=]()
+			{
+				HashFunction::Value value;
+				hashfunction->hash(function, text->data(), size, value);
+			}, 1, size);
+		}
+	}
+}
+
+} // benchmark
+} // love
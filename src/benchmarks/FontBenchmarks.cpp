@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "font/freetype/Font.h"
+#include "font/TextShaper.h"
+
+// C++
+#include <memory>
+#include <string>
+
+namespace love
+{
+namespace benchmark
+{
+
+using namespace love::font;
+
+std::string generateProse(size_t size)
+{
+	static const char *sentence = "The quick brown fox jumps over the lazy dog, and then it wanders off into the forest to find something to eat. ";
+
+	std::string text;
+	text.reserve(size);
+
+	for (int i = 0; text.size() < size; i++)
+	{
+		text += sentence;
+		if (i % 4 == 3)
+			text += "\n";
+	}
+
+	return text;
+}
+
+void addFontBenchmarks(Suite &suite)
+{
+	StrongRef<Font> fontmodule(new freetype::Font(), Acquire::NORETAIN);
+	StrongRef<Rasterizer> rasterizer(fontmodule->newTrueTypeRasterizer(14, TrueTypeRasterizer::HINTING_NORMAL), Acquire::NORETAIN);
+
+	// Small texts are wrapped on the calling thread, large ones on several.
+	for (size_t size : {1024, 256 * 1024})
+	{
+		StrongRef<TextShaper> shaper(rasterizer->newTextShaper(), Acquire::NORETAIN);
+
+		auto codepoints = std::make_shared<ColoredCodepoints>();
+		getCodepointsFromString(generateProse(size), codepoints->cps);
+
+		std::string name = "font/textshaper/wrap/" + std::string(size < 65536 ? "1KiB" : "256KiB");
+		suite.add(name, [=]()
+		{
+			(void) fontmodule; // The rasterizer's library lives in the module.
+			std::vector<Range> lines;
+			shaper->getWrap(*codepoints, 400.0f, lines);
+		}, codepoints->cps.size());
+	}
+}
+
+} // benchmark
+} // love
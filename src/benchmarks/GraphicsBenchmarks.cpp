@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "common/Matrix.h"
+#include "font/freetype/Font.h"
+#include "graphics/Graphics.h"
+#include "graphics/Font.h"
+#include "graphics/ParticleSystem.h"
+#include "window/sdl/Window.h"
+
+// C++
+#include <memory>
+
+namespace love
+{
+namespace benchmark
+{
+
+using namespace love::graphics;
+
+namespace
+{
+
+// Number of shapes or sprites drawn per frame.
+const int DRAWS_PER_FRAME = 1000;
+
+const int PARTICLE_COUNT = 10000;
+
+// The window and graphics modules are only created once a graphics benchmark
+// runs, so filtering them out doesn't open a window.
+struct Context
+{
+	bool initialized = false;
+	std::string error;
+
+	StrongRef<font::Font> fontModule;
+	StrongRef<window::Window> window;
+	StrongRef<Graphics> graphics;
+
+	StrongRef<Texture> texture;
+	StrongRef<graphics::Font> font;
+	StrongRef<ParticleSystem> particles;
+
+	font::ColoredCodepoints text;
+
+	~Context()
+	{
+		particles.set(nullptr);
+		font.set(nullptr);
+		texture.set(nullptr);
+		graphics.set(nullptr);
+		window.set(nullptr);
+		fontModule.set(nullptr);
+	}
+
+	Graphics *get()
+	{
+		if (!initialized)
+		{
+			initialized = true;
+
+			try
+			{
+				init();
+			}
+			catch (love::Exception &e)
+			{
+				error = e.what();
+			}
+		}
+
+		if (!error.empty())
+			throw Skip(error.c_str());
+
+		return graphics.get();
+	}
+
+	void init()
+	{
+		fontModule.set(new font::freetype::Font(), Acquire::NORETAIN);
+		Module::registerInstance(fontModule);
+
+		window.set(new window::sdl::Window(), Acquire::NORETAIN);
+		Module::registerInstance(window);
+
+		graphics.set(Graphics::createInstance(), Acquire::NORETAIN);
+		if (graphics.get() == nullptr)
+			throw love::Exception("Could not create a graphics module.");
+		Module::registerInstance(graphics);
+
+		// Without vsync, presenting doesn't wait for the display.
+		window::WindowSettings settings;
+		settings.vsync = 0;
+		if (!window->setWindow(800, 600, &settings) || !graphics->isActive())
+			throw love::Exception("Could not create a window.");
+
+		Texture::Settings texsettings;
+		texsettings.width = 32;
+		texsettings.height = 32;
+		texsettings.format = PIXELFORMAT_RGBA8_UNORM;
+		texture.set(graphics->newTexture(texsettings), Acquire::NORETAIN);
+
+		font.set(graphics->newDefaultFont(13, font::TrueTypeRasterizer::HINTING_NORMAL), Acquire::NORETAIN);
+		font::getCodepointsFromString(generateProse(4096), text.cps);
+
+		particles.set(graphics->newParticleSystem(texture, PARTICLE_COUNT, false), Acquire::NORETAIN);
+		particles->setParticleLifetime(1.0f, 1.0f);
+		particles->setEmissionRate((float) PARTICLE_COUNT);
+		particles->setSpeed(50.0f, 100.0f);
+		particles->setSpread(6.28f);
+		particles->start();
+		particles->emit(PARTICLE_COUNT);
+	}
+};
+
+} // anonymous namespace
+
+void addGraphicsBenchmarks(Suite &suite)
+{
+	auto context = std::make_shared<Context>();
+
+	suite.add("graphics/present", [=]()
+	{
+		context->get()->present(nullptr);
+	});
+
+	suite.add("graphics/batch/rectangles", [=]()
+	{
+		Graphics *gfx = context->get();
+		for (int i = 0; i < DRAWS_PER_FRAME; i++)
+			gfx->rectangle(Graphics::DRAW_FILL, (float) (i % 100) * 8.0f, (float) (i / 100) * 8.0f, 6.0f, 6.0f);
+		gfx->present(nullptr);
+	}, DRAWS_PER_FRAME);
+
+	suite.add("graphics/batch/sprites", [=]()
+	{
+		Graphics *gfx = context->get();
+		Texture *texture = context->texture.get();
+		for (int i = 0; i < DRAWS_PER_FRAME; i++)
+			gfx->draw(texture, Matrix4((float) (i % 100) * 8.0f, (float) (i / 100) * 8.0f, 0.0f, 0.25f, 0.25f, 0.0f, 0.0f, 0.0f, 0.0f));
+		gfx->present(nullptr);
+	}, DRAWS_PER_FRAME);
+
+	suite.add("graphics/font/generatevertices", [=]()
+	{
+		context->get();
+		const font::ColoredCodepoints &text = context->text;
+		std::vector<graphics::Font::GlyphVertex> vertices;
+		context->font->generateVertices(text, Range(0, text.cps.size()), Colorf(1.0f, 1.0f, 1.0f, 1.0f), vertices);
+	}, 4096);
+
+	suite.add("graphics/font/generateverticesformatted", [=]()
+	{
+		context->get();
+		const font::ColoredCodepoints &text = context->text;
+		std::vector<graphics::Font::GlyphVertex> vertices;
+		context->font->generateVerticesFormatted(text, Colorf(1.0f, 1.0f, 1.0f, 1.0f), 400.0f, graphics::Font::ALIGN_LEFT, vertices);
+	}, 4096);
+
+	suite.add("graphics/particlesystem/update", [=]()
+	{
+		context->get();
+		context->particles->update(1.0f / 60.0f);
+	}, PARTICLE_COUNT);
+}
+
+} // benchmark
+} // love
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "common/Object.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
+#include "image/magpie/PNGHandler.h"
+#include "image/magpie/STBHandler.h"
+#include "image/magpie/EXRHandler.h"
+
+// C++
+#include <memory>
+#include <vector>
+
+namespace love
+{
+namespace benchmark
+{
+
+using namespace love::image;
+
+static ImageData *newTestImage(int width, int height, PixelFormat format)
+{
+	ImageData *img = new ImageData(width, height, format);
+
+	// A gradient with some noise, so encoders can't take shortcuts.
+	uint32 seed = 1;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			float noise = (float) ((seed >> 24) & 0x0F) / 255.0f;
+			Colorf c((float) x / width, (float) y / height, 0.5f + noise, 1.0f);
+			img->setPixel(x, y, c);
+		}
+	}
+
+	return img;
+}
+
+void addImageBenchmarks(Suite &suite)
+{
+	{
+		StrongRef<ImageData> dst(new ImageData(1024, 1024), Acquire::NORETAIN);
+		StrongRef<ImageData> src(newTestImage(512, 512, PIXELFORMAT_RGBA8_UNORM), Acquire::NORETAIN);
+
+		suite.add("image/paste/rgba8/512x512", [=]()
+		{
+			dst->paste(src.get(), 100, 100, 0, 0, 512, 512);
+		}, 1, src->getSize());
+	}
+
+	std::vector<StrongRef<FormatHandler>> handlers = {
+		StrongRef<FormatHandler>(new magpie::PNGHandler(), Acquire::NORETAIN),
+		StrongRef<FormatHandler>(new magpie::STBHandler(), Acquire::NORETAIN),
+		StrongRef<FormatHandler>(new magpie::EXRHandler(), Acquire::NORETAIN),
+	};
+
+	const char *handlernames[] = {"png", "stb", "exr"};
+
+	const PixelFormat rawformats[] = {
+		PIXELFORMAT_RGBA8_UNORM,
+		PIXELFORMAT_RGBA16_FLOAT,
+		PIXELFORMAT_RGBA32_FLOAT,
+	};
+
+	for (PixelFormat rawformat : rawformats)
+	{
+		const char *rawformatname = nullptr;
+		love::getConstant(rawformat, rawformatname);
+
+		StrongRef<ImageData> img(newTestImage(256, 256, rawformat), Acquire::NORETAIN);
+
+		FormatHandler::DecodedImage decoded;
+		decoded.format = rawformat;
+		decoded.width = img->getWidth();
+		decoded.height = img->getHeight();
+		decoded.size = img->getSize();
+		decoded.data = (unsigned char *) img->getData();
+
+		for (int f = 0; f < (int) FormatHandler::ENCODED_MAX_ENUM; f++)
+		{
+			auto encodedformat = (FormatHandler::EncodedFormat) f;
+
+			const char *encodedname = nullptr;
+			ImageData::getConstant(encodedformat, encodedname);
+
+			for (size_t h = 0; h < handlers.size(); h++)
+			{
+				StrongRef<FormatHandler> handler = handlers[h];
+				if (!handler->canEncode(rawformat, encodedformat))
+					continue;
+
+				std::string suffix = std::string(handlernames[h]) + "/" + encodedname + "/" + rawformatname;
+
+				suite.add("image/encode/" + suffix, [=]()
+				{
+					FormatHandler::EncodedImage encoded = handler->encode(decoded, encodedformat);
+					handler->freeEncodedImage(encoded.data);
+				}, 1, decoded.size);
+
+				// Decode what was just encoded with every handler that can.
+				FormatHandler::EncodedImage encoded = handler->encode(decoded, encodedformat);
+				auto bytes = std::make_shared<std::vector<uint8>>(encoded.data, encoded.data + encoded.size);
+				handler->freeEncodedImage(encoded.data);
+
+				StrongRef<love::data::ByteData> encodeddata(new love::data::ByteData(bytes->data(), bytes->size(), false), Acquire::NORETAIN);
+
+				for (size_t d = 0; d < handlers.size(); d++)
+				{
+					StrongRef<FormatHandler> decoder = handlers[d];
+					if (!decoder->canDecode(encodeddata.get()))
+						continue;
+
+					std::string name = "image/decode/" + std::string(handlernames[d]) + "/" + encodedname + "/" + rawformatname;
+					suite.add(name, [=]()
+					{
+						(void) bytes; // Keeps the encoded bytes alive.
+						FormatHandler::DecodedImage img = decoder->decode(encodeddata.get());
+						decoder->freeRawPixels(img.data);
+					}, 1, decoded.size);
+				}
+			}
+		}
+	}
+}
+
+} // benchmark
+} // love
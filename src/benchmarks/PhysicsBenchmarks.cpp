@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "physics/box2d/Physics.h"
+#include "physics/box2d/World.h"
+#include "physics/box2d/Body.h"
+#include "physics/box2d/Fixture.h"
+
+// C++
+#include <memory>
+
+namespace love
+{
+namespace benchmark
+{
+
+using namespace love::physics::box2d;
+
+namespace
+{
+
+// A box with a pile of circles and boxes falling into it. Sleeping is
+// disabled, so the cost stays about the same once the pile settles.
+struct Scene
+{
+	StrongRef<Physics> physics;
+	StrongRef<World> world;
+
+	Scene(int count)
+		: physics(new Physics(), Acquire::NORETAIN)
+		, world(physics->newWorld(0.0f, 9.81f * 64.0f, false), Acquire::NORETAIN)
+	{
+		addStatic(400.0f, 610.0f, 820.0f, 20.0f);
+		addStatic(-10.0f, 300.0f, 20.0f, 620.0f);
+		addStatic(810.0f, 300.0f, 20.0f, 620.0f);
+
+		StrongRef<Shape> circle(physics->newCircleShape(6.0f), Acquire::NORETAIN);
+		StrongRef<Shape> box(physics->newRectangleShape(12.0f, 12.0f), Acquire::NORETAIN);
+
+		for (int i = 0; i < count; i++)
+		{
+			float x = 20.0f + (float) ((i * 16) % 760);
+			float y = 20.0f + (float) (i * 16 / 760) * 16.0f;
+			StrongRef<Body> body(physics->newBody(world, x, y, Body::BODY_DYNAMIC), Acquire::NORETAIN);
+			StrongRef<Fixture> fixture(physics->newFixture(body, i % 2 == 0 ? circle : box, 1.0f), Acquire::NORETAIN);
+		}
+	}
+
+	~Scene()
+	{
+		world->destroy();
+	}
+
+	void addStatic(float x, float y, float w, float h)
+	{
+		StrongRef<Body> body(physics->newBody(world, x, y, Body::BODY_STATIC), Acquire::NORETAIN);
+		StrongRef<Shape> shape(physics->newRectangleShape(w, h), Acquire::NORETAIN);
+		StrongRef<Fixture> fixture(physics->newFixture(body, shape, 0.0f), Acquire::NORETAIN);
+	}
+};
+
+} // anonymous namespace
+
+void addPhysicsBenchmarks(Suite &suite)
+{
+	for (int count : {100, 1000})
+	{
+		auto scene = std::make_shared<Scene>(count);
+		suite.add("physics/world/update/" + std::to_string(count) + "bodies", [=]()
+		{
+			scene->world->update(1.0f / 60.0f);
+		}, count);
+	}
+}
+
+} // benchmark
+} // love
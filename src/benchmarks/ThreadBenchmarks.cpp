@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+#include "common/Variant.h"
+#include "thread/Channel.h"
+
+// C++
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace love
+{
+namespace benchmark
+{
+
+using love::thread::Channel;
+
+// Every producer pushes this many numbers per operation.
+static const int MESSAGES_PER_PRODUCER = 10000;
+
+// Pushes from several producer threads while one consumer pops everything.
+// Producers retry when a fixed-capacity channel is full.
+static void runContention(Channel *channel, int producers)
+{
+	std::vector<std::thread> threads;
+
+	for (int p = 0; p < producers; p++)
+	{
+		threads.emplace_back([channel]()
+		{
+			for (int i = 0; i < MESSAGES_PER_PRODUCER; i++)
+			{
+				while (channel->push(Variant((double) i)) == 0)
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	int remaining = producers * MESSAGES_PER_PRODUCER;
+	Variant v;
+	while (remaining > 0)
+	{
+		if (channel->pop(&v))
+			remaining--;
+		else
+			std::this_thread::yield();
+	}
+
+	for (std::thread &t : threads)
+		t.join();
+}
+
+void addThreadBenchmarks(Suite &suite)
+{
+	{
+		StrongRef<Channel> channel(new Channel(), Acquire::NORETAIN);
+		suite.add("thread/channel/pushpop", [=]()
+		{
+			Variant v;
+			channel->push(Variant(1.0));
+			channel->pop(&v);
+		});
+	}
+
+	for (int producers : {1, 4})
+	{
+		std::string suffix = std::to_string(producers) + "producers";
+		uint64 messages = (uint64) producers * MESSAGES_PER_PRODUCER;
+
+		StrongRef<Channel> unbounded(new Channel(), Acquire::NORETAIN);
+		suite.add("thread/channel/contention/unbounded/" + suffix, [=]()
+		{
+			runContention(unbounded.get(), producers);
+		}, messages);
+
+		StrongRef<Channel> lockfree(new Channel(0, 1024, true), Acquire::NORETAIN);
+		suite.add("thread/channel/contention/lockfree/" + suffix, [=]()
+		{
+			runContention(lockfree.get(), producers);
+		}, messages);
+	}
+}
+
+} // benchmark
+} // love
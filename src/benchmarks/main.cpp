@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Benchmark.h"
+
+// C++
+#include <new>
+#include <string>
+
+// C
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Counts every C++ heap allocation, including ones made inside LOVE's code,
+// which is compiled into this executable.
+void *operator new(size_t size)
+{
+	love::benchmark::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	love::benchmark::allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+	void *mem = malloc(size > 0 ? size : 1);
+	if (mem == nullptr)
+		throw std::bad_alloc();
+	return mem;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *mem) noexcept
+{
+	free(mem);
+}
+
+void operator delete[](void *mem) noexcept
+{
+	free(mem);
+}
+
+void operator delete(void *mem, size_t) noexcept
+{
+	free(mem);
+}
+
+void operator delete[](void *mem, size_t) noexcept
+{
+	free(mem);
+}
+
+static void printUsage()
+{
+	printf("usage: love-benchmarks [--filter text] [--time seconds]\n"
+	       "    --filter text     only runs benchmarks whose name contains text\n"
+	       "    --time seconds    minimum time spent measuring each benchmark (default 0.25)\n");
+}
+
+int main(int argc, char **argv)
+{
+	using namespace love::benchmark;
+
+	Suite::Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			options.filter = argv[++i];
+		else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+			options.minTime = atof(argv[++i]);
+		else
+		{
+			printUsage();
+			return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+	}
+
+	Suite suite;
+
+#ifdef LOVE_ENABLE_DATA
+	addDataBenchmarks(suite);
+#endif
+#ifdef LOVE_ENABLE_IMAGE
+	addImageBenchmarks(suite);
+#endif
+#ifdef LOVE_ENABLE_THREAD
+	addThreadBenchmarks(suite);
+#endif
+#ifdef LOVE_ENABLE_PHYSICS
+	addPhysicsBenchmarks(suite);
+#endif
+#ifdef LOVE_ENABLE_FONT
+	addFontBenchmarks(suite);
+#endif
+#if defined(LOVE_ENABLE_GRAPHICS) && defined(LOVE_ENABLE_WINDOW) && defined(LOVE_ENABLE_FONT)
+	addGraphicsBenchmarks(suite);
+#endif
+
+	int failures = suite.run(options);
+	return failures > 0 ? 1 : 0;
+}
@@ -20,6 +20,7 @@
 
 #include "Matrix.h"
 #include "common/config.h"
+#include "common/int.h"
 
 // STD
 #include <cstring> // memcpy
@@ -309,6 +310,90 @@ void Matrix4::shear(float kx, float ky)
 	this->operator *=(t);
 }
 
+//                 | x |
+//                 | y |
+//                 | 0 |
+//                 | 1 |
+// | e0 e4 e8  e12 |
+// | e1 e5 e9  e13 |
+
+void Matrix4::transformXY(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const
+{
+	uint8 *d = (uint8 *) dst;
+	const uint8 *s = (const uint8 *) src;
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two vertices at a time, as x0 y0 x1 y1. Both are loaded before anything
+	// is stored, in case src = dst.
+	__m128 colx = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	__m128 coly = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	__m128 colw = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	for (; i + 1 < size; i += 2)
+	{
+		__m128 v = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) (s + srcstride * i));
+		v = _mm_loadh_pi(v, (const __m64 *) (s + srcstride * (i + 1)));
+
+		__m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, colx), _mm_mul_ps(yy, coly)), colw);
+
+		_mm_storel_pi((__m64 *) (d + dststride * i), r);
+		_mm_storeh_pi((__m64 *) (d + dststride * (i + 1)), r);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float x[2] = {e[0], e[1]};
+	const float y[2] = {e[4], e[5]};
+	const float w[2] = {e[12], e[13]};
+
+	float32x2_t colx = vld1_f32(x);
+	float32x2_t coly = vld1_f32(y);
+	float32x2_t colw = vld1_f32(w);
+
+	if (srcstride == sizeof(float) * 2 && dststride == sizeof(float) * 2)
+	{
+		// Tightly packed, deinterleave four vertices at a time.
+		for (; i + 3 < size; i += 4)
+		{
+			float32x4x2_t v = vld2q_f32((const float *) (s + srcstride * i));
+
+			float32x4x2_t r;
+			r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[12]), v.val[0], e[0]), v.val[1], e[4]);
+			r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(e[13]), v.val[0], e[1]), v.val[1], e[5]);
+
+			vst2q_f32((float *) (d + dststride * i), r);
+		}
+	}
+
+	for (; i < size; i++)
+	{
+		float32x2_t v = vld1_f32((const float *) (s + srcstride * i));
+		float32x2_t r = vmla_lane_f32(vmla_lane_f32(colw, colx, v, 0), coly, v, 1);
+		vst1_f32((float *) (d + dststride * i), r);
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		const float *v = (const float *) (s + srcstride * i);
+
+		// Store in temp variables in case src = dst
+		float x = (e[0]*v[0]) + (e[4]*v[1]) + (0) + (e[12]);
+		float y = (e[1]*v[0]) + (e[5]*v[1]) + (0) + (e[13]);
+
+		float *r = (float *) (d + dststride * i);
+		r[0] = x;
+		r[1] = y;
+	}
+}
+
 bool Matrix4::isAffine2DTransform() const
 {
 	return fabsf(e[2] + e[3] + e[6] + e[7] + e[8] + e[9] + e[11] + e[14]) < 0.00001f
@@ -25,6 +25,9 @@
 #include "math.h"
 #include "Vector.h"
 
+// C
+#include <stddef.h>
+
 namespace love
 {
 
@@ -39,6 +42,10 @@ private:
 
 	static void multiply(const Matrix4 &a, const Matrix4 &b, float t[16]);
 
+	// Transforms the x and y components of vertices which may be interleaved
+	// with other data. Uses SIMD instructions when they're available.
+	void transformXY(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const;
+
 public:
 
 	static void multiply(const Matrix4 &a, const Matrix4 &b, Matrix4 &result);
@@ -326,15 +333,11 @@ private:
 template <typename Vdst, typename Vsrc>
 void Matrix4::transformXY(Vdst *dst, const Vsrc *src, int size) const
 {
-	for (int i = 0; i < size; i++)
-	{
-		// Store in temp variables in case src = dst
-		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (0) + (e[12]);
-		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (0) + (e[13]);
+	if (size <= 0)
+		return;
 
-		dst[i].x = x;
-		dst[i].y = y;
-	}
+	// All vertex types store their x and y components as consecutive floats.
+	transformXY(&dst[0].x, sizeof(Vdst), &src[0].x, sizeof(Vsrc), size);
 }
 
 template <typename Vdst, typename Vsrc>
@@ -22,8 +22,10 @@
 #include "Module.h"
 #include "Exception.h"
 #include "deprecation.h"
+#include "thread/JobSystem.h"
 
 // std
+#include <atomic>
 #include <map>
 #include <utility>
 #include <string>
@@ -45,6 +47,15 @@ namespace
 		return *registry;
 	}
 
+	struct PreloadState
+	{
+		love::thread::JobSystem::Counter counter;
+		love::Module *instance = nullptr;
+		std::string error;
+	};
+
+	std::atomic<PreloadState *> preloads[love::Module::M_MAX_ENUM] = {};
+
 	void freeEmptyRegistry()
 	{
 		if (registry && registry->empty())
@@ -139,4 +150,69 @@ Module *Module::getInstance(const std::string &name)
 	return it->second;
 }
 
+void Module::preloadInstance(ModuleType type, Module *(*create)())
+{
+	if (type == M_UNKNOWN || instances[type] != nullptr)
+		return;
+
+	PreloadState *state = new PreloadState();
+	PreloadState *expected = nullptr;
+
+	if (!preloads[type].compare_exchange_strong(expected, state))
+	{
+		delete state;
+		return;
+	}
+
+	thread::JobSystem::getInstance()->submit([state, create]()
+	{
+		try
+		{
+			state->instance = create();
+		}
+		catch (std::exception &e)
+		{
+			state->error = e.what();
+		}
+	}, &state->counter);
+}
+
+Module *Module::takePreloadedInstance(ModuleType type)
+{
+	if (type == M_UNKNOWN)
+		return nullptr;
+
+	PreloadState *state = preloads[type].exchange(nullptr);
+	if (state == nullptr)
+		return nullptr;
+
+	thread::JobSystem::getInstance()->wait(state->counter);
+
+	Module *instance = state->instance;
+	std::string error = state->error;
+	delete state;
+
+	if (instance == nullptr)
+		throw Exception("%s", error.c_str());
+
+	return instance;
+}
+
+void Module::releasePreloadedInstances()
+{
+	for (int i = 0; i < M_MAX_ENUM; i++)
+	{
+		try
+		{
+			Module *instance = takePreloadedInstance((ModuleType) i);
+			if (instance != nullptr)
+				instance->release();
+		}
+		catch (Exception &)
+		{
+			// Nothing was created, so there's nothing to release.
+		}
+	}
+}
+
 } // love
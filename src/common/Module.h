@@ -104,6 +104,29 @@ public:
 		return type != M_UNKNOWN ? (T *) instances[type] : nullptr;
 	}
 
+	/**
+	 * Starts creating a module instance on a worker thread, so slow module
+	 * setup (e.g. opening an audio device) can overlap with other startup
+	 * work. Does nothing if an instance of that type is already pending.
+	 * @param type The base type of the module.
+	 * @param create Creates the instance. May throw.
+	 **/
+	static void preloadInstance(ModuleType type, Module *(*create)());
+
+	/**
+	 * Waits for and returns an instance started with preloadInstance. The
+	 * caller takes ownership of the instance. Rethrows any error thrown while
+	 * creating it.
+	 * @return The preloaded instance, or null if none was started.
+	 **/
+	static Module *takePreloadedInstance(ModuleType type);
+
+	/**
+	 * Waits for and releases every preloaded instance which hasn't been taken,
+	 * e.g. when startup fails before the modules are required.
+	 **/
+	static void releasePreloadedInstances();
+
 private:
 
 	static Module *instances[M_MAX_ENUM];
@@ -26,18 +26,30 @@ namespace love
 
 love::Type Object::type("Object", nullptr);
 
+#ifdef LOVE_ENABLE_REFCOUNT_STATS
+static std::atomic<int64> retainCalls(0);
+static std::atomic<int64> releaseCalls(0);
+#endif
+
 Object::Object()
 	: count(1)
+	, accountedType(&Object::type)
+	, accountedBytes(0)
 {
+	Object::type.addObject(0);
 }
 
 Object::Object(const Object & /*other*/)
 	: count(1) // Always start with a reference count of 1.
+	, accountedType(&Object::type)
+	, accountedBytes(0)
 {
+	Object::type.addObject(0);
 }
 
 Object::~Object()
 {
+	accountedType.load(std::memory_order_relaxed)->removeObject(accountedBytes);
 }
 
 int Object::getReferenceCount() const
@@ -47,11 +59,18 @@ int Object::getReferenceCount() const
 
 void Object::retain()
 {
+#ifdef LOVE_ENABLE_REFCOUNT_STATS
+	retainCalls.fetch_add(1, std::memory_order_relaxed);
+#endif
 	count.fetch_add(1, std::memory_order_relaxed);
 }
 
 void Object::release()
 {
+#ifdef LOVE_ENABLE_REFCOUNT_STATS
+	releaseCalls.fetch_add(1, std::memory_order_relaxed);
+#endif
+
 	// http://www.boost.org/doc/libs/1_56_0/doc/html/atomic/usage_examples.html
 	if (count.fetch_sub(1, std::memory_order_release) == 1)
 	{
@@ -60,4 +79,38 @@ void Object::release()
 	}
 }
 
+void Object::setAccountedType(Type &type, size_t bytes)
+{
+	if (&type == &Object::type)
+		return;
+
+	// The object may be pushed from several threads at once.
+	Type *expected = &Object::type;
+	if (accountedType.compare_exchange_strong(expected, &type))
+	{
+		accountedBytes = bytes;
+		Object::type.removeObject(0);
+		type.addObject(bytes);
+	}
+}
+
+void Object::getRefCountStats(int64 &retains, int64 &releases)
+{
+#ifdef LOVE_ENABLE_REFCOUNT_STATS
+	retains = retainCalls.load(std::memory_order_relaxed);
+	releases = releaseCalls.load(std::memory_order_relaxed);
+#else
+	retains = 0;
+	releases = 0;
+#endif
+}
+
+void Object::resetRefCountStats()
+{
+#ifdef LOVE_ENABLE_REFCOUNT_STATS
+	retainCalls.store(0, std::memory_order_relaxed);
+	releaseCalls.store(0, std::memory_order_relaxed);
+#endif
+}
+
 } // love
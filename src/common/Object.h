@@ -22,6 +22,7 @@
 #define LOVE_OBJECT_H
 
 #include <atomic>
+#include "int.h"
 #include "types.h"
 
 namespace love
@@ -71,11 +72,31 @@ public:
 	 **/
 	void release();
 
+	/**
+	 * Attributes this object, and the given number of bytes, to a type in the
+	 * live object statistics (see Type::getObjectCount). Objects are counted
+	 * as plain Objects until this is called; only the first call has an
+	 * effect. Called when an object is first pushed to Lua.
+	 **/
+	void setAccountedType(Type &type, size_t bytes);
+
+	/**
+	 * Gets the number of retain and release calls made on all Objects since
+	 * the counts were last reset. The calls are only counted in builds with
+	 * LOVE_ENABLE_REFCOUNT_STATS defined, otherwise both are always 0.
+	 **/
+	static void getRefCountStats(int64 &retains, int64 &releases);
+	static void resetRefCountStats();
+
 private:
 
 	// The reference count.
 	std::atomic<int> count;
 
+	// The type this object is counted as in the live object statistics.
+	std::atomic<Type *> accountedType;
+	size_t accountedBytes;
+
 }; // Object
 
 /**
@@ -121,7 +142,7 @@ public:
 		if (object) object->retain();
 	}
 
-	StrongRef(StrongRef &&other)
+	StrongRef(StrongRef &&other) noexcept
 		: object(other.object)
 	{
 		other.object = nullptr;
@@ -138,6 +159,17 @@ public:
 		return *this;
 	}
 
+	StrongRef &operator = (StrongRef &&other) noexcept
+	{
+		if (this != &other)
+		{
+			if (object) object->release();
+			object = other.object;
+			other.object = nullptr;
+		}
+		return *this;
+	}
+
 	T *operator->() const
 	{
 		return object;
@@ -155,6 +187,8 @@ public:
 
 	void set(T *obj, Acquire acquire = Acquire::RETAIN)
 	{
+		// Avoid a pointless retain/release pair when nothing changes.
+		if (obj == object && acquire == Acquire::RETAIN) return;
 		if (obj && acquire == Acquire::RETAIN) obj->retain();
 		if (object) object->release();
 		object = obj;
@@ -23,6 +23,7 @@
 #include <stddef.h>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 namespace love
 {
@@ -91,4 +92,119 @@ struct Range
 	}
 };
 
+/**
+ * A short, sorted list of disjoint ranges. Ranges which overlap or are at most
+ * mergeDistance apart are combined. When the list would grow past maxRanges,
+ * the two closest ranges are combined instead.
+ **/
+class RangeList
+{
+public:
+
+	RangeList(size_t maxRanges = 8, size_t mergeDistance = 0)
+		: maxRanges(std::max(maxRanges, (size_t) 1))
+		, mergeDistance(mergeDistance)
+	{}
+
+	bool isEmpty() const { return ranges.empty(); }
+	void clear() { ranges.clear(); }
+
+	const std::vector<Range> &getRanges() const { return ranges; }
+
+	Range getBounds() const
+	{
+		if (ranges.empty())
+			return Range();
+
+		Range r = ranges.front();
+		r.encapsulate(ranges.back());
+		return r;
+	}
+
+	void encapsulate(size_t index)
+	{
+		encapsulate(index, 1);
+	}
+
+	void encapsulate(size_t offset, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		Range r(offset, size);
+
+		// Sequential writes usually extend the last range.
+		if (!ranges.empty() && r.first >= ranges.back().first)
+		{
+			Range &back = ranges.back();
+			if (r.first <= back.last || r.first - back.last - 1 <= mergeDistance)
+			{
+				back.encapsulate(r);
+				return;
+			}
+
+			ranges.push_back(r);
+			trim();
+			return;
+		}
+
+		auto it = std::lower_bound(ranges.begin(), ranges.end(), r, [](const Range &a, const Range &b)
+		{
+			return a.first < b.first;
+		});
+
+		size_t i = (size_t) (it - ranges.begin());
+		ranges.insert(it, r);
+
+		// Combine with the previous range, then absorb any following ones.
+		if (i > 0 && isMergeable(ranges[i - 1], ranges[i]))
+		{
+			ranges[i - 1].encapsulate(ranges[i]);
+			ranges.erase(ranges.begin() + i);
+			i--;
+		}
+
+		while (i + 1 < ranges.size() && isMergeable(ranges[i], ranges[i + 1]))
+		{
+			ranges[i].encapsulate(ranges[i + 1]);
+			ranges.erase(ranges.begin() + i + 1);
+		}
+
+		trim();
+	}
+
+private:
+
+	bool isMergeable(const Range &a, const Range &b) const
+	{
+		return b.first <= a.last || b.first - a.last - 1 <= mergeDistance;
+	}
+
+	void trim()
+	{
+		while (ranges.size() > maxRanges)
+		{
+			size_t closest = 0;
+			size_t closestgap = std::numeric_limits<size_t>::max();
+
+			for (size_t i = 0; i + 1 < ranges.size(); i++)
+			{
+				size_t gap = ranges[i + 1].first - ranges[i].last;
+				if (gap < closestgap)
+				{
+					closest = i;
+					closestgap = gap;
+				}
+			}
+
+			ranges[closest].encapsulate(ranges[closest + 1]);
+			ranges.erase(ranges.begin() + closest + 1);
+		}
+	}
+
+	std::vector<Range> ranges;
+	size_t maxRanges;
+	size_t mergeDistance;
+};
+
 } // love
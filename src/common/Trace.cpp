@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Trace.h"
+#include "thread/threads.h"
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <vector>
+
+// C
+#include <stdio.h>
+#include <string.h>
+
+#ifdef LOVE_ENABLE_TRACY
+#include <tracy/TracyC.h>
+#endif
+
+namespace love
+{
+namespace trace
+{
+
+std::atomic<bool> enabled(false);
+
+namespace
+{
+
+struct ZoneRecord
+{
+	const char *name;
+	uint64 start;
+	uint64 end;
+};
+
+// Only written by its own thread. Readers use the count to find the valid
+// records, which may be overwritten while they're being read if the thread
+// keeps recording during an export.
+struct ThreadBuffer
+{
+	int id;
+	std::string name;
+	std::unique_ptr<ZoneRecord[]> records;
+	std::atomic<uint64> count;
+
+	ThreadBuffer(int id)
+		: id(id)
+		, records(new ZoneRecord[MAX_THREAD_ZONES])
+		, count(0)
+	{}
+};
+
+// Startup only has a few dozen stages; anything past this is dropped, in
+// case stages keep being recorded long after startup (e.g. on setMode).
+static const size_t MAX_STARTUP_STAGES = 256;
+
+struct Registry
+{
+	love::thread::MutexRef mutex;
+	std::vector<ThreadBuffer *> buffers;
+	std::set<std::string, std::less<>> names;
+	std::vector<StartupStage> startupStages;
+};
+
+// Never destroyed, so threads which outlive static destructors stay safe.
+Registry &getRegistry()
+{
+	static Registry *registry = new Registry();
+	return *registry;
+}
+
+thread_local ThreadBuffer *threadBuffer = nullptr;
+thread_local std::string threadName;
+
+struct OpenZone
+{
+	const char *name;
+	uint64 start;
+};
+
+thread_local std::vector<OpenZone> openZones;
+thread_local std::vector<OpenZone> openStartupStages;
+
+#ifdef LOVE_ENABLE_TRACY
+// Tracy zones started by push(), which can't use Tracy's scoped zones.
+thread_local std::vector<TracyCZoneCtx> tracyZones;
+#endif
+
+ThreadBuffer *getThreadBuffer()
+{
+	if (threadBuffer == nullptr)
+	{
+		Registry &r = getRegistry();
+		love::thread::Lock lock(r.mutex);
+		threadBuffer = new ThreadBuffer((int) r.buffers.size() + 1);
+		threadBuffer->name = threadName;
+		r.buffers.push_back(threadBuffer);
+	}
+
+	return threadBuffer;
+}
+
+void appendJSONString(std::string &out, const char *str)
+{
+	out += '"';
+	for (const char *c = str; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			out += '\\';
+			out += *c;
+		}
+		else if ((unsigned char) *c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) *c);
+			out += escaped;
+		}
+		else
+			out += *c;
+	}
+	out += '"';
+}
+
+} // anonymous namespace
+
+void setEnabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+uint64 now()
+{
+	auto t = std::chrono::steady_clock::now().time_since_epoch();
+	return (uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+void record(const char *name, uint64 start, uint64 end)
+{
+	ThreadBuffer *b = getThreadBuffer();
+
+	uint64 count = b->count.load(std::memory_order_relaxed);
+	ZoneRecord &r = b->records[count % MAX_THREAD_ZONES];
+	r.name = name;
+	r.start = start;
+	r.end = end;
+
+	b->count.store(count + 1, std::memory_order_release);
+}
+
+void push(const char *name)
+{
+#ifdef LOVE_ENABLE_TRACY
+	uint64_t srcloc = ___tracy_alloc_srcloc_name(0, "", 0, "", 0, name, strlen(name), 0);
+	tracyZones.push_back(___tracy_emit_zone_begin_alloc(srcloc, 1));
+#endif
+
+	openZones.push_back({name, now()});
+}
+
+bool pop()
+{
+	if (openZones.empty())
+		return false;
+
+	const OpenZone &zone = openZones.back();
+
+	// Zones pushed while tracing was disabled are dropped, but still popped
+	// so pushes and pops stay balanced.
+	if (isEnabled())
+		record(zone.name, zone.start, now());
+
+	openZones.pop_back();
+
+#ifdef LOVE_ENABLE_TRACY
+	___tracy_emit_zone_end(tracyZones.back());
+	tracyZones.pop_back();
+#endif
+
+	return true;
+}
+
+void beginStartupStage(const char *name)
+{
+	openStartupStages.push_back({name, now()});
+}
+
+void endStartupStage()
+{
+	if (openStartupStages.empty())
+		return;
+
+	OpenZone stage = openStartupStages.back();
+	openStartupStages.pop_back();
+
+	uint64 end = now();
+
+	if (isEnabled())
+		record(stage.name, stage.start, end);
+
+	Registry &r = getRegistry();
+	love::thread::Lock lock(r.mutex);
+
+	if (r.startupStages.size() < MAX_STARTUP_STAGES)
+		r.startupStages.push_back({stage.name, stage.start, end, (int) openStartupStages.size()});
+}
+
+std::vector<StartupStage> getStartupStages()
+{
+	std::vector<StartupStage> stages;
+
+	{
+		Registry &r = getRegistry();
+		love::thread::Lock lock(r.mutex);
+		stages = r.startupStages;
+	}
+
+	// Stages are added when they end, so enclosing stages come after their
+	// children until sorted. Ties go to the enclosing (shallower) stage.
+	std::sort(stages.begin(), stages.end(), [](const StartupStage &a, const StartupStage &b)
+	{
+		if (a.start != b.start)
+			return a.start < b.start;
+		return a.depth < b.depth;
+	});
+
+	return stages;
+}
+
+void clearStartupStages()
+{
+	Registry &r = getRegistry();
+	love::thread::Lock lock(r.mutex);
+	r.startupStages.clear();
+}
+
+const char *internName(const char *name)
+{
+	Registry &r = getRegistry();
+	love::thread::Lock lock(r.mutex);
+
+	auto it = r.names.find(name);
+	if (it == r.names.end())
+		it = r.names.emplace(name).first;
+
+	return it->c_str();
+}
+
+void setThreadName(const char *name)
+{
+	// The thread's buffer is only created once it records a zone.
+	threadName = name;
+
+#ifdef LOVE_ENABLE_TRACY
+	tracy::SetThreadName(name);
+#endif
+
+	if (threadBuffer != nullptr)
+	{
+		love::thread::Lock lock(getRegistry().mutex);
+		threadBuffer->name = name;
+	}
+}
+
+void clear()
+{
+	Registry &r = getRegistry();
+	love::thread::Lock lock(r.mutex);
+
+	// Buffers stay registered, since their threads still point to them.
+	for (ThreadBuffer *b : r.buffers)
+		b->count.store(0, std::memory_order_release);
+}
+
+std::string getChromeTraceJSON()
+{
+	Registry &r = getRegistry();
+	love::thread::Lock lock(r.mutex);
+
+	std::string out = "{\"traceEvents\":[\n";
+	bool first = true;
+	char buffer[128];
+
+	for (ThreadBuffer *b : r.buffers)
+	{
+		uint64 count = b->count.load(std::memory_order_acquire);
+		if (count == 0)
+			continue;
+
+		if (!first)
+			out += ",\n";
+		first = false;
+
+		snprintf(buffer, sizeof(buffer), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", b->id);
+		out += buffer;
+		if (b->name.empty())
+		{
+			snprintf(buffer, sizeof(buffer), "Thread %d", b->id);
+			appendJSONString(out, buffer);
+		}
+		else
+			appendJSONString(out, b->name.c_str());
+		out += "}}";
+
+		uint64 begin = count > MAX_THREAD_ZONES ? count - MAX_THREAD_ZONES : 0;
+		for (uint64 i = begin; i < count; i++)
+		{
+			const ZoneRecord &z = b->records[i % MAX_THREAD_ZONES];
+
+			out += ",\n{\"ph\":\"X\",\"name\":";
+			appendJSONString(out, z.name);
+
+			// Timestamps are in microseconds.
+			snprintf(buffer, sizeof(buffer), ",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			         b->id, (double) z.start / 1000.0, (double) (z.end - z.start) / 1000.0);
+			out += buffer;
+		}
+	}
+
+	out += "\n]}\n";
+	return out;
+}
+
+} // trace
+} // love
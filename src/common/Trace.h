@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "config.h"
+#include "int.h"
+
+// C++
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifdef LOVE_ENABLE_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace love
+{
+namespace trace
+{
+
+/**
+ * Lightweight CPU tracing. Zones are recorded into a fixed-size ring buffer
+ * per thread, so recording never locks or allocates after a thread's first
+ * zone. When tracing is disabled a zone costs a single atomic load.
+ **/
+
+// Maximum number of zones kept per thread; older zones are overwritten.
+static const size_t MAX_THREAD_ZONES = 1 << 16;
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enable);
+
+/**
+ * Gets the current time in nanoseconds, on the clock used for zones.
+ **/
+uint64 now();
+
+/**
+ * Records a finished zone for the calling thread. The name must stay valid
+ * until the trace is cleared (string literals or interned names).
+ **/
+void record(const char *name, uint64 start, uint64 end);
+
+/**
+ * Starts a zone on the calling thread, ended by the matching pop(). For
+ * zones which can't be tied to a C++ scope, e.g. zones started from Lua.
+ * The name must stay valid until the trace is cleared.
+ **/
+void push(const char *name);
+
+/**
+ * Ends the zone most recently started with push() on the calling thread.
+ * @return False if there was no zone to end.
+ **/
+bool pop();
+
+/**
+ * Gets a copy of the string which stays valid until the program exits.
+ **/
+const char *internName(const char *name);
+
+/**
+ * Names the calling thread in exported traces.
+ **/
+void setThreadName(const char *name);
+
+/**
+ * Discards all recorded zones.
+ **/
+void clear();
+
+/**
+ * Gets all recorded zones in the Chrome trace event JSON format, which can
+ * be opened with chrome://tracing or the Perfetto UI.
+ **/
+std::string getChromeTraceJSON();
+
+/**
+ * A one-off stage of startup, e.g. opening a module or creating the window.
+ **/
+struct StartupStage
+{
+	const char *name;
+	uint64 start;
+	uint64 end;
+	int depth; // Number of enclosing stages on the same thread.
+};
+
+/**
+ * Starts a startup stage on the calling thread. Unlike zones, startup stages
+ * are kept even when tracing is disabled, since whether a startup report is
+ * wanted is only known once conf.lua has run. They're also recorded as zones
+ * when tracing is enabled. The name must stay valid until the program exits.
+ **/
+void beginStartupStage(const char *name);
+
+/**
+ * Ends the stage most recently started with beginStartupStage() on the
+ * calling thread.
+ **/
+void endStartupStage();
+
+/**
+ * Gets all finished startup stages, ordered by start time.
+ **/
+std::vector<StartupStage> getStartupStages();
+
+/**
+ * Discards all finished startup stages, e.g. when the game restarts.
+ **/
+void clearStartupStages();
+
+/**
+ * Records the lifetime of a C++ scope as a startup stage.
+ **/
+class StartupStageScope
+{
+public:
+
+	StartupStageScope(const char *name) { beginStartupStage(name); }
+	~StartupStageScope() { endStartupStage(); }
+
+}; // StartupStageScope
+
+/**
+ * Records the lifetime of a C++ scope as a zone.
+ **/
+class Zone
+{
+public:
+
+	Zone(const char *name)
+		: name(isEnabled() ? name : nullptr)
+		, start(this->name != nullptr ? now() : 0)
+	{
+	}
+
+	~Zone()
+	{
+		if (name != nullptr)
+			record(name, start, now());
+	}
+
+private:
+
+	const char *name;
+	uint64 start;
+
+}; // Zone
+
+} // trace
+} // love
+
+#define LOVE_TRACE_CONCAT_(a, b) a##b
+#define LOVE_TRACE_CONCAT(a, b) LOVE_TRACE_CONCAT_(a, b)
+
+// Records the rest of the enclosing scope as a startup stage. The name must be
+// a string literal.
+#define LOVE_TRACE_STARTUP_STAGE(name) love::trace::StartupStageScope LOVE_TRACE_CONCAT(love_startup_stage_, __LINE__)(name)
+
+#ifdef LOVE_ENABLE_TRACY
+
+// Records the rest of the enclosing scope as a zone with the given name, in
+// both the built-in trace and Tracy. The name must be a string literal.
+#define LOVE_TRACE_ZONE(name) \
+	ZoneScopedN(name); \
+	love::trace::Zone LOVE_TRACE_CONCAT(love_trace_zone_, __LINE__)(name)
+
+#else
+
+// Records the rest of the enclosing scope as a zone with the given name.
+#define LOVE_TRACE_ZONE(name) love::trace::Zone LOVE_TRACE_CONCAT(love_trace_zone_, __LINE__)(name)
+
+#endif
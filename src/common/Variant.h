@@ -48,7 +48,8 @@ public:
 		LUSERDATA,
 		LOVEOBJECT,
 		NIL,
-		TABLE
+		TABLE,
+		FLATTABLE
 	};
 
 	class SharedString : public love::Object
@@ -78,6 +79,39 @@ public:
 		std::vector<std::pair<Variant, Variant>> pairs;
 	};
 
+	/**
+	 * A table and all of its nested tables serialized into one buffer, so a
+	 * Lua table can be copied between threads with a couple of allocations
+	 * instead of several per element. It's only decoded when it's pushed to
+	 * the receiving Lua state (see luax_checkvariant and luax_pushvariant.)
+	 **/
+	class FlatTable : public love::Object
+	{
+	public:
+
+		enum Tag
+		{
+			TAG_NIL,
+			TAG_FALSE,
+			TAG_TRUE,
+			TAG_NUMBER,
+			TAG_STRING,
+			TAG_LUSERDATA,
+			TAG_LOVEOBJECT,
+			TAG_TABLE,
+		};
+
+		FlatTable() {}
+		virtual ~FlatTable();
+
+		// Tagged values. A table is TAG_TABLE, its array size and pair count
+		// (uint32 each), then its keys and values.
+		std::vector<uint8> buffer;
+
+		// Retained objects referenced by index from the buffer.
+		std::vector<Proxy> objects;
+	};
+
 	union Data
 	{
 		bool boolean;
@@ -86,6 +120,7 @@ public:
 		void *userdata;
 		Proxy objectproxy;
 		SharedTable *table;
+		FlatTable *flattable;
 		struct
 		{
 			char str[MAX_SMALL_STRING_LENGTH];
@@ -101,11 +136,13 @@ public:
 	Variant(void *lightuserdata);
 	Variant(love::Type *type, love::Object *object);
 	Variant(SharedTable *table);
+	Variant(FlatTable *table);
 	Variant(const Variant &v);
 	Variant(Variant &&v);
 	~Variant();
 
 	Variant &operator = (const Variant &v);
+	Variant &operator = (Variant &&v);
 
 	Type getType() const { return type; }
 	const Data &getData() const { return data; }
@@ -21,17 +21,49 @@
 #include "b64.h"
 #include "Exception.h"
 
+#include <algorithm>
 #include <limits>
+#include <string.h>
 #include <stdio.h>
 
+#if defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+// The 64-entry table lookups need AArch64's TBL with four registers.
+#define LOVE_B64_NEON
+#endif
+
 namespace love
 {
 
 // Translation table as described in RFC1113
 static const char cb64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-// Translation table to decode (created by Bob Trower)
-static const char cd64[]="|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+// Lookup tables built from cb64: every pair of encoded characters for a 12-bit
+// value, and the 6-bit value of every byte (0xFF if it's not in the alphabet).
+struct B64Tables
+{
+	char pairs[4096][2];
+	uint8 decode[256];
+
+	B64Tables()
+	{
+		for (int i = 0; i < 4096; i++)
+		{
+			pairs[i][0] = cb64[i >> 6];
+			pairs[i][1] = cb64[i & 0x3F];
+		}
+
+		memset(decode, 0xFF, sizeof(decode));
+		for (int i = 0; i < 64; i++)
+			decode[(uint8) cb64[i]] = (uint8) i;
+	}
+};
+
+static const B64Tables &getTables()
+{
+	static const B64Tables tables;
+	return tables;
+}
 
 /**
  * encode 3 8-bit binary bytes as 4 '6-bit' characters
@@ -44,32 +76,64 @@ static void b64_encode_block(char in[3], char out[4], int len)
 	out[3] = (char) (len > 2 ? cb64[(int)(in[2] & 0x3f)] : '=');
 }
 
-char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+size_t b64_encode_groups(const char *src, size_t srclen, char *dst)
 {
-	if (linelen == 0)
-		linelen = std::numeric_limits<size_t>::max();
+	const uint8 *s = (const uint8 *) src;
+	size_t i = 0;
+
+#if defined(LOVE_B64_NEON)
+	const uint8x16x4_t lut = {{
+		vld1q_u8((const uint8 *) cb64 + 0),
+		vld1q_u8((const uint8 *) cb64 + 16),
+		vld1q_u8((const uint8 *) cb64 + 32),
+		vld1q_u8((const uint8 *) cb64 + 48),
+	}};
+
+	for (; i + 48 <= srclen; i += 48, dst += 64)
+	{
+		uint8x16x3_t in = vld3q_u8(s + i);
+
+		uint8x16_t i0 = vshrq_n_u8(in.val[0], 2);
+		uint8x16_t i1 = vorrq_u8(vandq_u8(vshlq_n_u8(in.val[0], 4), vdupq_n_u8(0x30)), vshrq_n_u8(in.val[1], 4));
+		uint8x16_t i2 = vorrq_u8(vandq_u8(vshlq_n_u8(in.val[1], 2), vdupq_n_u8(0x3C)), vshrq_n_u8(in.val[2], 6));
+		uint8x16_t i3 = vandq_u8(in.val[2], vdupq_n_u8(0x3F));
+
+		uint8x16x4_t out;
+		out.val[0] = vqtbl4q_u8(lut, i0);
+		out.val[1] = vqtbl4q_u8(lut, i1);
+		out.val[2] = vqtbl4q_u8(lut, i2);
+		out.val[3] = vqtbl4q_u8(lut, i3);
+		vst4q_u8((uint8 *) dst, out);
+	}
+#endif
 
-	size_t blocksout = 0;
-	size_t srcpos = 0;
+	const B64Tables &tables = getTables();
 
-	size_t adjustment = (srclen % 3) ? (3 - (srclen % 3)) : 0;
-	size_t paddedlen = ((srclen + adjustment) / 3) * 4;
+	for (; i + 3 <= srclen; i += 3, dst += 4)
+	{
+		uint32 v = ((uint32) s[i] << 16) | ((uint32) s[i + 1] << 8) | s[i + 2];
+		memcpy(dst + 0, tables.pairs[v >> 12], 2);
+		memcpy(dst + 2, tables.pairs[v & 0xFFF], 2);
+	}
 
-	dstlen = paddedlen + paddedlen / linelen;
+	return i;
+}
 
-	if (dstlen == 0)
-		return nullptr;
+void b64_encode_tail(const char *src, size_t srclen, char dst[4])
+{
+	char in[3] = {0};
+	for (size_t i = 0; i < srclen && i < 3; i++)
+		in[i] = src[i];
 
-	char *dst = nullptr;
-	try
-	{
-		dst = new char[dstlen + 1];
-	}
-	catch (std::exception &)
-	{
-		throw love::Exception("Out of memory.");
-	}
+	b64_encode_block(in, dst, (int) std::min<size_t>(srclen, 3));
+}
 
+// Line lengths which aren't a multiple of 4 don't line up with whole blocks,
+// so they keep the original block-by-block loop.
+static void b64_encode_unaligned(const char *src, size_t srclen, size_t linelen, char *dst, size_t dstlen)
+{
+	size_t blocksout = 0;
+	size_t srcpos = 0;
 	size_t dstpos = 0;
 
 	while (srcpos < srclen)
@@ -108,69 +172,206 @@ char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
 	}
 
 	dst[dstpos] = '\0';
-	return dst;
 }
 
-static void b64_decode_block(char in[4], char out[3])
+char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
 {
-	out[0] = (char)(in[0] << 2 | in[1] >> 4);
-	out[1] = (char)(in[1] << 4 | in[2] >> 2);
-	out[2] = (char)(((in[2] << 6) & 0xc0) | in[3]);
-}
+	if (linelen == 0)
+		linelen = std::numeric_limits<size_t>::max();
 
-char *b64_decode(const char *src, size_t srclen, size_t &size)
-{
-	size_t paddedsize = (srclen / 4) * 3;
+	size_t adjustment = (srclen % 3) ? (3 - (srclen % 3)) : 0;
+	size_t paddedlen = ((srclen + adjustment) / 3) * 4;
+
+	dstlen = paddedlen + paddedlen / linelen;
+
+	if (dstlen == 0)
+		return nullptr;
 
 	char *dst = nullptr;
 	try
 	{
-		dst = new char[paddedsize];
+		dst = new char[dstlen + 1];
 	}
 	catch (std::exception &)
 	{
 		throw love::Exception("Out of memory.");
 	}
 
-	char *d = dst;
+	if (linelen != std::numeric_limits<size_t>::max() && linelen % 4 != 0)
+	{
+		b64_encode_unaligned(src, srclen, linelen, dst, dstlen);
+		return dst;
+	}
+
+	size_t linebytes = (linelen / 4) * 3;
+	size_t srcpos = 0;
+	size_t dstpos = 0;
+
+	while (srcpos < srclen)
+	{
+		size_t n = std::min(srclen - srcpos, linebytes);
+
+		size_t encoded = b64_encode_groups(src + srcpos, n, dst + dstpos);
+		dstpos += (encoded / 3) * 4;
+
+		if (encoded < n)
+		{
+			b64_encode_tail(src + srcpos + encoded, n - encoded, dst + dstpos);
+			dstpos += 4;
+		}
+
+		srcpos += n;
+
+		// Every complete line ends with a line break.
+		if (((n + 2) / 3) * 4 == linelen && dstpos < dstlen)
+			dst[dstpos++] = '\n';
+	}
+
+	dst[dstpos] = '\0';
+	return dst;
+}
+
+// Decodes groups of 4 characters until one contains a character outside the
+// base64 alphabet. Returns the number of characters consumed.
+static size_t b64_decode_groups(const uint8 *src, size_t srclen, uint8 *dst, const uint8 *table)
+{
+	size_t i = 0;
+
+#if defined(LOVE_B64_NEON)
+	// Characters below 64 index the first table and the rest index the second
+	// one, and anything at or above 128 is forced to be invalid.
+	const uint8x16x4_t lo = {{
+		vld1q_u8(table + 0), vld1q_u8(table + 16), vld1q_u8(table + 32), vld1q_u8(table + 48),
+	}};
+	const uint8x16x4_t hi = {{
+		vld1q_u8(table + 64), vld1q_u8(table + 80), vld1q_u8(table + 96), vld1q_u8(table + 112),
+	}};
+
+	for (; i + 64 <= srclen; i += 64, dst += 48)
+	{
+		uint8x16x4_t in = vld4q_u8(src + i);
+		uint8x16_t v[4];
+		uint8x16_t invalid = vdupq_n_u8(0);
+
+		for (int j = 0; j < 4; j++)
+		{
+			uint8x16_t t = vqtbl4q_u8(lo, in.val[j]);
+			t = vqtbx4q_u8(t, hi, vsubq_u8(in.val[j], vdupq_n_u8(64)));
+			v[j] = vorrq_u8(t, vandq_u8(in.val[j], vdupq_n_u8(0x80)));
+			invalid = vorrq_u8(invalid, v[j]);
+		}
+
+		if (vmaxvq_u8(invalid) & 0x80)
+			break;
+
+		uint8x16x3_t out;
+		out.val[0] = vorrq_u8(vshlq_n_u8(v[0], 2), vshrq_n_u8(v[1], 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(v[1], 4), vshrq_n_u8(v[2], 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(v[2], 6), v[3]);
+		vst3q_u8(dst, out);
+	}
+#endif
+
+	for (; i + 4 <= srclen; i += 4, dst += 3)
+	{
+		uint32 a = table[src[i + 0]];
+		uint32 b = table[src[i + 1]];
+		uint32 c = table[src[i + 2]];
+		uint32 d = table[src[i + 3]];
+
+		if ((a | b | c | d) & 0x80)
+			break;
+
+		uint32 v = (a << 18) | (b << 12) | (c << 6) | d;
+		dst[0] = (uint8) (v >> 16);
+		dst[1] = (uint8) (v >> 8);
+		dst[2] = (uint8) v;
+	}
+
+	return i;
+}
+
+size_t b64_decode_update(B64DecodeState &state, const char *src, size_t srclen, char *dst)
+{
+	const uint8 *table = getTables().decode;
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
 
-	char in[4]  = {0};
-	char out[3] = {0};
-	size_t i, len, srcpos = 0;
+	size_t i = 0;
 
-	while (srcpos <= srclen)
+	while (i < srclen)
 	{
-		for (len = 0, i = 0; i < 4 && srcpos <= srclen; i++)
+		// Runs of whole groups take the fast path. Anything else (line breaks,
+		// padding, a group split across calls) goes one character at a time.
+		if (state.count == 0)
 		{
-			char v = 0;
-
-			while (srcpos <= srclen && v == 0)
-			{
-				v = src[srcpos++];
-				v = (char)((v < 43 || v > 122) ? 0 : cd64[v - 43]);
-				if (v != 0)
-					v = (char)((v == '$') ? 0 : v - 61);
-			}
-
-			if (srcpos <= srclen)
-			{
-				len++;
-				if (v != 0)
-					in[i] = (char)(v - 1);
-			}
-			else
-				in[i] = 0;
+			size_t n = b64_decode_groups(s + i, srclen - i, d, table);
+			i += n;
+			d += (n / 4) * 3;
+
+			if (i >= srclen)
+				break;
 		}
 
-		if (len)
+		uint8 v = table[s[i++]];
+		if (v & 0x80)
+			continue;
+
+		state.bits = (state.bits << 6) | v;
+
+		if (++state.count == 4)
 		{
-			b64_decode_block(in, out);
-			for (i = 0; i < len - 1; i++)
-				 *(d++) = out[i];
+			d[0] = (uint8) (state.bits >> 16);
+			d[1] = (uint8) (state.bits >> 8);
+			d[2] = (uint8) state.bits;
+			d += 3;
+
+			state.bits = 0;
+			state.count = 0;
 		}
 	}
 
-	size = (size_t)(ptrdiff_t) (d - dst);
+	return (size_t) (d - (uint8 *) dst);
+}
+
+size_t b64_decode_finish(B64DecodeState &state, char *dst)
+{
+	size_t size = 0;
+
+	// A trailing group of n characters holds n - 1 whole bytes.
+	if (state.count > 1)
+	{
+		uint32 bits = state.bits << (6 * (4 - state.count));
+		size = (size_t) state.count - 1;
+
+		dst[0] = (char) (bits >> 16);
+		if (size > 1)
+			dst[1] = (char) (bits >> 8);
+	}
+
+	state.bits = 0;
+	state.count = 0;
+	return size;
+}
+
+char *b64_decode(const char *src, size_t srclen, size_t &size)
+{
+	size_t paddedsize = (srclen / 4) * 3 + 3;
+
+	char *dst = nullptr;
+	try
+	{
+		dst = new char[paddedsize];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	B64DecodeState state;
+	size = b64_decode_update(state, src, srclen, dst);
+	size += b64_decode_finish(state, dst + size);
+
 	return dst;
 }
 
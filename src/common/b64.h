@@ -19,6 +19,7 @@
  **/
 
 #include "config.h"
+#include "int.h"
 
 #include <stddef.h>
 
@@ -50,6 +51,49 @@ char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
  */
 char *b64_decode(const char *src, size_t srclen, size_t &dstlen);
 
+/**
+ * Base64-encodes whole 3-byte groups of src into dst, without padding or line
+ * breaks. Any trailing 1 or 2 bytes are not consumed.
+ *
+ * @param dst Must have room for (srclen / 3) * 4 characters.
+ * @return The number of bytes of src which were encoded.
+ */
+size_t b64_encode_groups(const char *src, size_t srclen, char *dst);
+
+/**
+ * Base64-encodes the final 1 or 2 bytes of a stream as a padded 4-character
+ * block.
+ */
+void b64_encode_tail(const char *src, size_t srclen, char dst[4]);
+
+/**
+ * Partial state of a base64 decode that can be resumed with more input.
+ */
+struct B64DecodeState
+{
+	uint32 bits = 0;
+	int count = 0;
+};
+
+/**
+ * Decodes base64 characters into dst. Characters outside the base64 alphabet
+ * (including '=' and whitespace) are skipped. Up to 3 characters of an
+ * incomplete group are kept in the state for the next call.
+ *
+ * @param dst Must have room for ((state.count + srclen) / 4) * 3 bytes.
+ * @return The number of bytes written to dst.
+ */
+size_t b64_decode_update(B64DecodeState &state, const char *src, size_t srclen, char *dst);
+
+/**
+ * Decodes any characters of an incomplete group left in the state, and resets
+ * the state.
+ *
+ * @param dst Must have room for 2 bytes.
+ * @return The number of bytes written to dst.
+ */
+size_t b64_decode_finish(B64DecodeState &state, char *dst);
+
 } // love
 
 #endif // LOVE_B64_H
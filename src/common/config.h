@@ -69,6 +69,11 @@
 #	endif
 #endif
 
+// SSE2 instructions.
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define LOVE_SIMD_SSE2
+#endif
+
 // NEON instructions.
 #if defined(__ARM_NEON) || defined(_M_ARM64)
 #	define LOVE_SIMD_NEON
@@ -133,6 +138,10 @@
 #	define LOVE_GRAPHICS_METAL
 #endif
 
+#if defined(LOVE_WINDOWS) && !defined(LOVE_WINDOWS_UWP)
+#	define LOVE_VIDEO_MEDIAFOUNDATION
+#endif
+
 // Autotools config.h
 #ifdef HAVE_CONFIG_H
 #	include <../config.h>
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "hex.h"
+
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+
+static const char hexchars[] = "0123456789abcdef";
+
+void hex_encode(const uint8 *src, size_t srclen, char *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	// Nibbles become '0' + n, plus the distance from '9' + 1 to 'a' if n > 9.
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i zero = _mm_set1_epi8('0');
+	const __m128i letter = _mm_set1_epi8('a' - '0' - 10);
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		__m128i in = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+		__m128i lo = _mm_and_si128(in, mask);
+
+		hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+		lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 0), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const uint8x16_t nine = vdupq_n_u8(9);
+	const uint8x16_t zero = vdupq_n_u8('0');
+	const uint8x16_t letter = vdupq_n_u8('a' - '0' - 10);
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		uint8x16_t in = vld1q_u8(src + i);
+		uint8x16_t hi = vshrq_n_u8(in, 4);
+		uint8x16_t lo = vandq_u8(in, vdupq_n_u8(0x0F));
+
+		uint8x16x2_t out;
+		out.val[0] = vaddq_u8(vaddq_u8(hi, zero), vandq_u8(vcgtq_u8(hi, nine), letter));
+		out.val[1] = vaddq_u8(vaddq_u8(lo, zero), vandq_u8(vcgtq_u8(lo, nine), letter));
+		vst2q_u8((uint8 *) dst + i * 2, out);
+	}
+#endif
+
+	for (; i < srclen; i++)
+	{
+		uint8 b = src[i];
+		dst[i * 2 + 0] = hexchars[b >> 4];
+		dst[i * 2 + 1] = hexchars[b & 0xF];
+	}
+}
+
+uint8 hex_nibble(char c)
+{
+	if (c >= '0' && c <= '9')
+		return (uint8) (c - '0');
+
+	if (c >= 'A' && c <= 'F')
+		return (uint8) (c - 'A' + 0x0a);
+
+	if (c >= 'a' && c <= 'f')
+		return (uint8) (c - 'a' + 0x0a);
+
+	return 0;
+}
+
+void hex_decode(const char *src, size_t srclen, uint8 *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	// Signed compares are fine here: every hex digit is below 0x80, and bytes
+	// at or above it compare as negative and so match no range.
+	auto nibbles = [](__m128i c) -> __m128i
+	{
+		__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+		__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('F' + 1)));
+		__m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('f' + 1)));
+
+		__m128i n = _mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0')));
+		n = _mm_or_si128(n, _mm_and_si128(upper, _mm_sub_epi8(c, _mm_set1_epi8('A' - 10))));
+		n = _mm_or_si128(n, _mm_and_si128(lower, _mm_sub_epi8(c, _mm_set1_epi8('a' - 10))));
+
+		// Each 16-bit lane holds a pair of characters, first one in the low
+		// byte. Combine them into a byte value in the low half of the lane.
+		__m128i first = _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00FF)), 4);
+		__m128i second = _mm_srli_epi16(n, 8);
+		return _mm_or_si128(first, second);
+	};
+
+	for (; i + 32 <= srclen; i += 32)
+	{
+		__m128i a = nibbles(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+		__m128i b = nibbles(_mm_loadu_si128((const __m128i *) (src + i + 16)));
+		_mm_storeu_si128((__m128i *) (dst + i / 2), _mm_packus_epi16(a, b));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	auto nibbles = [](uint8x16_t c) -> uint8x16_t
+	{
+		uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+		uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+		uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+
+		uint8x16_t n = vandq_u8(vcltq_u8(digit, vdupq_n_u8(10)), digit);
+		n = vorrq_u8(n, vandq_u8(vcltq_u8(upper, vdupq_n_u8(6)), vaddq_u8(upper, vdupq_n_u8(10))));
+		n = vorrq_u8(n, vandq_u8(vcltq_u8(lower, vdupq_n_u8(6)), vaddq_u8(lower, vdupq_n_u8(10))));
+		return n;
+	};
+
+	for (; i + 32 <= srclen; i += 32)
+	{
+		uint8x16x2_t in = vld2q_u8((const uint8 *) src + i);
+		uint8x16_t hi = nibbles(in.val[0]);
+		uint8x16_t lo = nibbles(in.val[1]);
+		vst1q_u8(dst + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+	}
+#endif
+
+	for (; i + 2 <= srclen; i += 2)
+		dst[i / 2] = (uint8) ((hex_nibble(src[i]) << 4) | hex_nibble(src[i + 1]));
+}
+
+} // love
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_HEX_H
+#define LOVE_HEX_H
+
+#include "config.h"
+#include "int.h"
+
+#include <stddef.h>
+
+namespace love
+{
+
+/**
+ * Writes the lowercase hexadecimal representation of src to dst.
+ *
+ * @param dst Must have room for srclen * 2 characters.
+ */
+void hex_encode(const uint8 *src, size_t srclen, char *dst);
+
+/**
+ * Converts pairs of hexadecimal characters in src to bytes. Characters which
+ * aren't hexadecimal digits are treated as 0.
+ *
+ * @param srclen The number of characters to convert. Must be even.
+ * @param dst Must have room for srclen / 2 bytes.
+ */
+void hex_decode(const char *src, size_t srclen, uint8 *dst);
+
+/**
+ * Gets the value of a single hexadecimal character, or 0 if it isn't one.
+ */
+uint8 hex_nibble(char c);
+
+} // love
+
+#endif // LOVE_HEX_H
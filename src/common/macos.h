@@ -63,6 +63,12 @@ bool getMetalLayerVSync(void *metallayer);
  **/
 void setWindowSRGBColorSpace(SDL_Window *window);
 
+/**
+ * Gets the refresh rate range of the window's screen, if it supports adaptive
+ * sync (macOS 12+). Returns false otherwise.
+ **/
+bool getWindowRefreshRateRange(SDL_Window *window, double &minrate, double &maxrate);
+
 } // macos
 } // love
 
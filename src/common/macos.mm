@@ -129,6 +129,36 @@ void setWindowSRGBColorSpace(SDL_Window *window)
 	}
 }
 
+bool getWindowRefreshRateRange(SDL_Window *window, double &minrate, double &maxrate)
+{
+	@autoreleasepool
+	{
+		if (@available(macOS 12.0, *))
+		{
+			SDL_SysWMinfo info = {};
+			SDL_VERSION(&info.version);
+			if (!SDL_GetWindowWMInfo(window, &info))
+				return false;
+
+			NSScreen *screen = info.info.cocoa.window.screen;
+			if (screen == nil)
+				return false;
+
+			// The intervals are equal on fixed refresh rate displays.
+			NSTimeInterval mininterval = screen.minimumRefreshInterval;
+			NSTimeInterval maxinterval = screen.maximumRefreshInterval;
+			if (mininterval <= 0.0 || maxinterval <= mininterval)
+				return false;
+
+			minrate = 1.0 / maxinterval;
+			maxrate = 1.0 / mininterval;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // macos
 } // love
 
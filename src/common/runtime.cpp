@@ -22,6 +22,7 @@
 #include "runtime.h"
 
 // LOVE
+#include "Data.h"
 #include "Module.h"
 #include "Object.h"
 #include "Reference.h"
@@ -422,6 +423,9 @@ int luax_require(lua_State *L, const char *name)
 	return 1;
 }
 
+// The module whose types are currently being registered on this thread.
+static thread_local const char *registeringModuleName = nullptr;
+
 int luax_register_module(lua_State *L, const WrappedModule &m)
 {
 	m.type->init();
@@ -456,8 +460,13 @@ int luax_register_module(lua_State *L, const WrappedModule &m)
 	// Register types.
 	if (m.types != nullptr)
 	{
+		const char *prevModuleName = registeringModuleName;
+		registeringModuleName = m.name;
+
 		for (const lua_CFunction *t = m.types; *t != nullptr; t++)
 			(*t)(L);
+
+		registeringModuleName = prevModuleName;
 	}
 
 	lua_pushvalue(L, -1);
@@ -484,6 +493,9 @@ int luax_register_type(lua_State *L, love::Type *type, ...)
 {
 	type->init();
 
+	if (registeringModuleName != nullptr)
+		type->setModuleName(registeringModuleName);
+
 	// Get the place for storing and re-using instantiated love types.
 	luax_getregistry(L, REGISTRY_OBJECTS);
 
@@ -616,6 +628,9 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 
 	object->retain();
 
+	size_t bytes = type.isa(Data::type) ? ((Data *) object)->getSize() : 0;
+	object->setAccountedType(type, bytes);
+
 	u->object = object;
 	u->type = &type;
 
@@ -709,7 +724,170 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
-Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<const void*> *tableSet)
+template <typename T>
+static void flatWrite(std::vector<uint8> &buffer, const T &value)
+{
+	size_t offset = buffer.size();
+	buffer.resize(offset + sizeof(T));
+	memcpy(&buffer[offset], &value, sizeof(T));
+}
+
+template <typename T>
+static T flatRead(const uint8 *&p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+	return value;
+}
+
+// Appends the value at index n to the flat table. Returns false if the value
+// can't be stored. parents holds the tables currently being flattened.
+static bool flattenValue(lua_State *L, int n, bool allowuserdata, Variant::FlatTable *table, std::vector<const void *> &parents)
+{
+	using FlatTable = Variant::FlatTable;
+	std::vector<uint8> &buffer = table->buffer;
+
+	if (n < 0)
+		n += lua_gettop(L) + 1;
+
+	switch (lua_type(L, n))
+	{
+	case LUA_TBOOLEAN:
+		buffer.push_back(luax_toboolean(L, n) ? FlatTable::TAG_TRUE : FlatTable::TAG_FALSE);
+		return true;
+	case LUA_TNUMBER:
+		buffer.push_back(FlatTable::TAG_NUMBER);
+		flatWrite(buffer, (double) lua_tonumber(L, n));
+		return true;
+	case LUA_TSTRING:
+	{
+		size_t len = 0;
+		const char *str = lua_tolstring(L, n, &len);
+		buffer.push_back(FlatTable::TAG_STRING);
+		flatWrite(buffer, (uint32) len);
+		buffer.insert(buffer.end(), (const uint8 *) str, (const uint8 *) str + len);
+		return true;
+	}
+	case LUA_TLIGHTUSERDATA:
+		buffer.push_back(FlatTable::TAG_LUSERDATA);
+		flatWrite(buffer, lua_touserdata(L, n));
+		return true;
+	case LUA_TUSERDATA:
+	{
+		if (!allowuserdata)
+		{
+			luax_typerror(L, n, "copyable Lua value");
+			return false;
+		}
+		Proxy *p = tryextractproxy(L, n);
+		if (p == nullptr)
+		{
+			luax_typerror(L, n, "love type");
+			return false;
+		}
+		if (p->object == nullptr)
+		{
+			buffer.push_back(FlatTable::TAG_NIL);
+			return true;
+		}
+		buffer.push_back(FlatTable::TAG_LOVEOBJECT);
+		flatWrite(buffer, (uint32) table->objects.size());
+		table->objects.push_back(*p);
+		p->object->retain();
+		return true;
+	}
+	case LUA_TNIL:
+		buffer.push_back(FlatTable::TAG_NIL);
+		return true;
+	case LUA_TTABLE:
+	{
+		const void *tablePointer = lua_topointer(L, n);
+		if (std::find(parents.begin(), parents.end(), tablePointer) != parents.end())
+			throw love::Exception("Cycle detected in table");
+
+		parents.push_back(tablePointer);
+
+		buffer.push_back(FlatTable::TAG_TABLE);
+		flatWrite(buffer, (uint32) luax_objlen(L, n));
+		size_t countOffset = buffer.size();
+		flatWrite(buffer, (uint32) 0);
+
+		uint32 count = 0;
+		lua_pushnil(L);
+		while (lua_next(L, n))
+		{
+			if (!flattenValue(L, -2, allowuserdata, table, parents) || !flattenValue(L, -1, allowuserdata, table, parents))
+			{
+				lua_pop(L, 2);
+				return false;
+			}
+			lua_pop(L, 1);
+			count++;
+		}
+
+		memcpy(&buffer[countOffset], &count, sizeof(uint32));
+		parents.pop_back();
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Pushes the value at p and advances p past it.
+static void pushFlatValue(lua_State *L, const Variant::FlatTable *table, const uint8 *&p)
+{
+	using FlatTable = Variant::FlatTable;
+
+	switch (*p++)
+	{
+	case FlatTable::TAG_FALSE:
+		lua_pushboolean(L, 0);
+		break;
+	case FlatTable::TAG_TRUE:
+		lua_pushboolean(L, 1);
+		break;
+	case FlatTable::TAG_NUMBER:
+		lua_pushnumber(L, flatRead<double>(p));
+		break;
+	case FlatTable::TAG_STRING:
+	{
+		uint32 len = flatRead<uint32>(p);
+		lua_pushlstring(L, (const char *) p, len);
+		p += len;
+		break;
+	}
+	case FlatTable::TAG_LUSERDATA:
+		lua_pushlightuserdata(L, flatRead<void *>(p));
+		break;
+	case FlatTable::TAG_LOVEOBJECT:
+	{
+		const Proxy &proxy = table->objects[flatRead<uint32>(p)];
+		luax_pushtype(L, *proxy.type, proxy.object);
+		break;
+	}
+	case FlatTable::TAG_TABLE:
+	{
+		uint32 arraysize = flatRead<uint32>(p);
+		uint32 count = flatRead<uint32>(p);
+		lua_createtable(L, (int) arraysize, (int) (count - std::min(count, arraysize)));
+		for (uint32 i = 0; i < count; i++)
+		{
+			pushFlatValue(L, table, p);
+			pushFlatValue(L, table, p);
+			lua_rawset(L, -3);
+		}
+		break;
+	}
+	case FlatTable::TAG_NIL:
+	default:
+		lua_pushnil(L);
+		break;
+	}
+}
+
+Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata)
 {
 	size_t len;
 	const char *str;
@@ -747,53 +925,16 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
-			std::set<const void *> topTableSet;
-
-			// We can use a pointer to a stack-allocated variable because it's
-			// never used after the stack-allocated variable is destroyed.
-			if (tableSet == nullptr)
-				tableSet = &topTableSet;
-
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
-			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
-			}
-
-			Variant::SharedTable *table = new Variant::SharedTable();
-
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->pairs.reserve(len);
-
-			lua_pushnil(L);
+			// Nested tables are serialized into the same buffer, see FlatTable.
+			StrongRef<Variant::FlatTable> table(new Variant::FlatTable(), Acquire::NORETAIN);
+			std::vector<const void *> parents;
+			table->buffer.reserve(256);
 
-			while (lua_next(L, n))
+			if (flattenValue(L, n, allowuserdata, table, parents))
 			{
-				table->pairs.emplace_back(
-					luax_checkvariant(L, -2, allowuserdata, tableSet),
-					luax_checkvariant(L, -1, allowuserdata, tableSet)
-				);
-				lua_pop(L, 1);
-
-				const auto &p = table->pairs.back();
-				if (p.first.getType() == Variant::UNKNOWN || p.second.getType() == Variant::UNKNOWN)
-				{
-					success = false;
-					break;
-				}
+				table->retain();
+				return Variant(table.get());
 			}
-
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
-
-			if (success)
-				return Variant(table);
-			else
-				table->release();
 		}
 		break;
 	}
@@ -841,6 +982,12 @@ void luax_pushvariant(lua_State *L, const Variant &v)
 
 		break;
 	}
+	case Variant::FLATTABLE:
+	{
+		const uint8 *p = data.flattable->buffer.data();
+		pushFlatValue(L, data.flattable, p);
+		break;
+	}
 	case Variant::NIL:
 	default:
 		lua_pushnil(L);
@@ -355,7 +355,7 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object);
 /**
  * Stores the value at the given index on the stack into a Variant object.
  */
-LOVE_EXPORT Variant luax_checkvariant(lua_State *L, int idx, bool allowuserdata = true, std::set<const void*> *tableSet = nullptr);
+LOVE_EXPORT Variant luax_checkvariant(lua_State *L, int idx, bool allowuserdata = true);
 
 /**
  * Pushes the contents of the given Variant index onto the stack.
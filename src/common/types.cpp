@@ -33,6 +33,9 @@ Type::Type(const char *name, Type *parent)
 	, parent(parent)
 	, id(0)
 	, inited(false)
+	, objectCount(0)
+	, objectBytes(0)
+	, moduleName(nullptr)
 {
 }
 
@@ -77,4 +80,44 @@ Type *Type::byName(const char *name)
 	return pos->second;
 }
 
+void Type::getTypes(std::vector<Type *> &out)
+{
+	out.reserve(out.size() + types.size());
+	for (const auto &kvp : types)
+		out.push_back(kvp.second);
+}
+
+void Type::addObject(size_t bytes)
+{
+	objectCount.fetch_add(1, std::memory_order_relaxed);
+	objectBytes.fetch_add((int64) bytes, std::memory_order_relaxed);
+}
+
+void Type::removeObject(size_t bytes)
+{
+	objectCount.fetch_sub(1, std::memory_order_relaxed);
+	objectBytes.fetch_sub((int64) bytes, std::memory_order_relaxed);
+}
+
+int64 Type::getObjectCount() const
+{
+	return objectCount.load(std::memory_order_relaxed);
+}
+
+int64 Type::getObjectBytes() const
+{
+	return objectBytes.load(std::memory_order_relaxed);
+}
+
+void Type::setModuleName(const char *module)
+{
+	const char *expected = nullptr;
+	moduleName.compare_exchange_strong(expected, module);
+}
+
+const char *Type::getModuleName() const
+{
+	return moduleName.load(std::memory_order_relaxed);
+}
+
 } // love
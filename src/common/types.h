@@ -24,6 +24,7 @@
 #include "int.h"
 
 // STD
+#include <atomic>
 #include <bitset>
 #include <vector>
 
@@ -40,10 +41,31 @@ public:
 
 	static Type *byName(const char *name);
 
+	/**
+	 * Gets all initialized types.
+	 **/
+	static void getTypes(std::vector<Type *> &types);
+
 	void init();
 	uint32 getId();
 	const char *getName() const;
 
+	/**
+	 * Live object statistics for objects of exactly this type. See
+	 * Object::setAccountedType.
+	 **/
+	void addObject(size_t bytes);
+	void removeObject(size_t bytes);
+	int64 getObjectCount() const;
+	int64 getObjectBytes() const;
+
+	/**
+	 * The name of the module which registered this type with Lua, or null.
+	 * Only the first module to register the type is kept.
+	 **/
+	void setModuleName(const char *module);
+	const char *getModuleName() const;
+
 	bool isa(const uint32 &other)
 	{
 		if (!inited)
@@ -53,6 +75,9 @@ public:
 
 	bool isa(const Type &other)
 	{
+		// Fast path for the common case of an exact type match.
+		if (this == &other)
+			return true;
 		if (!inited)
 			init();
 		// Note that if this type implements the other
@@ -67,6 +92,9 @@ private:
 	uint32 id;
 	bool inited;
 	std::bitset<MAX_TYPES> bits;
+	std::atomic<int64> objectCount;
+	std::atomic<int64> objectBytes;
+	std::atomic<const char *> moduleName;
 };
 
 } // love
@@ -20,6 +20,151 @@
 
 #include "utf8.h"
 
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+
+// Widens up to the next non-ASCII byte in chunks of 16 bytes. Returns the
+// number of bytes converted.
+static size_t decodeASCII16(const uint8 *s, size_t len, uint32 *out)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+		if (_mm_movemask_epi8(v) != 0)
+			break;
+
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128((__m128i *) (out + i +  0), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (out + i +  4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (out + i +  8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *) (out + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 16 <= len; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(s + i);
+		uint8x8_t any = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+		if ((vget_lane_u64(vreinterpret_u64_u8(any), 0) & 0x8080808080808080ULL) != 0)
+			break;
+
+		uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+		vst1q_u32(out + i +  0, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(out + i +  4, vmovl_u16(vget_high_u16(lo)));
+		vst1q_u32(out + i +  8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(out + i + 12, vmovl_u16(vget_high_u16(hi)));
+	}
+#else
+	(void) s; (void) len; (void) out;
+#endif
+
+	return i;
+}
+
+bool decodeUTF8(const char *str, size_t len, std::vector<uint32> &codepoints)
+{
+	const uint8 *s = (const uint8 *) str;
+	size_t start = codepoints.size();
+
+	// There are never more code points than bytes.
+	codepoints.resize(start + len);
+	uint32 *out = codepoints.data() + start;
+
+	size_t i = 0;
+	size_t n = 0;
+
+	while (i < len)
+	{
+		// decodeASCII16 writes one code point per byte, so out and s stay in
+		// step for the run it converts.
+		size_t ascii = decodeASCII16(s + i, len - i, out + n);
+		i += ascii;
+		n += ascii;
+
+		if (i >= len)
+			break;
+
+		while (i < len && s[i] < 0x80)
+			out[n++] = s[i++];
+
+		if (i >= len)
+			break;
+
+		uint32 c = s[i];
+
+		size_t extra = 0;
+		uint32 minimum = 0;
+
+		if ((c & 0xE0) == 0xC0)
+		{
+			extra = 1;
+			c &= 0x1F;
+			minimum = 0x80;
+		}
+		else if ((c & 0xF0) == 0xE0)
+		{
+			extra = 2;
+			c &= 0x0F;
+			minimum = 0x800;
+		}
+		else if ((c & 0xF8) == 0xF0)
+		{
+			extra = 3;
+			c &= 0x07;
+			minimum = 0x10000;
+		}
+		else
+		{
+			codepoints.resize(start);
+			return false;
+		}
+
+		if (len - i <= extra)
+		{
+			codepoints.resize(start);
+			return false;
+		}
+
+		for (size_t k = 1; k <= extra; k++)
+		{
+			uint32 b = s[i + k];
+			if ((b & 0xC0) != 0x80)
+			{
+				codepoints.resize(start);
+				return false;
+			}
+			c = (c << 6) | (b & 0x3F);
+		}
+
+		if (c < minimum || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+		{
+			codepoints.resize(start);
+			return false;
+		}
+
+		out[n++] = c;
+		i += extra + 1;
+	}
+
+	codepoints.resize(start + n);
+	return true;
+}
+
+} // love
+
 #ifdef LOVE_WINDOWS
 
 namespace love
@@ -18,7 +18,31 @@
  * 3. This notice may not be removed or altered from any source distribution.
  **/
 
+#ifndef LOVE_UTF8_H
+#define LOVE_UTF8_H
+
 #include "config.h"
+#include "int.h"
+
+#include <stddef.h>
+#include <vector>
+
+namespace love
+{
+
+/**
+ * Decodes a UTF-8 string and appends its code points. Runs of ASCII are
+ * handled 16 bytes at a time with SSE2 or NEON when available.
+ * Overlong sequences, surrogates and values above U+10FFFF are rejected.
+ * @param str The UTF-8 string.
+ * @param len The length of the string in bytes.
+ * @param codepoints The decoded code points are appended to this.
+ * @return False if the string isn't valid UTF-8, in which case codepoints is
+ *         left unchanged.
+ **/
+bool decodeUTF8(const char *str, size_t len, std::vector<uint32> &codepoints);
+
+} // love
 
 #ifdef LOVE_WINDOWS
 
@@ -53,3 +77,5 @@ void replace_char(std::string &str, char find, char replace);
 } // love
 
 #endif // LOVE_WINDOWS
+
+#endif // LOVE_UTF8_H
@@ -392,6 +392,7 @@ private:
 
 	friend class b2World;
 	friend class b2Island;
+	friend class b2IslandBatch;
 	friend class b2ContactManager;
 	friend class b2ContactSolver;
 	friend class b2Contact;
@@ -432,6 +433,10 @@ private:
 
 	void Advance(float t);
 
+	// Index of this body in the island being solved. Islands solved in parallel
+	// share static bodies, so those are looked up through the island's table.
+	int32 GetIslandIndex(const int32* staticIndices) const;
+
 	b2BodyType m_type;
 
 	uint16 m_flags;
@@ -658,6 +663,16 @@ inline void b2Body::SetAwake(bool flag)
 	}
 }
 
+inline int32 b2Body::GetIslandIndex(const int32* staticIndices) const
+{
+	if (staticIndices != nullptr && m_type == b2_staticBody)
+	{
+		return staticIndices[m_islandIndex];
+	}
+
+	return m_islandIndex;
+}
+
 inline bool b2Body::IsAwake() const
 {
 	return (m_flags & e_awakeFlag) == e_awakeFlag;
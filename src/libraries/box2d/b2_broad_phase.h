@@ -28,6 +28,8 @@
 #include "b2_collision.h"
 #include "b2_dynamic_tree.h"
 
+class b2TaskExecutor;
+
 struct B2_API b2Pair
 {
 	int32 proxyIdA;
@@ -56,6 +58,15 @@ public:
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
 
+	/// Proxies created between BeginBulkInsert and EndBulkInsert are not inserted
+	/// into the tree one at a time. EndBulkInsert rebuilds the whole tree top-down
+	/// instead. Proxies must not be moved, destroyed or queried in between.
+	void BeginBulkInsert();
+	void EndBulkInsert();
+
+	/// Rebuild the tree top-down, for better query performance.
+	void RebuildTree();
+
 	/// Call MoveProxy as many times as you like, then when you are done
 	/// call UpdatePairs to finalized the proxy pairs (for your time step).
 	void MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement);
@@ -76,8 +87,10 @@ public:
 	int32 GetProxyCount() const;
 
 	/// Update the pairs. This results in pair callbacks. This can only add pairs.
+	/// If an executor is given, the tree queries for moved proxies are spread over
+	/// its threads. Pairs are reported in the same order either way.
 	template <typename T>
-	void UpdatePairs(T* callback);
+	void UpdatePairs(T* callback, b2TaskExecutor* executor = nullptr);
 
 	/// Query an AABB for overlapping proxies. The callback class
 	/// is called for each proxy that overlaps the supplied AABB.
@@ -108,6 +121,16 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Write the tree and the pending move buffer into a buffer.
+	/// @param buffer the destination, or nullptr to only compute the size.
+	/// @return the number of bytes written.
+	int32 SaveState(void* buffer) const;
+
+	/// Restore a state written by SaveState. The broad-phase is left unchanged
+	/// if the size does not match the saved contents.
+	/// @return true if the state was restored.
+	bool RestoreState(const void* buffer, int32 size);
+
 private:
 
 	friend class b2DynamicTree;
@@ -117,10 +140,14 @@ private:
 
 	bool QueryCallback(int32 proxyId);
 
+	void QueryPairsParallel(b2TaskExecutor* executor);
+
 	b2DynamicTree m_tree;
 
 	int32 m_proxyCount;
 
+	bool m_bulkInsert;
+
 	int32* m_moveBuffer;
 	int32 m_moveCapacity;
 	int32 m_moveCount;
@@ -170,26 +197,33 @@ inline float b2BroadPhase::GetTreeQuality() const
 }
 
 template <typename T>
-void b2BroadPhase::UpdatePairs(T* callback)
+void b2BroadPhase::UpdatePairs(T* callback, b2TaskExecutor* executor)
 {
 	// Reset pair buffer
 	m_pairCount = 0;
 
-	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
+	if (executor != nullptr && m_moveCount >= b2_parallelPairThreshold)
+	{
+		QueryPairsParallel(executor);
+	}
+	else
 	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
+		// Perform tree queries for all moving proxies.
+		for (int32 i = 0; i < m_moveCount; ++i)
 		{
-			continue;
+			m_queryProxyId = m_moveBuffer[i];
+			if (m_queryProxyId == e_nullProxy)
+			{
+				continue;
+			}
+
+			// We have to query the tree with the fat AABB so that
+			// we don't fail to create a pair that may touch later.
+			const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+
+			// Query tree, create pairs and add them pair buffer.
+			m_tree.Query(this, fatAABB);
 		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
 	}
 
 	// Send pairs to caller
@@ -119,6 +119,15 @@ void loveAssert(bool test, const char* teststr);
 /// A body cannot sleep if its angular velocity is above this tolerance.
 #define b2_angularSleepTolerance	(2.0f / 180.0f * b2_pi)
 
+
+// Threading
+
+/// The fewest moved proxies for which the broad-phase queries the tree on a task executor.
+#define b2_parallelPairThreshold	256
+
+/// The number of moved proxies each broad-phase query task handles.
+#define b2_parallelPairBatch		64
+
 /// Dump to a file. Only one dump file allowed at a time.
 void b2OpenDump(const char* fileName);
 void b2Dump(const char* string, ...);
@@ -30,6 +30,7 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2TaskExecutor;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
@@ -52,6 +53,7 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2TaskExecutor* m_taskExecutor;
 };
 
 #endif
@@ -75,7 +75,9 @@ public:
 	~b2DynamicTree();
 
 	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
-	int32 CreateProxy(const b2AABB& aabb, void* userData);
+	/// @param deferInsert if true, the proxy is not linked into the tree until
+	/// the next RebuildTopDown, and must not be moved or destroyed before that.
+	int32 CreateProxy(const b2AABB& aabb, void* userData, bool deferInsert = false);
 
 	/// Destroy a proxy. This asserts if the id is invalid.
 	void DestroyProxy(int32 proxyId);
@@ -128,11 +130,26 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Rebuild the tree from all proxies by recursively splitting them at the
+	/// median along the longest axis. O(n log n), and produces a balanced tree
+	/// with tighter nodes than incremental insertion.
+	void RebuildTopDown();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Write the node pool into a buffer, so the exact tree can be restored later.
+	/// @param buffer the destination, or nullptr to only compute the size.
+	/// @return the number of bytes written.
+	int32 SaveState(void* buffer) const;
+
+	/// Restore a node pool written by SaveState. The tree is left unchanged if
+	/// the size does not match the saved contents.
+	/// @return true if the state was restored.
+	bool RestoreState(const void* buffer, int32 size);
+
 private:
 
 	int32 AllocateNode();
@@ -141,6 +158,8 @@ private:
 	void InsertLeaf(int32 node);
 	void RemoveLeaf(int32 node);
 
+	int32 BuildTopDown(int32* leaves, int32 count);
+
 	int32 Balance(int32 index);
 
 	int32 ComputeHeight() const;
@@ -38,6 +38,7 @@ struct b2JointDef;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2IslandBatch;
 class b2Joint;
 
 /// The world class manages all physics entities, dynamic simulation,
@@ -71,6 +72,13 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task executor to solve islands and find new broad-phase pairs on
+	/// several threads. The executor is owned by you and must remain in scope.
+	/// The results are the same as stepping on one thread, but PostSolve is only
+	/// called once every island has been solved. Pass nullptr to disable.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+	b2TaskExecutor* GetTaskExecutor() const;
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -204,6 +212,19 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Fixtures created between BeginBulkCreate and EndBulkCreate don't insert
+	/// their broad-phase proxies one at a time. EndBulkCreate rebuilds the tree
+	/// top-down in one pass instead. Nothing may be moved, destroyed or queried
+	/// in between.
+	/// @warning this should be called outside of a time step.
+	void BeginBulkCreate();
+	void EndBulkCreate();
+
+	/// Rebuild the broad-phase tree top-down, for better query performance after
+	/// many proxies were created or destroyed one at a time.
+	/// @warning this should be called outside of a time step.
+	void RebuildBroadPhase();
+
 	/// Get the contact manager for testing.
 	const b2ContactManager& GetContactManager() const;
 
@@ -214,6 +235,21 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// Write the simulation state of the world into a buffer: body motion, fixture
+	/// proxies, joint solver data, contacts with their warm starting impulses and
+	/// the broad-phase tree. Shapes and user data are not included.
+	/// @param buffer the destination, or nullptr to only compute the size.
+	/// @return the number of bytes written.
+	/// @warning this should be called outside of a time step.
+	int32 SaveState(void* buffer) const;
+
+	/// Restore a state written by SaveState. The world must contain the same bodies,
+	/// fixtures and joints it had when the state was saved. Existing contacts are
+	/// destroyed without listener callbacks and replaced by the saved ones.
+	/// @return false if the state does not match the world, which is then left unchanged.
+	/// @warning this should be called outside of a time step.
+	bool RestoreState(const void* buffer, int32 size);
+
 private:
 
 	friend class b2Body;
@@ -231,6 +267,9 @@ private:
 
 	b2ContactManager m_contactManager;
 
+	b2TaskExecutor* m_taskExecutor;
+	b2IslandBatch* m_islandBatch;
+
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
 
@@ -261,6 +300,11 @@ private:
 	b2Profile m_profile;
 };
 
+inline b2TaskExecutor* b2World::GetTaskExecutor() const
+{
+	return m_taskExecutor;
+}
+
 inline b2Body* b2World::GetBodyList()
 {
 	return m_bodyList;
@@ -158,4 +158,19 @@ public:
 									const b2Vec2& normal, float fraction) = 0;
 };
 
+/// Implement this class to let the world spread independent work over several
+/// threads. See b2World::SetTaskExecutor
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	typedef void b2TaskFunction(int32 begin, int32 end, void* context);
+
+	/// Call task on disjoint ranges that together cover [0, count), each at least
+	/// minRange items long (except possibly the last). Ranges may run concurrently,
+	/// and this must only return once all of them have finished.
+	virtual void ParallelFor(int32 count, int32 minRange, b2TaskFunction* task, void* context) = 0;
+};
+
 #endif
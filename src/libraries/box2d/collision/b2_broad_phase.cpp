@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "box2d/b2_broad_phase.h"
+#include "box2d/b2_world_callbacks.h"
 #include <string.h>
 
 b2BroadPhase::b2BroadPhase()
@@ -34,6 +35,8 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_bulkInsert = false;
 }
 
 b2BroadPhase::~b2BroadPhase()
@@ -44,12 +47,34 @@ b2BroadPhase::~b2BroadPhase()
 
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	int32 proxyId = m_tree.CreateProxy(aabb, userData, m_bulkInsert);
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
 }
 
+void b2BroadPhase::BeginBulkInsert()
+{
+	m_bulkInsert = true;
+}
+
+void b2BroadPhase::EndBulkInsert()
+{
+	if (m_bulkInsert == false)
+	{
+		return;
+	}
+
+	m_bulkInsert = false;
+	m_tree.RebuildTopDown();
+}
+
+void b2BroadPhase::RebuildTree()
+{
+	b2Assert(m_bulkInsert == false);
+	m_tree.RebuildTopDown();
+}
+
 void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
@@ -129,3 +154,178 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+// Gathers the pairs for one batch of moved proxies. Each batch has its own
+// buffer so batches can be queried concurrently.
+struct b2PairQuery
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		if (proxyId == queryProxyId)
+		{
+			return true;
+		}
+
+		const bool moved = tree->WasMoved(proxyId);
+		if (moved && proxyId > queryProxyId)
+		{
+			return true;
+		}
+
+		if (count == capacity)
+		{
+			b2Pair* oldBuffer = pairs;
+			capacity = b2Max(16, capacity + (capacity >> 1));
+			pairs = (b2Pair*)b2Alloc(capacity * sizeof(b2Pair));
+			if (oldBuffer != nullptr)
+			{
+				memcpy(pairs, oldBuffer, count * sizeof(b2Pair));
+				b2Free(oldBuffer);
+			}
+		}
+
+		pairs[count].proxyIdA = b2Min(proxyId, queryProxyId);
+		pairs[count].proxyIdB = b2Max(proxyId, queryProxyId);
+		++count;
+
+		return true;
+	}
+
+	const b2DynamicTree* tree;
+	const int32* moveBuffer;
+	int32 moveCount;
+	int32 queryProxyId;
+
+	b2Pair* pairs;
+	int32 count;
+	int32 capacity;
+};
+
+static void b2QueryPairBatches(int32 begin, int32 end, void* context)
+{
+	b2PairQuery* queries = (b2PairQuery*)context;
+
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2PairQuery* query = queries + i;
+		int32 first = i * b2_parallelPairBatch;
+		int32 last = b2Min(first + b2_parallelPairBatch, query->moveCount);
+
+		for (int32 j = first; j < last; ++j)
+		{
+			query->queryProxyId = query->moveBuffer[j];
+			if (query->queryProxyId == b2BroadPhase::e_nullProxy)
+			{
+				continue;
+			}
+
+			const b2AABB& fatAABB = query->tree->GetFatAABB(query->queryProxyId);
+			query->tree->Query(query, fatAABB);
+		}
+	}
+}
+
+void b2BroadPhase::QueryPairsParallel(b2TaskExecutor* executor)
+{
+	int32 batchCount = (m_moveCount + b2_parallelPairBatch - 1) / b2_parallelPairBatch;
+	b2PairQuery* queries = (b2PairQuery*)b2Alloc(batchCount * sizeof(b2PairQuery));
+	for (int32 i = 0; i < batchCount; ++i)
+	{
+		b2PairQuery* query = queries + i;
+		query->tree = &m_tree;
+		query->moveBuffer = m_moveBuffer;
+		query->moveCount = m_moveCount;
+		query->queryProxyId = e_nullProxy;
+		query->pairs = nullptr;
+		query->count = 0;
+		query->capacity = 0;
+	}
+
+	executor->ParallelFor(batchCount, 1, b2QueryPairBatches, queries);
+
+	// Gather the batches in move buffer order, so pairs come out exactly as
+	// they would from a serial query.
+	int32 pairCount = 0;
+	for (int32 i = 0; i < batchCount; ++i)
+	{
+		pairCount += queries[i].count;
+	}
+
+	if (pairCount > m_pairCapacity)
+	{
+		b2Free(m_pairBuffer);
+		m_pairCapacity = pairCount;
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	for (int32 i = 0; i < batchCount; ++i)
+	{
+		b2PairQuery* query = queries + i;
+		if (query->count > 0)
+		{
+			memcpy(m_pairBuffer + m_pairCount, query->pairs, query->count * sizeof(b2Pair));
+			m_pairCount += query->count;
+		}
+
+		if (query->pairs != nullptr)
+		{
+			b2Free(query->pairs);
+		}
+	}
+
+	b2Free(queries);
+}
+
+int32 b2BroadPhase::SaveState(void* buffer) const
+{
+	int32 header[2] = { m_proxyCount, m_moveCount };
+	int32 moveSize = m_moveCount * int32(sizeof(int32));
+	int32 size = int32(sizeof(header)) + moveSize;
+
+	if (buffer != nullptr)
+	{
+		uint8* data = (uint8*)buffer;
+		memcpy(data, header, sizeof(header));
+		memcpy(data + sizeof(header), m_moveBuffer, moveSize);
+		return size + m_tree.SaveState(data + size);
+	}
+
+	return size + m_tree.SaveState(nullptr);
+}
+
+bool b2BroadPhase::RestoreState(const void* buffer, int32 size)
+{
+	int32 header[2];
+	if (size < int32(sizeof(header)))
+	{
+		return false;
+	}
+
+	const uint8* data = (const uint8*)buffer;
+	memcpy(header, data, sizeof(header));
+
+	int32 moveCount = header[1];
+	if (moveCount < 0 || moveCount > (size - int32(sizeof(header))) / int32(sizeof(int32)))
+	{
+		return false;
+	}
+
+	int32 offset = int32(sizeof(header)) + moveCount * int32(sizeof(int32));
+	if (m_tree.RestoreState(data + offset, size - offset) == false)
+	{
+		return false;
+	}
+
+	if (moveCount > m_moveCapacity)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = moveCount;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+
+	memcpy(m_moveBuffer, data + sizeof(header), moveCount * sizeof(int32));
+	m_moveCount = moveCount;
+	m_proxyCount = header[0];
+
+	return true;
+}
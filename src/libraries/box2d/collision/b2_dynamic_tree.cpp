@@ -21,6 +21,7 @@
 // SOFTWARE.
 #include "box2d/b2_dynamic_tree.h"
 #include <string.h>
+#include <algorithm>
 
 b2DynamicTree::b2DynamicTree()
 {
@@ -104,7 +105,7 @@ void b2DynamicTree::FreeNode(int32 nodeId)
 // Create a proxy in the tree as a leaf node. We return the index
 // of the node instead of a pointer so that we can grow
 // the node pool.
-int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
+int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData, bool deferInsert)
 {
 	int32 proxyId = AllocateNode();
 
@@ -116,7 +117,10 @@ int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
 	m_nodes[proxyId].height = 0;
 	m_nodes[proxyId].moved = true;
 
-	InsertLeaf(proxyId);
+	if (deferInsert == false)
+	{
+		InsertLeaf(proxyId);
+	}
 
 	return proxyId;
 }
@@ -790,6 +794,84 @@ void b2DynamicTree::RebuildBottomUp()
 	Validate();
 }
 
+void b2DynamicTree::RebuildTopDown()
+{
+	int32* leaves = (int32*)b2Alloc(b2Max(m_nodeCount, 1) * sizeof(int32));
+	int32 count = 0;
+
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			m_nodes[i].parent = b2_nullNode;
+			leaves[count] = i;
+			++count;
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	m_root = count > 0 ? BuildTopDown(leaves, count) : b2_nullNode;
+	b2Free(leaves);
+
+	Validate();
+}
+
+int32 b2DynamicTree::BuildTopDown(int32* leaves, int32 count)
+{
+	if (count == 1)
+	{
+		return leaves[0];
+	}
+
+	// Split along the longest axis of the leaf centers.
+	b2Vec2 lower = m_nodes[leaves[0]].aabb.GetCenter();
+	b2Vec2 upper = lower;
+	for (int32 i = 1; i < count; ++i)
+	{
+		b2Vec2 c = m_nodes[leaves[i]].aabb.GetCenter();
+		lower = b2Min(lower, c);
+		upper = b2Max(upper, c);
+	}
+
+	int32 axis = (upper.x - lower.x) >= (upper.y - lower.y) ? 0 : 1;
+	int32 half = count / 2;
+
+	std::nth_element(leaves, leaves + half, leaves + count, [this, axis](int32 a, int32 b)
+	{
+		return m_nodes[a].aabb.GetCenter()(axis) < m_nodes[b].aabb.GetCenter()(axis);
+	});
+
+	int32 index1 = BuildTopDown(leaves, half);
+	int32 index2 = BuildTopDown(leaves + half, count - half);
+
+	// The node pool may grow here, so look the children up afterwards.
+	int32 parentIndex = AllocateNode();
+	b2TreeNode* parent = m_nodes + parentIndex;
+	b2TreeNode* child1 = m_nodes + index1;
+	b2TreeNode* child2 = m_nodes + index2;
+
+	parent->child1 = index1;
+	parent->child2 = index2;
+	parent->height = 1 + b2Max(child1->height, child2->height);
+	parent->aabb.Combine(child1->aabb, child2->aabb);
+	parent->parent = b2_nullNode;
+
+	child1->parent = parentIndex;
+	child2->parent = parentIndex;
+
+	return parentIndex;
+}
+
 void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	// Build array of leaves. Free the rest.
@@ -799,3 +881,60 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+int32 b2DynamicTree::SaveState(void* buffer) const
+{
+	int32 header[5] = { m_root, m_nodeCount, m_nodeCapacity, m_freeList, m_insertionCount };
+	int32 nodeSize = m_nodeCapacity * int32(sizeof(b2TreeNode));
+
+	if (buffer != nullptr)
+	{
+		uint8* data = (uint8*)buffer;
+		memcpy(data, header, sizeof(header));
+		memcpy(data + sizeof(header), m_nodes, nodeSize);
+	}
+
+	return int32(sizeof(header)) + nodeSize;
+}
+
+bool b2DynamicTree::RestoreState(const void* buffer, int32 size)
+{
+	int32 header[5];
+	if (size < int32(sizeof(header)))
+	{
+		return false;
+	}
+
+	const uint8* data = (const uint8*)buffer;
+	memcpy(header, data, sizeof(header));
+
+	int32 root = header[0];
+	int32 nodeCount = header[1];
+	int32 nodeCapacity = header[2];
+	int32 freeList = header[3];
+
+	if (nodeCapacity <= 0 || nodeCount < 0 || nodeCount > nodeCapacity
+		|| root < b2_nullNode || root >= nodeCapacity
+		|| freeList < b2_nullNode || freeList >= nodeCapacity
+		|| (size - int32(sizeof(header))) / int32(sizeof(b2TreeNode)) != nodeCapacity
+		|| (size - int32(sizeof(header))) % int32(sizeof(b2TreeNode)) != 0)
+	{
+		return false;
+	}
+
+	if (nodeCapacity != m_nodeCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodes = (b2TreeNode*)b2Alloc(nodeCapacity * sizeof(b2TreeNode));
+		m_nodeCapacity = nodeCapacity;
+	}
+
+	memcpy(m_nodes, data + sizeof(header), nodeCapacity * sizeof(b2TreeNode));
+
+	m_root = root;
+	m_nodeCount = nodeCount;
+	m_freeList = freeList;
+	m_insertionCount = header[4];
+
+	return true;
+}
@@ -36,6 +36,7 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_taskExecutor = nullptr;
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -175,7 +176,7 @@ void b2ContactManager::Collide()
 
 void b2ContactManager::FindNewContacts()
 {
-	m_broadPhase.UpdatePairs(this);
+	m_broadPhase.UpdatePairs(this, m_taskExecutor);
 }
 
 void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
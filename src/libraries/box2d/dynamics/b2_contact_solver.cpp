@@ -82,8 +82,8 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 		vc->restitution = contact->m_restitution;
 		vc->threshold = contact->m_restitutionThreshold;
 		vc->tangentSpeed = contact->m_tangentSpeed;
-		vc->indexA = bodyA->m_islandIndex;
-		vc->indexB = bodyB->m_islandIndex;
+		vc->indexA = bodyA->GetIslandIndex(def->staticIndices);
+		vc->indexB = bodyB->GetIslandIndex(def->staticIndices);
 		vc->invMassA = bodyA->m_invMass;
 		vc->invMassB = bodyB->m_invMass;
 		vc->invIA = bodyA->m_invI;
@@ -94,8 +94,8 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 		vc->normalMass.SetZero();
 
 		b2ContactPositionConstraint* pc = m_positionConstraints + i;
-		pc->indexA = bodyA->m_islandIndex;
-		pc->indexB = bodyB->m_islandIndex;
+		pc->indexA = bodyA->GetIslandIndex(def->staticIndices);
+		pc->indexB = bodyB->GetIslandIndex(def->staticIndices);
 		pc->invMassA = bodyA->m_invMass;
 		pc->invMassB = bodyB->m_invMass;
 		pc->localCenterA = bodyA->m_sweep.localCenter;
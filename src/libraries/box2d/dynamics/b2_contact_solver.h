@@ -68,6 +68,7 @@ struct b2ContactSolverDef
 	int32 count;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const int32* staticIndices;
 	b2StackAllocator* allocator;
 };
 
@@ -140,10 +140,10 @@ b2GearJoint::b2GearJoint(const b2GearJointDef* def)
 
 void b2GearJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
-	m_indexC = m_bodyC->m_islandIndex;
-	m_indexD = m_bodyD->m_islandIndex;
+	m_indexA = m_bodyA->GetIslandIndex(data.staticIndices);
+	m_indexB = m_bodyB->GetIslandIndex(data.staticIndices);
+	m_indexC = m_bodyC->GetIslandIndex(data.staticIndices);
+	m_indexD = m_bodyD->GetIslandIndex(data.staticIndices);
 	m_lcA = m_bodyA->m_sweep.localCenter;
 	m_lcB = m_bodyB->m_sweep.localCenter;
 	m_lcC = m_bodyC->m_sweep.localCenter;
@@ -32,6 +32,8 @@
 #include "b2_island.h"
 #include "b2_contact_solver.h"
 
+#include <new>
+
 /*
 Position Correction Notes
 =========================
@@ -155,7 +157,8 @@ b2Island::b2Island(
 	int32 contactCapacity,
 	int32 jointCapacity,
 	b2StackAllocator* allocator,
-	b2ContactListener* listener)
+	b2ContactListener* listener,
+	int32 staticCapacity)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
@@ -173,11 +176,23 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+
+	m_staticIndices = nullptr;
+	if (staticCapacity > 0)
+	{
+		m_staticIndices = (int32*)m_allocator->Allocate(staticCapacity * sizeof(int32));
+	}
+
+	m_impulses = nullptr;
 }
 
 b2Island::~b2Island()
 {
 	// Warning: the order should reverse the constructor order.
+	if (m_staticIndices != nullptr)
+	{
+		m_allocator->Free(m_staticIndices);
+	}
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
 	m_allocator->Free(m_joints);
@@ -201,9 +216,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies never move,
+		// and may be shared with islands being solved on other threads.
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -235,6 +254,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	solverData.step = step;
 	solverData.positions = m_positions;
 	solverData.velocities = m_velocities;
+	solverData.staticIndices = m_staticIndices;
 
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
@@ -243,6 +263,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.staticIndices = m_staticIndices;
 	contactSolverDef.allocator = m_allocator;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
@@ -335,6 +356,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -408,6 +434,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.staticIndices = nullptr;
 	b2ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -520,7 +547,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
-	if (m_listener == nullptr)
+	if (m_listener == nullptr && m_impulses == nullptr)
 	{
 		return;
 	}
@@ -539,6 +566,185 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 			impulse.tangentImpulses[j] = vc->points[j].tangentImpulse;
 		}
 
-		m_listener->PostSolve(c, &impulse);
+		if (m_impulses != nullptr)
+		{
+			m_impulses[i] = impulse;
+		}
+		else
+		{
+			m_listener->PostSolve(c, &impulse);
+		}
+	}
+}
+
+b2IslandBatch::b2IslandBatch()
+{
+	m_bodies = nullptr;
+	m_contacts = nullptr;
+	m_joints = nullptr;
+	m_impulses = nullptr;
+	m_islands = nullptr;
+
+	m_bodyCount = 0;
+	m_contactCount = 0;
+	m_jointCount = 0;
+	m_islandCount = 0;
+	m_staticCount = 0;
+
+	m_bodyCapacity = 0;
+	m_contactCapacity = 0;
+	m_jointCapacity = 0;
+	m_islandCapacity = 0;
+
+	m_allowSleep = true;
+}
+
+b2IslandBatch::~b2IslandBatch()
+{
+	b2Free(m_islands);
+	b2Free(m_impulses);
+	b2Free(m_joints);
+	b2Free(m_contacts);
+	b2Free(m_bodies);
+}
+
+void b2IslandBatch::Reset(int32 bodyCount, int32 contactCount, int32 jointCount)
+{
+	// A static body is gathered once for every island it touches, which is
+	// at most once per contact or joint.
+	int32 bodyCapacity = bodyCount + contactCount + jointCount;
+	if (bodyCapacity > m_bodyCapacity)
+	{
+		b2Free(m_bodies);
+		m_bodyCapacity = bodyCapacity;
+		m_bodies = (b2Body**)b2Alloc(m_bodyCapacity * sizeof(b2Body*));
+	}
+
+	if (contactCount > m_contactCapacity)
+	{
+		b2Free(m_impulses);
+		b2Free(m_contacts);
+		m_contactCapacity = contactCount;
+		m_contacts = (b2Contact**)b2Alloc(m_contactCapacity * sizeof(b2Contact*));
+		m_impulses = (b2ContactImpulse*)b2Alloc(m_contactCapacity * sizeof(b2ContactImpulse));
+	}
+
+	if (jointCount > m_jointCapacity)
+	{
+		b2Free(m_joints);
+		m_jointCapacity = jointCount;
+		m_joints = (b2Joint**)b2Alloc(m_jointCapacity * sizeof(b2Joint*));
+	}
+
+	if (bodyCount > m_islandCapacity)
+	{
+		b2Free(m_islands);
+		m_islandCapacity = bodyCount;
+		m_islands = (Range*)b2Alloc(m_islandCapacity * sizeof(Range));
+	}
+
+	m_bodyCount = 0;
+	m_contactCount = 0;
+	m_jointCount = 0;
+	m_islandCount = 0;
+	m_staticCount = 0;
+}
+
+void b2IslandBatch::EndIsland()
+{
+	b2Assert(m_islandCount < m_islandCapacity);
+
+	int32 bodyStart = 0;
+	int32 contactStart = 0;
+	int32 jointStart = 0;
+	if (m_islandCount > 0)
+	{
+		const Range& last = m_islands[m_islandCount - 1];
+		bodyStart = last.bodyStart + last.bodyCount;
+		contactStart = last.contactStart + last.contactCount;
+		jointStart = last.jointStart + last.jointCount;
+	}
+
+	Range* island = m_islands + m_islandCount++;
+	island->bodyStart = bodyStart;
+	island->bodyCount = m_bodyCount - bodyStart;
+	island->contactStart = contactStart;
+	island->contactCount = m_contactCount - contactStart;
+	island->jointStart = jointStart;
+	island->jointCount = m_jointCount - jointStart;
+
+	for (int32 i = bodyStart; i < m_bodyCount; ++i)
+	{
+		b2Body* b = m_bodies[i];
+		if (b->GetType() == b2_staticBody)
+		{
+			b->m_flags &= ~b2Body::e_islandFlag;
+		}
+	}
+}
+
+// Each task solves its islands with its own stack allocator, since the
+// world's one isn't thread safe.
+static void b2SolveIslands(int32 begin, int32 end, void* context)
+{
+	b2IslandBatch* batch = (b2IslandBatch*)context;
+
+	void* mem = b2Alloc(sizeof(b2StackAllocator));
+	b2StackAllocator* allocator = new (mem) b2StackAllocator;
+
+	for (int32 i = begin; i < end; ++i)
+	{
+		batch->SolveIsland(i, allocator);
+	}
+
+	allocator->~b2StackAllocator();
+	b2Free(mem);
+}
+
+void b2IslandBatch::Solve(b2TaskExecutor* executor, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
+{
+	m_step = step;
+	m_gravity = gravity;
+	m_allowSleep = allowSleep;
+
+	executor->ParallelFor(m_islandCount, 1, b2SolveIslands, this);
+}
+
+void b2IslandBatch::SolveIsland(int32 index, b2StackAllocator* allocator)
+{
+	const Range& range = m_islands[index];
+
+	b2Island island(range.bodyCount, range.contactCount, range.jointCount, allocator, nullptr, m_staticCount);
+	island.m_impulses = m_impulses + range.contactStart;
+
+	for (int32 i = 0; i < range.bodyCount; ++i)
+	{
+		island.Add(m_bodies[range.bodyStart + i]);
+	}
+
+	for (int32 i = 0; i < range.contactCount; ++i)
+	{
+		island.Add(m_contacts[range.contactStart + i]);
+	}
+
+	for (int32 i = 0; i < range.jointCount; ++i)
+	{
+		island.Add(m_joints[range.jointStart + i]);
+	}
+
+	b2Profile profile;
+	island.Solve(&profile, m_step, m_gravity, m_allowSleep);
+}
+
+void b2IslandBatch::Report(b2ContactListener* listener)
+{
+	if (listener == nullptr)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < m_contactCount; ++i)
+	{
+		listener->PostSolve(m_contacts[i], m_impulses + i);
 	}
 }
@@ -31,6 +31,8 @@ class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+class b2TaskExecutor;
+struct b2ContactImpulse;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
@@ -39,7 +41,7 @@ class b2Island
 {
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener, int32 staticCapacity = 0);
 	~b2Island();
 
 	void Clear()
@@ -56,7 +58,15 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+		if (m_staticIndices != nullptr && body->m_type == b2_staticBody)
+		{
+			// Shared with other islands, so the body keeps its slot in the table.
+			m_staticIndices[body->m_islandIndex] = m_bodyCount;
+		}
+		else
+		{
+			body->m_islandIndex = m_bodyCount;
+		}
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -85,6 +95,12 @@ public:
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 
+	// Maps the slots of static bodies to island indices, or nullptr.
+	int32* m_staticIndices;
+
+	// If set, Report stores the contact impulses here instead of calling the listener.
+	b2ContactImpulse* m_impulses;
+
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
@@ -94,4 +110,78 @@ public:
 	int32 m_jointCapacity;
 };
 
+/// Awake islands gathered by b2World::Solve, to be solved concurrently on a
+/// b2TaskExecutor. Static bodies can be part of several islands, so each one
+/// gets a slot instead of an island index. This is an internal class.
+class b2IslandBatch
+{
+public:
+	b2IslandBatch();
+	~b2IslandBatch();
+
+	/// Size the buffers for the worst case and remove all islands.
+	void Reset(int32 bodyCount, int32 contactCount, int32 jointCount);
+
+	void Add(b2Body* body)
+	{
+		b2Assert(m_bodyCount < m_bodyCapacity);
+		if (body->m_type == b2_staticBody && body->m_islandIndex < 0)
+		{
+			body->m_islandIndex = m_staticCount++;
+		}
+		m_bodies[m_bodyCount++] = body;
+	}
+
+	void Add(b2Contact* contact)
+	{
+		b2Assert(m_contactCount < m_contactCapacity);
+		m_contacts[m_contactCount++] = contact;
+	}
+
+	void Add(b2Joint* joint)
+	{
+		b2Assert(m_jointCount < m_jointCapacity);
+		m_joints[m_jointCount++] = joint;
+	}
+
+	/// Finish the island being gathered. This allows its static bodies to
+	/// participate in other islands.
+	void EndIsland();
+
+	void Solve(b2TaskExecutor* executor, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
+
+	/// Report the contact impulses of every island, in the order they were gathered.
+	void Report(b2ContactListener* listener);
+
+	void SolveIsland(int32 index, b2StackAllocator* allocator);
+
+	struct Range
+	{
+		int32 bodyStart, bodyCount;
+		int32 contactStart, contactCount;
+		int32 jointStart, jointCount;
+	};
+
+	b2Body** m_bodies;
+	b2Contact** m_contacts;
+	b2Joint** m_joints;
+	b2ContactImpulse* m_impulses;
+	Range* m_islands;
+
+	int32 m_bodyCount;
+	int32 m_contactCount;
+	int32 m_jointCount;
+	int32 m_islandCount;
+	int32 m_staticCount;
+
+	int32 m_bodyCapacity;
+	int32 m_contactCapacity;
+	int32 m_jointCapacity;
+	int32 m_islandCapacity;
+
+	b2TimeStep m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+};
+
 #endif
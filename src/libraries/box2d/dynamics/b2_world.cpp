@@ -31,14 +31,26 @@
 #include "box2d/b2_contact.h"
 #include "box2d/b2_draw.h"
 #include "box2d/b2_edge_shape.h"
+#include "box2d/b2_distance_joint.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_friction_joint.h"
+#include "box2d/b2_gear_joint.h"
+#include "box2d/b2_motor_joint.h"
+#include "box2d/b2_mouse_joint.h"
 #include "box2d/b2_polygon_shape.h"
+#include "box2d/b2_prismatic_joint.h"
 #include "box2d/b2_pulley_joint.h"
+#include "box2d/b2_revolute_joint.h"
 #include "box2d/b2_time_of_impact.h"
 #include "box2d/b2_timer.h"
+#include "box2d/b2_weld_joint.h"
+#include "box2d/b2_wheel_joint.h"
 #include "box2d/b2_world.h"
 
+#include <algorithm>
 #include <new>
+#include <stdint.h>
+#include <string.h>
 
 b2World::b2World(const b2Vec2& gravity)
 {
@@ -68,6 +80,9 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_contactManager.m_allocator = &m_blockAllocator;
 
+	m_taskExecutor = nullptr;
+	m_islandBatch = nullptr;
+
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
 
@@ -90,6 +105,12 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	if (m_islandBatch)
+	{
+		m_islandBatch->~b2IslandBatch();
+		b2Free(m_islandBatch);
+	}
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -107,6 +128,18 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+
+	if (executor != nullptr && m_islandBatch == nullptr)
+	{
+		void* mem = b2Alloc(sizeof(b2IslandBatch));
+		m_islandBatch = new (mem) b2IslandBatch;
+	}
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	m_debugDraw = debugDraw;
@@ -397,10 +430,17 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// With a task executor, islands are gathered first and then solved together.
+	b2IslandBatch* batch = m_taskExecutor != nullptr ? m_islandBatch : nullptr;
+	if (batch)
+	{
+		batch->Reset(m_bodyCount, m_contactManager.m_contactCount, m_jointCount);
+	}
+
 	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
+	b2Island island(batch ? 0 : m_bodyCount,
+					batch ? 0 : m_contactManager.m_contactCount,
+					batch ? 0 : m_jointCount,
 					&m_stackAllocator,
 					m_contactManager.m_contactListener);
 
@@ -408,6 +448,7 @@ void b2World::Solve(const b2TimeStep& step)
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
 		b->m_flags &= ~b2Body::e_islandFlag;
+		b->m_islandIndex = -1;
 	}
 	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
 	{
@@ -451,7 +492,14 @@ void b2World::Solve(const b2TimeStep& step)
 			// Grab the next body off the stack and add it to the island.
 			b2Body* b = stack[--stackCount];
 			b2Assert(b->IsEnabled() == true);
-			island.Add(b);
+			if (batch)
+			{
+				batch->Add(b);
+			}
+			else
+			{
+				island.Add(b);
+			}
 
 			// To keep islands as small as possible, we don't
 			// propagate islands across static bodies.
@@ -489,7 +537,14 @@ void b2World::Solve(const b2TimeStep& step)
 					continue;
 				}
 
-				island.Add(contact);
+				if (batch)
+				{
+					batch->Add(contact);
+				}
+				else
+				{
+					island.Add(contact);
+				}
 				contact->m_flags |= b2Contact::e_islandFlag;
 
 				b2Body* other = ce->other;
@@ -521,7 +576,14 @@ void b2World::Solve(const b2TimeStep& step)
 					continue;
 				}
 
-				island.Add(je->joint);
+				if (batch)
+				{
+					batch->Add(je->joint);
+				}
+				else
+				{
+					island.Add(je->joint);
+				}
 				je->joint->m_islandFlag = true;
 
 				if (other->m_flags & b2Body::e_islandFlag)
@@ -535,6 +597,12 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
+		if (batch)
+		{
+			batch->EndIsland();
+			continue;
+		}
+
 		b2Profile profile;
 		island.Solve(&profile, step, m_gravity, m_allowSleep);
 		m_profile.solveInit += profile.solveInit;
@@ -555,6 +623,16 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	if (batch)
+	{
+		b2Timer timer;
+		batch->Solve(m_taskExecutor, step, m_gravity, m_allowSleep);
+		m_profile.solveVelocity = timer.GetMilliseconds();
+
+		// Report on this thread, in the order a serial step would have.
+		batch->Report(m_contactManager.m_contactListener);
+	}
+
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
@@ -1257,6 +1335,33 @@ void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 	m_contactManager.m_broadPhase.ShiftOrigin(newOrigin);
 }
 
+void b2World::BeginBulkCreate()
+{
+	b2Assert(m_locked == false);
+	if (m_locked)
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.BeginBulkInsert();
+}
+
+void b2World::EndBulkCreate()
+{
+	m_contactManager.m_broadPhase.EndBulkInsert();
+}
+
+void b2World::RebuildBroadPhase()
+{
+	b2Assert(m_locked == false);
+	if (m_locked)
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildTree();
+}
+
 void b2World::Dump()
 {
 	if (m_locked)
@@ -1320,3 +1425,517 @@ void b2World::Dump()
 
 	b2CloseDump();
 }
+
+namespace
+{
+
+const uint32 b2_worldStateMagic = 0x62327773; // 'b2ws'
+const int32 b2_worldStateVersion = 1;
+
+struct b2WorldStateHeader
+{
+	uint32 magic;
+	int32 version;
+	int32 bodyCount;
+	int32 fixtureCount;
+	int32 jointCount;
+	int32 contactCount;
+	b2Vec2 gravity;
+	float inv_dt0;
+	uint8 newContacts;
+	uint8 stepComplete;
+};
+
+struct b2BodyState
+{
+	uint64_t id;
+	int32 fixtureCount;
+	int32 type;
+	uint32 flags;
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	b2Vec2 force;
+	float torque;
+	float mass, invMass;
+	float I, invI;
+	float linearDamping;
+	float angularDamping;
+	float gravityScale;
+	float sleepTime;
+};
+
+struct b2FixtureState
+{
+	uint64_t id;
+	float density;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	b2Filter filter;
+	int32 proxyCount;
+	uint8 isSensor;
+};
+
+struct b2ProxyState
+{
+	b2AABB aabb;
+	int32 proxyId;
+};
+
+struct b2JointState
+{
+	uint64_t id;
+	int32 type;
+	int32 size;
+};
+
+struct b2ContactState
+{
+	uint64_t fixtureA;
+	uint64_t fixtureB;
+	int32 indexA;
+	int32 indexB;
+	uint32 flags;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+	b2Manifold manifold;
+};
+
+struct b2StateWriter
+{
+	uint8* data;
+	int32 size;
+
+	void Write(const void* src, int32 count)
+	{
+		if (data != nullptr)
+		{
+			memcpy(data + size, src, count);
+		}
+		size += count;
+	}
+};
+
+struct b2StateReader
+{
+	const uint8* data;
+	int32 size;
+	int32 offset;
+
+	bool Read(void* dst, int32 count)
+	{
+		if (count < 0 || count > size - offset)
+		{
+			return false;
+		}
+		memcpy(dst, data + offset, count);
+		offset += count;
+		return true;
+	}
+};
+
+struct b2FixtureStateRef
+{
+	uint64_t id;
+	b2Fixture* fixture;
+
+	bool operator < (const b2FixtureStateRef& other) const
+	{
+		return id < other.id;
+	}
+};
+
+b2Fixture* b2FindStateFixture(const b2FixtureStateRef* fixtures, int32 count, uint64_t id)
+{
+	b2FixtureStateRef key = { id, nullptr };
+	const b2FixtureStateRef* it = std::lower_bound(fixtures, fixtures + count, key);
+	if (it != fixtures + count && it->id == id)
+	{
+		return it->fixture;
+	}
+	return nullptr;
+}
+
+uint64_t b2StateId(const void* object)
+{
+	return uint64_t(uintptr_t(object));
+}
+
+// Joint solver state lives in the derived classes. Everything after the b2Joint
+// base is plain data whose pointers only refer to bodies and joints, which stay
+// the same for as long as a saved state can be restored.
+int32 b2JointStateSize(b2JointType type)
+{
+	int32 size = 0;
+	switch (type)
+	{
+	case e_revoluteJoint: size = sizeof(b2RevoluteJoint); break;
+	case e_prismaticJoint: size = sizeof(b2PrismaticJoint); break;
+	case e_distanceJoint: size = sizeof(b2DistanceJoint); break;
+	case e_pulleyJoint: size = sizeof(b2PulleyJoint); break;
+	case e_mouseJoint: size = sizeof(b2MouseJoint); break;
+	case e_gearJoint: size = sizeof(b2GearJoint); break;
+	case e_wheelJoint: size = sizeof(b2WheelJoint); break;
+	case e_weldJoint: size = sizeof(b2WeldJoint); break;
+	case e_frictionJoint: size = sizeof(b2FrictionJoint); break;
+	case e_motorJoint: size = sizeof(b2MotorJoint); break;
+	default: return 0;
+	}
+	return size - int32(sizeof(b2Joint));
+}
+
+} // namespace
+
+int32 b2World::SaveState(void* buffer) const
+{
+	b2StateWriter writer = { (uint8*)buffer, 0 };
+
+	int32 fixtureCount = 0;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		fixtureCount += b->m_fixtureCount;
+	}
+
+	b2WorldStateHeader header = {};
+	header.magic = b2_worldStateMagic;
+	header.version = b2_worldStateVersion;
+	header.bodyCount = m_bodyCount;
+	header.fixtureCount = fixtureCount;
+	header.jointCount = m_jointCount;
+	header.contactCount = m_contactManager.m_contactCount;
+	header.gravity = m_gravity;
+	header.inv_dt0 = m_inv_dt0;
+	header.newContacts = m_newContacts ? 1 : 0;
+	header.stepComplete = m_stepComplete ? 1 : 0;
+	writer.Write(&header, sizeof(header));
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState state = {};
+		state.id = b2StateId(b);
+		state.fixtureCount = b->m_fixtureCount;
+		state.type = b->m_type;
+		state.flags = b->m_flags;
+		state.xf = b->m_xf;
+		state.sweep = b->m_sweep;
+		state.linearVelocity = b->m_linearVelocity;
+		state.angularVelocity = b->m_angularVelocity;
+		state.force = b->m_force;
+		state.torque = b->m_torque;
+		state.mass = b->m_mass;
+		state.invMass = b->m_invMass;
+		state.I = b->m_I;
+		state.invI = b->m_invI;
+		state.linearDamping = b->m_linearDamping;
+		state.angularDamping = b->m_angularDamping;
+		state.gravityScale = b->m_gravityScale;
+		state.sleepTime = b->m_sleepTime;
+		writer.Write(&state, sizeof(state));
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState fstate = {};
+			fstate.id = b2StateId(f);
+			fstate.density = f->m_density;
+			fstate.friction = f->m_friction;
+			fstate.restitution = f->m_restitution;
+			fstate.restitutionThreshold = f->m_restitutionThreshold;
+			fstate.filter = f->m_filter;
+			fstate.proxyCount = f->m_proxyCount;
+			fstate.isSensor = f->m_isSensor ? 1 : 0;
+			writer.Write(&fstate, sizeof(fstate));
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2ProxyState pstate = {};
+				pstate.aabb = f->m_proxies[i].aabb;
+				pstate.proxyId = f->m_proxies[i].proxyId;
+				writer.Write(&pstate, sizeof(pstate));
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2JointState state = {};
+		state.id = b2StateId(j);
+		state.type = j->m_type;
+		state.size = b2JointStateSize(j->m_type);
+		writer.Write(&state, sizeof(state));
+		writer.Write((const uint8*)j + sizeof(b2Joint), state.size);
+	}
+
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2ContactState state = {};
+		state.fixtureA = b2StateId(c->m_fixtureA);
+		state.fixtureB = b2StateId(c->m_fixtureB);
+		state.indexA = c->m_indexA;
+		state.indexB = c->m_indexB;
+		state.flags = c->m_flags;
+		state.toiCount = c->m_toiCount;
+		state.toi = c->m_toi;
+		state.friction = c->m_friction;
+		state.restitution = c->m_restitution;
+		state.restitutionThreshold = c->m_restitutionThreshold;
+		state.tangentSpeed = c->m_tangentSpeed;
+		state.manifold = c->m_manifold;
+		writer.Write(&state, sizeof(state));
+	}
+
+	uint8* broadPhaseData = buffer != nullptr ? writer.data + writer.size : nullptr;
+	writer.size += m_contactManager.m_broadPhase.SaveState(broadPhaseData);
+
+	return writer.size;
+}
+
+bool b2World::RestoreState(const void* buffer, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	b2StateReader reader = { (const uint8*)buffer, size, 0 };
+
+	int32 worldFixtureCount = 0;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		worldFixtureCount += b->m_fixtureCount;
+	}
+
+	b2WorldStateHeader header;
+	if (reader.Read(&header, sizeof(header)) == false
+		|| header.magic != b2_worldStateMagic || header.version != b2_worldStateVersion
+		|| header.bodyCount != m_bodyCount || header.fixtureCount != worldFixtureCount
+		|| header.jointCount != m_jointCount || header.contactCount < 0)
+	{
+		return false;
+	}
+
+	// Validate everything before touching the world. Fixtures are collected,
+	// sorted by id, so saved contacts can be resolved without trusting pointers.
+	b2FixtureStateRef* fixtures = (b2FixtureStateRef*)b2Alloc(b2Max(header.fixtureCount, 1) * sizeof(b2FixtureStateRef));
+	int32 fixtureCount = 0;
+	bool valid = true;
+
+	for (b2Body* b = m_bodyList; b && valid; b = b->m_next)
+	{
+		b2BodyState state;
+		if (reader.Read(&state, sizeof(state)) == false || state.id != b2StateId(b)
+			|| state.fixtureCount != b->m_fixtureCount)
+		{
+			valid = false;
+			break;
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState fstate;
+			if (reader.Read(&fstate, sizeof(fstate)) == false
+				|| fstate.id != b2StateId(f) || fstate.proxyCount < 0
+				|| fstate.proxyCount > f->m_shape->GetChildCount()
+				|| fstate.proxyCount > (reader.size - reader.offset) / int32(sizeof(b2ProxyState)))
+			{
+				valid = false;
+				break;
+			}
+
+			reader.offset += fstate.proxyCount * int32(sizeof(b2ProxyState));
+			fixtures[fixtureCount].id = fstate.id;
+			fixtures[fixtureCount].fixture = f;
+			++fixtureCount;
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j && valid; j = j->m_next)
+	{
+		b2JointState state;
+		if (reader.Read(&state, sizeof(state)) == false || state.id != b2StateId(j)
+			|| state.type != j->m_type || state.size != b2JointStateSize(j->m_type)
+			|| state.size > reader.size - reader.offset)
+		{
+			valid = false;
+			break;
+		}
+
+		reader.offset += state.size;
+	}
+
+	std::sort(fixtures, fixtures + fixtureCount);
+
+	int32 contactOffset = reader.offset;
+	for (int32 i = 0; i < header.contactCount && valid; ++i)
+	{
+		b2ContactState state;
+		if (reader.Read(&state, sizeof(state)) == false)
+		{
+			valid = false;
+			break;
+		}
+
+		b2Fixture* fixtureA = b2FindStateFixture(fixtures, fixtureCount, state.fixtureA);
+		b2Fixture* fixtureB = b2FindStateFixture(fixtures, fixtureCount, state.fixtureB);
+		if (fixtureA == nullptr || fixtureB == nullptr || fixtureA->m_body == fixtureB->m_body
+			|| state.indexA < 0 || state.indexA >= fixtureA->m_shape->GetChildCount()
+			|| state.indexB < 0 || state.indexB >= fixtureB->m_shape->GetChildCount()
+			|| state.manifold.pointCount < 0 || state.manifold.pointCount > b2_maxManifoldPoints)
+		{
+			valid = false;
+		}
+	}
+
+	int32 broadPhaseOffset = reader.offset;
+	if (valid == false || m_contactManager.m_broadPhase.RestoreState(reader.data + broadPhaseOffset, size - broadPhaseOffset) == false)
+	{
+		b2Free(fixtures);
+		return false;
+	}
+
+	// Drop the current contacts. This may wake bodies, which is overwritten below.
+	b2Contact* c = m_contactManager.m_contactList;
+	while (c)
+	{
+		b2Contact* next = c->m_next;
+		b2Contact::Destroy(c, &m_blockAllocator);
+		c = next;
+	}
+
+	m_contactManager.m_contactList = nullptr;
+	m_contactManager.m_contactCount = 0;
+
+	reader.offset = sizeof(header);
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState state;
+		reader.Read(&state, sizeof(state));
+
+		b->m_type = b2BodyType(state.type);
+		b->m_flags = uint16(state.flags);
+		b->m_xf = state.xf;
+		b->m_sweep = state.sweep;
+		b->m_linearVelocity = state.linearVelocity;
+		b->m_angularVelocity = state.angularVelocity;
+		b->m_force = state.force;
+		b->m_torque = state.torque;
+		b->m_mass = state.mass;
+		b->m_invMass = state.invMass;
+		b->m_I = state.I;
+		b->m_invI = state.invI;
+		b->m_linearDamping = state.linearDamping;
+		b->m_angularDamping = state.angularDamping;
+		b->m_gravityScale = state.gravityScale;
+		b->m_sleepTime = state.sleepTime;
+		b->m_contactList = nullptr;
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState fstate;
+			reader.Read(&fstate, sizeof(fstate));
+
+			f->m_density = fstate.density;
+			f->m_friction = fstate.friction;
+			f->m_restitution = fstate.restitution;
+			f->m_restitutionThreshold = fstate.restitutionThreshold;
+			f->m_filter = fstate.filter;
+			f->m_isSensor = fstate.isSensor != 0;
+			f->m_proxyCount = fstate.proxyCount;
+
+			for (int32 i = 0; i < fstate.proxyCount; ++i)
+			{
+				b2ProxyState pstate;
+				reader.Read(&pstate, sizeof(pstate));
+
+				b2FixtureProxy* proxy = f->m_proxies + i;
+				proxy->aabb = pstate.aabb;
+				proxy->proxyId = pstate.proxyId;
+				proxy->fixture = f;
+				proxy->childIndex = i;
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2JointState state;
+		reader.Read(&state, sizeof(state));
+		reader.Read((uint8*)j + sizeof(b2Joint), state.size);
+	}
+
+	// Contacts are pushed to the front of the lists, so creating them in reverse
+	// reproduces the saved world list and the order of every body's contact edges.
+	for (int32 i = header.contactCount - 1; i >= 0; --i)
+	{
+		b2ContactState state;
+		reader.offset = contactOffset + i * int32(sizeof(state));
+		reader.Read(&state, sizeof(state));
+
+		b2Fixture* fixtureA = b2FindStateFixture(fixtures, fixtureCount, state.fixtureA);
+		b2Fixture* fixtureB = b2FindStateFixture(fixtures, fixtureCount, state.fixtureB);
+
+		c = b2Contact::Create(fixtureA, state.indexA, fixtureB, state.indexB, &m_blockAllocator);
+		if (c == nullptr)
+		{
+			continue;
+		}
+
+		c->m_flags = state.flags;
+		c->m_toiCount = state.toiCount;
+		c->m_toi = state.toi;
+		c->m_friction = state.friction;
+		c->m_restitution = state.restitution;
+		c->m_restitutionThreshold = state.restitutionThreshold;
+		c->m_tangentSpeed = state.tangentSpeed;
+		c->m_manifold = state.manifold;
+
+		b2Body* bodyA = c->m_fixtureA->m_body;
+		b2Body* bodyB = c->m_fixtureB->m_body;
+
+		c->m_prev = nullptr;
+		c->m_next = m_contactManager.m_contactList;
+		if (m_contactManager.m_contactList != nullptr)
+		{
+			m_contactManager.m_contactList->m_prev = c;
+		}
+		m_contactManager.m_contactList = c;
+
+		c->m_nodeA.contact = c;
+		c->m_nodeA.other = bodyB;
+		c->m_nodeA.prev = nullptr;
+		c->m_nodeA.next = bodyA->m_contactList;
+		if (bodyA->m_contactList != nullptr)
+		{
+			bodyA->m_contactList->prev = &c->m_nodeA;
+		}
+		bodyA->m_contactList = &c->m_nodeA;
+
+		c->m_nodeB.contact = c;
+		c->m_nodeB.other = bodyA;
+		c->m_nodeB.prev = nullptr;
+		c->m_nodeB.next = bodyB->m_contactList;
+		if (bodyB->m_contactList != nullptr)
+		{
+			bodyB->m_contactList->prev = &c->m_nodeB;
+		}
+		bodyB->m_contactList = &c->m_nodeB;
+
+		++m_contactManager.m_contactCount;
+	}
+
+	b2Free(fixtures);
+
+	m_gravity = header.gravity;
+	m_inv_dt0 = header.inv_dt0;
+	m_newContacts = header.newContacts != 0;
+	m_stepComplete = header.stepComplete != 0;
+
+	return true;
+}
@@ -42,6 +42,17 @@ extern "C" {
 #include <enet/enet.h>
 }
 
+#include "common/runtime.h"
+#include "data/ByteData.h"
+#include "data/ResidentData.h"
+#include "thread/threads.h"
+#include "thread/wrap_Channel.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <new>
+
 #define check_host(l, idx)\
 	*(ENetHost**)luaL_checkudata(l, idx, "enet_host")
 
@@ -192,13 +203,20 @@ static void push_peer(lua_State *l, ENetPeer *peer) {
 	lua_remove(l, -2); // remove enet_peers
 }
 
-static void push_event(lua_State *l, ENetEvent *event) {
-	lua_newtable(l); // event table
-
+/**
+ * Fill the event table at the top of the stack. Fields from a previous event
+ * are overwritten, so tables can be reused.
+ */
+static void fill_event(lua_State *l, ENetEvent *event) {
 	if (event->peer) {
 		push_peer(l, event->peer);
-		lua_setfield(l, -2, "peer");
+	} else {
+		lua_pushnil(l);
 	}
+	lua_setfield(l, -2, "peer");
+
+	lua_pushnil(l);
+	lua_setfield(l, -2, "channel");
 
 	switch (event->type) {
 		case ENET_EVENT_TYPE_CONNECT:
@@ -232,37 +250,87 @@ static void push_event(lua_State *l, ENetEvent *event) {
 	lua_setfield(l, -2, "type");
 }
 
+static void push_event(lua_State *l, ENetEvent *event) {
+	lua_newtable(l); // event table
+	fill_event(l, event);
+}
+
 /**
- * Read a packet off the stack as a string
+ * Read packet flags off the stack
+ * idx is position of the flag string, nil or none means "reliable"
+ */
+static enet_uint32 read_packet_flags(lua_State *l, int idx) {
+	if (lua_isnoneornil(l, idx)) {
+		return ENET_PACKET_FLAG_RELIABLE;
+	}
+
+	const char *flag_str = luaL_checkstring(l, idx);
+	if (strcmp("unsequenced", flag_str) == 0) {
+		return ENET_PACKET_FLAG_UNSEQUENCED;
+	} else if (strcmp("reliable", flag_str) == 0) {
+		return ENET_PACKET_FLAG_RELIABLE;
+	} else if (strcmp("unreliable", flag_str) == 0) {
+		return 0;
+	}
+
+	luaL_error(l, "Unknown packet flag: %s", flag_str);
+	return 0;
+}
+
+static bool is_packet_data(lua_State *l, int idx) {
+	return lua_type(l, idx) == LUA_TSTRING || love::luax_istype(l, idx, love::Data::type);
+}
+
+static void ENET_CALLBACK release_packet_data(ENetPacket *packet) {
+	love::Data *data = (love::Data *) packet->userData;
+	love::data::ResidentData::unpin(data);
+	data->release();
+}
+
+/**
+ * Create a packet from the string or Data at idx, which must be one of those.
+ * Data isn't copied: the packet references its memory and keeps it alive
+ * until ENet is done with the packet, so it must not be modified meanwhile.
+ * Idle-compressible Data is pinned resident for as long as the packet lives.
+ * Returns NULL if the packet could not be created.
+ */
+static ENetPacket *create_packet(lua_State *l, int idx, enet_uint32 flags) {
+	if (lua_type(l, idx) == LUA_TSTRING) {
+		size_t size;
+		const char *data = lua_tolstring(l, idx, &size);
+		return enet_packet_create(data, size, flags);
+	}
+
+	love::Data *data = love::luax_totype<love::Data>(l, idx);
+	love::data::ResidentData::pin(data);
+	ENetPacket *packet = enet_packet_create(data->getData(), data->getSize(), flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+	if (packet != NULL) {
+		data->retain();
+		packet->userData = data;
+		packet->freeCallback = release_packet_data;
+	} else {
+		love::data::ResidentData::unpin(data);
+	}
+	return packet;
+}
+
+/**
+ * Read a packet off the stack as a string or Data
  * idx is position of string
  */
 static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
-	size_t size;
-	int argc = lua_gettop(l);
-	const void *data = luaL_checklstring(l, idx, &size);
-	ENetPacket *packet;
+	if (!is_packet_data(l, idx)) {
+		luaL_argerror(l, idx, "string or Data expected");
+	}
 
-	enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+	enet_uint32 flags = read_packet_flags(l, idx+2);
 	*channel_id = 0;
 
-	if (argc >= idx+2 && !lua_isnil(l, idx+2)) {
-		const char *flag_str = luaL_checkstring(l, idx+2);
-		if (strcmp("unsequenced", flag_str) == 0) {
-			flags = ENET_PACKET_FLAG_UNSEQUENCED;
-		} else if (strcmp("reliable", flag_str) == 0) {
-			flags = ENET_PACKET_FLAG_RELIABLE;
-		} else if (strcmp("unreliable", flag_str) == 0) {
-			flags = 0;
-		} else {
-			luaL_error(l, "Unknown packet flag: %s", flag_str);
-		}
-	}
-
-	if (argc >= idx+1 && !lua_isnil(l, idx+1)) {
+	if (!lua_isnoneornil(l, idx+1)) {
 		*channel_id = (int) luaL_checknumber(l, idx+1);
 	}
 
-	packet = enet_packet_create(data, size, flags);
+	ENetPacket *packet = create_packet(l, idx, flags);
 	if (packet == NULL) {
 		luaL_error(l, "Failed to create packet");
 	}
@@ -270,6 +338,159 @@ static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 	return packet;
 }
 
+/**
+ * ENet is allocated with new[]/delete[] so a received packet's buffer can be
+ * handed to a ByteData, which frees its memory with delete[].
+ */
+static void *ENET_CALLBACK enet_alloc(size_t size) {
+	return new (std::nothrow) char[size];
+}
+
+static void ENET_CALLBACK enet_dealloc(void *memory) {
+	delete[] (char *) memory;
+}
+
+/**
+ * Services a host on its own thread, pushing events to a love Channel as
+ * tables: { type = "connect"|"disconnect"|"receive", peer = index,
+ * data = number|ByteData, channel = number }.
+ * Every other use of the host locks the thread's mutex (see HostLock.)
+ */
+class HostThread : public love::thread::Threadable {
+public:
+	HostThread(ENetHost *host, love::thread::Channel *channel, int timeout)
+		: host(host)
+		, channel(channel)
+		, timeout(timeout)
+		, running(true) {
+		setThreadName("enet");
+	}
+
+	virtual ~HostThread() {}
+
+	void threadFunction() override {
+		while (running) {
+			int result = 0;
+
+			{
+				love::thread::Lock lock(mutex);
+				ENetEvent event;
+				while ((result = enet_host_service(host, &event, 0)) > 0)
+					deliver(event);
+			}
+
+			if (result < 0) {
+				love::Variant::SharedTable *error = new love::Variant::SharedTable();
+				error->pairs.emplace_back(love::Variant(std::string("type")), love::Variant(std::string("error")));
+				channel->push(love::Variant(error));
+				break;
+			}
+
+			// Wake up as soon as a datagram arrives, or after the timeout so
+			// packets sent from Lua go out and peers are timed out.
+			enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE | ENET_SOCKET_WAIT_INTERRUPT;
+			enet_socket_wait(host->socket, &condition, timeout);
+		}
+	}
+
+	void stop() {
+		running = false;
+	}
+
+	love::thread::MutexRef mutex;
+
+private:
+
+	void deliver(ENetEvent &event) {
+		using love::Variant;
+
+		const char *type = "none";
+		Variant data((double) event.data);
+
+		if (event.type == ENET_EVENT_TYPE_CONNECT)
+			type = "connect";
+		else if (event.type == ENET_EVENT_TYPE_DISCONNECT)
+			type = "disconnect";
+		else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+			type = "receive";
+			ENetPacket *packet = event.packet;
+
+			if (packet->dataLength > 0 && !(packet->flags & ENET_PACKET_FLAG_NO_ALLOCATE)) {
+				// Take the packet's buffer instead of copying it.
+				love::data::ByteData *bytes = new love::data::ByteData(packet->data, packet->dataLength, true);
+				packet->data = NULL;
+				data = Variant(&love::data::ByteData::type, bytes);
+				bytes->release();
+			} else
+				data = Variant((const char *) packet->data, packet->dataLength);
+
+			enet_packet_destroy(packet);
+		}
+
+		Variant::SharedTable *table = new Variant::SharedTable();
+		table->pairs.emplace_back(Variant(std::string("type")), Variant(std::string(type)));
+		if (event.peer != NULL)
+			table->pairs.emplace_back(Variant(std::string("peer")), Variant((double) (event.peer - host->peers + 1)));
+		table->pairs.emplace_back(Variant(std::string("data")), data);
+		if (event.type == ENET_EVENT_TYPE_RECEIVE)
+			table->pairs.emplace_back(Variant(std::string("channel")), Variant((double) event.channelID));
+
+		channel->push(Variant(table));
+	}
+
+	ENetHost *host;
+	love::StrongRef<love::thread::Channel> channel;
+	int timeout;
+	std::atomic<bool> running;
+};
+
+// Hosts which are currently serviced by a thread.
+static std::map<ENetHost *, HostThread *> host_threads;
+static std::mutex host_threads_mutex;
+
+static HostThread *get_host_thread(ENetHost *host) {
+	std::lock_guard<std::mutex> lock(host_threads_mutex);
+	auto it = host_threads.find(host);
+	return it != host_threads.end() ? it->second : NULL;
+}
+
+/**
+ * Locks a host for use from Lua while it's serviced by a thread. Nothing is
+ * locked for hosts serviced from Lua. Lua errors must not be raised while a
+ * HostLock is alive.
+ */
+class HostLock {
+public:
+	HostLock(ENetHost *host) : thread(get_host_thread(host)) {
+		if (thread)
+			thread->mutex->lock();
+	}
+
+	~HostLock() {
+		if (thread)
+			thread->mutex->unlock();
+	}
+
+private:
+	HostThread *thread;
+};
+
+static void stop_host_thread(ENetHost *host) {
+	HostThread *thread = NULL;
+	{
+		std::lock_guard<std::mutex> lock(host_threads_mutex);
+		auto it = host_threads.find(host);
+		if (it == host_threads.end())
+			return;
+		thread = it->second;
+		host_threads.erase(it);
+	}
+
+	thread->stop();
+	thread->wait();
+	thread->release();
+}
+
 /**
  * Create a new host
  * Args:
@@ -344,6 +565,9 @@ static int host_service(lua_State *l) {
 	if (!host) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
+	if (get_host_thread(host)) {
+		return luaL_error(l, "Cannot service a host which is serviced by a thread.");
+	}
 	ENetEvent event;
 	int timeout = 0, out;
 
@@ -366,6 +590,9 @@ static int host_check_events(lua_State *l) {
 	if (!host) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
+	if (get_host_thread(host)) {
+		return luaL_error(l, "Cannot check events of a host which is serviced by a thread.");
+	}
 	ENetEvent event;
 	int out = enet_host_check_events(host, &event);
 	if (out == 0) return 0;
@@ -375,6 +602,58 @@ static int host_check_events(lua_State *l) {
 	return 1;
 }
 
+/**
+ * Service a host and dispatch several events at once
+ * Args:
+ *	events table, whose event tables are reused
+ *	[max = 64]
+ *	[timeout = 0], how long to wait for the first event
+ *
+ * Return
+ *	the number of events; events[count+1] is set to nil
+ */
+static int host_service_many(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+	if (get_host_thread(host)) {
+		return luaL_error(l, "Cannot service a host which is serviced by a thread.");
+	}
+	luaL_checktype(l, 2, LUA_TTABLE);
+	int max = (int) luaL_optnumber(l, 3, 64);
+	int timeout = (int) luaL_optnumber(l, 4, 0);
+
+	ENetEvent event;
+	int count = 0;
+
+	while (count < max) {
+		// Only the first call touches the socket, the rest dispatch events
+		// which were already received.
+		int out = count == 0 ? enet_host_service(host, &event, timeout) : enet_host_check_events(host, &event);
+		if (out == 0) break;
+		if (out < 0) return luaL_error(l, "Error during service");
+
+		lua_rawgeti(l, 2, count + 1);
+		if (!lua_istable(l, -1)) {
+			lua_pop(l, 1);
+			lua_newtable(l);
+			lua_pushvalue(l, -1);
+			lua_rawseti(l, 2, count + 1);
+		}
+
+		fill_event(l, &event);
+		lua_pop(l, 1);
+		count++;
+	}
+
+	lua_pushnil(l);
+	lua_rawseti(l, 2, count + 1);
+
+	lua_pushinteger(l, count);
+	return 1;
+}
+
 /**
  * Enables an adaptive order-2 PPM range coder for the transmitted data of
  * all peers.
@@ -385,7 +664,11 @@ static int host_compress_with_range_coder(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 
-	int result = enet_host_compress_with_range_coder (host);
+	int result;
+	{
+		HostLock lock(host);
+		result = enet_host_compress_with_range_coder (host);
+	}
 	if (result == 0) {
 		lua_pushboolean (l, 1);
 	} else {
@@ -423,7 +706,10 @@ static int host_connect(lua_State *l) {
 	}
 
 	// printf("host connect, channels=%d, data=%d\n", channel_count, data);
-	peer = enet_host_connect(host, &address, channel_count, data);
+	{
+		HostLock lock(host);
+		peer = enet_host_connect(host, &address, channel_count, data);
+	}
 
 	if (peer == NULL) {
 		return luaL_error(l, "Failed to create peer");
@@ -439,6 +725,7 @@ static int host_flush(lua_State *l) {
 	if (!host) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
+	HostLock lock(host);
 	enet_host_flush(host);
 	return 0;
 }
@@ -451,6 +738,7 @@ static int host_broadcast(lua_State *l) {
 
 	enet_uint8 channel_id;
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
+	HostLock lock(host);
 	enet_host_broadcast(host, channel_id, packet);
 	return 0;
 }
@@ -462,6 +750,7 @@ static int host_channel_limit(lua_State *l) {
 		return luaL_error(l, "Tried to index a nil host!");
 	}
 	int limit = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_channel_limit(host, limit);
 	return 0;
 }
@@ -473,6 +762,7 @@ static int host_bandwidth_limit(lua_State *l) {
 	}
 	enet_uint32 in_bandwidth = (int) luaL_checknumber(l, 2);
 	enet_uint32 out_bandwidth = (int) luaL_checknumber(l, 2);
+	HostLock lock(host);
 	enet_host_bandwidth_limit(host, in_bandwidth, out_bandwidth);
 	return 0;
 }
@@ -559,12 +849,68 @@ static int host_gc(lua_State *l) {
 	ENetHost** host = (ENetHost**)luaL_checkudata(l, 1, "enet_host");
 	// We don't want to crash by destroying a non-existant host.
 	if (*host) {
+		stop_host_thread(*host);
 		enet_host_destroy(*host);
 	}
 	*host = NULL;
 	return 0;
 }
 
+/**
+ * Service a host on its own thread
+ * Args:
+ *	love.thread Channel which receives event tables
+ *	[timeout = 1], the longest time in ms the thread sleeps waiting for
+ *	  packets; sent packets may wait this long before going out
+ */
+static int host_start_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+	love::thread::Channel *channel = love::thread::luax_checkchannel(l, 2);
+	int timeout = (int) luaL_optnumber(l, 3, 1);
+
+	if (get_host_thread(host)) {
+		return luaL_error(l, "Host is already serviced by a thread.");
+	}
+
+	HostThread *thread = new HostThread(host, channel, std::max(timeout, 0));
+	{
+		std::lock_guard<std::mutex> lock(host_threads_mutex);
+		host_threads[host] = thread;
+	}
+
+	if (!thread->start()) {
+		stop_host_thread(host);
+		return luaL_error(l, "Could not start enet host thread.");
+	}
+
+	return 0;
+}
+
+/**
+ * Stop servicing a host on its own thread. Events which were already pushed
+ * to the Channel stay there.
+ */
+static int host_stop_thread(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+	stop_host_thread(host);
+	return 0;
+}
+
+static int host_is_threaded(lua_State *l) {
+	ENetHost *host = check_host(l, 1);
+	if (!host) {
+		return luaL_error(l, "Tried to index a nil host!");
+	}
+	lua_pushboolean(l, get_host_thread(host) != NULL);
+	return 1;
+}
+
 static int peer_tostring(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 	char host_str[128];
@@ -579,6 +925,7 @@ static int peer_tostring(lua_State *l) {
 
 static int peer_ping(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_ping(peer);
 	return 0;
 }
@@ -590,6 +937,7 @@ static int peer_throttle_configure(lua_State *l) {
 	enet_uint32 acceleration = (int) luaL_checknumber(l, 3);
 	enet_uint32 deceleration = (int) luaL_checknumber(l, 4);
 
+	HostLock lock(peer->host);
 	enet_peer_throttle_configure(peer, interval, acceleration, deceleration);
 	return 0;
 }
@@ -624,6 +972,7 @@ static int peer_ping_interval(lua_State *l) {
 
 	if (lua_gettop(l) > 1) {
 		enet_uint32 interval = (int) luaL_checknumber(l, 2);
+		HostLock lock(peer->host);
 		enet_peer_ping_interval (peer, interval);
 	}
 
@@ -648,7 +997,10 @@ static int peer_timeout(lua_State *l) {
 			if (!lua_isnil(l, 2)) timeout_limit = (int) luaL_checknumber(l, 2);
 	}
 
-	enet_peer_timeout (peer, timeout_limit, timeout_minimum, timeout_maximum);
+	{
+		HostLock lock(peer->host);
+		enet_peer_timeout (peer, timeout_limit, timeout_minimum, timeout_maximum);
+	}
 
 	lua_pushinteger (l, peer->timeoutLimit);
 	lua_pushinteger (l, peer->timeoutMinimum);
@@ -661,6 +1013,7 @@ static int peer_disconnect(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect(peer, data);
 	return 0;
 }
@@ -669,6 +1022,7 @@ static int peer_disconnect_now(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_now(peer, data);
 	return 0;
 }
@@ -677,6 +1031,7 @@ static int peer_disconnect_later(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
 
 	enet_uint32 data = lua_gettop(l) > 1 ? (int) luaL_checknumber(l, 2) : 0;
+	HostLock lock(peer->host);
 	enet_peer_disconnect_later(peer, data);
 	return 0;
 }
@@ -742,6 +1097,7 @@ static int peer_connect_id(lua_State *l) {
 
 static int peer_reset(lua_State *l) {
 	ENetPeer *peer = check_peer(l, 1);
+	HostLock lock(peer->host);
 	enet_peer_reset(peer);
 	return 0;
 }
@@ -755,7 +1111,10 @@ static int peer_receive(lua_State *l) {
 		channel_id = (int) luaL_checknumber(l, 2);
 	}
 
-	packet = enet_peer_receive(peer, &channel_id);
+	{
+		HostLock lock(peer->host);
+		packet = enet_peer_receive(peer, &channel_id);
+	}
 	if (packet == NULL) return 0;
 
 	lua_pushlstring(l, (const char *)packet->data, packet->dataLength);
@@ -781,7 +1140,11 @@ static int peer_send(lua_State *l) {
 	ENetPacket *packet = read_packet(l, 2, &channel_id);
 
 	// printf("sending, channel_id=%d\n", channel_id);
-	int ret = enet_peer_send(peer, channel_id, packet);
+	int ret;
+	{
+		HostLock lock(peer->host);
+		ret = enet_peer_send(peer, channel_id, packet);
+	}
 	if (ret < 0) {
 		enet_packet_destroy(packet);
 	}
@@ -791,6 +1154,62 @@ static int peer_send(lua_State *l) {
 	return 1;
 }
 
+/**
+ * Send several packets to a peer at once
+ * Args:
+ *	array of packets, strings or Data
+ *	channel id
+ *	flags ["reliable", nil]
+ *
+ * Return
+ *	the number of packets queued
+ */
+static int peer_send_many(lua_State *l) {
+	ENetPeer *peer = check_peer(l, 1);
+	luaL_checktype(l, 2, LUA_TTABLE);
+
+	enet_uint8 channel_id = 0;
+	if (!lua_isnoneornil(l, 3)) {
+		channel_id = (int) luaL_checknumber(l, 3);
+	}
+	enet_uint32 flags = read_packet_flags(l, 4);
+
+	int count = (int) love::luax_objlen(l, 2);
+
+	// Check every value before creating any packets, so nothing leaks if
+	// there's an error.
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(l, 2, i);
+		if (!is_packet_data(l, -1)) {
+			return luaL_error(l, "Packet %d must be a string or Data.", i);
+		}
+		lua_pop(l, 1);
+	}
+
+	int sent = 0;
+	{
+		HostLock lock(peer->host);
+		for (int i = 1; i <= count; i++) {
+			lua_rawgeti(l, 2, i);
+			ENetPacket *packet = create_packet(l, -1, flags);
+			lua_pop(l, 1);
+
+			if (packet == NULL) {
+				continue;
+			}
+
+			if (enet_peer_send(peer, channel_id, packet) < 0) {
+				enet_packet_destroy(packet);
+			} else {
+				sent++;
+			}
+		}
+	}
+
+	lua_pushinteger(l, sent);
+	return 1;
+}
+
 static const struct luaL_Reg enet_funcs [] = {
 	{"host_create", host_create},
 	{"linked_version", linked_version},
@@ -800,6 +1219,7 @@ static const struct luaL_Reg enet_funcs [] = {
 static const struct luaL_Reg enet_host_funcs [] = {
 	{"service", host_service},
 	{"check_events", host_check_events},
+	{"service_many", host_service_many},
 	{"compress_with_range_coder", host_compress_with_range_coder},
 	{"connect", host_connect},
 	{"flush", host_flush},
@@ -818,6 +1238,9 @@ static const struct luaL_Reg enet_host_funcs [] = {
 	{"service_time", host_service_time},
 	{"peer_count", host_peer_count},
 	{"get_peer", host_get_peer},
+	{"start_thread", host_start_thread},
+	{"stop_thread", host_stop_thread},
+	{"is_threaded", host_is_threaded},
 	{NULL, NULL}
 };
 
@@ -829,6 +1252,7 @@ static const struct luaL_Reg enet_peer_funcs [] = {
 	{"ping", peer_ping},
 	{"receive", peer_receive},
 	{"send", peer_send},
+	{"send_many", peer_send_many},
 	{"throttle_configure", peer_throttle_configure},
 	{"ping_interval", peer_ping_interval},
 	{"timeout", peer_timeout},
@@ -847,8 +1271,12 @@ extern "C" {
 }
 
 int luaopen_enet(lua_State *l) {
-	enet_initialize();
-	atexit(enet_deinitialize);
+	static std::once_flag initialized;
+	std::call_once(initialized, []() {
+		ENetCallbacks callbacks = { enet_alloc, enet_dealloc, NULL };
+		enet_initialize_with_callbacks(ENET_VERSION, &callbacks);
+		atexit(enet_deinitialize);
+	});
 
 	// create metatables
 	luaL_newmetatable(l, "enet_host");
@@ -158,6 +158,7 @@ static void print_usage()
         "    love path/to/gamedir            runs the game from the given directory which contains a main.lua file\n"
         "    love path/to/packagedgame.love  runs the packaged game from the provided .love file\n"
         "    love path/to/file.lua           runs the game from the given .lua file\n"
+        "    love --compileshader in out     precompiles the shader code in a file into a bundle for love.graphics.newShader\n"
         );
 }
 
@@ -33,6 +33,17 @@ namespace audio
 {
 
 static bool requestRecPermission = false;
+static DeviceSettings deviceSettings;
+
+void setDeviceSettings(const DeviceSettings &settings)
+{
+	deviceSettings = settings;
+}
+
+const DeviceSettings &getDeviceSettings()
+{
+	return deviceSettings;
+}
 
 void setRequestRecordingPermission(bool rec)
 {
@@ -111,5 +122,34 @@ std::vector<std::string> Audio::getConstants(DistanceModel)
 	return distanceModels.getNames();
 }
 
+StringMap<Audio::OutputMode, Audio::OUTPUT_MODE_MAX_ENUM>::Entry Audio::outputModeEntries[] =
+{
+	{"default", Audio::OUTPUT_MODE_DEFAULT},
+	{"mono", Audio::OUTPUT_MODE_MONO},
+	{"stereo", Audio::OUTPUT_MODE_STEREO},
+	{"headphones", Audio::OUTPUT_MODE_HEADPHONES},
+	{"quad", Audio::OUTPUT_MODE_QUAD},
+	{"5.1", Audio::OUTPUT_MODE_SURROUND51},
+	{"6.1", Audio::OUTPUT_MODE_SURROUND61},
+	{"7.1", Audio::OUTPUT_MODE_SURROUND71},
+};
+
+StringMap<Audio::OutputMode, Audio::OUTPUT_MODE_MAX_ENUM> Audio::outputModes(Audio::outputModeEntries, sizeof(Audio::outputModeEntries));
+
+bool Audio::getConstant(const char *in, OutputMode &out)
+{
+	return outputModes.find(in, out);
+}
+
+bool Audio::getConstant(OutputMode in, const char  *&out)
+{
+	return outputModes.find(in, out);
+}
+
+std::vector<std::string> Audio::getConstants(OutputMode)
+{
+	return outputModes.getNames();
+}
+
 } // audio
 } // love
@@ -28,6 +28,7 @@
 #include "common/Module.h"
 #include "common/StringMap.h"
 #include "Source.h"
+#include "Mixer.h"
 #include "Effect.h"
 #include "RecordingDevice.h"
 
@@ -95,10 +96,41 @@ public:
 		DISTANCE_MAX_ENUM
 	};
 
+	/**
+	 * Speaker layout the device mixes for.
+	 **/
+	enum OutputMode
+	{
+		OUTPUT_MODE_DEFAULT,
+		OUTPUT_MODE_MONO,
+		OUTPUT_MODE_STEREO,
+		OUTPUT_MODE_HEADPHONES,
+		OUTPUT_MODE_QUAD,
+		OUTPUT_MODE_SURROUND51,
+		OUTPUT_MODE_SURROUND61,
+		OUTPUT_MODE_SURROUND71,
+		OUTPUT_MODE_MAX_ENUM
+	};
+
+	/**
+	 * What the device actually uses, which may differ from DeviceSettings.
+	 **/
+	struct DeviceInfo
+	{
+		int frequency = 0;
+		int refresh = 0;
+		double latency = 0.0;
+		OutputMode outputMode = OUTPUT_MODE_DEFAULT;
+	};
+
 	static bool getConstant(const char *in, DistanceModel &out);
 	static bool getConstant(DistanceModel in, const char  *&out);
 	static std::vector<std::string> getConstants(DistanceModel);
 
+	static bool getConstant(const char *in, OutputMode &out);
+	static bool getConstant(OutputMode in, const char  *&out);
+	static std::vector<std::string> getConstants(OutputMode);
+
 	virtual ~Audio() {}
 
 	// Implements Module.
@@ -108,6 +140,14 @@ public:
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a software Mixer, which plays many voices through a single
+	 * Source.
+	 * @param maxVoices The most voices the Mixer plays at once.
+	 * @param sampleRate The sample rate the voices are mixed at.
+	 **/
+	virtual Mixer *newMixer(int maxVoices, int sampleRate) = 0;
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -120,6 +160,40 @@ public:
 	 **/
 	virtual int getMaxSources() const = 0;
 
+	/**
+	 * Gets the time of the clock used to schedule playback, in seconds.
+	 * Where supported this is the audio device's own clock, so it stays in
+	 * step with what's being played.
+	 **/
+	virtual double getClockTime() const = 0;
+
+	/**
+	 * Gets the time between audio being played and it being heard, in
+	 * seconds. If the device doesn't report it, this is estimated from how
+	 * often it mixes.
+	 **/
+	virtual double getLatency() const = 0;
+
+	/**
+	 * Gets the sample rate, update rate, latency and output mode the device
+	 * ended up with.
+	 **/
+	virtual DeviceInfo getDeviceInfo() const = 0;
+
+	/**
+	 * Static Sources with identical sample data share one buffer. Buffers no
+	 * Source is using are kept while their total size in bytes is within this
+	 * limit, least recently used first to go. Defaults to 0.
+	 **/
+	virtual void setStaticCacheLimit(size_t bytes) = 0;
+	virtual size_t getStaticCacheLimit() const = 0;
+
+	/**
+	 * Gets the bytes used by all shared static buffers, and by the ones no
+	 * Source is using.
+	 **/
+	virtual void getStaticCacheUsage(size_t &total, size_t &idle) const = 0;
+
 	/**
 	 * Play the specified Source.
 	 * @param source The Source to play.
@@ -190,6 +264,12 @@ public:
 	 **/
 	virtual void setPosition(float *v) = 0;
 
+	/**
+	 * Moves the listener and every positional Source which isn't relative to
+	 * the listener by -v, for when the world's origin is moved to v.
+	 **/
+	virtual void translateOrigin(const float *v) = 0;
+
 	/**
 	 * Gets the orientation of the listener.
 	 * @param v A float array of size 6 containing [x,y,z] for the forward
@@ -267,6 +347,17 @@ public:
 	 */
 	virtual bool getActiveEffects(std::vector<std::string> &list) const = 0;
 
+	/**
+	 * Sets the output volume of a scene EFX effect, without re-uploading the
+	 * rest of its settings. Every Source sending to the effect shares it, so
+	 * this is the cheap way to fade a reverb shared by many Sources.
+	 * @param name Effect name.
+	 * @param volume The new volume.
+	 * @return true if effect was present, false otherwise.
+	 */
+	virtual bool setEffectVolume(const char *name, float volume) = 0;
+	virtual bool getEffectVolume(const char *name, float &volume) const = 0;
+
 	/**
 	 * Gets maximum number of scene EFX effects.
 	 * @return number of effects.
@@ -316,8 +407,29 @@ private:
 
 	static StringMap<DistanceModel, DISTANCE_MAX_ENUM>::Entry distanceModelEntries[];
 	static StringMap<DistanceModel, DISTANCE_MAX_ENUM> distanceModels;
+	static StringMap<OutputMode, OUTPUT_MODE_MAX_ENUM>::Entry outputModeEntries[];
+	static StringMap<OutputMode, OUTPUT_MODE_MAX_ENUM> outputModes;
 }; // Audio
 
+/**
+ * Requested settings for the audio device. Zero means the device's default.
+ * Lower frequencies and higher refresh rates give lower latency, at the cost
+ * of quality and CPU time.
+ **/
+struct DeviceSettings
+{
+	int frequency = 0;
+	int refresh = 0;
+	Audio::OutputMode outputMode = Audio::OUTPUT_MODE_DEFAULT;
+};
+
+/**
+ * Sets the settings the audio device is opened with. Only has an effect
+ * before the audio module is created.
+ **/
+void setDeviceSettings(const DeviceSettings &settings);
+const DeviceSettings &getDeviceSettings();
+
 } // audio
 } // love
 
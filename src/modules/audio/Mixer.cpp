@@ -0,0 +1,566 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Mixer.h"
+#include "common/Exception.h"
+#include "common/config.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace love
+{
+namespace audio
+{
+
+love::Type Mixer::type("Mixer", &Object::type);
+
+// Voices quieter than this (about -80 dB) aren't worth mixing.
+static const float SILENT_VOLUME = 0.0001f;
+
+static inline float sampleToFloat(int16 s)
+{
+	return (float) s / (float) LOVE_INT16_MAX;
+}
+
+static inline float sampleToFloat(uint8 s)
+{
+	// 8-bit sample values are unsigned, see SoundData::getSample.
+	return ((float) s - 128.0f) / 127.0f;
+}
+
+/**
+ * Adds frames of 16-bit data at its original rate into the stereo mix buffer,
+ * with the given left and right gains.
+ **/
+static void mixUnity16(const int16 *src, int channels, float gl, float gr, float *out, int frames)
+{
+	int i = 0;
+
+	gl /= (float) LOVE_INT16_MAX;
+	gr /= (float) LOVE_INT16_MAX;
+
+#if defined(LOVE_SIMD_SSE2)
+
+	if (channels == 1)
+	{
+		const __m128 l4 = _mm_set1_ps(gl);
+		const __m128 r4 = _mm_set1_ps(gr);
+
+		for (; i + 7 < frames; i += 8)
+		{
+			__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+
+			// Sign-extend the eight samples to 32 bits.
+			__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+			__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+			float *o = out + i * 2;
+			__m128 llo = _mm_mul_ps(lo, l4), rlo = _mm_mul_ps(lo, r4);
+			__m128 lhi = _mm_mul_ps(hi, l4), rhi = _mm_mul_ps(hi, r4);
+
+			_mm_storeu_ps(o + 0, _mm_add_ps(_mm_loadu_ps(o + 0), _mm_unpacklo_ps(llo, rlo)));
+			_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_unpackhi_ps(llo, rlo)));
+			_mm_storeu_ps(o + 8, _mm_add_ps(_mm_loadu_ps(o + 8), _mm_unpacklo_ps(lhi, rhi)));
+			_mm_storeu_ps(o + 12, _mm_add_ps(_mm_loadu_ps(o + 12), _mm_unpackhi_ps(lhi, rhi)));
+		}
+	}
+	else
+	{
+		const __m128 g4 = _mm_setr_ps(gl, gr, gl, gr);
+
+		for (; i + 3 < frames; i += 4)
+		{
+			__m128i s = _mm_loadu_si128((const __m128i *) (src + i * 2));
+
+			__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+			__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+			float *o = out + i * 2;
+			_mm_storeu_ps(o + 0, _mm_add_ps(_mm_loadu_ps(o + 0), _mm_mul_ps(lo, g4)));
+			_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(hi, g4)));
+		}
+	}
+
+#endif
+
+	if (channels == 1)
+	{
+		for (; i < frames; i++)
+		{
+			float s = (float) src[i];
+			out[i * 2 + 0] += s * gl;
+			out[i * 2 + 1] += s * gr;
+		}
+	}
+	else
+	{
+		for (; i < frames; i++)
+		{
+			out[i * 2 + 0] += (float) src[i * 2 + 0] * gl;
+			out[i * 2 + 1] += (float) src[i * 2 + 1] * gr;
+		}
+	}
+}
+
+/**
+ * Adds frames of data into the stereo mix buffer, resampling it with linear
+ * interpolation. Returns the new position, and sets finished if a
+ * non-looping sound reached its end.
+ **/
+template <typename T, int channels>
+static double mixResampled(const T *src, int srcframes, double pos, double step, bool looping, float gl, float gr, float *out, int frames, bool &finished)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		int a = (int) pos;
+		int b = a + 1 < srcframes ? a + 1 : (looping ? 0 : a);
+		float t = (float) (pos - a);
+
+		if (channels == 1)
+		{
+			float s0 = sampleToFloat(src[a]);
+			float s = s0 + (sampleToFloat(src[b]) - s0) * t;
+			out[i * 2 + 0] += s * gl;
+			out[i * 2 + 1] += s * gr;
+		}
+		else
+		{
+			float l0 = sampleToFloat(src[a * 2 + 0]);
+			float r0 = sampleToFloat(src[a * 2 + 1]);
+			out[i * 2 + 0] += (l0 + (sampleToFloat(src[b * 2 + 0]) - l0) * t) * gl;
+			out[i * 2 + 1] += (r0 + (sampleToFloat(src[b * 2 + 1]) - r0) * t) * gr;
+		}
+
+		pos += step;
+
+		if (pos >= srcframes)
+		{
+			if (!looping)
+			{
+				finished = true;
+				break;
+			}
+
+			pos = std::fmod(pos, (double) srcframes);
+		}
+	}
+
+	return pos;
+}
+
+/**
+ * Converts the float mix buffer to clamped 16-bit samples.
+ **/
+static void convertOutput(const float *in, int16 *out, int count, float volume)
+{
+	float scale = volume * (float) LOVE_INT16_MAX;
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+
+	const __m128 scale4 = _mm_set1_ps(scale);
+	const __m128 max4 = _mm_set1_ps((float) LOVE_INT16_MAX);
+	const __m128 min4 = _mm_set1_ps((float) -LOVE_INT16_MAX);
+
+	for (; i + 7 < count; i += 8)
+	{
+		__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale4), min4), max4);
+		__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale4), min4), max4);
+		__m128i s = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+		_mm_storeu_si128((__m128i *) (out + i), s);
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float s = std::min(std::max(in[i] * scale, (float) -LOVE_INT16_MAX), (float) LOVE_INT16_MAX);
+		out[i] = (int16) std::lrint(s);
+	}
+}
+
+Mixer::Mixer(Source *output, int sampleRate, int maxVoices)
+	: output(output)
+	, sampleRate(sampleRate)
+	, nextID(1)
+	, volume(1.0f)
+	, maxVoices(maxVoices)
+	, maxAudibleVoices(64)
+	, audibleCount(0)
+	, mixBuffer(BUFFER_FRAMES * 2)
+	, outBuffer(BUFFER_FRAMES * 2)
+{
+	if (sampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", sampleRate);
+
+	if (maxVoices < 1)
+		throw love::Exception("Mixer must have at least one voice.");
+
+	if (output->getChannelCount() != 2)
+		throw love::Exception("Mixer output must be a stereo Source.");
+}
+
+Mixer::~Mixer()
+{
+}
+
+uint32 Mixer::play(love::sound::SoundData *data, float volume, float pitch, float pan, int priority, bool looping)
+{
+	if (data->getChannelCount() > 2)
+		throw love::Exception("Mixer voices must be mono or stereo.");
+
+	thread::Lock lock(mutex);
+
+	if ((int) voices.size() >= maxVoices)
+	{
+		// Replace the lowest priority voice, the oldest one among equals.
+		size_t lowest = 0;
+		for (size_t i = 1; i < voices.size(); i++)
+		{
+			const Voice &v = voices[i];
+			if (v.priority < voices[lowest].priority || (v.priority == voices[lowest].priority && v.id < voices[lowest].id))
+				lowest = i;
+		}
+
+		if (voices.empty() || voices[lowest].priority > priority)
+			return 0;
+
+		removeVoice(lowest);
+	}
+
+	Voice v;
+	v.id = nextID++;
+	v.data.set(data);
+	v.position = 0.0;
+	v.volume = volume;
+	v.pitch = pitch;
+	v.pan = std::min(std::max(pan, -1.0f), 1.0f);
+	v.priority = priority;
+	v.looping = looping;
+	v.audible = false;
+
+	// 0 means "no voice".
+	if (nextID == 0)
+		nextID = 1;
+
+	voices.push_back(v);
+
+	// Start the output right away instead of waiting for the audio thread.
+	if (!output->isPlaying())
+	{
+		fill();
+		output->play();
+	}
+
+	return v.id;
+}
+
+void Mixer::stop(uint32 id)
+{
+	thread::Lock lock(mutex);
+
+	for (size_t i = 0; i < voices.size(); i++)
+	{
+		if (voices[i].id == id)
+		{
+			removeVoice(i);
+			break;
+		}
+	}
+}
+
+void Mixer::stop()
+{
+	thread::Lock lock(mutex);
+	voices.clear();
+	audibleCount = 0;
+}
+
+bool Mixer::isPlaying(uint32 id)
+{
+	thread::Lock lock(mutex);
+	return findVoice(id) != nullptr;
+}
+
+bool Mixer::setVoiceVolume(uint32 id, float volume)
+{
+	thread::Lock lock(mutex);
+	Voice *v = findVoice(id);
+	if (v != nullptr)
+		v->volume = volume;
+	return v != nullptr;
+}
+
+bool Mixer::setVoicePitch(uint32 id, float pitch)
+{
+	thread::Lock lock(mutex);
+	Voice *v = findVoice(id);
+	if (v != nullptr)
+		v->pitch = pitch;
+	return v != nullptr;
+}
+
+bool Mixer::setVoicePan(uint32 id, float pan)
+{
+	thread::Lock lock(mutex);
+	Voice *v = findVoice(id);
+	if (v != nullptr)
+		v->pan = std::min(std::max(pan, -1.0f), 1.0f);
+	return v != nullptr;
+}
+
+void Mixer::setVolume(float volume)
+{
+	thread::Lock lock(mutex);
+	this->volume = volume;
+}
+
+float Mixer::getVolume() const
+{
+	return volume;
+}
+
+void Mixer::setMaxVoices(int count)
+{
+	if (count < 1)
+		throw love::Exception("Mixer must have at least one voice.");
+
+	thread::Lock lock(mutex);
+	maxVoices = count;
+
+	// Drop the lowest priority voices that no longer fit.
+	if ((int) voices.size() > maxVoices)
+	{
+		std::stable_sort(voices.begin(), voices.end(), [](const Voice &a, const Voice &b)
+		{
+			return a.priority > b.priority || (a.priority == b.priority && a.id > b.id);
+		});
+		voices.resize(maxVoices);
+	}
+}
+
+int Mixer::getMaxVoices() const
+{
+	return maxVoices;
+}
+
+void Mixer::setMaxAudibleVoices(int count)
+{
+	if (count < 0)
+		throw love::Exception("The maximum number of audible voices cannot be negative.");
+
+	thread::Lock lock(mutex);
+	maxAudibleVoices = count;
+}
+
+int Mixer::getMaxAudibleVoices() const
+{
+	return maxAudibleVoices;
+}
+
+int Mixer::getVoiceCount()
+{
+	thread::Lock lock(mutex);
+	return (int) voices.size();
+}
+
+int Mixer::getAudibleVoiceCount()
+{
+	thread::Lock lock(mutex);
+	return audibleCount;
+}
+
+int Mixer::getSampleRate() const
+{
+	return sampleRate;
+}
+
+Source *Mixer::getSource() const
+{
+	return output.get();
+}
+
+bool Mixer::update()
+{
+	thread::Lock lock(mutex);
+	fill();
+	return !voices.empty();
+}
+
+Mixer::Voice *Mixer::findVoice(uint32 id)
+{
+	for (Voice &v : voices)
+	{
+		if (v.id == id)
+			return &v;
+	}
+
+	return nullptr;
+}
+
+void Mixer::removeVoice(size_t index)
+{
+	if (index + 1 != voices.size())
+		voices[index] = std::move(voices.back());
+	voices.pop_back();
+}
+
+void Mixer::chooseAudibleVoices()
+{
+	order.clear();
+
+	for (size_t i = 0; i < voices.size(); i++)
+	{
+		voices[i].audible = false;
+		if (voices[i].volume * volume > SILENT_VOLUME)
+			order.push_back(i);
+	}
+
+	if (order.size() > (size_t) maxAudibleVoices)
+	{
+		const std::vector<Voice> &v = voices;
+		std::nth_element(order.begin(), order.begin() + maxAudibleVoices, order.end(), [&](size_t a, size_t b)
+		{
+			if (v[a].priority != v[b].priority)
+				return v[a].priority > v[b].priority;
+			if (v[a].volume != v[b].volume)
+				return v[a].volume > v[b].volume;
+			return v[a].id < v[b].id;
+		});
+
+		order.resize(maxAudibleVoices);
+	}
+
+	for (size_t i : order)
+		voices[i].audible = true;
+
+	audibleCount = (int) order.size();
+}
+
+bool Mixer::mixVoice(Voice &v, int frames)
+{
+	const love::sound::SoundData *data = v.data.get();
+	int srcframes = data->getSampleCount();
+	int channels = data->getChannelCount();
+	double step = (double) data->getSampleRate() / (double) sampleRate * v.pitch;
+
+	if (srcframes <= 0 || step <= 0.0)
+		return false;
+
+	if (!v.audible)
+	{
+		v.position += step * frames;
+
+		if (v.position >= srcframes)
+		{
+			if (!v.looping)
+				return false;
+			v.position = std::fmod(v.position, (double) srcframes);
+		}
+
+		return true;
+	}
+
+	// Balance: panning turns one side down, never the other up.
+	float gl = v.volume * std::min(1.0f, 1.0f - v.pan);
+	float gr = v.volume * std::min(1.0f, 1.0f + v.pan);
+	float *out = mixBuffer.data();
+	bool finished = false;
+
+	if (data->getBitDepth() == 16)
+	{
+		const int16 *src = (const int16 *) data->getData();
+
+		// Most sound effects play at their own rate, which needs no resampling.
+		if (step == 1.0 && v.position == std::floor(v.position))
+		{
+			int pos = (int) v.position;
+			int done = 0;
+
+			while (done < frames)
+			{
+				int n = std::min(frames - done, srcframes - pos);
+				mixUnity16(src + pos * channels, channels, gl, gr, out + done * 2, n);
+				done += n;
+				pos += n;
+
+				if (pos >= srcframes)
+				{
+					if (!v.looping)
+						return false;
+					pos = 0;
+				}
+			}
+
+			v.position = pos;
+			return true;
+		}
+
+		if (channels == 1)
+			v.position = mixResampled<int16, 1>(src, srcframes, v.position, step, v.looping, gl, gr, out, frames, finished);
+		else
+			v.position = mixResampled<int16, 2>(src, srcframes, v.position, step, v.looping, gl, gr, out, frames, finished);
+	}
+	else
+	{
+		const uint8 *src = (const uint8 *) data->getData();
+
+		if (channels == 1)
+			v.position = mixResampled<uint8, 1>(src, srcframes, v.position, step, v.looping, gl, gr, out, frames, finished);
+		else
+			v.position = mixResampled<uint8, 2>(src, srcframes, v.position, step, v.looping, gl, gr, out, frames, finished);
+	}
+
+	return !finished;
+}
+
+void Mixer::fill()
+{
+	int freebuffers = output->getFreeBufferCount();
+
+	while (freebuffers-- > 0 && !voices.empty())
+	{
+		std::fill(mixBuffer.begin(), mixBuffer.end(), 0.0f);
+
+		chooseAudibleVoices();
+
+		for (size_t i = 0; i < voices.size();)
+		{
+			if (mixVoice(voices[i], BUFFER_FRAMES))
+				i++;
+			else
+				removeVoice(i);
+		}
+
+		convertOutput(mixBuffer.data(), outBuffer.data(), (int) outBuffer.size(), volume);
+
+		if (!output->queue(outBuffer.data(), outBuffer.size() * sizeof(int16), sampleRate, 16, 2))
+			break;
+	}
+}
+
+} // audio
+} // love
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_MIXER_H
+#define LOVE_AUDIO_MIXER_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "sound/SoundData.h"
+#include "thread/threads.h"
+#include "Source.h"
+
+// STL
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+
+/**
+ * Mixes many short sounds ("voices") in software into a single queueable
+ * Source, so they don't each need one of the backend's limited sources.
+ *
+ * When there are more voices than maxAudibleVoices, only the ones with the
+ * highest priority (and then volume) are mixed. The rest, along with silent
+ * voices, are virtual: they keep their place in the sound without costing
+ * anything to mix, and become audible again once there's room.
+ **/
+class Mixer : public Object
+{
+public:
+
+	static love::Type type;
+
+	// Frames mixed per buffer, and buffers queued ahead in the output Source.
+	static const int BUFFER_FRAMES = 512;
+	static const int BUFFER_COUNT = 4;
+
+	/**
+	 * @param output A queueable, 16 bit stereo Source with the given sample
+	 * rate. The Mixer takes ownership of the Source's queue.
+	 **/
+	Mixer(Source *output, int sampleRate, int maxVoices);
+	virtual ~Mixer();
+
+	/**
+	 * Starts a new voice playing the given mono or stereo SoundData. If the
+	 * Mixer already has maxVoices voices, the one with the lowest priority is
+	 * replaced, provided its priority isn't higher than the new voice's.
+	 * @return An id for the voice, or 0 if it couldn't play.
+	 **/
+	uint32 play(love::sound::SoundData *data, float volume, float pitch, float pan, int priority, bool looping);
+
+	void stop(uint32 id);
+	void stop();
+	bool isPlaying(uint32 id);
+
+	bool setVoiceVolume(uint32 id, float volume);
+	bool setVoicePitch(uint32 id, float pitch);
+	bool setVoicePan(uint32 id, float pan);
+
+	void setVolume(float volume);
+	float getVolume() const;
+
+	void setMaxVoices(int count);
+	int getMaxVoices() const;
+	void setMaxAudibleVoices(int count);
+	int getMaxAudibleVoices() const;
+
+	int getVoiceCount();
+	int getAudibleVoiceCount();
+
+	int getSampleRate() const;
+	Source *getSource() const;
+
+	/**
+	 * Mixes into every free buffer of the output Source. Called regularly by
+	 * the audio backend.
+	 * @return Whether any voices are still playing.
+	 **/
+	bool update();
+
+private:
+
+	struct Voice
+	{
+		uint32 id;
+		StrongRef<love::sound::SoundData> data;
+		double position;
+		float volume;
+		float pitch;
+		float pan;
+		int priority;
+		bool looping;
+		bool audible;
+	};
+
+	Voice *findVoice(uint32 id);
+	void removeVoice(size_t index);
+
+	// Marks the voices that get mixed in the next buffer.
+	void chooseAudibleVoices();
+
+	// Mixes (or just advances, for virtual voices) one voice into mixBuffer.
+	// Returns false once a non-looping voice reaches its end.
+	bool mixVoice(Voice &v, int frames);
+
+	void fill();
+
+	StrongRef<Source> output;
+	int sampleRate;
+
+	std::vector<Voice> voices;
+	uint32 nextID;
+
+	float volume;
+	int maxVoices;
+	int maxAudibleVoices;
+	int audibleCount;
+
+	std::vector<float> mixBuffer;
+	std::vector<int16> outBuffer;
+	std::vector<size_t> order;
+
+	love::thread::MutexRef mutex;
+
+}; // Mixer
+
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_MIXER_H
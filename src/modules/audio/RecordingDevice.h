@@ -23,6 +23,7 @@
 
 #include "common/Object.h"
 #include "sound/SoundData.h"
+#include "thread/Channel.h"
 
 #include <string>
 
@@ -66,6 +67,22 @@ public:
 	 **/
 	virtual love::sound::SoundData *getData() = 0;
 
+	/**
+	 * Moves recorded samples into an existing SoundData instead of creating a
+	 * new one. The SoundData must have the recording's format.
+	 * @return The number of samples copied to the start of the SoundData.
+	 **/
+	virtual int getData(love::sound::SoundData *dest) = 0;
+
+	/**
+	 * Sets a Channel which recorded samples are pushed to as SoundData
+	 * objects of the given number of samples each, straight from the capture
+	 * thread. While a Channel is set, getData receives no samples.
+	 * A null Channel disables the callback.
+	 **/
+	virtual void setCallbackChannel(love::thread::Channel *channel, int samples) = 0;
+	virtual love::thread::Channel *getCallbackChannel(int &samples) const = 0;
+
 	/**
 	 * @return C string device name.
 	 **/ 
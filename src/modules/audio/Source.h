@@ -24,6 +24,7 @@
 // LOVE
 #include "common/Object.h"
 #include "common/StringMap.h"
+#include "sound/SoundData.h"
 #include "Filter.h"
 
 #include <vector>
@@ -60,6 +61,12 @@ public:
 	virtual Source *clone() = 0;
 
 	virtual bool play() = 0;
+
+	/**
+	 * Starts playing at the given time on the audio clock (see
+	 * Audio::getClockTime). Does nothing if the Source is already playing.
+	 **/
+	virtual bool playAt(double time) = 0;
 	virtual void stop() = 0;
 	virtual void pause() = 0;
 	virtual bool isPlaying() const = 0;
@@ -109,6 +116,13 @@ public:
 
 	virtual int getChannelCount() const = 0;
 
+	/**
+	 * Sources with a higher priority keep playing audibly over lower priority
+	 * ones when the backend runs out of voices.
+	 **/
+	virtual void setPriority(int priority) = 0;
+	virtual int getPriority() const = 0;
+
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params) = 0;
 	virtual bool setFilter() = 0;
 	virtual bool getFilter(std::map<Filter::Parameter, float> &params) = 0;
@@ -119,9 +133,31 @@ public:
 	virtual bool getEffect(const char *effect, std::map<Filter::Parameter, float> &params) = 0;
 	virtual bool getActiveEffects(std::vector<std::string> &list) const = 0;
 
+	/**
+	 * Per-send gain into a scene effect. The effect itself runs once for all
+	 * Sources sending to it; this only scales what this Source contributes.
+	 * Stored as the volume of the send's filter, creating a gain-only
+	 * lowpass filter when the send has none.
+	 **/
+	virtual bool setEffectVolume(const char *effect, float volume) = 0;
+	virtual bool getEffectVolume(const char *effect, float &volume) const = 0;
+
 	virtual int getFreeBufferCount() const = 0;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels) = 0;
 
+	/**
+	 * Queues a whole SoundData without copying it where the backend allows,
+	 * keeping a reference until it has played. The SoundData shouldn't be
+	 * modified until popReleased returns it.
+	 **/
+	virtual bool queueShared(love::sound::SoundData *data) = 0;
+
+	/**
+	 * Gets the oldest SoundData given to queueShared that has finished
+	 * playing, or null if there are none.
+	 **/
+	virtual StrongRef<love::sound::SoundData> popReleased() = 0;
+
 	virtual Type getType() const;
 
 	static bool getConstant(const char *in, Type &out);
@@ -19,6 +19,7 @@
  **/
 
 #include "Audio.h"
+#include "timer/Timer.h"
 
 namespace love
 {
@@ -56,6 +57,12 @@ love::audio::Source *Audio::newSource(int, int, int, int)
 	return new Source();
 }
 
+love::audio::Mixer *Audio::newMixer(int maxVoices, int sampleRate)
+{
+	StrongRef<Source> output(new Source(), Acquire::NORETAIN);
+	return new Mixer(output, sampleRate, maxVoices);
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return 0;
@@ -66,6 +73,36 @@ int Audio::getMaxSources() const
 	return 0;
 }
 
+double Audio::getClockTime() const
+{
+	return love::timer::Timer::getTime();
+}
+
+double Audio::getLatency() const
+{
+	return 0.0;
+}
+
+Audio::DeviceInfo Audio::getDeviceInfo() const
+{
+	return DeviceInfo();
+}
+
+void Audio::setStaticCacheLimit(size_t)
+{
+}
+
+size_t Audio::getStaticCacheLimit() const
+{
+	return 0;
+}
+
+void Audio::getStaticCacheUsage(size_t &total, size_t &idle) const
+{
+	total = 0;
+	idle = 0;
+}
+
 bool Audio::play(love::audio::Source *)
 {
 	return false;
@@ -119,6 +156,10 @@ void Audio::setPosition(float *)
 {
 }
 
+void Audio::translateOrigin(const float *)
+{
+}
+
 void Audio::getOrientation(float *) const
 {
 }
@@ -188,6 +229,16 @@ bool Audio::getActiveEffects(std::vector<std::string> &) const
 	return false;
 }
 
+bool Audio::setEffectVolume(const char *, float)
+{
+	return false;
+}
+
+bool Audio::getEffectVolume(const char *, float &) const
+{
+	return false;
+}
+
 int Audio::getMaxSceneEffects() const
 {
 	return 0;
@@ -52,6 +52,21 @@ love::sound::SoundData *RecordingDevice::getData()
 	return nullptr;
 }
 
+int RecordingDevice::getData(love::sound::SoundData *)
+{
+	return 0;
+}
+
+void RecordingDevice::setCallbackChannel(love::thread::Channel *, int)
+{
+}
+
+love::thread::Channel *RecordingDevice::getCallbackChannel(int &samples) const
+{
+	samples = 0;
+	return nullptr;
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	return 0;
@@ -39,6 +39,9 @@ public:
 	virtual bool start(int samples, int sampleRate, int bitDepth, int channels);
 	virtual void stop();
 	virtual love::sound::SoundData *getData();
+	virtual int getData(love::sound::SoundData *dest);
+	virtual void setCallbackChannel(love::thread::Channel *channel, int samples);
+	virtual love::thread::Channel *getCallbackChannel(int &samples) const;
 	virtual const char *getName() const;
 	virtual int getMaxSamples() const;
 	virtual int getSampleCount() const;
@@ -47,6 +47,11 @@ bool Source::play()
 	return false;
 }
 
+bool Source::playAt(double)
+{
+	return false;
+}
+
 void Source::stop()
 {
 }
@@ -224,6 +229,16 @@ float Source::getAirAbsorptionFactor() const
 	return absorptionFactor;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
 int Source::getChannelCount() const
 {
 	return 2;
@@ -239,6 +254,16 @@ bool Source::queue(void *, size_t, int, int, int)
 	return false;
 }
 
+bool Source::queueShared(love::sound::SoundData *)
+{
+	return false;
+}
+
+StrongRef<love::sound::SoundData> Source::popReleased()
+{
+	return StrongRef<love::sound::SoundData>();
+}
+
 bool Source::setFilter(const std::map<Filter::Parameter, float> &)
 {
 	return false;
@@ -279,6 +304,16 @@ bool Source::getActiveEffects(std::vector<std::string> &) const
 	return false;
 }
 
+bool Source::setEffectVolume(const char *, float)
+{
+	return false;
+}
+
+bool Source::getEffectVolume(const char *, float &) const
+{
+	return false;
+}
+
 } // null
 } // audio
 } // love
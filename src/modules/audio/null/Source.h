@@ -41,6 +41,7 @@ public:
 
 	virtual love::audio::Source *clone();
 	virtual bool play();
+	virtual bool playAt(double time);
 	virtual void stop();
 	virtual void pause();
 	virtual bool isPlaying() const;
@@ -77,10 +78,14 @@ public:
 	virtual float getMaxDistance() const;
 	virtual void setAirAbsorptionFactor(float factor);
 	virtual float getAirAbsorptionFactor() const;
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
 	virtual int getChannelCount() const;
 
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
+	virtual bool queueShared(love::sound::SoundData *data);
+	virtual StrongRef<love::sound::SoundData> popReleased();
 
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params);
 	virtual bool setFilter();
@@ -91,6 +96,8 @@ public:
 	virtual bool unsetEffect(const char *effect);
 	virtual bool getEffect(const char *effect, std::map<Filter::Parameter, float> &params);
 	virtual bool getActiveEffects(std::vector<std::string> &list) const;
+	virtual bool setEffectVolume(const char *effect, float volume);
+	virtual bool getEffectVolume(const char *effect, float &volume) const;
 
 private:
 
@@ -108,6 +115,7 @@ private:
 	float rolloffFactor;
 	float maxDistance;
 	float absorptionFactor;
+	int priority = 0;
 
 }; // Source
 
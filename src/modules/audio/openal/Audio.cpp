@@ -19,10 +19,10 @@
  **/
 
 #include "Audio.h"
-#include "common/delay.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -30,6 +30,21 @@
 #include "common/ios.h"
 #endif
 
+#ifndef ALC_SOFT_output_mode
+#define ALC_OUTPUT_MODE_SOFT 0x19AC
+#define ALC_ANY_SOFT 0x19AD
+#define ALC_STEREO_HRTF_SOFT 0x19B2
+#endif
+
+#ifndef ALC_SOFT_loopback
+#define ALC_MONO_SOFT 0x1500
+#define ALC_STEREO_SOFT 0x1501
+#define ALC_QUAD_SOFT 0x1503
+#define ALC_5POINT1_SOFT 0x1504
+#define ALC_6POINT1_SOFT 0x1505
+#define ALC_7POINT1_SOFT 0x1506
+#endif
+
 namespace love
 {
 namespace audio
@@ -61,15 +76,23 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Wake up a little early, since the estimate doesn't account for
+		// e.g. the doppler effect changing the playback rate.
+		double delay = pool->update();
+		pool->updateMixers();
+		pool->trimStaticBuffers();
+		pool->waitForUpdate(std::max(delay * 0.9 - 0.001, 0.001));
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
@@ -105,6 +128,53 @@ static const char *getDeviceSpecifier(ALCdevice *device)
 	return alcGetString(device, deviceEnum);
 }
 
+static ALCint getALOutputMode(Audio::OutputMode mode)
+{
+	switch (mode)
+	{
+	case Audio::OUTPUT_MODE_MONO:
+		return ALC_MONO_SOFT;
+	case Audio::OUTPUT_MODE_STEREO:
+		return ALC_STEREO_SOFT;
+	case Audio::OUTPUT_MODE_HEADPHONES:
+		return ALC_STEREO_HRTF_SOFT;
+	case Audio::OUTPUT_MODE_QUAD:
+		return ALC_QUAD_SOFT;
+	case Audio::OUTPUT_MODE_SURROUND51:
+		return ALC_5POINT1_SOFT;
+	case Audio::OUTPUT_MODE_SURROUND61:
+		return ALC_6POINT1_SOFT;
+	case Audio::OUTPUT_MODE_SURROUND71:
+		return ALC_7POINT1_SOFT;
+	case Audio::OUTPUT_MODE_DEFAULT:
+	default:
+		return ALC_ANY_SOFT;
+	}
+}
+
+static Audio::OutputMode getOutputMode(ALCint mode)
+{
+	switch (mode)
+	{
+	case ALC_MONO_SOFT:
+		return Audio::OUTPUT_MODE_MONO;
+	case ALC_STEREO_SOFT:
+		return Audio::OUTPUT_MODE_STEREO;
+	case ALC_STEREO_HRTF_SOFT:
+		return Audio::OUTPUT_MODE_HEADPHONES;
+	case ALC_QUAD_SOFT:
+		return Audio::OUTPUT_MODE_QUAD;
+	case ALC_5POINT1_SOFT:
+		return Audio::OUTPUT_MODE_SURROUND51;
+	case ALC_6POINT1_SOFT:
+		return Audio::OUTPUT_MODE_SURROUND61;
+	case ALC_7POINT1_SOFT:
+		return Audio::OUTPUT_MODE_SURROUND71;
+	default:
+		return Audio::OUTPUT_MODE_DEFAULT;
+	}
+}
+
 Audio::Audio()
 	: device(nullptr)
 	, context(nullptr)
@@ -141,6 +211,20 @@ Audio::Audio()
 		attribs.insert(attribs.begin() + 1, MAX_SOURCE_EFFECTS);
 #endif
 
+		// These stay in attribs so a reopened device gets them too.
+		const DeviceSettings &settings = getDeviceSettings();
+
+		if (settings.frequency > 0)
+			attribs.insert(attribs.begin(), {ALC_FREQUENCY, settings.frequency});
+
+		// The mixing period is frequency / refresh, so a higher refresh rate
+		// means smaller device buffers and less latency.
+		if (settings.refresh > 0)
+			attribs.insert(attribs.begin(), {ALC_REFRESH, settings.refresh});
+
+		if (settings.outputMode != OUTPUT_MODE_DEFAULT && alcIsExtensionPresent(device, "ALC_SOFT_output_mode"))
+			attribs.insert(attribs.begin(), {ALC_OUTPUT_MODE_SOFT, getALOutputMode(settings.outputMode)});
+
 		context = alcCreateContext(device, attribs.data());
 
 		if (context == nullptr)
@@ -276,6 +360,17 @@ love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels
 	return new Source(pool, sampleRate, bitDepth, channels, buffers);
 }
 
+love::audio::Mixer *Audio::newMixer(int maxVoices, int sampleRate)
+{
+	StrongRef<Source> output(new Source(pool, sampleRate, 16, 2, Mixer::BUFFER_COUNT), Acquire::NORETAIN);
+	Mixer *mixer = new Mixer(output, sampleRate, maxVoices);
+
+	// The pool thread keeps the mixer's buffers filled.
+	pool->addMixer(mixer);
+
+	return mixer;
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return pool->getActiveSourceCount();
@@ -286,6 +381,49 @@ int Audio::getMaxSources() const
 	return pool->getMaxSources();
 }
 
+double Audio::getClockTime() const
+{
+	return pool->getClockTime();
+}
+
+double Audio::getLatency() const
+{
+	return pool->getLatency();
+}
+
+Audio::DeviceInfo Audio::getDeviceInfo() const
+{
+	DeviceInfo info;
+
+	alcGetIntegerv(device, ALC_FREQUENCY, 1, &info.frequency);
+	alcGetIntegerv(device, ALC_REFRESH, 1, &info.refresh);
+	info.latency = pool->getLatency();
+
+	if (alcIsExtensionPresent(device, "ALC_SOFT_output_mode"))
+	{
+		ALCint mode = ALC_ANY_SOFT;
+		alcGetIntegerv(device, ALC_OUTPUT_MODE_SOFT, 1, &mode);
+		info.outputMode = getOutputMode(mode);
+	}
+
+	return info;
+}
+
+void Audio::setStaticCacheLimit(size_t bytes)
+{
+	pool->setStaticCacheLimit(bytes);
+}
+
+size_t Audio::getStaticCacheLimit() const
+{
+	return pool->getStaticCacheLimit();
+}
+
+void Audio::getStaticCacheUsage(size_t &total, size_t &idle) const
+{
+	pool->getStaticCacheUsage(total, idle);
+}
+
 bool Audio::play(love::audio::Source *source)
 {
 	return source->play();
@@ -434,6 +572,17 @@ void Audio::setPosition(float *v)
 	alListenerfv(AL_POSITION, v);
 }
 
+void Audio::translateOrigin(const float *v)
+{
+	float listener[3];
+	alGetListenerfv(AL_POSITION, listener);
+	for (int i = 0; i < 3; i++)
+		listener[i] -= v[i];
+	alListenerfv(AL_POSITION, listener);
+
+	pool->translateOrigin(v);
+}
+
 void Audio::getOrientation(float *v) const
 {
 	alGetListenerfv(AL_ORIENTATION, v);
@@ -692,6 +841,37 @@ bool Audio::getActiveEffects(std::vector<std::string> &list) const
 	return true;
 }
 
+bool Audio::setEffectVolume(const char *name, float volume)
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end())
+		return false;
+
+	iter->second.effect->setVolume(volume);
+
+#ifdef ALC_EXT_EFX
+	if (alAuxiliaryEffectSlotf)
+	{
+		alAuxiliaryEffectSlotf(iter->second.slot, AL_EFFECTSLOT_GAIN, volume);
+		alGetError();
+	}
+#endif
+
+	return true;
+}
+
+bool Audio::getEffectVolume(const char *name, float &volume) const
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end())
+		return false;
+
+	const auto &params = iter->second.effect->getParams();
+	auto p = params.find(Effect::EFFECT_VOLUME);
+	volume = p != params.end() ? p->second : 1.0f;
+	return true;
+}
+
 int Audio::getMaxSceneEffects() const
 {
 	return MAX_SCENE_EFFECTS;
@@ -85,8 +85,16 @@ public:
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Mixer *newMixer(int maxVoices, int sampleRate);
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
+	double getClockTime() const;
+	double getLatency() const;
+	DeviceInfo getDeviceInfo() const;
+
+	void setStaticCacheLimit(size_t bytes);
+	size_t getStaticCacheLimit() const;
+	void getStaticCacheUsage(size_t &total, size_t &idle) const;
 	bool play(love::audio::Source *source);
 	bool play(const std::vector<love::audio::Source*> &sources);
 	void stop(love::audio::Source *source);
@@ -102,6 +110,7 @@ public:
 
 	void getPosition(float *v) const;
 	void setPosition(float *v);
+	void translateOrigin(const float *v);
 	void getOrientation(float *v) const;
 	void setOrientation(float *v);
 	void getVelocity(float *v) const;
@@ -121,6 +130,8 @@ public:
 	bool unsetEffect(const char *name);
 	bool getEffect(const char *name, std::map<Effect::Parameter, float> &params);
 	bool getActiveEffects(std::vector<std::string> &list) const;
+	bool setEffectVolume(const char *name, float volume);
+	bool getEffectVolume(const char *name, float &volume) const;
 	int getMaxSceneEffects() const;
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
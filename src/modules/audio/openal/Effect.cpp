@@ -366,6 +366,11 @@ const std::map<Effect::Parameter, float> &Effect::getParams() const
 	return params;
 }
 
+void Effect::setVolume(float volume)
+{
+	params[EFFECT_VOLUME] = volume;
+}
+
 float Effect::getValue(Parameter in, float def) const
 {
 	return params.find(in) == params.end() ? def : params.at(in);
@@ -71,6 +71,10 @@ public:
 	virtual bool setParams(const std::map<Parameter, float> &params);
 	virtual const std::map<Parameter, float> &getParams() const;
 
+	// EFFECT_VOLUME is applied to the effect slot rather than the effect, so
+	// it can change without regenerating anything.
+	void setVolume(float volume);
+
 private:
 	bool generateEffect();
 	void deleteEffect();
@@ -19,10 +19,18 @@
  **/
 
 #include "Pool.h"
+#include "common/Trace.h"
 
 #include "event/Event.h"
+#include "thread/JobSystem.h"
+#include "timer/Timer.h"
 #include "Source.h"
 
+#include "libraries/xxHash/xxhash.h"
+
+#include <algorithm>
+#include <cstring>
+
 namespace love
 {
 namespace audio
@@ -45,6 +53,13 @@ Pool::Pool(ALCdevice *device)
 	, sources()
 	, disconnectNotified(false)
 	, totalSources(0)
+	, alcGetInteger64vSOFT(nullptr)
+	, alSourcePlayAtTimeSOFT(nullptr)
+	, alBufferDataStatic(nullptr)
+	, clockStart(timer::Timer::getTime())
+	, staticBufferUses(0)
+	, staticCacheLimit(0)
+	, wakeRequested(false)
 {
 	// Clear errors.
 	alGetError();
@@ -82,12 +97,26 @@ Pool::Pool(ALCdevice *device)
 
 		available.push(sources[i]);
 	}
+
+	if (alcIsExtensionPresent(device, "ALC_SOFT_device_clock") == ALC_TRUE)
+		alcGetInteger64vSOFT = (LPALCGETINTEGER64VSOFT) alcGetProcAddress(device, "alcGetInteger64vSOFT");
+
+	if (alIsExtensionPresent("AL_SOFT_source_start_delay") == AL_TRUE)
+		alSourcePlayAtTimeSOFT = (LPALSOURCEPLAYATTIMESOFT) alGetProcAddress("alSourcePlayAtTimeSOFT");
+
+	if (alIsExtensionPresent("AL_EXT_STATIC_BUFFER") == AL_TRUE)
+		alBufferDataStatic = (PFNALBUFFERDATASTATICPROC) alGetProcAddress("alBufferDataStatic");
 }
 
 Pool::~Pool()
 {
+	// The mixers' Sources use the pool when they're destroyed.
+	mixers.clear();
+
 	Source::stop(this);
 
+	staticBuffers.clear();
+
 	// Free all sources.
 	alDeleteSources(totalSources, sources);
 }
@@ -112,8 +141,10 @@ bool Pool::isPlaying(Source *s)
 	return p;
 }
 
-void Pool::update()
+double Pool::update()
 {
+	LOVE_TRACE_ZONE("Pool::update");
+
 #ifndef ALC_CONNECTED
 	constexpr ALCenum ALC_CONNECTED = 0x313;
 #endif
@@ -152,15 +183,221 @@ void Pool::update()
 	}
 
 	std::vector<Source *> torelease;
+	std::vector<Source *> todecode;
+	double delay = MAX_UPDATE_DELAY;
 
 	for (const auto &i : playing)
 	{
-		if (!i.first->update())
+		if (!i.first->prepareUpdate())
 			torelease.push_back(i.first);
+		else if (i.first->needsDecode())
+			todecode.push_back(i.first);
 	}
 
+	// Streams are decoded in parallel, so one slow decoder doesn't hold up
+	// the rest. The pool stays locked, so nothing else touches the decoders.
+	thread::JobSystem::getInstance()->parallelFor(todecode.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			todecode[i]->decodeStream();
+	});
+
+	for (Source *s : todecode)
+		s->queueDecoded();
+
 	for (Source *s : torelease)
 		releaseSource(s);
+
+	updateVirtualSources();
+
+	if (!scheduledSources.empty())
+	{
+		double now = getClockTime();
+
+		for (size_t i = 0; i < scheduledSources.size();)
+		{
+			Source *s = scheduledSources[i];
+			double time = s->getScheduledTime();
+
+			if (time <= now)
+			{
+				scheduledSources.erase(scheduledSources.begin() + i);
+				s->setScheduled(false, 0.0);
+				s->play();
+				s->release();
+			}
+			else
+			{
+				delay = std::min(delay, time - now);
+				i++;
+			}
+		}
+	}
+
+	for (const auto &i : playing)
+	{
+		double sourcedelay = i.first->getUpdateDelay();
+		if (sourcedelay >= 0.0)
+			delay = std::min(delay, sourcedelay);
+	}
+
+	return delay;
+}
+
+void Pool::waitForUpdate(double seconds)
+{
+	thread::Lock lock(wakeMutex);
+
+	if (!wakeRequested && seconds > 0.0)
+		wakeCond->wait(wakeMutex, std::max((int) (seconds * 1000.0), 1));
+
+	wakeRequested = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(wakeMutex);
+	wakeRequested = true;
+	wakeCond->signal();
+}
+
+void Pool::addMixer(love::audio::Mixer *mixer)
+{
+	thread::Lock l(mixerMutex);
+	mixers.emplace_back(mixer);
+}
+
+void Pool::updateMixers()
+{
+	std::vector<StrongRef<love::audio::Mixer>> current;
+
+	{
+		thread::Lock l(mixerMutex);
+
+		// Nothing else can get hold of a Mixer only the pool references.
+		mixers.erase(std::remove_if(mixers.begin(), mixers.end(), [](const StrongRef<love::audio::Mixer> &m)
+		{
+			return m->getReferenceCount() == 1;
+		}), mixers.end());
+
+		current = mixers;
+	}
+
+	for (const auto &mixer : current)
+	{
+		// A Mixer's Source is released once its queue runs dry, which can
+		// happen while voices are still playing if this thread falls behind.
+		if (mixer->update())
+		{
+			Source *source = (Source *) mixer->getSource();
+			if (!isPlaying(source))
+				source->play();
+		}
+	}
+}
+
+StrongRef<StaticDataBuffer> Pool::getStaticBuffer(ALenum format, const void *data, ALsizei size, ALsizei freq)
+{
+	StaticBufferKey key = {XXH3_64bits(data, (size_t) size), size, format, freq};
+
+	thread::Lock lock(mutex);
+
+	auto it = staticBuffers.find(key);
+	if (it != staticBuffers.end() && memcmp(it->second.bytes.data(), data, (size_t) size) != 0)
+	{
+		// Same hash but different samples. Rare enough to not be worth
+		// caching both.
+		StrongRef<StaticDataBuffer> buffer(new StaticDataBuffer(format, data, size, freq), Acquire::NORETAIN);
+		return buffer;
+	}
+
+	if (it == staticBuffers.end())
+	{
+		StaticBufferEntry entry;
+		entry.buffer.set(new StaticDataBuffer(format, data, size, freq), Acquire::NORETAIN);
+		entry.bytes.assign((const char *) data, (const char *) data + size);
+		it = staticBuffers.insert(std::make_pair(key, std::move(entry))).first;
+	}
+
+	it->second.lastUsed = ++staticBufferUses;
+
+	return it->second.buffer;
+}
+
+void Pool::trimStaticBuffers()
+{
+	thread::Lock lock(mutex);
+
+	size_t total = 0;
+	size_t idle = 0;
+	getStaticCacheUsage(total, idle);
+
+	while (idle > staticCacheLimit)
+	{
+		auto oldest = staticBuffers.end();
+
+		for (auto it = staticBuffers.begin(); it != staticBuffers.end(); ++it)
+		{
+			// Only the cache references it, so no Source is using it.
+			if (it->second.buffer->getReferenceCount() == 1
+				&& (oldest == staticBuffers.end() || it->second.lastUsed < oldest->second.lastUsed))
+				oldest = it;
+		}
+
+		if (oldest == staticBuffers.end())
+			break;
+
+		idle -= (size_t) oldest->second.buffer->getSize();
+		staticBuffers.erase(oldest);
+	}
+}
+
+void Pool::setStaticCacheLimit(size_t bytes)
+{
+	thread::Lock lock(mutex);
+	staticCacheLimit = bytes;
+}
+
+size_t Pool::getStaticCacheLimit() const
+{
+	thread::Lock lock(mutex);
+	return staticCacheLimit;
+}
+
+void Pool::getStaticCacheUsage(size_t &total, size_t &idle) const
+{
+	thread::Lock lock(mutex);
+
+	total = 0;
+	idle = 0;
+
+	for (const auto &kv : staticBuffers)
+	{
+		size_t size = (size_t) kv.second.buffer->getSize();
+		total += size;
+		if (kv.second.buffer->getReferenceCount() == 1)
+			idle += size;
+	}
+}
+
+void Pool::translateOrigin(const float *v)
+{
+	thread::Lock l(mutex);
+
+	for (Source *source : allSources)
+		source->translateOrigin(v);
+}
+
+void Pool::addSource(Source *source)
+{
+	thread::Lock l(mutex);
+	allSources.insert(source);
+}
+
+void Pool::removeSource(Source *source)
+{
+	thread::Lock l(mutex);
+	allSources.erase(source);
 }
 
 int Pool::getActiveSourceCount() const
@@ -173,23 +410,62 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+double Pool::getClockTime()
+{
+	if (alcGetInteger64vSOFT != nullptr)
+	{
+		ALCint64SOFT clock = 0;
+		alcGetInteger64vSOFT(device, ALC_DEVICE_CLOCK_SOFT, 1, &clock);
+		return (double) clock / 1000000000.0;
+	}
+
+	return timer::Timer::getTime() - clockStart;
+}
+
+double Pool::getLatency()
+{
+	if (alcGetInteger64vSOFT != nullptr)
+	{
+		ALCint64SOFT latency = 0;
+		alcGetInteger64vSOFT(device, ALC_DEVICE_LATENCY_SOFT, 1, &latency);
+		return (double) latency / 1000000000.0;
+	}
+
+	ALCint refresh = 0;
+	alcGetIntegerv(device, ALC_REFRESH, 1, &refresh);
+	return refresh > 0 ? 1.0 / refresh : 0.0;
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
 
 	if (findSource(source, out))
+	{
+		// A paused source has no update deadline until it's resumed.
+		wake();
 		return wasPlaying = true;
+	}
 
 	wasPlaying = false;
 
 	if (available.empty())
-		return false;
+	{
+		// Take the OpenAL source of something less important, if possible.
+		Source *least = findLeastImportant();
+		if (least == nullptr || !isLessImportant(least, source))
+			return false;
+
+		virtualizeSource(least);
+	}
 
 	out = available.front();
 	available.pop();
 
 	playing.insert(std::make_pair(source, out));
 	source->retain();
+
+	wake();
 	return true;
 }
 
@@ -210,6 +486,169 @@ bool Pool::releaseSource(Source *source, bool stop)
 	return false;
 }
 
+bool Pool::isLessImportant(Source *a, Source *b)
+{
+	if (a->getPriority() != b->getPriority())
+		return a->getPriority() < b->getPriority();
+
+	return a->getAudibility() < b->getAudibility();
+}
+
+Source *Pool::findLeastImportant()
+{
+	Source *least = nullptr;
+
+	for (const auto &i : playing)
+	{
+		Source *s = i.first;
+
+		// Queueable sources can't be resumed from an offset, and paused
+		// sources aren't taking up any time.
+		if (s->getType() == Source::TYPE_QUEUE || !s->isPlaying())
+			continue;
+
+		if (least == nullptr || isLessImportant(s, least))
+			least = s;
+	}
+
+	return least;
+}
+
+void Pool::virtualizeSource(Source *source)
+{
+	double offset = source->tell(Source::UNIT_SAMPLES);
+
+	// Keep a reference for the virtual list before the playing list's one is
+	// released.
+	source->retain();
+	virtualSources.push_back(source);
+
+	releaseSource(source);
+	source->startVirtual(offset, timer::Timer::getTime());
+}
+
+void Pool::addVirtualSource(Source *source, double offset)
+{
+	source->retain();
+	virtualSources.push_back(source);
+	source->startVirtual(offset, timer::Timer::getTime());
+}
+
+void Pool::releaseVirtualSource(Source *source)
+{
+	auto it = std::find(virtualSources.begin(), virtualSources.end(), source);
+	if (it == virtualSources.end())
+		return;
+
+	virtualSources.erase(it);
+	source->stopVirtual();
+	source->release();
+}
+
+void Pool::updateVirtualSources()
+{
+	if (virtualSources.empty())
+		return;
+
+	double now = timer::Timer::getTime();
+
+	for (size_t i = 0; i < virtualSources.size();)
+	{
+		Source *s = virtualSources[i];
+		if (s->getVirtualOffset(now) < 0.0)
+			releaseVirtualSource(s);
+		else
+			i++;
+	}
+
+	// Most important first.
+	std::vector<Source *> candidates;
+	for (Source *s : virtualSources)
+	{
+		if (s->isPlaying())
+			candidates.push_back(s);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](Source *a, Source *b)
+	{
+		return isLessImportant(b, a);
+	});
+
+	for (Source *s : candidates)
+	{
+		if (available.empty())
+		{
+			Source *least = findLeastImportant();
+			if (least == nullptr)
+				break;
+
+			// Only swap when it's clearly more audible, so sources of similar
+			// loudness don't keep trading places.
+			if (least->getPriority() > s->getPriority())
+				break;
+			if (least->getPriority() == s->getPriority() && s->getAudibility() <= least->getAudibility() * 1.5f)
+				break;
+
+			virtualizeSource(least);
+		}
+
+		double offset = s->getVirtualOffset(now);
+
+		// The reference held by the virtual list moves to the playing list.
+		virtualSources.erase(std::find(virtualSources.begin(), virtualSources.end(), s));
+		s->stopVirtual();
+
+		ALuint out = available.front();
+		available.pop();
+		playing.insert(std::make_pair(s, out));
+
+		// playAtomic releases the source again if it fails, which may drop
+		// the last reference.
+		s->retain();
+		s->resumeVirtualAtomic(out, offset);
+		s->release();
+	}
+}
+
+bool Pool::hasPlayAtTime() const
+{
+	return alSourcePlayAtTimeSOFT != nullptr && alcGetInteger64vSOFT != nullptr;
+}
+
+void Pool::playAtTime(ALuint source, double time)
+{
+	alSourcePlayAtTimeSOFT(source, (ALint64SOFT) (time * 1000000000.0));
+}
+
+void Pool::bufferData(ALuint buffer, ALenum format, void *data, ALsizei size, ALsizei freq)
+{
+	if (alBufferDataStatic != nullptr)
+		alBufferDataStatic(buffer, format, data, size, freq);
+	else
+		alBufferData(buffer, format, data, size, freq);
+}
+
+void Pool::scheduleSource(Source *source, double time)
+{
+	source->retain();
+	scheduledSources.push_back(source);
+	source->setScheduled(true, time);
+
+	// The new deadline may be sooner than the current wait.
+	wake();
+}
+
+void Pool::unscheduleSource(Source *source)
+{
+	auto it = std::find(scheduledSources.begin(), scheduledSources.end(), source);
+	if (it == scheduledSources.end())
+		return;
+
+	scheduledSources.erase(it);
+	source->setScheduled(false, 0.0);
+	source->release();
+}
+
 bool Pool::findSource(Source *source, ALuint &out)
 {
 	std::map<Source *, ALuint>::const_iterator i = playing.find(source);
@@ -24,14 +24,18 @@
 // STD
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
 #include <cmath>
+#include <cstdint>
 
 // LOVE
 #include "common/config.h"
 #include "common/Exception.h"
+#include "common/int.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "audio/Mixer.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -51,6 +55,24 @@
 #include <AL/alext.h>
 #endif
 
+#ifndef ALC_SOFT_device_clock
+typedef int64_t ALCint64SOFT;
+typedef void (ALC_APIENTRY*LPALCGETINTEGER64VSOFT)(ALCdevice *device, ALCenum pname, ALsizei size, ALCint64SOFT *values);
+#define ALC_DEVICE_CLOCK_SOFT 0x1600
+#define ALC_DEVICE_LATENCY_SOFT 0x1601
+#endif
+
+#ifndef AL_EXT_STATIC_BUFFER
+typedef void (AL_APIENTRY*PFNALBUFFERDATASTATICPROC)(const ALuint buffer, ALenum format, ALvoid *data, ALsizei size, ALsizei freq);
+#endif
+
+#ifndef AL_SOFT_source_start_delay
+#ifndef AL_SOFT_source_latency
+typedef int64_t ALint64SOFT;
+#endif
+typedef void (AL_APIENTRY*LPALSOURCEPLAYATTIMESOFT)(ALuint source, ALint64SOFT start_time);
+#endif
+
 namespace love
 {
 namespace audio
@@ -59,6 +81,7 @@ namespace openal
 {
 
 class Source;
+class StaticDataBuffer;
 
 class Pool
 {
@@ -78,11 +101,81 @@ public:
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Refills streaming sources and releases finished ones.
+	 * @return Seconds until a playing source next needs an update, at most
+	 * MAX_UPDATE_DELAY.
+	 **/
+	double update();
+
+	/**
+	 * Blocks for the given number of seconds, or until wake is called.
+	 **/
+	void waitForUpdate(double seconds);
+
+	/**
+	 * Makes waitForUpdate return early, e.g. because a source started playing
+	 * and the time until the next update needs to be recalculated.
+	 **/
+	void wake();
+
+	/**
+	 * Keeps the given Mixer's output filled until nothing else references it.
+	 **/
+	void addMixer(love::audio::Mixer *mixer);
+
+	/**
+	 * Mixes more audio for every Mixer with playing voices, and restarts
+	 * their Sources if they ran out of data. Must be called without the pool
+	 * locked.
+	 **/
+	void updateMixers();
+
+	/**
+	 * Gets a buffer holding the given sample data, shared with any other
+	 * static Source using identical data.
+	 **/
+	StrongRef<StaticDataBuffer> getStaticBuffer(ALenum format, const void *data, ALsizei size, ALsizei freq);
+
+	/**
+	 * Frees the least recently used static buffers no Source references,
+	 * until those left fit in the cache limit.
+	 **/
+	void trimStaticBuffers();
+
+	void setStaticCacheLimit(size_t bytes);
+	size_t getStaticCacheLimit() const;
+
+	/**
+	 * Gets the bytes used by all cached static buffers, and by those no Source
+	 * currently references.
+	 **/
+	void getStaticCacheUsage(size_t &total, size_t &idle) const;
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	/**
+	 * Moves every positional, non-relative Source (playing or not) by -v.
+	 **/
+	void translateOrigin(const float *v);
+
+	/**
+	 * Seconds on the audio device's clock, which Source::playAt uses. Falls
+	 * back to the system timer if the device can't report its clock.
+	 **/
+	double getClockTime();
+
+	/**
+	 * Seconds between audio being mixed and it being heard, if the device can
+	 * report it, otherwise the length of one device update.
+	 **/
+	double getLatency();
+
+	// Longest time between updates, so device disconnection is still noticed
+	// when nothing is playing.
+	static constexpr double MAX_UPDATE_DELAY = 0.1;
+
 private:
 
 	friend class Source;
@@ -98,6 +191,84 @@ private:
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	/**
+	 * Sources are compared by priority, then by how audible they are.
+	 **/
+	static bool isLessImportant(Source *a, Source *b);
+
+	/**
+	 * The playing source that would be virtualized first, if any.
+	 **/
+	Source *findLeastImportant();
+
+	/**
+	 * Frees a playing source's OpenAL source, keeping it playing virtually.
+	 **/
+	void virtualizeSource(Source *source);
+
+	void addVirtualSource(Source *source, double offset);
+	void releaseVirtualSource(Source *source);
+
+	/**
+	 * Whether OpenAL can start sources at an exact device clock time.
+	 **/
+	bool hasPlayAtTime() const;
+	void playAtTime(ALuint source, double time);
+
+	/**
+	 * Fills an OpenAL buffer. With AL_EXT_STATIC_BUFFER the buffer uses the
+	 * data directly instead of copying it, so it must stay valid until the
+	 * buffer is refilled or deleted.
+	 **/
+	void bufferData(ALuint buffer, ALenum format, void *data, ALsizei size, ALsizei freq);
+
+	/**
+	 * Without hasPlayAtTime, scheduled sources are played by update once
+	 * their time has come.
+	 **/
+	void scheduleSource(Source *source, double time);
+	void unscheduleSource(Source *source);
+
+	// Called by every Source when it's created and destroyed.
+	void addSource(Source *source);
+	void removeSource(Source *source);
+
+	/**
+	 * Drops finished virtual sources, and gives OpenAL sources back to the
+	 * most important ones, taking them from less important sources if
+	 * needed.
+	 **/
+	void updateVirtualSources();
+
+	struct StaticBufferKey
+	{
+		uint64 hash;
+		ALsizei size;
+		ALenum format;
+		ALsizei freq;
+
+		bool operator < (const StaticBufferKey &other) const
+		{
+			if (hash != other.hash)
+				return hash < other.hash;
+			if (size != other.size)
+				return size < other.size;
+			if (format != other.format)
+				return format < other.format;
+			return freq < other.freq;
+		}
+	};
+
+	struct StaticBufferEntry
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		uint64 lastUsed;
+
+		// The samples in the buffer, so a hash collision isn't mistaken for a
+		// match.
+		std::vector<char> bytes;
+	};
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
@@ -119,10 +290,36 @@ private:
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Playing sources without an OpenAL source, see virtualizeSource.
+	std::vector<Source *> virtualSources;
+
+	// Sources waiting for update to play them, see scheduleSource.
+	std::vector<Source *> scheduledSources;
+
+	// Every existing Source, see translateOrigin.
+	std::set<Source *> allSources;
+
+	LPALCGETINTEGER64VSOFT alcGetInteger64vSOFT;
+	LPALSOURCEPLAYATTIMESOFT alSourcePlayAtTimeSOFT;
+	PFNALBUFFERDATASTATICPROC alBufferDataStatic;
+	double clockStart;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Static buffers by content, see getStaticBuffer.
+	std::map<StaticBufferKey, StaticBufferEntry> staticBuffers;
+	uint64 staticBufferUses;
+	size_t staticCacheLimit;
+
+	std::vector<StrongRef<love::audio::Mixer>> mixers;
+	love::thread::MutexRef mixerMutex;
+
+	love::thread::MutexRef wakeMutex;
+	love::thread::ConditionalRef wakeCond;
+	bool wakeRequested;
+
 }; // Pool
 
 } // openal
@@ -21,6 +21,11 @@
 #include "RecordingDevice.h"
 #include "Audio.h"
 #include "sound/Sound.h"
+#include "thread/Channel.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
 
 namespace love
 {
@@ -42,8 +47,32 @@ public:
 
 };
 
+class RecordingDevice::CaptureThread : public love::thread::Threadable
+{
+public:
+
+	CaptureThread(RecordingDevice *device)
+		: device(device)
+	{
+		threadName = "RecordingDevice";
+		priority = PRIORITY_HIGH;
+	}
+
+	void threadFunction() override
+	{
+		device->capture();
+	}
+
+private:
+
+	RecordingDevice *device;
+
+}; // CaptureThread
+
 RecordingDevice::RecordingDevice(const char *name) 
 	: name(name)
+	, ringWritePos(0)
+	, ringReadPos(0)
 {
 }
 
@@ -71,13 +100,38 @@ bool RecordingDevice::start(int samples, int sampleRate, int bitDepth, int chann
 	if (device == nullptr)
 		return false;
 
-	alcCaptureStart(device);
-
 	this->samples = samples;
 	this->sampleRate = sampleRate;
 	this->bitDepth = bitDepth;
 	this->channels = channels;
 
+	size_t framesize = (bitDepth / 8) * channels;
+
+	ring.resize(framesize * samples);
+	captureBuffer.resize(framesize * samples);
+	ringWritePos.store(0);
+	ringReadPos.store(0);
+
+	{
+		love::thread::Lock lock(mutex);
+		finish = false;
+		callbackBuffer.resize(framesize * callbackSamples);
+		callbackCount = 0;
+	}
+
+	alcCaptureStart(device);
+
+	// The device is only touched by the capture thread until it stops.
+	captureThread.set(new CaptureThread(this), Acquire::NORETAIN);
+	if (!captureThread->start())
+	{
+		captureThread.set(nullptr);
+		alcCaptureStop(device);
+		alcCaptureCloseDevice(device);
+		device = nullptr;
+		throw love::Exception("Could not start the audio capture thread.");
+	}
+
 	return true;
 }
 
@@ -86,11 +140,119 @@ void RecordingDevice::stop()
 	if (!isRecording())
 		return;
 
+	{
+		love::thread::Lock lock(mutex);
+		finish = true;
+		finishCond->broadcast();
+	}
+
+	captureThread->wait();
+	captureThread.set(nullptr);
+
 	alcCaptureStop(device);
 	alcCaptureCloseDevice(device);
 	device = nullptr;
 }
 
+void RecordingDevice::capture()
+{
+	// Poll often enough that the device's own buffer never fills up.
+	int interval = (int) ((int64) samples * 1000 / sampleRate / 4);
+	interval = std::min(std::max(interval, 1), 10);
+
+	love::thread::Lock lock(mutex);
+
+	while (!finish)
+	{
+		ALCint available = 0;
+		alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, 1, &available);
+
+		if (available > 0)
+			captureSamples((int) available);
+
+		finishCond->wait(mutex, interval);
+	}
+}
+
+void RecordingDevice::captureSamples(int count)
+{
+	size_t framesize = (bitDepth / 8) * channels;
+
+	if (callbackChannel.get() != nullptr)
+	{
+		while (count > 0)
+		{
+			int n = std::min(count, samples);
+			alcCaptureSamples(device, captureBuffer.data(), n);
+			pushCallbackSamples(captureBuffer.data(), n);
+			count -= n;
+		}
+		return;
+	}
+
+	uint64 writepos = ringWritePos.load(std::memory_order_relaxed);
+	uint64 readpos = ringReadPos.load(std::memory_order_acquire);
+
+	// Samples which don't fit stay in the device until getData makes room.
+	count = std::min(count, samples - (int) (writepos - readpos));
+	if (count <= 0)
+		return;
+
+	int start = (int) (writepos % samples);
+	int first = std::min(count, samples - start);
+
+	alcCaptureSamples(device, ring.data() + start * framesize, first);
+	if (count > first)
+		alcCaptureSamples(device, ring.data(), count - first);
+
+	ringWritePos.store(writepos + count, std::memory_order_release);
+}
+
+void RecordingDevice::pushCallbackSamples(const uint8 *data, int count)
+{
+	size_t framesize = (bitDepth / 8) * channels;
+
+	while (count > 0)
+	{
+		int n = std::min(count, callbackSamples - callbackCount);
+		memcpy(callbackBuffer.data() + callbackCount * framesize, data, n * framesize);
+
+		data += n * framesize;
+		count -= n;
+		callbackCount += n;
+
+		if (callbackCount == callbackSamples)
+		{
+			love::sound::SoundData *soundData = soundInstance()->newSoundData(callbackBuffer.data(), callbackSamples, sampleRate, bitDepth, channels);
+			callbackChannel->push(Variant(&love::sound::SoundData::type, soundData));
+			soundData->release();
+			callbackCount = 0;
+		}
+	}
+}
+
+int RecordingDevice::readRing(uint8 *dest, int count)
+{
+	size_t framesize = (bitDepth / 8) * channels;
+
+	uint64 readpos = ringReadPos.load(std::memory_order_relaxed);
+	uint64 writepos = ringWritePos.load(std::memory_order_acquire);
+
+	count = std::min(count, (int) (writepos - readpos));
+	if (count <= 0)
+		return 0;
+
+	int start = (int) (readpos % samples);
+	int first = std::min(count, samples - start);
+
+	memcpy(dest, ring.data() + start * framesize, first * framesize);
+	if (count > first)
+		memcpy(dest + first * framesize, ring.data(), (count - first) * framesize);
+
+	ringReadPos.store(readpos + count, std::memory_order_release);
+	return count;
+}
+
 love::sound::SoundData *RecordingDevice::getData()
 {
 	if (!isRecording())
@@ -102,19 +264,50 @@ love::sound::SoundData *RecordingDevice::getData()
 
 	love::sound::SoundData *soundData = soundInstance()->newSoundData(samples, sampleRate, bitDepth, channels);
 
-	alcCaptureSamples(device, soundData->getData(), samples);
+	readRing((uint8 *) soundData->getData(), samples);
 
 	return soundData;
 }
 
+int RecordingDevice::getData(love::sound::SoundData *dest)
+{
+	if (!isRecording())
+		return 0;
+
+	if (dest->getSampleRate() != sampleRate || dest->getBitDepth() != bitDepth || dest->getChannelCount() != channels)
+		throw love::Exception("The SoundData's format must match the recording format.");
+
+	return readRing((uint8 *) dest->getData(), dest->getSampleCount());
+}
+
+void RecordingDevice::setCallbackChannel(love::thread::Channel *channel, int samples)
+{
+	if (channel != nullptr && samples <= 0)
+		throw love::Exception("Invalid number of samples.");
+
+	love::thread::Lock lock(mutex);
+
+	callbackChannel.set(channel);
+	callbackSamples = channel != nullptr ? samples : 0;
+	callbackBuffer.resize((size_t) (bitDepth / 8) * channels * callbackSamples);
+	callbackCount = 0;
+}
+
+love::thread::Channel *RecordingDevice::getCallbackChannel(int &samples) const
+{
+	love::thread::Lock lock(mutex);
+	samples = callbackSamples;
+	return callbackChannel.get();
+}
+
 int RecordingDevice::getSampleCount() const
 {
 	if (!isRecording())
 		return 0;
 
-	ALCint samples;
-	alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, sizeof(ALCint), &samples);
-	return (int)samples;
+	uint64 writepos = ringWritePos.load(std::memory_order_acquire);
+	uint64 readpos = ringReadPos.load(std::memory_order_acquire);
+	return (int) (writepos - readpos);
 }
 
 int RecordingDevice::getMaxSamples() const
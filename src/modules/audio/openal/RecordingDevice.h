@@ -38,6 +38,11 @@
 
 #include "audio/RecordingDevice.h"
 #include "sound/SoundData.h"
+#include "thread/threads.h"
+
+// C++
+#include <atomic>
+#include <vector>
 
 namespace love
 {
@@ -55,6 +60,9 @@ public:
 	virtual bool start(int samples, int sampleRate, int bitDepth, int channels);
 	virtual void stop();
 	virtual love::sound::SoundData *getData();
+	virtual int getData(love::sound::SoundData *dest);
+	virtual void setCallbackChannel(love::thread::Channel *channel, int samples);
+	virtual love::thread::Channel *getCallbackChannel(int &samples) const;
 	virtual const char *getName() const;
 	virtual int getSampleCount() const;
 	virtual int getMaxSamples() const;
@@ -65,6 +73,16 @@ public:
 
 private:
 
+	class CaptureThread;
+
+	// Runs on the capture thread.
+	void capture();
+	void captureSamples(int count);
+	void pushCallbackSamples(const uint8 *data, int count);
+
+	// Copies up to count samples out of the ring buffer.
+	int readRing(uint8 *dest, int count);
+
 	int samples = DEFAULT_SAMPLES;
 	int sampleRate = DEFAULT_SAMPLE_RATE;
 	int bitDepth = DEFAULT_BIT_DEPTH;
@@ -73,6 +91,28 @@ private:
 	std::string name;
 	ALCdevice *device = nullptr;
 
+	// Captured samples, written by the capture thread and read by getData.
+	// The positions count samples since recording started, so the ring can
+	// be shared without a lock.
+	std::vector<uint8> ring;
+	std::atomic<uint64> ringWritePos;
+	std::atomic<uint64> ringReadPos;
+
+	std::vector<uint8> captureBuffer;
+
+	// Samples collected for the callback Channel.
+	std::vector<uint8> callbackBuffer;
+	int callbackCount = 0;
+
+	// Guards the fields below, which the capture thread reads.
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef finishCond;
+	bool finish = false;
+	StrongRef<love::thread::Channel> callbackChannel;
+	int callbackSamples = 0;
+
+	StrongRef<CaptureThread> captureThread;
+
 }; //RecordingDevice
 
 } //openal
@@ -23,10 +23,12 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "timer/Timer.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -129,7 +131,7 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 	if (fmt == AL_NONE)
 		throw InvalidFormatException(soundData->getChannelCount(), soundData->getBitDepth());
 
-	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+	staticBuffer = pool->getStaticBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate);
 
 	float z[3] = {0, 0, 0};
 
@@ -139,6 +141,8 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 
 	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
 		slotlist.push(i);
+
+	pool->addSource(this);
 }
 
 Source::Source(Pool *pool, love::sound::Decoder *decoder)
@@ -174,6 +178,8 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 
 	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
 		slotlist.push(i);
+
+	pool->addSource(this);
 }
 
 Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers)
@@ -214,6 +220,8 @@ Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffe
 
 	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
 		slotlist.push(i);
+
+	pool->addSource(this);
 }
 
 Source::Source(const Source &s)
@@ -232,6 +240,7 @@ Source::Source(const Source &s)
 	, maxDistance(s.maxDistance)
 	, cone(s.cone)
 	, offsetSamples(0)
+	, priority(s.priority)
 	, sampleRate(s.sampleRate)
 	, channels(s.channels)
 	, bitDepth(s.bitDepth)
@@ -288,11 +297,17 @@ Source::Source(const Source &s)
 		if (push)
 			slotlist.push(i);
 	}
+
+	pool->addSource(this);
 }
 
 Source::~Source()
 {
 	stop();
+	pool->removeSource(this);
+
+	for (const auto &shared : sharedData)
+		shared.second->unpinResident();
 
 	if (sourceType != TYPE_STATIC)
 	{
@@ -326,11 +341,36 @@ love::audio::Source *Source::clone()
 bool Source::play()
 {
 	Lock l = pool->lock();
+
+	// Playing now overrides an earlier playAt.
+	if (scheduled)
+		pool->unscheduleSource(this);
+
+	if (virtualized)
+	{
+		if (virtualPaused)
+		{
+			virtualTime = timer::Timer::getTime();
+			virtualPaused = false;
+		}
+		return true;
+	}
+
 	ALuint out;
 
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
+	{
+		// Everything playing is more important. Play silently until there's
+		// a free OpenAL source, rather than not at all.
+		if (sourceType != TYPE_QUEUE)
+		{
+			pool->addVirtualSource(this, offsetSamples);
+			return true;
+		}
+
 		return valid = false;
+	}
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -339,24 +379,79 @@ bool Source::play()
 	return valid = true;
 }
 
+bool Source::playAt(double time)
+{
+	Lock l = pool->lock();
+
+	if (scheduled || virtualized || pool->isPlaying(this))
+		return false;
+
+	ALuint out;
+	char wasPlaying;
+
+	if (pool->hasPlayAtTime() && pool->assignSource(this, out, wasPlaying))
+	{
+		this->source = out;
+		prepareAtomic();
+
+		// Clear errors.
+		alGetError();
+
+		pool->playAtTime(out, time);
+
+		if (alGetError() != AL_NO_ERROR)
+		{
+			valid = true; //stop() needs source to be valid
+			stop();
+			return false;
+		}
+
+		if (sourceType != TYPE_STREAM)
+			offsetSamples = 0;
+
+		return valid = true;
+	}
+
+	// Without the extension (or a free OpenAL source right now), the pool
+	// thread plays it as close to the time as it can.
+	pool->scheduleSource(this, time);
+	return true;
+}
+
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualized && !scheduled)
 		return;
 
 	Lock l = pool->lock();
-	pool->releaseSource(this);
+
+	if (scheduled)
+		pool->unscheduleSource(this);
+	else if (virtualized)
+		pool->releaseVirtualSource(this);
+	else
+		pool->releaseSource(this);
 }
 
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (scheduled)
+		pool->unscheduleSource(this);
+	else if (virtualized)
+		pauseVirtual();
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (scheduled)
+		return true;
+
+	if (virtualized)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -367,7 +462,7 @@ bool Source::isPlaying() const
 
 bool Source::isFinished() const
 {
-	if (!valid)
+	if (scheduled || virtualized || !valid)
 		return false;
 
 	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
@@ -379,6 +474,20 @@ bool Source::isFinished() const
 }
 
 bool Source::update()
+{
+	if (!prepareUpdate())
+		return false;
+
+	if (needsDecode())
+	{
+		decodeStream();
+		queueDecoded();
+	}
+
+	return true;
+}
+
+bool Source::prepareUpdate()
 {
 	if (!valid)
 		return false;
@@ -419,24 +528,23 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
-						alSourceQueueBuffers(source, 1, &buffer);
-					else
-						unusedBuffers.push(buffer);
-				}
-
-				while (!unusedBuffers.empty())
-				{
-					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					// See streamAtomic. Counted per processed buffer here, since
+					// decodeStream may run after several have been unqueued.
+					if (toLoop > 0)
 					{
-						alSourceQueueBuffers(source, 1, &b);
-						unusedBuffers.pop();
+						if (--toLoop == 0)
+							offsetSamples = 0;
 					}
-					else
-						break;
+
+					unusedBuffers.push(buffer);
 				}
 
+				// The unused buffers are refilled by decodeStream and
+				// queueDecoded, which need to know what's left to play.
+				ALint queued;
+				alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+				streamQueued = queued;
+
 				return true;
 			}
 			return false;
@@ -453,7 +561,7 @@ bool Source::update()
 				ALint size;
 				alGetBufferi(buffers[i], AL_SIZE, &size);
 				bufferedBytes -= size;
-				unusedBuffers.push(buffers[i]);
+				releaseBuffer(buffers[i]);
 			}
 			return !isFinished();
 		}
@@ -464,8 +572,133 @@ bool Source::update()
 	return false;
 }
 
+bool Source::needsDecode() const
+{
+	if (!valid || sourceType != TYPE_STREAM || unusedBuffers.empty())
+		return false;
+
+	return isLooping() || !decoder->isFinished();
+}
+
+void Source::decodeStream()
+{
+	// Unplayed buffers in the queue, including ones decoded below.
+	int pending = streamQueued;
+	size_t count = unusedBuffers.size();
+
+	if (decodedChunks.size() < count)
+		decodedChunks.resize(count);
+
+	decodedCount = 0;
+
+	// Same as streamAtomic, minus the OpenAL calls. The toLoop countdown is
+	// done in prepareUpdate.
+	for (size_t i = 0; i < count; i++)
+	{
+		int decoded = std::max(decoder->decode(), 0);
+
+		if (decoded > 0)
+		{
+			const char *data = (const char *) decoder->getBuffer();
+			decodedChunks[i].assign(data, data + decoded);
+		}
+
+		if (decoder->isFinished() && isLooping())
+		{
+			toLoop = pending > 0 ? pending : buffers;
+			decoder->rewind();
+		}
+
+		if (decoded == 0)
+			break;
+
+		pending++;
+		decodedCount++;
+	}
+}
+
+void Source::queueDecoded()
+{
+	int fmt = Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount());
+
+	for (int i = 0; i < decodedCount && fmt != AL_NONE; i++)
+	{
+		ALuint buffer = unusedBuffers.top();
+		const std::vector<char> &chunk = decodedChunks[i];
+
+		alBufferData(buffer, fmt, chunk.data(), (ALsizei) chunk.size(), decoder->getSampleRate());
+		alSourceQueueBuffers(source, 1, &buffer);
+		unusedBuffers.pop();
+	}
+
+	decodedCount = 0;
+}
+
+double Source::getUpdateDelay() const
+{
+	if (!valid)
+		return -1.0;
+
+	ALint state = AL_STOPPED;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	if (state != AL_PLAYING)
+		return -1.0;
+
+	double framebytes = (double) (channels * (bitDepth / 8));
+	double samples = 0.0;
+
+	// Processed buffers were unqueued by update, so the sample offset is into
+	// the buffer currently being played.
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+		// Only needs an update to notice it has finished.
+		if (isLooping())
+			return -1.0;
+		samples = staticBuffer->getSize() / framebytes;
+		break;
+	case TYPE_STREAM:
+		samples = decoder->getSize() / framebytes;
+		break;
+	case TYPE_QUEUE:
+	{
+		ALint queued = 0;
+		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+		if (queued <= 0)
+			return -1.0;
+		samples = bufferedBytes / framebytes / queued;
+		break;
+	}
+	case TYPE_MAX_ENUM:
+		return -1.0;
+	}
+
+	double rate = sampleRate * (double) pitch;
+	if (rate <= 0.0)
+		return -1.0;
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	return std::max(samples - offset, 0.0) / rate;
+}
+
 void Source::setPitch(float pitch)
 {
+	if (virtualized)
+	{
+		// The virtual position so far was at the old pitch.
+		Lock l = pool->lock();
+		double now = timer::Timer::getTime();
+		double offset = getVirtualOffset(now);
+		if (offset >= 0.0)
+		{
+			virtualOffset = offset;
+			virtualTime = now;
+		}
+	}
+
 	if (valid)
 		alSourcef(source, AL_PITCH, pitch);
 
@@ -526,6 +759,14 @@ void Source::seek(double offset, Source::Unit unit)
 		break;
 	}
 
+	if (virtualized)
+	{
+		// Resumes from here once it has an OpenAL source again.
+		virtualOffset = offsetSamples;
+		virtualTime = timer::Timer::getTime();
+		return;
+	}
+
 	bool wasPlaying = isPlaying();
 	switch (sourceType)
 	{
@@ -597,7 +838,12 @@ double Source::tell(Source::Unit unit)
 
 	int offset = 0;
 
-	if (valid)
+	if (virtualized)
+	{
+		double voffset = getVirtualOffset(timer::Timer::getTime());
+		offset = voffset >= 0.0 ? (int) voffset : (int) getDuration(UNIT_SAMPLES);
+	}
+	else if (valid)
 		alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
 
 	offset += offsetSamples;
@@ -659,6 +905,18 @@ void Source::setPosition(float *v)
 	setFloatv(position, v);
 }
 
+void Source::translateOrigin(const float *v)
+{
+	if (channels > 1 || relative)
+		return;
+
+	for (int i = 0; i < 3; i++)
+		position[i] -= v[i];
+
+	if (valid)
+		alSourcefv(source, AL_POSITION, position);
+}
+
 void Source::getPosition(float *v) const
 {
 	if (channels > 1)
@@ -803,14 +1061,83 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	auto buffer = unusedBuffers.top();
 	unusedBuffers.pop();
 	alBufferData(buffer, Audio::getFormat(bitDepth, channels), data, length, sampleRate);
+	queueBuffer(buffer, length);
+
+	return true;
+}
+
+bool Source::queueShared(love::sound::SoundData *data)
+{
+	if (sourceType != TYPE_QUEUE)
+		throw QueueTypeMismatchException();
+
+	if (data->getSampleRate() != sampleRate || data->getBitDepth() != bitDepth || data->getChannelCount() != channels)
+		throw QueueFormatMismatchException();
+
+	size_t length = data->getSize();
+
+	if (length == 0)
+		return true;
+
+	Lock l = pool->lock();
+
+	if (unusedBuffers.empty())
+		return false;
+
+	auto buffer = unusedBuffers.top();
+	unusedBuffers.pop();
+
+	// OpenAL may read the bytes in place until the buffer is released, so
+	// they must not be compressed while idle meanwhile.
+	data->pinResident();
+	pool->bufferData(buffer, Audio::getFormat(bitDepth, channels), data->getData(), (ALsizei) length, sampleRate);
+	sharedData[buffer].set(data);
+	queueBuffer(buffer, length);
+
+	return true;
+}
+
+StrongRef<love::sound::SoundData> Source::popReleased()
+{
+	Lock l = pool->lock();
+
+	StrongRef<love::sound::SoundData> data;
+
+	if (!releasedData.empty())
+	{
+		data = releasedData.front();
+		releasedData.pop();
+	}
+
+	return data;
+}
+
+void Source::queueBuffer(ALuint buffer, size_t length)
+{
 	bufferedBytes += length;
 
 	if (valid)
+	{
 		alSourceQueueBuffers(source, 1, &buffer);
+
+		// The pool may be waiting without a deadline for this source.
+		pool->wake();
+	}
 	else
 		streamBuffers.push(buffer);
+}
 
-	return true;
+void Source::releaseBuffer(ALuint buffer)
+{
+	auto it = sharedData.find(buffer);
+	if (it != sharedData.end())
+	{
+		it->second->unpinResident();
+		releasedData.push(it->second);
+		sharedData.erase(it);
+	}
+
+	unusedBuffers.push(buffer);
 }
 
 int Source::getFreeBufferCount() const
@@ -906,7 +1233,7 @@ void Source::teardownAtomic()
 		alSourceUnqueueBuffers(source, queued, buffers);
 
 		for (int i = 0; i < queued; i++)
-			unusedBuffers.push(buffers[i]);
+			releaseBuffer(buffers[i]);
 		break;
 	}
 	case TYPE_MAX_ENUM:
@@ -986,6 +1313,23 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	Pool *pool = ((Source*) sources[0])->pool;
 	Lock l = pool->lock();
 
+	// Virtual sources are already playing, at most they need to be unpaused.
+	std::vector<love::audio::Source*> nonvirtual;
+	for (auto &_source : sources)
+	{
+		Source *source = (Source*) _source;
+		if (source->scheduled)
+			pool->unscheduleSource(source);
+
+		if (source->virtualized)
+			source->play();
+		else
+			nonvirtual.push_back(source);
+	}
+
+	if (nonvirtual.size() != sources.size())
+		return play(nonvirtual);
+
 	// NOTE: not bool, because std::vector<bool> is implemented as a bitvector
 	// which means no bool references can be created.
 	std::vector<char> wasPlaying(sources.size());
@@ -1060,6 +1404,16 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		if (source->scheduled)
+		{
+			pool->unscheduleSource(source);
+			continue;
+		}
+		if (source->virtualized)
+		{
+			pool->releaseVirtualSource(source);
+			continue;
+		}
 		if (source->valid)
 			source->teardownAtomic();
 		pool->releaseSource(source, false);
@@ -1078,7 +1432,11 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
-		if (source->valid)
+		if (source->scheduled)
+			source->pool->unscheduleSource(source);
+		else if (source->virtualized)
+			source->pauseVirtual();
+		else if (source->valid)
 			sourceIds.push_back(source->source);
 	}
 
@@ -1090,6 +1448,9 @@ std::vector<love::audio::Source*> Source::pause(Pool *pool)
 	Lock l = pool->lock();
 	std::vector<love::audio::Source*> sources = pool->getPlayingSources();
 
+	for (Source *s : pool->virtualSources)
+		sources.push_back(s);
+
 	auto newend = std::remove_if(sources.begin(), sources.end(), [](love::audio::Source* s) {
 		return !s->isPlaying();
 	});
@@ -1103,6 +1464,12 @@ void Source::stop(Pool *pool)
 {
 	Lock l = pool->lock();
 	stop(pool->getPlayingSources());
+
+	std::vector<love::audio::Source*> virtualSources(pool->virtualSources.begin(), pool->virtualSources.end());
+	stop(virtualSources);
+
+	while (!pool->scheduledSources.empty())
+		pool->unscheduleSource(pool->scheduledSources.back());
 }
 
 void Source::reset()
@@ -1336,6 +1703,157 @@ float Source::getAirAbsorptionFactor() const
 	return absorptionFactor;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+float Source::getAudibility() const
+{
+	float gain = volume;
+
+	// Only mono sources are positional.
+	if (channels == 1)
+	{
+		float listener[3] = {0.0f, 0.0f, 0.0f};
+		if (!relative)
+			alGetListenerfv(AL_POSITION, listener);
+
+		float dx = position[0] - listener[0];
+		float dy = position[1] - listener[1];
+		float dz = position[2] - listener[2];
+		float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+
+		float ref = referenceDistance;
+		float rolloff = rolloffFactor;
+
+		// The distance models as the OpenAL spec defines them.
+		switch (audiomodule()->getDistanceModel())
+		{
+		case Audio::DISTANCE_INVERSE_CLAMPED:
+		case Audio::DISTANCE_LINEAR_CLAMPED:
+		case Audio::DISTANCE_EXPONENT_CLAMPED:
+			distance = std::min(std::max(distance, ref), maxDistance);
+			break;
+		default:
+			break;
+		}
+
+		switch (audiomodule()->getDistanceModel())
+		{
+		case Audio::DISTANCE_INVERSE:
+		case Audio::DISTANCE_INVERSE_CLAMPED:
+			if (ref + rolloff * (distance - ref) > 0.0f)
+				gain *= ref / (ref + rolloff * (distance - ref));
+			break;
+		case Audio::DISTANCE_LINEAR:
+		case Audio::DISTANCE_LINEAR_CLAMPED:
+			if (maxDistance > ref)
+				gain *= std::max(1.0f - rolloff * (distance - ref) / (maxDistance - ref), 0.0f);
+			break;
+		case Audio::DISTANCE_EXPONENT:
+		case Audio::DISTANCE_EXPONENT_CLAMPED:
+			if (distance > 0.0f && ref > 0.0f)
+				gain *= powf(distance / ref, -rolloff);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
+bool Source::isVirtual() const
+{
+	return virtualized;
+}
+
+void Source::startVirtual(double offset, double now)
+{
+	virtualized = true;
+	virtualPaused = false;
+	virtualOffset = offset;
+	virtualTime = now;
+	offsetSamples = 0;
+}
+
+void Source::stopVirtual()
+{
+	virtualized = false;
+	virtualPaused = false;
+}
+
+void Source::pauseVirtual()
+{
+	if (virtualPaused)
+		return;
+
+	double now = timer::Timer::getTime();
+	double offset = getVirtualOffset(now);
+
+	// A finished source is dropped by the next Pool update.
+	if (offset < 0.0)
+		return;
+
+	virtualOffset = offset;
+	virtualTime = now;
+	virtualPaused = true;
+}
+
+double Source::getVirtualOffset(double now)
+{
+	double offset = virtualOffset;
+	if (!virtualPaused)
+		offset += (now - virtualTime) * sampleRate * pitch;
+
+	double duration = getDuration(UNIT_SAMPLES);
+
+	if (duration > 0.0 && offset >= duration)
+	{
+		if (!isLooping())
+			return -1.0;
+		offset = fmod(offset, duration);
+	}
+
+	return offset;
+}
+
+bool Source::resumeVirtualAtomic(ALuint source, double offset)
+{
+	if (sourceType == TYPE_STREAM)
+	{
+		// Same as seek.
+		decoder->seek(offset / sampleRate);
+		offsetSamples = 0;
+		valid = playAtomic(source);
+		offsetSamples = (int) offset;
+	}
+	else
+	{
+		offsetSamples = (int) offset;
+		valid = playAtomic(source);
+	}
+
+	return valid;
+}
+
+void Source::setScheduled(bool scheduled, double time)
+{
+	this->scheduled = scheduled;
+	scheduledTime = time;
+}
+
+double Source::getScheduledTime() const
+{
+	return scheduledTime;
+}
+
 int Source::getChannelCount() const
 {
 	return channels;
@@ -1506,6 +2024,47 @@ bool Source::getEffect(const char *name, std::map<Filter::Parameter, float> &par
 	return true;
 }
 
+bool Source::setEffectVolume(const char *name, float volume)
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end())
+		return false;
+
+	std::map<Filter::Parameter, float> params;
+	Filter *filter = iter->second.filter;
+
+	if (filter)
+		params = filter->getParams();
+	else
+	{
+		// A lowpass that leaves high frequencies alone is a plain gain.
+		params[Filter::FILTER_TYPE] = Filter::TYPE_LOWPASS;
+		params[Filter::FILTER_HIGHGAIN] = 1.0f;
+	}
+
+	params[Filter::FILTER_VOLUME] = volume;
+
+	return setEffect(name, params);
+}
+
+bool Source::getEffectVolume(const char *name, float &volume) const
+{
+	auto iter = effectmap.find(name);
+	if (iter == effectmap.end())
+		return false;
+
+	volume = 1.0f;
+	if (iter->second.filter)
+	{
+		const auto &params = iter->second.filter->getParams();
+		auto p = params.find(Filter::FILTER_VOLUME);
+		if (p != params.end())
+			volume = p->second;
+	}
+
+	return true;
+}
+
 bool Source::getActiveEffects(std::vector<std::string> &list) const
 {
 	if (effectmap.empty())
@@ -34,6 +34,8 @@
 // STL
 #include <vector>
 #include <stack>
+#include <queue>
+#include <map>
 
 // C
 #include <float.h>
@@ -70,6 +72,7 @@ class Audio;
 class Pool;
 
 // Basically just a reference-counted non-streaming OpenAL buffer object.
+// Shared between Sources with the same sample data, see Pool::getStaticBuffer.
 class StaticDataBuffer : public love::Object
 {
 public:
@@ -106,11 +109,31 @@ public:
 
 	virtual love::audio::Source *clone();
 	virtual bool play();
+	virtual bool playAt(double time);
 	virtual void stop();
 	virtual void pause();
 	virtual bool isPlaying() const;
 	virtual bool isFinished() const;
 	virtual bool update();
+
+	/**
+	 * The steps of update, split up so Pool can decode several streams at
+	 * once. prepareUpdate and queueDecoded make OpenAL calls; decodeStream
+	 * only touches the decoder, and can run on any thread while the pool is
+	 * locked.
+	 **/
+	bool prepareUpdate();
+	bool needsDecode() const;
+	void decodeStream();
+	void queueDecoded();
+
+	/**
+	 * Estimates the seconds until the source next needs update, i.e. until
+	 * the buffer being played runs out. Returns a negative value if it doesn't
+	 * need updates until something else changes (e.g. it's paused).
+	 **/
+	double getUpdateDelay() const;
+
 	virtual void setPitch(float pitch);
 	virtual float getPitch() const;
 	virtual void setVolume(float volume);
@@ -143,6 +166,48 @@ public:
 	virtual void setAirAbsorptionFactor(float factor);
 	virtual float getAirAbsorptionFactor() const;
 	virtual int getChannelCount() const;
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+
+	/**
+	 * Moves a positional, non-relative source by -v. Must be called with the
+	 * pool locked, see Pool::translateOrigin.
+	 **/
+	void translateOrigin(const float *v);
+
+	/**
+	 * Estimates how loud the source is to the listener, from its volume and
+	 * distance attenuation. Pool virtualizes the least audible sources when
+	 * it runs out of OpenAL sources.
+	 **/
+	float getAudibility() const;
+
+	/**
+	 * Virtual sources are playing, but without an OpenAL source. Their
+	 * position is kept track of so they can resume where they'd be once
+	 * Pool has a free OpenAL source again.
+	 **/
+	bool isVirtual() const;
+	void startVirtual(double offset, double now);
+	void stopVirtual();
+	void pauseVirtual();
+
+	/**
+	 * The sample the virtual source has reached, or a negative value if it
+	 * has finished.
+	 **/
+	double getVirtualOffset(double now);
+
+	/**
+	 * Starts playing a virtual source on the given OpenAL source.
+	 **/
+	bool resumeVirtualAtomic(ALuint source, double offset);
+
+	/**
+	 * Scheduled sources are waiting for Pool to play them, see playAt.
+	 **/
+	void setScheduled(bool scheduled, double time);
+	double getScheduledTime() const;
 
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params);
 	virtual bool setFilter();
@@ -153,9 +218,13 @@ public:
 	virtual bool unsetEffect(const char *effect);
 	virtual bool getEffect(const char *effect, std::map<Filter::Parameter, float> &params);
 	virtual bool getActiveEffects(std::vector<std::string> &list) const;
+	virtual bool setEffectVolume(const char *effect, float volume);
+	virtual bool getEffectVolume(const char *effect, float &volume) const;
 
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
+	virtual bool queueShared(love::sound::SoundData *data);
+	virtual StrongRef<love::sound::SoundData> popReleased();
 
 	void prepareAtomic();
 	void teardownAtomic();
@@ -180,6 +249,13 @@ private:
 
 	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
 
+	// Queues a filled buffer for a queueable source.
+	void queueBuffer(ALuint buffer, size_t length);
+
+	// Returns a queueable source's buffer to the unused stack, handing any
+	// SoundData it was sharing back to the user.
+	void releaseBuffer(ALuint buffer);
+
 	Pool *pool = nullptr;
 	ALuint source = 0;
 	bool valid = false;
@@ -189,6 +265,10 @@ private:
 	std::queue<ALuint> streamBuffers;
 	std::stack<ALuint> unusedBuffers;
 
+	// SoundData referenced by queued buffers, and what's finished playing.
+	std::map<ALuint, StrongRef<love::sound::SoundData>> sharedData;
+	std::queue<StrongRef<love::sound::SoundData>> releasedData;
+
 	StrongRef<StaticDataBuffer> staticBuffer;
 
 	float pitch = 1.0f;
@@ -215,12 +295,29 @@ private:
 
 	int offsetSamples = 0;
 
+	int priority = 0;
+
+	bool virtualized = false;
+	bool virtualPaused = false;
+	double virtualOffset = 0.0;
+	double virtualTime = 0.0;
+
+	bool scheduled = false;
+	double scheduledTime = 0.0;
+
 	int sampleRate = 0;
 	int channels = 0;
 	int bitDepth = 0;
 
 	StrongRef<love::sound::Decoder> decoder;
 
+	// Data decoded by decodeStream, waiting for queueDecoded.
+	std::vector<std::vector<char>> decodedChunks;
+	int decodedCount = 0;
+
+	// Unplayed buffers in the stream's queue as of prepareUpdate.
+	int streamQueued = 0;
+
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
@@ -26,6 +26,7 @@
 #include "null/Audio.h"
 
 #include "common/runtime.h"
+#include "common/Trace.h"
 
 // C++
 #include <iostream>
@@ -44,6 +45,65 @@ int w_getActiveSourceCount(lua_State *L)
 	return 1;
 }
 
+int w_getClockTime(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getClockTime());
+	lua_pushnumber(L, instance()->getLatency());
+	return 2;
+}
+
+int w_getDeviceInfo(lua_State *L)
+{
+	Audio::DeviceInfo info = instance()->getDeviceInfo();
+
+	const char *modestr = nullptr;
+	if (!Audio::getConstant(info.outputMode, modestr))
+		return luaL_error(L, "Unknown audio output mode.");
+
+	lua_createtable(L, 0, 4);
+
+	lua_pushinteger(L, info.frequency);
+	lua_setfield(L, -2, "frequency");
+
+	lua_pushinteger(L, info.refresh);
+	lua_setfield(L, -2, "refresh");
+
+	lua_pushnumber(L, info.latency);
+	lua_setfield(L, -2, "latency");
+
+	lua_pushstring(L, modestr);
+	lua_setfield(L, -2, "outputmode");
+
+	return 1;
+}
+
+int w_setStaticCacheLimit(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Static cache limit must not be negative.");
+
+	instance()->setStaticCacheLimit((size_t) bytes);
+	return 0;
+}
+
+int w_getStaticCacheLimit(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getStaticCacheLimit());
+	return 1;
+}
+
+int w_getStaticCacheUsage(lua_State *L)
+{
+	size_t total = 0;
+	size_t idle = 0;
+	instance()->getStaticCacheUsage(total, idle);
+
+	lua_pushnumber(L, (lua_Number) total);
+	lua_pushnumber(L, (lua_Number) idle);
+	return 2;
+}
+
 int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
@@ -71,7 +131,10 @@ int w_newSource(lua_State *L)
 				lua_pushnil(L);
 
 			// buffer size
-			lua_pushnil(L);
+			if (stype == Source::TYPE_STATIC)
+				lua_pushinteger(L, love::sound::Decoder::FULL_DECODE_BUFFER_SIZE);
+			else
+				lua_pushnil(L);
 
 			// (file, buffer size, stream type)
 			int idxs[] = { 1, lua_gettop(L), lua_gettop(L) - 1 };
@@ -101,6 +164,19 @@ int w_newSource(lua_State *L)
 		return luax_typerror(L, 1, "Decoder or SoundData");
 }
 
+int w_newMixer(lua_State *L)
+{
+	int maxvoices = (int) luaL_optinteger(L, 1, 256);
+	int samplerate = (int) luaL_optinteger(L, 2, 44100);
+
+	Mixer *t = nullptr;
+	luax_catchexcept(L, [&]() { t = instance()->newMixer(maxvoices, samplerate); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newQueueableSource(lua_State *L)
 {
 	int samplerate = (int) luaL_checkinteger(L, 1);
@@ -241,6 +317,16 @@ int w_getPosition(lua_State *L)
 	return 3;
 }
 
+int w_translateOrigin(lua_State *L)
+{
+	float v[3];
+	v[0] = (float)luaL_checknumber(L, 1);
+	v[1] = (float)luaL_checknumber(L, 2);
+	v[2] = (float)luaL_optnumber(L, 3, 0);
+	instance()->translateOrigin(v);
+	return 0;
+}
+
 int w_setOrientation(lua_State *L)
 {
 	float v[6];
@@ -507,6 +593,24 @@ int w_getEffect(lua_State *L)
 	return 1;
 }
 
+int w_setEffectVolume(lua_State *L)
+{
+	const char *namestr = luaL_checkstring(L, 1);
+	float volume = (float) luaL_checknumber(L, 2);
+	lua_pushboolean(L, instance()->setEffectVolume(namestr, volume));
+	return 1;
+}
+
+int w_getEffectVolume(lua_State *L)
+{
+	const char *namestr = luaL_checkstring(L, 1);
+	float volume = 1.0f;
+	if (!instance()->getEffectVolume(namestr, volume))
+		return 0;
+	lua_pushnumber(L, volume);
+	return 1;
+}
+
 int w_getActiveEffects(lua_State *L)
 {
 	std::vector<std::string> list;
@@ -596,8 +700,14 @@ int w_setPlaybackDevice(lua_State* L)
 static const luaL_Reg functions[] =
 {
 	{ "getActiveSourceCount", w_getActiveSourceCount },
+	{ "getClockTime", w_getClockTime },
+	{ "getDeviceInfo", w_getDeviceInfo },
+	{ "setStaticCacheLimit", w_setStaticCacheLimit },
+	{ "getStaticCacheLimit", w_getStaticCacheLimit },
+	{ "getStaticCacheUsage", w_getStaticCacheUsage },
 	{ "newSource", w_newSource },
 	{ "newQueueableSource", w_newQueueableSource },
+	{ "newMixer", w_newMixer },
 	{ "play", w_play },
 	{ "stop", w_stop },
 	{ "pause", w_pause },
@@ -605,6 +715,7 @@ static const luaL_Reg functions[] =
 	{ "getVolume", w_getVolume },
 	{ "setPosition", w_setPosition },
 	{ "getPosition", w_getPosition },
+	{ "translateOrigin", w_translateOrigin },
 	{ "setOrientation", w_setOrientation },
 	{ "getOrientation", w_getOrientation },
 	{ "setVelocity", w_setVelocity },
@@ -619,6 +730,8 @@ static const luaL_Reg functions[] =
 	{ "setEffect", w_setEffect },
 	{ "getEffect", w_getEffect },
 	{ "getActiveEffects", w_getActiveEffects },
+	{ "setEffectVolume", w_setEffectVolume },
+	{ "getEffectVolume", w_getEffectVolume },
 	{ "getMaxSceneEffects", w_getMaxSceneEffects },
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
@@ -633,28 +746,26 @@ static const luaL_Reg functions[] =
 static const lua_CFunction types[] =
 {
 	luaopen_source,
+	luaopen_mixer,
 	luaopen_recordingdevice,
 	0
 };
 
-extern "C" int luaopen_love_audio(lua_State *L)
+static Module *createInstance()
 {
-	Audio *instance = instance();
+	LOVE_TRACE_STARTUP_STAGE("audio device");
 
-	if (instance == nullptr)
+	Audio *instance = nullptr;
+
+	// Try OpenAL first.
+	try
 	{
-		// Try OpenAL first.
-		try
-		{
-			instance = new love::audio::openal::Audio();
-		}
-		catch(love::Exception &e)
-		{
-			std::cout << e.what() << std::endl;
-		}
+		instance = new love::audio::openal::Audio();
+	}
+	catch(love::Exception &e)
+	{
+		std::cout << e.what() << std::endl;
 	}
-	else
-		instance->retain();
 
 	if (instance == nullptr)
 	{
@@ -670,7 +781,30 @@ extern "C" int luaopen_love_audio(lua_State *L)
 	}
 
 	if (instance == nullptr)
-		return luaL_error(L, "Could not open any audio module.");
+		throw love::Exception("Could not open any audio module.");
+
+	return instance;
+}
+
+void preloadModule()
+{
+	Module::preloadInstance(Module::M_AUDIO, createInstance);
+}
+
+extern "C" int luaopen_love_audio(lua_State *L)
+{
+	Audio *instance = instance();
+
+	if (instance == nullptr)
+	{
+		luax_catchexcept(L, [&]() {
+			instance = (Audio *) Module::takePreloadedInstance(Module::M_AUDIO);
+			if (instance == nullptr)
+				instance = (Audio *) createInstance();
+		});
+	}
+	else
+		instance->retain();
 
 	WrappedModule w;
 	w.module = instance;
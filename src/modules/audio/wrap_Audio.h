@@ -26,6 +26,7 @@
 #include "common/runtime.h"
 #include "Audio.h"
 #include "wrap_Source.h"
+#include "wrap_Mixer.h"
 #include "wrap_RecordingDevice.h"
 
 namespace love
@@ -33,6 +34,12 @@ namespace love
 namespace audio
 {
 
+/**
+ * Starts opening the audio device on a worker thread. luaopen_love_audio
+ * picks up the instance once it's ready.
+ **/
+void preloadModule();
+
 extern "C" LOVE_EXPORT int luaopen_love_audio(lua_State *L);
 
 } // audio
@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Mixer.h"
+#include "sound/wrap_SoundData.h"
+
+#include <limits>
+
+namespace love
+{
+namespace audio
+{
+
+Mixer *luax_checkmixer(lua_State *L, int idx)
+{
+	return luax_checktype<Mixer>(L, idx);
+}
+
+static uint32 checkVoiceID(lua_State *L, int idx)
+{
+	return (uint32) luaL_checkinteger(L, idx);
+}
+
+static float checkPitch(lua_State *L, float p)
+{
+	if (p != p)
+		return luaL_error(L, "Pitch cannot be NaN.");
+	if (p > std::numeric_limits<lua_Number>::max() || p <= 0.0f)
+		return luaL_error(L, "Pitch has to be non-zero, positive, finite number.");
+	return p;
+}
+
+int w_Mixer_play(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	love::sound::SoundData *data = love::sound::luax_checksounddata(L, 2);
+
+	float volume = 1.0f;
+	float pitch = 1.0f;
+	float pan = 0.0f;
+	int priority = 0;
+	bool looping = false;
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		volume = (float) luax_numberflag(L, 3, "volume", volume);
+		pitch = checkPitch(L, (float) luax_numberflag(L, 3, "pitch", pitch));
+		pan = (float) luax_numberflag(L, 3, "pan", pan);
+		priority = luax_intflag(L, 3, "priority", priority);
+		looping = luax_boolflag(L, 3, "loop", looping);
+	}
+
+	uint32 id = 0;
+	luax_catchexcept(L, [&]() { id = t->play(data, volume, pitch, pan, priority, looping); });
+
+	if (id == 0)
+		lua_pushnil(L);
+	else
+		lua_pushinteger(L, id);
+	return 1;
+}
+
+int w_Mixer_stop(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	if (lua_isnoneornil(L, 2))
+		t->stop();
+	else
+		t->stop(checkVoiceID(L, 2));
+	return 0;
+}
+
+int w_Mixer_isPlaying(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	luax_pushboolean(L, t->isPlaying(checkVoiceID(L, 2)));
+	return 1;
+}
+
+int w_Mixer_setVoiceVolume(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	uint32 id = checkVoiceID(L, 2);
+	float volume = (float) luaL_checknumber(L, 3);
+	luax_pushboolean(L, t->setVoiceVolume(id, volume));
+	return 1;
+}
+
+int w_Mixer_setVoicePitch(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	uint32 id = checkVoiceID(L, 2);
+	float pitch = checkPitch(L, (float) luaL_checknumber(L, 3));
+	luax_pushboolean(L, t->setVoicePitch(id, pitch));
+	return 1;
+}
+
+int w_Mixer_setVoicePan(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	uint32 id = checkVoiceID(L, 2);
+	float pan = (float) luaL_checknumber(L, 3);
+	luax_pushboolean(L, t->setVoicePan(id, pan));
+	return 1;
+}
+
+int w_Mixer_setVolume(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	t->setVolume((float) luaL_checknumber(L, 2));
+	return 0;
+}
+
+int w_Mixer_getVolume(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	lua_pushnumber(L, t->getVolume());
+	return 1;
+}
+
+int w_Mixer_setMaxVoices(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { t->setMaxVoices(count); });
+	return 0;
+}
+
+int w_Mixer_getMaxVoices(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	lua_pushinteger(L, t->getMaxVoices());
+	return 1;
+}
+
+int w_Mixer_setMaxAudibleVoices(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { t->setMaxAudibleVoices(count); });
+	return 0;
+}
+
+int w_Mixer_getMaxAudibleVoices(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	lua_pushinteger(L, t->getMaxAudibleVoices());
+	return 1;
+}
+
+int w_Mixer_getVoiceCount(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	lua_pushinteger(L, t->getVoiceCount());
+	lua_pushinteger(L, t->getAudibleVoiceCount());
+	return 2;
+}
+
+int w_Mixer_getSampleRate(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	lua_pushinteger(L, t->getSampleRate());
+	return 1;
+}
+
+int w_Mixer_getSource(lua_State *L)
+{
+	Mixer *t = luax_checkmixer(L, 1);
+	luax_pushtype(L, t->getSource());
+	return 1;
+}
+
+static const luaL_Reg w_Mixer_functions[] =
+{
+	{ "play", w_Mixer_play },
+	{ "stop", w_Mixer_stop },
+	{ "isPlaying", w_Mixer_isPlaying },
+	{ "setVoiceVolume", w_Mixer_setVoiceVolume },
+	{ "setVoicePitch", w_Mixer_setVoicePitch },
+	{ "setVoicePan", w_Mixer_setVoicePan },
+	{ "setVolume", w_Mixer_setVolume },
+	{ "getVolume", w_Mixer_getVolume },
+	{ "setMaxVoices", w_Mixer_setMaxVoices },
+	{ "getMaxVoices", w_Mixer_getMaxVoices },
+	{ "setMaxAudibleVoices", w_Mixer_setMaxAudibleVoices },
+	{ "getMaxAudibleVoices", w_Mixer_getMaxAudibleVoices },
+	{ "getVoiceCount", w_Mixer_getVoiceCount },
+	{ "getSampleRate", w_Mixer_getSampleRate },
+	{ "getSource", w_Mixer_getSource },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_mixer(lua_State *L)
+{
+	return luax_register_type(L, &Mixer::type, w_Mixer_functions, nullptr);
+}
+
+} // audio
+} // love
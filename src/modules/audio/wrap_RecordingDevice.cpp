@@ -79,6 +79,17 @@ int w_RecordingDevice_stop(lua_State *L)
 int w_RecordingDevice_getData(lua_State *L)
 {
 	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+
+	// Reads into an existing SoundData, and returns the sample count.
+	if (!lua_isnoneornil(L, 2))
+	{
+		love::sound::SoundData *dest = luax_checktype<love::sound::SoundData>(L, 2);
+		int count = 0;
+		luax_catchexcept(L, [&](){ count = d->getData(dest); });
+		lua_pushinteger(L, count);
+		return 1;
+	}
+
 	love::sound::SoundData *s = nullptr;
 
 	luax_catchexcept(L, [&](){ s = d->getData(); });
@@ -94,6 +105,38 @@ int w_RecordingDevice_getData(lua_State *L)
 	return 1;
 }
 
+int w_RecordingDevice_setCallbackChannel(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+
+	love::thread::Channel *channel = nullptr;
+	int samples = 0;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		channel = luax_checktype<love::thread::Channel>(L, 2);
+		samples = (int) luaL_checkinteger(L, 3);
+	}
+
+	luax_catchexcept(L, [&](){ d->setCallbackChannel(channel, samples); });
+	return 0;
+}
+
+int w_RecordingDevice_getCallbackChannel(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+
+	int samples = 0;
+	love::thread::Channel *channel = d->getCallbackChannel(samples);
+
+	if (channel == nullptr)
+		return 0;
+
+	luax_pushtype(L, channel);
+	lua_pushinteger(L, samples);
+	return 2;
+}
+
 int w_RecordingDevice_getSampleCount(lua_State *L)
 {
 	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
@@ -141,6 +184,8 @@ static const luaL_Reg w_RecordingDevice_functions[] =
 	{ "start", w_RecordingDevice_start },
 	{ "stop", w_RecordingDevice_stop },
 	{ "getData", w_RecordingDevice_getData },
+	{ "setCallbackChannel", w_RecordingDevice_setCallbackChannel },
+	{ "getCallbackChannel", w_RecordingDevice_getCallbackChannel },
 	{ "getSampleCount", w_RecordingDevice_getSampleCount },
 	{ "getSampleRate", w_RecordingDevice_getSampleRate },
 	{ "getBitDepth", w_RecordingDevice_getBitDepth },
@@ -53,6 +53,14 @@ int w_Source_play(lua_State *L)
 	return 1;
 }
 
+int w_Source_playAt(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	double time = luaL_checknumber(L, 2);
+	luax_pushboolean(L, t->playAt(time));
+	return 1;
+}
+
 int w_Source_stop(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -353,6 +361,20 @@ int w_Source_getChannelCount(lua_State *L)
 	return 1;
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->setPriority((int) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
 int setFilterReadFilter(lua_State *L, int idx, std::map<Filter::Parameter, float> &params)
 {
 	if (lua_gettop(L) < idx || lua_isnoneornil(L, idx))
@@ -514,6 +536,26 @@ int w_Source_getEffect(lua_State *L)
 	return 2;
 }
 
+int w_Source_setEffectVolume(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	const char *namestr = luaL_checkstring(L, 2);
+	float volume = (float) luaL_checknumber(L, 3);
+	luax_catchexcept(L, [&]() { lua_pushboolean(L, t->setEffectVolume(namestr, volume)); });
+	return 1;
+}
+
+int w_Source_getEffectVolume(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	const char *namestr = luaL_checkstring(L, 2);
+	float volume = 1.0f;
+	if (!t->getEffectVolume(namestr, volume))
+		return 0;
+	lua_pushnumber(L, volume);
+	return 1;
+}
+
 int w_Source_getActiveEffects(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -588,6 +630,31 @@ int w_Source_queue(lua_State *L)
 	return 1;
 }
 
+int w_Source_queueShared(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	auto s = luax_checktype<love::sound::SoundData>(L, 2);
+	bool success = false;
+
+	luax_catchexcept(L, [&]() { success = t->queueShared(s); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_Source_popReleased(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	StrongRef<love::sound::SoundData> s = t->popReleased();
+
+	if (s.get() != nullptr)
+		luax_pushtype(L, s.get());
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
 int w_Source_getType(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -606,6 +673,7 @@ static const luaL_Reg w_Source_functions[] =
 	{ "clone", w_Source_clone },
 
 	{ "play", w_Source_play },
+	{ "playAt", w_Source_playAt },
 	{ "stop", w_Source_stop },
 	{ "pause", w_Source_pause },
 
@@ -643,14 +711,21 @@ static const luaL_Reg w_Source_functions[] =
 
 	{ "getChannelCount", w_Source_getChannelCount },
 
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
+
 	{ "setFilter", w_Source_setFilter },
 	{ "getFilter", w_Source_getFilter },
 	{ "setEffect", w_Source_setEffect },
 	{ "getEffect", w_Source_getEffect },
 	{ "getActiveEffects", w_Source_getActiveEffects },
+	{ "setEffectVolume", w_Source_setEffectVolume },
+	{ "getEffectVolume", w_Source_getEffectVolume },
 
 	{ "getFreeBufferCount", w_Source_getFreeBufferCount },
 	{ "queue", w_Source_queue },
+	{ "queueShared", w_Source_queueShared },
+	{ "popReleased", w_Source_popReleased },
 
 	{ "getType", w_Source_getType },
 
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "BufferedStream.h"
+#include "common/Exception.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace data
+{
+
+love::Type BufferedStream::type("BufferedStream", &Stream::type);
+
+BufferedStream::BufferedStream(Stream *source, int bufferSize)
+	: source(source)
+	, size(0)
+	, position(0)
+	, sourcePosition(0)
+	, bufferStart(0)
+	, bufferLength(0)
+{
+	if (!source->isReadable() || !source->isSeekable())
+		throw love::Exception("BufferedStream source must be readable and seekable.");
+
+	if (bufferSize <= 0)
+		throw love::Exception("Invalid buffer size: %d", bufferSize);
+
+	size = source->getSize();
+	position = sourcePosition = source->tell();
+	buffer.resize((size_t) bufferSize);
+}
+
+BufferedStream::~BufferedStream()
+{
+}
+
+BufferedStream *BufferedStream::clone()
+{
+	StrongRef<Stream> s(source->clone(), Acquire::NORETAIN);
+	return new BufferedStream(s, (int) buffer.size());
+}
+
+bool BufferedStream::isReadable() const
+{
+	return true;
+}
+
+bool BufferedStream::isWritable() const
+{
+	return false;
+}
+
+bool BufferedStream::isSeekable() const
+{
+	return true;
+}
+
+int64 BufferedStream::readSource(void *dst, int64 count)
+{
+	if (sourcePosition != position)
+	{
+		if (!source->seek(position))
+			return -1;
+		sourcePosition = position;
+	}
+
+	int64 read = source->read(dst, count);
+	if (read > 0)
+		sourcePosition += read;
+
+	return read;
+}
+
+int64 BufferedStream::read(void *data, int64 count)
+{
+	uint8 *dst = (uint8 *) data;
+	int64 total = 0;
+
+	while (count > 0)
+	{
+		// Serve what we can from the buffer.
+		if (position >= bufferStart && position < bufferStart + bufferLength)
+		{
+			int64 n = std::min(count, bufferStart + bufferLength - position);
+			memcpy(dst, buffer.data() + (position - bufferStart), (size_t) n);
+			dst += n;
+			total += n;
+			count -= n;
+			position += n;
+			continue;
+		}
+
+		// Large reads skip the buffer.
+		if (count >= (int64) buffer.size())
+		{
+			int64 read = readSource(dst, count);
+			if (read <= 0)
+				break;
+
+			total += read;
+			position += read;
+			break;
+		}
+
+		int64 read = readSource(buffer.data(), (int64) buffer.size());
+		if (read <= 0)
+		{
+			bufferLength = 0;
+			break;
+		}
+
+		bufferStart = position;
+		bufferLength = read;
+	}
+
+	if (total == 0 && count > 0 && position < size)
+		return -1;
+
+	return total;
+}
+
+bool BufferedStream::write(const void *, int64)
+{
+	return false;
+}
+
+bool BufferedStream::flush()
+{
+	return true;
+}
+
+int64 BufferedStream::getSize()
+{
+	return size;
+}
+
+bool BufferedStream::seek(int64 pos, SeekOrigin origin)
+{
+	if (origin == SEEKORIGIN_CURRENT)
+		pos += position;
+	else if (origin == SEEKORIGIN_END)
+		pos += size;
+
+	if (pos < 0 || pos > size)
+		return false;
+
+	// The source is only seeked once data outside the buffer is needed.
+	position = pos;
+	return true;
+}
+
+int64 BufferedStream::tell()
+{
+	return position;
+}
+
+} // data
+} // love
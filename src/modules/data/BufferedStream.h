@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "common/Stream.h"
+
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Reads another Stream in large chunks and serves smaller reads and nearby
+ * seeks from memory. Meant for decoders, which make many small reads and
+ * seeks that can be expensive on file and archive streams. Read-only.
+ **/
+class BufferedStream : public love::Stream
+{
+public:
+
+	static love::Type type;
+
+	static const int DEFAULT_BUFFER_SIZE = 65536;
+
+	BufferedStream(Stream *source, int bufferSize = DEFAULT_BUFFER_SIZE);
+	virtual ~BufferedStream();
+
+	// Implements Stream.
+	BufferedStream *clone() override;
+
+	bool isReadable() const override;
+	bool isWritable() const override;
+	bool isSeekable() const override;
+
+	int64 read(void* data, int64 size) override;
+	bool write(const void* data, int64 size) override;
+
+	bool flush() override;
+
+	int64 getSize() override;
+
+	bool seek(int64 pos, SeekOrigin origin = SEEKORIGIN_BEGIN) override;
+	int64 tell() override;
+
+private:
+
+	// Reads from the source at the current position, seeking it if needed.
+	int64 readSource(void *dst, int64 size);
+
+	StrongRef<Stream> source;
+	int64 size;
+
+	// Current position in this stream, and where the source is positioned.
+	int64 position;
+	int64 sourcePosition;
+
+	// buffer holds bufferLength bytes starting at bufferStart in the source.
+	std::vector<uint8> buffer;
+	int64 bufferStart;
+	int64 bufferLength;
+
+}; // BufferedStream
+
+} // data
+} // love
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionDictionary.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+#ifdef LOVE_ENABLE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+// C++
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+love::Type CompressionDictionary::type("CompressionDictionary", &Data::type);
+
+CompressionDictionary::CompressionDictionary(const void *data, size_t size)
+	: bytes((const uint8 *) data, (const uint8 *) data + size)
+	, decompressionDict(nullptr)
+{
+}
+
+CompressionDictionary::CompressionDictionary(const CompressionDictionary &other)
+	: bytes(other.bytes)
+	, decompressionDict(nullptr)
+{
+}
+
+CompressionDictionary::~CompressionDictionary()
+{
+#ifdef LOVE_ENABLE_ZSTD
+	for (const auto &kvp : compressionDicts)
+		ZSTD_freeCDict(kvp.second);
+	ZSTD_freeDDict(decompressionDict);
+#endif
+}
+
+CompressionDictionary *CompressionDictionary::train(const std::vector<Data *> &samples, size_t maxSize)
+{
+#ifdef LOVE_ENABLE_ZSTD
+	if (samples.empty())
+		throw love::Exception("At least one sample is needed to train a compression dictionary.");
+
+	// ZDICT wants all samples in one contiguous buffer.
+	size_t totalsize = 0;
+	for (Data *sample : samples)
+		totalsize += sample->getSize();
+
+	std::vector<uint8> samplebuffer(totalsize);
+	std::vector<size_t> samplesizes;
+	samplesizes.reserve(samples.size());
+
+	size_t offset = 0;
+	for (Data *sample : samples)
+	{
+		if (sample->getSize() > 0)
+			memcpy(samplebuffer.data() + offset, sample->getData(), sample->getSize());
+		offset += sample->getSize();
+		samplesizes.push_back(sample->getSize());
+	}
+
+	std::vector<uint8> dict(maxSize);
+	size_t size = ZDICT_trainFromBuffer(dict.data(), dict.size(), samplebuffer.data(), samplesizes.data(), (unsigned) samplesizes.size());
+
+	if (ZDICT_isError(size))
+		throw love::Exception("Could not train compression dictionary: %s", ZDICT_getErrorName(size));
+
+	return new CompressionDictionary(dict.data(), size);
+#else
+	LOVE_UNUSED(samples);
+	LOVE_UNUSED(maxSize);
+	throw love::Exception("Compression dictionaries require zstd support, which is not available in this build.");
+#endif
+}
+
+CompressionDictionary *CompressionDictionary::clone() const
+{
+	return new CompressionDictionary(*this);
+}
+
+void *CompressionDictionary::getData() const
+{
+	return (void *) bytes.data();
+}
+
+size_t CompressionDictionary::getSize() const
+{
+	return bytes.size();
+}
+
+uint32 CompressionDictionary::getID() const
+{
+#ifdef LOVE_ENABLE_ZSTD
+	return ZSTD_getDictID_fromDict(bytes.data(), bytes.size());
+#else
+	return 0;
+#endif
+}
+
+ZSTD_CDict_s *CompressionDictionary::getCompressionDict(int level)
+{
+#ifdef LOVE_ENABLE_ZSTD
+	love::thread::Lock lock(mutex);
+
+	auto it = compressionDicts.find(level);
+	if (it != compressionDicts.end())
+		return it->second;
+
+	ZSTD_CDict *cdict = ZSTD_createCDict(bytes.data(), bytes.size(), level);
+	if (cdict == nullptr)
+		throw love::Exception("Could not create zstd compression dictionary.");
+
+	compressionDicts[level] = cdict;
+	return cdict;
+#else
+	LOVE_UNUSED(level);
+	throw love::Exception("Compression dictionaries require zstd support, which is not available in this build.");
+#endif
+}
+
+ZSTD_DDict_s *CompressionDictionary::getDecompressionDict()
+{
+#ifdef LOVE_ENABLE_ZSTD
+	love::thread::Lock lock(mutex);
+
+	if (decompressionDict == nullptr)
+	{
+		decompressionDict = ZSTD_createDDict(bytes.data(), bytes.size());
+		if (decompressionDict == nullptr)
+			throw love::Exception("Could not create zstd decompression dictionary.");
+	}
+
+	return decompressionDict;
+#else
+	throw love::Exception("Compression dictionaries require zstd support, which is not available in this build.");
+#endif
+}
+
+} // data
+} // love
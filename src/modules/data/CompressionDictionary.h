@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Data.h"
+#include "common/int.h"
+#include "thread/threads.h"
+
+// C++
+#include <map>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * A zstd dictionary. Compressing many small, similar pieces of data (such as
+ * network packets) with a dictionary trained on samples of that data gives
+ * much better compression ratios than compressing each piece on its own.
+ **/
+class CompressionDictionary : public love::Data
+{
+public:
+
+	static love::Type type;
+
+	CompressionDictionary(const void *data, size_t size);
+	CompressionDictionary(const CompressionDictionary &other);
+	virtual ~CompressionDictionary();
+
+	/**
+	 * Trains a new dictionary from samples which are representative of the
+	 * data that will be compressed.
+	 *
+	 * @param samples The sample data.
+	 * @param maxSize The maximum size in bytes of the dictionary.
+	 **/
+	static CompressionDictionary *train(const std::vector<Data *> &samples, size_t maxSize);
+
+	// Implements Data.
+	CompressionDictionary *clone() const override;
+	void *getData() const override;
+	size_t getSize() const override;
+
+	/**
+	 * Gets the dictionary's ID, which is stored in compressed data to identify
+	 * the dictionary it needs. Returns 0 for raw-content dictionaries.
+	 **/
+	uint32 getID() const;
+
+	/**
+	 * Gets the digested form of the dictionary for compression at a specific
+	 * level. These are expensive to create, so they're created on first use
+	 * and kept around afterwards.
+	 **/
+	ZSTD_CDict_s *getCompressionDict(int level);
+	ZSTD_DDict_s *getDecompressionDict();
+
+private:
+
+	std::vector<uint8> bytes;
+
+	love::thread::MutexRef mutex;
+	std::map<int, ZSTD_CDict_s *> compressionDicts;
+	ZSTD_DDict_s *decompressionDict;
+
+}; // CompressionDictionary
+
+} // data
+} // love
@@ -0,0 +1,821 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionStream.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+
+#include <zlib.h>
+
+#ifdef LOVE_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+static void writeUint32LE(uint8 *dst, uint32 v)
+{
+	dst[0] = (uint8) (v >> 0);
+	dst[1] = (uint8) (v >> 8);
+	dst[2] = (uint8) (v >> 16);
+	dst[3] = (uint8) (v >> 24);
+}
+
+static uint32 readUint32LE(const uint8 *src)
+{
+	return (uint32) src[0] | ((uint32) src[1] << 8) | ((uint32) src[2] << 16) | ((uint32) src[3] << 24);
+}
+
+/**
+ * LZ4 doesn't have a streaming format in the block API, so we write a header
+ * with the uncompressed and compressed sizes before each block. A header with
+ * both sizes set to 0 marks the end of the stream. Each block can reference
+ * the previous 64 KB of data, which gives close to whole-buffer compression
+ * ratios even when flushing small chunks.
+ **/
+class LZ4Codec : public CompressionStream::Codec
+{
+public:
+
+	LZ4Codec(CompressionStream::Mode mode, int level)
+		: compressing(mode == CompressionStream::MODE_COMPRESS)
+		, highCompression(level > 8)
+		, highCompressionLevel(std::min(level, LZ4HC_CLEVEL_MAX))
+		, stream(nullptr)
+		, streamHC(nullptr)
+		, dictSize(0)
+	{
+		if (compressing)
+		{
+			if (highCompression)
+				streamHC = LZ4_createStreamHC();
+			else
+				stream = LZ4_createStream();
+
+			if (stream == nullptr && streamHC == nullptr)
+				throw love::Exception("Out of memory.");
+
+			pending.reserve(BLOCK_SIZE);
+		}
+
+		dict.resize(BLOCK_SIZE);
+		reset();
+	}
+
+	virtual ~LZ4Codec()
+	{
+		if (stream != nullptr)
+			LZ4_freeStream(stream);
+		if (streamHC != nullptr)
+			LZ4_freeStreamHC(streamHC);
+	}
+
+	bool process(const uint8 *src, size_t size, CompressionStream::Flush flush, std::vector<uint8> &dst) override
+	{
+		if (compressing)
+			return compress(src, size, flush, dst);
+		else
+			return decompress(src, size, flush, dst);
+	}
+
+	void reset() override
+	{
+		if (stream != nullptr)
+			LZ4_resetStream(stream);
+		if (streamHC != nullptr)
+			LZ4_resetStreamHC(streamHC, highCompressionLevel);
+
+		pending.clear();
+		dictSize = 0;
+	}
+
+private:
+
+	static const size_t BLOCK_SIZE = 64 * 1024;
+	static const size_t HEADER_SIZE = sizeof(uint32) * 2;
+
+	bool compress(const uint8 *src, size_t size, CompressionStream::Flush flush, std::vector<uint8> &dst)
+	{
+		while (size > 0)
+		{
+			size_t count = std::min(size, BLOCK_SIZE - pending.size());
+			pending.insert(pending.end(), src, src + count);
+			src += count;
+			size -= count;
+
+			if (pending.size() == BLOCK_SIZE)
+				compressBlock(dst);
+		}
+
+		if (flush != CompressionStream::FLUSH_NONE && !pending.empty())
+			compressBlock(dst);
+
+		if (flush == CompressionStream::FLUSH_FINISH)
+		{
+			size_t start = dst.size();
+			dst.resize(start + HEADER_SIZE, 0);
+			return true;
+		}
+
+		return false;
+	}
+
+	void compressBlock(std::vector<uint8> &dst)
+	{
+		int bound = LZ4_compressBound((int) BLOCK_SIZE);
+		size_t start = dst.size();
+		dst.resize(start + HEADER_SIZE + bound);
+
+		const char *in = (const char *) pending.data();
+		char *out = (char *) &dst[start + HEADER_SIZE];
+
+		int csize = 0;
+		if (highCompression)
+			csize = LZ4_compress_HC_continue(streamHC, in, out, (int) pending.size(), bound);
+		else
+			csize = LZ4_compress_fast_continue(stream, in, out, (int) pending.size(), bound, 1);
+
+		if (csize <= 0)
+			throw love::Exception("Could not LZ4-compress data.");
+
+		writeUint32LE(&dst[start], (uint32) pending.size());
+		writeUint32LE(&dst[start + sizeof(uint32)], (uint32) csize);
+		dst.resize(start + HEADER_SIZE + csize);
+
+		// The pending buffer is reused for the next block, so the history LZ4
+		// references needs to be moved out of it first.
+		if (highCompression)
+			LZ4_saveDictHC(streamHC, (char *) dict.data(), (int) BLOCK_SIZE);
+		else
+			LZ4_saveDict(stream, (char *) dict.data(), (int) BLOCK_SIZE);
+
+		pending.clear();
+	}
+
+	bool decompress(const uint8 *src, size_t size, CompressionStream::Flush /*flush*/, std::vector<uint8> &dst)
+	{
+		// Blocks can be split across any number of process calls.
+		while (size > 0)
+		{
+			size_t needed = HEADER_SIZE;
+			if (pending.size() >= HEADER_SIZE)
+				needed += readUint32LE(&pending[sizeof(uint32)]);
+
+			size_t count = std::min(size, needed - pending.size());
+			pending.insert(pending.end(), src, src + count);
+			src += count;
+			size -= count;
+
+			if (pending.size() < HEADER_SIZE)
+				continue;
+
+			uint32 rawsize = readUint32LE(&pending[0]);
+			uint32 csize = readUint32LE(&pending[sizeof(uint32)]);
+
+			if (csize == 0)
+			{
+				if (rawsize != 0)
+					throw love::Exception("Invalid LZ4-compressed stream data.");
+
+				pending.clear();
+				return true;
+			}
+
+			if (rawsize > BLOCK_SIZE || csize > (uint32) LZ4_compressBound((int) BLOCK_SIZE))
+				throw love::Exception("Invalid LZ4-compressed stream data.");
+
+			if (pending.size() < HEADER_SIZE + csize)
+				continue;
+
+			decompressBlock(rawsize, csize, dst);
+			pending.clear();
+		}
+
+		return false;
+	}
+
+	void decompressBlock(uint32 rawsize, uint32 csize, std::vector<uint8> &dst)
+	{
+		size_t start = dst.size();
+		dst.resize(start + rawsize);
+
+		int result = LZ4_decompress_safe_usingDict((const char *) &pending[HEADER_SIZE], (char *) &dst[start],
+		                                           (int) csize, (int) rawsize, (const char *) dict.data(), (int) dictSize);
+
+		if (result != (int) rawsize)
+			throw love::Exception("Could not decompress LZ4-compressed data.");
+
+		// Keep the most recent 64 KB of output around for the next block.
+		const uint8 *out = &dst[start];
+		size_t keep = std::min(dictSize, BLOCK_SIZE - rawsize);
+
+		memmove(dict.data(), dict.data() + dictSize - keep, keep);
+		memcpy(dict.data() + keep, out, rawsize);
+		dictSize = keep + rawsize;
+	}
+
+	bool compressing;
+	bool highCompression;
+	int highCompressionLevel;
+
+	LZ4_stream_t *stream;
+	LZ4_streamHC_t *streamHC;
+
+	// Uncompressed input (compressing) or a partial block (decompressing).
+	std::vector<uint8> pending;
+
+	std::vector<uint8> dict;
+	size_t dictSize;
+
+}; // LZ4Codec
+
+class zlibCodec : public CompressionStream::Codec
+{
+public:
+
+	zlibCodec(Compressor::Format format, CompressionStream::Mode mode, int level)
+		: compressing(mode == CompressionStream::MODE_COMPRESS)
+		, stream()
+	{
+		int err = Z_OK;
+
+		if (compressing)
+		{
+			int windowbits = 15;
+			if (format == Compressor::FORMAT_GZIP)
+				windowbits += 16; // This tells zlib to use a gzip header.
+			else if (format == Compressor::FORMAT_DEFLATE)
+				windowbits = -windowbits;
+
+			if (level < 0)
+				level = Z_DEFAULT_COMPRESSION;
+			else if (level > 9)
+				level = 9;
+
+			err = deflateInit2(&stream, level, Z_DEFLATED, windowbits, 8, Z_DEFAULT_STRATEGY);
+		}
+		else
+		{
+			// 15 is the default. Adding 32 makes zlib auto-detect the header type.
+			int windowbits = format == Compressor::FORMAT_DEFLATE ? -15 : 15 + 32;
+			err = inflateInit2(&stream, windowbits);
+		}
+
+		if (err != Z_OK)
+			throw love::Exception("Could not initialize zlib stream.");
+	}
+
+	virtual ~zlibCodec()
+	{
+		if (compressing)
+			deflateEnd(&stream);
+		else
+			inflateEnd(&stream);
+	}
+
+	bool process(const uint8 *src, size_t size, CompressionStream::Flush flush, std::vector<uint8> &dst) override
+	{
+		int zflush = Z_NO_FLUSH;
+		if (flush == CompressionStream::FLUSH_SYNC)
+			zflush = Z_SYNC_FLUSH;
+		else if (flush == CompressionStream::FLUSH_FINISH)
+			zflush = Z_FINISH;
+
+		// zlib's sizes are 32 bit.
+		const size_t maxchunk = 1 << 30;
+
+		do
+		{
+			size_t count = std::min(size, maxchunk);
+			bool last = count == size;
+
+			if (processChunk(src, count, last ? zflush : Z_NO_FLUSH, dst))
+				return true;
+
+			src += count;
+			size -= count;
+		} while (size > 0);
+
+		return false;
+	}
+
+	void reset() override
+	{
+		if (compressing)
+			deflateReset(&stream);
+		else
+			inflateReset(&stream);
+	}
+
+private:
+
+	static const size_t CHUNK_SIZE = 16 * 1024;
+
+	bool processChunk(const uint8 *src, size_t size, int zflush, std::vector<uint8> &dst)
+	{
+		stream.next_in = (Bytef *) src;
+		stream.avail_in = (uInt) size;
+
+		// Keep going while zlib fills the whole output buffer, since it may
+		// have more output pending.
+		do
+		{
+			size_t start = dst.size();
+			dst.resize(start + CHUNK_SIZE);
+
+			stream.next_out = (Bytef *) &dst[start];
+			stream.avail_out = (uInt) CHUNK_SIZE;
+
+			int err = compressing ? deflate(&stream, zflush) : inflate(&stream, Z_NO_FLUSH);
+
+			dst.resize(start + CHUNK_SIZE - stream.avail_out);
+
+			if (err == Z_STREAM_END)
+				return true;
+			else if (err == Z_BUF_ERROR)
+				break; // No progress possible.
+			else if (err != Z_OK)
+			{
+				if (compressing)
+					throw love::Exception("Could not zlib/gzip-compress data.");
+				else
+					throw love::Exception("Could not decompress zlib/gzip-compressed data.");
+			}
+		} while (stream.avail_in > 0 || stream.avail_out == 0);
+
+		return false;
+	}
+
+	bool compressing;
+	z_stream stream;
+
+}; // zlibCodec
+
+#ifdef LOVE_ENABLE_ZSTD
+
+class zstdCodec : public CompressionStream::Codec
+{
+public:
+
+	zstdCodec(CompressionStream::Mode mode, int level, CompressionDictionary *dictionary)
+		: compressing(mode == CompressionStream::MODE_COMPRESS)
+		, cctx(nullptr)
+		, dctx(nullptr)
+	{
+		if (level < 0)
+			level = ZSTD_CLEVEL_DEFAULT;
+		else if (level > ZSTD_maxCLevel())
+			level = ZSTD_maxCLevel();
+
+		size_t err = 0;
+
+		if (compressing)
+		{
+			cctx = ZSTD_createCCtx();
+			if (cctx == nullptr)
+				throw love::Exception("Out of memory.");
+
+			if (dictionary != nullptr)
+				err = ZSTD_CCtx_refCDict(cctx, dictionary->getCompressionDict(level));
+			else
+				err = ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+		}
+		else
+		{
+			dctx = ZSTD_createDCtx();
+			if (dctx == nullptr)
+				throw love::Exception("Out of memory.");
+
+			if (dictionary != nullptr)
+				err = ZSTD_DCtx_refDDict(dctx, dictionary->getDecompressionDict());
+		}
+
+		if (ZSTD_isError(err))
+		{
+			ZSTD_freeCCtx(cctx);
+			ZSTD_freeDCtx(dctx);
+			throw love::Exception("Could not initialize zstd stream: %s", ZSTD_getErrorName(err));
+		}
+	}
+
+	virtual ~zstdCodec()
+	{
+		ZSTD_freeCCtx(cctx);
+		ZSTD_freeDCtx(dctx);
+	}
+
+	bool process(const uint8 *src, size_t size, CompressionStream::Flush flush, std::vector<uint8> &dst) override
+	{
+		ZSTD_inBuffer in = {src, size, 0};
+
+		if (compressing)
+			return compress(in, flush, dst);
+		else
+			return decompress(in, dst);
+	}
+
+	void reset() override
+	{
+		// Keeps the compression level and dictionary.
+		if (compressing)
+			ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+		else
+			ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+	}
+
+private:
+
+	static const size_t CHUNK_SIZE = 16 * 1024;
+
+	bool compress(ZSTD_inBuffer &in, CompressionStream::Flush flush, std::vector<uint8> &dst)
+	{
+		ZSTD_EndDirective directive = ZSTD_e_continue;
+		if (flush == CompressionStream::FLUSH_SYNC)
+			directive = ZSTD_e_flush;
+		else if (flush == CompressionStream::FLUSH_FINISH)
+			directive = ZSTD_e_end;
+
+		while (true)
+		{
+			size_t start = dst.size();
+			dst.resize(start + CHUNK_SIZE);
+
+			ZSTD_outBuffer out = {&dst[start], CHUNK_SIZE, 0};
+			size_t remaining = ZSTD_compressStream2(cctx, &out, &in, directive);
+
+			dst.resize(start + out.pos);
+
+			if (ZSTD_isError(remaining))
+				throw love::Exception("Could not zstd-compress data: %s", ZSTD_getErrorName(remaining));
+
+			if (directive == ZSTD_e_continue)
+			{
+				if (in.pos == in.size)
+					return false;
+			}
+			else if (remaining == 0)
+				return directive == ZSTD_e_end;
+		}
+	}
+
+	bool decompress(ZSTD_inBuffer &in, std::vector<uint8> &dst)
+	{
+		while (true)
+		{
+			size_t start = dst.size();
+			dst.resize(start + CHUNK_SIZE);
+
+			ZSTD_outBuffer out = {&dst[start], CHUNK_SIZE, 0};
+			size_t result = ZSTD_decompressStream(dctx, &out, &in);
+
+			dst.resize(start + out.pos);
+
+			if (ZSTD_isError(result))
+				throw love::Exception("Could not decompress zstd-compressed data: %s", ZSTD_getErrorName(result));
+
+			// The frame has been completely decoded and flushed.
+			if (result == 0)
+				return true;
+
+			// Keep going while zstd fills the whole output buffer, since it may
+			// have more output pending.
+			if (in.pos == in.size && out.pos < out.size)
+				return false;
+		}
+	}
+
+	bool compressing;
+
+	ZSTD_CCtx *cctx;
+	ZSTD_DCtx *dctx;
+
+}; // zstdCodec
+
+#endif // LOVE_ENABLE_ZSTD
+
+static CompressionStream::Codec *newCodec(Compressor::Format format, CompressionStream::Mode mode, int level, CompressionDictionary *dictionary)
+{
+	if (dictionary != nullptr && format != Compressor::FORMAT_ZSTD)
+		throw love::Exception("Compression dictionaries are only supported by the zstd format.");
+
+	switch (format)
+	{
+	case Compressor::FORMAT_LZ4:
+		return new LZ4Codec(mode, level);
+	case Compressor::FORMAT_ZLIB:
+	case Compressor::FORMAT_GZIP:
+	case Compressor::FORMAT_DEFLATE:
+		return new zlibCodec(format, mode, level);
+#ifdef LOVE_ENABLE_ZSTD
+	case Compressor::FORMAT_ZSTD:
+		return new zstdCodec(mode, level, dictionary);
+#endif
+	default:
+		throw love::Exception("Compression format is not supported by CompressionStream.");
+	}
+}
+
+love::Type CompressionStream::type("CompressionStream", &Stream::type);
+
+CompressionStream::CompressionStream(Compressor::Format format, Mode mode, int level, Stream *target, CompressionDictionary *dictionary)
+	: dictionary(dictionary)
+	, codec(newCodec(format, mode, level, dictionary))
+	, format(format)
+	, mode(mode)
+	, level(level)
+	, target(target)
+	, outputOffset(0)
+	, finished(false)
+	, position(0)
+{
+	if (target != nullptr)
+	{
+		if (mode == MODE_COMPRESS && !target->isWritable())
+			throw love::Exception("A compressing CompressionStream needs a writable Stream.");
+		if (mode == MODE_DECOMPRESS && !target->isReadable())
+			throw love::Exception("A decompressing CompressionStream needs a readable Stream.");
+	}
+}
+
+CompressionStream::~CompressionStream()
+{
+	if (isWritable() && !finished)
+	{
+		try
+		{
+			finish();
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
+}
+
+const std::vector<uint8> &CompressionStream::process(const void *src, size_t size, Flush flush)
+{
+	if (target.get() != nullptr)
+		throw love::Exception("CompressionStream:process cannot be used when wrapping another Stream.");
+
+	output.clear();
+
+	if (finished)
+	{
+		// Trailing data after the end of a compressed stream is ignored.
+		if (mode == MODE_COMPRESS && (size > 0 || flush != FLUSH_NONE))
+			throw love::Exception("The compressed stream has already been finished.");
+		return output;
+	}
+
+	finished = codec->process((const uint8 *) src, size, flush, output);
+	position += mode == MODE_COMPRESS ? (int64) size : (int64) output.size();
+
+	if (mode == MODE_DECOMPRESS && flush == FLUSH_FINISH && !finished)
+		throw love::Exception("Compressed data ended unexpectedly.");
+
+	return output;
+}
+
+void CompressionStream::writeOutput()
+{
+	if (!output.empty() && !target->write(output.data(), (int64) output.size()))
+		throw love::Exception("Could not write compressed data.");
+}
+
+void CompressionStream::finish()
+{
+	if (!isWritable())
+		throw love::Exception("Only compressing CompressionStreams which wrap another Stream can be finished.");
+
+	if (finished)
+		return;
+
+	output.clear();
+	finished = codec->process(nullptr, 0, FLUSH_FINISH, output);
+	writeOutput();
+	target->flush();
+}
+
+void CompressionStream::reset()
+{
+	codec->reset();
+	output.clear();
+	outputOffset = 0;
+	finished = false;
+	position = 0;
+}
+
+bool CompressionStream::isFinished() const
+{
+	return finished;
+}
+
+Compressor::Format CompressionStream::getFormat() const
+{
+	return format;
+}
+
+CompressionStream::Mode CompressionStream::getMode() const
+{
+	return mode;
+}
+
+int CompressionStream::getLevel() const
+{
+	return level;
+}
+
+Stream *CompressionStream::getTarget() const
+{
+	return target.get();
+}
+
+CompressionDictionary *CompressionStream::getDictionary() const
+{
+	return dictionary.get();
+}
+
+CompressionStream *CompressionStream::clone()
+{
+	StrongRef<Stream> t;
+	if (target.get() != nullptr)
+		t.set(target->clone(), Acquire::NORETAIN);
+
+	return new CompressionStream(format, mode, level, t.get(), dictionary.get());
+}
+
+bool CompressionStream::isReadable() const
+{
+	return mode == MODE_DECOMPRESS && target.get() != nullptr;
+}
+
+bool CompressionStream::isWritable() const
+{
+	return mode == MODE_COMPRESS && target.get() != nullptr;
+}
+
+bool CompressionStream::isSeekable() const
+{
+	return false;
+}
+
+int64 CompressionStream::read(void *dst, int64 size)
+{
+	if (!isReadable())
+		throw love::Exception("CompressionStream is not readable.");
+
+	const int64 READ_SIZE = 64 * 1024;
+
+	uint8 *out = (uint8 *) dst;
+	int64 total = 0;
+
+	while (total < size)
+	{
+		if (outputOffset < output.size())
+		{
+			size_t count = (size_t) std::min((int64) (output.size() - outputOffset), size - total);
+			memcpy(out + total, output.data() + outputOffset, count);
+			outputOffset += count;
+			total += (int64) count;
+			continue;
+		}
+
+		if (finished)
+			break;
+
+		input.resize((size_t) READ_SIZE);
+		int64 count = target->read(input.data(), READ_SIZE);
+
+		// An unterminated stream (e.g. one which is still being written) just
+		// ends at the last complete block.
+		if (count <= 0)
+			break;
+
+		output.clear();
+		outputOffset = 0;
+		finished = codec->process(input.data(), (size_t) count, FLUSH_NONE, output);
+	}
+
+	position += total;
+	return total;
+}
+
+bool CompressionStream::write(const void *src, int64 size)
+{
+	if (!isWritable())
+		throw love::Exception("CompressionStream is not writable.");
+
+	if (finished)
+		throw love::Exception("The compressed stream has already been finished.");
+
+	output.clear();
+	codec->process((const uint8 *) src, (size_t) size, FLUSH_NONE, output);
+	position += size;
+
+	writeOutput();
+	return true;
+}
+
+bool CompressionStream::flush()
+{
+	if (isWritable() && !finished)
+	{
+		output.clear();
+		codec->process(nullptr, 0, FLUSH_SYNC, output);
+		writeOutput();
+	}
+
+	return target.get() != nullptr ? target->flush() : true;
+}
+
+int64 CompressionStream::getSize()
+{
+	return -1;
+}
+
+bool CompressionStream::seek(int64 /*pos*/, SeekOrigin /*origin*/)
+{
+	return false;
+}
+
+int64 CompressionStream::tell()
+{
+	return position;
+}
+
+bool CompressionStream::getConstant(const char *in, Mode &out)
+{
+	return modeNames.find(in, out);
+}
+
+bool CompressionStream::getConstant(Mode in, const char *&out)
+{
+	return modeNames.find(in, out);
+}
+
+std::vector<std::string> CompressionStream::getConstants(Mode)
+{
+	return modeNames.getNames();
+}
+
+bool CompressionStream::getConstant(const char *in, Flush &out)
+{
+	return flushNames.find(in, out);
+}
+
+bool CompressionStream::getConstant(Flush in, const char *&out)
+{
+	return flushNames.find(in, out);
+}
+
+std::vector<std::string> CompressionStream::getConstants(Flush)
+{
+	return flushNames.getNames();
+}
+
+StringMap<CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM>::Entry CompressionStream::modeEntries[] =
+{
+	{ "compress",   MODE_COMPRESS   },
+	{ "decompress", MODE_DECOMPRESS },
+};
+
+StringMap<CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM> CompressionStream::modeNames(CompressionStream::modeEntries, sizeof(CompressionStream::modeEntries));
+
+StringMap<CompressionStream::Flush, CompressionStream::FLUSH_MAX_ENUM>::Entry CompressionStream::flushEntries[] =
+{
+	{ "none",   FLUSH_NONE   },
+	{ "sync",   FLUSH_SYNC   },
+	{ "finish", FLUSH_FINISH },
+};
+
+StringMap<CompressionStream::Flush, CompressionStream::FLUSH_MAX_ENUM> CompressionStream::flushNames(CompressionStream::flushEntries, sizeof(CompressionStream::flushEntries));
+
+} // data
+} // love
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Stream.h"
+#include "common/StringMap.h"
+#include "common/int.h"
+#include "Compressor.h"
+#include "CompressionDictionary.h"
+
+// C++
+#include <vector>
+#include <memory>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Incrementally compresses or decompresses data in chunks, keeping the
+ * compression state (and its allocations) alive between calls.
+ *
+ * A CompressionStream either produces output directly via process(), or wraps
+ * another Stream (e.g. a File): compressing streams compress everything
+ * written to them into the target, and decompressing streams decompress data
+ * read from the target.
+ *
+ * LZ4 streams use a simple block framing of their own, and are not compatible
+ * with data from Compressor's whole-buffer LZ4 format.
+ **/
+class CompressionStream : public love::Stream
+{
+public:
+
+	enum Mode
+	{
+		MODE_COMPRESS,
+		MODE_DECOMPRESS,
+		MODE_MAX_ENUM
+	};
+
+	enum Flush
+	{
+		// Buffer data internally for the best compression ratio.
+		FLUSH_NONE,
+		// Output everything processed so far, so the receiving end can
+		// decompress it without waiting for more data.
+		FLUSH_SYNC,
+		// End the compressed stream.
+		FLUSH_FINISH,
+		FLUSH_MAX_ENUM
+	};
+
+	class Codec
+	{
+	public:
+		virtual ~Codec() {}
+
+		/**
+		 * Processes input data and appends the result to dst. Returns true
+		 * once the end of the compressed stream has been reached.
+		 **/
+		virtual bool process(const uint8 *src, size_t size, Flush flush, std::vector<uint8> &dst) = 0;
+		virtual void reset() = 0;
+	};
+
+	static love::Type type;
+
+	CompressionStream(Compressor::Format format, Mode mode, int level = -1, Stream *target = nullptr, CompressionDictionary *dictionary = nullptr);
+	virtual ~CompressionStream();
+
+	/**
+	 * Processes a chunk of input data. The returned output is only valid until
+	 * the next call. Can't be used when the CompressionStream wraps a Stream.
+	 **/
+	const std::vector<uint8> &process(const void *src, size_t size, Flush flush = FLUSH_NONE);
+
+	/**
+	 * Ends the compressed stream and writes the remaining output to the target
+	 * Stream.
+	 **/
+	void finish();
+
+	/**
+	 * Starts a new compressed stream, reusing the existing internal state.
+	 **/
+	void reset();
+
+	bool isFinished() const;
+
+	Compressor::Format getFormat() const;
+	Mode getMode() const;
+	int getLevel() const;
+	Stream *getTarget() const;
+	CompressionDictionary *getDictionary() const;
+
+	// Implements Stream.
+	CompressionStream *clone() override;
+	bool isReadable() const override;
+	bool isWritable() const override;
+	bool isSeekable() const override;
+	int64 read(void *dst, int64 size) override;
+	bool write(const void *src, int64 size) override;
+	bool flush() override;
+	int64 getSize() override;
+	bool seek(int64 pos, SeekOrigin origin = SEEKORIGIN_BEGIN) override;
+	int64 tell() override;
+
+	static bool getConstant(const char *in, Mode &out);
+	static bool getConstant(Mode in, const char *&out);
+	static std::vector<std::string> getConstants(Mode);
+
+	static bool getConstant(const char *in, Flush &out);
+	static bool getConstant(Flush in, const char *&out);
+	static std::vector<std::string> getConstants(Flush);
+
+private:
+
+	void writeOutput();
+
+	// Must outlive the codec, which may reference its digested forms.
+	StrongRef<CompressionDictionary> dictionary;
+
+	std::unique_ptr<Codec> codec;
+
+	Compressor::Format format;
+	Mode mode;
+	int level;
+
+	StrongRef<Stream> target;
+
+	std::vector<uint8> input;
+	std::vector<uint8> output;
+	size_t outputOffset;
+
+	bool finished;
+	int64 position;
+
+	static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
+	static StringMap<Mode, MODE_MAX_ENUM> modeNames;
+
+	static StringMap<Flush, FLUSH_MAX_ENUM>::Entry flushEntries[];
+	static StringMap<Flush, FLUSH_MAX_ENUM> flushNames;
+
+}; // CompressionStream
+
+} // data
+} // love
@@ -28,6 +28,15 @@
 
 #include <zlib.h>
 
+#ifdef LOVE_ENABLE_ZSTD
+#include "CompressionDictionary.h"
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace data
@@ -37,7 +46,7 @@ class LZ4Compressor : public Compressor
 {
 public:
 
-	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
+	char *compress(Format format, const char *data, size_t dataSize, int level, CompressionDictionary * /*dictionary*/, size_t &compressedSize) override
 	{
 		if (format != FORMAT_LZ4)
 			throw love::Exception("Invalid format (expecting LZ4)");
@@ -100,7 +109,7 @@ public:
 		return compressedbytes;
 	}
 
-	char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) override
+	char *decompress(Format format, const char *data, size_t dataSize, CompressionDictionary * /*dictionary*/, size_t &decompressedSize) override
 	{
 		if (format != FORMAT_LZ4)
 			throw love::Exception("Invalid format (expecting LZ4)");
@@ -119,6 +128,12 @@ public:
 		uint32 rawsize = *(uint32 *) data;
 #endif
 
+		// The header can't be trusted (e.g. love.data.deserialize input), so
+		// check it against the most the data could decompress to before
+		// allocating.
+		if (rawsize > getMaxDecompressedSize(format, dataSize - headersize))
+			throw love::Exception("Could not decompress LZ4-compressed data: invalid size header.");
+
 		try
 		{
 			rawbytes = new char[rawsize];
@@ -257,7 +272,7 @@ private:
 
 public:
 
-	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
+	char *compress(Format format, const char *data, size_t dataSize, int level, CompressionDictionary * /*dictionary*/, size_t &compressedSize) override
 	{
 		if (!isSupported(format))
 			throw love::Exception("Invalid format (expecting zlib or gzip)");
@@ -306,7 +321,7 @@ public:
 		return compressedbytes;
 	}
 
-	char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) override
+	char *decompress(Format format, const char *data, size_t dataSize, CompressionDictionary * /*dictionary*/, size_t &decompressedSize) override
 	{
 		if (!isSupported(format))
 			throw love::Exception("Invalid format (expecting zlib or gzip)");
@@ -358,12 +373,167 @@ public:
 
 }; // zlibCompressor
 
+#ifdef LOVE_ENABLE_ZSTD
+
+class zstdCompressor : public Compressor
+{
+private:
+
+	// Creating zstd contexts is relatively expensive, so each thread keeps its
+	// own around between calls.
+	struct Contexts
+	{
+		ZSTD_CCtx *cctx = nullptr;
+		ZSTD_DCtx *dctx = nullptr;
+
+		~Contexts()
+		{
+			ZSTD_freeCCtx(cctx);
+			ZSTD_freeDCtx(dctx);
+		}
+	};
+
+	static thread_local Contexts contexts;
+
+public:
+
+	char *compress(Format format, const char *data, size_t dataSize, int level, CompressionDictionary *dictionary, size_t &compressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting zstd)");
+
+		if (level < 0)
+			level = ZSTD_CLEVEL_DEFAULT;
+		else if (level > ZSTD_maxCLevel())
+			level = ZSTD_maxCLevel();
+
+		if (contexts.cctx == nullptr)
+			contexts.cctx = ZSTD_createCCtx();
+		if (contexts.cctx == nullptr)
+			throw love::Exception("Out of memory.");
+
+		size_t maxsize = ZSTD_compressBound(dataSize);
+		char *compressedbytes = nullptr;
+
+		try
+		{
+			compressedbytes = new char[maxsize];
+		}
+		catch (std::bad_alloc &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		size_t csize = 0;
+		if (dictionary != nullptr)
+			csize = ZSTD_compress_usingCDict(contexts.cctx, compressedbytes, maxsize, data, dataSize, dictionary->getCompressionDict(level));
+		else
+			csize = ZSTD_compressCCtx(contexts.cctx, compressedbytes, maxsize, data, dataSize, level);
+
+		if (ZSTD_isError(csize))
+		{
+			delete[] compressedbytes;
+			throw love::Exception("Could not zstd-compress data: %s", ZSTD_getErrorName(csize));
+		}
+
+		// We allocated space for the maximum possible amount of data, but the
+		// actual compressed size might be much smaller, so we should shrink the
+		// data buffer if so.
+		if ((double) maxsize / (double) csize >= 1.2)
+		{
+			char *cbytes = new (std::nothrow) char[csize];
+			if (cbytes)
+			{
+				memcpy(cbytes, compressedbytes, csize);
+				delete[] compressedbytes;
+				compressedbytes = cbytes;
+			}
+		}
+
+		compressedSize = csize;
+		return compressedbytes;
+	}
+
+	char *decompress(Format format, const char *data, size_t dataSize, CompressionDictionary *dictionary, size_t &decompressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting zstd)");
+
+		if (contexts.dctx == nullptr)
+			contexts.dctx = ZSTD_createDCtx();
+		if (contexts.dctx == nullptr)
+			throw love::Exception("Out of memory.");
+
+		// zstd frames normally store their decompressed size.
+		unsigned long long framesize = ZSTD_getFrameContentSize(data, dataSize);
+		if (framesize == ZSTD_CONTENTSIZE_ERROR)
+			throw love::Exception("Could not decompress zstd-compressed data: invalid data.");
+
+		size_t rawsize = 0;
+		if (framesize != ZSTD_CONTENTSIZE_UNKNOWN)
+			rawsize = (size_t) framesize;
+		else
+			rawsize = decompressedSize > 0 ? decompressedSize : dataSize * 2;
+
+		// Repeatedly try to decompress with an increasingly large output buffer,
+		// if the size isn't known up front.
+		while (true)
+		{
+			char *rawbytes = nullptr;
+
+			try
+			{
+				rawbytes = new char[std::max(rawsize, (size_t) 1)];
+			}
+			catch (std::bad_alloc &)
+			{
+				throw love::Exception("Out of memory.");
+			}
+
+			size_t result = 0;
+			if (dictionary != nullptr)
+				result = ZSTD_decompress_usingDDict(contexts.dctx, rawbytes, rawsize, data, dataSize, dictionary->getDecompressionDict());
+			else
+				result = ZSTD_decompressDCtx(contexts.dctx, rawbytes, rawsize, data, dataSize);
+
+			if (!ZSTD_isError(result))
+			{
+				decompressedSize = result;
+				return rawbytes;
+			}
+
+			delete[] rawbytes;
+
+			if (ZSTD_getErrorCode(result) != ZSTD_error_dstSize_tooSmall || framesize != ZSTD_CONTENTSIZE_UNKNOWN)
+				throw love::Exception("Could not decompress zstd-compressed data: %s", ZSTD_getErrorName(result));
+
+			// Not enough room in the output buffer: try again with a larger size.
+			rawsize *= 2;
+		}
+	}
+
+	bool isSupported(Format format) const override
+	{
+		return format == FORMAT_ZSTD;
+	}
+
+}; // zstdCompressor
+
+thread_local zstdCompressor::Contexts zstdCompressor::contexts;
+
+#endif // LOVE_ENABLE_ZSTD
+
 Compressor *Compressor::getCompressor(Format format)
 {
 	static LZ4Compressor lz4compressor;
 	static zlibCompressor zlibcompressor;
 
+#ifdef LOVE_ENABLE_ZSTD
+	static zstdCompressor zstdcompressor;
+	Compressor *compressors[] = {&lz4compressor, &zlibcompressor, &zstdcompressor};
+#else
 	Compressor *compressors[] = {&lz4compressor, &zlibcompressor};
+#endif
 
 	for (Compressor *c : compressors)
 	{
@@ -374,6 +544,31 @@ Compressor *Compressor::getCompressor(Format format)
 	return nullptr;
 }
 
+uint64 Compressor::getMaxDecompressedSize(Format format, size_t compressedSize)
+{
+	uint64 ratio = 0;
+
+	switch (format)
+	{
+	case FORMAT_LZ4:
+		// Each extra length byte adds at most 255 bytes of output.
+		ratio = 255;
+		break;
+	case FORMAT_ZLIB:
+	case FORMAT_GZIP:
+	case FORMAT_DEFLATE:
+		ratio = 1032;
+		break;
+	case FORMAT_ZSTD:
+	default:
+		// An RLE block of up to 128 KB takes 4 bytes.
+		ratio = 32768;
+		break;
+	}
+
+	return (uint64) compressedSize * ratio + 64;
+}
+
 bool Compressor::getConstant(const char *in, Format &out)
 {
 	return formatNames.find(in, out);
@@ -395,6 +590,7 @@ StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM>::Entry Compressor::fo
 	{ "zlib",    FORMAT_ZLIB    },
 	{ "gzip",    FORMAT_GZIP    },
 	{ "deflate", FORMAT_DEFLATE },
+	{ "zstd",    FORMAT_ZSTD    },
 };
 
 StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM> Compressor::formatNames(Compressor::formatEntries, sizeof(Compressor::formatEntries));
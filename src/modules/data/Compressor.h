@@ -22,12 +22,15 @@
 
 // LOVE
 #include "common/StringMap.h"
+#include "common/int.h"
 
 namespace love
 {
 namespace data
 {
 
+class CompressionDictionary;
+
 /**
  * Base class for backends for different compression formats.
  **/
@@ -41,6 +44,7 @@ public:
 		FORMAT_ZLIB,
 		FORMAT_GZIP,
 		FORMAT_DEFLATE,
+		FORMAT_ZSTD,
 		FORMAT_MAX_ENUM
 	};
 
@@ -50,6 +54,13 @@ public:
 	 **/
 	static Compressor *getCompressor(Format format);
 
+	/**
+	 * Gets the largest size valid data of the given compressed size can
+	 * decompress to, based on the format's maximum compression ratio. Used to
+	 * reject size headers in untrusted data before allocating from them.
+	 **/
+	static uint64 getMaxDecompressedSize(Format format, size_t compressedSize);
+
 	virtual ~Compressor() {}
 
 	/**
@@ -58,14 +69,17 @@ public:
 	 * @param[in] format The format to compress to.
 	 * @param[in] data The input (uncompressed) data.
 	 * @param[in] dataSize The size in bytes of the input data.
-	 * @param[in] level The amount of compression to apply (between 0 and 9.)
-	 *            A value of -1 indicates the default amount of compression.
-	 *            Specific formats may not use every level.
+	 * @param[in] level The amount of compression to apply (between 0 and 9,
+	 *            or up to 22 for zstd.) A value of -1 indicates the default
+	 *            amount of compression. Specific formats may not use every
+	 *            level.
+	 * @param[in] dictionary An optional dictionary to compress with. Only
+	 *            used by zstd.
 	 * @param[out] compressedSize The size in bytes of the compressed result.
 	 *
 	 * @return The newly compressed data (allocated with new[]).
 	 **/
-	virtual char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) = 0;
+	virtual char *compress(Format format, const char *data, size_t dataSize, int level, CompressionDictionary *dictionary, size_t &compressedSize) = 0;
 
 	/**
 	 * Decompresses compressed data, and returns the decompressed result.
@@ -73,13 +87,15 @@ public:
 	 * @param[in] format The format the compressed data is in.
 	 * @param[in] data The input (compressed) data.
 	 * @param[in] dataSize The size in bytes of the compressed data.
+	 * @param[in] dictionary The dictionary the data was compressed with, if
+	 *            any. Only used by zstd.
 	 * @param[in,out] decompressedSize On input, the size in bytes of the
 	 *               original uncompressed data, or 0 if unknown. On return, the
 	 *               size in bytes of the decompressed data.
 	 *
 	 * @return The decompressed data (allocated with new[]).
 	 **/
-	virtual char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) = 0;
+	virtual char *decompress(Format format, const char *data, size_t dataSize, CompressionDictionary *dictionary, size_t &decompressedSize) = 0;
 
 	/**
 	 * Gets whether a specific format is supported by this backend.
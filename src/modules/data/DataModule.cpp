@@ -21,19 +21,22 @@
 // LOVE
 #include "DataModule.h"
 #include "common/b64.h"
+#include "common/hex.h"
 #include "common/int.h"
 #include "common/StringMap.h"
+#include "thread/JobSystem.h"
 
 // STL
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <list>
 #include <iostream>
 
 namespace
 {
 
-static const char hexchars[] = "0123456789abcdef";
-
 char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 {
 	dstlen = srclen * 2;
@@ -51,31 +54,12 @@ char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < srclen; i++)
-	{
-		love::uint8 b = src[i];
-		dst[i * 2 + 0] = hexchars[b >> 4];
-		dst[i * 2 + 1] = hexchars[b & 0xF];
-	}
+	love::hex_encode(src, srclen, dst);
 
 	dst[dstlen] = '\0';
 	return dst;
 }
 
-love::uint8 nibble(char c)
-{
-	if (c >= '0' && c <= '9')
-		return (love::uint8) (c - '0');
-
-	if (c >= 'A' && c <= 'F')
-		return (love::uint8) (c - 'A' + 0x0a);
-
-	if (c >= 'a' && c <= 'f')
-		return (love::uint8) (c - 'a' + 0x0a);
-
-	return 0;
-}
-
 love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
 {
 	if (srclen >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X'))
@@ -99,13 +83,10 @@ love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < dstlen; i++)
-	{
-		dst[i] = nibble(src[i * 2]) << 4;
+	love::hex_decode(src, srclen & ~(size_t) 1, dst);
 
-		if (i * 2 + 1 < srclen)
-			dst[i] |= nibble(src[i * 2 + 1]);
-	}
+	if (srclen & 1)
+		dst[dstlen - 1] = love::hex_nibble(src[srclen - 1]) << 4;
 
 	return dst;
 }
@@ -117,15 +98,263 @@ namespace love
 namespace data
 {
 
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level)
+static Compressor *getCompressor(Compressor::Format format, CompressionDictionary *dictionary)
 {
 	Compressor *compressor = Compressor::getCompressor(format);
 
 	if (compressor == nullptr)
+	{
+		if (format == Compressor::FORMAT_ZSTD)
+			throw love::Exception("The zstd compression format is not supported in this build.");
 		throw love::Exception("Invalid compression format.");
+	}
+
+	if (dictionary != nullptr && format != Compressor::FORMAT_ZSTD)
+		throw love::Exception("Compression dictionaries are only supported by the zstd format.");
+
+	return compressor;
+}
+
+/**
+ * Calls func on the current thread and in enough jobs to cover the given
+ * number of independent tasks, up to the number of CPU cores. func is
+ * expected to take tasks from a shared counter until none are left, so a few
+ * large tasks don't hold up the rest.
+ **/
+static void runWorkers(size_t tasks, const std::function<void()> &func)
+{
+	const int maxThreads = 8;
+
+	love::thread::JobSystem *jobsystem = love::thread::JobSystem::getInstance();
+
+	int threadcount = std::min(jobsystem->getWorkerCount() + 1, maxThreads);
+	threadcount = (int) std::min<size_t>(threadcount, tasks);
+
+	jobsystem->parallelFor((size_t) threadcount, 1, [&](size_t, size_t) { func(); });
+}
+
+/**
+ * Data compressed in independent blocks (so each block can be compressed and
+ * decompressed on a different thread) is stored in a small frame:
+ *
+ * - 4 byte magic number. The first byte isn't valid at the start of a zlib or
+ *   raw deflate stream, and the last byte makes the value too large to be the
+ *   size header of LOVE's lz4 format, so frames can't be mistaken for data
+ *   compressed as a single block.
+ * - 32 bit block count and 64 bit total uncompressed size.
+ * - The uncompressed and compressed size of each block, 32 bits each.
+ * - The compressed blocks, back to back, each in the regular format.
+ *
+ * All values are little-endian.
+ **/
+static const uint8 blockFrameMagic[4] = {0x4E, 0x4C, 0x42, 0xF1};
+static const size_t blockFrameHeaderSize = 16;
+static const size_t blockFrameEntrySize = 8;
+
+static void storele32(char *p, uint32 x)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = (char) ((x >> (i * 8)) & 0xFF);
+}
+
+static uint32 loadle32(const char *p)
+{
+	uint32 x = 0;
+	for (int i = 0; i < 4; i++)
+		x |= (uint32) (uint8) p[i] << (i * 8);
+	return x;
+}
+
+static bool isBlockFrame(const char *cbytes, size_t compressedsize)
+{
+	return compressedsize >= blockFrameHeaderSize && memcmp(cbytes, blockFrameMagic, 4) == 0;
+}
+
+static char *compressBlocks(Compressor *compressor, Compressor::Format format, const char *rawbytes, size_t rawsize, int level, CompressionDictionary *dictionary, size_t blocksize, size_t &compressedsize)
+{
+	if (blocksize < 4096 || blocksize > 0x40000000)
+		throw love::Exception("Invalid compression block size (must be between 4 KB and 1 GB.)");
+
+	size_t count = (rawsize + blocksize - 1) / blocksize;
+	if (count > 0xFFFFFFFF)
+		throw love::Exception("Too many compression blocks.");
+
+	std::vector<char *> blocks(count, nullptr);
+	std::vector<size_t> sizes(count, 0);
+	std::vector<std::string> errors(count);
+	std::atomic<size_t> next(0);
+
+	auto compressblocks = [&]()
+	{
+		for (size_t i = next++; i < count; i = next++)
+		{
+			size_t offset = i * blocksize;
+			size_t size = std::min(blocksize, rawsize - offset);
+
+			try
+			{
+				blocks[i] = compressor->compress(format, rawbytes + offset, size, level, dictionary, sizes[i]);
+				if (sizes[i] > 0xFFFFFFFF)
+					throw love::Exception("Compressed block is too large.");
+			}
+			catch (love::Exception &e)
+			{
+				errors[i] = e.what();
+			}
+		}
+	};
+
+	runWorkers(count, compressblocks);
+
+	auto freeblocks = [&]()
+	{
+		for (char *block : blocks)
+			delete[] block;
+	};
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!errors[i].empty())
+		{
+			freeblocks();
+			throw love::Exception("%s", errors[i].c_str());
+		}
+	}
+
+	compressedsize = blockFrameHeaderSize + count * blockFrameEntrySize;
+	for (size_t size : sizes)
+		compressedsize += size;
+
+	char *cbytes = nullptr;
+	try
+	{
+		cbytes = new char[compressedsize];
+	}
+	catch (std::bad_alloc &)
+	{
+		freeblocks();
+		throw love::Exception("Out of memory.");
+	}
+
+	memcpy(cbytes, blockFrameMagic, 4);
+	storele32(cbytes + 4, (uint32) count);
+	storele32(cbytes + 8, (uint32) ((uint64) rawsize & 0xFFFFFFFF));
+	storele32(cbytes + 12, (uint32) ((uint64) rawsize >> 32));
+
+	char *entry = cbytes + blockFrameHeaderSize;
+	char *dst = entry + count * blockFrameEntrySize;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		storele32(entry, (uint32) std::min(blocksize, rawsize - i * blocksize));
+		storele32(entry + 4, (uint32) sizes[i]);
+		entry += blockFrameEntrySize;
+
+		memcpy(dst, blocks[i], sizes[i]);
+		dst += sizes[i];
+	}
+
+	freeblocks();
+	return cbytes;
+}
+
+static char *decompressBlocks(Compressor *compressor, Compressor::Format format, const char *cbytes, size_t compressedsize, CompressionDictionary *dictionary, size_t &rawsize)
+{
+	size_t count = loadle32(cbytes + 4);
+	uint64 framerawsize = (uint64) loadle32(cbytes + 8) | ((uint64) loadle32(cbytes + 12) << 32);
+
+	if (count > (compressedsize - blockFrameHeaderSize) / blockFrameEntrySize || framerawsize > (uint64) SIZE_MAX)
+		throw love::Exception("Could not decompress data: invalid block header.");
+
+	std::vector<size_t> rawoffsets(count), coffsets(count);
+	std::vector<uint32> rawsizes(count), csizes(count);
+
+	const char *entry = cbytes + blockFrameHeaderSize;
+	uint64 rawoffset = 0;
+	uint64 coffset = blockFrameHeaderSize + count * blockFrameEntrySize;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		rawsizes[i] = loadle32(entry);
+		csizes[i] = loadle32(entry + 4);
+		entry += blockFrameEntrySize;
+
+		// The output is allocated from the header, so every block has to be
+		// able to decompress to its stated size.
+		if (rawsizes[i] > Compressor::getMaxDecompressedSize(format, csizes[i]))
+			throw love::Exception("Could not decompress data: invalid block header.");
+
+		rawoffsets[i] = (size_t) rawoffset;
+		coffsets[i] = (size_t) coffset;
+		rawoffset += rawsizes[i];
+		coffset += csizes[i];
+	}
+
+	if (rawoffset != framerawsize || coffset > compressedsize)
+		throw love::Exception("Could not decompress data: invalid block header.");
+
+	char *rawbytes = nullptr;
+	try
+	{
+		rawbytes = new char[std::max((size_t) framerawsize, (size_t) 1)];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	std::vector<std::string> errors(count);
+	std::atomic<size_t> next(0);
+
+	auto decompressblocks = [&]()
+	{
+		for (size_t i = next++; i < count; i = next++)
+		{
+			char *block = nullptr;
+			size_t size = rawsizes[i];
+
+			try
+			{
+				block = compressor->decompress(format, cbytes + coffsets[i], csizes[i], dictionary, size);
+				if (size != rawsizes[i])
+					throw love::Exception("Could not decompress data: block size does not match its header.");
+				memcpy(rawbytes + rawoffsets[i], block, size);
+			}
+			catch (love::Exception &e)
+			{
+				errors[i] = e.what();
+			}
+
+			delete[] block;
+		}
+	};
+
+	runWorkers(count, decompressblocks);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!errors[i].empty())
+		{
+			delete[] rawbytes;
+			throw love::Exception("%s", errors[i].c_str());
+		}
+	}
+
+	rawsize = (size_t) framerawsize;
+	return rawbytes;
+}
+
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level, CompressionDictionary *dictionary, size_t blocksize)
+{
+	Compressor *compressor = getCompressor(format, dictionary);
 
 	size_t compressedsize = 0;
-	char *cbytes = compressor->compress(format, rawbytes, rawsize, level, compressedsize);
+	char *cbytes = nullptr;
+
+	if (blocksize > 0 && rawsize > blocksize)
+		cbytes = compressBlocks(compressor, format, rawbytes, rawsize, level, dictionary, blocksize, compressedsize);
+	else
+		cbytes = compressor->compress(format, rawbytes, rawsize, level, dictionary, compressedsize);
 
 	CompressedData *data = nullptr;
 
@@ -142,25 +371,25 @@ CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t
 	return data;
 }
 
-char *decompress(CompressedData *data, size_t &decompressedsize)
+char *decompress(CompressedData *data, size_t &decompressedsize, CompressionDictionary *dictionary)
 {
 	size_t rawsize = data->getDecompressedSize();
 
 	char *rawbytes = decompress(data->getFormat(), (const char *) data->getData(),
-	                            data->getSize(), rawsize);
+	                            data->getSize(), rawsize, dictionary);
 
 	decompressedsize = rawsize;
 	return rawbytes;
 }
 
-char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize)
+char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize, CompressionDictionary *dictionary)
 {
-	Compressor *compressor = Compressor::getCompressor(format);
+	Compressor *compressor = getCompressor(format, dictionary);
 
-	if (compressor == nullptr)
-		throw love::Exception("Invalid compression format.");
+	if (isBlockFrame(cbytes, compressedsize))
+		return decompressBlocks(compressor, format, cbytes, compressedsize, dictionary, rawsize);
 
-	return compressor->decompress(format, cbytes, compressedsize, rawsize);
+	return compressor->decompress(format, cbytes, compressedsize, dictionary, rawsize);
 }
 
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen)
@@ -213,6 +442,34 @@ void hash(HashFunction::Function function, const char *input, uint64_t size, Has
 	hashfunction->hash(function, input, size, output);
 }
 
+void hashMultiple(HashFunction::Function function, const std::vector<std::pair<const char *, uint64>> &inputs, std::vector<HashFunction::Value> &outputs)
+{
+	// Starting a thread costs more than hashing a small input, so only use as
+	// many threads as there are large chunks of data to hash.
+	const uint64 minBytesPerThread = 1024 * 1024;
+
+	HashFunction *hashfunction = HashFunction::getHashFunction(function);
+	if (hashfunction == nullptr)
+		throw love::Exception("Invalid hash function.");
+
+	outputs.resize(inputs.size());
+
+	uint64 totalsize = 0;
+	for (const auto &input : inputs)
+		totalsize += input.second;
+
+	std::atomic<size_t> next(0);
+
+	auto hashinputs = [&]()
+	{
+		for (size_t i = next++; i < inputs.size(); i = next++)
+			hashfunction->hash(function, inputs[i].first, inputs[i].second, outputs[i]);
+	};
+
+	size_t tasks = (size_t) std::min<uint64>(inputs.size(), totalsize / minBytesPerThread);
+	runWorkers(tasks, hashinputs);
+}
+
 DataModule::DataModule()
 {
 }
@@ -241,6 +498,21 @@ ByteData *DataModule::newByteData(void *d, size_t size, bool own)
 	return new ByteData(d, size, own);
 }
 
+Hasher *DataModule::newHasher(HashFunction::Function function)
+{
+	return new Hasher(function);
+}
+
+Encoder *DataModule::newEncoder(EncodeFormat format, Encoder::Mode mode, size_t lineLength)
+{
+	return new Encoder(format, mode, lineLength);
+}
+
+CompressionStream *DataModule::newCompressionStream(Compressor::Format format, CompressionStream::Mode mode, int level, Stream *target, CompressionDictionary *dictionary)
+{
+	return new CompressionStream(format, mode, level, target, dictionary);
+}
+
 static StringMap<EncodeFormat, ENCODE_MAX_ENUM>::Entry encoderEntries[] =
 {
 	{ "base64", ENCODE_BASE64 },
@@ -23,8 +23,12 @@
 #include "CompressedData.h"
 #include "Compressor.h"
 #include "HashFunction.h"
+#include "Hasher.h"
+#include "Encoder.h"
 #include "DataView.h"
 #include "ByteData.h"
+#include "CompressionDictionary.h"
+#include "CompressionStream.h"
 
 // LOVE
 #include "common/Module.h"
@@ -35,13 +39,6 @@ namespace love
 namespace data
 {
 
-enum EncodeFormat
-{
-	ENCODE_BASE64,
-	ENCODE_HEX,
-	ENCODE_MAX_ENUM
-};
-
 enum ContainerType
 {
 	CONTAINER_DATA,
@@ -55,21 +52,26 @@ enum ContainerType
  * @param format The compression format to use.
  * @param rawbytes The data to compress.
  * @param rawsize The size in bytes of the data to compress.
- * @param level The amount of compression to apply (between 0 and 9.)
- *              A value of -1 indicates the default amount of compression.
- *              Specific formats may not use every level.
+ * @param level The amount of compression to apply (between 0 and 9, or up
+ *              to 22 for zstd.) A value of -1 indicates the default amount
+ *              of compression. Specific formats may not use every level.
+ * @param dictionary An optional zstd dictionary to compress with.
+ * @param blocksize If non-zero, data larger than this is split into blocks of
+ *                  this size which are compressed independently on multiple
+ *                  threads, and can be decompressed the same way.
  * @return The newly compressed data.
  **/
-CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1);
+CompressedData *compress(Compressor::Format format, const char *rawbytes, size_t rawsize, int level = -1, CompressionDictionary *dictionary = nullptr, size_t blocksize = 0);
 
 /**
  * Decompresses existing compressed data into raw bytes.
  *
  * @param[in] data The compressed data to decompress.
  * @param[out] decompressedsize The size in bytes of the decompressed data.
+ * @param[in] dictionary The zstd dictionary the data was compressed with, if any.
  * @return The newly decompressed data (allocated with new[]).
  **/
-char *decompress(CompressedData *data, size_t &decompressedsize);
+char *decompress(CompressedData *data, size_t &decompressedsize, CompressionDictionary *dictionary = nullptr);
 
 /**
  * Decompresses existing compressed data into raw bytes.
@@ -80,9 +82,10 @@ char *decompress(CompressedData *data, size_t &decompressedsize);
  * @param[in,out] rawsize On input, the size in bytes of the original
  *               uncompressed data, or 0 if unknown. On return, the size in
  *               bytes of the newly decompressed data.
+ * @param[in] dictionary The zstd dictionary the data was compressed with, if any.
  * @return The newly decompressed data (allocated with new[]).
  **/
-char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize);
+char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize, CompressionDictionary *dictionary = nullptr);
 
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen = 0);
 char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen);
@@ -100,6 +103,16 @@ std::string hash(HashFunction::Function function, const char *input, uint64_t si
 void hash(HashFunction::Function function, Data *input, HashFunction::Value &output);
 void hash(HashFunction::Function function, const char *input, uint64_t size, HashFunction::Value &output);
 
+/**
+ * Hashes several inputs with the same hash function. Inputs are spread across
+ * worker threads when there is enough data for that to be worthwhile.
+ *
+ * @param[in] function The selected hash function.
+ * @param[in] inputs Pointers to and sizes of the data to hash.
+ * @param[out] outputs The hash of each input, in the same order.
+ **/
+void hashMultiple(HashFunction::Function function, const std::vector<std::pair<const char *, uint64>> &inputs, std::vector<HashFunction::Value> &outputs);
+
 
 bool getConstant(const char *in, EncodeFormat &out);
 bool getConstant(EncodeFormat in, const char *&out);
@@ -125,6 +138,9 @@ public:
 	ByteData *newByteData(size_t size);
 	ByteData *newByteData(const void *d, size_t size);
 	ByteData *newByteData(void *d, size_t size, bool own);
+	Hasher *newHasher(HashFunction::Function function);
+	Encoder *newEncoder(EncodeFormat format, Encoder::Mode mode, size_t lineLength);
+	CompressionStream *newCompressionStream(Compressor::Format format, CompressionStream::Mode mode, int level, Stream *target, CompressionDictionary *dictionary);
 
 }; // DataModule
 
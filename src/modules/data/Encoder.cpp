@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Encoder.h"
+#include "common/Exception.h"
+#include "common/hex.h"
+
+// C++
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace data
+{
+
+love::Type Encoder::type("Encoder", &Object::type);
+
+Encoder::Encoder(EncodeFormat format, Mode mode, size_t lineLength)
+	: format(format)
+	, mode(mode)
+	, lineLength(lineLength)
+	, column(0)
+	, pending()
+	, pendingSize(0)
+	, b64State()
+	, prefixChecked(false)
+{
+	if (lineLength % 4 != 0)
+		throw love::Exception("Encoder line length must be a multiple of 4.");
+}
+
+Encoder::~Encoder()
+{
+}
+
+void Encoder::update(const void *input, size_t size, std::vector<char> &output)
+{
+	const char *src = (const char *) input;
+
+	if (mode == MODE_ENCODE)
+	{
+		if (format == ENCODE_HEX)
+		{
+			size_t pos = output.size();
+			output.resize(pos + size * 2);
+			hex_encode((const uint8 *) src, size, output.data() + pos);
+		}
+		else
+			encodeBase64(src, size, output);
+	}
+	else
+	{
+		if (format == ENCODE_HEX)
+			decodeHex(src, size, output);
+		else
+		{
+			size_t pos = output.size();
+			output.resize(pos + ((b64State.count + size) / 4) * 3);
+			size_t written = b64_decode_update(b64State, src, size, output.data() + pos);
+			output.resize(pos + written);
+		}
+	}
+}
+
+void Encoder::finish(std::vector<char> &output)
+{
+	if (mode == MODE_ENCODE)
+	{
+		if (format == ENCODE_BASE64 && pendingSize > 0)
+		{
+			size_t pos = output.size();
+			output.resize(pos + 4);
+			b64_encode_tail(pending, pendingSize, output.data() + pos);
+
+			column += 4;
+			endLine(output);
+		}
+	}
+	else
+	{
+		if (format == ENCODE_HEX)
+		{
+			if (pendingSize > 0)
+				output.push_back((char) (hex_nibble(pending[0]) << 4));
+		}
+		else
+		{
+			char tail[2];
+			size_t size = b64_decode_finish(b64State, tail);
+			output.insert(output.end(), tail, tail + size);
+		}
+	}
+
+	reset();
+}
+
+void Encoder::reset()
+{
+	column = 0;
+	pendingSize = 0;
+	b64State = B64DecodeState();
+	prefixChecked = false;
+}
+
+void Encoder::encodeBase64(const char *src, size_t size, std::vector<char> &output)
+{
+	// Complete a group left over from the last update first.
+	if (pendingSize > 0)
+	{
+		size_t n = std::min(size, 3 - pendingSize);
+		memcpy(pending + pendingSize, src, n);
+		pendingSize += n;
+		src += n;
+		size -= n;
+
+		if (pendingSize < 3)
+			return;
+
+		pendingSize = 0;
+		encodeBase64(pending, 3, output);
+	}
+
+	while (size >= 3)
+	{
+		size_t groups = size / 3;
+		if (lineLength > 0)
+			groups = std::min(groups, (lineLength - column) / 4);
+
+		size_t pos = output.size();
+		output.resize(pos + groups * 4);
+		b64_encode_groups(src, groups * 3, output.data() + pos);
+
+		src += groups * 3;
+		size -= groups * 3;
+
+		column += groups * 4;
+		endLine(output);
+	}
+
+	memcpy(pending, src, size);
+	pendingSize = size;
+}
+
+void Encoder::endLine(std::vector<char> &output)
+{
+	if (lineLength > 0 && column >= lineLength)
+	{
+		output.push_back('\n');
+		column = 0;
+	}
+}
+
+void Encoder::decodeHex(const char *src, size_t size, std::vector<char> &output)
+{
+	// Matches the one-shot decode, which skips a "0x" prefix at the start.
+	if (!prefixChecked)
+	{
+		if (pendingSize + size < 2)
+		{
+			if (size > 0)
+				pending[pendingSize++] = src[0];
+			return;
+		}
+
+		char first = pendingSize > 0 ? pending[0] : src[0];
+		char second = pendingSize > 0 ? src[0] : src[1];
+
+		if (first == '0' && (second == 'x' || second == 'X'))
+		{
+			size_t skip = 2 - pendingSize;
+			src += skip;
+			size -= skip;
+			pendingSize = 0;
+		}
+
+		prefixChecked = true;
+	}
+
+	if (pendingSize > 0 && size > 0)
+	{
+		output.push_back((char) ((hex_nibble(pending[0]) << 4) | hex_nibble(src[0])));
+		pendingSize = 0;
+		src++;
+		size--;
+	}
+
+	size_t pairs = size / 2;
+	size_t pos = output.size();
+	output.resize(pos + pairs);
+	hex_decode(src, pairs * 2, (uint8 *) output.data() + pos);
+
+	if (size % 2 != 0)
+	{
+		pending[0] = src[size - 1];
+		pendingSize = 1;
+	}
+}
+
+EncodeFormat Encoder::getFormat() const
+{
+	return format;
+}
+
+Encoder::Mode Encoder::getMode() const
+{
+	return mode;
+}
+
+bool Encoder::getConstant(const char *in, Mode &out)
+{
+	return modeNames.find(in, out);
+}
+
+bool Encoder::getConstant(Mode in, const char *&out)
+{
+	return modeNames.find(in, out);
+}
+
+std::vector<std::string> Encoder::getConstants(Mode)
+{
+	return modeNames.getNames();
+}
+
+StringMap<Encoder::Mode, Encoder::MODE_MAX_ENUM>::Entry Encoder::modeEntries[] =
+{
+	{ "encode", MODE_ENCODE },
+	{ "decode", MODE_DECODE },
+};
+
+StringMap<Encoder::Mode, Encoder::MODE_MAX_ENUM> Encoder::modeNames(Encoder::modeEntries, sizeof(Encoder::modeEntries));
+
+} // data
+} // love
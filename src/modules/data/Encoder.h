@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "common/b64.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+enum EncodeFormat
+{
+	ENCODE_BASE64,
+	ENCODE_HEX,
+	ENCODE_MAX_ENUM
+};
+
+/**
+ * Encodes or decodes input which is processed in multiple pieces, e.g. a
+ * large file read in chunks. Input which doesn't make up a whole block yet is
+ * held until the next update or finish.
+ **/
+class Encoder : public Object
+{
+public:
+
+	enum Mode
+	{
+		MODE_ENCODE,
+		MODE_DECODE,
+		MODE_MAX_ENUM
+	};
+
+	static love::Type type;
+
+	/**
+	 * @param lineLength Base64 output is split into lines of this many
+	 *        characters when encoding. Must be a multiple of 4, or 0 for no
+	 *        line breaks.
+	 **/
+	Encoder(EncodeFormat format, Mode mode, size_t lineLength = 0);
+	virtual ~Encoder();
+
+	/**
+	 * Processes the next piece of input and appends the result to output.
+	 **/
+	void update(const void *input, size_t size, std::vector<char> &output);
+
+	/**
+	 * Appends the result of any held input (and base64 padding) to output,
+	 * and starts a new stream.
+	 **/
+	void finish(std::vector<char> &output);
+
+	void reset();
+
+	EncodeFormat getFormat() const;
+	Mode getMode() const;
+
+	static bool getConstant(const char *in, Mode &out);
+	static bool getConstant(Mode in, const char *&out);
+	static std::vector<std::string> getConstants(Mode);
+
+private:
+
+	void encodeBase64(const char *src, size_t size, std::vector<char> &output);
+	void decodeHex(const char *src, size_t size, std::vector<char> &output);
+	void endLine(std::vector<char> &output);
+
+	EncodeFormat format;
+	Mode mode;
+	size_t lineLength;
+
+	// Characters written to the current line of base64 output.
+	size_t column;
+
+	// Bytes of an incomplete base64 group, or an unpaired hex character.
+	char pending[3];
+	size_t pendingSize;
+
+	B64DecodeState b64State;
+
+	bool prefixChecked;
+
+	static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
+	static StringMap<Mode, MODE_MAX_ENUM> modeNames;
+
+}; // Encoder
+
+} // data
+} // love
@@ -20,6 +20,26 @@
 
 #include "HashFunction.h"
 
+#include "libraries/xxHash/xxhash.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+// The SHA extensions are checked for at runtime on x86, so the hardware paths
+// are compiled in regardless of the target CPU the rest of the code is built for.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	define LOVE_HASH_SHA_X86
+#	if defined(_MSC_VER) && !defined(__clang__)
+#		include <intrin.h>
+#		define LOVE_HASH_TARGET_SHA
+#	else
+#		include <cpuid.h>
+#		include <immintrin.h>
+#		define LOVE_HASH_TARGET_SHA __attribute__((target("sha,sse4.1")))
+#	endif
+#endif
+
 // FIXME: Probably trivial by having tole and tobe functions, which can be ifdeffed to being identity functions
 #ifdef LOVE_BIG_ENDIAN
 #	error Hashing not yet implemented for big endian
@@ -50,54 +70,311 @@ inline uint64 rightrot(uint64 x, uint8 amount)
 	return (x >> amount) | (x << (64 - amount));
 }
 
+inline uint32 loadbe32(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+inline uint64 loadbe64(const uint8 *p)
+{
+	return ((uint64) loadbe32(p) << 32) | (uint64) loadbe32(p + 4);
+}
+
+inline void storebe32(uint8 *p, uint32 x)
+{
+	p[0] = (x >> 24) & 0xFF;
+	p[1] = (x >> 16) & 0xFF;
+	p[2] = (x >>  8) & 0xFF;
+	p[3] = (x >>  0) & 0xFF;
+}
+
+inline void storebe64(uint8 *p, uint64 x)
+{
+	storebe32(p, (uint32) (x >> 32));
+	storebe32(p + 4, (uint32) x);
+}
+
+#ifdef LOVE_HASH_SHA_X86
+
 /**
- * The following implementation is based on the pseudocode provided by multiple
- * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
- * The pseudocode is licensed under the CC-BY-SA license, but no authorship
- * information is present. I believe this note, and the zlib license of this
- * project satisfy the conditions of the license.
+ * Whether the CPU has the SHA extensions (and the SSSE3/SSE4.1 instructions
+ * the implementations below use alongside them.) Checked once, since hashing
+ * is often done on many small inputs.
  **/
-class MD5 : public HashFunction
+bool hasSHAExtensions()
 {
-private:
-	static const uint8 shifts[64];
-	static const uint32 constants[64];
+	static const bool supported = []()
+	{
+		unsigned int leaf1[4] = {0, 0, 0, 0};
+		unsigned int leaf7[4] = {0, 0, 0, 0};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+		int regs[4];
+		__cpuid(regs, 0);
+		if (regs[0] < 7)
+			return false;
+		__cpuid(regs, 1);
+		memcpy(leaf1, regs, sizeof(leaf1));
+		__cpuidex(regs, 7, 0);
+		memcpy(leaf7, regs, sizeof(leaf7));
+#else
+		if (__get_cpuid_max(0, nullptr) < 7)
+			return false;
+		__cpuid(1, leaf1[0], leaf1[1], leaf1[2], leaf1[3]);
+		__cpuid_count(7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3]);
+#endif
+
+		bool ssse3 = (leaf1[2] & (1 << 9)) != 0;
+		bool sse41 = (leaf1[2] & (1 << 19)) != 0;
+		bool sha = (leaf7[1] & (1 << 29)) != 0;
+
+		return ssse3 && sse41 && sha;
+	}();
+
+	return supported;
+}
+
+/**
+ * SHA1 compression using the SHA extensions. Each iteration of the inner
+ * loop does 4 rounds, while the message schedule for later rounds is
+ * computed in a rolling set of 4 registers.
+ **/
+LOVE_HASH_TARGET_SHA
+void sha1BlocksSHAExtensions(uint32 state[5], const uint8 *blocks, uint64 count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0x1B);
+	__m128i e[2] = {_mm_set_epi32((int) state[4], 0, 0, 0), _mm_setzero_si128()};
+	__m128i msg[4];
+
+	for (uint64 i = 0; i < count; i++)
+	{
+		const uint8 *chunk = blocks + i * 64;
+
+		__m128i abcdsave = abcd;
+		__m128i esave = e[0];
+
+		for (int j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (chunk + j * 16)), mask);
+
+		for (int j = 0; j < 20; j++)
+		{
+			if (j == 0)
+				e[0] = _mm_add_epi32(e[0], msg[0]);
+			else
+				e[j % 2] = _mm_sha1nexte_epu32(e[j % 2], msg[j % 4]);
+
+			e[(j + 1) % 2] = abcd;
+
+			if (j >= 3 && j <= 18)
+				msg[(j + 1) % 4] = _mm_sha1msg2_epu32(msg[(j + 1) % 4], msg[j % 4]);
+
+			switch (j / 5)
+			{
+			case 0: abcd = _mm_sha1rnds4_epu32(abcd, e[j % 2], 0); break;
+			case 1: abcd = _mm_sha1rnds4_epu32(abcd, e[j % 2], 1); break;
+			case 2: abcd = _mm_sha1rnds4_epu32(abcd, e[j % 2], 2); break;
+			default: abcd = _mm_sha1rnds4_epu32(abcd, e[j % 2], 3); break;
+			}
+
+			if (j >= 1 && j <= 16)
+				msg[(j + 3) % 4] = _mm_sha1msg1_epu32(msg[(j + 3) % 4], msg[j % 4]);
+
+			if (j >= 2 && j <= 17)
+				msg[(j + 2) % 4] = _mm_xor_si128(msg[(j + 2) % 4], msg[j % 4]);
+		}
 
+		e[0] = _mm_sha1nexte_epu32(e[0], esave);
+		abcd = _mm_add_epi32(abcd, abcdsave);
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1B);
+	_mm_storeu_si128((__m128i *) state, abcd);
+	state[4] = (uint32) _mm_extract_epi32(e[0], 3);
+}
+
+/**
+ * SHA-256 compression using the SHA extensions. The extensions work on the
+ * state as ABEF and CDGH halves rather than in order, and do 2 rounds per
+ * instruction.
+ **/
+LOVE_HASH_TARGET_SHA
+void sha256BlocksSHAExtensions(uint32 state[8], const uint32 constants[64], const uint8 *blocks, uint64 count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xB1); // CDAB
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1B); // EFGH
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+	__m128i msg[4];
+
+	for (uint64 i = 0; i < count; i++)
+	{
+		const uint8 *chunk = blocks + i * 64;
+
+		__m128i state0save = state0;
+		__m128i state1save = state1;
+
+		for (int j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (chunk + j * 16)), mask);
+
+		for (int j = 0; j < 16; j++)
+		{
+			__m128i k = _mm_loadu_si128((const __m128i *) &constants[j * 4]);
+			__m128i w = _mm_add_epi32(msg[j % 4], k);
+
+			state1 = _mm_sha256rnds2_epu32(state1, state0, w);
+
+			if (j >= 3 && j <= 14)
+			{
+				__m128i &next = msg[(j + 1) % 4];
+				next = _mm_add_epi32(next, _mm_alignr_epi8(msg[j % 4], msg[(j + 3) % 4], 4));
+				next = _mm_sha256msg2_epu32(next, msg[j % 4]);
+			}
+
+			state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(w, 0x0E));
+
+			if (j >= 1 && j <= 12)
+				msg[(j + 3) % 4] = _mm_sha256msg1_epu32(msg[(j + 3) % 4], msg[j % 4]);
+		}
+
+		state0 = _mm_add_epi32(state0, state0save);
+		state1 = _mm_add_epi32(state1, state1save);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8); // HGFE
+
+	_mm_storeu_si128((__m128i *) &state[0], state0);
+	_mm_storeu_si128((__m128i *) &state[4], state1);
+}
+
+#endif // LOVE_HASH_SHA_X86
+
+/**
+ * Splits input into fixed-size blocks, and applies the padding which MD5, SHA1
+ * and SHA2 share: a 1 bit, zeroes, and the message length in bits at the end
+ * of the last block. Input is processed directly where possible, so hashing
+ * large inputs doesn't need a padded copy of them.
+ **/
+template <size_t BLOCK_SIZE, size_t LENGTH_SIZE, bool BIG_ENDIAN_LENGTH>
+class BlockState : public HashFunction::State
+{
 public:
-	bool isSupported(Function function) const override
+
+	BlockState()
+		: length(0)
+		, bufferSize(0)
 	{
-		return function == FUNCTION_MD5;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	void update(const char *input, uint64 size) override
 	{
-		if (function != FUNCTION_MD5)
-			throw love::Exception("Hash function not supported by MD5 implementation");
+		const uint8 *in = (const uint8 *) input;
+		length += size;
+
+		if (bufferSize > 0)
+		{
+			size_t count = (size_t) std::min((uint64) (BLOCK_SIZE - bufferSize), size);
+			memcpy(buffer + bufferSize, in, count);
+			bufferSize += count;
+			in += count;
+			size -= count;
+
+			if (bufferSize < BLOCK_SIZE)
+				return;
+
+			processBlocks(buffer, 1);
+			bufferSize = 0;
+		}
 
-		uint32 a0 = 0x67452301;
-		uint32 b0 = 0xefcdab89;
-		uint32 c0 = 0x98badcfe;
-		uint32 d0 = 0x10325476;
+		uint64 blocks = size / BLOCK_SIZE;
+		if (blocks > 0)
+		{
+			processBlocks(in, blocks);
+			in += blocks * BLOCK_SIZE;
+			size -= blocks * BLOCK_SIZE;
+		}
 
-		//Do the required padding (MD5, SHA1 and SHA2 use the same padding)
-		uint64 paddedLength = length + 1; //Consider the appended bit
-		if (paddedLength % 64 < 56)
-			paddedLength += 56 - paddedLength % 64;
-		if (paddedLength % 64 > 56)
-			paddedLength += 120 - paddedLength % 64;
+		memcpy(buffer, in, (size_t) size);
+		bufferSize = (size_t) size;
+	}
 
-		uint8 *padded = new uint8[paddedLength + 8];
-		memcpy(padded, input, length);
-		memset(padded + length, 0, paddedLength - length);
-		padded[length] = 0x80;
+	void finish(HashFunction::Value &output) override
+	{
+		uint64 bits = length * 8;
 
-		//Now we need the length in bits
-		*((uint64*) &padded[paddedLength]) = length * 8;
-		paddedLength += 8;
+		uint8 padding[BLOCK_SIZE + LENGTH_SIZE] = {0x80};
+		size_t paddingSize = BLOCK_SIZE - LENGTH_SIZE - bufferSize;
+		if (bufferSize >= BLOCK_SIZE - LENGTH_SIZE)
+			paddingSize += BLOCK_SIZE;
 
-		for (uint64 i = 0; i < paddedLength; i += 64)
+		// The length is 64 bits, stored at the end of a (possibly larger) field.
+		uint8 *lengthBytes = padding + paddingSize;
+		memset(lengthBytes, 0, LENGTH_SIZE);
+		for (int i = 0; i < 8; i++)
 		{
-			uint32 *chunk = (uint32*) &padded[i];
+			if (BIG_ENDIAN_LENGTH)
+				lengthBytes[LENGTH_SIZE - 1 - i] = (bits >> (i * 8)) & 0xFF;
+			else
+				lengthBytes[i] = (bits >> (i * 8)) & 0xFF;
+		}
+
+		update((const char *) padding, paddingSize + LENGTH_SIZE);
+		getResult(output);
+		reset();
+	}
+
+	void reset() override
+	{
+		length = 0;
+		bufferSize = 0;
+		resetIntermediate();
+	}
+
+protected:
+
+	virtual void processBlocks(const uint8 *blocks, uint64 count) = 0;
+	virtual void getResult(HashFunction::Value &output) = 0;
+	virtual void resetIntermediate() = 0;
+
+private:
+
+	uint64 length;
+	uint8 buffer[BLOCK_SIZE];
+	size_t bufferSize;
+
+}; // BlockState
+
+/**
+ * The following implementation is based on the pseudocode provided by multiple
+ * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
+ * The pseudocode is licensed under the CC-BY-SA license, but no authorship
+ * information is present. I believe this note, and the zlib license of this
+ * project satisfy the conditions of the license.
+ **/
+class MD5State : public BlockState<64, 8, false>
+{
+public:
+
+	MD5State()
+	{
+		reset();
+	}
+
+protected:
+
+	void processBlocks(const uint8 *blocks, uint64 count) override
+	{
+		for (uint64 i = 0; i < count; i++)
+		{
+			uint32 chunk[16];
+			memcpy(chunk, blocks + i * 64, 64);
 
 			uint32 A = a0;
 			uint32 B = b0;
@@ -141,25 +418,42 @@ public:
 			c0 += C;
 			d0 += D;
 		}
+	}
 
-		delete[] padded;
-
+	void getResult(HashFunction::Value &output) override
+	{
 		memcpy(&output.data[ 0], &a0, 4);
 		memcpy(&output.data[ 4], &b0, 4);
 		memcpy(&output.data[ 8], &c0, 4);
 		memcpy(&output.data[12], &d0, 4);
 		output.size = 16;
 	}
-} md5;
 
-const uint8 MD5::shifts[64] = {
+	void resetIntermediate() override
+	{
+		a0 = 0x67452301;
+		b0 = 0xefcdab89;
+		c0 = 0x98badcfe;
+		d0 = 0x10325476;
+	}
+
+private:
+
+	static const uint8 shifts[64];
+	static const uint32 constants[64];
+
+	uint32 a0, b0, c0, d0;
+
+}; // MD5State
+
+const uint8 MD5State::shifts[64] = {
 	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
 	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
 	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
 	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
 };
 
-const uint32 MD5::constants[64] = {
+const uint32 MD5State::constants[64] = {
 	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
 	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
 	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
@@ -183,54 +477,32 @@ const uint32 MD5::constants[64] = {
  * in RFC3174. I believe this means no copyright other than that of the L�VE
  * Development Team applies.
  **/
-class SHA1 : public HashFunction
+class SHA1State : public BlockState<64, 8, true>
 {
 public:
-	bool isSupported(Function function) const override
-	{
-		return function == FUNCTION_SHA1;
-	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	SHA1State()
 	{
-		if (function != FUNCTION_SHA1)
-			throw love::Exception("Hash function not supported by SHA1 implementation");
-
-		uint32 intermediate[5] = {
-			0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
-		};
-
-		//Do the required padding (MD5, SHA1 and SHA2 use the same padding)
-		uint64 paddedLength = length + 1; //Consider the appended bit
-		if (paddedLength % 64 < 56)
-			paddedLength += 56 - paddedLength % 64;
-		if (paddedLength % 64 > 56)
-			paddedLength += 120 - paddedLength % 64;
+		reset();
+	}
 
-		uint8 *padded = new uint8[paddedLength + 8];
-		memcpy(padded, input, length);
-		memset(padded + length, 0, paddedLength - length);
-		padded[length] = 0x80;
+protected:
 
-		// Now we need the length in bits (big endian)
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56 - i * 8)) & 0xFF;
+	void processBlocks(const uint8 *blocks, uint64 count) override
+	{
+#ifdef LOVE_HASH_SHA_X86
+		if (hasSHAExtensions())
+			return sha1BlocksSHAExtensions(intermediate, blocks, count);
+#endif
 
 		// Allocate our extended words
 		uint32 words[80];
 
-		for (uint64 i = 0; i < paddedLength; i += 64)
+		for (uint64 i = 0; i < count; i++)
 		{
-			uint32 *chunk = (uint32*) &padded[i];
+			const uint8 *chunk = blocks + i * 64;
 			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadbe32(chunk + j * 4);
 			for (int j = 16; j < 80; j++)
 				words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
 
@@ -266,80 +538,62 @@ public:
 			intermediate[3] += D;
 			intermediate[4] += E;
 		}
+	}
 
-		delete[] padded;
-
+	void getResult(HashFunction::Value &output) override
+	{
 		for (int i = 0; i < 20; i += 4)
-		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
-		}
+			storebe32((uint8 *) &output.data[i], intermediate[i/4]);
 
 		output.size = 20;
 	}
-} sha1;
+
+	void resetIntermediate() override
+	{
+		const uint32 initial[5] = {
+			0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+		};
+
+		memcpy(intermediate, initial, sizeof(intermediate));
+	}
+
+private:
+
+	uint32 intermediate[5];
+
+}; // SHA1State
 
 /**
  * This implementation was based on the description in RFC-6234.
  **/
 // SHA-2: SHA-224 and SHA-256
-class SHA256 : public HashFunction
+class SHA256State : public BlockState<64, 8, true>
 {
-private:
-	static const uint32 initial224[8];
-	static const uint32 initial256[8];
-	static const uint32 constants[64];
-
 public:
-	bool isSupported(Function function) const override
+
+	SHA256State(HashFunction::Function function)
+		: function(function)
 	{
-		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
+		reset();
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
-	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+protected:
 
-		//Do the required padding (MD5, SHA1 and SHA2 use the same padding)
-		uint64 paddedLength = length + 1; //Consider the appended bit
-		if (paddedLength % 64 < 56)
-			paddedLength += 56 - paddedLength % 64;
-		if (paddedLength % 64 > 56)
-			paddedLength += 120 - paddedLength % 64;
-
-		uint8 *padded = new uint8[paddedLength + 8];
-		memcpy(padded, input, length);
-		memset(padded + length, 0, paddedLength - length);
-		padded[length] = 0x80;
-
-		// Now we need the length in bits (big endian)
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56 - i * 8)) & 0xFF;
-
-		uint32 intermediate[8];
-		if (function == FUNCTION_SHA224)
-			memcpy(intermediate, initial224, sizeof(intermediate));
-		else
-			memcpy(intermediate, initial256, sizeof(intermediate));
+	void processBlocks(const uint8 *blocks, uint64 count) override
+	{
+#ifdef LOVE_HASH_SHA_X86
+		if (hasSHAExtensions())
+			return sha256BlocksSHAExtensions(intermediate, constants, blocks, count);
+#endif
 
 		// Allocate our extended words
 		uint32 words[64];
 
-		for (uint64 i = 0; i < paddedLength; i += 64)
+		for (uint64 i = 0; i < count; i++)
 		{
-			uint32 *chunk = (uint32*) &padded[i];
+			const uint8 *chunk = blocks + i * 64;
 			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadbe32(chunk + j * 4);
 			for (int j = 16; j < 64; j++)
 			{
 				words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
@@ -383,36 +637,50 @@ public:
 			intermediate[6] += G;
 			intermediate[7] += H;
 		}
+	}
 
-		delete[] padded;
-
+	void getResult(HashFunction::Value &output) override
+	{
 		int hashlength = 32;
-		if (function == FUNCTION_SHA224)
+		if (function == HashFunction::FUNCTION_SHA224)
 			hashlength = 28;
 
 		for (int i = 0; i < hashlength; i += 4)
-		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
-		}
+			storebe32((uint8 *) &output.data[i], intermediate[i/4]);
 
 		output.size = hashlength;
 	}
-} sha256;
 
-const uint32 SHA256::initial224[8] = {
+	void resetIntermediate() override
+	{
+		if (function == HashFunction::FUNCTION_SHA224)
+			memcpy(intermediate, initial224, sizeof(intermediate));
+		else
+			memcpy(intermediate, initial256, sizeof(intermediate));
+	}
+
+private:
+
+	static const uint32 initial224[8];
+	static const uint32 initial256[8];
+	static const uint32 constants[64];
+
+	HashFunction::Function function;
+	uint32 intermediate[8];
+
+}; // SHA256State
+
+const uint32 SHA256State::initial224[8] = {
 	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
 	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
 };
 
-const uint32 SHA256::initial256[8] = {
+const uint32 SHA256State::initial256[8] = {
 	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
 	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
 };
 
-const uint32 SHA256::constants[64] = {
+const uint32 SHA256State::constants[64] = {
 	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
 	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
 	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -435,67 +703,28 @@ const uint32 SHA256::constants[64] = {
  * This implementation was based on the description in RFC-6234.
  **/
 // SHA-2: SHA-384 and SHA-512
-class SHA512 : public HashFunction
+class SHA512State : public BlockState<128, 16, true>
 {
-private:
-	static const uint64 initial384[8];
-	static const uint64 initial512[8];
-	static const uint64 constants[80];
-
 public:
-	bool isSupported(Function function) const override
-	{
-		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
-	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	SHA512State(HashFunction::Function function)
+		: function(function)
 	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
-
-		uint64 intermediates[8];
-		if (function == FUNCTION_SHA384)
-			memcpy(intermediates, initial384, sizeof(intermediates));
-		else
-			memcpy(intermediates, initial512, sizeof(intermediates));
+		reset();
+	}
 
-		//Do the required padding
-		uint64 paddedLength = length + 1; //Consider the appended bit
-		if (paddedLength % 128 < 112)
-			paddedLength += 112 - paddedLength % 128;
-		if (paddedLength % 128 > 112)
-			paddedLength += 240 - paddedLength % 128;
-
-		uint8 *padded = new uint8[paddedLength + 16];
-		paddedLength += 8;
-		memcpy(padded, input, length);
-		memset(padded + length, 0, paddedLength - length);
-		padded[length] = 0x80;
-
-		// Now we need the length in bits (big endian), note we only write a 64-bit int, so
-		// we have filled the first 8 bytes with zeroes
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56 - i * 8)) & 0xFF;
+protected:
 
+	void processBlocks(const uint8 *blocks, uint64 count) override
+	{
 		// Allocate our extended words
 		uint64 words[80];
 
-		for (uint64 i = 0; i < paddedLength; i += 128)
+		for (uint64 i = 0; i < count; i++)
 		{
-			uint64 *chunk = (uint64*) &padded[i];
+			const uint8 *chunk = blocks + i * 128;
 			for (int j = 0; j < 16; ++j)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 56) & 0xFF;
-				c[1] = (chunk[j] >> 48) & 0xFF;
-				c[2] = (chunk[j] >> 40) & 0xFF;
-				c[3] = (chunk[j] >> 32) & 0xFF;
-				c[4] = (chunk[j] >> 24) & 0xFF;
-				c[5] = (chunk[j] >> 16) & 0xFF;
-				c[6] = (chunk[j] >>  8) & 0xFF;
-				c[7] = (chunk[j] >>  0) & 0xFF;
-			}
+				words[j] = loadbe64(chunk + j * 8);
 			for (int j = 16; j < 80; ++j)
 			{
 				words[j] = words[j-7] + words[j-16];
@@ -538,40 +767,50 @@ public:
 			intermediates[6] += G;
 			intermediates[7] += H;
 		}
+	}
 
-		delete[] padded;
-
+	void getResult(HashFunction::Value &output) override
+	{
 		int hashlength = 64;
-		if (function == FUNCTION_SHA384)
+		if (function == HashFunction::FUNCTION_SHA384)
 			hashlength = 48;
 
 		for (int i = 0; i < hashlength; i += 8)
-		{
-			output.data[i+0] = (intermediates[i/8] >> 56) & 0xFF;
-			output.data[i+1] = (intermediates[i/8] >> 48) & 0xFF;
-			output.data[i+2] = (intermediates[i/8] >> 40) & 0xFF;
-			output.data[i+3] = (intermediates[i/8] >> 32) & 0xFF;
-			output.data[i+4] = (intermediates[i/8] >> 24) & 0xFF;
-			output.data[i+5] = (intermediates[i/8] >> 16) & 0xFF;
-			output.data[i+6] = (intermediates[i/8] >>  8) & 0xFF;
-			output.data[i+7] = (intermediates[i/8] >>  0) & 0xFF;
-		}
+			storebe64((uint8 *) &output.data[i], intermediates[i/8]);
 
 		output.size = hashlength;
 	}
-} sha512;
 
-const uint64 SHA512::initial384[8] = {
+	void resetIntermediate() override
+	{
+		if (function == HashFunction::FUNCTION_SHA384)
+			memcpy(intermediates, initial384, sizeof(intermediates));
+		else
+			memcpy(intermediates, initial512, sizeof(intermediates));
+	}
+
+private:
+
+	static const uint64 initial384[8];
+	static const uint64 initial512[8];
+	static const uint64 constants[80];
+
+	HashFunction::Function function;
+	uint64 intermediates[8];
+
+}; // SHA512State
+
+const uint64 SHA512State::initial384[8] = {
 	0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
 	0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
 };
 
-const uint64 SHA512::initial512[8] = {
+const uint64 SHA512State::initial512[8] = {
 	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
 	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
 };
 
-const uint64 SHA512::constants[80] = {
+const uint64 SHA512State::constants[80] = {
 	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
 	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
 	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
@@ -594,6 +833,210 @@ const uint64 SHA512::constants[80] = {
 	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
 };
 
+// xxHash's XXH3, a fast non-cryptographic hash. Results are stored in the
+// canonical (big endian) form, which matches the output of xxhsum.
+class XXH3State : public HashFunction::State
+{
+public:
+
+	XXH3State(HashFunction::Function function)
+		: function(function)
+		, state(XXH3_createState())
+	{
+		if (state == nullptr)
+			throw love::Exception("Out of memory.");
+		reset();
+	}
+
+	virtual ~XXH3State()
+	{
+		XXH3_freeState(state);
+	}
+
+	void update(const char *input, uint64 length) override
+	{
+		if (function == HashFunction::FUNCTION_XXH3_64)
+			XXH3_64bits_update(state, input, (size_t) length);
+		else
+			XXH3_128bits_update(state, input, (size_t) length);
+	}
+
+	void finish(HashFunction::Value &output) override
+	{
+		if (function == HashFunction::FUNCTION_XXH3_64)
+			storeResult(XXH3_64bits_digest(state), output);
+		else
+			storeResult(XXH3_128bits_digest(state), output);
+
+		reset();
+	}
+
+	void reset() override
+	{
+		if (function == HashFunction::FUNCTION_XXH3_64)
+			XXH3_64bits_reset(state);
+		else
+			XXH3_128bits_reset(state);
+	}
+
+	static void storeResult(XXH64_hash_t hash, HashFunction::Value &output)
+	{
+		XXH64_canonical_t canonical;
+		XXH64_canonicalFromHash(&canonical, hash);
+		memcpy(output.data, &canonical, sizeof(canonical));
+		output.size = sizeof(canonical);
+	}
+
+	static void storeResult(XXH128_hash_t hash, HashFunction::Value &output)
+	{
+		XXH128_canonical_t canonical;
+		XXH128_canonicalFromHash(&canonical, hash);
+		memcpy(output.data, &canonical, sizeof(canonical));
+		output.size = sizeof(canonical);
+	}
+
+private:
+
+	HashFunction::Function function;
+	XXH3_state_t *state;
+
+}; // XXH3State
+
+class MD5 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_MD5;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (function != FUNCTION_MD5)
+			throw love::Exception("Hash function not supported by MD5 implementation");
+
+		MD5State state;
+		state.update(input, length);
+		state.finish(output);
+	}
+
+	State *newState(Function function) const override
+	{
+		if (function != FUNCTION_MD5)
+			throw love::Exception("Hash function not supported by MD5 implementation");
+
+		return new MD5State();
+	}
+} md5;
+
+class SHA1 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA1;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (function != FUNCTION_SHA1)
+			throw love::Exception("Hash function not supported by SHA1 implementation");
+
+		SHA1State state;
+		state.update(input, length);
+		state.finish(output);
+	}
+
+	State *newState(Function function) const override
+	{
+		if (function != FUNCTION_SHA1)
+			throw love::Exception("Hash function not supported by SHA1 implementation");
+
+		return new SHA1State();
+	}
+} sha1;
+
+class SHA256 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+
+		SHA256State state(function);
+		state.update(input, length);
+		state.finish(output);
+	}
+
+	State *newState(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
+
+		return new SHA256State(function);
+	}
+} sha256;
+
+class SHA512 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+
+		SHA512State state(function);
+		state.update(input, length);
+		state.finish(output);
+	}
+
+	State *newState(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+
+		return new SHA512State(function);
+	}
+} sha512;
+
+class XXH3 : public HashFunction
+{
+public:
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_XXH3_64 || function == FUNCTION_XXH3_128;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (function == FUNCTION_XXH3_64)
+			XXH3State::storeResult(XXH3_64bits(input, (size_t) length), output);
+		else if (function == FUNCTION_XXH3_128)
+			XXH3State::storeResult(XXH3_128bits(input, (size_t) length), output);
+		else
+			throw love::Exception("Hash function not supported by XXH3 implementation");
+	}
+
+	State *newState(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by XXH3 implementation");
+
+		return new XXH3State(function);
+	}
+} xxh3;
+
 } // impl
 }
 
@@ -611,6 +1054,9 @@ HashFunction *HashFunction::getHashFunction(Function function)
 	case FUNCTION_SHA384:
 	case FUNCTION_SHA512:
 		return &impl::sha512;
+	case FUNCTION_XXH3_64:
+	case FUNCTION_XXH3_128:
+		return &impl::xxh3;
 	case FUNCTION_MAX_ENUM:
 		return nullptr;
 	// No default for compiler warnings
@@ -640,6 +1086,8 @@ StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM>::Entry HashFu
 	{"sha256", FUNCTION_SHA256},
 	{"sha384", FUNCTION_SHA384},
 	{"sha512", FUNCTION_SHA512},
+	{"xxh3_64", FUNCTION_XXH3_64},
+	{"xxh3_128", FUNCTION_XXH3_128},
 };
 
 StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM> HashFunction::functionNames(HashFunction::functionEntries, sizeof(HashFunction::functionEntries));
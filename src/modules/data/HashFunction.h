@@ -42,6 +42,8 @@ public:
 		FUNCTION_SHA256,
 		FUNCTION_SHA384,
 		FUNCTION_SHA512,
+		FUNCTION_XXH3_64,
+		FUNCTION_XXH3_128,
 		FUNCTION_MAX_ENUM
 	};
 
@@ -51,6 +53,29 @@ public:
 		size_t size;
 	};
 
+	/**
+	 * Hashing state for input which is processed in multiple pieces.
+	 **/
+	class State
+	{
+	public:
+
+		virtual ~State() {}
+
+		/**
+		 * Adds more input to the hash.
+		 **/
+		virtual void update(const char *input, uint64 length) = 0;
+
+		/**
+		 * Produces the hash of all input since the last reset, and resets the
+		 * state afterwards.
+		 **/
+		virtual void finish(Value &output) = 0;
+
+		virtual void reset() = 0;
+	};
+
 	/**
 	 * Get a HashFunction instance for the given function.
 	 *
@@ -72,6 +97,14 @@ public:
 	 **/
 	virtual void hash(Function function, const char *input, uint64 length, Value &output) const = 0;
 
+	/**
+	 * Creates a new incremental hashing state for the given function.
+	 *
+	 * @param[in] function The selected hash function.
+	 * @return The new state (allocated with new).
+	 **/
+	virtual State *newState(Function function) const = 0;
+
 	/**
 	 * @param[in] function The requested hash function.
 	 * @return Whether this HashFunction instance implements the given function.
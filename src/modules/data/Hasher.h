@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "HashFunction.h"
+
+// C++
+#include <memory>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Hashes input which is processed in multiple pieces, e.g. a large file read
+ * in chunks.
+ **/
+class Hasher : public Object
+{
+public:
+
+	static love::Type type;
+
+	Hasher(HashFunction::Function function);
+	virtual ~Hasher();
+
+	void update(const void *input, size_t size);
+	void update(Data *input);
+
+	/**
+	 * Gets the hash of all input since the Hasher was created or last
+	 * finished, and starts a new hash.
+	 **/
+	void finish(HashFunction::Value &output);
+
+	void reset();
+
+	HashFunction::Function getFunction() const;
+
+private:
+
+	HashFunction::Function function;
+	std::unique_ptr<HashFunction::State> state;
+
+}; // Hasher
+
+} // data
+} // love
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ResidentData.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+static love::thread::Mutex *getRegistryMutex()
+{
+	static auto *mutex = new love::thread::MutexRef();
+	return *mutex;
+}
+
+static std::vector<ResidentData *> &getRegistry()
+{
+	static std::vector<ResidentData *> registry;
+	return registry;
+}
+
+static double getSeconds()
+{
+	auto t = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration<double>(t).count();
+}
+
+ResidentData::ResidentData()
+	: idleCompression(false)
+	, touched(false)
+	, compressed(false)
+	, pins(0)
+	, idleSince(0.0)
+	, compressedBytes(nullptr)
+	, compressedSize(0)
+	, compressedFormat(Compressor::FORMAT_LZ4)
+{
+}
+
+ResidentData::~ResidentData()
+{
+	unregisterResident();
+	delete[] compressedBytes;
+}
+
+void ResidentData::unregisterResident()
+{
+	if (!idleCompression)
+		return;
+
+	love::thread::Lock lock(getRegistryMutex());
+
+	auto &registry = getRegistry();
+	registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+
+	idleCompression = false;
+}
+
+void ResidentData::setIdleCompression(bool enable)
+{
+	if (enable == idleCompression)
+		return;
+
+	if (enable)
+	{
+		love::thread::Lock lock(getRegistryMutex());
+
+		touched = false;
+		idleSince = getSeconds();
+		idleCompression = true;
+
+		getRegistry().push_back(this);
+	}
+	else
+	{
+		unregisterResident();
+
+		love::thread::Lock lock(mutex);
+		decompress();
+	}
+}
+
+void ResidentData::touch() const
+{
+	touched = true;
+
+	if (compressed)
+	{
+		love::thread::Lock lock(mutex);
+		decompress();
+	}
+}
+
+void ResidentData::pinResident() const
+{
+	// Same ordering as touch() and compress(): either compress sees the pin,
+	// or this sees the compressed flag and waits for it to finish.
+	pins++;
+
+	if (compressed)
+	{
+		love::thread::Lock lock(mutex);
+		decompress();
+	}
+}
+
+void ResidentData::unpinResident() const
+{
+	// Restart the idle timer from the last use rather than the pin.
+	touched = true;
+	pins--;
+}
+
+void ResidentData::pin(const love::Data *data)
+{
+	auto resident = dynamic_cast<const ResidentData *>(data);
+	if (resident != nullptr)
+		resident->pinResident();
+}
+
+void ResidentData::unpin(const love::Data *data)
+{
+	auto resident = dynamic_cast<const ResidentData *>(data);
+	if (resident != nullptr)
+		resident->unpinResident();
+}
+
+void ResidentData::decompress() const
+{
+	if (compressedBytes == nullptr)
+		return;
+
+	Compressor *compressor = Compressor::getCompressor(compressedFormat);
+	if (compressor == nullptr)
+		throw love::Exception("Cannot decompress idle Data: compression format is not supported.");
+
+	size_t size = getResidentSize();
+	char *bytes = compressor->decompress(compressedFormat, compressedBytes, compressedSize, nullptr, size);
+
+	delete[] compressedBytes;
+	compressedBytes = nullptr;
+	compressedSize = 0;
+
+	const_cast<ResidentData *>(this)->restoreResidentBytes(bytes);
+
+	compressed = false;
+}
+
+bool ResidentData::compress(Compressor::Format format)
+{
+	Compressor *compressor = Compressor::getCompressor(format);
+	if (compressor == nullptr)
+		throw love::Exception("Cannot compress idle Data: compression format is not supported.");
+
+	love::thread::Lock lock(mutex);
+
+	if (compressed)
+		return false;
+
+	// Mark the bytes as compressed before checking whether they were touched
+	// or pinned: a concurrent touch() or pinResident() then either shows up
+	// here, or sees the flag and waits on the mutex to decompress.
+	compressed = true;
+
+	if (touched || pins > 0)
+	{
+		compressed = false;
+		return false;
+	}
+
+	size_t size = getResidentSize();
+	size_t csize = 0;
+	char *cbytes = nullptr;
+
+	try
+	{
+		cbytes = compressor->compress(format, (const char *) getResidentBytes(), size, -1, nullptr, csize);
+	}
+	catch (love::Exception &)
+	{
+		compressed = false;
+		throw;
+	}
+
+	// Not worth keeping if it barely compresses.
+	if (csize + csize / 8 >= size)
+	{
+		delete[] cbytes;
+		compressed = false;
+		return false;
+	}
+
+	compressedBytes = cbytes;
+	compressedSize = csize;
+	compressedFormat = format;
+
+	releaseResidentBytes();
+
+	return true;
+}
+
+void ResidentData::compressIdle(double idleSeconds, Compressor::Format format, int &count, int64 &savedBytes)
+{
+	count = 0;
+	savedBytes = 0;
+
+	double now = getSeconds();
+
+	love::thread::Lock lock(getRegistryMutex());
+
+	for (ResidentData *d : getRegistry())
+	{
+		if (d->touched.exchange(false))
+		{
+			d->idleSince = now;
+			continue;
+		}
+
+		if (d->compressed || d->pins > 0 || now - d->idleSince < idleSeconds)
+			continue;
+
+		if (d->compress(format))
+		{
+			count++;
+			savedBytes += (int64) d->getResidentSize() - (int64) d->compressedSize;
+		}
+	}
+}
+
+} // data
+} // love
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "common/Data.h"
+#include "Compressor.h"
+#include "thread/threads.h"
+
+// C++
+#include <atomic>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Lets large Data objects which are kept around for reuse (ImageData,
+ * SoundData) compress their contents in memory while they aren't used.
+ * Subclasses call makeResident() before accessing their bytes, which
+ * decompresses them if needed. compressIdle() compresses every object with
+ * idle compression enabled which hasn't been accessed for a while.
+ *
+ * Pointers previously returned by getData() become invalid once the object
+ * is compressed. Code which keeps using them after the call that got them
+ * returns (jobs, other threads, OpenAL buffers, network packets) must pin the
+ * object meanwhile: pinned objects are never compressed. Raw pointers handed
+ * to Lua (Data:getPointer, Data:getFFIPointer) pin the object for good when
+ * idle compression is already enabled; enabling it afterwards invalidates
+ * such pointers.
+ **/
+class ResidentData
+{
+public:
+
+	ResidentData();
+	virtual ~ResidentData();
+
+	void setIdleCompression(bool enable);
+	bool hasIdleCompression() const { return idleCompression; }
+
+	bool isIdleCompressed() const { return compressed; }
+
+	void makeResident() const
+	{
+		if (idleCompression)
+			touch();
+	}
+
+	/**
+	 * Makes the bytes resident and keeps them that way until the matching
+	 * unpinResident call.
+	 **/
+	void pinResident() const;
+	void unpinResident() const;
+
+	/**
+	 * Pins the given object for the lifetime of the Pin.
+	 **/
+	class Pin
+	{
+	public:
+
+		Pin(const ResidentData *data)
+			: data(data)
+		{
+			if (data != nullptr)
+				data->pinResident();
+		}
+
+		~Pin()
+		{
+			if (data != nullptr)
+				data->unpinResident();
+		}
+
+		Pin(const Pin &) = delete;
+		Pin &operator = (const Pin &) = delete;
+
+	private:
+
+		const ResidentData *data;
+
+	}; // Pin
+
+	/**
+	 * Pin or unpin a Data if it's a ResidentData, otherwise do nothing.
+	 **/
+	static void pin(const love::Data *data);
+	static void unpin(const love::Data *data);
+
+	/**
+	 * Compresses the contents of objects with idle compression enabled which
+	 * weren't accessed in the last idleSeconds. An object counts as idle from
+	 * the first call which sees it untouched, so this should be called
+	 * periodically.
+	 *
+	 * @param[out] count The number of objects compressed by this call.
+	 * @param[out] savedBytes The memory freed by this call.
+	 **/
+	static void compressIdle(double idleSeconds, Compressor::Format format, int &count, int64 &savedBytes);
+
+protected:
+
+	// The subclass' bytes, while they're not compressed.
+	virtual void *getResidentBytes() const = 0;
+	virtual size_t getResidentSize() const = 0;
+
+	// Frees the subclass' bytes once they've been compressed.
+	virtual void releaseResidentBytes() = 0;
+
+	// Gives the subclass its decompressed bytes, allocated with new[].
+	virtual void restoreResidentBytes(char *bytes) = 0;
+
+	// Subclasses call this first in their destructors, so compressIdle never
+	// sees a partially destroyed object.
+	void unregisterResident();
+
+private:
+
+	void touch() const;
+	void decompress() const;
+	bool compress(Compressor::Format format);
+
+	std::atomic<bool> idleCompression;
+	mutable std::atomic<bool> touched;
+	mutable std::atomic<bool> compressed;
+	mutable std::atomic<int> pins;
+	double idleSince;
+
+	mutable char *compressedBytes;
+	mutable size_t compressedSize;
+	mutable Compressor::Format compressedFormat;
+
+	love::thread::MutexRef mutex;
+
+}; // ResidentData
+
+} // data
+} // love
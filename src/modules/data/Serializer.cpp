@@ -0,0 +1,499 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Serializer.h"
+#include "ByteData.h"
+#include "Compressor.h"
+#include "common/Exception.h"
+
+// C++
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace love
+{
+namespace data
+{
+
+namespace
+{
+
+/**
+ * Serialized data starts with a small header: a 3 byte magic number, a format
+ * version, and a flags byte. The (possibly compressed) value follows it.
+ *
+ * Each value is a tag byte followed by the tag's payload. Integers and sizes
+ * are stored as LEB128 varints, and signed integers are zigzag encoded first.
+ * Tables are stored as their array part (a count followed by that many
+ * values), then key/value pairs for the rest of the table terminated by a nil
+ * key. Each string is given an index in the order they're first written, and
+ * later copies of the same string are stored as that index.
+ **/
+const char magic[3] = {'L', 'S', 'D'};
+const uint8 version = 1;
+const size_t headerSize = 5;
+
+const uint8 FLAG_COMPRESSED = 0x01;
+
+// Deeper nesting than this is almost certainly a mistake (or malicious data,
+// when deserializing), and would eventually overflow the C or Lua stack.
+const int maxDepth = 200;
+
+enum Tag
+{
+	TAG_NIL,
+	TAG_FALSE,
+	TAG_TRUE,
+	TAG_INTEGER,
+	TAG_NUMBER,
+	TAG_STRING,
+	TAG_STRING_REF,
+	TAG_TABLE,
+	TAG_DATA,
+};
+
+class Writer
+{
+public:
+
+	Writer(lua_State *L, std::vector<char> &output)
+		: L(L)
+		, output(output)
+	{}
+
+	void writeValue(int idx, int depth)
+	{
+		if (idx < 0)
+			idx = lua_gettop(L) + idx + 1;
+
+		switch (lua_type(L, idx))
+		{
+		case LUA_TNIL:
+			writeByte(TAG_NIL);
+			break;
+		case LUA_TBOOLEAN:
+			writeByte(lua_toboolean(L, idx) ? TAG_TRUE : TAG_FALSE);
+			break;
+		case LUA_TNUMBER:
+			writeNumber(idx);
+			break;
+		case LUA_TSTRING:
+			writeString(idx);
+			break;
+		case LUA_TTABLE:
+			writeTable(idx, depth);
+			break;
+		case LUA_TUSERDATA:
+		{
+			if (!luax_istype(L, idx, Data::type))
+				throw love::Exception("Cannot serialize a value of type %s.", luaL_typename(L, idx));
+
+			Data *data = luax_totype<Data>(L, idx);
+
+			writeByte(TAG_DATA);
+			writeVarint(data->getSize());
+			writeBytes((const char *) data->getData(), data->getSize());
+			break;
+		}
+		default:
+			throw love::Exception("Cannot serialize a value of type %s.", luaL_typename(L, idx));
+		}
+	}
+
+private:
+
+	void writeByte(uint8 b)
+	{
+		output.push_back((char) b);
+	}
+
+	void writeBytes(const char *bytes, size_t size)
+	{
+		output.insert(output.end(), bytes, bytes + size);
+	}
+
+	void writeVarint(uint64 x)
+	{
+		while (x >= 0x80)
+		{
+			writeByte((uint8) ((x & 0x7F) | 0x80));
+			x >>= 7;
+		}
+		writeByte((uint8) x);
+	}
+
+	void writeInteger(int64 x)
+	{
+		writeByte(TAG_INTEGER);
+		writeVarint(((uint64) x << 1) ^ (uint64) (x >> 63));
+	}
+
+	void writeNumber(int idx)
+	{
+#if LUA_VERSION_NUM >= 503
+		if (lua_isinteger(L, idx))
+			return writeInteger((int64) lua_tointeger(L, idx));
+#endif
+
+		double n = (double) lua_tonumber(L, idx);
+
+#if LUA_VERSION_NUM < 503
+		// Integral numbers are common (counts, IDs, coordinates), and are
+		// much smaller as varints. -0 has to keep its sign.
+		const double maxExact = 9007199254740992.0; // 2^53
+		if (n >= -maxExact && n <= maxExact && n == std::floor(n) && !(n == 0.0 && std::signbit(n)))
+			return writeInteger((int64) n);
+#endif
+
+		uint64 bits = 0;
+		memcpy(&bits, &n, sizeof(double));
+
+		writeByte(TAG_NUMBER);
+		for (int i = 0; i < 8; i++)
+			writeByte((uint8) (bits >> (i * 8)));
+	}
+
+	void writeString(int idx)
+	{
+		size_t len = 0;
+		const char *str = lua_tolstring(L, idx, &len);
+
+		auto result = strings.emplace(std::string(str, len), strings.size());
+		if (!result.second)
+		{
+			writeByte(TAG_STRING_REF);
+			writeVarint(result.first->second);
+			return;
+		}
+
+		writeByte(TAG_STRING);
+		writeVarint(len);
+		writeBytes(str, len);
+	}
+
+	void writeTable(int idx, int depth)
+	{
+		if (depth >= maxDepth)
+			throw love::Exception("Cannot serialize tables nested more than %d levels deep.", maxDepth);
+
+		if (!lua_checkstack(L, 3))
+			throw love::Exception("Out of Lua stack space.");
+
+		const void *table = lua_topointer(L, idx);
+		if (!tables.insert(table).second)
+			throw love::Exception("Cannot serialize a table which contains itself.");
+
+		size_t arraysize = luax_objlen(L, idx);
+
+		writeByte(TAG_TABLE);
+		writeVarint(arraysize);
+
+		for (size_t i = 1; i <= arraysize; i++)
+		{
+			lua_rawgeti(L, idx, (int) i);
+			writeValue(-1, depth + 1);
+			lua_pop(L, 1);
+		}
+
+		lua_pushnil(L);
+		while (lua_next(L, idx))
+		{
+			if (!isArrayKey(-2, arraysize))
+			{
+				writeValue(-2, depth + 1);
+				writeValue(-1, depth + 1);
+			}
+			lua_pop(L, 1);
+		}
+
+		writeByte(TAG_NIL);
+
+		tables.erase(table);
+	}
+
+	bool isArrayKey(int idx, size_t arraysize)
+	{
+		if (lua_type(L, idx) != LUA_TNUMBER)
+			return false;
+
+		lua_Number n = lua_tonumber(L, idx);
+		return n >= 1 && n <= (lua_Number) arraysize && n == std::floor(n);
+	}
+
+	lua_State *L;
+	std::vector<char> &output;
+
+	std::unordered_map<std::string, uint64> strings;
+	std::unordered_set<const void *> tables;
+
+}; // Writer
+
+class Reader
+{
+public:
+
+	Reader(lua_State *L, const char *data, size_t size)
+		: L(L)
+		, data(data)
+		, size(size)
+		, pos(0)
+	{}
+
+	void readValue(int depth)
+	{
+		uint8 tag = readByte();
+
+		switch (tag)
+		{
+		case TAG_NIL:
+			lua_pushnil(L);
+			break;
+		case TAG_FALSE:
+		case TAG_TRUE:
+			lua_pushboolean(L, tag == TAG_TRUE);
+			break;
+		case TAG_INTEGER:
+		{
+			uint64 z = readVarint();
+			int64 x = (int64) (z >> 1) ^ -(int64) (z & 1);
+#if LUA_VERSION_NUM >= 503
+			lua_pushinteger(L, (lua_Integer) x);
+#else
+			lua_pushnumber(L, (lua_Number) x);
+#endif
+			break;
+		}
+		case TAG_NUMBER:
+		{
+			const char *bytes = readBytes(8);
+			uint64 bits = 0;
+			for (int i = 0; i < 8; i++)
+				bits |= (uint64) (uint8) bytes[i] << (i * 8);
+
+			double n = 0.0;
+			memcpy(&n, &bits, sizeof(double));
+			lua_pushnumber(L, (lua_Number) n);
+			break;
+		}
+		case TAG_STRING:
+		{
+			size_t len = readSize();
+			const char *str = readBytes(len);
+			strings.emplace_back(str, len);
+			lua_pushlstring(L, str, len);
+			break;
+		}
+		case TAG_STRING_REF:
+		{
+			uint64 index = readVarint();
+			if (index >= strings.size())
+				throw love::Exception("Could not deserialize data: invalid string reference.");
+			lua_pushlstring(L, strings[index].first, strings[index].second);
+			break;
+		}
+		case TAG_TABLE:
+			readTable(depth);
+			break;
+		case TAG_DATA:
+		{
+			size_t len = readSize();
+			const char *bytes = readBytes(len);
+			ByteData *d = new ByteData(bytes, len);
+			luax_pushtype(L, d);
+			d->release();
+			break;
+		}
+		default:
+			throw love::Exception("Could not deserialize data: unknown value type.");
+		}
+	}
+
+	bool isFinished() const
+	{
+		return pos == size;
+	}
+
+private:
+
+	uint8 readByte()
+	{
+		return (uint8) *readBytes(1);
+	}
+
+	const char *readBytes(size_t count)
+	{
+		if (count > size - pos)
+			throw love::Exception("Could not deserialize data: unexpected end of data.");
+
+		const char *bytes = data + pos;
+		pos += count;
+		return bytes;
+	}
+
+	uint64 readVarint()
+	{
+		uint64 x = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			uint8 b = readByte();
+			x |= (uint64) (b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				return x;
+		}
+
+		throw love::Exception("Could not deserialize data: invalid integer.");
+	}
+
+	// Sizes and counts can't be larger than the rest of the data, which also
+	// keeps corrupt data from causing huge allocations.
+	size_t readSize()
+	{
+		uint64 x = readVarint();
+		if (x > (uint64) (size - pos))
+			throw love::Exception("Could not deserialize data: unexpected end of data.");
+		return (size_t) x;
+	}
+
+	void readTable(int depth)
+	{
+		if (depth >= maxDepth)
+			throw love::Exception("Could not deserialize data: tables are nested more than %d levels deep.", maxDepth);
+
+		if (!lua_checkstack(L, 4))
+			throw love::Exception("Out of Lua stack space.");
+
+		size_t arraysize = readSize();
+		lua_createtable(L, (int) arraysize, 0);
+
+		for (size_t i = 1; i <= arraysize; i++)
+		{
+			readValue(depth + 1);
+			lua_rawseti(L, -2, (int) i);
+		}
+
+		while (true)
+		{
+			readValue(depth + 1);
+
+			if (lua_isnil(L, -1))
+			{
+				lua_pop(L, 1);
+				break;
+			}
+
+			if (lua_type(L, -1) == LUA_TNUMBER && std::isnan((double) lua_tonumber(L, -1)))
+				throw love::Exception("Could not deserialize data: invalid table key.");
+
+			readValue(depth + 1);
+			lua_rawset(L, -3);
+		}
+	}
+
+	lua_State *L;
+
+	const char *data;
+	size_t size;
+	size_t pos;
+
+	std::vector<std::pair<const char *, size_t>> strings;
+
+}; // Reader
+
+} // anonymous namespace
+
+void serialize(lua_State *L, int idx, bool compress, std::vector<char> &output)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	output.clear();
+	output.insert(output.end(), magic, magic + sizeof(magic));
+	output.push_back((char) version);
+	output.push_back((char) (compress ? FLAG_COMPRESSED : 0));
+
+	Writer writer(L, output);
+	writer.writeValue(idx, 0);
+
+	if (compress)
+	{
+		Compressor *compressor = Compressor::getCompressor(Compressor::FORMAT_LZ4);
+		if (compressor == nullptr)
+			throw love::Exception("Invalid compression format.");
+
+		size_t compressedsize = 0;
+		char *cbytes = compressor->compress(Compressor::FORMAT_LZ4, output.data() + headerSize,
+		                                    output.size() - headerSize, -1, nullptr, compressedsize);
+
+		output.resize(headerSize);
+		output.insert(output.end(), cbytes, cbytes + compressedsize);
+		delete[] cbytes;
+	}
+}
+
+void deserialize(lua_State *L, const char *data, size_t size)
+{
+	if (size < headerSize || memcmp(data, magic, sizeof(magic)) != 0)
+		throw love::Exception("Could not deserialize data: not serialized data.");
+
+	if ((uint8) data[3] != version)
+		throw love::Exception("Could not deserialize data: unsupported version %d.", (int) (uint8) data[3]);
+
+	uint8 flags = (uint8) data[4];
+	const char *payload = data + headerSize;
+	size_t payloadsize = size - headerSize;
+
+	std::unique_ptr<char[]> rawbytes;
+
+	if (flags & FLAG_COMPRESSED)
+	{
+		Compressor *compressor = Compressor::getCompressor(Compressor::FORMAT_LZ4);
+		if (compressor == nullptr)
+			throw love::Exception("Invalid compression format.");
+
+		size_t rawsize = 0;
+		rawbytes.reset(compressor->decompress(Compressor::FORMAT_LZ4, payload, payloadsize, nullptr, rawsize));
+
+		payload = rawbytes.get();
+		payloadsize = rawsize;
+	}
+
+	int top = lua_gettop(L);
+	Reader reader(L, payload, payloadsize);
+
+	try
+	{
+		reader.readValue(0);
+		if (!reader.isFinished())
+			throw love::Exception("Could not deserialize data: unexpected data after the value.");
+	}
+	catch (love::Exception &)
+	{
+		lua_settop(L, top);
+		throw;
+	}
+}
+
+} // data
+} // love
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/runtime.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Serializes the value at the given stack index into a compact binary form.
+ * Supported values are nil, booleans, numbers, strings, LOVE Data objects and
+ * nested tables of those. Repeated strings are only stored once. Data objects
+ * are stored by value, and become ByteData when deserialized.
+ *
+ * @param[in] L The Lua state.
+ * @param[in] idx The stack index of the value to serialize.
+ * @param[in] compress Whether to compress the result with LZ4.
+ * @param[out] output The serialized bytes.
+ **/
+void serialize(lua_State *L, int idx, bool compress, std::vector<char> &output);
+
+/**
+ * Deserializes a value previously serialized with serialize, and pushes it
+ * onto the stack.
+ **/
+void deserialize(lua_State *L, const char *data, size_t size);
+
+} // data
+} // love
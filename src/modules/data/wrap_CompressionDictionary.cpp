@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionDictionary.h"
+#include "wrap_Data.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressionDictionary *luax_checkcompressiondictionary(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionDictionary>(L, idx);
+}
+
+CompressionDictionary *luax_optcompressiondictionary(lua_State *L, int idx)
+{
+	if (lua_isnoneornil(L, idx))
+		return nullptr;
+	return luax_checkcompressiondictionary(L, idx);
+}
+
+int w_CompressionDictionary_clone(lua_State *L)
+{
+	CompressionDictionary *t = luax_checkcompressiondictionary(L, 1), *c = nullptr;
+	luax_catchexcept(L, [&](){ c = t->clone(); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_CompressionDictionary_getID(lua_State *L)
+{
+	CompressionDictionary *t = luax_checkcompressiondictionary(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getID());
+	return 1;
+}
+
+static const luaL_Reg w_CompressionDictionary_functions[] =
+{
+	{ "clone", w_CompressionDictionary_clone },
+	{ "getID", w_CompressionDictionary_getID },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_compressiondictionary(lua_State *L)
+{
+	int ret = luax_register_type(L, &CompressionDictionary::type, w_Data_functions, w_CompressionDictionary_functions, nullptr);
+	love::data::luax_rundatawrapper(L, CompressionDictionary::type);
+	return ret;
+}
+
+} // data
+} // love
@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionStream.h"
+#include "wrap_DataModule.h"
+#include "ByteData.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace data
+{
+
+CompressionStream *luax_checkcompressionstream(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionStream>(L, idx);
+}
+
+static const char *luax_checkbytes(lua_State *L, int idx, size_t &size)
+{
+	if (lua_isstring(L, idx))
+		return luaL_checklstring(L, idx, &size);
+
+	Data *data = luax_checktype<Data>(L, idx);
+	size = data->getSize();
+	return (const char *) data->getData();
+}
+
+static void luax_pushbytes(lua_State *L, ContainerType ctype, const void *bytes, size_t size)
+{
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *d = nullptr;
+		luax_catchexcept(L, [&]() { d = new ByteData(bytes, size); });
+		luax_pushtype(L, d);
+		d->release();
+	}
+	else
+		lua_pushlstring(L, (const char *) bytes, size);
+}
+
+int w_CompressionStream_process(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	size_t size = 0;
+	const char *bytes = luax_checkbytes(L, 3, size);
+
+	CompressionStream::Flush flush = CompressionStream::FLUSH_NONE;
+	if (!lua_isnoneornil(L, 4))
+	{
+		const char *str = luaL_checkstring(L, 4);
+		if (!CompressionStream::getConstant(str, flush))
+			return luax_enumerror(L, "flush mode", CompressionStream::getConstants(flush), str);
+	}
+
+	const std::vector<uint8> *output = nullptr;
+	luax_catchexcept(L, [&]() { output = &s->process(bytes, size, flush); });
+
+	luax_pushbytes(L, ctype, output->data(), output->size());
+	return 1;
+}
+
+int w_CompressionStream_read(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+	int64 size = (int64) luaL_checknumber(L, 3);
+
+	std::vector<uint8> buffer((size_t) std::max(size, (int64) 0));
+	int64 count = 0;
+	luax_catchexcept(L, [&]() { count = s->read(buffer.data(), (int64) buffer.size()); });
+
+	luax_pushbytes(L, ctype, buffer.data(), (size_t) count);
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+int w_CompressionStream_write(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+
+	size_t size = 0;
+	const char *bytes = luax_checkbytes(L, 2, size);
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = s->write(bytes, (int64) size); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_CompressionStream_flush(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = s->flush(); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_CompressionStream_finish(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	luax_catchexcept(L, [&]() { s->finish(); });
+	return 0;
+}
+
+int w_CompressionStream_reset(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	s->reset();
+	return 0;
+}
+
+int w_CompressionStream_isFinished(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	luax_pushboolean(L, s->isFinished());
+	return 1;
+}
+
+int w_CompressionStream_getFormat(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	const char *str = nullptr;
+	if (!Compressor::getConstant(s->getFormat(), str))
+		return luaL_error(L, "Unknown compressed data format.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_CompressionStream_getMode(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	const char *str = nullptr;
+	if (!CompressionStream::getConstant(s->getMode(), str))
+		return luaL_error(L, "Unknown compression stream mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_CompressionStream_tell(lua_State *L)
+{
+	CompressionStream *s = luax_checkcompressionstream(L, 1);
+	lua_pushnumber(L, (lua_Number) s->tell());
+	return 1;
+}
+
+static const luaL_Reg w_CompressionStream_functions[] =
+{
+	{ "process", w_CompressionStream_process },
+	{ "read", w_CompressionStream_read },
+	{ "write", w_CompressionStream_write },
+	{ "flush", w_CompressionStream_flush },
+	{ "finish", w_CompressionStream_finish },
+	{ "reset", w_CompressionStream_reset },
+	{ "isFinished", w_CompressionStream_isFinished },
+	{ "getFormat", w_CompressionStream_getFormat },
+	{ "getMode", w_CompressionStream_getMode },
+	{ "tell", w_CompressionStream_tell },
+	{ 0, 0 }
+};
+
+int luaopen_compressionstream(lua_State *L)
+{
+	return luax_register_type(L, &CompressionStream::type, w_CompressionStream_functions, nullptr);
+}
+
+} // data
+} // love
@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_Data.h"
+#include "ResidentData.h"
 
 // Put the Lua code directly into a raw string literal.
 static const char data_lua[] =
@@ -35,6 +36,16 @@ Data *luax_checkdata(lua_State *L, int idx)
 	return luax_checktype<Data>(L, idx);
 }
 
+// Lua can hold on to a raw pointer indefinitely, so Data which is already
+// compressed while idle stays resident for good once its pointer is taken.
+// Enabling idle compression afterwards invalidates pointers taken before.
+static void pinForPointer(Data *data)
+{
+	auto resident = dynamic_cast<ResidentData *>(data);
+	if (resident != nullptr && resident->hasIdleCompression())
+		resident->pinResident();
+}
+
 int w_Data_getString(lua_State *L)
 {
 	Data *t = luax_checkdata(L, 1);
@@ -45,6 +56,7 @@ int w_Data_getString(lua_State *L)
 int w_Data_getPointer(lua_State *L)
 {
 	Data *t = luax_checkdata(L, 1);
+	pinForPointer(t);
 	lua_pushlightuserdata(L, t->getData());
 	return 1;
 }
@@ -74,7 +86,10 @@ static FFI_Data ffifuncs =
 	[](Proxy *p) -> void * // getFFIPointer
 	{
 		auto data = luax_ffi_checktype<Data>(p);
-		return data != nullptr ? data->getData() : nullptr;
+		if (data == nullptr)
+			return nullptr;
+		pinForPointer(data);
+		return data->getData();
 	}
 };
 
@@ -24,7 +24,13 @@
 #include "wrap_ByteData.h"
 #include "wrap_DataView.h"
 #include "wrap_CompressedData.h"
+#include "wrap_CompressionDictionary.h"
+#include "wrap_CompressionStream.h"
+#include "wrap_Hasher.h"
+#include "wrap_Encoder.h"
 #include "DataModule.h"
+#include "ResidentData.h"
+#include "Serializer.h"
 #include "common/b64.h"
 
 // Lua 5.3
@@ -136,8 +142,11 @@ int w_compress(lua_State *L)
 		rawbytes = (const char *) rawdata->getData();
 	}
 
+	CompressionDictionary *dictionary = luax_optcompressiondictionary(L, 5);
+	size_t blocksize = (size_t) luaL_optinteger(L, 6, 0);
+
 	CompressedData *cdata = nullptr;
-	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level); });
+	luax_catchexcept(L, [&](){ cdata = compress(format, rawbytes, rawsize, level, dictionary, blocksize); });
 
 	if (ctype == CONTAINER_DATA)
 		luax_pushtype(L, cdata);
@@ -148,6 +157,113 @@ int w_compress(lua_State *L)
 	return 1;
 }
 
+int w_compressIdle(lua_State *L)
+{
+	double seconds = luaL_checknumber(L, 1);
+
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *fstr = luaL_checkstring(L, 2);
+		if (!Compressor::getConstant(fstr, format))
+			return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+	}
+
+	int count = 0;
+	int64 savedbytes = 0;
+	luax_catchexcept(L, [&](){ ResidentData::compressIdle(seconds, format, count, savedbytes); });
+
+	lua_pushinteger(L, count);
+	lua_pushnumber(L, (lua_Number) savedbytes);
+	return 2;
+}
+
+int w_newCompressionDictionary(lua_State *L)
+{
+	CompressionDictionary *d = nullptr;
+
+	if (lua_istable(L, 1))
+	{
+		// Train a new dictionary from a table of sample strings or Data.
+		size_t maxsize = (size_t) luaL_optinteger(L, 2, 110 * 1024);
+
+		std::vector<StrongRef<Data>> samplerefs;
+		std::vector<Data *> samples;
+
+		int count = (int) luax_objlen(L, 1);
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 1, i);
+
+			Data *sample = nullptr;
+			if (lua_type(L, -1) == LUA_TSTRING)
+			{
+				size_t size = 0;
+				const char *str = lua_tolstring(L, -1, &size);
+				luax_catchexcept(L, [&]() { sample = instance()->newByteData(str, size); });
+				samplerefs.emplace_back(sample, Acquire::NORETAIN);
+			}
+			else
+				sample = luax_checktype<Data>(L, -1);
+
+			samples.push_back(sample);
+			lua_pop(L, 1);
+		}
+
+		luax_catchexcept(L, [&]() { d = CompressionDictionary::train(samples, maxsize); });
+	}
+	else
+	{
+		// Use existing dictionary contents, e.g. one that was saved to a file.
+		size_t size = 0;
+		const char *bytes = nullptr;
+
+		if (lua_type(L, 1) == LUA_TSTRING)
+			bytes = luaL_checklstring(L, 1, &size);
+		else
+		{
+			Data *data = luax_checktype<Data>(L, 1);
+			bytes = (const char *) data->getData();
+			size = data->getSize();
+		}
+
+		luax_catchexcept(L, [&]() { d = new CompressionDictionary(bytes, size); });
+	}
+
+	luax_pushtype(L, d);
+	d->release();
+	return 1;
+}
+
+int w_newCompressionStream(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	const char *mstr = luaL_checkstring(L, 2);
+	CompressionStream::Mode mode = CompressionStream::MODE_COMPRESS;
+
+	if (!CompressionStream::getConstant(mstr, mode))
+		return luax_enumerror(L, "compression stream mode", CompressionStream::getConstants(mode), mstr);
+
+	int level = (int) luaL_optinteger(L, 3, -1);
+
+	Stream *target = nullptr;
+	if (!lua_isnoneornil(L, 4))
+		target = luax_checktype<Stream>(L, 4);
+
+	CompressionDictionary *dictionary = luax_optcompressiondictionary(L, 5);
+
+	CompressionStream *s = nullptr;
+	luax_catchexcept(L, [&]() { s = instance()->newCompressionStream(format, mode, level, target, dictionary); });
+	luax_pushtype(L, s);
+	s->release();
+	return 1;
+}
+
 int w_decompress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -158,8 +274,9 @@ int w_decompress(lua_State *L)
 	if (luax_istype(L, 2, CompressedData::type))
 	{
 		CompressedData *data = luax_checkcompresseddata(L, 2);
+		CompressionDictionary *dictionary = luax_optcompressiondictionary(L, 3);
 		rawsize = data->getDecompressedSize();
-		luax_catchexcept(L, [&](){ rawbytes = decompress(data, rawsize); });
+		luax_catchexcept(L, [&](){ rawbytes = decompress(data, rawsize, dictionary); });
 	}
 	else
 	{
@@ -181,7 +298,8 @@ int w_decompress(lua_State *L)
 		else
 			cbytes = luaL_checklstring(L, 3, &compressedsize);
 
-		luax_catchexcept(L, [&](){ rawbytes = decompress(format, cbytes, compressedsize, rawsize); });
+		CompressionDictionary *dictionary = luax_optcompressiondictionary(L, 4);
+		luax_catchexcept(L, [&](){ rawbytes = decompress(format, cbytes, compressedsize, rawsize, dictionary); });
 	}
 
 	if (ctype == CONTAINER_DATA)
@@ -324,6 +442,127 @@ int w_hash(lua_State *L)
 	return 1;
 }
 
+int w_hashMultiple(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	HashFunction::Function function;
+	if (!HashFunction::getConstant(fstr, function))
+		return luax_enumerror(L, "hash function", HashFunction::getConstants(function), fstr);
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	int count = (int) luax_objlen(L, 2);
+
+	// Strings and Data stay referenced by the table while they're hashed.
+	std::vector<std::pair<const char *, uint64>> inputs;
+	inputs.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		if (lua_type(L, -1) == LUA_TSTRING)
+		{
+			size_t size = 0;
+			const char *str = lua_tolstring(L, -1, &size);
+			inputs.emplace_back(str, size);
+		}
+		else if (luax_istype(L, -1, Data::type))
+		{
+			Data *data = luax_totype<Data>(L, -1);
+			inputs.emplace_back((const char *) data->getData(), data->getSize());
+		}
+		else
+			return luaL_error(L, "Expected a string or Data at index %d.", i);
+		lua_pop(L, 1);
+	}
+
+	std::vector<HashFunction::Value> outputs;
+	luax_catchexcept(L, [&](){ love::data::hashMultiple(function, inputs, outputs); });
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushlstring(L, outputs[i].data, outputs[i].size);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_newHasher(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	HashFunction::Function function;
+	if (!HashFunction::getConstant(fstr, function))
+		return luax_enumerror(L, "hash function", HashFunction::getConstants(function), fstr);
+
+	Hasher *h = nullptr;
+	luax_catchexcept(L, [&]() { h = instance()->newHasher(function); });
+	luax_pushtype(L, h);
+	h->release();
+	return 1;
+}
+
+int w_newEncoder(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	EncodeFormat format;
+	if (!getConstant(fstr, format))
+		return luax_enumerror(L, "encode format", getConstants(format), fstr);
+
+	const char *mstr = luaL_checkstring(L, 2);
+	Encoder::Mode mode;
+	if (!Encoder::getConstant(mstr, mode))
+		return luax_enumerror(L, "encoder mode", Encoder::getConstants(mode), mstr);
+
+	size_t linelen = (size_t) luaL_optinteger(L, 3, 0);
+
+	Encoder *e = nullptr;
+	luax_catchexcept(L, [&]() { e = instance()->newEncoder(format, mode, linelen); });
+	luax_pushtype(L, e);
+	e->release();
+	return 1;
+}
+
+int w_serialize(lua_State *L)
+{
+	ContainerType ctype = luax_checkcontainertype(L, 1);
+	luaL_checkany(L, 2);
+	bool compress = luax_optboolean(L, 3, false);
+
+	std::vector<char> bytes;
+	luax_catchexcept(L, [&]() { serialize(L, 2, compress, bytes); });
+
+	if (ctype == CONTAINER_DATA)
+	{
+		Data *d = nullptr;
+		luax_catchexcept(L, [&]() { d = instance()->newByteData(bytes.data(), bytes.size()); });
+		luax_pushtype(L, Data::type, d);
+		d->release();
+	}
+	else
+		lua_pushlstring(L, bytes.data(), bytes.size());
+
+	return 1;
+}
+
+int w_deserialize(lua_State *L)
+{
+	size_t size = 0;
+	const char *data = nullptr;
+
+	if (lua_type(L, 1) == LUA_TSTRING)
+		data = lua_tolstring(L, 1, &size);
+	else
+	{
+		Data *d = luax_checktype<Data>(L, 1);
+		data = (const char *) d->getData();
+		size = d->getSize();
+	}
+
+	luax_catchexcept(L, [&]() { deserialize(L, data, size); });
+	return 1;
+}
+
 int w_pack(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -373,13 +612,21 @@ static const luaL_Reg functions[] =
 	{ "newByteData", w_newByteData },
 	{ "compress", w_compress },
 	{ "decompress", w_decompress },
+	{ "compressIdle", w_compressIdle },
+	{ "newCompressionStream", w_newCompressionStream },
+	{ "newCompressionDictionary", w_newCompressionDictionary },
 	{ "encode", w_encode },
 	{ "decode", w_decode },
 	{ "hash", w_hash },
+	{ "hashMultiple", w_hashMultiple },
+	{ "newHasher", w_newHasher },
+	{ "newEncoder", w_newEncoder },
 
 	{ "pack", w_pack },
 	{ "unpack", w_unpack },
 	{ "getPackedSize", lua53_str_packsize },
+	{ "serialize", w_serialize },
+	{ "deserialize", w_deserialize },
 
 	{ 0, 0 }
 };
@@ -390,6 +637,10 @@ static const lua_CFunction types[] =
 	luaopen_bytedata,
 	luaopen_dataview,
 	luaopen_compresseddata,
+	luaopen_compressiondictionary,
+	luaopen_compressionstream,
+	luaopen_hasher,
+	luaopen_encoder,
 	nullptr
 };
 
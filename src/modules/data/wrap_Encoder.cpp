@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_Encoder.h"
+#include "wrap_DataModule.h"
+
+namespace love
+{
+namespace data
+{
+
+Encoder *luax_checkencoder(lua_State *L, int idx)
+{
+	return luax_checktype<Encoder>(L, idx);
+}
+
+int w_Encoder_update(lua_State *L)
+{
+	Encoder *e = luax_checkencoder(L, 1);
+
+	size_t size = 0;
+	const void *input = nullptr;
+
+	if (lua_isstring(L, 2))
+		input = luaL_checklstring(L, 2, &size);
+	else
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		input = data->getData();
+		size = data->getSize();
+	}
+
+	std::vector<char> output;
+	luax_catchexcept(L, [&]() { e->update(input, size, output); });
+
+	lua_pushlstring(L, output.data(), output.size());
+	return 1;
+}
+
+int w_Encoder_finish(lua_State *L)
+{
+	Encoder *e = luax_checkencoder(L, 1);
+
+	std::vector<char> output;
+	luax_catchexcept(L, [&]() { e->finish(output); });
+
+	lua_pushlstring(L, output.data(), output.size());
+	return 1;
+}
+
+int w_Encoder_reset(lua_State *L)
+{
+	Encoder *e = luax_checkencoder(L, 1);
+	e->reset();
+	return 0;
+}
+
+int w_Encoder_getFormat(lua_State *L)
+{
+	Encoder *e = luax_checkencoder(L, 1);
+	const char *str = nullptr;
+	if (!getConstant(e->getFormat(), str))
+		return luaL_error(L, "Unknown encode format.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Encoder_getMode(lua_State *L)
+{
+	Encoder *e = luax_checkencoder(L, 1);
+	const char *str = nullptr;
+	if (!Encoder::getConstant(e->getMode(), str))
+		return luaL_error(L, "Unknown encoder mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+static const luaL_Reg w_Encoder_functions[] =
+{
+	{ "update", w_Encoder_update },
+	{ "finish", w_Encoder_finish },
+	{ "reset", w_Encoder_reset },
+	{ "getFormat", w_Encoder_getFormat },
+	{ "getMode", w_Encoder_getMode },
+	{ 0, 0 }
+};
+
+int luaopen_encoder(lua_State *L)
+{
+	return luax_register_type(L, &Encoder::type, w_Encoder_functions, nullptr);
+}
+
+} // data
+} // love
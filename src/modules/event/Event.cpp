@@ -19,6 +19,10 @@
  **/
 
 #include "Event.h"
+#include "thread/LockFreeQueue.h"
+
+// C++
+#include <set>
 
 using love::thread::Mutex;
 using love::thread::Lock;
@@ -28,16 +32,142 @@ namespace love
 namespace event
 {
 
+// Upper bound on the number of freed Messages kept around for reuse.
+static const size_t MESSAGE_POOL_CAPACITY = 1024;
+
+static love::thread::LockFreeQueue<void *> &getMessagePool()
+{
+	// Never destroyed, so Messages released during shutdown stay safe.
+	static auto *pool = new love::thread::LockFreeQueue<void *>(MESSAGE_POOL_CAPACITY);
+	return *pool;
+}
+
 Message::Message(const std::string &name, const std::vector<Variant> &vargs)
-	: name(name)
-	, args(vargs)
+	: name(internName(name.c_str()))
+	, argCount(0)
+{
+	setArgs(vargs.data(), vargs.size());
+}
+
+Message::Message(const char *name, const std::vector<Variant> &vargs)
+	: name(internName(name))
+	, argCount(0)
 {
+	setArgs(vargs.data(), vargs.size());
 }
 
 Message::~Message()
 {
 }
 
+void Message::setArgs(const Variant *vargs, size_t count)
+{
+	argCount = count;
+
+	for (size_t i = 0; i < count && i < MAX_INLINE_ARGS; i++)
+		inlineArgs[i] = vargs[i];
+
+	if (count > MAX_INLINE_ARGS)
+		extraArgs.assign(vargs + MAX_INLINE_ARGS, vargs + count);
+}
+
+void *Message::operator new(size_t size)
+{
+	void *mem = nullptr;
+	if (size == sizeof(Message) && getMessagePool().pop(mem))
+		return mem;
+
+	return ::operator new(size);
+}
+
+void Message::operator delete(void *mem, size_t size)
+{
+	size_t position = 0;
+	if (mem == nullptr || (size == sizeof(Message) && getMessagePool().push(mem, position)))
+		return;
+
+	::operator delete(mem);
+}
+
+const char *Message::internName(const char *name)
+{
+	// Event names come from a small, mostly fixed set, so they're kept
+	// forever. std::less<> lets us look them up without making a string.
+	static auto *names = new std::set<std::string, std::less<>>();
+	static auto *mutex = new love::thread::MutexRef();
+
+	Lock lock(*mutex);
+
+	auto it = names->find(name);
+	if (it == names->end())
+		it = names->emplace(name).first;
+
+	return it->c_str();
+}
+
+static bool variantEquals(const Variant &a, const Variant &b)
+{
+	Variant::Type atype = a.getType() == Variant::SMALLSTRING ? Variant::STRING : a.getType();
+	Variant::Type btype = b.getType() == Variant::SMALLSTRING ? Variant::STRING : b.getType();
+
+	if (atype != btype)
+		return false;
+
+	const Variant::Data &ad = a.getData();
+	const Variant::Data &bd = b.getData();
+
+	switch (a.getType())
+	{
+	case Variant::BOOLEAN:
+		return ad.boolean == bd.boolean;
+	case Variant::NUMBER:
+		return ad.number == bd.number;
+	case Variant::STRING:
+	case Variant::SMALLSTRING:
+	{
+		const char *astr = a.getType() == Variant::STRING ? ad.string->str : ad.smallstring.str;
+		size_t alen = a.getType() == Variant::STRING ? ad.string->len : ad.smallstring.len;
+		const char *bstr = b.getType() == Variant::STRING ? bd.string->str : bd.smallstring.str;
+		size_t blen = b.getType() == Variant::STRING ? bd.string->len : bd.smallstring.len;
+		return alen == blen && memcmp(astr, bstr, alen) == 0;
+	}
+	case Variant::LUSERDATA:
+		return ad.userdata == bd.userdata;
+	case Variant::LOVEOBJECT:
+		return ad.objectproxy.object == bd.objectproxy.object;
+	case Variant::NIL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+Event::Event()
+	: keyInputCaptured(false)
+	, keyInputs(MAX_KEY_INPUTS)
+{
+	const CoalesceRule rules[] =
+	{
+		// x, y, dx, dy, istouch
+		{ "mousemoved", { 4, -1 }, { 2, 3 }, false, false, {} },
+		// id, x, y, dx, dy, pressure
+		{ "touchmoved", { 0, -1 }, { 3, 4 }, false, false, {} },
+		// joystick, axis, value
+		{ "joystickaxis", { 0, 1 }, { -1, -1 }, false, false, {} },
+		{ "gamepadaxis", { 0, 1 }, { -1, -1 }, false, false, {} },
+		// sensor type, x, y, z
+		{ "sensorupdated", { 0, -1 }, { -1, -1 }, false, false, {} },
+		// joystick, sensor type, x, y, z
+		{ "joysticksensorupdated", { 0, 1 }, { -1, -1 }, false, false, {} },
+	};
+
+	for (const CoalesceRule &rule : rules)
+	{
+		coalesceRules.push_back(rule);
+		coalesceRules.back().name = Message::internName(rule.name);
+	}
+}
+
 Event::~Event()
 {
 }
@@ -45,10 +175,149 @@ Event::~Event()
 void Event::push(Message *msg)
 {
 	Lock lock(mutex);
+
+	if (coalesce(msg))
+		return;
+
 	msg->retain();
 	queue.push(msg);
 }
 
+Event::CoalesceRule *Event::getCoalesceRule(const char *name)
+{
+	for (CoalesceRule &rule : coalesceRules)
+	{
+		if (strcmp(rule.name, name) == 0)
+			return &rule;
+	}
+	return nullptr;
+}
+
+const Event::CoalesceRule *Event::getCoalesceRule(const char *name) const
+{
+	return const_cast<Event *>(this)->getCoalesceRule(name);
+}
+
+bool Event::coalesce(Message *msg)
+{
+	// Names are interned, so pointer comparisons are enough here.
+	CoalesceRule *rule = nullptr;
+	for (CoalesceRule &r : coalesceRules)
+	{
+		if (r.name == msg->name)
+		{
+			rule = &r;
+			break;
+		}
+	}
+
+	if (rule == nullptr || !rule->enabled)
+		return false;
+
+	if (rule->keepHistory)
+	{
+		if (rule->history.size() >= MAX_COALESCED_HISTORY)
+			rule->history.pop_front();
+		rule->history.emplace_back(msg);
+	}
+
+	if (queue.empty())
+		return false;
+
+	Message *last = queue.back();
+	if (last->name != msg->name || last->getArgCount() != msg->getArgCount())
+		return false;
+
+	for (int arg : rule->keyArgs)
+	{
+		if (arg >= 0 && (size_t) arg < msg->getArgCount() && !variantEquals(last->getArg(arg), msg->getArg(arg)))
+			return false;
+	}
+
+	std::vector<Variant> args;
+	args.reserve(msg->getArgCount());
+	for (size_t i = 0; i < msg->getArgCount(); i++)
+		args.push_back(msg->getArg(i));
+
+	for (int arg : rule->deltaArgs)
+	{
+		if (arg < 0 || (size_t) arg >= msg->getArgCount())
+			continue;
+
+		const Variant &a = last->getArg(arg);
+		const Variant &b = msg->getArg(arg);
+		if (a.getType() == Variant::NUMBER && b.getType() == Variant::NUMBER)
+			args[arg] = Variant(a.getData().number + b.getData().number);
+	}
+
+	queue.back() = new Message(msg->name, args);
+	last->release();
+
+	return true;
+}
+
+bool Event::setCoalesced(const char *name, bool enable, bool keephistory)
+{
+	Lock lock(mutex);
+
+	CoalesceRule *rule = getCoalesceRule(name);
+	if (rule == nullptr)
+		return false;
+
+	rule->enabled = enable;
+	rule->keepHistory = enable && keephistory;
+	if (!rule->keepHistory)
+		rule->history.clear();
+
+	return true;
+}
+
+bool Event::isCoalesced(const char *name) const
+{
+	Lock lock(mutex);
+	const CoalesceRule *rule = getCoalesceRule(name);
+	return rule != nullptr && rule->enabled;
+}
+
+void Event::getCoalescedHistory(const char *name, std::vector<StrongRef<Message>> &history)
+{
+	Lock lock(mutex);
+
+	history.clear();
+
+	CoalesceRule *rule = getCoalesceRule(name);
+	if (rule == nullptr)
+		return;
+
+	history.assign(rule->history.begin(), rule->history.end());
+	rule->history.clear();
+}
+
+void Event::setKeyInputCaptured(bool enable)
+{
+	keyInputCaptured.store(enable);
+}
+
+bool Event::isKeyInputCaptured() const
+{
+	return keyInputCaptured.load();
+}
+
+void Event::pollKeyInput(std::vector<KeyInput> &inputs)
+{
+	inputs.clear();
+
+	KeyInput input;
+	while (keyInputs.pop(input))
+		inputs.push_back(input);
+}
+
+void Event::pushKeyInput(KeyInput &input)
+{
+	size_t position = 0;
+	keyInputs.push(input, position);
+}
+
 bool Event::poll(Message *&msg)
 {
 	Lock lock(mutex);
@@ -29,8 +29,11 @@
 #include "mouse/Mouse.h"
 #include "joystick/Joystick.h"
 #include "thread/threads.h"
+#include "thread/LockFreeQueue.h"
 
 // C++
+#include <atomic>
+#include <deque>
 #include <queue>
 #include <vector>
 
@@ -43,17 +46,48 @@ class Message : public Object
 {
 public:
 
+	// Messages with up to this many arguments store them inline.
+	static const size_t MAX_INLINE_ARGS = 8;
+
 	Message(const std::string &name, const std::vector<Variant> &vargs = {});
+	Message(const char *name, const std::vector<Variant> &vargs = {});
 	~Message();
 
-	const std::string name;
-	const std::vector<Variant> args;
+	// Messages are recycled through a free list instead of the general heap,
+	// since input devices can create thousands of them per second.
+	static void *operator new(size_t size);
+	static void operator delete(void *mem, size_t size);
+
+	size_t getArgCount() const { return argCount; }
+
+	const Variant &getArg(size_t i) const
+	{
+		return i < MAX_INLINE_ARGS ? inlineArgs[i] : extraArgs[i - MAX_INLINE_ARGS];
+	}
+
+	/**
+	 * Gets the shared copy of an event name. The returned string stays valid
+	 * until the program exits.
+	 **/
+	static const char *internName(const char *name);
+
+	// Interned, see internName.
+	const char * const name;
+
+private:
+
+	void setArgs(const Variant *vargs, size_t count);
+
+	size_t argCount;
+	Variant inlineArgs[MAX_INLINE_ARGS];
+	std::vector<Variant> extraArgs;
 
 }; // Message
 
 class Event : public Module
 {
 public:
+	Event();
 	virtual ~Event();
 
 	// Implements Module.
@@ -66,10 +100,99 @@ public:
 	virtual void pump() = 0;
 	virtual Message *wait() = 0;
 
+	/**
+	 * Enables or disables coalescing for a high-frequency event type. When
+	 * enabled, an event pushed directly after another one of the same type
+	 * and source replaces it, and its deltas are accumulated. Optionally the
+	 * unmerged events are kept, see getCoalescedHistory.
+	 * @return False if the event type can't be coalesced.
+	 **/
+	bool setCoalesced(const char *name, bool enable, bool keephistory);
+	bool isCoalesced(const char *name) const;
+
+	/**
+	 * Gets the raw events of a coalesced type pushed since the last call, and
+	 * clears them.
+	 **/
+	void getCoalescedHistory(const char *name, std::vector<StrongRef<Message>> &history);
+
+	// Maximum number of raw events kept per coalesced event type.
+	static const size_t MAX_COALESCED_HISTORY = 1024;
+
+	// A key press, key release or text input, see setKeyInputCaptured.
+	struct KeyInput
+	{
+		enum Type
+		{
+			TYPE_KEY_PRESSED,
+			TYPE_KEY_RELEASED,
+			TYPE_TEXT_INPUT,
+		};
+
+		Type type;
+		love::keyboard::Keyboard::Key key;
+		love::keyboard::Keyboard::Scancode scancode;
+		bool isRepeat;
+
+		// When the input happened, in seconds on love.timer's clock.
+		double time;
+
+		// The UTF-8 text of text input.
+		char text[32];
+	};
+
+	/**
+	 * Enables or disables capturing key and text input. While enabled,
+	 * keypressed, keyreleased and textinput events don't go through the
+	 * message queue. They are stored as soon as the system reports them, for
+	 * pollKeyInput.
+	 **/
+	void setKeyInputCaptured(bool enable);
+	bool isKeyInputCaptured() const;
+
+	/**
+	 * Moves the key input captured since the last call into inputs, oldest
+	 * first.
+	 **/
+	void pollKeyInput(std::vector<KeyInput> &inputs);
+
+	// Maximum number of captured key inputs kept until pollKeyInput. Newer
+	// ones are dropped when it's full.
+	static const size_t MAX_KEY_INPUTS = 512;
+
 protected:
+
+	void pushKeyInput(KeyInput &input);
+
+	struct CoalesceRule
+	{
+		const char *name;
+
+		// Arguments which must be equal for two events to be merged.
+		int keyArgs[2];
+
+		// Arguments which are summed when two events are merged.
+		int deltaArgs[2];
+
+		bool enabled;
+		bool keepHistory;
+		std::deque<StrongRef<Message>> history;
+	};
+
+	CoalesceRule *getCoalesceRule(const char *name);
+	const CoalesceRule *getCoalesceRule(const char *name) const;
+
+	// Merges msg into the last queued message, if possible.
+	bool coalesce(Message *msg);
+
 	love::thread::MutexRef mutex;
 	std::queue<Message *> queue;
 
+	std::vector<CoalesceRule> coalesceRules;
+
+	std::atomic<bool> keyInputCaptured;
+	love::thread::LockFreeQueue<KeyInput> keyInputs;
+
 }; // Event
 
 } // event
@@ -77,7 +77,7 @@ static void normalizedToDPICoords(double *x, double *y)
 // SDL's event watch callbacks trigger when the event is actually posted inside
 // SDL, unlike with SDL_PollEvents. This is useful for some events which require
 // handling inside the function which triggered them on some backends.
-static int SDLCALL watchAppEvents(void * /*udata*/, SDL_Event *event)
+static int SDLCALL watchAppEvents(void *udata, SDL_Event *event)
 {
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 
@@ -91,6 +91,12 @@ static int SDLCALL watchAppEvents(void * /*udata*/, SDL_Event *event)
 		if (gfx)
 			gfx->setActive(event->type == SDL_APP_WILLENTERFOREGROUND);
 		break;
+	// Captured key input is delivered without waiting for the event queue.
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+	case SDL_TEXTINPUT:
+		((Event *) udata)->captureKeyInput(*event);
+		break;
 	default:
 		break;
 	}
@@ -134,6 +140,46 @@ void Event::pump()
 	}
 }
 
+void Event::captureKeyInput(const SDL_Event &e)
+{
+	if (!isKeyInputCaptured())
+		return;
+
+	KeyInput input = {};
+	input.key = love::keyboard::Keyboard::KEY_UNKNOWN;
+	input.scancode = love::keyboard::Keyboard::SCANCODE_UNKNOWN;
+
+	if (e.type == SDL_TEXTINPUT)
+	{
+		input.type = KeyInput::TYPE_TEXT_INPUT;
+		SDL_strlcpy(input.text, e.text.text, sizeof(input.text));
+	}
+	else
+	{
+		if (e.type == SDL_KEYDOWN && e.key.repeat)
+		{
+			auto kb = Module::getInstance<love::keyboard::Keyboard>(Module::M_KEYBOARD);
+			if (kb && !kb->hasKeyRepeat())
+				return;
+		}
+
+		input.type = e.type == SDL_KEYDOWN ? KeyInput::TYPE_KEY_PRESSED : KeyInput::TYPE_KEY_RELEASED;
+		input.isRepeat = e.key.repeat != 0;
+
+		auto keyit = keys.find(e.key.keysym.sym);
+		if (keyit != keys.end())
+			input.key = keyit->second;
+
+		love::keyboard::sdl::Keyboard::getConstant(e.key.keysym.scancode, input.scancode);
+	}
+
+	// SDL timestamps are in milliseconds since SDL was initialized.
+	Uint32 age = SDL_GetTicks() - e.common.timestamp;
+	input.time = love::timer::Timer::getTime() - (double) age / 1000.0;
+
+	pushKeyInput(input);
+}
+
 Message *Event::wait()
 {
 	exceptionIfInRenderPass("love.event.wait");
@@ -175,8 +221,7 @@ Message *Event::convert(const SDL_Event &e)
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	vargs.clear();
 
 	love::filesystem::Filesystem *filesystem = nullptr;
 	love::sensor::Sensor *sensorInstance = nullptr;
@@ -196,6 +241,9 @@ Message *Event::convert(const SDL_Event &e)
 	switch (e.type)
 	{
 	case SDL_KEYDOWN:
+		if (isKeyInputCaptured())
+			break;
+
 		if (e.key.repeat)
 		{
 			auto kb = Module::getInstance<love::keyboard::Keyboard>(Module::M_KEYBOARD);
@@ -220,6 +268,9 @@ Message *Event::convert(const SDL_Event &e)
 		msg = new Message("keypressed", vargs);
 		break;
 	case SDL_KEYUP:
+		if (isKeyInputCaptured())
+			break;
+
 		keyit = keys.find(e.key.keysym.sym);
 		if (keyit != keys.end())
 			key = keyit->second;
@@ -236,6 +287,9 @@ Message *Event::convert(const SDL_Event &e)
 		msg = new Message("keyreleased", vargs);
 		break;
 	case SDL_TEXTINPUT:
+		if (isKeyInputCaptured())
+			break;
+
 		txt = e.text.text;
 		vargs.emplace_back(txt, strlen(txt));
 		msg = new Message("textinput", vargs);
@@ -434,7 +488,7 @@ Message *Event::convert(const SDL_Event &e)
 #endif
 	case SDL_SENSORUPDATE:
 		sensorInstance = Module::getInstance<sensor::Sensor>(M_SENSOR);
-		if (sensorInstance)
+		if (sensorInstance && sensorInstance->areEventsEnabled())
 		{
 			std::vector<void*> sensors = sensorInstance->getHandles();
 
@@ -470,7 +524,7 @@ Message *Event::convert(const SDL_Event &e)
 	return msg;
 }
 
-Message *Event::convertJoystickEvent(const SDL_Event &e) const
+Message *Event::convertJoystickEvent(const SDL_Event &e)
 {
 	auto joymodule = Module::getInstance<joystick::JoystickModule>(Module::M_JOYSTICK);
 	if (!joymodule)
@@ -478,8 +532,7 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	vargs.clear();
 
 	love::Type *joysticktype = &love::joystick::Joystick::type;
 	love::joystick::Joystick *stick = nullptr;
@@ -492,6 +545,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 	{
 	case SDL_JOYBUTTONDOWN:
 	case SDL_JOYBUTTONUP:
+		if (!joymodule->areEventsEnabled(joystick::Joystick::INPUT_TYPE_BUTTON))
+			break;
+
 		stick = joymodule->getJoystickFromID(e.jbutton.which);
 		if (!stick)
 			break;
@@ -504,6 +560,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		break;
 	case SDL_JOYAXISMOTION:
 		{
+			if (!joymodule->areEventsEnabled(joystick::Joystick::INPUT_TYPE_AXIS))
+				break;
+
 			stick = joymodule->getJoystickFromID(e.jaxis.which);
 			if (!stick)
 				break;
@@ -516,6 +575,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		}
 		break;
 	case SDL_JOYHATMOTION:
+		if (!joymodule->areEventsEnabled(joystick::Joystick::INPUT_TYPE_HAT))
+			break;
+
 		if (!joystick::sdl::Joystick::getConstant(e.jhat.value, hat) || !joystick::Joystick::getConstant(hat, txt))
 			break;
 
@@ -530,6 +592,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		break;
 	case SDL_CONTROLLERBUTTONDOWN:
 	case SDL_CONTROLLERBUTTONUP:
+		if (!joymodule->areEventsEnabled(joystick::Joystick::INPUT_TYPE_BUTTON))
+			break;
+
 		if (!joystick::sdl::Joystick::getConstant((SDL_GameControllerButton) e.cbutton.button, padbutton))
 			break;
 
@@ -546,6 +611,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 						  "gamepadpressed" : "gamepadreleased", vargs);
 		break;
 	case SDL_CONTROLLERAXISMOTION:
+		if (!joymodule->areEventsEnabled(joystick::Joystick::INPUT_TYPE_AXIS))
+			break;
+
 		if (joystick::sdl::Joystick::getConstant((SDL_GameControllerAxis) e.caxis.axis, padaxis))
 		{
 			if (!joystick::Joystick::getConstant(padaxis, txt))
@@ -583,6 +651,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		break;
 #if SDL_VERSION_ATLEAST(2, 0, 14) && defined(LOVE_ENABLE_SENSOR)
 	case SDL_CONTROLLERSENSORUPDATE:
+		if (!joymodule->areSensorEventsEnabled())
+			break;
+
 		stick = joymodule->getJoystickFromID(e.csensor.which);
 		if (stick)
 		{
@@ -613,8 +684,7 @@ Message *Event::convertWindowEvent(const SDL_Event &e)
 {
 	Message *msg = nullptr;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+	vargs.clear();
 
 	window::Window *win = nullptr;
 	graphics::Graphics *gfx = nullptr;
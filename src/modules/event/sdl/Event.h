@@ -67,17 +67,26 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * Stores a key or text input event if key input is being captured. Called
+	 * from the SDL event watch, as soon as SDL receives the event.
+	 **/
+	void captureKeyInput(const SDL_Event &e);
+
 private:
 
 	void exceptionIfInRenderPass(const char *name);
 
 	Message *convert(const SDL_Event &e);
-	Message *convertJoystickEvent(const SDL_Event &e) const;
+	Message *convertJoystickEvent(const SDL_Event &e);
 	Message *convertWindowEvent(const SDL_Event &e);
 
 	static std::map<SDL_Keycode, love::keyboard::Keyboard::Key> createKeyMap();
 	static std::map<SDL_Keycode, love::keyboard::Keyboard::Key> keys;
 
+	// Reused by the convert functions, to avoid allocating for every event.
+	std::vector<Variant> vargs;
+
 }; // Event
 
 } // sdl
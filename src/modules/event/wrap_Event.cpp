@@ -40,12 +40,12 @@ namespace event
 
 static int luax_pushmessage(lua_State *L, const Message &m)
 {
-	luax_pushstring(L, m.name);
+	lua_pushstring(L, m.name);
 
-	for (const Variant &v : m.args)
-		luax_pushvariant(L, v);
+	for (size_t i = 0; i < m.getArgCount(); i++)
+		luax_pushvariant(L, m.getArg(i));
 
-	return (int) m.args.size() + 1;
+	return (int) m.getArgCount() + 1;
 }
 
 static int w_poll_i(lua_State *L)
@@ -148,6 +148,117 @@ int w_restart(lua_State *L)
 	return 1;
 }
 
+int w_setCoalesced(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	bool history = luax_optboolean(L, 3, false);
+
+	if (!instance()->setCoalesced(name, enable, history))
+		return luaL_error(L, "The '%s' event cannot be coalesced.", name);
+
+	return 0;
+}
+
+int w_isCoalesced(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	luax_pushboolean(L, instance()->isCoalesced(name));
+	return 1;
+}
+
+int w_getCoalescedHistory(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+
+	std::vector<StrongRef<Message>> history;
+	instance()->getCoalescedHistory(name, history);
+
+	lua_createtable(L, (int) history.size(), 0);
+	for (int i = 0; i < (int) history.size(); i++)
+	{
+		const Message *m = history[i].get();
+
+		lua_createtable(L, (int) m->getArgCount(), 0);
+		for (size_t j = 0; j < m->getArgCount(); j++)
+		{
+			luax_pushvariant(L, m->getArg(j));
+			lua_rawseti(L, -2, (int) j + 1);
+		}
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_setKeyInputCaptured(lua_State *L)
+{
+	instance()->setKeyInputCaptured(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isKeyInputCaptured(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isKeyInputCaptured());
+	return 1;
+}
+
+int w_pollKeyInput(lua_State *L)
+{
+	// Five values per input, in a flat table so one can be reused every frame:
+	// event name, key or text, scancode or false, isrepeat, time.
+	const int stride = 5;
+
+	std::vector<Event::KeyInput> inputs;
+	instance()->pollKeyInput(inputs);
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, (int) inputs.size() * stride, 0);
+
+	for (int i = 0; i < (int) inputs.size(); i++)
+	{
+		const Event::KeyInput &input = inputs[i];
+		const char *str = nullptr;
+		int index = i * stride;
+
+		if (input.type == Event::KeyInput::TYPE_TEXT_INPUT)
+		{
+			lua_pushstring(L, "textinput");
+			lua_rawseti(L, -2, index + 1);
+			lua_pushstring(L, input.text);
+			lua_rawseti(L, -2, index + 2);
+			lua_pushboolean(L, 0);
+			lua_rawseti(L, -2, index + 3);
+		}
+		else
+		{
+			lua_pushstring(L, input.type == Event::KeyInput::TYPE_KEY_PRESSED ? "keypressed" : "keyreleased");
+			lua_rawseti(L, -2, index + 1);
+
+			if (!love::keyboard::Keyboard::getConstant(input.key, str))
+				str = "unknown";
+			lua_pushstring(L, str);
+			lua_rawseti(L, -2, index + 2);
+
+			if (!love::keyboard::Keyboard::getConstant(input.scancode, str))
+				str = "unknown";
+			lua_pushstring(L, str);
+			lua_rawseti(L, -2, index + 3);
+		}
+
+		luax_pushboolean(L, input.isRepeat);
+		lua_rawseti(L, -2, index + 4);
+		lua_pushnumber(L, input.time);
+		lua_rawseti(L, -2, index + 5);
+	}
+
+	lua_pushinteger(L, (lua_Integer) inputs.size());
+	return 2;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -158,6 +269,12 @@ static const luaL_Reg functions[] =
 	{ "clear", w_clear },
 	{ "quit", w_quit },
 	{ "restart", w_restart },
+	{ "setCoalesced", w_setCoalesced },
+	{ "isCoalesced", w_isCoalesced },
+	{ "getCoalescedHistory", w_getCoalescedHistory },
+	{ "setKeyInputCaptured", w_setKeyInputCaptured },
+	{ "isKeyInputCaptured", w_isKeyInputCaptured },
+	{ "pollKeyInput", w_pollKeyInput },
 	{ 0, 0 }
 };
 
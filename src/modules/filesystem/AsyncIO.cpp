@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "AsyncIO.h"
+#include "Filesystem.h"
+
+// C++
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace filesystem
+{
+
+class AsyncIO::Worker : public love::thread::Threadable
+{
+public:
+
+	Worker(AsyncIO *io)
+		: io(io)
+	{
+		threadName = "AsyncIO";
+	}
+
+	void threadFunction() override
+	{
+		io->processRequests();
+	}
+
+private:
+
+	AsyncIO *io;
+
+}; // Worker
+
+AsyncIO::AsyncIO(Filesystem *filesystem)
+	: filesystem(filesystem)
+	, nextID(1)
+	, finishing(false)
+{
+}
+
+AsyncIO::~AsyncIO()
+{
+	finish();
+}
+
+int64 AsyncIO::request(RequestType type, const std::string &filename, Data *data, love::thread::Channel *channel)
+{
+	Request req;
+	req.type = type;
+	req.filename = filename;
+	req.data.set(data);
+	req.channel.set(channel);
+
+	{
+		love::thread::Lock lock(mutex);
+
+		req.id = nextID++;
+		requests.push(req);
+		finishing = false;
+
+		// Threads are started on the first request.
+		if (workers.empty())
+		{
+			int threadcount = std::min((int) std::thread::hardware_concurrency(), MAX_THREADS);
+			threadcount = std::max(threadcount, 1);
+
+			for (int i = 0; i < threadcount; i++)
+			{
+				StrongRef<Worker> worker(new Worker(this), Acquire::NORETAIN);
+				if (!worker->start())
+					break;
+				workers.push_back(worker);
+			}
+		}
+	}
+
+	cond->signal();
+
+	// Without threads the request is handled on the calling thread.
+	if (workers.empty())
+		processRequests();
+
+	return req.id;
+}
+
+void AsyncIO::finish()
+{
+	{
+		love::thread::Lock lock(mutex);
+
+		finishing = true;
+		while (!requests.empty())
+			requests.pop();
+	}
+
+	cond->broadcast();
+
+	for (const auto &worker : workers)
+		worker->wait();
+
+	workers.clear();
+}
+
+void AsyncIO::processRequests()
+{
+	while (true)
+	{
+		Request req;
+
+		{
+			love::thread::Lock lock(mutex);
+
+			while (requests.empty() && !finishing && !workers.empty())
+				cond->wait(mutex);
+
+			if (requests.empty())
+				return;
+
+			req = requests.front();
+			requests.pop();
+		}
+
+		processRequest(req);
+	}
+}
+
+void AsyncIO::processRequest(const Request &req)
+{
+	Variant::SharedTable *result = new Variant::SharedTable();
+	result->pairs.emplace_back(Variant(std::string("id")), Variant((double) req.id));
+	result->pairs.emplace_back(Variant(std::string("filename")), Variant(req.filename));
+
+	try
+	{
+		switch (req.type)
+		{
+		case REQUEST_READ:
+		case REQUEST_READ_MAPPED:
+		{
+			const char *filename = req.filename.c_str();
+			FileData *filedata = req.type == REQUEST_READ_MAPPED ? filesystem->readMapped(filename) : filesystem->read(filename);
+			StrongRef<FileData> fdref(filedata, Acquire::NORETAIN);
+			result->pairs.emplace_back(Variant(std::string("data")), Variant(&FileData::type, filedata));
+			break;
+		}
+		case REQUEST_WRITE:
+			filesystem->write(req.filename.c_str(), req.data->getData(), req.data->getSize());
+			result->pairs.emplace_back(Variant(std::string("success")), Variant(true));
+			break;
+		case REQUEST_APPEND:
+			filesystem->append(req.filename.c_str(), req.data->getData(), req.data->getSize());
+			result->pairs.emplace_back(Variant(std::string("success")), Variant(true));
+			break;
+		case REQUEST_LIST_DIRECTORY:
+		case REQUEST_LIST_DIRECTORY_RECURSIVE:
+		{
+			std::vector<Filesystem::DirectoryItem> items;
+			bool recursive = req.type == REQUEST_LIST_DIRECTORY_RECURSIVE;
+			if (!filesystem->getDirectoryItemsInfo(req.filename.c_str(), recursive, items))
+				throw love::Exception("Could not open directory %s.", req.filename.c_str());
+
+			Variant::SharedTable *itemstable = new Variant::SharedTable();
+			itemstable->pairs.reserve(items.size());
+
+			for (size_t i = 0; i < items.size(); i++)
+			{
+				const Filesystem::DirectoryItem &item = items[i];
+
+				const char *typestr = nullptr;
+				Filesystem::getConstant(item.info.type, typestr);
+
+				Variant::SharedTable *itemtable = new Variant::SharedTable();
+				itemtable->pairs.emplace_back(Variant(std::string("path")), Variant(item.path));
+				itemtable->pairs.emplace_back(Variant(std::string("type")), Variant(std::string(typestr != nullptr ? typestr : "other")));
+				itemtable->pairs.emplace_back(Variant(std::string("readonly")), Variant(item.info.readonly));
+
+				if (item.info.size >= 0)
+					itemtable->pairs.emplace_back(Variant(std::string("size")), Variant((double) item.info.size));
+				if (item.info.modtime >= 0)
+					itemtable->pairs.emplace_back(Variant(std::string("modtime")), Variant((double) item.info.modtime));
+
+				itemstable->pairs.emplace_back(Variant((double) (i + 1)), Variant(itemtable));
+			}
+
+			result->pairs.emplace_back(Variant(std::string("items")), Variant(itemstable));
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	catch (std::exception &e)
+	{
+		result->pairs.emplace_back(Variant(std::string("error")), Variant(std::string(e.what())));
+	}
+
+	if (req.channel.get() != nullptr)
+		req.channel->push(Variant(result));
+	else
+		result->release();
+}
+
+} // filesystem
+} // love
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "thread/Channel.h"
+
+// C++
+#include <string>
+#include <queue>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+class Filesystem;
+
+/**
+ * Runs file reads and writes on a small pool of worker threads. When a request
+ * completes, a table is pushed to its Channel with 'id' and 'filename' fields,
+ * plus a 'data' field holding the FileData (for reads), a 'success' field (for
+ * writes), an 'items' field (for directory listings), or an 'error' field with
+ * the error message.
+ **/
+class AsyncIO : public love::Object
+{
+public:
+
+	static const int MAX_THREADS = 4;
+
+	enum RequestType
+	{
+		REQUEST_READ,
+		REQUEST_READ_MAPPED,
+		REQUEST_WRITE,
+		REQUEST_APPEND,
+		REQUEST_LIST_DIRECTORY,
+		REQUEST_LIST_DIRECTORY_RECURSIVE,
+		REQUEST_MAX_ENUM
+	};
+
+	AsyncIO(Filesystem *filesystem);
+	virtual ~AsyncIO();
+
+	/**
+	 * Queues a request and returns its id. The data is only used by writes,
+	 * and the channel may be null for writes whose result isn't needed.
+	 **/
+	int64 request(RequestType type, const std::string &filename, Data *data, love::thread::Channel *channel);
+
+	/**
+	 * Drops requests which haven't started yet, waits for the ones in
+	 * progress, and stops the worker threads.
+	 **/
+	void finish();
+
+private:
+
+	class Worker;
+
+	struct Request
+	{
+		int64 id;
+		RequestType type;
+		std::string filename;
+		StrongRef<Data> data;
+		StrongRef<love::thread::Channel> channel;
+	};
+
+	void processRequests();
+	void processRequest(const Request &req);
+
+	Filesystem *filesystem;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	std::queue<Request> requests;
+	std::vector<StrongRef<Worker>> workers;
+
+	int64 nextID;
+	bool finishing;
+
+}; // AsyncIO
+
+} // filesystem
+} // love
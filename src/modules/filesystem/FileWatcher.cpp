@@ -0,0 +1,580 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "FileWatcher.h"
+#include "common/Module.h"
+#include "common/utf8.h"
+#include "event/Event.h"
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+#include <CoreServices/CoreServices.h>
+#include <dispatch/dispatch.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+#include <windows.h>
+#endif
+
+// C++
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+
+// How long the worker thread waits for changes before checking whether it
+// should stop, in milliseconds.
+static const int POLL_INTERVAL = 100;
+
+struct FileWatcher::Root
+{
+	FileWatcher *watcher;
+	std::string key;
+	std::string realPath;
+	std::string virtualRoot;
+
+#if defined(LOVE_FILEWATCHER_FSEVENTS)
+	// The path as reported by FSEvents, with symlinks resolved.
+	std::string canonicalPath;
+	FSEventStreamRef stream;
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+	HANDLE directory;
+	OVERLAPPED overlapped;
+	std::vector<DWORD> buffer;
+	bool removed;
+#endif
+
+	void push(const std::string &relativepath, Change change)
+	{
+		watcher->pushEvent(this, relativepath, change);
+	}
+};
+
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS)
+
+class FileWatcher::Worker : public love::thread::Threadable
+{
+public:
+
+	Worker(FileWatcher *watcher)
+		: watcher(watcher)
+	{
+		threadName = "FileWatcher";
+	}
+
+	void threadFunction() override
+	{
+		watcher->processEvents();
+	}
+
+private:
+
+	FileWatcher *watcher;
+
+}; // Worker
+
+#endif
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+
+static const uint32_t INOTIFY_MASK = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+
+static void fsEventsCallback(ConstFSEventStreamRef /*stream*/, void *info, size_t count, void *eventpaths, const FSEventStreamEventFlags flags[], const FSEventStreamEventId /*ids*/[])
+{
+	FileWatcher::Root *root = (FileWatcher::Root *) info;
+	const char **paths = (const char **) eventpaths;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		std::string path = paths[i];
+		if (path.size() <= root->canonicalPath.size() + 1 || path.compare(0, root->canonicalPath.size(), root->canonicalPath) != 0
+			|| path[root->canonicalPath.size()] != '/')
+			continue;
+
+		std::string relativepath = path.substr(root->canonicalPath.size() + 1);
+		FSEventStreamEventFlags f = flags[i];
+
+		// Events can be coalesced, so check whether the file still exists.
+		struct stat buf;
+		bool exists = stat(path.c_str(), &buf) == 0;
+
+		if ((f & (kFSEventStreamEventFlagItemRemoved | kFSEventStreamEventFlagItemRenamed)) != 0 && !exists)
+			root->push(relativepath, FileWatcher::CHANGE_REMOVED);
+		else if ((f & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)) != 0 && exists)
+			root->push(relativepath, FileWatcher::CHANGE_ADDED);
+		else if ((f & (kFSEventStreamEventFlagItemModified | kFSEventStreamEventFlagItemInodeMetaMod)) != 0 && exists)
+			root->push(relativepath, FileWatcher::CHANGE_MODIFIED);
+	}
+}
+
+static void dispatchNoop(void *)
+{
+}
+
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+
+static const DWORD WINDOWS_NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+	| FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+static const size_t WINDOWS_BUFFER_SIZE = 64 * 1024;
+
+static bool issueRead(HANDLE directory, OVERLAPPED *overlapped, std::vector<DWORD> &buffer)
+{
+	DWORD size = (DWORD) (buffer.size() * sizeof(DWORD));
+	return ReadDirectoryChangesW(directory, buffer.data(), size, TRUE, WINDOWS_NOTIFY_FILTER, nullptr, overlapped, nullptr) != 0;
+}
+
+#endif
+
+bool FileWatcher::isSupported()
+{
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_FSEVENTS) || defined(LOVE_FILEWATCHER_WINDOWS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+FileWatcher::FileWatcher()
+	: finishing(false)
+{
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+	inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFD < 0)
+		throw love::Exception("Could not initialize inotify.");
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+	dispatchQueue = dispatch_queue_create("org.love2d.filewatcher", DISPATCH_QUEUE_SERIAL);
+#elif !defined(LOVE_FILEWATCHER_WINDOWS)
+	throw love::Exception("Watching files is not supported on this platform.");
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+	{
+		love::thread::Lock lock(mutex);
+		finishing = true;
+	}
+
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS)
+	if (worker.get() != nullptr)
+		worker->wait();
+#endif
+
+	for (Root *root : roots)
+		closeRoot(root);
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+	close(inotifyFD);
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+	dispatch_release((dispatch_queue_t) dispatchQueue);
+#endif
+}
+
+bool FileWatcher::watch(const std::string &key, const std::string &fullpath, const std::string &virtualroot)
+{
+	love::thread::Lock lock(mutex);
+
+	Root *root = new Root();
+	root->watcher = this;
+	root->key = key;
+	root->realPath = fullpath;
+	root->virtualRoot = virtualroot;
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+	if (!addInotifyWatch(root, ""))
+	{
+		delete root;
+		return false;
+	}
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+	char *canonical = realpath(fullpath.c_str(), nullptr);
+	root->canonicalPath = canonical != nullptr ? canonical : fullpath;
+	free(canonical);
+
+	CFStringRef path = CFStringCreateWithCString(kCFAllocatorDefault, root->canonicalPath.c_str(), kCFStringEncodingUTF8);
+	CFArrayRef paths = CFArrayCreate(kCFAllocatorDefault, (const void **) &path, 1, &kCFTypeArrayCallBacks);
+
+	FSEventStreamContext context = {};
+	context.info = root;
+
+	FSEventStreamCreateFlags flags = kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer;
+	root->stream = FSEventStreamCreate(kCFAllocatorDefault, fsEventsCallback, &context, paths, kFSEventStreamEventIdSinceNow, POLL_INTERVAL / 1000.0, flags);
+
+	CFRelease(paths);
+	CFRelease(path);
+
+	if (root->stream == nullptr)
+	{
+		delete root;
+		return false;
+	}
+
+	FSEventStreamSetDispatchQueue(root->stream, (dispatch_queue_t) dispatchQueue);
+
+	if (!FSEventStreamStart(root->stream))
+	{
+		FSEventStreamInvalidate(root->stream);
+		FSEventStreamRelease(root->stream);
+		delete root;
+		return false;
+	}
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+	// make sure non-ASCII paths work.
+	std::wstring wpath = to_widestr(fullpath);
+
+	root->directory = CreateFileW(wpath.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+	if (root->directory == INVALID_HANDLE_VALUE)
+	{
+		delete root;
+		return false;
+	}
+
+	root->overlapped = {};
+	root->overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+	root->buffer.resize(WINDOWS_BUFFER_SIZE / sizeof(DWORD));
+	root->removed = false;
+
+	if (root->overlapped.hEvent == nullptr || !issueRead(root->directory, &root->overlapped, root->buffer))
+	{
+		if (root->overlapped.hEvent != nullptr)
+			CloseHandle(root->overlapped.hEvent);
+		CloseHandle(root->directory);
+		delete root;
+		return false;
+	}
+#endif
+
+	roots.push_back(root);
+
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS)
+	// The thread is started with the first watch.
+	if (worker.get() == nullptr)
+	{
+		worker.set(new Worker(this), Acquire::NORETAIN);
+		if (!worker->start())
+		{
+			worker.set(nullptr);
+			roots.pop_back();
+			closeRoot(root);
+			return false;
+		}
+	}
+#endif
+
+	return true;
+}
+
+void FileWatcher::unwatch(const std::string &key)
+{
+	love::thread::Lock lock(mutex);
+
+	for (auto it = roots.begin(); it != roots.end();)
+	{
+		Root *root = *it;
+		if (root->key != key)
+		{
+			++it;
+			continue;
+		}
+
+#ifdef LOVE_FILEWATCHER_WINDOWS
+		// The worker thread may be waiting on the directory's event, so it
+		// closes the handles itself.
+		if (worker.get() != nullptr)
+		{
+			root->removed = true;
+			++it;
+			continue;
+		}
+#endif
+
+		closeRoot(root);
+		it = roots.erase(it);
+	}
+}
+
+void FileWatcher::closeRoot(Root *root)
+{
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+	for (auto it = inotifyWatches.begin(); it != inotifyWatches.end();)
+	{
+		if (it->second.root == root)
+		{
+			inotify_rm_watch(inotifyFD, it->first);
+			it = inotifyWatches.erase(it);
+		}
+		else
+			++it;
+	}
+#elif defined(LOVE_FILEWATCHER_FSEVENTS)
+	FSEventStreamStop(root->stream);
+	FSEventStreamInvalidate(root->stream);
+	FSEventStreamRelease(root->stream);
+
+	// Wait for any callback which is still running on the queue.
+	dispatch_sync_f((dispatch_queue_t) dispatchQueue, nullptr, dispatchNoop);
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+	CancelIoEx(root->directory, &root->overlapped);
+
+	DWORD bytes = 0;
+	GetOverlappedResult(root->directory, &root->overlapped, &bytes, TRUE);
+
+	CloseHandle(root->overlapped.hEvent);
+	CloseHandle(root->directory);
+#endif
+
+	delete root;
+}
+
+void FileWatcher::pushEvent(const Root *root, const std::string &relativepath, Change change)
+{
+	auto eventmodule = Module::getInstance<event::Event>(Module::M_EVENT);
+	if (!eventmodule)
+		return;
+
+	const char *changestr = nullptr;
+	if (!getConstant(change, changestr))
+		return;
+
+	std::string path = relativepath;
+	if (!root->virtualRoot.empty())
+		path = root->virtualRoot + "/" + relativepath;
+
+	std::vector<Variant> vargs = {
+		Variant(path),
+		Variant(changestr, strlen(changestr))
+	};
+
+	StrongRef<event::Message> msg(new event::Message("filechanged", vargs), Acquire::NORETAIN);
+	eventmodule->push(msg);
+}
+
+#if defined(LOVE_FILEWATCHER_INOTIFY)
+
+bool FileWatcher::addInotifyWatch(Root *root, const std::string &relativepath)
+{
+	std::string path = relativepath.empty() ? root->realPath : root->realPath + "/" + relativepath;
+
+	int wd = inotify_add_watch(inotifyFD, path.c_str(), INOTIFY_MASK);
+	if (wd < 0)
+		return false;
+
+	inotifyWatches[wd] = {root, relativepath};
+
+	// inotify isn't recursive, so every subdirectory needs its own watch.
+	DIR *dir = opendir(path.c_str());
+	if (dir == nullptr)
+		return true;
+
+	while (struct dirent *entry = readdir(dir))
+	{
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		std::string childpath = relativepath.empty() ? std::string(entry->d_name) : relativepath + "/" + entry->d_name;
+
+		bool isdir = entry->d_type == DT_DIR;
+		if (entry->d_type == DT_UNKNOWN)
+		{
+			struct stat buf;
+			isdir = stat((root->realPath + "/" + childpath).c_str(), &buf) == 0 && S_ISDIR(buf.st_mode);
+		}
+
+		if (isdir)
+			addInotifyWatch(root, childpath);
+	}
+
+	closedir(dir);
+	return true;
+}
+
+void FileWatcher::processEvents()
+{
+	// Large enough for many events with long names.
+	alignas(struct inotify_event) char buffer[16 * 1024];
+
+	while (true)
+	{
+		{
+			love::thread::Lock lock(mutex);
+			if (finishing)
+				return;
+		}
+
+		struct pollfd pfd = {};
+		pfd.fd = inotifyFD;
+		pfd.events = POLLIN;
+
+		if (poll(&pfd, 1, POLL_INTERVAL) <= 0)
+			continue;
+
+		ssize_t length = read(inotifyFD, buffer, sizeof(buffer));
+		if (length <= 0)
+			continue;
+
+		love::thread::Lock lock(mutex);
+
+		for (char *p = buffer; p < buffer + length;)
+		{
+			const struct inotify_event *event = (const struct inotify_event *) p;
+			p += sizeof(struct inotify_event) + event->len;
+
+			auto it = inotifyWatches.find(event->wd);
+			if (it == inotifyWatches.end())
+				continue;
+
+			if ((event->mask & IN_IGNORED) != 0)
+			{
+				inotifyWatches.erase(it);
+				continue;
+			}
+
+			// Events for the watched directory itself have no name.
+			if (event->len == 0 || event->name[0] == '\0')
+				continue;
+
+			Root *root = it->second.root;
+			const std::string &dirpath = it->second.relativePath;
+			std::string relativepath = dirpath.empty() ? std::string(event->name) : dirpath + "/" + event->name;
+
+			if ((event->mask & IN_ISDIR) != 0 && (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+				addInotifyWatch(root, relativepath);
+
+			if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+				root->push(relativepath, CHANGE_ADDED);
+			else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+				root->push(relativepath, CHANGE_REMOVED);
+			else if ((event->mask & IN_CLOSE_WRITE) != 0)
+				root->push(relativepath, CHANGE_MODIFIED);
+		}
+	}
+}
+
+#elif defined(LOVE_FILEWATCHER_WINDOWS)
+
+void FileWatcher::processEvents()
+{
+	while (true)
+	{
+		std::vector<HANDLE> events;
+
+		{
+			love::thread::Lock lock(mutex);
+			if (finishing)
+				return;
+
+			for (auto it = roots.begin(); it != roots.end();)
+			{
+				if ((*it)->removed)
+				{
+					closeRoot(*it);
+					it = roots.erase(it);
+				}
+				else
+				{
+					if (events.size() < MAXIMUM_WAIT_OBJECTS)
+						events.push_back((*it)->overlapped.hEvent);
+					++it;
+				}
+			}
+		}
+
+		if (events.empty())
+		{
+			Sleep(POLL_INTERVAL);
+			continue;
+		}
+
+		WaitForMultipleObjects((DWORD) events.size(), events.data(), FALSE, POLL_INTERVAL);
+
+		love::thread::Lock lock(mutex);
+
+		for (Root *root : roots)
+		{
+			if (root->removed)
+				continue;
+
+			// Returns false while the read is still pending.
+			DWORD bytes = 0;
+			if (!GetOverlappedResult(root->directory, &root->overlapped, &bytes, FALSE))
+				continue;
+
+			// Zero bytes means the buffer overflowed and changes were lost.
+			const char *p = (const char *) root->buffer.data();
+			while (bytes > 0)
+			{
+				const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *) p;
+
+				std::wstring wname(info->FileName, info->FileNameLength / sizeof(WCHAR));
+				std::string relativepath = to_utf8(wname.c_str());
+				replace_char(relativepath, '\\', '/');
+
+				switch (info->Action)
+				{
+				case FILE_ACTION_ADDED:
+				case FILE_ACTION_RENAMED_NEW_NAME:
+					root->push(relativepath, CHANGE_ADDED);
+					break;
+				case FILE_ACTION_REMOVED:
+				case FILE_ACTION_RENAMED_OLD_NAME:
+					root->push(relativepath, CHANGE_REMOVED);
+					break;
+				case FILE_ACTION_MODIFIED:
+					root->push(relativepath, CHANGE_MODIFIED);
+					break;
+				default:
+					break;
+				}
+
+				if (info->NextEntryOffset == 0)
+					break;
+				p += info->NextEntryOffset;
+			}
+
+			issueRead(root->directory, &root->overlapped, root->buffer);
+		}
+	}
+}
+
+#endif
+
+STRINGMAP_CLASS_BEGIN(FileWatcher, FileWatcher::Change, FileWatcher::CHANGE_MAX_ENUM, change)
+{
+	{ "added",    FileWatcher::CHANGE_ADDED    },
+	{ "modified", FileWatcher::CHANGE_MODIFIED },
+	{ "removed",  FileWatcher::CHANGE_REMOVED  },
+}
+STRINGMAP_CLASS_END(FileWatcher, FileWatcher::Change, FileWatcher::CHANGE_MAX_ENUM, change)
+
+} // filesystem
+} // love
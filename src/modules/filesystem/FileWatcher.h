@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+
+// C++
+#include <string>
+#include <vector>
+#include <map>
+
+#if defined(LOVE_LINUX) || defined(LOVE_ANDROID)
+#define LOVE_FILEWATCHER_INOTIFY
+#elif defined(LOVE_MACOS)
+#define LOVE_FILEWATCHER_FSEVENTS
+#elif defined(LOVE_WINDOWS)
+#define LOVE_FILEWATCHER_WINDOWS
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * Watches directories on disk for changes, using inotify on Linux and Android,
+ * FSEvents on macOS and ReadDirectoryChangesW on Windows. Each change is pushed
+ * as a 'filechanged' event with the file's path and the kind of change.
+ **/
+class FileWatcher : public love::Object
+{
+public:
+
+	enum Change
+	{
+		CHANGE_ADDED,
+		CHANGE_MODIFIED,
+		CHANGE_REMOVED,
+		CHANGE_MAX_ENUM
+	};
+
+	// Platform-specific state for a watched directory.
+	struct Root;
+
+	static bool isSupported();
+
+	FileWatcher();
+	virtual ~FileWatcher();
+
+	/**
+	 * Watches a directory on disk and everything inside it. Changed files are
+	 * reported with their path relative to the directory appended to
+	 * virtualroot.
+	 * @param key Groups watches so they can be removed together by unwatch.
+	 **/
+	bool watch(const std::string &key, const std::string &fullpath, const std::string &virtualroot);
+
+	/**
+	 * Stops watching all directories added with the given key.
+	 **/
+	void unwatch(const std::string &key);
+
+	STRINGMAP_CLASS_DECLARE(Change);
+
+private:
+
+	void pushEvent(const Root *root, const std::string &relativepath, Change change);
+	void closeRoot(Root *root);
+
+#if defined(LOVE_FILEWATCHER_INOTIFY) || defined(LOVE_FILEWATCHER_WINDOWS)
+	class Worker;
+
+	void processEvents();
+
+	StrongRef<Worker> worker;
+#endif
+
+#ifdef LOVE_FILEWATCHER_INOTIFY
+	struct InotifyWatch
+	{
+		Root *root;
+		std::string relativePath;
+	};
+
+	bool addInotifyWatch(Root *root, const std::string &relativepath);
+
+	int inotifyFD;
+	std::map<int, InotifyWatch> inotifyWatches;
+#endif
+
+#ifdef LOVE_FILEWATCHER_FSEVENTS
+	// dispatch_queue_t
+	void *dispatchQueue;
+#endif
+
+	love::thread::MutexRef mutex;
+
+	std::vector<Root *> roots;
+	bool finishing;
+
+}; // FileWatcher
+
+} // filesystem
+} // love
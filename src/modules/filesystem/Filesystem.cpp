@@ -21,6 +21,11 @@
 // LOVE
 #include "Filesystem.h"
 #include "common/utf8.h"
+#include "thread/JobSystem.h"
+
+// C++
+#include <atomic>
+#include <functional>
 
 // Assume POSIX or Visual Studio.
 #include <sys/types.h>
@@ -45,6 +50,7 @@ namespace filesystem
 love::Type Filesystem::type("filesystem", &Module::type);
 
 Filesystem::Filesystem()
+	: bytecodeCacheEnabled(false)
 {
 }
 
@@ -62,6 +68,74 @@ bool Filesystem::isAndroidSaveExternal() const
 	return useExternal;
 }
 
+void Filesystem::setBytecodeCacheEnabled(bool enable)
+{
+	bytecodeCacheEnabled = enable;
+}
+
+bool Filesystem::isBytecodeCacheEnabled() const
+{
+	return bytecodeCacheEnabled;
+}
+
+int64 Filesystem::requestAsync(AsyncIO::RequestType type, const char *filename, Data *data, love::thread::Channel *channel)
+{
+	if (asyncIO.get() == nullptr)
+		asyncIO.set(new AsyncIO(this), Acquire::NORETAIN);
+
+	return asyncIO->request(type, filename, data, channel);
+}
+
+void Filesystem::finishAsyncIO()
+{
+	if (asyncIO.get() != nullptr)
+		asyncIO->finish();
+}
+
+void Filesystem::readMultiple(const std::vector<std::string> &filenames, bool mapped, std::vector<StrongRef<FileData>> &files) const
+{
+	files.clear();
+	files.resize(filenames.size());
+
+	std::vector<std::string> errors(filenames.size());
+	std::atomic<size_t> next(0);
+
+	// Each thread takes the next unread file until none are left, so a few
+	// large files don't hold up the rest.
+	auto readfiles = [&]()
+	{
+		for (size_t i = next++; i < filenames.size(); i = next++)
+		{
+			try
+			{
+				const char *filename = filenames[i].c_str();
+				files[i].set(mapped ? readMapped(filename) : read(filename), Acquire::NORETAIN);
+			}
+			catch (love::Exception &e)
+			{
+				errors[i] = e.what();
+			}
+		}
+	};
+
+	love::thread::JobSystem *jobsystem = love::thread::JobSystem::getInstance();
+
+	int threadcount = std::min(jobsystem->getWorkerCount() + 1, AsyncIO::MAX_THREADS);
+	threadcount = std::min(threadcount, (int) filenames.size());
+
+	jobsystem->parallelFor((size_t) threadcount, 1, [&](size_t, size_t) { readfiles(); });
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (files[i].get() == nullptr)
+		{
+			std::string error = errors[i];
+			files.clear();
+			throw love::Exception("%s", error.c_str());
+		}
+	}
+}
+
 FileData *Filesystem::newFileData(const void *data, size_t size, const char *filename) const
 {
 	FileData *fd = new FileData(size, std::string(filename));
@@ -28,6 +28,8 @@
 #include "common/StringMap.h"
 #include "FileData.h"
 #include "File.h"
+#include "AsyncIO.h"
+#include "LogFile.h"
 
 // C++
 #include <string>
@@ -106,6 +108,13 @@ public:
 		bool readonly;
 	};
 
+	struct DirectoryItem
+	{
+		// Relative to the enumerated directory, using '/' as the separator.
+		std::string path;
+		Info info;
+	};
+
 	static love::Type type;
 
 	Filesystem();
@@ -140,6 +149,14 @@ public:
 	**/
 	virtual bool isAndroidSaveExternal() const; 
 
+	/**
+	 * Sets whether love.filesystem.load and require store compiled Lua
+	 * bytecode in the save directory, and use it instead of parsing the
+	 * source again when the source hasn't changed.
+	 **/
+	void setBytecodeCacheEnabled(bool enable);
+	bool isBytecodeCacheEnabled() const;
+
 	/**
 	 * Sets the name of the save folder.
 	 * @param ident The name of the game. Will be used to
@@ -255,6 +272,14 @@ public:
 	virtual FileData *read(const char *filename, int64 size) const = 0;
 	virtual FileData *read(const char *filename) const = 0;
 
+	/**
+	 * Reads a whole file into a FileData backed by a memory mapping of the file,
+	 * when the file is in a plain directory on disk or is stored uncompressed
+	 * in a zip archive on disk. Other files are read normally.
+	 * @param filename The name of the file to read from.
+	 **/
+	virtual FileData *readMapped(const char *filename) const = 0;
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
@@ -271,12 +296,48 @@ public:
 	 **/
 	virtual void append(const char *filename, const void *data, int64 size) const = 0;
 
+	/**
+	 * Queues a read or write to run on background I/O threads, and returns the
+	 * request's id. See AsyncIO for how results are delivered to the Channel.
+	 **/
+	int64 requestAsync(AsyncIO::RequestType type, const char *filename, Data *data, love::thread::Channel *channel);
+
+	/**
+	 * Reads several files at once on a few worker threads, so entries in
+	 * compressed archives are decompressed in parallel. The results are in the
+	 * same order as the filenames. Throws if any of the files can't be read.
+	 * @param mapped Whether to use readMapped for each file.
+	 **/
+	void readMultiple(const std::vector<std::string> &filenames, bool mapped, std::vector<StrongRef<FileData>> &files) const;
+
 	/**
 	 * This "native" method returns a table of all
 	 * files in a given directory.
 	 **/
 	virtual bool getDirectoryItems(const char *dir, std::vector<std::string> &items) = 0;
 
+	/**
+	 * Gets the items in a directory along with their info, optionally
+	 * including the contents of all subdirectories. Returns false if the
+	 * directory doesn't exist.
+	 **/
+	virtual bool getDirectoryItemsInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items) const = 0;
+
+	/**
+	 * Watches a directory and everything inside it for changes made in
+	 * directories on disk (such as the source and save directories), and
+	 * pushes a 'filechanged' event for each change. Returns false if nothing
+	 * could be watched.
+	 **/
+	virtual bool watch(const char *dir) = 0;
+	virtual void unwatch(const char *dir) = 0;
+
+	/**
+	 * Opens a file in the save directory for buffered appending from a
+	 * background thread. See LogFile.
+	 **/
+	virtual LogFile *newLogFile(const char *filename, const LogFile::Settings &settings) = 0;
+
 	/**
 	 * Enable or disable symbolic link support in love.filesystem.
 	 **/
@@ -317,13 +378,25 @@ public:
 	STRINGMAP_CLASS_DECLARE(MountPermissions);
 	STRINGMAP_CLASS_DECLARE(LoadMode);
 
-private:
+protected:
+
+	/**
+	 * Stops the asynchronous I/O threads. Implementations must call this before
+	 * tearing down anything the threads may use.
+	 **/
+	void finishAsyncIO();
 
 	bool getRealPathType(const std::string &path, FileType &ftype) const;
 
+private:
+
+	StrongRef<AsyncIO> asyncIO;
+
 	// Should we save external or internal for Android
 	bool useExternal;
 
+	bool bytecodeCacheEnabled;
+
 }; // Filesystem
 
 } // filesystem
@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "LogFile.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+
+love::Type LogFile::type("LogFile", &Object::type);
+
+class LogFile::Flusher : public love::thread::Threadable
+{
+public:
+
+	Flusher(LogFile *logfile)
+		: logfile(logfile)
+	{
+		threadName = "LogFile";
+	}
+
+	void threadFunction() override
+	{
+		logfile->processWrites();
+	}
+
+private:
+
+	LogFile *logfile;
+
+}; // Flusher
+
+LogFile::LogFile(const std::string &fullpath, const std::string &filename, const Settings &settings)
+	: filename(filename)
+	, settings(settings)
+	, readPos(0)
+	, pendingSize(0)
+	, totalWritten(0)
+	, totalFlushed(0)
+	, flushRequested(false)
+	, closing(false)
+	, closed(false)
+{
+	if (settings.bufferSize <= 0)
+		throw love::Exception("Log file buffer size must be greater than 0.");
+
+	if (settings.flushInterval < 0.0)
+		throw love::Exception("Log file flush interval must not be negative.");
+
+	file.set(new NativeFile(fullpath, File::MODE_APPEND), Acquire::NORETAIN);
+	ring.resize((size_t) settings.bufferSize);
+
+	flusher.set(new Flusher(this), Acquire::NORETAIN);
+	if (!flusher->start())
+		throw love::Exception("Could not start the log file thread.");
+}
+
+LogFile::~LogFile()
+{
+	close();
+}
+
+void LogFile::write(const void *data, int64 size)
+{
+	love::thread::Lock lock(mutex);
+
+	if (closed || closing)
+		throw love::Exception("Log file %s is closed.", filename.c_str());
+
+	checkError();
+
+	const char *src = (const char *) data;
+
+	while (size > 0)
+	{
+		size_t space = ring.size() - pendingSize;
+		if (space == 0)
+		{
+			// Wait for the flusher to make room rather than dropping data.
+			writeCond->signal();
+			flushCond->wait(mutex);
+			checkError();
+			continue;
+		}
+
+		size_t count = std::min((size_t) size, space);
+		size_t writepos = (readPos + pendingSize) % ring.size();
+		size_t first = std::min(count, ring.size() - writepos);
+
+		memcpy(&ring[writepos], src, first);
+		memcpy(&ring[0], src + first, count - first);
+
+		bool wasempty = pendingSize == 0;
+
+		pendingSize += count;
+		totalWritten += count;
+		src += count;
+		size -= count;
+
+		// The flusher sleeps while the buffer is empty, and writes early once
+		// it's half full.
+		if (wasempty || pendingSize >= ring.size() / 2)
+			writeCond->signal();
+	}
+
+	if (settings.syncMode == SYNC_ALWAYS)
+		waitForFlush(totalWritten);
+}
+
+void LogFile::flush()
+{
+	love::thread::Lock lock(mutex);
+
+	if (closed)
+		return;
+
+	waitForFlush(totalWritten);
+}
+
+void LogFile::close()
+{
+	{
+		love::thread::Lock lock(mutex);
+		if (closed)
+			return;
+		closing = true;
+	}
+
+	writeCond->signal();
+	flusher->wait();
+
+	love::thread::Lock lock(mutex);
+	file->close();
+	closed = true;
+}
+
+bool LogFile::isOpen() const
+{
+	love::thread::Lock lock(mutex);
+	return !closed && !closing;
+}
+
+const std::string &LogFile::getFilename() const
+{
+	return filename;
+}
+
+const LogFile::Settings &LogFile::getSettings() const
+{
+	return settings;
+}
+
+void LogFile::waitForFlush(uint64 target)
+{
+	// Called with the mutex locked.
+	flushRequested = true;
+	writeCond->signal();
+
+	while (totalFlushed < target && error.empty())
+		flushCond->wait(mutex);
+
+	checkError();
+}
+
+void LogFile::checkError() const
+{
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+}
+
+void LogFile::processWrites()
+{
+	int interval = (int) (settings.flushInterval * 1000.0);
+
+	love::thread::Lock lock(mutex);
+
+	while (true)
+	{
+		if (!closing && !flushRequested && pendingSize < ring.size() / 2)
+		{
+			// Sleep until there's data, then give more writes a chance to
+			// arrive so they're written out together.
+			if (pendingSize == 0)
+				writeCond->wait(mutex);
+			else if (interval > 0)
+				writeCond->wait(mutex, interval);
+		}
+
+		size_t start = readPos;
+		size_t count = pendingSize;
+		flushRequested = false;
+
+		if (count > 0)
+		{
+			// Writers only touch the free part of the buffer, so the pending
+			// part can be written without holding the lock.
+			mutex->unlock();
+
+			size_t first = std::min(count, ring.size() - start);
+			bool success = false;
+
+			try
+			{
+				success = file->write(&ring[start], first);
+				if (success && count > first)
+					success = file->write(&ring[0], count - first);
+
+				if (success)
+					success = settings.syncMode == SYNC_NEVER ? file->flush() : file->sync();
+			}
+			catch (love::Exception &)
+			{
+				success = false;
+			}
+
+			mutex->lock();
+
+			readPos = (start + count) % ring.size();
+			pendingSize -= count;
+			totalFlushed += count;
+
+			if (!success && error.empty())
+				error = "Could not write to log file " + filename + ".";
+		}
+
+		flushCond->broadcast();
+
+		if (closing && pendingSize == 0)
+			break;
+	}
+}
+
+STRINGMAP_CLASS_BEGIN(LogFile, LogFile::SyncMode, LogFile::SYNC_MAX_ENUM, syncMode)
+{
+	{ "never",  LogFile::SYNC_NEVER  },
+	{ "flush",  LogFile::SYNC_FLUSH  },
+	{ "always", LogFile::SYNC_ALWAYS },
+}
+STRINGMAP_CLASS_END(LogFile, LogFile::SyncMode, LogFile::SYNC_MAX_ENUM, syncMode)
+
+} // filesystem
+} // love
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "common/int.h"
+#include "thread/threads.h"
+#include "NativeFile.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * Appends to a file on disk through an in-memory ring buffer, which a
+ * background thread writes out in batches. Writes only block when the buffer
+ * is full, or when every write is required to reach the disk.
+ **/
+class LogFile : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum SyncMode
+	{
+		SYNC_NEVER,  // Data is handed to the OS, which writes it out eventually.
+		SYNC_FLUSH,  // Each batch is synced to the disk after being written.
+		SYNC_ALWAYS, // write() waits until its data is synced to the disk.
+		SYNC_MAX_ENUM
+	};
+
+	struct Settings
+	{
+		// How long writes are collected before being written out, in seconds.
+		double flushInterval = 1.0;
+		int64 bufferSize = 1024 * 1024;
+		SyncMode syncMode = SYNC_NEVER;
+	};
+
+	/**
+	 * Opens the file at the given full path for appending.
+	 * @param filename The name reported by getFilename.
+	 **/
+	LogFile(const std::string &fullpath, const std::string &filename, const Settings &settings);
+	virtual ~LogFile();
+
+	/**
+	 * Queues data to be appended to the file. Throws if the file is closed or
+	 * an earlier write failed.
+	 **/
+	void write(const void *data, int64 size);
+
+	/**
+	 * Waits until everything written so far is in the file (and synced to
+	 * the disk, unless the sync mode is SYNC_NEVER).
+	 **/
+	void flush();
+
+	/**
+	 * Writes out pending data and closes the file.
+	 **/
+	void close();
+
+	bool isOpen() const;
+	const std::string &getFilename() const;
+	const Settings &getSettings() const;
+
+	STRINGMAP_CLASS_DECLARE(SyncMode);
+
+private:
+
+	class Flusher;
+
+	void processWrites();
+	void waitForFlush(uint64 target);
+	void checkError() const;
+
+	StrongRef<NativeFile> file;
+	std::string filename;
+	Settings settings;
+
+	std::vector<char> ring;
+	size_t readPos;
+	size_t pendingSize;
+
+	// Total bytes queued and written out since the file was opened.
+	uint64 totalWritten;
+	uint64 totalFlushed;
+
+	bool flushRequested;
+	bool closing;
+	bool closed;
+	std::string error;
+
+	love::thread::MutexRef mutex;
+
+	// Wakes the flusher.
+	love::thread::ConditionalRef writeCond;
+
+	// Wakes writers waiting for buffer space or a flush.
+	love::thread::ConditionalRef flushCond;
+
+	StrongRef<Flusher> flusher;
+
+}; // LogFile
+
+} // filesystem
+} // love
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "MappedFileData.h"
+#include "common/utf8.h"
+
+#ifdef LOVE_WINDOWS
+#include <windows.h>
+#else
+// POSIX.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+
+MappedFileData::MappedFileData(const std::string &fullpath, const std::string &filename)
+	: FileData(filename)
+	, mapping(nullptr)
+	, mappingSize(0)
+{
+	map(fullpath, 0, -1);
+}
+
+MappedFileData::MappedFileData(const std::string &fullpath, int64 offset, int64 size, const std::string &filename)
+	: FileData(filename)
+	, mapping(nullptr)
+	, mappingSize(0)
+{
+	if (offset < 0 || size <= 0)
+		throw love::Exception("Invalid range for mapping file %s.", fullpath.c_str());
+
+	map(fullpath, offset, size);
+}
+
+MappedFileData::~MappedFileData()
+{
+#ifdef LOVE_WINDOWS
+	UnmapViewOfFile(mapping);
+#else
+	munmap(mapping, mappingSize);
+#endif
+
+	// Keep the FileData destructor from freeing the mapped memory.
+	data = nullptr;
+}
+
+void MappedFileData::map(const std::string &fullpath, int64 offset, int64 length)
+{
+#ifdef LOVE_WINDOWS
+	// make sure non-ASCII paths work.
+	std::wstring wpath = to_widestr(fullpath);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw love::Exception("Could not open file %s.", fullpath.c_str());
+
+	LARGE_INTEGER filesize = {};
+	if (!GetFileSizeEx(file, &filesize) || filesize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		throw love::Exception("Could not map file %s.", fullpath.c_str());
+	}
+
+	int64 totalsize = (int64) filesize.QuadPart;
+#else
+	int fd = open(fullpath.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw love::Exception("Could not open file %s.", fullpath.c_str());
+
+	struct stat buf;
+	if (fstat(fd, &buf) != 0 || buf.st_size <= 0)
+	{
+		close(fd);
+		throw love::Exception("Could not map file %s.", fullpath.c_str());
+	}
+
+	int64 totalsize = (int64) buf.st_size;
+#endif
+
+	if (length < 0)
+		length = totalsize - offset;
+
+	bool inrange = offset >= 0 && length > 0 && offset + length <= totalsize;
+
+	// Views have to start at a multiple of the allocation granularity.
+#ifdef LOVE_WINDOWS
+	SYSTEM_INFO sysinfo = {};
+	GetSystemInfo(&sysinfo);
+	int64 alignment = (int64) sysinfo.dwAllocationGranularity;
+#else
+	int64 alignment = (int64) sysconf(_SC_PAGESIZE);
+#endif
+
+	int64 mapoffset = offset - (offset % alignment);
+	size_t mapsize = (size_t) (offset + length - mapoffset);
+
+#ifdef LOVE_WINDOWS
+	HANDLE filemapping = inrange ? CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file);
+
+	if (filemapping == nullptr)
+		throw love::Exception("Could not map file %s.", fullpath.c_str());
+
+	// The view keeps the mapping object alive.
+	DWORD offsethigh = (DWORD) ((uint64) mapoffset >> 32);
+	DWORD offsetlow = (DWORD) ((uint64) mapoffset & 0xFFFFFFFF);
+	void *view = MapViewOfFile(filemapping, FILE_MAP_COPY, offsethigh, offsetlow, mapsize);
+	CloseHandle(filemapping);
+
+	if (view == nullptr)
+		throw love::Exception("Could not map file %s.", fullpath.c_str());
+#else
+	void *view = MAP_FAILED;
+	if (inrange)
+		view = mmap(nullptr, mapsize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) mapoffset);
+
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+
+	if (view == MAP_FAILED)
+		throw love::Exception("Could not map file %s.", fullpath.c_str());
+#endif
+
+	mapping = view;
+	mappingSize = mapsize;
+	data = (char *) view + (offset - mapoffset);
+	size = (uint64) length;
+}
+
+} // filesystem
+} // love
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "FileData.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * FileData backed by a copy-on-write memory mapping of a file on disk instead
+ * of a heap copy. Pages are loaded by the OS on first access, and writes to
+ * the Data's memory are never written back to the file.
+ **/
+class MappedFileData : public FileData
+{
+public:
+
+	/**
+	 * Maps the file at the given full (platform-dependent) path. Throws if the
+	 * file can't be mapped, for example when it's empty.
+	 * @param fullpath The path used to open the file.
+	 * @param filename The filename reported by the FileData.
+	 **/
+	MappedFileData(const std::string &fullpath, const std::string &filename);
+
+	/**
+	 * Maps a byte range of the file at the given full path, for example an
+	 * uncompressed entry inside a zip archive. The range doesn't need to be
+	 * aligned. Throws if it can't be mapped or lies outside of the file.
+	 **/
+	MappedFileData(const std::string &fullpath, int64 offset, int64 size, const std::string &filename);
+
+	virtual ~MappedFileData();
+
+private:
+
+	void map(const std::string &fullpath, int64 offset, int64 size);
+
+	// Start and size of the whole mapped region, which begins at an aligned
+	// offset at or before the requested data.
+	void *mapping;
+	size_t mappingSize;
+
+}; // MappedFileData
+
+} // filesystem
+} // love
@@ -20,7 +20,9 @@
 
 // LOVE
 #include "NativeFile.h"
+#include "MappedFileData.h"
 #include "common/utf8.h"
+#include "common/Trace.h"
 
 #ifdef LOVE_ANDROID
 #include "common/android.h"
@@ -32,6 +34,7 @@
 
 #ifdef LOVE_WINDOWS
 #include <wchar.h>
+#include <io.h>
 #else
 #include <unistd.h> // POSIX.
 #endif
@@ -188,6 +191,8 @@ int64 NativeFile::getSize()
 
 int64 NativeFile::read(void *dst, int64 size)
 {
+	LOVE_TRACE_ZONE("NativeFile::read");
+
 	if (!file || mode != MODE_READ)
 		throw love::Exception("File is not opened for reading.");
 
@@ -220,6 +225,18 @@ bool NativeFile::flush()
 	return fflush(file) == 0;
 }
 
+bool NativeFile::sync()
+{
+	if (!flush())
+		return false;
+
+#ifdef LOVE_WINDOWS
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
 bool NativeFile::isEOF()
 {
 	return file == nullptr || tell() >= getSize();
@@ -329,5 +346,28 @@ const char *NativeFile::getModeString(Mode mode)
 	}
 }
 
+FileData *NativeFile::readMapped()
+{
+	try
+	{
+		return new MappedFileData(filename, filename);
+	}
+	catch (love::Exception &)
+	{
+		// Not mappable (e.g. an empty file.)
+	}
+
+	// Fall back to a regular read of the whole file.
+	if (!isOpen())
+		return read();
+
+	int64 pos = tell();
+	seek(0, SEEKORIGIN_BEGIN);
+	FileData *data = read();
+	seek(pos, SEEKORIGIN_BEGIN);
+
+	return data;
+}
+
 } // filesystem
 } // love
@@ -18,6 +18,8 @@
  * 3. This notice may not be removed or altered from any source distribution.
  **/
 
+#pragma once
+
 // LOVE
 #include "common/config.h"
 #include "File.h"
@@ -63,6 +65,18 @@ public:
 	Mode getMode() const override;
 	const std::string &getFilename() const override;
 
+	/**
+	 * Reads the whole file into a FileData backed by a memory mapping of the
+	 * file, or with a regular read if it can't be mapped.
+	 **/
+	FileData *readMapped();
+
+	/**
+	 * Flushes buffered data and waits until the OS has written the file's
+	 * contents to the storage device.
+	 **/
+	bool sync();
+
 private:
 
 	NativeFile(const NativeFile &other);
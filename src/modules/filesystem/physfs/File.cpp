@@ -19,6 +19,7 @@
  **/
 
 #include "File.h"
+#include "common/Trace.h"
 
 // STD
 #include <cstring>
@@ -169,6 +170,8 @@ int64 File::getSize()
 
 int64 File::read(void *dst, int64 size)
 {
+	LOVE_TRACE_ZONE("File::read");
+
 	if (!file || mode != MODE_READ)
 		throw love::Exception("File is not opened for reading.");
 
@@ -21,12 +21,14 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <limits>
 
 #include "common/utf8.h"
 #include "common/b64.h"
 
 #include "Filesystem.h"
 #include "File.h"
+#include "filesystem/MappedFileData.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -108,6 +110,7 @@ Filesystem::Filesystem()
 	: appendIdentityToPath(false)
 	, fused(false)
 	, fusedSet(false)
+	, pathIndexValid(false)
 	, fullPaths()
 	, commonPathMountInfo()
 	, saveDirectoryNeedsMounting(false)
@@ -118,6 +121,8 @@ Filesystem::Filesystem()
 
 Filesystem::~Filesystem()
 {
+	finishAsyncIO();
+
 #ifdef LOVE_ANDROID
 	love::android::deinitializeVirtualArchive();
 #endif
@@ -269,6 +274,7 @@ bool Filesystem::setSource(const char *source)
 
 			if (PHYSFS_mountIo(io, "LOVE.FD", nullptr, 0))
 			{
+				invalidatePathIndex();
 				gameSource = new_search_path;
 				return true;
 			}
@@ -280,6 +286,8 @@ bool Filesystem::setSource(const char *source)
 	if (!PHYSFS_mount(new_search_path.c_str(), nullptr, 1))
 		return false;
 
+	invalidatePathIndex();
+
 	// Save the game source.
 	gameSource = new_search_path;
 
@@ -360,10 +368,16 @@ bool Filesystem::mountFullPath(const char *archive, const char *mountpoint, Moun
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
+	bool success = false;
 	if (permissions == MOUNT_PERMISSIONS_READWRITE)
-		return PHYSFS_mountRW(archive, mountpoint, appendToPath) != 0;
+		success = PHYSFS_mountRW(archive, mountpoint, appendToPath) != 0;
+	else
+		success = PHYSFS_mount(archive, mountpoint, appendToPath) != 0;
+
+	if (success)
+		invalidatePathIndex();
 
-	return PHYSFS_mount(archive, mountpoint, appendToPath) != 0;
+	return success;
 }
 
 bool Filesystem::mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir)
@@ -401,6 +415,7 @@ bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoi
 	if (PHYSFS_mountMemory(data->getData(), data->getSize(), nullptr, archivename, mountpoint, appendToPath) != 0)
 	{
 		mountedData[archivename] = data;
+		invalidatePathIndex();
 		return true;
 	}
 
@@ -417,6 +432,7 @@ bool Filesystem::unmount(const char *archive)
 	if (datait != mountedData.end() && PHYSFS_unmount(archive) != 0)
 	{
 		mountedData.erase(datait);
+		invalidatePathIndex();
 		return true;
 	}
 
@@ -442,7 +458,7 @@ bool Filesystem::unmount(const char *archive)
 	if (PHYSFS_getMountPoint(realPath.c_str()) == nullptr)
 		return false;
 
-	return PHYSFS_unmount(realPath.c_str()) != 0;
+	return unmountFullPath(realPath.c_str());
 }
 
 bool Filesystem::unmountFullPath(const char *fullpath)
@@ -450,7 +466,11 @@ bool Filesystem::unmountFullPath(const char *fullpath)
 	if (!PHYSFS_isInit() || !fullpath)
 		return false;
 
-	return PHYSFS_unmount(fullpath) != 0;
+	if (PHYSFS_unmount(fullpath) == 0)
+		return false;
+
+	invalidatePathIndex();
+	return true;
 }
 
 bool Filesystem::unmount(CommonPath path)
@@ -722,11 +742,247 @@ std::string Filesystem::getRealDirectory(const char *filename) const
 	return std::string(dir);
 }
 
+static void convertStat(const PHYSFS_Stat &stat, Filesystem::Info &info)
+{
+	info.size = (int64) stat.filesize;
+	info.modtime = (int64) stat.modtime;
+	info.readonly = stat.readonly != 0;
+
+	if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
+		info.type = Filesystem::FILETYPE_FILE;
+	else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
+		info.type = Filesystem::FILETYPE_DIRECTORY;
+	else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
+		info.type = Filesystem::FILETYPE_SYMLINK;
+	else
+		info.type = Filesystem::FILETYPE_OTHER;
+}
+
+// Only plain relative paths are looked up in the index. Anything PhysFS would
+// have to sanitize or reject goes through PhysFS directly.
+static bool isIndexablePath(const std::string &path)
+{
+	if (path.empty() || path.find_first_of("\\:") != std::string::npos)
+		return false;
+
+	size_t start = 0;
+	while (true)
+	{
+		size_t end = path.find('/', start);
+		size_t len = (end == std::string::npos ? path.size() : end) - start;
+
+		// Empty, "." and ".." components.
+		if (len == 0 || (len <= 2 && path.compare(start, len, "..", len) == 0))
+			return false;
+
+		if (end == std::string::npos)
+			return true;
+
+		start = end + 1;
+	}
+}
+
+void Filesystem::invalidatePathIndex()
+{
+	love::thread::Lock lock(pathIndexMutex);
+
+	pathIndexValid = false;
+	pathIndex.clear();
+	indexedDirectories.clear();
+	archiveIndices.clear();
+	searchDirectories.clear();
+
+	// Unmounted archives may change on disk.
+	love::thread::Lock ziplock(zipDirectoryMutex);
+	zipDirectories.clear();
+}
+
+static bool isAbsolutePath(const std::string &path)
+{
+#ifdef LOVE_WINDOWS
+	if (path.size() >= 3 && path[1] == ':' && (path[2] == '\\' || path[2] == '/'))
+		return true;
+	return path.compare(0, 2, "\\\\") == 0;
+#else
+	return !path.empty() && path[0] == '/';
+#endif
+}
+
+StrongRef<ZipDirectory> Filesystem::getZipDirectory(const std::string &archive) const
+{
+	love::thread::Lock lock(zipDirectoryMutex);
+
+	auto it = zipDirectories.find(archive);
+	if (it != zipDirectories.end())
+		return it->second;
+
+	StrongRef<ZipDirectory> zip;
+
+	// Archives mounted from memory or through custom I/O don't have a path on
+	// disk.
+	FileType ftype = FILETYPE_MAX_ENUM;
+	if (isAbsolutePath(archive) && getRealPathType(archive, ftype) && ftype == FILETYPE_FILE)
+	{
+		try
+		{
+			zip.set(new ZipDirectory(archive), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
+
+	zipDirectories[archive] = zip;
+	return zip;
+}
+
+void Filesystem::buildPathIndex() const
+{
+	pathIndex.clear();
+	indexedDirectories.clear();
+	archiveIndices.clear();
+	searchDirectories.clear();
+
+	char **searchpath = PHYSFS_getSearchPath();
+	if (searchpath == nullptr)
+		return;
+
+	int index = 0;
+	for (char **i = searchpath; *i != nullptr; i++, index++)
+	{
+		if (isRealDirectory(*i))
+		{
+			// PhysFS stores mount points without a leading slash.
+			const char *mountpoint = PHYSFS_getMountPoint(*i);
+			std::string mp = mountpoint != nullptr && strcmp(mountpoint, "/") != 0 ? mountpoint : "";
+			searchDirectories.push_back({index, *i, mp});
+		}
+		else
+			archiveIndices[*i] = index;
+	}
+
+	PHYSFS_freeList(searchpath);
+
+	pathIndexValid = true;
+}
+
+void Filesystem::indexDirectory(const std::string &dir) const
+{
+	indexedDirectories.insert(dir);
+
+	// Nothing to index without archives.
+	if (archiveIndices.empty())
+		return;
+
+	char **rc = PHYSFS_enumerateFiles(dir.c_str());
+	if (rc == nullptr)
+		return;
+
+	for (char **i = rc; *i != nullptr; i++)
+	{
+		std::string path = dir.empty() ? std::string(*i) : dir + "/" + *i;
+
+		const char *realdir = PHYSFS_getRealDir(path.c_str());
+		if (realdir == nullptr)
+			continue;
+
+		// Files which a directory on disk provides aren't stat'd, lookups go
+		// through PhysFS since the directory may have changed meanwhile.
+		auto it = archiveIndices.find(realdir);
+		if (it == archiveIndices.end())
+		{
+			pathIndex[path] = {-1, Info()};
+			continue;
+		}
+
+		PHYSFS_Stat stat = {};
+		if (!PHYSFS_stat(path.c_str(), &stat))
+			continue;
+
+		PathIndexEntry entry = {it->second, Info()};
+		convertStat(stat, entry.info);
+
+		pathIndex[path] = entry;
+	}
+
+	PHYSFS_freeList(rc);
+}
+
+bool Filesystem::findIndexedPath(const char *filepath, bool &found, Info &info) const
+{
+	if (filepath == nullptr)
+		return false;
+
+	while (*filepath == '/')
+		filepath++;
+
+	std::string path = filepath;
+	if (!isIndexablePath(path))
+		return false;
+
+	love::thread::Lock lock(pathIndexMutex);
+
+	if (!pathIndexValid)
+	{
+		buildPathIndex();
+		if (!pathIndexValid)
+			return false;
+	}
+
+	size_t slash = path.rfind('/');
+	std::string dir = slash == std::string::npos ? std::string() : path.substr(0, slash);
+	if (indexedDirectories.find(dir) == indexedDirectories.end())
+		indexDirectory(dir);
+
+	auto it = pathIndex.find(path);
+
+	int limit = std::numeric_limits<int>::max();
+	if (it != pathIndex.end())
+	{
+		// Provided by a directory on disk, so there's no cached info.
+		if (it->second.searchIndex < 0)
+			return false;
+		limit = it->second.searchIndex;
+	}
+
+	// Mounted directories which take precedence may have gained the file since
+	// the index was built.
+	for (const SearchDirectory &searchdir : searchDirectories)
+	{
+		if (searchdir.searchIndex >= limit)
+			break;
+
+		const std::string &mp = searchdir.mountPoint;
+		if (path.compare(0, mp.size(), mp) != 0)
+		{
+			// The path is the mount point itself or one of its parents.
+			if (mp.compare(0, path.size(), path) == 0 && mp[path.size()] == '/')
+				return false;
+			continue;
+		}
+
+		FileType ftype = FILETYPE_MAX_ENUM;
+		if (getRealPathType(searchdir.realPath + LOVE_PATH_SEPARATOR + path.substr(mp.size()), ftype))
+			return false;
+	}
+
+	found = it != pathIndex.end();
+	if (found)
+		info = it->second.info;
+
+	return true;
+}
+
 bool Filesystem::exists(const char *filepath) const
 {
 	if (!PHYSFS_isInit())
 		return false;
 
+	bool found = false;
+	Info info = {};
+	if (findIndexedPath(filepath, found, info))
+		return found;
+
 	return PHYSFS_exists(filepath) != 0;
 }
 
@@ -735,23 +991,15 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 	if (!PHYSFS_isInit())
 		return false;
 
+	bool found = false;
+	if (findIndexedPath(filepath, found, info))
+		return found;
+
 	PHYSFS_Stat stat = {};
 	if (!PHYSFS_stat(filepath, &stat))
 		return false;
 
-	info.size = (int64) stat.filesize;
-	info.modtime = (int64) stat.modtime;
-	info.readonly = stat.readonly != 0;
-
-	if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
-		info.type = FILETYPE_FILE;
-	else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
-		info.type = FILETYPE_DIRECTORY;
-	else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
-		info.type = FILETYPE_SYMLINK;
-	else
-		info.type = FILETYPE_OTHER;
-
+	convertStat(stat, info);
 	return true;
 }
 
@@ -799,6 +1047,53 @@ FileData* Filesystem::read(const char* filename) const
 	return file.read();
 }
 
+FileData *Filesystem::readMapped(const char *filename) const
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	const char *realdir = PHYSFS_getRealDir(filename);
+
+	if (realdir != nullptr)
+	{
+		std::string path = filename;
+		while (!path.empty() && path[0] == '/')
+			path = path.substr(1);
+
+		// Convert the path in the virtual tree into a path inside realdir.
+		const char *mp = PHYSFS_getMountPoint(realdir);
+		std::string mountpoint = mp != nullptr ? mp : "";
+		while (!mountpoint.empty() && mountpoint[0] == '/')
+			mountpoint = mountpoint.substr(1);
+
+		if (!mountpoint.empty() && path.compare(0, mountpoint.size(), mountpoint) == 0)
+			path = path.substr(mountpoint.size());
+
+		try
+		{
+			if (isRealDirectory(realdir))
+			{
+				std::string fullpath = std::string(realdir) + LOVE_PATH_SEPARATOR + path;
+				return new MappedFileData(fullpath, filename);
+			}
+
+			// Entries stored without compression in a zip archive on disk can
+			// be mapped straight from the archive file.
+			StrongRef<ZipDirectory> zip = getZipDirectory(realdir);
+			int64 offset = 0;
+			int64 size = 0;
+			if (zip.get() != nullptr && zip->findStoredEntry(path, offset, size))
+				return new MappedFileData(realdir, offset, size, filename);
+		}
+		catch (love::Exception &)
+		{
+			// Fall back to a regular read (e.g. for empty files.)
+		}
+	}
+
+	return read(filename);
+}
+
 void Filesystem::write(const char *filename, const void *data, int64 size) const
 {
 	File file(filename, File::MODE_WRITE);
@@ -834,12 +1129,150 @@ bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &it
 	return true;
 }
 
+bool Filesystem::getDirectoryItemsInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items) const
+{
+	if (!PHYSFS_isInit())
+		return false;
+
+	Info info = {};
+	if (!getInfo(dir, info) || info.type != FILETYPE_DIRECTORY)
+		return false;
+
+	std::string path = dir;
+	while (!path.empty() && path.back() == '/')
+		path.pop_back();
+
+	addDirectoryItemsInfo(path, "", recursive, items);
+	return true;
+}
+
+void Filesystem::addDirectoryItemsInfo(const std::string &dir, const std::string &prefix, bool recursive, std::vector<DirectoryItem> &items) const
+{
+	char **rc = PHYSFS_enumerateFiles(dir.c_str());
+	if (rc == nullptr)
+		return;
+
+	for (char **i = rc; *i != nullptr; i++)
+	{
+		std::string fullpath = dir.empty() ? std::string(*i) : dir + "/" + *i;
+
+		// Goes through the path index, so files in archives aren't resolved
+		// through every mounted archive again.
+		DirectoryItem item;
+		if (!getInfo(fullpath.c_str(), item.info))
+			continue;
+
+		item.path = prefix + *i;
+		items.push_back(item);
+
+		// Symlinks aren't followed, so cycles aren't possible.
+		if (recursive && item.info.type == FILETYPE_DIRECTORY)
+			addDirectoryItemsInfo(fullpath, item.path + "/", recursive, items);
+	}
+
+	PHYSFS_freeList(rc);
+}
+
+static std::string normalizePath(const char *dir)
+{
+	std::string path = dir != nullptr ? dir : "";
+	while (!path.empty() && path[0] == '/')
+		path = path.substr(1);
+	while (!path.empty() && path.back() == '/')
+		path.pop_back();
+	return path;
+}
+
+bool Filesystem::watch(const char *dir)
+{
+	if (!PHYSFS_isInit() || !FileWatcher::isSupported())
+		return false;
+
+	std::string path = normalizePath(dir);
+	if (!path.empty() && !isIndexablePath(path))
+		return false;
+
+	if (fileWatcher.get() == nullptr)
+		fileWatcher.set(new FileWatcher(), Acquire::NORETAIN);
+
+	char **searchpath = PHYSFS_getSearchPath();
+	if (searchpath == nullptr)
+		return false;
+
+	bool watching = false;
+
+	// Archives can't change while they're mounted, so only directories on disk
+	// are watched.
+	for (char **i = searchpath; *i != nullptr; i++)
+	{
+		if (!isRealDirectory(*i))
+			continue;
+
+		// PhysFS stores mount points without a leading slash.
+		const char *mp = PHYSFS_getMountPoint(*i);
+		std::string mountpoint = mp != nullptr && strcmp(mp, "/") != 0 ? mp : "";
+
+		std::string fullpath;
+		std::string virtualroot;
+
+		if (mountpoint.empty() || path.compare(0, mountpoint.size(), mountpoint) == 0)
+		{
+			// The watched directory is inside this mount.
+			std::string relative = path.substr(std::min(mountpoint.size(), path.size()));
+			fullpath = relative.empty() ? std::string(*i) : std::string(*i) + LOVE_PATH_SEPARATOR + relative;
+			virtualroot = path;
+		}
+		else if (path.empty() || (mountpoint.compare(0, path.size(), path) == 0 && mountpoint[path.size()] == '/'))
+		{
+			// This mount is inside the watched directory.
+			fullpath = *i;
+			virtualroot = mountpoint.substr(0, mountpoint.size() - 1);
+		}
+		else
+			continue;
+
+		if (isRealDirectory(fullpath) && fileWatcher->watch(path, fullpath, virtualroot))
+			watching = true;
+	}
+
+	PHYSFS_freeList(searchpath);
+	return watching;
+}
+
+void Filesystem::unwatch(const char *dir)
+{
+	if (fileWatcher.get() != nullptr)
+		fileWatcher->unwatch(normalizePath(dir));
+}
+
+LogFile *Filesystem::newLogFile(const char *filename, const LogFile::Settings &settings)
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	if (!setupWriteDirectory())
+		throw love::Exception("Could not set write directory.");
+
+	std::string path = normalizePath(filename);
+	if (!isIndexablePath(path))
+		throw love::Exception("Invalid log file path: %s", filename);
+
+	const char *writedir = PHYSFS_getWriteDir();
+	if (writedir == nullptr)
+		throw love::Exception("Could not set write directory.");
+
+	// The flusher thread writes to the file directly, bypassing PhysFS.
+	std::string fullpath = std::string(writedir) + LOVE_PATH_SEPARATOR + path;
+	return new LogFile(fullpath, path, settings);
+}
+
 void Filesystem::setSymlinksEnabled(bool enable)
 {
 	if (!PHYSFS_isInit())
 		return;
 
 	PHYSFS_permitSymbolicLinks(enable ? 1 : 0);
+	invalidatePathIndex();
 }
 
 bool Filesystem::areSymlinksEnabled() const
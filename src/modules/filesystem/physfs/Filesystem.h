@@ -25,9 +25,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // LOVE
 #include "filesystem/Filesystem.h"
+#include "thread/threads.h"
+#include "filesystem/FileWatcher.h"
+#include "ZipDirectory.h"
 
 namespace love
 {
@@ -91,10 +97,17 @@ public:
 
 	FileData *read(const char *filename, int64 size) const override;
 	FileData *read(const char *filename) const override;
+	FileData *readMapped(const char *filename) const override;
 	void write(const char *filename, const void *data, int64 size) const override;
 	void append(const char *filename, const void *data, int64 size) const override;
 
 	bool getDirectoryItems(const char *dir, std::vector<std::string> &items) override;
+	bool getDirectoryItemsInfo(const char *dir, bool recursive, std::vector<DirectoryItem> &items) const override;
+
+	bool watch(const char *dir) override;
+	void unwatch(const char *dir) override;
+
+	LogFile *newLogFile(const char *filename, const LogFile::Settings &settings) override;
 
 	void setSymlinksEnabled(bool enable) override;
 	bool areSymlinksEnabled() const override;
@@ -113,8 +126,38 @@ private:
 		MountPermissions permissions;
 	};
 
+	// An entry in the path index. Archive contents can't change while they're
+	// mounted, so their info is cached. Paths provided by a directory on disk
+	// have a searchIndex of -1, no info, and are always looked up through
+	// PhysFS.
+	struct PathIndexEntry
+	{
+		int searchIndex;
+		Info info;
+	};
+
+	// A mounted directory on disk, which may gain or lose files at any time.
+	struct SearchDirectory
+	{
+		int searchIndex;
+		std::string realPath;
+		std::string mountPoint;
+	};
+
 	bool mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir);
 
+	// Returns false if the index can't answer the query and PhysFS should be
+	// used instead. Otherwise 'found' and 'info' hold the result.
+	bool findIndexedPath(const char *filepath, bool &found, Info &info) const;
+	void buildPathIndex() const;
+	void indexDirectory(const std::string &dir) const;
+	void invalidatePathIndex();
+
+	void addDirectoryItemsInfo(const std::string &dir, const std::string &prefix, bool recursive, std::vector<DirectoryItem> &items) const;
+
+	// Returns null if the archive at the given full path isn't a zip file.
+	StrongRef<ZipDirectory> getZipDirectory(const std::string &archive) const;
+
 	// Contains the current working directory (UTF8).
 	std::string cwd;
 
@@ -137,6 +180,24 @@ private:
 
 	std::map<std::string, StrongRef<Data>> mountedData;
 
+	// Lookup cache for the files mounted archives provide, filled in one
+	// directory at a time as lookups reach it and cleared after the set of
+	// mounted archives and directories changes. Files in directories on disk
+	// aren't indexed; they're checked directly.
+	mutable love::thread::MutexRef pathIndexMutex;
+	mutable bool pathIndexValid;
+	mutable std::unordered_map<std::string, PathIndexEntry> pathIndex;
+	mutable std::unordered_set<std::string> indexedDirectories;
+	mutable std::map<std::string, int> archiveIndices;
+	mutable std::vector<SearchDirectory> searchDirectories;
+
+	// Central directories of mounted zip archives, used to map uncompressed
+	// entries directly. Failed lookups are stored as null.
+	mutable love::thread::MutexRef zipDirectoryMutex;
+	mutable std::map<std::string, StrongRef<ZipDirectory>> zipDirectories;
+
+	StrongRef<FileWatcher> fileWatcher;
+
 	std::string fullPaths[COMMONPATH_MAX_ENUM];
 
 	CommonPathMountInfo commonPathMountInfo[COMMONPATH_MAX_ENUM];
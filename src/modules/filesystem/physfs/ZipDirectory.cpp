@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ZipDirectory.h"
+#include "common/Exception.h"
+#include "filesystem/NativeFile.h"
+
+// STD
+#include <algorithm>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+static const uint32 LOCAL_HEADER_SIG = 0x04034b50;
+static const uint32 CENTRAL_DIR_SIG = 0x02014b50;
+static const uint32 END_OF_CENTRAL_DIR_SIG = 0x06054b50;
+static const uint32 ZIP64_END_OF_CENTRAL_DIR_SIG = 0x06064b50;
+static const uint32 ZIP64_LOCATOR_SIG = 0x07064b50;
+
+static const int64 LOCAL_HEADER_SIZE = 30;
+static const int64 CENTRAL_DIR_ENTRY_SIZE = 46;
+static const int64 END_OF_CENTRAL_DIR_SIZE = 22;
+static const int64 ZIP64_END_OF_CENTRAL_DIR_SIZE = 56;
+static const int64 ZIP64_LOCATOR_SIZE = 20;
+
+static inline uint16 readU16(const uint8 *p)
+{
+	return (uint16) (p[0] | (p[1] << 8));
+}
+
+static inline uint32 readU32(const uint8 *p)
+{
+	return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+static inline uint64 readU64(const uint8 *p)
+{
+	return (uint64) readU32(p) | ((uint64) readU32(p + 4) << 32);
+}
+
+static bool readAt(NativeFile *file, int64 pos, void *dst, int64 size)
+{
+	if (pos < 0 || !file->seek(pos, Stream::SEEKORIGIN_BEGIN))
+		return false;
+	return file->read(dst, size) == size;
+}
+
+ZipDirectory::ZipDirectory(const std::string &fullpath)
+	: path(fullpath)
+	, archiveStart(0)
+{
+	StrongRef<NativeFile> file(new NativeFile(fullpath, File::MODE_READ), Acquire::NORETAIN);
+
+	int64 filesize = file->getSize();
+	if (filesize < END_OF_CENTRAL_DIR_SIZE)
+		throw love::Exception("%s is not a zip archive.", fullpath.c_str());
+
+	// The end of central directory record is followed by a comment of up to
+	// 64 KB, so search backwards for its signature.
+	int64 tailsize = std::min(filesize, END_OF_CENTRAL_DIR_SIZE + 0xFFFF);
+	std::vector<uint8> tail((size_t) tailsize);
+	if (!readAt(file, filesize - tailsize, tail.data(), tailsize))
+		throw love::Exception("Could not read %s.", fullpath.c_str());
+
+	int64 eocdpos = -1;
+	for (int64 i = tailsize - END_OF_CENTRAL_DIR_SIZE; i >= 0; i--)
+	{
+		if (readU32(&tail[(size_t) i]) == END_OF_CENTRAL_DIR_SIG)
+		{
+			eocdpos = i;
+			break;
+		}
+	}
+
+	if (eocdpos < 0)
+		throw love::Exception("%s is not a zip archive.", fullpath.c_str());
+
+	const uint8 *eocd = &tail[(size_t) eocdpos];
+	uint64 entrycount = readU16(eocd + 10);
+	uint64 dirsize = readU32(eocd + 12);
+	uint64 dirofs = readU32(eocd + 16);
+
+	// The central directory ends where the record following it begins.
+	int64 dirend = filesize - tailsize + eocdpos;
+
+	if (entrycount == 0xFFFF || dirsize == 0xFFFFFFFF || dirofs == 0xFFFFFFFF)
+	{
+		// Zip64 archives have a locator right before the regular record, which
+		// in turn follows the zip64 end of central directory record.
+		uint8 locator[ZIP64_LOCATOR_SIZE];
+		if (!readAt(file, dirend - ZIP64_LOCATOR_SIZE, locator, ZIP64_LOCATOR_SIZE) || readU32(locator) != ZIP64_LOCATOR_SIG)
+			throw love::Exception("Unsupported zip archive: %s", fullpath.c_str());
+
+		int64 recordpos = dirend - ZIP64_LOCATOR_SIZE - ZIP64_END_OF_CENTRAL_DIR_SIZE;
+
+		uint8 record[ZIP64_END_OF_CENTRAL_DIR_SIZE];
+		if (!readAt(file, recordpos, record, ZIP64_END_OF_CENTRAL_DIR_SIZE) || readU32(record) != ZIP64_END_OF_CENTRAL_DIR_SIG)
+			throw love::Exception("Unsupported zip archive: %s", fullpath.c_str());
+
+		entrycount = readU64(record + 32);
+		dirsize = readU64(record + 40);
+		dirofs = readU64(record + 48);
+		dirend = recordpos;
+	}
+
+	if (dirsize > (uint64) dirend || dirofs > (uint64) dirend - dirsize)
+		throw love::Exception("Corrupt zip archive: %s", fullpath.c_str());
+
+	// Offsets in the archive are relative to its start, which isn't the start
+	// of the file when something is prepended to it.
+	archiveStart = dirend - (int64) dirsize - (int64) dirofs;
+
+	std::vector<uint8> dir((size_t) dirsize);
+	if (dirsize > 0 && !readAt(file, dirend - (int64) dirsize, dir.data(), (int64) dirsize))
+		throw love::Exception("Could not read %s.", fullpath.c_str());
+
+	size_t pos = 0;
+	for (uint64 i = 0; i < entrycount; i++)
+	{
+		if (pos + CENTRAL_DIR_ENTRY_SIZE > dir.size() || readU32(&dir[pos]) != CENTRAL_DIR_SIG)
+			throw love::Exception("Corrupt zip archive: %s", fullpath.c_str());
+
+		const uint8 *entry = &dir[pos];
+
+		uint16 version = readU16(entry + 4);
+		uint16 flags = readU16(entry + 8);
+		uint16 method = readU16(entry + 10);
+		uint64 compressedsize = readU32(entry + 20);
+		uint64 uncompressedsize = readU32(entry + 24);
+		size_t namelen = readU16(entry + 28);
+		size_t extralen = readU16(entry + 30);
+		size_t commentlen = readU16(entry + 32);
+		uint32 externalattr = readU32(entry + 38);
+		uint64 localheaderofs = readU32(entry + 42);
+
+		if (pos + CENTRAL_DIR_ENTRY_SIZE + namelen + extralen + commentlen > dir.size())
+			throw love::Exception("Corrupt zip archive: %s", fullpath.c_str());
+
+		std::string name((const char *) entry + CENTRAL_DIR_ENTRY_SIZE, namelen);
+
+		// The zip64 extended information field holds the values which didn't
+		// fit in the regular fields, in this order.
+		const uint8 *extra = entry + CENTRAL_DIR_ENTRY_SIZE + namelen;
+		for (size_t x = 0; x + 4 <= extralen;)
+		{
+			uint16 id = readU16(extra + x);
+			size_t len = readU16(extra + x + 2);
+			if (x + 4 + len > extralen)
+				break;
+
+			if (id == 0x0001)
+			{
+				const uint8 *field = extra + x + 4;
+				const uint8 *fieldend = field + len;
+
+				for (uint64 *value : {&uncompressedsize, &compressedsize, &localheaderofs})
+				{
+					if (*value == 0xFFFFFFFF && field + 8 <= fieldend)
+					{
+						*value = readU64(field);
+						field += 8;
+					}
+				}
+			}
+
+			x += 4 + len;
+		}
+
+		pos += CENTRAL_DIR_ENTRY_SIZE + namelen + extralen + commentlen;
+
+		// Skip directories, compressed or encrypted entries, and symlinks
+		// (which PhysFS resolves itself.)
+		bool symlink = ((externalattr >> 16) & 0170000) == 0120000;
+		if (name.empty() || name.back() == '/' || method != 0 || (flags & 0x1) != 0
+			|| compressedsize != uncompressedsize || uncompressedsize == 0 || symlink)
+			continue;
+
+		// Match PhysFS's handling of paths from DOS-based zip tools.
+		if (((version >> 8) & 0xFF) == 0)
+			std::replace(name.begin(), name.end(), '\\', '/');
+
+		storedEntries[name] = {(int64) localheaderofs, (int64) uncompressedsize};
+	}
+}
+
+ZipDirectory::~ZipDirectory()
+{
+}
+
+bool ZipDirectory::findStoredEntry(const std::string &name, int64 &offset, int64 &size) const
+{
+	auto it = storedEntries.find(name);
+	if (it == storedEntries.end())
+		return false;
+
+	try
+	{
+		StrongRef<NativeFile> file(new NativeFile(path, File::MODE_READ), Acquire::NORETAIN);
+
+		// The local header's name and extra field lengths can differ from the
+		// central directory's, so the data offset has to come from it.
+		int64 headerpos = archiveStart + it->second.localHeaderOffset;
+
+		uint8 header[LOCAL_HEADER_SIZE];
+		if (!readAt(file, headerpos, header, LOCAL_HEADER_SIZE) || readU32(header) != LOCAL_HEADER_SIG)
+			return false;
+
+		offset = headerpos + LOCAL_HEADER_SIZE + readU16(header + 26) + readU16(header + 28);
+		size = it->second.size;
+
+		return offset + size <= file->getSize();
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_ZIP_DIRECTORY_H
+#define LOVE_FILESYSTEM_PHYSFS_ZIP_DIRECTORY_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+
+// STD
+#include <string>
+#include <unordered_map>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+/**
+ * Reads the central directory of a zip archive on disk, so the location of
+ * entries stored without compression can be found and the entries mapped into
+ * memory directly instead of being read through PhysFS.
+ **/
+class ZipDirectory : public love::Object
+{
+public:
+
+	/**
+	 * Throws if the file can't be read or isn't a zip archive. Archives with
+	 * data in front of them (e.g. fused executables) are supported.
+	 **/
+	ZipDirectory(const std::string &fullpath);
+	virtual ~ZipDirectory();
+
+	/**
+	 * Finds the location of the data of an uncompressed, unencrypted entry in
+	 * the archive file. Returns false if the entry doesn't exist or its data
+	 * can't be used as-is.
+	 **/
+	bool findStoredEntry(const std::string &name, int64 &offset, int64 &size) const;
+
+	const std::string &getPath() const { return path; }
+
+private:
+
+	struct Entry
+	{
+		int64 localHeaderOffset;
+		int64 size;
+	};
+
+	std::string path;
+
+	// Offset of the start of the archive in the file.
+	int64 archiveStart;
+
+	// Only entries which can be mapped directly are stored.
+	std::unordered_map<std::string, Entry> storedEntries;
+
+}; // ZipDirectory
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_ZIP_DIRECTORY_H
@@ -23,9 +23,11 @@
 #include "wrap_Filesystem.h"
 #include "wrap_File.h"
 #include "wrap_NativeFile.h"
+#include "wrap_LogFile.h"
 #include "wrap_FileData.h"
 #include "data/wrap_Data.h"
 #include "data/wrap_DataModule.h"
+#include "thread/wrap_Channel.h"
 
 #include "physfs/Filesystem.h"
 
@@ -570,6 +572,131 @@ int w_getInfo(lua_State *L)
 	return 1;
 }
 
+int w_getDirectoryItemsInfo(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	bool recursive = luax_optboolean(L, 2, false);
+
+	std::vector<Filesystem::DirectoryItem> items;
+	if (!instance()->getDirectoryItemsInfo(dir, recursive, items))
+		return luax_ioError(L, "Could not open directory %s.", dir);
+
+	lua_createtable(L, (int) items.size(), 0);
+
+	for (int i = 0; i < (int) items.size(); i++)
+	{
+		Filesystem::DirectoryItem &item = items[i];
+
+		const char *typestr = nullptr;
+		if (!Filesystem::getConstant(item.info.type, typestr))
+			return luaL_error(L, "Unknown file type.");
+
+		lua_createtable(L, 0, 5);
+
+		luax_pushstring(L, item.path);
+		lua_setfield(L, -2, "path");
+
+		lua_pushstring(L, typestr);
+		lua_setfield(L, -2, "type");
+
+		luax_pushboolean(L, item.info.readonly);
+		lua_setfield(L, -2, "readonly");
+
+		// Lua numbers (doubles) can't fit the full range of 64 bit ints.
+		int64 size = std::min<int64>(item.info.size, 0x20000000000000LL);
+		if (size >= 0)
+		{
+			lua_pushnumber(L, (lua_Number) size);
+			lua_setfield(L, -2, "size");
+		}
+
+		int64 modtime = std::min<int64>(item.info.modtime, 0x20000000000000LL);
+		if (modtime >= 0)
+		{
+			lua_pushnumber(L, (lua_Number) modtime);
+			lua_setfield(L, -2, "modtime");
+		}
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_getDirectoryItemsInfoAsync(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	love::thread::Channel *channel = love::thread::luax_checkchannel(L, 2);
+	bool recursive = luax_optboolean(L, 3, false);
+
+	auto type = recursive ? AsyncIO::REQUEST_LIST_DIRECTORY_RECURSIVE : AsyncIO::REQUEST_LIST_DIRECTORY;
+
+	int64 id = 0;
+	luax_catchexcept(L, [&]() { id = instance()->requestAsync(type, dir, nullptr, channel); });
+
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
+int w_newLogFile(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	LogFile::Settings settings;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_getfield(L, 2, "flushinterval");
+		settings.flushInterval = luaL_optnumber(L, -1, settings.flushInterval);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "buffersize");
+		settings.bufferSize = (int64) luaL_optnumber(L, -1, (lua_Number) settings.bufferSize);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "sync");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!LogFile::getConstant(str, settings.syncMode))
+				return luax_enumerror(L, "log file sync mode", LogFile::getConstants(settings.syncMode), str);
+		}
+		lua_pop(L, 1);
+	}
+
+	LogFile *file = nullptr;
+	try
+	{
+		file = instance()->newLogFile(filename, settings);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, file);
+	file->release();
+	return 1;
+}
+
+int w_watch(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = instance()->watch(dir); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_unwatch(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+	instance()->unwatch(dir);
+	return 0;
+}
+
 int w_createDirectory(lua_State *L)
 {
 	const char *arg = luaL_checkstring(L, 1);
@@ -627,6 +754,62 @@ int w_read(lua_State *L)
 	return 2;
 }
 
+int w_readMapped(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	FileData *data = nullptr;
+	try
+	{
+		data = instance()->readMapped(filename);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
+int w_readMultiple(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	bool mapped = luax_optboolean(L, 2, false);
+
+	std::vector<std::string> filenames;
+	int count = (int) luax_objlen(L, 1);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		if (!lua_isstring(L, -1))
+			return luaL_error(L, "Expected a filename string at index %d.", i);
+		filenames.push_back(lua_tostring(L, -1));
+		lua_pop(L, 1);
+	}
+
+	std::vector<StrongRef<FileData>> files;
+	try
+	{
+		instance()->readMultiple(filenames, mapped, files);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushtype(L, files[i].get());
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 static int w_write_or_append(lua_State *L, File::Mode mode)
 {
 	const char *filename = luaL_checkstring(L, 1);
@@ -674,6 +857,61 @@ int w_append(lua_State *L)
 	return w_write_or_append(L, File::MODE_APPEND);
 }
 
+int w_readAsync(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	love::thread::Channel *channel = love::thread::luax_checkchannel(L, 2);
+	bool mapped = luax_optboolean(L, 3, false);
+
+	auto type = mapped ? AsyncIO::REQUEST_READ_MAPPED : AsyncIO::REQUEST_READ;
+
+	int64 id = 0;
+	luax_catchexcept(L, [&]() { id = instance()->requestAsync(type, filename, nullptr, channel); });
+
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
+static int w_writeAsync_or_appendAsync(lua_State *L, AsyncIO::RequestType type)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	StrongRef<love::Data> data;
+
+	// Data is referenced rather than copied, so it shouldn't be modified
+	// until the request completes. Strings are copied.
+	if (luax_istype(L, 2, love::Data::type))
+		data.set(luax_totype<love::Data>(L, 2));
+	else if (lua_isstring(L, 2))
+	{
+		size_t len = 0;
+		const char *input = lua_tolstring(L, 2, &len);
+		luax_catchexcept(L, [&]() { data.set(instance()->newFileData(input, len, filename), Acquire::NORETAIN); });
+	}
+	else
+		return luaL_argerror(L, 2, "string or Data expected");
+
+	love::thread::Channel *channel = nullptr;
+	if (!lua_isnoneornil(L, 3))
+		channel = love::thread::luax_checkchannel(L, 3);
+
+	int64 id = 0;
+	luax_catchexcept(L, [&]() { id = instance()->requestAsync(type, filename, data, channel); });
+
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
+int w_writeAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, AsyncIO::REQUEST_WRITE);
+}
+
+int w_appendAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, AsyncIO::REQUEST_APPEND);
+}
+
 int w_getDirectoryItems(lua_State *L)
 {
 	const char *dir = luaL_checkstring(L, 1);
@@ -712,6 +950,103 @@ int w_lines(lua_State *L)
 	return 1;
 }
 
+static const char *BYTECODE_CACHE_DIR = "bytecodecache";
+
+// Identifies the source file and the interpreter which compiled the cached
+// bytecode. Stored at the start of each cache file; a mismatch means the
+// cached chunk is stale.
+static std::string getBytecodeCacheKey(const std::string &filename, const Filesystem::Info &info)
+{
+	std::stringstream ss;
+	ss << filename << "\n" << info.size << "\n" << info.modtime << "\n" << LUA_RELEASE;
+#ifdef LUAJIT_VERSION
+	ss << "\n" << LUAJIT_VERSION;
+#endif
+	ss << "\n" << sizeof(void *) << "\n" << sizeof(lua_Number);
+	return ss.str() + '\0';
+}
+
+static std::string getBytecodeCachePath(const std::string &filename)
+{
+	// FNV-1a, so nested paths map to a single flat directory.
+	uint64 hash = 14695981039346656037ULL;
+	for (char c : filename)
+	{
+		hash ^= (unsigned char) c;
+		hash *= 1099511628211ULL;
+	}
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long) hash);
+	return std::string(BYTECODE_CACHE_DIR) + "/" + name + ".luac";
+}
+
+static int writeBytecode(lua_State *, const void *p, size_t size, void *ud)
+{
+	((std::string *) ud)->append((const char *) p, size);
+	return 0;
+}
+
+// Pushes the cached chunk for the given source file, if there's an up to date
+// one. Returns false (and pushes nothing) otherwise.
+static bool loadCachedBytecode(lua_State *L, const std::string &filename, const std::string &key)
+{
+	Data *data = nullptr;
+	try
+	{
+		std::string path = getBytecodeCachePath(filename);
+		if (!instance()->exists(path.c_str()))
+			return false;
+		data = instance()->read(path.c_str());
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	const char *bytes = (const char *) data->getData();
+	size_t size = data->getSize();
+
+	bool loaded = false;
+	if (size > key.size() && memcmp(bytes, key.data(), key.size()) == 0)
+	{
+		std::string name = "@" + filename;
+		if (luaL_loadbuffer(L, bytes + key.size(), size - key.size(), name.c_str()) == 0)
+			loaded = true;
+		else
+			lua_pop(L, 1);
+	}
+
+	data->release();
+	return loaded;
+}
+
+// Dumps the function at the top of the stack to the cache. Failures are
+// ignored, the cache is only an optimization.
+static void saveCachedBytecode(lua_State *L, const std::string &filename, const std::string &key)
+{
+	std::string bytecode = key;
+
+#if LUA_VERSION_NUM >= 503
+	int status = lua_dump(L, writeBytecode, &bytecode, 0);
+#else
+	int status = lua_dump(L, writeBytecode, &bytecode);
+#endif
+
+	if (status != 0)
+		return;
+
+	try
+	{
+		std::string path = getBytecodeCachePath(filename);
+		instance()->createDirectory(BYTECODE_CACHE_DIR);
+		instance()->write(path.c_str(), bytecode.data(), (int64) bytecode.size());
+	}
+	catch (love::Exception &)
+	{
+	}
+}
+
 int w_load(lua_State *L)
 {
 	std::string filename = std::string(luaL_checkstring(L, 1));
@@ -726,6 +1061,19 @@ int w_load(lua_State *L)
 			return luax_enumerror(L, "load mode", Filesystem::getConstants(loadMode), mode);
 	}
 
+	// Text-only loads can't accept bytecode, so they always parse the source.
+	std::string cachekey;
+	if (instance()->isBytecodeCacheEnabled() && loadMode != Filesystem::LOADMODE_TEXT)
+	{
+		Filesystem::Info info = {};
+		if (instance()->getInfo(filename.c_str(), info) && info.type == Filesystem::FILETYPE_FILE)
+		{
+			cachekey = getBytecodeCacheKey(filename, info);
+			if (loadCachedBytecode(L, filename, cachekey))
+				return 1;
+		}
+	}
+
 	Data *data = nullptr;
 	try
 	{
@@ -736,6 +1084,10 @@ int w_load(lua_State *L)
 		return luax_ioError(L, "%s", e.what());
 	}
 
+	// Don't cache files which are already precompiled.
+	if (data->getSize() > 0 && *(const char *) data->getData() == LUA_SIGNATURE[0])
+		cachekey.clear();
+
 	int status;
 
 #if (LUA_VERSION_NUM > 501) || defined(LUA_JITLIBNAME)
@@ -765,10 +1117,24 @@ int w_load(lua_State *L)
 	case LUA_ERRSYNTAX:
 		return luaL_error(L, "Syntax error: %s\n", lua_tostring(L, -1));
 	default: // success
+		if (!cachekey.empty())
+			saveCachedBytecode(L, filename, cachekey);
 		return 1;
 	}
 }
 
+int w_setBytecodeCacheEnabled(lua_State *L)
+{
+	instance()->setBytecodeCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isBytecodeCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isBytecodeCacheEnabled());
+	return 1;
+}
+
 int w_setSymlinksEnabled(lua_State *L)
 {
 	instance()->setSymlinksEnabled(luax_checkboolean(L, 1));
@@ -1031,11 +1397,23 @@ static const luaL_Reg functions[] =
 	{ "createDirectory", w_createDirectory },
 	{ "remove", w_remove },
 	{ "read", w_read },
+	{ "readMapped", w_readMapped },
+	{ "readMultiple", w_readMultiple },
 	{ "write", w_write },
 	{ "append", w_append },
+	{ "readAsync", w_readAsync },
+	{ "writeAsync", w_writeAsync },
+	{ "appendAsync", w_appendAsync },
 	{ "getDirectoryItems", w_getDirectoryItems },
+	{ "getDirectoryItemsInfo", w_getDirectoryItemsInfo },
+	{ "getDirectoryItemsInfoAsync", w_getDirectoryItemsInfoAsync },
+	{ "newLogFile", w_newLogFile },
+	{ "watch", w_watch },
+	{ "unwatch", w_unwatch },
 	{ "lines", w_lines },
 	{ "load", w_load },
+	{ "setBytecodeCacheEnabled", w_setBytecodeCacheEnabled },
+	{ "isBytecodeCacheEnabled", w_isBytecodeCacheEnabled },
 	{ "exists", w_exists },
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
@@ -1057,6 +1435,7 @@ static const lua_CFunction types[] =
 	luaopen_file,
 	luaopen_nativefile,
 	luaopen_filedata,
+	luaopen_logfile,
 	0
 };
 
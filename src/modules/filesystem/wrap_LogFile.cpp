@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_LogFile.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+LogFile *luax_checklogfile(lua_State *L, int idx)
+{
+	return luax_checktype<LogFile>(L, idx);
+}
+
+int w_LogFile_write(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+
+	const void *data = nullptr;
+	size_t size = 0;
+
+	if (luax_istype(L, 2, love::Data::type))
+	{
+		love::Data *d = luax_totype<love::Data>(L, 2);
+		data = d->getData();
+		size = d->getSize();
+	}
+	else if (lua_isstring(L, 2))
+		data = lua_tolstring(L, 2, &size);
+	else
+		return luax_typerror(L, 2, "string or Data");
+
+	luax_catchexcept(L, [&]() { file->write(data, (int64) size); });
+	return 0;
+}
+
+int w_LogFile_flush(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	luax_catchexcept(L, [&]() { file->flush(); });
+	return 0;
+}
+
+int w_LogFile_close(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	file->close();
+	return 0;
+}
+
+int w_LogFile_isOpen(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	luax_pushboolean(L, file->isOpen());
+	return 1;
+}
+
+int w_LogFile_getFilename(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	luax_pushstring(L, file->getFilename());
+	return 1;
+}
+
+int w_LogFile_getSyncMode(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	const char *str = nullptr;
+	if (!LogFile::getConstant(file->getSettings().syncMode, str))
+		return luaL_error(L, "Unknown sync mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_LogFile_getFlushInterval(lua_State *L)
+{
+	LogFile *file = luax_checklogfile(L, 1);
+	lua_pushnumber(L, file->getSettings().flushInterval);
+	return 1;
+}
+
+static const luaL_Reg w_LogFile_functions[] =
+{
+	{ "write", w_LogFile_write },
+	{ "flush", w_LogFile_flush },
+	{ "close", w_LogFile_close },
+	{ "isOpen", w_LogFile_isOpen },
+	{ "getFilename", w_LogFile_getFilename },
+	{ "getSyncMode", w_LogFile_getSyncMode },
+	{ "getFlushInterval", w_LogFile_getFlushInterval },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_logfile(lua_State *L)
+{
+	return luax_register_type(L, &LogFile::type, w_LogFile_functions, nullptr);
+}
+
+} // filesystem
+} // love
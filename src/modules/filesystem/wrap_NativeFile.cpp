@@ -31,9 +31,34 @@ NativeFile *luax_checknativefile(lua_State *L, int idx)
 	return luax_checktype<NativeFile>(L, idx);
 }
 
+int w_NativeFile_readMapped(lua_State *L)
+{
+	NativeFile *file = luax_checknativefile(L, 1);
+
+	FileData *data = nullptr;
+	try
+	{
+		data = file->readMapped();
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
+static const luaL_Reg w_NativeFile_functions[] =
+{
+	{ "readMapped", w_NativeFile_readMapped },
+	{ 0, 0 }
+};
+
 extern "C" int luaopen_nativefile(lua_State *L)
 {
-	return luax_register_type(L, &NativeFile::type, w_File_functions, nullptr);
+	return luax_register_type(L, &NativeFile::type, w_File_functions, w_NativeFile_functions, nullptr);
 }
 
 } // filesystem
@@ -28,8 +28,10 @@
 #include <sstream>
 #include <vector>
 #include <algorithm>
+#include <unordered_set>
 
 // C
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 
@@ -355,6 +357,214 @@ GlyphData *BMFontRasterizer::getGlyphDataForIndex(int index) const
 	return g;
 }
 
+image::ImageData *BMFontRasterizer::getGlyphPage(int index, int &page, int &x, int &y, GlyphMetrics &metrics) const
+{
+	if (index < 0 || index >= (int) characters.size())
+		return nullptr;
+
+	const BMFontCharacter &c = characters[index];
+	const auto &imagepair = images.find(c.page);
+
+	if (imagepair == images.end())
+		return nullptr;
+
+	page = c.page;
+	x = c.x;
+	y = c.y;
+	metrics = c.metrics;
+
+	return imagepair->second.get();
+}
+
+void BMFontRasterizer::bake(const Rasterizer *source, const std::vector<uint32> &glyphs, int pagesize, const std::string &pagename, std::string &fontdef, std::vector<StrongRef<image::ImageData>> &pages)
+{
+	if (source->isSDF())
+		throw love::Exception("Signed distance field fonts cannot be baked into a BMFont.");
+
+	if (pagesize <= 0)
+		throw love::Exception("Invalid BMFont page size: %d", pagesize);
+
+	// Transparent pixels between glyphs, so linear filtering doesn't pick up
+	// neighbouring glyphs.
+	const int padding = 1;
+
+	std::vector<StrongRef<GlyphData>> glyphdata;
+	glyphdata.reserve(glyphs.size());
+
+	std::unordered_set<uint32> seen;
+
+	for (uint32 glyph : glyphs)
+	{
+		if (glyph == 0 || !source->hasGlyph(glyph) || !seen.insert(glyph).second)
+			continue;
+
+		glyphdata.emplace_back(source->getGlyphData(glyph), Acquire::NORETAIN);
+	}
+
+	// Tall glyphs first, so each shelf wastes as little height as possible.
+	std::vector<size_t> order(glyphdata.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+	{
+		return glyphdata[a]->getHeight() > glyphdata[b]->getHeight();
+	});
+
+	struct Placement
+	{
+		int page;
+		int x;
+		int y;
+	};
+
+	std::vector<Placement> placements(glyphdata.size(), {0, 0, 0});
+	std::vector<int> pageheights;
+
+	int shelfx = padding;
+	int shelfy = padding;
+	int shelfheight = 0;
+
+	for (size_t i : order)
+	{
+		int w = glyphdata[i]->getWidth();
+		int h = glyphdata[i]->getHeight();
+
+		if (w <= 0 || h <= 0)
+			continue;
+
+		if (w + padding * 2 > pagesize || h + padding * 2 > pagesize)
+			throw love::Exception("Glyph %u does not fit in a %dx%d BMFont page.", glyphdata[i]->getGlyph(), pagesize, pagesize);
+
+		if (pageheights.empty())
+			pageheights.push_back(0);
+
+		if (shelfx + w + padding > pagesize)
+		{
+			shelfx = padding;
+			shelfy += shelfheight + padding;
+			shelfheight = 0;
+		}
+
+		if (shelfy + h + padding > pagesize)
+		{
+			pageheights.push_back(0);
+			shelfx = padding;
+			shelfy = padding;
+			shelfheight = 0;
+		}
+
+		int page = (int) pageheights.size() - 1;
+		placements[i] = {page, shelfx, shelfy};
+
+		shelfx += w + padding;
+		shelfheight = std::max(shelfheight, h);
+		pageheights[page] = std::max(pageheights[page], shelfy + h + padding);
+	}
+
+	pages.clear();
+	for (int height : pageheights)
+	{
+		StrongRef<image::ImageData> page(new image::ImageData(pagesize, height, PIXELFORMAT_RGBA8_UNORM), Acquire::NORETAIN);
+
+		// Transparent white, like the Font atlas uses for TrueType glyphs.
+		uint8 *pixels = (uint8 *) page->getData();
+		for (size_t p = 0; p < (size_t) pagesize * height; p++)
+		{
+			pixels[p * 4 + 0] = 255;
+			pixels[p * 4 + 1] = 255;
+			pixels[p * 4 + 2] = 255;
+			pixels[p * 4 + 3] = 0;
+		}
+
+		pages.push_back(page);
+	}
+
+	for (size_t i = 0; i < glyphdata.size(); i++)
+	{
+		const GlyphData *gd = glyphdata[i];
+		int w = gd->getWidth();
+		int h = gd->getHeight();
+
+		if (w <= 0 || h <= 0)
+			continue;
+
+		const Placement &pl = placements[i];
+		uint8 *dst = (uint8 *) pages[pl.page]->getData();
+		const uint8 *src = (const uint8 *) gd->getData();
+
+		for (int y = 0; y < h; y++)
+		{
+			uint8 *row = &dst[((pl.y + y) * pagesize + pl.x) * 4];
+
+			if (gd->getFormat() == PIXELFORMAT_LA8_UNORM)
+			{
+				for (int x = 0; x < w; x++)
+				{
+					const uint8 *s = &src[(y * w + x) * 2];
+					row[x * 4 + 0] = s[0];
+					row[x * 4 + 1] = s[0];
+					row[x * 4 + 2] = s[0];
+					row[x * 4 + 3] = s[1];
+				}
+			}
+			else
+				memcpy(row, &src[y * w * 4], w * 4);
+		}
+	}
+
+	std::stringstream ss;
+
+	ss << "info face=\"baked\" size=" << source->getHeight() << " unicode=1 padding=0,0,0,0 spacing=" << padding << "," << padding << "\n";
+	ss << "common lineHeight=" << source->getLineHeight() << " base=" << source->getAscent()
+	   << " scaleW=" << pagesize << " scaleH=" << pagesize << " pages=" << pages.size() << " packed=0\n";
+
+	for (size_t i = 0; i < pages.size(); i++)
+		ss << "page id=" << i << " file=\"" << pagename << "_" << i << ".png\"\n";
+
+	ss << "chars count=" << glyphdata.size() << "\n";
+
+	for (size_t i = 0; i < glyphdata.size(); i++)
+	{
+		const GlyphData *gd = glyphdata[i];
+		ss << "char id=" << gd->getGlyph()
+		   << " x=" << placements[i].x << " y=" << placements[i].y
+		   << " width=" << gd->getWidth() << " height=" << gd->getHeight()
+		   << " xoffset=" << gd->getBearingX() << " yoffset=" << -gd->getBearingY()
+		   << " xadvance=" << gd->getAdvance()
+		   << " page=" << placements[i].page << " chnl=15\n";
+	}
+
+	// Every pair would be far too many for large character sets, and scripts
+	// beyond Latin rely on shaping rather than pair kerning anyway.
+	std::stringstream kerningss;
+	int kerningcount = 0;
+
+	for (const auto &left : glyphdata)
+	{
+		if (left->getGlyph() >= 0x250)
+			continue;
+
+		for (const auto &right : glyphdata)
+		{
+			if (right->getGlyph() >= 0x250)
+				continue;
+
+			int amount = (int) floorf(source->getKerning(left->getGlyph(), right->getGlyph()) + 0.5f);
+			if (amount == 0)
+				continue;
+
+			kerningss << "kerning first=" << left->getGlyph() << " second=" << right->getGlyph() << " amount=" << amount << "\n";
+			kerningcount++;
+		}
+	}
+
+	if (kerningcount > 0)
+		ss << "kernings count=" << kerningcount << "\n" << kerningss.str();
+
+	fontdef = ss.str();
+}
+
 int BMFontRasterizer::getGlyphCount() const
 {
 	return (int) characters.size();
@@ -55,9 +55,18 @@ public:
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
 	TextShaper *newTextShaper() override;
+	image::ImageData *getGlyphPage(int index, int &page, int &x, int &y, GlyphMetrics &metrics) const override;
 
 	static bool accepts(love::filesystem::FileData *fontdef);
 
+	/**
+	 * Rasterizes the given glyphs of another Rasterizer into RGBA page images
+	 * of at most pagesize x pagesize pixels, and writes a text BMFont
+	 * descriptor for them. Pages are referred to in the descriptor as
+	 * pagename_<index>.png. Kerning is kept for pairs of Latin glyphs.
+	 **/
+	static void bake(const Rasterizer *source, const std::vector<uint32> &glyphs, int pagesize, const std::string &pagename, std::string &fontdef, std::vector<StrongRef<image::ImageData>> &pages);
+
 private:
 
 	struct BMFontCharacter
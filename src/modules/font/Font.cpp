@@ -23,6 +23,7 @@
 #include "BMFontRasterizer.h"
 #include "ImageRasterizer.h"
 #include "data/DataModule.h"
+#include "filesystem/Filesystem.h"
 
 #include "libraries/utf8/utf8.h"
 
@@ -55,11 +56,51 @@ Rasterizer *Font::newTrueTypeRasterizer(int size, float dpiscale, TrueTypeRaster
 	return newTrueTypeRasterizer(defaultFontData.get(), size, dpiscale, hinting);
 }
 
+Rasterizer *Font::newTrueTypeRasterizer(int size, const TrueTypeRasterizer::Settings &settings)
+{
+	return newTrueTypeRasterizer(defaultFontData.get(), size, settings);
+}
+
 Rasterizer *Font::newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale)
 {
 	return new BMFontRasterizer(fontdef, images, dpiscale);
 }
 
+void Font::bakeBMFont(Rasterizer *r, const std::vector<uint32> &glyphs, const std::string &filename, int pagesize)
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		throw love::Exception("love.filesystem must be loaded in order to bake a BMFont.");
+
+	// Page files go next to the descriptor, which refers to them by name only.
+	std::string folder;
+	std::string stem = filename;
+
+	size_t separatorpos = stem.rfind('/');
+	if (separatorpos != std::string::npos)
+	{
+		folder = stem.substr(0, separatorpos + 1);
+		stem = stem.substr(separatorpos + 1);
+	}
+
+	size_t extpos = stem.rfind('.');
+	if (extpos != std::string::npos && extpos > 0)
+		stem = stem.substr(0, extpos);
+
+	std::string fontdef;
+	std::vector<StrongRef<image::ImageData>> pages;
+
+	BMFontRasterizer::bake(r, glyphs, pagesize, stem, fontdef, pages);
+
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		std::string pagefilename = folder + stem + "_" + std::to_string(i) + ".png";
+		StrongRef<filesystem::FileData> encoded(pages[i]->encode(image::FormatHandler::ENCODED_PNG, pagefilename.c_str(), true), Acquire::NORETAIN);
+	}
+
+	fs->write(filename.c_str(), fontdef.data(), (int64) fontdef.size());
+}
+
 Rasterizer *Font::newImageRasterizer(love::image::ImageData *data, const std::string &text, int extraspacing, float dpiscale)
 {
 	std::vector<uint32> glyphs;
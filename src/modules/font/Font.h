@@ -52,9 +52,19 @@ public:
 	virtual Rasterizer *newTrueTypeRasterizer(int size, float dpiscale, TrueTypeRasterizer::Hinting hinting);
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting) = 0;
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting) = 0;
+	virtual Rasterizer *newTrueTypeRasterizer(int size, const TrueTypeRasterizer::Settings &settings);
+	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, const TrueTypeRasterizer::Settings &settings) = 0;
 
 	virtual Rasterizer *newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale);
 
+	/**
+	 * Bakes glyphs of a Rasterizer into a BMFont in the save directory: a
+	 * descriptor at filename, and PNG pages next to it. Loading the result
+	 * with a BMFont rasterizer (using the same DPI scale) needs no glyph
+	 * rasterization, and its pages are used as Font textures directly.
+	 **/
+	virtual void bakeBMFont(Rasterizer *r, const std::vector<uint32> &glyphs, const std::string &filename, int pagesize);
+
 	virtual Rasterizer *newImageRasterizer(love::image::ImageData *data, const std::string &glyphs, int extraspacing, float dpiscale);
 	virtual Rasterizer *newImageRasterizer(love::image::ImageData *data, uint32 *glyphs, int length, int extraspacing, float dpiscale);
 
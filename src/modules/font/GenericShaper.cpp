@@ -37,7 +37,7 @@ GenericShaper::~GenericShaper()
 {
 }
 
-void GenericShaper::computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+void GenericShaper::shapeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
 {
 	if (!range.isValid())
 		range = Range(0, codepoints.cps.size());
@@ -164,6 +164,29 @@ void ImageRasterizer::load(const uint32 *glyphs, int glyphcount)
 		imageGlyphs.push_back(imageGlyph);
 		glyphIndices[glyphs[i]] = (int) imageGlyphs.size() - 1;
 	}
+
+	page.set(new love::image::ImageData(imgw, imgh, PIXELFORMAT_RGBA8_UNORM), Acquire::NORETAIN);
+
+	Color32 *pagepixels = (Color32 *) page->getData();
+	for (int i = 0; i < imgw * imgh; i++)
+		pagepixels[i] = pixels[i] == spacer ? Color32(0, 0, 0, 0) : pixels[i];
+}
+
+love::image::ImageData *ImageRasterizer::getGlyphPage(int index, int &pageindex, int &x, int &y, GlyphMetrics &gm) const
+{
+	if (index <= 0 || index >= (int) imageGlyphs.size())
+		return nullptr;
+
+	pageindex = 0;
+	x = imageGlyphs[index].x;
+	y = 0;
+
+	gm = {};
+	gm.width = imageGlyphs[index].width;
+	gm.height = metrics.height;
+	gm.advance = imageGlyphs[index].width + extraSpacing;
+
+	return page.get();
 }
 
 int ImageRasterizer::getGlyphCount() const
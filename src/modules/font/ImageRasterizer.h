@@ -51,6 +51,7 @@ public:
 	bool hasGlyph(uint32 glyph) const override;
 	DataType getDataType() const override;
 	TextShaper *newTextShaper() override;
+	image::ImageData *getGlyphPage(int index, int &page, int &x, int &y, GlyphMetrics &metrics) const override;
 
 
 private:
@@ -69,6 +70,10 @@ private:
 	// The image data
 	StrongRef<love::image::ImageData> imageData;
 
+	// The image data with the spacer color made transparent, so glyphs can be
+	// drawn straight from it.
+	StrongRef<love::image::ImageData> page;
+
 	// Number of glyphs in the font
 	int numglyphs;
 
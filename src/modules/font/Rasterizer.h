@@ -28,6 +28,11 @@
 
 namespace love
 {
+namespace image
+{
+class ImageData;
+}
+
 namespace font
 {
 
@@ -137,8 +142,29 @@ public:
 
 	virtual DataType getDataType() const = 0;
 
+	/**
+	 * Creates a new Rasterizer with the same data and settings, which can be
+	 * used on a different thread than this one. Returns null if the Rasterizer
+	 * type doesn't support it.
+	 **/
+	virtual Rasterizer *clone() const { return nullptr; }
+
 	virtual ptrdiff_t getHandle() const { return 0; }
 
+	/**
+	 * Whether the glyphs are signed distance fields rather than coverage
+	 * bitmaps. The edge of a glyph is where its alpha value is 0.5.
+	 **/
+	virtual bool isSDF() const { return false; }
+
+	/**
+	 * Rasterizers whose glyphs are already laid out in page images can say
+	 * where a glyph is, so Font can use the page as a texture as-is instead of
+	 * copying the glyph into its own atlas. Returns null if the glyph isn't on
+	 * a page.
+	 **/
+	virtual love::image::ImageData *getGlyphPage(int /*index*/, int &/*page*/, int &/*x*/, int &/*y*/, GlyphMetrics &/*metrics*/) const { return nullptr; }
+
 	virtual TextShaper *newTextShaper() = 0;
 
 	float getDPIScale() const;
@@ -22,9 +22,17 @@
 #include "TextShaper.h"
 #include "Rasterizer.h"
 #include "common/Exception.h"
+#include "common/utf8.h"
+#include "thread/threads.h"
 
 #include "libraries/utf8/utf8.h"
 
+// C++
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
 namespace love
 {
 namespace font
@@ -32,23 +40,8 @@ namespace font
 
 void getCodepointsFromString(const std::string &text, std::vector<uint32> &codepoints)
 {
-	codepoints.reserve(text.size());
-
-	try
-	{
-		utf8::iterator<std::string::const_iterator> i(text.begin(), text.begin(), text.end());
-		utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
-
-		while (i != end)
-		{
-			uint32 g = *i++;
-			codepoints.push_back(g);
-		}
-	}
-	catch (utf8::exception &e)
-	{
-		throw love::Exception("UTF-8 decoding error: %s", e.what());
-	}
+	if (!decodeUTF8(text.data(), text.size(), codepoints))
+		throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
 }
 
 void getCodepointsFromString(const std::vector<ColoredString> &strs, ColoredCodepoints &codepoints)
@@ -88,6 +81,8 @@ TextShaper::TextShaper(Rasterizer *rasterizer)
 	, height(floorf(rasterizer->getHeight() / rasterizer->getDPIScale() + 0.5f))
 	, lineHeight(1)
 	, useSpacesForTab(false)
+	, denseGlyphAdvances(DENSE_ADVANCE_COUNT, std::make_pair(0, GlyphIndex {0, -1}))
+	, parallelWrapSupported(true)
 {
 	if (!rasterizer->hasGlyph('\t'))
 		useSpacesForTab = true;
@@ -104,6 +99,9 @@ float TextShaper::getHeight() const
 
 void TextShaper::setLineHeight(float h)
 {
+	if (h != lineHeight)
+		clearShapedRuns();
+
 	lineHeight = h;
 }
 
@@ -172,11 +170,26 @@ bool TextShaper::hasGlyphs(const std::string &text) const
 
 float TextShaper::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
+	float *densek = nullptr;
+
+	if (leftglyph < DENSE_KERNING_COUNT && rightglyph < DENSE_KERNING_COUNT)
+	{
+		if (denseKerning.empty())
+			denseKerning.resize(DENSE_KERNING_COUNT * DENSE_KERNING_COUNT, std::numeric_limits<float>::quiet_NaN());
+
+		densek = &denseKerning[leftglyph * DENSE_KERNING_COUNT + rightglyph];
+		if (!std::isnan(*densek))
+			return *densek;
+	}
+
 	uint64 packedglyphs = ((uint64)leftglyph << 32) | (uint64)rightglyph;
 
-	const auto it = kerning.find(packedglyphs);
-	if (it != kerning.end())
-		return it->second;
+	if (densek == nullptr)
+	{
+		const auto it = kerning.find(packedglyphs);
+		if (it != kerning.end())
+			return it->second;
+	}
 
 	float k = 0.0f;
 	bool found = false;
@@ -194,7 +207,11 @@ float TextShaper::getKerning(uint32 leftglyph, uint32 rightglyph)
 	if (!found)
 		k = floorf(rasterizers[0]->getKerning(leftglyph, rightglyph) / rasterizers[0]->getDPIScale() + 0.5f);
 
-	kerning[packedglyphs] = k;
+	if (densek != nullptr)
+		*densek = k;
+	else
+		kerning[packedglyphs] = k;
+
 	return k;
 }
 
@@ -218,12 +235,25 @@ float TextShaper::getKerning(const std::string &leftchar, const std::string &rig
 
 int TextShaper::getGlyphAdvance(uint32 glyph, GlyphIndex *glyphindex)
 {
-	const auto it = glyphAdvances.find(glyph);
-	if (it != glyphAdvances.end())
+	if (glyph < DENSE_ADVANCE_COUNT)
 	{
-		if (glyphindex)
-			*glyphindex = it->second.second;
-		return it->second.first;
+		const auto &dense = denseGlyphAdvances[glyph];
+		if (dense.second.rasterizerIndex >= 0)
+		{
+			if (glyphindex)
+				*glyphindex = dense.second;
+			return dense.first;
+		}
+	}
+	else
+	{
+		const auto it = glyphAdvances.find(glyph);
+		if (it != glyphAdvances.end())
+		{
+			if (glyphindex)
+				*glyphindex = it->second.second;
+			return it->second.first;
+		}
 	}
 
 	int rasterizeri = 0;
@@ -249,7 +279,11 @@ int TextShaper::getGlyphAdvance(uint32 glyph, GlyphIndex *glyphindex)
 
 	GlyphIndex glyphi = {r->getGlyphIndex(realglyph), rasterizeri};
 
-	glyphAdvances[glyph] = std::make_pair(advance, glyphi);
+	if (glyph < DENSE_ADVANCE_COUNT)
+		denseGlyphAdvances[glyph] = std::make_pair(advance, glyphi);
+	else
+		glyphAdvances[glyph] = std::make_pair(advance, glyphi);
+
 	if (glyphindex)
 		*glyphindex = glyphi;
 	return advance;
@@ -283,12 +317,166 @@ static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 
 void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths)
 {
-	size_t nextnewline = findNewline(codepoints, 0);
+	if (codepoints.cps.empty())
+		return;
+
+	getWrap(codepoints, Range(0, codepoints.cps.size()), wraplimit, lineranges, linewidths);
+}
+
+void TextShaper::getWrap(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths)
+{
+	size_t end = std::min(range.getMax() + 1, codepoints.cps.size());
+
+	if (range.getMin() < end && end - range.getMin() >= PARALLEL_WRAP_MIN_LENGTH)
+	{
+		if (getWrapParallel(codepoints, range, wraplimit, lineranges, linewidths))
+			return;
+	}
+
+	getWrapSequential(codepoints, range, wraplimit, lineranges, linewidths);
+}
+
+class ParallelWrapJob : public love::thread::Threadable
+{
+public:
+
+	ParallelWrapJob(TextShaper *shaper, const ColoredCodepoints &codepoints, Range range, float wraplimit)
+		: shaper(shaper)
+		, codepoints(codepoints)
+		, range(range)
+		, wraplimit(wraplimit)
+	{
+		threadName = "TextWrap";
+	}
+
+	void threadFunction() override
+	{
+		try
+		{
+			shaper->getWrapSequential(codepoints, range, wraplimit, lineRanges, &lineWidths);
+		}
+		catch (love::Exception &e)
+		{
+			error = e.what();
+		}
+	}
+
+	std::vector<Range> lineRanges;
+	std::vector<int> lineWidths;
+	std::string error;
+
+private:
+
+	TextShaper *shaper;
+	const ColoredCodepoints &codepoints;
+	Range range;
+	float wraplimit;
+};
+
+bool TextShaper::createWrapWorkers(int count)
+{
+	while ((int) wrapWorkers.size() < count)
+	{
+		// Each thread needs its own copies, since rasterizers and shapers keep
+		// caches and library state that isn't thread-safe.
+		std::vector<StrongRef<Rasterizer>> clones;
+
+		for (const auto &r : rasterizers)
+		{
+			StrongRef<Rasterizer> clone(r->clone(), Acquire::NORETAIN);
+			if (clone.get() == nullptr)
+			{
+				parallelWrapSupported = false;
+				wrapWorkers.clear();
+				return false;
+			}
+			clones.push_back(clone);
+		}
+
+		StrongRef<TextShaper> worker(clones[0]->newTextShaper(), Acquire::NORETAIN);
+
+		std::vector<Rasterizer *> fallbacks;
+		for (size_t i = 1; i < clones.size(); i++)
+			fallbacks.push_back(clones[i]);
+
+		if (!fallbacks.empty())
+			worker->setFallbacks(fallbacks);
+
+		wrapWorkers.push_back(worker);
+	}
+
+	return true;
+}
+
+bool TextShaper::getWrapParallel(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths)
+{
+	if (!parallelWrapSupported)
+		return false;
 
-	for (size_t i = 0; i < codepoints.cps.size();)
+	int threadcount = std::min((int) std::thread::hardware_concurrency(), MAX_WRAP_THREADS);
+	if (threadcount < 2)
+		return false;
+
+	size_t start = range.getMin();
+	size_t end = std::min(range.getMax() + 1, codepoints.cps.size());
+	size_t chunksize = (end - start) / threadcount;
+
+	// Split into roughly equal chunks which end just after a hard line break,
+	// so each chunk wraps the same as it would as part of the whole text.
+	std::vector<Range> chunks;
+	for (size_t chunkstart = start; chunkstart < end && (int) chunks.size() < threadcount;)
+	{
+		size_t chunkend = end;
+		if ((int) chunks.size() < threadcount - 1)
+			chunkend = std::min(findNewline(codepoints, std::min(chunkstart + chunksize, end)) + 1, end);
+
+		chunks.push_back(Range(chunkstart, chunkend - chunkstart));
+		chunkstart = chunkend;
+	}
+
+	if (chunks.size() < 2 || !createWrapWorkers((int) chunks.size() - 1))
+		return false;
+
+	std::vector<StrongRef<ParallelWrapJob>> jobs;
+
+	for (size_t i = 1; i < chunks.size(); i++)
+	{
+		StrongRef<ParallelWrapJob> job(new ParallelWrapJob(wrapWorkers[i - 1], codepoints, chunks[i], wraplimit), Acquire::NORETAIN);
+
+		if (!job->start())
+			job->threadFunction();
+
+		jobs.push_back(job);
+	}
+
+	// This thread takes care of the first chunk.
+	getWrapSequential(codepoints, chunks[0], wraplimit, lineranges, linewidths);
+
+	for (const auto &job : jobs)
+		job->wait();
+
+	for (const auto &job : jobs)
+	{
+		if (!job->error.empty())
+			throw love::Exception("%s", job->error.c_str());
+
+		lineranges.insert(lineranges.end(), job->lineRanges.begin(), job->lineRanges.end());
+		if (linewidths)
+			linewidths->insert(linewidths->end(), job->lineWidths.begin(), job->lineWidths.end());
+	}
+
+	return true;
+}
+
+void TextShaper::getWrapSequential(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths)
+{
+	size_t end = std::min(range.getMax() + 1, codepoints.cps.size());
+	size_t nextnewline = std::min(findNewline(codepoints, range.getMin()), end);
+
+	for (size_t i = range.getMin(); i < end;)
 	{
 		if (nextnewline < i)
-			nextnewline = findNewline(codepoints, i);
+			nextnewline = std::min(findNewline(codepoints, i), end);
 
 		if (nextnewline == i) // Empty line.
 		{
@@ -366,6 +554,11 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 	// Clear caches.
 	kerning.clear();
 	glyphAdvances.clear();
+	std::fill(denseGlyphAdvances.begin(), denseGlyphAdvances.end(), std::make_pair(0, GlyphIndex {0, -1}));
+	denseKerning.clear();
+	clearShapedRuns();
+	wrapWorkers.clear();
+	parallelWrapSupported = true;
 
 	rasterizers.resize(1);
 	dpiScales.resize(1);
@@ -377,5 +570,136 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 	}
 }
 
+void TextShaper::clearShapedRuns()
+{
+	shapedRuns.clear();
+	shapedRunLookup.clear();
+}
+
+uint64 TextShaper::hashShapedRun(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing)
+{
+	// FNV-1a.
+	uint64 hash = 0xcbf29ce484222325ULL;
+	auto combine = [&](const void *data, size_t size)
+	{
+		const uint8 *bytes = (const uint8 *) data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ULL;
+		}
+	};
+
+	uint64 start = range.getOffset();
+	combine(&start, sizeof(start));
+	combine(&codepoints.cps[range.getOffset()], sizeof(uint32) * range.getSize());
+
+	for (const IndexedColor &c : codepoints.colors)
+	{
+		combine(&c.color, sizeof(Colorf));
+		combine(&c.index, sizeof(int));
+	}
+
+	combine(&offset.x, sizeof(float));
+	combine(&offset.y, sizeof(float));
+	combine(&extraspacing, sizeof(float));
+
+	return hash;
+}
+
+bool TextShaper::isShapedRunMatch(const ShapedRun &run, const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing)
+{
+	if (run.rangeStart != range.getOffset() || run.codepoints.size() != range.getSize())
+		return false;
+
+	if (run.offset.x != offset.x || run.offset.y != offset.y || run.extraSpacing != extraspacing)
+		return false;
+
+	if (!std::equal(run.codepoints.begin(), run.codepoints.end(), codepoints.cps.begin() + range.getOffset()))
+		return false;
+
+	if (run.colors.size() != codepoints.colors.size())
+		return false;
+
+	for (size_t i = 0; i < run.colors.size(); i++)
+	{
+		if (run.colors[i].index != codepoints.colors[i].index || run.colors[i].color != codepoints.colors[i].color)
+			return false;
+	}
+
+	return true;
+}
+
+void TextShaper::computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+{
+	if (!range.isValid())
+		range = Range(0, codepoints.cps.size());
+
+	// Empty, out-of-bounds and very long runs aren't worth caching.
+	if (codepoints.cps.empty() || range.getMax() >= codepoints.cps.size() || range.getSize() > MAX_SHAPED_RUN_LENGTH)
+	{
+		shapeGlyphPositions(codepoints, range, offset, extraspacing, positions, colors, info);
+		return;
+	}
+
+	uint64 hash = hashShapedRun(codepoints, range, offset, extraspacing);
+
+	auto it = shapedRunLookup.find(hash);
+	if (it != shapedRunLookup.end() && !isShapedRunMatch(*it->second, codepoints, range, offset, extraspacing))
+	{
+		shapedRuns.erase(it->second);
+		shapedRunLookup.erase(it);
+		it = shapedRunLookup.end();
+	}
+
+	if (it != shapedRunLookup.end())
+	{
+		// Move it to the front of the LRU list.
+		shapedRuns.splice(shapedRuns.begin(), shapedRuns, it->second);
+	}
+	else
+	{
+		ShapedRun run;
+		run.hash = hash;
+		run.codepoints.assign(codepoints.cps.begin() + range.getOffset(), codepoints.cps.begin() + range.getOffset() + range.getSize());
+		run.colors = codepoints.colors;
+		run.rangeStart = range.getOffset();
+		run.offset = offset;
+		run.extraSpacing = extraspacing;
+
+		shapeGlyphPositions(codepoints, range, offset, extraspacing, &run.positions, &run.positionColors, &run.info);
+
+		shapedRuns.push_front(std::move(run));
+		shapedRunLookup[hash] = shapedRuns.begin();
+
+		if (shapedRuns.size() > MAX_SHAPED_RUNS)
+		{
+			shapedRunLookup.erase(shapedRuns.back().hash);
+			shapedRuns.pop_back();
+		}
+	}
+
+	const ShapedRun &run = shapedRuns.front();
+
+	if (positions != nullptr)
+	{
+		// Color indices are relative to the start of the output positions.
+		int startindex = (int) positions->size();
+		positions->insert(positions->end(), run.positions.begin(), run.positions.end());
+
+		if (colors != nullptr)
+		{
+			for (IndexedColor c : run.positionColors)
+			{
+				c.index += startindex;
+				colors->push_back(c);
+			}
+		}
+	}
+
+	if (info != nullptr)
+		*info = run.info;
+}
+
 } // font
 } // love
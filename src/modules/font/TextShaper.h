@@ -30,6 +30,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <list>
 
 namespace love
 {
@@ -37,6 +38,7 @@ namespace font
 {
 
 class Rasterizer;
+class ParallelWrapJob;
 
 struct ColoredString
 {
@@ -122,10 +124,20 @@ public:
 
 	void getWrap(const std::vector<ColoredString> &text, float wraplimit, std::vector<std::string> &lines, std::vector<int> *linewidths = nullptr);
 	void getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths = nullptr);
+	/**
+	 * Large texts are split at hard line breaks and wrapped on several threads
+	 * at once, when the rasterizers can be copied for each thread.
+	 **/
+	void getWrap(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths = nullptr);
 
 	virtual void setFallbacks(const std::vector<Rasterizer *> &fallbacks);
 
-	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
+	/**
+	 * Computes the positions of the glyphs in the given range of codepoints.
+	 * Recently shaped runs are cached, so text which is printed the same way
+	 * every frame is only shaped once.
+	 **/
+	void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info);
 	virtual int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) = 0;
 
 protected:
@@ -134,11 +146,48 @@ protected:
 
 	static inline bool isWhitespace(uint32 codepoint) { return codepoint == ' ' || codepoint == '\t'; }
 
+	// Does the actual work for computeGlyphPositions, without any caching.
+	virtual void shapeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
+
+	void clearShapedRuns();
+
 	std::vector<StrongRef<Rasterizer>> rasterizers;
 	std::vector<float> dpiScales;
 
 private:
 
+	friend class ParallelWrapJob;
+
+	void getWrapSequential(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths);
+	bool getWrapParallel(const ColoredCodepoints &codepoints, Range range, float wraplimit, std::vector<Range> &lineranges, std::vector<int> *linewidths);
+	bool createWrapWorkers(int count);
+
+	// Texts with fewer codepoints than this are always wrapped on one thread.
+	static const size_t PARALLEL_WRAP_MIN_LENGTH = 16384;
+	static const int MAX_WRAP_THREADS = 8;
+
+	struct ShapedRun
+	{
+		uint64 hash;
+
+		// Inputs, compared on lookup in case of hash collisions.
+		std::vector<uint32> codepoints;
+		std::vector<IndexedColor> colors;
+		size_t rangeStart;
+		Vector2 offset;
+		float extraSpacing;
+
+		std::vector<GlyphPosition> positions;
+		std::vector<IndexedColor> positionColors;
+		TextInfo info;
+	};
+
+	static const size_t MAX_SHAPED_RUNS = 512;
+	static const size_t MAX_SHAPED_RUN_LENGTH = 2048;
+
+	static uint64 hashShapedRun(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing);
+	static bool isShapedRunMatch(const ShapedRun &run, const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing);
+
 	int height;
 	float lineHeight;
 
@@ -150,6 +199,24 @@ private:
 	// map of left/right glyph pairs to horizontal kerning.
 	std::unordered_map<uint64, float> kerning;
 
+	// Direct-indexed versions of the above for low codepoints, since they're
+	// looked up for every character of most text. Unset advances have a
+	// rasterizer index of -1, and unset kerning values are NaN. The kerning
+	// table is only allocated once it's first used.
+	static const uint32 DENSE_ADVANCE_COUNT = 256;
+	static const uint32 DENSE_KERNING_COUNT = 128;
+	std::vector<std::pair<int, GlyphIndex>> denseGlyphAdvances;
+	std::vector<float> denseKerning;
+
+	// Shapers with their own copies of the rasterizers, used by
+	// getWrapParallel on other threads.
+	std::vector<StrongRef<TextShaper>> wrapWorkers;
+	bool parallelWrapSupported;
+
+	// Most recently used runs are at the front.
+	std::list<ShapedRun> shapedRuns;
+	std::unordered_map<uint64, std::list<ShapedRun>::iterator> shapedRunLookup;
+
 }; // TextShaper
 
 } // font
@@ -24,6 +24,7 @@
 // LOVE
 #include "Rasterizer.h"
 #include "common/StringMap.h"
+#include "common/Optional.h"
 
 namespace love
 {
@@ -44,6 +45,16 @@ public:
 		HINTING_MAX_ENUM
 	};
 
+	struct Settings
+	{
+		Hinting hinting = HINTING_NORMAL;
+		OptionalFloat dpiScale;
+
+		// Rasterize glyphs as signed distance fields, which can be drawn at any
+		// scale with Shader::STANDARD_SDF.
+		bool sdf = false;
+	};
+
 	virtual ~TrueTypeRasterizer() {}
 
 	static bool getConstant(const char *in, Hinting &out);
@@ -58,17 +58,32 @@ Rasterizer *Font::newRasterizer(love::filesystem::FileData *data)
 
 Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting)
 {
-	float dpiscale = 1.0f;
-	auto window = Module::getInstance<window::Window>(Module::M_WINDOW);
-	if (window != nullptr)
-		dpiscale = window->getDPIScale();
-
-	return newTrueTypeRasterizer(data, size, dpiscale, hinting);
+	TrueTypeRasterizer::Settings settings;
+	settings.hinting = hinting;
+	return newTrueTypeRasterizer(data, size, settings);
 }
 
 Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting)
 {
-	return new TrueTypeRasterizer(library, data, size, dpiscale, hinting);
+	TrueTypeRasterizer::Settings settings;
+	settings.hinting = hinting;
+	settings.dpiScale.set(dpiscale);
+	return newTrueTypeRasterizer(data, size, settings);
+}
+
+Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, const TrueTypeRasterizer::Settings &settings)
+{
+	float dpiscale = 1.0f;
+	if (settings.dpiScale.hasValue)
+		dpiscale = settings.dpiScale.value;
+	else
+	{
+		auto window = Module::getInstance<window::Window>(Module::M_WINDOW);
+		if (window != nullptr)
+			dpiscale = window->getDPIScale();
+	}
+
+	return new TrueTypeRasterizer(library, data, size, dpiscale, settings.hinting, settings.sdf);
 }
 
 const char *Font::getName() const
@@ -33,10 +33,18 @@ namespace font
 namespace freetype
 {
 
-TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting)
-	: data(data)
+TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting, bool sdf)
+	: library(library)
+	, data(data)
 	, hinting(hinting)
+	, sdf(sdf)
+	, baseSize(size)
 {
+#if !(FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11))
+	if (sdf)
+		throw love::Exception("Signed distance field TrueType fonts require FreeType 2.11 or newer.");
+#endif
+
 	this->dpiScale = dpiscale;
 	size = floorf(size * dpiscale + 0.5f);
 
@@ -71,6 +79,13 @@ TrueTypeRasterizer::~TrueTypeRasterizer()
 	FT_Done_Face(face);
 }
 
+Rasterizer *TrueTypeRasterizer::clone() const
+{
+	// Each FT_Face may only be used by one thread at a time, so the copy gets
+	// its own face from the same font data.
+	return new TrueTypeRasterizer(library, data, baseSize, dpiScale, hinting, sdf);
+}
+
 int TrueTypeRasterizer::getLineHeight() const
 {
 	return (int)(getHeight() * 1.25);
@@ -122,6 +137,14 @@ GlyphData *TrueTypeRasterizer::getGlyphDataForIndex(int index) const
 	if (hinting == HINTING_MONO)
 		rendermode = FT_RENDER_MODE_MONO;
 
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+	// The SDF renderer pads the bitmap by its spread (8 pixels by default),
+	// and the bearing is adjusted to match, so no extra handling is needed for
+	// the metrics. Values above 128 are inside the glyph outline.
+	if (sdf)
+		rendermode = FT_RENDER_MODE_SDF;
+#endif
+
 	err = FT_Glyph_To_Bitmap(&ftglyph, rendermode, 0, 1);
 
 	if (err != FT_Err_Ok)
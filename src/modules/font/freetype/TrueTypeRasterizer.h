@@ -44,7 +44,7 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 {
 public:
 
-	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting);
+	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting, bool sdf);
 	virtual ~TrueTypeRasterizer();
 
 	// Implement Rasterizer
@@ -57,8 +57,10 @@ public:
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
 	TextShaper *newTextShaper() override;
+	Rasterizer *clone() const override;
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t) face; }
+	bool isSDF() const override { return sdf; }
 
 	static bool accepts(FT_Library library, love::Data *data);
 
@@ -66,6 +68,8 @@ private:
 
 	static FT_UInt hintingToLoadOption(Hinting hinting);
 
+	FT_Library library;
+
 	// TrueType face
 	FT_Face face;
 
@@ -74,6 +78,11 @@ private:
 
 	Hinting hinting;
 
+	bool sdf;
+
+	// Size before the DPI scale is applied.
+	int baseSize;
+
 }; // TrueTypeRasterizer
 
 } // freetype
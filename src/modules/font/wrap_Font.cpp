@@ -28,6 +28,8 @@
 
 #include "filesystem/wrap_Filesystem.h"
 
+#include "libraries/utf8/utf8.h"
+
 namespace love
 {
 namespace font
@@ -64,6 +66,27 @@ int w_newRasterizer(lua_State *L)
 	}
 }
 
+static void luax_checktruetypesettings(lua_State *L, int idx, TrueTypeRasterizer::Settings &settings)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "hinting");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *hintstr = luaL_checkstring(L, -1);
+		if (!TrueTypeRasterizer::getConstant(hintstr, settings.hinting))
+			luax_enumerror(L, "TrueType font hinting mode", TrueTypeRasterizer::getConstants(settings.hinting), hintstr);
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, idx, "dpiscale");
+	if (!lua_isnoneornil(L, -1))
+		settings.dpiScale.set((float) luaL_checknumber(L, -1));
+	lua_pop(L, 1);
+
+	settings.sdf = luax_boolflag(L, idx, "sdf", false);
+}
+
 int w_newTrueTypeRasterizer(lua_State *L)
 {
 	Rasterizer *t = nullptr;
@@ -74,6 +97,17 @@ int w_newTrueTypeRasterizer(lua_State *L)
 		// First argument is a number: use the default TrueType font.
 		int size = (int) luaL_optinteger(L, 1, 13);
 
+		if (lua_istable(L, 2))
+		{
+			TrueTypeRasterizer::Settings settings;
+			luax_checktruetypesettings(L, 2, settings);
+			luax_catchexcept(L, [&](){ t = instance()->newTrueTypeRasterizer(size, settings); });
+
+			luax_pushtype(L, t);
+			t->release();
+			return 1;
+		}
+
 		const char *hintstr = lua_isnoneornil(L, 2) ? nullptr : luaL_checkstring(L, 2);
 		if (hintstr && !TrueTypeRasterizer::getConstant(hintstr, hinting))
 			return luax_enumerror(L, "TrueType font hinting mode", TrueTypeRasterizer::getConstants(hinting), hintstr);
@@ -88,6 +122,13 @@ int w_newTrueTypeRasterizer(lua_State *L)
 	}
 	else
 	{
+		// Parse the settings before grabbing the Data, so a Lua error can't
+		// leak it.
+		bool usesettings = lua_istable(L, 3);
+		TrueTypeRasterizer::Settings settings;
+		if (usesettings)
+			luax_checktruetypesettings(L, 3, settings);
+
 		love::Data *d = nullptr;
 
 		if (luax_istype(L, 1, love::Data::type))
@@ -100,6 +141,18 @@ int w_newTrueTypeRasterizer(lua_State *L)
 
 		int size = (int) luaL_optinteger(L, 2, 12);
 
+		if (usesettings)
+		{
+			luax_catchexcept(L,
+				[&]() { t = instance()->newTrueTypeRasterizer(d, size, settings); },
+				[&](bool) { d->release(); }
+			);
+
+			luax_pushtype(L, t);
+			t->release();
+			return 1;
+		}
+
 		const char *hintstr = lua_isnoneornil(L, 3) ? nullptr : luaL_checkstring(L, 3);
 		if (hintstr && !TrueTypeRasterizer::getConstant(hintstr, hinting))
 			return luax_enumerror(L, "TrueType font hinting mode", TrueTypeRasterizer::getConstants(hinting), hintstr);
@@ -190,6 +243,45 @@ int w_newImageRasterizer(lua_State *L)
 	return 1;
 }
 
+int w_bakeBMFont(lua_State *L)
+{
+	Rasterizer *r = luax_checkrasterizer(L, 1);
+	std::vector<uint32> glyphs;
+
+	if (lua_istable(L, 2))
+	{
+		for (int i = 1; i <= (int) luax_objlen(L, 2); i++)
+		{
+			lua_rawgeti(L, 2, i);
+			glyphs.push_back((uint32) luaL_checkinteger(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		std::string text = luax_checkstring(L, 2);
+
+		try
+		{
+			utf8::iterator<std::string::const_iterator> i(text.begin(), text.begin(), text.end());
+			utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
+
+			while (i != end)
+				glyphs.push_back(*i++);
+		}
+		catch (utf8::exception &e)
+		{
+			return luaL_error(L, "UTF-8 decoding error: %s", e.what());
+		}
+	}
+
+	std::string filename = luax_checkstring(L, 3);
+	int pagesize = (int) luaL_optinteger(L, 4, 1024);
+
+	luax_catchexcept(L, [&]() { instance()->bakeBMFont(r, glyphs, filename, pagesize); });
+	return 0;
+}
+
 int w_newGlyphData(lua_State *L)
 {
 	Rasterizer *r = luax_checkrasterizer(L, 1);
@@ -220,6 +312,7 @@ static const luaL_Reg functions[] =
 	{ "newBMFontRasterizer", w_newBMFontRasterizer },
 	{ "newImageRasterizer", w_newImageRasterizer },
 	{ "newGlyphData",  w_newGlyphData },
+	{ "bakeBMFont", w_bakeBMFont },
 	{ 0, 0 }
 };
 
@@ -230,12 +323,26 @@ static const lua_CFunction types[] =
 	0
 };
 
+static Module *createInstance()
+{
+	return new freetype::Font();
+}
+
+void preloadModule()
+{
+	Module::preloadInstance(Module::M_FONT, createInstance);
+}
+
 extern "C" int luaopen_love_font(lua_State *L)
 {
 	Font *instance = instance();
 	if (instance == nullptr)
 	{
-		luax_catchexcept(L, [&](){ instance = new freetype::Font(); });
+		luax_catchexcept(L, [&]() {
+			instance = (Font *) Module::takePreloadedInstance(Module::M_FONT);
+			if (instance == nullptr)
+				instance = (Font *) createInstance();
+		});
 	}
 	else
 		instance->retain();
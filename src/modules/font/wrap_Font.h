@@ -35,6 +35,7 @@ int w_newTrueTypeRasterizer(lua_State *L);
 int w_newBMFontRasterizer(lua_State *L);
 int w_newImageRasterizer(lua_State *L);
 int w_newGlyphData(lua_State *L);
+void preloadModule();
 extern "C" LOVE_EXPORT int luaopen_love_font(lua_State *L);
 
 } // font
@@ -29,6 +29,9 @@ namespace graphics
 
 love::Type Buffer::type("GraphicsBuffer", &Object::type);
 
+int Buffer::bufferCount = 0;
+int64 Buffer::totalGraphicsMemory = 0;
+
 Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDeclaration> &bufferformat, size_t size, size_t arraylength)
 	: arrayLength(0)
 	, arrayStride(0)
@@ -52,6 +55,8 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	bool vertexbuffer = usageFlags & BUFFERUSAGEFLAG_VERTEX;
 	bool texelbuffer = usageFlags & BUFFERUSAGEFLAG_TEXEL;
 	bool storagebuffer = usageFlags & BUFFERUSAGEFLAG_SHADER_STORAGE;
+	bool indirectbuffer = usageFlags & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS;
+	bool uniformbuffer = usageFlags & BUFFERUSAGEFLAG_UNIFORM;
 
 	if (texelbuffer && !caps.features[Graphics::FEATURE_TEXEL_BUFFER])
 		throw love::Exception("Texel buffers are not supported on this system.");
@@ -62,8 +67,19 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	if (storagebuffer && dataUsage == BUFFERDATAUSAGE_STREAM)
 		throw love::Exception("Buffers created with 'stream' data usage cannot be used as a shader storage buffer.");
 
-	if (dataUsage == BUFFERDATAUSAGE_READBACK && (indexbuffer || vertexbuffer || texelbuffer || storagebuffer))
-		throw love::Exception("Buffers created with 'readback' data usage cannot be index, vertex, texel, or shaderstorage buffer types.");
+	if (indirectbuffer && !caps.features[Graphics::FEATURE_INDIRECT_DRAW])
+		throw love::Exception("Indirect argument buffers are not supported on this system.");
+
+	if (uniformbuffer && !supportsGLSL3)
+		throw love::Exception("Uniform buffers are not supported on this system (GLSL 3 support is necessary.)");
+
+	// std140 and the layouts of the other buffer types only agree for some
+	// formats, which isn't worth the trouble to detect.
+	if (uniformbuffer && (indexbuffer || vertexbuffer || texelbuffer || storagebuffer || indirectbuffer))
+		throw love::Exception("Uniform buffers cannot be used as other buffer types.");
+
+	if (dataUsage == BUFFERDATAUSAGE_READBACK && (indexbuffer || vertexbuffer || texelbuffer || storagebuffer || indirectbuffer || uniformbuffer))
+		throw love::Exception("Buffers created with 'readback' data usage cannot be index, vertex, texel, uniform, shaderstorage, or indirectarguments buffer types.");
 
 	size_t offset = 0;
 	size_t stride = 0;
@@ -109,6 +125,12 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 				throw love::Exception("Vertex buffer attributes must have a name.");
 		}
 
+		if (indirectbuffer)
+		{
+			if (info.isMatrix || info.componentSize != 4 || (info.baseType != DATA_BASETYPE_INT && info.baseType != DATA_BASETYPE_UINT))
+				throw love::Exception("Indirect argument buffers only support 32 bit integer data types.");
+		}
+
 		if (texelbuffer)
 		{
 			if (format != bufferformat[0].format)
@@ -184,6 +206,43 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 					member.decl.name.c_str(), memberoffset, offset);
 		}
 
+		// Uniform buffers use GLSL's std140 packing rules. Each array element
+		// is one instance of the block (or of a struct in an array inside it.)
+		if (uniformbuffer)
+		{
+			if (decl.arrayLength > 0)
+				throw love::Exception("Arrays are not currently supported in uniform buffers.");
+
+			if (info.baseType == DATA_BASETYPE_BOOL)
+				throw love::Exception("Bool types are not supported in uniform buffers.");
+
+			if (info.baseType == DATA_BASETYPE_UNORM || info.baseType == DATA_BASETYPE_SNORM)
+				throw love::Exception("Normalized formats are not supported in uniform buffers.");
+
+			if (info.componentSize != 4)
+				throw love::Exception("Only 32 bit data formats are supported in uniform buffers.");
+
+			// Scalars and vectors have the same alignment as in std430, but the
+			// columns of matrices are always aligned to 16 bytes.
+			int c = info.isMatrix ? info.matrixRows : info.components;
+			size_t alignment = c == 3 ? 4 * info.componentSize : c * info.componentSize;
+
+			if (info.isMatrix && alignment != 16)
+			{
+				const char *fstr = "unknown";
+				getConstant(decl.format, fstr);
+				throw love::Exception("Data format %s is not currently supported in uniform buffers.", fstr);
+			}
+
+			// "The structure may have padding at the end; the base offset of the
+			// member following the sub-structure is rounded up to the next
+			// multiple of the base alignment of the structure", which is always
+			// rounded up to the alignment of a vec4.
+			structurealignment = std::max(structurealignment, std::max(alignment, (size_t) 16));
+
+			memberoffset = alignUp(memberoffset, alignment);
+		}
+
 		member.offset = memberoffset;
 		member.size = membersize;
 
@@ -223,10 +282,15 @@ Buffer::Buffer(Graphics *gfx, const Settings &settings, const std::vector<DataDe
 	if (texelbuffer && arraylength * dataMembers.size() > caps.limits[Graphics::LIMIT_TEXEL_BUFFER_SIZE])
 		throw love::Exception("Cannot create texel buffer: total number of values in the buffer (%d * %d) is too large for this system (maximum %d).",
 			(int) dataMembers.size(), (int) arraylength, caps.limits[Graphics::LIMIT_TEXEL_BUFFER_SIZE]);
+
+	++bufferCount;
+	totalGraphicsMemory += (int64) size;
 }
 
 Buffer::~Buffer()
 {
+	--bufferCount;
+	totalGraphicsMemory = std::max(totalGraphicsMemory - (int64) size, (int64) 0);
 }
 
 int Buffer::getDataMemberIndex(const std::string &name) const
@@ -301,5 +365,13 @@ std::vector<Buffer::DataDeclaration> Buffer::getCommonFormatDeclaration(CommonFo
 	return {};
 }
 
+STRINGMAP_BEGIN(Buffer::MapType, Buffer::MAP_MAX_ENUM, bufferMapType)
+{
+	{ "discard",        Buffer::MAP_WRITE_INVALIDATE     },
+	{ "read",           Buffer::MAP_READ_ONLY            },
+	{ "unsynchronized", Buffer::MAP_WRITE_UNSYNCHRONIZED },
+}
+STRINGMAP_END(Buffer::MapType, Buffer::MAP_MAX_ENUM, bufferMapType)
+
 } // graphics
 } // love
@@ -24,6 +24,7 @@
 #include "common/config.h"
 #include "common/int.h"
 #include "common/Object.h"
+#include "common/StringMap.h"
 #include "vertex.h"
 #include "Resource.h"
 
@@ -50,10 +51,18 @@ public:
 
 	static const size_t SHADER_STORAGE_BUFFER_MAX_STRIDE = 2048;
 
+	static int bufferCount;
+	static int64 totalGraphicsMemory;
+
 	enum MapType
 	{
 		MAP_WRITE_INVALIDATE,
 		MAP_READ_ONLY,
+		// Writes go to the buffer without waiting for the GPU to finish using
+		// it. Backends which can't map buffer memory directly treat this like
+		// MAP_WRITE_INVALIDATE for the mapped range.
+		MAP_WRITE_UNSYNCHRONIZED,
+		MAP_MAX_ENUM
 	};
 
 	struct DataDeclaration
@@ -185,5 +194,7 @@ protected:
 	
 }; // Buffer
 
+STRINGMAP_DECLARE(Buffer::MapType);
+
 } // graphics
 } // love
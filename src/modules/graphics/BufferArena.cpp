@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "BufferArena.h"
+#include "Graphics.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type BufferArena::type("BufferArena", &Object::type);
+
+BufferArena::BufferArena(Graphics *gfx, const std::vector<Buffer::DataDeclaration> &format, size_t pagelength, BufferDataUsage usage)
+	: gfx(gfx)
+	, format(format)
+	, dataUsage(usage)
+	, pageLength(pagelength)
+	, arrayStride(0)
+	, allocatedCount(0)
+{
+	if (pagelength == 0)
+		throw love::Exception("BufferArena page length must be greater than 0.");
+
+	if (usage == BUFFERDATAUSAGE_READBACK)
+		throw love::Exception("BufferArena cannot use the readback data usage.");
+
+	// Validates the format and gets the arena started with one page.
+	int page = addPage(pageLength);
+	arrayStride = pages[page].buffer->getArrayStride();
+}
+
+BufferArena::~BufferArena()
+{
+}
+
+int BufferArena::addPage(size_t length)
+{
+	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, dataUsage);
+	StrongRef<Buffer> buffer(gfx->newBuffer(settings, format, nullptr, 0, length), Acquire::NORETAIN);
+
+	Page page;
+	page.buffer = buffer;
+	page.freeRanges.push_back({0, length});
+	page.length = length;
+	page.used = 0;
+
+	// Reuse the slot of a page which was dropped, so page indices held by
+	// existing allocations stay valid.
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		if (pages[i].buffer.get() == nullptr)
+		{
+			pages[i] = page;
+			return (int) i;
+		}
+	}
+
+	pages.push_back(page);
+	return (int) pages.size() - 1;
+}
+
+BufferArena::Allocation BufferArena::allocate(size_t count)
+{
+	if (count == 0)
+		throw love::Exception("Cannot allocate 0 elements from a BufferArena.");
+
+	int pageindex = -1;
+	size_t rangeindex = 0;
+
+	// First fit.
+	for (size_t i = 0; i < pages.size() && pageindex < 0; i++)
+	{
+		const Page &page = pages[i];
+		if (page.buffer.get() == nullptr || page.length - page.used < count)
+			continue;
+
+		for (size_t r = 0; r < page.freeRanges.size(); r++)
+		{
+			if (page.freeRanges[r].count >= count)
+			{
+				pageindex = (int) i;
+				rangeindex = r;
+				break;
+			}
+		}
+	}
+
+	if (pageindex < 0)
+	{
+		pageindex = addPage(std::max(count, pageLength));
+		rangeindex = 0;
+	}
+
+	Page &page = pages[pageindex];
+	FreeRange &range = page.freeRanges[rangeindex];
+
+	Allocation alloc;
+	alloc.buffer = page.buffer;
+	alloc.page = pageindex;
+	alloc.start = range.start;
+	alloc.count = count;
+
+	range.start += count;
+	range.count -= count;
+	if (range.count == 0)
+		page.freeRanges.erase(page.freeRanges.begin() + rangeindex);
+
+	page.used += count;
+	allocatedCount += count;
+
+	return alloc;
+}
+
+void BufferArena::free(const Allocation &alloc)
+{
+	if (alloc.page < 0 || alloc.page >= (int) pages.size() || alloc.count == 0)
+		return;
+
+	Page &page = pages[alloc.page];
+	if (page.buffer.get() != alloc.buffer)
+		return;
+
+	auto &ranges = page.freeRanges;
+
+	// Insert in start order, merging with neighbouring free ranges.
+	size_t i = 0;
+	while (i < ranges.size() && ranges[i].start < alloc.start)
+		i++;
+
+	ranges.insert(ranges.begin() + i, {alloc.start, alloc.count});
+
+	if (i + 1 < ranges.size() && ranges[i].start + ranges[i].count == ranges[i + 1].start)
+	{
+		ranges[i].count += ranges[i + 1].count;
+		ranges.erase(ranges.begin() + i + 1);
+	}
+
+	if (i > 0 && ranges[i - 1].start + ranges[i - 1].count == ranges[i].start)
+	{
+		ranges[i - 1].count += ranges[i].count;
+		ranges.erase(ranges.begin() + i);
+	}
+
+	page.used -= alloc.count;
+	allocatedCount -= alloc.count;
+
+	// Empty pages are dropped, except for the last one left.
+	if (page.used == 0 && getPageCount() > 1)
+	{
+		page.buffer.set(nullptr);
+		page.freeRanges.clear();
+	}
+}
+
+int BufferArena::getPageCount() const
+{
+	int count = 0;
+	for (const Page &page : pages)
+	{
+		if (page.buffer.get() != nullptr)
+			count++;
+	}
+	return count;
+}
+
+} // graphics
+} // love
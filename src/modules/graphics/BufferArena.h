@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_GRAPHICS_BUFFER_ARENA_H
+#define LOVE_GRAPHICS_BUFFER_ARENA_H
+
+// LOVE
+#include "common/Object.h"
+#include "Buffer.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Suballocates ranges of vertices from a small number of large vertex Buffers
+ * which all share the same format, so many small Meshes don't each need their
+ * own GPU buffer object.
+ **/
+class BufferArena : public Object
+{
+public:
+
+	static love::Type type;
+
+	struct Allocation
+	{
+		Buffer *buffer = nullptr;
+		int page = -1;
+		size_t start = 0; // In array elements (vertices).
+		size_t count = 0;
+	};
+
+	BufferArena(Graphics *gfx, const std::vector<Buffer::DataDeclaration> &format, size_t pagelength, BufferDataUsage usage);
+	virtual ~BufferArena();
+
+	/**
+	 * Reserves a contiguous range of array elements. Allocations larger than
+	 * the page length get a dedicated Buffer.
+	 **/
+	Allocation allocate(size_t count);
+	void free(const Allocation &alloc);
+
+	const std::vector<Buffer::DataDeclaration> &getFormat() const { return format; }
+	BufferDataUsage getDataUsage() const { return dataUsage; }
+	size_t getPageLength() const { return pageLength; }
+	size_t getArrayStride() const { return arrayStride; }
+
+	int getPageCount() const;
+	size_t getAllocatedCount() const { return allocatedCount; }
+
+private:
+
+	struct FreeRange
+	{
+		size_t start;
+		size_t count;
+	};
+
+	struct Page
+	{
+		StrongRef<Buffer> buffer;
+		std::vector<FreeRange> freeRanges; // Sorted by start.
+		size_t length;
+		size_t used;
+	};
+
+	int addPage(size_t length);
+
+	Graphics *gfx;
+
+	std::vector<Buffer::DataDeclaration> format;
+	BufferDataUsage dataUsage;
+	size_t pageLength;
+	size_t arrayStride;
+
+	std::vector<Page> pages;
+	size_t allocatedCount;
+
+}; // BufferArena
+
+} // graphics
+} // love
+
+#endif // LOVE_GRAPHICS_BUFFER_ARENA_H
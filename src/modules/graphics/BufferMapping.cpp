@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "BufferMapping.h"
+#include "common/Exception.h"
+#include "data/ByteData.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type BufferMapping::type("GraphicsBufferMapping", &Data::type);
+
+BufferMapping::BufferMapping(Buffer *buffer, Buffer::MapType maptype, size_t offset, size_t size)
+	: buffer(buffer)
+	, mapType(maptype)
+	, data(nullptr)
+	, offset(offset)
+	, size(size)
+{
+	if (buffer->isMapped())
+		throw love::Exception("Buffer is already mapped.");
+
+	if (maptype == Buffer::MAP_READ_ONLY && buffer->getDataUsage() != BUFFERDATAUSAGE_READBACK)
+		throw love::Exception("Only Buffers created with the readback data usage can be mapped for reading.");
+
+	if (maptype != Buffer::MAP_READ_ONLY && (buffer->isImmutable() || buffer->getDataUsage() == BUFFERDATAUSAGE_READBACK))
+		throw love::Exception("Buffers created with the readback data usage, or immutable Buffers, cannot be mapped for writing.");
+
+	if (size == 0 || offset + size > buffer->getSize())
+		throw love::Exception("Invalid Buffer map range (offset %d, size %d).", (int) offset, (int) size);
+
+	data = buffer->map(maptype, offset, size);
+
+	if (data == nullptr)
+		throw love::Exception("Could not map Buffer.");
+}
+
+BufferMapping::~BufferMapping()
+{
+	unmap();
+}
+
+Data *BufferMapping::clone() const
+{
+	return new love::data::ByteData(data, getSize());
+}
+
+void *BufferMapping::getData() const
+{
+	return data;
+}
+
+size_t BufferMapping::getSize() const
+{
+	return data != nullptr ? size : 0;
+}
+
+void BufferMapping::unmap()
+{
+	unmap(size);
+}
+
+void BufferMapping::unmap(size_t usedsize)
+{
+	if (data == nullptr)
+		return;
+
+	// Reads have nothing to write back.
+	if (mapType == Buffer::MAP_READ_ONLY)
+		usedsize = size;
+
+	buffer->unmap(offset, std::min(usedsize, size));
+	data = nullptr;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Data.h"
+#include "Buffer.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A Data view of a mapped range of a graphics Buffer. Writes to the data go
+ * to the Buffer when it's unmapped (or directly, for unsynchronized maps on
+ * backends which support them). The data pointer is null once unmapped.
+ **/
+class BufferMapping : public love::Data
+{
+public:
+
+	static love::Type type;
+
+	BufferMapping(Buffer *buffer, Buffer::MapType maptype, size_t offset, size_t size);
+	virtual ~BufferMapping();
+
+	// Implements Data.
+	Data *clone() const override;
+	void *getData() const override;
+	size_t getSize() const override;
+
+	/**
+	 * Unmaps the Buffer range. Only the first usedsize bytes (all of them by
+	 * default) are written back.
+	 **/
+	void unmap();
+	void unmap(size_t usedsize);
+	bool isMapped() const { return data != nullptr; }
+
+	Buffer *getBuffer() const { return buffer; }
+	Buffer::MapType getMapType() const { return mapType; }
+
+private:
+
+	StrongRef<Buffer> buffer;
+	Buffer::MapType mapType;
+	void *data;
+	size_t offset;
+	size_t size;
+
+}; // BufferMapping
+
+} // graphics
+} // love
@@ -0,0 +1,267 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DrawList.h"
+#include "Shader.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type DrawList::type("DrawList", &Drawable::type);
+
+DrawList::DrawList(Graphics *gfx)
+	: gfx(gfx)
+	, recording(false)
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+void DrawList::clear()
+{
+	if (recording)
+		throw love::Exception("Cannot clear a DrawList while it is being recorded.");
+
+	batches.clear();
+	vertexStreams.clear();
+	indexData.clear();
+	indexBuffer.set(nullptr);
+}
+
+int DrawList::getVertexCount() const
+{
+	int count = 0;
+	for (const Batch &b : batches)
+		count += b.vertexCount;
+	return count;
+}
+
+int DrawList::getVertexStreamIndex(CommonFormat format)
+{
+	for (size_t i = 0; i < vertexStreams.size(); i++)
+	{
+		if (vertexStreams[i].format == format)
+			return (int) i;
+	}
+
+	VertexStream stream;
+	stream.format = format;
+	vertexStreams.push_back(stream);
+
+	return (int) vertexStreams.size() - 1;
+}
+
+void DrawList::beginRecording()
+{
+	clear();
+	recording = true;
+}
+
+void DrawList::endRecording()
+{
+	if (!recording)
+		return;
+
+	recording = false;
+
+	// Upload everything in one go, the CPU-side copies aren't needed anymore
+	// afterwards.
+	for (VertexStream &stream : vertexStreams)
+	{
+		if (stream.data.empty())
+			continue;
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto decl = Buffer::getCommonFormatDeclaration(stream.format);
+
+		stream.buffer.set(gfx->newBuffer(settings, decl, stream.data.data(), stream.data.size(), 0), Acquire::NORETAIN);
+
+		std::vector<uint8>().swap(stream.data);
+	}
+
+	if (!indexData.empty())
+	{
+		Buffer::Settings settings(BUFFERUSAGEFLAG_INDEX, BUFFERDATAUSAGE_STATIC);
+		size_t size = indexData.size() * sizeof(uint16);
+
+		indexBuffer.set(gfx->newBuffer(settings, DATAFORMAT_UINT16, indexData.data(), size, 0), Acquire::NORETAIN);
+
+		std::vector<uint16>().swap(indexData);
+	}
+}
+
+Graphics::BatchedVertexData DrawList::requestBatchedDraw(const Graphics::BatchedDrawCommand &cmd)
+{
+	bool newbatch = batches.empty();
+
+	if (!newbatch)
+	{
+		const Batch &b = batches.back();
+
+		if (cmd.primitiveMode != b.primitiveMode
+			|| cmd.formats[0] != b.formats[0] || cmd.formats[1] != b.formats[1]
+			|| ((cmd.indexMode != TRIANGLEINDEX_NONE) != (b.indexCount > 0))
+			|| cmd.texture != b.texture.get()
+			|| cmd.standardShaderType != b.standardShaderType)
+		{
+			newbatch = true;
+		}
+
+		// We only support uint16 index buffers for now.
+		if (b.vertexCount + cmd.vertexCount > LOVE_UINT16_MAX && cmd.indexMode != TRIANGLEINDEX_NONE)
+			newbatch = true;
+	}
+
+	int streamindices[2] = {-1, -1};
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (cmd.formats[i] != CommonFormat::NONE)
+			streamindices[i] = getVertexStreamIndex(cmd.formats[i]);
+	}
+
+	if (newbatch)
+	{
+		// Keep index offsets 4-byte aligned, some backends require it.
+		if (indexData.size() % 2 != 0)
+			indexData.push_back(0);
+
+		Batch b;
+		b.primitiveMode = cmd.primitiveMode;
+		b.formats[0] = cmd.formats[0];
+		b.formats[1] = cmd.formats[1];
+		b.texture.set(cmd.texture);
+		b.standardShaderType = cmd.standardShaderType;
+		b.indexStart = indexData.size();
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (streamindices[i] >= 0)
+				b.vertexOffsets[i] = vertexStreams[streamindices[i]].data.size();
+		}
+
+		batches.push_back(b);
+	}
+
+	Batch &b = batches.back();
+
+	if (cmd.indexMode != TRIANGLEINDEX_NONE)
+	{
+		int count = getIndexCount(cmd.indexMode, cmd.vertexCount);
+		size_t start = indexData.size();
+
+		indexData.resize(start + count);
+		fillIndices(cmd.indexMode, (uint16) b.vertexCount, (uint16) cmd.vertexCount, &indexData[start]);
+
+		b.indexCount += count;
+	}
+
+	size_t offsets[2] = {0, 0};
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (streamindices[i] < 0)
+			continue;
+
+		auto &data = vertexStreams[streamindices[i]].data;
+		offsets[i] = data.size();
+		data.resize(offsets[i] + getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+	}
+
+	// Pointers are only grabbed after all resizes are done, in case both
+	// streams share the same storage.
+	Graphics::BatchedVertexData d = {};
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (streamindices[i] >= 0)
+			d.stream[i] = vertexStreams[streamindices[i]].data.data() + offsets[i];
+	}
+
+	b.vertexCount += cmd.vertexCount;
+
+	return d;
+}
+
+void DrawList::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (recording)
+		throw love::Exception("Cannot draw a DrawList while it is being recorded.");
+
+	if (gfx->getRecordingDrawList() != nullptr)
+		throw love::Exception("Cannot draw a DrawList while another DrawList is being recorded.");
+
+	if (batches.empty())
+		return;
+
+	gfx->flushBatchedDraws();
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (const Batch &b : batches)
+	{
+		if (Shader::isDefaultActive())
+			Shader::attachDefault(b.standardShaderType);
+
+		if (Shader::current)
+			Shader::current->validateDrawState(b.primitiveMode, b.texture);
+
+		VertexAttributes attributes;
+		BufferBindings buffers;
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (b.formats[i] == CommonFormat::NONE)
+				continue;
+
+			int streamindex = getVertexStreamIndex(b.formats[i]);
+
+			attributes.setCommonFormat(b.formats[i], (uint8) i);
+			buffers.set(i, vertexStreams[streamindex].buffer, b.vertexOffsets[i]);
+		}
+
+		if (b.indexCount > 0)
+		{
+			Graphics::DrawIndexedCommand cmd(&attributes, &buffers, indexBuffer);
+			cmd.primitiveType = b.primitiveMode;
+			cmd.indexCount = b.indexCount;
+			cmd.indexType = INDEX_UINT16;
+			cmd.indexBufferOffset = b.indexStart * sizeof(uint16);
+			cmd.texture = b.texture;
+			gfx->draw(cmd);
+		}
+		else
+		{
+			Graphics::DrawCommand cmd(&attributes, &buffers);
+			cmd.primitiveType = b.primitiveMode;
+			cmd.vertexStart = 0;
+			cmd.vertexCount = b.vertexCount;
+			cmd.texture = b.texture;
+			gfx->draw(cmd);
+		}
+	}
+}
+
+} // graphics
+} // love
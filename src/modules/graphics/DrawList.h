@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "Drawable.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A DrawList captures the vertices, indices, textures and standard shader
+ * types generated by automatically batched draws (shapes, textures, text) so
+ * they can be replayed later without regenerating the geometry each frame.
+ * Other state such as the active custom shader, blend mode and stencil mode is
+ * taken from the state at the time the DrawList is drawn.
+ **/
+class DrawList : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	DrawList(Graphics *gfx);
+	virtual ~DrawList();
+
+	/**
+	 * Discards all recorded geometry.
+	 **/
+	void clear();
+
+	bool isRecording() const { return recording; }
+
+	int getDrawCount() const { return (int) batches.size(); }
+	int getVertexCount() const;
+
+	// Internal use only, called by Graphics.
+	void beginRecording();
+	void endRecording();
+	Graphics::BatchedVertexData requestBatchedDraw(const Graphics::BatchedDrawCommand &cmd);
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	struct Batch
+	{
+		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
+		CommonFormat formats[2];
+		StrongRef<Texture> texture;
+		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
+
+		size_t vertexOffsets[2];
+		int vertexCount = 0;
+
+		size_t indexStart = 0;
+		int indexCount = 0;
+
+		Batch()
+		{
+			formats[0] = formats[1] = CommonFormat::NONE;
+			vertexOffsets[0] = vertexOffsets[1] = 0;
+		}
+	};
+
+	// All vertices which share a vertex format are packed into one Buffer.
+	struct VertexStream
+	{
+		CommonFormat format;
+		std::vector<uint8> data;
+		StrongRef<Buffer> buffer;
+	};
+
+	int getVertexStreamIndex(CommonFormat format);
+
+	Graphics *gfx;
+
+	std::vector<Batch> batches;
+	std::vector<VertexStream> vertexStreams;
+
+	std::vector<uint16> indexData;
+	StrongRef<Buffer> indexBuffer;
+
+	bool recording;
+
+}; // DrawList
+
+} // graphics
+} // love
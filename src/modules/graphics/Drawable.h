@@ -51,6 +51,15 @@ public:
 	 * Draws the object with the specified transformation matrix.
 	 **/
 	virtual void draw(Graphics *gfx, const Matrix4 &m) = 0;
+
+	/**
+	 * Gets the local-space bounding rectangle of everything the object draws,
+	 * used for draw culling. Returns false if the bounds aren't known.
+	 **/
+	virtual bool getBounds(float &/*x*/, float &/*y*/, float &/*w*/, float &/*h*/) const
+	{
+		return false;
+	}
 };
 
 } // graphics
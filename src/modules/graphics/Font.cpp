@@ -20,9 +20,11 @@
 #include "common/config.h"
 #include "Font.h"
 #include "font/GlyphData.h"
+#include "image/ImageData.h"
 
 #include "common/math.h"
 #include "common/Matrix.h"
+#include "common/Trace.h"
 #include "Graphics.h"
 
 #include <math.h>
@@ -59,19 +61,24 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 	: shaper(r->newTextShaper(), Acquire::NORETAIN)
 	, textureWidth(128)
 	, textureHeight(128)
+	, denseGlyphs(DENSE_GLYPH_COUNT, nullptr)
 	, samplerState()
 	, dpiScale(r->getDPIScale())
 	, textureCacheID(0)
 {
+	emptyGlyph.texture = nullptr;
+	memset(emptyGlyph.vertices, 0, sizeof(GlyphVertex) * 4);
+
 	samplerState.minFilter = s.minFilter;
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
-	// Try to find the best texture size match for the font size. default to the
-	// largest texture size if no rough match is found.
+	// Atlas pages never grow, so pick a size with room for a decent number of
+	// glyphs at this font size. Default to the largest page size if no rough
+	// match is found.
 	while (true)
 	{
-		if ((shaper->getHeight() * 0.8) * shaper->getHeight() * 30 <= textureWidth * textureHeight)
+		if ((shaper->getHeight() * 0.8) * shaper->getHeight() * GLYPHS_PER_PAGE <= textureWidth * textureHeight)
 			break;
 
 		TextureSize nextsize = getNextTextureSize();
@@ -112,8 +119,8 @@ Font::TextureSize Font::getNextTextureSize() const
 		maxsize = (int) caps.limits[Graphics::LIMIT_TEXTURE_SIZE];
 	}
 
-	int maxwidth  = std::min(8192, maxsize);
-	int maxheight = std::min(4096, maxsize);
+	int maxwidth  = std::min(2048, maxsize);
+	int maxheight = std::min(2048, maxsize);
 
 	if (size.width * 2 <= maxwidth || size.height * 2 <= maxheight)
 	{
@@ -130,31 +137,26 @@ Font::TextureSize Font::getNextTextureSize() const
 bool Font::loadVolatile()
 {
 	textureCacheID++;
-	glyphs.clear();
+	clearGlyphs();
 	textures.clear();
-	createTexture();
+	skylines.clear();
+	pageTextures.clear();
+
+	// Image fonts draw their glyphs from their own pages, so an atlas page is
+	// only created if something (a fallback, usually) ends up needing one.
+	if (shaper->getRasterizers()[0]->getDataType() != font::Rasterizer::DATA_IMAGE)
+		createTexture(textureWidth, textureHeight);
+
 	return true;
 }
 
-void Font::createTexture()
+void Font::createTexture(int width, int height)
 {
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	gfx->flushBatchedDraws();
 
 	Texture *texture = nullptr;
-	TextureSize size = {textureWidth, textureHeight};
-	TextureSize nextsize = getNextTextureSize();
-	bool recreatetexture = false;
-
-	// If we have an existing texture already, we'll try replacing it with a
-	// larger-sized one rather than creating a second one. Having a single
-	// texture reduces texture switches and draw calls when rendering.
-	if ((nextsize.width > size.width || nextsize.height > size.height) && !textures.empty())
-	{
-		recreatetexture = true;
-		size = nextsize;
-		textures.pop_back();
-	}
+	TextureSize size = {width, height};
 
 	Texture::Settings settings;
 	settings.format = pixelFormat;
@@ -196,32 +198,109 @@ void Font::createTexture()
 
 	textures.emplace_back(texture, Acquire::NORETAIN);
 
-	textureWidth  = size.width;
-	textureHeight = size.height;
+	skylines.emplace_back();
+	resetSkyline(textures.size() - 1);
+}
+
+void Font::resetSkyline(size_t page)
+{
+	int width = textures[page]->getPixelWidth();
+
+	skylines[page].clear();
+	skylines[page].push_back({TEXTURE_PADDING, TEXTURE_PADDING, width - TEXTURE_PADDING});
+}
+
+bool Font::packGlyph(size_t page, int w, int h, int &outx, int &outy)
+{
+	std::vector<SkylineNode> &skyline = skylines[page];
+	int pagewidth = textures[page]->getPixelWidth();
+	int pageheight = textures[page]->getPixelHeight();
+
+	w += TEXTURE_PADDING;
+	h += TEXTURE_PADDING;
+
+	int bestindex = -1;
+	int besty = 0;
+	int bestbottom = LOVE_INT32_MAX;
+	int bestwidth = LOVE_INT32_MAX;
+
+	// Bottom-left placement: the position where the glyph's bottom edge ends
+	// up lowest, preferring narrower spans of the skyline to reduce waste.
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int x = skyline[i].x;
+		if (x + w > pagewidth)
+			break;
+
+		int y = 0;
+		int remaining = w;
+		for (size_t j = i; remaining > 0 && j < skyline.size(); j++)
+		{
+			y = std::max(y, skyline[j].y);
+			remaining -= skyline[j].width;
+		}
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+		if (y + h > pageheight)
+			continue;
 
-	// Re-add the old glyphs if we re-created the existing texture object.
-	if (recreatetexture)
+		if (y + h < bestbottom || (y + h == bestbottom && skyline[i].width < bestwidth))
+		{
+			bestindex = (int) i;
+			besty = y;
+			bestbottom = y + h;
+			bestwidth = skyline[i].width;
+		}
+	}
+
+	if (bestindex < 0)
+		return false;
+
+	SkylineNode node = {skyline[bestindex].x, bestbottom, w};
+	skyline.insert(skyline.begin() + bestindex, node);
+
+	// Shrink or remove the nodes covered by the new one.
+	for (size_t i = bestindex + 1; i < skyline.size();)
 	{
-		textureCacheID++;
+		const SkylineNode &prev = skyline[i - 1];
+		int overlap = prev.x + prev.width - skyline[i].x;
+
+		if (overlap <= 0)
+			break;
 
-		std::vector<love::font::TextShaper::GlyphIndex> glyphstoadd;
+		if (overlap >= skyline[i].width)
+		{
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
 
-		for (const auto &glyphpair : glyphs)
-			glyphstoadd.push_back(unpackGlyphIndex(glyphpair.first));
+		skyline[i].x += overlap;
+		skyline[i].width -= overlap;
+		break;
+	}
 
-		glyphs.clear();
-		
-		for (auto glyphindex : glyphstoadd)
-			addGlyph(glyphindex);
+	// Merge neighbouring nodes at the same height.
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			i++;
 	}
+
+	outx = node.x;
+	outy = besty;
+	return true;
 }
 
 void Font::unloadVolatile()
 {
-	glyphs.clear();
+	clearGlyphs();
 	textures.clear();
+	skylines.clear();
+	pageTextures.clear();
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale)
@@ -231,35 +310,100 @@ love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::Glyp
 	return r->getGlyphDataForIndex(glyphindex.index);
 }
 
-const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+bool Font::addPageGlyph(love::font::TextShaper::GlyphIndex glyphindex, Glyph &g)
 {
-	float glyphdpiscale = getDPIScale();
-	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+	const auto &r = shaper->getRasterizers()[glyphindex.rasterizerIndex];
 
-	int w = gd->getWidth();
-	int h = gd->getHeight();
+	int pageindex = 0;
+	int x = 0;
+	int y = 0;
+	love::font::GlyphMetrics gm = {};
+
+	love::image::ImageData *pagedata = r->getGlyphPage(glyphindex.index, pageindex, x, y, gm);
+	if (pagedata == nullptr)
+		return false;
+
+	g.texture = nullptr;
+	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
+
+	int w = gm.width;
+	int h = gm.height;
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
+	if (w <= 0 || h <= 0)
+		return true;
+
+	uint64 pagekey = ((uint64)glyphindex.rasterizerIndex << 32) | (uint64)(uint32)pageindex;
+	auto it = pageTextures.find(pagekey);
+
+	if (it == pageTextures.end())
 	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
-		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
-		}
+		auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+		gfx->flushBatchedDraws();
 
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
-		{
-			// Totally out of space - new texture!
-			createTexture();
+		Texture::Slices slices(TEXTURE_2D);
+		slices.set(0, 0, pagedata);
 
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyphindex);
-		}
+		Texture::Settings settings;
+		settings.format = pagedata->getFormat();
+		settings.width = pagedata->getWidth();
+		settings.height = pagedata->getHeight();
+
+		StrongRef<Texture> texture(gfx->newTexture(settings, &slices), Acquire::NORETAIN);
+		texture->setSamplerState(samplerState);
+
+		it = pageTextures.emplace(pagekey, texture).first;
 	}
 
+	Texture *texture = it->second;
+	g.texture = texture;
+
+	float glyphdpiscale = r->getDPIScale();
+
+	double tX     = (double) x,     tY      = (double) y;
+	double tWidth = (double) texture->getPixelWidth(), tHeight = (double) texture->getPixelHeight();
+
+	Color32 c(255, 255, 255, 255);
+
+	// Unlike atlas glyphs, the quads aren't extruded: whatever is next to the
+	// glyph on its page isn't guaranteed to be transparent.
+	const GlyphVertex verts[4] =
+	{
+		{0.0f,            0.0f,            normToUint16(tX/tWidth),     normToUint16(tY/tHeight),     c},
+		{0.0f,            h/glyphdpiscale, normToUint16(tX/tWidth),     normToUint16((tY+h)/tHeight), c},
+		{w/glyphdpiscale, 0.0f,            normToUint16((tX+w)/tWidth), normToUint16(tY/tHeight),     c},
+		{w/glyphdpiscale, h/glyphdpiscale, normToUint16((tX+w)/tWidth), normToUint16((tY+h)/tHeight), c}
+	};
+
+	for (int i = 0; i < 4; i++)
+	{
+		g.vertices[i] = verts[i];
+		g.vertices[i].x += gm.bearingX / glyphdpiscale;
+		g.vertices[i].y -= gm.bearingY / glyphdpiscale;
+	}
+
+	return true;
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	Glyph pageglyph;
+	if (addPageGlyph(glyphindex, pageglyph))
+	{
+		uint64 packedindex = packGlyphIndex(glyphindex);
+		glyphs[packedindex] = pageglyph;
+		return glyphs[packedindex];
+	}
+
+	float glyphdpiscale = getDPIScale();
+	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+	return addGlyph(glyphindex, gd, glyphdpiscale);
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale)
+{
+	int w = gd->getWidth();
+	int h = gd->getHeight();
+
 	Glyph g;
 
 	g.texture = nullptr;
@@ -268,7 +412,35 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Texture *texture = textures.back();
+		int textureX = 0;
+		int textureY = 0;
+		int page = -1;
+
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (packGlyph(i, w, h, textureX, textureY))
+			{
+				page = (int) i;
+				break;
+			}
+		}
+
+		if (page < 0)
+		{
+			// Out of space - new page! Existing pages are never resized, so
+			// their glyphs don't have to be uploaded again. Glyphs which are too
+			// big for a regular page get one of their own.
+			int pagewidth = std::max(textureWidth, nextP2(w + TEXTURE_PADDING * 2));
+			int pageheight = std::max(textureHeight, nextP2(h + TEXTURE_PADDING * 2));
+
+			createTexture(pagewidth, pageheight);
+
+			page = (int) textures.size() - 1;
+			if (!packGlyph(page, w, h, textureX, textureY))
+				throw love::Exception("Cannot fit font glyph into a new texture atlas page.");
+		}
+
+		Texture *texture = textures[page];
 		g.texture = texture;
 
 		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
@@ -300,7 +472,7 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 		}
 
 		double tX     = (double) textureX,     tY      = (double) textureY;
-		double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+		double tWidth = (double) texture->getPixelWidth(), tHeight = (double) texture->getPixelHeight();
 
 		Color32 c(255, 255, 255, 255);
 
@@ -327,9 +499,6 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 			g.vertices[i].x += gd->getBearingX() / glyphdpiscale;
 			g.vertices[i].y -= gd->getBearingY() / glyphdpiscale;
 		}
-
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
 	}
 
 	uint64 packedindex = packGlyphIndex(glyphindex);
@@ -339,13 +508,107 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 
 const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 {
+	bool dense = glyphindex.rasterizerIndex == 0 && glyphindex.index >= 0 && glyphindex.index < DENSE_GLYPH_COUNT;
+
+	if (dense && denseGlyphs[glyphindex.index] != nullptr)
+		return *denseGlyphs[glyphindex.index];
+
 	uint64 packedindex = packGlyphIndex(glyphindex);
 	const auto it = glyphs.find(packedindex);
 
+	// References to unordered_map values stay valid until they're erased.
 	if (it != glyphs.end())
+	{
+		if (dense)
+			denseGlyphs[glyphindex.index] = &it->second;
 		return it->second;
+	}
+
+	if (asyncRasterizer.get() != nullptr)
+	{
+		if (pendingGlyphs.insert(packedindex).second)
+			asyncRasterizer->request(glyphindex);
+		return emptyGlyph;
+	}
+
+	const Glyph &g = addGlyph(glyphindex);
+	if (dense)
+		denseGlyphs[glyphindex.index] = &g;
+	return g;
+}
+
+void Font::clearGlyphs()
+{
+	glyphs.clear();
+	std::fill(denseGlyphs.begin(), denseGlyphs.end(), nullptr);
+}
+
+void Font::createAsyncRasterizer()
+{
+	std::vector<StrongRef<love::font::Rasterizer>> clones;
+
+	for (const auto &r : shaper->getRasterizers())
+	{
+		StrongRef<love::font::Rasterizer> clone(r->clone(), Acquire::NORETAIN);
+		if (clone.get() == nullptr)
+			throw love::Exception("Asynchronous glyph rasterization is only supported for TrueType fonts (including fallbacks).");
+		clones.push_back(clone);
+	}
+
+	asyncRasterizer.set(new GlyphRasterizerThread(clones), Acquire::NORETAIN);
+	pendingGlyphs.clear();
+}
+
+void Font::setAsyncRasterization(bool enable)
+{
+	if (enable == isAsyncRasterization())
+		return;
 
-	return addGlyph(glyphindex);
+	if (enable)
+		createAsyncRasterizer();
+	else
+	{
+		asyncRasterizer.set(nullptr);
+		pendingGlyphs.clear();
+	}
+}
+
+bool Font::isAsyncRasterization() const
+{
+	return asyncRasterizer.get() != nullptr;
+}
+
+void Font::flushAsyncGlyphs()
+{
+	if (asyncRasterizer.get() == nullptr)
+		return;
+
+	std::vector<GlyphRasterizerThread::Result> results;
+	asyncRasterizer->getResults(results);
+
+	if (results.empty())
+		return;
+
+	const auto &rasterizers = shaper->getRasterizers();
+
+	for (const auto &result : results)
+	{
+		uint64 packedindex = packGlyphIndex(result.glyphIndex);
+		pendingGlyphs.erase(packedindex);
+
+		if (glyphs.find(packedindex) != glyphs.end())
+			continue;
+
+		// Rasterizing it again here reports the error, if there was one.
+		if (result.data.get() == nullptr)
+			addGlyph(result.glyphIndex);
+		else
+			addGlyph(result.glyphIndex, result.data, rasterizers[result.glyphIndex.rasterizerIndex]->getDPIScale());
+	}
+
+	// Text which was generated while the glyphs were pending has to be
+	// generated again.
+	textureCacheID++;
 }
 
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
@@ -369,6 +632,8 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 	std::vector<love::font::IndexedColor> colors;
 	shaper->computeGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
 
+	flushAsyncGlyphs();
+
 	size_t vertstartsize = vertices.size();
 	vertices.reserve(vertstartsize + glyphpositions.size() * 4);
 
@@ -458,19 +723,31 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 }
 
 std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info)
+{
+	if (text.cps.empty())
+	{
+		if (info != nullptr)
+			*info = {};
+		return {};
+	}
+
+	return generateVerticesFormatted(text, Range(0, text.cps.size()), constantcolor, wrap, align, vertices, 0, info);
+}
+
+std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, Range textrange, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, int startline, love::font::TextShaper::TextInfo *info, int *linecount)
 {
 	wrap = std::max(wrap, 0.0f);
 
 	uint32 cacheid = textureCacheID;
 
 	std::vector<DrawCommand> drawcommands;
-	vertices.reserve(text.cps.size() * 4);
+	vertices.reserve(vertices.size() + textrange.getSize() * 4);
 
 	std::vector<Range> ranges;
 	std::vector<int> widths;
-	shaper->getWrap(text, wrap, ranges, &widths);
+	shaper->getWrap(text, textrange, wrap, ranges, &widths);
 
-	float y = 0.0f;
+	float lineheight = getHeight() * getLineHeight();
 	float maxwidth = 0.0f;
 
 	for (int i = 0; i < (int)ranges.size(); i++)
@@ -478,10 +755,11 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 		const auto& range = ranges[i];
 
 		if (!range.isValid())
-		{
-			y += getHeight() * getLineHeight();
 			continue;
-		}
+
+		// Computed from the line index rather than accumulated, so a range
+		// starting partway through a text lines up with the full layout.
+		float y = (startline + i) * lineheight;
 
 		float width = (float) widths[i];
 		love::Vector2 offset(0.0f, floorf(y));
@@ -535,20 +813,21 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 			// Append the new draw commands to the list we're building.
 			drawcommands.insert(drawcommands.end(), firstcmd, newcommands.end());
 		}
-
-		y += getHeight() * getLineHeight();
 	}
 
 	if (info != nullptr)
 	{
 		info->width = (int) maxwidth;
-		info->height = (int) y;
+		info->height = (int) (ranges.size() * lineheight);
 	}
 
+	if (linecount != nullptr)
+		*linecount = (int) ranges.size();
+
 	if (cacheid != textureCacheID)
 	{
 		vertices.clear();
-		drawcommands = generateVerticesFormatted(text, constantcolor, wrap, align, vertices);
+		drawcommands = generateVerticesFormatted(text, textrange, constantcolor, wrap, align, vertices, startline);
 	}
 
 	return drawcommands;
@@ -568,6 +847,7 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = TRIANGLEINDEX_QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = getStandardShader();
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
@@ -579,6 +859,8 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 
 void Font::print(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
 {
+	LOVE_TRACE_ZONE("Font::print");
+
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
@@ -590,6 +872,8 @@ void Font::print(graphics::Graphics *gfx, const std::vector<love::font::ColoredS
 
 void Font::printf(graphics::Graphics *gfx, const std::vector<love::font::ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
 {
+	LOVE_TRACE_ZONE("Font::printf");
+
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
@@ -637,6 +921,9 @@ void Font::setSamplerState(const SamplerState &s)
 
 	for (const auto &texture : textures)
 		texture->setSamplerState(samplerState);
+
+	for (const auto &page : pageTextures)
+		page.second->setSamplerState(samplerState);
 }
 
 const SamplerState &Font::getSamplerState() const
@@ -673,17 +960,29 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 {
 	std::vector<love::font::Rasterizer*> rasterizerfallbacks;
 	for (const Font* f : fallbacks)
+	{
+		if (f->isSDF() != isSDF())
+			throw love::Exception("Font fallbacks must all be signed distance field fonts, or none of them.");
+
 		rasterizerfallbacks.push_back(f->shaper->getRasterizers()[0]);
+	}
 
 	shaper->setFallbacks(rasterizerfallbacks);
 
+	// Rasterizer indices change with the fallbacks.
+	if (asyncRasterizer.get() != nullptr)
+		createAsyncRasterizer();
+
 	// Invalidate existing textures.
 	textureCacheID++;
-	glyphs.clear();
+	clearGlyphs();
+	pageTextures.clear();
 	while (textures.size() > 1)
 		textures.pop_back();
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	skylines.resize(textures.size());
+	if (!textures.empty())
+		resetSkyline(0);
 }
 
 float Font::getDPIScale() const
@@ -696,6 +995,16 @@ uint32 Font::getTextureCacheID() const
 	return textureCacheID;
 }
 
+bool Font::isSDF() const
+{
+	return shaper->getRasterizers()[0]->isSDF();
+}
+
+Shader::StandardShader Font::getStandardShader() const
+{
+	return isSDF() ? Shader::STANDARD_SDF : Shader::STANDARD_DEFAULT;
+}
+
 bool Font::getConstant(const char *in, AlignMode &out)
 {
 	return alignModes.find(in, out);
@@ -22,6 +22,7 @@
 
 // STD
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <stddef.h>
@@ -35,8 +36,10 @@
 #include "font/Rasterizer.h"
 #include "font/TextShaper.h"
 #include "Texture.h"
+#include "Shader.h"
 #include "vertex.h"
 #include "Volatile.h"
+#include "GlyphRasterizerThread.h"
 
 namespace love
 {
@@ -83,6 +86,14 @@ public:
 	std::vector<DrawCommand> generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantColor, float wrap, AlignMode align,
 	                                                   std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info = nullptr);
 
+	/**
+	 * Wraps and generates vertices for only the given range of the text, with
+	 * its first line placed as if startline lines came before it. Optionally
+	 * outputs the number of lines.
+	 **/
+	std::vector<DrawCommand> generateVerticesFormatted(const love::font::ColoredCodepoints &text, Range range, const Colorf &constantColor, float wrap, AlignMode align,
+	                                                   std::vector<GlyphVertex> &vertices, int startline, love::font::TextShaper::TextInfo *info = nullptr, int *linecount = nullptr);
+
 	/**
 	 * Draws the specified text.
 	 **/
@@ -150,6 +161,27 @@ public:
 
 	uint32 getTextureCacheID() const;
 
+	/**
+	 * Whether the glyphs are signed distance fields. SDF fonts are drawn with
+	 * Shader::STANDARD_SDF, and one Font can be scaled to any size.
+	 **/
+	bool isSDF() const;
+	Shader::StandardShader getStandardShader() const;
+
+	/**
+	 * When enabled, glyphs which aren't in the atlas yet are rasterized on a
+	 * background thread and drawn as blank until they're ready, instead of
+	 * stalling the frame which first uses them. Only TrueType fonts support it.
+	 **/
+	void setAsyncRasterization(bool enable);
+	bool isAsyncRasterization() const;
+
+	/**
+	 * Adds glyphs which finished rasterizing in the background to the atlas,
+	 * and invalidates the texture cache if there were any.
+	 **/
+	void flushAsyncGlyphs();
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -174,11 +206,24 @@ private:
 		int height;
 	};
 
-	void createTexture();
+	struct SkylineNode
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	void createTexture(int width, int height);
+	void resetSkyline(size_t page);
+	bool packGlyph(size_t page, int w, int h, int &outx, int &outy);
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale);
 	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale);
+	bool addPageGlyph(love::font::TextShaper::GlyphIndex glyphindex, Glyph &g);
+	void createAsyncRasterizer();
+	void clearGlyphs();
 	const Glyph &findGlyph(love::font::TextShaper::GlyphIndex glyphindex);
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
 
@@ -187,19 +232,35 @@ private:
 	int textureWidth;
 	int textureHeight;
 
+	// Fixed-size atlas pages, each with its own skyline of packed glyphs.
 	std::vector<StrongRef<Texture>> textures;
+	std::vector<std::vector<SkylineNode>> skylines;
+
+	// Textures made directly from the page images of BMFont and ImageFont
+	// rasterizers, indexed by packed (rasterizer, page) values. Glyphs on
+	// those pages are never copied into the atlas.
+	std::unordered_map<uint64, StrongRef<Texture>> pageTextures;
 
 	// maps packed glyph index values to glyph texture information
 	std::unordered_map<uint64, Glyph> glyphs;
 
+	// Direct lookup into glyphs for the low glyph indices of the primary
+	// rasterizer, which is where most Latin text ends up.
+	std::vector<const Glyph *> denseGlyphs;
+
 	PixelFormat pixelFormat;
 
 	SamplerState samplerState;
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
+	StrongRef<GlyphRasterizerThread> asyncRasterizer;
+
+	// Glyphs requested from asyncRasterizer which haven't been added yet.
+	std::unordered_set<uint64> pendingGlyphs;
+
+	// Returned in place of glyphs which are still being rasterized.
+	Glyph emptyGlyph;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
@@ -209,6 +270,11 @@ private:
 	// use, for edge antialiasing.
 	static const int TEXTURE_PADDING = 2;
 
+	// Rough number of glyphs the first atlas page should be able to hold.
+	static const int GLYPHS_PER_PAGE = 128;
+
+	static const int DENSE_GLYPH_COUNT = 512;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "GlyphRasterizerThread.h"
+
+namespace love
+{
+namespace graphics
+{
+
+GlyphRasterizerThread::GlyphRasterizerThread(const std::vector<StrongRef<love::font::Rasterizer>> &rasterizers)
+	: rasterizers(rasterizers)
+	, stopping(false)
+{
+	threadName = "GlyphRasterizer";
+}
+
+GlyphRasterizerThread::~GlyphRasterizerThread()
+{
+	stop();
+}
+
+void GlyphRasterizerThread::request(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	{
+		love::thread::Lock lock(mutex);
+		requests.push(glyphindex);
+		stopping = false;
+	}
+
+	cond->broadcast();
+
+	if (!isRunning())
+		start();
+}
+
+void GlyphRasterizerThread::getResults(std::vector<Result> &outresults)
+{
+	love::thread::Lock lock(mutex);
+
+	for (Result &r : results)
+		outresults.push_back(r);
+
+	results.clear();
+}
+
+void GlyphRasterizerThread::stop()
+{
+	{
+		love::thread::Lock lock(mutex);
+		stopping = true;
+
+		while (!requests.empty())
+			requests.pop();
+	}
+
+	cond->broadcast();
+	wait();
+}
+
+void GlyphRasterizerThread::threadFunction()
+{
+	while (true)
+	{
+		love::font::TextShaper::GlyphIndex glyphindex;
+
+		{
+			love::thread::Lock lock(mutex);
+
+			while (requests.empty() && !stopping)
+				cond->wait(mutex);
+
+			if (requests.empty())
+				return;
+
+			glyphindex = requests.front();
+			requests.pop();
+		}
+
+		Result result;
+		result.glyphIndex = glyphindex;
+
+		try
+		{
+			const auto &r = rasterizers[glyphindex.rasterizerIndex];
+			result.data.set(r->getGlyphDataForIndex(glyphindex.index), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			// The Font rasterizes failed glyphs itself, which reports the error.
+		}
+
+		love::thread::Lock lock(mutex);
+		results.push_back(result);
+	}
+}
+
+} // graphics
+} // love
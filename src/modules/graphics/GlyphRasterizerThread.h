@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "font/Rasterizer.h"
+#include "font/TextShaper.h"
+#include "font/GlyphData.h"
+
+// C++
+#include <vector>
+#include <queue>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Rasterizes font glyphs on a background thread, using copies of a Font's
+ * rasterizers so they're never used by two threads at once.
+ **/
+class GlyphRasterizerThread : public love::thread::Threadable
+{
+public:
+
+	struct Result
+	{
+		love::font::TextShaper::GlyphIndex glyphIndex;
+
+		// Null if rasterizing the glyph failed.
+		StrongRef<love::font::GlyphData> data;
+	};
+
+	GlyphRasterizerThread(const std::vector<StrongRef<love::font::Rasterizer>> &rasterizers);
+	virtual ~GlyphRasterizerThread();
+
+	void request(love::font::TextShaper::GlyphIndex glyphindex);
+
+	/**
+	 * Moves every finished glyph into results.
+	 **/
+	void getResults(std::vector<Result> &results);
+
+	void stop();
+
+	void threadFunction() override;
+
+private:
+
+	std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	std::queue<love::font::TextShaper::GlyphIndex> requests;
+	std::vector<Result> results;
+	bool stopping;
+
+}; // GlyphRasterizerThread
+
+} // graphics
+} // love
@@ -28,15 +28,24 @@
 #include "window/Window.h"
 #include "SpriteBatch.h"
 #include "ParticleSystem.h"
+#include "Line.h"
 #include "Font.h"
 #include "Video.h"
 #include "TextBatch.h"
+#include "DrawList.h"
+#include "ReadbackRing.h"
+#include "ShaderBundle.h"
+#include "filesystem/Filesystem.h"
 #include "common/deprecation.h"
 #include "common/config.h"
+#include "common/version.h"
+#include "common/Trace.h"
 
 // C++
 #include <algorithm>
+#include <thread>
 #include <stdlib.h>
+#include <string.h>
 
 namespace love
 {
@@ -187,18 +196,31 @@ Graphics::Graphics()
 	, pixelHeight(0)
 	, created(false)
 	, active(true)
+	, framesInFlight(2)
+	, lowLatency(false)
+	, gpuFrameTime(0.0)
+	, activeOcclusionQuery(nullptr)
 	, batchedDrawState()
+	, recordingDrawList(nullptr)
+	, batchSortMode(BATCH_SORT_NONE)
+	, batchSortDepth(0.0f)
+	, pipelineMissLogging(false)
+	, parallelRenderPassRecording(false)
+	, textureStreamingBudget(-1)
+	, textureStreamingFrame(0)
+	, streamedTextureData(0)
 	, deviceProjectionMatrix()
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, drawsCulled(0)
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
 	, capabilities()
 	, cachedShaderStages()
 {
 	transformStack.reserve(16);
-	transformStack.push_back(Matrix4());
+	pushIdentityTransform();
 
 	pixelScaleStack.reserve(16);
 	pixelScaleStack.push_back(1);
@@ -212,10 +234,24 @@ Graphics::Graphics()
 
 Graphics::~Graphics()
 {
+	for (const auto &job : shaderCompileJobs)
+		job->wait();
+
+	shaderCompileJobs.clear();
+	queuedShaderCompiles.clear();
+	pendingShaders.clear();
+
 	if (quadIndexBuffer != nullptr)
 		quadIndexBuffer->release();
 	if (fanIndexBuffer != nullptr)
 		fanIndexBuffer->release();
+	if (instancedShapeState.vertexBuffer != nullptr)
+		instancedShapeState.vertexBuffer->release();
+
+	mipmapComputeShader.set(nullptr);
+	particleComputeShader.set(nullptr);
+	particleRenderShader.set(nullptr);
+	lineShader.set(nullptr);
 
 	// Clean up standard shaders before the active shader. If we do it after,
 	// the active shader may try to activate a standard shader when deactivating
@@ -234,6 +270,9 @@ Graphics::~Graphics()
 
 	defaultFont.set(nullptr);
 
+	if (recordingDrawList != nullptr)
+		recordingDrawList->release();
+
 	if (batchedDrawState.vb[0])
 		batchedDrawState.vb[0]->release();
 	if (batchedDrawState.vb[1])
@@ -247,6 +286,10 @@ Graphics::~Graphics()
 	pendingReadbacks.clear();
 	clearTemporaryResources();
 
+	// Screenshots which are still queued are written before quitting.
+	if (screenshotEncoder.get())
+		screenshotEncoder->finish();
+
 	Shader::deinitialize();
 }
 
@@ -309,14 +352,24 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage)
+TileMap *Graphics::newTileMap(Texture *texture, int tilewidth, int tileheight, int width, int height, const TileMap::Settings &settings)
+{
+	return new TileMap(this, texture, tilewidth, tileheight, width, height, settings);
+}
+
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced)
+{
+	return new SpriteBatch(this, texture, size, usage, instanced);
+}
+
+love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size, bool gpu)
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new ParticleSystem(texture, size, gpu);
 }
 
-love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
+Line *Graphics::newLine(const Vector2 *points, size_t count, bool gpuExpanded)
 {
-	return new ParticleSystem(texture, size);
+	return new Line(this, points, count, gpuExpanded);
 }
 
 ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache)
@@ -324,16 +377,19 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 	ShaderStage *s = nullptr;
 	std::string cachekey;
 
-	// Never cache if there are custom defines set... because hashing would get
-	// more complicated/expensive, and there shouldn't be a lot of duplicate
-	// shader stages with custom defines anyway.
-	if (!options.defines.empty())
-		cache = false;
-
 	if (cache && !source.empty())
 	{
+		// The defines are part of the key, so each variant of a shader gets
+		// its own cache entry.
+		std::string keysource = source;
+		if (!options.defines.empty())
+		{
+			keysource += '\0';
+			keysource += Shader::getDefinesKey(options.defines);
+		}
+
 		data::HashFunction::Value hashvalue;
-		data::hash(data::HashFunction::FUNCTION_SHA1, source.c_str(), source.size(), hashvalue);
+		data::hash(data::HashFunction::FUNCTION_SHA1, keysource.c_str(), keysource.size(), hashvalue);
 
 		cachekey = std::string(hashvalue.data, hashvalue.size);
 
@@ -349,7 +405,7 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 	{
 		bool glsles = usesGLSLES();
 		std::string glsl = Shader::createShaderStageCode(this, stage, source, options, info, glsles, true);
-		s = newShaderStageInternal(stage, cachekey, glsl, glsles);
+		s = newShaderStageInternal(stage, cachekey, glsl, glsles, nullptr);
 		if (cache && !cachekey.empty())
 			cachedShaderStages[stage][cachekey] = s;
 	}
@@ -359,6 +415,13 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 
 Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
 {
+	if (stagessource.size() == 1 && ShaderBundle::isBundle(stagessource[0]))
+		return newShaderFromBundle(stagessource[0], false);
+
+	Shader *cachedshader = newShaderWithDiskCache(stagessource, options, false);
+	if (cachedshader != nullptr)
+		return cachedshader;
+
 	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
 
 	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
@@ -399,11 +462,20 @@ Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const
 
 	}
 
-	return newShaderInternal(stages);
+	Shader *shader = newShaderInternal(stages, nullptr);
+	shader->setVariantSource(stagessource, options, false);
+	return shader;
 }
 
 Shader *Graphics::newComputeShader(const std::string &source, const Shader::CompileOptions &options)
 {
+	if (ShaderBundle::isBundle(source))
+		return newShaderFromBundle(source, true);
+
+	Shader *cachedshader = newShaderWithDiskCache({source}, options, true);
+	if (cachedshader != nullptr)
+		return cachedshader;
+
 	Shader::SourceInfo info = Shader::getSourceInfo(source);
 
 	if (info.stages[SHADERSTAGE_COMPUTE] == Shader::ENTRYPOINT_NONE)
@@ -415,199 +487,892 @@ Shader *Graphics::newComputeShader(const std::string &source, const Shader::Comp
 	// shouldn't be much reuse.
 	stages[SHADERSTAGE_COMPUTE].set(newShaderStage(SHADERSTAGE_COMPUTE, source, options, info, false));
 
-	return newShaderInternal(stages);
+	Shader *shader = newShaderInternal(stages, nullptr);
+	shader->setVariantSource({source}, options, true);
+	return shader;
 }
 
-Buffer *Graphics::newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength)
+Shader *Graphics::getShaderVariant(Shader *shader, const std::map<std::string, std::string> &defines)
 {
-	std::vector<Buffer::DataDeclaration> dataformat = {{"", format, 0}};
-	return newBuffer(settings, dataformat, data, size, arraylength);
+	if (!shader->hasVariantSource())
+		throw love::Exception("Variants can only be created from Shaders which were created from source code.");
+
+	Shader::CompileOptions options = shader->getVariantOptions();
+	for (const auto &def : defines)
+		options.defines[def.first] = def.second;
+
+	std::string key = Shader::getDefinesKey(options.defines);
+
+	Shader *variant = shader->getCachedVariant(key);
+	if (variant != nullptr)
+		return variant;
+
+	const auto &sources = shader->getVariantSources();
+
+	StrongRef<Shader> newvariant;
+	if (shader->isVariantCompute())
+		newvariant.set(newComputeShader(sources[0], options), Acquire::NORETAIN);
+	else
+		newvariant.set(newShader(sources, options), Acquire::NORETAIN);
+
+	shader->addCachedVariant(key, newvariant);
+	return newvariant;
 }
 
-Mesh *Graphics::newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, int vertexcount, PrimitiveType drawmode, BufferDataUsage usage)
+Shader *Graphics::newShaderFromBundle(const std::string &bundledata, bool compute)
 {
-	return new Mesh(this, vertexformat, vertexcount, drawmode, usage);
+	ShaderBundle bundle;
+	bundle.deserialize(bundledata.data(), bundledata.size());
+
+	if (compute && !bundle.compute)
+		throw love::Exception("The shader bundle does not contain a compute shader.");
+	else if (!compute && bundle.compute)
+		throw love::Exception("The shader bundle contains a compute shader, which must be loaded with newComputeShader.");
+
+	const ShaderBundle::Variant *variant = getSupportedVariant(bundle);
+
+	// Compiling the original code also produces the right error messages for
+	// shaders this system doesn't support.
+	if (variant == nullptr)
+	{
+		if (compute)
+			return newComputeShader(bundle.sources[0], bundle.options);
+		else
+			return newShader(bundle.sources, bundle.options);
+	}
+
+	return newShaderFromVariant(*variant, bundle.sources, bundle.options, compute);
 }
 
-Mesh *Graphics::newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage)
+Shader *Graphics::newShaderFromVariant(const ShaderBundle::Variant &variant, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute)
 {
-	return new Mesh(this, vertexformat, data, datasize, drawmode, usage);
+	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM];
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (variant.glsl[i].empty())
+			continue;
+
+		auto stype = (ShaderStageType) i;
+		stages[i].set(newShaderStageInternal(stype, "", variant.glsl[i], variant.code.gles, &variant.spirv[i]), Acquire::NORETAIN);
+	}
+
+	Shader *shader = newShaderInternal(stages, &variant.reflection);
+	shader->setVariantSource(sources, options, compute);
+	return shader;
 }
 
-Mesh *Graphics::newMesh(const std::vector<Mesh::BufferAttribute> &attributes, PrimitiveType drawmode)
+const ShaderBundle::Variant *Graphics::getSupportedVariant(const ShaderBundle &bundle) const
 {
-	return new Mesh(attributes, drawmode);
+	const auto &features = capabilities.features;
+
+	if (bundle.language == Shader::LANGUAGE_GLSL3 && !features[FEATURE_GLSL3])
+		return nullptr;
+	if (bundle.language == Shader::LANGUAGE_GLSL4 && !features[FEATURE_GLSL4])
+		return nullptr;
+
+	// The generated code depends on the version of LOVE which created it.
+	if (bundle.loveVersion != LOVE_VERSION_STRING)
+		return nullptr;
+
+	return bundle.getVariant(getShaderCodeVariant(), getRenderer() != RENDERER_OPENGL);
 }
 
-love::graphics::TextBatch *Graphics::newTextBatch(graphics::Font *font, const std::vector<love::font::ColoredString> &text)
+std::string Graphics::getShaderCacheFilename(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute) const
 {
-	return new TextBatch(font, text);
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || fs->getIdentity() == nullptr || fs->getIdentity()[0] == '\0')
+		return std::string();
+
+	Shader::CodeVariant code = getShaderCodeVariant();
+
+	// Everything which affects the generated code is part of the key, so
+	// switching renderers or graphics settings doesn't overwrite other entries.
+	std::string key = LOVE_VERSION_STRING;
+	key += getRenderer() != RENDERER_OPENGL ? "\nspirv" : "\nglsl";
+	key += compute ? "\ncompute\n" : "\ngraphics\n";
+	key += code.gles ? '1' : '0';
+	key += code.glsl3 ? '1' : '0';
+	key += code.gammaCorrect ? '1' : '0';
+	key += code.pixelShaderHighp ? '1' : '0';
+	key += '\n' + Shader::getDefinesKey(options.defines);
+
+	for (const std::string &source : sources)
+	{
+		key += '\0' + std::to_string(source.size()) + '\n';
+		key += source;
+	}
+
+	return getCacheFilename("shadercache", key, ".bin");
 }
 
-love::data::ByteData *Graphics::readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
+bool Graphics::loadCachedShaderVariant(const std::string &filename, const std::vector<std::string> &sources, const Shader::CompileOptions &options, ShaderBundle::Variant &variant) const
 {
-	StrongRef<GraphicsReadback> readback;
-	readback.set(newReadbackInternal(READBACK_IMMEDIATE, buffer, offset, size, dest, destoffset), Acquire::NORETAIN);
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return false;
 
-	auto data = readback->getBufferData();
-	if (data == nullptr)
-		throw love::Exception("love.graphics.readbackBuffer failed.");
+	try
+	{
+		love::filesystem::Filesystem::Info info = {};
+		if (!fs->getInfo(filename.c_str(), info))
+			return false;
 
-	data->retain();
-	return data;
+		StrongRef<love::filesystem::FileData> data(fs->read(filename.c_str()), Acquire::NORETAIN);
+
+		ShaderBundle bundle;
+		bundle.deserialize(data->getData(), data->getSize());
+
+		// Guards against hash collisions.
+		if (bundle.sources != sources || bundle.options.defines != options.defines)
+			return false;
+
+		const ShaderBundle::Variant *cached = getSupportedVariant(bundle);
+		if (cached == nullptr)
+			return false;
+
+		variant = *cached;
+		return true;
+	}
+	catch (love::Exception &)
+	{
+		// Corrupt or outdated files are replaced once the shader is compiled.
+		return false;
+	}
 }
 
-GraphicsReadback *Graphics::readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
+void Graphics::saveCachedShaderVariant(const std::string &filename, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute, const ShaderBundle::Variant &variant) const
 {
-	auto readback = newReadbackInternal(READBACK_ASYNC, buffer, offset, size, dest, destoffset);
-	pendingReadbacks.push_back(readback);
-	return readback;
+	ShaderBundle bundle;
+	bundle.compute = compute;
+	bundle.sources = sources;
+	bundle.options = options;
+	bundle.variants.push_back(variant);
+
+	ShaderBundle::StageSource stages[SHADERSTAGE_MAX_ENUM];
+	bundle.language = ShaderBundle::getStageSources(bundle.sources, options, compute, stages);
+
+	std::string data = bundle.serialize();
+	saveCacheFile("shadercache", filename, data.data(), data.size());
 }
 
-image::ImageData *Graphics::readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+Shader *Graphics::newShaderWithDiskCache(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute)
 {
-	StrongRef<GraphicsReadback> readback;
-	readback.set(newReadbackInternal(READBACK_IMMEDIATE, texture, slice, mipmap, rect, dest, destx, desty), Acquire::NORETAIN);
+	std::string filename = getShaderCacheFilename(sources, options, compute);
+	if (filename.empty())
+		return nullptr;
 
-	auto imagedata = readback->getImageData();
-	if (imagedata == nullptr)
-		throw love::Exception("love.graphics.readbackTexture failed.");
+	ShaderBundle::Variant variant;
+	if (loadCachedShaderVariant(filename, sources, options, variant))
+	{
+		// A variant which doesn't work anymore (e.g. after a driver update) is
+		// compiled from source again below.
+		try
+		{
+			return newShaderFromVariant(variant, sources, options, compute);
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
 
-	imagedata->retain();
-	return imagedata;
+	ShaderBundle::StageSource stages[SHADERSTAGE_MAX_ENUM];
+	ShaderBundle::getStageSources(sources, options, compute, stages);
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (stages[i].source != nullptr)
+			Shader::checkSystemFeatures(this, (ShaderStageType) i, stages[i].info);
+	}
+
+	variant = ShaderBundle::Variant();
+	variant.code = getShaderCodeVariant();
+	ShaderBundle::compileVariant(stages, variant);
+
+	std::string err;
+	if (getRenderer() != RENDERER_OPENGL && !ShaderBundle::compileSPIRV(variant.glsl, variant.code.gles, variant.spirv, err))
+		throw love::Exception("%s", err.c_str());
+
+	Shader *shader = newShaderFromVariant(variant, sources, options, compute);
+	saveCachedShaderVariant(filename, sources, options, compute, variant);
+	return shader;
 }
 
-GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+std::string Graphics::compileShaderBundle(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
 {
-	auto readback = newReadbackInternal(READBACK_ASYNC, texture, slice, mipmap, rect, dest, destx, desty);
-	pendingReadbacks.push_back(readback);
-	return readback;
+	ShaderBundle bundle;
+	bundle.sources = stagessource;
+	bundle.options = options;
+
+	for (const std::string &source : stagessource)
+	{
+		if (Shader::getSourceInfo(source).stages[SHADERSTAGE_COMPUTE] != Shader::ENTRYPOINT_NONE)
+			bundle.compute = true;
+	}
+
+	if (bundle.compute && stagessource.size() != 1)
+		throw love::Exception("Compute shader bundles must be created from a single piece of shader code.");
+
+	ShaderBundle::StageSource stages[SHADERSTAGE_MAX_ENUM];
+	bundle.language = ShaderBundle::getStageSources(bundle.sources, options, bundle.compute, stages);
+
+	std::string firsterr;
+
+	// One variant per combination of the settings in Shader::CodeVariant.
+	for (uint32 bits = 0; bits < 16; bits++)
+	{
+		ShaderBundle::Variant variant;
+		variant.code.gles = (bits & 1) != 0;
+		variant.code.glsl3 = (bits & 2) != 0;
+		variant.code.gammaCorrect = (bits & 4) != 0;
+		variant.code.pixelShaderHighp = (bits & 8) != 0;
+
+		// Only systems without GLSL 3 support use the other variants, and they
+		// can only load GLSL 1 shaders.
+		if (!variant.code.glsl3 && bundle.language != Shader::LANGUAGE_GLSL1)
+			continue;
+
+		try
+		{
+			ShaderBundle::compileVariant(stages, variant);
+		}
+		catch (love::Exception &e)
+		{
+			if (firsterr.empty())
+				firsterr = e.what();
+			continue;
+		}
+
+		// SPIR-V is only used by the Vulkan and Metal backends, which always
+		// support GLSL 3. Variants which fail to compile to it are still usable
+		// with OpenGL.
+		std::string spirverr;
+		if (!variant.code.glsl3 || !ShaderBundle::compileSPIRV(variant.glsl, variant.code.gles, variant.spirv, spirverr))
+		{
+			for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+				variant.spirv[i].clear();
+		}
+
+		bundle.variants.push_back(variant);
+	}
+
+	if (bundle.variants.empty())
+		throw love::Exception("%s", firsterr.c_str());
+
+	return bundle.serialize();
 }
 
-void Graphics::cleanupCachedShaderStage(ShaderStageType type, const std::string &hashkey)
+PendingShader *Graphics::newShaderAsync(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
 {
-	cachedShaderStages[type].erase(hashkey);
+	// Bundles don't have much left to compile.
+	if (stagessource.size() == 1 && ShaderBundle::isBundle(stagessource[0]))
+	{
+		StrongRef<Shader> shader(newShaderFromBundle(stagessource[0], false), Acquire::NORETAIN);
+		return new PendingShader(shader);
+	}
+
+	PendingShader *shader = new PendingShader(this, stagessource, options, false);
+	if (shader->needsCompile())
+		queuedShaderCompiles.push_back(shader);
+	pendingShaders.push_back(shader);
+	startShaderCompiles();
+	return shader;
 }
 
-bool Graphics::validateShader(bool gles, const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, std::string &err)
+PendingShader *Graphics::newComputeShaderAsync(const std::string &source, const Shader::CompileOptions &options)
 {
-	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
+	if (ShaderBundle::isBundle(source))
+	{
+		StrongRef<Shader> shader(newShaderFromBundle(source, true), Acquire::NORETAIN);
+		return new PendingShader(shader);
+	}
 
-	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
-	validstages[SHADERSTAGE_VERTEX] = true;
-	validstages[SHADERSTAGE_PIXEL] = true;
-	validstages[SHADERSTAGE_COMPUTE] = true;
+	PendingShader *shader = new PendingShader(this, {source}, options, true);
+	if (shader->needsCompile())
+		queuedShaderCompiles.push_back(shader);
+	pendingShaders.push_back(shader);
+	startShaderCompiles();
+	return shader;
+}
 
-	// Don't use cached shader stages, since the gles flag may not match the
-	// current renderer.
-	for (const std::string &source : stagessource)
+void Graphics::startShaderCompiles()
+{
+	for (size_t i = 0; i < shaderCompileJobs.size(); )
 	{
-		Shader::SourceInfo info = Shader::getSourceInfo(source);
-		bool isanystage = false;
-
-		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		if (shaderCompileJobs[i]->isRunning())
 		{
-			auto stype = (ShaderStageType) i;
+			i++;
+			continue;
+		}
 
-			if (!validstages[i])
-				continue;
+		shaderCompileJobs[i]->wait();
+		shaderCompileJobs.erase(shaderCompileJobs.begin() + i);
+	}
 
-			if (info.stages[i] != Shader::ENTRYPOINT_NONE)
+	if (queuedShaderCompiles.empty())
+		return;
+
+	int maxthreads = std::max(1, std::min((int) std::thread::hardware_concurrency() - 1, 4));
+	int threadcount = std::min(maxthreads - (int) shaderCompileJobs.size(), (int) queuedShaderCompiles.size());
+
+	// Anything left over is started once a running job finishes.
+	if (threadcount <= 0)
+		return;
+
+	for (int i = 0; i < threadcount; i++)
+	{
+		StrongRef<ShaderCompileJob> job(new ShaderCompileJob(), Acquire::NORETAIN);
+
+		for (size_t j = i; j < queuedShaderCompiles.size(); j += threadcount)
+			job->shaders.push_back(queuedShaderCompiles[j]);
+
+		shaderCompileJobs.push_back(job);
+		job->start();
+	}
+
+	queuedShaderCompiles.clear();
+}
+
+void Graphics::waitForShaderCompile(PendingShader *shader)
+{
+	for (size_t i = 0; i < queuedShaderCompiles.size(); i++)
+	{
+		if (queuedShaderCompiles[i].get() == shader)
+		{
+			// Not picked up by a job yet, there's no point in waiting for one.
+			StrongRef<PendingShader> ref(shader);
+			queuedShaderCompiles.erase(queuedShaderCompiles.begin() + i);
+			shader->compile();
+			return;
+		}
+	}
+
+	for (const auto &job : shaderCompileJobs)
+	{
+		for (const auto &s : job->shaders)
+		{
+			if (s.get() == shader)
 			{
-				isanystage = true;
-				std::string glsl = Shader::createShaderStageCode(this, stype, source, options, info, gles, false);
-				stages[i].set(new ShaderStageForValidation(this, stype, glsl, gles), Acquire::NORETAIN);
+				job->wait();
+				return;
 			}
 		}
+	}
+}
 
-		if (!isanystage)
+void Graphics::updatePendingShaders()
+{
+	startShaderCompiles();
+
+	for (size_t i = 0; i < pendingShaders.size(); )
+	{
+		PendingShader *shader = pendingShaders[i];
+
+		if (!shader->isReady())
 		{
-			err = "Could not parse shader code (missing 'position' or 'effect' function?)";
-			return false;
+			i++;
+			continue;
 		}
-	}
 
-	return Shader::validate(stages, err);
+		pendingShaders.erase(pendingShaders.begin() + i);
+	}
 }
 
-int Graphics::getWidth() const
+Shader::CodeVariant Graphics::getShaderCodeVariant() const
 {
-	return width;
+	Shader::CodeVariant variant = {};
+	variant.gles = usesGLSLES();
+	variant.glsl3 = capabilities.features[FEATURE_GLSL3];
+	variant.gammaCorrect = isGammaCorrect();
+	variant.pixelShaderHighp = capabilities.features[FEATURE_PIXEL_SHADER_HIGHP];
+	return variant;
 }
 
-int Graphics::getHeight() const
+Buffer *Graphics::newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength)
 {
-	return height;
+	std::vector<Buffer::DataDeclaration> dataformat = {{"", format, 0}};
+	return newBuffer(settings, dataformat, data, size, arraylength);
 }
 
-int Graphics::getPixelWidth() const
+Mesh *Graphics::newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, int vertexcount, PrimitiveType drawmode, BufferDataUsage usage)
 {
-	return pixelWidth;
+	return new Mesh(this, vertexformat, vertexcount, drawmode, usage);
 }
 
-int Graphics::getPixelHeight() const
+Mesh *Graphics::newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage)
 {
-	return pixelHeight;
+	return new Mesh(this, vertexformat, data, datasize, drawmode, usage);
 }
 
-double Graphics::getCurrentDPIScale() const
+Mesh *Graphics::newMesh(const std::vector<Mesh::BufferAttribute> &attributes, PrimitiveType drawmode)
 {
-	const auto &rt = states.back().renderTargets.getFirstTarget();
-	if (rt.texture.get())
-		return rt.texture->getDPIScale();
-
-	return getScreenDPIScale();
+	return new Mesh(attributes, drawmode);
 }
 
-double Graphics::getScreenDPIScale() const
+Mesh *Graphics::newMesh(BufferArena *arena, const void *data, size_t vertexcount, PrimitiveType drawmode)
 {
-	return (double) getPixelHeight() / (double) getHeight();
+	return new Mesh(arena, data, vertexcount, drawmode);
 }
 
-bool Graphics::isCreated() const
+BufferArena *Graphics::newBufferArena(const std::vector<Buffer::DataDeclaration> &vertexformat, size_t pagelength, BufferDataUsage usage)
 {
-	return created;
+	return new BufferArena(this, vertexformat, pagelength, usage);
 }
 
-bool Graphics::isActive() const
+love::graphics::TextBatch *Graphics::newTextBatch(graphics::Font *font, const std::vector<love::font::ColoredString> &text)
 {
-	// The graphics module is only completely 'active' if there's a window, a
-	// context, and the active variable is set.
-	auto window = getInstance<love::window::Window>(M_WINDOW);
-	return active && isCreated() && window != nullptr && window->isOpen();
+	return new TextBatch(font, text);
 }
 
-void Graphics::reset()
+DrawList *Graphics::newDrawList()
 {
-	DisplayState s;
-	restoreState(s);
-	origin();
+	return new DrawList(this);
 }
 
-/**
- * State functions.
- **/
-
-void Graphics::restoreState(const DisplayState &s)
+Texture *Graphics::newTextureAsync(const Texture::Settings &settings, const Texture::Slices *slices)
 {
-	setColor(s.color);
-	setBackgroundColor(s.backgroundColor);
+	if (slices == nullptr || slices->getMipmapCount() == 0 || slices->getSliceCount() == 0)
+		return newTexture(settings, slices);
 
-	setBlendState(s.blend);
+	slices->validate();
 
-	setLineWidth(s.lineWidth);
-	setLineStyle(s.lineStyle);
-	setLineJoin(s.lineJoin);
+	image::ImageDataBase *base = slices->get(0, 0);
 
-	setPointSize(s.pointSize);
+	// Compressed textures can't be created without initial data.
+	if (isPixelFormatCompressed(base->getFormat()) || settings.msaa > 1)
+		return newTexture(settings, slices);
 
-	if (s.scissor)
-		setScissor(s.scissorRect);
-	else
-		setScissor();
+	// Mirror what the Texture constructor does when it's given data.
+	Texture::Settings s = settings;
+	s.type = slices->getTextureType();
+	s.format = base->getFormat();
+	if (isGammaCorrect() && !settings.linear)
+		s.format = getSRGBPixelFormat(s.format);
+
+	s.width = (int) (base->getWidth() / settings.dpiScale + 0.5);
+	s.height = (int) (base->getHeight() / settings.dpiScale + 0.5);
+
+	if (s.type == TEXTURE_2D_ARRAY || s.type == TEXTURE_VOLUME)
+		s.layers = slices->getSliceCount();
+
+	// The pixel dimensions of an empty texture are computed from its DPI-scaled
+	// dimensions, which doesn't always round-trip.
+	if ((int) (s.width * settings.dpiScale + 0.5) != base->getWidth()
+		|| (int) (s.height * settings.dpiScale + 0.5) != base->getHeight())
+	{
+		return newTexture(settings, slices);
+	}
+
+	StrongRef<Texture> texture(newTexture(s, nullptr), Acquire::NORETAIN);
+
+	bool hasmipmapdata = slices->getMipmapCount() > 1;
+
+	// Streaming needs the CPU-side data of every mipmap.
+	if (settings.streaming && hasmipmapdata && s.type != TEXTURE_VOLUME && texture->getMipmapCount() > 1)
+	{
+		StreamingTexture st;
+		st.texture = texture;
+		st.mipmaps.resize(texture->getMipmapCount());
+		st.baseMinLod = texture->getSamplerState().minLod;
+
+		for (int mip = 0; mip < texture->getMipmapCount(); mip++)
+		{
+			for (int slice = 0; slice < slices->getSliceCount(mip); slice++)
+				st.mipmaps[mip].push_back(slices->get(slice, mip));
+		}
+
+		// Nothing is resident until the first upload is done.
+		setStreamingResidency(st, texture->getMipmapCount());
+
+		int firstmip = texture->getMipmapCount() - 1;
+		while (firstmip > 0 && std::max(texture->getPixelWidth(firstmip - 1), texture->getPixelHeight(firstmip - 1)) <= STREAMING_TEXTURE_INITIAL_SIZE)
+			firstmip--;
+
+		queueStreamingMipmaps(st, firstmip, texture->getMipmapCount() - 1);
+
+		texture->setStreaming(true);
+		texture->markUsed(textureStreamingFrame);
+		texture->setUploadPending(true);
+
+		streamingTextures.push_back(st);
+
+		texture->retain();
+		return texture;
+	}
+
+	PendingTextureUpload upload;
+	upload.texture = texture;
+	upload.generateMipmaps = !hasmipmapdata && texture->getMipmapCount() > 1;
+
+	for (int mip = 0; mip < (hasmipmapdata ? texture->getMipmapCount() : 1); mip++)
+	{
+		for (int slice = 0; slice < slices->getSliceCount(mip); slice++)
+		{
+			image::ImageDataBase *d = slices->get(slice, mip);
+			if (d != nullptr)
+				upload.parts.push_back({d, slice, mip});
+		}
+	}
+
+	texture->setUploadPending(true);
+	pendingTextureUploads.push_back(upload);
+
+	texture->retain();
+	return texture;
+}
+
+void Graphics::setTextureStreamingBudget(int64 bytes)
+{
+	textureStreamingBudget = bytes;
+}
+
+void Graphics::addToSharedArrayTexture(Texture *texture, const Texture::Slices *slices)
+{
+	if (texture->getSharedArrayTexture() != nullptr || texture->isStreaming() || !capabilities.textureTypes[TEXTURE_2D_ARRAY])
+		return;
+
+	if (texture->getTextureType() != TEXTURE_2D || texture->isRenderTarget()
+		|| texture->isComputeWritable() || !texture->isReadable() || texture->isCompressed())
+		return;
+
+	PixelFormat format = texture->getPixelFormat();
+	int w = texture->getPixelWidth();
+	int h = texture->getPixelHeight();
+	int mipcount = texture->getMipmapCount();
+	auto mipmapsmode = texture->getMipmapsMode();
+
+	// Auto-generated mipmaps are regenerated in the array instead of copied.
+	int copymips = mipmapsmode == Texture::MIPMAPS_AUTO ? 1 : mipcount;
+
+	if (slices != nullptr)
+	{
+		for (int mip = 0; mip < std::min(copymips, slices->getMipmapCount()); mip++)
+		{
+			const image::ImageDataBase *d = slices->get(0, mip);
+			if (d != nullptr && d->getFormat() != format)
+				return;
+		}
+	}
+
+	size_t layersize = 0;
+	for (int mip = 0; mip < mipcount; mip++)
+		layersize += getPixelFormatSliceSize(format, texture->getPixelWidth(mip), texture->getPixelHeight(mip));
+
+	// Keep each array within a reasonable amount of memory, since we don't know
+	// how many layers will end up being used.
+	const size_t arraymemory = 32 * 1024 * 1024;
+	int maxlayers = std::min(64, (int) capabilities.limits[LIMIT_TEXTURE_LAYERS]);
+	int layercount = std::min((int) (arraymemory / std::max(layersize, (size_t) 1)), maxlayers);
+
+	if (layercount < 2)
+		return;
+
+	SharedArrayTexture *shared = nullptr;
+
+	for (SharedArrayTexture &s : sharedArrayTextures)
+	{
+		Texture *a = s.texture;
+
+		if (a->getPixelFormat() == format && a->getPixelWidth() == w && a->getPixelHeight() == h
+			&& a->getMipmapsMode() == mipmapsmode && a->getMipmapCount() == mipcount
+			&& a->isFormatLinear() == texture->isFormatLinear()
+			&& s.usedCount < a->getLayerCount())
+		{
+			shared = &s;
+			break;
+		}
+	}
+
+	if (shared == nullptr)
+	{
+		Texture::Settings settings;
+		settings.type = TEXTURE_2D_ARRAY;
+		settings.width = w;
+		settings.height = h;
+		settings.layers = layercount;
+		settings.format = format;
+		settings.linear = texture->isFormatLinear();
+		settings.mipmaps = mipmapsmode;
+
+		StrongRef<Texture> array;
+
+		try
+		{
+			array.set(newTexture(settings), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			// Sharing is only an optimization, the texture still works on its
+			// own (e.g. when the array doesn't fit in memory).
+			return;
+		}
+
+		if (array->getMipmapCount() != mipcount)
+			return;
+
+		SharedArrayTexture s;
+		s.texture = array;
+		s.usedLayers.resize(layercount, false);
+		s.usedCount = 0;
+		sharedArrayTextures.push_back(s);
+
+		shared = &sharedArrayTextures.back();
+
+		// The texture we're adding takes ownership of the array.
+		texture->setSharedArrayLayer(array, 0);
+	}
+
+	int layer = 0;
+	while (shared->usedLayers[layer])
+		layer++;
+
+	Texture *array = shared->texture;
+
+	if (slices != nullptr)
+	{
+		try
+		{
+			for (int mip = 0; mip < std::min(copymips, slices->getMipmapCount()); mip++)
+			{
+				image::ImageDataBase *d = slices->get(0, mip);
+				if (d != nullptr)
+					array->replacePixels(d, layer, mip, 0, 0, false);
+			}
+
+			if (mipmapsmode == Texture::MIPMAPS_AUTO && mipcount > 1)
+				array->generateMipmaps();
+		}
+		catch (love::Exception &)
+		{
+			// Fall back to the standalone texture, and don't keep an array
+			// around which nothing uses.
+			if (shared->usedCount == 0)
+				sharedArrayTextures.erase(sharedArrayTextures.begin() + (shared - sharedArrayTextures.data()));
+
+			texture->setSharedArrayLayer(nullptr, -1);
+			return;
+		}
+	}
+
+	shared->usedLayers[layer] = true;
+	shared->usedCount++;
+
+	texture->setSharedArrayLayer(array, layer);
+}
+
+void Graphics::removeFromSharedArrayTexture(Texture *array, int layer)
+{
+	for (size_t i = 0; i < sharedArrayTextures.size(); i++)
+	{
+		SharedArrayTexture &s = sharedArrayTextures[i];
+		if (s.texture != array)
+			continue;
+
+		if (layer >= 0 && layer < (int) s.usedLayers.size() && s.usedLayers[layer])
+		{
+			s.usedLayers[layer] = false;
+			s.usedCount--;
+		}
+
+		if (s.usedCount <= 0)
+			sharedArrayTextures.erase(sharedArrayTextures.begin() + i);
+
+		return;
+	}
+}
+
+love::data::ByteData *Graphics::readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
+{
+	StrongRef<GraphicsReadback> readback;
+	readback.set(newReadbackInternal(READBACK_IMMEDIATE, buffer, offset, size, dest, destoffset), Acquire::NORETAIN);
+
+	auto data = readback->getBufferData();
+	if (data == nullptr)
+		throw love::Exception("love.graphics.readbackBuffer failed.");
+
+	data->retain();
+	return data;
+}
+
+GraphicsReadback *Graphics::readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
+{
+	auto readback = newReadbackInternal(READBACK_ASYNC, buffer, offset, size, dest, destoffset);
+	pendingReadbacks.push_back(readback);
+	return readback;
+}
+
+image::ImageData *Graphics::readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+{
+	StrongRef<GraphicsReadback> readback;
+	readback.set(newReadbackInternal(READBACK_IMMEDIATE, texture, slice, mipmap, rect, dest, destx, desty), Acquire::NORETAIN);
+
+	auto imagedata = readback->getImageData();
+	if (imagedata == nullptr)
+		throw love::Exception("love.graphics.readbackTexture failed.");
+
+	imagedata->retain();
+	return imagedata;
+}
+
+GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty)
+{
+	auto readback = newReadbackInternal(READBACK_ASYNC, texture, slice, mipmap, rect, dest, destx, desty);
+	pendingReadbacks.push_back(readback);
+	return readback;
+}
+
+ReadbackRing *Graphics::newReadbackRing(int slotcount)
+{
+	return new ReadbackRing(this, slotcount);
+}
+
+VirtualTexture *Graphics::newVirtualTexture(const VirtualTexture::Settings &settings)
+{
+	const char *fstr = "unknown";
+	love::getConstant(settings.format, fstr);
+
+	if (isPixelFormatCompressed(settings.format) || isPixelFormatDepthStencil(settings.format))
+		throw love::Exception("The %s pixel format can't be used for a VirtualTexture.", fstr);
+
+	if (settings.cachePages > capabilities.limits[LIMIT_TEXTURE_LAYERS])
+		throw love::Exception("VirtualTexture cache page count must be at most %d on this system.", (int) capabilities.limits[LIMIT_TEXTURE_LAYERS]);
+
+	return new VirtualTexture(this, settings);
+}
+
+void Graphics::cleanupCachedShaderStage(ShaderStageType type, const std::string &hashkey)
+{
+	cachedShaderStages[type].erase(hashkey);
+}
+
+bool Graphics::validateShader(bool gles, const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, std::string &err)
+{
+	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
+
+	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
+	validstages[SHADERSTAGE_VERTEX] = true;
+	validstages[SHADERSTAGE_PIXEL] = true;
+	validstages[SHADERSTAGE_COMPUTE] = true;
+
+	// Don't use cached shader stages, since the gles flag may not match the
+	// current renderer.
+	for (const std::string &source : stagessource)
+	{
+		Shader::SourceInfo info = Shader::getSourceInfo(source);
+		bool isanystage = false;
+
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			auto stype = (ShaderStageType) i;
+
+			if (!validstages[i])
+				continue;
+
+			if (info.stages[i] != Shader::ENTRYPOINT_NONE)
+			{
+				isanystage = true;
+				// Without the system feature check the code is always generated
+				// for GLSL 3.
+				std::string glsl = Shader::createShaderStageCode(this, stype, source, options, info, gles, false);
+				stages[i].set(new ShaderStageForValidation(stype, glsl, gles, true), Acquire::NORETAIN);
+			}
+		}
+
+		if (!isanystage)
+		{
+			err = "Could not parse shader code (missing 'position' or 'effect' function?)";
+			return false;
+		}
+	}
+
+	return Shader::validate(stages, err);
+}
+
+int Graphics::getWidth() const
+{
+	return width;
+}
+
+int Graphics::getHeight() const
+{
+	return height;
+}
+
+int Graphics::getPixelWidth() const
+{
+	return pixelWidth;
+}
+
+int Graphics::getPixelHeight() const
+{
+	return pixelHeight;
+}
+
+double Graphics::getCurrentDPIScale() const
+{
+	const auto &rt = states.back().renderTargets.getFirstTarget();
+	if (rt.texture.get())
+		return rt.texture->getDPIScale();
+
+	return getScreenDPIScale();
+}
+
+double Graphics::getScreenDPIScale() const
+{
+	return (double) getPixelHeight() / (double) getHeight();
+}
+
+bool Graphics::isCreated() const
+{
+	return created;
+}
+
+void Graphics::setFrameLatency(int framesinflight, bool lowlatency)
+{
+	framesInFlight = std::max(1, std::min(framesinflight, MAX_FRAMES_IN_FLIGHT));
+	lowLatency = lowlatency;
+}
+
+bool Graphics::isActive() const
+{
+	// The graphics module is only completely 'active' if there's a window, a
+	// context, and the active variable is set.
+	auto window = getInstance<love::window::Window>(M_WINDOW);
+	return active && isCreated() && window != nullptr && window->isOpen();
+}
+
+void Graphics::reset()
+{
+	DisplayState s;
+	restoreState(s);
+	origin();
+}
+
+/**
+ * State functions.
+ **/
+
+void Graphics::restoreState(const DisplayState &s)
+{
+	setColor(s.color);
+	setBackgroundColor(s.backgroundColor);
+
+	setBlendState(s.blend);
+
+	setLineWidth(s.lineWidth);
+	setLineStyle(s.lineStyle);
+	setLineJoin(s.lineJoin);
+
+	setPointSize(s.pointSize);
+
+	if (s.scissor)
+		setScissor(s.scissorRect);
+	else
+		setScissor();
 
 	setMeshCullMode(s.meshCullMode);
 	setFrontFaceWinding(s.winding);
+	setDrawCulling(s.drawCulling);
 
 	setFont(s.font.get());
 	setShader(s.shader.get());
@@ -660,6 +1425,8 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 	if (s.winding != cur.winding)
 		setFrontFaceWinding(s.winding);
 
+	setDrawCulling(s.drawCulling);
+
 	setFont(s.font.get());
 	setShader(s.shader.get());
 
@@ -681,7 +1448,7 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 		if (!rtschanged && sRTs.depthStencil != curRTs.depthStencil)
 			rtschanged = true;
 
-		if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags)
+		if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags || sRTs.passFlags != curRTs.passFlags)
 			rtschanged = true;
 	}
 
@@ -792,6 +1559,7 @@ void Graphics::setRenderTargets(const RenderTargetsStrongRef &rts)
 
 	targets.depthStencil = RenderTarget(rts.depthStencil.texture, rts.depthStencil.slice, rts.depthStencil.mipmap);
 	targets.temporaryRTFlags = rts.temporaryRTFlags;
+	targets.passFlags = rts.passFlags;
 
 	return setRenderTargets(targets);
 }
@@ -825,7 +1593,7 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 		if (!modified && rts.depthStencil != prevRTs.depthStencil)
 			modified = true;
 
-		if (rts.temporaryRTFlags != prevRTs.temporaryRTFlags)
+		if (rts.temporaryRTFlags != prevRTs.temporaryRTFlags || rts.passFlags != prevRTs.passFlags)
 			modified = true;
 
 		if (!modified)
@@ -936,7 +1704,12 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 		// but we don't want to directly store it in the main graphics state.
 		RenderTargets realRTs = rts;
 
-		realRTs.depthStencil.texture = getTemporaryTexture(dsformat, pixelw, pixelh, reqmsaa);
+		// The internal depth/stencil buffer is discarded at the end of each
+		// pass, so it doesn't need backing memory on tile-based GPUs. Metal
+		// and Vulkan can split a pass partway through (e.g. for texture or
+		// buffer uploads), which would lose memoryless contents mid-frame.
+		bool memoryless = getRenderer() == RENDERER_OPENGL;
+		realRTs.depthStencil.texture = getTemporaryTexture(dsformat, pixelw, pixelh, reqmsaa, memoryless);
 		realRTs.depthStencil.slice = 0;
 
 		// TODO: fix this to call release at the right time.
@@ -956,6 +1729,9 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 	refs.depthStencil = RenderTargetStrongRef(rts.depthStencil.texture, rts.depthStencil.slice);
 	refs.temporaryRTFlags = rts.temporaryRTFlags;
+	// Discarding only applies to the pass begun here, so it isn't stored in
+	// the state where pop/restoreState would apply it again.
+	refs.passFlags = rts.passFlags & ~RENDER_PASS_DISCARD_ON_BEGIN;
 
 	std::swap(state.renderTargets, refs);
 
@@ -963,6 +1739,13 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 	resetProjection();
 
+	// Skip loading the previous contents when they'll be overwritten anyway.
+	if ((rts.passFlags & RENDER_PASS_DISCARD_ON_BEGIN) != 0)
+	{
+		bool hasdepthstencil = rts.depthStencil.texture != nullptr || rts.temporaryRTFlags != 0;
+		discard(std::vector<bool>(rts.colors.size(), true), hasdepthstencil);
+	}
+
 	// Clear/reset the temporary depth/stencil buffers.
 	// TODO: make this deferred somehow to avoid double clearing if the user
 	// also calls love.graphics.clear after setCanvas.
@@ -1003,6 +1786,7 @@ Graphics::RenderTargets Graphics::getRenderTargets() const
 
 	rts.depthStencil = RenderTarget(curRTs.depthStencil.texture, curRTs.depthStencil.slice, curRTs.depthStencil.mipmap);
 	rts.temporaryRTFlags = curRTs.temporaryRTFlags;
+	rts.passFlags = curRTs.passFlags;
 
 	return rts;
 }
@@ -1045,7 +1829,7 @@ bool Graphics::isRenderTargetActive(Texture *texture, int slice) const
 	return false;
 }
 
-Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int samples)
+Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int samples, bool memoryless)
 {
 	Texture *texture = nullptr;
 
@@ -1056,7 +1840,8 @@ Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int sam
 
 		Texture *c = temp.texture;
 		if (c->getPixelFormat() == format && c->getPixelWidth() == w
-			&& c->getPixelHeight() == h && c->getRequestedMSAA() == samples)
+			&& c->getPixelHeight() == h && c->getRequestedMSAA() == samples
+			&& c->isMemoryless() == memoryless)
 		{
 			texture = c;
 			temp.framesSinceUse = -1;
@@ -1072,6 +1857,7 @@ Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int sam
 		settings.width = w;
 		settings.height = h;
 		settings.msaa = samples;
+		settings.memoryless = memoryless;
 
 		texture = newTexture(settings);
 
@@ -1093,6 +1879,48 @@ void Graphics::releaseTemporaryTexture(Texture *texture)
 	}
 }
 
+Texture *Graphics::getTransientTexture(PixelFormat format, int w, int h, int samples)
+{
+	if (w <= 0 || h <= 0)
+		throw love::Exception("Transient render target dimensions must be greater than 0.");
+
+	if (isPixelFormatCompressed(format))
+		throw love::Exception("Compressed pixel formats can't be used for render targets.");
+
+	format = getSizedFormat(format, true, !isPixelFormatDepthStencil(format));
+
+	Texture *texture = getTemporaryTexture(format, w, h, samples, false);
+	transientTextures.push_back(texture);
+
+	return texture;
+}
+
+void Graphics::releaseTransientTexture(Texture *texture)
+{
+	auto it = std::find(transientTextures.begin(), transientTextures.end(), texture);
+	if (it == transientTextures.end())
+		throw love::Exception("Texture is not an active transient render target.");
+
+	// States saved by push are restored by pop, so they can't use it either.
+	for (const DisplayState &state : states)
+	{
+		for (const auto &rt : state.renderTargets.colors)
+		{
+			if (rt.texture.get() == texture)
+				throw love::Exception("Cannot release a transient render target while it's active or in a pushed graphics state.");
+		}
+
+		if (state.renderTargets.depthStencil.texture.get() == texture)
+			throw love::Exception("Cannot release a transient render target while it's active or in a pushed graphics state.");
+	}
+
+	// Anything drawn with it before has to be submitted before it's reused.
+	flushBatchedDraws();
+
+	transientTextures.erase(it);
+	releaseTemporaryTexture(texture);
+}
+
 Buffer *Graphics::getTemporaryBuffer(size_t size, DataFormat format, uint32 usageflags, BufferDataUsage datausage)
 {
 	Buffer *buffer = nullptr;
@@ -1138,6 +1966,11 @@ void Graphics::releaseTemporaryBuffer(Buffer *buffer)
 
 void Graphics::updateTemporaryResources()
 {
+	// Transient render targets only last until the end of the frame.
+	for (Texture *texture : transientTextures)
+		releaseTemporaryTexture(texture);
+	transientTextures.clear();
+
 	for (int i = (int) temporaryTextures.size() - 1; i >= 0; i--)
 	{
 		auto &t = temporaryTextures[i];
@@ -1163,6 +1996,22 @@ void Graphics::updateTemporaryResources()
 		else if (t.framesSinceUse >= 0)
 			t.framesSinceUse++;
 	}
+
+	// Pooled screenshots are in use as long as anything else references them.
+	for (int i = (int) screenshotPool.size() - 1; i >= 0; i--)
+	{
+		auto &s = screenshotPool[i];
+		if (s.data->getReferenceCount() > 1)
+			s.framesSinceUse = 0;
+		else if (s.framesSinceUse >= MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES)
+		{
+			s.data->release();
+			s = screenshotPool.back();
+			screenshotPool.pop_back();
+		}
+		else
+			s.framesSinceUse++;
+	}
 }
 
 void Graphics::clearTemporaryResources()
@@ -1173,8 +2022,13 @@ void Graphics::clearTemporaryResources()
 	for (auto temp : temporaryTextures)
 		temp.texture->release();
 
+	for (auto s : screenshotPool)
+		s.data->release();
+	screenshotPool.clear();
+
 	temporaryBuffers.clear();
 	temporaryTextures.clear();
+	transientTextures.clear();
 }
 
 void Graphics::updatePendingReadbacks()
@@ -1190,6 +2044,272 @@ void Graphics::updatePendingReadbacks()
 	}
 }
 
+void Graphics::updateTextureUploads()
+{
+	updateTextureStreaming();
+
+	size_t budget = TEXTURE_UPLOAD_BYTES_PER_FRAME;
+
+	while (!pendingTextureUploads.empty() && budget > 0)
+	{
+		PendingTextureUpload &upload = pendingTextureUploads.front();
+
+		// Nothing else references the texture, so nobody will ever see it.
+		bool abandoned = upload.texture->getReferenceCount() == 1;
+
+		if (!abandoned && upload.currentPart < upload.parts.size())
+		{
+			size_t size = uploadTexturePart(upload, budget);
+			budget -= std::min(size, budget);
+			continue;
+		}
+
+		if (!abandoned)
+		{
+			if (upload.generateMipmaps)
+				upload.texture->generateMipmaps();
+
+			upload.texture->setUploadPending(false);
+		}
+
+		if (upload.streamedMipmap >= 0)
+		{
+			for (StreamingTexture &st : streamingTextures)
+			{
+				if (st.texture.get() == upload.texture.get())
+				{
+					setStreamingResidency(st, upload.streamedMipmap);
+					st.uploadingMipmap = -1;
+					break;
+				}
+			}
+		}
+
+		pendingTextureUploads.erase(pendingTextureUploads.begin());
+	}
+}
+
+void Graphics::updateTextureStreaming()
+{
+	textureStreamingFrame++;
+
+	streamedTextureData = 0;
+
+	for (size_t i = 0; i < streamingTextures.size(); )
+	{
+		StreamingTexture &st = streamingTextures[i];
+
+		// The pending upload holds a reference too, if there is one.
+		int refs = st.uploadingMipmap >= 0 ? 2 : 1;
+		if (st.texture->getReferenceCount() <= refs)
+		{
+			streamingTextures.erase(streamingTextures.begin() + i);
+			continue;
+		}
+
+		// Mipmaps which are being uploaded count as resident, so the budget
+		// is respected once they're done.
+		int firstmip = st.uploadingMipmap >= 0 ? st.uploadingMipmap : st.residentMipmap;
+		for (int mip = firstmip; mip < (int) st.mipmaps.size(); mip++)
+			streamedTextureData += getStreamingMipmapSize(st, mip);
+
+		i++;
+	}
+
+	uint64 visibleframe = textureStreamingFrame - std::min<uint64>(textureStreamingFrame, STREAMING_TEXTURE_VISIBLE_FRAMES);
+
+	// Evicts the top resident mipmap of the least recently drawn texture which
+	// isn't visible, until the given amount of memory fits in the budget.
+	auto makeroom = [&](int64 size) -> bool
+	{
+		if (textureStreamingBudget < 0)
+			return true;
+
+		while (streamedTextureData + size > textureStreamingBudget)
+		{
+			StreamingTexture *lru = nullptr;
+
+			for (StreamingTexture &st : streamingTextures)
+			{
+				if (st.uploadingMipmap >= 0 || st.residentMipmap >= (int) st.mipmaps.size() - 1)
+					continue;
+
+				uint64 lastused = st.texture->getLastUsedFrame();
+				if (lastused > visibleframe)
+					continue;
+
+				if (lru == nullptr || lastused < lru->texture->getLastUsedFrame())
+					lru = &st;
+			}
+
+			if (lru == nullptr)
+				return false;
+
+			streamedTextureData -= getStreamingMipmapSize(*lru, lru->residentMipmap);
+			setStreamingResidency(*lru, lru->residentMipmap + 1);
+		}
+
+		return true;
+	};
+
+	// The budget may have been lowered since the last frame.
+	makeroom(0);
+
+	// Textures which have been drawn recently stream in their next mipmap,
+	// one level at a time so the smaller levels are always available first.
+	for (StreamingTexture &st : streamingTextures)
+	{
+		if (st.uploadingMipmap >= 0 || st.residentMipmap <= 0 || st.residentMipmap >= (int) st.mipmaps.size())
+			continue;
+
+		if (st.texture->getLastUsedFrame() <= visibleframe)
+			continue;
+
+		int mip = st.residentMipmap - 1;
+		int64 size = getStreamingMipmapSize(st, mip);
+
+		if (!makeroom(size))
+			continue;
+
+		queueStreamingMipmaps(st, mip, mip);
+		streamedTextureData += size;
+	}
+}
+
+int64 Graphics::getStreamingMipmapSize(const StreamingTexture &st, int mipmap) const
+{
+	int64 size = 0;
+	for (const auto &data : st.mipmaps[mipmap])
+	{
+		if (data.get() != nullptr)
+			size += (int64) data->getSize();
+	}
+	return size;
+}
+
+void Graphics::setStreamingResidency(StreamingTexture &st, int mipmap)
+{
+	st.residentMipmap = mipmap;
+
+	SamplerState sampler = st.texture->getSamplerState();
+	int residentlod = std::min(mipmap, (int) st.mipmaps.size() - 1);
+	sampler.minLod = (uint8) std::max(st.baseMinLod, residentlod);
+	st.texture->setSamplerState(sampler);
+}
+
+void Graphics::queueStreamingMipmaps(StreamingTexture &st, int firstmipmap, int lastmipmap)
+{
+	PendingTextureUpload upload;
+	upload.texture = st.texture;
+	upload.streamedMipmap = firstmipmap;
+
+	// Smallest mipmaps first.
+	for (int mip = lastmipmap; mip >= firstmipmap; mip--)
+	{
+		for (int slice = 0; slice < (int) st.mipmaps[mip].size(); slice++)
+		{
+			image::ImageDataBase *d = st.mipmaps[mip][slice];
+			if (d != nullptr)
+				upload.parts.push_back({d, slice, mip});
+		}
+	}
+
+	st.uploadingMipmap = firstmipmap;
+	pendingTextureUploads.push_back(upload);
+}
+
+size_t Graphics::uploadTexturePart(PendingTextureUpload &upload, size_t maxsize)
+{
+	const PendingTextureUpload::Part &part = upload.parts[upload.currentPart];
+	image::ImageDataBase *d = part.data;
+	Texture *texture = upload.texture;
+
+	int w = d->getWidth();
+	int h = d->getHeight();
+
+	// Large images are split into groups of rows, so a single big texture
+	// doesn't use up more than its share of a frame.
+	size_t rowsize = getPixelFormatUncompressedRowSize(d->getFormat(), w);
+	int rows = (int) std::min(std::max(maxsize / rowsize, (size_t) 1), (size_t) (h - upload.currentRow));
+	size_t size = rowsize * rows;
+
+	Rect rect = {0, upload.currentRow, w, rows};
+
+	image::ImageData *id = dynamic_cast<image::ImageData *>(d);
+
+	love::thread::EmptyLock lock;
+	if (id != nullptr)
+		lock.setLock(id->getMutex());
+
+	const uint8 *src = (const uint8 *) d->getData() + rowsize * upload.currentRow;
+
+	if (capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE])
+	{
+		// The staging buffer is released right away, backends keep it alive
+		// until the GPU is done with the copy.
+		size_t buffersize = (size + 3) & ~(size_t) 3;
+		Buffer::Settings settings(BUFFERUSAGEFLAG_NONE, BUFFERDATAUSAGE_STREAM);
+		StrongRef<Buffer> staging(newBuffer(settings, DATAFORMAT_UINT8_VEC4, nullptr, buffersize, 0), Acquire::NORETAIN);
+
+		staging->fill(0, size, src);
+		copyBufferToTexture(staging, texture, 0, w, part.slice, part.mipmap, rect);
+	}
+	else
+		texture->replacePixels(src, size, part.slice, part.mipmap, rect, false);
+
+	upload.currentRow += rows;
+	if (upload.currentRow >= h)
+	{
+		upload.currentPart++;
+		upload.currentRow = 0;
+	}
+
+	return size;
+}
+
+void Graphics::beginFrameTimer()
+{
+	if (!capabilities.features[FEATURE_TIMER_QUERY] || activeFrameTimer.get() != nullptr)
+		return;
+
+	StrongRef<TimerQuery> query;
+
+	if (!unusedFrameTimers.empty())
+	{
+		query = unusedFrameTimers.back();
+		unusedFrameTimers.pop_back();
+	}
+	else
+		query.set(newTimerQuery(), Acquire::NORETAIN);
+
+	query->start();
+	activeFrameTimer = query;
+}
+
+void Graphics::endFrameTimer()
+{
+	if (activeFrameTimer.get() != nullptr)
+	{
+		activeFrameTimer->stop();
+		pendingFrameTimers.push_back(activeFrameTimer);
+		activeFrameTimer.set(nullptr);
+	}
+
+	// Results come back in order, so the newest completed query wins.
+	while (!pendingFrameTimers.empty())
+	{
+		StrongRef<TimerQuery> query = pendingFrameTimers.front();
+		query->update();
+
+		if (!query->isComplete())
+			break;
+
+		gpuFrameTime = query->getTime();
+		pendingFrameTimers.erase(pendingFrameTimers.begin());
+		unusedFrameTimers.push_back(query);
+	}
+}
+
 void Graphics::intersectScissor(const Rect &rect)
 {
 	Rect currect = states.back().scissorRect;
@@ -1257,6 +2377,125 @@ CullMode Graphics::getMeshCullMode() const
 	return states.back().meshCullMode;
 }
 
+void Graphics::setDrawCulling(bool enable)
+{
+	states.back().drawCulling = enable;
+}
+
+bool Graphics::isDrawCullingEnabled() const
+{
+	return states.back().drawCulling;
+}
+
+void Graphics::beginConditionalRender(OcclusionQuery *query)
+{
+	if (!capabilities.features[FEATURE_CONDITIONAL_RENDER])
+		throw love::Exception("Conditional rendering is not supported on this system.");
+
+	if (conditionalRenderQuery.get() != nullptr)
+		throw love::Exception("Conditional rendering is already active.");
+
+	if (query->isRunning() || !query->hasStopped())
+		throw love::Exception("Conditional rendering needs an OcclusionQuery which has been started and stopped.");
+
+	flushBatchedDraws();
+
+	query->beginConditionalRender();
+	conditionalRenderQuery.set(query);
+}
+
+void Graphics::endConditionalRender()
+{
+	if (conditionalRenderQuery.get() == nullptr)
+		return;
+
+	flushBatchedDraws();
+
+	conditionalRenderQuery->endConditionalRender();
+	conditionalRenderQuery.set(nullptr);
+}
+
+OcclusionQuery *Graphics::getConditionalRenderQuery() const
+{
+	return conditionalRenderQuery.get();
+}
+
+bool Graphics::isRectVisible(const Matrix4 &m, float x, float y, float w, float h) const
+{
+	const DisplayState &state = states.back();
+	const float corners[4][2] = {{x, y}, {x + w, y}, {x, y + h}, {x + w, y + h}};
+
+	// Custom projections are tested in clip space, without the scissor.
+	if (state.useCustomProjection)
+	{
+		Matrix4 mvp = getDeviceProjection() * getTransform() * m;
+		const float *e = mvp.getElements();
+
+		int left = 0, right = 0, top = 0, bottom = 0, behind = 0;
+
+		for (const auto &c : corners)
+		{
+			float cx = e[0] * c[0] + e[4] * c[1] + e[12];
+			float cy = e[1] * c[0] + e[5] * c[1] + e[13];
+			float cw = e[3] * c[0] + e[7] * c[1] + e[15];
+
+			left += cx < -cw;
+			right += cx > cw;
+			top += cy < -cw;
+			bottom += cy > cw;
+			behind += cw <= 0.0f;
+		}
+
+		return left < 4 && right < 4 && top < 4 && bottom < 4 && behind < 4;
+	}
+
+	// Otherwise the transform maps straight to render target units.
+	Matrix4 t = getTransform() * m;
+	const float *e = t.getElements();
+
+	if (e[3] != 0.0f || e[7] != 0.0f || e[15] != 1.0f)
+		return true;
+
+	float minx = std::numeric_limits<float>::max();
+	float miny = std::numeric_limits<float>::max();
+	float maxx = -std::numeric_limits<float>::max();
+	float maxy = -std::numeric_limits<float>::max();
+
+	for (const auto &c : corners)
+	{
+		float tx = e[0] * c[0] + e[4] * c[1] + e[12];
+		float ty = e[1] * c[0] + e[5] * c[1] + e[13];
+
+		minx = std::min(minx, tx);
+		miny = std::min(miny, ty);
+		maxx = std::max(maxx, tx);
+		maxy = std::max(maxy, ty);
+	}
+
+	float vx = 0.0f;
+	float vy = 0.0f;
+	float vw = (float) getWidth();
+	float vh = (float) getHeight();
+
+	const auto &rt = state.renderTargets.getFirstTarget();
+	if (rt.texture.get())
+	{
+		vw = (float) rt.texture->getWidth(rt.mipmap);
+		vh = (float) rt.texture->getHeight(rt.mipmap);
+	}
+
+	if (state.scissor)
+	{
+		const Rect &r = state.scissorRect;
+		vx = std::max(vx, (float) r.x);
+		vy = std::max(vy, (float) r.y);
+		vw = std::min(vw, (float) (r.x + r.w)) - vx;
+		vh = std::min(vh, (float) (r.y + r.h)) - vy;
+	}
+
+	return maxx >= vx && maxy >= vy && minx <= vx + vw && miny <= vy + vh;
+}
+
 Winding Graphics::getFrontFaceWinding() const
 {
 	return states.back().winding;
@@ -1334,14 +2573,82 @@ float Graphics::getPointSize() const
 	return states.back().pointSize;
 }
 
-bool Graphics::isWireframe() const
-{
-	return states.back().wireframe;
-}
+bool Graphics::isWireframe() const
+{
+	return states.back().wireframe;
+}
+
+void Graphics::captureScreenshot(const ScreenshotInfo &info)
+{
+	pendingScreenshotCallbacks.push_back(info);
+}
+
+void Graphics::callScreenshotCallbacks(const std::vector<ScreenshotInfo> &callbacks, image::ImageData *img, void *screenshotCallbackData)
+{
+	std::vector<StrongRef<image::ImageData>> images;
+
+	try
+	{
+		images.emplace_back(img);
+
+		// Copies are made before any callback can modify the pixels.
+		for (size_t i = 1; i < callbacks.size(); i++)
+			images.emplace_back(newScreenshotImageData(img->getWidth(), img->getHeight(), img->getData()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		for (const auto &info : callbacks)
+			info.callback(&info, nullptr, nullptr);
+		throw;
+	}
+
+	for (size_t i = 0; i < callbacks.size(); i++)
+		callbacks[i].callback(&callbacks[i], images[i], screenshotCallbackData);
+}
+
+void Graphics::saveScreenshotAsync(image::ImageData *data, image::FormatHandler::EncodedFormat format, const std::string &filename)
+{
+	if (screenshotEncoder.get() == nullptr)
+		screenshotEncoder.set(new ScreenshotEncoder(), Acquire::NORETAIN);
+
+	screenshotEncoder->encode(data, format, filename);
+}
+
+image::ImageData *Graphics::newScreenshotImageData(int width, int height, const void *pixels)
+{
+	image::ImageData *img = nullptr;
+
+	for (auto &s : screenshotPool)
+	{
+		// Only the pool references it, so nothing can be reading the pixels.
+		if (s.data->getReferenceCount() == 1 && s.data->getWidth() == width && s.data->getHeight() == height)
+		{
+			img = s.data;
+			img->retain();
+			s.framesSinceUse = 0;
+			break;
+		}
+	}
+
+	if (img == nullptr)
+	{
+		auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
+		if (imagemodule == nullptr)
+			throw love::Exception("The love.image module must be loaded to capture screenshots.");
+
+		img = imagemodule->newImageData(width, height, PIXELFORMAT_RGBA8_UNORM, nullptr);
+
+		if (screenshotPool.size() < MAX_POOLED_SCREENSHOTS)
+		{
+			img->retain();
+			screenshotPool.push_back({img, 0});
+		}
+	}
+
+	if (pixels != nullptr)
+		memcpy(img->getData(), pixels, img->getSize());
 
-void Graphics::captureScreenshot(const ScreenshotInfo &info)
-{
-	pendingScreenshotCallbacks.push_back(info);
+	return img;
 }
 
 void Graphics::copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size)
@@ -1454,95 +2761,829 @@ void Graphics::copyTextureToBuffer(Texture *source, Buffer *dest, int slice, int
 		size = getPixelFormatUncompressedRowSize(format, pixels);
 	}
 
-	Range destrange(destoffset, size);
+	Range destrange(destoffset, size);
+
+	if (destrange.getMax() >= dest->getSize())
+		throw love::Exception("Buffer copy destination offset and width/height doesn't fit within the destination Buffer.");
+
+	source->copyToBuffer(dest, slice, mipmap, rect, destoffset, destwidth, size);
+}
+
+void Graphics::copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceoffset, int sourcewidth, int slice, int mipmap, const Rect &rect)
+{
+	if (!capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE])
+		throw love::Exception("Copying a Buffer to a Texture is not supported on this system.");
+
+	if (source->getDataUsage() == BUFFERDATAUSAGE_READBACK)
+		throw love::Exception("Buffers created with 'readback' data usage cannot be used as a copy source.");
+
+	PixelFormat format = dest->getPixelFormat();
+
+	if (isPixelFormatDepthStencil(format))
+		throw love::Exception("Copying a Buffer to a depth/stencil Texture is not supported.");
+
+	if (!dest->isReadable())
+		throw love::Exception("copyBufferToTexture can only be called on readable Textures.");
+
+	if (isRenderTargetActive(dest))
+		throw love::Exception("copyBufferToTexture cannot be called while the Texture is an active render target.");
+
+	if (mipmap < 0 || mipmap >= dest->getMipmapCount())
+		throw love::Exception("Invalid texture mipmap index %d.", mipmap + 1);
+
+	TextureType textype = dest->getTextureType();
+	if (slice < 0 || (textype == TEXTURE_CUBE && slice >= 6)
+		|| (textype == TEXTURE_VOLUME && slice >= dest->getDepth(mipmap))
+		|| (textype == TEXTURE_2D_ARRAY && slice >= dest->getLayerCount()))
+	{
+		throw love::Exception("Invalid texture slice index %d.", slice + 1);
+	}
+
+	int mipw = dest->getPixelWidth(mipmap);
+	int miph = dest->getPixelHeight(mipmap);
+
+	if (rect.x < 0 || rect.y < 0 || rect.w <= 0 || rect.h <= 0
+		|| (rect.x + rect.w) > mipw || (rect.y + rect.h) > miph)
+	{
+		throw love::Exception("Invalid rectangle dimensions (x=%d, y=%d, w=%d, h=%d) for %dx%d texture.", rect.x, rect.y, rect.w, rect.h, mipw, miph);
+	}
+
+	if (sourcewidth <= 0)
+		sourcewidth = rect.w;
+
+	size_t size = 0;
+
+	if (isPixelFormatCompressed(format))
+	{
+		if (sourcewidth != rect.w) // OpenGL limitation...
+			throw love::Exception("Copying a buffer to a compressed texture cannot use a custom source width.");
+
+		const PixelFormatInfo &info = getPixelFormatInfo(format);
+		int bw = (int) info.blockWidth;
+		int bh = (int) info.blockHeight;
+		if (rect.x % bw != 0 || rect.y % bh != 0 ||
+			((rect.w % bw != 0 || rect.h % bh != 0) && rect.x + rect.w != dest->getPixelWidth(mipmap)))
+		{
+			const char *name = nullptr;
+			love::getConstant(format, name);
+			throw love::Exception("Compressed texture format %s only supports copying a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
+		}
+
+		// Note: this will need to change if sourcewidth == rect.w restriction
+		// is removed.
+		size = getPixelFormatSliceSize(format, sourcewidth, rect.h);
+	}
+	else
+	{
+		// Not the cleanest, but should work since uncompressed formats always
+		// have 1x1 blocks.
+		int pixels = (rect.h - 1) * sourcewidth + rect.w;
+		size = getPixelFormatUncompressedRowSize(format, pixels);
+	}
+
+	Range sourcerange(sourceoffset, size);
+
+	if (sourcerange.getMax() >= source->getSize())
+		throw love::Exception("Buffer copy source offset and width/height doesn't fit within the source Buffer.");
+
+	dest->copyFromBuffer(source, sourceoffset, sourcewidth, size, slice, mipmap, rect);
+
+	Texture *sharedarray = dest->getSharedArrayTexture();
+	if (sharedarray != nullptr)
+		sharedarray->copyFromBuffer(source, sourceoffset, sourcewidth, size, dest->getSharedArrayLayer(), mipmap, rect);
+}
+
+// Downsamples one mip level into a storage buffer, packed in the texture's
+// pixel format so it can be copied straight into the next mip level. The
+// MIP_* defines describe the format and are set by generateMipmapsCompute.
+static const char mipmapComputeCode[] = R"(
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+#if MIP_KIND == 1
+	#define texel_t ivec4
+	#if MIP_ARRAY
+		uniform highp isampler2DArray Source;
+	#else
+		uniform highp isampler2D Source;
+	#endif
+#elif MIP_KIND == 2
+	#define texel_t uvec4
+	#if MIP_ARRAY
+		uniform highp usampler2DArray Source;
+	#else
+		uniform highp usampler2D Source;
+	#endif
+#else
+	#define texel_t vec4
+	#if MIP_ARRAY
+		uniform highp sampler2DArray Source;
+	#else
+		uniform highp sampler2D Source;
+	#endif
+#endif
+
+#if MIP_BITS == 8
+	#define MIP_MASK 0xFFu
+	#define MIP_UNORM_MAX 255.0
+#elif MIP_BITS == 16
+	#define MIP_MASK 0xFFFFu
+	#define MIP_UNORM_MAX 65535.0
+#else
+	#define MIP_MASK 0xFFFFFFFFu
+	#define MIP_UNORM_MAX 4294967295.0
+#endif
+
+#define MIP_SCALARS_PER_WORD (32 / MIP_BITS)
+
+// x: source mip level, y: destination width, z: destination height,
+// w: threads per destination row.
+uniform ivec4 Params;
+
+// Offset into DestWords of the destination mip level.
+uniform int DestOffset;
+
+layout (std430) writeonly buffer DestBuffer
+{
+	uint DestWords[];
+};
+
+texel_t fetchSource(ivec2 p)
+{
+#if MIP_ARRAY
+	return texelFetch(Source, ivec3(p, int(love_GlobalThreadID.z)), Params.x);
+#else
+	return texelFetch(Source, p, Params.x);
+#endif
+}
+
+texel_t downsample(ivec2 p)
+{
+	ivec2 maxp = textureSize(Source, Params.x).xy - 1;
+	ivec2 p0 = min(p * 2, maxp);
+	ivec2 p1 = min(p * 2 + 1, maxp);
+
+	texel_t a = fetchSource(p0);
+	texel_t b = fetchSource(ivec2(p1.x, p0.y));
+	texel_t c = fetchSource(ivec2(p0.x, p1.y));
+	texel_t d = fetchSource(p1);
+
+#if MIP_KIND == 0
+	return (a + b + c + d) * 0.25;
+#else
+	// Split into high and low bits so 32 bit values can't overflow.
+	return (a >> 2) + (b >> 2) + (c >> 2) + (d >> 2) + (((a & 3) + (b & 3) + (c & 3) + (d & 3)) >> 2);
+#endif
+}
+
+#if MIP_KIND == 0
+uint encodeScalar(float v, int component)
+{
+#if MIP_ENCODE == 1
+	// sRGB textures are decoded when fetched, so they're filtered in linear
+	// space and have to be encoded again here. Alpha is always linear.
+	v = clamp(v, 0.0, 1.0);
+	if (component < 3)
+		v = v <= 0.0031308 ? v * 12.92 : 1.055 * pow(v, 1.0 / 2.4) - 0.055;
+	return uint(v * MIP_UNORM_MAX + 0.5);
+#elif MIP_ENCODE == 2
+	return packHalf2x16(vec2(v, 0.0)) & MIP_MASK;
+#elif MIP_ENCODE == 3
+	return floatBitsToUint(v);
+#else
+	return uint(clamp(v, 0.0, 1.0) * MIP_UNORM_MAX + 0.5);
+#endif
+}
+#elif MIP_KIND == 1
+uint encodeScalar(int v, int component)
+{
+	return uint(v) & MIP_MASK;
+}
+#else
+uint encodeScalar(uint v, int component)
+{
+	return v & MIP_MASK;
+}
+#endif
+
+void computemain()
+{
+	ivec2 id = ivec2(love_GlobalThreadID.xy);
+	if (id.x >= Params.w || id.y >= Params.z)
+		return;
+
+	uint words[MIP_WORDS_PER_THREAD];
+	for (int i = 0; i < MIP_WORDS_PER_THREAD; i++)
+		words[i] = 0u;
+
+	// Formats smaller than 4 bytes per pixel pack several pixels into each
+	// word, so threads never share a word.
+	for (int i = 0; i < MIP_PIXELS_PER_THREAD; i++)
+	{
+		int x = id.x * MIP_PIXELS_PER_THREAD + i;
+		if (x >= Params.y)
+			break;
+
+		texel_t t = downsample(ivec2(x, id.y));
+#if MIP_BGRA
+		t = t.bgra;
+#endif
+
+		for (int c = 0; c < MIP_COMPONENTS; c++)
+		{
+			int s = i * MIP_COMPONENTS + c;
+			words[s / MIP_SCALARS_PER_WORD] |= encodeScalar(t[c], c) << uint((s % MIP_SCALARS_PER_WORD) * MIP_BITS);
+		}
+	}
+
+	int thread = (int(love_GlobalThreadID.z) * Params.z + id.y) * Params.w + id.x;
+	int offset = DestOffset + thread * MIP_WORDS_PER_THREAD;
+
+	for (int i = 0; i < MIP_WORDS_PER_THREAD; i++)
+		DestWords[offset + i] = words[i];
+}
+)";
+
+struct ComputeMipmapFormat
+{
+	int kind; // 0: float, 1: int, 2: uint.
+	int encode; // 0: unorm, 1: sRGB, 2: half float, 3: float, 4: integer.
+	int bits;
+	int components;
+	bool bgra;
+};
+
+static bool getComputeMipmapFormat(PixelFormat format, ComputeMipmapFormat &f)
+{
+	switch (format)
+	{
+	case PIXELFORMAT_R8_UNORM: f = {0, 0, 8, 1, false}; return true;
+	case PIXELFORMAT_R8_INT: f = {1, 4, 8, 1, false}; return true;
+	case PIXELFORMAT_R8_UINT: f = {2, 4, 8, 1, false}; return true;
+	case PIXELFORMAT_R16_UNORM: f = {0, 0, 16, 1, false}; return true;
+	case PIXELFORMAT_R16_FLOAT: f = {0, 2, 16, 1, false}; return true;
+	case PIXELFORMAT_R16_INT: f = {1, 4, 16, 1, false}; return true;
+	case PIXELFORMAT_R16_UINT: f = {2, 4, 16, 1, false}; return true;
+	case PIXELFORMAT_R32_FLOAT: f = {0, 3, 32, 1, false}; return true;
+	case PIXELFORMAT_R32_INT: f = {1, 4, 32, 1, false}; return true;
+	case PIXELFORMAT_R32_UINT: f = {2, 4, 32, 1, false}; return true;
+	case PIXELFORMAT_RG8_UNORM: f = {0, 0, 8, 2, false}; return true;
+	case PIXELFORMAT_RG8_INT: f = {1, 4, 8, 2, false}; return true;
+	case PIXELFORMAT_RG8_UINT: f = {2, 4, 8, 2, false}; return true;
+	case PIXELFORMAT_RG16_UNORM: f = {0, 0, 16, 2, false}; return true;
+	case PIXELFORMAT_RG16_FLOAT: f = {0, 2, 16, 2, false}; return true;
+	case PIXELFORMAT_RG16_INT: f = {1, 4, 16, 2, false}; return true;
+	case PIXELFORMAT_RG16_UINT: f = {2, 4, 16, 2, false}; return true;
+	case PIXELFORMAT_RG32_FLOAT: f = {0, 3, 32, 2, false}; return true;
+	case PIXELFORMAT_RG32_INT: f = {1, 4, 32, 2, false}; return true;
+	case PIXELFORMAT_RG32_UINT: f = {2, 4, 32, 2, false}; return true;
+	case PIXELFORMAT_RGBA8_UNORM: f = {0, 0, 8, 4, false}; return true;
+	case PIXELFORMAT_RGBA8_UNORM_sRGB: f = {0, 1, 8, 4, false}; return true;
+	case PIXELFORMAT_BGRA8_UNORM: f = {0, 0, 8, 4, true}; return true;
+	case PIXELFORMAT_BGRA8_UNORM_sRGB: f = {0, 1, 8, 4, true}; return true;
+	case PIXELFORMAT_RGBA8_INT: f = {1, 4, 8, 4, false}; return true;
+	case PIXELFORMAT_RGBA8_UINT: f = {2, 4, 8, 4, false}; return true;
+	case PIXELFORMAT_RGBA16_UNORM: f = {0, 0, 16, 4, false}; return true;
+	case PIXELFORMAT_RGBA16_FLOAT: f = {0, 2, 16, 4, false}; return true;
+	case PIXELFORMAT_RGBA16_INT: f = {1, 4, 16, 4, false}; return true;
+	case PIXELFORMAT_RGBA16_UINT: f = {2, 4, 16, 4, false}; return true;
+	case PIXELFORMAT_RGBA32_FLOAT: f = {0, 3, 32, 4, false}; return true;
+	case PIXELFORMAT_RGBA32_INT: f = {1, 4, 32, 4, false}; return true;
+	case PIXELFORMAT_RGBA32_UINT: f = {2, 4, 32, 4, false}; return true;
+	default: return false;
+	}
+}
+
+bool Graphics::isComputeMipmapsSupported(const Texture *texture, const char *&outReason) const
+{
+	if (texture->getMipmapsMode() == Texture::MIPMAPS_NONE)
+	{
+		outReason = "generateMipmaps can only be called on a Texture which was created with mipmaps enabled.";
+		return false;
+	}
+
+	if (!capabilities.features[FEATURE_GLSL4] || !capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE])
+	{
+		outReason = "Generating mipmaps with a compute shader is not supported on this system.";
+		return false;
+	}
+
+	TextureType textype = texture->getTextureType();
+	if (textype != TEXTURE_2D && textype != TEXTURE_2D_ARRAY)
+	{
+		outReason = "Generating mipmaps with a compute shader is only supported for 2D and array textures.";
+		return false;
+	}
+
+	if (!texture->isReadable())
+	{
+		outReason = "Generating mipmaps with a compute shader is only supported for readable textures.";
+		return false;
+	}
+
+	ComputeMipmapFormat f;
+	if (!getComputeMipmapFormat(texture->getPixelFormat(), f))
+	{
+		outReason = "Generating mipmaps with a compute shader is not supported for this texture's pixel format.";
+		return false;
+	}
+
+	return true;
+}
+
+void Graphics::generateMipmapsCompute(Texture *texture)
+{
+	const char *err = nullptr;
+	if (!isComputeMipmapsSupported(texture, err))
+		throw love::Exception("%s", err);
+
+	if (isRenderTargetActive(texture))
+		throw love::Exception("generateMipmaps cannot be called while the Texture is an active render target.");
+
+	ComputeMipmapFormat f;
+	getComputeMipmapFormat(texture->getPixelFormat(), f);
+
+	int bytesperpixel = f.bits / 8 * f.components;
+	int pixelsperthread = std::max(4 / bytesperpixel, 1);
+	int wordsperthread = std::max(bytesperpixel / 4, 1);
+
+	bool isarray = texture->getTextureType() == TEXTURE_2D_ARRAY;
+	int layers = isarray ? texture->getLayerCount() : 1;
+	int mipcount = texture->getMipmapCount();
+
+	if (mipcount <= 1)
+		return;
+
+	std::map<std::string, std::string> defines;
+	defines["MIP_ARRAY"] = isarray ? "1" : "0";
+	defines["MIP_KIND"] = std::to_string(f.kind);
+	defines["MIP_ENCODE"] = std::to_string(f.encode);
+	defines["MIP_BITS"] = std::to_string(f.bits);
+	defines["MIP_COMPONENTS"] = std::to_string(f.components);
+	defines["MIP_BGRA"] = f.bgra ? "1" : "0";
+	defines["MIP_PIXELS_PER_THREAD"] = std::to_string(pixelsperthread);
+	defines["MIP_WORDS_PER_THREAD"] = std::to_string(wordsperthread);
+
+	// The first format to use this creates the base shader, others become
+	// cached variants of it.
+	if (mipmapComputeShader.get() == nullptr)
+	{
+		Shader::CompileOptions options;
+		options.defines = defines;
+		mipmapComputeShader.set(newComputeShader(mipmapComputeCode, options), Acquire::NORETAIN);
+	}
+
+	Shader *shader = getShaderVariant(mipmapComputeShader, defines);
+
+	const Shader::UniformInfo *sourceinfo = shader->getUniformInfo("Source");
+	const Shader::UniformInfo *paramsinfo = shader->getUniformInfo("Params");
+	const Shader::UniformInfo *offsetinfo = shader->getUniformInfo("DestOffset");
+	const Shader::UniformInfo *bufferinfo = shader->getUniformInfo("DestBuffer");
+
+	if (sourceinfo == nullptr || paramsinfo == nullptr || bufferinfo == nullptr)
+		throw love::Exception("Could not find the mipmap generation shader's variables.");
+
+	// Every level gets its own part of the buffer, so a level's copy never
+	// races with the next level's dispatch.
+	std::vector<size_t> offsets(mipcount, 0);
+	size_t totalwords = 0;
+
+	for (int mip = 1; mip < mipcount; mip++)
+	{
+		int threadsperrow = (texture->getPixelWidth(mip) + pixelsperthread - 1) / pixelsperthread;
+		offsets[mip] = totalwords;
+		totalwords += (size_t) threadsperrow * wordsperthread * texture->getPixelHeight(mip) * layers;
+	}
+
+	Buffer *buffer = getTemporaryBuffer(totalwords * sizeof(uint32), DATAFORMAT_UINT32, BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+
+	try
+	{
+		shader->sendTextures(sourceinfo, &texture, 1);
+		shader->sendBuffers(bufferinfo, &buffer, 1);
+
+		for (int mip = 1; mip < mipcount; mip++)
+		{
+			int w = texture->getPixelWidth(mip);
+			int h = texture->getPixelHeight(mip);
+			int threadsperrow = (w + pixelsperthread - 1) / pixelsperthread;
+
+			paramsinfo->ints[0] = mip - 1;
+			paramsinfo->ints[1] = w;
+			paramsinfo->ints[2] = h;
+			paramsinfo->ints[3] = threadsperrow;
+			shader->updateUniform(paramsinfo, 1);
+
+			if (offsetinfo != nullptr)
+			{
+				offsetinfo->ints[0] = (int) offsets[mip];
+				shader->updateUniform(offsetinfo, 1);
+			}
+
+			dispatchThreadgroups(shader, (threadsperrow + 7) / 8, (h + 7) / 8, layers);
+
+			size_t slicesize = (size_t) threadsperrow * wordsperthread * h * sizeof(uint32);
+			Rect rect = {0, 0, w, h};
+
+			for (int slice = 0; slice < layers; slice++)
+			{
+				size_t offset = offsets[mip] * sizeof(uint32) + slicesize * slice;
+				copyBufferToTexture(buffer, texture, offset, threadsperrow * pixelsperthread, slice, mip, rect);
+			}
+		}
+	}
+	catch (love::Exception &)
+	{
+		releaseTemporaryBuffer(buffer);
+		throw;
+	}
+
+	releaseTemporaryBuffer(buffer);
+}
+
+// GPU ParticleSystems store six vec4s per particle:
+// 0: position, velocity.
+// 1: origin (the emitter's position when it was emitted), linear acceleration.
+// 2: life left, lifetime, radial acceleration, tangential acceleration.
+// 3: linear damping, size offset, size interval, rotation.
+// 4: spin start, spin end, angle, size.
+// 5: color.
+// A particle is dead when its life left isn't positive. The update shader
+// mirrors the CPU code in ParticleSystem.cpp, ParticleSystem::updateGPU sets
+// its uniforms.
+static const char particleComputeCode[] = R"(
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// x: first slot to emit into, y: number of particles to emit, z: number of
+// slots, w: random seed.
+uniform ivec4 EmitState;
+
+// x: emission area distribution, y: flags (1: direction relative to the
+// emission center, 2: relative rotation, 4: kill every other particle),
+// z: size count, w: color count.
+uniform ivec4 EmitOptions;
+
+uniform vec4 Params[8];
+uniform vec4 Sizes[2];
+uniform vec4 Colors[8];
+
+#define Dt (Params[0].x)
+#define Direction (Params[0].y)
+#define Spread (Params[0].z)
+#define EmissionAreaAngle (Params[0].w)
+#define EmitterPosition (Params[1].xy)
+#define PrevEmitterPosition (Params[1].zw)
+#define LifeRange (Params[2].xy)
+#define SpeedRange (Params[2].zw)
+#define LinearAccelerationMin (Params[3].xy)
+#define LinearAccelerationMax (Params[3].zw)
+#define RadialAccelerationRange (Params[4].xy)
+#define TangentialAccelerationRange (Params[4].zw)
+#define LinearDampingRange (Params[5].xy)
+#define RotationRange (Params[5].zw)
+#define SpinStart (Params[6].x)
+#define SpinEnd (Params[6].y)
+#define SpinVariation (Params[6].z)
+#define SizeVariation (Params[6].w)
+#define EmissionArea (Params[7].xy)
+#define OriginShift (Params[7].zw)
+
+layout (std430) buffer ParticleBuffer
+{
+	vec4 Particles[];
+};
+
+uint randomState;
+
+float random()
+{
+	// PCG hash.
+	randomState = randomState * 747796405u + 2891336453u;
+	uint word = ((randomState >> ((randomState >> 28u) + 4u)) ^ randomState) * 277803737u;
+	return float((word >> 22u) ^ word) / 4294967295.0;
+}
+
+float random(vec2 range)
+{
+	return mix(range.x, range.y, random());
+}
+
+float randomNormal(float stddev)
+{
+	float r = sqrt(-2.0 * log(max(1.0 - random(), 1e-7)));
+	return r * cos(6.28318531 * random()) * stddev;
+}
+
+float variation(float inner, float outer, float var)
+{
+	return inner + (outer * 0.5) * var * (random() * 2.0 - 1.0);
+}
+
+float interpolateSize(float s)
+{
+	int n = EmitOptions.z;
+	if (n <= 1)
+		return Sizes[0].x;
+
+	s *= float(n - 1);
+	int i = clamp(int(s), 0, n - 1);
+	int k = min(i + 1, n - 1);
+	return mix(Sizes[i / 4][i % 4], Sizes[k / 4][k % 4], s - float(i));
+}
+
+vec4 interpolateColor(float t)
+{
+	int n = EmitOptions.w;
+	if (n <= 1)
+		return Colors[0];
+
+	float s = t * float(n - 1);
+	int i = clamp(int(s), 0, n - 1);
+	int k = min(i + 1, n - 1);
+	return mix(Colors[i], Colors[k], s - float(i));
+}
+
+vec2 emissionAreaOffset()
+{
+	vec2 area = EmissionArea;
+	vec2 r = vec2(0.0);
+
+	int distribution = EmitOptions.x;
+	if (distribution == 1) // Uniform.
+		r = vec2(random(vec2(-area.x, area.x)), random(vec2(-area.y, area.y)));
+	else if (distribution == 2) // Normal.
+		r = vec2(randomNormal(area.x), randomNormal(area.y));
+	else if (distribution == 3) // Ellipse.
+	{
+		vec2 e = vec2(random(vec2(-1.0, 1.0)), random(vec2(-1.0, 1.0)));
+		r = area * e * sqrt(1.0 - 0.5 * e.yx * e.yx);
+	}
+	else if (distribution == 4) // Border ellipse.
+	{
+		float a = random(vec2(0.0, 6.28318531));
+		r = vec2(cos(a), sin(a)) * area;
+	}
+	else if (distribution == 5) // Border rectangle.
+	{
+		float x = random(vec2(-2.0, 2.0) * (area.x + area.y));
+		float h = area.y * 2.0;
+		if (x < -h)
+			r = vec2(x + h + area.x, -area.y);
+		else if (x < 0.0)
+			r = vec2(-area.x, x + area.y);
+		else if (x < h)
+			r = vec2(area.x, x - area.y);
+		else
+			r = vec2(x - h - area.x, area.y);
+	}
+
+	float c = cos(EmissionAreaAngle);
+	float s = sin(EmissionAreaAngle);
+	return vec2(c * r.x - s * r.y, s * r.x + c * r.y);
+}
+
+void emit(uint base, float t)
+{
+	vec2 origin = mix(PrevEmitterPosition, EmitterPosition, t);
+	float life = random(LifeRange);
+
+	float dir = random(vec2(Direction - Spread * 0.5, Direction + Spread * 0.5));
+	vec2 pos = origin + emissionAreaOffset();
+
+	if ((EmitOptions.y & 1) != 0)
+		dir += atan(pos.y - origin.y, pos.x - origin.x);
+
+	vec2 velocity = vec2(cos(dir), sin(dir)) * random(SpeedRange);
+	vec2 accel = vec2(random(vec2(LinearAccelerationMin.x, LinearAccelerationMax.x)), random(vec2(LinearAccelerationMin.y, LinearAccelerationMax.y)));
+	float radial = random(RadialAccelerationRange);
+	float tangential = random(TangentialAccelerationRange);
+	float damping = random(LinearDampingRange);
+
+	float sizeoffset = random() * SizeVariation;
+	float sizeinterval = (1.0 - random() * SizeVariation) - sizeoffset;
+
+	float spinstart = variation(SpinStart, SpinEnd, SpinVariation);
+	float spinend = variation(SpinEnd, SpinStart, SpinVariation);
+	float rotation = random(RotationRange);
+
+	float angle = rotation;
+	if ((EmitOptions.y & 2) != 0)
+		angle += atan(velocity.y, velocity.x);
+
+	Particles[base + 0u] = vec4(pos, velocity);
+	Particles[base + 1u] = vec4(origin, accel);
+	Particles[base + 2u] = vec4(life, life, radial, tangential);
+	Particles[base + 3u] = vec4(damping, sizeoffset, sizeinterval, rotation);
+	Particles[base + 4u] = vec4(spinstart, spinend, angle, interpolateSize(sizeoffset));
+	Particles[base + 5u] = Colors[0];
+}
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+	uint count = uint(EmitState.z);
+	if (index >= count)
+		return;
+
+	uint base = index * 6u;
+
+	// Emitted particles fill a ring of slots, starting after the last ones.
+	uint emitcount = uint(EmitState.y);
+	uint emitindex = (index + count - uint(EmitState.x)) % count;
+	if (emitindex < emitcount)
+	{
+		randomState = index * 1664525u ^ uint(EmitState.w);
+		random();
+		emit(base, float(emitindex + 1u) / float(emitcount));
+		return;
+	}
+
+	vec4 lifeinfo = Particles[base + 2u];
+	lifeinfo.x -= Dt;
+
+	if ((EmitOptions.y & 4) != 0 || !(lifeinfo.x > 0.0))
+	{
+		Particles[base + 2u].x = 0.0;
+		return;
+	}
+
+	vec4 posvel = Particles[base + 0u];
+	vec4 originaccel = Particles[base + 1u];
+	vec4 misc = Particles[base + 3u];
+	vec4 spin = Particles[base + 4u];
 
-	if (destrange.getMax() >= dest->getSize())
-		throw love::Exception("Buffer copy destination offset and width/height doesn't fit within the destination Buffer.");
+	posvel.xy -= OriginShift;
+	originaccel.xy -= OriginShift;
+	Particles[base + 1u].xy = originaccel.xy;
 
-	source->copyToBuffer(dest, slice, mipmap, rect, destoffset, destwidth, size);
+	vec2 r = posvel.xy - originaccel.xy;
+	float len = length(r);
+	r = len > 0.0 ? r / len : vec2(0.0);
+
+	// The tangential direction is the radial one rotated by 90 degrees.
+	vec2 accel = r * lifeinfo.z + vec2(-r.y, r.x) * lifeinfo.w + originaccel.zw;
+	vec2 velocity = (posvel.zw + accel * Dt) / (1.0 + misc.x * Dt);
+	vec2 pos = posvel.xy + velocity * Dt;
+
+	float t = 1.0 - lifeinfo.x / lifeinfo.y;
+	float rotation = misc.w + mix(spin.x, spin.y, t) * Dt;
+
+	float angle = rotation;
+	if ((EmitOptions.y & 2) != 0)
+		angle += atan(velocity.y, velocity.x);
+
+	Particles[base + 0u] = vec4(pos, velocity);
+	Particles[base + 2u].x = lifeinfo.x;
+	Particles[base + 3u].w = rotation;
+	Particles[base + 4u].zw = vec2(angle, interpolateSize(misc.y + t * misc.z));
+	Particles[base + 5u] = interpolateColor(t);
 }
+)";
 
-void Graphics::copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceoffset, int sourcewidth, int slice, int mipmap, const Rect &rect)
+// Draws one instance per particle slot, see ParticleSystem::drawGPU.
+static const char particleVertexCode[] = R"(
+#pragma language glsl4
+
+layout (std430) readonly buffer ParticleBuffer
 {
-	if (!capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE])
-		throw love::Exception("Copying a Buffer to a Texture is not supported on this system.");
+	vec4 Particles[];
+};
 
-	if (source->getDataUsage() == BUFFERDATAUSAGE_READBACK)
-		throw love::Exception("Buffers created with 'readback' data usage cannot be used as a copy source.");
+// xy: offset, z: quad count.
+uniform vec4 RenderParams;
 
-	PixelFormat format = dest->getPixelFormat();
+// Each quad is its texture rectangle (xy: origin, zw: size) followed by its
+// size in pixels.
+uniform vec4 Quads[128];
 
-	if (isPixelFormatDepthStencil(format))
-		throw love::Exception("Copying a Buffer to a depth/stencil Texture is not supported.");
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	int base = love_InstanceID * 6;
+	vec4 lifeinfo = Particles[base + 2];
 
-	if (!dest->isReadable())
-		throw love::Exception("copyBufferToTexture can only be called on readable Textures.");
+	// Dead particles are moved outside the clip volume.
+	if (!(lifeinfo.x > 0.0))
+		return vec4(2.0, 2.0, 2.0, 1.0);
 
-	if (isRenderTargetActive(dest))
-		throw love::Exception("copyBufferToTexture cannot be called while the Texture is an active render target.");
+	vec4 posvel = Particles[base + 0];
+	vec4 spin = Particles[base + 4];
 
-	if (mipmap < 0 || mipmap >= dest->getMipmapCount())
-		throw love::Exception("Invalid texture mipmap index %d.", mipmap + 1);
+	int quadcount = int(RenderParams.z);
+	float t = 1.0 - lifeinfo.x / lifeinfo.y;
+	int q = clamp(int(t * float(quadcount)), 0, quadcount - 1) * 2;
 
-	TextureType textype = dest->getTextureType();
-	if (slice < 0 || (textype == TEXTURE_CUBE && slice >= 6)
-		|| (textype == TEXTURE_VOLUME && slice >= dest->getDepth(mipmap))
-		|| (textype == TEXTURE_2D_ARRAY && slice >= dest->getLayerCount()))
+	vec2 corner = vec2(float(love_VertexID >> 1), float(love_VertexID & 1));
+	VaryingTexCoord = vec4(Quads[q].xy + corner * Quads[q].zw, 0.0, 1.0);
+	VaryingColor = gammaCorrectColor(Particles[base + 5]) * ConstantColor;
+
+	vec2 p = (corner * Quads[q + 1].xy - RenderParams.xy) * spin.w;
+	float c = cos(spin.z);
+	float s = sin(spin.z);
+	p = posvel.xy + vec2(c * p.x - s * p.y, s * p.x + c * p.y);
+
+	return clipSpaceFromLocal * vec4(p, 0.0, 1.0);
+}
+)";
+
+static const char particlePixelCode[] = R"(
+#pragma language glsl4
+
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	return Texel(tex, texcoord) * vcolor;
+}
+)";
+
+Shader *Graphics::getParticleComputeShader()
+{
+	if (particleComputeShader.get() == nullptr)
 	{
-		throw love::Exception("Invalid texture slice index %d.", slice + 1);
+		Shader::CompileOptions options;
+		particleComputeShader.set(newComputeShader(particleComputeCode, options), Acquire::NORETAIN);
 	}
 
-	int mipw = dest->getPixelWidth(mipmap);
-	int miph = dest->getPixelHeight(mipmap);
+	return particleComputeShader;
+}
 
-	if (rect.x < 0 || rect.y < 0 || rect.w <= 0 || rect.h <= 0
-		|| (rect.x + rect.w) > mipw || (rect.y + rect.h) > miph)
+Shader *Graphics::getParticleRenderShader()
+{
+	if (particleRenderShader.get() == nullptr)
 	{
-		throw love::Exception("Invalid rectangle dimensions (x=%d, y=%d, w=%d, h=%d) for %dx%d texture.", rect.x, rect.y, rect.w, rect.h, mipw, miph);
+		Shader::CompileOptions options;
+		std::vector<std::string> stages = {particleVertexCode, particlePixelCode};
+		particleRenderShader.set(newShader(stages, options), Acquire::NORETAIN);
 	}
 
-	if (sourcewidth <= 0)
-		sourcewidth = rect.w;
+	return particleRenderShader;
+}
 
-	size_t size = 0;
+// Draws one quad per line segment, see Line::drawExpanded. The quad's
+// distance from the segment is passed to the pixel shader, which fades out
+// the edges of smooth lines.
+static const char lineVertexCode[] = R"(
+#pragma language glsl3
 
-	if (isPixelFormatCompressed(format))
-	{
-		if (sourcewidth != rect.w) // OpenGL limitation...
-			throw love::Exception("Copying a buffer to a compressed texture cannot use a custom source width.");
+attribute vec2 LineStart;
+attribute vec2 LineEnd;
 
-		const PixelFormatInfo &info = getPixelFormatInfo(format);
-		int bw = (int) info.blockWidth;
-		int bh = (int) info.blockHeight;
-		if (rect.x % bw != 0 || rect.y % bh != 0 ||
-			((rect.w % bw != 0 || rect.h % bh != 0) && rect.x + rect.w != dest->getPixelWidth(mipmap)))
-		{
-			const char *name = nullptr;
-			love::getConstant(format, name);
-			throw love::Exception("Compressed texture format %s only supports copying a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
-		}
+// x: half line width, y: pixel size of smooth lines (0 for rough lines).
+uniform vec4 LineParams;
 
-		// Note: this will need to change if sourcewidth == rect.w restriction
-		// is removed.
-		size = getPixelFormatSliceSize(format, sourcewidth, rect.h);
-	}
-	else
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec2 corner = vec2(float(love_VertexID >> 1), float(love_VertexID & 1));
+	float side = corner.y * 2.0 - 1.0;
+	float extent = LineParams.x + LineParams.y;
+
+	vec2 dir = LineEnd - LineStart;
+	float len = length(dir);
+	dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);
+
+	vec2 p = mix(LineStart, LineEnd, corner.x) + vec2(-dir.y, dir.x) * side * extent;
+
+	VaryingTexCoord = vec4(side * extent, 0.0, 0.0, 1.0);
+	VaryingColor = ConstantColor;
+
+	return clipSpaceFromLocal * vec4(p, 0.0, 1.0);
+}
+)";
+
+static const char linePixelCode[] = R"(
+#pragma language glsl3
+
+uniform vec4 LineParams;
+
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	float alpha = 1.0;
+	if (LineParams.y > 0.0)
+		alpha = clamp((LineParams.x + LineParams.y - abs(texcoord.x)) / LineParams.y, 0.0, 1.0);
+	return vec4(vcolor.rgb, vcolor.a * alpha);
+}
+)";
+
+Shader *Graphics::getLineShader()
+{
+	if (lineShader.get() == nullptr)
 	{
-		// Not the cleanest, but should work since uncompressed formats always
-		// have 1x1 blocks.
-		int pixels = (rect.h - 1) * sourcewidth + rect.w;
-		size = getPixelFormatUncompressedRowSize(format, pixels);
+		Shader::CompileOptions options;
+		std::vector<std::string> stages = {lineVertexCode, linePixelCode};
+		lineShader.set(newShader(stages, options), Acquire::NORETAIN);
 	}
 
-	Range sourcerange(sourceoffset, size);
+	return lineShader;
+}
 
-	if (sourcerange.getMax() >= source->getSize())
-		throw love::Exception("Buffer copy source offset and width/height doesn't fit within the source Buffer.");
+void Graphics::dispatchThreadgroups(Shader* shader, int x, int y, int z)
+{
+	dispatchThreadgroups(shader, x, y, z, false);
+}
 
-	dest->copyFromBuffer(source, sourceoffset, sourcewidth, size, slice, mipmap, rect);
+uint64 Graphics::dispatchThreadgroupsAsync(Shader* shader, int x, int y, int z)
+{
+	return dispatchThreadgroups(shader, x, y, z, true);
 }
 
-void Graphics::dispatchThreadgroups(Shader* shader, int x, int y, int z)
+uint64 Graphics::dispatchThreadgroups(Shader* shader, int x, int y, int z, bool async)
 {
 	if (!shader->hasStage(SHADERSTAGE_COMPUTE))
 		throw love::Exception("Only compute shaders can have threads dispatched.");
@@ -1562,17 +3603,44 @@ void Graphics::dispatchThreadgroups(Shader* shader, int x, int y, int z)
 	auto prevshader = Shader::current;
 	shader->attach();
 
-	bool success = dispatch(x, y, z);
+	uint64 fence = 0;
+	bool success = async ? dispatchAsync(x, y, z, fence) : dispatch(x, y, z);
 
 	if (prevshader != nullptr)
 		prevshader->attach();
 
 	if (!success)
 		throw love::Exception("Compute shader must have resources bound to all writable texture and buffer variables.");
+
+	return fence;
+}
+
+bool Graphics::dispatchAsync(int x, int y, int z, uint64 &fence)
+{
+	fence = 0;
+	return dispatch(x, y, z);
+}
+
+bool Graphics::isComputeFenceComplete(uint64 /*fence*/)
+{
+	return true;
+}
+
+void Graphics::waitComputeFence(uint64 /*fence*/)
+{
 }
 
 Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
 {
+	if (recordingDrawList != nullptr)
+		return recordingDrawList->requestBatchedDraw(cmd);
+
+	if (batchSortMode != BATCH_SORT_NONE)
+		return requestSortedBatchedDraw(cmd);
+
+	if (!instancedShapeState.pending.empty())
+		flushInstancedShapes();
+
 	BatchedDrawState &state = batchedDrawState;
 
 	bool shouldflush = false;
@@ -1706,8 +3774,228 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 	return d;
 }
 
+// Maps a float to an unsigned integer which sorts in the same order.
+static inline uint32 getSortableFloatBits(float f)
+{
+	uint32 bits;
+	memcpy(&bits, &f, sizeof(uint32));
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+// Stable LSD radix sort of 0..keys.size()-1 by their keys, 8 bits per pass.
+// Passes where every key has the same byte are skipped, so draws which only
+// use a few distinct depths don't pay for all four.
+static const std::vector<uint32> &radixSortIndices(const std::vector<uint32> &keys, std::vector<uint32> &indices, std::vector<uint32> &scratch)
+{
+	size_t count = keys.size();
+
+	indices.resize(count);
+	scratch.resize(count);
+
+	for (size_t i = 0; i < count; i++)
+		indices[i] = (uint32) i;
+
+	std::vector<uint32> *src = &indices;
+	std::vector<uint32> *dst = &scratch;
+
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		size_t histogram[256] = {};
+
+		for (uint32 key : keys)
+			histogram[(key >> shift) & 0xFF]++;
+
+		if (histogram[(keys[0] >> shift) & 0xFF] == count)
+			continue;
+
+		size_t offset = 0;
+		for (size_t &h : histogram)
+		{
+			size_t c = h;
+			h = offset;
+			offset += c;
+		}
+
+		for (uint32 index : *src)
+			(*dst)[histogram[(keys[index] >> shift) & 0xFF]++] = index;
+
+		std::swap(src, dst);
+	}
+
+	return *src;
+}
+
+Graphics::BatchedVertexData Graphics::requestSortedBatchedDraw(const BatchedDrawCommand &cmd)
+{
+	SortedBatchState &sorted = sortedBatchState;
+
+	SortedBatchState::Draw draw;
+	draw.command = cmd;
+
+	BatchedVertexData d = {};
+
+	for (int i = 0; i < 2; i++)
+	{
+		draw.vertexOffsets[i] = 0;
+
+		if (cmd.formats[i] == CommonFormat::NONE)
+			continue;
+
+		auto &data = sorted.vertexData[i];
+		draw.vertexOffsets[i] = data.size();
+		data.resize(data.size() + getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+		d.stream[i] = &data[draw.vertexOffsets[i]];
+	}
+
+	if (batchSortMode == BATCH_SORT_DEPTH)
+	{
+		// Keep textures alive until the flush. Runs of draws with the same
+		// texture only need one reference.
+		if (cmd.texture != nullptr && (sorted.depthTextures.empty() || sorted.depthTextures.back().get() != cmd.texture))
+			sorted.depthTextures.emplace_back(cmd.texture);
+
+		sorted.depthDraws.push_back(draw);
+		sorted.depthKeys.push_back(getSortableFloatBits(batchSortDepth));
+
+		return d;
+	}
+
+	auto matches = [&](const SortedBatchState::Group &g) -> bool
+	{
+		const BatchedDrawCommand &c = g.command;
+		return cmd.primitiveMode == c.primitiveMode
+			&& cmd.formats[0] == c.formats[0] && cmd.formats[1] == c.formats[1]
+			&& (cmd.indexMode != TRIANGLEINDEX_NONE) == (c.indexMode != TRIANGLEINDEX_NONE)
+			&& cmd.texture == c.texture
+			&& cmd.standardShaderType == c.standardShaderType;
+	};
+
+	int groupindex = -1;
+
+	// Consecutive draws usually share a group, so check the last one first.
+	if (sorted.lastGroup >= 0 && matches(sorted.groups[sorted.lastGroup]))
+		groupindex = sorted.lastGroup;
+	else
+	{
+		for (size_t i = 0; i < sorted.groups.size(); i++)
+		{
+			if (matches(sorted.groups[i]))
+			{
+				groupindex = (int) i;
+				break;
+			}
+		}
+	}
+
+	if (groupindex < 0)
+	{
+		SortedBatchState::Group group;
+		group.command = cmd;
+		group.texture.set(cmd.texture);
+		sorted.groups.push_back(std::move(group));
+		groupindex = (int) sorted.groups.size() - 1;
+	}
+
+	sorted.lastGroup = groupindex;
+
+	sorted.groups[groupindex].draws.push_back(draw);
+
+	return d;
+}
+
+void Graphics::flushSortedBatchedDraws()
+{
+	SortedBatchState &sorted = sortedBatchState;
+
+	if (sorted.groups.empty() && sorted.depthDraws.empty())
+		return;
+
+	// Take the buffered draws out first: the regular batching path below may
+	// flush recursively when its stream buffers fill up.
+	std::vector<SortedBatchState::Group> groups;
+	std::vector<SortedBatchState::Draw> depthdraws;
+	std::vector<uint32> depthkeys;
+	std::vector<StrongRef<Texture>> depthtextures;
+	std::vector<uint8> vertexdata[2];
+
+	std::swap(groups, sorted.groups);
+	std::swap(depthdraws, sorted.depthDraws);
+	std::swap(depthkeys, sorted.depthKeys);
+	std::swap(depthtextures, sorted.depthTextures);
+	std::swap(vertexdata[0], sorted.vertexData[0]);
+	std::swap(vertexdata[1], sorted.vertexData[1]);
+	sorted.lastGroup = -1;
+
+	BatchSortMode mode = batchSortMode;
+	batchSortMode = BATCH_SORT_NONE;
+
+	auto replay = [&](const SortedBatchState::Draw &draw)
+	{
+		BatchedVertexData data = requestBatchedDraw(draw.command);
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (draw.command.formats[i] == CommonFormat::NONE)
+				continue;
+
+			size_t size = getFormatStride(draw.command.formats[i]) * draw.command.vertexCount;
+			memcpy(data.stream[i], &vertexdata[i][draw.vertexOffsets[i]], size);
+		}
+	};
+
+	try
+	{
+		for (const SortedBatchState::Group &group : groups)
+		{
+			for (const SortedBatchState::Draw &draw : group.draws)
+				replay(draw);
+		}
+
+		if (!depthdraws.empty())
+		{
+			const auto &order = radixSortIndices(depthkeys, sorted.sortIndices[0], sorted.sortIndices[1]);
+
+			for (uint32 index : order)
+				replay(depthdraws[index]);
+		}
+	}
+	catch (love::Exception &)
+	{
+		batchSortMode = mode;
+		throw;
+	}
+
+	batchSortMode = mode;
+
+	// Keep the CPU-side allocations around for the next sorted batch.
+	for (int i = 0; i < 2; i++)
+	{
+		vertexdata[i].clear();
+		std::swap(vertexdata[i], sorted.vertexData[i]);
+	}
+
+	depthdraws.clear();
+	depthkeys.clear();
+	std::swap(depthdraws, sorted.depthDraws);
+	std::swap(depthkeys, sorted.depthKeys);
+}
+
+void Graphics::setBatchSortMode(BatchSortMode mode)
+{
+	if (mode == batchSortMode)
+		return;
+
+	flushBatchedDraws();
+	batchSortMode = mode;
+}
+
 void Graphics::flushBatchedDraws()
 {
+	LOVE_TRACE_ZONE("Graphics::flushBatchedDraws");
+
+	flushSortedBatchedDraws();
+	flushInstancedShapes();
+
 	auto &sbstate = batchedDrawState;
 
 	if (sbstate.vertexCount == 0 && sbstate.indexCount == 0)
@@ -1764,54 +4052,164 @@ void Graphics::flushBatchedDraws()
 		cmd.texture = sbstate.texture;
 		draw(cmd);
 	}
-
-	for (int i = 0; i < 2; i++)
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (usedsizes[i] > 0)
+			sbstate.vb[i]->markUsed(usedsizes[i]);
+	}
+
+	if (usedsizes[2] > 0)
+		sbstate.indexBuffer->markUsed(usedsizes[2]);
+
+	popTransform();
+
+	if (attributes.isEnabled(ATTRIB_COLOR))
+		setColor(nc);
+
+	batchedDrawState.vertexCount = 0;
+	batchedDrawState.indexCount = 0;
+}
+
+void Graphics::flushBatchedDrawsGlobal()
+{
+	Graphics *instance = getInstance<Graphics>(M_GRAPHICS);
+	if (instance != nullptr)
+		instance->flushBatchedDraws();
+}
+
+std::string Graphics::getCacheFilename(const std::string &directory, const std::string &key, const std::string &extension)
+{
+	data::HashFunction::Value hashvalue;
+	data::hash(data::HashFunction::FUNCTION_SHA1, key.c_str(), key.size(), hashvalue);
+
+	size_t hexlen = 0;
+	char *hex = data::encode(data::ENCODE_HEX, hashvalue.data, hashvalue.size, hexlen);
+
+	std::string filename = directory + "/" + std::string(hex, hexlen) + extension;
+	delete[] hex;
+
+	return filename;
+}
+
+bool Graphics::createCacheDirectory(const std::string &directory)
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs == nullptr)
+		return false;
+
+	try
+	{
+		return fs->createDirectory(directory.c_str());
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+}
+
+bool Graphics::saveCacheFile(const std::string &directory, const std::string &filename, const void *data, size_t size)
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs == nullptr || !createCacheDirectory(directory))
+		return false;
+
+	try
+	{
+		fs->write(filename.c_str(), data, (int64) size);
+		return true;
+	}
+	catch (love::Exception &)
 	{
-		if (usedsizes[i] > 0)
-			sbstate.vb[i]->markUsed(usedsizes[i]);
+		return false;
 	}
+}
 
-	if (usedsizes[2] > 0)
-		sbstate.indexBuffer->markUsed(usedsizes[2]);
+void Graphics::precompilePipeline(Shader * /*shader*/, const VertexAttributes & /*attributes*/, PrimitiveType /*primitive*/)
+{
+}
 
-	popTransform();
+int Graphics::getPrecompilingPipelineCount() const
+{
+	return 0;
+}
 
-	if (attributes.isEnabled(ATTRIB_COLOR))
-		setColor(nc);
+void Graphics::beginDrawListRecording(DrawList *drawlist)
+{
+	if (recordingDrawList != nullptr)
+		throw love::Exception("A DrawList is already being recorded.");
 
-	batchedDrawState.vertexCount = 0;
-	batchedDrawState.indexCount = 0;
+	flushBatchedDraws();
+
+	drawlist->beginRecording();
+	drawlist->retain();
+	recordingDrawList = drawlist;
 }
 
-void Graphics::flushBatchedDrawsGlobal()
+void Graphics::endDrawListRecording()
 {
-	Graphics *instance = getInstance<Graphics>(M_GRAPHICS);
-	if (instance != nullptr)
-		instance->flushBatchedDraws();
+	if (recordingDrawList == nullptr)
+		throw love::Exception("No DrawList is being recorded.");
+
+	// Takes ownership of the reference held by recordingDrawList.
+	StrongRef<DrawList> drawlist(recordingDrawList, Acquire::NORETAIN);
+	recordingDrawList = nullptr;
+
+	drawlist->endRecording();
 }
 
 /**
  * Drawing
  **/
 
+bool Graphics::isCulled(Drawable *drawable, const Matrix4 &m)
+{
+	float x, y, w, h;
+	if (!states.back().drawCulling || !drawable->getBounds(x, y, w, h))
+		return false;
+
+	if (isRectVisible(m, x, y, w, h))
+		return false;
+
+	drawsCulled++;
+	return true;
+}
+
+bool Graphics::isCulled(Quad *quad, const Matrix4 &m)
+{
+	if (!states.back().drawCulling)
+		return false;
+
+	Quad::Viewport v = quad->getViewport();
+	if (isRectVisible(m, 0.0f, 0.0f, (float) v.w, (float) v.h))
+		return false;
+
+	drawsCulled++;
+	return true;
+}
+
 void Graphics::draw(Drawable *drawable, const Matrix4 &m)
 {
-	drawable->draw(this, m);
+	if (!isCulled(drawable, m))
+		drawable->draw(this, m);
 }
 
 void Graphics::draw(Texture *texture, Quad *quad, const Matrix4 &m)
 {
-	texture->draw(this, quad, m);
+	if (!isCulled(quad, m))
+		texture->draw(this, quad, m);
 }
 
 void Graphics::drawLayer(Texture *texture, int layer, const Matrix4 &m)
 {
-	texture->drawLayer(this, layer, m);
+	if (!isCulled(texture, m))
+		texture->drawLayer(this, layer, m);
 }
 
 void Graphics::drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4 &m)
 {
-	texture->drawLayer(this, layer, quad, m);
+	if (!isCulled(quad, m))
+		texture->drawLayer(this, layer, quad, m);
 }
 
 void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
@@ -1819,6 +4217,34 @@ void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
 	mesh->drawInstanced(this, m, instancecount);
 }
 
+void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
+{
+	mesh->drawIndirect(this, m, indirectargs, argsindex, drawcount);
+}
+
+size_t Graphics::validateIndirectArgs(Buffer *indirectargs, int argsindex, int drawcount, bool indexed) const
+{
+	if (!capabilities.features[FEATURE_INDIRECT_DRAW])
+		throw love::Exception("Indirect draws are not supported on this system.");
+
+	if (!(indirectargs->getUsageFlags() & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS))
+		throw love::Exception("The Buffer used for indirect draw arguments must be created with the 'indirectarguments' buffer type.");
+
+	if (argsindex < 0)
+		throw love::Exception("The indirect draw arguments index must not be negative.");
+
+	if (drawcount < 0)
+		throw love::Exception("The indirect draw count must not be negative.");
+
+	size_t argssize = indexed ? sizeof(DrawIndexedIndirectArguments) : sizeof(DrawIndirectArguments);
+	size_t offset = argssize * (size_t) argsindex;
+
+	if (offset + argssize * (size_t) drawcount > indirectargs->getSize())
+		throw love::Exception("The indirect draw arguments index and draw count do not fit in the given Buffer.");
+
+	return offset;
+}
+
 void Graphics::drawShaderVertices(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture)
 {
 	if (primtype == PRIMITIVE_TRIANGLE_FAN && vertexcount > LOVE_UINT16_MAX)
@@ -1899,6 +4325,75 @@ void Graphics::drawShaderVertices(Buffer *indexbuffer, int indexcount, int insta
 	draw(cmd);
 }
 
+void Graphics::drawShaderVerticesIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture)
+{
+	if (primtype == PRIMITIVE_TRIANGLE_FAN && getFanIndexBuffer())
+		throw love::Exception("The 'fan' draw mode cannot be used with indirect draws on this system.");
+
+	flushBatchedDraws();
+
+	if (!capabilities.features[FEATURE_GLSL3])
+		throw love::Exception("drawShaderVerticesIndirect is not supported on this system (GLSL3 support is required.)");
+
+	if (Shader::isDefaultActive() || !Shader::current)
+		throw love::Exception("drawShaderVerticesIndirect can only be used with a custom shader.");
+
+	size_t argsoffset = validateIndirectArgs(indirectargs, argsindex, drawcount, false);
+
+	if (drawcount == 0)
+		return;
+
+	Shader::current->validateDrawState(primtype, maintexture);
+
+	VertexAttributes attributes;
+	BufferBindings buffers;
+
+	DrawCommand cmd(&attributes, &buffers);
+
+	cmd.primitiveType = primtype;
+	cmd.indirectBuffer = indirectargs;
+	cmd.indirectBufferOffset = argsoffset;
+	cmd.indirectDrawCount = drawcount;
+	cmd.texture = maintexture;
+
+	draw(cmd);
+}
+
+void Graphics::drawShaderVerticesIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture)
+{
+	flushBatchedDraws();
+
+	if (!capabilities.features[FEATURE_GLSL3])
+		throw love::Exception("drawShaderVerticesIndirect is not supported on this system (GLSL3 support is required.)");
+
+	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
+		throw love::Exception("The buffer passed to drawShaderVerticesIndirect must be an index buffer.");
+
+	if (Shader::isDefaultActive() || !Shader::current)
+		throw love::Exception("drawShaderVerticesIndirect can only be used with a custom shader.");
+
+	size_t argsoffset = validateIndirectArgs(indirectargs, argsindex, drawcount, true);
+
+	if (drawcount == 0)
+		return;
+
+	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
+
+	VertexAttributes attributes;
+	BufferBindings buffers;
+
+	DrawIndexedCommand cmd(&attributes, &buffers, indexbuffer);
+
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.indexType = getIndexDataType(indexbuffer->getDataMember(0).decl.format);
+	cmd.indirectBuffer = indirectargs;
+	cmd.indirectBufferOffset = argsoffset;
+	cmd.indirectDrawCount = drawcount;
+	cmd.texture = maintexture;
+
+	draw(cmd);
+}
+
 void Graphics::print(const std::vector<love::font::ColoredString> &str, const Matrix4 &m)
 {
 	checkSetDefaultFont();
@@ -1987,13 +4482,18 @@ int Graphics::calculateEllipsePoints(float rx, float ry) const
 	return std::max(points, 8);
 }
 
+float Graphics::getPixelSize() const
+{
+	return 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+}
+
 void Graphics::polyline(const Vector2 *vertices, size_t count)
 {
 	float halfwidth = getLineWidth() * 0.5f;
 	LineJoin linejoin = getLineJoin();
 	LineStyle linestyle = getLineStyle();
 
-	float pixelsize = 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+	float pixelsize = getPixelSize();
 
 	if (linejoin == LINE_JOIN_NONE)
 	{
@@ -2100,6 +4600,10 @@ void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b, int po
 {
 	float two_pi = (float) (LOVE_M_PI * 2);
 	if (points <= 0) points = 1;
+
+	if (mode == DRAW_FILL && addInstancedShape(x, y, a, b, 0.0f, two_pi, points, false))
+		return;
+
 	float angle_shift = (two_pi / points);
 	float phi = .0f;
 
@@ -2163,6 +4667,9 @@ void Graphics::arc(DrawMode drawmode, ArcMode arcmode, float x, float y, float r
 	if (drawmode == DRAW_FILL && arcmode == ARC_OPEN)
 		arcmode = ARC_CLOSED;
 
+	if (drawmode == DRAW_FILL && addInstancedShape(x, y, radius, radius, angle1, angle2, points, arcmode != ARC_PIE))
+		return;
+
 	float phi = angle1;
 
 	Vector2 *coords = nullptr;
@@ -2219,6 +4726,195 @@ void Graphics::arc(DrawMode drawmode, ArcMode arcmode, float x, float y, float r
 	arc(drawmode, arcmode, x, y, radius, angle1, angle2, (int) (points + 0.5f));
 }
 
+bool Graphics::addInstancedShape(float x, float y, float rx, float ry, float angle1, float angle2, int segments, bool chord)
+{
+	if (segments <= 0 || segments > MAX_INSTANCED_SHAPE_SEGMENTS)
+		return false;
+
+	if (recordingDrawList != nullptr || batchSortMode != BATCH_SORT_NONE || !capabilities.features[FEATURE_INSTANCING])
+		return false;
+
+	// Custom shaders don't know about the per-instance attributes.
+	if (Shader::standardShaders[Shader::STANDARD_SHAPES] == nullptr || !Shader::isDefaultActive())
+		return false;
+
+	const Matrix4 &t = getTransform();
+	if (!t.isAffine2DTransform())
+		return false;
+
+	const float *e = t.getElements();
+
+	ShapeInstance s;
+	s.transform[0] = e[0];
+	s.transform[1] = e[1];
+	s.transform[2] = e[4];
+	s.transform[3] = e[5];
+	s.offset[0] = e[0] * x + e[4] * y + e[12];
+	s.offset[1] = e[1] * x + e[5] * y + e[13];
+	s.radii[0] = rx;
+	s.radii[1] = ry;
+	s.angles[0] = angle1;
+	s.angles[1] = angle2;
+	s.segments = (float) segments;
+	s.chord = chord ? 1.0f : 0.0f;
+	s.color = toColor32(getColor());
+
+	instancedShapeState.pending.push_back(s);
+	return true;
+}
+
+static int getInstancedShapeSegmentBucket(float segments)
+{
+	int bucket = 8;
+	while ((float) bucket < segments)
+		bucket *= 2;
+	return bucket;
+}
+
+void Graphics::flushInstancedShapes()
+{
+	InstancedShapeState &state = instancedShapeState;
+
+	if (state.pending.empty())
+		return;
+
+	// Anything drawn while flushing (including the flushBatchedDraws call
+	// below) shouldn't see these shapes again.
+	std::vector<ShapeInstance> &shapes = state.flushing;
+	shapes.swap(state.pending);
+
+	Shader *shader = Shader::standardShaders[Shader::STANDARD_SHAPES];
+
+	int transformindex = shader->getVertexAttributeIndex("ShapeTransform");
+	int offsetradiiindex = shader->getVertexAttributeIndex("ShapeOffsetRadii");
+	int anglesindex = shader->getVertexAttributeIndex("ShapeAngles");
+
+	if (shapes.size() < (size_t) MIN_INSTANCED_SHAPES || !Shader::isDefaultActive()
+		|| transformindex < 0 || offsetradiiindex < 0 || anglesindex < 0)
+	{
+		drawInstancedShapesBatched(shapes.data(), shapes.size());
+		shapes.clear();
+		return;
+	}
+
+	// Shapes are always drawn after anything that was batched before them.
+	flushBatchedDraws();
+
+	if (state.vertexBuffer == nullptr)
+	{
+		float indices[MAX_INSTANCED_SHAPE_SEGMENTS + 2];
+		for (int i = 0; i < MAX_INSTANCED_SHAPE_SEGMENTS + 2; i++)
+			indices[i] = (float) i;
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		state.vertexBuffer = newBuffer(settings, DATAFORMAT_FLOAT, indices, sizeof(indices), 0);
+	}
+
+	createFanIndexBuffer();
+
+	Shader::attachDefault(Shader::STANDARD_SHAPES);
+	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, nullptr);
+
+	VertexAttributes attributes;
+	attributes.set(ATTRIB_POS, DATAFORMAT_FLOAT, 0, 0);
+	attributes.setBufferLayout(0, sizeof(float));
+	attributes.set(transformindex, DATAFORMAT_FLOAT_VEC4, offsetof(ShapeInstance, transform), 1);
+	attributes.set(offsetradiiindex, DATAFORMAT_FLOAT_VEC4, offsetof(ShapeInstance, offset), 1);
+	attributes.set(anglesindex, DATAFORMAT_FLOAT_VEC4, offsetof(ShapeInstance, angles), 1);
+	attributes.set(ATTRIB_COLOR, DATAFORMAT_UNORM8_VEC4, offsetof(ShapeInstance, color), 1);
+	attributes.setBufferLayout(1, sizeof(ShapeInstance), STEP_PER_INSTANCE);
+
+	Colorf nc = getColor();
+	setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+
+	pushIdentityTransform();
+
+	// The batched draw vertex streams are unused after the flush above, so
+	// the instance data can go in one of them.
+	StreamBuffer *instancebuffer = batchedDrawState.vb[1];
+	size_t maxinstances = std::max(instancebuffer->getSize() / sizeof(ShapeInstance), (size_t) 1);
+
+	for (size_t start = 0; start < shapes.size();)
+	{
+		// Consecutive shapes with a similar number of segments share a draw,
+		// the unused vertices of each fan collapse to degenerate triangles.
+		int bucket = getInstancedShapeSegmentBucket(shapes[start].segments);
+
+		size_t end = start + 1;
+		while (end < shapes.size() && end - start < maxinstances
+			&& getInstancedShapeSegmentBucket(shapes[end].segments) == bucket)
+		{
+			end++;
+		}
+
+		size_t size = (end - start) * sizeof(ShapeInstance);
+
+		StreamBuffer::MapInfo map = instancebuffer->map(size);
+		memcpy(map.data, &shapes[start], size);
+		size_t offset = instancebuffer->unmap(size);
+
+		BufferBindings buffers;
+		buffers.set(0, state.vertexBuffer, 0);
+		buffers.set(1, instancebuffer, offset);
+
+		DrawIndexedCommand cmd(&attributes, &buffers, fanIndexBuffer);
+		cmd.primitiveType = PRIMITIVE_TRIANGLES;
+		cmd.indexCount = getIndexCount(TRIANGLEINDEX_FAN, bucket + 2);
+		cmd.instanceCount = (int) (end - start);
+		cmd.indexType = INDEX_UINT16;
+		draw(cmd);
+
+		instancebuffer->markUsed(size);
+
+		start = end;
+	}
+
+	popTransform();
+
+	setColor(nc);
+
+	shapes.clear();
+}
+
+void Graphics::drawInstancedShapesBatched(const ShapeInstance *shapes, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const ShapeInstance &s = shapes[i];
+		int segments = (int) s.segments;
+
+		BatchedDrawCommand cmd;
+		cmd.formats[0] = CommonFormat::XYf;
+		cmd.formats[1] = CommonFormat::RGBAub;
+		cmd.indexMode = TRIANGLEINDEX_FAN;
+		cmd.vertexCount = segments + 2;
+
+		BatchedVertexData data = requestBatchedDraw(cmd);
+
+		Vector2 *positions = (Vector2 *) data.stream[0];
+		Color32 *colors = (Color32 *) data.stream[1];
+
+		float angleshift = (s.angles[1] - s.angles[0]) / (float) segments;
+
+		for (int v = 0; v < cmd.vertexCount; v++)
+		{
+			float px = 0.0f;
+			float py = 0.0f;
+
+			if (v > 0 || s.chord > 0.0f)
+			{
+				float phi = s.angles[0] + angleshift * (float) std::max(v - 1, 0);
+				px = s.radii[0] * cosf(phi);
+				py = s.radii[1] * sinf(phi);
+			}
+
+			positions[v].x = s.transform[0] * px + s.transform[2] * py + s.offset[0];
+			positions[v].y = s.transform[1] * px + s.transform[3] * py + s.offset[1];
+			colors[v] = s.color;
+		}
+	}
+}
+
 void Graphics::polygon(DrawMode mode, const Vector2 *coords, size_t count, bool skipLastFilledVertex)
 {
 	// coords is an array of a closed loop of vertices, i.e.
@@ -2261,18 +4957,53 @@ Graphics::Stats Graphics::getStats() const
 {
 	Stats stats;
 
-	getAPIStats(stats.shaderSwitches);
+	stats.shaderSwitches = 0;
+	stats.pipelineCreations = 0;
+	stats.samplerCreations = 0;
+	stats.descriptorWrites = 0;
+	stats.stateCalls = 0;
+	stats.stateCallsSkipped = 0;
+	stats.gpuMemoryReserved = 0;
+	stats.gpuMemoryUnused = 0;
+	stats.gpuMemoryFreeRanges = 0;
+	stats.gpuMemoryLargestFreeRange = 0;
+
+	getAPIStats(stats);
 
 	stats.drawCalls = drawCalls;
 	if (batchedDrawState.vertexCount > 0)
 		stats.drawCalls++;
+	if (!instancedShapeState.pending.empty())
+		stats.drawCalls++;
 
 	stats.renderTargetSwitches = renderTargetSwitchCount;
 	stats.drawCallsBatched = drawCallsBatched;
 	stats.textures = Texture::textureCount;
 	stats.fonts = Font::fontCount;
 	stats.textureMemory = Texture::totalGraphicsMemory;
-	
+	stats.buffers = Buffer::bufferCount;
+	stats.bufferMemory = Buffer::totalGraphicsMemory;
+	stats.streamBufferBytes = StreamBuffer::frameBytesUsed;
+	stats.streamBufferStalls = StreamBuffer::frameStalls;
+	stats.gpuFrameTime = gpuFrameTime;
+	stats.streamedTextureData = streamedTextureData;
+
+	Object::getRefCountStats(stats.objectRetains, stats.objectReleases);
+
+	stats.drawsCulled = drawsCulled;
+
+	stats.gpuMemoryUsage = 0;
+	stats.gpuMemoryBudget = 0;
+
+	for (const MemoryHeap &heap : getMemoryHeaps())
+	{
+		if (!heap.deviceLocal)
+			continue;
+
+		stats.gpuMemoryUsage += heap.usage;
+		stats.gpuMemoryBudget += heap.budget;
+	}
+
 	return stats;
 }
 
@@ -2323,7 +5054,17 @@ void Graphics::pop()
 
 const Matrix4 &Graphics::getTransform() const
 {
-	return transformStack.back();
+	const TransformEntry &t = transformStack.back();
+	if (t.full)
+		return fullTransformStack.back();
+
+	if (currentTransformDirty)
+	{
+		currentTransform.setRawTransformation(t.a, t.b, t.c, t.d, t.x, t.y);
+		currentTransformDirty = false;
+	}
+
+	return currentTransform;
 }
 
 const Matrix4 &Graphics::getDeviceProjection() const
@@ -2333,69 +5074,187 @@ const Matrix4 &Graphics::getDeviceProjection() const
 
 void Graphics::pushTransform()
 {
-	transformStack.push_back(transformStack.back());
+	TransformEntry t = transformStack.back();
+	if (t.full)
+		fullTransformStack.push_back(fullTransformStack.back());
+	transformStack.push_back(t);
 }
 
 void Graphics::pushIdentityTransform()
 {
-	transformStack.push_back(Matrix4());
+	transformStack.push_back({1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, false});
+	currentTransformDirty = true;
 }
 
 void Graphics::popTransform()
 {
+	if (transformStack.back().full)
+		fullTransformStack.pop_back();
 	transformStack.pop_back();
+	currentTransformDirty = true;
+}
+
+static bool isAffine2D(const Matrix4 &m)
+{
+	const float *e = m.getElements();
+	return e[2] == 0.0f && e[3] == 0.0f && e[6] == 0.0f && e[7] == 0.0f
+		&& e[8] == 0.0f && e[9] == 0.0f && e[10] == 1.0f && e[11] == 0.0f
+		&& e[14] == 0.0f && e[15] == 1.0f;
+}
+
+void Graphics::promoteTransform()
+{
+	TransformEntry &t = transformStack.back();
+	if (!t.full)
+	{
+		fullTransformStack.push_back(Matrix4(t.a, t.b, t.c, t.d, t.x, t.y));
+		t.full = true;
+	}
+}
+
+void Graphics::multiplyTransform(const Matrix4 &m)
+{
+	TransformEntry &t = transformStack.back();
+
+	if (t.full || !isAffine2D(m))
+	{
+		promoteTransform();
+		fullTransformStack.back() *= m;
+		return;
+	}
+
+	const float *e = m.getElements();
+	TransformEntry r = t;
+
+	r.a = t.a * e[0] + t.c * e[1];
+	r.b = t.b * e[0] + t.d * e[1];
+	r.c = t.a * e[4] + t.c * e[5];
+	r.d = t.b * e[4] + t.d * e[5];
+	r.x = t.a * e[12] + t.c * e[13] + t.x;
+	r.y = t.b * e[12] + t.d * e[13] + t.y;
+
+	t = r;
+	currentTransformDirty = true;
+}
+
+void Graphics::updatePixelScale()
+{
+	float sx, sy;
+	getTransform().getApproximateScale(sx, sy);
+	pixelScaleStack.back() = (sx + sy) / 2.0;
 }
 
 void Graphics::rotate(float r)
 {
-	transformStack.back().rotate(r);
+	TransformEntry &t = transformStack.back();
+	if (t.full)
+	{
+		fullTransformStack.back().rotate(r);
+		return;
+	}
+
+	float co = cosf(r);
+	float si = sinf(r);
+	float a = t.a, b = t.b;
+
+	t.a = a * co + t.c * si;
+	t.b = b * co + t.d * si;
+	t.c = t.c * co - a * si;
+	t.d = t.d * co - b * si;
+	currentTransformDirty = true;
 }
 
 void Graphics::scale(float x, float y)
 {
-	transformStack.back().scale(x, y);
+	TransformEntry &t = transformStack.back();
+	if (t.full)
+		fullTransformStack.back().scale(x, y);
+	else
+	{
+		t.a *= x;
+		t.b *= x;
+		t.c *= y;
+		t.d *= y;
+		currentTransformDirty = true;
+	}
+
 	pixelScaleStack.back() *= (fabs(x) + fabs(y)) / 2.0;
 }
 
 void Graphics::translate(float x, float y)
 {
-	transformStack.back().translate(x, y);
+	TransformEntry &t = transformStack.back();
+	if (t.full)
+	{
+		fullTransformStack.back().translate(x, y);
+		return;
+	}
+
+	t.x += t.a * x + t.c * y;
+	t.y += t.b * x + t.d * y;
+	currentTransformDirty = true;
 }
 
 void Graphics::shear(float kx, float ky)
 {
-	transformStack.back().shear(kx, ky);
+	TransformEntry &t = transformStack.back();
+	if (t.full)
+	{
+		fullTransformStack.back().shear(kx, ky);
+		return;
+	}
+
+	float a = t.a, b = t.b;
+
+	t.a = a + t.c * ky;
+	t.b = b + t.d * ky;
+	t.c = a * kx + t.c;
+	t.d = b * kx + t.d;
+	currentTransformDirty = true;
 }
 
 void Graphics::origin()
 {
-	transformStack.back().setIdentity();
+	if (transformStack.back().full)
+		fullTransformStack.pop_back();
+
+	transformStack.back() = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, false};
+	currentTransformDirty = true;
 	pixelScaleStack.back() = 1;
 }
 
 void Graphics::applyTransform(const Matrix4 &m)
 {
-	Matrix4 &current = transformStack.back();
-	current *= m;
-
-	float sx, sy;
-	current.getApproximateScale(sx, sy);
-	pixelScaleStack.back() = (sx + sy) / 2.0;
+	multiplyTransform(m);
+	updatePixelScale();
 }
 
 void Graphics::replaceTransform(const Matrix4 &m)
 {
-	transformStack.back() = m;
+	TransformEntry &t = transformStack.back();
 
-	float sx, sy;
-	m.getApproximateScale(sx, sy);
-	pixelScaleStack.back() = (sx + sy) / 2.0;
+	if (isAffine2D(m))
+	{
+		if (t.full)
+			fullTransformStack.pop_back();
+
+		const float *e = m.getElements();
+		t = {e[0], e[1], e[4], e[5], e[12], e[13], false};
+		currentTransformDirty = true;
+	}
+	else
+	{
+		promoteTransform();
+		fullTransformStack.back() = m;
+	}
+
+	updatePixelScale();
 }
 
 Vector2 Graphics::transformPoint(Vector2 point)
 {
 	Vector2 p;
-	transformStack.back().transformXY(&p, &point, 1);
+	getTransform().transformXY(&p, &point, 1);
 	return p;
 }
 
@@ -2404,7 +5263,7 @@ Vector2 Graphics::inverseTransformPoint(Vector2 point)
 	Vector2 p;
 	// TODO: We should probably cache the inverse transform so we don't have to
 	// re-calculate it every time this is called.
-	transformStack.back().inverse().transformXY(&p, &point, 1);
+	getTransform().inverse().transformXY(&p, &point, 1);
 	return p;
 }
 
@@ -2532,6 +5391,11 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, f
 	{ "copybuffertotexture",      Graphics::FEATURE_COPY_BUFFER_TO_TEXTURE },
 	{ "copytexturetobuffer",      Graphics::FEATURE_COPY_TEXTURE_TO_BUFFER },
 	{ "copyrendertargettobuffer", Graphics::FEATURE_COPY_RENDER_TARGET_TO_BUFFER },
+	{ "timerquery",               Graphics::FEATURE_TIMER_QUERY          },
+	{ "asynccompute",             Graphics::FEATURE_ASYNC_COMPUTE        },
+	{ "indirectdraw",             Graphics::FEATURE_INDIRECT_DRAW        },
+	{ "occlusionquery",           Graphics::FEATURE_OCCLUSION_QUERY      },
+	{ "conditionalrender",        Graphics::FEATURE_CONDITIONAL_RENDER   },
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, feature)
 
@@ -2560,6 +5424,14 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, s
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, stackType)
 
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::BatchSortMode, Graphics::BATCH_SORT_MAX_ENUM, batchSortMode)
+{
+	{ "none",  Graphics::BATCH_SORT_NONE  },
+	{ "state", Graphics::BATCH_SORT_STATE },
+	{ "depth", Graphics::BATCH_SORT_DEPTH },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::BatchSortMode, Graphics::BATCH_SORT_MAX_ENUM, batchSortMode)
+
 STRINGMAP_BEGIN(Renderer, RENDERER_MAX_ENUM, renderer)
 {
 	{ "opengl", RENDERER_OPENGL },
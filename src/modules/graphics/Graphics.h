@@ -38,6 +38,12 @@
 #include "Quad.h"
 #include "Mesh.h"
 #include "GraphicsReadback.h"
+#include "PendingShader.h"
+#include "ScreenshotEncoder.h"
+#include "VirtualTexture.h"
+#include "TimerQuery.h"
+#include "OcclusionQuery.h"
+#include "TileMap.h"
 #include "Deprecations.h"
 #include "renderstate.h"
 #include "math/Transform.h"
@@ -58,14 +64,20 @@ namespace graphics
 
 class SpriteBatch;
 class ParticleSystem;
+class Line;
 class TextBatch;
 class Video;
 class Buffer;
+class DrawList;
+class ReadbackRing;
 
 typedef Optional<ColorD> OptionalColorD;
 
 const int MAX_COLOR_RENDER_TARGETS = 8;
 
+// The most frames the CPU can queue ahead of the GPU.
+const int MAX_FRAMES_IN_FLIGHT = 3;
+
 enum Renderer
 {
 	RENDERER_NONE,
@@ -111,6 +123,9 @@ void setRenderers(const std::vector<Renderer> &renderers);
 
 class Graphics : public Module
 {
+	friend class PendingShader;
+	friend class OcclusionQuery;
+
 public:
 
 	static love::Type type;
@@ -164,6 +179,11 @@ public:
 		FEATURE_COPY_BUFFER_TO_TEXTURE,
 		FEATURE_COPY_TEXTURE_TO_BUFFER,
 		FEATURE_COPY_RENDER_TARGET_TO_BUFFER,
+		FEATURE_TIMER_QUERY,
+		FEATURE_ASYNC_COMPUTE,
+		FEATURE_INDIRECT_DRAW,
+		FEATURE_OCCLUSION_QUERY,
+		FEATURE_CONDITIONAL_RENDER,
 		FEATURE_MAX_ENUM
 	};
 
@@ -192,12 +212,28 @@ public:
 		STACK_MAX_ENUM
 	};
 
+	enum BatchSortMode
+	{
+		BATCH_SORT_NONE,
+		BATCH_SORT_STATE,
+		BATCH_SORT_DEPTH,
+		BATCH_SORT_MAX_ENUM
+	};
+
 	enum TemporaryRenderTargetFlags
 	{
 		TEMPORARY_RT_DEPTH   = (1 << 0),
 		TEMPORARY_RT_STENCIL = (1 << 1),
 	};
 
+	// Hints for how the contents of render targets are loaded at the start of
+	// their render pass and stored at the end of it.
+	enum RenderPassFlags
+	{
+		RENDER_PASS_DISCARD_ON_BEGIN         = (1 << 0),
+		RENDER_PASS_DONT_STORE_DEPTH_STENCIL = (1 << 1),
+	};
+
 	struct Capabilities
 	{
 		double limits[LIMIT_MAX_ENUM];
@@ -222,6 +258,33 @@ public:
 		int textures;
 		int fonts;
 		int64 textureMemory;
+		int buffers;
+		int64 bufferMemory;
+		int64 streamBufferBytes;
+		int streamBufferStalls;
+		int pipelineCreations;
+		int samplerCreations;
+		int descriptorWrites;
+		int stateCalls;
+		int stateCallsSkipped;
+		double gpuFrameTime;
+		int64 streamedTextureData;
+		int64 gpuMemoryUsage;
+		int64 gpuMemoryBudget;
+		int64 gpuMemoryReserved;
+		int64 gpuMemoryUnused;
+		int gpuMemoryFreeRanges;
+		int64 gpuMemoryLargestFreeRange;
+		int64 objectRetains;
+		int64 objectReleases;
+		int drawsCulled;
+	};
+
+	struct MemoryHeap
+	{
+		int64 usage;
+		int64 budget;
+		bool deviceLocal;
 	};
 
 	struct DrawCommand
@@ -235,6 +298,12 @@ public:
 		int vertexCount = 0;
 		int instanceCount = 1;
 
+		// When set, the vertex and instance counts come from consecutive
+		// DrawIndirectArguments structs in this buffer instead.
+		Resource *indirectBuffer = nullptr;
+		size_t indirectBufferOffset = 0;
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -260,6 +329,12 @@ public:
 		Resource *indexBuffer;
 		size_t indexBufferOffset = 0;
 
+		// When set, the index and instance counts come from consecutive
+		// DrawIndexedIndirectArguments structs in this buffer instead.
+		Resource *indirectBuffer = nullptr;
+		size_t indirectBufferOffset = 0;
+		int indirectDrawCount = 1;
+
 		Texture *texture = nullptr;
 
 		// TODO: This should be moved out to a state transition API?
@@ -272,6 +347,26 @@ public:
 		{}
 	};
 
+	// The layout of the draw arguments in an 'indirectarguments' Buffer. They
+	// match what glDrawArraysIndirect, vkCmdDrawIndirect and Metal's indirect
+	// draws all expect.
+	struct DrawIndirectArguments
+	{
+		uint32 vertexCount;
+		uint32 instanceCount;
+		uint32 firstVertex;
+		uint32 firstInstance;
+	};
+
+	struct DrawIndexedIndirectArguments
+	{
+		uint32 indexCount;
+		uint32 instanceCount;
+		uint32 firstIndex;
+		int32 baseVertex;
+		uint32 firstInstance;
+	};
+
 	struct BatchedDrawCommand
 	{
 		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
@@ -307,7 +402,7 @@ public:
 			: gfx(gfx)
 		{
 			gfx->pushTransform();
-			gfx->transformStack.back() *= t;
+			gfx->multiplyTransform(t);
 		}
 
 		~TempTransform()
@@ -387,10 +482,12 @@ public:
 		std::vector<RenderTarget> colors;
 		RenderTarget depthStencil;
 		uint32 temporaryRTFlags;
+		uint32 passFlags;
 
 		RenderTargets()
 			: depthStencil(nullptr)
 			, temporaryRTFlags(0)
+			, passFlags(0)
 		{}
 
 		const RenderTarget &getFirstTarget() const
@@ -413,6 +510,9 @@ public:
 			if (depthStencil != other.depthStencil || temporaryRTFlags != other.temporaryRTFlags)
 				return false;
 
+			if (passFlags != other.passFlags)
+				return false;
+
 			return true;
 		}
 	};
@@ -422,10 +522,12 @@ public:
 		std::vector<RenderTargetStrongRef> colors;
 		RenderTargetStrongRef depthStencil;
 		uint32 temporaryRTFlags;
+		uint32 passFlags; // Never includes RENDER_PASS_DISCARD_ON_BEGIN.
 
 		RenderTargetsStrongRef()
 			: depthStencil(nullptr)
 			, temporaryRTFlags(0)
+			, passFlags(0)
 		{}
 
 		const RenderTargetStrongRef &getFirstTarget() const
@@ -442,32 +544,104 @@ public:
 
 	virtual Texture *newTexture(const Texture::Settings &settings, const Texture::Slices *data = nullptr) = 0;
 
+	/**
+	 * Creates a texture whose data is uploaded over the next few frames rather
+	 * than immediately. Texture::isReady returns true once it's done. Falls
+	 * back to newTexture for data which can't be uploaded that way.
+	 **/
+	Texture *newTextureAsync(const Texture::Settings &settings, const Texture::Slices *slices);
+
+	/**
+	 * Sets the maximum amount of mipmap data of streaming textures that's
+	 * uploaded and available for sampling. The highest mipmap levels of the
+	 * least recently drawn streaming textures stop being sampled when it's
+	 * exceeded, and are uploaded again once they're needed. A negative value
+	 * means there's no limit.
+	 *
+	 * This limits upload bandwidth and the sampled working set, not GPU memory:
+	 * backends still allocate storage for every mipmap of a streaming texture.
+	 **/
+	void setTextureStreamingBudget(int64 bytes);
+	int64 getTextureStreamingBudget() const { return textureStreamingBudget; }
+
+	// Incremented once per frame, used to track when streaming textures were
+	// last drawn.
+	uint64 getTextureStreamingFrame() const { return textureStreamingFrame; }
+
+	/**
+	 * Copies the texture's contents into a free layer of an array texture
+	 * shared with other compatible textures. Draws of the texture which use the
+	 * default shader are redirected to that layer, so they can be batched with
+	 * draws of the other textures in the array. Does nothing if the texture
+	 * can't be placed in an array.
+	 **/
+	void addToSharedArrayTexture(Texture *texture, const Texture::Slices *slices);
+	void removeFromSharedArrayTexture(Texture *array, int layer);
+
 	Quad *newQuad(Quad::Viewport v, double sw, double sh);
 	Font *newFont(love::font::Rasterizer *data);
 	Font *newDefaultFont(int size, font::TrueTypeRasterizer::Hinting hinting);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage);
-	ParticleSystem *newParticleSystem(Texture *texture, int size);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced);
+	TileMap *newTileMap(Texture *texture, int tilewidth, int tileheight, int width, int height, const TileMap::Settings &settings);
+	ParticleSystem *newParticleSystem(Texture *texture, int size, bool gpu);
+	Line *newLine(const Vector2 *points, size_t count, bool gpuExpanded);
 
 	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
 	Shader *newComputeShader(const std::string &source, const Shader::CompileOptions &options);
 
+	/**
+	 * Gets a variant of the Shader compiled from the same code, with the given
+	 * defines added to (or replacing) the ones it was created with. Variants
+	 * are compiled the first time they're requested and cached afterwards. The
+	 * returned Shader is owned by the given one.
+	 **/
+	Shader *getShaderVariant(Shader *shader, const std::map<std::string, std::string> &defines);
+
+	/**
+	 * Preprocesses, validates and compiles shader code ahead of time, for
+	 * every Shader::CodeVariant it can be used with. The returned data can be
+	 * passed to newShader or newComputeShader in place of the source code, and
+	 * doesn't need a window to be created.
+	 **/
+	std::string compileShaderBundle(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
+
+	/**
+	 * Like newShader and newComputeShader, but the code is compiled on worker
+	 * threads. The returned PendingShader is checked or waited on to get the
+	 * Shader once it's done.
+	 **/
+	PendingShader *newShaderAsync(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
+	PendingShader *newComputeShaderAsync(const std::string &source, const Shader::CompileOptions &options);
+
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) = 0;
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, DataFormat format, const void *data, size_t size, size_t arraylength);
 
 	Mesh *newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, int vertexcount, PrimitiveType drawmode, BufferDataUsage usage);
 	Mesh *newMesh(const std::vector<Buffer::DataDeclaration> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, BufferDataUsage usage);
 	Mesh *newMesh(const std::vector<Mesh::BufferAttribute> &attributes, PrimitiveType drawmode);
+	Mesh *newMesh(BufferArena *arena, const void *data, size_t vertexcount, PrimitiveType drawmode);
+
+	BufferArena *newBufferArena(const std::vector<Buffer::DataDeclaration> &vertexformat, size_t pagelength, BufferDataUsage usage);
 
 	TextBatch *newTextBatch(Font *font, const std::vector<love::font::ColoredString> &text = {});
 
+	DrawList *newDrawList();
+
+	virtual TimerQuery *newTimerQuery() = 0;
+	virtual OcclusionQuery *newOcclusionQuery(bool precise) = 0;
+
 	data::ByteData *readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 	GraphicsReadback *readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 
 	image::ImageData *readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 	GraphicsReadback *readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 
+	ReadbackRing *newReadbackRing(int slotcount);
+
+	VirtualTexture *newVirtualTexture(const VirtualTexture::Settings &settings);
+
 	bool validateShader(bool gles, const std::vector<std::string> &stages, const Shader::CompileOptions &options, std::string &err);
 
 	/**
@@ -533,6 +707,16 @@ public:
 	virtual int getRequestedBackbufferMSAA() const = 0;
 	virtual int getBackbufferMSAA() const = 0;
 
+	/**
+	 * Sets how many frames the CPU can get ahead of the GPU before present
+	 * waits, from 1 to MAX_FRAMES_IN_FLIGHT. In low latency mode present also
+	 * waits for earlier frames to be displayed (where the backend can tell),
+	 * so input is read as late as possible for the next frame.
+	 **/
+	void setFrameLatency(int framesinflight, bool lowlatency);
+	int getFramesInFlight() const { return framesInFlight; }
+	bool isLowLatency() const { return lowLatency; }
+
 	Buffer *getQuadIndexBuffer() const { return quadIndexBuffer; }
 	Buffer *getFanIndexBuffer() const { return fanIndexBuffer; }
 
@@ -604,6 +788,30 @@ public:
 	void setMeshCullMode(CullMode cull);
 	CullMode getMeshCullMode() const;
 
+	/**
+	 * Sets whether draws of Drawables with known bounds are skipped on the CPU
+	 * when they're entirely outside the viewport or scissor rectangle.
+	 * Vertex shaders which move vertices outside of the bounds aren't
+	 * accounted for, so this is disabled by default.
+	 **/
+	void setDrawCulling(bool enable);
+	bool isDrawCullingEnabled() const;
+
+	/**
+	 * Draws until endConditionalRender are skipped by the GPU if no samples
+	 * passed in the query's most recent start/stop pair. Unlike reading the
+	 * query's result, this never waits on the CPU.
+	 **/
+	void beginConditionalRender(OcclusionQuery *query);
+	void endConditionalRender();
+	OcclusionQuery *getConditionalRenderQuery() const;
+
+	/**
+	 * Gets whether any part of the given local-space rectangle may be visible
+	 * after being transformed by m and the current transform.
+	 **/
+	bool isRectVisible(const Matrix4 &m, float x, float y, float w, float h) const;
+
 	virtual void setFrontFaceWinding(Winding winding) = 0;
 	Winding getFrontFaceWinding() const;
 
@@ -659,6 +867,12 @@ public:
 	void setLineJoin(LineJoin style);
 	LineJoin getLineJoin() const;
 
+	/**
+	 * Gets the size of a pixel in the current coordinate system, which smooth
+	 * lines are faded out over.
+	 **/
+	float getPixelSize() const;
+
 	/**
 	 * Sets the size of points.
 	 **/
@@ -684,21 +898,79 @@ public:
 
 	void captureScreenshot(const ScreenshotInfo &info);
 
+	/**
+	 * Encodes the ImageData and writes it to a file on a background thread.
+	 **/
+	void saveScreenshotAsync(image::ImageData *data, image::FormatHandler::EncodedFormat format, const std::string &filename);
+
 	void copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size);
 	void copyTextureToBuffer(Texture *source, Buffer *dest, int slice, int mipmap, const Rect &rect, size_t destoffset, int destwidth);
 	void copyBufferToTexture(Buffer *source, Texture *dest, size_t sourceoffset, int sourcewidth, int slice, int mipmap, const Rect &rect);
 
+	/**
+	 * Generates the mipmaps of a 2D or array Texture with a compute shader,
+	 * which works with formats the backend can't generate mipmaps for (such
+	 * as integer formats) and filters sRGB textures in linear space.
+	 **/
+	bool isComputeMipmapsSupported(const Texture *texture, const char *&outReason) const;
+	void generateMipmapsCompute(Texture *texture);
+
+	/**
+	 * Shaders used to update and draw GPU ParticleSystems. They're created the
+	 * first time they're needed.
+	 **/
+	Shader *getParticleComputeShader();
+	Shader *getParticleRenderShader();
+
+	/**
+	 * Shader used to draw Lines whose segments are expanded on the GPU.
+	 **/
+	Shader *getLineShader();
+
 	void dispatchThreadgroups(Shader* shader, int x, int y, int z);
 
+	/**
+	 * Dispatches a compute shader on a separate compute queue when the backend
+	 * has one (FEATURE_ASYNC_COMPUTE), so it can run alongside rendering. The
+	 * work is submitted at the end of the frame and starts after the rest of
+	 * the frame's GPU work. Returns a fence value for isComputeFenceComplete
+	 * and waitComputeFence. Without an async compute queue the shader is
+	 * dispatched in-line and 0 is returned.
+	 **/
+	uint64 dispatchThreadgroupsAsync(Shader* shader, int x, int y, int z);
+
+	/**
+	 * Returns whether the async compute work with the given fence value has
+	 * finished executing on the GPU.
+	 **/
+	virtual bool isComputeFenceComplete(uint64 fence);
+
+	/**
+	 * Makes GPU work submitted after this call wait for the async compute work
+	 * with the given fence value. Doesn't block on the CPU.
+	 **/
+	virtual void waitComputeFence(uint64 fence);
+
 	void draw(Drawable *drawable, const Matrix4 &m);
 	void draw(Texture *texture, Quad *quad, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4 &m);
 	void drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount);
+	void drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount);
 
 	void drawShaderVertices(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture);
 	void drawShaderVertices(Buffer *indexbuffer, int indexcount, int instancecount, int startindex, Texture *maintexture);
 
+	void drawShaderVerticesIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture);
+	void drawShaderVerticesIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, int drawcount, Texture *maintexture);
+
+	/**
+	 * Throws an exception if the given indirect arguments Buffer can't be
+	 * used for drawcount draws starting at argsindex. Returns the byte offset
+	 * of the first draw's arguments.
+	 **/
+	size_t validateIndirectArgs(Buffer *indirectargs, int argsindex, int drawcount, bool indexed) const;
+
 	/**
 	 * Draws text at the specified coordinates
 	 **/
@@ -829,6 +1101,19 @@ public:
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Returns the current usage and the budget the driver recommends staying
+	 * within, for each GPU memory heap. Empty if the backend can't query it.
+	 **/
+	virtual std::vector<MemoryHeap> getMemoryHeaps() const { return {}; }
+
+	/**
+	 * Compacts the graphics memory used by textures and buffers, by moving
+	 * resources out of sparsely used memory blocks and releasing recycled
+	 * objects. Backends may do the work at the start of the next frame.
+	 **/
+	virtual void defragmentMemory() {}
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -864,9 +1149,72 @@ public:
 
 	static void flushBatchedDrawsGlobal();
 
-	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples);
+	/**
+	 * Redirects all batched draws into the given DrawList until
+	 * endDrawListRecording is called, instead of drawing them.
+	 **/
+	void beginDrawListRecording(DrawList *drawlist);
+	void endDrawListRecording();
+	DrawList *getRecordingDrawList() const { return recordingDrawList; }
+
+	/**
+	 * When enabled, batched draws are buffered and grouped by their texture,
+	 * vertex format and standard shader instead of being flushed in submission
+	 * order, so interleaved draws using different textures still end up in a
+	 * small number of draw calls. The buffered draws are flushed whenever other
+	 * state changes cause a flush. Only use this for content that doesn't
+	 * overlap, or that is depth-tested, since draw order isn't preserved.
+	 *
+	 * BATCH_SORT_DEPTH instead orders the buffered draws by the sort depth
+	 * which was active when each was submitted, lowest first, keeping
+	 * submission order for equal depths. Consecutive draws which end up
+	 * sharing a texture are then merged as usual.
+	 **/
+	void setBatchSortMode(BatchSortMode mode);
+	BatchSortMode getBatchSortMode() const { return batchSortMode; }
+	bool isBatchSorting() const { return batchSortMode != BATCH_SORT_NONE; }
+
+	void setBatchSortDepth(float depth) { batchSortDepth = depth; }
+	float getBatchSortDepth() const { return batchSortDepth; }
+
+	/**
+	 * Creates the backend pipeline state which draws using the given shader,
+	 * vertex attributes and primitive type need with the current blend mode,
+	 * color mask, wireframe mode and render targets, so it doesn't have to be
+	 * created in the middle of drawing. Backends may compile it on other
+	 * threads. Does nothing on backends without pipeline state objects.
+	 **/
+	virtual void precompilePipeline(Shader *shader, const VertexAttributes &attributes, PrimitiveType primitive);
+	virtual int getPrecompilingPipelineCount() const;
+
+	/**
+	 * When enabled, pipeline state which has to be created while drawing
+	 * because it wasn't precompiled is printed to stdout.
+	 **/
+	void setPipelineMissLogging(bool enable) { pipelineMissLogging = enable; }
+	bool isPipelineMissLogging() const { return pipelineMissLogging; }
+
+	/**
+	 * When enabled, backends which support it record the commands of render
+	 * passes with render targets active on worker threads. The recorded passes
+	 * are still submitted in the order they were drawn.
+	 **/
+	void setParallelRenderPassRecording(bool enable) { parallelRenderPassRecording = enable; }
+	bool isParallelRenderPassRecording() const { return parallelRenderPassRecording; }
+
+	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples, bool memoryless);
 	void releaseTemporaryTexture(Texture *texture);
 
+	/**
+	 * Returns a pooled render target with the given size in pixels, which is
+	 * reserved until releaseTransientTexture is called or the frame ends.
+	 * Released render targets are handed out again for later requests with
+	 * the same format, size and MSAA, so chains of render targets which are
+	 * never in use at the same time share memory.
+	 **/
+	Texture *getTransientTexture(PixelFormat format, int w, int h, int samples);
+	void releaseTransientTexture(Texture *texture);
+
 	Buffer *getTemporaryBuffer(size_t size, DataFormat format, uint32 usageflags, BufferDataUsage datausage);
 	void releaseTemporaryBuffer(Buffer *buffer);
 
@@ -885,6 +1233,21 @@ public:
 
 	static Graphics *createInstance();
 
+	/**
+	 * Gets the name of a file in the save directory which caches data created
+	 * from the given key: the directory, the key's SHA-1 as hex, then the
+	 * extension.
+	 **/
+	static std::string getCacheFilename(const std::string &directory, const std::string &key, const std::string &extension);
+
+	/**
+	 * Creates a cache directory, or writes a cache file into one. A cache
+	 * which can't be saved (e.g. when no save directory has been set up) is
+	 * only created again on the next run, so failures just return false.
+	 **/
+	static bool createCacheDirectory(const std::string &directory);
+	static bool saveCacheFile(const std::string &directory, const std::string &filename, const void *data, size_t size);
+
 	STRINGMAP_CLASS_DECLARE(DrawMode);
 	STRINGMAP_CLASS_DECLARE(ArcMode);
 	STRINGMAP_CLASS_DECLARE(LineStyle);
@@ -892,6 +1255,7 @@ public:
 	STRINGMAP_CLASS_DECLARE(Feature);
 	STRINGMAP_CLASS_DECLARE(SystemLimit);
 	STRINGMAP_CLASS_DECLARE(StackType);
+	STRINGMAP_CLASS_DECLARE(BatchSortMode);
 
 protected:
 
@@ -929,6 +1293,8 @@ protected:
 		CullMode meshCullMode = CULL_NONE;
 		Winding winding = WINDING_CCW;
 
+		bool drawCulling = false;
+
 		StrongRef<Font> font;
 		StrongRef<Shader> shader;
 
@@ -968,6 +1334,94 @@ protected:
 		}
 	};
 
+	struct SortedBatchState
+	{
+		struct Draw
+		{
+			BatchedDrawCommand command;
+			size_t vertexOffsets[2];
+		};
+
+		struct Group
+		{
+			BatchedDrawCommand command;
+			StrongRef<Texture> texture;
+			std::vector<Draw> draws;
+		};
+
+		std::vector<Group> groups;
+		std::vector<uint8> vertexData[2];
+		int lastGroup = -1;
+
+		// Used instead of groups by BATCH_SORT_DEPTH. Keys are the sort depths
+		// of each draw, mapped to integers with the same ordering.
+		std::vector<Draw> depthDraws;
+		std::vector<uint32> depthKeys;
+		std::vector<StrongRef<Texture>> depthTextures;
+		std::vector<uint32> sortIndices[2];
+	};
+
+	// Per-instance data for ellipses and arcs drawn with instancing. The
+	// transform and offset are in screen space, like batched vertices.
+	struct ShapeInstance
+	{
+		float transform[4];
+		float offset[2];
+		float radii[2];
+		float angles[2];
+		float segments;
+		float chord;
+		Color32 color;
+	};
+
+	struct InstancedShapeState
+	{
+		std::vector<ShapeInstance> pending;
+		std::vector<ShapeInstance> flushing;
+		Buffer *vertexBuffer = nullptr;
+	};
+
+	struct PendingTextureUpload
+	{
+		struct Part
+		{
+			StrongRef<image::ImageDataBase> data;
+			int slice;
+			int mipmap;
+		};
+
+		StrongRef<Texture> texture;
+		std::vector<Part> parts;
+		size_t currentPart = 0;
+		int currentRow = 0;
+		bool generateMipmaps = false;
+		int streamedMipmap = -1;
+	};
+
+	// Resident mipmaps of a streaming texture are the uploaded ones sampling is
+	// restricted to, via the sampler's minimum LOD. Storage for the other
+	// mipmaps is still allocated by the backend.
+	struct StreamingTexture
+	{
+		StrongRef<Texture> texture;
+		// CPU-side copies of each slice of each mipmap, so evicted mipmaps can
+		// be uploaded again later.
+		std::vector<std::vector<StrongRef<image::ImageDataBase>>> mipmaps;
+		int residentMipmap = 0;
+		int uploadingMipmap = -1;
+		// The sampler's own minimum LOD, which residency never goes below.
+		int baseMinLod = 0;
+	};
+
+	// The array texture is owned by the textures that use its layers, it's
+	// removed from the list once no layers are in use.
+	struct SharedArrayTexture
+	{
+		Texture *texture;
+		std::vector<bool> usedLayers;
+		int usedCount;
+	};
+
 	struct TemporaryBuffer
 	{
 		Buffer *buffer;
@@ -993,19 +1447,34 @@ protected:
 	};
 
 	ShaderStage *newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache);
-	virtual ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) = 0;
-	virtual Shader *newShaderInternal(StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM]) = 0;
+	Shader *newShaderFromBundle(const std::string &bundledata, bool compute);
+	Shader *newShaderFromVariant(const ShaderBundle::Variant &variant, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute);
+	const ShaderBundle::Variant *getSupportedVariant(const ShaderBundle &bundle) const;
+	Shader::CodeVariant getShaderCodeVariant() const;
+
+	/**
+	 * Compiled shader variants are stored in the save directory, so later runs
+	 * can skip preprocessing, glslang and SPIR-V generation. Returns an empty
+	 * string if there's nowhere to store them.
+	 **/
+	std::string getShaderCacheFilename(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute) const;
+	bool loadCachedShaderVariant(const std::string &filename, const std::vector<std::string> &sources, const Shader::CompileOptions &options, ShaderBundle::Variant &variant) const;
+	void saveCachedShaderVariant(const std::string &filename, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute, const ShaderBundle::Variant &variant) const;
+	Shader *newShaderWithDiskCache(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute);
+	virtual ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv) = 0;
+	virtual Shader *newShaderInternal(StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection) = 0;
 	virtual StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) = 0;
 
 	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) = 0;
 	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty) = 0;
 
 	virtual bool dispatch(int x, int y, int z) = 0;
+	virtual bool dispatchAsync(int x, int y, int z, uint64 &fence);
 
 	virtual void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) = 0;
 
 	virtual void initCapabilities() = 0;
-	virtual void getAPIStats(int &shaderswitches) const = 0;
+	virtual void getAPIStats(Stats &stats) const = 0;
 
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
@@ -1015,14 +1484,61 @@ protected:
 
 	void updatePendingReadbacks();
 
+	/**
+	 * Gets an RGBA8 ImageData for a captured screenshot, reusing one from a
+	 * previous capture when nothing else references it anymore. The pixels
+	 * are copied into it if non-null.
+	 **/
+	image::ImageData *newScreenshotImageData(int width, int height, const void *pixels);
+
+	/**
+	 * Gives the captured screenshot to the first callback, and a copy of it to
+	 * each of the others. If copying fails, every callback is told the
+	 * capture failed before the exception is rethrown.
+	 **/
+	void callScreenshotCallbacks(const std::vector<ScreenshotInfo> &callbacks, image::ImageData *img, void *screenshotCallbackData);
+
+	// Backends call this once per frame.
+	void updatePendingShaders();
+	void startShaderCompiles();
+	void waitForShaderCompile(PendingShader *shader);
+
+	// Backends call this once per frame, after the next frame has begun.
+	void updateTextureUploads();
+	size_t uploadTexturePart(PendingTextureUpload &upload, size_t maxsize);
+
+	void updateTextureStreaming();
+	int64 getStreamingMipmapSize(const StreamingTexture &st, int mipmap) const;
+	void setStreamingResidency(StreamingTexture &st, int mipmap);
+	void queueStreamingMipmaps(StreamingTexture &st, int firstmipmap, int lastmipmap);
+
+	// Backends call these around the work submitted for each frame, to measure
+	// the GPU frame time reported by getStats.
+	void beginFrameTimer();
+	void endFrameTimer();
+
+	BatchedVertexData requestSortedBatchedDraw(const BatchedDrawCommand &cmd);
+	void flushSortedBatchedDraws();
+
+	bool addInstancedShape(float x, float y, float rx, float ry, float angle1, float angle2, int segments, bool chord);
+	void flushInstancedShapes();
+	void drawInstancedShapesBatched(const ShapeInstance *shapes, size_t count);
+
 	void restoreState(const DisplayState &s);
 	void restoreStateChecked(const DisplayState &s);
 
 	void pushTransform();
 	void pushIdentityTransform();
 	void popTransform();
+	void multiplyTransform(const Matrix4 &m);
+	void promoteTransform();
+	void updatePixelScale();
 
 	void updateDeviceProjection(const Matrix4 &projection);
+
+	// Whether a draw is skipped by draw culling. Counts culled draws.
+	bool isCulled(Drawable *drawable, const Matrix4 &m);
+	bool isCulled(Quad *quad, const Matrix4 &m);
 	Matrix4 calculateDeviceProjection(const Matrix4 &projection, uint32 flags) const;
 
 	int width;
@@ -1033,14 +1549,68 @@ protected:
 	bool created;
 	bool active;
 
+	int framesInFlight;
+	bool lowLatency;
+
 	StrongRef<love::graphics::Font> defaultFont;
 
 	std::vector<ScreenshotInfo> pendingScreenshotCallbacks;
 	std::vector<StrongRef<GraphicsReadback>> pendingReadbacks;
 
+	StrongRef<TimerQuery> activeFrameTimer;
+	std::vector<StrongRef<TimerQuery>> pendingFrameTimers;
+	std::vector<StrongRef<TimerQuery>> unusedFrameTimers;
+	double gpuFrameTime;
+
+	// Not retained: a running query clears this when it's stopped or deleted.
+	OcclusionQuery *activeOcclusionQuery;
+	StrongRef<OcclusionQuery> conditionalRenderQuery;
+
 	BatchedDrawState batchedDrawState;
 
-	std::vector<Matrix4> transformStack;
+	DrawList *recordingDrawList;
+
+	BatchSortMode batchSortMode;
+	float batchSortDepth;
+	SortedBatchState sortedBatchState;
+
+	bool pipelineMissLogging;
+	bool parallelRenderPassRecording;
+
+	std::vector<SharedArrayTexture> sharedArrayTextures;
+
+	InstancedShapeState instancedShapeState;
+
+	std::vector<PendingTextureUpload> pendingTextureUploads;
+
+	std::vector<StrongRef<PendingShader>> queuedShaderCompiles;
+	std::vector<StrongRef<ShaderCompileJob>> shaderCompileJobs;
+	std::vector<StrongRef<PendingShader>> pendingShaders;
+
+	std::vector<StreamingTexture> streamingTextures;
+	int64 textureStreamingBudget;
+	uint64 textureStreamingFrame;
+	int64 streamedTextureData;
+
+	// Transform stack entry. Most transforms are 2D affine, so they're kept
+	// as a compact 2x3 matrix:
+	// | a c x |
+	// | b d y |
+	// An entry is only promoted to a full 4x4 matrix (the top of
+	// fullTransformStack) once a transform which isn't 2D is applied to it.
+	struct TransformEntry
+	{
+		float a, b, c, d, x, y;
+		bool full;
+	};
+
+	std::vector<TransformEntry> transformStack;
+	std::vector<Matrix4> fullTransformStack;
+
+	// The top 2D transform as a Matrix4, built on demand by getTransform.
+	mutable Matrix4 currentTransform;
+	mutable bool currentTransformDirty;
+
 	Matrix4 deviceProjectionMatrix;
 
 	std::vector<double> pixelScaleStack;
@@ -1050,10 +1620,26 @@ protected:
 
 	std::vector<TemporaryBuffer> temporaryBuffers;
 	std::vector<TemporaryTexture> temporaryTextures;
+	std::vector<Texture *> transientTextures;
+
+	struct PooledScreenshot
+	{
+		image::ImageData *data;
+		int framesSinceUse;
+	};
+
+	std::vector<PooledScreenshot> screenshotPool;
+	StrongRef<ScreenshotEncoder> screenshotEncoder;
+
+	StrongRef<Shader> mipmapComputeShader;
+	StrongRef<Shader> particleComputeShader;
+	StrongRef<Shader> particleRenderShader;
+	StrongRef<Shader> lineShader;
 
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
+	int drawsCulled;
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
@@ -1064,11 +1650,29 @@ protected:
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
+	static const size_t MAX_POOLED_SCREENSHOTS = 4;
+
+	// Filled ellipses and arcs with more segments than this are never instanced.
+	static const int MAX_INSTANCED_SHAPE_SEGMENTS = 64;
+
+	// Fewer consecutive shapes than this are cheaper to draw without instancing.
+	static const int MIN_INSTANCED_SHAPES = 32;
+
+	// The amount of asynchronous texture data uploaded each frame.
+	static const size_t TEXTURE_UPLOAD_BYTES_PER_FRAME = 8 * 1024 * 1024;
+
+	// Streaming textures start with the mipmaps no larger than this resident.
+	static const int STREAMING_TEXTURE_INITIAL_SIZE = 128;
+
+	// Streaming textures drawn within this many frames stream in their higher
+	// mipmaps, and aren't considered for eviction.
+	static const int STREAMING_TEXTURE_VISIBLE_FRAMES = 2;
 
 private:
 
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
+	uint64 dispatchThreadgroups(Shader* shader, int x, int y, int z, bool async);
 
 	std::vector<uint8> scratchBuffer;
 
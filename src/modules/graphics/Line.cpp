@@ -0,0 +1,302 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Line.h"
+#include "Graphics.h"
+#include "Polyline.h"
+#include "Buffer.h"
+#include "Shader.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type Line::type("Line", &Drawable::type);
+
+Line::Line(Graphics * /*gfx*/, const Vector2 *points, size_t count, bool gpuExpanded)
+	: gpuExpanded(gpuExpanded)
+	, geometryBuffer(nullptr)
+	, geometryColorBuffer(nullptr)
+	, geometryVertexCount(0)
+	, geometryIndexMode(TRIANGLEINDEX_STRIP)
+	, geometryDirty(true)
+	, geometryHalfWidth(0.0f)
+	, geometryPixelSize(0.0f)
+	, geometryJoin(-1)
+	, geometryStyle(-1)
+	, pointBuffer(nullptr)
+	, pointBufferDirty(true)
+{
+	setPoints(points, count);
+}
+
+Line::~Line()
+{
+	if (geometryBuffer)
+		geometryBuffer->release();
+	if (geometryColorBuffer)
+		geometryColorBuffer->release();
+	if (pointBuffer)
+		pointBuffer->release();
+}
+
+void Line::setPoints(const Vector2 *newpoints, size_t count)
+{
+	if (count < 2)
+		throw love::Exception("Need at least two vertices to draw a line.");
+
+	points.assign(newpoints, newpoints + count);
+	geometryDirty = true;
+	pointBufferDirty = true;
+}
+
+const std::vector<Vector2> &Line::getPoints() const
+{
+	return points;
+}
+
+bool Line::isGPUExpanded() const
+{
+	return gpuExpanded;
+}
+
+void Line::updateGeometry(Graphics *gfx)
+{
+	float halfwidth = gfx->getLineWidth() * 0.5f;
+	float pixelsize = gfx->getPixelSize();
+	Graphics::LineJoin join = gfx->getLineJoin();
+	Graphics::LineStyle style = gfx->getLineStyle();
+
+	// Rough lines don't depend on the pixel size.
+	if (style != Graphics::LINE_SMOOTH)
+		pixelsize = 0.0f;
+
+	if (!geometryDirty && halfwidth == geometryHalfWidth && pixelsize == geometryPixelSize
+		&& (int) join == geometryJoin && (int) style == geometryStyle)
+	{
+		return;
+	}
+
+	geometryHalfWidth = halfwidth;
+	geometryPixelSize = pixelsize;
+	geometryJoin = (int) join;
+	geometryStyle = (int) style;
+
+	const Vector2 *coords = points.data();
+	size_t count = points.size();
+	bool overdraw = style == Graphics::LINE_SMOOTH;
+
+	// The vertex colors are white, faded out at the edges of smooth lines. The
+	// current color is applied when drawing.
+	Color32 white(255, 255, 255, 255);
+
+	if (join == Graphics::LINE_JOIN_NONE)
+	{
+		NoneJoinPolyline line(&geometry);
+		line.render(coords, count, halfwidth, pixelsize, overdraw);
+		geometryVertexCount = line.getVertexCount();
+		geometryIndexMode = line.getTriangleIndexMode();
+		geometryColors.resize(geometryVertexCount);
+		line.fillColors(white, geometryColors.data());
+	}
+	else if (join == Graphics::LINE_JOIN_BEVEL)
+	{
+		BevelJoinPolyline line(&geometry);
+		line.render(coords, count, halfwidth, pixelsize, overdraw);
+		geometryVertexCount = line.getVertexCount();
+		geometryIndexMode = line.getTriangleIndexMode();
+		geometryColors.resize(geometryVertexCount);
+		line.fillColors(white, geometryColors.data());
+	}
+	else
+	{
+		MiterJoinPolyline line(&geometry);
+		line.render(coords, count, halfwidth, pixelsize, overdraw);
+		geometryVertexCount = line.getVertexCount();
+		geometryIndexMode = line.getTriangleIndexMode();
+		geometryColors.resize(geometryVertexCount);
+		line.fillColors(white, geometryColors.data());
+	}
+
+	size_t size = sizeof(Vector2) * geometryVertexCount;
+
+	// The buffers only grow, so lines whose points change often don't
+	// recreate them every time.
+	if (geometryBuffer == nullptr || geometryBuffer->getSize() < size)
+	{
+		if (geometryBuffer)
+			geometryBuffer->release();
+		if (geometryColorBuffer)
+			geometryColorBuffer->release();
+		geometryBuffer = nullptr;
+		geometryColorBuffer = nullptr;
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_DYNAMIC);
+		auto posdecl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf);
+		auto colordecl = Buffer::getCommonFormatDeclaration(CommonFormat::RGBAub);
+
+		geometryBuffer = gfx->newBuffer(settings, posdecl, geometry.data(), size, 0);
+		geometryColorBuffer = gfx->newBuffer(settings, colordecl, geometryColors.data(), sizeof(Color32) * geometryVertexCount, 0);
+	}
+	else
+	{
+		geometryBuffer->fill(0, size, geometry.data());
+		geometryColorBuffer->fill(0, sizeof(Color32) * geometryVertexCount, geometryColors.data());
+	}
+
+	geometryDirty = false;
+}
+
+void Line::drawGeometry(Graphics *gfx, const Matrix4 &m)
+{
+	updateGeometry(gfx);
+
+	if (geometryVertexCount == 0)
+		return;
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, nullptr);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	VertexAttributes attributes;
+	attributes.setCommonFormat(CommonFormat::XYf, 0);
+	attributes.setCommonFormat(CommonFormat::RGBAub, 1);
+
+	BufferBindings buffers;
+	buffers.set(0, geometryBuffer, 0);
+	buffers.set(1, geometryColorBuffer, 0);
+
+	if (geometryIndexMode == TRIANGLEINDEX_QUADS)
+		gfx->drawQuads(0, (int) geometryVertexCount / 4, attributes, buffers, nullptr);
+	else
+	{
+		Graphics::DrawCommand cmd(&attributes, &buffers);
+		cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+		cmd.vertexCount = (int) geometryVertexCount;
+		gfx->draw(cmd);
+	}
+}
+
+void Line::drawExpanded(Graphics *gfx, const Matrix4 &m)
+{
+	Shader *shader = gfx->getLineShader();
+
+	if (pointBufferDirty)
+	{
+		size_t size = sizeof(Vector2) * points.size();
+
+		if (pointBuffer == nullptr || pointBuffer->getSize() < size)
+		{
+			if (pointBuffer)
+				pointBuffer->release();
+			pointBuffer = nullptr;
+
+			Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_DYNAMIC);
+			std::vector<Buffer::DataDeclaration> decl = {{"LinePoint", DATAFORMAT_FLOAT_VEC2}};
+			pointBuffer = gfx->newBuffer(settings, decl, points.data(), size, 0);
+		}
+		else
+			pointBuffer->fill(0, size, points.data());
+
+		pointBufferDirty = false;
+	}
+
+	int startindex = shader->getVertexAttributeIndex("LineStart");
+	int endindex = shader->getVertexAttributeIndex("LineEnd");
+	const Shader::UniformInfo *paramsinfo = shader->getUniformInfo("LineParams");
+
+	if (startindex < 0 || endindex < 0 || paramsinfo == nullptr)
+		throw love::Exception("Could not find the line shader's variables.");
+
+	float pixelsize = gfx->getLineStyle() == Graphics::LINE_SMOOTH ? gfx->getPixelSize() : 0.0f;
+
+	paramsinfo->floats[0] = gfx->getLineWidth() * 0.5f;
+	paramsinfo->floats[1] = pixelsize;
+	paramsinfo->floats[2] = 0.0f;
+	paramsinfo->floats[3] = 0.0f;
+	shader->updateUniform(paramsinfo, 1);
+
+	// Each segment is an instance, with its start and end points read from
+	// the same buffer one point apart.
+	VertexAttributes attributes;
+	attributes.set(startindex, DATAFORMAT_FLOAT_VEC2, 0, 0);
+	attributes.setBufferLayout(0, (uint16) sizeof(Vector2), STEP_PER_INSTANCE);
+	attributes.set(endindex, DATAFORMAT_FLOAT_VEC2, 0, 1);
+	attributes.setBufferLayout(1, (uint16) sizeof(Vector2), STEP_PER_INSTANCE);
+
+	BufferBindings buffers;
+	buffers.set(0, pointBuffer, 0);
+	buffers.set(1, pointBuffer, sizeof(Vector2));
+
+	Shader *prevshader = Shader::current;
+	shader->attach();
+
+	try
+	{
+		shader->validateDrawState(PRIMITIVE_TRIANGLES, nullptr);
+
+		Graphics::TempTransform transform(gfx, m);
+
+		Graphics::DrawIndexedCommand cmd(&attributes, &buffers, gfx->getQuadIndexBuffer());
+		cmd.primitiveType = PRIMITIVE_TRIANGLES;
+		cmd.indexCount = 6;
+		cmd.instanceCount = (int) points.size() - 1;
+		cmd.indexType = INDEX_UINT16;
+		gfx->draw(cmd);
+	}
+	catch (love::Exception &)
+	{
+		prevshader->attach();
+		throw;
+	}
+
+	prevshader->attach();
+}
+
+void Line::draw(Graphics *gfx, const Matrix4 &m)
+{
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	// Custom shaders get the triangulated geometry, since they don't know
+	// how to expand segments.
+	const auto &caps = gfx->getCapabilities();
+	bool expand = gpuExpanded && Shader::isDefaultActive() && Shader::current != nullptr
+		&& caps.features[Graphics::FEATURE_GLSL3] && caps.features[Graphics::FEATURE_INSTANCING];
+
+	if (expand)
+		drawExpanded(gfx, m);
+	else
+		drawGeometry(gfx, m);
+}
+
+} // graphics
+} // love
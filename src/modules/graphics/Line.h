@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/math.h"
+#include "common/Matrix.h"
+#include "common/Vector.h"
+#include "Drawable.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Buffer;
+
+/**
+ * A line through a list of points, which keeps its triangulated geometry on
+ * the GPU until the points or the line state it was built with change. It's
+ * drawn with the current line width, style and join, like love.graphics.line.
+ **/
+class Line : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param gpuExpanded Whether the segments are expanded into quads by a
+	 *                    vertex shader instead of being triangulated on the
+	 *                    CPU. Segments aren't joined and only the line width
+	 *                    and style apply, but changing points only has to
+	 *                    upload the points themselves.
+	 **/
+	Line(Graphics *gfx, const Vector2 *points, size_t count, bool gpuExpanded);
+	virtual ~Line();
+
+	void setPoints(const Vector2 *points, size_t count);
+	const std::vector<Vector2> &getPoints() const;
+
+	bool isGPUExpanded() const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	void updateGeometry(Graphics *gfx);
+	void drawGeometry(Graphics *gfx, const Matrix4 &m);
+	void drawExpanded(Graphics *gfx, const Matrix4 &m);
+
+	std::vector<Vector2> points;
+	bool gpuExpanded;
+
+	// Triangulated geometry, and the line state it was built with. The join
+	// and style are stored as Graphics::LineJoin and Graphics::LineStyle.
+	std::vector<Vector2> geometry;
+	std::vector<Color32> geometryColors;
+	Buffer *geometryBuffer;
+	Buffer *geometryColorBuffer;
+	size_t geometryVertexCount;
+	TriangleIndexMode geometryIndexMode;
+	bool geometryDirty;
+	float geometryHalfWidth;
+	float geometryPixelSize;
+	int geometryJoin;
+	int geometryStyle;
+
+	// Points for GPU expansion, as one instance per segment.
+	Buffer *pointBuffer;
+	bool pointBufferDirty;
+
+}; // Line
+
+} // graphics
+} // love
@@ -124,11 +124,51 @@ Mesh::Mesh(const std::vector<Mesh::BufferAttribute> &attributes, PrimitiveType d
 	indexDataType = getIndexDataTypeFromMax(vertexCount);
 }
 
+Mesh::Mesh(BufferArena *arena, const void *data, size_t vertexcount, PrimitiveType drawmode)
+	: primitiveType(drawmode)
+{
+	if (vertexcount == 0)
+		throw love::Exception("Invalid number of vertices (%d).", (int) vertexcount);
+
+	arenaAllocation = arena->allocate(vertexcount);
+	this->arena.set(arena);
+
+	vertexBuffer.set(arenaAllocation.buffer);
+	vertexCount = vertexcount;
+	vertexStride = vertexBuffer->getArrayStride();
+	vertexFormat = vertexBuffer->getDataMembers();
+
+	setupAttachedAttributes();
+
+	indexDataType = getIndexDataTypeFromMax(vertexCount);
+
+	size_t datasize = vertexCount * vertexStride;
+
+	try
+	{
+		vertexData = new uint8[datasize];
+	}
+	catch (std::exception &)
+	{
+		arena->free(arenaAllocation);
+		throw love::Exception("Out of memory");
+	}
+
+	if (data != nullptr)
+		memcpy(vertexData, data, datasize);
+	else
+		memset(vertexData, 0, datasize);
+
+	vertexBuffer->fill(arenaAllocation.start * vertexStride, datasize, vertexData);
+}
+
 Mesh::~Mesh()
 {
 	delete vertexData;
 	if (indexData != nullptr)
 		free(indexData);
+	if (arena.get())
+		arena->free(arenaAllocation);
 }
 
 void Mesh::setupAttachedAttributes()
@@ -140,7 +180,7 @@ void Mesh::setupAttachedAttributes()
 		if (getAttachedAttributeIndex(name) != -1)
 			throw love::Exception("Duplicate vertex attribute name: %s", name.c_str());
 
-		attachedAttributes.push_back({name, vertexBuffer, nullptr, (int) i, 0, STEP_PER_VERTEX, true});
+		attachedAttributes.push_back({name, vertexBuffer, nullptr, (int) i, (int) getVertexBufferOffset(), STEP_PER_VERTEX, true});
 	}
 }
 
@@ -185,6 +225,11 @@ Buffer *Mesh::getVertexBuffer() const
 	return vertexBuffer;
 }
 
+size_t Mesh::getVertexBufferOffset() const
+{
+	return arena.get() ? arenaAllocation.start : 0;
+}
+
 const std::vector<Buffer::DataMember> &Mesh::getVertexFormat() const
 {
 	return vertexFormat;
@@ -197,6 +242,7 @@ void Mesh::setAttributeEnabled(const std::string &name, bool enable)
 		throw love::Exception("Mesh does not have an attached vertex attribute named '%s'", name.c_str());
 
 	attachedAttributes[index].enabled = enable;
+	boundsDirty = true;
 }
 
 bool Mesh::isAttributeEnabled(const std::string &name) const
@@ -244,6 +290,8 @@ void Mesh::attachAttribute(const std::string &name, Buffer *buffer, Mesh *mesh,
 		attachedAttributes[oldindex] = newattrib;
 	else
 		attachedAttributes.push_back(newattrib);
+
+	boundsDirty = true;
 }
 
 bool Mesh::detachAttribute(const std::string &name)
@@ -253,9 +301,10 @@ bool Mesh::detachAttribute(const std::string &name)
 		return false;
 
 	attachedAttributes.erase(attachedAttributes.begin() + index);
+	boundsDirty = true;
 
 	if (vertexBuffer.get() && vertexBuffer->getDataMemberIndex(name) != -1)
-		attachAttribute(name, vertexBuffer, nullptr, name);
+		attachAttribute(name, vertexBuffer, nullptr, name, (int) getVertexBufferOffset());
 
 	return true;
 }
@@ -274,21 +323,26 @@ void Mesh::setVertexDataModified(size_t offset, size_t size)
 {
 	if (vertexData != nullptr)
 		modifiedVertexData.encapsulate(offset, size);
+
+	boundsDirty = true;
 }
 
 void Mesh::flush()
 {
 	if (vertexBuffer.get() && vertexData != nullptr && modifiedVertexData.isValid())
 	{
+		// Arena Meshes only own a range of the vertex buffer.
+		size_t base = getVertexBufferOffset() * vertexStride;
+
 		if (vertexBuffer->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 		{
-			vertexBuffer->fill(0, vertexBuffer->getSize(), vertexData);
+			vertexBuffer->fill(base, vertexCount * vertexStride, vertexData);
 		}
 		else
 		{
 			size_t offset = modifiedVertexData.getOffset();
 			size_t size = modifiedVertexData.getSize();
-			vertexBuffer->fill(offset, size, vertexData + offset);
+			vertexBuffer->fill(base + offset, size, vertexData + offset);
 		}
 
 		modifiedVertexData.invalidate();
@@ -475,6 +529,256 @@ size_t Mesh::getIndexCount() const
 	return indexCount;
 }
 
+/**
+ * Reorders a triangle list for post-transform vertex cache reuse, using the
+ * Tipsify algorithm (Sander, Nehab and Barczak, 2007).
+ **/
+static std::vector<uint32> optimizeVertexCache(const std::vector<uint32> &indices, size_t vertexcount, int cachesize)
+{
+	size_t tricount = indices.size() / 3;
+
+	// Triangles adjacent to each vertex.
+	std::vector<uint32> adjoffsets(vertexcount + 1, 0);
+	for (uint32 v : indices)
+		adjoffsets[v + 1]++;
+	for (size_t v = 0; v < vertexcount; v++)
+		adjoffsets[v + 1] += adjoffsets[v];
+
+	std::vector<uint32> adjacency(indices.size());
+	std::vector<uint32> live(vertexcount, 0);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		uint32 v = indices[i];
+		adjacency[adjoffsets[v] + live[v]++] = (uint32) (i / 3);
+	}
+
+	std::vector<int> cachetime(vertexcount, 0);
+	std::vector<bool> emitted(tricount, false);
+	std::vector<uint32> deadend;
+	std::vector<uint32> candidates;
+
+	std::vector<uint32> result;
+	result.reserve(tricount * 3);
+
+	int timestamp = cachesize + 1;
+	size_t cursor = 1;
+	int64 fanning = 0;
+
+	while (fanning >= 0)
+	{
+		candidates.clear();
+
+		for (uint32 a = adjoffsets[fanning]; a < adjoffsets[fanning + 1]; a++)
+		{
+			uint32 t = adjacency[a];
+			if (emitted[t])
+				continue;
+
+			for (int c = 0; c < 3; c++)
+			{
+				uint32 v = indices[t * 3 + c];
+				result.push_back(v);
+				deadend.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+
+				if (timestamp - cachetime[v] > cachesize)
+					cachetime[v] = timestamp++;
+			}
+
+			emitted[t] = true;
+		}
+
+		// Prefer a candidate which is still in the cache and will stay there
+		// while its remaining triangles are emitted.
+		int64 best = -1;
+		int bestpriority = -1;
+		for (uint32 v : candidates)
+		{
+			if (live[v] == 0)
+				continue;
+
+			int priority = 0;
+			if (timestamp - cachetime[v] + 2 * (int) live[v] <= cachesize)
+				priority = timestamp - cachetime[v];
+
+			if (priority > bestpriority)
+			{
+				bestpriority = priority;
+				best = v;
+			}
+		}
+
+		// Otherwise back up through recently used vertices, and finally scan
+		// for any vertex with triangles left.
+		while (best < 0 && !deadend.empty())
+		{
+			uint32 v = deadend.back();
+			deadend.pop_back();
+			if (live[v] > 0)
+				best = v;
+		}
+
+		while (best < 0 && cursor < vertexcount)
+		{
+			if (live[cursor] > 0)
+				best = (int64) cursor;
+			cursor++;
+		}
+
+		fanning = best;
+	}
+
+	return result;
+}
+
+void Mesh::optimize()
+{
+	if (primitiveType != PRIMITIVE_TRIANGLES)
+		throw love::Exception("Mesh:optimize requires the Mesh to use the triangles draw mode.");
+
+	if (vertexBuffer.get() == nullptr || vertexData == nullptr)
+		throw love::Exception("Mesh must own its own vertex buffer.");
+
+	if (useIndexBuffer && indexData == nullptr)
+		throw love::Exception("Mesh:optimize cannot be used with a Mesh that has an index Buffer set via Mesh:setIndexBuffer.");
+
+	for (const BufferAttribute &attrib : attachedAttributes)
+	{
+		if (attrib.step == STEP_PER_VERTEX && attrib.buffer.get() != vertexBuffer.get())
+			throw love::Exception("Mesh:optimize cannot be used while per-vertex attributes from other Buffers are attached to the Mesh.");
+	}
+
+	std::vector<uint32> indices;
+	if (!getVertexMap(indices))
+	{
+		indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			indices[i] = (uint32) i;
+	}
+
+	// Incomplete triangles are never drawn.
+	indices.resize(indices.size() - indices.size() % 3);
+
+	if (indices.empty())
+		return;
+
+	// Merge byte-identical vertices, via an open addressing hash table.
+	std::vector<uint32> remap(vertexCount);
+	{
+		size_t tablesize = 1;
+		while (tablesize < vertexCount * 2)
+			tablesize <<= 1;
+
+		std::vector<uint32> table(tablesize, LOVE_UINT32_MAX);
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const uint8 *vdata = vertexData + v * vertexStride;
+
+			uint32 hash = 2166136261u;
+			for (size_t b = 0; b < vertexStride; b++)
+				hash = (hash ^ vdata[b]) * 16777619u;
+
+			size_t slot = hash & (tablesize - 1);
+			while (table[slot] != LOVE_UINT32_MAX && memcmp(vertexData + table[slot] * vertexStride, vdata, vertexStride) != 0)
+				slot = (slot + 1) & (tablesize - 1);
+
+			if (table[slot] == LOVE_UINT32_MAX)
+				table[slot] = (uint32) v;
+
+			remap[v] = table[slot];
+		}
+	}
+
+	for (uint32 &i : indices)
+	{
+		if (i >= vertexCount)
+			throw love::Exception("Invalid vertex map value: %d", i + 1);
+		i = remap[i];
+	}
+
+	indices = optimizeVertexCache(indices, vertexCount, 16);
+
+	// Reorder vertices by first use, dropping unreferenced ones.
+	std::fill(remap.begin(), remap.end(), LOVE_UINT32_MAX);
+	uint32 newcount = 0;
+	for (uint32 &i : indices)
+	{
+		if (remap[i] == LOVE_UINT32_MAX)
+			remap[i] = newcount++;
+		i = remap[i];
+	}
+
+	uint8 *newdata = nullptr;
+	try
+	{
+		newdata = new uint8[newcount * vertexStride];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory");
+	}
+
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] != LOVE_UINT32_MAX)
+			memcpy(newdata + remap[v] * vertexStride, vertexData + v * vertexStride, vertexStride);
+	}
+
+	std::vector<Buffer::DataDeclaration> format;
+	for (const Buffer::DataMember &member : vertexFormat)
+		format.push_back(member.decl);
+
+	StrongRef<Buffer> newbuffer;
+	BufferArena::Allocation newallocation;
+	try
+	{
+		if (arena.get())
+		{
+			newallocation = arena->allocate(newcount);
+			newbuffer.set(newallocation.buffer);
+			newbuffer->fill(newallocation.start * vertexStride, newcount * vertexStride, newdata);
+		}
+		else
+		{
+			auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+			Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, vertexBuffer->getDataUsage());
+			newbuffer.set(gfx->newBuffer(settings, format, newdata, newcount * vertexStride, 0), Acquire::NORETAIN);
+		}
+	}
+	catch (std::exception &)
+	{
+		delete[] newdata;
+		throw;
+	}
+
+	if (arena.get())
+	{
+		arena->free(arenaAllocation);
+		arenaAllocation = newallocation;
+	}
+
+	for (BufferAttribute &attrib : attachedAttributes)
+	{
+		if (attrib.buffer.get() == vertexBuffer.get())
+		{
+			attrib.buffer = newbuffer;
+			attrib.startArrayIndex = (int) getVertexBufferOffset();
+		}
+	}
+
+	delete[] vertexData;
+	vertexData = newdata;
+	vertexBuffer = newbuffer;
+	vertexCount = newcount;
+	modifiedVertexData.invalidate();
+	boundsDirty = true;
+
+	setVertexMap(indices);
+	setDrawRange();
+}
+
 void Mesh::setTexture(Texture *tex)
 {
 	texture.set(tex);
@@ -523,6 +827,118 @@ bool Mesh::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+bool Mesh::getBounds(float &x, float &y, float &w, float &h) const
+{
+	// Skinned vertices are moved by the bones on the GPU.
+	if (!bonePalette.empty())
+		return false;
+
+	if (boundsDirty)
+	{
+		boundsValid = computeBounds(bounds);
+		boundsDirty = false;
+	}
+
+	if (!boundsValid)
+		return false;
+
+	x = bounds[0];
+	y = bounds[1];
+	w = bounds[2];
+	h = bounds[3];
+	return true;
+}
+
+bool Mesh::computeBounds(float *b) const
+{
+	if (vertexData == nullptr || vertexCount == 0)
+		return false;
+
+	int index = getAttachedAttributeIndex(getConstant(ATTRIB_POS));
+	if (index == -1)
+		return false;
+
+	// Positions can only be read back when they're stored in this Mesh.
+	const BufferAttribute &attrib = attachedAttributes[index];
+	if (!attrib.enabled || attrib.buffer.get() != vertexBuffer.get() || attrib.mesh.get() != nullptr)
+		return false;
+
+	const auto &member = vertexBuffer->getDataMember(attrib.indexInBuffer);
+	DataFormat format = member.decl.format;
+	if (format != DATAFORMAT_FLOAT_VEC2 && format != DATAFORMAT_FLOAT_VEC3 && format != DATAFORMAT_FLOAT_VEC4)
+		return false;
+
+	float minx = std::numeric_limits<float>::max();
+	float miny = std::numeric_limits<float>::max();
+	float maxx = -std::numeric_limits<float>::max();
+	float maxy = -std::numeric_limits<float>::max();
+
+	const uint8 *data = vertexData + member.offset;
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const float *pos = (const float *) (data + i * vertexStride);
+		minx = std::min(minx, pos[0]);
+		miny = std::min(miny, pos[1]);
+		maxx = std::max(maxx, pos[0]);
+		maxy = std::max(maxy, pos[1]);
+	}
+
+	b[0] = minx;
+	b[1] = miny;
+	b[2] = maxx - minx;
+	b[3] = maxy - miny;
+	return true;
+}
+
+void Mesh::setBoneTransforms(const float *transforms, int bonecount)
+{
+	if (bonecount < 0 || bonecount > MAX_BONES)
+		throw love::Exception("Invalid bone count: %d (the maximum is %d)", bonecount, MAX_BONES);
+
+	bonePalette.assign((size_t) bonecount * 8, 0.0f);
+
+	for (int i = 0; i < bonecount; i++)
+		setBoneTransform(i, &transforms[i * 6]);
+}
+
+void Mesh::setBoneTransform(int index, const float *transform)
+{
+	if (index < 0 || index >= getBoneCount())
+		throw love::Exception("Invalid bone index: %d", index + 1);
+
+	float *bone = &bonePalette[(size_t) index * 8];
+
+	for (int i = 0; i < 6; i++)
+		bone[i] = transform[i];
+
+	bone[6] = 0.0f;
+	bone[7] = 0.0f;
+}
+
+int Mesh::getBoneCount() const
+{
+	return (int) (bonePalette.size() / 8);
+}
+
+void Mesh::sendBonePalette()
+{
+	Shader *shader = Shader::current;
+	if (shader == nullptr)
+		return;
+
+	const Shader::UniformInfo *info = shader->getUniformInfo("BonePalette");
+	if (info == nullptr || info->baseType != Shader::UNIFORM_FLOAT || info->components != 4)
+		return;
+
+	int count = std::min(info->count, getBoneCount() * 2);
+	if (count <= 0)
+		return;
+
+	memcpy(info->floats, bonePalette.data(), sizeof(float) * 4 * count);
+	shader->updateUniform(info, count);
+}
+
 void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 {
 	drawInstanced(gfx, m, 1);
@@ -530,11 +946,36 @@ void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 
 void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 {
-	if (vertexCount <= 0 || instancecount <= 0)
-		return;
+	drawInternal(gfx, m, instancecount, nullptr, 0, 0);
+}
+
+void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount)
+{
+	drawInternal(gfx, m, 0, indirectargs, argsindex, drawcount);
+}
+
+void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount)
+{
+	size_t argsoffset = 0;
+
+	if (indirectargs != nullptr)
+	{
+		argsoffset = gfx->validateIndirectArgs(indirectargs, argsindex, drawcount, useIndexBuffer && indexBuffer != nullptr);
 
-	if (instancecount > 1 && !gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
-		throw love::Exception("Instancing is not supported on this system.");
+		if (primitiveType == PRIMITIVE_TRIANGLE_FAN && gfx->getFanIndexBuffer())
+			throw love::Exception("The 'fan' Mesh draw mode cannot be used with indirect draws on this system.");
+
+		if (vertexCount <= 0 || drawcount <= 0)
+			return;
+	}
+	else
+	{
+		if (vertexCount <= 0 || instancecount <= 0)
+			return;
+
+		if (instancecount > 1 && !gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
+			throw love::Exception("Instancing is not supported on this system.");
+	}
 
 	// Some graphics backends don't natively support triangle fans. So we'd
 	// have to emulate them with triangles plus an index buffer... which doesn't
@@ -546,12 +987,29 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 
 	flush();
 
+	if (texture.get() && texture->isStreaming())
+		texture->markUsed(gfx->getTextureStreamingFrame());
+
+	bool skinned = !bonePalette.empty();
+
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	{
+		if (skinned)
+		{
+			if (Shader::standardShaders[Shader::STANDARD_SKINNED] == nullptr)
+				throw love::Exception("GPU skinning is not supported on this system.");
+			Shader::attachDefault(Shader::STANDARD_SKINNED);
+		}
+		else
+			Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	}
 
 	if (Shader::current)
 		Shader::current->validateDrawState(primitiveType, texture);
 
+	if (skinned)
+		sendBonePalette();
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
@@ -616,7 +1074,38 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 		}
 	}
 
-	if (indexbuffer != nullptr && indexcount > 0)
+	if (indirectargs != nullptr)
+	{
+		// The draw ranges come from the arguments buffer.
+		if (indexbuffer != nullptr)
+		{
+			Graphics::DrawIndexedCommand cmd(&attributes, &buffers, indexbuffer);
+
+			cmd.primitiveType = primitiveType;
+			cmd.indexType = indexDataType;
+			cmd.indirectBuffer = indirectargs;
+			cmd.indirectBufferOffset = argsoffset;
+			cmd.indirectDrawCount = drawcount;
+			cmd.texture = texture;
+			cmd.cullMode = gfx->getMeshCullMode();
+
+			gfx->draw(cmd);
+		}
+		else
+		{
+			Graphics::DrawCommand cmd(&attributes, &buffers);
+
+			cmd.primitiveType = primitiveType;
+			cmd.indirectBuffer = indirectargs;
+			cmd.indirectBufferOffset = argsoffset;
+			cmd.indirectDrawCount = drawcount;
+			cmd.texture = texture;
+			cmd.cullMode = gfx->getMeshCullMode();
+
+			gfx->draw(cmd);
+		}
+	}
+	else if (indexbuffer != nullptr && indexcount > 0)
 	{
 		Range r(0, indexcount);
 		if (range.isValid())
@@ -30,6 +30,7 @@
 #include "Texture.h"
 #include "vertex.h"
 #include "Buffer.h"
+#include "BufferArena.h"
 
 // C++
 #include <vector>
@@ -68,6 +69,12 @@ public:
 	Mesh(Graphics *gfx, const std::vector<Buffer::DataDeclaration> &vertexformat, int vertexcount, PrimitiveType drawmode, BufferDataUsage usage);
 	Mesh(const std::vector<BufferAttribute> &attributes, PrimitiveType drawmode);
 
+	/**
+	 * Creates a Mesh whose vertices live in a range suballocated from the
+	 * arena's shared vertex buffers. The data may be null.
+	 **/
+	Mesh(BufferArena *arena, const void *data, size_t vertexcount, PrimitiveType drawmode);
+
 	virtual ~Mesh();
 
 	/**
@@ -92,6 +99,12 @@ public:
 	 **/
 	Buffer *getVertexBuffer() const;
 
+	/**
+	 * Gets the array index of the Mesh's first vertex in its vertex buffer.
+	 * Only non-zero for Meshes created from a BufferArena.
+	 **/
+	size_t getVertexBufferOffset() const;
+
 	/**
 	 * Gets the format of each vertex attribute stored in the Mesh.
 	 **/
@@ -146,6 +159,17 @@ public:
 	 **/
 	size_t getIndexCount() const;
 
+	/**
+	 * Rebuilds the vertex data and vertex map of a triangle Mesh for faster
+	 * drawing: byte-identical vertices are merged, triangles are reordered for
+	 * post-transform vertex cache reuse, and vertices are reordered by first
+	 * use. Unused vertices are removed, so the vertex count may shrink. The
+	 * vertex map uses 16 bit indices when the new vertex count allows it.
+	 * The draw range is reset. Attributes which other Meshes attached from
+	 * this Mesh will keep using the previous vertex buffer.
+	 **/
+	void optimize();
+
 	/**
 	 * Sets the texture used when drawing the Mesh.
 	 **/
@@ -172,10 +196,28 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Sets the bone transforms used to skin the Mesh on the GPU. Each bone is
+	 * a 2D affine transform of 6 floats: the two columns of its 2x2 matrix
+	 * followed by its translation. While bones are set, the Mesh is drawn with
+	 * the skinned standard shader, which reads the VertexBoneIndices and
+	 * VertexBoneWeights attributes. Custom shaders which declare a BonePalette
+	 * uniform receive the bones as well.
+	 * A bone count of 0 disables skinning.
+	 **/
+	void setBoneTransforms(const float *transforms, int bonecount);
+	void setBoneTransform(int index, const float *transform);
+	int getBoneCount() const;
+
+	// Matches the size of the BonePalette array in the skinned shader.
+	static const int MAX_BONES = 64;
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
+	bool getBounds(float &x, float &y, float &w, float &h) const override;
 
 	void drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount);
+	void drawIndirect(Graphics *gfx, const Matrix4 &m, Buffer *indirectargs, int argsindex, int drawcount);
 
 	static std::vector<Buffer::DataDeclaration> getDefaultVertexFormat();
 
@@ -183,7 +225,11 @@ private:
 
 	friend class SpriteBatch;
 
+	void drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buffer *indirectargs, int argsindex, int drawcount);
+
 	void setupAttachedAttributes();
+	void sendBonePalette();
+	bool computeBounds(float *b) const;
 	int getAttachedAttributeIndex(const std::string &name) const;
 
 	std::vector<Buffer::DataMember> vertexFormat;
@@ -212,6 +258,17 @@ private:
 
 	StrongRef<Texture> texture;
 
+	// Bounding rectangle of the vertex positions, recomputed when they change.
+	mutable float bounds[4] = {};
+	mutable bool boundsDirty = true;
+	mutable bool boundsValid = false;
+
+	// Two vec4s per bone: the 2x2 matrix, then the translation.
+	std::vector<float> bonePalette;
+
+	StrongRef<BufferArena> arena;
+	BufferArena::Allocation arenaAllocation;
+
 }; // Mesh
 
 } // graphics
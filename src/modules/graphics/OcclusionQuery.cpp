@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type OcclusionQuery::type("OcclusionQuery", &Object::type);
+
+OcclusionQuery::OcclusionQuery(Graphics *gfx, bool precise)
+	: gfx(gfx)
+	, precise(precise)
+	, running(false)
+	, pending(false)
+	, complete(false)
+	, stopped(false)
+	, samples(0)
+{
+	if (!gfx->getCapabilities().features[Graphics::FEATURE_OCCLUSION_QUERY])
+		throw love::Exception("Occlusion queries are not supported on this system.");
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	if (gfx->activeOcclusionQuery == this)
+		gfx->activeOcclusionQuery = nullptr;
+}
+
+void OcclusionQuery::start()
+{
+	if (running)
+		throw love::Exception("OcclusionQuery:start cannot be called while the query is already running.");
+
+	if (gfx->activeOcclusionQuery != nullptr)
+		throw love::Exception("Only one OcclusionQuery can be running at a time.");
+
+	if (gfx->conditionalRenderQuery.get() == this)
+		throw love::Exception("An OcclusionQuery cannot be started while it's used for conditional rendering.");
+
+	// Batched draws submitted before this point shouldn't be counted.
+	gfx->flushBatchedDraws();
+
+	beginQuery();
+	gfx->activeOcclusionQuery = this;
+
+	running = true;
+	pending = false;
+	complete = false;
+}
+
+void OcclusionQuery::stop()
+{
+	if (!running)
+		throw love::Exception("OcclusionQuery:stop must be called after OcclusionQuery:start.");
+
+	gfx->flushBatchedDraws();
+
+	endQuery();
+	gfx->activeOcclusionQuery = nullptr;
+
+	running = false;
+	pending = true;
+	stopped = true;
+}
+
+void OcclusionQuery::update()
+{
+	if (!pending)
+		return;
+
+	uint64 result = 0;
+	if (!getResult(result))
+		return;
+
+	samples = precise ? result : (result > 0 ? 1 : 0);
+	pending = false;
+	complete = true;
+}
+
+void OcclusionQuery::beginConditionalRender()
+{
+	throw love::Exception("Conditional rendering is not supported on this system.");
+}
+
+void OcclusionQuery::endConditionalRender()
+{
+}
+
+} // graphics
+} // love
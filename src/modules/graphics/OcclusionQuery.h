@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Counts the samples which pass the depth and stencil tests for the draws
+ * between start() and stop(). Like TimerQuery, results are retrieved
+ * asynchronously and never stall the CPU.
+ *
+ * Non-precise queries only report whether any sample passed (as a count of 0
+ * or 1), which lets some GPUs stop counting early. Either kind can be used
+ * with Graphics::beginConditionalRender to skip draws on the GPU without
+ * waiting for the result on the CPU.
+ **/
+class OcclusionQuery : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	OcclusionQuery(Graphics *gfx, bool precise);
+	virtual ~OcclusionQuery();
+
+	void start();
+	void stop();
+
+	/**
+	 * Checks whether the GPU has finished the draws of the most recent
+	 * start/stop pair, without waiting for it.
+	 **/
+	void update();
+
+	bool isRunning() const { return running; }
+	bool isComplete() const { return complete; }
+	bool isPrecise() const { return precise; }
+
+	// Whether start/stop has been called at least once.
+	bool hasStopped() const { return stopped; }
+
+	uint64 getSampleCount() const { return samples; }
+
+	/**
+	 * Conditional rendering, for backends which support it. Draws between the
+	 * two calls are discarded by the GPU if no samples passed in the most
+	 * recent start/stop pair. Called by Graphics.
+	 **/
+	virtual void beginConditionalRender();
+	virtual void endConditionalRender();
+
+protected:
+
+	virtual void beginQuery() = 0;
+	virtual void endQuery() = 0;
+
+	// Returns false if the result isn't available yet. Must not block.
+	virtual bool getResult(uint64 &samples) = 0;
+
+	Graphics *gfx;
+	bool precise;
+
+private:
+
+	bool running;
+	bool pending;
+	bool complete;
+	bool stopped;
+	uint64 samples;
+
+}; // OcclusionQuery
+
+} // graphics
+} // love
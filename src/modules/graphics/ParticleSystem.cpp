@@ -25,11 +25,18 @@
 
 #include "common/math.h"
 #include "modules/math/RandomGenerator.h"
+#include "modules/thread/JobSystem.h"
 
 // STD
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
 
 namespace love
 {
@@ -39,7 +46,9 @@ namespace graphics
 namespace
 {
 
-love::math::RandomGenerator rng;
+// Particle systems can be updated on several threads at once, see
+// ParticleSystem::updateMany.
+thread_local love::math::RandomGenerator rng;
 
 float calculate_variation(float inner, float outer, float var)
 {
@@ -53,11 +62,15 @@ float calculate_variation(float inner, float outer, float var)
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
-ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+ParticleSystem::ParticleSystem(Texture *texture, uint32 size, bool gpu)
+	: particleStride(0)
+	, pendingBottomInserts(0)
+	, gpu(gpu)
+	, gpuEmitNext(0)
+	, gpuUsedSlots(0)
+	, gpuPendingEmits(0)
+	, gpuClearPending(true)
+	, gpuOriginShift()
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -95,6 +108,7 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, relativeRotation(false)
 	, vertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)
 	, buffer(nullptr)
+	, vertexCacheValid(false)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -102,6 +116,18 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	if (texture->getTextureType() != TEXTURE_2D)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
+	if (gpu)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		const auto &caps = gfx->getCapabilities();
+
+		if (!caps.features[Graphics::FEATURE_GLSL4])
+			throw love::Exception("GPU ParticleSystems are not supported on this system (GLSL4 support is required.)");
+
+		if ((size + 63) / 64 > (uint32) caps.limits[Graphics::LIMIT_THREADGROUPS_X])
+			throw love::Exception("Invalid ParticleSystem size.");
+	}
+
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
@@ -109,10 +135,14 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	: particleStride(0)
+	, pendingBottomInserts(0)
+	, gpu(p.gpu)
+	, gpuEmitNext(0)
+	, gpuUsedSlots(0)
+	, gpuPendingEmits(0)
+	, gpuClearPending(true)
+	, gpuOriginShift()
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -156,6 +186,7 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, relativeRotation(p.relativeRotation)
 	, vertexAttributes(p.vertexAttributes)
 	, buffer(nullptr)
+	, vertexCacheValid(false)
 {
 	setBufferSize(maxParticles);
 }
@@ -172,6 +203,8 @@ ParticleSystem *ParticleSystem::clone()
 
 void ParticleSystem::resetOffset()
 {
+	vertexCacheValid = false;
+
 	if (quads.empty())
 		offset = love::Vector2(float(texture->getWidth())*0.5f, float(texture->getHeight())*0.5f);
 	else
@@ -185,10 +218,21 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 		maxParticles = (uint32) size;
 
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gpu)
+		{
+			// Six vec4s per particle, see the particle shaders in Graphics.cpp.
+			// Uninitialized particles are killed by the first update.
+			Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+			buffer = gfx->newBuffer(settings, DATAFORMAT_FLOAT_VEC4, nullptr, sizeof(float) * 4 * 6 * size, 0);
+			return;
+		}
+
+		// Rounded up so SIMD code can always process four particles at once.
+		particleStride = (size + 3) & ~(size_t) 3;
+		particleData.resize(particleStride * PARTICLE_VALUE_MAX_ENUM);
 
 		size_t bytes = sizeof(Vertex) * size * 4;
 		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STREAM);
@@ -204,11 +248,11 @@ void ParticleSystem::createBuffers(size_t size)
 
 void ParticleSystem::deleteBuffers()
 {
-	delete[] pMem;
+	std::vector<float>().swap(particleData);
 	if (buffer)
 		buffer->release();
 
-	pMem = nullptr;
+	particleStride = 0;
 	buffer = nullptr;
 	maxParticles = 0;
 	activeParticles = 0;
@@ -233,28 +277,102 @@ void ParticleSystem::addParticle(float t)
 	if (isFull())
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
+	// New particles are always created at the end of the arrays.
+	uint32 index = activeParticles;
+	initParticle(index, t);
 
 	switch (insertMode)
 	{
 	default:
 	case INSERT_MODE_TOP:
-		insertTop(p);
 		break;
 	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
+		// Moving every particle for each new one would be slow, so they're
+		// moved to the front together in finishInsertion.
+		pendingBottomInserts++;
 		break;
 	case INSERT_MODE_RANDOM:
-		insertRandom(p);
+	{
+		// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+		// The other particles keep their order, so they're shifted together
+		// in finishInsertion rather than once per new particle.
+		uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+		pendingRandomInserts.push_back((uint32) pos);
 		break;
 	}
+	}
 
 	activeParticles++;
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::finishInsertion()
+{
+	if (!pendingRandomInserts.empty())
+	{
+		uint32 count = activeParticles;
+		uint32 inserts = (uint32) pendingRandomInserts.size();
+		uint32 first = count - inserts;
+
+		// Work out where each new particle ends up once the ones added after
+		// it have been inserted in front of it.
+		for (uint32 i = 0; i < inserts; i++)
+		{
+			for (uint32 j = i + 1; j < inserts; j++)
+			{
+				if (pendingRandomInserts[j] <= pendingRandomInserts[i])
+					pendingRandomInserts[i]++;
+			}
+		}
+
+		insertOrder.assign(count, LOVE_UINT32_MAX);
+		for (uint32 i = 0; i < inserts; i++)
+			insertOrder[pendingRandomInserts[i]] = first + i;
+
+		uint32 next = 0;
+		for (uint32 &src : insertOrder)
+		{
+			if (src == LOVE_UINT32_MAX)
+				src = next++;
+		}
+
+		insertScratch.resize(count);
+		for (int v = 0; v < PARTICLE_VALUE_MAX_ENUM; v++)
+		{
+			float *values = getValues((ParticleValue) v);
+			for (uint32 i = 0; i < count; i++)
+				insertScratch[i] = values[insertOrder[i]];
+			std::copy(insertScratch.begin(), insertScratch.end(), values);
+		}
+
+		pendingRandomInserts.clear();
+	}
+
+	if (pendingBottomInserts == 0)
+		return;
+
+	uint32 count = activeParticles;
+	uint32 first = count - pendingBottomInserts;
+
+	// The newest particle goes first, as if each one had been inserted at the
+	// front when it was added.
+	for (int v = 0; v < PARTICLE_VALUE_MAX_ENUM; v++)
+	{
+		float *values = getValues((ParticleValue) v);
+		std::rotate(values, values + first, values + count);
+		std::reverse(values, values + pendingBottomInserts);
+	}
+
+	pendingBottomInserts = 0;
+}
+
+void ParticleSystem::copyParticle(uint32 src, uint32 dst)
+{
+	float *data = particleData.data();
+	for (int v = 0; v < PARTICLE_VALUE_MAX_ENUM; v++)
+		data[particleStride * v + dst] = data[particleStride * v + src];
+}
+
+void ParticleSystem::initParticle(uint32 index, float t)
 {
 	float min,max;
 
@@ -263,13 +381,14 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	min = particleLifeMin;
 	max = particleLifeMax;
-	if (min == max)
-		p->life = min;
-	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+	float plife = min;
+	if (min != max)
+		plife = (float) rng.random(min, max);
 
-	p->position = pos;
+	getValues(PARTICLE_LIFE)[index] = plife;
+	getValues(PARTICLE_LIFETIME)[index] = plife;
+
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -285,15 +404,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -301,16 +420,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -319,26 +438,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -348,155 +467,62 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
-	p->origin = pos;
+	getValues(PARTICLE_POSITION_X)[index] = ppos.x;
+	getValues(PARTICLE_POSITION_Y)[index] = ppos.y;
+	getValues(PARTICLE_ORIGIN_X)[index] = pos.x;
+	getValues(PARTICLE_ORIGIN_Y)[index] = pos.y;
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	getValues(PARTICLE_VELOCITY_X)[index] = velocity.x;
+	getValues(PARTICLE_VELOCITY_Y)[index] = velocity.y;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	getValues(PARTICLE_LINEAR_ACCELERATION_X)[index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	getValues(PARTICLE_LINEAR_ACCELERATION_Y)[index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	getValues(PARTICLE_RADIAL_ACCELERATION)[index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	getValues(PARTICLE_TANGENTIAL_ACCELERATION)[index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	getValues(PARTICLE_LINEAR_DAMPING)[index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
+	float sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - sizeOffset;
+	getValues(PARTICLE_SIZE_OFFSET)[index] = sizeOffset;
+	getValues(PARTICLE_SIZE_INTERVAL_SIZE)[index] = sizeIntervalSize;
+	getValues(PARTICLE_SIZE)[index] = sizes[(size_t)(sizeOffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	getValues(PARTICLE_SPIN_START)[index] = calculate_variation(spinStart, spinEnd, spinVariation);
+	getValues(PARTICLE_SPIN_END)[index] = calculate_variation(spinEnd, spinStart, spinVariation);
+	float rotation = (float) rng.random(min, max);
+	getValues(PARTICLE_ROTATION)[index] = rotation;
 
-	p->angle = p->rotation;
+	float angle = rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
-
-	p->color = colors[0];
-
-	p->quadIndex = 0;
-}
-
-void ParticleSystem::insertTop(Particle *p)
-{
-	if (pHead == nullptr)
-	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
-	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
-
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
-	}
-	else
-	{
-		pHead->prev = p;
-		p->next = pHead;
-	}
-	p->prev = nullptr;
-	pHead = p;
-}
-
-void ParticleSystem::insertRandom(Particle *p)
-{
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+		angle += atan2f(velocity.y, velocity.x);
+	getValues(PARTICLE_ANGLE)[index] = angle;
 
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
-		return;
-	}
+	getValues(PARTICLE_COLOR_R)[index] = colors[0].r;
+	getValues(PARTICLE_COLOR_G)[index] = colors[0].g;
+	getValues(PARTICLE_COLOR_B)[index] = colors[0].b;
+	getValues(PARTICLE_COLOR_A)[index] = colors[0].a;
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+	getValues(PARTICLE_QUAD_INDEX)[index] = 0.0f;
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
-{
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
-
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
-
-	if (p->next)
-	{
-		p->next->prev = p->prev;
-		pNext = p->next;
-	}
-	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
-	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
-
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
-
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
-	}
-
-	activeParticles--;
-	return pNext;
-}
 
 void ParticleSystem::setTexture(Texture *tex)
 {
@@ -504,6 +530,7 @@ void ParticleSystem::setTexture(Texture *tex)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
 	texture.set(tex);
+	vertexCacheValid = false;
 
 	if (defaultOffset)
 		resetOffset();
@@ -580,6 +607,37 @@ void ParticleSystem::moveTo(float x, float y)
 	position = love::Vector2(x, y);
 }
 
+void ParticleSystem::translateOrigin(float x, float y)
+{
+	love::Vector2 offset(x, y);
+
+	position -= offset;
+	prevPosition -= offset;
+
+	if (gpu)
+	{
+		gpuOriginShift += offset;
+		return;
+	}
+
+	uint32 count = activeParticles;
+
+	float *px = getValues(PARTICLE_POSITION_X);
+	float *py = getValues(PARTICLE_POSITION_Y);
+	float *ox = getValues(PARTICLE_ORIGIN_X);
+	float *oy = getValues(PARTICLE_ORIGIN_Y);
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		px[i] -= x;
+		py[i] -= y;
+		ox[i] -= x;
+		oy[i] -= y;
+	}
+
+	vertexCacheValid = false;
+}
+
 void ParticleSystem::setEmissionArea(AreaSpreadDistribution distribution, float x, float y, float angle, bool directionRelativeToCenter)
 {
 	emissionArea = love::Vector2(x, y);
@@ -772,6 +830,7 @@ void ParticleSystem::setOffset(float x, float y)
 {
 	offset = love::Vector2(x, y);
 	defaultOffset = false;
+	vertexCacheValid = false;
 }
 
 love::Vector2 ParticleSystem::getOffset() const
@@ -800,6 +859,9 @@ std::vector<Colorf> ParticleSystem::getColor() const
 
 void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 {
+	if (gpu && newQuads.size() > (size_t) MAX_GPU_QUADS)
+		throw love::Exception("GPU ParticleSystems can use at most %d Quads.", MAX_GPU_QUADS);
+
 	std::vector<StrongRef<Quad>> quadlist;
 	quadlist.reserve(newQuads.size());
 
@@ -807,6 +869,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 		quadlist.push_back(q);
 
 	quads = quadlist;
+	vertexCacheValid = false;
 
 	if (defaultOffset)
 		resetOffset();
@@ -815,6 +878,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 void ParticleSystem::setQuads()
 {
 	quads.clear();
+	vertexCacheValid = false;
 }
 
 std::vector<Quad *> ParticleSystem::getQuads() const
@@ -840,6 +904,14 @@ bool ParticleSystem::hasRelativeRotation() const
 
 uint32 ParticleSystem::getCount() const
 {
+	if (gpu)
+	{
+		uint32 count = 0;
+		for (const GPUEmitBatch &batch : gpuBatches)
+			count += batch.count;
+		return std::min(count, gpuUsedSlots);
+	}
+
 	return activeParticles;
 }
 
@@ -862,13 +934,23 @@ void ParticleSystem::pause()
 
 void ParticleSystem::reset()
 {
-	if (pMem == nullptr)
+	vertexCacheValid = false;
+
+	if (gpu)
+	{
+		gpuEmitNext = 0;
+		gpuUsedSlots = 0;
+		gpuPendingEmits = 0;
+		gpuClearPending = true;
+		gpuBatches.clear();
+	}
+
+	if (particleData.empty() && !gpu)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
 	activeParticles = 0;
+	pendingBottomInserts = 0;
+	pendingRandomInserts.clear();
 	life = lifetime;
 	emitCounter = 0;
 }
@@ -878,10 +960,20 @@ void ParticleSystem::emit(uint32 num)
 	if (!active)
 		return;
 
+	vertexCacheValid = false;
+
+	if (gpu)
+	{
+		gpuPendingEmits = std::min(maxParticles, gpuPendingEmits + std::min(num, maxParticles));
+		return;
+	}
+
 	num = std::min(num, maxParticles - activeParticles);
 
 	while (num--)
 		addParticle(1.0f);
+
+	finishInsertion();
 }
 
 bool ParticleSystem::isActive() const
@@ -901,109 +993,241 @@ bool ParticleSystem::isStopped() const
 
 bool ParticleSystem::isEmpty() const
 {
-	return activeParticles == 0;
+	return getCount() == 0;
 }
 
 bool ParticleSystem::isFull() const
 {
-	return activeParticles == maxParticles;
+	return getCount() == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
+bool ParticleSystem::isGPU() const
 {
-	if (pMem == nullptr || dt == 0.0f)
-		return;
+	return gpu;
+}
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
+void ParticleSystem::removeDeadParticles()
+{
+	const float *life = getValues(PARTICLE_LIFE);
+	uint32 count = activeParticles;
+	uint32 alive = 0;
 
-	while (p)
+	// Compacts the arrays in place, keeping the remaining particles in order.
+	for (uint32 i = 0; i < count; i++)
 	{
-		// Decrease lifespan.
-		p->life -= dt;
+		if (life[i] <= 0.0f)
+			continue;
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
-		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
+		if (alive != i)
+			copyParticle(i, alive);
 
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
+		alive++;
+	}
 
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
+	activeParticles = alive;
+}
 
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
+void ParticleSystem::integrateParticles(float dt)
+{
+	uint32 count = activeParticles;
+
+	float *px = getValues(PARTICLE_POSITION_X);
+	float *py = getValues(PARTICLE_POSITION_Y);
+	const float *ox = getValues(PARTICLE_ORIGIN_X);
+	const float *oy = getValues(PARTICLE_ORIGIN_Y);
+	float *vx = getValues(PARTICLE_VELOCITY_X);
+	float *vy = getValues(PARTICLE_VELOCITY_Y);
+	const float *ax = getValues(PARTICLE_LINEAR_ACCELERATION_X);
+	const float *ay = getValues(PARTICLE_LINEAR_ACCELERATION_Y);
+	const float *radial = getValues(PARTICLE_RADIAL_ACCELERATION);
+	const float *tangential = getValues(PARTICLE_TANGENTIAL_ACCELERATION);
+	const float *damping = getValues(PARTICLE_LINEAR_DAMPING);
+	const float *life = getValues(PARTICLE_LIFE);
+	const float *lifetime = getValues(PARTICLE_LIFETIME);
+	float *rotation = getValues(PARTICLE_ROTATION);
+	float *angle = getValues(PARTICLE_ANGLE);
+	const float *spinstart = getValues(PARTICLE_SPIN_START);
+	const float *spinend = getValues(PARTICLE_SPIN_END);
+
+	uint32 i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 dt4 = _mm_set1_ps(dt);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 3 < count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(px + i);
+		__m128 y = _mm_loadu_ps(py + i);
+
+		// Direction from the particle's origin to the particle. Like
+		// Vector2::normalize, zero-length directions stay zero.
+		__m128 rx = _mm_sub_ps(x, _mm_loadu_ps(ox + i));
+		__m128 ry = _mm_sub_ps(y, _mm_loadu_ps(oy + i));
+		__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+		__m128 invlen = _mm_and_ps(_mm_cmpgt_ps(len, zero), _mm_div_ps(one, len));
+		rx = _mm_mul_ps(rx, invlen);
+		ry = _mm_mul_ps(ry, invlen);
+
+		// The tangential direction is the radial one rotated by 90 degrees.
+		__m128 ra = _mm_loadu_ps(radial + i);
+		__m128 ta = _mm_loadu_ps(tangential + i);
+		__m128 accx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(ry, ta)), _mm_loadu_ps(ax + i));
+		__m128 accy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), _mm_loadu_ps(ay + i));
+
+		__m128 damp = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(damping + i), dt4)));
+		__m128 velx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(accx, dt4)), damp);
+		__m128 vely = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(accy, dt4)), damp);
+
+		_mm_storeu_ps(vx + i, velx);
+		_mm_storeu_ps(vy + i, vely);
+		_mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(velx, dt4)));
+		_mm_storeu_ps(py + i, _mm_add_ps(y, _mm_mul_ps(vely, dt4)));
+
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(life + i), _mm_loadu_ps(lifetime + i)));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(spinstart + i), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(spinend + i), t));
+		__m128 rot = _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(spin, dt4));
+
+		_mm_storeu_ps(rotation + i, rot);
+		_mm_storeu_ps(angle + i, rot);
+	}
 
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
+#endif
 
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+	for (; i < count; i++)
+	{
+		love::Vector2 r(px[i] - ox[i], py[i] - oy[i]);
+		r.normalize();
+
+		float accx = r.x * radial[i] - r.y * tangential[i] + ax[i];
+		float accy = r.y * radial[i] + r.x * tangential[i] + ay[i];
+
+		float damp = 1.0f / (1.0f + damping[i] * dt);
+		vx[i] = (vx[i] + accx * dt) * damp;
+		vy[i] = (vy[i] + accy * dt) * damp;
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+		px[i] += vx[i] * dt;
+		py[i] += vy[i] * dt;
 
-			// Modify position.
-			ppos += p->velocity * dt;
+		const float t = 1.0f - life[i] / lifetime[i];
+
+		rotation[i] += (spinstart[i] * (1.0f - t) + spinend[i] * t) * dt;
+		angle[i] = rotation[i];
+	}
 
-			p->position = ppos;
+	if (relativeRotation)
+	{
+		for (i = 0; i < count; i++)
+			angle[i] += atan2f(vy[i], vx[i]);
+	}
+}
 
-			const float t = 1.0f - p->life / p->lifetime;
+void ParticleSystem::interpolateParticles()
+{
+	uint32 count = activeParticles;
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+	const float *life = getValues(PARTICLE_LIFE);
+	const float *lifetime = getValues(PARTICLE_LIFETIME);
 
-			p->angle = p->rotation;
+	// Change size according to given intervals:
+	// i = 0       1       2      3          n-1
+	//     |-------|-------|------|--- ... ---|
+	// t = 0    1/(n-1)        3/(n-1)        1
+	//
+	// `s' is the interpolation variable scaled to the current
+	// interval width, e.g. if n = 5 and t = 0.3, then the current
+	// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+	float *size = getValues(PARTICLE_SIZE);
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+	if (sizes.size() == 1)
+		std::fill(size, size + count, sizes[0]);
+	else
+	{
+		const float *sizeoffset = getValues(PARTICLE_SIZE_OFFSET);
+		const float *sizeinterval = getValues(PARTICLE_SIZE_INTERVAL_SIZE);
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - life[j] / lifetime[j];
+			float s = sizeoffset[j] + t * sizeinterval[j]; // size variation
 			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
 			size_t i = (size_t)s;
 			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
 			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
+			size[j] = sizes[i] * (1.0f - s) + sizes[k] * s;
+		}
+	}
 
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
+	// Update color according to given intervals (as above)
+	float *r = getValues(PARTICLE_COLOR_R);
+	float *g = getValues(PARTICLE_COLOR_G);
+	float *b = getValues(PARTICLE_COLOR_B);
+	float *a = getValues(PARTICLE_COLOR_A);
+
+	if (colors.size() == 1)
+	{
+		std::fill(r, r + count, colors[0].r);
+		std::fill(g, g + count, colors[0].g);
+		std::fill(b, b + count, colors[0].b);
+		std::fill(a, a + count, colors[0].a);
+	}
+	else
+	{
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - life[j] / lifetime[j];
+			float s = t * (float)(colors.size() - 1);
+			size_t i = (size_t)s;
+			size_t k = (i == colors.size() - 1) ? i : i + 1;
 			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
+			Colorf c = colors[i] * (1.0f - s) + colors[k] * s;
+			r[j] = c.r;
+			g[j] = c.g;
+			b[j] = c.b;
+			a[j] = c.a;
+		}
+	}
 
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+	// Update the quad index.
+	size_t k = quads.size();
+	if (k > 0)
+	{
+		float *quadindex = getValues(PARTICLE_QUAD_INDEX);
 
-			// Next particle.
-			p = p->next;
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - life[j] / lifetime[j];
+			float s = t * (float) k; // [0:numquads-1] (clamped below)
+			size_t i = (s > 0.0f) ? (size_t) s : 0;
+			quadindex[j] = (float) ((i < k) ? i : k - 1);
 		}
 	}
+}
+
+void ParticleSystem::update(float dt)
+{
+	if (gpu)
+	{
+		if (buffer != nullptr && dt != 0.0f)
+			updateGPU(dt);
+		return;
+	}
+
+	if (particleData.empty() || dt == 0.0f)
+		return;
+
+	vertexCacheValid = false;
+
+	// Decrease lifespans.
+	float *particlelife = getValues(PARTICLE_LIFE);
+	for (uint32 i = 0; i < activeParticles; i++)
+		particlelife[i] -= dt;
+
+	removeDeadParticles();
+	integrateParticles(dt);
+	interpolateParticles();
 
 	// Make some more particles.
 	if (active)
@@ -1017,6 +1241,8 @@ void ParticleSystem::update(float dt)
 			emitCounter -= rate;
 		}
 
+		finishInsertion();
+
 		life -= dt;
 		if (lifetime != -1 && life < 0)
 			stop();
@@ -1025,47 +1251,44 @@ void ParticleSystem::update(float dt)
 	prevPosition = position;
 }
 
-void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+void ParticleSystem::generateVertices(Vertex *pVerts) const
 {
-	uint32 pCount = getCount();
-
-	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
-		return;
-
-	gfx->flushBatchedDraws();
-
-	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
-
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+	uint32 pCount = activeParticles;
 
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
-	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
-	Particle *p = pHead;
+	const float *px = getValues(PARTICLE_POSITION_X);
+	const float *py = getValues(PARTICLE_POSITION_Y);
+	const float *angle = getValues(PARTICLE_ANGLE);
+	const float *size = getValues(PARTICLE_SIZE);
+	const float *r = getValues(PARTICLE_COLOR_R);
+	const float *g = getValues(PARTICLE_COLOR_G);
+	const float *b = getValues(PARTICLE_COLOR_B);
+	const float *a = getValues(PARTICLE_COLOR_A);
+	const float *quadindex = getValues(PARTICLE_QUAD_INDEX);
 
 	bool useQuads = !quads.empty();
 
 	Matrix3 t;
 
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 i = 0; i < pCount; i++)
 	{
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			Quad *quad = quads[(size_t) quadindex[i]];
+			positions = quad->getVertexPositions();
+			texcoords = quad->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
+		t.setTransformation(px[i], py[i], angle[i], size[i], size[i], offset.x, offset.y, 0.0f, 0.0f);
 		t.transformXY(pVerts, positions, 4);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+		Color32 c = toColor32(Colorf(r[i], g[i], b[i], a[i]));
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
@@ -1076,8 +1299,342 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 		}
 
 		pVerts += 4;
-		p = p->next;
 	}
+}
+
+void ParticleSystem::prepareVertices()
+{
+	if (gpu || texture.get() == nullptr)
+		return;
+
+	vertexCache.resize((size_t) activeParticles * 4);
+	generateVertices(vertexCache.data());
+	vertexCacheValid = true;
+}
+
+void ParticleSystem::updateGroup(ParticleSystem * const *systems, size_t count, float dt, uint64 seed)
+{
+	// Groups can run on the thread which called updateMany, so its generator's
+	// state is restored afterwards.
+	std::string state = rng.getState();
+
+	love::math::RandomGenerator::Seed s;
+	s.b64 = seed;
+	rng.setSeed(s);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		systems[i]->update(dt);
+		systems[i]->prepareVertices();
+	}
+
+	rng.setState(state);
+}
+
+void ParticleSystem::updateMany(const std::vector<ParticleSystem *> &systems, float dt)
+{
+	// A system listed twice must not be updated on two threads at once.
+	std::vector<ParticleSystem *> unique = systems;
+	std::sort(unique.begin(), unique.end());
+	unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+	std::vector<ParticleSystem *> cpusystems;
+	cpusystems.reserve(unique.size());
+
+	uint64 totalparticles = 0;
+
+	for (ParticleSystem *p : unique)
+	{
+		// GPU systems dispatch compute work, which only the main thread can.
+		if (p->gpu)
+			p->update(dt);
+		else
+		{
+			cpusystems.push_back(p);
+			totalparticles += p->activeParticles;
+		}
+	}
+
+	love::thread::JobSystem *jobsystem = love::thread::JobSystem::getInstance();
+
+	int threadcount = std::min(jobsystem->getWorkerCount() + 1, MAX_UPDATE_THREADS);
+	threadcount = std::min(threadcount, (int) cpusystems.size());
+
+	if (threadcount < 2 || totalparticles < PARALLEL_UPDATE_MIN_PARTICLES)
+	{
+		for (ParticleSystem *p : cpusystems)
+			p->update(dt);
+		return;
+	}
+
+	// Split into contiguous groups with roughly the same number of particles.
+	// Systems are weighted a little extra so empty ones still spread out.
+	const uint64 systemweight = 16;
+	uint64 totalweight = totalparticles + systemweight * cpusystems.size();
+
+	std::vector<size_t> groupstarts = {0};
+	uint64 weight = 0;
+
+	for (size_t i = 0; i < cpusystems.size(); i++)
+	{
+		uint64 groupend = totalweight * groupstarts.size() / threadcount;
+		if (weight >= groupend && (int) groupstarts.size() < threadcount && i > groupstarts.back())
+			groupstarts.push_back(i);
+
+		weight += cpusystems[i]->activeParticles + systemweight;
+	}
+
+	groupstarts.push_back(cpusystems.size());
+
+	// Each group gets its own random sequence, seeded by this thread's
+	// generator, so results don't depend on which thread runs the group.
+	size_t groupcount = groupstarts.size() - 1;
+	std::vector<uint64> seeds(groupcount);
+	for (uint64 &seed : seeds)
+		seed = rng.rand();
+
+	jobsystem->parallelFor(groupcount, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t g = begin; g < end; g++)
+		{
+			size_t start = groupstarts[g];
+			updateGroup(cpusystems.data() + start, groupstarts[g + 1] - start, dt, seeds[g]);
+		}
+	});
+}
+
+void ParticleSystem::updateGPU(float dt)
+{
+	uint32 count = gpuPendingEmits;
+	gpuPendingEmits = 0;
+
+	// Same emission timing as CPU particle systems.
+	if (active)
+	{
+		float rate = 1.0f / emissionRate;
+		emitCounter += dt;
+		while (emitCounter > rate)
+		{
+			count++;
+			emitCounter -= rate;
+		}
+
+		life -= dt;
+		if (lifetime != -1 && life < 0)
+			stop();
+	}
+
+	count = std::min(count, maxParticles);
+
+	for (GPUEmitBatch &batch : gpuBatches)
+		batch.timeLeft -= dt;
+
+	bool hadparticles = !gpuBatches.empty();
+	gpuBatches.erase(std::remove_if(gpuBatches.begin(), gpuBatches.end(), [](const GPUEmitBatch &b) { return b.timeLeft <= 0.0f; }), gpuBatches.end());
+
+	// Rounding can leave a particle barely alive after its batch is gone, so
+	// the buffer starts over once every batch is.
+	if (hadparticles && gpuBatches.empty())
+	{
+		gpuEmitNext = 0;
+		gpuUsedSlots = 0;
+		gpuClearPending = true;
+	}
+
+	if (gpuBatches.empty() && count == 0)
+	{
+		prevPosition = position;
+		gpuOriginShift = love::Vector2();
+		return;
+	}
+
+	if (count > 0)
+		gpuBatches.push_back({std::max(particleLifeMin, particleLifeMax), count});
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	Shader *shader = gfx->getParticleComputeShader();
+
+	const Shader::UniformInfo *stateinfo = shader->getUniformInfo("EmitState");
+	const Shader::UniformInfo *optionsinfo = shader->getUniformInfo("EmitOptions");
+	const Shader::UniformInfo *paramsinfo = shader->getUniformInfo("Params");
+	const Shader::UniformInfo *sizesinfo = shader->getUniformInfo("Sizes");
+	const Shader::UniformInfo *colorsinfo = shader->getUniformInfo("Colors");
+	const Shader::UniformInfo *bufferinfo = shader->getUniformInfo("ParticleBuffer");
+
+	if (stateinfo == nullptr || optionsinfo == nullptr || paramsinfo == nullptr || bufferinfo == nullptr)
+		throw love::Exception("Could not find the particle update shader's variables.");
+
+	stateinfo->ints[0] = (int) gpuEmitNext;
+	stateinfo->ints[1] = (int) count;
+	stateinfo->ints[2] = (int) maxParticles;
+	stateinfo->ints[3] = (int) (rng.rand() & 0x7FFFFFFF);
+	shader->updateUniform(stateinfo, 1);
+
+	int flags = (directionRelativeToEmissionCenter ? 1 : 0) | (relativeRotation ? 2 : 0) | (gpuClearPending ? 4 : 0);
+	optionsinfo->ints[0] = (int) emissionAreaDistribution;
+	optionsinfo->ints[1] = flags;
+	optionsinfo->ints[2] = (int) sizes.size();
+	optionsinfo->ints[3] = (int) colors.size();
+	shader->updateUniform(optionsinfo, 1);
+
+	const float params[] =
+	{
+		dt, direction, spread, emissionAreaAngle,
+		position.x, position.y, prevPosition.x, prevPosition.y,
+		particleLifeMin, particleLifeMax, speedMin, speedMax,
+		linearAccelerationMin.x, linearAccelerationMin.y, linearAccelerationMax.x, linearAccelerationMax.y,
+		radialAccelerationMin, radialAccelerationMax, tangentialAccelerationMin, tangentialAccelerationMax,
+		linearDampingMin, linearDampingMax, rotationMin, rotationMax,
+		spinStart, spinEnd, spinVariation, sizeVariation,
+		emissionArea.x, emissionArea.y, gpuOriginShift.x, gpuOriginShift.y,
+	};
+
+	memcpy(paramsinfo->floats, params, std::min(sizeof(params), sizeof(float) * 4 * paramsinfo->count));
+	shader->updateUniform(paramsinfo, paramsinfo->count);
+
+	// Unused sizes and colors may have been optimized out of the shader.
+	if (sizesinfo != nullptr)
+	{
+		int n = std::min((int) sizes.size(), sizesinfo->count * 4);
+		memcpy(sizesinfo->floats, sizes.data(), sizeof(float) * n);
+		shader->updateUniform(sizesinfo, sizesinfo->count);
+	}
+
+	if (colorsinfo != nullptr)
+	{
+		int n = std::min((int) colors.size(), colorsinfo->count);
+		memcpy(colorsinfo->floats, colors.data(), sizeof(Colorf) * n);
+		shader->updateUniform(colorsinfo, colorsinfo->count);
+	}
+
+	shader->sendBuffers(bufferinfo, &buffer, 1);
+	gfx->dispatchThreadgroups(shader, (maxParticles + 63) / 64, 1, 1);
+
+	gpuEmitNext = (gpuEmitNext + count) % maxParticles;
+	gpuUsedSlots = std::min(maxParticles, gpuUsedSlots + count);
+	gpuClearPending = false;
+	gpuOriginShift = love::Vector2();
+
+	prevPosition = position;
+}
+
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	uint32 slots = gpuUsedSlots;
+
+	if (slots == 0 || gpuBatches.empty() || texture.get() == nullptr || buffer == nullptr)
+		return;
+
+	Shader *shader = gfx->getParticleRenderShader();
+
+	const Shader::UniformInfo *paramsinfo = shader->getUniformInfo("RenderParams");
+	const Shader::UniformInfo *quadsinfo = shader->getUniformInfo("Quads");
+	const Shader::UniformInfo *bufferinfo = shader->getUniformInfo("ParticleBuffer");
+
+	if (paramsinfo == nullptr || quadsinfo == nullptr || bufferinfo == nullptr)
+		throw love::Exception("Could not find the particle drawing shader's variables.");
+
+	gfx->flushBatchedDraws();
+
+	if (texture->isStreaming())
+		texture->markUsed(gfx->getTextureStreamingFrame());
+
+	// Each quad is its texture rectangle followed by its size.
+	int quadcount = std::min(std::max((int) quads.size(), 1), quadsinfo->count / 2);
+	for (int i = 0; i < quadcount; i++)
+	{
+		Quad *quad = quads.empty() ? texture->getQuad() : quads[i].get();
+		const Vector2 *positions = quad->getVertexPositions();
+		const Vector2 *texcoords = quad->getVertexTexCoords();
+
+		float *q = quadsinfo->floats + i * 8;
+		q[0] = texcoords[0].x;
+		q[1] = texcoords[0].y;
+		q[2] = texcoords[3].x - texcoords[0].x;
+		q[3] = texcoords[3].y - texcoords[0].y;
+		q[4] = positions[3].x;
+		q[5] = positions[3].y;
+		q[6] = 0.0f;
+		q[7] = 0.0f;
+	}
+
+	shader->updateUniform(quadsinfo, quadcount * 2);
+
+	paramsinfo->floats[0] = offset.x;
+	paramsinfo->floats[1] = offset.y;
+	paramsinfo->floats[2] = (float) quadcount;
+	paramsinfo->floats[3] = 0.0f;
+	shader->updateUniform(paramsinfo, 1);
+
+	shader->sendBuffers(bufferinfo, &buffer, 1);
+
+	Shader *prevshader = Shader::current;
+	shader->attach();
+
+	try
+	{
+		shader->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+		Graphics::TempTransform transform(gfx, m);
+
+		// Every slot in use is drawn, dead particles are discarded by the
+		// vertex shader.
+		VertexAttributes attributes;
+		BufferBindings buffers;
+
+		Graphics::DrawIndexedCommand cmd(&attributes, &buffers, gfx->getQuadIndexBuffer());
+		cmd.primitiveType = PRIMITIVE_TRIANGLES;
+		cmd.indexCount = 6;
+		cmd.instanceCount = (int) slots;
+		cmd.indexType = INDEX_UINT16;
+		cmd.texture = texture;
+		gfx->draw(cmd);
+	}
+	catch (love::Exception &)
+	{
+		if (prevshader != nullptr)
+			prevshader->attach();
+		else
+			Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		throw;
+	}
+
+	if (prevshader != nullptr)
+		prevshader->attach();
+	else
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+}
+
+void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (gpu)
+	{
+		drawGPU(gfx, m);
+		return;
+	}
+
+	uint32 pCount = getCount();
+
+	if (pCount == 0 || texture.get() == nullptr || particleData.empty() || buffer == nullptr)
+		return;
+
+	gfx->flushBatchedDraws();
+
+	if (texture->isStreaming())
+		texture->markUsed(gfx->getTextureStreamingFrame());
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
+
+	if (vertexCacheValid)
+		memcpy(pVerts, vertexCache.data(), sizeof(Vertex) * 4 * pCount);
+	else
+		generateVertices(pVerts);
 
 	buffer->unmap(0, pCount * sizeof(Vertex) * 4);
 
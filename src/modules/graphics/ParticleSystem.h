@@ -83,10 +83,17 @@ public:
 	 **/
 	static const uint32 MAX_PARTICLES = LOVE_INT32_MAX / 4;
 
+	/**
+	 * Maximum number of Quads a GPU ParticleSystem can use.
+	 **/
+	static const int MAX_GPU_QUADS = 64;
+
 	/**
 	 * Creates a particle system with the specified buffer size and texture.
+	 * GPU particle systems emit, update and draw their particles with shaders
+	 * instead of on the CPU, and need GLSL 4 support.
 	 **/
-	ParticleSystem(Texture *texture, uint32 buffer);
+	ParticleSystem(Texture *texture, uint32 buffer, bool gpu);
 	ParticleSystem(const ParticleSystem &p);
 
 	/**
@@ -193,6 +200,13 @@ public:
 	 **/
 	void moveTo(float x, float y);
 
+	/**
+	 * Moves the emitter and every live particle by (-x, -y), for when the
+	 * world's origin is moved to (x, y). GPU particles are moved by the next
+	 * update.
+	 **/
+	void translateOrigin(float x, float y);
+
 	/**
 	 * Sets the emission area spread parameters and distribution type. The interpretation of
 	 * the parameters depends on the distribution type:
@@ -453,6 +467,8 @@ public:
 
 	/**
 	 * Returns the amount of particles that are currently active in the system.
+	 * GPU particle systems can't know this exactly without reading their
+	 * particles back, so it's an upper bound for them.
 	 **/
 	uint32 getCount() const;
 
@@ -477,7 +493,8 @@ public:
 	void reset();
 
 	/**
-	 * Instantly emits a number of particles.
+	 * Instantly emits a number of particles. GPU particle systems emit them
+	 * during the next update.
 	 * @param num The number of particles to emit.
 	 **/
 	void emit(uint32 num);
@@ -510,9 +527,22 @@ public:
 	 **/
 	void update(float dt);
 
+	/**
+	 * Updates many particle systems, split across several threads when they
+	 * have enough particles between them. Those threads also generate the
+	 * vertices for each system's next draw. GPU particle systems are updated
+	 * on the calling thread.
+	 **/
+	static void updateMany(const std::vector<ParticleSystem *> &systems, float dt);
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
+	/**
+	 * Returns whether the particles are simulated and drawn on the GPU.
+	 **/
+	bool isGPU() const;
+
 	static bool getConstant(const char *in, AreaSpreadDistribution &out);
 	static bool getConstant(AreaSpreadDistribution in, const char *&out);
 	static std::vector<std::string> getConstants(AreaSpreadDistribution);
@@ -523,66 +553,135 @@ public:
 
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Systems with fewer particles than this between them are always updated
+	// on one thread.
+	static const uint32 PARALLEL_UPDATE_MIN_PARTICLES = 8192;
+	static const int MAX_UPDATE_THREADS = 8;
+
+	// The values stored for each particle. Each one has its own array in
+	// particleData, so updates can process many particles at a time.
+	enum ParticleValue
 	{
-		Particle *prev;
-		Particle *next;
+		PARTICLE_LIFE,
+		PARTICLE_LIFETIME,
+		PARTICLE_POSITION_X,
+		PARTICLE_POSITION_Y,
+		PARTICLE_ORIGIN_X, // Particles gravitate towards this point.
+		PARTICLE_ORIGIN_Y,
+		PARTICLE_VELOCITY_X,
+		PARTICLE_VELOCITY_Y,
+		PARTICLE_LINEAR_ACCELERATION_X,
+		PARTICLE_LINEAR_ACCELERATION_Y,
+		PARTICLE_RADIAL_ACCELERATION,
+		PARTICLE_TANGENTIAL_ACCELERATION,
+		PARTICLE_LINEAR_DAMPING,
+		PARTICLE_SIZE,
+		PARTICLE_SIZE_OFFSET,
+		PARTICLE_SIZE_INTERVAL_SIZE,
+		PARTICLE_ROTATION, // Amount of rotation applied to the final angle.
+		PARTICLE_ANGLE,
+		PARTICLE_SPIN_START,
+		PARTICLE_SPIN_END,
+		PARTICLE_COLOR_R,
+		PARTICLE_COLOR_G,
+		PARTICLE_COLOR_B,
+		PARTICLE_COLOR_A,
+		PARTICLE_QUAD_INDEX, // Stored as a float, like everything else.
+		PARTICLE_VALUE_MAX_ENUM
+	};
+
+	float *getValues(ParticleValue value)
+	{
+		return particleData.data() + particleStride * value;
+	}
+
+	const float *getValues(ParticleValue value) const
+	{
+		return particleData.data() + particleStride * value;
+	}
+
+	void resetOffset();
+
+	void createBuffers(size_t size);
+	void deleteBuffers();
+
+	void addParticle(float t);
 
-		float lifetime;
-		float life;
+	// Called by addParticle.
+	void initParticle(uint32 index, float t);
 
-		love::Vector2 position;
+	// Moves particles added at the end in bottom and random insert modes to
+	// their place.
+	void finishInsertion();
 
-		// Particles gravitate towards this point.
-		love::Vector2 origin;
+	void copyParticle(uint32 src, uint32 dst);
 
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
+	// Called by update.
+	void removeDeadParticles();
+	void integrateParticles(float dt);
+	void interpolateParticles();
 
-		float linearDamping;
+	// Writes four vertices for each active particle.
+	void generateVertices(Vertex *vertices) const;
 
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
+	// Generates the vertices for the next draw ahead of time, into vertexCache.
+	void prepareVertices();
 
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
+	// Updates one of updateMany's groups of systems, from a job.
+	static void updateGroup(ParticleSystem * const *systems, size_t count, float dt, uint64 seed);
 
-		Colorf color;
+	void updateGPU(float dt);
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
 
-		int quadIndex;
+	// Particles emitted together on the GPU, and the time until the last of
+	// them is dead.
+	struct GPUEmitBatch
+	{
+		float timeLeft;
+		uint32 count;
 	};
 
-	void resetOffset();
+	// Every per-particle value. The active particles are packed at the start
+	// of each value's array, in draw order.
+	std::vector<float> particleData;
 
-	void createBuffers(size_t size);
-	void deleteBuffers();
+	// The length of each value's array.
+	size_t particleStride;
 
-	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
+	// Particles added at the end which still have to be moved to the front.
+	uint32 pendingBottomInserts;
 
-	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	// Where each particle added at the end in random insert mode goes, among
+	// the particles active when it was added.
+	std::vector<uint32> pendingRandomInserts;
+
+	// Reused by finishInsertion for random inserts.
+	std::vector<uint32> insertOrder;
+	std::vector<float> insertScratch;
+
+	// Whether the particles live in a storage buffer and are updated by a
+	// compute shader, rather than in particleData.
+	bool gpu;
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// GPU particles are emitted into the storage buffer as a ring. This is
+	// the next slot to emit into.
+	uint32 gpuEmitNext;
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// The number of slots at the start of the storage buffer which have been
+	// emitted into since the last reset.
+	uint32 gpuUsedSlots;
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	// Particles emitted by emit(), for the next update to create.
+	uint32 gpuPendingEmits;
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Whether the next update has to kill every particle which isn't emitted.
+	bool gpuClearPending;
+
+	// Subtracted from every GPU particle's position by the next update, see
+	// translateOrigin.
+	love::Vector2 gpuOriginShift;
+
+	std::vector<GPUEmitBatch> gpuBatches;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -674,8 +773,15 @@ private:
 	bool relativeRotation;
 
 	const VertexAttributes vertexAttributes;
+
+	// Vertices for CPU particle systems, particle data for GPU ones.
 	Buffer *buffer;
 
+	// Vertices generated by prepareVertices, valid until the particles or
+	// anything else affecting their vertices changes.
+	std::vector<Vertex> vertexCache;
+	bool vertexCacheValid;
+
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "PendingShader.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type PendingShader::type("PendingShader", &Object::type);
+
+PendingShader::PendingShader(Graphics *gfx, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute)
+	: gfx(gfx)
+	, sources(sources)
+	, options(options)
+	, compute(compute)
+	, loadedFromCache(false)
+	, needsSPIRV(gfx->getRenderer() != RENDERER_OPENGL)
+	, compiled(false)
+	, state(STATE_COMPILING)
+{
+	// Errors which don't need the code to be compiled are reported right away,
+	// like they are by newShader.
+	ShaderBundle::getStageSources(this->sources, options, compute, stageSources);
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (stageSources[i].source != nullptr)
+			Shader::checkSystemFeatures(gfx, (ShaderStageType) i, stageSources[i].info);
+	}
+
+	variant.code = gfx->getShaderCodeVariant();
+
+	cacheFilename = gfx->getShaderCacheFilename(this->sources, options, compute);
+	if (!cacheFilename.empty() && gfx->loadCachedShaderVariant(cacheFilename, this->sources, options, variant))
+	{
+		loadedFromCache = true;
+		compiled.store(true);
+	}
+}
+
+PendingShader::PendingShader(Shader *shader)
+	: gfx(nullptr)
+	, compute(false)
+	, loadedFromCache(false)
+	, needsSPIRV(false)
+	, compiled(true)
+	, state(STATE_DONE)
+	, shader(shader)
+{
+}
+
+PendingShader::~PendingShader()
+{
+}
+
+bool PendingShader::isReady()
+{
+	update(false);
+	return state == STATE_DONE;
+}
+
+Shader *PendingShader::getShader()
+{
+	update(true);
+
+	if (shader.get() == nullptr)
+		throw love::Exception("%s", error.c_str());
+
+	return shader;
+}
+
+void PendingShader::compile()
+{
+	try
+	{
+		ShaderBundle::compileVariant(stageSources, variant);
+
+		std::string err;
+		if (needsSPIRV && !ShaderBundle::compileSPIRV(variant.glsl, variant.code.gles, variant.spirv, err))
+			throw love::Exception("%s", err.c_str());
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+	}
+
+	compiled.store(true);
+}
+
+void PendingShader::update(bool wait)
+{
+	if (state == STATE_COMPILING)
+	{
+		if (!compiled.load())
+		{
+			if (!wait)
+				return;
+
+			gfx->waitForShaderCompile(this);
+		}
+
+		if (!error.empty())
+		{
+			state = STATE_DONE;
+			return;
+		}
+
+		try
+		{
+			for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+			{
+				if (variant.glsl[i].empty())
+					continue;
+
+				auto stype = (ShaderStageType) i;
+				stages[i].set(gfx->newShaderStageInternal(stype, "", variant.glsl[i], variant.code.gles, &variant.spirv[i]), Acquire::NORETAIN);
+				stages[i]->startAsyncCompile();
+			}
+		}
+		catch (love::Exception &e)
+		{
+			if (retryWithoutCache())
+			{
+				update(wait);
+				return;
+			}
+
+			error = e.what();
+			state = STATE_DONE;
+			return;
+		}
+
+		state = STATE_COMPILING_STAGES;
+	}
+
+	if (state == STATE_COMPILING_STAGES)
+	{
+		if (!wait)
+		{
+			for (const auto &stage : stages)
+			{
+				if (stage.get() != nullptr && !stage->isAsyncCompileComplete())
+					return;
+			}
+		}
+
+		// Linking isn't asynchronous, it's usually much faster than compiling
+		// the stages.
+		try
+		{
+			shader.set(gfx->newShaderInternal(stages, &variant.reflection), Acquire::NORETAIN);
+			shader->setVariantSource(sources, options, compute);
+
+			if (!loadedFromCache && !cacheFilename.empty())
+				gfx->saveCachedShaderVariant(cacheFilename, sources, options, compute, variant);
+		}
+		catch (love::Exception &e)
+		{
+			if (retryWithoutCache())
+			{
+				update(wait);
+				return;
+			}
+
+			error = e.what();
+		}
+
+		for (auto &stage : stages)
+			stage.set(nullptr);
+
+		variant = ShaderBundle::Variant();
+		state = STATE_DONE;
+	}
+}
+
+bool PendingShader::retryWithoutCache()
+{
+	// The cached code may not work anymore after a driver update, for
+	// example. It's compiled from source like any other shader in that case.
+	if (!loadedFromCache)
+		return false;
+
+	loadedFromCache = false;
+
+	for (auto &stage : stages)
+		stage.set(nullptr);
+
+	variant = ShaderBundle::Variant();
+	variant.code = gfx->getShaderCodeVariant();
+
+	compiled.store(false);
+	state = STATE_COMPILING;
+
+	gfx->queuedShaderCompiles.push_back(this);
+	return true;
+}
+
+ShaderCompileJob::ShaderCompileJob()
+{
+	threadName = "ShaderCompile";
+}
+
+void ShaderCompileJob::threadFunction()
+{
+	for (const auto &shader : shaders)
+		shader->compile();
+}
+
+} // graphics
+} // love
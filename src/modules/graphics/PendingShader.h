@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "Shader.h"
+#include "ShaderStage.h"
+#include "ShaderBundle.h"
+
+// C++
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A Shader which is compiled in the background. Code generation, glslang
+ * validation and SPIR-V generation run on a worker thread. The backend's
+ * shader objects are created on the main thread afterwards - with OpenGL
+ * drivers that support parallel shader compilation, the stages are compiled
+ * in the background as well before the program is linked.
+ **/
+class PendingShader : public Object
+{
+public:
+
+	static love::Type type;
+
+	PendingShader(Graphics *gfx, const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute);
+
+	// For shaders which didn't need to be compiled asynchronously, such as
+	// ones loaded from a precompiled bundle.
+	PendingShader(Shader *shader);
+
+	virtual ~PendingShader();
+
+	/**
+	 * Whether getShader can return without waiting for the compile to finish.
+	 **/
+	bool isReady();
+
+	/**
+	 * Waits for the compile to finish if needed. Throws an exception if the
+	 * shader failed to compile.
+	 **/
+	Shader *getShader();
+
+	// Internal use only, called by Graphics on the main thread. Creates the
+	// backend objects once the worker thread is done with the shader.
+	void update(bool wait);
+
+	// Internal use only. Runs on a worker thread, or on the main thread if
+	// the shader is needed before a worker picks it up.
+	void compile();
+
+	// Internal use only. False if the shader was loaded from the disk cache
+	// and doesn't need to be queued for compilation.
+	bool needsCompile() const { return !loadedFromCache; }
+
+private:
+
+	enum State
+	{
+		STATE_COMPILING,
+		STATE_COMPILING_STAGES,
+		STATE_DONE,
+	};
+
+	bool retryWithoutCache();
+
+	Graphics *gfx;
+
+	std::vector<std::string> sources;
+	Shader::CompileOptions options;
+	bool compute;
+
+	std::string cacheFilename;
+	bool loadedFromCache;
+	ShaderBundle::StageSource stageSources[SHADERSTAGE_MAX_ENUM];
+
+	bool needsSPIRV;
+	ShaderBundle::Variant variant;
+
+	// Written by the worker thread before compiled is set.
+	std::string error;
+	std::atomic<bool> compiled;
+
+	State state;
+
+	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM];
+	StrongRef<Shader> shader;
+
+}; // PendingShader
+
+// Compiles queued PendingShaders on another thread.
+class ShaderCompileJob : public love::thread::Threadable
+{
+public:
+
+	ShaderCompileJob();
+	virtual ~ShaderCompileJob() {}
+
+	void threadFunction() override;
+
+	std::vector<StrongRef<PendingShader>> shaders;
+
+}; // ShaderCompileJob
+
+} // graphics
+} // love
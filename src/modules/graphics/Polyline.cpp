@@ -87,7 +87,11 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 
 	// Use a single linear array for both the regular and overdraw vertices.
-	vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
+	// It's reused between renders rather than allocated each time.
+	static std::vector<Vector2> scratch;
+	std::vector<Vector2> &dest = storage != nullptr ? *storage : scratch;
+	dest.resize(vertex_count + extra_vertices + overdraw_vertex_count);
+	vertices = dest.data();
 
 	for (size_t i = 0; i < vertex_count; ++i)
 		vertices[i] = anchors[i] + normals[i];
@@ -365,12 +369,6 @@ void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/,
 	}
 }
 
-Polyline::~Polyline()
-{
-	if (vertices)
-		delete[] vertices;
-}
-
 void Polyline::draw(love::graphics::Graphics *gfx)
 {
 	const Matrix4 &t = gfx->getTransform();
@@ -437,6 +435,18 @@ void Polyline::draw(love::graphics::Graphics *gfx)
 	}
 }
 
+void Polyline::fillColors(Color32 constant_color, Color32 *colors)
+{
+	size_t count = getVertexCount();
+	size_t rough_count = overdraw ? overdraw_vertex_start : vertex_count;
+
+	for (size_t i = 0; i < rough_count; i++)
+		colors[i] = constant_color;
+
+	if (overdraw)
+		fill_color_array(constant_color, colors + rough_count, (int) (count - rough_count));
+}
+
 void Polyline::fill_color_array(Color32 constant_color, Color32 *colors, int count)
 {
 	for (int i = 0; i < count; ++i)
@@ -44,16 +44,23 @@ class Polyline
 {
 public:
 
-	Polyline(TriangleIndexMode mode = TRIANGLEINDEX_STRIP)
+	/**
+	 * @param mode    How the vertices form triangles.
+	 * @param storage Where the rendered vertices are kept. When null, they go
+	 *                in a scratch array shared by every Polyline, which is
+	 *                only valid until the next one is rendered.
+	 */
+	Polyline(TriangleIndexMode mode = TRIANGLEINDEX_STRIP, std::vector<Vector2> *storage = nullptr)
 		: vertices(nullptr)
 		, overdraw(nullptr)
 		, vertex_count(0)
 		, overdraw_vertex_count(0)
 		, triangle_mode(mode)
 		, overdraw_vertex_start(0)
+		, storage(storage)
 	{}
 
-	virtual ~Polyline();
+	virtual ~Polyline() {}
 
 	/**
 	 * @param vertices      Vertices defining the core line segments
@@ -69,6 +76,17 @@ public:
 	 */
 	void draw(love::graphics::Graphics *gfx);
 
+	/** The rendered vertices, including the overdraw ones (if any).
+	 */
+	const Vector2 *getVertices() const { return vertices; }
+	size_t getVertexCount() const { return overdraw ? overdraw_vertex_start + overdraw_vertex_count : vertex_count; }
+	TriangleIndexMode getTriangleIndexMode() const { return triangle_mode; }
+
+	/** Fills one color per rendered vertex, with transparent outer overdraw
+	 *  vertices.
+	 */
+	void fillColors(Color32 constant_color, Color32 *colors);
+
 protected:
 
 	virtual void calc_overdraw_vertex_count(bool is_looping);
@@ -96,6 +114,7 @@ protected:
 	size_t overdraw_vertex_count;
 	TriangleIndexMode triangle_mode;
 	size_t overdraw_vertex_start;
+	std::vector<Vector2> *storage;
 
 }; // Polyline
 
@@ -108,8 +127,8 @@ class NoneJoinPolyline : public Polyline
 {
 public:
 
-	NoneJoinPolyline()
-		: Polyline(TRIANGLEINDEX_QUADS)
+	NoneJoinPolyline(std::vector<Vector2> *storage = nullptr)
+		: Polyline(TRIANGLEINDEX_QUADS, storage)
 	{}
 
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
@@ -149,6 +168,10 @@ class MiterJoinPolyline : public Polyline
 {
 public:
 
+	MiterJoinPolyline(std::vector<Vector2> *storage = nullptr)
+		: Polyline(TRIANGLEINDEX_STRIP, storage)
+	{}
+
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
 		Polyline::render(vertices, count, 2 * count, halfwidth, pixel_size, draw_overdraw);
@@ -171,6 +194,10 @@ class BevelJoinPolyline : public Polyline
 {
 public:
 
+	BevelJoinPolyline(std::vector<Vector2> *storage = nullptr)
+		: Polyline(TRIANGLEINDEX_STRIP, storage)
+	{}
+
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
 		Polyline::render(vertices, count, 4 * count - 4, halfwidth, pixel_size, draw_overdraw);
@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ReadbackRing.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ReadbackRing::type("ReadbackRing", &Object::type);
+
+ReadbackRing::ReadbackRing(Graphics *gfx, int slotcount)
+	: gfx(gfx)
+	, nextID(1)
+{
+	if (slotcount < 1)
+		throw love::Exception("ReadbackRing slot count must be at least 1.");
+
+	slots.resize(slotcount);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+}
+
+ReadbackRing::Slot *ReadbackRing::getFreeSlot()
+{
+	uint64 latestid = 0;
+	getLatest(latestid);
+
+	Slot *freeslot = nullptr;
+
+	for (Slot &slot : slots)
+	{
+		if (slot.readback.get() != nullptr && !slot.readback->isComplete())
+			continue;
+
+		// The latest completed readback is kept until a newer one completes,
+		// so getLatest always has something to return.
+		if (slot.id == latestid && latestid != 0 && slots.size() > 1)
+			continue;
+
+		// Oldest first.
+		if (freeslot == nullptr || slot.id < freeslot->id)
+			freeslot = &slot;
+	}
+
+	return freeslot;
+}
+
+uint64 ReadbackRing::readbackBuffer(Buffer *buffer, size_t offset, size_t size)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return 0;
+
+	data::ByteData *dest = nullptr;
+	if (slot->readback.get() != nullptr && !slot->readback->hasError())
+	{
+		data::ByteData *olddata = slot->readback->getBufferData();
+		if (olddata != nullptr && olddata->getSize() == size)
+			dest = olddata;
+	}
+
+	// The new readback retains dest before the old one is released.
+	slot->readback.set(gfx->readbackBufferAsync(buffer, offset, size, dest, 0), Acquire::NORETAIN);
+	slot->id = nextID++;
+
+	return slot->id;
+}
+
+uint64 ReadbackRing::readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return 0;
+
+	image::ImageData *dest = nullptr;
+	if (slot->readback.get() != nullptr && !slot->readback->hasError())
+	{
+		image::ImageData *olddata = slot->readback->getImageData();
+		PixelFormat format = getLinearPixelFormat(texture->getPixelFormat());
+
+		if (olddata != nullptr && olddata->getFormat() == format
+			&& olddata->getWidth() == rect.w && olddata->getHeight() == rect.h)
+		{
+			dest = olddata;
+		}
+	}
+
+	slot->readback.set(gfx->readbackTextureAsync(texture, slice, mipmap, rect, dest, 0, 0), Acquire::NORETAIN);
+	slot->id = nextID++;
+
+	return slot->id;
+}
+
+GraphicsReadback *ReadbackRing::getLatest(uint64 &id)
+{
+	GraphicsReadback *latest = nullptr;
+	id = 0;
+
+	for (const Slot &slot : slots)
+	{
+		GraphicsReadback *r = slot.readback.get();
+		if (r == nullptr)
+			continue;
+
+		// Readbacks are also updated once per frame by Graphics, this only
+		// picks up ones which finished since then.
+		r->update();
+
+		if (r->isComplete() && !r->hasError() && slot.id > id)
+		{
+			latest = r;
+			id = slot.id;
+		}
+	}
+
+	return latest;
+}
+
+int ReadbackRing::getPendingCount() const
+{
+	int count = 0;
+	for (const Slot &slot : slots)
+	{
+		if (slot.readback.get() != nullptr && !slot.readback->isComplete())
+			count++;
+	}
+	return count;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/math.h"
+#include "common/Object.h"
+#include "GraphicsReadback.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A fixed number of asynchronous readback slots, for data which is read back
+ * from the GPU every frame. A new readback goes in a free slot instead of
+ * waiting, and is dropped if every slot is still in flight. The ByteData or
+ * ImageData of a slot is reused by its next readback when the size and format
+ * match, so no new memory is allocated in the common case.
+ **/
+class ReadbackRing : public Object
+{
+public:
+
+	static love::Type type;
+
+	ReadbackRing(Graphics *gfx, int slotcount);
+	virtual ~ReadbackRing();
+
+	/**
+	 * Starts a readback in a free slot. Returns its ID, or 0 if every slot is
+	 * still in flight.
+	 **/
+	uint64 readbackBuffer(Buffer *buffer, size_t offset, size_t size);
+	uint64 readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect);
+
+	/**
+	 * Gets the most recently started readback which has completed, or null if
+	 * none has completed yet. Its data stays valid until slotcount - 1 more
+	 * readbacks have been started.
+	 **/
+	GraphicsReadback *getLatest(uint64 &id);
+
+	int getSlotCount() const { return (int) slots.size(); }
+	int getPendingCount() const;
+
+private:
+
+	struct Slot
+	{
+		StrongRef<GraphicsReadback> readback;
+		uint64 id = 0;
+	};
+
+	Slot *getFreeSlot();
+
+	Graphics *gfx;
+	std::vector<Slot> slots;
+	uint64 nextID;
+
+}; // ReadbackRing
+
+} // graphics
+} // love
@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ScreenshotEncoder.h"
+#include "filesystem/Filesystem.h"
+#include "event/Event.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ScreenshotEncoder::ScreenshotEncoder()
+	: finishing(false)
+{
+	threadName = "ScreenshotEncoder";
+}
+
+ScreenshotEncoder::~ScreenshotEncoder()
+{
+	finish();
+}
+
+void ScreenshotEncoder::encode(image::ImageData *data, image::FormatHandler::EncodedFormat format, const std::string &filename)
+{
+	{
+		love::thread::Lock lock(mutex);
+
+		while (jobs.size() >= MAX_QUEUED_SCREENSHOTS)
+			cond->wait(mutex);
+
+		Job job;
+		job.data.set(data);
+		job.format = format;
+		job.filename = filename;
+		jobs.push(job);
+
+		finishing = false;
+	}
+
+	cond->broadcast();
+
+	if (!isRunning())
+		start();
+}
+
+void ScreenshotEncoder::finish()
+{
+	{
+		love::thread::Lock lock(mutex);
+		finishing = true;
+	}
+
+	cond->broadcast();
+	wait();
+}
+
+void ScreenshotEncoder::onError(const std::string &filename, const std::string &error)
+{
+	auto eventmodule = Module::getInstance<event::Event>(Module::M_EVENT);
+	if (!eventmodule)
+		return;
+
+	std::vector<Variant> vargs = {
+		Variant(filename.c_str(), filename.length()),
+		Variant(error.c_str(), error.length())
+	};
+
+	StrongRef<event::Message> msg(new event::Message("screenshoterror", vargs), Acquire::NORETAIN);
+	eventmodule->push(msg);
+}
+
+void ScreenshotEncoder::threadFunction()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			love::thread::Lock lock(mutex);
+
+			while (jobs.empty() && !finishing)
+				cond->wait(mutex);
+
+			if (jobs.empty())
+				return;
+
+			job = jobs.front();
+			jobs.pop();
+		}
+
+		// Wakes up encode() if it's waiting for room in the queue.
+		cond->broadcast();
+
+		auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+		StrongRef<love::filesystem::File> file;
+
+		try
+		{
+			if (fs == nullptr)
+				throw love::Exception("love.filesystem must be loaded in order to save a screenshot.");
+
+			// Encode straight into the file, so large screenshots don't need a
+			// second full-size buffer for the encoded data.
+			file.set(fs->openFile(job.filename.c_str(), love::filesystem::File::MODE_WRITE), Acquire::NORETAIN);
+			job.data->encode(job.format, file);
+			file->close();
+		}
+		catch (love::Exception &e)
+		{
+			// Don't leave a truncated image behind.
+			if (file.get() != nullptr)
+			{
+				file->close();
+				fs->remove(job.filename.c_str());
+			}
+
+			onError(job.filename, e.what());
+		}
+	}
+}
+
+} // graphics
+} // love
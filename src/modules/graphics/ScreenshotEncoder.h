@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "image/ImageData.h"
+
+// C++
+#include <string>
+#include <queue>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Encodes screenshots and writes them to files on a background thread, so
+ * continuous captures don't stall the frame which requested them. Failures
+ * are reported with a "screenshoterror" event.
+ **/
+class ScreenshotEncoder : public love::thread::Threadable
+{
+public:
+
+	ScreenshotEncoder();
+	virtual ~ScreenshotEncoder();
+
+	/**
+	 * Queues the ImageData to be encoded. Blocks if too many screenshots are
+	 * already waiting, so memory use stays bounded when encoding can't keep
+	 * up.
+	 **/
+	void encode(image::ImageData *data, image::FormatHandler::EncodedFormat format, const std::string &filename);
+
+	/**
+	 * Waits for every queued screenshot to be written, and stops the thread.
+	 **/
+	void finish();
+
+	void threadFunction() override;
+
+private:
+
+	static const size_t MAX_QUEUED_SCREENSHOTS = 8;
+
+	void onError(const std::string &filename, const std::string &error);
+
+	struct Job
+	{
+		StrongRef<image::ImageData> data;
+		image::FormatHandler::EncodedFormat format;
+		std::string filename;
+	};
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	std::queue<Job> jobs;
+	bool finishing;
+
+}; // ScreenshotEncoder
+
+} // graphics
+} // love
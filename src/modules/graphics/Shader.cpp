@@ -500,6 +500,39 @@ Shader::SourceInfo Shader::getSourceInfo(const std::string &src)
 }
 
 std::string Shader::createShaderStageCode(Graphics *gfx, ShaderStageType stage, const std::string &code, const CompileOptions &options, const Shader::SourceInfo &info, bool gles, bool checksystemfeatures)
+{
+	const auto &features = gfx->getCapabilities().features;
+
+	CodeVariant variant = {};
+	variant.gles = gles;
+	variant.glsl3 = true;
+	variant.gammaCorrect = isGammaCorrect();
+	variant.pixelShaderHighp = features[Graphics::FEATURE_PIXEL_SHADER_HIGHP];
+
+	if (checksystemfeatures)
+	{
+		checkSystemFeatures(gfx, stage, info);
+		variant.glsl3 = features[Graphics::FEATURE_GLSL3];
+	}
+
+	return createShaderStageCode(stage, code, options, info, variant);
+}
+
+void Shader::checkSystemFeatures(Graphics *gfx, ShaderStageType stage, const SourceInfo &info)
+{
+	const auto &features = gfx->getCapabilities().features;
+
+	if (stage == SHADERSTAGE_COMPUTE && !features[Graphics::FEATURE_GLSL4])
+		throw love::Exception("Compute shaders require GLSL 4 which is not supported on this system.");
+
+	if (info.language == LANGUAGE_GLSL3 && !features[Graphics::FEATURE_GLSL3])
+		throw love::Exception("GLSL 3 shaders are not supported on this system.");
+
+	if (info.language == LANGUAGE_GLSL4 && !features[Graphics::FEATURE_GLSL4])
+		throw love::Exception("GLSL 4 shaders are not supported on this system.");
+}
+
+std::string Shader::createShaderStageCode(ShaderStageType stage, const std::string &code, const CompileOptions &options, const Shader::SourceInfo &info, const CodeVariant &variant)
 {
 	if (info.language == Shader::LANGUAGE_MAX_ENUM)
 		throw love::Exception("Invalid shader language");
@@ -513,23 +546,8 @@ std::string Shader::createShaderStageCode(Graphics *gfx, ShaderStageType stage,
 	if (stage == SHADERSTAGE_COMPUTE && info.language != LANGUAGE_GLSL4)
 		throw love::Exception("Compute shaders must use GLSL 4.");
 
-	bool glsl1on3 = info.language == LANGUAGE_GLSL1;
-
-	if (checksystemfeatures)
-	{
-		const auto &features = gfx->getCapabilities().features;
-
-		if (stage == SHADERSTAGE_COMPUTE && !features[Graphics::FEATURE_GLSL4])
-			throw love::Exception("Compute shaders require GLSL 4 which is not supported on this system.");
-
-		if (info.language == LANGUAGE_GLSL3 && !features[Graphics::FEATURE_GLSL3])
-			throw love::Exception("GLSL 3 shaders are not supported on this system.");
-
-		if (info.language == LANGUAGE_GLSL4 && !features[Graphics::FEATURE_GLSL4])
-			throw love::Exception("GLSL 4 shaders are not supported on this system.");
-
-		glsl1on3 = info.language == LANGUAGE_GLSL1 && features[Graphics::FEATURE_GLSL3];
-	}
+	bool gles = variant.gles;
+	bool glsl1on3 = info.language == LANGUAGE_GLSL1 && variant.glsl3;
 
 	Language lang = info.language;
 	if (glsl1on3)
@@ -543,14 +561,14 @@ std::string Shader::createShaderStageCode(Graphics *gfx, ShaderStageType stage,
 	if (glsl1on3)
 		ss << "#define LOVE_GLSL1_ON_GLSL3 1\n";
 
-	if (isGammaCorrect())
+	if (variant.gammaCorrect)
 		ss << "#define LOVE_GAMMA_CORRECT 1\n";
 	if (info.usesMRT)
 		ss << "#define LOVE_MULTI_RENDER_TARGETS 1\n";
 
 	// Note: backends are expected to handle this situation if highp is ever
 	// conditional in that backend.
-	if (!gfx->getCapabilities().features[Graphics::FEATURE_PIXEL_SHADER_HIGHP])
+	if (!variant.pixelShaderHighp)
 		ss << "#define LOVE_SPLIT_UNIFORMS_PER_DRAW 1\n";
 
 	for (const auto &def : options.defines)
@@ -577,12 +595,18 @@ std::string Shader::createShaderStageCode(Graphics *gfx, ShaderStageType stage,
 	return ss.str();
 }
 
-Shader::Shader(StrongRef<ShaderStage> _stages[])
+Shader::Shader(StrongRef<ShaderStage> _stages[], const ValidationReflection *prebuiltreflection)
 	: stages()
+	, variantCompute(false)
 {
-	std::string err;
-	if (!validateInternal(_stages, err, validationReflection))
-		throw love::Exception("%s", err.c_str());
+	if (prebuiltreflection != nullptr)
+		validationReflection = *prebuiltreflection;
+	else
+	{
+		std::string err;
+		if (!validateInternal(_stages, err, validationReflection))
+			throw love::Exception("%s", err.c_str());
+	}
 
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 		stages[i] = _stages[i];
@@ -600,6 +624,45 @@ Shader::~Shader()
 		attachDefault(STANDARD_DEFAULT);
 }
 
+void Shader::setVariantSource(const std::vector<std::string> &sources, const CompileOptions &options, bool compute)
+{
+	variantSources = sources;
+	variantOptions = options;
+	variantCompute = compute;
+}
+
+Shader *Shader::getCachedVariant(const std::string &defineskey) const
+{
+	if (defineskey == getDefinesKey(variantOptions.defines))
+		return const_cast<Shader *>(this);
+
+	auto it = variants.find(defineskey);
+	if (it != variants.end())
+		return it->second.get();
+
+	return nullptr;
+}
+
+void Shader::addCachedVariant(const std::string &defineskey, Shader *variant)
+{
+	variants[defineskey].set(variant);
+}
+
+std::string Shader::getDefinesKey(const std::map<std::string, std::string> &defines)
+{
+	// std::map is ordered, so the same set of defines always produces the same
+	// key.
+	std::string key;
+	for (const auto &def : defines)
+	{
+		key += def.first;
+		key += '=';
+		key += def.second;
+		key += '\n';
+	}
+	return key;
+}
+
 bool Shader::hasStage(ShaderStageType stage)
 {
 	return stages[stage] != nullptr;
@@ -726,6 +789,11 @@ bool Shader::validate(StrongRef<ShaderStage> stages[], std::string& err)
 	return validateInternal(stages, err, reflection);
 }
 
+bool Shader::validate(StrongRef<ShaderStage> stages[], std::string &err, ValidationReflection &reflection)
+{
+	return validateInternal(stages, err, reflection);
+}
+
 static PixelFormat getPixelFormat(glslang::TLayoutFormat format)
 {
 	using namespace glslang;
@@ -972,6 +1040,33 @@ bool Shader::validateInternal(StrongRef<ShaderStage> stages[], std::string &err,
 		}
 	}
 
+	for (int i = 0; i < program.getNumUniformBlocks(); i++)
+	{
+		const glslang::TObjectReflection &info = program.getUniformBlock(i);
+		const glslang::TType *type = info.getType();
+
+		if (type == nullptr)
+		{
+			err = "Shader validation error:\nCannot retrieve type information for Uniform Buffer block '" + info.name + "'.";
+			return false;
+		}
+
+		// Buffers are laid out on the CPU side, so the layout can't be left up
+		// to the driver.
+		if (type->getQualifier().layoutPacking != glslang::ElpStd140)
+		{
+			err = "Shader validation error:\nUniform Buffer block '" + info.name + "' must use the std140 packing layout.";
+			return false;
+		}
+
+		BufferReflection bufferReflection = {};
+		bufferReflection.stride = (size_t) info.size;
+		bufferReflection.memberCount = (size_t) info.numMembers;
+		bufferReflection.access = ACCESS_READ;
+
+		reflection.uniformBuffers[info.name] = bufferReflection;
+	}
+
 	return true;
 }
 
@@ -1046,11 +1141,14 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 
 	bool texelbinding = info->baseType == UNIFORM_TEXELBUFFER;
 	bool storagebinding = info->baseType == UNIFORM_STORAGEBUFFER;
+	bool uniformbinding = info->baseType == UNIFORM_UNIFORMBUFFER;
 
 	if (texelbinding)
 		requiredtypeflags = BUFFERUSAGEFLAG_TEXEL;
 	else if (storagebinding)
 		requiredtypeflags = BUFFERUSAGEFLAG_SHADER_STORAGE;
+	else if (uniformbinding)
+		requiredtypeflags = BUFFERUSAGEFLAG_UNIFORM;
 
 	if ((buffer->getUsageFlags() & requiredtypeflags) == 0)
 	{
@@ -1060,6 +1158,8 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 			throw love::Exception("Shader uniform '%s' is a texel buffer, but the given Buffer was not created with texel buffer capabilities.", info->name.c_str());
 		else if (storagebinding)
 			throw love::Exception("Shader uniform '%s' is a shader storage buffer block, but the given Buffer was not created with shader storage buffer capabilities.", info->name.c_str());
+		else if (uniformbinding)
+			throw love::Exception("Shader uniform '%s' is a uniform buffer block, but the given Buffer was not created with uniform buffer capabilities.", info->name.c_str());
 		else
 			throw love::Exception("Shader uniform '%s' does not match the types supported by the given Buffer.", info->name.c_str());
 	}
@@ -1094,6 +1194,17 @@ bool Shader::validateBuffer(const UniformInfo *info, Buffer *buffer, bool intern
 					info->name.c_str(), info->bufferMemberCount, buffer->getDataMembers().size());
 		}
 	}
+	else if (uniformbinding)
+	{
+		if (buffer->getSize() < info->bufferStride)
+		{
+			if (internalUpdate)
+				return false;
+			else
+				throw love::Exception("Uniform buffer block '%s' is %d bytes, but the given Buffer is only %d bytes.",
+					info->name.c_str(), info->bufferStride, buffer->getSize());
+		}
+	}
 
 	return true;
 }
@@ -1129,6 +1240,19 @@ bool Shader::fillUniformReflectionData(UniformInfo &u)
 
 		return false;
 	}
+	else if (u.baseType == UNIFORM_UNIFORMBUFFER)
+	{
+		const auto reflectionit = r.uniformBuffers.find(u.name);
+		if (reflectionit != r.uniformBuffers.end())
+		{
+			u.bufferStride = reflectionit->second.stride;
+			u.bufferMemberCount = reflectionit->second.memberCount;
+			u.access = reflectionit->second.access;
+			return true;
+		}
+
+		return false;
+	}
 
 	return true;
 }
@@ -1158,6 +1282,73 @@ vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
 }
 )";
 
+// Used by instanced shape draws. Each instance is an ellipse or arc, expanded
+// from a fan of vertex indices stored in VertexPosition.x.
+static const std::string defaultShapesVertex = R"(
+attribute vec4 ShapeTransform;
+attribute vec4 ShapeOffsetRadii;
+attribute vec4 ShapeAngles;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	float segments = ShapeAngles.z;
+	float index = min(localPosition.x, segments + 1.0);
+
+	// Index 0 is the center of the fan, unless the shape is a chord.
+	vec2 p = vec2(0.0);
+	if (index > 0.0 || ShapeAngles.w > 0.0)
+	{
+		float angle = mix(ShapeAngles.x, ShapeAngles.y, max(index - 1.0, 0.0) / segments);
+		p = vec2(cos(angle), sin(angle)) * ShapeOffsetRadii.zw;
+	}
+
+	p = mat2(ShapeTransform.xy, ShapeTransform.zw) * p + ShapeOffsetRadii.xy;
+	return clipSpaceFromLocal * vec4(p, 0.0, 1.0);
+}
+)";
+
+// Used by instanced SpriteBatches. Each instance is a sprite, expanded from
+// the corners of a unit square stored in VertexPosition.xy.
+static const std::string defaultSpritesVertex = R"(
+attribute vec4 SpriteTransform;
+attribute vec4 SpriteTexRect;
+attribute vec3 SpriteOffsetLayer;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec2 corner = localPosition.xy;
+	VaryingTexCoord = vec4(SpriteTexRect.xy + corner * SpriteTexRect.zw, SpriteOffsetLayer.z, 1.0);
+
+	vec2 p = mat2(SpriteTransform.xy, SpriteTransform.zw) * corner + SpriteOffsetLayer.xy;
+	return clipSpaceFromLocal * vec4(p, 0.0, 1.0);
+}
+)";
+
+// Used by Meshes with bone transforms. Each vertex blends up to 4 bones from
+// the palette, which stores a 2x2 matrix and a translation per bone.
+static const std::string defaultSkinnedVertex = R"(
+attribute vec4 VertexBoneIndices;
+attribute vec4 VertexBoneWeights;
+
+uniform vec4 BonePalette[128];
+
+vec2 skinBone(float bone, vec2 p)
+{
+	int i = int(bone + 0.5) * 2;
+	vec4 m = BonePalette[i];
+	return mat2(m.xy, m.zw) * p + BonePalette[i + 1].xy;
+}
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition)
+{
+	vec2 p = skinBone(VertexBoneIndices.x, localPosition.xy) * VertexBoneWeights.x;
+	p += skinBone(VertexBoneIndices.y, localPosition.xy) * VertexBoneWeights.y;
+	p += skinBone(VertexBoneIndices.z, localPosition.xy) * VertexBoneWeights.z;
+	p += skinBone(VertexBoneIndices.w, localPosition.xy) * VertexBoneWeights.w;
+	return clipSpaceFromLocal * vec4(p, localPosition.zw);
+}
+)";
+
 static const std::string defaultStandardPixel = R"(
 vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
 {
@@ -1165,6 +1356,22 @@ vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
 }
 )";
 
+static const std::string defaultSDFPixel = R"(
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	vec4 texel = Texel(tex, texcoord);
+	float dist = texel.a - 0.5;
+#if defined(GL_ES) && __VERSION__ < 300 && !defined(GL_OES_standard_derivatives)
+	float width = 0.1;
+#else
+	// Antialias over roughly one screen pixel, regardless of the draw scale.
+	float width = max(fwidth(dist), 0.0001);
+#endif
+	float alpha = clamp(dist / width + 0.5, 0.0, 1.0);
+	return vec4(texel.rgb, alpha) * vcolor;
+}
+)";
+
 static const std::string defaultVideoPixel = R"(
 void effect()
 {
@@ -1186,6 +1393,12 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 	{
 		if (shader == STANDARD_POINTS)
 			return defaultPointsVertex;
+		else if (shader == STANDARD_SHAPES)
+			return defaultShapesVertex;
+		else if (shader == STANDARD_SPRITES || shader == STANDARD_ARRAY_SPRITES)
+			return defaultSpritesVertex;
+		else if (shader == STANDARD_SKINNED)
+			return defaultSkinnedVertex;
 		else
 			return defaultVertex;
 	}
@@ -1198,6 +1411,11 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 		case STANDARD_VIDEO: return defaultVideoPixel;
 		case STANDARD_ARRAY: return defaultArrayPixel;
 		case STANDARD_POINTS: return defaultStandardPixel;
+		case STANDARD_SHAPES: return defaultStandardPixel;
+		case STANDARD_SDF: return defaultSDFPixel;
+		case STANDARD_SPRITES: return defaultStandardPixel;
+		case STANDARD_ARRAY_SPRITES: return defaultArrayPixel;
+		case STANDARD_SKINNED: return defaultStandardPixel;
 		case STANDARD_MAX_ENUM: return nocode;
 	}
 
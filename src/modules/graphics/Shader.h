@@ -80,6 +80,7 @@ public:
 		UNIFORM_STORAGETEXTURE,
 		UNIFORM_TEXELBUFFER,
 		UNIFORM_STORAGEBUFFER,
+		UNIFORM_UNIFORMBUFFER,
 		UNIFORM_UNKNOWN,
 		UNIFORM_MAX_ENUM
 	};
@@ -90,6 +91,11 @@ public:
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
 		STANDARD_POINTS,
+		STANDARD_SHAPES,
+		STANDARD_SDF,
+		STANDARD_SPRITES,
+		STANDARD_ARRAY_SPRITES,
+		STANDARD_SKINNED,
 		STANDARD_MAX_ENUM
 	};
 
@@ -120,6 +126,22 @@ public:
 		bool usesMRT;
 	};
 
+	// System and graphics settings which affect the code generated by
+	// createShaderStageCode.
+	struct CodeVariant
+	{
+		bool gles;
+		bool glsl3; // GLSL 1 code is compiled as GLSL 3 when supported.
+		bool gammaCorrect;
+		bool pixelShaderHighp;
+
+		bool operator == (const CodeVariant &other) const
+		{
+			return gles == other.gles && glsl3 == other.glsl3
+				&& gammaCorrect == other.gammaCorrect && pixelShaderHighp == other.pixelShaderHighp;
+		}
+	};
+
 	struct MatrixSize
 	{
 		short columns;
@@ -143,7 +165,7 @@ public:
 		Access access;
 		bool isDepthSampler;
 		PixelFormat storageTextureFormat;
-		size_t bufferStride;
+		size_t bufferStride; // Total size of the block, for uniform buffers.
 		size_t bufferMemberCount;
 		std::string name;
 
@@ -183,13 +205,46 @@ public:
 		Vector4 screenSizeParams;
  	};
 
+	struct BufferReflection
+	{
+		size_t stride;
+		size_t memberCount;
+		Access access;
+	};
+
+	struct StorageTextureReflection
+	{
+		PixelFormat format;
+		Access access;
+	};
+
+	struct LocalUniform
+	{
+		DataBaseType dataType;
+		std::vector<LocalUniformValue> initializerValues;
+	};
+
+	struct ValidationReflection
+	{
+		std::map<std::string, BufferReflection> storageBuffers;
+		std::map<std::string, BufferReflection> uniformBuffers;
+		std::map<std::string, StorageTextureReflection> storageTextures;
+		std::map<std::string, LocalUniform> localUniforms;
+		int localThreadgroupSize[3];
+		bool usesPointSize;
+	};
+
 	// Pointer to currently active Shader.
 	static Shader *current;
 
 	// Pointer to the default Shader.
 	static Shader *standardShaders[STANDARD_MAX_ENUM];
 
-	Shader(StrongRef<ShaderStage> stages[]);
+	/**
+	 * If prebuiltreflection is non-null, it's used instead of linking and
+	 * reflecting the stages with glslang (for stages from a ShaderBundle).
+	 **/
+	Shader(StrongRef<ShaderStage> stages[], const ValidationReflection *prebuiltreflection);
 	virtual ~Shader();
 
 	/**
@@ -243,10 +298,33 @@ public:
 
 	void getLocalThreadgroupSize(int *x, int *y, int *z);
 
+	/**
+	 * Stores the code this Shader was compiled from, so variants using
+	 * different defines can be created from it later.
+	 **/
+	void setVariantSource(const std::vector<std::string> &sources, const CompileOptions &options, bool compute);
+
+	bool hasVariantSource() const { return !variantSources.empty(); }
+	const std::vector<std::string> &getVariantSources() const { return variantSources; }
+	const CompileOptions &getVariantOptions() const { return variantOptions; }
+	bool isVariantCompute() const { return variantCompute; }
+
+	/**
+	 * Variants are cached per Shader, keyed by getDefinesKey. Returns null if
+	 * the variant hasn't been created yet.
+	 **/
+	Shader *getCachedVariant(const std::string &defineskey) const;
+	void addCachedVariant(const std::string &defineskey, Shader *variant);
+
+	static std::string getDefinesKey(const std::map<std::string, std::string> &defines);
+
 	static SourceInfo getSourceInfo(const std::string &src);
 	static std::string createShaderStageCode(Graphics *gfx, ShaderStageType stage, const std::string &code, const CompileOptions &options, const SourceInfo &info, bool gles, bool checksystemfeatures);
+	static std::string createShaderStageCode(ShaderStageType stage, const std::string &code, const CompileOptions &options, const SourceInfo &info, const CodeVariant &variant);
+	static void checkSystemFeatures(Graphics *gfx, ShaderStageType stage, const SourceInfo &info);
 
 	static bool validate(StrongRef<ShaderStage> stages[], std::string &err);
+	static bool validate(StrongRef<ShaderStage> stages[], std::string &err, ValidationReflection &reflection);
 
 	static bool initialize();
 	static void deinitialize();
@@ -261,34 +339,6 @@ public:
 
 protected:
 
-	struct BufferReflection
-	{
-		size_t stride;
-		size_t memberCount;
-		Access access;
-	};
-
-	struct StorageTextureReflection
-	{
-		PixelFormat format;
-		Access access;
-	};
-
-	struct LocalUniform
-	{
-		DataBaseType dataType;
-		std::vector<LocalUniformValue> initializerValues;
-	};
-
-	struct ValidationReflection
-	{
-		std::map<std::string, BufferReflection> storageBuffers;
-		std::map<std::string, StorageTextureReflection> storageTextures;
-		std::map<std::string, LocalUniform> localUniforms;
-		int localThreadgroupSize[3];
-		bool usesPointSize;
-	};
-
 	bool fillUniformReflectionData(UniformInfo &u);
 
 	static bool validateInternal(StrongRef<ShaderStage> stages[], std::string& err, ValidationReflection &reflection);
@@ -302,6 +352,12 @@ protected:
 
 	ValidationReflection validationReflection;
 
+	std::vector<std::string> variantSources;
+	CompileOptions variantOptions;
+	bool variantCompute;
+
+	std::map<std::string, StrongRef<Shader>> variants;
+
 }; // Shader
 
 } // graphics
@@ -0,0 +1,537 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ShaderBundle.h"
+#include "common/Exception.h"
+#include "common/version.h"
+
+#include "libraries/glslang/glslang/Public/ShaderLang.h"
+#include "libraries/glslang/SPIRV/GlslangToSpv.h"
+
+// C++
+#include <algorithm>
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+static const char bundleMagic[] = "LOVESHADERBUNDLE";
+static const size_t bundleMagicSize = sizeof(bundleMagic) - 1;
+
+// Bump this when the layout of the serialized data changes.
+static const uint32 bundleFormatVersion = 2;
+
+static void writeUInt32(std::string &out, uint32 v)
+{
+	// Always little-endian, bundles are usually created on another machine.
+	for (int i = 0; i < 4; i++)
+		out.push_back((char) ((v >> (i * 8)) & 0xFF));
+}
+
+static void writeString(std::string &out, const std::string &str)
+{
+	writeUInt32(out, (uint32) str.size());
+	out.append(str);
+}
+
+struct BundleReader
+{
+	const uint8 *data;
+	size_t size;
+	size_t offset;
+
+	uint32 readUInt32()
+	{
+		if (size - offset < 4)
+			throw love::Exception("Invalid shader bundle: unexpected end of data.");
+
+		uint32 v = 0;
+		for (int i = 0; i < 4; i++)
+			v |= ((uint32) data[offset + i]) << (i * 8);
+
+		offset += 4;
+		return v;
+	}
+
+	std::string readString()
+	{
+		uint32 length = readUInt32();
+		if (size - offset < length)
+			throw love::Exception("Invalid shader bundle: unexpected end of data.");
+
+		std::string str((const char *) data + offset, length);
+		offset += length;
+		return str;
+	}
+
+	// Reads an element count, and makes sure the remaining data can hold that
+	// many elements of at least the given size.
+	uint32 readCount(size_t minelementsize)
+	{
+		uint32 count = readUInt32();
+		if ((size - offset) / minelementsize < count)
+			throw love::Exception("Invalid shader bundle: unexpected end of data.");
+		return count;
+	}
+
+	Shader::Access readAccess()
+	{
+		uint32 access = readUInt32();
+		if ((access & ~(uint32) (Shader::ACCESS_READ | Shader::ACCESS_WRITE)) != 0)
+			throw love::Exception("Invalid shader bundle: unknown resource access.");
+		return (Shader::Access) access;
+	}
+};
+
+// The smallest possible size of a serialized variant: its bits, a string
+// and word count per stage, four reflection counts, the threadgroup size and
+// the point size flag.
+static const size_t minVariantSize = 4 + SHADERSTAGE_MAX_ENUM * 8 + 4 * 4 + 3 * 4 + 4;
+
+static uint32 getCodeVariantBits(const Shader::CodeVariant &code)
+{
+	return (code.gles ? 1 : 0) | (code.glsl3 ? 2 : 0) | (code.gammaCorrect ? 4 : 0) | (code.pixelShaderHighp ? 8 : 0);
+}
+
+static EShLanguage getGLSLangStage(ShaderStageType stage)
+{
+	switch (stage)
+	{
+		case SHADERSTAGE_VERTEX: return EShLangVertex;
+		case SHADERSTAGE_PIXEL: return EShLangFragment;
+		case SHADERSTAGE_COMPUTE: return EShLangCompute;
+		case SHADERSTAGE_MAX_ENUM: return EShLangCount;
+	}
+	return EShLangCount;
+}
+
+ShaderBundle::ShaderBundle()
+	: loveVersion(LOVE_VERSION_STRING)
+	, compute(false)
+	, language(Shader::LANGUAGE_GLSL1)
+{
+}
+
+const ShaderBundle::Variant *ShaderBundle::getVariant(const Shader::CodeVariant &code, bool needsspirv) const
+{
+	for (const Variant &variant : variants)
+	{
+		if (!(variant.code == code))
+			continue;
+
+		if (needsspirv)
+		{
+			for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+			{
+				if (!variant.glsl[i].empty() && variant.spirv[i].empty())
+					return nullptr;
+			}
+		}
+
+		return &variant;
+	}
+
+	return nullptr;
+}
+
+std::string ShaderBundle::serialize() const
+{
+	std::string out(bundleMagic, bundleMagicSize);
+
+	writeUInt32(out, bundleFormatVersion);
+	writeString(out, loveVersion);
+	writeUInt32(out, compute ? 1 : 0);
+	writeUInt32(out, (uint32) language);
+
+	writeUInt32(out, (uint32) sources.size());
+	for (const std::string &source : sources)
+		writeString(out, source);
+
+	writeUInt32(out, (uint32) options.defines.size());
+	for (const auto &def : options.defines)
+	{
+		writeString(out, def.first);
+		writeString(out, def.second);
+	}
+
+	writeUInt32(out, (uint32) variants.size());
+	for (const Variant &variant : variants)
+	{
+		writeUInt32(out, getCodeVariantBits(variant.code));
+
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			writeString(out, variant.glsl[i]);
+			writeUInt32(out, (uint32) variant.spirv[i].size());
+			for (uint32 word : variant.spirv[i])
+				writeUInt32(out, word);
+		}
+
+		const Shader::ValidationReflection &r = variant.reflection;
+
+		writeUInt32(out, (uint32) r.storageBuffers.size());
+		for (const auto &kvp : r.storageBuffers)
+		{
+			writeString(out, kvp.first);
+			writeUInt32(out, (uint32) kvp.second.stride);
+			writeUInt32(out, (uint32) kvp.second.memberCount);
+			writeUInt32(out, (uint32) kvp.second.access);
+		}
+
+		writeUInt32(out, (uint32) r.uniformBuffers.size());
+		for (const auto &kvp : r.uniformBuffers)
+		{
+			writeString(out, kvp.first);
+			writeUInt32(out, (uint32) kvp.second.stride);
+			writeUInt32(out, (uint32) kvp.second.memberCount);
+		}
+
+		writeUInt32(out, (uint32) r.storageTextures.size());
+		for (const auto &kvp : r.storageTextures)
+		{
+			writeString(out, kvp.first);
+			writeUInt32(out, (uint32) kvp.second.format);
+			writeUInt32(out, (uint32) kvp.second.access);
+		}
+
+		writeUInt32(out, (uint32) r.localUniforms.size());
+		for (const auto &kvp : r.localUniforms)
+		{
+			writeString(out, kvp.first);
+			writeUInt32(out, (uint32) kvp.second.dataType);
+			writeUInt32(out, (uint32) kvp.second.initializerValues.size());
+			for (const auto &value : kvp.second.initializerValues)
+				writeUInt32(out, value.u);
+		}
+
+		for (int i = 0; i < 3; i++)
+			writeUInt32(out, (uint32) r.localThreadgroupSize[i]);
+
+		writeUInt32(out, r.usesPointSize ? 1 : 0);
+	}
+
+	return out;
+}
+
+void ShaderBundle::deserialize(const void *data, size_t size)
+{
+	if (size < bundleMagicSize || memcmp(data, bundleMagic, bundleMagicSize) != 0)
+		throw love::Exception("Invalid shader bundle.");
+
+	BundleReader reader = {(const uint8 *) data, size, bundleMagicSize};
+
+	if (reader.readUInt32() != bundleFormatVersion)
+		throw love::Exception("Shader bundle was created with an incompatible version of LOVE.");
+
+	loveVersion = reader.readString();
+	compute = reader.readUInt32() != 0;
+
+	uint32 lang = reader.readUInt32();
+	if (lang >= Shader::LANGUAGE_MAX_ENUM)
+		throw love::Exception("Invalid shader bundle: unknown shader language.");
+	language = (Shader::Language) lang;
+
+	sources.resize(reader.readCount(4));
+	for (std::string &source : sources)
+		source = reader.readString();
+
+	if (sources.empty())
+		throw love::Exception("Invalid shader bundle: no shader code.");
+
+	options.defines.clear();
+	uint32 definecount = reader.readCount(8);
+	for (uint32 i = 0; i < definecount; i++)
+	{
+		std::string name = reader.readString();
+		options.defines[name] = reader.readString();
+	}
+
+	uint32 variantcount = reader.readCount(minVariantSize);
+
+	variants.clear();
+	variants.reserve(variantcount);
+
+	for (uint32 v = 0; v < variantcount; v++)
+	{
+		variants.emplace_back();
+		Variant &variant = variants.back();
+
+		uint32 bits = reader.readUInt32();
+		variant.code.gles = (bits & 1) != 0;
+		variant.code.glsl3 = (bits & 2) != 0;
+		variant.code.gammaCorrect = (bits & 4) != 0;
+		variant.code.pixelShaderHighp = (bits & 8) != 0;
+
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			variant.glsl[i] = reader.readString();
+
+			uint32 wordcount = reader.readCount(4);
+			variant.spirv[i].resize(wordcount);
+			for (uint32 &word : variant.spirv[i])
+				word = reader.readUInt32();
+		}
+
+		Shader::ValidationReflection &r = variant.reflection;
+
+		uint32 count = reader.readCount(16);
+		for (uint32 i = 0; i < count; i++)
+		{
+			std::string name = reader.readString();
+			Shader::BufferReflection &b = r.storageBuffers[name];
+			b.stride = reader.readUInt32();
+			b.memberCount = reader.readUInt32();
+			b.access = reader.readAccess();
+		}
+
+		count = reader.readCount(12);
+		for (uint32 i = 0; i < count; i++)
+		{
+			std::string name = reader.readString();
+			Shader::BufferReflection &b = r.uniformBuffers[name];
+			b.stride = reader.readUInt32();
+			b.memberCount = reader.readUInt32();
+			b.access = Shader::ACCESS_READ;
+		}
+
+		count = reader.readCount(12);
+		for (uint32 i = 0; i < count; i++)
+		{
+			std::string name = reader.readString();
+			Shader::StorageTextureReflection &t = r.storageTextures[name];
+
+			uint32 format = reader.readUInt32();
+			if (format >= PIXELFORMAT_MAX_ENUM)
+				throw love::Exception("Invalid shader bundle: unknown pixel format.");
+
+			t.format = (PixelFormat) format;
+			t.access = reader.readAccess();
+		}
+
+		count = reader.readCount(12);
+		for (uint32 i = 0; i < count; i++)
+		{
+			std::string name = reader.readString();
+			Shader::LocalUniform &u = r.localUniforms[name];
+
+			uint32 datatype = reader.readUInt32();
+			if (datatype >= DATA_BASETYPE_MAX_ENUM)
+				throw love::Exception("Invalid shader bundle: unknown uniform data type.");
+
+			u.dataType = (DataBaseType) datatype;
+
+			uint32 valuecount = reader.readCount(4);
+
+			u.initializerValues.resize(valuecount);
+			for (auto &value : u.initializerValues)
+				value.u = reader.readUInt32();
+		}
+
+		for (int i = 0; i < 3; i++)
+			r.localThreadgroupSize[i] = (int) reader.readUInt32();
+
+		r.usesPointSize = reader.readUInt32() != 0;
+	}
+}
+
+bool ShaderBundle::isBundle(const std::string &data)
+{
+	return data.size() >= bundleMagicSize && memcmp(data.data(), bundleMagic, bundleMagicSize) == 0;
+}
+
+Shader::Language ShaderBundle::getStageSources(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute, StageSource stages[SHADERSTAGE_MAX_ENUM])
+{
+	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
+	if (compute)
+		validstages[SHADERSTAGE_COMPUTE] = true;
+	else
+	{
+		validstages[SHADERSTAGE_VERTEX] = true;
+		validstages[SHADERSTAGE_PIXEL] = true;
+	}
+
+	for (const std::string &source : sources)
+	{
+		Shader::SourceInfo info = Shader::getSourceInfo(source);
+		bool isanystage = false;
+
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			if (validstages[i] && info.stages[i] != Shader::ENTRYPOINT_NONE)
+			{
+				isanystage = true;
+				stages[i].source = &source;
+				stages[i].info = info;
+				stages[i].options = options;
+			}
+		}
+
+		if (!isanystage)
+		{
+			if (compute)
+				throw love::Exception("Could not parse compute shader code (missing 'computemain' function?)");
+			else
+				throw love::Exception("Could not parse shader code (missing shader entry point function such as 'position' or 'effect')");
+		}
+	}
+
+	Shader::Language language = Shader::LANGUAGE_GLSL1;
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (validstages[i] && stages[i].source == nullptr)
+		{
+			stages[i].source = &Shader::getDefaultCode(Shader::STANDARD_DEFAULT, (ShaderStageType) i);
+			stages[i].info = Shader::getSourceInfo(*stages[i].source);
+			stages[i].options = Shader::CompileOptions();
+		}
+
+		if (stages[i].source != nullptr)
+			language = std::max(language, stages[i].info.language);
+	}
+
+	return language;
+}
+
+void ShaderBundle::compileVariant(const StageSource stages[SHADERSTAGE_MAX_ENUM], Variant &variant)
+{
+	StrongRef<ShaderStage> validationstages[SHADERSTAGE_MAX_ENUM];
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (stages[i].source == nullptr)
+			continue;
+
+		auto stype = (ShaderStageType) i;
+		variant.glsl[i] = Shader::createShaderStageCode(stype, *stages[i].source, stages[i].options, stages[i].info, variant.code);
+		validationstages[i].set(new ShaderStageForValidation(stype, variant.glsl[i], variant.code.gles, variant.code.glsl3), Acquire::NORETAIN);
+	}
+
+	std::string err;
+	if (!Shader::validate(validationstages, err, variant.reflection))
+		throw love::Exception("%s", err.c_str());
+}
+
+bool ShaderBundle::compileSPIRV(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool gles, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM], std::string &err)
+{
+	using namespace glslang;
+
+	TShader *glslangShaders[SHADERSTAGE_MAX_ENUM] = {};
+
+	TProgram *program = new TProgram();
+
+	auto cleanup = [&]()
+	{
+		delete program;
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+			delete glslangShaders[i];
+	};
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (glsl[i].empty())
+			continue;
+
+		auto stage = (ShaderStageType) i;
+		auto glslangstage = getGLSLangStage(stage);
+		auto tshader = new TShader(glslangstage);
+
+		glslangShaders[i] = tshader;
+
+		// SPIR-V 1.0 works on every Vulkan device, and with SPIRV-Cross for Metal.
+		tshader->setEnvInput(EShSourceGlsl, glslangstage, EShClientVulkan, 450);
+		tshader->setEnvClient(EShClientVulkan, EShTargetVulkan_1_2);
+		tshader->setEnvTarget(EShTargetSpv, EShTargetSpv_1_0);
+		tshader->setAutoMapLocations(true);
+		tshader->setAutoMapBindings(true);
+		tshader->setEnvInputVulkanRulesRelaxed();
+		tshader->setGlobalUniformBinding(0);
+		tshader->setGlobalUniformSet(0);
+
+		const char *csrc = glsl[i].c_str();
+		int srclen = (int) glsl[i].length();
+		tshader->setStringsWithLengths(&csrc, &srclen, 1);
+
+		int defaultversion = 450;
+		EProfile defaultprofile = ECoreProfile;
+		bool forcedefault = false;
+		bool forwardcompat = true;
+
+		// GLSL ES code is only compiled to SPIR-V by the Metal backend on iOS.
+		if (gles)
+		{
+			defaultversion = 320;
+			defaultprofile = EEsProfile;
+			forcedefault = true;
+		}
+
+		if (!tshader->parse(&ShaderStage::getDefaultBuiltInResource(), defaultversion, defaultprofile, forcedefault, forwardcompat, EShMsgSuppressWarnings))
+		{
+			const char *stagename = "unknown";
+			ShaderStage::getConstant(stage, stagename);
+
+			err = "Error parsing " + std::string(stagename) + " shader:\n\n"
+				+ std::string(tshader->getInfoLog()) + "\n"
+				+ std::string(tshader->getInfoDebugLog());
+
+			cleanup();
+			return false;
+		}
+
+		program->addShader(tshader);
+	}
+
+	if (!program->link(EShMsgDefault))
+	{
+		err = "Cannot link shader:\n\n" + std::string(program->getInfoLog());
+		cleanup();
+		return false;
+	}
+
+	if (!program->mapIO())
+	{
+		err = "Cannot map shader inputs and outputs.";
+		cleanup();
+		return false;
+	}
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		auto intermediate = program->getIntermediate(getGLSLangStage((ShaderStageType) i));
+		if (intermediate == nullptr)
+			continue;
+
+		spv::SpvBuildLogger logger;
+		glslang::SpvOptions opt;
+		opt.validate = true;
+
+		GlslangToSpv(*intermediate, spirv[i], &logger, &opt);
+	}
+
+	cleanup();
+	return true;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "Shader.h"
+#include "ShaderStage.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A ShaderBundle holds the stages of a shader which were preprocessed and
+ * compiled ahead of time - GLSL for the OpenGL backend and SPIR-V for the
+ * Vulkan and Metal backends - along with the reflection data Shader would
+ * otherwise get from glslang. Each variant in the bundle matches one
+ * Shader::CodeVariant. The original source code is kept as well, so the shader
+ * can still be compiled at runtime when no variant matches the current system.
+ **/
+class ShaderBundle
+{
+public:
+
+	struct Variant
+	{
+		Shader::CodeVariant code;
+		std::string glsl[SHADERSTAGE_MAX_ENUM];
+
+		// Empty if the variant couldn't be compiled to SPIR-V.
+		std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM];
+
+		Shader::ValidationReflection reflection;
+	};
+
+	std::string loveVersion;
+	bool compute;
+
+	// The highest GLSL version used by any stage.
+	Shader::Language language;
+
+	std::vector<std::string> sources;
+	Shader::CompileOptions options;
+
+	std::vector<Variant> variants;
+
+	ShaderBundle();
+
+	const Variant *getVariant(const Shader::CodeVariant &code, bool needsspirv) const;
+
+	std::string serialize() const;
+	void deserialize(const void *data, size_t size);
+
+	static bool isBundle(const std::string &data);
+
+	struct StageSource
+	{
+		const std::string *source = nullptr;
+		Shader::SourceInfo info;
+		Shader::CompileOptions options;
+	};
+
+	/**
+	 * Picks which piece of code is used for each shader stage, using the
+	 * default code for missing vertex and pixel stages. Returns the highest
+	 * GLSL version used by any stage.
+	 **/
+	static Shader::Language getStageSources(const std::vector<std::string> &sources, const Shader::CompileOptions &options, bool compute, StageSource stages[SHADERSTAGE_MAX_ENUM]);
+
+	/**
+	 * Generates the code of each stage for variant.code and validates it,
+	 * filling in the variant's GLSL and reflection data. Throws an exception
+	 * if the code doesn't compile. Doesn't use any graphics API, so it can run
+	 * on any thread.
+	 **/
+	static void compileVariant(const StageSource stages[SHADERSTAGE_MAX_ENUM], Variant &variant);
+
+	/**
+	 * Compiles GLSL generated by Shader::createShaderStageCode to SPIR-V, with
+	 * the same glslang settings the Vulkan and Metal backends use.
+	 **/
+	static bool compileSPIRV(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool gles, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM], std::string &err);
+
+}; // ShaderBundle
+
+} // graphics
+} // love
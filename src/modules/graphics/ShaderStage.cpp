@@ -137,12 +137,25 @@ namespace love
 namespace graphics
 {
 
-ShaderStage::ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey)
+ShaderStage::ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv)
+	: ShaderStage(stage, glsl, gles, gfx->getCapabilities().features[Graphics::FEATURE_GLSL3], cachekey, prebuiltspirv)
+{
+}
+
+ShaderStage::ShaderStage(ShaderStageType stage, const std::string &glsl, bool gles, bool glsl3, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv)
 	: stageType(stage)
 	, source(glsl)
 	, cacheKey(cachekey)
 	, glslangValidationShader(nullptr)
+	, prebuilt(prebuiltspirv != nullptr)
 {
+	// Prebuilt stages were already validated when their bundle was created.
+	if (prebuiltspirv != nullptr)
+	{
+		prebuiltSPIRV = *prebuiltspirv;
+		return;
+	}
+
 	EShLanguage glslangStage = EShLangCount;
 	if (stage == SHADERSTAGE_VERTEX)
 		glslangStage = EShLangVertex;
@@ -155,7 +168,6 @@ ShaderStage::ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string
 
 	auto glslangShader = new glslang::TShader(glslangStage);
 
-	bool supportsGLSL3 = gfx->getCapabilities().features[Graphics::FEATURE_GLSL3];
 	int defaultversion = gles ? 100 : 120;
 	EProfile defaultprofile = ENoProfile;
 
@@ -167,7 +179,7 @@ ShaderStage::ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string
 	if (source.find("#define LOVE_GLSL1_ON_GLSL3") != std::string::npos)
 		forcedefault = true;
 
-	bool forwardcompat = supportsGLSL3 && !forcedefault;
+	bool forwardcompat = glsl3 && !forcedefault;
 
 	if (!glslangShader->parse(&defaultTBuiltInResource, defaultversion, defaultprofile, forcedefault, forwardcompat, EShMsgSuppressWarnings))
 	{
@@ -197,6 +209,11 @@ ShaderStage::~ShaderStage()
 	delete glslangValidationShader;
 }
 
+const TBuiltInResource &ShaderStage::getDefaultBuiltInResource()
+{
+	return defaultTBuiltInResource;
+}
+
 bool ShaderStage::getConstant(const char *in, ShaderStageType &out)
 {
 	return stageNames.find(in, out);
@@ -22,16 +22,20 @@
 
 #include "common/Object.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 #include "Resource.h"
 
 #include <stddef.h>
 #include <string>
+#include <vector>
 
 namespace glslang
 {
 class TShader;
 }
 
+struct TBuiltInResource;
+
 namespace love
 {
 namespace graphics
@@ -52,7 +56,12 @@ class ShaderStage : public love::Object
 {
 public:
 
-	ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey);
+	/**
+	 * If prebuiltspirv is non-null, the stage was loaded from a ShaderBundle:
+	 * glslang validation is skipped and the SPIR-V is used by backends which
+	 * need it instead of compiling the GLSL source again.
+	 **/
+	ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv);
 	virtual ~ShaderStage();
 
 	virtual ptrdiff_t getHandle() const = 0;
@@ -62,12 +71,29 @@ public:
 	const std::string &getWarnings() const { return warnings; }
 	glslang::TShader *getGLSLangValidationShader() const { return glslangValidationShader; }
 
+	bool isPrebuilt() const { return prebuilt; }
+	const std::vector<uint32> &getPrebuiltSPIRV() const { return prebuiltSPIRV; }
+
+	/**
+	 * Lets the driver compile the stage in the background, for backends which
+	 * support it. isAsyncCompileComplete returns true once using the stage
+	 * won't block.
+	 **/
+	virtual void startAsyncCompile() {}
+	virtual bool isAsyncCompileComplete() const { return true; }
+
+	static const TBuiltInResource &getDefaultBuiltInResource();
+
 	static bool getConstant(const char *in, ShaderStageType &out);
 	static bool getConstant(ShaderStageType in, const char *&out);
 	static const char *getConstant(ShaderStageType in);
 
 protected:
 
+	// glsl3 is whether GLSL 1 code in the stage was generated for GLSL 3,
+	// which the other constructor takes from the system's capabilities.
+	ShaderStage(ShaderStageType stage, const std::string &glsl, bool gles, bool glsl3, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv);
+
 	std::string warnings;
 
 private:
@@ -77,6 +103,9 @@ private:
 	std::string cacheKey;
 	glslang::TShader *glslangValidationShader;
 
+	bool prebuilt;
+	std::vector<uint32> prebuiltSPIRV;
+
 	static StringMap<ShaderStageType, SHADERSTAGE_MAX_ENUM>::Entry stageNameEntries[];
 	static StringMap<ShaderStageType, SHADERSTAGE_MAX_ENUM> stageNames;
 
@@ -86,8 +115,8 @@ class ShaderStageForValidation final : public ShaderStage
 {
 public:
 
-	ShaderStageForValidation(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles)
-		: ShaderStage(gfx, stage, glsl, gles, "")
+	ShaderStageForValidation(ShaderStageType stage, const std::string &glsl, bool gles, bool glsl3)
+		: ShaderStage(stage, glsl, gles, glsl3, "", nullptr)
 	{}
 	virtual ~ShaderStageForValidation() {}
 	ptrdiff_t getHandle() const override { return 0; }
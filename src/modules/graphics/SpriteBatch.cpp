@@ -32,6 +32,15 @@
 
 // C
 #include <stddef.h>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -40,15 +49,29 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage)
+static std::vector<Buffer::DataDeclaration> getInstanceDeclaration()
+{
+	return {
+		{ "SpriteTransform", DATAFORMAT_FLOAT_VEC4 },
+		{ "SpriteTexRect", DATAFORMAT_FLOAT_VEC4 },
+		{ "SpriteOffsetLayer", DATAFORMAT_FLOAT_VEC3 },
+		{ getConstant(ATTRIB_COLOR), DATAFORMAT_UNORM8_VEC4 },
+	};
+}
+
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
 	, color(255, 255, 255, 255)
 	, colorf(1.0f, 1.0f, 1.0f, 1.0f)
+	, instanced(instanced)
+	, sprite_stride(0)
 	, array_buf(nullptr)
 	, vertex_data(nullptr)
-	, modified_sprites()
+	, modified_sprites(MAX_MODIFIED_RANGES, MODIFIED_RANGE_MERGE_DISTANCE)
+	, expanded_dirty(true)
+	, spatial_bounds()
 	, range_start(-1)
 	, range_count(-1)
 {
@@ -65,7 +88,17 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 
 	vertex_stride = getFormatStride(vertex_format);
 
-	size_t vertex_size = vertex_stride * 4 * size;
+	if (instanced)
+	{
+		if (!gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
+			throw love::Exception("Instanced SpriteBatches are not supported on this system.");
+
+		sprite_stride = sizeof(SpriteInstance);
+	}
+	else
+		sprite_stride = vertex_stride * 4;
+
+	size_t vertex_size = sprite_stride * size;
 
 	vertex_data = (uint8 *) malloc(vertex_size);
 	if (vertex_data == nullptr)
@@ -74,9 +107,22 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 	memset(vertex_data, 0, vertex_size);
 
 	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, usage);
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
 
-	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	if (instanced)
+	{
+		array_buf.set(gfx->newBuffer(settings, getInstanceDeclaration(), nullptr, vertex_size, 0), Acquire::NORETAIN);
+
+		// Ordered like a Quad's vertices.
+		const Vector2 corners[] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
+		Buffer::Settings cornersettings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto cornerdecl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf);
+		corner_buf.set(gfx->newBuffer(cornersettings, cornerdecl, corners, sizeof(corners), 0), Acquire::NORETAIN);
+	}
+	else
+	{
+		auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+		array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	}
 }
 
 SpriteBatch::~SpriteBatch()
@@ -100,24 +146,9 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
-	const Vector2 *quadpositions = quad->getVertexPositions();
-	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
-
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
-
-	m.transformXY(verts, quadpositions, 4);
-
-	for (int i = 0; i < 4; i++)
-	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].color = color;
-	}
-
-	modified_sprites.encapsulate(spriteindex);
+	setSprite(spriteindex, 0, quad, m);
 
 	// Increment counter.
 	if (index == -1)
@@ -145,52 +176,507 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
+	int spriteindex = (index == -1 ? next : index);
+
+	setSprite(spriteindex, layer, quad, m);
+
+	// Increment counter.
+	if (index == -1)
+		return next++;
+
+	return index;
+}
+
+int SpriteBatch::setTransforms(int index, const float *transforms, int count, Quad *quad)
+{
+	if (quad == nullptr)
+		quad = texture->getQuad();
+
+	if (count < 0)
+		throw love::Exception("Invalid sprite count: %d", count);
+
+	if (index < -1 || index >= size || (index >= 0 && count > size - index))
+		throw love::Exception("Invalid sprite index: %d", index + 1);
+
+	if (index == -1 && count > size - next)
+		setBufferSize(std::max(size * 2, next + count));
+
+	int layer = 0;
+	if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
+	{
+		layer = quad->getLayer();
+		if (layer < 0 || layer >= texture->getLayerCount())
+			throw love::Exception("Invalid layer: %d (Texture has %d layers)", layer + 1, texture->getLayerCount());
+	}
+
+	int first = (index == -1 ? next : index);
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *t = transforms + i * 5;
+		Matrix4 m(t[0], t[1], t[2], t[3], t[4], 0.0f, 0.0f, 0.0f, 0.0f);
+		setSprite(first + i, layer, quad, m);
+	}
+
+	if (index == -1)
+		next += count;
+
+	return first;
+}
+
+// Computes the 2x2 part of each sprite's transform from its rotation and
+// scale: a and b are the x axis, c and d the y axis.
+static void computeSpriteAxes(int count, const float *cosines, const float *sines, const float *sx, const float *sy, float *a, float *b, float *c, float *d)
+{
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	for (; i + 3 < count; i += 4)
+	{
+		__m128 cs = _mm_loadu_ps(cosines + i);
+		__m128 sn = _mm_loadu_ps(sines + i);
+		__m128 scalex = _mm_loadu_ps(sx + i);
+		__m128 scaley = _mm_loadu_ps(sy + i);
+
+		_mm_storeu_ps(a + i, _mm_mul_ps(cs, scalex));
+		_mm_storeu_ps(b + i, _mm_mul_ps(sn, scalex));
+		_mm_storeu_ps(c + i, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sn, scaley)));
+		_mm_storeu_ps(d + i, _mm_mul_ps(cs, scaley));
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i + 3 < count; i += 4)
+	{
+		float32x4_t cs = vld1q_f32(cosines + i);
+		float32x4_t sn = vld1q_f32(sines + i);
+		float32x4_t scalex = vld1q_f32(sx + i);
+		float32x4_t scaley = vld1q_f32(sy + i);
+
+		vst1q_f32(a + i, vmulq_f32(cs, scalex));
+		vst1q_f32(b + i, vmulq_f32(sn, scalex));
+		vst1q_f32(c + i, vnegq_f32(vmulq_f32(sn, scaley)));
+		vst1q_f32(d + i, vmulq_f32(cs, scaley));
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		a[i] = cosines[i] * sx[i];
+		b[i] = sines[i] * sx[i];
+		c[i] = -sines[i] * sy[i];
+		d[i] = cosines[i] * sy[i];
+	}
+}
+
+int SpriteBatch::setArrays(int index, int count, const SpriteArrays &arrays, const std::vector<Quad *> &quads)
+{
+	if (arrays.x == nullptr || arrays.y == nullptr)
+		throw love::Exception("Sprite x and y arrays are required.");
+
+	if (count < 0)
+		throw love::Exception("Invalid sprite count: %d", count);
+
+	if (index < -1 || index >= size || (index >= 0 && count > size - index))
+		throw love::Exception("Invalid sprite index: %d", index + 1);
+
+	Quad *defaultquad = quads.empty() ? texture->getQuad() : quads[0];
+	bool arraytexture = vertex_format == CommonFormat::XYf_STPf_RGBAub;
+
+	// Validate everything before any sprite is changed.
+	if (arrays.quad != nullptr)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (arrays.quad[i] >= std::max(quads.size(), (size_t) 1))
+				throw love::Exception("Invalid quad index %d for sprite %d.", (int) arrays.quad[i], i + 1);
+		}
+	}
+
+	if (arraytexture)
+	{
+		for (Quad *q : quads)
+		{
+			if (q->getLayer() < 0 || q->getLayer() >= texture->getLayerCount())
+				throw love::Exception("Invalid layer: %d (Texture has %d layers)", q->getLayer() + 1, texture->getLayerCount());
+		}
+	}
+
+	if (index == -1 && count > size - next)
+		setBufferSize(std::max(size * 2, next + count));
+
+	int first = (index == -1 ? next : index);
+
+	// Sprites are processed in chunks small enough to keep the intermediate
+	// values on the stack.
+	const int CHUNK_SIZE = 256;
+
+	float cosines[CHUNK_SIZE];
+	float sines[CHUNK_SIZE];
+	float scalex[CHUNK_SIZE];
+	float scaley[CHUNK_SIZE];
+	float a[CHUNK_SIZE];
+	float b[CHUNK_SIZE];
+	float c[CHUNK_SIZE];
+	float d[CHUNK_SIZE];
+
+	for (int chunk = 0; chunk < count; chunk += CHUNK_SIZE)
+	{
+		int n = std::min(CHUNK_SIZE, count - chunk);
+
+		for (int i = 0; i < n; i++)
+		{
+			float angle = arrays.angle ? arrays.angle[chunk + i] : 0.0f;
+			cosines[i] = cosf(angle);
+			sines[i] = sinf(angle);
+			scalex[i] = arrays.sx ? arrays.sx[chunk + i] : 1.0f;
+			scaley[i] = arrays.sy ? arrays.sy[chunk + i] : scalex[i];
+		}
+
+		computeSpriteAxes(n, cosines, sines, scalex, scaley, a, b, c, d);
+
+		for (int i = 0; i < n; i++)
+		{
+			int j = chunk + i;
+			int spriteindex = first + j;
+
+			Quad *quad = arrays.quad && !quads.empty() ? quads[arrays.quad[j]] : defaultquad;
+			const Vector2 *quadpositions = quad->getVertexPositions();
+			const Vector2 *quadtexcoords = quad->getVertexTexCoords();
+
+			float w = quadpositions[3].x;
+			float h = quadpositions[3].y;
+
+			float ox = arrays.ox ? arrays.ox[j] : 0.0f;
+			float oy = arrays.oy ? arrays.oy[j] : 0.0f;
+
+			float x = arrays.x[j] - ox * a[i] - oy * c[i];
+			float y = arrays.y[j] - ox * b[i] - oy * d[i];
+
+			Color32 spritecolor = arrays.color ? arrays.color[j] : color;
+			float layer = arraytexture ? (float) quad->getLayer() : 0.0f;
+
+			if (instanced)
+			{
+				SpriteInstance &s = ((SpriteInstance *) vertex_data)[spriteindex];
+
+				s.transform[0] = a[i] * w;
+				s.transform[1] = b[i] * w;
+				s.transform[2] = c[i] * h;
+				s.transform[3] = d[i] * h;
+				s.texRect[0] = quadtexcoords[0].x;
+				s.texRect[1] = quadtexcoords[0].y;
+				s.texRect[2] = quadtexcoords[3].x - quadtexcoords[0].x;
+				s.texRect[3] = quadtexcoords[3].y - quadtexcoords[0].y;
+				s.offset[0] = x;
+				s.offset[1] = y;
+				s.layer = layer;
+				s.color = spritecolor;
+				continue;
+			}
+
+			uint8 *spriteverts = vertex_data + spriteindex * sprite_stride;
+
+			for (int v = 0; v < 4; v++)
+			{
+				const Vector2 &p = quadpositions[v];
+
+				// Every vertex format starts with XYf_STf.
+				auto vert = (XYf_STf *) (spriteverts + vertex_stride * v);
+				vert->x = x + a[i] * p.x + c[i] * p.y;
+				vert->y = y + b[i] * p.x + d[i] * p.y;
+				vert->s = quadtexcoords[v].x;
+				vert->t = quadtexcoords[v].y;
+
+				if (arraytexture)
+				{
+					auto arrayvert = (XYf_STPf_RGBAub *) vert;
+					arrayvert->p = layer;
+					arrayvert->color = spritecolor;
+				}
+				else
+					((XYf_STf_RGBAub *) vert)->color = spritecolor;
+			}
+		}
+	}
+
+	if (count > 0)
+	{
+		modified_sprites.encapsulate(first, count);
+		spatial_cells.clear();
+	}
+
+	if (index == -1)
+		next += count;
+
+	return first;
+}
+
+void SpriteBatch::setSprite(int spriteindex, int layer, Quad *quad, const Matrix4 &m)
+{
 	const Vector2 *quadpositions = quad->getVertexPositions();
 	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
 
-	int spriteindex = (index == -1 ? next : index);
+	if (instanced)
+	{
+		if (!m.isAffine2DTransform())
+			throw love::Exception("Instanced SpriteBatches only support 2D transforms.");
+
+		const float *e = m.getElements();
+
+		float w = quadpositions[3].x;
+		float h = quadpositions[3].y;
+
+		SpriteInstance &s = ((SpriteInstance *) vertex_data)[spriteindex];
+
+		s.transform[0] = e[0] * w;
+		s.transform[1] = e[1] * w;
+		s.transform[2] = e[4] * h;
+		s.transform[3] = e[5] * h;
+		s.texRect[0] = quadtexcoords[0].x;
+		s.texRect[1] = quadtexcoords[0].y;
+		s.texRect[2] = quadtexcoords[3].x - quadtexcoords[0].x;
+		s.texRect[3] = quadtexcoords[3].y - quadtexcoords[0].y;
+		s.offset[0] = e[12];
+		s.offset[1] = e[13];
+		s.layer = (float) layer;
+		s.color = color;
+	}
+	else if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
+	{
+		auto verts = (XYf_STPf_RGBAub *) (vertex_data + spriteindex * sprite_stride);
+
+		m.transformXY(verts, quadpositions, 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].p = (float) layer;
+			verts[i].color = color;
+		}
+	}
+	else
+	{
+		auto verts = (XYf_STf_RGBAub *) (vertex_data + spriteindex * sprite_stride);
+
+		m.transformXY(verts, quadpositions, 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].color = color;
+		}
+	}
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
+	modified_sprites.encapsulate(spriteindex);
+	spatial_cells.clear();
+}
 
-	m.transformXY(verts, quadpositions, 4);
+void SpriteBatch::getSpriteBounds(int spriteindex, float *bounds) const
+{
+	float x[4];
+	float y[4];
+
+	if (instanced)
+	{
+		const SpriteInstance &s = ((const SpriteInstance *) vertex_data)[spriteindex];
+
+		for (int v = 0; v < 4; v++)
+		{
+			float cx = (float) (v >> 1);
+			float cy = (float) (v & 1);
+			x[v] = s.transform[0] * cx + s.transform[2] * cy + s.offset[0];
+			y[v] = s.transform[1] * cx + s.transform[3] * cy + s.offset[1];
+		}
+	}
+	else
+	{
+		// Both vertex formats start with the position.
+		const uint8 *verts = vertex_data + spriteindex * sprite_stride;
+
+		for (int v = 0; v < 4; v++)
+		{
+			const float *pos = (const float *) (verts + vertex_stride * v);
+			x[v] = pos[0];
+			y[v] = pos[1];
+		}
+	}
+
+	bounds[0] = std::min(std::min(x[0], x[1]), std::min(x[2], x[3]));
+	bounds[1] = std::min(std::min(y[0], y[1]), std::min(y[2], y[3]));
+	bounds[2] = std::max(std::max(x[0], x[1]), std::max(x[2], x[3]));
+	bounds[3] = std::max(std::max(y[0], y[1]), std::max(y[2], y[3]));
+}
+
+void SpriteBatch::sortSpatially(float cellsize)
+{
+	if (!(cellsize > 0.0f))
+		throw love::Exception("Invalid cell size: %f", cellsize);
+
+	// Attached attributes would no longer line up with the sprites.
+	if (!attached_attributes.empty())
+		throw love::Exception("SpriteBatches with attached vertex attributes can't be sorted spatially.");
+
+	spatial_cells.clear();
+
+	if (next == 0)
+		return;
+
+	struct SortedSprite
+	{
+		int cellx;
+		int celly;
+		int index;
+		float bounds[4];
+	};
+
+	std::vector<SortedSprite> sprites(next);
+
+	for (int i = 0; i < next; i++)
+	{
+		SortedSprite &sprite = sprites[i];
+		getSpriteBounds(i, sprite.bounds);
+
+		double cx = std::floor((sprite.bounds[0] + sprite.bounds[2]) * 0.5 / cellsize);
+		double cy = std::floor((sprite.bounds[1] + sprite.bounds[3]) * 0.5 / cellsize);
+
+		sprite.cellx = (int) std::min(std::max(cx, -1e9), 1e9);
+		sprite.celly = (int) std::min(std::max(cy, -1e9), 1e9);
+		sprite.index = i;
+	}
+
+	// Rows of cells, so the visible cells of a row are usually contiguous.
+	std::stable_sort(sprites.begin(), sprites.end(), [](const SortedSprite &a, const SortedSprite &b)
+	{
+		return a.celly != b.celly ? a.celly < b.celly : a.cellx < b.cellx;
+	});
+
+	std::vector<uint8> sorted(sprite_stride * next);
+
+	for (int i = 0; i < next; i++)
+	{
+		const SortedSprite &sprite = sprites[i];
+		memcpy(sorted.data() + i * sprite_stride, vertex_data + sprite.index * sprite_stride, sprite_stride);
+
+		if (i == 0 || sprite.cellx != sprites[i - 1].cellx || sprite.celly != sprites[i - 1].celly)
+		{
+			SpatialCell cell = {i, 0, {sprite.bounds[0], sprite.bounds[1], sprite.bounds[2], sprite.bounds[3]}};
+			spatial_cells.push_back(cell);
+		}
+
+		SpatialCell &cell = spatial_cells.back();
+		cell.count++;
+		cell.bounds[0] = std::min(cell.bounds[0], sprite.bounds[0]);
+		cell.bounds[1] = std::min(cell.bounds[1], sprite.bounds[1]);
+		cell.bounds[2] = std::max(cell.bounds[2], sprite.bounds[2]);
+		cell.bounds[3] = std::max(cell.bounds[3], sprite.bounds[3]);
+	}
+
+	memcpy(vertex_data, sorted.data(), sorted.size());
+	modified_sprites.encapsulate(0, next);
+	expanded_dirty = true;
 
 	for (int i = 0; i < 4; i++)
+		spatial_bounds[i] = spatial_cells[0].bounds[i];
+
+	for (const SpatialCell &cell : spatial_cells)
 	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].p = (float) layer;
-		verts[i].color = color;
+		spatial_bounds[0] = std::min(spatial_bounds[0], cell.bounds[0]);
+		spatial_bounds[1] = std::min(spatial_bounds[1], cell.bounds[1]);
+		spatial_bounds[2] = std::max(spatial_bounds[2], cell.bounds[2]);
+		spatial_bounds[3] = std::max(spatial_bounds[3], cell.bounds[3]);
 	}
+}
 
-	modified_sprites.encapsulate(spriteindex);
+bool SpriteBatch::isSpatiallySorted() const
+{
+	return !spatial_cells.empty();
+}
 
-	// Increment counter.
-	if (index == -1)
-		return next++;
+void SpriteBatch::translateOrigin(float x, float y)
+{
+	if (next == 0)
+		return;
 
-	return index;
+	if (instanced)
+	{
+		SpriteInstance *sprites = (SpriteInstance *) vertex_data;
+		for (int i = 0; i < next; i++)
+		{
+			sprites[i].offset[0] -= x;
+			sprites[i].offset[1] -= y;
+		}
+	}
+	else
+	{
+		// Both vertex formats start with the position.
+		for (int i = 0; i < next * 4; i++)
+		{
+			float *pos = (float *) (vertex_data + i * vertex_stride);
+			pos[0] -= x;
+			pos[1] -= y;
+		}
+	}
+
+	for (SpatialCell &cell : spatial_cells)
+	{
+		cell.bounds[0] -= x;
+		cell.bounds[1] -= y;
+		cell.bounds[2] -= x;
+		cell.bounds[3] -= y;
+	}
+
+	spatial_bounds[0] -= x;
+	spatial_bounds[1] -= y;
+	spatial_bounds[2] -= x;
+	spatial_bounds[3] -= y;
+
+	modified_sprites.encapsulate(0, next);
+}
+
+bool SpriteBatch::getBounds(float &x, float &y, float &w, float &h) const
+{
+	if (spatial_cells.empty())
+		return false;
+
+	x = spatial_bounds[0];
+	y = spatial_bounds[1];
+	w = spatial_bounds[2] - spatial_bounds[0];
+	h = spatial_bounds[3] - spatial_bounds[1];
+	return true;
 }
 
 void SpriteBatch::clear()
 {
 	// Reset the position of the next index.
 	next = 0;
+	spatial_cells.clear();
 }
 
 void SpriteBatch::flush()
 {
-	if (modified_sprites.isValid())
+	if (!modified_sprites.isEmpty())
 	{
-		size_t offset = modified_sprites.getOffset() * vertex_stride * 4;
-		size_t size = modified_sprites.getSize() * vertex_stride * 4;
-
 		if (array_buf->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 			array_buf->fill(0, array_buf->getSize(), vertex_data);
 		else
-			array_buf->fill(offset, size, vertex_data + offset);
+		{
+			// Scattered set() calls upload a few separate ranges rather than
+			// everything between the first and last modified sprite.
+			for (const Range &r : modified_sprites.getRanges())
+			{
+				size_t offset = r.getOffset() * sprite_stride;
+				size_t size = r.getSize() * sprite_stride;
+				array_buf->fill(offset, size, vertex_data + offset);
+			}
+		}
 
-		modified_sprites.invalidate();
+		modified_sprites.clear();
+		expanded_dirty = true;
 	}
 }
 
@@ -235,7 +721,7 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	size_t vertex_size = sprite_stride * newsize;
 
 	int new_next = std::min(next, newsize);
 
@@ -245,16 +731,24 @@ void SpriteBatch::setBufferSize(int newsize)
 
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	Buffer::Settings settings(array_buf->getUsageFlags(), array_buf->getDataUsage());
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
 
-	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	if (instanced)
+		array_buf.set(gfx->newBuffer(settings, getInstanceDeclaration(), nullptr, vertex_size, 0), Acquire::NORETAIN);
+	else
+	{
+		auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+		array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+	}
 
-	array_buf->fill(0, vertex_stride * 4 * new_next, new_vertex_data);
+	array_buf->fill(0, sprite_stride * new_next, new_vertex_data);
 
 	vertex_data = (uint8 *) new_vertex_data;
 
 	size = newsize;
 	next = new_next;
+
+	expanded_dirty = true;
+	spatial_cells.clear();
 }
 
 int SpriteBatch::getBufferSize() const
@@ -262,6 +756,11 @@ int SpriteBatch::getBufferSize() const
 	return size;
 }
 
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
 void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh *mesh)
 {
 	if ((buffer->getUsageFlags() & BUFFERUSAGEFLAG_VERTEX) == 0)
@@ -270,8 +769,11 @@ void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
-	if (buffer->getArrayLength() < (size_t) next * 4)
-		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*4);
+	// Attributes of instanced SpriteBatches are per sprite.
+	int vertexcount = instanced ? next : next * 4;
+
+	if (buffer->getArrayLength() < (size_t) vertexcount)
+		throw love::Exception("Buffer has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", vertexcount);
 
 	auto it = attached_attributes.find(name);
 	if (it != attached_attributes.end())
@@ -312,6 +814,69 @@ bool SpriteBatch::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+void SpriteBatch::updateExpandedVertices()
+{
+	if (!expanded_dirty && expanded_buf.get() != nullptr)
+		return;
+
+	size_t spritesize = vertex_stride * 4;
+	expanded_data.resize(spritesize * size);
+
+	const SpriteInstance *instances = (const SpriteInstance *) vertex_data;
+
+	for (int i = 0; i < next; i++)
+	{
+		const SpriteInstance &s = instances[i];
+		uint8 *spriteverts = expanded_data.data() + spritesize * i;
+
+		for (int v = 0; v < 4; v++)
+		{
+			// Same corner order as the vertices of a Quad.
+			float cx = (float) (v >> 1);
+			float cy = (float) (v & 1);
+
+			float x = s.transform[0] * cx + s.transform[2] * cy + s.offset[0];
+			float y = s.transform[1] * cx + s.transform[3] * cy + s.offset[1];
+			float u = s.texRect[0] + s.texRect[2] * cx;
+			float t = s.texRect[1] + s.texRect[3] * cy;
+
+			if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
+			{
+				auto vert = (XYf_STPf_RGBAub *) (spriteverts + vertex_stride * v);
+				vert->x = x;
+				vert->y = y;
+				vert->s = u;
+				vert->t = t;
+				vert->p = s.layer;
+				vert->color = s.color;
+			}
+			else
+			{
+				auto vert = (XYf_STf_RGBAub *) (spriteverts + vertex_stride * v);
+				vert->x = x;
+				vert->y = y;
+				vert->s = u;
+				vert->t = t;
+				vert->color = s.color;
+			}
+		}
+	}
+
+	if (expanded_buf.get() == nullptr || expanded_buf->getSize() < expanded_data.size())
+	{
+		auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_DYNAMIC);
+		auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+
+		expanded_buf.set(gfx->newBuffer(settings, decl, nullptr, expanded_data.size(), 0), Acquire::NORETAIN);
+	}
+
+	if (next > 0)
+		expanded_buf->fill(0, spritesize * next, expanded_data.data());
+
+	expanded_dirty = false;
+}
+
 void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 {
 	if (next == 0)
@@ -323,12 +888,24 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	{
 		if (Shader::isDefaultActive())
 		{
+			bool arraytexture = texture->getTextureType() == TEXTURE_2D_ARRAY;
+
 			Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
-			if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+			if (arraytexture)
 				defaultshader = Shader::STANDARD_ARRAY;
 
+			if (instanced)
+			{
+				auto spriteshader = arraytexture ? Shader::STANDARD_ARRAY_SPRITES : Shader::STANDARD_SPRITES;
+				if (Shader::standardShaders[spriteshader] != nullptr)
+					defaultshader = spriteshader;
+			}
+
 			Shader::attachDefault(defaultshader);
 		}
+
+		if (texture->isStreaming())
+			texture->markUsed(gfx->getTextureStreamingFrame());
 	}
 
 	if (Shader::current)
@@ -336,15 +913,69 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	flush(); // Upload any modified sprite data to the GPU.
 
+	int transformindex = -1;
+	int texrectindex = -1;
+	int offsetlayerindex = -1;
+
+	if (instanced && Shader::current)
+	{
+		transformindex = Shader::current->getVertexAttributeIndex("SpriteTransform");
+		texrectindex = Shader::current->getVertexAttributeIndex("SpriteTexRect");
+		offsetlayerindex = Shader::current->getVertexAttributeIndex("SpriteOffsetLayer");
+	}
+
+	// Shaders which don't place sprites from their instance data get regular
+	// vertices instead.
+	bool useinstances = instanced && transformindex >= 0;
+
+	int start = std::min(std::max(0, range_start), next - 1);
+
+	int count = next;
+	if (range_count > 0)
+		count = std::min(count, range_count);
+
+	count = std::min(count, next - start);
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
+	if (useinstances)
+	{
+		buffers.set(0, corner_buf, 0);
+		attributes.setCommonFormat(CommonFormat::XYf, 0);
+
+		buffers.set(1, array_buf, start * sprite_stride);
+		attributes.set(transformindex, DATAFORMAT_FLOAT_VEC4, offsetof(SpriteInstance, transform), 1);
+		if (texrectindex >= 0)
+			attributes.set(texrectindex, DATAFORMAT_FLOAT_VEC4, offsetof(SpriteInstance, texRect), 1);
+		if (offsetlayerindex >= 0)
+			attributes.set(offsetlayerindex, DATAFORMAT_FLOAT_VEC3, offsetof(SpriteInstance, offset), 1);
+		attributes.set(ATTRIB_COLOR, DATAFORMAT_UNORM8_VEC4, offsetof(SpriteInstance, color), 1);
+		attributes.setBufferLayout(1, (uint16) sprite_stride, STEP_PER_INSTANCE);
+	}
+	else if (instanced)
+	{
+		if (!attached_attributes.empty())
+			throw love::Exception("Vertex attributes attached to an instanced SpriteBatch can only be used with a shader that uses its sprite instance attributes.");
+
+		updateExpandedVertices();
+
+		buffers.set(0, expanded_buf, 0);
+		attributes.setCommonFormat(vertex_format, 0);
+	}
+	else
 	{
 		buffers.set(0, array_buf, 0);
 		attributes.setCommonFormat(vertex_format, 0);
 	}
 
-	int activebuffers = 1;
+	int activebuffers = useinstances ? 2 : 1;
+
+	// Per-instance attached attributes are offset to each drawn range.
+	std::vector<std::pair<int, Buffer *>> instancebuffers;
+
+	// Attached attributes of instanced SpriteBatches have one value per sprite.
+	int vertexcount = instanced ? next : next * 4;
 
 	for (const auto &it : attached_attributes)
 	{
@@ -352,7 +983,7 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 		// We have to do this check here as wll because setBufferSize can be
 		// called after attachAttribute.
-		if (buffer->getArrayLength() < (size_t) next * 4)
+		if (buffer->getArrayLength() < (size_t) vertexcount)
 			throw love::Exception("Buffer with attribute '%s' attached to this SpriteBatch has too few vertices", it.first.c_str());
 
 		int attributeindex = -1;
@@ -376,26 +1007,74 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 			uint16 stride = (uint16) buffer->getArrayStride();
 
 			attributes.set(attributeindex, member.decl.format, offset, activebuffers);
-			attributes.setBufferLayout(activebuffers, stride);
 
 			// TODO: We should reuse buffer bindings with the same buffer+stride+step.
-			buffers.set(activebuffers, buffer, 0);
+			if (useinstances)
+			{
+				attributes.setBufferLayout(activebuffers, stride, STEP_PER_INSTANCE);
+				instancebuffers.emplace_back(activebuffers, buffer);
+			}
+			else
+			{
+				attributes.setBufferLayout(activebuffers, stride);
+				buffers.set(activebuffers, buffer, 0);
+			}
+
 			activebuffers++;
 		}
 	}
 
-	Graphics::TempTransform transform(gfx, m);
+	if (count <= 0)
+		return;
 
-	int start = std::min(std::max(0, range_start), next - 1);
+	// Spatially sorted sprites are only drawn from visible cells, merging
+	// cells which are next to each other in the batch.
+	std::vector<std::pair<int, int>> ranges;
 
-	int count = next;
-	if (range_count > 0)
-		count = std::min(count, range_count);
+	if (!spatial_cells.empty())
+	{
+		for (const SpatialCell &cell : spatial_cells)
+		{
+			int first = std::max(cell.start, start);
+			int last = std::min(cell.start + cell.count, start + count);
 
-	count = std::min(count, next - start);
+			if (first >= last)
+				continue;
 
-	if (count > 0)
-		gfx->drawQuads(start, count, attributes, buffers, texture);
+			const float *b = cell.bounds;
+			if (!gfx->isRectVisible(m, b[0], b[1], b[2] - b[0], b[3] - b[1]))
+				continue;
+
+			if (!ranges.empty() && ranges.back().first + ranges.back().second == first)
+				ranges.back().second += last - first;
+			else
+				ranges.emplace_back(first, last - first);
+		}
+	}
+	else
+		ranges.emplace_back(start, count);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (const auto &range : ranges)
+	{
+		if (useinstances)
+		{
+			buffers.set(1, array_buf, range.first * sprite_stride);
+			for (const auto &b : instancebuffers)
+				buffers.set(b.first, b.second, range.first * b.second->getArrayStride());
+
+			Graphics::DrawIndexedCommand cmd(&attributes, &buffers, gfx->getQuadIndexBuffer());
+			cmd.primitiveType = PRIMITIVE_TRIANGLES;
+			cmd.indexCount = 6;
+			cmd.instanceCount = range.second;
+			cmd.indexType = INDEX_UINT16;
+			cmd.texture = texture;
+			gfx->draw(cmd);
+		}
+		else
+			gfx->drawQuads(range.first, range.second, attributes, buffers, texture);
+	}
 }
 
 } // graphics
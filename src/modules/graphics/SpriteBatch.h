@@ -25,6 +25,7 @@
 
 // C++
 #include <unordered_map>
+#include <vector>
 
 // LOVE
 #include "common/math.h"
@@ -52,7 +53,35 @@ public:
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage);
+	// Per-sprite data of an instanced SpriteBatch. The size of the sprite's
+	// quad is folded into the transform, so the vertex shader only has to
+	// place a unit square's corners.
+	struct SpriteInstance
+	{
+		float transform[4];
+		float texRect[4];
+		float offset[2];
+		float layer;
+		Color32 color;
+	};
+
+	// Packed per-sprite values for setArrays. Only x and y are required, the
+	// others default to no rotation, a scale of 1, no origin offset, the
+	// first quad, and the current color.
+	struct SpriteArrays
+	{
+		const float *x = nullptr;
+		const float *y = nullptr;
+		const float *angle = nullptr;
+		const float *sx = nullptr;
+		const float *sy = nullptr;
+		const float *ox = nullptr;
+		const float *oy = nullptr;
+		const uint16 *quad = nullptr;
+		const Color32 *color = nullptr;
+	};
+
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
@@ -60,6 +89,25 @@ public:
 	int addLayer(int layer, const Matrix4 &m, int index = -1);
 	int addLayer(int layer, Quad *quad, const Matrix4 &m, int index = -1);
 
+	/**
+	 * Sets count consecutive sprites to the given quad (or the whole texture),
+	 * starting at index. When index is -1 the sprites are added at the end.
+	 * Each sprite is described by five floats in transforms: x, y, angle,
+	 * scale x and scale y.
+	 *
+	 * @return The index of the first sprite.
+	 **/
+	int setTransforms(int index, const float *transforms, int count, Quad *quad = nullptr);
+
+	/**
+	 * Sets count consecutive sprites starting at index (or appends them when
+	 * index is -1) from structure-of-arrays data. Quad values index into the
+	 * quads list, which may be empty to use the whole texture.
+	 *
+	 * @return The index of the first sprite.
+	 **/
+	int setArrays(int index, int count, const SpriteArrays &arrays, const std::vector<Quad *> &quads);
+
 	void clear();
 
 	void flush();
@@ -90,6 +138,12 @@ public:
 	 **/
 	int getBufferSize() const;
 
+	/**
+	 * Whether this SpriteBatch stores one SpriteInstance per sprite which is
+	 * expanded in the vertex shader, instead of four vertices per sprite.
+	 **/
+	bool isInstanced() const;
+
 	/**
 	 * Attaches a specific vertex attribute from a Buffer to this SpriteBatch.
 	 * The vertex attribute will be used when drawing the SpriteBatch.
@@ -103,11 +157,33 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Reorders the sprites by the grid cell their centers are in, using cells
+	 * of the given size in the SpriteBatch's local coordinates. Until the
+	 * sprites are modified again, draws skip cells which are entirely outside
+	 * the viewport or scissor rectangle. Sprite indices change.
+	 **/
+	void sortSpatially(float cellsize);
+	bool isSpatiallySorted() const;
+
+	/**
+	 * Moves every sprite by (-x, -y), for when the world's origin is moved to
+	 * (x, y). A spatially sorted SpriteBatch stays sorted.
+	 **/
+	void translateOrigin(float x, float y);
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
+	bool getBounds(float &x, float &y, float &w, float &h) const override;
 
 private:
 
+	// Flushes upload at most this many separate ranges of sprites.
+	static const size_t MAX_MODIFIED_RANGES = 8;
+
+	// Modified ranges closer than this many sprites are uploaded together.
+	static const size_t MODIFIED_RANGE_MERGE_DISTANCE = 16;
+
 	struct AttachedAttribute
 	{
 		StrongRef<Buffer> buffer;
@@ -115,12 +191,30 @@ private:
 		int index;
 	};
 
+	// A run of consecutive sprites of a spatially sorted SpriteBatch which
+	// belong to the same grid cell.
+	struct SpatialCell
+	{
+		int start;
+		int count;
+		float bounds[4]; // min x, min y, max x, max y.
+	};
+
 	/**
 	 * Sets the total number of sprites this SpriteBatch can hold.
 	 * Leaves existing sprite data intact when possible.
 	 **/
 	void setBufferSize(int newsize);
 
+	void setSprite(int spriteindex, int layer, Quad *quad, const Matrix4 &m);
+
+	// Gets the min x, min y, max x and max y of a sprite's corners.
+	void getSpriteBounds(int spriteindex, float *bounds) const;
+
+	// Custom shaders which don't use the instance attributes get four regular
+	// vertices per sprite, expanded on the CPU.
+	void updateExpandedVertices();
+
 	StrongRef<Texture> texture;
 
 	// Max number of sprites in the batch.
@@ -136,12 +230,28 @@ private:
 	CommonFormat vertex_format;
 	size_t vertex_stride;
 
+	bool instanced;
+
+	// Bytes of vertex_data used by each sprite.
+	size_t sprite_stride;
+
 	StrongRef<love::graphics::Buffer> array_buf;
 	uint8 *vertex_data;
 
-	Range modified_sprites;
+	// Sprites changed since the last flush.
+	RangeList modified_sprites;
+
+	// Only used by instanced SpriteBatches.
+	StrongRef<love::graphics::Buffer> corner_buf;
+	StrongRef<love::graphics::Buffer> expanded_buf;
+	std::vector<uint8> expanded_data;
+	bool expanded_dirty;
 
 	std::unordered_map<std::string, AttachedAttribute> attached_attributes;
+
+	// Empty unless the sprites are spatially sorted.
+	std::vector<SpatialCell> spatial_cells;
+	float spatial_bounds[4];
 	
 	int range_start;
 	int range_count;
@@ -26,6 +26,9 @@ namespace love
 namespace graphics
 {
 
+int64 StreamBuffer::frameBytesUsed = 0;
+int StreamBuffer::frameStalls = 0;
+
 StreamBuffer::StreamBuffer(BufferUsage mode, size_t size)
 	: bufferSize(size)
 	, frameGPUReadOffset(0)
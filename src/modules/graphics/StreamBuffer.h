@@ -51,6 +51,12 @@ public:
 		{}
 	};
 
+	// Bytes used by draws and number of times the CPU had to wait for the
+	// GPU before it could write new data, across all StreamBuffers. Reset by
+	// Graphics at the end of each frame.
+	static int64 frameBytesUsed;
+	static int frameStalls;
+
 	virtual ~StreamBuffer() {}
 
 	size_t getSize() const { return bufferSize; }
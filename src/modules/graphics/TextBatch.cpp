@@ -22,6 +22,7 @@
 #include "Graphics.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace love
 {
@@ -36,6 +37,8 @@ TextBatch::TextBatch(Font *font, const std::vector<love::font::ColoredString> &t
 	, vertexData(nullptr)
 	, modifiedVertices()
 	, vertOffset(0)
+	, bounds()
+	, boundsDirty(true)
 	, textureCacheID((uint32) -1)
 {
 	set(text);
@@ -81,12 +84,18 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 		vertexBuffer = newbuffer;
 
 		vertexBuffers.set(0, vertexBuffer, 0);
+
+		// The new buffer starts out empty, so existing vertices before the
+		// new ones have to be uploaded to it as well.
+		if (offset > 0)
+			modifiedVertices.encapsulate(0, offset);
 	}
 
 	if (vertexData != nullptr && datasize > 0)
 	{
 		memcpy(vertexData + offset, &vertices[0], datasize);
 		modifiedVertices.encapsulate(offset, datasize);
+		boundsDirty = true;
 	}
 }
 
@@ -107,65 +116,234 @@ void TextBatch::regenerateVertices()
 	}
 }
 
-void TextBatch::addTextData(const TextData &t)
+static void spliceCodepoints(love::font::ColoredCodepoints &dst, size_t start, size_t count, const love::font::ColoredCodepoints &src)
 {
-	std::vector<Font::GlyphVertex> vertices;
-	std::vector<Font::DrawCommand> newcommands;
+	const Colorf white(1.0f, 1.0f, 1.0f, 1.0f);
+
+	size_t end = start + count;
+	size_t srcsize = src.cps.size();
+	int delta = (int) srcsize - (int) count;
+
+	std::vector<love::font::IndexedColor> colors;
+
+	if (!dst.colors.empty() || !src.colors.empty())
+	{
+		// The color in effect at the end of the replaced range, so the text
+		// after it keeps its color.
+		Colorf aftercolor = white;
+		bool hasaftercolor = false;
+
+		for (const love::font::IndexedColor &c : dst.colors)
+		{
+			if (c.index < (int) end)
+				aftercolor = c.color;
+			else if (c.index == (int) end)
+				hasaftercolor = true;
+		}
 
-	love::font::TextShaper::TextInfo textinfo;
+		for (const love::font::IndexedColor &c : dst.colors)
+		{
+			if (c.index < (int) start)
+				colors.push_back(c);
+		}
+
+		if (srcsize > 0)
+		{
+			// Text without colors of its own is white.
+			if (src.colors.empty() || src.colors[0].index != 0)
+				colors.push_back({white, (int) start});
+
+			for (const love::font::IndexedColor &c : src.colors)
+				colors.push_back({c.color, c.index + (int) start});
+		}
+
+		if (end < dst.cps.size() && !hasaftercolor)
+			colors.push_back({aftercolor, (int) (start + srcsize)});
 
+		for (const love::font::IndexedColor &c : dst.colors)
+		{
+			if (c.index >= (int) end)
+				colors.push_back({c.color, c.index + delta});
+		}
+	}
+
+	dst.cps.erase(dst.cps.begin() + start, dst.cps.begin() + end);
+	dst.cps.insert(dst.cps.begin() + start, src.cps.begin(), src.cps.end());
+	dst.colors = std::move(colors);
+}
+
+float TextBatch::getLineStep(const TextData &t) const
+{
+	float step = font->getHeight() * font->getLineHeight();
+
+	// Unformatted text moves down by a rounded amount for each newline.
+	if (t.align == Font::ALIGN_MAX_ENUM)
+		step = floorf(step + 0.5f);
+
+	return step;
+}
+
+void TextBatch::layoutParagraph(const TextData &t, Paragraph &p)
+{
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
+	Range range(p.start, p.length);
+	float step = getLineStep(t);
+
+	love::font::TextShaper::TextInfo info = {};
+	p.vertices.clear();
 
 	// We only have formatted text if the align mode is valid.
 	if (t.align == Font::ALIGN_MAX_ENUM)
-		newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
+	{
+		Vector2 offset(0.0f, p.startLine * step);
+		p.commands = font->generateVertices(t.codepoints, range, constantcolor, p.vertices, 0.0f, offset, &info);
+		p.lineCount = step > 0.0f ? (int) floorf(info.height / step + 0.5f) : 0;
+	}
 	else
-		newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
+		p.commands = font->generateVerticesFormatted(t.codepoints, range, constantcolor, t.wrap, t.align, p.vertices, p.startLine, &info, &p.lineCount);
 
-	size_t voffset = vertOffset;
+	p.width = info.width;
+}
 
-	if (!t.appendVertices)
+void TextBatch::layoutParagraphs(TextData &t, size_t index, size_t start, size_t end)
+{
+	const std::vector<uint32> &cps = t.codepoints.cps;
+
+	int line = 0;
+	if (index > 0)
+		line = t.paragraphs[index - 1].startLine + t.paragraphs[index - 1].lineCount;
+
+	std::vector<Paragraph> newparagraphs;
+
+	for (size_t i = start; i < end;)
 	{
-		voffset = 0;
-		vertOffset = 0;
-		drawCommands.clear();
-		textData.clear();
+		size_t next = i;
+		while (next < end && cps[next] != '\n')
+			next++;
+
+		// The newline belongs to the paragraph it ends.
+		if (next < end)
+			next++;
+
+		Paragraph p;
+		p.start = i;
+		p.length = next - i;
+		p.startLine = line;
+		layoutParagraph(t, p);
+
+		line += p.lineCount;
+		newparagraphs.push_back(std::move(p));
+
+		i = next;
 	}
 
-	if (t.useMatrix && !vertices.empty())
-		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
+	t.paragraphs.insert(t.paragraphs.begin() + index, std::make_move_iterator(newparagraphs.begin()), std::make_move_iterator(newparagraphs.end()));
+}
+
+void TextBatch::updateTextInfo(TextData &t)
+{
+	int width = 0;
+	int lines = 0;
+	size_t vertexcount = 0;
+
+	for (const Paragraph &p : t.paragraphs)
+	{
+		width = std::max(width, p.width);
+		vertexcount += p.vertices.size();
+	}
+
+	if (!t.paragraphs.empty())
+		lines = t.paragraphs.back().startLine + t.paragraphs.back().lineCount;
+
+	t.textInfo.width = width;
+	t.textInfo.height = (int) (lines * getLineStep(t));
+	t.vertexCount = vertexcount;
+}
+
+void TextBatch::uploadTextData(const TextData &t, size_t firstparagraph)
+{
+	size_t offset = t.vertexStart;
+	for (size_t i = 0; i < firstparagraph && i < t.paragraphs.size(); i++)
+		offset += t.paragraphs[i].vertices.size();
 
-	uploadVertices(vertices, voffset);
+	std::vector<Font::GlyphVertex> vertices;
+	vertices.reserve(t.vertexStart + t.vertexCount - offset);
 
-	if (!newcommands.empty())
+	for (size_t i = firstparagraph; i < t.paragraphs.size(); i++)
 	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : newcommands)
-			cmd.startvertex += (int) voffset;
+		const auto &pverts = t.paragraphs[i].vertices;
+		vertices.insert(vertices.end(), pverts.begin(), pverts.end());
+	}
+
+	if (t.useMatrix && !vertices.empty())
+		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
 
-		auto firstcmd = newcommands.begin();
+	uploadVertices(vertices, offset);
+}
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
-		if (!drawCommands.empty())
+void TextBatch::appendDrawCommands(const TextData &t)
+{
+	size_t vertexstart = t.vertexStart;
+	boundsDirty = true;
+
+	for (const Paragraph &p : t.paragraphs)
+	{
+		for (Font::DrawCommand cmd : p.commands)
 		{
-			auto prevcmd = drawCommands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
+			// The start vertex should be adjusted to account for the vertex offset.
+			cmd.startvertex += (int) vertexstart;
+
+			// If the draw command has the same texture as the last one in the
+			// list we're building and its vertices are in-order, we can combine
+			// them (saving a draw call.)
+			if (!drawCommands.empty())
 			{
-				drawCommands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
+				Font::DrawCommand &prevcmd = drawCommands.back();
+				if (prevcmd.texture == cmd.texture && (prevcmd.startvertex + prevcmd.vertexcount) == cmd.startvertex)
+				{
+					prevcmd.vertexcount += cmd.vertexcount;
+					continue;
+				}
 			}
+
+			drawCommands.push_back(cmd);
 		}
 
-		// Append the new draw commands to the list we're building.
-		drawCommands.insert(drawCommands.end(), firstcmd, newcommands.end());
+		vertexstart += p.vertices.size();
 	}
+}
 
-	vertOffset = voffset + vertices.size();
+void TextBatch::rebuildDrawCommands()
+{
+	drawCommands.clear();
+	boundsDirty = true;
+
+	for (const TextData &t : textData)
+		appendDrawCommands(t);
+}
+
+void TextBatch::addTextData(const TextData &t)
+{
+	if (!t.appendVertices)
+	{
+		vertOffset = 0;
+		drawCommands.clear();
+		textData.clear();
+	}
 
 	textData.push_back(t);
-	textData.back().textInfo = textinfo;
+
+	TextData &data = textData.back();
+	data.vertexStart = vertOffset;
+	data.paragraphs.clear();
+
+	layoutParagraphs(data, 0, 0, data.codepoints.cps.size());
+	updateTextInfo(data);
+
+	uploadTextData(data, 0);
+	appendDrawCommands(data);
+
+	vertOffset = data.vertexStart + data.vertexCount;
 
 	// Font::generateVertices can invalidate the font's texture cache.
 	if (font->getTextureCacheID() != textureCacheID)
@@ -185,7 +363,7 @@ void TextBatch::set(const std::vector<love::font::ColoredString> &text, float wr
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, false, false, Matrix4()});
+	addTextData({codepoints, wrap, align, {}, false, false, Matrix4(), {}, 0, 0});
 }
 
 int TextBatch::add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m)
@@ -198,17 +376,136 @@ int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wr
 	love::font::ColoredCodepoints codepoints;
 	love::font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, true, true, m});
+	addTextData({codepoints, wrap, align, {}, true, true, m, {}, 0, 0});
 
 	return (int) textData.size() - 1;
 }
 
+void TextBatch::replace(int index, int start, int count, const std::vector<love::font::ColoredString> &text)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	TextData &t = textData[index];
+	std::vector<Paragraph> &paragraphs = t.paragraphs;
+	size_t oldsize = t.codepoints.cps.size();
+
+	if (start < 0 || count < 0 || (size_t) start + (size_t) count > oldsize)
+		throw love::Exception("Invalid character range for text index %d.", index + 1);
+
+	love::font::ColoredCodepoints codepoints;
+	love::font::getCodepointsFromString(text, codepoints);
+
+	size_t end = (size_t) start + (size_t) count;
+
+	// Find the paragraphs touched by the edit. Text added at the very end
+	// joins the last paragraph, unless it ends with a newline.
+	size_t first = 0;
+	while (first < paragraphs.size() && paragraphs[first].start + paragraphs[first].length <= (size_t) start)
+		first++;
+
+	if (first == paragraphs.size() && first > 0 && t.codepoints.cps[oldsize - 1] != '\n')
+		first--;
+
+	size_t last = first;
+	while (last < paragraphs.size() && (last == first || paragraphs[last].start < end))
+		last++;
+
+	size_t regionstart = first < paragraphs.size() ? paragraphs[first].start : oldsize;
+	size_t regionend = last > first ? paragraphs[last - 1].start + paragraphs[last - 1].length : regionstart;
+
+	spliceCodepoints(t.codepoints, (size_t) start, (size_t) count, codepoints);
+
+	const std::vector<uint32> &cps = t.codepoints.cps;
+	int delta = (int) cps.size() - (int) oldsize;
+	regionend = (size_t) ((int) regionend + delta);
+
+	// If the newline which ended the region was removed, the next paragraph
+	// becomes part of it.
+	while (regionend > regionstart && regionend < cps.size() && cps[regionend - 1] != '\n' && last < paragraphs.size())
+	{
+		regionend += paragraphs[last].length;
+		last++;
+	}
+
+	size_t oldvertexcount = t.vertexCount;
+
+	paragraphs.erase(paragraphs.begin() + first, paragraphs.begin() + last);
+	size_t remaining = paragraphs.size();
+
+	layoutParagraphs(t, first, regionstart, regionend);
+
+	// Paragraphs after the edit keep their layout, but may start on a
+	// different line. With a whole-pixel line height they can just be moved.
+	float step = getLineStep(t);
+	bool canshift = step == floorf(step);
+
+	for (size_t i = first + (paragraphs.size() - remaining); i < paragraphs.size(); i++)
+	{
+		Paragraph &p = paragraphs[i];
+		p.start = (size_t) ((int) p.start + delta);
+
+		int line = i > 0 ? paragraphs[i - 1].startLine + paragraphs[i - 1].lineCount : 0;
+		if (line == p.startLine)
+			continue;
+
+		if (canshift)
+		{
+			float dy = (line - p.startLine) * step;
+			for (Font::GlyphVertex &v : p.vertices)
+				v.y += dy;
+			p.startLine = line;
+		}
+		else
+		{
+			p.startLine = line;
+			layoutParagraph(t, p);
+		}
+	}
+
+	updateTextInfo(t);
+
+	// Vertices before the first edited paragraph are still valid.
+	uploadTextData(t, first);
+
+	// Everything after the edited text moves in the vertex buffer if its
+	// vertex count changed.
+	if (t.vertexCount != oldvertexcount)
+	{
+		size_t offset = t.vertexStart + t.vertexCount;
+
+		for (size_t i = (size_t) index + 1; i < textData.size(); i++)
+		{
+			textData[i].vertexStart = offset;
+			uploadTextData(textData[i], 0);
+			offset += textData[i].vertexCount;
+		}
+
+		vertOffset = offset;
+	}
+
+	rebuildDrawCommands();
+
+	// Font::generateVertices can invalidate the font's texture cache.
+	if (font->getTextureCacheID() != textureCacheID)
+		regenerateVertices();
+}
+
+void TextBatch::append(int index, const std::vector<love::font::ColoredString> &text)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	replace(index, (int) textData[index].codepoints.cps.size(), 0, text);
+}
+
 void TextBatch::clear()
 {
 	textData.clear();
 	drawCommands.clear();
 	textureCacheID = font->getTextureCacheID();
 	vertOffset = 0;
+	boundsDirty = true;
 }
 
 void TextBatch::setFont(Font *f)
@@ -248,6 +545,45 @@ int TextBatch::getHeight(int index) const
 	return textData[index].textInfo.height;
 }
 
+bool TextBatch::getBounds(float &x, float &y, float &w, float &h) const
+{
+	if (vertexData == nullptr || drawCommands.empty())
+		return false;
+
+	if (boundsDirty)
+	{
+		float minx = std::numeric_limits<float>::max();
+		float miny = std::numeric_limits<float>::max();
+		float maxx = -std::numeric_limits<float>::max();
+		float maxy = -std::numeric_limits<float>::max();
+
+		const Font::GlyphVertex *vertices = (const Font::GlyphVertex *) vertexData;
+
+		for (const Font::DrawCommand &cmd : drawCommands)
+		{
+			for (int i = cmd.startvertex; i < cmd.startvertex + cmd.vertexcount; i++)
+			{
+				minx = std::min(minx, vertices[i].x);
+				miny = std::min(miny, vertices[i].y);
+				maxx = std::max(maxx, vertices[i].x);
+				maxy = std::max(maxy, vertices[i].y);
+			}
+		}
+
+		bounds[0] = minx;
+		bounds[1] = miny;
+		bounds[2] = maxx - minx;
+		bounds[3] = maxy - miny;
+		boundsDirty = false;
+	}
+
+	x = bounds[0];
+	y = bounds[1];
+	w = bounds[2];
+	h = bounds[3];
+	return w >= 0.0f && h >= 0.0f;
+}
+
 void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 {
 	if (vertexBuffer == nullptr || vertexData == nullptr || drawCommands.empty())
@@ -256,7 +592,7 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 	gfx->flushBatchedDraws();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->getStandardShader());
 
 	Texture *firsttex = nullptr;
 	if (!drawCommands.empty())
@@ -265,6 +601,8 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (Shader::current)
 		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, firsttex);
 
+	font->flushAsyncGlyphs();
+
 	// Re-generate the text if the Font's texture cache was invalidated.
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
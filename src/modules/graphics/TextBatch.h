@@ -49,6 +49,18 @@ public:
 	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Replaces count codepoints of an existing text starting at the given
+	 * codepoint index. Only the lines touched by the edit are re-wrapped, and
+	 * only vertices from the first changed line onward are uploaded again.
+	 **/
+	void replace(int index, int start, int count, const std::vector<love::font::ColoredString> &text);
+
+	/**
+	 * Adds codepoints to the end of an existing text.
+	 **/
+	void append(int index, const std::vector<love::font::ColoredString> &text);
+
 	void clear();
 
 	void setFont(Font *f);
@@ -66,9 +78,27 @@ public:
 
 	// Implements Drawable.
 	void draw(love::graphics::Graphics *gfx, const Matrix4 &m) override;
+	bool getBounds(float &x, float &y, float &w, float &h) const override;
 
 private:
 
+	// The text between two newlines. Paragraphs are laid out independently of
+	// each other, apart from the line they start on.
+	struct Paragraph
+	{
+		// Codepoint range in the text, including the trailing newline.
+		size_t start;
+		size_t length;
+
+		int startLine;
+		int lineCount;
+		int width;
+
+		// Untransformed vertices, and draw commands relative to them.
+		std::vector<Font::GlyphVertex> vertices;
+		std::vector<Font::DrawCommand> commands;
+	};
+
 	struct TextData
 	{
 		love::font::ColoredCodepoints codepoints;
@@ -78,12 +108,24 @@ private:
 		bool useMatrix;
 		bool appendVertices;
 		Matrix4 matrix;
+
+		std::vector<Paragraph> paragraphs;
+		size_t vertexStart;
+		size_t vertexCount;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
 	void addTextData(const TextData &s);
 
+	float getLineStep(const TextData &t) const;
+	void layoutParagraph(const TextData &t, Paragraph &p);
+	void layoutParagraphs(TextData &t, size_t index, size_t start, size_t end);
+	void updateTextInfo(TextData &t);
+	void uploadTextData(const TextData &t, size_t firstparagraph);
+	void appendDrawCommands(const TextData &t);
+	void rebuildDrawCommands();
+
 	StrongRef<Font> font;
 
 	VertexAttributes vertexAttributes;
@@ -98,6 +140,10 @@ private:
 	std::vector<TextData> textData;
 
 	size_t vertOffset;
+
+	// Bounding rectangle of the vertices, recomputed when they change.
+	mutable float bounds[4];
+	mutable bool boundsDirty;
 	
 	// Used so we know when the font's texture cache is invalidated.
 	uint32 textureCacheID;
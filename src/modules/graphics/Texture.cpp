@@ -167,6 +167,7 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	, renderTarget(settings.renderTarget)
 	, computeWrite(settings.computeWrite)
 	, readable(true)
+	, memoryless(settings.memoryless)
 	, mipmapsMode(settings.mipmaps)
 	, sRGB(isGammaCorrect() && !settings.linear)
 	, width(settings.width)
@@ -178,6 +179,10 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	, pixelHeight(0)
 	, requestedMSAA(settings.msaa > 1 ? settings.msaa : 0)
 	, samplerState()
+	, sharedArrayLayer(-1)
+	, uploadPending(false)
+	, streaming(false)
+	, lastUsedFrame(0)
 	, graphicsMemorySize(0)
 {
 	if (slices != nullptr && slices->getMipmapCount() > 0 && slices->getSliceCount() > 0)
@@ -187,6 +192,9 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 		if (requestedMSAA > 1)
 			throw love::Exception("MSAA textures cannot be created from image data.");
 
+		if (memoryless)
+			throw love::Exception("Memoryless textures cannot be created from image data.");
+
 		int dataMipmaps = 1;
 		if (slices->validate() && slices->getMipmapCount() > 1)
 			dataMipmaps = slices->getMipmapCount();
@@ -223,7 +231,7 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	if (settings.readable.hasValue)
 		readable = settings.readable.value;
 	else
-		readable = !renderTarget || !isPixelFormatDepthStencil(format);
+		readable = !memoryless && (!renderTarget || !isPixelFormatDepthStencil(format));
 
 	format = gfx->getSizedFormat(format, renderTarget, readable);
 
@@ -234,7 +242,7 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 		mipmapCount = getTotalMipmapCount(pixelWidth, pixelHeight, depth);
 
 	const char *miperr = nullptr;
-	if (mipmapsMode == MIPMAPS_AUTO && !supportsGenerateMipmaps(miperr))
+	if (mipmapsMode == MIPMAPS_AUTO && !supportsGenerateMipmaps(miperr) && !gfx->isComputeMipmapsSupported(this, miperr))
 	{
 		const char *fstr = "unknown";
 		love::getConstant(format, fstr);
@@ -262,6 +270,9 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 	if (isCompressed() && renderTarget)
 		throw love::Exception("Compressed textures cannot be render targets.");
 
+	if (memoryless && (!renderTarget || readable || computeWrite))
+		throw love::Exception("Memoryless textures must be non-readable render targets.");
+
 	uint32 usage = PIXELFORMATUSAGEFLAGS_NONE;
 	if (renderTarget)
 		usage |= PIXELFORMATUSAGEFLAGS_RENDERTARGET;
@@ -312,6 +323,13 @@ Texture::~Texture()
 {
 	--textureCount;
 	setGraphicsMemorySize(0);
+
+	if (sharedArray.get() != nullptr)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->removeFromSharedArrayTexture(sharedArray, sharedArrayLayer);
+	}
 }
 
 void Texture::setGraphicsMemorySize(int64 bytes)
@@ -328,6 +346,16 @@ void Texture::draw(Graphics *gfx, const Matrix4 &m)
 	draw(gfx, quad, m);
 }
 
+bool Texture::getBounds(float &x, float &y, float &w, float &h) const
+{
+	Quad::Viewport v = quad->getViewport();
+	x = 0.0f;
+	y = 0.0f;
+	w = (float) v.w;
+	h = (float) v.h;
+	return true;
+}
+
 void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 {
 	if (!readable)
@@ -336,12 +364,25 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 	if (renderTarget && gfx->isRenderTargetActive(this))
 		throw love::Exception("Cannot render a Texture to itself.");
 
+	if (streaming)
+		markUsed(gfx->getTextureStreamingFrame());
+
 	if (texType == TEXTURE_2D_ARRAY)
 	{
 		drawLayer(gfx, q->getLayer(), q, localTransform);
 		return;
 	}
 
+	// Draw using the shared array texture's copy when possible, so consecutive
+	// draws of different textures in the same array can be batched together.
+	// Custom shaders expect a 2D texture, so they always use the original.
+	if (sharedArray.get() != nullptr && Shader::isDefaultActive()
+		&& sharedArray->getSamplerState().toKey() == samplerState.toKey())
+	{
+		sharedArray->drawLayer(gfx, sharedArrayLayer, q, localTransform);
+		return;
+	}
+
 	const Matrix4 &tm = gfx->getTransform();
 	bool is2D = tm.isAffine2DTransform();
 
@@ -393,6 +434,9 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 	if (layer < 0 || layer >= layers)
 		throw love::Exception("Invalid layer: %d (Texture has %d layers)", layer + 1, layers);
 
+	if (streaming)
+		markUsed(gfx->getTextureStreamingFrame());
+
 	Color32 c = toColor32(gfx->getColor());
 
 	const Matrix4 &tm = gfx->getTransform();
@@ -436,7 +480,23 @@ void Texture::uploadImageData(love::image::ImageDataBase *d, int level, int slic
 		lock.setLock(id->getMutex());
 
 	Rect rect = {x, y, d->getWidth(), d->getHeight()};
-	uploadByteData(d->getFormat(), d->getData(), d->getSize(), level, slice, rect);
+	uploadByteData(d->getFormat(), d->getData(), d->getSize(), level, slice, rect, rect.w);
+}
+
+void Texture::uploadImageData(love::image::ImageData *d, const Rect &sourcerect, int level, int slice, int x, int y)
+{
+	love::thread::Lock lock(d->getMutex());
+
+	size_t pixelsize = getPixelFormatBlockSize(d->getFormat());
+	size_t rowsize = pixelsize * d->getWidth();
+
+	// The data starts at the first pixel of the sub-rectangle, and ends at its
+	// last pixel rather than at the end of the ImageData's last row.
+	const uint8 *data = (const uint8 *) d->getData() + sourcerect.y * rowsize + sourcerect.x * pixelsize;
+	size_t size = (sourcerect.h - 1) * rowsize + sourcerect.w * pixelsize;
+
+	Rect rect = {x, y, sourcerect.w, sourcerect.h};
+	uploadByteData(d->getFormat(), data, size, level, slice, rect, d->getWidth());
 }
 
 void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
@@ -455,7 +515,60 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 	if (getHandle() == 0)
 		return;
 
-	if (d->getFormat() != getPixelFormat())
+	Rect rect = {x, y, d->getWidth(), d->getHeight()};
+	validateReplacePixels(d->getFormat(), slice, mipmap, rect);
+
+	Graphics::flushBatchedDrawsGlobal();
+
+	uploadImageData(d, mipmap, slice, x, y);
+
+	if (sharedArray.get() != nullptr)
+		sharedArray->replacePixels(d, sharedArrayLayer, mipmap, x, y, false);
+
+	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
+		generateMipmaps();
+}
+
+void Texture::replacePixels(love::image::ImageData *d, const Rect &sourcerect, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	if (!isReadable())
+		throw love::Exception("replacePixels can only be called on readable Textures.");
+
+	if (getMSAA() > 1)
+		throw love::Exception("replacePixels cannot be called on a MSAA Texture.");
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && gfx->isRenderTargetActive(this))
+		throw love::Exception("replacePixels cannot be called on this Texture while it's an active render target.");
+
+	// No effect if the texture hasn't been created yet.
+	if (getHandle() == 0)
+		return;
+
+	const Rect &sr = sourcerect;
+	if (sr.x < 0 || sr.y < 0 || sr.w <= 0 || sr.h <= 0
+		|| (sr.x + sr.w) > d->getWidth() || (sr.y + sr.h) > d->getHeight())
+	{
+		throw love::Exception("Invalid source rectangle dimensions (x=%d, y=%d, w=%d, h=%d) for %dx%d ImageData.", sr.x, sr.y, sr.w, sr.h, d->getWidth(), d->getHeight());
+	}
+
+	Rect rect = {x, y, sr.w, sr.h};
+	validateReplacePixels(d->getFormat(), slice, mipmap, rect);
+
+	Graphics::flushBatchedDrawsGlobal();
+
+	uploadImageData(d, sourcerect, mipmap, slice, x, y);
+
+	if (sharedArray.get() != nullptr)
+		sharedArray->replacePixels(d, sourcerect, sharedArrayLayer, mipmap, x, y, false);
+
+	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
+		generateMipmaps();
+}
+
+void Texture::validateReplacePixels(PixelFormat pixelformat, int slice, int mipmap, const Rect &rect) const
+{
+	if (pixelformat != getPixelFormat())
 		throw love::Exception("Pixel formats must match.");
 
 	if (mipmap < 0 || mipmap >= getMipmapCount())
@@ -468,8 +581,6 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 		throw love::Exception("Invalid texture slice index %d.", slice + 1);
 	}
 
-	Rect rect = {x, y, d->getWidth(), d->getHeight()};
-
 	int mipw = getPixelWidth(mipmap);
 	int miph = getPixelHeight(mipmap);
 
@@ -479,25 +590,18 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 		throw love::Exception("Invalid rectangle dimensions (x=%d, y=%d, w=%d, h=%d) for %dx%d Texture.", rect.x, rect.y, rect.w, rect.h, mipw, miph);
 	}
 
-	if (isPixelFormatCompressed(d->getFormat()) && (rect.x != 0 || rect.y != 0 || rect.w != mipw || rect.h != miph))
+	if (isPixelFormatCompressed(pixelformat) && (rect.x != 0 || rect.y != 0 || rect.w != mipw || rect.h != miph))
 	{
-		const PixelFormatInfo &info = getPixelFormatInfo(d->getFormat());
+		const PixelFormatInfo &info = getPixelFormatInfo(pixelformat);
 		int bw = (int) info.blockWidth;
 		int bh = (int) info.blockHeight;
 		if (rect.x % bw != 0 || rect.y % bh != 0 || rect.w % bw != 0 || rect.h % bh != 0)
 		{
 			const char *name = nullptr;
-			love::getConstant(d->getFormat(), name);
+			love::getConstant(pixelformat, name);
 			throw love::Exception("Compressed texture format %s only supports replacing a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
 		}
 	}
-
-	Graphics::flushBatchedDrawsGlobal();
-
-	uploadImageData(d, mipmap, slice, x, y);
-
-	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
-		generateMipmaps();
 }
 
 void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
@@ -511,7 +615,10 @@ void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap
 
 	Graphics::flushBatchedDrawsGlobal();
 
-	uploadByteData(format, data, size, mipmap, slice, rect);
+	uploadByteData(format, data, size, mipmap, slice, rect, rect.w);
+
+	if (sharedArray.get() != nullptr)
+		sharedArray->replacePixels(data, size, sharedArrayLayer, mipmap, rect, false);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
 		generateMipmaps();
@@ -555,13 +662,36 @@ bool Texture::supportsGenerateMipmaps(const char *&outReason) const
 	return true;
 }
 
-void Texture::generateMipmaps()
+void Texture::generateMipmaps(bool compute)
 {
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
 	const char *err = nullptr;
-	if (!supportsGenerateMipmaps(err))
-		throw love::Exception("%s", err);
+	if (!compute && !supportsGenerateMipmaps(err))
+	{
+		const char *computeerr = nullptr;
+		if (gfx == nullptr || !gfx->isComputeMipmapsSupported(this, computeerr))
+			throw love::Exception("%s", err);
+		compute = true;
+	}
+
+	if (compute)
+	{
+		if (gfx == nullptr)
+			throw love::Exception("Generating mipmaps with a compute shader requires the graphics module.");
+
+		// Copies into the levels also update the shared array, if there is
+		// one.
+		gfx->generateMipmapsCompute(this);
+		return;
+	}
 
 	generateMipmapsInternal();
+
+	// This regenerates the mipmaps of every layer in the shared array, which
+	// is wasteful but keeps them all in sync with their originals.
+	if (sharedArray.get() != nullptr)
+		sharedArray->generateMipmaps();
 }
 
 TextureType Texture::getTextureType() const
@@ -696,6 +826,12 @@ Quad *Texture::getQuad() const
 	return quad;
 }
 
+void Texture::setSharedArrayLayer(Texture *array, int layer)
+{
+	sharedArray.set(array);
+	sharedArrayLayer = array != nullptr ? layer : -1;
+}
+
 int Texture::getTotalMipmapCount(int w, int h)
 {
 	return (int) log2(std::max(w, h)) + 1;
@@ -955,6 +1091,10 @@ static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM>::Entry setting
 	{ "canvas",       Texture::SETTING_RENDER_TARGET },
 	{ "computewrite", Texture::SETTING_COMPUTE_WRITE },
 	{ "readable",     Texture::SETTING_READABLE      },
+	{ "arraybatching", Texture::SETTING_ARRAY_BATCHING },
+	{ "async",        Texture::SETTING_ASYNC         },
+	{ "streaming",    Texture::SETTING_STREAMING     },
+	{ "memoryless",   Texture::SETTING_MEMORYLESS    },
 };
 
 static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM> settingTypes(settingTypeEntries, sizeof(settingTypeEntries));
@@ -174,6 +174,10 @@ public:
 		SETTING_RENDER_TARGET,
 		SETTING_COMPUTE_WRITE,
 		SETTING_READABLE,
+		SETTING_ARRAY_BATCHING,
+		SETTING_ASYNC,
+		SETTING_STREAMING,
+		SETTING_MEMORYLESS,
 		SETTING_MAX_ENUM
 	};
 
@@ -192,6 +196,10 @@ public:
 		bool renderTarget = false;
 		bool computeWrite = false;
 		OptionalBool readable;
+		bool arrayBatching = false;
+		bool async = false;
+		bool streaming = false;
+		bool memoryless = false;
 	};
 
 	struct Slices
@@ -231,6 +239,7 @@ public:
 
 	// Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
+	bool getBounds(float &x, float &y, float &w, float &h) const override;
 
 	/**
 	 * Draws the texture using the specified transformation with a Quad applied.
@@ -243,7 +252,18 @@ public:
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
-	void generateMipmaps();
+	/**
+	 * Replaces pixels with a sub-rectangle of the ImageData, which is uploaded
+	 * straight from the ImageData's memory without an intermediate copy.
+	 **/
+	void replacePixels(love::image::ImageData *d, const Rect &sourcerect, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Uses a compute shader instead of the backend's mipmap generation when
+	 * compute is true, or when the backend can't generate mipmaps for this
+	 * texture's format.
+	 **/
+	void generateMipmaps(bool compute = false);
 
 	virtual void copyFromBuffer(Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect) = 0;
 	virtual void copyToBuffer(Buffer *dest, int slice, int mipmap, const Rect &rect, size_t destoffset, int destwidth, size_t size) = 0;
@@ -259,6 +279,13 @@ public:
 	bool isComputeWritable() const;
 	bool isReadable() const;
 
+	/**
+	 * Memoryless render targets only keep their contents for the duration of
+	 * a single render pass. Tile-based GPUs can keep them entirely in on-chip
+	 * memory instead of allocating and writing back to system memory.
+	 **/
+	bool isMemoryless() const { return memoryless; }
+
 	bool isCompressed() const;
 	bool isFormatLinear() const;
 
@@ -286,6 +313,26 @@ public:
 
 	Quad *getQuad() const;
 
+	// Internal use only, for textures which have a copy in a layer of an array
+	// texture shared with other textures, so their draws can be batched.
+	void setSharedArrayLayer(Texture *array, int layer);
+	Texture *getSharedArrayTexture() const { return sharedArray.get(); }
+	int getSharedArrayLayer() const { return sharedArrayLayer; }
+
+	/**
+	 * Whether all of the texture's initial data has been uploaded, for textures
+	 * created with asynchronous uploads.
+	 **/
+	bool isReady() const { return !uploadPending; }
+	void setUploadPending(bool pending) { uploadPending = pending; }
+
+	// Internal use only, for textures whose higher mipmap levels are streamed
+	// in by Graphics once they're drawn.
+	void setStreaming(bool enable) { streaming = enable; }
+	bool isStreaming() const { return streaming; }
+	void markUsed(uint64 frame) { lastUsedFrame = frame; }
+	uint64 getLastUsedFrame() const { return lastUsedFrame; }
+
 	static int getTotalMipmapCount(int w, int h);
 	static int getTotalMipmapCount(int w, int h, int d);
 
@@ -307,9 +354,17 @@ protected:
 	void setGraphicsMemorySize(int64 size);
 
 	void uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y);
-	virtual void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) = 0;
+	void uploadImageData(love::image::ImageData *d, const Rect &sourcerect, int level, int slice, int x, int y);
+
+	/**
+	 * Uploads pixels to the given rectangle. Rows in the data are rowlength
+	 * pixels apart, which is only allowed to differ from the rectangle's
+	 * width for uncompressed formats.
+	 **/
+	virtual void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength) = 0;
 
 	bool supportsGenerateMipmaps(const char *&outReason) const;
+	void validateReplacePixels(PixelFormat pixelformat, int slice, int mipmap, const Rect &rect) const;
 	virtual void generateMipmapsInternal() = 0;
 
 	bool validateDimensions(bool throwException) const;
@@ -320,6 +375,7 @@ protected:
 	bool renderTarget;
 	bool computeWrite;
 	bool readable;
+	bool memoryless;
 
 	MipmapsMode mipmapsMode;
 
@@ -341,6 +397,14 @@ protected:
 
 	StrongRef<Quad> quad;
 
+	StrongRef<Texture> sharedArray;
+	int sharedArrayLayer;
+
+	bool uploadPending;
+
+	bool streaming;
+	uint64 lastUsedFrame;
+
 	int64 graphicsMemorySize;
 
 }; // Texture
@@ -0,0 +1,429 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TileMap.h"
+
+// LOVE
+#include "Graphics.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TileMap::type("TileMap", &Drawable::type);
+
+TileMap::TileMap(Graphics * /*gfx*/, Texture *texture, int tileWidth, int tileHeight, int width, int height, const Settings &settings)
+	: texture(texture)
+	, tileWidth(tileWidth)
+	, tileHeight(tileHeight)
+	, width(width)
+	, height(height)
+	, chunkSize(settings.chunkSize)
+	, chunksX(0)
+	, chunksY(0)
+	, margin(settings.margin)
+	, spacing(settings.spacing)
+	, tilesetColumns(0)
+	, tilesetCount(0)
+	, lastDrawnChunks(0)
+	, lastRebuiltChunks(0)
+{
+	if (texture == nullptr)
+		throw love::Exception("A texture must be used when creating a TileMap.");
+
+	if (tileWidth <= 0 || tileHeight <= 0)
+		throw love::Exception("Invalid TileMap tile dimensions.");
+
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid TileMap dimensions.");
+
+	if (chunkSize <= 0 || chunkSize > 256)
+		throw love::Exception("TileMap chunk size must be between 1 and 256.");
+
+	if (margin < 0 || spacing < 0)
+		throw love::Exception("TileMap tileset margin and spacing must not be negative.");
+
+	updateTileset();
+
+	chunksX = (width + chunkSize - 1) / chunkSize;
+	chunksY = (height + chunkSize - 1) / chunkSize;
+
+	tiles.resize((size_t) width * (size_t) height, 0);
+	chunks.resize((size_t) chunksX * (size_t) chunksY);
+}
+
+TileMap::~TileMap()
+{
+}
+
+void TileMap::updateTileset()
+{
+	if (texture->getTextureType() != TEXTURE_2D)
+		throw love::Exception("TileMaps can only use 2D textures.");
+
+	int tw = texture->getWidth();
+	int th = texture->getHeight();
+
+	int columns = (tw - 2 * margin + spacing) / (tileWidth + spacing);
+	int rows = (th - 2 * margin + spacing) / (tileHeight + spacing);
+
+	if (columns <= 0 || rows <= 0)
+		throw love::Exception("The TileMap's tile size is larger than its tileset texture.");
+
+	tilesetColumns = columns;
+	tilesetCount = std::min(columns * rows, (int) LOVE_UINT16_MAX);
+}
+
+void TileMap::validateRect(int x, int y, int w, int h) const
+{
+	if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > width || y + h > height)
+		throw love::Exception("Invalid tile rectangle (x=%d, y=%d, w=%d, h=%d) for a %dx%d TileMap.", x, y, w, h, width, height);
+}
+
+void TileMap::markDirty(int x, int y, int w, int h)
+{
+	if (w <= 0 || h <= 0)
+		return;
+
+	int cx0 = x / chunkSize;
+	int cy0 = y / chunkSize;
+	int cx1 = (x + w - 1) / chunkSize;
+	int cy1 = (y + h - 1) / chunkSize;
+
+	for (int cy = cy0; cy <= cy1; cy++)
+	{
+		for (int cx = cx0; cx <= cx1; cx++)
+			chunks[cy * chunksX + cx].dirty = true;
+	}
+}
+
+void TileMap::setTile(int x, int y, uint16 tile)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		throw love::Exception("Invalid tile position (%d, %d) for a %dx%d TileMap.", x, y, width, height);
+
+	uint16 &dst = tiles[(size_t) y * width + x];
+	if (dst == tile)
+		return;
+
+	dst = tile;
+	chunks[(y / chunkSize) * chunksX + (x / chunkSize)].dirty = true;
+}
+
+uint16 TileMap::getTile(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		throw love::Exception("Invalid tile position (%d, %d) for a %dx%d TileMap.", x, y, width, height);
+
+	return tiles[(size_t) y * width + x];
+}
+
+void TileMap::setTiles(int x, int y, int w, int h, const uint16 *src)
+{
+	validateRect(x, y, w, h);
+
+	for (int row = 0; row < h; row++)
+		memcpy(&tiles[(size_t) (y + row) * width + x], src + (size_t) row * w, sizeof(uint16) * w);
+
+	markDirty(x, y, w, h);
+}
+
+void TileMap::fill(uint16 tile)
+{
+	std::fill(tiles.begin(), tiles.end(), tile);
+	markDirty(0, 0, width, height);
+}
+
+void TileMap::setTexture(Texture *newtexture)
+{
+	if (newtexture == texture.get())
+		return;
+
+	StrongRef<Texture> oldtexture = texture;
+	texture.set(newtexture);
+
+	try
+	{
+		updateTileset();
+	}
+	catch (love::Exception &)
+	{
+		texture = oldtexture;
+		throw;
+	}
+
+	// Texture coordinates depend on the tileset's size.
+	markDirty(0, 0, width, height);
+}
+
+Texture *TileMap::getTexture() const
+{
+	return texture.get();
+}
+
+int TileMap::getTilesetCount() const
+{
+	return tilesetCount;
+}
+
+void TileMap::getLastDrawStats(int &drawnChunks, int &rebuiltChunks) const
+{
+	drawnChunks = lastDrawnChunks;
+	rebuiltChunks = lastRebuiltChunks;
+}
+
+void TileMap::buildChunk(Graphics *gfx, int cx, int cy)
+{
+	Chunk &chunk = chunks[cy * chunksX + cx];
+
+	float tw = (float) texture->getWidth();
+	float th = (float) texture->getHeight();
+
+	int x0 = cx * chunkSize;
+	int y0 = cy * chunkSize;
+	int x1 = std::min(x0 + chunkSize, width);
+	int y1 = std::min(y0 + chunkSize, height);
+
+	vertexScratch.clear();
+
+	for (int y = y0; y < y1; y++)
+	{
+		const uint16 *row = &tiles[(size_t) y * width];
+
+		for (int x = x0; x < x1; x++)
+		{
+			int tile = row[x];
+			if (tile == 0 || tile > tilesetCount)
+				continue;
+
+			int column = (tile - 1) % tilesetColumns;
+			int tilerow = (tile - 1) / tilesetColumns;
+
+			float sx = (float) (margin + column * (tileWidth + spacing));
+			float sy = (float) (margin + tilerow * (tileHeight + spacing));
+
+			float s0 = sx / tw;
+			float t0 = sy / th;
+			float s1 = (sx + tileWidth) / tw;
+			float t1 = (sy + tileHeight) / th;
+
+			float px0 = (float) (x * tileWidth);
+			float py0 = (float) (y * tileHeight);
+			float px1 = px0 + tileWidth;
+			float py1 = py0 + tileHeight;
+
+			// Ordered like a Quad's vertices.
+			vertexScratch.push_back({px0, py0, s0, t0});
+			vertexScratch.push_back({px0, py1, s0, t1});
+			vertexScratch.push_back({px1, py0, s1, t0});
+			vertexScratch.push_back({px1, py1, s1, t1});
+		}
+	}
+
+	chunk.tileCount = (int) (vertexScratch.size() / 4);
+	chunk.dirty = false;
+
+	if (chunk.tileCount == 0)
+		return;
+
+	size_t datasize = vertexScratch.size() * sizeof(XYf_STf);
+
+	if (chunk.buffer.get() == nullptr || chunk.buffer->getSize() < datasize)
+	{
+		// A chunk which has to grow after an edit is likely to be edited
+		// again, so it gets room for every tile.
+		size_t buffersize = datasize;
+		if (chunk.buffer.get() != nullptr)
+			buffersize = (size_t) chunkSize * chunkSize * 4 * sizeof(XYf_STf);
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf_STf);
+
+		const void *initialdata = buffersize == datasize ? vertexScratch.data() : nullptr;
+		chunk.buffer.set(gfx->newBuffer(settings, decl, initialdata, buffersize, 0), Acquire::NORETAIN);
+
+		if (initialdata != nullptr)
+			return;
+	}
+
+	chunk.buffer->fill(0, datasize, vertexScratch.data());
+}
+
+bool TileMap::getVisibleChunks(const Matrix4 &mvp, int &x0, int &y0, int &x1, int &y1) const
+{
+	x0 = 0;
+	y0 = 0;
+	x1 = chunksX - 1;
+	y1 = chunksY - 1;
+
+	const float *e = mvp.getElements();
+
+	// With a perspective projection every chunk gets tested individually.
+	if (e[3] != 0.0f || e[7] != 0.0f || e[15] <= 0.0f)
+		return true;
+
+	float det = e[0] * e[5] - e[4] * e[1];
+	if (std::abs(det) < 1e-12f)
+		return false;
+
+	// Map the corners of clip space back to the map's local coordinates.
+	float w = e[15];
+	const float corners[4][2] = {{-w, -w}, {w, -w}, {-w, w}, {w, w}};
+
+	float minx = std::numeric_limits<float>::max();
+	float miny = std::numeric_limits<float>::max();
+	float maxx = -std::numeric_limits<float>::max();
+	float maxy = -std::numeric_limits<float>::max();
+
+	for (const auto &c : corners)
+	{
+		float dx = c[0] - e[12];
+		float dy = c[1] - e[13];
+		float lx = ( e[5] * dx - e[4] * dy) / det;
+		float ly = (-e[1] * dx + e[0] * dy) / det;
+
+		minx = std::min(minx, lx);
+		miny = std::min(miny, ly);
+		maxx = std::max(maxx, lx);
+		maxy = std::max(maxy, ly);
+	}
+
+	float chunkw = (float) chunkSize * tileWidth;
+	float chunkh = (float) chunkSize * tileHeight;
+
+	if (maxx < 0.0f || maxy < 0.0f || minx >= chunkw * chunksX || miny >= chunkh * chunksY)
+		return false;
+
+	x0 = std::max(0, (int) std::floor(minx / chunkw));
+	y0 = std::max(0, (int) std::floor(miny / chunkh));
+	x1 = std::min(chunksX - 1, (int) std::floor(maxx / chunkw));
+	y1 = std::min(chunksY - 1, (int) std::floor(maxy / chunkh));
+
+	return true;
+}
+
+bool TileMap::isChunkVisible(const Matrix4 &mvp, int cx, int cy) const
+{
+	const float *e = mvp.getElements();
+
+	float x0 = (float) (cx * chunkSize * tileWidth);
+	float y0 = (float) (cy * chunkSize * tileHeight);
+	float x1 = (float) (std::min((cx + 1) * chunkSize, width) * tileWidth);
+	float y1 = (float) (std::min((cy + 1) * chunkSize, height) * tileHeight);
+
+	const float corners[4][2] = {{x0, y0}, {x1, y0}, {x0, y1}, {x1, y1}};
+
+	// The chunk is hidden if all of its corners are outside the same edge of
+	// clip space.
+	int left = 0, right = 0, top = 0, bottom = 0, behind = 0;
+
+	for (const auto &c : corners)
+	{
+		float x = e[0] * c[0] + e[4] * c[1] + e[12];
+		float y = e[1] * c[0] + e[5] * c[1] + e[13];
+		float w = e[3] * c[0] + e[7] * c[1] + e[15];
+
+		left += x < -w;
+		right += x > w;
+		top += y < -w;
+		bottom += y > w;
+		behind += w <= 0.0f;
+	}
+
+	return left < 4 && right < 4 && top < 4 && bottom < 4 && behind < 4;
+}
+
+bool TileMap::getBounds(float &x, float &y, float &w, float &h) const
+{
+	x = 0.0f;
+	y = 0.0f;
+	w = (float) (width * tileWidth);
+	h = (float) (height * tileHeight);
+	return true;
+}
+
+void TileMap::draw(Graphics *gfx, const Matrix4 &m)
+{
+	lastDrawnChunks = 0;
+	lastRebuiltChunks = 0;
+
+	Matrix4 mvp = gfx->getDeviceProjection() * gfx->getTransform() * m;
+
+	int x0, y0, x1, y1;
+	if (!getVisibleChunks(mvp, x0, y0, x1, y1))
+		return;
+
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+	if (texture->isStreaming())
+		texture->markUsed(gfx->getTextureStreamingFrame());
+
+	VertexAttributes attributes;
+	attributes.setCommonFormat(CommonFormat::XYf_STf, 0);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (int cy = y0; cy <= y1; cy++)
+	{
+		for (int cx = x0; cx <= x1; cx++)
+		{
+			Chunk &chunk = chunks[cy * chunksX + cx];
+
+			if (!chunk.dirty && chunk.tileCount == 0)
+				continue;
+
+			if (!isChunkVisible(mvp, cx, cy))
+				continue;
+
+			if (chunk.dirty)
+			{
+				buildChunk(gfx, cx, cy);
+				lastRebuiltChunks++;
+
+				if (chunk.tileCount == 0)
+					continue;
+			}
+
+			BufferBindings buffers;
+			buffers.set(0, chunk.buffer, 0);
+
+			gfx->drawQuads(0, chunk.tileCount, attributes, buffers, texture);
+			lastDrawnChunks++;
+		}
+	}
+}
+
+} // graphics
+} // love
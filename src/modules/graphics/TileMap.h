@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <vector>
+
+// LOVE
+#include "common/int.h"
+#include "common/Matrix.h"
+#include "Drawable.h"
+#include "Buffer.h"
+#include "vertex.h"
+
+namespace love
+{
+namespace graphics
+{
+
+// Forward declarations.
+class Graphics;
+class Texture;
+
+/**
+ * A grid of tiles drawn from a tileset texture. The grid is split into square
+ * chunks whose vertices are built the first time they are visible, rebuilt
+ * only after tiles in them change, and skipped entirely when they're outside
+ * the viewport.
+ **/
+class TileMap : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	struct Settings
+	{
+		// Width and height of a chunk, in tiles.
+		int chunkSize = 32;
+
+		// Pixels around the edge of the tileset, and between its tiles.
+		int margin = 0;
+		int spacing = 0;
+	};
+
+	/**
+	 * @param tileWidth, tileHeight The size of a tile in the tileset texture,
+	 *        and of a tile drawn by the map.
+	 * @param width, height The size of the map in tiles.
+	 **/
+	TileMap(Graphics *gfx, Texture *texture, int tileWidth, int tileHeight, int width, int height, const Settings &settings);
+	virtual ~TileMap();
+
+	/**
+	 * Tile ids index the tileset's tiles from left to right and top to
+	 * bottom, starting at 1. Tile 0 is empty.
+	 **/
+	void setTile(int x, int y, uint16 tile);
+	uint16 getTile(int x, int y) const;
+
+	/**
+	 * Sets a w by h rectangle of tiles from row-major ids.
+	 **/
+	void setTiles(int x, int y, int w, int h, const uint16 *tiles);
+
+	void fill(uint16 tile);
+
+	void setTexture(Texture *texture);
+	Texture *getTexture() const;
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	int getTileWidth() const { return tileWidth; }
+	int getTileHeight() const { return tileHeight; }
+	int getChunkSize() const { return chunkSize; }
+
+	/**
+	 * Gets the number of tiles in the tileset texture.
+	 **/
+	int getTilesetCount() const;
+
+	/**
+	 * Gets the number of chunks drawn and rebuilt by the last draw.
+	 **/
+	void getLastDrawStats(int &drawnChunks, int &rebuiltChunks) const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+	bool getBounds(float &x, float &y, float &w, float &h) const override;
+
+private:
+
+	struct Chunk
+	{
+		StrongRef<Buffer> buffer;
+
+		// Number of non-empty tiles, which is the number of quads in the
+		// buffer once it's built.
+		int tileCount = 0;
+
+		bool dirty = true;
+	};
+
+	void validateRect(int x, int y, int w, int h) const;
+	void markDirty(int x, int y, int w, int h);
+	void updateTileset();
+	void buildChunk(Graphics *gfx, int cx, int cy);
+
+	// Gets the range of chunks which may be visible with the given
+	// model-view-projection matrix. Returns false if nothing is visible.
+	bool getVisibleChunks(const Matrix4 &mvp, int &x0, int &y0, int &x1, int &y1) const;
+	bool isChunkVisible(const Matrix4 &mvp, int cx, int cy) const;
+
+	StrongRef<Texture> texture;
+
+	int tileWidth;
+	int tileHeight;
+	int width;
+	int height;
+
+	int chunkSize;
+	int chunksX;
+	int chunksY;
+
+	int margin;
+	int spacing;
+
+	// Tileset columns and total tiles, derived from the texture.
+	int tilesetColumns;
+	int tilesetCount;
+
+	std::vector<uint16> tiles;
+	std::vector<Chunk> chunks;
+
+	std::vector<XYf_STf> vertexScratch;
+
+	int lastDrawnChunks;
+	int lastRebuiltChunks;
+
+}; // TileMap
+
+} // graphics
+} // love
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TimerQuery.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TimerQuery::type("TimerQuery", &Object::type);
+
+TimerQuery::TimerQuery(Graphics *gfx)
+	: gfx(gfx)
+	, running(false)
+	, pending(false)
+	, complete(false)
+	, time(0.0)
+{
+	if (!gfx->getCapabilities().features[Graphics::FEATURE_TIMER_QUERY])
+		throw love::Exception("Timer queries are not supported on this system.");
+}
+
+TimerQuery::~TimerQuery()
+{
+}
+
+void TimerQuery::start()
+{
+	if (running)
+		throw love::Exception("TimerQuery:start cannot be called while the query is already running.");
+
+	// Batched draws submitted before this point shouldn't be part of the time.
+	gfx->flushBatchedDraws();
+
+	timestamp(TIMESTAMP_START);
+
+	running = true;
+	pending = false;
+	complete = false;
+}
+
+void TimerQuery::stop()
+{
+	if (!running)
+		throw love::Exception("TimerQuery:stop must be called after TimerQuery:start.");
+
+	gfx->flushBatchedDraws();
+
+	timestamp(TIMESTAMP_STOP);
+
+	running = false;
+	pending = true;
+}
+
+void TimerQuery::update()
+{
+	if (!pending)
+		return;
+
+	uint64 startns = 0;
+	uint64 stopns = 0;
+
+	if (!getTimestamps(startns, stopns))
+		return;
+
+	time = stopns > startns ? (double)(stopns - startns) / 1000000000.0 : 0.0;
+	pending = false;
+	complete = true;
+}
+
+} // graphics
+} // love
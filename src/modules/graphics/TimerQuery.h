@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Measures the time the GPU spends between two points in the command stream,
+ * using GPU timestamps. Results are retrieved asynchronously and never stall
+ * the CPU: they typically become available a frame or two after stop().
+ **/
+class TimerQuery : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	TimerQuery(Graphics *gfx);
+	virtual ~TimerQuery();
+
+	void start();
+	void stop();
+
+	/**
+	 * Checks whether the GPU has written both timestamps of the most recent
+	 * start/stop pair, without waiting for it.
+	 **/
+	void update();
+
+	bool isRunning() const { return running; }
+	bool isComplete() const { return complete; }
+
+	/**
+	 * Gets the GPU time in seconds between the most recent completed
+	 * start/stop pair.
+	 **/
+	double getTime() const { return time; }
+
+protected:
+
+	enum Timestamp
+	{
+		TIMESTAMP_START,
+		TIMESTAMP_STOP,
+	};
+
+	// Records a timestamp into the command stream.
+	virtual void timestamp(Timestamp t) = 0;
+
+	// Returns false if the timestamps aren't available yet. Must not block.
+	virtual bool getTimestamps(uint64 &startns, uint64 &stopns) = 0;
+
+	Graphics *gfx;
+
+private:
+
+	bool running;
+	bool pending;
+	bool complete;
+	double time;
+
+}; // TimerQuery
+
+} // graphics
+} // love
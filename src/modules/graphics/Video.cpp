@@ -36,6 +36,7 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 	, width(stream->getWidth() / dpiscale)
 	, height(stream->getHeight() / dpiscale)
 	, samplerState()
+	, stagingIndex(0)
 {
 	const SamplerState &defaultSampler = gfx->getDefaultSamplerState();
 	samplerState.minFilter = defaultSampler.minFilter;
@@ -77,8 +78,6 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 	int widths[3]  = {frame->yw, frame->cw, frame->cw};
 	int heights[3] = {frame->yh, frame->ch, frame->ch};
 
-	const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
-
 	Texture::Settings settings;
 
 	for (int i = 0; i < 3; i++)
@@ -90,14 +89,10 @@ Video::Video(Graphics *gfx, love::video::VideoStream *stream, float dpiscale)
 
 		tex->setSamplerState(samplerState);
 
-		size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
-		size_t size = bpp * widths[i] * heights[i];
-
-		Rect rect = {0, 0, widths[i], heights[i]};
-		tex->replacePixels(data[i], size, 0, 0, rect, false);
-
 		textures[i].set(tex, Acquire::NORETAIN);
 	}
+
+	uploadFrame(gfx, frame);
 }
 
 Video::~Video()
@@ -113,7 +108,7 @@ love::video::VideoStream *Video::getStream()
 
 void Video::draw(Graphics *gfx, const Matrix4 &m)
 {
-	update();
+	update(gfx);
 
 	const Matrix4 &tm = gfx->getTransform();
 	bool is2D = tm.isAffine2DTransform();
@@ -151,7 +146,7 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 	gfx->flushBatchedDraws();
 }
 
-void Video::update()
+void Video::update(Graphics *gfx)
 {
 	bool bufferschanged = stream->swapBuffers();
 	stream->fillBackBuffer();
@@ -159,15 +154,54 @@ void Video::update()
 	if (bufferschanged)
 	{
 		auto frame = (const love::video::VideoStream::Frame*) stream->getFrontBuffer();
+		uploadFrame(gfx, frame);
+	}
+}
 
-		int widths[3]  = {frame->yw, frame->cw, frame->cw};
-		int heights[3] = {frame->yh, frame->ch, frame->ch};
+void Video::uploadFrame(Graphics *gfx, const love::video::VideoStream::Frame *frame)
+{
+	int widths[3]  = {frame->yw, frame->cw, frame->cw};
+	int heights[3] = {frame->yh, frame->ch, frame->ch};
+
+	const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
 
-		const unsigned char *data[3] = {frame->yplane, frame->cbplane, frame->crplane};
+	size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
 
+	if (gfx->getCapabilities().features[Graphics::FEATURE_COPY_BUFFER_TO_TEXTURE])
+	{
+		size_t sizes[3];
+		size_t totalsize = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			sizes[i] = bpp * widths[i] * heights[i];
+			totalsize += sizes[i];
+		}
+
+		StrongRef<Buffer> &staging = stagingBuffers[stagingIndex];
+		stagingIndex = (stagingIndex + 1) % STAGING_BUFFER_COUNT;
+
+		if (staging.get() == nullptr)
+		{
+			size_t buffersize = (totalsize + 3) & ~(size_t) 3;
+			Buffer::Settings settings(BUFFERUSAGEFLAG_NONE, BUFFERDATAUSAGE_STREAM);
+			staging.set(gfx->newBuffer(settings, DATAFORMAT_UINT8_VEC4, nullptr, buffersize, 0), Acquire::NORETAIN);
+		}
+
+		// The planes are contiguous, so the whole frame is a single write.
+		staging->fill(0, totalsize, frame->yplane);
+
+		size_t offset = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			Rect rect = {0, 0, widths[i], heights[i]};
+			gfx->copyBufferToTexture(staging, textures[i], offset, widths[i], 0, 0, rect);
+			offset += sizes[i];
+		}
+	}
+	else
+	{
 		for (int i = 0; i < 3; i++)
 		{
-			size_t bpp = getPixelFormatBlockSize(PIXELFORMAT_R8_UNORM);
 			size_t size = bpp * widths[i] * heights[i];
 
 			Rect rect = {0, 0, widths[i], heights[i]};
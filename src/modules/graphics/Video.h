@@ -23,6 +23,7 @@
 // LOVE
 #include "common/math.h"
 #include "Drawable.h"
+#include "Buffer.h"
 #include "Texture.h"
 #include "vertex.h"
 #include "video/VideoStream.h"
@@ -63,7 +64,13 @@ public:
 
 private:
 
-	void update();
+	void update(Graphics *gfx);
+	void uploadFrame(Graphics *gfx, const love::video::VideoStream::Frame *frame);
+
+	// Frames are uploaded through a few persistent staging buffers, used in
+	// turn so a buffer isn't refilled while the GPU may still be copying
+	// from it.
+	static const int STAGING_BUFFER_COUNT = 3;
 
 	StrongRef<love::video::VideoStream> stream;
 
@@ -75,6 +82,10 @@ private:
 	Vertex vertices[4];
 
 	StrongRef<Texture> textures[3];
+
+	StrongRef<Buffer> stagingBuffers[STAGING_BUFFER_COUNT];
+	int stagingIndex;
+
 	StrongRef<love::audio::Source> source;
 	
 }; // Video
@@ -0,0 +1,364 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "VirtualTexture.h"
+#include "Graphics.h"
+#include "common/math.h"
+#include "image/ImageData.h"
+
+// C++
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type VirtualTexture::type("VirtualTexture", &Object::type);
+
+static const char virtualTextureShaderCode[] = R"(
+// info: xy = fraction of the page grid covered by the image, z = page size,
+// w = mip level count. See VirtualTexture:getSamplingParameters.
+float VirtualTextureLod(sampler2D pagetable, vec2 uv, vec4 info)
+{
+	vec2 pixels = uv * info.xy * vec2(textureSize(pagetable, 0)) * info.z;
+	vec2 dx = dFdx(pixels);
+	vec2 dy = dFdy(pixels);
+	float lod = floor(0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0)));
+	return clamp(lod, 0.0, info.w - 1.0);
+}
+
+vec4 VirtualTexel(sampler2D pagetable, sampler2DArray cache, vec2 uv, vec4 info)
+{
+	vec2 guv = uv * info.xy;
+	vec4 entry = floor(textureLod(pagetable, guv, VirtualTextureLod(pagetable, uv, info)) * 255.0 + 0.5);
+	if (entry.a < 1.0)
+		return vec4(0.0);
+
+	vec2 pages = max(floor(vec2(textureSize(pagetable, 0)) / exp2(entry.b)), vec2(1.0));
+	return textureLod(cache, vec3(fract(guv * pages), entry.r + entry.g * 256.0), 0.0);
+}
+
+vec4 VirtualTextureFeedback(sampler2D pagetable, vec2 uv, vec4 info)
+{
+	float lod = VirtualTextureLod(pagetable, uv, info);
+	vec2 pages = max(floor(vec2(textureSize(pagetable, 0)) / exp2(lod)), vec2(1.0));
+	vec2 page = min(floor(uv * info.xy * pages), pages - 1.0);
+	vec2 high = floor(page / 256.0);
+	return vec4(mod(page, 256.0), high.x + high.y * 16.0, lod + 1.0) / 255.0;
+}
+)";
+
+VirtualTexture::VirtualTexture(Graphics *gfx, const Settings &settings)
+	: width(settings.width)
+	, height(settings.height)
+	, pageSize(settings.pageSize)
+	, frame(1)
+	, pageTableDirty(true)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("VirtualTexture dimensions must be greater than 0.");
+
+	if (pageSize <= 0 || (pageSize & (pageSize - 1)) != 0)
+		throw love::Exception("VirtualTexture page size must be a power of two.");
+
+	if (settings.cachePages <= 0)
+		throw love::Exception("VirtualTexture cache page count must be greater than 0.");
+
+	if (settings.cachePages > 0xFFFF)
+		throw love::Exception("VirtualTexture cache page count must be at most 65535.");
+
+	pagesX = nextP2((width + pageSize - 1) / pageSize);
+	pagesY = nextP2((height + pageSize - 1) / pageSize);
+
+	if (pagesX > 4096 || pagesY > 4096)
+		throw love::Exception("VirtualTexture dimensions are too large for the page size.");
+
+	mipmapCount = Texture::getTotalMipmapCount(pagesX, pagesY);
+
+	Texture::Settings cachesettings;
+	cachesettings.type = TEXTURE_2D_ARRAY;
+	cachesettings.width = pageSize;
+	cachesettings.height = pageSize;
+	cachesettings.layers = settings.cachePages;
+	cachesettings.format = settings.format;
+	cachesettings.linear = settings.linear;
+	cache.set(gfx->newTexture(cachesettings), Acquire::NORETAIN);
+
+	Texture::Settings tablesettings;
+	tablesettings.width = pagesX;
+	tablesettings.height = pagesY;
+	tablesettings.format = PIXELFORMAT_RGBA8_UNORM;
+	tablesettings.linear = true;
+	tablesettings.mipmaps = mipmapCount > 1 ? Texture::MIPMAPS_MANUAL : Texture::MIPMAPS_NONE;
+	pageTable.set(gfx->newTexture(tablesettings), Acquire::NORETAIN);
+
+	SamplerState s = pageTable->getSamplerState();
+	s.minFilter = s.magFilter = SamplerState::FILTER_NEAREST;
+	s.mipmapFilter = SamplerState::MIPMAP_FILTER_NEAREST;
+	pageTable->setSamplerState(s);
+
+	slots.resize(settings.cachePages, {0, 0, false});
+
+	updatePageTable();
+}
+
+VirtualTexture::~VirtualTexture()
+{
+}
+
+int VirtualTexture::getPagesX(int mipmap) const
+{
+	return std::max(pagesX >> mipmap, 1);
+}
+
+int VirtualTexture::getPagesY(int mipmap) const
+{
+	return std::max(pagesY >> mipmap, 1);
+}
+
+uint64 VirtualTexture::getKey(int x, int y, int mipmap) const
+{
+	return ((uint64) mipmap << 48) | ((uint64) y << 24) | (uint64) x;
+}
+
+void VirtualTexture::validatePage(int x, int y, int mipmap) const
+{
+	if (mipmap < 0 || mipmap >= mipmapCount)
+		throw love::Exception("Invalid VirtualTexture mipmap index %d.", mipmap + 1);
+
+	if (x < 0 || y < 0 || x >= getPagesX(mipmap) || y >= getPagesY(mipmap))
+		throw love::Exception("Invalid VirtualTexture page (%d, %d) for mipmap level %d.", x, y, mipmap + 1);
+}
+
+void VirtualTexture::requestPage(int x, int y, int mipmap)
+{
+	validatePage(x, y, mipmap);
+
+	uint64 key = getKey(x, y, mipmap);
+
+	if (!residentPages.count(key) && !takenPages.count(key))
+		pendingPages.insert(key);
+
+	// Coarser pages are the fallback while finer ones stream in, so they're
+	// kept alive too.
+	for (int mip = mipmap; mip < mipmapCount; mip++)
+	{
+		auto it = residentPages.find(getKey(x, y, mip));
+		if (it != residentPages.end())
+			slots[it->second].lastUsed = frame;
+
+		x >>= 1;
+		y >>= 1;
+	}
+}
+
+int VirtualTexture::processFeedback(love::image::ImageData *feedback)
+{
+	if (feedback->getFormat() != PIXELFORMAT_RGBA8_UNORM)
+		throw love::Exception("VirtualTexture feedback ImageData must use the rgba8 pixel format.");
+
+	love::thread::Lock lock(feedback->getMutex());
+
+	const uint8 *texels = (const uint8 *) feedback->getData();
+	size_t count = (size_t) feedback->getWidth() * feedback->getHeight();
+
+	uint32 lastrequest = 0;
+	int requests = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8 *t = texels + i * 4;
+		if (t[3] == 0)
+			continue;
+
+		requests++;
+
+		// Neighbouring texels usually request the same page.
+		uint32 request = t[0] | (t[1] << 8) | (t[2] << 16) | ((uint32) t[3] << 24);
+		if (request == lastrequest)
+			continue;
+
+		lastrequest = request;
+
+		int x = t[0] | ((t[2] & 0xF) << 8);
+		int y = t[1] | ((t[2] >> 4) << 8);
+		int mipmap = t[3] - 1;
+
+		if (mipmap >= mipmapCount || x >= getPagesX(mipmap) || y >= getPagesY(mipmap))
+			continue;
+
+		requestPage(x, y, mipmap);
+	}
+
+	return requests;
+}
+
+void VirtualTexture::getPendingPages(int maxcount, std::vector<Page> &pages)
+{
+	while (!pendingPages.empty() && (int) pages.size() < maxcount)
+	{
+		auto it = std::prev(pendingPages.end());
+		uint64 key = *it;
+		pendingPages.erase(it);
+		takenPages.insert(key);
+
+		Page p;
+		p.x = (int) (key & 0xFFFFFF);
+		p.y = (int) ((key >> 24) & 0xFFFFFF);
+		p.mipmap = (int) (key >> 48);
+		pages.push_back(p);
+	}
+}
+
+void VirtualTexture::cancelPage(int x, int y, int mipmap)
+{
+	validatePage(x, y, mipmap);
+
+	uint64 key = getKey(x, y, mipmap);
+	pendingPages.erase(key);
+	takenPages.erase(key);
+}
+
+int VirtualTexture::getFreeSlot()
+{
+	int lru = -1;
+
+	for (int i = 0; i < (int) slots.size(); i++)
+	{
+		if (!slots[i].used)
+			return i;
+
+		if (lru < 0 || slots[i].lastUsed < slots[lru].lastUsed)
+			lru = i;
+	}
+
+	residentPages.erase(slots[lru].key);
+	slots[lru].used = false;
+	pageTableDirty = true;
+
+	return lru;
+}
+
+void VirtualTexture::setPage(int x, int y, int mipmap, love::image::ImageData *data)
+{
+	validatePage(x, y, mipmap);
+
+	if (data->getWidth() != pageSize || data->getHeight() != pageSize)
+		throw love::Exception("VirtualTexture page ImageData must be %dx%d.", pageSize, pageSize);
+
+	uint64 key = getKey(x, y, mipmap);
+
+	int slot = -1;
+	auto it = residentPages.find(key);
+	if (it != residentPages.end())
+		slot = it->second;
+	else
+		slot = getFreeSlot();
+
+	cache->replacePixels(data, slot, 0, 0, 0, false);
+
+	slots[slot].key = key;
+	slots[slot].lastUsed = frame;
+	slots[slot].used = true;
+
+	if (it == residentPages.end())
+	{
+		residentPages[key] = slot;
+		pageTableDirty = true;
+	}
+
+	pendingPages.erase(key);
+	takenPages.erase(key);
+}
+
+bool VirtualTexture::isPageResident(int x, int y, int mipmap) const
+{
+	validatePage(x, y, mipmap);
+	return residentPages.count(getKey(x, y, mipmap)) != 0;
+}
+
+void VirtualTexture::updatePageTable()
+{
+	// Built from the coarsest level down, so each texel without a resident
+	// page inherits its parent's entry.
+	std::vector<uint8> parent;
+	std::vector<uint8> entries;
+
+	for (int mip = mipmapCount - 1; mip >= 0; mip--)
+	{
+		int w = getPagesX(mip);
+		int h = getPagesY(mip);
+		int parentw = getPagesX(mip + 1);
+
+		entries.assign((size_t) w * h * 4, 0);
+
+		for (int y = 0; y < h; y++)
+		{
+			for (int x = 0; x < w; x++)
+			{
+				uint8 *entry = &entries[(y * w + x) * 4];
+
+				auto it = residentPages.find(getKey(x, y, mip));
+				if (it != residentPages.end())
+				{
+					entry[0] = (uint8) (it->second & 0xFF);
+					entry[1] = (uint8) (it->second >> 8);
+					entry[2] = (uint8) mip;
+					entry[3] = 255;
+				}
+				else if (!parent.empty())
+					memcpy(entry, &parent[((y >> 1) * parentw + (x >> 1)) * 4], 4);
+			}
+		}
+
+		Rect rect = {0, 0, w, h};
+		pageTable->replacePixels(entries.data(), entries.size(), 0, mip, rect, false);
+
+		parent.swap(entries);
+	}
+
+	pageTableDirty = false;
+}
+
+void VirtualTexture::update()
+{
+	if (pageTableDirty)
+		updatePageTable();
+
+	frame++;
+}
+
+void VirtualTexture::getSamplingParameters(float params[4]) const
+{
+	params[0] = (float) width / (float) (pagesX * pageSize);
+	params[1] = (float) height / (float) (pagesY * pageSize);
+	params[2] = (float) pageSize;
+	params[3] = (float) mipmapCount;
+}
+
+const char *VirtualTexture::getShaderCode()
+{
+	return virtualTextureShaderCode;
+}
+
+} // graphics
+} // love
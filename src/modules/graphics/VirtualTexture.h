@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+#include "common/pixelformat.h"
+#include "Texture.h"
+
+// C++
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+namespace love
+{
+
+namespace image
+{
+class ImageData;
+}
+
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A very large texture which only keeps the pages (fixed-size tiles, one for
+ * each mip level of the virtual image) currently needed in memory. Resident
+ * pages live in the layers of a 2D array texture, and a page table texture
+ * maps each page to its cache layer, falling back to the nearest resident
+ * coarser page. Pages are requested by the application (usually through a
+ * feedback pass), loaded by it from ImageData tiles, and evicted in least
+ * recently used order when the cache is full.
+ *
+ * Page table texels store the cache layer as r + g * 256, the mip level of
+ * the resident page in b, and 255 in a when any page covers the texel.
+ * Feedback texels store the page x and y coordinates in r and g (low 8 bits)
+ * and b (high 4 bits each, x in the low half), and the mip level + 1 in a.
+ **/
+class VirtualTexture : public Object
+{
+public:
+
+	static love::Type type;
+
+	struct Settings
+	{
+		int width = 1;
+		int height = 1;
+		int pageSize = 128;
+		int cachePages = 256;
+		PixelFormat format = PIXELFORMAT_RGBA8_UNORM;
+		bool linear = false;
+	};
+
+	struct Page
+	{
+		int x;
+		int y;
+		int mipmap;
+	};
+
+	VirtualTexture(Graphics *gfx, const Settings &settings);
+	virtual ~VirtualTexture();
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	int getPageSize() const { return pageSize; }
+	int getMipmapCount() const { return mipmapCount; }
+	int getPagesX(int mipmap) const;
+	int getPagesY(int mipmap) const;
+
+	int getCachePageCount() const { return (int) slots.size(); }
+	int getResidentPageCount() const { return (int) residentPages.size(); }
+
+	Texture *getCacheTexture() const { return cache; }
+	Texture *getPageTable() const { return pageTable; }
+
+	/**
+	 * Marks a page as needed this frame. Resident pages (and their coarser
+	 * parents) are kept from being evicted, other pages are queued until
+	 * they're taken by getPendingPages.
+	 **/
+	void requestPage(int x, int y, int mipmap);
+
+	/**
+	 * Requests every page encoded in an RGBA8 feedback ImageData. Returns the
+	 * number of texels which contained a request.
+	 **/
+	int processFeedback(love::image::ImageData *feedback);
+
+	/**
+	 * Takes up to maxcount queued pages, coarsest mip levels first. Taken pages
+	 * aren't queued again until setPage or cancelPage is called for them.
+	 **/
+	void getPendingPages(int maxcount, std::vector<Page> &pages);
+	void cancelPage(int x, int y, int mipmap);
+
+	/**
+	 * Uploads a page's pixels into the cache, evicting the least recently
+	 * used page if the cache is full.
+	 **/
+	void setPage(int x, int y, int mipmap, love::image::ImageData *data);
+
+	bool isPageResident(int x, int y, int mipmap) const;
+
+	/**
+	 * Updates the page table if any page has changed, and starts a new frame
+	 * for page usage tracking. Should be called once per frame.
+	 **/
+	void update();
+
+	/**
+	 * Parameters for the sampling shader code: the fraction of the page grid
+	 * covered by the virtual image, the page size, and the mip count.
+	 **/
+	void getSamplingParameters(float params[4]) const;
+
+	/**
+	 * GLSL helper functions for sampling the virtual texture and writing
+	 * feedback texels.
+	 **/
+	static const char *getShaderCode();
+
+private:
+
+	struct CacheSlot
+	{
+		uint64 key;
+		uint64 lastUsed;
+		bool used;
+	};
+
+	uint64 getKey(int x, int y, int mipmap) const;
+	void validatePage(int x, int y, int mipmap) const;
+	int getFreeSlot();
+	void updatePageTable();
+
+	int width;
+	int height;
+	int pageSize;
+	int mipmapCount;
+
+	// The page grid of the base level is a power of two in each direction, so
+	// every page has exactly one parent page.
+	int pagesX;
+	int pagesY;
+
+	StrongRef<Texture> cache;
+	StrongRef<Texture> pageTable;
+
+	std::vector<CacheSlot> slots;
+	std::unordered_map<uint64, int> residentPages;
+
+	// Ordered by key, which puts coarser mip levels last.
+	std::set<uint64> pendingPages;
+	std::set<uint64> takenPages;
+
+	uint64 frame;
+	bool pageTableDirty;
+
+}; // VirtualTexture
+
+} // graphics
+} // love
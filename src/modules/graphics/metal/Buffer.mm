@@ -119,7 +119,7 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 	if (size == 0)
 		return nullptr;
 
-	if (map == MAP_WRITE_INVALIDATE && (isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK))
+	if (map != MAP_READ_ONLY && (isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK))
 		return nullptr;
 
 	if (map == MAP_READ_ONLY && dataUsage != BUFFERDATAUSAGE_READBACK)
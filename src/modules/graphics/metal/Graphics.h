@@ -25,6 +25,7 @@
 #include "Shader.h"
 
 #include <map>
+#include <vector>
 
 @class CAMetalLayer;
 @protocol CAMetalDrawable;
@@ -65,6 +66,8 @@ public:
 
 	love::graphics::Texture *newTexture(const Texture::Settings &settings, const Texture::Slices *data = nullptr) override;
 	love::graphics::Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) override;
+	love::graphics::TimerQuery *newTimerQuery() override;
+	love::graphics::OcclusionQuery *newOcclusionQuery(bool precise) override;
 
 	Matrix4 computeDeviceProjection(const Matrix4 &projection, bool rendertotexture) const override;
 
@@ -114,6 +117,8 @@ public:
 	Renderer getRenderer() const override;
 	bool usesGLSLES() const override;
 	RendererInfo getRendererInfo() const override;
+	void defragmentMemory() override;
+	std::vector<MemoryHeap> getMemoryHeaps() const override;
 
 	void setShaderChanged();
 
@@ -143,14 +148,36 @@ public:
 
 	int getClosestMSAASamples(int requestedsamples);
 
+	/**
+	 * The MTLTextures of destroyed Textures are kept around for a while
+	 * instead of being released right away, and new Textures with the same
+	 * descriptor reuse them. Returns nil if nothing matches.
+	 **/
+	id<MTLTexture> takeRecycledTexture(MTLTextureDescriptor *desc);
+	void recycleTexture(id<MTLTexture> texture);
+
 	static Graphics *getInstance() { return graphicsInstance; }
 
+	void pipelineCreated() { ++pipelineCreations; }
+
+	/**
+	 * Lets pipeline creation look up previously compiled pipelines from the
+	 * binary archive in the save directory, and records newly compiled ones
+	 * so they're saved for the next run.
+	 **/
+	void usePipelineBinaryArchive(MTLRenderPipelineDescriptor *desc);
+	void addToPipelineBinaryArchive(MTLRenderPipelineDescriptor *desc);
+
 	id<MTLDevice> device;
 
 private:
 
 	static Graphics *graphicsInstance;
 
+	std::string getPipelineBinaryArchiveFilename() const;
+	void createPipelineBinaryArchive();
+	void savePipelineBinaryArchive();
+
 	enum StateType
 	{
 		STATE_BLEND,
@@ -189,6 +216,16 @@ private:
 		bool macCatalyst[2+1];
 	};
 
+	struct RecycledTexture
+	{
+		void *texture; // Retained id<MTLTexture>.
+		int framesSinceRecycled;
+	};
+
+	// Recycled textures which aren't reused within this many frames are
+	// released.
+	static const int MAX_RECYCLED_TEXTURE_FRAMES = 60;
+
 	struct AttachmentStoreActions
 	{
 		MTLStoreAction color[MAX_COLOR_RENDER_TARGETS];
@@ -196,8 +233,8 @@ private:
 		MTLStoreAction stencil;
 	};
 
-	love::graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
-	love::graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM]) override;
+	love::graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv) override;
+	love::graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection) override;
 	love::graphics::StreamBuffer *newStreamBuffer(BufferUsage usage, size_t size) override;
 
 	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) override;
@@ -205,10 +242,13 @@ private:
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
 
 	void endPass(bool presenting);
 
+	void updateRecycledTextures();
+	void clearRecycledTextures();
+
 	id<MTLDepthStencilState> getCachedDepthStencilState(const DepthState &depth, const StencilState &stencil);
 	void applyRenderState(id<MTLRenderCommandEncoder> renderEncoder, const VertexAttributes &attributes);
 	bool applyShaderUniforms(id<MTLComputeCommandEncoder> encoder, love::graphics::Shader *shader);
@@ -223,6 +263,10 @@ private:
 
 	CAMetalLayer *metalLayer;
 	id<CAMetalDrawable> activeDrawable;
+
+	// The command buffers which presented each of the last few frames.
+	id<MTLCommandBuffer> frameCommandBuffers[MAX_FRAMES_IN_FLIGHT];
+	int frameCommandBufferIndex = 0;
 	MTLRenderPassDescriptor *passDesc;
 
 	uint32 dirtyRenderState;
@@ -230,6 +274,10 @@ private:
 	Shader::RenderPipelineKey lastRenderPipelineKey;
 	bool windowHasStencil;
 	int shaderSwitches;
+	int pipelineCreations;
+	int samplerCreations;
+
+	std::vector<RecycledTexture> recycledTextures;
 
 	StrongRef<love::graphics::Texture> backbufferMSAA;
 	StrongRef<love::graphics::Texture> backbufferDepthStencil;
@@ -243,6 +291,13 @@ private:
 	StreamBuffer::MapInfo uniformBufferData;
 	size_t uniformBufferOffset;
 
+	// A copy of the last uniform data uploaded for a draw. Draws with
+	// identical uniforms reuse its location in this frame's uniform buffer,
+	// which also lets the encoder skip the buffer offset calls.
+	std::vector<uint8> lastRenderUniformData;
+	size_t lastRenderUniformOffset;
+	bool lastRenderUniformValid;
+
 	Buffer *defaultAttributesBuffer;
 
 	Texture *defaultTextures[TEXTURE_MAX_ENUM];
@@ -254,6 +309,10 @@ private:
 
 	DeviceFamilies families;
 
+	// id<MTLBinaryArchive>, only available on macOS 11 and iOS 14.
+	id pipelineBinaryArchive;
+	bool pipelineBinaryArchiveDirty;
+
 }; // Graphics
 
 } // metal
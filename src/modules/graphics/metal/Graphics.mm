@@ -23,11 +23,16 @@
 #include "Buffer.h"
 #include "Texture.h"
 #include "GraphicsReadback.h"
+#include "TimerQuery.h"
+#include "OcclusionQuery.h"
 #include "Shader.h"
 #include "ShaderStage.h"
 #include "window/Window.h"
 #include "image/Image.h"
 #include "common/memory.h"
+#include "common/version.h"
+#include "common/Trace.h"
+#include "filesystem/Filesystem.h"
 
 #import <QuartzCore/CAMetalLayer.h>
 
@@ -276,13 +281,19 @@ Graphics::Graphics()
 	, lastRenderPipelineKey()
 	, windowHasStencil(false)
 	, shaderSwitches(0)
+	, pipelineCreations(0)
+	, samplerCreations(0)
 	, requestedBackbufferMSAA(0)
 	, attachmentStoreActions()
 	, renderBindings()
 	, uniformBufferOffset(0)
+	, lastRenderUniformOffset(0)
+	, lastRenderUniformValid(false)
 	, defaultAttributesBuffer(nullptr)
 	, defaultTextures()
 	, families()
+	, pipelineBinaryArchive(nil)
+	, pipelineBinaryArchiveDirty(false)
 { @autoreleasepool {
 	if (@available(macOS 10.15, iOS 13.0, *))
 	{
@@ -328,6 +339,8 @@ Graphics::Graphics()
 
 	initCapabilities();
 
+	createPipelineBinaryArchive();
+
 	uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 
 	{
@@ -370,16 +383,20 @@ Graphics::Graphics()
 	createFanIndexBuffer();
 
 	// We always need a default shader.
-	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
-		auto stype = (Shader::StandardShader) i;
-		if (!Shader::standardShaders[i])
+		LOVE_TRACE_STARTUP_STAGE("default shaders");
+
+		for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 		{
-			std::vector<std::string> stages;
-			Shader::CompileOptions opts;
-			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_VERTEX));
-			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_PIXEL));
-			Shader::standardShaders[i] = newShader(stages, opts);
+			auto stype = (Shader::StandardShader) i;
+			if (!Shader::standardShaders[i])
+			{
+				std::vector<std::string> stages;
+				Shader::CompileOptions opts;
+				stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_VERTEX));
+				stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_PIXEL));
+				Shader::standardShaders[i] = newShader(stages, opts);
+			}
 		}
 	}
 
@@ -408,6 +425,8 @@ Graphics::Graphics()
 Graphics::~Graphics()
 { @autoreleasepool {
 	submitCommandBuffer(SUBMIT_DONE);
+	savePipelineBinaryArchive();
+	pipelineBinaryArchive = nil;
 	delete uniformBuffer;
 	delete defaultAttributesBuffer;
 	passDesc = nil;
@@ -423,9 +442,106 @@ Graphics::~Graphics()
 	for (auto &kvp : cachedDepthStencilStates)
 		CFBridgingRelease(kvp.second);
 
+	clearRecycledTextures();
+
 	graphicsInstance = nullptr;
 }}
 
+std::string Graphics::getPipelineBinaryArchiveFilename() const
+{
+	// Archives are only useful on the GPU and OS version they were created on.
+	std::string key = LOVE_VERSION_STRING;
+	key += '\n';
+	key += device.name.UTF8String;
+	key += '\n';
+	key += [NSProcessInfo processInfo].operatingSystemVersionString.UTF8String;
+
+	return getCacheFilename("metalpipelinecache", key, ".metallib");
+}
+
+void Graphics::createPipelineBinaryArchive()
+{ @autoreleasepool {
+	if (@available(macOS 11.0, iOS 14.0, *))
+	{
+		auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+		if (fs == nullptr)
+			return;
+
+		std::string filename = getPipelineBinaryArchiveFilename();
+
+		MTLBinaryArchiveDescriptor *desc = [MTLBinaryArchiveDescriptor new];
+
+		love::filesystem::Filesystem::Info info = {};
+		if (fs->getInfo(filename.c_str(), info) && info.type != love::filesystem::Filesystem::FILETYPE_DIRECTORY)
+		{
+			// Resolve the full path, as the archive is loaded without physfs.
+			std::string path = fs->getRealDirectory(filename.c_str()) + LOVE_PATH_SEPARATOR + filename;
+			desc.url = [NSURL fileURLWithPath:@(path.c_str())];
+		}
+
+		NSError *err = nil;
+		id<MTLBinaryArchive> archive = [device newBinaryArchiveWithDescriptor:desc error:&err];
+
+		// A stale or corrupt archive is discarded, it will be rebuilt as
+		// pipelines are compiled.
+		if (archive == nil && desc.url != nil)
+		{
+			desc.url = nil;
+			archive = [device newBinaryArchiveWithDescriptor:desc error:&err];
+		}
+
+		pipelineBinaryArchive = archive;
+	}
+}}
+
+void Graphics::savePipelineBinaryArchive()
+{ @autoreleasepool {
+	if (@available(macOS 11.0, iOS 14.0, *))
+	{
+		if (pipelineBinaryArchive == nil || !pipelineBinaryArchiveDirty)
+			return;
+
+		auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+		if (fs == nullptr)
+			return;
+
+		// The archive serializes itself to a URL, only its directory is
+		// created through love.filesystem.
+		if (!createCacheDirectory("metalpipelinecache"))
+			return;
+
+		std::string path = fs->getSaveDirectory() + "/" + getPipelineBinaryArchiveFilename();
+
+		id<MTLBinaryArchive> archive = pipelineBinaryArchive;
+		NSError *err = nil;
+		if ([archive serializeToURL:[NSURL fileURLWithPath:@(path.c_str())] error:&err])
+			pipelineBinaryArchiveDirty = false;
+	}
+}}
+
+void Graphics::usePipelineBinaryArchive(MTLRenderPipelineDescriptor *desc)
+{
+	if (@available(macOS 11.0, iOS 14.0, *))
+	{
+		if (pipelineBinaryArchive != nil)
+			desc.binaryArchives = @[pipelineBinaryArchive];
+	}
+}
+
+void Graphics::addToPipelineBinaryArchive(MTLRenderPipelineDescriptor *desc)
+{
+	if (@available(macOS 11.0, iOS 14.0, *))
+	{
+		if (pipelineBinaryArchive == nil)
+			return;
+
+		id<MTLBinaryArchive> archive = pipelineBinaryArchive;
+		NSError *err = nil;
+		if ([archive addRenderPipelineFunctionsWithDescriptor:desc error:&err])
+			pipelineBinaryArchiveDirty = true;
+	}
+}
+
 love::graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage usage, size_t size)
 {
 	return CreateStreamBuffer(device, usage, size);
@@ -436,14 +552,14 @@ love::graphics::Texture *Graphics::newTexture(const Texture::Settings &settings,
 	return new Texture(this, device, settings, data);
 }
 
-love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles)
+love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv)
 {
-	return new ShaderStage(this, stage, source, gles, cachekey);
+	return new ShaderStage(this, stage, source, gles, cachekey, prebuiltspirv);
 }
 
-love::graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM])
+love::graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection)
 {
-	return new Shader(device, stages);
+	return new Shader(device, stages, prebuiltreflection);
 }
 
 love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength)
@@ -451,6 +567,16 @@ love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, co
 	return new Buffer(this, device, settings, format, data, size, arraylength);
 }
 
+love::graphics::TimerQuery *Graphics::newTimerQuery()
+{
+	return new TimerQuery(this);
+}
+
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery(bool precise)
+{
+	return new OcclusionQuery(this, precise);
+}
+
 love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
@@ -543,6 +669,9 @@ void Graphics::unSetMode()
 	created = false;
 	metalLayer = nil;
 	activeDrawable = nil;
+
+	for (auto &cmd : frameCommandBuffers)
+		cmd = nil;
 }}
 
 void Graphics::setActive(bool enable)
@@ -592,6 +721,28 @@ void Graphics::submitAllEncoders(SubmitType type)
 	submitComputeEncoder();
 }
 
+static inline bool isMemoryless(id<MTLTexture> texture)
+{
+	if (@available(macOS 11.0, iOS 10.0, *))
+		return texture != nil && texture.storageMode == MTLStorageModeMemoryless;
+	return false;
+}
+
+static inline MTLStoreAction getStoreAction(MTLRenderPassAttachmentDescriptor *desc, MTLStoreAction action, bool store)
+{
+	// Memoryless attachments can't be stored, their contents only exist
+	// for the duration of the render pass.
+	if (isMemoryless(desc.texture))
+		return MTLStoreActionDontCare;
+	return store ? MTLStoreActionStore : action;
+}
+
+static inline void fixMemorylessLoadAction(MTLRenderPassAttachmentDescriptor *desc)
+{
+	if (desc.loadAction == MTLLoadActionLoad && isMemoryless(desc.texture))
+		desc.loadAction = MTLLoadActionDontCare;
+}
+
 static inline void setAttachment(const Graphics::RenderTarget &rt, MTLRenderPassAttachmentDescriptor *desc, MTLStoreAction &storeaction, bool setload = true)
 {
 	bool isvolume = rt.texture->getTextureType() == TEXTURE_VOLUME;
@@ -670,8 +821,22 @@ id<MTLRenderCommandEncoder> Graphics::useRenderEncoder()
 			key.msaa = backbufferMSAA ? (uint8) backbufferMSAA->getMSAA() : 1;
 		}
 
+		for (int i = 0; i < MAX_COLOR_RENDER_TARGETS; i++)
+			fixMemorylessLoadAction(passDesc.colorAttachments[i]);
+		fixMemorylessLoadAction(passDesc.depthAttachment);
+		fixMemorylessLoadAction(passDesc.stencilAttachment);
+
+		auto occlusionQuery = (OcclusionQuery *) activeOcclusionQuery;
+		if (occlusionQuery != nullptr)
+			occlusionQuery->prepareRenderPass(passDesc);
+		else
+			passDesc.visibilityResultBuffer = nil;
+
 		renderEncoder = [useCommandBuffer() renderCommandEncoderWithDescriptor:passDesc];
 
+		if (occlusionQuery != nullptr)
+			occlusionQuery->beginRenderPass(renderEncoder);
+
 		renderBindings = {};
 
 		id<MTLBuffer> defaultbuffer = getMTLBuffer(defaultAttributesBuffer);
@@ -694,15 +859,15 @@ void Graphics::submitRenderEncoder(SubmitType type)
 		bool isbackbuffer = rts.getFirstTarget().texture.get() == nullptr;
 
 		if (isbackbuffer)
-			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[0]) atIndex:0];
+			[renderEncoder setColorStoreAction:getStoreAction(passDesc.colorAttachments[0], actions.color[0], store) atIndex:0];
 
 		for (size_t i = 0; i < rts.colors.size(); i++)
-			[renderEncoder setColorStoreAction:(store ? MTLStoreActionStore : actions.color[i]) atIndex:i];
+			[renderEncoder setColorStoreAction:getStoreAction(passDesc.colorAttachments[i], actions.color[i], store) atIndex:i];
 
 		if (rts.depthStencil.texture.get() || rts.temporaryRTFlags != 0 || isbackbuffer)
 		{
-			[renderEncoder setDepthStoreAction:store ? MTLStoreActionStore : actions.depth];
-			[renderEncoder setStencilStoreAction:store ? MTLStoreActionStore : actions.stencil];
+			[renderEncoder setDepthStoreAction:getStoreAction(passDesc.depthAttachment, actions.depth, store)];
+			[renderEncoder setStencilStoreAction:getStoreAction(passDesc.stencilAttachment, actions.stencil, store)];
 		}
 
 		[renderEncoder endEncoding];
@@ -816,7 +981,10 @@ id<MTLSamplerState> Graphics::getCachedSampler(const SamplerState &s)
 	id<MTLSamplerState> sampler = [device newSamplerStateWithDescriptor:desc];
 
 	if (sampler != nil)
+	{
 		cachedSamplers[key] = (void *) CFBridgingRetain(sampler);
+		samplerCreations++;
+	}
 
 	return sampler;
 }}
@@ -999,6 +1167,7 @@ bool Graphics::applyShaderUniforms(id<MTLComputeCommandEncoder> encoder, love::g
 		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, newsize);
 		uniformBufferData = {};
 		uniformBufferOffset = 0;
+		lastRenderUniformValid = false;
 	}
 
 	if (uniformBufferData.data == nullptr)
@@ -1098,28 +1267,38 @@ void Graphics::applyShaderUniforms(id<MTLRenderCommandEncoder> renderEncoder, lo
 	builtins->constantColor = getColor();
 	gammaCorrectColor(builtins->constantColor);
 
-	if (uniformBuffer->getSize() < uniformBufferOffset + size)
+	bool reuseuniforms = lastRenderUniformValid && lastRenderUniformData.size() == size
+		&& memcmp(lastRenderUniformData.data(), bufferdata, size) == 0;
+
+	if (!reuseuniforms)
 	{
-		size_t newsize = uniformBuffer->getSize() * 2;
-		uniformBuffer->release();
-		uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, newsize);
-		uniformBufferData = {};
-		uniformBufferOffset = 0;
-	}
+		if (uniformBuffer->getSize() < uniformBufferOffset + size)
+		{
+			size_t newsize = uniformBuffer->getSize() * 2;
+			uniformBuffer->release();
+			uniformBuffer = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, newsize);
+			uniformBufferData = {};
+			uniformBufferOffset = 0;
+		}
 
-	if (uniformBufferData.data == nullptr)
-		uniformBufferData = uniformBuffer->map(uniformBuffer->getSize());
+		if (uniformBufferData.data == nullptr)
+			uniformBufferData = uniformBuffer->map(uniformBuffer->getSize());
 
-	memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+		memcpy(uniformBufferData.data + uniformBufferOffset, bufferdata, size);
+
+		lastRenderUniformData.assign(bufferdata, bufferdata + size);
+		lastRenderUniformOffset = uniformBufferOffset;
+		lastRenderUniformValid = true;
+
+		uniformBufferOffset += alignUp(size, alignment);
+	}
 
 	id<MTLBuffer> buffer = getMTLBuffer(uniformBuffer);
 	int uniformindex = Shader::getUniformBufferBinding();
 
 	auto &bindings = renderBindings;
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, uniformBufferOffset);
-	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, uniformBufferOffset);
-
-	uniformBufferOffset += alignUp(size, alignment);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_VERTEX, uniformindex, buffer, lastRenderUniformOffset);
+	setBuffer(renderEncoder, bindings, SHADERSTAGE_PIXEL, uniformindex, buffer, lastRenderUniformOffset);
 
 	for (const Shader::TextureBinding &b : s->getTextureBindings())
 	{
@@ -1204,6 +1383,26 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	setVertexBuffers(encoder, Shader::current, cmd.buffers, renderBindings);
 
+	if (cmd.indirectBuffer != nullptr)
+	{
+		// Metal has no multi-draw variant outside of indirect command buffers,
+		// so each draw reads its own arguments.
+		id<MTLBuffer> indirectbuffer = getMTLBuffer(cmd.indirectBuffer);
+		size_t offset = cmd.indirectBufferOffset;
+
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+					 indirectBuffer:indirectbuffer
+			   indirectBufferOffset:offset];
+
+			offset += sizeof(DrawIndirectArguments);
+			++drawCalls;
+		}
+
+		return;
+	}
+
 	[encoder drawPrimitives:getMTLPrimitiveType(cmd.primitiveType)
 				vertexStart:cmd.vertexStart
 				vertexCount:cmd.vertexCount
@@ -1229,6 +1428,27 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 
 	auto indexType = cmd.indexType == INDEX_UINT32 ? MTLIndexTypeUInt32 : MTLIndexTypeUInt16;
 
+	if (cmd.indirectBuffer != nullptr)
+	{
+		id<MTLBuffer> indirectbuffer = getMTLBuffer(cmd.indirectBuffer);
+		size_t offset = cmd.indirectBufferOffset;
+
+		for (int i = 0; i < cmd.indirectDrawCount; i++)
+		{
+			[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
+								 indexType:indexType
+							   indexBuffer:getMTLBuffer(cmd.indexBuffer)
+						 indexBufferOffset:0
+							indirectBuffer:indirectbuffer
+					  indirectBufferOffset:offset];
+
+			offset += sizeof(DrawIndexedIndirectArguments);
+			++drawCalls;
+		}
+
+		return;
+	}
+
 	[encoder drawIndexedPrimitives:getMTLPrimitiveType(cmd.primitiveType)
 						indexCount:cmd.indexCount
 						 indexType:indexType
@@ -1421,8 +1641,10 @@ void Graphics::endPass(bool presenting)
 	love::graphics::Texture *depthstencil = rts.depthStencil.texture.get();
 
 	// Discard the depth/stencil buffer if we're using an internal cached one,
-	// or if we're presenting the backbuffer to the display.
+	// if its contents weren't requested to be kept, or if we're presenting the
+	// backbuffer to the display.
 	if ((depthstencil == nullptr && (rts.temporaryRTFlags & (TEMPORARY_RT_DEPTH | TEMPORARY_RT_STENCIL)) != 0)
+		|| (depthstencil != nullptr && (rts.passFlags & RENDER_PASS_DONT_STORE_DEPTH_STENCIL) != 0)
 		|| (presenting && !rts.getFirstTarget().texture.get()))
 	{
 		attachmentStoreActions.depth = MTLStoreActionDontCare;
@@ -1552,6 +1774,8 @@ void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 
 void Graphics::present(void *screenshotCallbackData)
 { @autoreleasepool {
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (!isActive())
 		return;
 
@@ -1599,6 +1823,7 @@ void Graphics::present(void *screenshotCallbackData)
 	uniformBuffer->nextFrame();
 	uniformBufferData = {};
 	uniformBufferOffset = 0;
+	lastRenderUniformValid = false;
 
 	id<MTLCommandBuffer> cmd = getCommandBuffer();
 
@@ -1607,53 +1832,66 @@ void Graphics::present(void *screenshotCallbackData)
 
 	submitCommandBuffer(SUBMIT_DONE);
 
+	endFrameTimer();
+
 	activeDrawable = nil;
 
+	// Limit how far ahead of the GPU the CPU can get. There's no way to wait
+	// for a frame to be displayed here, so low latency mode waits for this
+	// frame's GPU work and uses the fewest drawables instead.
+	if (cmd != nil)
+	{
+		int framesago = isLowLatency() ? 0 : getFramesInFlight() - 1;
+		frameCommandBuffers[frameCommandBufferIndex] = cmd;
+
+		id<MTLCommandBuffer> waitcmd = frameCommandBuffers[(frameCommandBufferIndex + MAX_FRAMES_IN_FLIGHT - framesago) % MAX_FRAMES_IN_FLIGHT];
+		if (waitcmd != nil)
+			[waitcmd waitUntilCompleted];
+
+		frameCommandBufferIndex = (frameCommandBufferIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+	}
+
+	if (@available(macOS 10.13.2, iOS 11.2, *))
+	{
+		NSUInteger drawables = (isLowLatency() || getFramesInFlight() == 1) ? 2 : 3;
+		if (metalLayer.maximumDrawableCount != drawables)
+			metalLayer.maximumDrawableCount = drawables;
+	}
+
 	if (!pendingScreenshotCallbacks.empty())
 	{
 		[cmd waitUntilCompleted];
 
 		size_t size = w * h * 4;
 
-		auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
+		std::vector<ScreenshotInfo> callbacks;
+		std::swap(callbacks, pendingScreenshotCallbacks);
 
-		for (int i = 0; i < (int) pendingScreenshotCallbacks.size(); i++)
-		{
-			const auto &info = pendingScreenshotCallbacks[i];
-			image::ImageData *img = nullptr;
+		StrongRef<image::ImageData> img;
 
-			try
-			{
-				img = imagemodule->newImageData(w, h, PIXELFORMAT_RGBA8_UNORM, screenshotbuffer.contents);
-			}
-			catch (love::Exception &)
-			{
+		try
+		{
+			img.set(newScreenshotImageData(w, h, screenshotbuffer.contents), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			for (const auto &info : callbacks)
 				info.callback(&info, nullptr, nullptr);
-				for (int j = i + 1; j < (int) pendingScreenshotCallbacks.size(); j++)
-				{
-					const auto &ninfo = pendingScreenshotCallbacks[j];
-					ninfo.callback(&ninfo, nullptr, nullptr);
-				}
-				pendingScreenshotCallbacks.clear();
-				throw;
-			}
+			throw;
+		}
 
-			uint8 *screenshot = (uint8 *) img->getData();
+		uint8 *screenshot = (uint8 *) img->getData();
 
-			// Convert from BGRA to RGBA and replace alpha with full opacity.
-			for (size_t i = 0; i < size; i += 4)
-			{
-				uint8 r = screenshot[i + 2];
-				screenshot[i + 2] = screenshot[i + 0];
-				screenshot[i + 0] = r;
-				screenshot[i + 3] = 255;
-			}
-
-			info.callback(&info, img, screenshotCallbackData);
-			img->release();
+		// Convert from BGRA to RGBA and replace alpha with full opacity.
+		for (size_t i = 0; i < size; i += 4)
+		{
+			uint8 r = screenshot[i + 2];
+			screenshot[i + 2] = screenshot[i + 0];
+			screenshot[i + 0] = r;
+			screenshot[i + 3] = 255;
 		}
 
-		pendingScreenshotCallbacks.clear();
+		callScreenshotCallbacks(callbacks, img, screenshotCallbackData);
 	}
 
 	auto window = Module::getInstance<love::window::Window>(M_WINDOW);
@@ -1666,11 +1904,23 @@ void Graphics::present(void *screenshotCallbackData)
 	// Reset the per-frame stat counts.
 	drawCalls = 0;
 	shaderSwitches = 0;
+	pipelineCreations = 0;
+	samplerCreations = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawsCulled = 0;
+	love::graphics::StreamBuffer::frameBytesUsed = 0;
+	love::graphics::StreamBuffer::frameStalls = 0;
+	Object::resetRefCountStats();
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
+	updateRecycledTextures();
+
+	beginFrameTimer();
+
+	updateTextureUploads();
+	updatePendingShaders();
 }}
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -2096,6 +2346,87 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 	return info;
 }
 
+std::vector<Graphics::MemoryHeap> Graphics::getMemoryHeaps() const
+{
+	std::vector<MemoryHeap> heaps;
+
+	if (@available(macOS 10.13, iOS 16.0, *))
+	{
+		MemoryHeap heap;
+		heap.usage = (int64) device.currentAllocatedSize;
+		heap.budget = (int64) device.recommendedMaxWorkingSetSize;
+		heap.deviceLocal = true;
+		heaps.push_back(heap);
+	}
+
+	return heaps;
+}
+
+static bool isTextureCompatible(id<MTLTexture> texture, MTLTextureDescriptor *desc)
+{
+	return texture.textureType == desc.textureType && texture.pixelFormat == desc.pixelFormat
+		&& texture.width == desc.width && texture.height == desc.height
+		&& texture.depth == desc.depth && texture.arrayLength == desc.arrayLength
+		&& texture.mipmapLevelCount == desc.mipmapLevelCount && texture.sampleCount == desc.sampleCount
+		&& texture.storageMode == desc.storageMode && texture.usage == desc.usage;
+}
+
+id<MTLTexture> Graphics::takeRecycledTexture(MTLTextureDescriptor *desc)
+{
+	for (size_t i = 0; i < recycledTextures.size(); i++)
+	{
+		const RecycledTexture &t = recycledTextures[i];
+
+		// Work in command buffers which haven't completed yet may still use
+		// the texture's old contents.
+		if (t.framesSinceRecycled < MAX_FRAMES_IN_FLIGHT)
+			continue;
+
+		if (isTextureCompatible((__bridge id<MTLTexture>) t.texture, desc))
+		{
+			id<MTLTexture> texture = (id<MTLTexture>) CFBridgingRelease(t.texture);
+			recycledTextures[i] = recycledTextures.back();
+			recycledTextures.pop_back();
+			return texture;
+		}
+	}
+
+	return nil;
+}
+
+void Graphics::recycleTexture(id<MTLTexture> texture)
+{
+	recycledTextures.push_back({(void *) CFBridgingRetain(texture), 0});
+}
+
+void Graphics::updateRecycledTextures()
+{
+	for (int i = (int) recycledTextures.size() - 1; i >= 0; i--)
+	{
+		auto &t = recycledTextures[i];
+		if (++t.framesSinceRecycled >= MAX_RECYCLED_TEXTURE_FRAMES)
+		{
+			CFBridgingRelease(t.texture);
+			t = recycledTextures.back();
+			recycledTextures.pop_back();
+		}
+	}
+}
+
+void Graphics::clearRecycledTextures()
+{
+	for (const auto &t : recycledTextures)
+		CFBridgingRelease(t.texture);
+
+	recycledTextures.clear();
+}
+
+void Graphics::defragmentMemory()
+{ @autoreleasepool {
+	// Metal places resources itself, but recycled textures can be given back.
+	clearRecycledTextures();
+}}
+
 int Graphics::getClosestMSAASamples(int requestedsamples)
 {
 	// We currently rely on StoreAndMultisampleResolve (unfortunately), which
@@ -2172,7 +2503,13 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE] = true;
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = true;
 	capabilities.features[FEATURE_COPY_RENDER_TARGET_TO_BUFFER] = true;
-	static_assert(FEATURE_MAX_ENUM == 17, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	if (@available(macOS 10.15, iOS 10.3, *))
+		capabilities.features[FEATURE_TIMER_QUERY] = true;
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = false;
+	capabilities.features[FEATURE_INDIRECT_DRAW] = families.mac[1] || families.macCatalyst[1] || families.apple[3];
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	capabilities.features[FEATURE_CONDITIONAL_RENDER] = false;
+	static_assert(FEATURE_MAX_ENUM == 22, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	// https://developer.apple.com/metal/Metal-Feature-Set-Tables.pdf
 	capabilities.limits[LIMIT_POINT_SIZE] = 511;
@@ -2218,9 +2555,23 @@ void Graphics::initCapabilities()
 		capabilities.textureTypes[i] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
 {
-	shaderswitches = shaderSwitches;
+	stats.shaderSwitches = shaderSwitches;
+	stats.pipelineCreations = pipelineCreations;
+	stats.samplerCreations = samplerCreations;
+
+	// Recycled textures keep their storage without being used by anything.
+	int64 recycledmemory = 0;
+
+	if (@available(macOS 10.13, iOS 11.0, *))
+	{
+		for (const auto &t : recycledTextures)
+			recycledmemory += (int64) ((__bridge id<MTLTexture>) t.texture).allocatedSize;
+	}
+
+	stats.gpuMemoryUnused = recycledmemory;
+	stats.gpuMemoryReserved = love::graphics::Texture::totalGraphicsMemory + love::graphics::Buffer::totalGraphicsMemory + recycledmemory;
 }
 
 } // metal
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "graphics/OcclusionQuery.h"
+
+#import <Metal/MTLBuffer.h>
+#import <Metal/MTLRenderCommandEncoder.h>
+#import <Metal/MTLRenderPass.h>
+
+#include <atomic>
+#include <memory>
+
+namespace love::graphics::metal
+{
+
+/**
+ * Visibility results are written per render command encoder, so each render
+ * encoder which is created while the query is running gets its own slot in
+ * the visibility result buffer, and the result is their sum.
+ **/
+class OcclusionQuery final : public love::graphics::OcclusionQuery
+{
+public:
+
+	OcclusionQuery(love::graphics::Graphics *gfx, bool precise);
+	virtual ~OcclusionQuery();
+
+	// Called by Graphics when creating a render encoder while this query is
+	// running.
+	void prepareRenderPass(MTLRenderPassDescriptor *desc);
+	void beginRenderPass(id<MTLRenderCommandEncoder> encoder);
+
+protected:
+
+	void beginQuery() override;
+	void endQuery() override;
+	bool getResult(uint64 &samples) override;
+
+private:
+
+	static const int MAX_RENDER_PASSES = 64;
+
+	id<MTLBuffer> buffer;
+
+	int usedSlots;
+	bool overflow;
+
+	uint64 generation;
+
+	// Written from a command buffer completion handler on another thread.
+	std::shared_ptr<std::atomic<uint64>> completedGeneration;
+
+}; // OcclusionQuery
+
+} // love::graphics::metal
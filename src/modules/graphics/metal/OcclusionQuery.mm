@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+#include "Graphics.h"
+
+#include <string.h>
+
+namespace love::graphics::metal
+{
+
+OcclusionQuery::OcclusionQuery(love::graphics::Graphics *gfx, bool precise)
+	: love::graphics::OcclusionQuery(gfx, precise)
+	, buffer(nil)
+	, usedSlots(0)
+	, overflow(false)
+	, generation(0)
+	, completedGeneration(std::make_shared<std::atomic<uint64>>(0))
+{
+}
+
+OcclusionQuery::~OcclusionQuery()
+{ @autoreleasepool {
+	buffer = nil;
+}}
+
+void OcclusionQuery::beginQuery()
+{ @autoreleasepool {
+	auto mgfx = (Graphics *) gfx;
+
+	// The GPU may still be writing to the previous buffer, so each start gets
+	// a new one rather than waiting on it.
+	buffer = [mgfx->device newBufferWithLength:MAX_RENDER_PASSES * sizeof(uint64) options:MTLResourceStorageModeShared];
+	if (buffer == nil)
+		throw love::Exception("Could not create occlusion query buffer.");
+
+	memset(buffer.contents, 0, buffer.length);
+
+	generation++;
+	usedSlots = 0;
+	overflow = false;
+
+	// The next draw starts a new render encoder, which picks up the buffer.
+	mgfx->submitRenderEncoder(Graphics::SUBMIT_STORE);
+}}
+
+void OcclusionQuery::endQuery()
+{ @autoreleasepool {
+	auto mgfx = (Graphics *) gfx;
+
+	mgfx->submitRenderEncoder(Graphics::SUBMIT_STORE);
+
+	auto completed = completedGeneration;
+	uint64 gen = generation;
+
+	[mgfx->useCommandBuffer() addCompletedHandler:^(id<MTLCommandBuffer> _Nonnull)
+	{
+		*completed = gen;
+	}];
+}}
+
+void OcclusionQuery::prepareRenderPass(MTLRenderPassDescriptor *desc)
+{
+	desc.visibilityResultBuffer = usedSlots < MAX_RENDER_PASSES ? buffer : nil;
+}
+
+void OcclusionQuery::beginRenderPass(id<MTLRenderCommandEncoder> encoder)
+{
+	if (usedSlots >= MAX_RENDER_PASSES)
+	{
+		overflow = true;
+		return;
+	}
+
+	MTLVisibilityResultMode mode = precise ? MTLVisibilityResultModeCounting : MTLVisibilityResultModeBoolean;
+	[encoder setVisibilityResultMode:mode offset:usedSlots * sizeof(uint64)];
+
+	usedSlots++;
+}
+
+bool OcclusionQuery::getResult(uint64 &samples)
+{
+	if (*completedGeneration != generation || buffer == nil)
+		return false;
+
+	const uint64 *results = (const uint64 *) buffer.contents;
+
+	samples = 0;
+	for (int i = 0; i < usedSlots; i++)
+		samples += results[i];
+
+	if (overflow && samples == 0)
+		samples = 1;
+
+	return true;
+}
+
+} // love::graphics::metal
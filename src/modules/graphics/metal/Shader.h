@@ -33,11 +33,7 @@
 #include <unordered_map>
 #include <map>
 #include <string>
-
-namespace glslang
-{
-class TProgram;
-}
+#include <vector>
 
 namespace spirv_cross
 {
@@ -100,7 +96,7 @@ public:
 		Access access;
 	};
 
-	Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM]);
+	Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const ValidationReflection *prebuiltreflection);
 	virtual ~Shader();
 
 	// Implements Shader.
@@ -141,7 +137,8 @@ private:
 
 	void buildLocalUniforms(const spirv_cross::CompilerMSL &msl, const spirv_cross::SPIRType &type, size_t baseoffset, const std::string &basename);
 	void addImage(const spirv_cross::CompilerMSL &msl, const spirv_cross::Resource &resource, UniformType baseType);
-	void compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &program);
+	void addBuffer(const spirv_cross::CompilerMSL &msl, const spirv_cross::Resource &resource, UniformType baseType);
+	void compileFromSPIRV(id<MTLDevice> device, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]);
 
 	id<MTLFunction> functions[SHADERSTAGE_MAX_ENUM];
 
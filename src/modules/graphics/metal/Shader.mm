@@ -249,16 +249,8 @@ static EShLanguage getGLSLangStage(ShaderStageType stage)
 	return EShLangCount;
 }
 
-Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM])
-	: love::graphics::Shader(stages)
-	, functions()
-	, builtinUniformInfo()
-	, localUniformStagingData(nullptr)
-	, localUniformBufferData(nullptr)
-	, localUniformBufferSize(0)
-	, builtinUniformDataOffset(0)
-	, firstVertexBufferBinding(DEFAULT_VERTEX_BUFFER_BINDING + 1)
-{ @autoreleasepool {
+static void compileToSPIRV(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM])
+{
 	using namespace glslang;
 
 	TShader *glslangShaders[SHADERSTAGE_MAX_ENUM] = {};
@@ -343,17 +335,54 @@ Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stag
 		throw love::Exception("mapIO failed");
 	}
 
-	try
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		compileFromGLSLang(device, *program);
+		auto intermediate = program->getIntermediate(getGLSLangStage((ShaderStageType) i));
+		if (intermediate == nullptr)
+			continue;
+
+		spv::SpvBuildLogger logger;
+		glslang::SpvOptions opt;
+		opt.validate = true;
+
+		GlslangToSpv(*intermediate, spirv[i], &logger, &opt);
 	}
-	catch (love::Exception &)
+
+	cleanup();
+}
+
+Shader::Shader(id<MTLDevice> device, StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const ValidationReflection *prebuiltreflection)
+	: love::graphics::Shader(stages, prebuiltreflection)
+	, functions()
+	, builtinUniformInfo()
+	, localUniformStagingData(nullptr)
+	, localUniformBufferData(nullptr)
+	, localUniformBufferSize(0)
+	, builtinUniformDataOffset(0)
+	, firstVertexBufferBinding(DEFAULT_VERTEX_BUFFER_BINDING + 1)
+{ @autoreleasepool {
+	// Stages from a ShaderBundle already have SPIR-V, so glslang isn't needed.
+	bool prebuilt = true;
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		cleanup();
-		throw;
+		if (stages[i] && !stages[i]->isPrebuilt())
+			prebuilt = false;
 	}
 
-	cleanup();
+	std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM];
+
+	if (prebuilt)
+	{
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			if (stages[i])
+				spirv[i] = stages[i]->getPrebuiltSPIRV();
+		}
+	}
+	else
+		compileToSPIRV(stages, spirv);
+
+	compileFromSPIRV(device, spirv);
 
 	if (functions[SHADERSTAGE_COMPUTE] != nil)
 	{
@@ -455,6 +484,38 @@ void Shader::buildLocalUniforms(const spirv_cross::CompilerMSL &msl, const spirv
 	}
 }
 
+void Shader::addBuffer(const spirv_cross::CompilerMSL &msl, const spirv_cross::Resource &resource, UniformType baseType)
+{
+	using namespace spirv_cross;
+
+	auto it = uniforms.find(resource.name);
+	if (it != uniforms.end())
+		return;
+
+	const SPIRType &type = msl.get_type(resource.type_id);
+
+	UniformInfo u = {};
+	u.baseType = baseType;
+	u.components = 1;
+	u.name = resource.name;
+	u.count = type.array.empty() ? 1 : type.array[0];
+
+	if (!fillUniformReflectionData(u))
+		return;
+
+	u.buffers = new love::graphics::Buffer*[u.count];
+	u.dataSize = sizeof(int) * u.count;
+	u.data = malloc(u.dataSize);
+
+	for (int i = 0; i < u.count; i++)
+	{
+		u.ints[i] = -1; // Initialized after compiling.
+		u.buffers[i] = nullptr;
+	}
+
+	uniforms[u.name] = u;
+}
+
 void Shader::addImage(const spirv_cross::CompilerMSL &msl, const spirv_cross::Resource &resource, UniformType baseType)
 {
 	using namespace spirv_cross;
@@ -549,7 +610,7 @@ void Shader::addImage(const spirv_cross::CompilerMSL &msl, const spirv_cross::Re
 		builtinUniformInfo[builtin] = &uniforms[u.name];
 }
 
-void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &program)
+void Shader::compileFromSPIRV(id<MTLDevice> device, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM])
 {
 	using namespace glslang;
 	using namespace spirv_cross;
@@ -564,26 +625,14 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 
 	for (int stageindex = 0; stageindex < SHADERSTAGE_MAX_ENUM; stageindex++)
 	{
-		auto glslangstage = getGLSLangStage((ShaderStageType) stageindex);
-		auto intermediate = program.getIntermediate(glslangstage);
-		if (intermediate == nullptr)
+		if (spirv[stageindex].empty())
 			continue;
 
-		spv::SpvBuildLogger logger;
-		glslang::SpvOptions opt;
-		opt.validate = true;
-
-		std::vector<unsigned int> spirv;
-		GlslangToSpv(*intermediate, spirv, &logger, &opt);
-
-		std::string msgs = logger.getAllMessages();
-//		printf("spirv length: %ld, messages:\n%s\n", spirv.size(), msgs.c_str());
-
 		try
 		{
 //			printf("GLSL INPUT SOURCE:\n\n%s\n\n", pixel->getSource().c_str());
 
-			CompilerMSL msl(std::move(spirv));
+			CompilerMSL msl(std::move(spirv[stageindex]));
 
 			auto interfacevars = msl.get_active_interface_variables();
 
@@ -637,6 +686,8 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 				{
 					binding.msl_buffer = metalBufferIndices[stageindex]++;
 					msl.add_msl_resource_binding(binding);
+
+					addBuffer(msl, resource, UNIFORM_UNIFORMBUFFER);
 				}
 			}
 
@@ -649,32 +700,7 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 				binding.msl_buffer = metalBufferIndices[stageindex]++;
 				msl.add_msl_resource_binding(binding);
 
-				auto it = uniforms.find(resource.name);
-				if (it != uniforms.end())
-					continue;
-
-				const SPIRType &type = msl.get_type(resource.type_id);
-
-				UniformInfo u = {};
-				u.baseType = UNIFORM_STORAGEBUFFER;
-				u.components = 1;
-				u.name = resource.name;
-				u.count = type.array.empty() ? 1 : type.array[0];
-
-				if (!fillUniformReflectionData(u))
-					continue;
-
-				u.buffers = new love::graphics::Buffer*[u.count];
-				u.dataSize = sizeof(int) * u.count;
-				u.data = malloc(u.dataSize);
-
-				for (int i = 0; i < u.count; i++)
-				{
-					u.ints[i] = -1; // Initialized below, after compiling.
-					u.buffers[i] = nullptr; // TODO
-				}
-
-				uniforms[u.name] = u;
+				addBuffer(msl, resource, UNIFORM_STORAGEBUFFER);
 			}
 
 			if (stageindex == SHADERSTAGE_VERTEX)
@@ -812,17 +838,17 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 				setTextureBinding(msl, stageindex, resource);
 			}
 
-			for (const auto &resource : resources.storage_buffers)
+			auto setBufferBinding = [this](CompilerMSL &msl, int stageindex, const spirv_cross::Resource &resource) -> void
 			{
 				auto it = uniforms.find(resource.name);
 				if (it == uniforms.end())
-					continue;
+					return;
 
 				UniformInfo &u = it->second;
 
 				uint32 bufferbinding = msl.get_automatic_msl_resource_binding(resource.id);
 				if (bufferbinding == (uint32)-1)
-					continue;
+					return;
 
 				for (int i = 0; i < u.count; i++)
 				{
@@ -840,6 +866,17 @@ void Shader::compileFromGLSLang(id<MTLDevice> device, const glslang::TProgram &p
 
 					bufferBindings[u.ints[i]].stages[stageindex] = (uint8) bufferbinding;
 				}
+			};
+
+			for (const auto &resource : resources.uniform_buffers)
+			{
+				if (resource.name != "gl_DefaultUniformBlock")
+					setBufferBinding(msl, stageindex, resource);
+			}
+
+			for (const auto &resource : resources.storage_buffers)
+			{
+				setBufferBinding(msl, stageindex, resource);
 			}
 		}
 		catch (std::exception &e)
@@ -874,7 +911,7 @@ Shader::~Shader()
 			}
 			delete[] u.textures;
 		}
-		else if (u.baseType == UNIFORM_TEXELBUFFER || u.baseType == UNIFORM_STORAGEBUFFER)
+		else if (u.baseType == UNIFORM_TEXELBUFFER || u.baseType == UNIFORM_STORAGEBUFFER || u.baseType == UNIFORM_UNIFORMBUFFER)
 		{
 			free(u.data);
 			for (int i = 0; i < u.count; i++)
@@ -1001,7 +1038,7 @@ void Shader::sendTextures(const UniformInfo *info, love::graphics::Texture **tex
 void Shader::sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffers, int count)
 {
 	bool texelbinding = info->baseType == UNIFORM_TEXELBUFFER;
-	bool storagebinding = info->baseType == UNIFORM_STORAGEBUFFER;
+	bool storagebinding = info->baseType == UNIFORM_STORAGEBUFFER || info->baseType == UNIFORM_UNIFORMBUFFER;
 
 	if (!texelbinding && !storagebinding)
 		return;
@@ -1172,6 +1209,9 @@ id<MTLRenderPipelineState> Shader::getCachedRenderPipeline(const RenderPipelineK
 
 	desc.vertexDescriptor = vertdesc;
 
+	Graphics *gfx = Graphics::getInstance();
+	gfx->usePipelineBinaryArchive(desc);
+
 	NSError *err = nil;
 	id<MTLRenderPipelineState> pipeline = [device newRenderPipelineStateWithDescriptor:desc error:&err];
 
@@ -1181,7 +1221,10 @@ id<MTLRenderPipelineState> Shader::getCachedRenderPipeline(const RenderPipelineK
 		return nil;
 	}
 
+	gfx->addToPipelineBinaryArchive(desc);
+
 	cachedRenderPipelines[key] = CFBridgingRetain(pipeline);
+	gfx->pipelineCreated();
 
 	return pipeline;
 }
@@ -33,7 +33,7 @@ class ShaderStage final : public love::graphics::ShaderStage
 {
 public:
 
-	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey);
+	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv);
 	virtual ~ShaderStage();
 	ptrdiff_t getHandle() const override { return 0; }
 
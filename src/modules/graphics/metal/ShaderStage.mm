@@ -29,8 +29,8 @@ namespace graphics
 namespace metal
 {
 
-ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey)
-	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
+ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv)
+	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey, prebuiltspirv)
 {
 	// Can't store anything in here since the next part of the compilation
 	// pipeline (glslang to generate spir-v) requires linking stages together
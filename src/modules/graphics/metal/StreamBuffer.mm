@@ -70,7 +70,11 @@ public:
 		// Make sure this frame's section of the buffer is done being used.
 		if (!mappedFrames[frameIndex])
 		{
-			dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			if (dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_NOW) != 0)
+			{
+				frameStalls++;
+				dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			}
 			mappedFrames[frameIndex] = true;
 		}
 
@@ -114,6 +118,7 @@ public:
 		// We insert a fence for all data from this frame at the end of the
 		// frame (in nextFrame), rather than doing anything more fine-grained.
 		frameGPUReadOffset += usedsize;
+		frameBytesUsed += usedsize;
 	}
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t)buffer; }
@@ -55,7 +55,7 @@ public:
 
 private:
 
-	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) override;
+	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength) override;
 	void generateMipmapsInternal() override;
 
 	id<MTLTexture> texture;
@@ -64,6 +64,10 @@ private:
 
 	int actualMSAASamples;
 
+	// Whether the MTLTextures can be reused by new Textures once this one is
+	// destroyed.
+	bool recyclable;
+
 }; // Texture
 
 } // metal
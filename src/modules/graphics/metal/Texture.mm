@@ -47,6 +47,7 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	, msaaTexture(nil)
 	, sampler(nil)
 	, actualMSAASamples(1)
+	, recyclable(false)
 { @autoreleasepool {
 	auto gfx = (Graphics *) gfxbase;
 
@@ -74,6 +75,21 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 
 	desc.storageMode = MTLStorageModePrivate;
 
+	// Memoryless textures live entirely in tile memory, which is only
+	// available on Apple GPUs.
+	if (memoryless)
+	{
+#ifdef LOVE_IOS
+		desc.storageMode = MTLStorageModeMemoryless;
+#else
+		if (@available(macOS 11.0, *))
+		{
+			if ([device supportsFamily:MTLGPUFamilyApple1])
+				desc.storageMode = MTLStorageModeMemoryless;
+		}
+#endif
+	}
+
 	if (readable)
 		desc.usage |= MTLTextureUsageShaderRead;
 	if (renderTarget)
@@ -81,7 +97,14 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	if (computeWrite)
 		desc.usage |= MTLTextureUsageShaderWrite;
 
-	texture = [device newTextureWithDescriptor:desc];
+	// Swizzles aren't part of what's compared when reusing textures.
+	recyclable = !memoryless && !formatdesc.swizzled;
+
+	if (recyclable)
+		texture = gfx->takeRecycledTexture(desc);
+
+	if (texture == nil)
+		texture = [device newTextureWithDescriptor:desc];
 
 	if (texture == nil)
 		throw love::Exception("Out of graphics memory.");
@@ -94,7 +117,12 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 		desc.textureType = getMTLTextureType(texType, actualMSAASamples);
 		desc.usage &= ~MTLTextureUsageShaderRead;
 
-		msaaTexture = [device newTextureWithDescriptor:desc];
+		if (recyclable)
+			msaaTexture = gfx->takeRecycledTexture(desc);
+
+		if (msaaTexture == nil)
+			msaaTexture = [device newTextureWithDescriptor:desc];
+
 		if (msaaTexture == nil)
 		{
 			texture = nil;
@@ -102,7 +130,9 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 		}
 	}
 
-	int mipcount = getMipmapCount();
+	// Memoryless textures have no contents outside of a render pass, so
+	// there's nothing to initialize.
+	int mipcount = memoryless ? 0 : getMipmapCount();
 
 	bool cangeneratemips = true;
 
@@ -143,7 +173,7 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 					emptydata.resize(getPixelFormatSliceSize(format, w, h));
 
 				Rect r = {0, 0, getPixelWidth(mip), getPixelHeight(mip)};
-				uploadByteData(format, emptydata.data(), emptydata.size(), mip, slice, r);
+				uploadByteData(format, emptydata.data(), emptydata.size(), mip, slice, r, r.w);
 			}
 			else if (isRenderTarget())
 			{
@@ -208,17 +238,40 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 
 Texture::~Texture()
 { @autoreleasepool {
+	auto gfx = Graphics::getInstance();
+
+	if (gfx != nullptr && recyclable)
+	{
+		if (texture != nil)
+			gfx->recycleTexture(texture);
+		if (msaaTexture != nil)
+			gfx->recycleTexture(msaaTexture);
+	}
+
 	texture = nil;
 	msaaTexture = nil;
 	sampler = nil;
 }}
 
-void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength)
 { @autoreleasepool {
 	auto gfx = Graphics::getInstance();
-	id<MTLBuffer> buffer = [gfx->device newBufferWithBytes:data
-													length:size
-												   options:MTLResourceStorageModeShared];
+
+	size_t rowSize = 0;
+	if (isCompressed())
+		rowSize = getPixelFormatCompressedBlockRowSize(format, r.w);
+	else
+		rowSize = getPixelFormatUncompressedRowSize(format, rowlength);
+
+	// TODO: Verify this is correct for compressed formats at small sizes.
+	size_t sliceSize = getPixelFormatSliceSize(format, r.w, r.h);
+	if (rowlength != r.w)
+		sliceSize = rowSize * r.h;
+
+	// Data with a longer row length ends at the rectangle's last pixel, so the
+	// buffer is padded to a whole number of rows.
+	id<MTLBuffer> buffer = [gfx->device newBufferWithLength:std::max(size, sliceSize)
+													options:MTLResourceStorageModeShared];
 
 	memcpy(buffer.contents, data, size);
 
@@ -246,15 +299,6 @@ void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t s
 		break;
 	}
 
-	size_t rowSize = 0;
-	if (isCompressed())
-		rowSize = getPixelFormatCompressedBlockRowSize(format, r.w);
-	else
-		rowSize = getPixelFormatUncompressedRowSize(format, r.w);
-
-	// TODO: Verify this is correct for compressed formats at small sizes.
-	size_t sliceSize = getPixelFormatSliceSize(format, r.w, r.h);
-
 	[encoder copyFromBuffer:buffer
 			   sourceOffset:0
 		  sourceBytesPerRow:rowSize
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TimerQuery.h"
+#include "Graphics.h"
+
+namespace love::graphics::metal
+{
+
+TimerQuery::TimerQuery(love::graphics::Graphics *gfx)
+	: love::graphics::TimerQuery(gfx)
+	, generation(0)
+	, results(std::make_shared<Results>())
+{
+	for (int i = 0; i < 2; i++)
+	{
+		results->generation[i] = 0;
+		results->times[i] = 0.0;
+	}
+}
+
+TimerQuery::~TimerQuery()
+{
+}
+
+void TimerQuery::timestamp(Timestamp t)
+{ @autoreleasepool {
+	auto mgfx = (Graphics *) gfx;
+
+	if (t == TIMESTAMP_START)
+	{
+		generation++;
+
+		// Commands before this point go in a separate command buffer.
+		mgfx->submitCommandBuffer(Graphics::SUBMIT_STORE);
+	}
+
+	id<MTLCommandBuffer> cmd = mgfx->useCommandBuffer();
+
+	auto r = results;
+	uint64 gen = generation;
+
+	[cmd addCompletedHandler:^(id<MTLCommandBuffer> _Nonnull buffer)
+	{
+		if (@available(macOS 10.15, iOS 10.3, *))
+			r->times[t] = t == TIMESTAMP_START ? buffer.GPUStartTime : buffer.GPUEndTime;
+		r->generation[t] = gen;
+	}];
+
+	if (t == TIMESTAMP_STOP)
+		mgfx->submitCommandBuffer(Graphics::SUBMIT_STORE);
+}}
+
+bool TimerQuery::getTimestamps(uint64 &startns, uint64 &stopns)
+{
+	if (results->generation[TIMESTAMP_START] != generation || results->generation[TIMESTAMP_STOP] != generation)
+		return false;
+
+	startns = (uint64) (results->times[TIMESTAMP_START] * 1000000000.0);
+	stopns = (uint64) (results->times[TIMESTAMP_STOP] * 1000000000.0);
+
+	return true;
+}
+
+} // love::graphics::metal
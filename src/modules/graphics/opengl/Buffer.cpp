@@ -78,8 +78,12 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 		mapUsage = BUFFERUSAGE_VERTEX;
 	else if (usageFlags & BUFFERUSAGEFLAG_INDEX)
 		mapUsage = BUFFERUSAGE_INDEX;
+	else if (usageFlags & BUFFERUSAGEFLAG_UNIFORM)
+		mapUsage = BUFFERUSAGE_UNIFORM;
 	else  if (usageFlags & BUFFERUSAGEFLAG_SHADER_STORAGE)
 		mapUsage = BUFFERUSAGE_SHADER_STORAGE;
+	else if (usageFlags & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS)
+		mapUsage = BUFFERUSAGE_INDIRECT_ARGUMENTS;
 
 	target = OpenGL::getGLBufferType(mapUsage);
 
@@ -124,9 +128,16 @@ bool Buffer::loadVolatile()
 
 void Buffer::unloadVolatile()
 {
-	mapped = false;
 	if (buffer != 0)
-		gl.deleteBuffer(buffer);
+	{
+		// Texel buffers have a texture view tied to their buffer object.
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr && !mapped && texture == 0)
+			gfx->recycleBuffer(buffer, OpenGL::getGLBufferDataUsage(getDataUsage()), getSize());
+		else
+			gl.deleteBuffer(buffer);
+	}
+	mapped = false;
 	buffer = 0;
 	if (texture != 0)
 		gl.deleteTexture(texture);
@@ -138,13 +149,27 @@ bool Buffer::load(const void *initialdata)
 	while (glGetError() != GL_NO_ERROR)
 		/* Clear the error buffer. */;
 
-	glGenBuffers(1, &buffer);
-	gl.bindBuffer(mapUsage, buffer);
-
 	GLenum gldatausage = OpenGL::getGLBufferDataUsage(getDataUsage());
 
-	// initialdata can be null.
-	glBufferData(target, (GLsizeiptr) getSize(), initialdata, gldatausage);
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && (getUsageFlags() & BUFFERUSAGEFLAG_TEXEL) == 0)
+		buffer = gfx->takeRecycledBuffer(gldatausage, getSize());
+
+	if (buffer != 0)
+	{
+		// The recycled buffer already has storage of the right size.
+		gl.bindBuffer(mapUsage, buffer);
+		if (initialdata != nullptr)
+			glBufferSubData(target, 0, (GLsizeiptr) getSize(), initialdata);
+	}
+	else
+	{
+		glGenBuffers(1, &buffer);
+		gl.bindBuffer(mapUsage, buffer);
+
+		// initialdata can be null.
+		glBufferData(target, (GLsizeiptr) getSize(), initialdata, gldatausage);
+	}
 
 	if (getUsageFlags() & BUFFERUSAGEFLAG_TEXEL)
 	{
@@ -169,7 +194,7 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 	if (size == 0)
 		return nullptr;
 
-	if (map == MAP_WRITE_INVALIDATE && (isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK))
+	if (map != MAP_READ_ONLY && (isImmutable() || dataUsage == BUFFERDATAUSAGE_READBACK))
 		return nullptr;
 
 	if (map == MAP_READ_ONLY && dataUsage != BUFFERDATAUSAGE_READBACK)
@@ -191,13 +216,23 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 		else if (GLAD_VERSION_1_1)
 			data = (char *) glMapBuffer(target, GL_READ_ONLY) + offset;
 	}
-	else if (ownsMemoryMap)
+	else if (map == MAP_WRITE_UNSYNCHRONIZED && (GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0))
+	{
+		// Write straight into the GL buffer. Only the range passed to unmap is
+		// flushed.
+		gl.bindBuffer(mapUsage, buffer);
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+		data = (char *) glMapBufferRange(target, offset, size, access);
+		directMapped = data != nullptr;
+	}
+
+	if (data == nullptr && map != MAP_READ_ONLY && ownsMemoryMap)
 	{
 		if (memoryMap == nullptr)
 			memoryMap = (char *) malloc(getSize());
 		data = memoryMap;
 	}
-	else
+	else if (data == nullptr && map != MAP_READ_ONLY)
 	{
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 		data = (char *) gfx->getBufferMapMemory(size);
@@ -224,6 +259,18 @@ void Buffer::unmap(size_t usedoffset, size_t usedsize)
 
 	mapped = false;
 
+	if (directMapped)
+	{
+		gl.bindBuffer(mapUsage, buffer);
+		if (usedsize > 0)
+			glFlushMappedBufferRange(target, usedoffset - mappedRange.getOffset(), usedsize);
+		glUnmapBuffer(target);
+		directMapped = false;
+		if (!ownsMemoryMap)
+			memoryMap = nullptr;
+		return;
+	}
+
 	if (mappedType == MAP_READ_ONLY)
 	{
 		gl.bindBuffer(mapUsage, buffer);
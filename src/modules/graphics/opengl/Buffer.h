@@ -78,6 +78,9 @@ private:
 	char *memoryMap = nullptr;
 	bool ownsMemoryMap = false;
 
+	// Whether the current map points directly at GL buffer memory.
+	bool directMapped = false;
+
 	Range mappedRange;
 
 }; // Buffer
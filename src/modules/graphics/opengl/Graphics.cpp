@@ -22,11 +22,14 @@
 #include "common/config.h"
 #include "common/math.h"
 #include "common/Vector.h"
+#include "common/Trace.h"
 
 #include "Graphics.h"
 #include "font/Font.h"
 #include "StreamBuffer.h"
 #include "GraphicsReadback.h"
+#include "TimerQuery.h"
+#include "OcclusionQuery.h"
 #include "math/MathModule.h"
 #include "window/Window.h"
 #include "Buffer.h"
@@ -48,6 +51,19 @@
 #include <SDL_syswm.h>
 #endif
 
+#ifdef LOVE_ENABLE_TRACY
+// TracyOpenGL.hpp calls GL functions unqualified from its own namespace.
+namespace tracy { using namespace glad; }
+#include <tracy/TracyOpenGL.hpp>
+
+// Tracy's GPU zones use timestamp queries, which OpenGL ES doesn't have.
+static bool tracyGPUZonesActive = false;
+
+#define LOVE_GPU_ZONE(name) TracyGpuNamedZone(LOVE_TRACE_CONCAT(love_gpu_zone_, __LINE__), name, tracyGPUZonesActive)
+#else
+#define LOVE_GPU_ZONE(name)
+#endif
+
 namespace love
 {
 namespace graphics
@@ -114,6 +130,7 @@ Graphics::Graphics()
 	, bufferMapMemorySize(2 * 1024 * 1024)
 	, defaultBuffers()
 	, pixelFormatUsage()
+	, frameFenceIndex(0)
 {
 	gl = OpenGL();
 
@@ -163,14 +180,14 @@ love::graphics::Texture *Graphics::newTexture(const Texture::Settings &settings,
 	return new Texture(this, settings, data);
 }
 
-love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles)
+love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv)
 {
-	return new ShaderStage(this, stage, source, gles, cachekey);
+	return new ShaderStage(this, stage, source, gles, cachekey, prebuiltspirv);
 }
 
-love::graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM])
+love::graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection)
 {
-	return new Shader(stages);
+	return new Shader(stages, prebuiltreflection);
 }
 
 love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength)
@@ -178,6 +195,16 @@ love::graphics::Buffer *Graphics::newBuffer(const Buffer::Settings &settings, co
 	return new Buffer(this, settings, format, data, size, arraylength);
 }
 
+love::graphics::TimerQuery *Graphics::newTimerQuery()
+{
+	return new TimerQuery(this);
+}
+
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery(bool precise)
+{
+	return new OcclusionQuery(this, precise);
+}
+
 love::graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
@@ -311,7 +338,8 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 	// Okay, setup OpenGL.
 	gl.initContext();
 
-	if (gl.isCoreProfile())
+	// Indirect draws in OpenGL ES also need a non-zero VAO to be bound.
+	if (gl.isCoreProfile() || GLAD_ES_VERSION_3_1)
 	{
 		glGenVertexArrays(1, &mainVAO);
 		glBindVertexArray(mainVAO);
@@ -319,6 +347,16 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 
 	gl.setupContext();
 
+#ifdef LOVE_ENABLE_TRACY
+	// Tracy has no way to destroy an OpenGL context, so a previous one is
+	// abandoned along with its GL context when the window is recreated.
+	tracyGPUZonesActive = GLAD_VERSION_3_3 || GLAD_ARB_timer_query;
+	if (tracyGPUZonesActive)
+	{
+		TracyGpuContext;
+	}
+#endif
+
 	created = true;
 	initCapabilities();
 
@@ -421,6 +459,8 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 	// Restore the graphics state.
 	restoreState(states.back());
 
+	LOVE_TRACE_STARTUP_STAGE("default shaders");
+
 	// We always need a default shader.
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
@@ -429,6 +469,14 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 		if (i == Shader::STANDARD_ARRAY && !capabilities.textureTypes[TEXTURE_2D_ARRAY])
 			continue;
 
+		if (i == Shader::STANDARD_ARRAY_SPRITES && !capabilities.textureTypes[TEXTURE_2D_ARRAY])
+			continue;
+
+		bool instancedshader = i == Shader::STANDARD_SHAPES || i == Shader::STANDARD_SPRITES || i == Shader::STANDARD_ARRAY_SPRITES;
+
+		if (instancedshader && !capabilities.features[FEATURE_INSTANCING])
+			continue;
+
 		// Apparently some intel GMA drivers on windows fail to compile shaders
 		// which use array textures despite claiming support for the extension.
 		try
@@ -446,7 +494,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 		{
 			if (i == Shader::STANDARD_ARRAY)
 				capabilities.textureTypes[TEXTURE_2D_ARRAY] = false;
-			else
+			else if (!instancedshader && i != Shader::STANDARD_SKINNED) // Shapes, sprites and skinning are optional.
 				throw;
 		}
 	}
@@ -474,6 +522,10 @@ void Graphics::unSetMode()
 	Volatile::unloadAll();
 
 	clearTemporaryResources();
+	clearRecycledResources();
+
+	for (FenceSync &fence : frameFences)
+		fence.cleanup();
 
 	for (const auto &pair : framebufferObjects)
 		gl.deleteFramebuffer(pair.second);
@@ -527,6 +579,9 @@ static bool computeDispatchBarriers(Shader *shader, GLbitfield &preDispatchBarri
 		if (usage & BUFFERUSAGEFLAG_INDEX)
 			postDispatchBarriers |= GL_ELEMENT_ARRAY_BARRIER_BIT;
 
+		if (usage & BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS)
+			postDispatchBarriers |= GL_COMMAND_BARRIER_BIT;
+
 		if (usage & BUFFERUSAGEFLAG_VERTEX)
 			postDispatchBarriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
 
@@ -574,7 +629,10 @@ bool Graphics::dispatch(int x, int y, int z)
 	if (preDispatchBarriers != 0)
 		glMemoryBarrier(preDispatchBarriers);
 
-	glDispatchCompute(x, y, z);
+	{
+		LOVE_GPU_ZONE("Graphics::dispatch");
+		glDispatchCompute(x, y, z);
+	}
 
 	// Not as (theoretically) efficient as issuing the barrier right before
 	// they're used later, but much less complicated.
@@ -586,6 +644,8 @@ bool Graphics::dispatch(int x, int y, int z)
 
 void Graphics::draw(const DrawCommand &cmd)
 {
+	LOVE_GPU_ZONE("Graphics::draw");
+
 	gl.prepareDraw(this);
 	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
@@ -593,16 +653,42 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	GLenum glprimitivetype = OpenGL::getGLPrimitiveType(cmd.primitiveType);
 
-	if (cmd.instanceCount > 1)
+	if (cmd.indirectBuffer != nullptr)
+	{
+		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+		{
+			glMultiDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, 0);
+			++drawCalls;
+		}
+		else
+		{
+			size_t offset = cmd.indirectBufferOffset;
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+			{
+				glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(offset));
+				offset += sizeof(DrawIndirectArguments);
+				++drawCalls;
+			}
+		}
+	}
+	else if (cmd.instanceCount > 1)
+	{
 		glDrawArraysInstanced(glprimitivetype, cmd.vertexStart, cmd.vertexCount, cmd.instanceCount);
+		++drawCalls;
+	}
 	else
+	{
 		glDrawArrays(glprimitivetype, cmd.vertexStart, cmd.vertexCount);
-
-	++drawCalls;
+		++drawCalls;
+	}
 }
 
 void Graphics::draw(const DrawIndexedCommand &cmd)
 {
+	LOVE_GPU_ZONE("Graphics::draw");
+
 	gl.prepareDraw(this);
 	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
@@ -614,12 +700,38 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 
 	gl.bindBuffer(BUFFERUSAGE_INDEX, cmd.indexBuffer->getHandle());
 
-	if (cmd.instanceCount > 1)
+	if (cmd.indirectBuffer != nullptr)
+	{
+		// The first index in the arguments is relative to the start of the
+		// index buffer, so indexBufferOffset isn't used here.
+		gl.bindBuffer(BUFFERUSAGE_INDIRECT_ARGUMENTS, (GLuint) cmd.indirectBuffer->getHandle());
+
+		if (cmd.indirectDrawCount > 1 && gl.isMultiDrawIndirectSupported())
+		{
+			glMultiDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(cmd.indirectBufferOffset), cmd.indirectDrawCount, 0);
+			++drawCalls;
+		}
+		else
+		{
+			size_t offset = cmd.indirectBufferOffset;
+			for (int i = 0; i < cmd.indirectDrawCount; i++)
+			{
+				glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(offset));
+				offset += sizeof(DrawIndexedIndirectArguments);
+				++drawCalls;
+			}
+		}
+	}
+	else if (cmd.instanceCount > 1)
+	{
 		glDrawElementsInstanced(glprimitivetype, cmd.indexCount, gldatatype, gloffset, cmd.instanceCount);
+		++drawCalls;
+	}
 	else
+	{
 		glDrawElements(glprimitivetype, cmd.indexCount, gldatatype, gloffset);
-
-	++drawCalls;
+		++drawCalls;
+	}
 }
 
 static inline void advanceVertexOffsets(const VertexAttributes &attributes, BufferBindings &buffers, int vertexcount)
@@ -650,6 +762,8 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 	const int MAX_VERTICES_PER_DRAW = LOVE_UINT16_MAX;
 	const int MAX_QUADS_PER_DRAW    = MAX_VERTICES_PER_DRAW / 4;
 
+	LOVE_GPU_ZONE("Graphics::drawQuads");
+
 	gl.prepareDraw(this);
 	gl.bindTextureToUnit(texture, 0, false);
 	gl.setCullMode(CULL_NONE);
@@ -800,13 +914,26 @@ void Graphics::endPass(bool presenting)
 	love::graphics::Texture *depthstencil = rts.depthStencil.texture.get();
 
 	// Discard the depth/stencil buffer if we're using an internal cached one,
-	// or if we're presenting the backbuffer to the display.
-	if ((depthstencil == nullptr && (rts.temporaryRTFlags & (TEMPORARY_RT_DEPTH | TEMPORARY_RT_STENCIL)) != 0)
-		|| (presenting && !rts.getFirstTarget().texture.get()))
+	// or if we're presenting the backbuffer to the display. Memoryless render
+	// targets are discarded too, which lets tile-based GPUs skip writing them
+	// back to memory.
+	bool discarddepthstencil = (depthstencil == nullptr && (rts.temporaryRTFlags & (TEMPORARY_RT_DEPTH | TEMPORARY_RT_STENCIL)) != 0)
+		|| (depthstencil != nullptr && depthstencil->isMemoryless())
+		|| (depthstencil != nullptr && (rts.passFlags & RENDER_PASS_DONT_STORE_DEPTH_STENCIL) != 0)
+		|| (presenting && !rts.getFirstTarget().texture.get());
+
+	std::vector<bool> discardcolors(rts.colors.size(), false);
+	bool discardcolor = false;
+
+	for (size_t i = 0; i < rts.colors.size(); i++)
 	{
-		discard({}, true);
+		discardcolors[i] = rts.colors[i].texture->isMemoryless();
+		discardcolor = discardcolor || discardcolors[i];
 	}
 
+	if (discarddepthstencil || discardcolor)
+		discard(discardcolors, discarddepthstencil);
+
 	// Resolve MSAA buffers. MSAA is only supported for 2D render targets so we
 	// don't have to worry about resolving to slices.
 	if (rts.colors.size() > 0 && rts.colors[0].texture->getMSAA() > 1)
@@ -1217,6 +1344,8 @@ GLuint Graphics::bindCachedFBO(const RenderTargets &targets)
 
 void Graphics::present(void *screenshotCallbackData)
 {
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (!isActive())
 		return;
 
@@ -1229,6 +1358,8 @@ void Graphics::present(void *screenshotCallbackData)
 
 	endPass(true);
 
+	LOVE_GPU_ZONE("Graphics::present");
+
 	int w = getPixelWidth();
 	int h = getPixelHeight();
 
@@ -1260,21 +1391,25 @@ void Graphics::present(void *screenshotCallbackData)
 		size_t row = 4 * w;
 		size_t size = row * h;
 
-		GLubyte *pixels = nullptr;
-		GLubyte *screenshot = nullptr;
+		// The pixels are read straight into a (usually pooled) ImageData.
+		StrongRef<image::ImageData> img;
+		std::vector<GLubyte> temprow;
 
 		try
 		{
-			pixels = new GLubyte[size];
-			screenshot = new GLubyte[size];
+			img.set(newScreenshotImageData(w, h, nullptr), Acquire::NORETAIN);
+			temprow.resize(row);
 		}
 		catch (std::exception &)
 		{
-			delete[] pixels;
-			delete[] screenshot;
+			for (const auto &info : pendingScreenshotCallbacks)
+				info.callback(&info, nullptr, nullptr);
+			pendingScreenshotCallbacks.clear();
 			throw love::Exception("Out of memory.");
 		}
 
+		GLubyte *pixels = (GLubyte *) img->getData();
+
 		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getSystemBackbufferFBO());
 		glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
@@ -1282,45 +1417,22 @@ void Graphics::present(void *screenshotCallbackData)
 		for (size_t i = 3; i < size; i += 4)
 			pixels[i] = 255;
 
-		// OpenGL sucks and reads pixels from the lower-left. Let's fix that.
-		GLubyte *src = pixels - row;
-		GLubyte *dst = screenshot + size;
-
-		for (int i = 0; i < h; ++i)
-			memcpy(dst-=row, src+=row, row);
-
-		delete[] pixels;
-
-		auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
-
-		for (int i = 0; i < (int) pendingScreenshotCallbacks.size(); i++)
+		// OpenGL sucks and reads pixels from the lower-left. Let's fix that,
+		// in place.
+		for (int y = 0; y < h / 2; y++)
 		{
-			const auto &info = pendingScreenshotCallbacks[i];
-			image::ImageData *img = nullptr;
+			GLubyte *top = pixels + y * row;
+			GLubyte *bottom = pixels + (h - 1 - y) * row;
 
-			try
-			{
-				img = imagemodule->newImageData(w, h, PIXELFORMAT_RGBA8_UNORM, screenshot);
-			}
-			catch (love::Exception &)
-			{
-				delete[] screenshot;
-				info.callback(&info, nullptr, nullptr);
-				for (int j = i + 1; j < (int) pendingScreenshotCallbacks.size(); j++)
-				{
-					const auto &ninfo = pendingScreenshotCallbacks[j];
-					ninfo.callback(&ninfo, nullptr, nullptr);
-				}
-				pendingScreenshotCallbacks.clear();
-				throw;
-			}
-
-			info.callback(&info, img, screenshotCallbackData);
-			img->release();
+			memcpy(temprow.data(), top, row);
+			memcpy(top, bottom, row);
+			memcpy(bottom, temprow.data(), row);
 		}
 
-		delete[] screenshot;
-		pendingScreenshotCallbacks.clear();
+		std::vector<ScreenshotInfo> callbacks;
+		std::swap(callbacks, pendingScreenshotCallbacks);
+
+		callScreenshotCallbacks(callbacks, img, screenshotCallbackData);
 	}
 
 #ifdef LOVE_IOS
@@ -1331,6 +1443,8 @@ void Graphics::present(void *screenshotCallbackData)
 	glBindRenderbuffer(GL_RENDERBUFFER, info.info.uikit.colorbuffer);
 #endif
 
+	endFrameTimer();
+
 	for (StreamBuffer *buffer : batchedDrawState.vb)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
@@ -1339,16 +1453,54 @@ void Graphics::present(void *screenshotCallbackData)
 	if (window != nullptr)
 		window->swapBuffers();
 
+	waitForFrameFences();
+
+#ifdef LOVE_ENABLE_TRACY
+	if (tracyGPUZonesActive)
+	{
+		TracyGpuCollect;
+	}
+#endif
+
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getInternalBackbufferFBO());
 
 	// Reset the per-frame stat counts.
 	drawCalls = 0;
 	gl.stats.shaderSwitches = 0;
+	gl.stats.stateCalls = 0;
+	gl.stats.stateCallsSkipped = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawsCulled = 0;
+	love::graphics::StreamBuffer::frameBytesUsed = 0;
+	love::graphics::StreamBuffer::frameStalls = 0;
+	Object::resetRefCountStats();
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
+	updateRecycledResources();
+
+	beginFrameTimer();
+
+	updateTextureUploads();
+	updatePendingShaders();
+}
+
+void Graphics::waitForFrameFences()
+{
+	if (!(GLAD_VERSION_3_2 || GLAD_ARB_sync || GLAD_ES_VERSION_3_0))
+		return;
+
+	// Otherwise the driver decides how many frames can be queued, which is
+	// often more than we want for latency. In low latency mode wait for the
+	// frame which was just presented, since there's no way to wait for it to
+	// be displayed.
+	int framesago = isLowLatency() ? 0 : getFramesInFlight() - 1;
+
+	frameFences[frameFenceIndex].fence();
+	frameFences[(frameFenceIndex + MAX_FRAMES_IN_FLIGHT - framesago) % MAX_FRAMES_IN_FLIGHT].cpuWait();
+
+	frameFenceIndex = (frameFenceIndex + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -1461,10 +1613,7 @@ void Graphics::setStencilMode(StencilAction action, CompareMode compare, int val
 	GLenum glcompare = OpenGL::getGLCompareMode(getReversedCompareMode(compare));
 
 	if (enablestencil)
-	{
-		glStencilFunc(glcompare, value, readmask);
-		glStencilOp(GL_KEEP, GL_KEEP, glaction);
-	}
+		gl.setStencilFunc(glcompare, value, readmask, glaction);
 
 	if (writemask != gl.getStencilWriteMask())
 		gl.setStencilWriteMask(writemask);
@@ -1493,7 +1642,7 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 	if (depthenable)
 	{
-		glDepthFunc(OpenGL::getGLCompareMode(compare));
+		gl.setDepthFunc(OpenGL::getGLCompareMode(compare));
 		gl.setDepthWrites(write);
 	}
 }
@@ -1527,7 +1676,7 @@ void Graphics::setColorMask(ColorChannelMask mask)
 {
 	flushBatchedDraws();
 
-	glColorMask(mask.r, mask.g, mask.b, mask.a);
+	gl.setColorMask(mask);
 	states.back().colorMask = mask;
 }
 
@@ -1555,8 +1704,7 @@ void Graphics::setBlendState(const BlendState &blend)
 		GLenum dstRGB = getGLBlendFactor(blend.dstFactorRGB);
 		GLenum dstA   = getGLBlendFactor(blend.dstFactorA);
 
-		glBlendEquationSeparate(opRGB, opA);
-		glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+		gl.setBlendFunctions(opRGB, opA, srcRGB, dstRGB, srcA, dstA);
 	}
 
 	states.back().blend = blend;
@@ -1597,6 +1745,93 @@ void Graphics::releaseBufferMapMemory(void *mem)
 		free(mem);
 }
 
+GLuint Graphics::takeRecycledTexture(const RecycledTextureKey &key)
+{
+	for (size_t i = 0; i < recycledTextures.size(); i++)
+	{
+		if (recycledTextures[i].key == key)
+		{
+			GLuint texture = recycledTextures[i].texture;
+			recycledTextures[i] = recycledTextures.back();
+			recycledTextures.pop_back();
+			return texture;
+		}
+	}
+
+	return 0;
+}
+
+void Graphics::recycleTexture(GLuint texture, const RecycledTextureKey &key, int64 size)
+{
+	recycledTextures.push_back({texture, key, size, 0});
+}
+
+GLuint Graphics::takeRecycledBuffer(GLenum datausage, size_t size)
+{
+	for (size_t i = 0; i < recycledBuffers.size(); i++)
+	{
+		const RecycledBuffer &b = recycledBuffers[i];
+		if (b.dataUsage == datausage && b.size == size)
+		{
+			GLuint buffer = b.buffer;
+			recycledBuffers[i] = recycledBuffers.back();
+			recycledBuffers.pop_back();
+			return buffer;
+		}
+	}
+
+	return 0;
+}
+
+void Graphics::recycleBuffer(GLuint buffer, GLenum datausage, size_t size)
+{
+	recycledBuffers.push_back({buffer, datausage, size, 0});
+}
+
+void Graphics::updateRecycledResources()
+{
+	for (int i = (int) recycledTextures.size() - 1; i >= 0; i--)
+	{
+		auto &t = recycledTextures[i];
+		if (++t.framesSinceRecycled >= MAX_RECYCLED_RESOURCE_FRAMES)
+		{
+			gl.deleteTexture(t.texture);
+			t = recycledTextures.back();
+			recycledTextures.pop_back();
+		}
+	}
+
+	for (int i = (int) recycledBuffers.size() - 1; i >= 0; i--)
+	{
+		auto &b = recycledBuffers[i];
+		if (++b.framesSinceRecycled >= MAX_RECYCLED_RESOURCE_FRAMES)
+		{
+			gl.deleteBuffer(b.buffer);
+			b = recycledBuffers.back();
+			recycledBuffers.pop_back();
+		}
+	}
+}
+
+void Graphics::clearRecycledResources()
+{
+	for (const auto &t : recycledTextures)
+		gl.deleteTexture(t.texture);
+
+	for (const auto &b : recycledBuffers)
+		gl.deleteBuffer(b.buffer);
+
+	recycledTextures.clear();
+	recycledBuffers.clear();
+}
+
+void Graphics::defragmentMemory()
+{
+	// The driver manages the placement of GL objects, the most we can do is
+	// give it back the storage of recycled ones.
+	clearRecycledResources();
+}
+
 Renderer Graphics::getRenderer() const
 {
 	return RENDERER_OPENGL;
@@ -1637,9 +1872,25 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 	return info;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
 {
-	shaderswitches = gl.stats.shaderSwitches;
+	// OpenGL has no explicit pipeline objects, and sampler state is stored in
+	// each texture object.
+	stats.shaderSwitches = gl.stats.shaderSwitches;
+	stats.stateCalls = gl.stats.stateCalls;
+	stats.stateCallsSkipped = gl.stats.stateCallsSkipped;
+
+	// Recycled objects keep their storage without being used by anything.
+	int64 recycledmemory = 0;
+
+	for (const auto &t : recycledTextures)
+		recycledmemory += t.size;
+
+	for (const auto &b : recycledBuffers)
+		recycledmemory += (int64) b.size;
+
+	stats.gpuMemoryUnused = recycledmemory;
+	stats.gpuMemoryReserved = love::graphics::Texture::totalGraphicsMemory + love::graphics::Buffer::totalGraphicsMemory + recycledmemory;
 }
 
 void Graphics::initCapabilities()
@@ -1661,7 +1912,12 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE] = gl.isCopyBufferToTextureSupported();
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = gl.isCopyTextureToBufferSupported();
 	capabilities.features[FEATURE_COPY_RENDER_TARGET_TO_BUFFER] = gl.isCopyRenderTargetToBufferSupported();
-	static_assert(FEATURE_MAX_ENUM == 17, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_TIMER_QUERY] = gl.isTimerQuerySupported();
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = false;
+	capabilities.features[FEATURE_INDIRECT_DRAW] = gl.isIndirectDrawSupported();
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = gl.isOcclusionQuerySupported();
+	capabilities.features[FEATURE_CONDITIONAL_RENDER] = gl.isConditionalRenderSupported();
+	static_assert(FEATURE_MAX_ENUM == 22, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	capabilities.limits[LIMIT_POINT_SIZE] = gl.getMaxPointSize();
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = gl.getMax2DTextureSize();
@@ -38,6 +38,7 @@
 
 #include "Texture.h"
 #include "Shader.h"
+#include "FenceSync.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -61,6 +62,8 @@ public:
 
 	love::graphics::Texture *newTexture(const Texture::Settings &settings, const Texture::Slices *data = nullptr) override;
 	love::graphics::Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) override;
+	love::graphics::TimerQuery *newTimerQuery() override;
+	love::graphics::OcclusionQuery *newOcclusionQuery(bool precise) override;
 
 	Matrix4 computeDeviceProjection(const Matrix4 &projection, bool rendertotexture) const override;
 
@@ -110,6 +113,7 @@ public:
 	Renderer getRenderer() const override;
 	bool usesGLSLES() const override;
 	RendererInfo getRendererInfo() const override;
+	void defragmentMemory() override;
 
 	// Internal use.
 	void cleanupRenderTexture(love::graphics::Texture *texture);
@@ -117,8 +121,37 @@ public:
 	void *getBufferMapMemory(size_t size);
 	void releaseBufferMapMemory(void *mem);
 
+	/**
+	 * The GL objects of destroyed Textures and Buffers are kept around for a
+	 * while instead of being deleted right away, and new Textures and Buffers
+	 * with the same storage reuse them. Returns 0 if nothing matches.
+	 **/
+	GLuint takeRecycledTexture(const RecycledTextureKey &key);
+	void recycleTexture(GLuint texture, const RecycledTextureKey &key, int64 size);
+	GLuint takeRecycledBuffer(GLenum datausage, size_t size);
+	void recycleBuffer(GLuint buffer, GLenum datausage, size_t size);
+
 private:
 
+	struct RecycledTexture
+	{
+		GLuint texture;
+		RecycledTextureKey key;
+		int64 size;
+		int framesSinceRecycled;
+	};
+
+	struct RecycledBuffer
+	{
+		GLuint buffer;
+		GLenum dataUsage;
+		size_t size;
+		int framesSinceRecycled;
+	};
+
+	// Recycled objects which aren't reused within this many frames are deleted.
+	static const int MAX_RECYCLED_RESOURCE_FRAMES = 60;
+
 	struct CachedFBOHasher
 	{
 		size_t operator() (const RenderTargets &rts) const
@@ -138,8 +171,8 @@ private:
 		}
 	};
 
-	love::graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
-	love::graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM]) override;
+	love::graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv) override;
+	love::graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection) override;
 	love::graphics::StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) override;
 
 	love::graphics::GraphicsReadback *newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) override;
@@ -147,7 +180,7 @@ private:
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
 
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
@@ -159,6 +192,11 @@ private:
 
 	void setDebug(bool enable);
 
+	void updateRecycledResources();
+	void clearRecycledResources();
+
+	void waitForFrameFences();
+
 	uint32 computePixelFormatUsage(PixelFormat format, bool readable);
 
 	std::unordered_map<RenderTargets, GLuint, CachedFBOHasher> framebufferObjects;
@@ -173,12 +211,19 @@ private:
 	char *bufferMapMemory;
 	size_t bufferMapMemorySize;
 
+	std::vector<RecycledTexture> recycledTextures;
+	std::vector<RecycledBuffer> recycledBuffers;
+
 	// Only needed for buffer types that can be bound to shaders.
 	StrongRef<love::graphics::Buffer> defaultBuffers[BUFFERUSAGE_MAX_ENUM];
 
 	// [non-readable, readable]
 	uint32 pixelFormatUsage[PIXELFORMAT_MAX_ENUM][2];
 
+	// Signaled when the GPU finishes each of the last few frames.
+	FenceSync frameFences[MAX_FRAMES_IN_FLIGHT];
+	int frameFenceIndex;
+
 }; // Graphics
 
 } // opengl
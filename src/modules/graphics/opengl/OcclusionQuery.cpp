@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+// EXT_occlusion_query_boolean (for ES2) uses the same names with an EXT
+// suffix. Everything else has them in core.
+static bool isCoreQuery()
+{
+	return GLAD_VERSION_1_5 || GLAD_ES_VERSION_3_0;
+}
+
+OcclusionQuery::OcclusionQuery(love::graphics::Graphics *gfx, bool precise)
+	: love::graphics::OcclusionQuery(gfx, precise)
+	, query(0)
+{
+	// OpenGL ES can only tell whether any samples passed.
+	if (precise && !GLAD_VERSION_1_5)
+		throw love::Exception("Precise occlusion queries are not supported on this system.");
+
+	loadVolatile();
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	if (isRunning())
+		endQuery();
+
+	unloadVolatile();
+}
+
+bool OcclusionQuery::loadVolatile()
+{
+	if (query != 0)
+		return true;
+
+	if (isCoreQuery())
+		glGenQueries(1, &query);
+	else
+		glGenQueriesEXT(1, &query);
+
+	return true;
+}
+
+void OcclusionQuery::unloadVolatile()
+{
+	if (query == 0)
+		return;
+
+	if (isCoreQuery())
+		glDeleteQueries(1, &query);
+	else
+		glDeleteQueriesEXT(1, &query);
+
+	query = 0;
+}
+
+GLenum OcclusionQuery::getTarget() const
+{
+	if (precise)
+		return GL_SAMPLES_PASSED;
+
+	if (GLAD_VERSION_3_3 || GLAD_ARB_occlusion_query2 || GLAD_ES_VERSION_3_0 || GLAD_EXT_occlusion_query_boolean)
+		return GL_ANY_SAMPLES_PASSED;
+
+	// Still correct, the GPU just can't stop counting early.
+	return GL_SAMPLES_PASSED;
+}
+
+void OcclusionQuery::beginQuery()
+{
+	if (isCoreQuery())
+		glBeginQuery(getTarget(), query);
+	else
+		glBeginQueryEXT(getTarget(), query);
+}
+
+void OcclusionQuery::endQuery()
+{
+	if (isCoreQuery())
+		glEndQuery(getTarget());
+	else
+		glEndQueryEXT(getTarget());
+}
+
+bool OcclusionQuery::getResult(uint64 &samples)
+{
+	bool core = isCoreQuery();
+
+	GLuint available = 0;
+	if (core)
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+	else
+		glGetQueryObjectuivEXT(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+
+	if (!available)
+		return false;
+
+	GLuint result = 0;
+	if (core)
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT, &result);
+	else
+		glGetQueryObjectuivEXT(query, GL_QUERY_RESULT_EXT, &result);
+
+	samples = result;
+	return true;
+}
+
+void OcclusionQuery::beginConditionalRender()
+{
+	if (GLAD_VERSION_3_0)
+		glBeginConditionalRender(query, GL_QUERY_WAIT);
+	else
+		glBeginConditionalRenderNV(query, GL_QUERY_WAIT_NV);
+}
+
+void OcclusionQuery::endConditionalRender()
+{
+	if (GLAD_VERSION_3_0)
+		glEndConditionalRender();
+	else
+		glEndConditionalRenderNV();
+}
+
+} // opengl
+} // graphics
+} // love
@@ -27,6 +27,7 @@
 
 #include "graphics/Graphics.h"
 #include "graphics/Buffer.h"
+#include "libraries/xxHash/xxhash.h"
 
 // C++
 #include <algorithm>
@@ -96,6 +97,8 @@ OpenGL::OpenGL()
 	, contextInitialized(false)
 	, pixelShaderHighpSupported(false)
 	, baseVertexSupported(false)
+	, vertexArrayCacheSupported(false)
+	, parallelShaderCompileSupported(false)
 	, maxAnisotropy(1.0f)
 	, max2DTextureSize(0)
 	, max3DTextureSize(0)
@@ -110,6 +113,7 @@ OpenGL::OpenGL()
 	, maxSamples(1)
 	, maxTextureUnits(1)
 	, maxShaderStorageBufferBindings(0)
+	, maxUniformBufferBindings(0)
 	, maxPointSize(1)
 	, coreProfile(false)
 	, vendor(VENDOR_UNKNOWN)
@@ -203,15 +207,33 @@ void OpenGL::setupContext()
 
 	initMaxValues();
 
+	// Let the driver pick how many threads it uses to compile shaders.
+	if (parallelShaderCompileSupported)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
 	GLfloat glcolor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
 	glVertexAttrib4fv(ATTRIB_COLOR, glcolor);
 
 	GLint maxvertexattribs = 1;
 	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxvertexattribs);
 
+	clearVertexArrayCache();
+
+	state.defaultVertexArray = 0;
+	if (vertexArrayCacheSupported)
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, (GLint *) &state.defaultVertexArray);
+	state.boundVertexArray = state.defaultVertexArray;
+
+	state.constantColorValid = false;
+
 	state.enabledAttribArrays = (uint32) ((1ull << uint32(maxvertexattribs)) - 1);
 	state.instancedAttribArrays = 0;
 
+	// Make sure the first glVertexAttribPointer call for each attribute isn't
+	// skipped.
+	for (auto &pointer : state.vertexAttribPointers)
+		pointer.buffer = std::numeric_limits<GLuint>::max();
+
 	setVertexAttributes(VertexAttributes(), BufferBindings());
 
 	// Get the current viewport.
@@ -219,9 +241,26 @@ void OpenGL::setupContext()
 
 	// And the current scissor - but we need to compensate for GL scissors
 	// starting at the bottom left instead of top left.
-	glGetIntegerv(GL_SCISSOR_BOX, (GLint *) &state.scissor.x);
+	glGetIntegerv(GL_SCISSOR_BOX, (GLint *) &state.glScissor.x);
+	state.scissor = state.glScissor;
 	state.scissor.y = state.viewport.h - (state.scissor.y + state.scissor.h);
 
+	// Blend, depth and stencil state start out invalid, and take effect on
+	// the first set call which matches love's default state.
+	state.blendEquations[0] = state.blendEquations[1] = GL_NONE;
+	for (GLenum &func : state.blendFuncs)
+		func = GL_NONE;
+
+	state.colorMask = ColorChannelMask();
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+	state.depthFunc = GL_NONE;
+
+	state.stencilFunc = GL_NONE;
+	state.stencilRef = 0;
+	state.stencilReadMask = 0;
+	state.stencilPassOp = GL_NONE;
+
 	if (GLAD_VERSION_1_0)
 		glGetFloatv(GL_POINT_SIZE, &state.pointSize);
 	else
@@ -259,6 +298,9 @@ void OpenGL::setupContext()
 	if (isBufferUsageSupported(BUFFERUSAGE_SHADER_STORAGE))
 		state.boundIndexedBuffers[BUFFERUSAGE_SHADER_STORAGE].resize(maxShaderStorageBufferBindings, 0);
 
+	if (isBufferUsageSupported(BUFFERUSAGE_UNIFORM))
+		state.boundIndexedBuffers[BUFFERUSAGE_UNIFORM].resize(maxUniformBufferBindings, 0);
+
 	// Initialize multiple texture unit support for shaders.
 	for (int i = 0; i < TEXTURE_MAX_ENUM + 1; i++)
 	{
@@ -282,6 +324,17 @@ void OpenGL::setupContext()
 	glActiveTexture(GL_TEXTURE0);
 	state.curTextureUnit = 0;
 
+	state.boundSamplers.clear();
+	state.boundSamplers.resize(maxTextureUnits, 0);
+	state.samplerTextures.clear();
+	state.samplerTextures.resize(maxTextureUnits, std::numeric_limits<GLuint>::max());
+
+	if (isSamplerObjectSupported())
+	{
+		for (int i = 0; i < maxTextureUnits; i++)
+			glBindSampler(i, 0);
+	}
+
 	setDepthWrites(state.depthWritesEnabled);
 	setStencilWriteMask(state.stencilWriteMask);
 
@@ -303,6 +356,13 @@ void OpenGL::deInitContext()
 	if (!contextInitialized)
 		return;
 
+	clearVertexArrayCache();
+
+	for (const auto &kvp : samplerCache)
+		glDeleteSamplers(1, &kvp.second);
+	samplerCache.clear();
+	textureSamplers.clear();
+
 	for (int i = 0; i < TEXTURE_MAX_ENUM; i++)
 	{
 		for (int datatype = DATA_BASETYPE_FLOAT; datatype <= DATA_BASETYPE_UINT; datatype++)
@@ -400,6 +460,12 @@ void OpenGL::initOpenGLFunctions()
 			fp_glRenderbufferStorageMultisample = fp_glRenderbufferStorageMultisampleNV;
 	}
 
+	if (GLAD_EXT_multi_draw_indirect && !(GLAD_VERSION_4_3 || GLAD_ARB_multi_draw_indirect))
+	{
+		fp_glMultiDrawArraysIndirect = fp_glMultiDrawArraysIndirectEXT;
+		fp_glMultiDrawElementsIndirect = fp_glMultiDrawElementsIndirectEXT;
+	}
+
 	if (isInstancingSupported() && !(GLAD_VERSION_3_3 || GLAD_ES_VERSION_3_0))
 	{
 		if (GLAD_ARB_instanced_arrays)
@@ -466,6 +532,15 @@ void OpenGL::initOpenGLFunctions()
 
 		}
 	}
+
+	// KHR_parallel_shader_compile is the same as the ARB extension (including
+	// its enums), but glad doesn't know about it.
+	parallelShaderCompileSupported = GLAD_ARB_parallel_shader_compile;
+	if (!parallelShaderCompileSupported && SDL_GL_ExtensionSupported("GL_KHR_parallel_shader_compile"))
+	{
+		fp_glMaxShaderCompilerThreadsARB = (pfn_glMaxShaderCompilerThreadsARB) LOVEGetProcAddress("glMaxShaderCompilerThreadsKHR");
+		parallelShaderCompileSupported = fp_glMaxShaderCompilerThreadsARB != nullptr;
+	}
 }
 
 void OpenGL::initMaxValues()
@@ -483,6 +558,8 @@ void OpenGL::initMaxValues()
 	baseVertexSupported = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_2 || GLAD_ARB_draw_elements_base_vertex
 		|| GLAD_OES_draw_elements_base_vertex || GLAD_EXT_draw_elements_base_vertex;
 
+	vertexArrayCacheSupported = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0 || GLAD_ARB_vertex_array_object;
+
 	// We'll need this value to clamp anisotropy.
 	if (GLAD_EXT_texture_filter_anisotropic)
 		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
@@ -518,6 +595,11 @@ void OpenGL::initMaxValues()
 		maxShaderStorageBufferBindings = 0;
 	}
 
+	if (isBufferUsageSupported(BUFFERUSAGE_UNIFORM))
+		glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxUniformBufferBindings);
+	else
+		maxUniformBufferBindings = 0;
+
 	if (GLAD_ES_VERSION_3_1 || GLAD_VERSION_4_3)
 	{
 		glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxComputeWorkGroupsX);
@@ -666,7 +748,9 @@ GLenum OpenGL::getGLBufferType(BufferUsage usage)
 		case BUFFERUSAGE_VERTEX: return GL_ARRAY_BUFFER;
 		case BUFFERUSAGE_INDEX: return GL_ELEMENT_ARRAY_BUFFER;
 		case BUFFERUSAGE_TEXEL: return GL_TEXTURE_BUFFER;
+		case BUFFERUSAGE_UNIFORM: return GL_UNIFORM_BUFFER;
 		case BUFFERUSAGE_SHADER_STORAGE: return GL_SHADER_STORAGE_BUFFER;
+		case BUFFERUSAGE_INDIRECT_ARGUMENTS: return GL_DRAW_INDIRECT_BUFFER;
 		case BUFFERUSAGE_MAX_ENUM: return GL_ZERO;
 	}
 
@@ -855,7 +939,10 @@ void OpenGL::bindBuffer(BufferUsage type, GLuint buffer)
 	{
 		glBindBuffer(getGLBufferType(type), buffer);
 		state.boundBuffers[type] = buffer;
+		++stats.stateCalls;
 	}
+	else
+		++stats.stateCallsSkipped;
 }
 
 void OpenGL::deleteBuffer(GLuint buffer)
@@ -873,10 +960,195 @@ void OpenGL::deleteBuffer(GLuint buffer)
 				bufferid = 0;
 		}
 	}
+
+	// The name can be reused by a new buffer, which needs the attribute
+	// pointer to be set again.
+	for (auto &pointer : state.vertexAttribPointers)
+	{
+		if (pointer.buffer == buffer)
+			pointer.buffer = std::numeric_limits<GLuint>::max();
+	}
+
+	for (auto it = vertexArrayCache.begin(); it != vertexArrayCache.end(); )
+	{
+		const VertexArrayKey &key = it->second.key;
+		bool referenced = false;
+
+		for (uint32 i = 0; i < VertexAttributes::MAX; i++)
+		{
+			if ((key.enableBits & (1u << i)) && key.attribs[i].buffer == buffer)
+			{
+				referenced = true;
+				break;
+			}
+		}
+
+		if (referenced)
+		{
+			if (state.boundVertexArray == it->second.vao)
+				bindVertexArray(state.defaultVertexArray);
+			glDeleteVertexArrays(1, &it->second.vao);
+			it = vertexArrayCache.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+bool OpenGL::getVertexArrayKey(const VertexAttributes &attributes, const BufferBindings &buffers, VertexArrayKey &key) const
+{
+	memset(&key, 0, sizeof(VertexArrayKey));
+
+	key.enableBits = attributes.enableBits;
+
+	for (uint32 i = 0; i < VertexAttributes::MAX; i++)
+	{
+		if ((attributes.enableBits & (1u << i)) == 0)
+			continue;
+
+		const auto &attrib = attributes.attribs[i];
+		const auto &bufferinfo = buffers.info[attrib.bufferIndex];
+
+		// Streamed vertex data changes its offset every draw, so only
+		// buffers owned by love::graphics::Buffer objects are cached.
+		if (dynamic_cast<love::graphics::Buffer *>(bufferinfo.buffer) == nullptr)
+			return false;
+
+		if (attributes.instanceBits & (1u << attrib.bufferIndex))
+			key.instanceBits |= 1u << i;
+
+		auto &a = key.attribs[i];
+		a.buffer = (GLuint) bufferinfo.buffer->getHandle();
+		a.format = (uint32) attrib.format;
+		a.stride = attributes.bufferLayouts[attrib.bufferIndex].stride;
+		a.offset = bufferinfo.offset + attrib.offsetFromVertex;
+	}
+
+	return true;
+}
+
+GLuint OpenGL::getCachedVertexArray(const VertexArrayKey &key)
+{
+	uint32 hash = XXH32(&key, sizeof(VertexArrayKey), 0);
+
+	auto it = vertexArrayCache.find(hash);
+	if (it != vertexArrayCache.end())
+	{
+		if (memcmp(&it->second.key, &key, sizeof(VertexArrayKey)) == 0)
+			return it->second.vao;
+
+		// Hash collision, the new layout replaces the old one.
+		if (state.boundVertexArray == it->second.vao)
+			bindVertexArray(state.defaultVertexArray);
+		glDeleteVertexArrays(1, &it->second.vao);
+		vertexArrayCache.erase(it);
+	}
+
+	// Layouts which reference many different buffer offsets could otherwise
+	// grow the cache without bound.
+	if (vertexArrayCache.size() >= 1024)
+		clearVertexArrayCache();
+
+	GLuint vao = 0;
+	glGenVertexArrays(1, &vao);
+	bindVertexArray(vao);
+
+	for (uint32 i = 0; i < VertexAttributes::MAX; i++)
+	{
+		if ((key.enableBits & (1u << i)) == 0)
+			continue;
+
+		const auto &a = key.attribs[i];
+
+		int components = 0;
+		GLboolean normalized = GL_FALSE;
+		bool intformat = false;
+		GLenum gltype = getGLVertexDataType((DataFormat) a.format, components, normalized, intformat);
+
+		const void *offsetpointer = reinterpret_cast<void*>((size_t) a.offset);
+
+		glEnableVertexAttribArray(i);
+
+		if (key.instanceBits & (1u << i))
+			glVertexAttribDivisor(i, 1);
+
+		bindBuffer(BUFFERUSAGE_VERTEX, a.buffer);
+
+		if (intformat)
+			glVertexAttribIPointer(i, components, gltype, a.stride, offsetpointer);
+		else
+			glVertexAttribPointer(i, components, gltype, normalized, a.stride, offsetpointer);
+	}
+
+	CachedVertexArray cached;
+	cached.key = key;
+	cached.vao = vao;
+	vertexArrayCache[hash] = cached;
+
+	return vao;
+}
+
+void OpenGL::bindVertexArray(GLuint vao)
+{
+	if (vao != state.boundVertexArray)
+	{
+		glBindVertexArray(vao);
+		state.boundVertexArray = vao;
+
+		// The index buffer binding is part of a VAO's state, keep it in sync
+		// with what we think is bound.
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, state.boundBuffers[BUFFERUSAGE_INDEX]);
+
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+}
+
+void OpenGL::clearVertexArrayCache()
+{
+	if (vertexArrayCache.empty())
+		return;
+
+	for (const auto &pair : vertexArrayCache)
+	{
+		if (state.boundVertexArray == pair.second.vao)
+			bindVertexArray(state.defaultVertexArray);
+		glDeleteVertexArrays(1, &pair.second.vao);
+	}
+
+	vertexArrayCache.clear();
+}
+
+void OpenGL::setConstantColorAttribute(bool colorarrayenabled)
+{
+	// glDisableVertexAttribArray and drawing with an enabled array will make
+	// the constant value for a vertex attribute undefined. We rely on the
+	// per-vertex color attribute being white when no per-vertex color is
+	// used, so we set it here.
+	if (colorarrayenabled)
+		state.constantColorValid = false;
+	else if (!state.constantColorValid)
+	{
+		glVertexAttrib4f(ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+		state.constantColorValid = true;
+	}
 }
 
 void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const BufferBindings &buffers)
 {
+	// Static vertex layouts get their own VAO, which replaces all the calls
+	// below with a single bind.
+	VertexArrayKey key;
+	if (vertexArrayCacheSupported && attributes.enableBits != 0 && getVertexArrayKey(attributes, buffers, key))
+	{
+		bindVertexArray(getCachedVertexArray(key));
+		setConstantColorAttribute((attributes.enableBits & ATTRIBFLAG_COLOR) != 0);
+		return;
+	}
+
+	bindVertexArray(state.defaultVertexArray);
+
 	uint32 enablediff = attributes.enableBits ^ state.enabledAttribArrays;
 	uint32 instanceattribbits = 0;
 	uint32 allbits = attributes.enableBits | state.enabledAttribArrays;
@@ -913,14 +1185,36 @@ void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const Buffe
 			bool intformat = false;
 			GLenum gltype = getGLVertexDataType(attrib.format, components, normalized, intformat);
 
-			const void *offsetpointer = reinterpret_cast<void*>(bufferinfo.offset + attrib.offsetFromVertex);
+			size_t offset = bufferinfo.offset + attrib.offsetFromVertex;
+			GLuint buffer = (GLuint) bufferinfo.buffer->getHandle();
+
+			auto &pointer = state.vertexAttribPointers[i];
+
+			if (pointer.buffer != buffer || pointer.type != gltype || pointer.components != components
+				|| pointer.normalized != normalized || pointer.intFormat != intformat
+				|| pointer.stride != (GLsizei) layout.stride || pointer.offset != offset)
+			{
+				const void *offsetpointer = reinterpret_cast<void*>(offset);
+
+				bindBuffer(BUFFERUSAGE_VERTEX, buffer);
+
+				if (intformat)
+					glVertexAttribIPointer(i, components, gltype, layout.stride, offsetpointer);
+				else
+					glVertexAttribPointer(i, components, gltype, normalized, layout.stride, offsetpointer);
 
-			bindBuffer(BUFFERUSAGE_VERTEX, (GLuint) bufferinfo.buffer->getHandle());
+				pointer.buffer = buffer;
+				pointer.type = gltype;
+				pointer.components = components;
+				pointer.normalized = normalized;
+				pointer.intFormat = intformat;
+				pointer.stride = (GLsizei) layout.stride;
+				pointer.offset = offset;
 
-			if (intformat)
-				glVertexAttribIPointer(i, components, gltype, layout.stride, offsetpointer);
+				++stats.stateCalls;
+			}
 			else
-				glVertexAttribPointer(i, components, gltype, normalized, layout.stride, offsetpointer);
+				++stats.stateCallsSkipped;
 		}
 
 		i++;
@@ -930,12 +1224,7 @@ void OpenGL::setVertexAttributes(const VertexAttributes &attributes, const Buffe
 	state.enabledAttribArrays = attributes.enableBits;
 	state.instancedAttribArrays = instanceattribbits | (state.instancedAttribArrays & (~attributes.enableBits));
 
-	// glDisableVertexAttribArray will make the constant value for a vertex
-	// attribute undefined. We rely on the per-vertex color attribute being
-	// white when no per-vertex color is used, so we set it here.
-	// FIXME: Is there a better place to do this?
-	if ((enablediff & ATTRIBFLAG_COLOR) && !(attributes.enableBits & ATTRIBFLAG_COLOR))
-		glVertexAttrib4f(ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+	setConstantColorAttribute((attributes.enableBits & ATTRIBFLAG_COLOR) != 0);
 }
 
 void OpenGL::setCullMode(CullMode mode)
@@ -956,6 +1245,79 @@ void OpenGL::setCullMode(CullMode mode)
 	}
 }
 
+void OpenGL::setBlendFunctions(GLenum opRGB, GLenum opA, GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA)
+{
+	if (opRGB != state.blendEquations[0] || opA != state.blendEquations[1])
+	{
+		glBlendEquationSeparate(opRGB, opA);
+		state.blendEquations[0] = opRGB;
+		state.blendEquations[1] = opA;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+
+	GLenum *funcs = state.blendFuncs;
+	if (srcRGB != funcs[0] || dstRGB != funcs[1] || srcA != funcs[2] || dstA != funcs[3])
+	{
+		glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+		funcs[0] = srcRGB;
+		funcs[1] = dstRGB;
+		funcs[2] = srcA;
+		funcs[3] = dstA;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+}
+
+void OpenGL::setColorMask(ColorChannelMask mask)
+{
+	if (mask != state.colorMask)
+	{
+		glColorMask(mask.r, mask.g, mask.b, mask.a);
+		state.colorMask = mask;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+}
+
+void OpenGL::setDepthFunc(GLenum func)
+{
+	if (func != state.depthFunc)
+	{
+		glDepthFunc(func);
+		state.depthFunc = func;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+}
+
+void OpenGL::setStencilFunc(GLenum func, int ref, uint32 readmask, GLenum passop)
+{
+	if (func != state.stencilFunc || ref != state.stencilRef || readmask != state.stencilReadMask)
+	{
+		glStencilFunc(func, ref, readmask);
+		state.stencilFunc = func;
+		state.stencilRef = ref;
+		state.stencilReadMask = readmask;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+
+	if (passop != state.stencilPassOp)
+	{
+		glStencilOp(GL_KEEP, GL_KEEP, passop);
+		state.stencilPassOp = passop;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
+}
+
 void OpenGL::clearDepth(double value)
 {
 	if (GLAD_ES_VERSION_2_0)
@@ -966,8 +1328,14 @@ void OpenGL::clearDepth(double value)
 
 void OpenGL::setViewport(const Rect &v)
 {
-	glViewport(v.x, v.y, v.w, v.h);
-	state.viewport = v;
+	if (!(v == state.viewport))
+	{
+		glViewport(v.x, v.y, v.w, v.h);
+		state.viewport = v;
+		++stats.stateCalls;
+	}
+	else
+		++stats.stateCallsSkipped;
 }
 
 Rect OpenGL::getViewport() const
@@ -977,14 +1345,21 @@ Rect OpenGL::getViewport() const
 
 void OpenGL::setScissor(const Rect &v, bool rtActive)
 {
-	if (rtActive)
-		glScissor(v.x, v.y, v.w, v.h);
-	else
+	Rect glrect = v;
+
+	// With no RT active, we need to compensate for glScissor starting from
+	// the lower left of the viewport instead of the top left.
+	if (!rtActive)
+		glrect.y = state.viewport.h - (v.y + v.h);
+
+	if (!(glrect == state.glScissor))
 	{
-		// With no RT active, we need to compensate for glScissor starting
-		// from the lower left of the viewport instead of the top left.
-		glScissor(v.x, state.viewport.h - (v.y + v.h), v.w, v.h);
+		glScissor(glrect.x, glrect.y, glrect.w, glrect.h);
+		state.glScissor = glrect;
+		++stats.stateCalls;
 	}
+	else
+		++stats.stateCallsSkipped;
 
 	state.scissor = v;
 }
@@ -1160,6 +1535,8 @@ void OpenGL::bindTextureToUnit(TextureType target, GLuint texture, int textureun
 {
 	if (texture != state.boundTextures[target][textureunit])
 	{
+		++stats.stateCalls;
+
 		int oldtextureunit = state.curTextureUnit;
 		if (oldtextureunit != textureunit)
 			glActiveTexture(GL_TEXTURE0 + textureunit);
@@ -1177,6 +1554,17 @@ void OpenGL::bindTextureToUnit(TextureType target, GLuint texture, int textureun
 		glActiveTexture(GL_TEXTURE0 + textureunit);
 		state.curTextureUnit = textureunit;
 	}
+	else
+		++stats.stateCallsSkipped;
+
+	// A sampler object applies to the whole unit rather than to one texture
+	// type, so it's checked even when the texture was already bound.
+	if (target != TEXTURE_MAX_ENUM && texture != state.samplerTextures[textureunit] && isSamplerObjectSupported())
+	{
+		auto it = textureSamplers.find(texture);
+		bindSamplerToUnit(it != textureSamplers.end() ? it->second : 0, textureunit);
+		state.samplerTextures[textureunit] = texture;
+	}
 }
 
 void OpenGL::bindBufferTextureToUnit(GLuint texture, int textureunit, bool restoreprev, bool bindforedit)
@@ -1240,6 +1628,14 @@ void OpenGL::deleteTexture(GLuint texture)
 		}
 	}
 
+	// The name may be reused by a new texture with a different sampler.
+	textureSamplers.erase(texture);
+	for (GLuint &texid : state.samplerTextures)
+	{
+		if (texid == texture)
+			texid = std::numeric_limits<GLuint>::max();
+	}
+
 	glDeleteTextures(1, &texture);
 }
 
@@ -1283,26 +1679,12 @@ static bool isClampOne(SamplerState::WrapMode mode)
 
 void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 {
-	GLenum gltarget = getGLTextureType(target);
-
-	GLint gmin = s.minFilter == SamplerState::FILTER_NEAREST ? GL_NEAREST : GL_LINEAR;
-	GLint gmag = s.magFilter == SamplerState::FILTER_NEAREST ? GL_NEAREST : GL_LINEAR;
-
-	if (s.mipmapFilter != SamplerState::MIPMAP_FILTER_NONE)
-	{
-		if (s.minFilter == SamplerState::FILTER_NEAREST && s.mipmapFilter == SamplerState::MIPMAP_FILTER_NEAREST)
-			gmin = GL_NEAREST_MIPMAP_NEAREST;
-		else if (s.minFilter == SamplerState::FILTER_NEAREST && s.mipmapFilter == SamplerState::MIPMAP_FILTER_LINEAR)
-			gmin = GL_NEAREST_MIPMAP_LINEAR;
-		else if (s.minFilter == SamplerState::FILTER_LINEAR && s.mipmapFilter == SamplerState::MIPMAP_FILTER_NEAREST)
-			gmin = GL_LINEAR_MIPMAP_NEAREST;
-		else if (s.minFilter == SamplerState::FILTER_LINEAR && s.mipmapFilter == SamplerState::MIPMAP_FILTER_LINEAR)
-			gmin = GL_LINEAR_MIPMAP_LINEAR;
-	}
-
-	glTexParameteri(gltarget, GL_TEXTURE_MIN_FILTER, gmin);
-	glTexParameteri(gltarget, GL_TEXTURE_MAG_FILTER, gmag);
+	normalizeSamplerState(s);
+	applySamplerState(target, 0, s);
+}
 
+void OpenGL::normalizeSamplerState(SamplerState &s) const
+{
 	if (!isClampZeroOneTextureWrapSupported())
 	{
 		if (SamplerState::isClampZeroOrOne(s.wrapU)) s.wrapU = SamplerState::WRAP_CLAMP;
@@ -1310,21 +1692,6 @@ void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 		if (SamplerState::isClampZeroOrOne(s.wrapW)) s.wrapW = SamplerState::WRAP_CLAMP;
 	}
 
-	if (SamplerState::isClampZeroOrOne(s.wrapU) || SamplerState::isClampZeroOrOne(s.wrapV) || SamplerState::isClampZeroOrOne(s.wrapW))
-	{
-		GLfloat c[] = {0.0f, 0.0f, 0.0f, 0.0f};
-		if (isClampOne(s.wrapU) || isClampOne(s.wrapU) || isClampOne(s.wrapV))
-			c[0] = c[1] = c[2] = c[3] = 1.0f;
-
-		glTexParameterfv(gltarget, GL_TEXTURE_BORDER_COLOR, c);
-	}
-
-	glTexParameteri(gltarget, GL_TEXTURE_WRAP_S, getGLWrapMode(s.wrapU));
-	glTexParameteri(gltarget, GL_TEXTURE_WRAP_T, getGLWrapMode(s.wrapV));
-
-	if (target == TEXTURE_VOLUME)
-		glTexParameteri(gltarget, GL_TEXTURE_WRAP_R, getGLWrapMode(s.wrapW));
-
 	if (isSamplerLODBiasSupported())
 	{
 		float maxbias = getMaxLODBias();
@@ -1332,8 +1699,6 @@ void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 			maxbias -= 0.01f;
 
 		s.lodBias = std::min(std::max(s.lodBias, -maxbias), maxbias);
-
-		glTexParameterf(gltarget, GL_TEXTURE_LOD_BIAS, s.lodBias);
 	}
 	else
 	{
@@ -1344,24 +1709,93 @@ void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 	{
 		uint8 maxAniso = (uint8) std::min(maxAnisotropy, (float)LOVE_UINT8_MAX);
 		s.maxAnisotropy = std::min(std::max(s.maxAnisotropy, (uint8)1), maxAniso);
-		glTexParameteri(gltarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, s.maxAnisotropy);
 	}
 	else
 	{
 		s.maxAnisotropy = 1;
 	}
 
-	if (GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0)
-	{
-		glTexParameterf(gltarget, GL_TEXTURE_MIN_LOD, (float)s.minLod);
-		glTexParameterf(gltarget, GL_TEXTURE_MAX_LOD, (float)s.maxLod);
-	}
-	else
+	if (!(GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0))
 	{
 		s.minLod = 0;
 		s.maxLod = LOVE_UINT8_MAX;
 	}
 
+	if (!isDepthCompareSampleSupported())
+		s.depthSampleMode.hasValue = false;
+}
+
+void OpenGL::applySamplerState(TextureType target, GLuint sampler, const SamplerState &s)
+{
+	// Sets the parameter on the sampler object if there is one, otherwise on
+	// the currently bound texture.
+	GLenum gltarget = getGLTextureType(target);
+
+	auto seti = [&](GLenum pname, GLint param)
+	{
+		if (sampler != 0)
+			glSamplerParameteri(sampler, pname, param);
+		else
+			glTexParameteri(gltarget, pname, param);
+	};
+
+	auto setf = [&](GLenum pname, GLfloat param)
+	{
+		if (sampler != 0)
+			glSamplerParameterf(sampler, pname, param);
+		else
+			glTexParameterf(gltarget, pname, param);
+	};
+
+	GLint gmin = s.minFilter == SamplerState::FILTER_NEAREST ? GL_NEAREST : GL_LINEAR;
+	GLint gmag = s.magFilter == SamplerState::FILTER_NEAREST ? GL_NEAREST : GL_LINEAR;
+
+	if (s.mipmapFilter != SamplerState::MIPMAP_FILTER_NONE)
+	{
+		if (s.minFilter == SamplerState::FILTER_NEAREST && s.mipmapFilter == SamplerState::MIPMAP_FILTER_NEAREST)
+			gmin = GL_NEAREST_MIPMAP_NEAREST;
+		else if (s.minFilter == SamplerState::FILTER_NEAREST && s.mipmapFilter == SamplerState::MIPMAP_FILTER_LINEAR)
+			gmin = GL_NEAREST_MIPMAP_LINEAR;
+		else if (s.minFilter == SamplerState::FILTER_LINEAR && s.mipmapFilter == SamplerState::MIPMAP_FILTER_NEAREST)
+			gmin = GL_LINEAR_MIPMAP_NEAREST;
+		else if (s.minFilter == SamplerState::FILTER_LINEAR && s.mipmapFilter == SamplerState::MIPMAP_FILTER_LINEAR)
+			gmin = GL_LINEAR_MIPMAP_LINEAR;
+	}
+
+	seti(GL_TEXTURE_MIN_FILTER, gmin);
+	seti(GL_TEXTURE_MAG_FILTER, gmag);
+
+	if (SamplerState::isClampZeroOrOne(s.wrapU) || SamplerState::isClampZeroOrOne(s.wrapV) || SamplerState::isClampZeroOrOne(s.wrapW))
+	{
+		GLfloat c[] = {0.0f, 0.0f, 0.0f, 0.0f};
+		if (isClampOne(s.wrapU) || isClampOne(s.wrapU) || isClampOne(s.wrapV))
+			c[0] = c[1] = c[2] = c[3] = 1.0f;
+
+		if (sampler != 0)
+			glSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, c);
+		else
+			glTexParameterfv(gltarget, GL_TEXTURE_BORDER_COLOR, c);
+	}
+
+	seti(GL_TEXTURE_WRAP_S, getGLWrapMode(s.wrapU));
+	seti(GL_TEXTURE_WRAP_T, getGLWrapMode(s.wrapV));
+
+	// Sampler objects can be used with any type of texture.
+	if (target == TEXTURE_VOLUME || sampler != 0)
+		seti(GL_TEXTURE_WRAP_R, getGLWrapMode(s.wrapW));
+
+	if (isSamplerLODBiasSupported())
+		setf(GL_TEXTURE_LOD_BIAS, s.lodBias);
+
+	if (GLAD_EXT_texture_filter_anisotropic)
+		seti(GL_TEXTURE_MAX_ANISOTROPY_EXT, s.maxAnisotropy);
+
+	if (GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0)
+	{
+		setf(GL_TEXTURE_MIN_LOD, (float)s.minLod);
+		setf(GL_TEXTURE_MAX_LOD, (float)s.maxLod);
+	}
+
 	if (isDepthCompareSampleSupported())
 	{
 		if (s.depthSampleMode.hasValue)
@@ -1369,17 +1803,51 @@ void OpenGL::setSamplerState(TextureType target, SamplerState &s)
 			// See the comment in renderstate.h
 			GLenum glmode = getGLCompareMode(getReversedCompareMode(s.depthSampleMode.value));
 
-			glTexParameteri(gltarget, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-			glTexParameteri(gltarget, GL_TEXTURE_COMPARE_FUNC, glmode);
+			seti(GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+			seti(GL_TEXTURE_COMPARE_FUNC, glmode);
 		}
 		else
 		{
-			glTexParameteri(gltarget, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+			seti(GL_TEXTURE_COMPARE_MODE, GL_NONE);
 		}
 	}
-	else
+}
+
+GLuint OpenGL::getCachedSampler(const SamplerState &s)
+{
+	uint64 key = s.toKey();
+
+	auto it = samplerCache.find(key);
+	if (it != samplerCache.end())
+		return it->second;
+
+	GLuint sampler = 0;
+	glGenSamplers(1, &sampler);
+	applySamplerState(TEXTURE_2D, sampler, s);
+
+	samplerCache[key] = sampler;
+	return sampler;
+}
+
+void OpenGL::setTextureSampler(GLuint texture, GLuint sampler)
+{
+	textureSamplers[texture] = sampler;
+
+	// Update the texture units it's already bound to.
+	for (int unit = 0; unit < (int) state.samplerTextures.size(); unit++)
 	{
-		s.depthSampleMode.hasValue = false;
+		if (state.samplerTextures[unit] == texture)
+			bindSamplerToUnit(sampler, unit);
+	}
+}
+
+void OpenGL::bindSamplerToUnit(GLuint sampler, int textureunit)
+{
+	if (sampler != state.boundSamplers[textureunit])
+	{
+		++stats.stateCalls;
+		state.boundSamplers[textureunit] = sampler;
+		glBindSampler(textureunit, sampler);
 	}
 }
 
@@ -1483,8 +1951,12 @@ bool OpenGL::isBufferUsageSupported(BufferUsage usage) const
 		return true;
 	case BUFFERUSAGE_TEXEL:
 		return GLAD_VERSION_3_1 || GLAD_ES_VERSION_3_2;
+	case BUFFERUSAGE_UNIFORM:
+		return GLAD_VERSION_3_1 || GLAD_ES_VERSION_3_0 || GLAD_ARB_uniform_buffer_object;
 	case BUFFERUSAGE_SHADER_STORAGE:
 		return (GLAD_VERSION_4_3 && isCoreProfile()) || GLAD_ES_VERSION_3_1;
+	case BUFFERUSAGE_INDIRECT_ARGUMENTS:
+		return isIndirectDrawSupported();
 	case BUFFERUSAGE_MAX_ENUM:
 		return false;
 	}
@@ -1519,16 +1991,36 @@ bool OpenGL::isSamplerLODBiasSupported() const
 	return GLAD_VERSION_1_4;
 }
 
+bool OpenGL::isSamplerObjectSupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sampler_objects;
+}
+
 bool OpenGL::isBaseVertexSupported() const
 {
 	return baseVertexSupported;
 }
 
+bool OpenGL::isVertexArrayCacheSupported() const
+{
+	return vertexArrayCacheSupported;
+}
+
 bool OpenGL::isMultiFormatMRTSupported() const
 {
 	return getMaxRenderTargets() > 1 && (GLAD_ES_VERSION_3_0 || GLAD_VERSION_3_0 || GLAD_ARB_framebuffer_object);
 }
 
+bool OpenGL::isIndirectDrawSupported() const
+{
+	return GLAD_VERSION_4_0 || GLAD_ARB_draw_indirect || GLAD_ES_VERSION_3_1;
+}
+
+bool OpenGL::isMultiDrawIndirectSupported() const
+{
+	return isIndirectDrawSupported() && (GLAD_VERSION_4_3 || GLAD_ARB_multi_draw_indirect || GLAD_EXT_multi_draw_indirect);
+}
+
 bool OpenGL::isCopyBufferSupported() const
 {
 	return GLAD_VERSION_3_1 || GLAD_ES_VERSION_3_0;
@@ -1540,6 +2032,38 @@ bool OpenGL::isCopyBufferToTextureSupported() const
 	return GLAD_VERSION_2_0 || GLAD_ES_VERSION_3_0;
 }
 
+bool OpenGL::isTimerQuerySupported() const
+{
+	// Requires glQueryCounter with GL_TIMESTAMP support.
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query || GLAD_EXT_disjoint_timer_query;
+}
+
+bool OpenGL::isProgramBinarySupported() const
+{
+	if (!(GLAD_VERSION_4_1 || GLAD_ARB_get_program_binary || GLAD_ES_VERSION_3_0))
+		return false;
+
+	// Some drivers expose the functions without supporting any formats.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+bool OpenGL::isParallelShaderCompileSupported() const
+{
+	return parallelShaderCompileSupported;
+}
+
+bool OpenGL::isOcclusionQuerySupported() const
+{
+	return GLAD_VERSION_1_5 || GLAD_ES_VERSION_3_0 || GLAD_EXT_occlusion_query_boolean;
+}
+
+bool OpenGL::isConditionalRenderSupported() const
+{
+	return GLAD_VERSION_3_0 || GLAD_NV_conditional_render;
+}
+
 bool OpenGL::isCopyTextureToBufferSupported() const
 {
 	// Requires glGetTextureSubImage support.
@@ -1617,6 +2141,11 @@ int OpenGL::getMaxShaderStorageBufferBindings() const
 	return maxShaderStorageBufferBindings;
 }
 
+int OpenGL::getMaxUniformBufferBindings() const
+{
+	return maxUniformBufferBindings;
+}
+
 float OpenGL::getMaxPointSize() const
 {
 	return maxPointSize;
@@ -37,6 +37,7 @@
 // C++
 #include <vector>
 #include <stack>
+#include <unordered_map>
 
 // The last argument to AttribPointer takes a buffer offset casted to a pointer.
 #define BUFFER_OFFSET(i) ((char *) NULL + (i))
@@ -127,6 +128,11 @@ public:
 	struct Stats
 	{
 		int shaderSwitches;
+
+		// State-tracked calls which reached the driver, and ones which were
+		// skipped because they wouldn't have changed anything.
+		int stateCalls;
+		int stateCallsSkipped;
 	} stats;
 
 	struct Bugs
@@ -259,6 +265,27 @@ public:
 	 **/
 	void setCullMode(CullMode mode);
 
+	/**
+	 * State-tracked glBlendEquationSeparate and glBlendFuncSeparate.
+	 **/
+	void setBlendFunctions(GLenum opRGB, GLenum opA, GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA);
+
+	/**
+	 * State-tracked glColorMask.
+	 **/
+	void setColorMask(ColorChannelMask mask);
+
+	/**
+	 * State-tracked glDepthFunc.
+	 **/
+	void setDepthFunc(GLenum func);
+
+	/**
+	 * State-tracked glStencilFunc and glStencilOp. The stencil-fail and
+	 * depth-fail operations always keep the current value.
+	 **/
+	void setStencilFunc(GLenum func, int ref, uint32 readmask, GLenum passop);
+
 	/**
 	 * Wrapper for glClearDepth and glClearDepthf.
 	 **/
@@ -358,6 +385,24 @@ public:
 	 **/
 	void setSamplerState(TextureType target, SamplerState &s);
 
+	/**
+	 * Adjusts sampler state to what the system supports. Done by
+	 * setSamplerState as well.
+	 **/
+	void normalizeSamplerState(SamplerState &s) const;
+
+	/**
+	 * Gets a sampler object with the given (normalized) state, creating it if
+	 * it isn't cached yet.
+	 **/
+	GLuint getCachedSampler(const SamplerState &s);
+
+	/**
+	 * Makes a texture be sampled through the given sampler object wherever
+	 * it's bound, instead of through its own sampler parameters.
+	 **/
+	void setTextureSampler(GLuint texture, GLuint sampler);
+
 	/**
 	 * Equivalent to glTexStorage2D/3D on platforms that support it. Equivalent
 	 * to glTexImage2D/3D for all levels and slices of a texture otherwise.
@@ -372,12 +417,21 @@ public:
 	bool isInstancingSupported() const;
 	bool isDepthCompareSampleSupported() const;
 	bool isSamplerLODBiasSupported() const;
+	bool isSamplerObjectSupported() const;
 	bool isBaseVertexSupported() const;
+	bool isVertexArrayCacheSupported() const;
+	bool isIndirectDrawSupported() const;
+	bool isMultiDrawIndirectSupported() const;
 	bool isMultiFormatMRTSupported() const;
 	bool isCopyBufferSupported() const;
 	bool isCopyBufferToTextureSupported() const;
 	bool isCopyTextureToBufferSupported() const;
 	bool isCopyRenderTargetToBufferSupported() const;
+	bool isTimerQuerySupported() const;
+	bool isOcclusionQuerySupported() const;
+	bool isConditionalRenderSupported() const;
+	bool isProgramBinarySupported() const;
+	bool isParallelShaderCompileSupported() const;
 
 	/**
 	 * Returns the maximum supported width or height of a texture.
@@ -425,6 +479,11 @@ public:
 	 **/
 	int getMaxShaderStorageBufferBindings() const;
 
+	/**
+	 * Returns the maximum number of uniform buffer bindings.
+	 **/
+	int getMaxUniformBufferBindings() const;
+
 	/**
 	 * Returns the maximum point size.
 	 **/
@@ -476,10 +535,53 @@ private:
 	void initMaxValues();
 	void createDefaultTexture();
 
+	// The GL state of a cached vertex array object, only enabled attributes
+	// have their fields set. Unused bytes are zeroed so the struct can be
+	// hashed and compared directly.
+	struct VertexArrayKey
+	{
+		uint32 enableBits;
+		uint32 instanceBits; // Indexed by attribute.
+
+		struct
+		{
+			GLuint buffer;
+			uint32 format;
+			uint32 stride;
+			uint32 padding;
+			uint64 offset;
+		} attribs[VertexAttributes::MAX];
+	};
+
+	struct CachedVertexArray
+	{
+		VertexArrayKey key;
+		GLuint vao;
+	};
+
+	bool getVertexArrayKey(const VertexAttributes &attributes, const BufferBindings &buffers, VertexArrayKey &key) const;
+	GLuint getCachedVertexArray(const VertexArrayKey &key);
+	void bindVertexArray(GLuint vao);
+	void clearVertexArrayCache();
+	void setConstantColorAttribute(bool colorarrayenabled);
+
+	// Sets sampler parameters on the sampler object, or on the currently
+	// bound texture if it's 0.
+	void applySamplerState(TextureType target, GLuint sampler, const SamplerState &s);
+	void bindSamplerToUnit(GLuint sampler, int textureunit);
+
 	bool contextInitialized;
 
 	bool pixelShaderHighpSupported;
 	bool baseVertexSupported;
+	bool vertexArrayCacheSupported;
+	bool parallelShaderCompileSupported;
+
+	std::unordered_map<uint32, CachedVertexArray> vertexArrayCache;
+
+	// Sampler objects by SamplerState key, and the one each texture uses.
+	std::unordered_map<uint64, GLuint> samplerCache;
+	std::unordered_map<GLuint, GLuint> textureSamplers;
 
 	float maxAnisotropy;
 	float maxLODBias;
@@ -496,6 +598,7 @@ private:
 	int maxSamples;
 	int maxTextureUnits;
 	int maxShaderStorageBufferBindings;
+	int maxUniformBufferBindings;
 	float maxPointSize;
 
 	bool coreProfile;
@@ -510,6 +613,11 @@ private:
 		// Texture unit state (currently bound texture for each texture unit.)
 		std::vector<GLuint> boundTextures[TEXTURE_MAX_ENUM + 1];
 
+		// The sampler object bound to each texture unit, and the texture it
+		// was chosen for.
+		std::vector<GLuint> boundSamplers;
+		std::vector<GLuint> samplerTextures;
+
 		std::vector<GLuint> boundIndexedBuffers[BUFFERUSAGE_MAX_ENUM];
 
 		bool enableState[ENABLE_MAX_ENUM];
@@ -518,12 +626,47 @@ private:
 
 		int curTextureUnit;
 
+		// The VAO which was bound when the context was set up. The attribute
+		// state below is only tracked for this one.
+		GLuint defaultVertexArray;
+		GLuint boundVertexArray;
+
+		// Whether the constant value of the color attribute is known to be
+		// white.
+		bool constantColorValid;
+
 		uint32 enabledAttribArrays;
 		uint32 instancedAttribArrays;
 
+		// Arguments of the last glVertexAttrib(I)Pointer call per attribute.
+		struct
+		{
+			GLuint buffer;
+			GLenum type;
+			GLint components;
+			GLboolean normalized;
+			bool intFormat;
+			GLsizei stride;
+			size_t offset;
+		} vertexAttribPointers[VertexAttributes::MAX];
+
 		Rect viewport;
 		Rect scissor;
 
+		// The scissor box in GL's bottom-left coordinates.
+		Rect glScissor;
+
+		GLenum blendEquations[2];
+		GLenum blendFuncs[4];
+		ColorChannelMask colorMask;
+
+		GLenum depthFunc;
+
+		GLenum stencilFunc;
+		int stencilRef;
+		uint32 stencilReadMask;
+		GLenum stencilPassOp;
+
 		float pointSize;
 
 		bool depthWritesEnabled = true;
@@ -25,6 +25,8 @@
 #include "ShaderStage.h"
 #include "Graphics.h"
 #include "graphics/vertex.h"
+#include "common/version.h"
+#include "filesystem/Filesystem.h"
 
 // C++
 #include <algorithm>
@@ -40,11 +42,11 @@ namespace opengl
 
 static bool isBuffer(Shader::UniformType utype)
 {
-	return utype == Shader::UNIFORM_TEXELBUFFER || utype == Shader::UNIFORM_STORAGEBUFFER;
+	return utype == Shader::UNIFORM_TEXELBUFFER || utype == Shader::UNIFORM_STORAGEBUFFER || utype == Shader::UNIFORM_UNIFORMBUFFER;
 }
 
-Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM])
-	: love::graphics::Shader(stages)
+Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const ValidationReflection *prebuiltreflection)
+	: love::graphics::Shader(stages, prebuiltreflection)
 	, program(0)
 	, splitUniformsPerDraw(false)
 	, builtinUniforms()
@@ -427,6 +429,69 @@ void Shader::mapActiveUniforms()
 		}
 	}
 
+	if (gl.isBufferUsageSupported(BUFFERUSAGE_UNIFORM))
+	{
+		GLint numuniformblocks = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numuniformblocks);
+
+		char namebuffer[2048] = { '\0' };
+
+		for (int bindex = 0; bindex < numuniformblocks; bindex++)
+		{
+			UniformInfo u = {};
+			u.baseType = UNIFORM_UNIFORMBUFFER;
+			u.access = ACCESS_READ;
+
+			GLsizei namelength = 0;
+			glGetActiveUniformBlockName(program, (GLuint) bindex, 2048, &namelength, namebuffer);
+
+			u.name = std::string(namebuffer, namelength);
+			u.count = 1;
+
+			if (!fillUniformReflectionData(u))
+				continue;
+
+			auto oldu = olduniforms.find(u.name);
+			if (oldu != olduniforms.end())
+			{
+				u.data = oldu->second.data;
+				u.dataSize = oldu->second.dataSize;
+				u.buffers = oldu->second.buffers;
+			}
+			else
+			{
+				u.dataSize = sizeof(int) * 1;
+				u.data = malloc(u.dataSize);
+
+				u.buffers = new love::graphics::Buffer * [u.count];
+				memset(u.buffers, 0, sizeof(Buffer*)* u.count);
+			}
+
+			// Like storage blocks, these don't get unique bindings automatically
+			// if they're unspecified in the shader.
+			u.ints[0] = (int) activeUniformBufferBindings.size();
+			glUniformBlockBinding(program, (GLuint) bindex, (GLuint) u.ints[0]);
+
+			BufferBinding binding;
+			binding.bindingindex = u.ints[0];
+			binding.buffer = 0;
+			activeUniformBufferBindings.push_back(binding);
+
+			uniforms[u.name] = u;
+
+			for (int i = 0; i < u.count; i++)
+			{
+				if (u.buffers[i] == nullptr)
+					continue;
+				Volatile* v = dynamic_cast<Volatile*>(u.buffers[i]);
+				if (v != nullptr)
+					v->loadVolatile();
+			}
+
+			sendBuffers(&u, u.buffers, u.count, true);
+		}
+	}
+
 	// Make sure uniforms that existed before but don't exist anymore are
 	// cleaned up. This theoretically shouldn't happen, but...
 	for (const auto &p : olduniforms)
@@ -480,43 +545,57 @@ bool Shader::loadVolatile()
 	storageBufferBindingIndexToActiveBinding.resize(gl.getMaxShaderStorageBufferBindings(), std::make_pair(-1, -1));
 	activeStorageBufferBindings.clear();
 	activeWritableStorageBuffers.clear();
+	activeUniformBufferBindings.clear();
 
-	for (const auto &stage : stages)
+	std::string binaryfilename;
+	if (gl.isProgramBinarySupported())
+		binaryfilename = getProgramBinaryFilename();
+
+	if (binaryfilename.empty() || !loadProgramBinary(binaryfilename))
 	{
-		if (stage.get() != nullptr)
-			((ShaderStage*)stage.get())->loadVolatile();
-	}
+		for (const auto &stage : stages)
+		{
+			if (stage.get() != nullptr)
+				((ShaderStage*)stage.get())->compile();
+		}
 
-	program = glCreateProgram();
+		program = glCreateProgram();
 
-	if (program == 0)
-		throw love::Exception("Cannot create shader program object.");
+		if (program == 0)
+			throw love::Exception("Cannot create shader program object.");
 
-	for (const auto &stage : stages)
-	{
-		if (stage.get() != nullptr)
-			glAttachShader(program, (GLuint) stage->getHandle());
-	}
+		for (const auto &stage : stages)
+		{
+			if (stage.get() != nullptr)
+				glAttachShader(program, (GLuint) stage->getHandle());
+		}
 
-	// Bind generic vertex attribute indices to names in the shader.
-	for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
-	{
-		const char *name = nullptr;
-		if (graphics::getConstant((BuiltinVertexAttribute) i, name))
-			glBindAttribLocation(program, i, (const GLchar *) name);
-	}
+		// Bind generic vertex attribute indices to names in the shader.
+		for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
+		{
+			const char *name = nullptr;
+			if (graphics::getConstant((BuiltinVertexAttribute) i, name))
+				glBindAttribLocation(program, i, (const GLchar *) name);
+		}
 
-	glLinkProgram(program);
+		if (!binaryfilename.empty())
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
+		glLinkProgram(program);
 
-	if (status == GL_FALSE)
-	{
-		std::string warnings = getProgramWarnings();
-		glDeleteProgram(program);
-		program = 0;
-		throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+		if (status == GL_FALSE)
+		{
+			std::string warnings = getProgramWarnings();
+			glDeleteProgram(program);
+			program = 0;
+			throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+		}
+
+		if (!binaryfilename.empty())
+			saveProgramBinary(binaryfilename);
 	}
 
 	// Get all active uniform variables in this shader from OpenGL.
@@ -574,6 +653,109 @@ std::string Shader::getProgramWarnings() const
 	return warnings;
 }
 
+std::string Shader::getProgramBinaryFilename() const
+{
+	std::string key = LOVE_VERSION_STRING;
+
+	// Binaries are only valid for the driver which created them.
+	const char *driverstrings[] = {
+		(const char *) glGetString(GL_VENDOR),
+		(const char *) glGetString(GL_RENDERER),
+		(const char *) glGetString(GL_VERSION),
+	};
+
+	for (const char *str : driverstrings)
+	{
+		key += '\n';
+		if (str != nullptr)
+			key += str;
+	}
+
+	for (const auto &stage : stages)
+	{
+		if (stage.get() == nullptr)
+			continue;
+
+		key += '\n' + std::to_string((int) stage->getStageType()) + '\n';
+		key += stage->getSource();
+	}
+
+	return Graphics::getCacheFilename("glprogramcache", key, ".bin");
+}
+
+bool Shader::loadProgramBinary(const std::string &filename)
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return false;
+
+	StrongRef<love::filesystem::FileData> data;
+
+	try
+	{
+		love::filesystem::Filesystem::Info info = {};
+		if (fs->getInfo(filename.c_str(), info))
+			data.set(fs->read(filename.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+	}
+
+	// The binary format enum is stored before the binary itself.
+	if (data.get() == nullptr || data->getSize() <= sizeof(uint32))
+		return false;
+
+	uint32 format = 0;
+	memcpy(&format, data->getData(), sizeof(uint32));
+
+	const uint8 *binary = (const uint8 *) data->getData() + sizeof(uint32);
+	GLsizei binarysize = (GLsizei) (data->getSize() - sizeof(uint32));
+
+	program = glCreateProgram();
+
+	if (program == 0)
+		return false;
+
+	glProgramBinary(program, (GLenum) format, binary, binarysize);
+
+	// Drivers reject binaries after an update even if the version string
+	// didn't change, the program is linked from source in that case.
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		program = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void Shader::saveProgramBinary(const std::string &filename) const
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+		return;
+
+	std::vector<uint8> data(sizeof(uint32) + length);
+
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &format, data.data() + sizeof(uint32));
+
+	if (written <= 0)
+		return;
+
+	uint32 format32 = (uint32) format;
+	memcpy(data.data(), &format32, sizeof(uint32));
+
+	Graphics::saveCacheFile("glprogramcache", filename, data.data(), sizeof(uint32) + written);
+}
+
 std::string Shader::getWarnings() const
 {
 	std::string warnings;
@@ -627,6 +809,9 @@ void Shader::attach()
 		for (auto bufferbinding : activeStorageBufferBindings)
 			gl.bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_SHADER_STORAGE, bufferbinding.bindingindex);
 
+		for (auto bufferbinding : activeUniformBufferBindings)
+			gl.bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_UNIFORM, bufferbinding.bindingindex);
+
 		// send any pending uniforms to the shader program.
 		for (const auto &p : pendingUniformUpdates)
 			updateUniform(p.first, p.second, true);
@@ -659,6 +844,17 @@ void Shader::updateUniform(const UniformInfo *info, int count, bool internalupda
 {
 	if (current != this && !internalupdate)
 	{
+		// Only the latest values are uploaded once the shader is used, however
+		// many times they were sent before that.
+		for (auto &p : pendingUniformUpdates)
+		{
+			if (p.first == info)
+			{
+				p.second = std::max(p.second, count);
+				return;
+			}
+		}
+
 		pendingUniformUpdates.push_back(std::make_pair(info, count));
 		return;
 	}
@@ -831,8 +1027,9 @@ void Shader::sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffe
 {
 	bool texelbinding = info->baseType == UNIFORM_TEXELBUFFER;
 	bool storagebinding = info->baseType == UNIFORM_STORAGEBUFFER;
+	bool uniformbinding = info->baseType == UNIFORM_UNIFORMBUFFER;
 
-	if (!texelbinding && !storagebinding)
+	if (!texelbinding && !storagebinding && !uniformbinding)
 		return;
 
 	bool shaderactive = current == this;
@@ -896,6 +1093,16 @@ void Shader::sendBuffers(const UniformInfo *info, love::graphics::Buffer **buffe
 			if (activeindex.second >= 0)
 				activeWritableStorageBuffers[activeindex.second] = buffer;
 		}
+		else if (uniformbinding)
+		{
+			int bindingindex = info->ints[i];
+			GLuint glbuffer = buffer != nullptr ? (GLuint) buffer->getHandle() : 0;
+
+			if (shaderactive)
+				gl.bindIndexedBuffer(glbuffer, BUFFERUSAGE_UNIFORM, bindingindex);
+
+			activeUniformBufferBindings[bindingindex].buffer = glbuffer;
+		}
 	}
 }
 
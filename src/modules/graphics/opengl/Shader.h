@@ -52,7 +52,7 @@ public:
 		GLenum internalFormat;
 	};
 
-	Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM]);
+	Shader(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const ValidationReflection *prebuiltreflection);
 	virtual ~Shader();
 
 	// Implements Volatile
@@ -109,6 +109,12 @@ private:
 	// Get any warnings or errors generated only by the shader program object.
 	std::string getProgramWarnings() const;
 
+	// Linked programs are cached in the save directory, keyed by the code of
+	// each stage and the driver which compiled them.
+	std::string getProgramBinaryFilename() const;
+	bool loadProgramBinary(const std::string &filename);
+	void saveProgramBinary(const std::string &filename) const;
+
 	// volatile
 	GLuint program;
 
@@ -131,6 +137,9 @@ private:
 	std::vector<std::pair<int, int>> storageBufferBindingIndexToActiveBinding;
 	std::vector<BufferBinding> activeStorageBufferBindings;
 
+	// Indexed by the uniform block binding.
+	std::vector<BufferBinding> activeUniformBufferBindings;
+
 	std::vector<Buffer *> activeWritableStorageBuffers;
 
 	std::vector<std::pair<const UniformInfo *, int>> pendingUniformUpdates;
@@ -27,11 +27,11 @@ namespace graphics
 namespace opengl
 {
 
-ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey)
-	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
+ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv)
+	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey, prebuiltspirv)
 	, glShader(0)
+	, compiled(false)
 {
-	loadVolatile();
 }
 
 ShaderStage::~ShaderStage()
@@ -40,9 +40,15 @@ ShaderStage::~ShaderStage()
 }
 
 bool ShaderStage::loadVolatile()
+{
+	// Compiled on demand by Shader.
+	return true;
+}
+
+void ShaderStage::startAsyncCompile()
 {
 	if (glShader != 0)
-		return true;
+		return;
 
 	ShaderStageType stage = getStageType();
 	const char *typestr = "unknown";
@@ -69,6 +75,28 @@ bool ShaderStage::loadVolatile()
 
 	glShaderSource(glShader, 1, (const GLchar **)&src, &srclen);
 	glCompileShader(glShader);
+	compiled = false;
+}
+
+bool ShaderStage::isAsyncCompileComplete() const
+{
+	if (glShader == 0 || compiled || !gl.isParallelShaderCompileSupported())
+		return true;
+
+	GLint complete = GL_FALSE;
+	glGetShaderiv(glShader, GL_COMPLETION_STATUS_ARB, &complete);
+	return complete != GL_FALSE;
+}
+
+void ShaderStage::compile()
+{
+	startAsyncCompile();
+
+	if (compiled)
+		return;
+
+	const char *typestr = "unknown";
+	getConstant(getStageType(), typestr);
 
 	GLint infologlen;
 	glGetShaderiv(glShader, GL_INFO_LOG_LENGTH, &infologlen);
@@ -88,10 +116,11 @@ bool ShaderStage::loadVolatile()
 	if (status == GL_FALSE)
 	{
 		glDeleteShader(glShader);
+		glShader = 0;
 		throw love::Exception("Cannot compile %s shader code:\n%s", typestr, warnings.c_str());
 	}
 
-	return true;
+	compiled = true;
 }
 
 void ShaderStage::unloadVolatile()
@@ -100,6 +129,7 @@ void ShaderStage::unloadVolatile()
 		glDeleteShader(glShader);
 
 	glShader = 0;
+	compiled = false;
 }
 
 } // opengl
@@ -35,11 +35,22 @@ class ShaderStage final : public love::graphics::ShaderStage, public Volatile
 {
 public:
 
-	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey);
+	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &source, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv);
 	virtual ~ShaderStage();
 
 	ptrdiff_t getHandle() const override { return glShader; }
 
+	/**
+	 * Compiles the GL shader object if it hasn't been already. This is done on
+	 * demand by Shader, since programs loaded from a cached binary don't need
+	 * their stages to be compiled at all.
+	 **/
+	void compile();
+
+	// Implements love::graphics::ShaderStage.
+	void startAsyncCompile() override;
+	bool isAsyncCompileComplete() const override;
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -48,6 +59,9 @@ private:
 
 	GLuint glShader;
 
+	// Whether the compile status of glShader has been checked.
+	bool compiled;
+
 }; // ShaderStage
 
 } // opengl
@@ -28,6 +28,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <stdlib.h>
+#include <string.h>
 
 namespace love
 {
@@ -73,7 +75,11 @@ public:
 		return (size_t) data;
 	}
 
-	void markUsed(size_t /*usedsize*/) override { }
+	void markUsed(size_t usedsize) override
+	{
+		frameBytesUsed += usedsize;
+	}
+
 	ptrdiff_t getHandle() const override { return 0; }
 
 private:
@@ -134,6 +140,7 @@ public:
 	void markUsed(size_t usedsize) override
 	{
 		frameGPUReadOffset += usedsize;
+		frameBytesUsed += usedsize;
 	}
 
 	void nextFrame() override
@@ -207,10 +214,19 @@ public:
 		// We insert a fence for all data from this frame at the end of the
 		// frame (in nextFrame), rather than doing anything more fine-grained.
 		frameGPUReadOffset += usedsize;
+		frameBytesUsed += usedsize;
 	}
 
 protected:
 
+	void waitForFrame()
+	{
+		if (!syncs[frameIndex].isComplete())
+			frameStalls++;
+
+		syncs[frameIndex].cpuWait();
+	}
+
 	int frameIndex;
 	FenceSync syncs[BUFFER_FRAMES];
 
@@ -238,7 +254,7 @@ public:
 		gl.bindBuffer(mode, vbo);
 
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -320,7 +336,7 @@ public:
 	MapInfo map(size_t /*minsize*/) override
 	{
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -423,7 +439,7 @@ public:
 	MapInfo map(size_t /*minsize*/) override
 	{
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -491,8 +507,64 @@ private:
 
 }; // StreamBufferPinnedMemory
 
+// The LOVE_GRAPHICS_GL_STREAMBUFFER environment variable can be used to force
+// a specific implementation at startup instead of picking one based on the
+// driver. Unsupported choices fall back to the automatic selection.
+static const char *getStreamBufferOverride()
+{
+	static bool queried = false;
+	static const char *forcedtype = nullptr;
+
+	if (!queried)
+	{
+		const char *env = getenv("LOVE_GRAPHICS_GL_STREAMBUFFER");
+		if (env != nullptr && env[0] != '\0' && strcmp(env, "auto") != 0)
+			forcedtype = env;
+		queried = true;
+	}
+
+	return forcedtype;
+}
+
+static love::graphics::StreamBuffer *createStreamBufferOverride(const char *type, BufferUsage mode, size_t size)
+{
+	if (!gl.isCoreProfile())
+		return strcmp(type, "client") == 0 ? new StreamBufferClientMemory(mode, size) : nullptr;
+
+	bool bufferstorage = GLAD_VERSION_4_4 || GLAD_ARB_buffer_storage;
+
+	if (strcmp(type, "persistent") == 0 && bufferstorage)
+		return new StreamBufferPersistentMapSync(mode, size, true);
+	else if (strcmp(type, "persistentflush") == 0 && bufferstorage)
+		return new StreamBufferPersistentMapSync(mode, size, false);
+	else if (strcmp(type, "mapsync") == 0)
+		return new StreamBufferMapSync(mode, size);
+	else if (strcmp(type, "subdata") == 0)
+		return new StreamBufferSubDataOrphan(mode, size);
+	else if (strcmp(type, "pinned") == 0 && GLAD_AMD_pinned_memory)
+	{
+		try
+		{
+			return new StreamBufferPinnedMemory(mode, size);
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
+
+	return nullptr;
+}
+
 love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
 {
+	const char *forcedtype = getStreamBufferOverride();
+	if (forcedtype != nullptr)
+	{
+		love::graphics::StreamBuffer *buffer = createStreamBufferOverride(forcedtype, mode, size);
+		if (buffer != nullptr)
+			return buffer;
+	}
+
 	if (gl.isCoreProfile())
 	{
 		if (!gl.bugs.clientWaitSyncStalls)
@@ -209,6 +209,7 @@ Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const
 	, framebufferStatus(GL_FRAMEBUFFER_COMPLETE)
 	, textureGLError(GL_NO_ERROR)
 	, actualSamples(1)
+	, loaded(false)
 {
 	if (data != nullptr)
 		slices = *data;
@@ -237,11 +238,26 @@ void Texture::createTexture()
 	// given then it must exist for all mip levels, a render target can't use
 	// a compressed format, etc.
 
-	glGenTextures(1, &texture);
+	// Reuse the storage of a destroyed texture with the same layout, if there
+	// is one. Its contents are re-initialized below like a new texture's.
+	RecycledTextureKey recyclekey;
+	bool recycledsRGB = sRGB;
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	if (gfx != nullptr && getRecycledTextureKey(recyclekey, recycledsRGB))
+		texture = gfx->takeRecycledTexture(recyclekey);
+
+	bool recycled = texture != 0;
+
+	if (recycled)
+		sRGB = recycledsRGB;
+	else
+		glGenTextures(1, &texture);
+
 	gl.bindTextureToUnit(this, 0, false);
 
 	GLenum gltype = OpenGL::getGLTextureType(texType);
-	if (renderTarget && GLAD_ANGLE_texture_usage)
+	if (!recycled && renderTarget && GLAD_ANGLE_texture_usage)
 		glTexParameteri(gltype, GL_TEXTURE_USAGE_ANGLE, GL_FRAMEBUFFER_ATTACHMENT_ANGLE);
 
 	setSamplerState(samplerState);
@@ -261,7 +277,7 @@ void Texture::createTexture()
 	// correct value for all compressed texture formats, and I also vaguely
 	// remember some driver issues on some old Android systems, maybe...
 	// For now, the base class enforces data on init for compressed textures.
-	if (!isCompressed())
+	if (!isCompressed() && !recycled)
 		gl.rawTexStorage(texType, mipcount, format, sRGB, pixelWidth, pixelHeight, texType == TEXTURE_VOLUME ? depth : layers);
 
 	int w = pixelWidth;
@@ -334,7 +350,7 @@ void Texture::createTexture()
 			int slices = texType == TEXTURE_VOLUME ? getDepth(mip) : layers;
 			slices = texType == TEXTURE_CUBE ? 6 : slices;
 			for (int i = 0; i < slices; i++)
-				uploadByteData(format, emptydata.data(), emptydata.size(), mip, i, r);
+				uploadByteData(format, emptydata.data(), emptydata.size(), mip, i, r, r.w);
 		}
 	}
 
@@ -344,6 +360,23 @@ void Texture::createTexture()
 		generateMipmaps();
 }
 
+bool Texture::getRecycledTextureKey(RecycledTextureKey &key, bool &srgb) const
+{
+	// Compressed textures don't get their storage allocated up-front.
+	if (isCompressed())
+		return false;
+
+	key.target = OpenGL::getGLTextureType(texType);
+	key.internalFormat = gl.convertPixelFormat(format, false, srgb).internalformat;
+	key.width = pixelWidth;
+	key.height = pixelHeight;
+	key.depth = texType == TEXTURE_VOLUME ? depth : layers;
+	key.mipmapCount = getMipmapCount();
+	key.renderTarget = renderTarget;
+
+	return true;
+}
+
 bool Texture::loadVolatile()
 {
 	if (texture != 0 || renderbuffer != 0)
@@ -400,16 +433,18 @@ bool Texture::loadVolatile()
 
 	setGraphicsMemorySize(memsize);
 
+	loaded = true;
 	return true;
 }
 
 void Texture::unloadVolatile()
 {
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
 	if (isRenderTarget() && (fbo != 0 || renderbuffer != 0 || texture != 0))
 	{
 		// This is a bit ugly, but we need some way to destroy the cached FBO
 		// when this texture's GL object is destroyed.
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 		if (gfx != nullptr)
 			gfx->cleanupRenderTexture(this);
 	}
@@ -421,16 +456,26 @@ void Texture::unloadVolatile()
 		glDeleteRenderbuffers(1, &renderbuffer);
 
 	if (texture != 0)
-		gl.deleteTexture(texture);
+	{
+		RecycledTextureKey recyclekey;
+		bool srgb = sRGB;
+
+		// A texture which failed to load may not have all its storage.
+		if (loaded && gfx != nullptr && getRecycledTextureKey(recyclekey, srgb))
+			gfx->recycleTexture(texture, recyclekey, graphicsMemorySize);
+		else
+			gl.deleteTexture(texture);
+	}
 
 	fbo = 0;
 	renderbuffer = 0;
 	texture = 0;
+	loaded = false;
 
 	setGraphicsMemorySize(0);
 }
 
-void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength)
 {
 	OpenGL::TempDebugGroup debuggroup("Texture data upload");
 
@@ -455,12 +500,32 @@ void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t s
 		else if (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME)
 			glCompressedTexSubImage3D(gltarget, level, r.x, r.y, slice, r.w, r.h, 1, fmt.internalformat, size, data);
 	}
+	else if (rowlength != r.w && !(GLAD_VERSION_1_1 || GLAD_ES_VERSION_3_0))
+	{
+		// No GL_UNPACK_ROW_LENGTH in ES2, so rows are uploaded one at a time.
+		size_t rowsize = getPixelFormatBlockSize(pixelformat) * rowlength;
+		const uint8 *rowdata = (const uint8 *) data;
+
+		for (int y = 0; y < r.h; y++, rowdata += rowsize)
+		{
+			if (texType == TEXTURE_2D || texType == TEXTURE_CUBE)
+				glTexSubImage2D(gltarget, level, r.x, r.y + y, r.w, 1, fmt.externalformat, fmt.type, rowdata);
+			else if (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME)
+				glTexSubImage3D(gltarget, level, r.x, r.y + y, slice, r.w, 1, 1, fmt.externalformat, fmt.type, rowdata);
+		}
+	}
 	else
 	{
+		if (rowlength != r.w)
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, rowlength);
+
 		if (texType == TEXTURE_2D || texType == TEXTURE_CUBE)
 			glTexSubImage2D(gltarget, level, r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, data);
 		else if (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME)
 			glTexSubImage3D(gltarget, level, r.x, r.y, slice, r.w, r.h, 1, fmt.externalformat, fmt.type, data);
+
+		if (rowlength != r.w)
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 	}
 }
 
@@ -525,15 +590,14 @@ void Texture::copyFromBuffer(love::graphics::Buffer *source, size_t sourceoffset
 	GLuint glbuffer = (GLuint) source->getHandle();
 	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, glbuffer);
 
-	if (!isCompressed()) // Not supported in GL with compressed textures...
-		glPixelStorei(GL_UNPACK_ROW_LENGTH, sourcewidth);
+	// Row lengths aren't supported in GL with compressed textures...
+	int rowlength = isCompressed() ? rect.w : sourcewidth;
 
 	// glTexSubImage and friends copy from the active pixel_unpack_buffer by
 	// treating the pointer as a byte offset.
 	const uint8 *byteoffset = (const uint8 *)(ptrdiff_t)sourceoffset;
-	uploadByteData(format, byteoffset, size, mipmap, slice, rect);
+	uploadByteData(format, byteoffset, size, mipmap, slice, rect, rowlength);
 
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
@@ -578,8 +642,19 @@ void Texture::setSamplerState(const SamplerState &s)
 		samplerState.wrapU = samplerState.wrapV = samplerState.wrapW = SamplerState::WRAP_CLAMP;
 	}
 
-	gl.bindTextureToUnit(this, 0, false);
-	gl.setSamplerState(texType, samplerState);
+	if (gl.isSamplerObjectSupported())
+	{
+		// Textures drawn with often-changing filters share cached sampler
+		// objects instead of re-setting their own parameters each time.
+		gl.normalizeSamplerState(samplerState);
+		if (texture != 0)
+			gl.setTextureSampler(texture, gl.getCachedSampler(samplerState));
+	}
+	else
+	{
+		gl.bindTextureToUnit(this, 0, false);
+		gl.setSamplerState(texType, samplerState);
+	}
 }
 
 ptrdiff_t Texture::getHandle() const
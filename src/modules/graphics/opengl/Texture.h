@@ -34,6 +34,26 @@ namespace graphics
 namespace opengl
 {
 
+// The storage layout of a texture object, used to find destroyed textures
+// whose storage can be reused.
+struct RecycledTextureKey
+{
+	GLenum target;
+	GLenum internalFormat;
+	int width;
+	int height;
+	int depth;
+	int mipmapCount;
+	bool renderTarget;
+
+	bool operator == (const RecycledTextureKey &other) const
+	{
+		return target == other.target && internalFormat == other.internalFormat
+			&& width == other.width && height == other.height && depth == other.depth
+			&& mipmapCount == other.mipmapCount && renderTarget == other.renderTarget;
+	}
+};
+
 class Texture final : public love::graphics::Texture, public Volatile
 {
 public:
@@ -62,8 +82,9 @@ public:
 
 private:
 	void createTexture();
+	bool getRecycledTextureKey(RecycledTextureKey &key, bool &srgb) const;
 
-	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) override;
+	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength) override;
 
 	void generateMipmapsInternal() override;
 
@@ -79,6 +100,9 @@ private:
 
 	int actualSamples;
 
+	// Whether the texture finished loading, so its storage can be recycled.
+	bool loaded;
+
 }; // Texture
 
 } // opengl
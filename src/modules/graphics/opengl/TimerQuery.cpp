@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TimerQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+TimerQuery::TimerQuery(love::graphics::Graphics *gfx)
+	: love::graphics::TimerQuery(gfx)
+	, queries()
+{
+	loadVolatile();
+}
+
+TimerQuery::~TimerQuery()
+{
+	unloadVolatile();
+}
+
+bool TimerQuery::loadVolatile()
+{
+	if (queries[0] != 0)
+		return true;
+
+	if (GLAD_VERSION_3_3 || GLAD_ARB_timer_query)
+		glGenQueries(2, queries);
+	else
+		glGenQueriesEXT(2, queries);
+
+	return true;
+}
+
+void TimerQuery::unloadVolatile()
+{
+	if (queries[0] == 0)
+		return;
+
+	if (GLAD_VERSION_3_3 || GLAD_ARB_timer_query)
+		glDeleteQueries(2, queries);
+	else
+		glDeleteQueriesEXT(2, queries);
+
+	queries[0] = queries[1] = 0;
+}
+
+void TimerQuery::timestamp(Timestamp t)
+{
+	if (GLAD_VERSION_3_3 || GLAD_ARB_timer_query)
+		glQueryCounter(queries[t], GL_TIMESTAMP);
+	else
+		glQueryCounterEXT(queries[t], GL_TIMESTAMP_EXT);
+}
+
+bool TimerQuery::getTimestamps(uint64 &startns, uint64 &stopns)
+{
+	bool core = GLAD_VERSION_3_3 || GLAD_ARB_timer_query;
+
+	// The stop timestamp is always written last.
+	GLuint available = 0;
+	if (core)
+		glGetQueryObjectuiv(queries[TIMESTAMP_STOP], GL_QUERY_RESULT_AVAILABLE, &available);
+	else
+		glGetQueryObjectuivEXT(queries[TIMESTAMP_STOP], GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+
+	if (!available)
+		return false;
+
+	GLuint64 results[2] = {0, 0};
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (core)
+			glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &results[i]);
+		else
+			glGetQueryObjectui64vEXT(queries[i], GL_QUERY_RESULT_EXT, &results[i]);
+	}
+
+	// The GPU's timer can become invalid (e.g. when its clock changes) with
+	// EXT_disjoint_timer_query. Report a zero duration in that case.
+	if (!core)
+	{
+		GLint disjoint = 0;
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+		if (disjoint)
+			results[1] = results[0];
+	}
+
+	startns = results[0];
+	stopns = results[1];
+
+	return true;
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "graphics/TimerQuery.h"
+#include "graphics/Volatile.h"
+
+// OpenGL
+#include "OpenGL.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+class TimerQuery final : public love::graphics::TimerQuery, public Volatile
+{
+public:
+
+	TimerQuery(love::graphics::Graphics *gfx);
+	virtual ~TimerQuery();
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+protected:
+
+	void timestamp(Timestamp t) override;
+	bool getTimestamps(uint64 &startns, uint64 &stopns) override;
+
+private:
+
+	GLuint queries[2];
+
+}; // TimerQuery
+
+} // opengl
+} // graphics
+} // love
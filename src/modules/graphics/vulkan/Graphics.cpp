@@ -21,14 +21,19 @@
 #include "common/Exception.h"
 #include "common/pixelformat.h"
 #include "common/version.h"
+#include "common/Trace.h"
 #include "window/Window.h"
+#include "filesystem/Filesystem.h"
 #include "Buffer.h"
 #include "Graphics.h"
 #include "GraphicsReadback.h"
+#include "TimerQuery.h"
+#include "OcclusionQuery.h"
 #include "Shader.h"
 #include "Vulkan.h"
 
 #include <SDL_vulkan.h>
+#include <SDL_cpuinfo.h>
 
 #include <algorithm>
 #include <vector>
@@ -43,6 +48,10 @@
 #define VMA_IMPLEMENTATION
 #include "libraries/vma/vk_mem_alloc.h"
 
+#ifdef LOVE_ENABLE_TRACY
+#include <tracy/TracyVulkan.hpp>
+#endif
+
 namespace love
 {
 namespace graphics
@@ -59,6 +68,9 @@ static const std::vector<const char*> deviceExtensions = {
 };
 
 constexpr uint32_t USAGES_POLL_INTERVAL = 5000;
+// Periodic memory defragmentation copies at most this much per poll interval.
+constexpr VkDeviceSize DEFRAGMENT_BYTES_PER_PASS = 64 * 1024 * 1024;
+constexpr int MAX_DEFRAGMENT_PASSES = 64;
 
 const char *Graphics::getName() const
 {
@@ -75,6 +87,30 @@ const VmaAllocator Graphics::getVmaAllocator() const
 	return vmaAllocator;
 }
 
+VkResult Graphics::createImage(const VkImageCreateInfo &imageInfo, const VmaAllocationCreateInfo &allocInfo, VkImage &image, VmaAllocation &allocation)
+{
+	VmaAllocationCreateInfo budgetAllocInfo = allocInfo;
+	budgetAllocInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+
+	VkResult result = vmaCreateImage(vmaAllocator, &imageInfo, &budgetAllocInfo, &image, &allocation, nullptr);
+	if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY)
+		result = vmaCreateImage(vmaAllocator, &imageInfo, &allocInfo, &image, &allocation, nullptr);
+
+	return result;
+}
+
+VkResult Graphics::createBuffer(const VkBufferCreateInfo &bufferInfo, const VmaAllocationCreateInfo &allocInfo, VkBuffer &buffer, VmaAllocation &allocation, VmaAllocationInfo *info)
+{
+	VmaAllocationCreateInfo budgetAllocInfo = allocInfo;
+	budgetAllocInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+
+	VkResult result = vmaCreateBuffer(vmaAllocator, &bufferInfo, &budgetAllocInfo, &buffer, &allocation, info);
+	if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY)
+		result = vmaCreateBuffer(vmaAllocator, &bufferInfo, &allocInfo, &buffer, &allocation, info);
+
+	return result;
+}
+
 Graphics::Graphics()
 {
 	if (SDL_Vulkan_LoadLibrary(nullptr))
@@ -150,10 +186,12 @@ void Graphics::clear(OptionalColorD color, OptionalInt stencil, OptionalDouble d
 	rect.rect.extent.width = static_cast<uint32_t>(renderPassState.width);
 	rect.rect.extent.height = static_cast<uint32_t>(renderPassState.height);
 
-	vkCmdClearAttachments(
-		commandBuffers[currentFrame], 
-		static_cast<uint32_t>(attachments.size()), attachments.data(),
-		1, &rect);
+	recordCommands([attachments, rect](VkCommandBuffer commandBuffer) {
+		vkCmdClearAttachments(
+			commandBuffer,
+			static_cast<uint32_t>(attachments.size()), attachments.data(),
+			1, &rect);
+	});
 }
 
 void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt stencil, OptionalDouble depth)
@@ -204,10 +242,12 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 	rect.rect.extent.width = static_cast<uint32_t>(renderPassState.width);
 	rect.rect.extent.height = static_cast<uint32_t>(renderPassState.height);
 
-	vkCmdClearAttachments(
-		commandBuffers[currentFrame],
-		static_cast<uint32_t>(attachments.size()), attachments.data(),
-		1, &rect);
+	recordCommands([attachments = std::move(attachments), rect](VkCommandBuffer commandBuffer) {
+		vkCmdClearAttachments(
+			commandBuffer,
+			static_cast<uint32_t>(attachments.size()), attachments.data(),
+			1, &rect);
+	});
 }
 
 void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
@@ -226,8 +266,8 @@ void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 	else
 	{
 		RenderPassConfiguration renderPassConfiguration{};
-		renderPassConfiguration.colorAttachments.push_back({ swapChainImageFormat, colorbuffers[0], msaaSamples });
-		renderPassConfiguration.staticData.depthAttachment = { findDepthFormat(), depthstencil, msaaSamples };
+		renderPassConfiguration.colorAttachments.push_back({ swapChainImageFormat, colorbuffers[0], false, msaaSamples });
+		renderPassConfiguration.staticData.depthAttachment = { findDepthFormat(), depthstencil, false, msaaSamples };
 		if (msaaSamples & VK_SAMPLE_COUNT_1_BIT)
 			renderPassConfiguration.staticData.resolve = false;
 		else
@@ -335,23 +375,29 @@ void Graphics::submitGpuCommands(bool present, void *screenshotCallbackData)
 				1, &region);
 
 			addReadbackCallback([
+				this,
 				w = swapChainExtent.width,
 				h = swapChainExtent.height,
 				pendingScreenshotCallbacks = pendingScreenshotCallbacks,
 				screenShotReadbackBuffer = screenshotReadbackBuffers.at(currentFrame),
 				screenshotCallbackData = screenshotCallbackData]() {
-				auto imageModule = Module::getInstance<love::image::Image>(M_IMAGE);
+				StrongRef<image::ImageData> img;
 
-				for (const auto &info : pendingScreenshotCallbacks)
+				try
+				{
+					img.set(newScreenshotImageData(
+						(int) w,
+						(int) h,
+						screenShotReadbackBuffer.allocationInfo.pMappedData), Acquire::NORETAIN);
+				}
+				catch (love::Exception &)
 				{
-					image::ImageData *img = imageModule->newImageData(
-						w,
-						h,
-						PIXELFORMAT_RGBA8_UNORM,
-						screenShotReadbackBuffer.allocationInfo.pMappedData);
-					info.callback(&info, img, screenshotCallbackData);
-					img->release();
+					for (const auto &info : pendingScreenshotCallbacks)
+						info.callback(&info, nullptr, nullptr);
+					throw;
 				}
+
+				callScreenshotCallbacks(pendingScreenshotCallbacks, img, screenshotCallbackData);
 			});
 
 			pendingScreenshotCallbacks.clear();
@@ -364,40 +410,60 @@ void Graphics::submitGpuCommands(bool present, void *screenshotCallbackData)
 		vkWaitForFences(device, 1, &imagesInFlight.at(imageIndex), VK_TRUE, UINT64_MAX);
 	imagesInFlight[imageIndex] = inFlightFences[currentFrame];
 
-	std::array<VkCommandBuffer, 1> submitCommandbuffers = { commandBuffers.at(currentFrame) };
+	finishRenderPassRecordJobs();
+	submitCommandBuffers.push_back(commandBuffers.at(currentFrame));
 
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	VkSemaphore waitSemaphores[] = { imageAvailableSemaphores.at(currentFrame) };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT };
+	std::vector<VkSemaphore> waitSemaphores;
+	std::vector<VkPipelineStageFlags> waitStages;
 
 	if (imageRequested)
 	{
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-		submitInfo.pWaitDstStageMask = waitStages;
+		waitSemaphores.push_back(imageAvailableSemaphores.at(currentFrame));
+		waitStages.push_back(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
 		imageRequested = false;
 	}
 
-	submitInfo.commandBufferCount = static_cast<uint32_t>(submitCommandbuffers.size());
-	submitInfo.pCommandBuffers = submitCommandbuffers.data();
+	addComputeWaitSemaphores(waitSemaphores, waitStages);
+
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+	submitInfo.pWaitSemaphores = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = waitStages.data();
+
+	submitInfo.commandBufferCount = static_cast<uint32_t>(submitCommandBuffers.size());
+	submitInfo.pCommandBuffers = submitCommandBuffers.data();
 
-	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores.at(currentFrame) };
+	// Async compute work is submitted at the end of the frame, after
+	// everything it could depend on.
+	bool submitCompute = present && asyncComputeRecording;
+
+	std::vector<VkSemaphore> signalSemaphores;
 
 	VkFence fence = VK_NULL_HANDLE;
 
 	if (present)
 	{
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = signalSemaphores;
+		signalSemaphores.push_back(renderFinishedSemaphores.at(currentFrame));
+		if (submitCompute)
+			signalSemaphores.push_back(computeStartSemaphores.at(currentFrame));
+
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
 
 		vkResetFences(device, 1, &inFlightFences[currentFrame]);
 		fence = inFlightFences[currentFrame];
 	}
 
-	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+	VkResult result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence);
+	submitCommandBuffers.clear();
+
+	if (result != VK_SUCCESS)
 		throw love::Exception("failed to submit draw command buffer");
+
+	if (submitCompute)
+		submitAsyncCompute();
 	
 	if (!present)
 	{
@@ -414,8 +480,87 @@ void Graphics::submitGpuCommands(bool present, void *screenshotCallbackData)
 	}
 }
 
+void Graphics::addComputeWaitSemaphores(std::vector<VkSemaphore> &semaphores, std::vector<VkPipelineStageFlags> &stages)
+{
+	for (size_t i = 0; i < computeSemaphoresSignaled.size(); i++)
+	{
+		if (!computeSemaphoresSignaled[i])
+			continue;
+
+		// This frame's semaphore has to be unsignaled before it's used for new
+		// async compute work. The work was waited for in beginFrame, so this
+		// doesn't stall.
+		bool requested = requestedComputeFence != 0 && computeFenceValues[i] <= requestedComputeFence;
+
+		if (requested || i == currentFrame)
+		{
+			semaphores.push_back(computeFinishedSemaphores[i]);
+			stages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+			computeSemaphoresSignaled[i] = false;
+		}
+	}
+
+	// Work which hasn't been submitted yet is waited for in a later submission.
+	if (requestedComputeFence < nextComputeFence)
+		requestedComputeFence = 0;
+}
+
+void Graphics::submitAsyncCompute()
+{
+	VkCommandBuffer commandBuffer = computeCommandBuffers.at(currentFrame);
+	asyncComputeRecording = false;
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record command buffer");
+
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &computeStartSemaphores.at(currentFrame);
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &computeFinishedSemaphores.at(currentFrame);
+
+	vkResetFences(device, 1, &computeFences.at(currentFrame));
+
+	if (vkQueueSubmit(computeQueue, 1, &submitInfo, computeFences.at(currentFrame)) != VK_SUCCESS)
+		throw love::Exception("failed to submit compute command buffer");
+
+	computeFenceValues.at(currentFrame) = nextComputeFence++;
+	computeSemaphoresSignaled.at(currentFrame) = true;
+}
+
+bool Graphics::isComputeFenceComplete(uint64 fence)
+{
+	if (fence == 0)
+		return true;
+
+	if (fence >= nextComputeFence)
+		return false;
+
+	for (size_t i = 0; i < computeFenceValues.size(); i++)
+	{
+		if (computeFenceValues[i] == fence)
+			return vkGetFenceStatus(device, computeFences[i]) == VK_SUCCESS;
+	}
+
+	// Older work has been waited for before its frame was reused.
+	return true;
+}
+
+void Graphics::waitComputeFence(uint64 fence)
+{
+	requestedComputeFence = std::max(requestedComputeFence, fence);
+}
+
 void Graphics::present(void *screenshotCallbackdata)
 {
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (!isActive())
 		return;
 
@@ -424,6 +569,8 @@ void Graphics::present(void *screenshotCallbackdata)
 
 	deprecations.draw(this);
 
+	endFrameTimer();
+
 	submitGpuCommands(true, screenshotCallbackdata);
 
 	VkPresentInfoKHR presentInfo{};
@@ -434,6 +581,17 @@ void Graphics::present(void *screenshotCallbackdata)
 	presentInfo.pSwapchains = &swapChain;
 	presentInfo.pImageIndices = &imageIndex;
 
+	uint64_t presentId = lastPresentId + 1;
+
+	VkPresentIdKHR presentIdInfo{};
+	if (optionalDeviceFeatures.presentWait)
+	{
+		presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+		presentIdInfo.swapchainCount = 1;
+		presentIdInfo.pPresentIds = &presentId;
+		presentInfo.pNext = &presentIdInfo;
+	}
+
 	VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
 
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || swapChainRecreationRequested)
@@ -443,6 +601,11 @@ void Graphics::present(void *screenshotCallbackdata)
 	}
 	else if (result != VK_SUCCESS)
 		throw love::Exception("failed to present swap chain image");
+	else
+		lastPresentId = presentId;
+
+	if (lowLatency)
+		waitForPresent();
 
 	for (love::graphics::StreamBuffer *buffer : batchedDrawState.vb)
 		buffer->nextFrame();
@@ -451,6 +614,10 @@ void Graphics::present(void *screenshotCallbackdata)
 	drawCalls = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawsCulled = 0;
+	love::graphics::StreamBuffer::frameBytesUsed = 0;
+	love::graphics::StreamBuffer::frameStalls = 0;
+	Object::resetRefCountStats();
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
@@ -459,6 +626,14 @@ void Graphics::present(void *screenshotCallbackdata)
 	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
 	beginFrame();
+
+	beginFrameTimer();
+
+	updateTextureUploads();
+	updatePendingShaders();
+
+	finishPipelineCompiles(false);
+	startPipelineCompiles();
 }
 
 void Graphics::setViewportSize(int width, int height, int pixelwidth, int pixelheight)
@@ -493,6 +668,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	createSurface();
 	pickPhysicalDevice();
 	createLogicalDevice();
+	createPipelineCache();
 	initVMA();
 	initCapabilities();
 	createSwapChain();
@@ -536,7 +712,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 
 	restoreState(states.back());
 
-	Vulkan::resetShaderSwitches();
+	Vulkan::resetStats();
 
 	frameCounter = 0;
 	currentFrame = 0;
@@ -566,7 +742,12 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_COPY_BUFFER_TO_TEXTURE] = true;
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = true;
 	capabilities.features[FEATURE_COPY_RENDER_TARGET_TO_BUFFER] = true;
-	static_assert(FEATURE_MAX_ENUM == 17, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_TIMER_QUERY] = timestampPeriod > 0.0f;
+	capabilities.features[FEATURE_ASYNC_COMPUTE] = computeQueue != VK_NULL_HANDLE;
+	capabilities.features[FEATURE_INDIRECT_DRAW] = true;
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = true;
+	capabilities.features[FEATURE_CONDITIONAL_RENDER] = false;
+	static_assert(FEATURE_MAX_ENUM == 22, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	VkPhysicalDeviceProperties properties;
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
@@ -592,9 +773,27 @@ void Graphics::initCapabilities()
 	capabilities.textureTypes[TEXTURE_CUBE] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(Stats &stats) const
 {
-	shaderswitches = static_cast<int>(Vulkan::getNumShaderSwitches());
+	stats.shaderSwitches = static_cast<int>(Vulkan::getNumShaderSwitches());
+	stats.pipelineCreations = static_cast<int>(Vulkan::getNumPipelineCreations());
+	stats.samplerCreations = static_cast<int>(Vulkan::getNumSamplerCreations());
+	stats.descriptorWrites = static_cast<int>(Vulkan::getNumDescriptorWrites());
+
+	if (vmaAllocator == VK_NULL_HANDLE)
+		return;
+
+	// Free space inside VMA's memory blocks, small scattered free ranges
+	// mean the memory is fragmented.
+	VmaTotalStatistics vmaStats{};
+	vmaCalculateStatistics(vmaAllocator, &vmaStats);
+
+	const VmaDetailedStatistics &total = vmaStats.total;
+	stats.gpuMemoryReserved = static_cast<int64>(total.statistics.blockBytes);
+	stats.gpuMemoryUnused = static_cast<int64>(total.statistics.blockBytes - total.statistics.allocationBytes);
+	stats.gpuMemoryFreeRanges = static_cast<int>(total.unusedRangeCount);
+	if (total.unusedRangeCount > 0)
+		stats.gpuMemoryLargestFreeRange = static_cast<int64>(total.unusedRangeSizeMax);
 }
 
 void Graphics::unSetMode()
@@ -605,6 +804,12 @@ void Graphics::unSetMode()
 	
 	created = false;
 	vkDeviceWaitIdle(device);
+
+	// Shaders used by in-progress pipeline compiles are about to be unloaded.
+	finishPipelineCompiles(true);
+	queuedPipelines.clear();
+	queuedPipelineShaders.clear();
+
 	Volatile::unloadAll();
 	cleanup();
 }
@@ -637,9 +842,12 @@ void Graphics::setFrontFaceWinding(Winding winding)
 	states.back().winding = winding;
 
 	if (optionalDeviceFeatures.extendedDynamicState)
-		vkCmdSetFrontFaceEXT(
-			commandBuffers.at(currentFrame),
-			Vulkan::getFrontFace(winding));
+	{
+		VkFrontFace frontFace = Vulkan::getFrontFace(winding);
+		recordCommands([frontFace](VkCommandBuffer commandBuffer) {
+			vkCmdSetFrontFaceEXT(commandBuffer, frontFace);
+		});
+	}
 }
 
 void Graphics::setColorMask(ColorChannelMask mask)
@@ -684,16 +892,65 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 	return info;
 }
 
+std::vector<Graphics::MemoryHeap> Graphics::getMemoryHeaps() const
+{
+	std::vector<MemoryHeap> heaps;
+
+	if (vmaAllocator == VK_NULL_HANDLE)
+		return heaps;
+
+	// The budget comes from VK_EXT_memory_budget when it's supported, VMA
+	// estimates it from the heap sizes otherwise.
+	const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+	vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	vmaGetHeapBudgets(vmaAllocator, budgets);
+
+	for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++)
+	{
+		MemoryHeap heap;
+		heap.usage = static_cast<int64>(budgets[i].usage);
+		heap.budget = static_cast<int64>(budgets[i].budget);
+		heap.deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		heaps.push_back(heap);
+	}
+
+	return heaps;
+}
+
 void Graphics::draw(const DrawCommand &cmd)
 {
 	prepareDraw(*cmd.attributes, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
-	vkCmdDraw(
-		commandBuffers.at(currentFrame),
-		static_cast<uint32_t>(cmd.vertexCount),
-		static_cast<uint32_t>(cmd.instanceCount),
-		static_cast<uint32_t>(cmd.vertexStart),
-		0);
+	if (cmd.indirectBuffer != nullptr)
+	{
+		VkBuffer indirectBuffer = (VkBuffer)cmd.indirectBuffer->getHandle();
+		VkDeviceSize offset = static_cast<VkDeviceSize>(cmd.indirectBufferOffset);
+		uint32_t stride = sizeof(DrawIndirectArguments);
+		uint32_t drawCount = static_cast<uint32_t>(cmd.indirectDrawCount);
+		bool multiDraw = optionalDeviceFeatures.multiDrawIndirect;
+
+		recordCommands([=](VkCommandBuffer commandBuffer) {
+			if (multiDraw)
+				vkCmdDrawIndirect(commandBuffer, indirectBuffer, offset, drawCount, stride);
+			else
+			{
+				for (uint32_t i = 0; i < drawCount; i++)
+					vkCmdDrawIndirect(commandBuffer, indirectBuffer, offset + i * stride, 1, stride);
+			}
+		});
+		drawCalls += multiDraw ? 1 : cmd.indirectDrawCount;
+		return;
+	}
+
+	uint32_t vertexCount = static_cast<uint32_t>(cmd.vertexCount);
+	uint32_t instanceCount = static_cast<uint32_t>(cmd.instanceCount);
+	uint32_t vertexStart = static_cast<uint32_t>(cmd.vertexStart);
+
+	recordCommands([=](VkCommandBuffer commandBuffer) {
+		vkCmdDraw(commandBuffer, vertexCount, instanceCount, vertexStart, 0);
+	});
 	drawCalls++;
 }
 
@@ -701,18 +958,38 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 {
 	prepareDraw(*cmd.attributes, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
-		(VkBuffer)cmd.indexBuffer->getHandle(),
-		static_cast<VkDeviceSize>(cmd.indexBufferOffset),
-		Vulkan::getVulkanIndexBufferType(cmd.indexType));
-	vkCmdDrawIndexed(
-		commandBuffers.at(currentFrame),
-		static_cast<uint32_t>(cmd.indexCount),
-		static_cast<uint32_t>(cmd.instanceCount),
-		0,
-		0,
-		0);
+	VkBuffer indexBuffer = (VkBuffer)cmd.indexBuffer->getHandle();
+	VkDeviceSize indexBufferOffset = static_cast<VkDeviceSize>(cmd.indexBufferOffset);
+	VkIndexType indexType = Vulkan::getVulkanIndexBufferType(cmd.indexType);
+	uint32_t indexCount = static_cast<uint32_t>(cmd.indexCount);
+	uint32_t instanceCount = static_cast<uint32_t>(cmd.instanceCount);
+
+	if (cmd.indirectBuffer != nullptr)
+	{
+		VkBuffer indirectBuffer = (VkBuffer)cmd.indirectBuffer->getHandle();
+		VkDeviceSize offset = static_cast<VkDeviceSize>(cmd.indirectBufferOffset);
+		uint32_t stride = sizeof(DrawIndexedIndirectArguments);
+		uint32_t drawCount = static_cast<uint32_t>(cmd.indirectDrawCount);
+		bool multiDraw = optionalDeviceFeatures.multiDrawIndirect;
+
+		recordCommands([=](VkCommandBuffer commandBuffer) {
+			vkCmdBindIndexBuffer(commandBuffer, indexBuffer, indexBufferOffset, indexType);
+			if (multiDraw)
+				vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, offset, drawCount, stride);
+			else
+			{
+				for (uint32_t i = 0; i < drawCount; i++)
+					vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, offset + i * stride, 1, stride);
+			}
+		});
+		drawCalls += multiDraw ? 1 : cmd.indirectDrawCount;
+		return;
+	}
+
+	recordCommands([=](VkCommandBuffer commandBuffer) {
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer, indexBufferOffset, indexType);
+		vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+	});
 	drawCalls++;
 }
 
@@ -723,11 +1000,11 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 
 	prepareDraw(attributes, buffers, texture, PRIMITIVE_TRIANGLES, CULL_BACK);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
-		(VkBuffer)quadIndexBuffer->getHandle(),
-		0,
-		Vulkan::getVulkanIndexBufferType(INDEX_UINT16));
+	VkBuffer indexBuffer = (VkBuffer)quadIndexBuffer->getHandle();
+
+	recordCommands([indexBuffer](VkCommandBuffer commandBuffer) {
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+	});
 
 	int baseVertex = start * 4;
 
@@ -735,13 +1012,11 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 	{
 		int quadcount = std::min(MAX_QUADS_PER_DRAW, count - quadindex);
 
-		vkCmdDrawIndexed(
-			commandBuffers.at(currentFrame),
-			static_cast<uint32_t>(quadcount * 6),
-			1,
-			0,
-			baseVertex,
-			0);
+		uint32_t indexCount = static_cast<uint32_t>(quadcount * 6);
+
+		recordCommands([indexCount, baseVertex](VkCommandBuffer commandBuffer) {
+			vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, baseVertex, 0);
+		});
 		baseVertex += quadcount * 4;
 
 		drawCalls++;
@@ -807,7 +1082,9 @@ void Graphics::setScissor(const Rect &rect)
 	flushBatchedDraws();
 
 	VkRect2D scissor = computeScissor(rect, static_cast<double>(swapChainExtent.width), static_cast<double>(swapChainExtent.height), getCurrentDPIScale(), preTransform);
-	vkCmdSetScissor(commandBuffers.at(currentFrame), 0, 1, &scissor);
+	recordCommands([scissor](VkCommandBuffer commandBuffer) {
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	});
 
 	states.back().scissor = true;
 	states.back().scissorRect = rect;
@@ -823,7 +1100,9 @@ void Graphics::setScissor()
 	scissor.offset = { 0, 0 };
 	scissor.extent = swapChainExtent;
 
-	vkCmdSetScissor(commandBuffers.at(currentFrame), 0, 1, &scissor);
+	recordCommands([scissor](VkCommandBuffer commandBuffer) {
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	});
 }
 
 void Graphics::setStencilMode(StencilAction action, CompareMode compare, int value, love::uint32 readmask, love::uint32 writemask)
@@ -841,17 +1120,22 @@ void Graphics::setStencilMode(StencilAction action, CompareMode compare, int val
 
 	flushBatchedDraws();
 
-	vkCmdSetStencilWriteMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, writemask);
-	
-	vkCmdSetStencilCompareMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, readmask);
-	vkCmdSetStencilReference(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, value);
+	bool extendedDynamicState = optionalDeviceFeatures.extendedDynamicState;
+	VkStencilOp stencilOp = Vulkan::getStencilOp(action);
+	VkCompareOp compareOp = Vulkan::getCompareOp(getReversedCompareMode(compare));
 
-	if (optionalDeviceFeatures.extendedDynamicState)
-		vkCmdSetStencilOpEXT(
-			commandBuffers.at(currentFrame),
-			VK_STENCIL_FRONT_AND_BACK,
-			VK_STENCIL_OP_KEEP, Vulkan::getStencilOp(action),
-			VK_STENCIL_OP_KEEP, Vulkan::getCompareOp(getReversedCompareMode(compare)));
+	recordCommands([=](VkCommandBuffer commandBuffer) {
+		vkCmdSetStencilWriteMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, writemask);
+		vkCmdSetStencilCompareMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, readmask);
+		vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, value);
+
+		if (extendedDynamicState)
+			vkCmdSetStencilOpEXT(
+				commandBuffer,
+				VK_STENCIL_FRONT_AND_BACK,
+				VK_STENCIL_OP_KEEP, stencilOp,
+				VK_STENCIL_OP_KEEP, compareOp);
+	});
 
 	states.back().stencil.action = action;
 	states.back().stencil.compare = compare;
@@ -866,11 +1150,13 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 	if (optionalDeviceFeatures.extendedDynamicState)
 	{
-		vkCmdSetDepthCompareOpEXT(
-			commandBuffers.at(currentFrame), Vulkan::getCompareOp(compare));
+		VkCompareOp compareOp = Vulkan::getCompareOp(compare);
+		VkBool32 writeEnable = Vulkan::getBool(write);
 
-		vkCmdSetDepthWriteEnableEXT(
-			commandBuffers.at(currentFrame), Vulkan::getBool(write));
+		recordCommands([compareOp, writeEnable](VkCommandBuffer commandBuffer) {
+			vkCmdSetDepthCompareOpEXT(commandBuffer, compareOp);
+			vkCmdSetDepthWriteEnableEXT(commandBuffer, writeEnable);
+		});
 	}
 
 	states.back().depthTest = compare;
@@ -979,6 +1265,16 @@ Renderer Graphics::getRenderer() const
 	return RENDERER_VULKAN;
 }
 
+love::graphics::TimerQuery *Graphics::newTimerQuery()
+{
+	return new TimerQuery(this);
+}
+
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery(bool precise)
+{
+	return new OcclusionQuery(this, precise);
+}
+
 graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method, love::graphics::Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	return new GraphicsReadback(this, method, buffer, offset, size, dest, destoffset);
@@ -989,14 +1285,14 @@ graphics::GraphicsReadback *Graphics::newReadbackInternal(ReadbackMethod method,
 	return new GraphicsReadback(this, method, texture, slice, mipmap, rect, dest, destx, desty);
 }
 
-graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles)
+graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv)
 {
-	return new ShaderStage(this, stage, source, gles, cachekey);
+	return new ShaderStage(this, stage, source, gles, cachekey, prebuiltspirv);
 }
 
-graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM])
+graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection)
 {
-	return new Shader(stages);
+	return new Shader(stages, prebuiltreflection);
 }
 
 graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage type, size_t size)
@@ -1004,6 +1300,35 @@ graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage type, size_t size)
 	return new StreamBuffer(this, type, size);
 }
 
+bool Graphics::dispatchAsync(int x, int y, int z, uint64 &fence)
+{
+	if (computeQueue == VK_NULL_HANDLE)
+		return love::graphics::Graphics::dispatchAsync(x, y, z, fence);
+
+	VkCommandBuffer commandBuffer = computeCommandBuffers.at(currentFrame);
+
+	if (!asyncComputeRecording)
+	{
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw love::Exception("failed to begin recording command buffer");
+
+		asyncComputeRecording = true;
+	}
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
+
+	computeShader->cmdPushDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, commandBuffer);
+
+	vkCmdDispatch(commandBuffer, static_cast<uint32_t>(x), static_cast<uint32_t>(y), static_cast<uint32_t>(z));
+
+	fence = nextComputeFence;
+	return true;
+}
+
 bool Graphics::dispatch(int x, int y, int z)
 {
 	if (renderPassState.active)
@@ -1011,7 +1336,7 @@ bool Graphics::dispatch(int x, int y, int z)
 
 	vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
 
-	computeShader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE);
+	computeShader->cmdPushDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatch(commandBuffers.at(currentFrame), static_cast<uint32_t>(x), static_cast<uint32_t>(y), static_cast<uint32_t>(z));
 
@@ -1040,31 +1365,75 @@ void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int pixelw, in
 
 void Graphics::initDynamicState()
 {
-	if (states.back().scissor)
-		setScissor(states.back().scissorRect);
-	else
-		setScissor();
-
-	vkCmdSetStencilWriteMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.writeMask);
-	vkCmdSetStencilCompareMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.readMask);
-	vkCmdSetStencilReference(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.value);
+	const auto &state = states.back();
 
-	if (optionalDeviceFeatures.extendedDynamicState)
-	{
-		 vkCmdSetStencilOpEXT(
-			commandBuffers.at(currentFrame),
-			VK_STENCIL_FRONT_AND_BACK,
-			VK_STENCIL_OP_KEEP, Vulkan::getStencilOp(states.back().stencil.action),
-			VK_STENCIL_OP_KEEP, Vulkan::getCompareOp(getReversedCompareMode(states.back().stencil.compare)));
+	// This can happen in the middle of flushing a batch, so the scissor is set
+	// directly instead of through setScissor.
+	VkRect2D scissor{};
+	if (state.scissor)
+		scissor = computeScissor(state.scissorRect, static_cast<double>(swapChainExtent.width), static_cast<double>(swapChainExtent.height), getCurrentDPIScale(), preTransform);
+	else
+		scissor.extent = swapChainExtent;
+
+	bool extendedDynamicState = optionalDeviceFeatures.extendedDynamicState;
+	uint32_t writeMask = state.stencil.writeMask;
+	uint32_t readMask = state.stencil.readMask;
+	uint32_t reference = static_cast<uint32_t>(state.stencil.value);
+	VkStencilOp stencilOp = Vulkan::getStencilOp(state.stencil.action);
+	VkCompareOp stencilCompareOp = Vulkan::getCompareOp(getReversedCompareMode(state.stencil.compare));
+	VkCompareOp depthCompareOp = Vulkan::getCompareOp(state.depthTest);
+	VkBool32 depthWrite = Vulkan::getBool(state.depthWrite);
+	VkFrontFace frontFace = Vulkan::getFrontFace(state.winding);
+
+	recordCommands([=](VkCommandBuffer commandBuffer) {
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		vkCmdSetStencilWriteMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, writeMask);
+		vkCmdSetStencilCompareMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, readMask);
+		vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, reference);
+
+		if (extendedDynamicState)
+		{
+			vkCmdSetStencilOpEXT(
+				commandBuffer,
+				VK_STENCIL_FRONT_AND_BACK,
+				VK_STENCIL_OP_KEEP, stencilOp,
+				VK_STENCIL_OP_KEEP, stencilCompareOp);
+
+			vkCmdSetDepthCompareOpEXT(commandBuffer, depthCompareOp);
+			vkCmdSetDepthWriteEnableEXT(commandBuffer, depthWrite);
+			vkCmdSetFrontFaceEXT(commandBuffer, frontFace);
+		}
+	});
+}
 
-		vkCmdSetDepthCompareOpEXT(
-			commandBuffers.at(currentFrame), Vulkan::getCompareOp(states.back().depthTest));
+void Graphics::waitForFrame(uint32_t framesago)
+{
+	size_t frame = (currentFrame + MAX_FRAMES_IN_FLIGHT - framesago) % MAX_FRAMES_IN_FLIGHT;
+	vkWaitForFences(device, 1, &inFlightFences[frame], VK_TRUE, UINT64_MAX);
+}
 
-		vkCmdSetDepthWriteEnableEXT(
-			commandBuffers.at(currentFrame), Vulkan::getBool(states.back().depthWrite));
+void Graphics::waitForPresent()
+{
+	// Called after currentFrame has been presented. Wait until the frames
+	// before the newest framesInFlight - 1 ones are on screen, so the next
+	// frame starts (and reads input) as late as possible.
+	uint32_t framesago = (uint32_t) framesInFlight - 1;
 
-		vkCmdSetFrontFaceEXT(
-			commandBuffers.at(currentFrame), Vulkan::getFrontFace(states.back().winding));
+	if (optionalDeviceFeatures.presentWait)
+	{
+		if (lastPresentId > framesago)
+		{
+			// Don't wait forever if the window is hidden or minimized and
+			// nothing is being displayed.
+			const uint64_t timeout = 100 * 1000 * 1000;
+			vkWaitForPresentKHR(device, swapChain, lastPresentId - framesago, timeout);
+		}
+	}
+	else
+	{
+		// The closest thing without present_wait is waiting for the GPU.
+		waitForFrame(framesago);
 	}
 }
 
@@ -1072,11 +1441,34 @@ void Graphics::beginFrame()
 {
 	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
-	if (frameCounter >= USAGES_POLL_INTERVAL)
+	// The frame which used these resources last is MAX_FRAMES_IN_FLIGHT
+	// frames old. When fewer frames in flight are requested, also wait for a
+	// newer one.
+	if ((uint32_t) framesInFlight < MAX_FRAMES_IN_FLIGHT)
+		waitForFrame((uint32_t) framesInFlight);
+
+	// Async compute work from this frame uses its descriptor sets and uniform
+	// buffers as well.
+	if (computeFenceValues.at(currentFrame) != 0)
+		vkWaitForFences(device, 1, &computeFences.at(currentFrame), VK_TRUE, UINT64_MAX);
+
+	bool pollUsages = frameCounter >= USAGES_POLL_INTERVAL;
+
+	if (pollUsages || defragmentRequested)
 	{
 		vkDeviceWaitIdle(device);
-		cleanupUnusedObjects();
-		frameCounter = 0;
+
+		if (pollUsages)
+		{
+			cleanupUnusedObjects();
+			frameCounter = 0;
+		}
+
+		// Long sessions which keep creating and destroying textures leave
+		// VMA's memory blocks sparsely used, so a little is compacted every
+		// poll interval while nothing is in flight.
+		compactMemory(defragmentRequested ? MAX_DEFRAGMENT_PASSES : 1);
+		defragmentRequested = false;
 	}
 
 	while (true)
@@ -1129,13 +1521,44 @@ void Graphics::beginFrame()
 		transitionColorDepthLayouts = false;
 	}
 
-	Vulkan::resetShaderSwitches();
+	Vulkan::resetStats();
 
 	usedShadersInFrame.clear();
 }
 
 void Graphics::startRecordingGraphicsCommands()
 {
+	// Everything recorded with this frame's command buffers has finished
+	// executing at this point, so they can all be reused.
+	usedCommandBufferSegments = 0;
+	usedRenderPassRecordJobs = 0;
+
+	beginCommandBufferSegment();
+
+	setDefaultRenderPass();
+}
+
+void Graphics::beginCommandBufferSegment()
+{
+	auto &segments = commandBufferSegments.at(currentFrame);
+
+	if (usedCommandBufferSegments >= segments.size())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw love::Exception("failed to allocate command buffers");
+
+		segments.push_back(commandBuffer);
+	}
+
+	commandBuffers.at(currentFrame) = segments.at(usedCommandBufferSegments++);
+
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
@@ -1144,15 +1567,80 @@ void Graphics::startRecordingGraphicsCommands()
 	if (vkBeginCommandBuffer(commandBuffers.at(currentFrame), &beginInfo) != VK_SUCCESS)
 		throw love::Exception("failed to begin recording command buffer");
 
+	beginGPUZone(commandBuffers.at(currentFrame));
+
+	// Bound and dynamic state doesn't carry over between command buffers.
+	renderPassState.pipeline = VK_NULL_HANDLE;
 	initDynamicState();
+}
 
-	setDefaultRenderPass();
+void Graphics::beginGPUZone(VkCommandBuffer commandBuffer)
+{
+#ifdef LOVE_ENABLE_TRACY
+	if (tracyContext == nullptr)
+		return;
+
+	// Query results are read back and their queries reset once per frame,
+	// before any render pass has started.
+	if (usedCommandBufferSegments == 1)
+		TracyVkCollect(tracyContext, commandBuffer);
+
+	static constexpr tracy::SourceLocationData location { "Command buffer", "Graphics::beginCommandBufferSegment", __FILE__, __LINE__, 0 };
+	tracyZone = new tracy::VkCtxScope(tracyContext, &location, commandBuffer, true);
+#else
+	LOVE_UNUSED(commandBuffer);
+#endif
+}
+
+void Graphics::endGPUZone()
+{
+#ifdef LOVE_ENABLE_TRACY
+	// Ending the scope writes its closing timestamp into the command buffer.
+	delete tracyZone;
+	tracyZone = nullptr;
+#endif
+}
+
+void Graphics::startRenderPassRecordJob()
+{
+	VkCommandBuffer commandBuffer = commandBuffers.at(currentFrame);
+	endGPUZone();
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record command buffer");
+	submitCommandBuffers.push_back(commandBuffer);
+
+	auto &jobs = renderPassRecordJobs.at(currentFrame);
+	if (usedRenderPassRecordJobs >= jobs.size())
+		jobs.emplace_back(new RenderPassRecordJob(this), Acquire::NORETAIN);
+
+	recordingRenderPass = jobs.at(usedRenderPassRecordJobs++);
+	submitCommandBuffers.push_back(recordingRenderPass->getCommandBuffer());
+
+	renderPassState.pipeline = VK_NULL_HANDLE;
+	initDynamicState();
+}
+
+void Graphics::finishRenderPassRecordJobs()
+{
+	bool failed = false;
+
+	for (size_t i = 0; i < usedRenderPassRecordJobs; i++)
+	{
+		RenderPassRecordJob *job = renderPassRecordJobs.at(currentFrame).at(i);
+		job->wait();
+		failed = failed || job->hasFailed();
+	}
+
+	if (failed)
+		throw love::Exception("failed to record render pass command buffer");
 }
 
 void Graphics::endRecordingGraphicsCommands() {
 	if (renderPassState.active)
 		endRenderPass();
 
+	endGPUZone();
+
 	if (vkEndCommandBuffer(commandBuffers.at(currentFrame)) != VK_SUCCESS)
 		throw love::Exception("failed to record command buffer");
 }
@@ -1162,6 +1650,16 @@ const VkDeviceSize Graphics::getMinUniformBufferOffsetAlignment() const
 	return minUniformBufferOffsetAlignment;
 }
 
+float Graphics::getTimestampPeriod() const
+{
+	return timestampPeriod;
+}
+
+uint32_t Graphics::getTimestampValidBits() const
+{
+	return timestampValidBits;
+}
+
 graphics::Texture *Graphics::getDefaultTexture() const
 {
 	return defaultTexture;
@@ -1353,8 +1851,23 @@ void Graphics::pickPhysicalDevice()
 	VkPhysicalDeviceProperties properties;
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 	minUniformBufferOffsetAlignment = properties.limits.minUniformBufferOffsetAlignment;
+	timestampPeriod = properties.limits.timestampComputeAndGraphics ? properties.limits.timestampPeriod : 0.0f;
 	deviceApiVersion = properties.apiVersion;
 
+	// Timestamps written on the graphics queue only have this many low bits
+	// set, and wrap around past them.
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+	if (indices.graphicsFamily.hasValue && indices.graphicsFamily.value < queueFamilyCount)
+		timestampValidBits = queueFamilies[indices.graphicsFamily.value].timestampValidBits;
+
+	if (timestampValidBits == 0)
+		timestampPeriod = 0.0f;
+
 	msaaSamples = getMsaaCount(requestedMsaa);
 }
 
@@ -1450,6 +1963,18 @@ QueueFamilyIndices Graphics::findQueueFamilies(VkPhysicalDevice device)
 		i++;
 	}
 
+	// Compute-only families are usually separate hardware queues which can
+	// run alongside rendering.
+	for (uint32_t j = 0; j < queueFamilyCount; j++)
+	{
+		VkQueueFlags flags = queueFamilies[j].queueFlags;
+		if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			indices.computeFamily = j;
+			break;
+		}
+	}
+
 	return indices;
 }
 
@@ -1477,6 +2002,10 @@ static void findOptionalDeviceExtensions(VkPhysicalDevice physicalDevice, Option
 			optionalDeviceFeatures.shaderFloatControls = true;
 		if (strcmp(extension.extensionName, VK_KHR_SPIRV_1_4_EXTENSION_NAME) == 0)
 			optionalDeviceFeatures.spirv14 = true;
+		if (strcmp(extension.extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0)
+			optionalDeviceFeatures.presentId = true;
+		if (strcmp(extension.extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0)
+			optionalDeviceFeatures.presentWait = true;
 	}
 }
 
@@ -1489,6 +2018,8 @@ void Graphics::createLogicalDevice()
 		indices.graphicsFamily.value,
 		indices.presentFamily.value
 	};
+	if (indices.computeFamily.hasValue)
+		uniqueQueueFamilies.insert(indices.computeFamily.value);
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -1517,10 +2048,40 @@ void Graphics::createLogicalDevice()
 		optionalDeviceFeatures.spirv14 = false;
 	if (optionalDeviceFeatures.spirv14 && deviceApiVersion < VK_API_VERSION_1_1)
 		optionalDeviceFeatures.spirv14 = false;
+	if (optionalDeviceFeatures.presentWait && !optionalDeviceFeatures.presentId)
+		optionalDeviceFeatures.presentWait = false;
+	if (optionalDeviceFeatures.presentWait && !optionalInstanceExtensions.physicalDeviceProperties2)
+		optionalDeviceFeatures.presentWait = false;
+
+	// The extensions can be listed without the features being supported.
+	VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+	presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+	VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+	presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+	if (optionalDeviceFeatures.presentWait)
+	{
+		presentIdFeatures.pNext = &presentWaitFeatures;
+
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &presentIdFeatures;
+		vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+
+		optionalDeviceFeatures.presentWait = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+	}
+
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	optionalDeviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+	optionalDeviceFeatures.occlusionQueryPrecise = supportedFeatures.occlusionQueryPrecise == VK_TRUE;
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 	deviceFeatures.fillModeNonSolid = VK_TRUE;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	deviceFeatures.occlusionQueryPrecise = supportedFeatures.occlusionQueryPrecise;
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1543,6 +2104,11 @@ void Graphics::createLogicalDevice()
 		enabledExtensions.push_back(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
 	if (optionalDeviceFeatures.spirv14)
 		enabledExtensions.push_back(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
+	if (optionalDeviceFeatures.presentWait)
+	{
+		enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+		enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+	}
 	if (deviceApiVersion >= VK_API_VERSION_1_1)
 		enabledExtensions.push_back(VK_KHR_BIND_MEMORY_2_EXTENSION_NAME);
 
@@ -1558,7 +2124,7 @@ void Graphics::createLogicalDevice()
 	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{};
 	extendedDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
 	extendedDynamicStateFeatures.extendedDynamicState = Vulkan::getBool(optionalDeviceFeatures.extendedDynamicState);
-	extendedDynamicStateFeatures.pNext = nullptr;
+	extendedDynamicStateFeatures.pNext = optionalDeviceFeatures.presentWait ? &presentIdFeatures : nullptr;
 
 	createInfo.pNext = &extendedDynamicStateFeatures;
 
@@ -1569,6 +2135,96 @@ void Graphics::createLogicalDevice()
 
 	vkGetDeviceQueue(device, indices.graphicsFamily.value, 0, &graphicsQueue);
 	vkGetDeviceQueue(device, indices.presentFamily.value, 0, &presentQueue);
+
+	computeQueue = VK_NULL_HANDLE;
+	resourceQueueFamilies.clear();
+
+	if (indices.computeFamily.hasValue)
+	{
+		vkGetDeviceQueue(device, indices.computeFamily.value, 0, &computeQueue);
+		resourceQueueFamilies = { indices.graphicsFamily.value, indices.computeFamily.value };
+	}
+}
+
+std::string Graphics::getPipelineCacheFilename() const
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	// Caches are only valid for the device and driver which created them, the
+	// UUID identifies both.
+	std::string key((const char *) properties.pipelineCacheUUID, VK_UUID_SIZE);
+	return getCacheFilename("vulkanpipelinecache", key, ".bin");
+}
+
+void Graphics::createPipelineCache()
+{
+	StrongRef<love::filesystem::FileData> data;
+
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs != nullptr)
+	{
+		std::string filename = getPipelineCacheFilename();
+		love::filesystem::Filesystem::Info info = {};
+
+		try
+		{
+			if (fs->getInfo(filename.c_str(), info))
+				data.set(fs->read(filename.c_str()), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+		}
+	}
+
+	VkPipelineCacheCreateInfo cacheInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+	// Some drivers don't cope well with mismatched data, so the header is
+	// checked here rather than relying on them to reject it.
+	if (data.get() != nullptr && data->getSize() >= 16 + VK_UUID_SIZE)
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		const uint8 *bytes = (const uint8 *) data->getData();
+		uint32 header[4];
+		memcpy(header, bytes, sizeof(header));
+
+		if (header[0] >= 16 + VK_UUID_SIZE
+			&& header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header[2] == properties.vendorID
+			&& header[3] == properties.deviceID
+			&& memcmp(bytes + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+		{
+			cacheInfo.initialDataSize = data->getSize();
+			cacheInfo.pInitialData = data->getData();
+		}
+	}
+
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+	{
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData = nullptr;
+		if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+			pipelineCache = VK_NULL_HANDLE;
+	}
+}
+
+void Graphics::savePipelineCache()
+{
+	if (pipelineCache == VK_NULL_HANDLE)
+		return;
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		return;
+
+	std::vector<uint8> data(size);
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+		return;
+
+	saveCacheFile("vulkanpipelinecache", getPipelineCacheFilename(), data.data(), size);
 }
 
 void Graphics::initVMA()
@@ -1734,6 +2390,8 @@ void Graphics::createSwapChain()
 	if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
 		throw love::Exception("failed to create swap chain");
 
+	lastPresentId = 0;
+
 	vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
 	swapChainImages.resize(imageCount);
 	vkGetSwapchainImagesKHR(device, swapChain, &imageCount, swapChainImages.data());
@@ -1924,8 +2582,8 @@ void Graphics::createScreenshotCallbackBuffers()
 void Graphics::createDefaultRenderPass()
 {
 	RenderPassConfiguration renderPassConfiguration{};
-	renderPassConfiguration.colorAttachments.push_back({ swapChainImageFormat, false, msaaSamples });
-	renderPassConfiguration.staticData.depthAttachment = { findDepthFormat(), false, msaaSamples };
+	renderPassConfiguration.colorAttachments.push_back({ swapChainImageFormat, false, false, msaaSamples });
+	renderPassConfiguration.staticData.depthAttachment = { findDepthFormat(), false, false, msaaSamples };
 	if (msaaSamples & VK_SAMPLE_COUNT_1_BIT)
 		renderPassConfiguration.staticData.resolve = false;
 	else
@@ -2003,6 +2661,8 @@ VkFramebuffer Graphics::getFramebuffer(FramebufferConfiguration &configuration)
 
 void Graphics::createDefaultShaders()
 {
+	LOVE_TRACE_STARTUP_STAGE("default shaders");
+
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
 		auto stype = (Shader::StandardShader)i;
@@ -2036,11 +2696,14 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		VkAttachmentDescription colorDescription{};
 		colorDescription.format = colorAttachment.format;
 		colorDescription.samples = colorAttachment.msaaSamples;
-		if (colorAttachment.discard)
+		if (colorAttachment.discard || colorAttachment.memoryless)
 			colorDescription.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		else
 			colorDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-		colorDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		if (colorAttachment.memoryless)
+			colorDescription.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		else
+			colorDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		colorDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorDescription.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -2061,16 +2724,27 @@ VkRenderPass Graphics::createRenderPass(RenderPassConfiguration &configuration)
 		VkAttachmentDescription depthStencilAttachment{};
 		depthStencilAttachment.format = configuration.staticData.depthAttachment.format;
 		depthStencilAttachment.samples = configuration.staticData.depthAttachment.msaaSamples;
-		if (configuration.staticData.depthAttachment.discard)
+		const auto &depthAttachment = configuration.staticData.depthAttachment;
+		if (depthAttachment.discard || depthAttachment.memoryless)
+		{
 			depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		else
-			depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-		depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		if (configuration.staticData.depthAttachment.discard)
 			depthStencilAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		}
 		else
+		{
+			depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 			depthStencilAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-		depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		}
+		if (depthAttachment.memoryless || !depthAttachment.store)
+		{
+			depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		}
+		else
+		{
+			depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		}
 		depthStencilAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 		depthStencilAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 		attachments.push_back(depthStencilAttachment);
@@ -2229,7 +2903,12 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 	configuration.primitiveType = primitiveType;
 
 	if (optionalDeviceFeatures.extendedDynamicState)
-		vkCmdSetCullModeEXT(commandBuffers.at(currentFrame), Vulkan::getCullMode(cullmode));
+	{
+		VkCullModeFlags cullMode = Vulkan::getCullMode(cullmode);
+		recordCommands([cullMode](VkCommandBuffer commandBuffer) {
+			vkCmdSetCullModeEXT(commandBuffer, cullMode);
+		});
+	}
 	else
 	{
 		configuration.dynamicState.winding = states.back().winding;
@@ -2265,8 +2944,11 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 
 	ensureGraphicsPipelineConfiguration(configuration);
 
-	configuration.shader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_GRAPHICS);
-	vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), 0, static_cast<uint32_t>(bufferVector.size()), bufferVector.data(), offsets.data());
+	configuration.shader->cmdPushDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+	recordCommands([bufferVector = std::move(bufferVector), offsets = std::move(offsets)](VkCommandBuffer commandBuffer) {
+		vkCmdBindVertexBuffers(commandBuffer, 0, static_cast<uint32_t>(bufferVector.size()), bufferVector.data(), offsets.data());
+	});
 }
 
 void Graphics::setDefaultRenderPass()
@@ -2297,13 +2979,16 @@ void Graphics::setRenderPass(const RenderTargets &rts, int pixelw, int pixelh, b
 		renderPassConfiguration.colorAttachments.push_back({ 
 			Vulkan::getTextureFormat(color.texture->getPixelFormat(), isPixelFormatSRGB(color.texture->getPixelFormat())).internalFormat,
 			false, 
+			color.texture->isMemoryless(),
 			dynamic_cast<Texture*>(color.texture)->getMsaaSamples() });
 	if (rts.depthStencil.texture != nullptr)
 		if (rts.depthStencil.texture != nullptr)
 			renderPassConfiguration.staticData.depthAttachment = { 
 				Vulkan::getTextureFormat(rts.depthStencil.texture->getPixelFormat(), false).internalFormat,
 				false,
-				dynamic_cast<Texture*>(rts.depthStencil.texture)->getMsaaSamples() };
+				rts.depthStencil.texture->isMemoryless(),
+				dynamic_cast<Texture*>(rts.depthStencil.texture)->getMsaaSamples(),
+				(rts.passFlags & RENDER_PASS_DONT_STORE_DEPTH_STENCIL) == 0 };
 
 	FramebufferConfiguration configuration{};
 
@@ -2343,6 +3028,9 @@ void Graphics::startRenderPass()
 {
 	renderPassState.active = true;
 
+	if (renderPassState.useConfigurations && isParallelRenderPassRecording())
+		startRenderPassRecordJob();
+
 	VkViewport viewport{};
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
@@ -2351,20 +3039,13 @@ void Graphics::startRenderPass()
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
 
-	vkCmdSetViewport(commandBuffers.at(currentFrame), 0, 1, &viewport);
+	recordCommands([viewport](VkCommandBuffer commandBuffer) {
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	});
 
 	if (renderPassState.useConfigurations)
 	{
-		auto &renderPassConfiguration = renderPassState.renderPassConfiguration;
-		VkRenderPass renderPass;
-		auto it = renderPasses.find(renderPassConfiguration);
-		if (it != renderPasses.end())
-			renderPass = it->second;
-		else
-		{
-			renderPass = createRenderPass(renderPassConfiguration);
-			renderPasses[renderPassConfiguration] = renderPass;
-		}
+		VkRenderPass renderPass = getRenderPass(renderPassState.renderPassConfiguration);
 		renderPassState.beginInfo.renderPass = renderPass;
 
 		renderPassUsages[renderPass] = true;
@@ -2372,22 +3053,49 @@ void Graphics::startRenderPass()
 		auto &framebufferConfiguration = renderPassState.framebufferConfiguration;
 		framebufferConfiguration.staticData.renderPass = renderPass;
 		renderPassState.beginInfo.framebuffer = getFramebuffer(framebufferConfiguration);
+
+		// Discards only apply to the start of the pass. If it gets interrupted
+		// by a dispatch or data transfer, the contents have to be loaded again.
+		for (auto &colorAttachment : renderPassState.renderPassConfiguration.colorAttachments)
+			colorAttachment.discard = false;
+		renderPassState.renderPassConfiguration.staticData.depthAttachment.discard = false;
 	}
 
-	for (const auto &image : renderPassState.transitionImages)
-		Vulkan::cmdTransitionImageLayout(commandBuffers.at(currentFrame), image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	recordCommands([transitionImages = renderPassState.transitionImages, beginInfo = renderPassState.beginInfo](VkCommandBuffer commandBuffer) {
+		for (const auto &image : transitionImages)
+			Vulkan::cmdTransitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-	vkCmdBeginRenderPass(commandBuffers.at(currentFrame), &renderPassState.beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	});
+
+	if (activeOcclusionQuery != nullptr)
+		static_cast<OcclusionQuery *>(activeOcclusionQuery)->beginRenderPass();
 }
 
 void Graphics::endRenderPass()
 {
 	renderPassState.active = false;
 
-	vkCmdEndRenderPass(commandBuffers.at(currentFrame));
+	if (activeOcclusionQuery != nullptr)
+		static_cast<OcclusionQuery *>(activeOcclusionQuery)->endRenderPass();
+
+	recordCommands([transitionImages = renderPassState.transitionImages](VkCommandBuffer commandBuffer) {
+		vkCmdEndRenderPass(commandBuffer);
+
+		for (const auto &image : transitionImages)
+			Vulkan::cmdTransitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	});
 
-	for (const auto &image : renderPassState.transitionImages)
-		Vulkan::cmdTransitionImageLayout(commandBuffers.at(currentFrame), image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	if (recordingRenderPass != nullptr)
+	{
+		RenderPassRecordJob *job = recordingRenderPass;
+		recordingRenderPass = nullptr;
+
+		if (!job->start())
+			job->threadFunction();
+
+		beginCommandBufferSegment();
+	}
 }
 
 VkSampler Graphics::createSampler(const SamplerState &samplerState)
@@ -2430,6 +3138,8 @@ VkSampler Graphics::createSampler(const SamplerState &samplerState)
 	if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
 		throw love::Exception("failed to create sampler");
 
+	Vulkan::samplerCreated();
+
 	return sampler;
 }
 
@@ -2465,6 +3175,95 @@ void Graphics::cleanupUnusedObjects()
 	eraseUnusedObjects(graphicsPipelines, pipelineUsages, vkDestroyPipeline, device);
 }
 
+void Graphics::defragmentMemory()
+{
+	// Allocations can only be moved while the GPU isn't using them, and the
+	// current frame's commands may still reference them.
+	defragmentRequested = true;
+}
+
+void Graphics::compactMemory(int maxPasses)
+{
+	VmaDefragmentationInfo defragInfo{};
+	defragInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+	defragInfo.maxBytesPerPass = DEFRAGMENT_BYTES_PER_PASS;
+
+	VmaDefragmentationContext context = VK_NULL_HANDLE;
+	if (vmaBeginDefragmentation(vmaAllocator, &defragInfo, &context) != VK_SUCCESS)
+		return;
+
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		vmaEndDefragmentation(vmaAllocator, context, nullptr);
+		return;
+	}
+
+	std::vector<std::function<void()>> cleanUps;
+
+	for (int pass = 0; pass < maxPasses; pass++)
+	{
+		VmaDefragmentationPassMoveInfo passInfo{};
+		if (vmaBeginDefragmentationPass(vmaAllocator, context, &passInfo) != VK_INCOMPLETE)
+			break;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		for (uint32_t i = 0; i < passInfo.moveCount; i++)
+		{
+			VmaDefragmentationMove &move = passInfo.pMoves[i];
+
+			// Only textures which opted in can be moved. Buffers and other
+			// images have their handles stored in places we can't update.
+			VmaAllocationInfo info{};
+			vmaGetAllocationInfo(vmaAllocator, move.srcAllocation, &info);
+			Texture *texture = (Texture *) info.pUserData;
+
+			std::function<void()> cleanUp;
+			if (texture != nullptr && texture->moveToAllocation(commandBuffer, move.dstTmpAllocation, cleanUp))
+				cleanUps.push_back(cleanUp);
+			else
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+		}
+
+		vkEndCommandBuffer(commandBuffer);
+
+		if (!cleanUps.empty())
+		{
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &commandBuffer;
+
+			if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+				throw love::Exception("failed to submit defragmentation command buffer");
+
+			vkQueueWaitIdle(graphicsQueue);
+
+			for (const auto &cleanUp : cleanUps)
+				cleanUp();
+			cleanUps.clear();
+		}
+
+		if (vmaEndDefragmentationPass(vmaAllocator, context, &passInfo) == VK_SUCCESS)
+			break;
+	}
+
+	vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+
+	vmaEndDefragmentation(vmaAllocator, context, nullptr);
+}
+
 void Graphics::requestSwapchainRecreation()
 {
 	if (swapChain != VK_NULL_HANDLE)
@@ -2646,27 +3445,276 @@ VkPipeline Graphics::createGraphicsPipeline(GraphicsPipelineConfiguration &confi
 	pipelineInfo.renderPass = configuration.renderPass;
 
 	VkPipeline graphicsPipeline;
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
+	if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
 		throw love::Exception("failed to create graphics pipeline");
+
 	return graphicsPipeline;
 }
 
+VkRenderPass Graphics::getRenderPass(RenderPassConfiguration &configuration)
+{
+	auto it = renderPasses.find(configuration);
+	if (it != renderPasses.end())
+		return it->second;
+
+	VkRenderPass renderPass = createRenderPass(configuration);
+	renderPasses[configuration] = renderPass;
+	return renderPass;
+}
+
+void Graphics::precompilePipeline(love::graphics::Shader *shader, const VertexAttributes &attributes, PrimitiveType primitive)
+{
+	if (shader == nullptr || shader->hasStage(SHADERSTAGE_COMPUTE))
+		return;
+
+	// Triangle fans are drawn as indexed triangles.
+	if (primitive == PRIMITIVE_TRIANGLE_FAN)
+		primitive = PRIMITIVE_TRIANGLES;
+
+	GraphicsPipelineConfiguration configuration{};
+
+	if (renderPassState.useConfigurations)
+		configuration.renderPass = getRenderPass(renderPassState.renderPassConfiguration);
+	else
+		configuration.renderPass = defaultRenderPass;
+
+	configuration.vertexAttributes = attributes;
+	configuration.shader = (Shader*)shader;
+	configuration.wireFrame = states.back().wireframe;
+	configuration.blendState = states.back().blend;
+	configuration.colorChannelMask = states.back().colorMask;
+	configuration.msaaSamples = renderPassState.msaa;
+	configuration.numColorAttachments = renderPassState.numColorAttachments;
+	configuration.primitiveType = primitive;
+
+	if (!optionalDeviceFeatures.extendedDynamicState)
+	{
+		configuration.dynamicState.winding = states.back().winding;
+		configuration.dynamicState.depthState.compare = states.back().depthTest;
+		configuration.dynamicState.depthState.write = states.back().depthWrite;
+		configuration.dynamicState.stencilAction = states.back().stencil.action;
+		configuration.dynamicState.stencilCompare = states.back().stencil.compare;
+		configuration.dynamicState.cullmode = CULL_NONE;
+	}
+
+	if (graphicsPipelines.find(configuration) != graphicsPipelines.end())
+		return;
+
+	if (std::find(queuedPipelines.begin(), queuedPipelines.end(), configuration) != queuedPipelines.end())
+		return;
+
+	for (const auto &job : pipelineCompileJobs)
+	{
+		if (std::find(job->configurations.begin(), job->configurations.end(), configuration) != job->configurations.end())
+			return;
+	}
+
+	queuedPipelines.push_back(configuration);
+	queuedPipelineShaders.push_back((Shader*)shader);
+}
+
+int Graphics::getPrecompilingPipelineCount() const
+{
+	size_t count = queuedPipelines.size();
+	for (const auto &job : pipelineCompileJobs)
+		count += job->configurations.size();
+	return (int) count;
+}
+
+void Graphics::startPipelineCompiles()
+{
+	if (queuedPipelines.empty())
+		return;
+
+	int threadcount = std::max(1, std::min(SDL_GetCPUCount() - 1, 4));
+	threadcount = std::min(threadcount, (int) queuedPipelines.size());
+
+	for (int i = 0; i < threadcount; i++)
+	{
+		StrongRef<PipelineCompileJob> job(new PipelineCompileJob(this), Acquire::NORETAIN);
+
+		for (size_t j = i; j < queuedPipelines.size(); j += threadcount)
+		{
+			job->configurations.push_back(queuedPipelines[j]);
+			job->shaders.push_back(queuedPipelineShaders[j]);
+		}
+
+		pipelineCompileJobs.push_back(job);
+		job->start();
+	}
+
+	queuedPipelines.clear();
+	queuedPipelineShaders.clear();
+}
+
+void Graphics::finishPipelineCompiles(bool wait)
+{
+	for (size_t i = 0; i < pipelineCompileJobs.size(); )
+	{
+		PipelineCompileJob *job = pipelineCompileJobs[i];
+
+		if (!wait && job->isRunning())
+		{
+			i++;
+			continue;
+		}
+
+		job->wait();
+
+		for (size_t j = 0; j < job->configurations.size(); j++)
+		{
+			VkPipeline pipeline = job->pipelines[j];
+			if (pipeline == VK_NULL_HANDLE)
+				continue;
+
+			Vulkan::pipelineCreated();
+
+			// The pipeline may have been needed before the job was done.
+			if (!graphicsPipelines.insert({job->configurations[j], pipeline}).second)
+			{
+				vkDestroyPipeline(device, pipeline, nullptr);
+				continue;
+			}
+
+			pipelineUsages[pipeline] = true;
+		}
+
+		pipelineCompileJobs.erase(pipelineCompileJobs.begin() + i);
+	}
+}
+
+PipelineCompileJob::PipelineCompileJob(Graphics *gfx)
+	: gfx(gfx)
+{
+	threadName = "PipelineCompile";
+}
+
+void PipelineCompileJob::threadFunction()
+{
+	pipelines.resize(configurations.size(), VK_NULL_HANDLE);
+
+	for (size_t i = 0; i < configurations.size(); i++)
+	{
+		try
+		{
+			pipelines[i] = gfx->createGraphicsPipeline(configurations[i]);
+		}
+		catch (love::Exception &)
+		{
+			pipelines[i] = VK_NULL_HANDLE;
+		}
+	}
+}
+
+RenderPassRecordJob::RenderPassRecordJob(Graphics *gfx)
+	: device(gfx->getDevice())
+{
+	threadName = "RenderPassRecord";
+
+	// Command pools can only be used from one thread at a time, so each job
+	// gets its own.
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = gfx->findQueueFamilies(gfx->physicalDevice).graphicsFamily.value;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+		throw love::Exception("failed to create command pool");
+
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		vkDestroyCommandPool(device, commandPool, nullptr);
+		throw love::Exception("failed to allocate command buffers");
+	}
+}
+
+RenderPassRecordJob::~RenderPassRecordJob()
+{
+	vkDestroyCommandPool(device, commandPool, nullptr);
+}
+
+void RenderPassRecordJob::threadFunction()
+{
+	failed = false;
+
+	vkResetCommandPool(device, commandPool, 0);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		failed = true;
+		commands.clear();
+		return;
+	}
+
+	for (const auto &command : commands)
+		command(commandBuffer);
+	commands.clear();
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		failed = true;
+}
+
 void Graphics::ensureGraphicsPipelineConfiguration(GraphicsPipelineConfiguration &configuration) {
 	auto it = graphicsPipelines.find(configuration);
 	if (it != graphicsPipelines.end())
 	{
 		if (it->second != renderPassState.pipeline)
 		{
-			vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_GRAPHICS, it->second);
+			VkPipeline pipeline = it->second;
+			recordCommands([pipeline](VkCommandBuffer commandBuffer) {
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			});
 			renderPassState.pipeline = it->second;
 			pipelineUsages[it->second] = true;
 		}
 	}
 	else
 	{
+		// It might be one of the precompiled pipelines which isn't done yet.
+		// Only its own job is waited for, other misses are compiled inline.
+		for (const auto &job : pipelineCompileJobs)
+		{
+			if (std::find(job->configurations.begin(), job->configurations.end(), configuration) == job->configurations.end())
+				continue;
+
+			job->wait();
+			finishPipelineCompiles(false);
+
+			if (graphicsPipelines.find(configuration) != graphicsPipelines.end())
+				return ensureGraphicsPipelineConfiguration(configuration);
+			break;
+		}
+
+		if (isPipelineMissLogging())
+		{
+			const BlendState &b = configuration.blendState;
+			const ColorChannelMask &mask = configuration.colorChannelMask;
+			const char *primitive = "unknown";
+			love::graphics::getConstant(configuration.primitiveType, primitive);
+
+			::printf("Vulkan pipeline created while drawing: shader %p, primitive %s, vertex attributes 0x%x, blend %s (%d %d %d / %d %d %d), color mask %s%s%s%s, %u color attachments, %d samples, wireframe %s\n",
+				(void *) configuration.shader, primitive, (unsigned int) configuration.vertexAttributes.enableBits,
+				b.enable ? "on" : "off", (int) b.operationRGB, (int) b.srcFactorRGB, (int) b.dstFactorRGB, (int) b.operationA, (int) b.srcFactorA, (int) b.dstFactorA,
+				mask.r ? "r" : "", mask.g ? "g" : "", mask.b ? "b" : "", mask.a ? "a" : "",
+				configuration.numColorAttachments, (int) configuration.msaaSamples, configuration.wireFrame ? "on" : "off");
+		}
+
 		VkPipeline pipeline = createGraphicsPipeline(configuration);
+		Vulkan::pipelineCreated();
 		graphicsPipelines.insert({configuration, pipeline});
-		vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		recordCommands([pipeline](VkCommandBuffer commandBuffer) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		});
 		renderPassState.pipeline = pipeline;
 		pipelineUsages[pipeline] = true;
 	}
@@ -2850,6 +3898,14 @@ void Graphics::createCommandPool()
 
 	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
 		throw love::Exception("failed to create command pool");
+
+	if (queueFamilyIndices.computeFamily.hasValue)
+	{
+		poolInfo.queueFamilyIndex = queueFamilyIndices.computeFamily.value;
+
+		if (vkCreateCommandPool(device, &poolInfo, nullptr, &computeCommandPool) != VK_SUCCESS)
+			throw love::Exception("failed to create command pool");
+	}
 }
 
 void Graphics::createCommandBuffers()
@@ -2864,6 +3920,31 @@ void Graphics::createCommandBuffers()
 
 	if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
 		throw love::Exception("failed to allocate command buffers");
+
+	commandBufferSegments.clear();
+	for (VkCommandBuffer commandBuffer : commandBuffers)
+		commandBufferSegments.push_back({ commandBuffer });
+
+	renderPassRecordJobs.clear();
+	renderPassRecordJobs.resize(MAX_FRAMES_IN_FLIGHT);
+
+	computeCommandBuffers.clear();
+
+	if (computeCommandPool != VK_NULL_HANDLE)
+	{
+		computeCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+		allocInfo.commandPool = computeCommandPool;
+
+		if (vkAllocateCommandBuffers(device, &allocInfo, computeCommandBuffers.data()) != VK_SUCCESS)
+			throw love::Exception("failed to allocate command buffers");
+	}
+
+#ifdef LOVE_ENABLE_TRACY
+	// The context records and submits its own calibration commands, and waits
+	// for them, so it can borrow a command buffer that isn't in use yet.
+	if (timestampPeriod > 0.0f)
+		tracyContext = TracyVkContext(physicalDevice, device, graphicsQueue, commandBuffers.at(0));
+#endif
 }
 
 void Graphics::createSyncObjects()
@@ -2885,6 +3966,25 @@ void Graphics::createSyncObjects()
 			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores.at(i)) != VK_SUCCESS ||
 			vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences.at(i)) != VK_SUCCESS)
 			throw love::Exception("failed to create synchronization objects for a frame!");
+
+	computeFenceValues.assign(MAX_FRAMES_IN_FLIGHT, 0);
+	computeSemaphoresSignaled.assign(MAX_FRAMES_IN_FLIGHT, false);
+	nextComputeFence = 1;
+	requestedComputeFence = 0;
+	asyncComputeRecording = false;
+
+	if (computeQueue != VK_NULL_HANDLE)
+	{
+		computeStartSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+		computeFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+		computeFences.resize(MAX_FRAMES_IN_FLIGHT);
+
+		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+			if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &computeStartSemaphores.at(i)) != VK_SUCCESS ||
+				vkCreateSemaphore(device, &semaphoreInfo, nullptr, &computeFinishedSemaphores.at(i)) != VK_SUCCESS ||
+				vkCreateFence(device, &fenceInfo, nullptr, &computeFences.at(i)) != VK_SUCCESS)
+				throw love::Exception("failed to create synchronization objects for async compute!");
+	}
 }
 
 void Graphics::createDefaultTexture()
@@ -2913,7 +4013,29 @@ void Graphics::cleanup()
 		vkDestroyFence(device, inFlightFences[i], nullptr);
 	}
 
-	vkFreeCommandBuffers(device, commandPool, MAX_FRAMES_IN_FLIGHT, commandBuffers.data());
+	for (VkSemaphore semaphore : computeStartSemaphores)
+		vkDestroySemaphore(device, semaphore, nullptr);
+	for (VkSemaphore semaphore : computeFinishedSemaphores)
+		vkDestroySemaphore(device, semaphore, nullptr);
+	for (VkFence computeFence : computeFences)
+		vkDestroyFence(device, computeFence, nullptr);
+	computeStartSemaphores.clear();
+	computeFinishedSemaphores.clear();
+	computeFences.clear();
+
+	if (!computeCommandBuffers.empty())
+		vkFreeCommandBuffers(device, computeCommandPool, static_cast<uint32_t>(computeCommandBuffers.size()), computeCommandBuffers.data());
+	computeCommandBuffers.clear();
+
+	for (const auto &segments : commandBufferSegments)
+		vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(segments.size()), segments.data());
+	commandBufferSegments.clear();
+
+	for (const auto &jobs : renderPassRecordJobs)
+		for (const auto &job : jobs)
+			job->wait();
+	renderPassRecordJobs.clear();
+	recordingRenderPass = nullptr;
 
 	for (auto const &p : samplers)
 		vkDestroySampler(device, p.second, nullptr);
@@ -2931,7 +4053,23 @@ void Graphics::cleanup()
 		vkDestroyPipeline(device, p.second, nullptr);
 	graphicsPipelines.clear();
 
+	savePipelineCache();
+	vkDestroyPipelineCache(device, pipelineCache, nullptr);
+	pipelineCache = VK_NULL_HANDLE;
+
+#ifdef LOVE_ENABLE_TRACY
+	if (tracyContext != nullptr)
+	{
+		endGPUZone();
+		TracyVkDestroy(tracyContext);
+		tracyContext = nullptr;
+	}
+#endif
+
 	vkDestroyCommandPool(device, commandPool, nullptr);
+	if (computeCommandPool != VK_NULL_HANDLE)
+		vkDestroyCommandPool(device, computeCommandPool, nullptr);
+	computeCommandPool = VK_NULL_HANDLE;
 	vkDestroyDevice(device, nullptr);
 	vkDestroySurfaceKHR(instance, surface, nullptr);
 	vkDestroyInstance(instance, nullptr);
@@ -23,6 +23,7 @@
 // löve
 #include "common/config.h"
 #include "graphics/Graphics.h"
+#include "thread/threads.h"
 #include "StreamBuffer.h"
 #include "ShaderStage.h"
 #include "Shader.h"
@@ -38,6 +39,13 @@
 #include <functional>
 #include <set>
 
+#ifdef LOVE_ENABLE_TRACY
+namespace tracy
+{
+class VkCtx;
+class VkCtxScope;
+}
+#endif
 
 namespace love
 {
@@ -50,13 +58,17 @@ struct RenderPassAttachment
 {
 	VkFormat format = VK_FORMAT_UNDEFINED;
 	bool discard = true;
+	bool memoryless = false;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	bool store = true;
 
 	bool operator==(const RenderPassAttachment &attachment) const
 	{
 		return format == attachment.format && 
 			discard == attachment.discard && 
-			msaaSamples == attachment.msaaSamples;
+			memoryless == attachment.memoryless &&
+			msaaSamples == attachment.msaaSamples &&
+			store == attachment.store;
 	}
 };
 
@@ -152,6 +164,18 @@ struct OptionalDeviceFeatures
 
 	// VK_KHR_spirv_1_4
 	bool spirv14 = false;
+
+	// VK_KHR_present_id
+	bool presentId = false;
+
+	// VK_KHR_present_wait
+	bool presentWait = false;
+
+	// VkPhysicalDeviceFeatures::multiDrawIndirect
+	bool multiDrawIndirect = false;
+
+	// VkPhysicalDeviceFeatures::occlusionQueryPrecise
+	bool occlusionQueryPrecise = false;
 };
 
 struct GraphicsPipelineConfiguration
@@ -198,6 +222,8 @@ struct QueueFamilyIndices
 {
 	Optional<uint32_t> graphicsFamily;
 	Optional<uint32_t> presentFamily;
+	// A family without graphics support, used for async compute.
+	Optional<uint32_t> computeFamily;
 
 	bool isComplete() const
 	{
@@ -237,8 +263,60 @@ struct ScreenshotReadbackBuffer
 	VmaAllocation imageAllocation;
 };
 
+class Graphics;
+
+// Creates graphics pipelines ahead of time on another thread.
+class PipelineCompileJob : public love::thread::Threadable
+{
+public:
+
+	PipelineCompileJob(Graphics *gfx);
+	virtual ~PipelineCompileJob() {}
+
+	void threadFunction() override;
+
+	std::vector<GraphicsPipelineConfiguration> configurations;
+	std::vector<StrongRef<Shader>> shaders;
+
+	// Null for pipelines which failed to compile.
+	std::vector<VkPipeline> pipelines;
+
+private:
+
+	Graphics *gfx;
+};
+
+// Records the commands of a render pass with render targets into its own
+// primary command buffer on a worker thread. A primary command buffer is used
+// rather than a secondary one so the job can begin and end the render pass
+// itself.
+class RenderPassRecordJob : public love::thread::Threadable
+{
+public:
+
+	RenderPassRecordJob(Graphics *gfx);
+	virtual ~RenderPassRecordJob();
+
+	void threadFunction() override;
+
+	VkCommandBuffer getCommandBuffer() const { return commandBuffer; }
+	bool hasFailed() const { return failed; }
+
+	std::vector<std::function<void(VkCommandBuffer)>> commands;
+
+private:
+
+	VkDevice device;
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	bool failed = false;
+};
+
 class Graphics final : public love::graphics::Graphics
 {
+	friend class PipelineCompileJob;
+	friend class RenderPassRecordJob;
+
 public:
 	Graphics();
 	~Graphics();
@@ -247,9 +325,18 @@ public:
 	const VkDevice getDevice() const;
 	const VmaAllocator getVmaAllocator() const;
 
+	// Allocations first try to stay within the memory budget of each heap,
+	// which lets them spill into other memory types once the preferred heap
+	// is full. They only go over budget if nothing else fits.
+	VkResult createImage(const VkImageCreateInfo &imageInfo, const VmaAllocationCreateInfo &allocInfo, VkImage &image, VmaAllocation &allocation);
+	VkResult createBuffer(const VkBufferCreateInfo &bufferInfo, const VmaAllocationCreateInfo &allocInfo, VkBuffer &buffer, VmaAllocation &allocation, VmaAllocationInfo *info);
+	VkPipelineCache getPipelineCache() const { return pipelineCache; }
+
 	// implementation for virtual functions
 	love::graphics::Texture *newTexture(const love::graphics::Texture::Settings &settings, const love::graphics::Texture::Slices *data) override;
 	love::graphics::Buffer *newBuffer(const love::graphics::Buffer::Settings &settings, const std::vector<love::graphics::Buffer::DataDeclaration>& format, const void *data, size_t size, size_t arraylength) override;
+	love::graphics::TimerQuery *newTimerQuery() override;
+	love::graphics::OcclusionQuery *newOcclusionQuery(bool precise) override;
 	void clear(OptionalColorD color, OptionalInt stencil, OptionalDouble depth) override;
 	void clear(const std::vector<OptionalColorD> &colors, OptionalInt stencil, OptionalDouble depth) override;
 	Matrix4 computeDeviceProjection(const Matrix4 &projection, bool rendertotexture) const override;
@@ -276,6 +363,8 @@ public:
 	Renderer getRenderer() const override;
 	bool usesGLSLES() const override;
 	RendererInfo getRendererInfo() const override;
+	std::vector<MemoryHeap> getMemoryHeaps() const override;
+	void defragmentMemory() override;
 	void draw(const DrawCommand &cmd) override;
 	void draw(const DrawIndexedCommand &cmd) override;
 	void drawQuads(int start, int count, const VertexAttributes &attributes, const BufferBindings &buffers, graphics::Texture *texture) override;
@@ -290,6 +379,8 @@ public:
 	void addReadbackCallback(std::function<void()> callback);
 	void submitGpuCommands(bool present, void *screenshotCallbackData = nullptr);
 	const VkDeviceSize getMinUniformBufferOffsetAlignment() const;
+	float getTimestampPeriod() const;
+	uint32_t getTimestampValidBits() const;
 	graphics::Texture *getDefaultTexture() const;
 	VkSampler getCachedSampler(const SamplerState &sampler);
 	void setComputeShader(Shader *computeShader);
@@ -300,13 +391,36 @@ public:
 	void setVsync(int vsync);
 	int getVsync() const;
 
+	// Calls fn with the command buffer draw and render state commands go into.
+	// While a render pass is recorded on a worker thread, fn is stored and
+	// called from that thread instead, so it must capture by value.
+	template <typename T>
+	void recordCommands(T &&fn)
+	{
+		if (recordingRenderPass != nullptr)
+			recordingRenderPass->commands.emplace_back(std::forward<T>(fn));
+		else
+			fn(commandBuffers.at(currentFrame));
+	}
+
+	void precompilePipeline(love::graphics::Shader *shader, const VertexAttributes &attributes, PrimitiveType primitive) override;
+	int getPrecompilingPipelineCount() const override;
+
+	bool isComputeFenceComplete(uint64 fence) override;
+	void waitComputeFence(uint64 fence) override;
+
+	// The queue families resources are shared between, empty when everything
+	// uses the graphics queue family.
+	const std::vector<uint32_t> &getResourceQueueFamilies() const { return resourceQueueFamilies; }
+
 protected:
-	graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
-	graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM]) override;
+	graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles, const std::vector<uint32> *prebuiltspirv) override;
+	graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::ValidationReflection *prebuiltreflection) override;
 	graphics::StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) override;
 	bool dispatch(int x, int y, int z) override;
+	bool dispatchAsync(int x, int y, int z, uint64 &fence) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(Stats &stats) const override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 
 private:
@@ -316,6 +430,9 @@ private:
 	int rateDeviceSuitability(VkPhysicalDevice device);
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 	void createLogicalDevice();
+	void createPipelineCache();
+	void savePipelineCache();
+	std::string getPipelineCacheFilename() const;
 	void initVMA();
 	void createSurface();
 	bool checkDeviceExtensionSupport(VkPhysicalDevice device);
@@ -347,6 +464,8 @@ private:
 	void recreateSwapChain();
 	void initDynamicState();
 	void beginFrame();
+	void waitForFrame(uint32_t framesago);
+	void waitForPresent();
 	void startRecordingGraphicsCommands();
 	void endRecordingGraphicsCommands();
 	void ensureGraphicsPipelineConfiguration(GraphicsPipelineConfiguration &configuration);
@@ -365,7 +484,18 @@ private:
 	void endRenderPass();
 	VkSampler createSampler(const SamplerState &sampler);
 	void cleanupUnusedObjects();
+	void compactMemory(int maxPasses);
 	void requestSwapchainRecreation();
+	VkRenderPass getRenderPass(RenderPassConfiguration &configuration);
+	void startPipelineCompiles();
+	void finishPipelineCompiles(bool wait);
+	void beginCommandBufferSegment();
+	void beginGPUZone(VkCommandBuffer commandBuffer);
+	void endGPUZone();
+	void startRenderPassRecordJob();
+	void finishRenderPassRecordJobs();
+	void addComputeWaitSemaphores(std::vector<VkSemaphore> &semaphores, std::vector<VkPipelineStageFlags> &stages);
+	void submitAsyncCompute();
 
 	VkInstance instance = VK_NULL_HANDLE;
 	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
@@ -377,6 +507,12 @@ private:
 	OptionalDeviceFeatures optionalDeviceFeatures;
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
 	VkQueue presentQueue = VK_NULL_HANDLE;
+	VkQueue computeQueue = VK_NULL_HANDLE;
+#ifdef LOVE_ENABLE_TRACY
+	tracy::VkCtx *tracyContext = nullptr;
+	tracy::VkCtxScope *tracyZone = nullptr;
+#endif
+	std::vector<uint32_t> resourceQueueFamilies;
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
 	VkSwapchainKHR swapChain = VK_NULL_HANDLE;
 	VkSurfaceTransformFlagBitsKHR preTransform = {};
@@ -397,23 +533,55 @@ private:
 	std::unordered_map<RenderPassConfiguration, VkRenderPass, RenderPassConfigurationHasher> renderPasses;
 	std::unordered_map<FramebufferConfiguration, VkFramebuffer, FramebufferConfigurationHasher> framebuffers;
 	std::unordered_map<GraphicsPipelineConfiguration, VkPipeline, GraphicsPipelineConfigurationHasher> graphicsPipelines;
+	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	std::vector<GraphicsPipelineConfiguration> queuedPipelines;
+	std::vector<StrongRef<Shader>> queuedPipelineShaders;
+	std::vector<StrongRef<PipelineCompileJob>> pipelineCompileJobs;
 	std::unordered_map<VkRenderPass, bool> renderPassUsages;
 	std::unordered_map<VkFramebuffer, bool> framebufferUsages;
 	std::unordered_map<VkPipeline, bool> pipelineUsages;
 	std::unordered_map<uint64, VkSampler> samplers;
 	VkCommandPool commandPool = VK_NULL_HANDLE;
 	std::vector<VkCommandBuffer> commandBuffers;
+	// Every primary command buffer of each frame, the first one is the
+	// frame's entry in commandBuffers. The others are used to continue
+	// recording after a render pass was handed off to a worker thread.
+	std::vector<std::vector<VkCommandBuffer>> commandBufferSegments;
+	size_t usedCommandBufferSegments = 0;
+	std::vector<std::vector<StrongRef<RenderPassRecordJob>>> renderPassRecordJobs;
+	size_t usedRenderPassRecordJobs = 0;
+	RenderPassRecordJob *recordingRenderPass = nullptr;
+	// Finished command buffers of the current submission, in order.
+	std::vector<VkCommandBuffer> submitCommandBuffers;
 	Shader *computeShader = nullptr;
 	std::vector<VkSemaphore> imageAvailableSemaphores;
 	std::vector<VkSemaphore> renderFinishedSemaphores;
 	std::vector<VkFence> inFlightFences;
 	std::vector<VkFence> imagesInFlight;
+	VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> computeCommandBuffers;
+	// Signaled by the graphics submission async compute work waits for.
+	std::vector<VkSemaphore> computeStartSemaphores;
+	// Signaled by async compute work, for later graphics submissions.
+	std::vector<VkSemaphore> computeFinishedSemaphores;
+	std::vector<bool> computeSemaphoresSignaled;
+	std::vector<VkFence> computeFences;
+	// The fence value of the last async compute work submitted in each frame.
+	std::vector<uint64> computeFenceValues;
+	uint64 nextComputeFence = 1;
+	uint64 requestedComputeFence = 0;
+	bool asyncComputeRecording = false;
 	int vsync = 1;
 	VkDeviceSize minUniformBufferOffsetAlignment = 0;
+	float timestampPeriod = 0.0f;
+	uint32_t timestampValidBits = 64;
 	bool imageRequested = false;
 	uint32_t frameCounter = 0;
+	bool defragmentRequested = false;
 	size_t currentFrame = 0;
 	uint32_t imageIndex = 0;
+	// VK_KHR_present_id values are per swapchain, 0 means nothing presented yet.
+	uint64_t lastPresentId = 0;
 	bool swapChainRecreationRequested = false;
 	bool transitionColorDepthLayouts = false;
 	VmaAllocator vmaAllocator = VK_NULL_HANDLE;
@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+#include "Graphics.h"
+
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+OcclusionQuery::OcclusionQuery(love::graphics::Graphics *gfx, bool precise)
+	: graphics::OcclusionQuery(gfx, precise)
+	, vgfx(dynamic_cast<Graphics*>(gfx))
+	, completedGeneration(std::make_shared<uint64>(0))
+{
+	if (precise && !vgfx->getEnabledOptionalDeviceExtensions().occlusionQueryPrecise)
+		throw love::Exception("Precise occlusion queries are not supported on this system.");
+
+	loadVolatile();
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	if (isRunning())
+		endQuery();
+
+	unloadVolatile();
+}
+
+bool OcclusionQuery::loadVolatile()
+{
+	if (queryPool != VK_NULL_HANDLE)
+		return true;
+
+	VkQueryPoolCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	createInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+	createInfo.queryCount = MAX_RENDER_PASSES;
+
+	if (vkCreateQueryPool(vgfx->getDevice(), &createInfo, nullptr, &queryPool) != VK_SUCCESS)
+		throw love::Exception("failed to create occlusion query pool");
+
+	return true;
+}
+
+void OcclusionQuery::unloadVolatile()
+{
+	if (queryPool == VK_NULL_HANDLE)
+		return;
+
+	vgfx->queueCleanUp([device = vgfx->getDevice(), queryPool = queryPool](){
+		vkDestroyQueryPool(device, queryPool, nullptr);
+	});
+
+	queryPool = VK_NULL_HANDLE;
+}
+
+void OcclusionQuery::beginQuery()
+{
+	// Query resets aren't allowed inside a render pass, which
+	// getCommandBufferForDataTransfer ends.
+	VkCommandBuffer commandBuffer = vgfx->getCommandBufferForDataTransfer();
+	vkCmdResetQueryPool(commandBuffer, queryPool, 0, MAX_RENDER_PASSES);
+
+	generation++;
+	usedQueries = 0;
+	inRenderPass = false;
+	overflow = false;
+}
+
+void OcclusionQuery::endQuery()
+{
+	// Ends the current render pass, and with it the last query.
+	vgfx->getCommandBufferForDataTransfer();
+
+	vgfx->addReadbackCallback([completed = completedGeneration, generation = generation](){
+		*completed = generation;
+	});
+}
+
+void OcclusionQuery::beginRenderPass()
+{
+	if (usedQueries >= MAX_RENDER_PASSES)
+	{
+		overflow = true;
+		return;
+	}
+
+	VkQueryControlFlags flags = precise ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+
+	vgfx->recordCommands([queryPool = queryPool, index = usedQueries, flags](VkCommandBuffer commandBuffer) {
+		vkCmdBeginQuery(commandBuffer, queryPool, index, flags);
+	});
+
+	inRenderPass = true;
+}
+
+void OcclusionQuery::endRenderPass()
+{
+	if (!inRenderPass)
+		return;
+
+	vgfx->recordCommands([queryPool = queryPool, index = usedQueries](VkCommandBuffer commandBuffer) {
+		vkCmdEndQuery(commandBuffer, queryPool, index);
+	});
+
+	usedQueries++;
+	inRenderPass = false;
+}
+
+bool OcclusionQuery::getResult(uint64 &samples)
+{
+	if (*completedGeneration != generation)
+		return false;
+
+	samples = 0;
+
+	if (usedQueries > 0)
+	{
+		std::vector<uint64_t> results(usedQueries, 0);
+
+		VkResult result = vkGetQueryPoolResults(vgfx->getDevice(), queryPool, 0, usedQueries, sizeof(uint64_t) * usedQueries, results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+		if (result == VK_NOT_READY)
+			return false;
+
+		for (uint64_t r : results)
+			samples += r;
+	}
+
+	if (overflow && samples == 0)
+		samples = 1;
+
+	return true;
+}
+
+} // vulkan
+} // graphics
+} // love
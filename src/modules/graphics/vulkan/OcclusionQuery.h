@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "graphics/OcclusionQuery.h"
+#include "graphics/Volatile.h"
+
+#include "VulkanWrapper.h"
+
+#include <memory>
+
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+class Graphics;
+
+/**
+ * Vulkan occlusion queries can't span command buffers, and render passes may
+ * be recorded into their own command buffers on worker threads. So each render
+ * pass which starts while the query is running gets its own query in the
+ * pool, and the result is their sum.
+ **/
+class OcclusionQuery final
+	: public love::graphics::OcclusionQuery
+	, public Volatile
+{
+public:
+	OcclusionQuery(love::graphics::Graphics *gfx, bool precise);
+	virtual ~OcclusionQuery();
+
+	virtual bool loadVolatile() override;
+	virtual void unloadVolatile() override;
+
+	// Called by Graphics right after a render pass begins, and right before it
+	// ends, while this query is running.
+	void beginRenderPass();
+	void endRenderPass();
+
+protected:
+	void beginQuery() override;
+	void endQuery() override;
+	bool getResult(uint64 &samples) override;
+
+private:
+	static const uint32_t MAX_RENDER_PASSES = 64;
+
+	Graphics *vgfx = nullptr;
+	VkQueryPool queryPool = VK_NULL_HANDLE;
+
+	uint32_t usedQueries = 0;
+	bool inRenderPass = false;
+
+	// Render passes beyond MAX_RENDER_PASSES aren't counted, so the result
+	// is conservatively reported as visible.
+	bool overflow = false;
+
+	uint64 generation = 0;
+	std::shared_ptr<uint64> completedGeneration;
+};
+
+} // vulkan
+} // graphics
+} // love
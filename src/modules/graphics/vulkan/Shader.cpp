@@ -142,7 +142,7 @@ static const TBuiltInResource defaultTBuiltInResource = {
 };
 
 static const uint32_t STREAMBUFFER_DEFAULT_SIZE = 16;
-static const uint32_t DESCRIPTOR_POOL_SIZE = 1;
+static const uint32_t DESCRIPTOR_POOL_SIZE = 16;
 
 static VkShaderStageFlagBits getStageBit(ShaderStageType type)
 {
@@ -174,8 +174,8 @@ static EShLanguage getGlslShaderType(ShaderStageType stage)
 	}
 }
 
-Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[])
-	: graphics::Shader(stages)
+Shader::Shader(StrongRef<love::graphics::ShaderStage> stages[], const ValidationReflection *prebuiltreflection)
+	: graphics::Shader(stages, prebuiltreflection)
 {
 	auto gfx = Module::getInstance<Graphics>(Module::ModuleType::M_GRAPHICS);
 	vgfx = dynamic_cast<Graphics*>(gfx);
@@ -197,6 +197,7 @@ bool Shader::loadVolatile()
 	createDescriptorPoolSizes();
 	createStreamBuffers();
 	descriptorSetsVector.resize(MAX_FRAMES_IN_FLIGHT);
+	currentDescriptorSet = VK_NULL_HANDLE;
 	currentFrame = 0;
 	currentUsedUniformStreamBuffersCount = 0;
 	currentUsedDescriptorSetsCount = 0;
@@ -224,6 +225,7 @@ void Shader::unloadVolatile()
 			break;
 		case UNIFORM_TEXELBUFFER:
 		case UNIFORM_STORAGEBUFFER:
+		case UNIFORM_UNIFORMBUFFER:
 			for (int i = 0; i < uniform.second.count; i++)
 			{
 				if (uniform.second.buffers[i] != nullptr)
@@ -277,7 +279,6 @@ void Shader::newFrame()
 {
 	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
-	updatedUniforms.clear();
 	currentUsedUniformStreamBuffersCount = 0;
 	currentUsedDescriptorSetsCount = 0;
 
@@ -295,14 +296,51 @@ void Shader::newFrame()
 	else
 		streamBuffers.at(0)->nextFrame();
 
-	if (descriptorSetsVector.at(currentFrame).size() == 0)
-		descriptorSetsVector.at(currentFrame).push_back(allocateDescriptorSet());
+	// Sets used in other frames may still be in flight, so they can't be
+	// bound again.
+	currentDescriptorSet = VK_NULL_HANDLE;
+}
+
+static bool equalDescriptors(const VkDescriptorImageInfo &a, const VkDescriptorImageInfo &b)
+{
+	return a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+}
+
+static bool equalDescriptors(const VkDescriptorBufferInfo &a, const VkDescriptorBufferInfo &b)
+{
+	return a.buffer == b.buffer && a.offset == b.offset && a.range == b.range;
+}
+
+static bool equalDescriptors(const VkBufferView &a, const VkBufferView &b)
+{
+	return a == b;
+}
+
+template <typename T>
+static bool equalDescriptors(const std::vector<T> &a, const std::vector<T> &b)
+{
+	if (a.size() != b.size())
+		return false;
 
-	currentDescriptorSet = descriptorSetsVector.at(currentFrame).at(0);
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (!equalDescriptors(a[i], b[i]))
+			return false;
+	}
+
+	return true;
 }
 
-void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint)
+void Shader::cmdPushDescriptorSets(VkPipelineBindPoint bindPoint, VkCommandBuffer commandBuffer)
 {
+	descriptorWrites.clear();
+	descriptorImageInfos.clear();
+	descriptorBufferInfos.clear();
+	descriptorBufferViews.clear();
+
+	uint32_t dynamicOffset = 0;
+	uint32_t dynamicOffsetCount = 0;
+
 	if (!localUniformData.empty())
 	{
 		auto usedStreamBufferMemory = currentUsedUniformStreamBuffersCount * uniformBufferSizeAligned;
@@ -326,77 +364,182 @@ void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBind
 		auto offset = currentStreamBuffer->unmap(uniformBufferSizeAligned);
 		currentStreamBuffer->markUsed(uniformBufferSizeAligned);
 
+		// The offset into the stream buffer is supplied when the set is bound,
+		// so the descriptor itself only changes with the buffer.
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = (VkBuffer)currentStreamBuffer->getHandle();
-		bufferInfo.offset = offset;
+		bufferInfo.offset = 0;
 		bufferInfo.range = localUniformData.size();
+		descriptorBufferInfos.push_back(bufferInfo);
 
 		VkWriteDescriptorSet uniformWrite{};
 		uniformWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		uniformWrite.dstSet = currentDescriptorSet;
 		uniformWrite.dstBinding = localUniformLocation;
 		uniformWrite.dstArrayElement = 0;
-		uniformWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		uniformWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		uniformWrite.descriptorCount = 1;
-		uniformWrite.pBufferInfo = &bufferInfo;
+		descriptorWrites.push_back(uniformWrite);
 
-		vkUpdateDescriptorSets(device, 1, &uniformWrite, 0, nullptr);
+		dynamicOffset = (uint32_t) offset;
+		dynamicOffsetCount = 1;
 
 		currentUsedUniformStreamBuffersCount++;
+	}
+
+	for (const auto &u : uniformInfos)
+		addDescriptorWrite(&u.second);
+
+	if (currentDescriptorSet == VK_NULL_HANDLE || !descriptorsMatchBoundSet())
+	{
+		if (currentUsedDescriptorSetsCount >= static_cast<uint32_t>(descriptorSetsVector.at(currentFrame).size()))
+			descriptorSetsVector.at(currentFrame).push_back(allocateDescriptorSet());
+
+		currentDescriptorSet = descriptorSetsVector.at(currentFrame).at(currentUsedDescriptorSetsCount);
+		currentUsedDescriptorSetsCount++;
 
-		updatedUniforms.insert(localUniformLocation);
+		// The info arrays are done growing, so pointers into them are stable.
+		size_t imageIndex = 0;
+		size_t bufferIndex = 0;
+		size_t viewIndex = 0;
+
+		for (auto &write : descriptorWrites)
+		{
+			write.dstSet = currentDescriptorSet;
+
+			switch (write.descriptorType)
+			{
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+				write.pImageInfo = &descriptorImageInfos[imageIndex];
+				imageIndex += write.descriptorCount;
+				break;
+			case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+				write.pTexelBufferView = &descriptorBufferViews[viewIndex];
+				viewIndex += write.descriptorCount;
+				break;
+			default:
+				write.pBufferInfo = &descriptorBufferInfos[bufferIndex];
+				bufferIndex += write.descriptorCount;
+				break;
+			}
+		}
+
+		if (!descriptorWrites.empty())
+		{
+			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+			Vulkan::descriptorsWritten(static_cast<uint32_t>(descriptorWrites.size()));
+		}
+
+		boundImageInfos = descriptorImageInfos;
+		boundBufferInfos = descriptorBufferInfos;
+		boundBufferViews = descriptorBufferViews;
 	}
 
-	static const std::vector<BuiltinUniform> builtinUniformTextures = {
-		BUILTIN_TEXTURE_MAIN,
-		BUILTIN_TEXTURE_VIDEO_Y,
-		BUILTIN_TEXTURE_VIDEO_CB,
-		BUILTIN_TEXTURE_VIDEO_CR,
-	};
+	if (commandBuffer != VK_NULL_HANDLE)
+	{
+		vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &currentDescriptorSet, dynamicOffsetCount, &dynamicOffset);
+		return;
+	}
 
-	for (const auto &builtin : builtinUniformTextures)
+	VkPipelineLayout layout = pipelineLayout;
+	VkDescriptorSet descriptorSet = currentDescriptorSet;
+
+	vgfx->recordCommands([=](VkCommandBuffer commandBuffer) {
+		vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, 0, 1, &descriptorSet, dynamicOffsetCount, &dynamicOffset);
+	});
+}
+
+void Shader::addDescriptorWrite(const UniformInfo *info)
+{
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstBinding = info->location;
+	write.dstArrayElement = 0;
+	write.descriptorCount = static_cast<uint32_t>(info->count);
+
+	if (info->baseType == UNIFORM_SAMPLER || info->baseType == UNIFORM_STORAGETEXTURE)
 	{
-		if (builtinUniformInfo[builtin] != nullptr)
+		bool isSampler = info->baseType == UNIFORM_SAMPLER;
+
+		for (int i = 0; i < info->count; i++)
 		{
-			auto texture = dynamic_cast<Texture*>(builtinUniformInfo[builtin]->textures[0]);
+			auto vkTexture = dynamic_cast<Texture*>(info->textures[i]);
+
+			if (vkTexture == nullptr)
+				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
 
 			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageLayout = texture->getImageLayout();
-			imageInfo.imageView = (VkImageView)texture->getRenderTargetHandle();
-			imageInfo.sampler = (VkSampler)texture->getSamplerHandle();
 
-			auto location = builtinUniformInfo[builtin]->location;
+			imageInfo.imageLayout = vkTexture->getImageLayout();
+			imageInfo.imageView = (VkImageView)vkTexture->getRenderTargetHandle();
+			if (isSampler)
+				imageInfo.sampler = (VkSampler)vkTexture->getSamplerHandle();
 
-			VkWriteDescriptorSet textureWrite{};
-			textureWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			textureWrite.dstSet = currentDescriptorSet;
-			textureWrite.dstBinding = location;
-			textureWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			textureWrite.descriptorCount = 1;
-			textureWrite.pImageInfo = &imageInfo;
+			descriptorImageInfos.push_back(imageInfo);
+		}
 
-			vkUpdateDescriptorSets(device, 1, &textureWrite, 0, nullptr);
+		if (isSampler)
+			write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		else
+			write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	}
+	else if (info->baseType == UNIFORM_STORAGEBUFFER)
+	{
+		for (int i = 0; i < info->count; i++)
+		{
+			if (info->buffers[i] == nullptr)
+				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
+
+			VkDescriptorBufferInfo bufferInfo{};
+			bufferInfo.buffer = (VkBuffer)info->buffers[i]->getHandle();
+			bufferInfo.offset = 0;
+			bufferInfo.range = info->buffers[i]->getSize();
 
-			updatedUniforms.insert(location);
+			descriptorBufferInfos.push_back(bufferInfo);
 		}
-	}
 
-	for (const auto &u : uniformInfos)
-	{
-		if (updatedUniforms.find(u.second.location) == updatedUniforms.end())
-			updateUniform(&u.second, u.second.count);
+		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 	}
+	else if (info->baseType == UNIFORM_UNIFORMBUFFER)
+	{
+		for (int i = 0; i < info->count; i++)
+		{
+			if (info->buffers[i] == nullptr)
+				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
 
-	vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &currentDescriptorSet, 0, nullptr);
+			VkDescriptorBufferInfo bufferInfo{};
+			bufferInfo.buffer = (VkBuffer)info->buffers[i]->getHandle();
+			bufferInfo.offset = 0;
+			bufferInfo.range = info->bufferStride;
 
-	currentUsedDescriptorSetsCount++;
+			descriptorBufferInfos.push_back(bufferInfo);
+		}
 
-	if (currentUsedDescriptorSetsCount >= static_cast<uint32_t>(descriptorSetsVector.at(currentFrame).size()))
-		descriptorSetsVector.at(currentFrame).push_back(allocateDescriptorSet());
+		write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	}
+	else if (info->baseType == UNIFORM_TEXELBUFFER)
+	{
+		for (int i = 0; i < info->count; i++)
+		{
+			if (info->buffers[i] == nullptr)
+				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
+
+			descriptorBufferViews.push_back((VkBufferView)info->buffers[i]->getTexelBufferHandle());
+		}
+
+		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+	}
+	else
+		return;
 
-	currentDescriptorSet = descriptorSetsVector.at(currentFrame).at(currentUsedDescriptorSetsCount);
+	descriptorWrites.push_back(write);
+}
 
-	updatedUniforms.clear();
+bool Shader::descriptorsMatchBoundSet() const
+{
+	return equalDescriptors(descriptorImageInfos, boundImageInfos)
+		&& equalDescriptors(descriptorBufferInfos, boundBufferInfos)
+		&& equalDescriptors(descriptorBufferViews, boundBufferViews);
 }
 
 Shader::~Shader()
@@ -461,100 +604,14 @@ void Shader::updateUniform(const UniformInfo* info, int count, bool internal)
 	if (!internal && current == this)
 		Graphics::flushBatchedDrawsGlobal();
 
+	// Descriptors for textures and buffers are gathered for each draw, in
+	// cmdPushDescriptorSets. Only the bytes belonging to this uniform are
+	// copied, the rest of the block hasn't changed.
 	if (usesLocalUniformData(info))
-		memcpy(localUniformData.data(), localUniformStagingData.data(), localUniformStagingData.size());
-	if (info->baseType == UNIFORM_SAMPLER || info->baseType == UNIFORM_STORAGETEXTURE)
-	{
-		bool isSampler = info->baseType == UNIFORM_SAMPLER;
-
-		std::vector<VkDescriptorImageInfo> imageInfos;
-
-		for (int i = 0; i < count; i++)
-		{
-			auto vkTexture = dynamic_cast<Texture*>(info->textures[i]);
-
-			if (vkTexture == nullptr)
-				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
-
-			VkDescriptorImageInfo imageInfo{};
-
-			imageInfo.imageLayout = vkTexture->getImageLayout();
-			imageInfo.imageView = (VkImageView)vkTexture->getRenderTargetHandle();
-			if (isSampler)
-				imageInfo.sampler = (VkSampler)vkTexture->getSamplerHandle();
-
-			imageInfos.push_back(imageInfo);
-		}
-
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = currentDescriptorSet;
-		write.dstBinding = info->location;
-		write.dstArrayElement = 0;
-		if (isSampler)
-			write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		else
-			write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-		write.descriptorCount = static_cast<uint32_t>(count);
-		write.pImageInfo = imageInfos.data();
-
-		vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
-	}
-	if (info->baseType == UNIFORM_STORAGEBUFFER)
-	{
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = currentDescriptorSet;
-		write.dstBinding = info->location;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		write.descriptorCount = info->count;
-
-		std::vector<VkDescriptorBufferInfo> bufferInfos;
-
-		for (int i = 0; i < info->count; i++)
-		{
-			if (info->buffers[i] == nullptr)
-				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
-
-			VkDescriptorBufferInfo bufferInfo{};
-			bufferInfo.buffer = (VkBuffer)info->buffers[i]->getHandle();;
-			bufferInfo.offset = 0;
-			bufferInfo.range = info->buffers[i]->getSize();
-
-			bufferInfos.push_back(bufferInfo);
-		}
-
-		write.pBufferInfo = bufferInfos.data();
-
-		vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
-	}
-	if (info->baseType == UNIFORM_TEXELBUFFER)
 	{
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = currentDescriptorSet;
-		write.dstBinding = info->location;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-		write.descriptorCount = info->count;
-
-		std::vector<VkBufferView> bufferViews;
-
-		for (int i = 0; i < info->count; i++)
-		{
-			if (info->buffers[i] == nullptr)
-				throw love::Exception("uniform variable %s is not set.", info->name.c_str());
-
-			bufferViews.push_back((VkBufferView)info->buffers[i]->getTexelBufferHandle());
-		}
-
-		write.pTexelBufferView = bufferViews.data();
-
-		vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+		size_t offset = (uint8 *) info->data - localUniformStagingData.data();
+		memcpy(localUniformData.data() + offset, info->data, info->dataSize);
 	}
-
-	updatedUniforms.insert(info->location);
 }
 
 void Shader::sendTextures(const UniformInfo *info, graphics::Texture **textures, int count)
@@ -684,6 +741,16 @@ void Shader::compileShaders()
 
 	const auto &enabledExtensions = vgfx->getEnabledOptionalDeviceExtensions();
 
+	// Stages from a ShaderBundle already have SPIR-V, so glslang isn't needed.
+	bool prebuilt = true;
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (stages[i] && !stages[i]->isPrebuilt())
+			prebuilt = false;
+	}
+
+	std::vector<uint32_t> stageSPIRV[SHADERSTAGE_MAX_ENUM];
+
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
 		if (!stages[i])
@@ -694,6 +761,12 @@ void Shader::compileShaders()
 		if (stage == SHADERSTAGE_COMPUTE)
 			isCompute = true;
 
+		if (prebuilt)
+		{
+			stageSPIRV[i] = stages[i]->getPrebuiltSPIRV();
+			continue;
+		}
+
 		auto glslangShaderStage = getGlslShaderType(stage);
 		auto tshader = new TShader(glslangShaderStage);
 
@@ -731,31 +804,37 @@ void Shader::compileShaders()
 		glslangShaders.push_back(tshader);
 	}
 
-	if (!program->link(EShMsgDefault))
-		throw love::Exception("link failed! %s\n", program->getInfoLog());
+	if (!prebuilt)
+	{
+		if (!program->link(EShMsgDefault))
+			throw love::Exception("link failed! %s\n", program->getInfoLog());
+
+		if (!program->mapIO())
+			throw love::Exception("mapIO failed");
+
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			auto glslangStage = getGlslShaderType((ShaderStageType)i);
+			auto intermediate = program->getIntermediate(glslangStage);
+			if (intermediate == nullptr)
+				continue;
+
+			spv::SpvBuildLogger logger;
+			glslang::SpvOptions opt;
+			opt.validate = true;
 
-	if (!program->mapIO())
-		throw love::Exception("mapIO failed");
+			GlslangToSpv(*intermediate, stageSPIRV[i], &logger, &opt);
+		}
+	}
 
 	uniformInfos.clear();
 
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
 		auto shaderStage = (ShaderStageType)i;
-		auto glslangStage = getGlslShaderType(shaderStage);
-		auto intermediate = program->getIntermediate(glslangStage);
-		if (intermediate == nullptr) {
+		const std::vector<uint32_t> &spirv = stageSPIRV[i];
+		if (spirv.empty())
 			continue;
-		}
-
-		spv::SpvBuildLogger logger;
-		glslang::SpvOptions opt;
-		opt.validate = true;
-
-		std::vector<uint32_t> spirv;
-		GlslangToSpv(*intermediate, spirv, &logger, &opt);
-
-		std::string msgs = logger.getAllMessages();
 
 		VkShaderModuleCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -807,7 +886,26 @@ void Shader::compileShaders()
 				memcpy(localUniformData.data(), localUniformStagingData.data(), localUniformStagingData.size());
 			}
 			else
-				throw love::Exception("unimplemented: non default uniform blocks.");
+			{
+				const auto &type = comp.get_type(resource.type_id);
+
+				UniformInfo u{};
+				u.baseType = UNIFORM_UNIFORMBUFFER;
+				u.components = 1;
+				u.name = resource.name;
+				u.count = type.array.empty() ? 1 : type.array[0];
+
+				if (!fillUniformReflectionData(u))
+					continue;
+
+				u.location = comp.get_decoration(resource.id, spv::DecorationBinding);
+				u.buffers = new love::graphics::Buffer *[u.count];
+
+				for (int i = 0; i < u.count; i++)
+					u.buffers[i] = nullptr;
+
+				uniformInfos[u.name] = u;
+			}
 		}
 
 		for (const auto &r : shaderResources.sampled_images)
@@ -960,7 +1058,7 @@ void Shader::createDescriptorSetLayout()
 	for (auto const &entry : uniformInfos)
 	{
 		auto type = Vulkan::getDescriptorType(entry.second.baseType);
-		if (type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+		if (!usesLocalUniformData(&entry.second))
 		{
 			VkDescriptorSetLayoutBinding layoutBinding{};
 
@@ -977,7 +1075,7 @@ void Shader::createDescriptorSetLayout()
 	{
 		VkDescriptorSetLayoutBinding uniformBinding{};
 		uniformBinding.binding = localUniformLocation;
-		uniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		uniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		uniformBinding.descriptorCount = 1;
 		uniformBinding.stageFlags = stageFlags;
 		bindings.push_back(uniformBinding);
@@ -1012,8 +1110,10 @@ void Shader::createPipelineLayout()
 		computeInfo.stage = shaderStages.at(0);
 		computeInfo.layout = pipelineLayout;
 
-		if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &computeInfo, nullptr, &computePipeline) != VK_SUCCESS)
+		if (vkCreateComputePipelines(device, vgfx->getPipelineCache(), 1, &computeInfo, nullptr, &computePipeline) != VK_SUCCESS)
 			throw love::Exception("failed to create compute pipeline");
+
+		Vulkan::pipelineCreated();
 	}
 }
 
@@ -1022,8 +1122,8 @@ void Shader::createDescriptorPoolSizes()
 	if (!localUniformData.empty())
 	{
 		VkDescriptorPoolSize size{};
-		size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		size.descriptorCount = 1;
+		size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		size.descriptorCount = DESCRIPTOR_POOL_SIZE;
 
 		descriptorPoolSizes.push_back(size);
 	}
@@ -1032,11 +1132,11 @@ void Shader::createDescriptorPoolSizes()
 	{
 		VkDescriptorPoolSize size{};
 		auto type = Vulkan::getDescriptorType(entry.second.baseType);
-		if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+		if (usesLocalUniformData(&entry.second)) {
 			continue;
 		}
 		size.type = type;
-		size.descriptorCount = 1;
+		size.descriptorCount = static_cast<uint32_t>(entry.second.count) * DESCRIPTOR_POOL_SIZE;
 		descriptorPoolSizes.push_back(size);
 	}
 }
@@ -1064,7 +1164,7 @@ void Shader::setVideoTextures(graphics::Texture *ytexture, graphics::Texture *cb
 
 	for (size_t i = 0; i < textures.size(); i++)
 	{
-		if (builtinUniformInfo[builtIns[i]] != nullptr)
+		if (builtinUniformInfo[builtIns[i]] != nullptr && builtinUniformInfo[builtIns[i]]->textures[0] != textures[i])
 		{
 			textures[i]->retain();
 			builtinUniformInfo[builtIns[i]]->textures[0]->release();
@@ -1080,7 +1180,8 @@ bool Shader::hasUniform(const std::string &name) const
 
 void Shader::setMainTex(graphics::Texture *texture)
 {
-	if (builtinUniformInfo[BUILTIN_TEXTURE_MAIN] != nullptr)
+	// Called for every draw, which usually uses the same texture as the last.
+	if (builtinUniformInfo[BUILTIN_TEXTURE_MAIN] != nullptr && builtinUniformInfo[BUILTIN_TEXTURE_MAIN]->textures[0] != texture)
 	{
 		texture->retain();
 		builtinUniformInfo[BUILTIN_TEXTURE_MAIN]->textures[0]->release();
@@ -52,7 +52,7 @@ class Shader final
 	, public Volatile
 {
 public:
-	Shader(StrongRef<love::graphics::ShaderStage> stages[]);
+	Shader(StrongRef<love::graphics::ShaderStage> stages[], const ValidationReflection *prebuiltreflection);
 	virtual ~Shader();
 
 	bool loadVolatile() override;
@@ -66,7 +66,9 @@ public:
 
 	void newFrame();
 
-	void cmdPushDescriptorSets(VkCommandBuffer, VkPipelineBindPoint);
+	// Binds into the given command buffer instead of the current graphics one
+	// when it isn't null.
+	void cmdPushDescriptorSets(VkPipelineBindPoint, VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
 
 	void attach() override;
 
@@ -103,6 +105,8 @@ private:
 		size_t baseoff, 
 		const std::string &basename);
 	void updateUniform(const UniformInfo *info, int count, bool internal);
+	void addDescriptorWrite(const UniformInfo *info);
+	bool descriptorsMatchBoundSet() const;
 
 	VkDescriptorSet allocateDescriptorSet();
 
@@ -121,7 +125,16 @@ private:
 	std::queue<VkDescriptorSet> freeDescriptorSets;
 	std::vector<std::vector<VkDescriptorSet>> descriptorSetsVector;
 
-	std::set<uint32_t> updatedUniforms;
+	// Descriptors for the next draw. They're only written to a new descriptor
+	// set when they differ from the ones in the most recently bound set.
+	std::vector<VkWriteDescriptorSet> descriptorWrites;
+	std::vector<VkDescriptorImageInfo> descriptorImageInfos;
+	std::vector<VkDescriptorBufferInfo> descriptorBufferInfos;
+	std::vector<VkBufferView> descriptorBufferViews;
+
+	std::vector<VkDescriptorImageInfo> boundImageInfos;
+	std::vector<VkDescriptorBufferInfo> boundBufferInfos;
+	std::vector<VkBufferView> boundBufferViews;
 
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
 	std::vector<VkShaderModule> shaderModules;
@@ -142,6 +155,7 @@ private:
 
 	std::unordered_map<std::string, int> attributes;
 
+	// The most recently bound descriptor set in the current frame, if any.
 	VkDescriptorSet currentDescriptorSet;
 
 	uint32_t currentFrame;
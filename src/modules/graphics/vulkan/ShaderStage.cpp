@@ -27,8 +27,8 @@ namespace graphics
 namespace vulkan
 {
 
-ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey)
-	: love::graphics::ShaderStage(gfx, stage, glsl, gles, cachekey)
+ShaderStage::ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv)
+	: love::graphics::ShaderStage(gfx, stage, glsl, gles, cachekey, prebuiltspirv)
 {
 	// the compilation is done in Shader.
 }
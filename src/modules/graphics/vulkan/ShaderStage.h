@@ -33,7 +33,7 @@ namespace vulkan
 class ShaderStage final : public graphics::ShaderStage
 {
 public:
-	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey);
+	ShaderStage(love::graphics::Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey, const std::vector<uint32> *prebuiltspirv);
 
 	ptrdiff_t getHandle() const override;
 };
@@ -58,6 +58,14 @@ bool StreamBuffer::loadVolatile()
 	bufferInfo.usage = getUsageFlags(mode);
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+	const auto &queueFamilies = vgfx->getResourceQueueFamilies();
+	if (!queueFamilies.empty())
+	{
+		bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+		bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+	}
+
 	VmaAllocationCreateInfo allocCreateInfo = {};
 	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
 	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
@@ -119,6 +127,7 @@ size_t StreamBuffer::unmap(size_t usedSize)
 void StreamBuffer::markUsed(size_t usedSize)
 {
 	frameGPUReadOffset += usedSize;
+	frameBytesUsed += usedSize;
 }
 
 void StreamBuffer::nextFrame()
@@ -57,9 +57,19 @@ bool Texture::loadVolatile()
 
 	auto vulkanFormat = Vulkan::getTextureFormat(format, sRGB);
 
-	VkImageUsageFlags usageFlags =
-		VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-		VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	VkImageUsageFlags usageFlags = 0;
+
+	// Transient attachments can't be used for transfers. Color render targets
+	// are kept in the shader-read layout between passes, which also needs
+	// input attachment usage when the image isn't sampled.
+	if (memoryless)
+	{
+		usageFlags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		if (!isPixelFormatDepthStencil(format))
+			usageFlags |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+	}
+	else
+		usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
 	if (readable)
 		usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
@@ -105,11 +115,43 @@ bool Texture::loadVolatile()
 	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	imageInfo.samples = msaaSamples;
 
+	// Compute shaders on the async compute queue can sample any readable
+	// texture as well as write to storage textures, so those are shared with
+	// it. Others stay exclusive since concurrent sharing can disable
+	// compression.
+	const auto &queueFamilies = vgfx->getResourceQueueFamilies();
+	if ((readable || computeWrite) && !queueFamilies.empty())
+	{
+		imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+		imageInfo.pQueueFamilyIndices = queueFamilies.data();
+	}
+
 	VmaAllocationCreateInfo imageAllocationCreateInfo{};
 
-	if (vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr) != VK_SUCCESS)
+	// Tile-based GPUs can back transient attachments with lazily allocated
+	// memory, which is usually never committed. Other GPUs don't have such a
+	// memory type so we fall back to a regular allocation.
+	lazilyAllocated = false;
+	VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+
+	if (memoryless)
+	{
+		VmaAllocationCreateInfo lazyAllocationCreateInfo{};
+		lazyAllocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+		result = vmaCreateImage(allocator, &imageInfo, &lazyAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr);
+		lazilyAllocated = result == VK_SUCCESS;
+	}
+
+	if (result != VK_SUCCESS)
+		result = vgfx->createImage(imageInfo, imageAllocationCreateInfo, textureImage, textureImageAllocation);
+
+	if (result != VK_SUCCESS)
 		throw love::Exception("failed to create image");
 
+	imageCreateInfo = imageInfo;
+
 	auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
 
 	if (isPixelFormatDepthStencil(format))
@@ -144,7 +186,7 @@ bool Texture::loadVolatile()
 			}
 		}
 	}
-	else
+	else if (!memoryless)
 		clear();
 
 	createTextureImageView();
@@ -195,8 +237,18 @@ bool Texture::loadVolatile()
 
 	memsize *= static_cast<int>(msaaSamples);
 
+	if (lazilyAllocated)
+		memsize = 0;
+
 	setGraphicsMemorySize(memsize);
 
+	// Memory defragmentation only moves allocations which point back to their
+	// texture. Views of render targets are also kept in cached framebuffers,
+	// and storage images are shared with the async compute queue.
+	if (!renderTarget && !computeWrite && !memoryless && isPixelFormatColor(format)
+		&& imageLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		vmaSetAllocationUserData(allocator, textureImageAllocation, this);
+
 	return true;
 }
 
@@ -205,6 +257,8 @@ void Texture::unloadVolatile()
 	if (textureImage == VK_NULL_HANDLE)
 		return;
 
+	vmaSetAllocationUserData(allocator, textureImageAllocation, nullptr);
+
 	vgfx->queueCleanUp([
 		device = device, 
 		textureImageView = textureImageView, 
@@ -271,6 +325,72 @@ VkImageLayout Texture::getImageLayout() const
 	return imageLayout;
 }
 
+bool Texture::moveToAllocation(VkCommandBuffer commandBuffer, VmaAllocation allocation, std::function<void()> &cleanUp)
+{
+	VkImage newImage = VK_NULL_HANDLE;
+	if (vkCreateImage(device, &imageCreateInfo, nullptr, &newImage) != VK_SUCCESS)
+		return false;
+
+	if (vmaBindImageMemory(allocator, allocation, newImage) != VK_SUCCESS)
+	{
+		vkDestroyImage(device, newImage, nullptr);
+		return false;
+	}
+
+	VkImage oldImage = textureImage;
+	VkImageView oldImageView = textureImageView;
+
+	textureImage = newImage;
+
+	try
+	{
+		createTextureImageView();
+	}
+	catch (love::Exception &)
+	{
+		vkDestroyImage(device, newImage, nullptr);
+		textureImage = oldImage;
+		textureImageView = oldImageView;
+		return false;
+	}
+
+	Vulkan::cmdTransitionImageLayout(commandBuffer, oldImage, imageLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	Vulkan::cmdTransitionImageLayout(commandBuffer, newImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+	std::vector<VkImageCopy> regions;
+
+	for (int mip = 0; mip < getMipmapCount(); mip++)
+	{
+		VkImageCopy region{};
+		region.srcSubresource.aspectMask = imageAspect;
+		region.srcSubresource.mipLevel = static_cast<uint32_t>(mip);
+		region.srcSubresource.baseArrayLayer = 0;
+		region.srcSubresource.layerCount = static_cast<uint32_t>(layerCount);
+		region.dstSubresource = region.srcSubresource;
+		region.extent.width = static_cast<uint32_t>(getPixelWidth(mip));
+		region.extent.height = static_cast<uint32_t>(getPixelHeight(mip));
+		region.extent.depth = static_cast<uint32_t>(getDepth(mip));
+
+		regions.push_back(region);
+	}
+
+	vkCmdCopyImage(commandBuffer,
+		oldImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		newImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<uint32_t>(regions.size()), regions.data());
+
+	Vulkan::cmdTransitionImageLayout(commandBuffer, newImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, imageLayout);
+
+	// The old image's memory belongs to the allocation, which VMA moves to the
+	// new place once the defragmentation pass ends.
+	cleanUp = [device = device, oldImage, oldImageView]() {
+		vkDestroyImageView(device, oldImageView, nullptr);
+		vkDestroyImage(device, oldImage, nullptr);
+	};
+
+	return true;
+}
+
 void Texture::createTextureImageView()
 {
 	auto vulkanFormat = Vulkan::getTextureFormat(format, sRGB);
@@ -455,7 +575,7 @@ void Texture::generateMipmapsInternal()
 			1, &barrier);
 }
 
-void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength)
 {
 	VkBuffer stagingBuffer;
 	VmaAllocation vmaAllocation;
@@ -476,7 +596,7 @@ void Texture::uploadByteData(PixelFormat pixelformat, const void *data, size_t s
 
 	VkBufferImageCopy region{};
 	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
+	region.bufferRowLength = rowlength != r.w ? (uint32_t) rowlength : 0;
 	region.bufferImageHeight = 0;
 
 	uint32_t baseLayer;
@@ -25,6 +25,8 @@
 
 #include "VulkanWrapper.h"
 
+#include <functional>
+
 
 namespace love
 {
@@ -59,13 +61,21 @@ public:
 	VkImageView getRenderTargetView(int mip, int layer);
 	VkSampleCountFlagBits getMsaaSamples() const;
 
-	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) override;
+	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r, int rowlength) override;
 
 	void generateMipmapsInternal()  override;
 
 	int getMSAA() const override;
 	ptrdiff_t getHandle() const override;
 
+	/**
+	 * Used by memory defragmentation. Records a copy of the image into a new
+	 * image bound to the given allocation and switches over to it, the old
+	 * image and view are destroyed by the returned cleanup function once the
+	 * copy has finished. Returns false if the texture can't be moved.
+	 **/
+	bool moveToAllocation(VkCommandBuffer commandBuffer, VmaAllocation allocation, std::function<void()> &cleanUp);
+
 private:
 	void createTextureImageView();
 	void clear();
@@ -79,6 +89,8 @@ private:
 	VkImage textureImage = VK_NULL_HANDLE;
 	VkImageLayout imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	VmaAllocation textureImageAllocation = VK_NULL_HANDLE;
+	VkImageCreateInfo imageCreateInfo{};
+	bool lazilyAllocated = false;
 	VkImageView textureImageView = VK_NULL_HANDLE;
 	std::vector<std::vector<VkImageView>> renderTargetImageViews;
 	VkSampler textureSampler = VK_NULL_HANDLE;
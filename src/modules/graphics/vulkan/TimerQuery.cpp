@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TimerQuery.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+TimerQuery::TimerQuery(love::graphics::Graphics *gfx)
+	: graphics::TimerQuery(gfx)
+	, vgfx(dynamic_cast<Graphics*>(gfx))
+	, completedGeneration(std::make_shared<uint64>(0))
+{
+	loadVolatile();
+}
+
+TimerQuery::~TimerQuery()
+{
+	unloadVolatile();
+}
+
+bool TimerQuery::loadVolatile()
+{
+	if (queryPool != VK_NULL_HANDLE)
+		return true;
+
+	VkQueryPoolCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	createInfo.queryCount = 2;
+
+	if (vkCreateQueryPool(vgfx->getDevice(), &createInfo, nullptr, &queryPool) != VK_SUCCESS)
+		throw love::Exception("failed to create timestamp query pool");
+
+	return true;
+}
+
+void TimerQuery::unloadVolatile()
+{
+	if (queryPool == VK_NULL_HANDLE)
+		return;
+
+	vgfx->queueCleanUp([device = vgfx->getDevice(), queryPool = queryPool](){
+		vkDestroyQueryPool(device, queryPool, nullptr);
+	});
+
+	queryPool = VK_NULL_HANDLE;
+}
+
+void TimerQuery::timestamp(Timestamp t)
+{
+	// Query resets aren't allowed inside a render pass, which
+	// getCommandBufferForDataTransfer ends.
+	VkCommandBuffer commandBuffer = vgfx->getCommandBufferForDataTransfer();
+
+	if (t == TIMESTAMP_START)
+	{
+		generation++;
+		vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+	}
+	else
+	{
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+
+		vgfx->addReadbackCallback([completed = completedGeneration, generation = generation](){
+			*completed = generation;
+		});
+	}
+}
+
+bool TimerQuery::getTimestamps(uint64 &startns, uint64 &stopns)
+{
+	if (*completedGeneration != generation)
+		return false;
+
+	uint64_t results[2] = {0, 0};
+
+	VkResult result = vkGetQueryPoolResults(vgfx->getDevice(), queryPool, 0, 2, sizeof(results), results, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+	if (result == VK_NOT_READY)
+		return false;
+
+	double period = vgfx->getTimestampPeriod();
+
+	uint32_t validbits = vgfx->getTimestampValidBits();
+	uint64 mask = validbits >= 64 ? ~(uint64) 0 : ((uint64) 1 << validbits) - 1;
+
+	uint64 start = results[0] & mask;
+	uint64 stop = results[1] & mask;
+
+	// The counter may have wrapped around between the two timestamps.
+	uint64 elapsed = (stop - start) & mask;
+
+	startns = (uint64) (start * period);
+	stopns = startns + (uint64) (elapsed * period);
+
+	return true;
+}
+
+} // vulkan
+} // graphics
+} // love
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "graphics/TimerQuery.h"
+#include "graphics/Volatile.h"
+
+#include "VulkanWrapper.h"
+
+#include <memory>
+
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+class Graphics;
+
+class TimerQuery final
+	: public love::graphics::TimerQuery
+	, public Volatile
+{
+public:
+	TimerQuery(love::graphics::Graphics *gfx);
+	virtual ~TimerQuery();
+
+	virtual bool loadVolatile() override;
+	virtual void unloadVolatile() override;
+
+protected:
+	void timestamp(Timestamp t) override;
+	bool getTimestamps(uint64 &startns, uint64 &stopns) override;
+
+private:
+	Graphics *vgfx = nullptr;
+	VkQueryPool queryPool = VK_NULL_HANDLE;
+
+	// Query results can only be read once the frame containing the stop
+	// timestamp has finished on the GPU. Each start/stop pair gets a new
+	// generation so late callbacks from an earlier pair are ignored.
+	uint64 generation = 0;
+	std::shared_ptr<uint64> completedGeneration;
+};
+
+} // vulkan
+} // graphics
+} // love
@@ -31,6 +31,9 @@ namespace vulkan
 {
 
 static uint32_t numShaderSwitches;
+static uint32_t numPipelineCreations;
+static uint32_t numSamplerCreations;
+static uint32_t numDescriptorWrites;
 
 void Vulkan::shaderSwitch()
 {
@@ -42,9 +45,42 @@ uint32_t Vulkan::getNumShaderSwitches()
 	return numShaderSwitches;
 }
 
-void Vulkan::resetShaderSwitches()
+void Vulkan::pipelineCreated()
+{
+	numPipelineCreations++;
+}
+
+uint32_t Vulkan::getNumPipelineCreations()
+{
+	return numPipelineCreations;
+}
+
+void Vulkan::samplerCreated()
+{
+	numSamplerCreations++;
+}
+
+uint32_t Vulkan::getNumSamplerCreations()
+{
+	return numSamplerCreations;
+}
+
+void Vulkan::descriptorsWritten(uint32_t count)
+{
+	numDescriptorWrites += count;
+}
+
+uint32_t Vulkan::getNumDescriptorWrites()
+{
+	return numDescriptorWrites;
+}
+
+void Vulkan::resetStats()
 {
 	numShaderSwitches = 0;
+	numPipelineCreations = 0;
+	numSamplerCreations = 0;
+	numDescriptorWrites = 0;
 }
 
 VkFormat Vulkan::getVulkanVertexFormat(DataFormat format)
@@ -706,6 +742,8 @@ VkDescriptorType Vulkan::getDescriptorType(graphics::Shader::UniformType type)
 		return VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
 	case graphics::Shader::UniformType::UNIFORM_STORAGEBUFFER:
 		return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	case graphics::Shader::UniformType::UNIFORM_UNIFORMBUFFER:
+		return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 	default:
 		throw love::Exception("unkonwn uniform type");
 	}
@@ -49,14 +49,22 @@ struct TextureFormat
 	VkComponentSwizzle swizzleA = VK_COMPONENT_SWIZZLE_IDENTITY;
 };
 
-constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+// Per-frame resources are created for the most frames in flight a window can
+// ask for, Graphics waits on older frames when fewer are requested.
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = (uint32_t) graphics::MAX_FRAMES_IN_FLIGHT;
 
 class Vulkan
 {
 public:
 	static void shaderSwitch();
 	static uint32_t getNumShaderSwitches();
-	static void resetShaderSwitches();
+	static void pipelineCreated();
+	static uint32_t getNumPipelineCreations();
+	static void samplerCreated();
+	static uint32_t getNumSamplerCreations();
+	static void descriptorsWritten(uint32_t count);
+	static uint32_t getNumDescriptorWrites();
+	static void resetStats();
 
 	static VkFormat getVulkanVertexFormat(DataFormat format);
 	static TextureFormat getTextureFormat(PixelFormat, bool sRGB);
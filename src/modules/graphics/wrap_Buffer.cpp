@@ -20,6 +20,7 @@
 
 #include "wrap_Buffer.h"
 #include "Buffer.h"
+#include "BufferMapping.h"
 #include "common/Data.h"
 
 #include <limits>
@@ -318,6 +319,36 @@ static int w_Buffer_setArrayData(lua_State *L)
 	return 0;
 }
 
+static int w_Buffer_map(lua_State *L)
+{
+	Buffer *t = luax_checkbuffer(L, 1);
+
+	const char *typestr = luaL_checkstring(L, 2);
+	Buffer::MapType maptype = Buffer::MAP_WRITE_INVALIDATE;
+	if (!getConstant(typestr, maptype))
+		return luax_enumerror(L, "buffer map type", getConstants(maptype), typestr);
+
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	lua_Integer size = luaL_optinteger(L, 4, (lua_Integer) t->getSize() - offset);
+
+	if (offset < 0 || size <= 0)
+		return luaL_error(L, "Invalid Buffer map range (offset %d, size %d).", (int) offset, (int) size);
+
+	BufferMapping *mapping = nullptr;
+	luax_catchexcept(L, [&](){ mapping = new BufferMapping(t, maptype, (size_t) offset, (size_t) size); });
+
+	luax_pushtype(L, mapping);
+	mapping->release();
+	return 1;
+}
+
+static int w_Buffer_isMapped(lua_State *L)
+{
+	Buffer *t = luax_checkbuffer(L, 1);
+	luax_pushboolean(L, t->isMapped());
+	return 1;
+}
+
 static int w_Buffer_getElementCount(lua_State *L)
 {
 	Buffer *t = luax_checkbuffer(L, 1);
@@ -386,6 +417,8 @@ static int w_Buffer_isBufferType(lua_State *L)
 static const luaL_Reg w_Buffer_functions[] =
 {
 	{ "setArrayData", w_Buffer_setArrayData },
+	{ "map", w_Buffer_map },
+	{ "isMapped", w_Buffer_isMapped },
 	{ "getElementCount", w_Buffer_getElementCount },
 	{ "getElementStride", w_Buffer_getElementStride },
 	{ "getSize", w_Buffer_getSize },
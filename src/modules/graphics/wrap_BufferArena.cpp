@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_BufferArena.h"
+
+namespace love
+{
+namespace graphics
+{
+
+BufferArena *luax_checkbufferarena(lua_State *L, int idx)
+{
+	return luax_checktype<BufferArena>(L, idx);
+}
+
+int w_BufferArena_getPageLength(lua_State *L)
+{
+	BufferArena *t = luax_checkbufferarena(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getPageLength());
+	return 1;
+}
+
+int w_BufferArena_getPageCount(lua_State *L)
+{
+	BufferArena *t = luax_checkbufferarena(L, 1);
+	lua_pushinteger(L, t->getPageCount());
+	return 1;
+}
+
+int w_BufferArena_getAllocatedCount(lua_State *L)
+{
+	BufferArena *t = luax_checkbufferarena(L, 1);
+	lua_pushnumber(L, (lua_Number) t->getAllocatedCount());
+	return 1;
+}
+
+static const luaL_Reg w_BufferArena_functions[] =
+{
+	{ "getPageLength", w_BufferArena_getPageLength },
+	{ "getPageCount", w_BufferArena_getPageCount },
+	{ "getAllocatedCount", w_BufferArena_getAllocatedCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_bufferarena(lua_State *L)
+{
+	return luax_register_type(L, &BufferArena::type, w_BufferArena_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_BufferMapping.h"
+#include "data/wrap_Data.h"
+
+namespace love
+{
+namespace graphics
+{
+
+BufferMapping *luax_checkbuffermapping(lua_State *L, int idx)
+{
+	return luax_checktype<BufferMapping>(L, idx);
+}
+
+int w_BufferMapping_unmap(lua_State *L)
+{
+	BufferMapping *t = luax_checkbuffermapping(L, 1);
+	if (lua_isnoneornil(L, 2))
+		t->unmap();
+	else
+		t->unmap((size_t) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_BufferMapping_isMapped(lua_State *L)
+{
+	BufferMapping *t = luax_checkbuffermapping(L, 1);
+	luax_pushboolean(L, t->isMapped());
+	return 1;
+}
+
+int w_BufferMapping_getBuffer(lua_State *L)
+{
+	BufferMapping *t = luax_checkbuffermapping(L, 1);
+	luax_pushtype(L, t->getBuffer());
+	return 1;
+}
+
+static const luaL_Reg w_BufferMapping_functions[] =
+{
+	{ "unmap", w_BufferMapping_unmap },
+	{ "isMapped", w_BufferMapping_isMapped },
+	{ "getBuffer", w_BufferMapping_getBuffer },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_buffermapping(lua_State *L)
+{
+	int ret = luax_register_type(L, &BufferMapping::type, data::w_Data_functions, w_BufferMapping_functions, nullptr);
+	love::data::luax_rundatawrapper(L, BufferMapping::type);
+	return ret;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_DrawList.h"
+
+namespace love
+{
+namespace graphics
+{
+
+DrawList *luax_checkdrawlist(lua_State *L, int idx)
+{
+	return luax_checktype<DrawList>(L, idx);
+}
+
+int w_DrawList_clear(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	luax_catchexcept(L, [&](){ t->clear(); });
+	return 0;
+}
+
+int w_DrawList_isRecording(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	luax_pushboolean(L, t->isRecording());
+	return 1;
+}
+
+int w_DrawList_getDrawCount(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	lua_pushinteger(L, t->getDrawCount());
+	return 1;
+}
+
+int w_DrawList_getVertexCount(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	lua_pushinteger(L, t->getVertexCount());
+	return 1;
+}
+
+static const luaL_Reg w_DrawList_functions[] =
+{
+	{ "clear", w_DrawList_clear },
+	{ "isRecording", w_DrawList_isRecording },
+	{ "getDrawCount", w_DrawList_getDrawCount },
+	{ "getVertexCount", w_DrawList_getVertexCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_drawlist(lua_State *L)
+{
+	return luax_register_type(L, &DrawList::type, w_DrawList_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -264,6 +264,28 @@ int w_Font_getDPIScale(lua_State *L)
 	return 1;
 }
 
+int w_Font_setAsyncRasterization(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setAsyncRasterization(enable); });
+	return 0;
+}
+
+int w_Font_isAsyncRasterization(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isAsyncRasterization());
+	return 1;
+}
+
+int w_Font_isSDF(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
 static const luaL_Reg w_Font_functions[] =
 {
 	{ "getHeight", w_Font_getHeight },
@@ -280,6 +302,9 @@ static const luaL_Reg w_Font_functions[] =
 	{ "getKerning", w_Font_getKerning },
 	{ "setFallbacks", w_Font_setFallbacks },
 	{ "getDPIScale", w_Font_getDPIScale },
+	{ "setAsyncRasterization", w_Font_setAsyncRasterization },
+	{ "isAsyncRasterization", w_Font_isAsyncRasterization },
+	{ "isSDF", w_Font_isSDF },
 	{ 0, 0 }
 };
 
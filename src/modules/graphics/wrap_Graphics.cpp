@@ -174,6 +174,19 @@ int w_discard(lua_State *L)
 	return 0;
 }
 
+int w_beginConditionalRender(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&]() { instance()->beginConditionalRender(q); });
+	return 0;
+}
+
+int w_endConditionalRender(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->endConditionalRender(); });
+	return 0;
+}
+
 int w_present(lua_State *L)
 {
 	luax_catchexcept(L, [&]() { instance()->present(L); });
@@ -318,6 +331,12 @@ int w_setCanvas(lua_State *L)
 
 		if (targets.depthStencil.texture == nullptr && (targets.temporaryRTFlags & tempstencilflag) == 0)
 			targets.temporaryRTFlags |= luax_boolflag(L, 1, "stencil", false) ? tempstencilflag : 0;
+
+		if (luax_boolflag(L, 1, "discard", false))
+			targets.passFlags |= Graphics::RENDER_PASS_DISCARD_ON_BEGIN;
+
+		if (!luax_boolflag(L, 1, "storedepth", true))
+			targets.passFlags |= Graphics::RENDER_PASS_DONT_STORE_DEPTH_STENCIL;
 	}
 	else
 	{
@@ -469,9 +488,11 @@ static void screenshotFileCallback(const Graphics::ScreenshotInfo *info, love::i
 
 	if (i != nullptr && fileinfo != nullptr)
 	{
+		// Encoding happens on another thread, so continuous captures don't
+		// stall the main thread.
 		try
 		{
-			i->encode(fileinfo->format, fileinfo->filename.c_str(), true);
+			instance()->saveScreenshotAsync(i, fileinfo->format, fileinfo->filename);
 		}
 		catch (love::Exception &e)
 		{
@@ -716,7 +737,14 @@ static int w__pushNewTexture(lua_State *L, Texture::Slices *slices, const Textur
 {
 	StrongRef<Texture> i;
 	luax_catchexcept(L,
-		[&]() { i.set(instance()->newTexture(settings, slices), Acquire::NORETAIN); },
+		[&]() {
+			if (settings.async || settings.streaming)
+				i.set(instance()->newTextureAsync(settings, slices), Acquire::NORETAIN);
+			else
+				i.set(instance()->newTexture(settings, slices), Acquire::NORETAIN);
+			if (settings.arrayBatching)
+				instance()->addToSharedArrayTexture(i, i->isReady() ? slices : nullptr);
+		},
 		[&](bool) { if (slices) slices->clear(); }
 	);
 
@@ -785,6 +813,10 @@ static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool chec
 	s.msaa = luax_intflag(L, idx, Texture::getConstant(Texture::SETTING_MSAA), s.msaa);
 
 	s.computeWrite = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_COMPUTE_WRITE), s.computeWrite);
+	s.arrayBatching = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_ARRAY_BATCHING), s.arrayBatching);
+	s.async = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_ASYNC), s.async);
+	s.streaming = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_STREAMING), s.streaming);
+	s.memoryless = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_MEMORYLESS), s.memoryless);
 
 	lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_READABLE));
 	if (!lua_isnoneornil(L, -1))
@@ -843,6 +875,37 @@ int w_newCanvas(lua_State *L)
 	return 1;
 }
 
+int w_getTransientCanvas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int w = (int) luaL_checkinteger(L, 1);
+	int h = (int) luaL_checkinteger(L, 2);
+
+	PixelFormat format = PIXELFORMAT_NORMAL;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!getConstant(str, format))
+			return luax_enumerror(L, "pixel format", str);
+	}
+
+	int msaa = (int) luaL_optinteger(L, 4, 1);
+
+	Texture *texture = nullptr;
+	luax_catchexcept(L, [&](){ texture = instance()->getTransientTexture(format, w, h, msaa); });
+
+	luax_pushtype(L, texture);
+	return 1;
+}
+
+int w_releaseTransientCanvas(lua_State *L)
+{
+	Texture *texture = luax_checktexture(L, 1);
+	luax_catchexcept(L, [&](){ instance()->releaseTransientTexture(texture); });
+	return 0;
+}
+
 int w_newTexture(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1311,16 +1374,57 @@ int w_newSpriteBatch(lua_State *L)
 	Texture *texture = luax_checktexture(L, 1);
 	int size = (int) luaL_optinteger(L, 2, 1000);
 	BufferDataUsage usage = BUFFERDATAUSAGE_DYNAMIC;
-	if (lua_gettop(L) > 2)
+	if (!lua_isnoneornil(L, 3))
 	{
 		const char *usagestr = luaL_checkstring(L, 3);
 		if (!getConstant(usagestr, usage))
 			return luax_enumerror(L, "usage hint", getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
+	);
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newTileMap(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Texture *texture = luax_checktexture(L, 1);
+	int tilewidth = (int) luaL_checkinteger(L, 2);
+	int tileheight = (int) luaL_checkinteger(L, 3);
+	int width = (int) luaL_checkinteger(L, 4);
+	int height = (int) luaL_checkinteger(L, 5);
+
+	TileMap::Settings settings;
+
+	if (!lua_isnoneornil(L, 6))
+	{
+		luaL_checktype(L, 6, LUA_TTABLE);
+
+		lua_getfield(L, 6, "chunksize");
+		settings.chunkSize = (int) luaL_optinteger(L, -1, settings.chunkSize);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 6, "margin");
+		settings.margin = (int) luaL_optinteger(L, -1, settings.margin);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 6, "spacing");
+		settings.spacing = (int) luaL_optinteger(L, -1, settings.spacing);
+		lua_pop(L, 1);
+	}
+
+	TileMap *t = nullptr;
+	luax_catchexcept(L,
+		[&](){ t = instance()->newTileMap(texture, tilewidth, tileheight, width, height, settings); }
 	);
 
 	luax_pushtype(L, t);
@@ -1334,12 +1438,31 @@ int w_newParticleSystem(lua_State *L)
 
 	Texture *texture = luax_checktexture(L, 1);
 	lua_Number size = luaL_optnumber(L, 2, 1000);
+	bool gpu = luax_optboolean(L, 3, false);
 	ParticleSystem *t = nullptr;
 	if (size < 1.0 || size > ParticleSystem::MAX_PARTICLES)
 		return luaL_error(L, "Invalid ParticleSystem size");
 
 	luax_catchexcept(L,
-		[&](){ t = instance()->newParticleSystem(texture, int(size)); }
+		[&](){ t = instance()->newParticleSystem(texture, int(size), gpu); }
+	);
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newLine(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	std::vector<Vector2> points;
+	luax_checklinepoints(L, 1, points);
+	bool gpuexpanded = luax_optboolean(L, 2, false);
+
+	Line *t = nullptr;
+	luax_catchexcept(L,
+		[&](){ t = instance()->newLine(points.data(), points.size(), gpuexpanded); }
 	);
 
 	luax_pushtype(L, t);
@@ -1347,12 +1470,30 @@ int w_newParticleSystem(lua_State *L)
 	return 1;
 }
 
+int w_updateParticleSystems(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float dt = (float) luaL_checknumber(L, 2);
+
+	int count = (int) luax_objlen(L, 1);
+	std::vector<ParticleSystem *> systems;
+	systems.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		systems.push_back(luax_checkparticlesystem(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ ParticleSystem::updateMany(systems, dt); });
+	return 0;
+}
+
 static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string> &stages, Shader::CompileOptions &options)
 {
 	using namespace love::filesystem;
 
-	luax_checkgraphicscreated(L);
-
 	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
 
 	// read any filepath arguments
@@ -1421,34 +1562,7 @@ static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string
 			if (!lua_istable(L, -1))
 				luaL_argerror(L, optionsidx, "expected 'defines' field to be a table");
 
-			lua_pushnil(L);
-			while (lua_next(L, -2))
-			{
-				std::string defname;
-				std::string defval;
-
-				if (lua_type(L, -2) == LUA_TNUMBER && lua_type(L, -1) == LUA_TSTRING)
-					defname = luaL_checkstring(L, -1);
-				else if (lua_type(L, -2) != LUA_TSTRING)
-					luaL_argerror(L, optionsidx, "all fields in the 'defines' table must use string keys.");
-				else
-				{
-					defname = luaL_checkstring(L, -2);
-					if (lua_type(L, -1) == LUA_TBOOLEAN)
-						defval = luax_toboolean(L, -1) ? "1" : "0";
-					else
-					{
-						const char *val = lua_tostring(L, -1);
-						if (val == nullptr)
-							luaL_argerror(L, optionsidx, "'defines' table values must be strings, numbers, or booleans.");
-						defval = val;
-					}
-				}
-
-				options.defines[defname] = defval;
-
-				lua_pop(L, 1);
-			}
+			luax_checkshaderdefines(L, -1, optionsidx, options.defines);
 		}
 		lua_pop(L, 1);
 	}
@@ -1458,6 +1572,8 @@ static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string
 
 int w_newShader(lua_State *L)
 {
+	luax_checkgraphicscreated(L);
+
 	std::vector<std::string> stages;
 	Shader::CompileOptions options;
 	w_getShaderSource(L, 1, stages, options);
@@ -1487,6 +1603,8 @@ int w_newShader(lua_State *L)
 
 int w_newComputeShader(lua_State* L)
 {
+	luax_checkgraphicscreated(L);
+
 	std::vector<std::string> stages;
 	Shader::CompileOptions options;
 	w_getShaderSource(L, 1, stages, options);
@@ -1518,6 +1636,8 @@ int w_validateShader(lua_State *L)
 {
 	bool gles = luax_checkboolean(L, 1);
 
+	luax_checkgraphicscreated(L);
+
 	std::vector<std::string> stages;
 	Shader::CompileOptions options;
 	w_getShaderSource(L, 2, stages, options);
@@ -1545,6 +1665,98 @@ int w_validateShader(lua_State *L)
 	return 1;
 }
 
+int w_newShaderAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	std::vector<std::string> stages;
+	Shader::CompileOptions options;
+	w_getShaderSource(L, 1, stages, options);
+
+	bool should_error = false;
+	try
+	{
+		PendingShader *shader = instance()->newShaderAsync(stages, options);
+		luax_pushtype(L, shader);
+		shader->release();
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	return 1;
+}
+
+int w_newComputeShaderAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	std::vector<std::string> stages;
+	Shader::CompileOptions options;
+	w_getShaderSource(L, 1, stages, options);
+
+	bool should_error = false;
+	try
+	{
+		PendingShader *shader = instance()->newComputeShaderAsync(stages[0], options);
+		luax_pushtype(L, shader);
+		shader->release();
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	return 1;
+}
+
+int w_compileShaderBundle(lua_State *L)
+{
+	std::vector<std::string> stages;
+	Shader::CompileOptions options;
+	w_getShaderSource(L, 1, stages, options);
+
+	std::string bundle;
+
+	bool should_error = false;
+	try
+	{
+		bundle = instance()->compileShaderBundle(stages, options);
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	lua_pushlstring(L, bundle.data(), bundle.size());
+	return 1;
+}
+
 static BufferDataUsage luax_optdatausage(lua_State *L, int idx, BufferDataUsage def)
 {
 	const char *usagestr = lua_isnoneornil(L, idx) ? nullptr : luaL_checkstring(L, idx);
@@ -1868,6 +2080,50 @@ static PrimitiveType luax_checkmeshdrawmode(lua_State *L, int idx)
 	return mode;
 }
 
+/**
+ * Writes a table of vertex tables into the Mesh's vertex data, following its
+ * vertex format.
+ **/
+static void luax_writemeshvertices(lua_State *L, int idx, Mesh *t, size_t numvertices)
+{
+	char *data = (char *) t->getVertexData();
+	size_t stride = t->getVertexStride();
+	const auto &members = t->getVertexFormat();
+
+	for (size_t vertindex = 0; vertindex < numvertices; vertindex++)
+	{
+		// get vertices[vertindex]
+		lua_rawgeti(L, idx, vertindex + 1);
+		luaL_checktype(L, -1, LUA_TTABLE);
+
+		int n = 0;
+		for (size_t i = 0; i < members.size(); i++)
+		{
+			const auto &member = members[i];
+			const auto &info = getDataFormatInfo(member.decl.format);
+
+			// get vertices[vertindex][n]
+			for (int c = 0; c < info.components; c++)
+			{
+				n++;
+				lua_rawgeti(L, -(c + 1), n);
+			}
+
+			size_t offset = vertindex * stride + member.offset;
+
+			// Fetch the values from Lua and store them in data buffer.
+			luax_writebufferdata(L, -info.components, member.decl.format, data + offset);
+
+			lua_pop(L, info.components);
+		}
+
+		lua_pop(L, 1); // pop vertices[vertindex]
+	}
+
+	t->setVertexDataModified(0, stride * numvertices);
+	t->flush();
+}
+
 static Mesh *newStandardMesh(lua_State *L)
 {
 	Mesh *t = nullptr;
@@ -2038,42 +2294,40 @@ static Mesh *newCustomMesh(lua_State *L)
 
 		luax_catchexcept(L, [&](){ t = instance()->newMesh(vertexformat, numvertices, drawmode, usage); });
 
-		char *data = (char *) t->getVertexData();
-		size_t stride = t->getVertexStride();
-		const auto &members = t->getVertexFormat();
-
-		for (size_t vertindex = 0; vertindex < numvertices; vertindex++)
-		{
-			// get vertices[vertindex]
-			lua_rawgeti(L, 2, vertindex + 1);
-			luaL_checktype(L, -1, LUA_TTABLE);
-
-			int n = 0;
-			for (size_t i = 0; i < vertexformat.size(); i++)
-			{
-				const auto &member = members[i];
-				const auto &info = getDataFormatInfo(member.decl.format);
+		luax_writemeshvertices(L, 2, t, numvertices);
+	}
 
-				// get vertices[vertindex][n]
-				for (int c = 0; c < info.components; c++)
-				{
-					n++;
-					lua_rawgeti(L, -(c + 1), n);
-				}
+	return t;
+}
 
-				size_t offset = vertindex * stride + member.offset;
+static Mesh *newArenaMesh(lua_State *L)
+{
+	Mesh *t = nullptr;
 
-				// Fetch the values from Lua and store them in data buffer.
-				luax_writebufferdata(L, -info.components, member.decl.format, data + offset);
+	BufferArena *arena = luax_checkbufferarena(L, 1);
+	PrimitiveType drawmode = luax_checkmeshdrawmode(L, 3);
 
-				lua_pop(L, info.components);
-			}
+	if (lua_isnumber(L, 2))
+	{
+		int vertexcount = (int) luaL_checkinteger(L, 2);
+		if (vertexcount <= 0)
+			luaL_error(L, "Invalid number of vertices (%d).", vertexcount);
+		luax_catchexcept(L, [&](){ t = instance()->newMesh(arena, nullptr, (size_t) vertexcount, drawmode); });
+	}
+	else if (luax_istype(L, 2, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		size_t vertexcount = data->getSize() / arena->getArrayStride();
+		luax_catchexcept(L, [&](){ t = instance()->newMesh(arena, data->getData(), vertexcount, drawmode); });
+	}
+	else
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		size_t numvertices = luax_objlen(L, 2);
 
-			lua_pop(L, 1); // pop vertices[vertindex]
-		}
+		luax_catchexcept(L, [&](){ t = instance()->newMesh(arena, nullptr, numvertices, drawmode); });
 
-		t->setVertexDataModified(0, stride * numvertices);
-		t->flush();
+		luax_writemeshvertices(L, 2, t, numvertices);
 	}
 
 	return t;
@@ -2083,13 +2337,21 @@ int w_newMesh(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
 
+	Mesh *t = nullptr;
+
+	if (luax_istype(L, 1, BufferArena::type))
+	{
+		t = newArenaMesh(L);
+		luax_pushtype(L, t);
+		t->release();
+		return 1;
+	}
+
 	// Check first argument: table or number of vertices.
 	int arg1type = lua_type(L, 1);
 	if (arg1type != LUA_TTABLE && arg1type != LUA_TNUMBER)
 		luaL_argerror(L, 1, "table or number expected");
 
-	Mesh *t = nullptr;
-
 	int arg2type = lua_type(L, 2);
 	if (arg1type == LUA_TTABLE && (arg2type == LUA_TTABLE || arg2type == LUA_TNUMBER || arg2type == LUA_TUSERDATA))
 		t = newCustomMesh(L);
@@ -2101,6 +2363,30 @@ int w_newMesh(lua_State *L)
 	return 1;
 }
 
+int w_newBufferArena(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	std::vector<Buffer::DataDeclaration> format;
+	if (lua_isnoneornil(L, 1))
+		format = Mesh::getDefaultVertexFormat();
+	else
+		luax_checkbufferformat(L, 1, format);
+
+	int pagelength = (int) luaL_checkinteger(L, 2);
+	if (pagelength <= 0)
+		return luaL_error(L, "Invalid BufferArena page length (%d).", pagelength);
+
+	BufferDataUsage usage = luax_optdatausage(L, 3, BUFFERDATAUSAGE_DYNAMIC);
+
+	BufferArena *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newBufferArena(format, (size_t) pagelength, usage); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newTextBatch(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -2123,11 +2409,49 @@ int w_newTextBatch(lua_State *L)
 	return 1;
 }
 
-int w_newText(lua_State *L)
+int w_newDrawList(lua_State *L)
 {
-	luax_markdeprecated(L, 1, "love.graphics.newText", API_FUNCTION, DEPRECATED_RENAMED, "love.graphics.newTextBatch");
-	return w_newTextBatch(L);
-}
+	luax_checkgraphicscreated(L);
+
+	DrawList *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newDrawList(); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newTimerQuery(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	TimerQuery *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newTimerQuery(); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newOcclusionQuery(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	bool precise = luax_optboolean(L, 1, false);
+
+	OcclusionQuery *q = nullptr;
+	luax_catchexcept(L, [&](){ q = instance()->newOcclusionQuery(precise); });
+
+	luax_pushtype(L, q);
+	q->release();
+	return 1;
+}
+
+int w_newText(lua_State *L)
+{
+	luax_markdeprecated(L, 1, "love.graphics.newText", API_FUNCTION, DEPRECATED_RENAMED, "love.graphics.newTextBatch");
+	return w_newTextBatch(L);
+}
 
 int w_newVideo(lua_State *L)
 {
@@ -2147,6 +2471,54 @@ int w_newVideo(lua_State *L)
 	return 1;
 }
 
+int w_newReadbackRing(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int slotcount = (int) luaL_optinteger(L, 1, 3);
+
+	ReadbackRing *r = nullptr;
+	luax_catchexcept(L, [&](){ r = instance()->newReadbackRing(slotcount); });
+
+	luax_pushtype(L, r);
+	r->release();
+	return 1;
+}
+
+int w_newVirtualTexture(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	VirtualTexture::Settings s;
+	s.width = (int) luaL_checkinteger(L, 1);
+	s.height = (int) luaL_checkinteger(L, 2);
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		s.pageSize = luax_intflag(L, 3, "pagesize", s.pageSize);
+		s.cachePages = luax_intflag(L, 3, "cachepages", s.cachePages);
+		s.linear = luax_boolflag(L, 3, "linear", s.linear);
+
+		lua_getfield(L, 3, "format");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!getConstant(str, s.format))
+				return luax_enumerror(L, "pixel format", str);
+		}
+		lua_pop(L, 1);
+	}
+
+	VirtualTexture *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newVirtualTexture(s); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_readbackBuffer(lua_State *L)
 {
 	Buffer *b = luax_checkbuffer(L, 1);
@@ -2586,6 +2958,25 @@ int w_getDefaultMipmapFilter(lua_State *L)
 	return 2;
 }
 
+int w_setTextureStreamingBudget(lua_State *L)
+{
+	int64 bytes = -1;
+	if (!lua_isnoneornil(L, 1))
+		bytes = (int64) luaL_checknumber(L, 1);
+	instance()->setTextureStreamingBudget(bytes);
+	return 0;
+}
+
+int w_getTextureStreamingBudget(lua_State *L)
+{
+	int64 bytes = instance()->getTextureStreamingBudget();
+	if (bytes < 0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, (lua_Number) bytes);
+	return 1;
+}
+
 int w_setLineWidth(lua_State *L)
 {
 	float width = (float)luaL_checknumber(L, 1);
@@ -2744,6 +3135,18 @@ int w_isWireframe(lua_State *L)
 	return 1;
 }
 
+int w_setDrawCulling(lua_State *L)
+{
+	instance()->setDrawCulling(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isDrawCullingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isDrawCullingEnabled());
+	return 1;
+}
+
 int w_setShader(lua_State *L)
 {
 	if (lua_isnoneornil(L,1))
@@ -2986,7 +3389,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 20);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -3009,9 +3412,100 @@ int w_getStats(lua_State *L)
 	lua_pushinteger(L, stats.textureMemory);
 	lua_setfield(L, -2, "texturememory");
 
+	lua_pushinteger(L, stats.buffers);
+	lua_setfield(L, -2, "buffers");
+
+	lua_pushinteger(L, stats.bufferMemory);
+	lua_setfield(L, -2, "buffermemory");
+
+	lua_pushinteger(L, stats.streamBufferBytes);
+	lua_setfield(L, -2, "streambufferbytes");
+
+	lua_pushinteger(L, stats.streamBufferStalls);
+	lua_setfield(L, -2, "streambufferstalls");
+
+	lua_pushinteger(L, stats.objectRetains);
+	lua_setfield(L, -2, "objectretains");
+
+	lua_pushinteger(L, stats.objectReleases);
+	lua_setfield(L, -2, "objectreleases");
+
+	lua_pushinteger(L, stats.drawsCulled);
+	lua_setfield(L, -2, "drawsculled");
+
+	lua_pushinteger(L, stats.pipelineCreations);
+	lua_setfield(L, -2, "pipelinecreations");
+
+	lua_pushinteger(L, stats.samplerCreations);
+	lua_setfield(L, -2, "samplercreations");
+
+	lua_pushinteger(L, stats.descriptorWrites);
+	lua_setfield(L, -2, "descriptorwrites");
+
+	lua_pushinteger(L, stats.stateCalls);
+	lua_setfield(L, -2, "statecalls");
+
+	lua_pushinteger(L, stats.stateCallsSkipped);
+	lua_setfield(L, -2, "statecallsskipped");
+
+	lua_pushnumber(L, stats.gpuFrameTime);
+	lua_setfield(L, -2, "gpuframetime");
+
+	lua_pushinteger(L, stats.streamedTextureData);
+	lua_setfield(L, -2, "streamedtexturedata");
+
+	lua_pushinteger(L, stats.gpuMemoryUsage);
+	lua_setfield(L, -2, "gpumemoryusage");
+
+	lua_pushinteger(L, stats.gpuMemoryBudget);
+	lua_setfield(L, -2, "gpumemorybudget");
+
+	lua_pushinteger(L, stats.gpuMemoryReserved);
+	lua_setfield(L, -2, "gpumemoryreserved");
+
+	lua_pushinteger(L, stats.gpuMemoryUnused);
+	lua_setfield(L, -2, "gpumemoryunused");
+
+	lua_pushinteger(L, stats.gpuMemoryFreeRanges);
+	lua_setfield(L, -2, "gpumemoryfreeranges");
+
+	lua_pushinteger(L, stats.gpuMemoryLargestFreeRange);
+	lua_setfield(L, -2, "gpumemorylargestfreerange");
+
+	return 1;
+}
+
+int w_getMemoryHeaps(lua_State *L)
+{
+	std::vector<Graphics::MemoryHeap> heaps = instance()->getMemoryHeaps();
+
+	lua_createtable(L, (int) heaps.size(), 0);
+
+	for (size_t i = 0; i < heaps.size(); i++)
+	{
+		lua_createtable(L, 0, 3);
+
+		lua_pushinteger(L, heaps[i].usage);
+		lua_setfield(L, -2, "usage");
+
+		lua_pushinteger(L, heaps[i].budget);
+		lua_setfield(L, -2, "budget");
+
+		luax_pushboolean(L, heaps[i].deviceLocal);
+		lua_setfield(L, -2, "devicelocal");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
 	return 1;
 }
 
+int w_defragmentMemory(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->defragmentMemory(); });
+	return 0;
+}
+
 int w_draw(lua_State *L)
 {
 	Drawable *drawable = nullptr;
@@ -3094,6 +3588,21 @@ int w_drawInstanced(lua_State *L)
 	return 0;
 }
 
+int w_drawIndirect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Buffer *args = luax_checkbuffer(L, 2);
+	int argsindex = (int) luaL_optinteger(L, 3, 1) - 1;
+	int drawcount = (int) luaL_optinteger(L, 4, 1);
+
+	luax_checkstandardtransform(L, 5, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, args, argsindex, drawcount); });
+	});
+
+	return 0;
+}
+
 int w_drawShaderVertices(lua_State *L)
 {
 	if (luax_istype(L, 1, Buffer::type))
@@ -3130,6 +3639,35 @@ int w_drawShaderVertices(lua_State *L)
 	return 0;
 }
 
+int w_drawShaderVerticesIndirect(lua_State *L)
+{
+	Buffer *args = luax_checkbuffer(L, 2);
+	int argsindex = (int) luaL_optinteger(L, 3, 1) - 1;
+	int drawcount = (int) luaL_optinteger(L, 4, 1);
+
+	Texture *tex = nullptr;
+	if (!lua_isnoneornil(L, 5))
+		tex = luax_checktexture(L, 5);
+
+	if (luax_istype(L, 1, Buffer::type))
+	{
+		// Indexed drawing.
+		Buffer *indexbuffer = luax_checkbuffer(L, 1);
+		luax_catchexcept(L, [&]() { instance()->drawShaderVerticesIndirect(indexbuffer, args, argsindex, drawcount, tex); });
+	}
+	else
+	{
+		const char *primstr = luaL_checkstring(L, 1);
+		PrimitiveType primtype = PRIMITIVE_TRIANGLES;
+		if (!getConstant(primstr, primtype))
+			return luax_enumerror(L, "primitive type", getConstants(primtype), primstr);
+
+		luax_catchexcept(L, [&]() { instance()->drawShaderVerticesIndirect(primtype, args, argsindex, drawcount, tex); });
+	}
+
+	return 0;
+}
+
 int w_print(lua_State *L)
 {
 	std::vector<love::font::ColoredString> str;
@@ -3177,7 +3715,7 @@ int w_printf(lua_State *L)
 	if (luax_istype(L, startidx, math::Transform::type))
 	{
 		math::Transform *tf = luax_totype<math::Transform>(L, startidx);
-		m = tf->getMatrix();
+		m = tf->getWorldMatrix();
 		formatidx = startidx + 1;
 	}
 	else
@@ -3524,6 +4062,32 @@ int w_dispatchThreadgroups(lua_State* L)
 	return 0;
 }
 
+int w_dispatchThreadgroupsAsync(lua_State* L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_optinteger(L, 3, 1);
+	int z = (int) luaL_optinteger(L, 4, 1);
+	uint64 fence = 0;
+	luax_catchexcept(L, [&](){ fence = instance()->dispatchThreadgroupsAsync(shader, x, y, z); });
+	lua_pushnumber(L, (lua_Number) fence);
+	return 1;
+}
+
+int w_isComputeFenceComplete(lua_State *L)
+{
+	uint64 fence = (uint64) luaL_checknumber(L, 1);
+	luax_pushboolean(L, instance()->isComputeFenceComplete(fence));
+	return 1;
+}
+
+int w_waitComputeFence(lua_State *L)
+{
+	uint64 fence = (uint64) luaL_checknumber(L, 1);
+	instance()->waitComputeFence(fence);
+	return 0;
+}
+
 int w_copyBuffer(lua_State *L)
 {
 	Buffer *source = luax_checkbuffer(L, 1);
@@ -3615,6 +4179,147 @@ int w_flushBatch(lua_State *)
 	return 0;
 }
 
+int w_beginDrawList(lua_State *L)
+{
+	DrawList *drawlist = luax_checkdrawlist(L, 1);
+	luax_catchexcept(L, [&](){ instance()->beginDrawListRecording(drawlist); });
+	return 0;
+}
+
+int w_endDrawList(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endDrawListRecording(); });
+	return 0;
+}
+
+int w_setBatchSorting(lua_State *L)
+{
+	Graphics::BatchSortMode mode = Graphics::BATCH_SORT_NONE;
+
+	if (lua_type(L, 1) == LUA_TSTRING)
+	{
+		const char *str = lua_tostring(L, 1);
+		if (!Graphics::getConstant(str, mode))
+			return luax_enumerror(L, "batch sort mode", Graphics::getConstants(mode), str);
+	}
+	else
+		mode = luax_checkboolean(L, 1) ? Graphics::BATCH_SORT_STATE : Graphics::BATCH_SORT_NONE;
+
+	luax_catchexcept(L, [&](){ instance()->setBatchSortMode(mode); });
+	return 0;
+}
+
+int w_isBatchSorting(lua_State *L)
+{
+	const char *str = nullptr;
+	Graphics::BatchSortMode mode = instance()->getBatchSortMode();
+	luax_pushboolean(L, mode != Graphics::BATCH_SORT_NONE);
+	if (!Graphics::getConstant(mode, str))
+		return luaL_error(L, "Unknown batch sort mode.");
+	lua_pushstring(L, str);
+	return 2;
+}
+
+int w_setSortDepth(lua_State *L)
+{
+	instance()->setBatchSortDepth((float) luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getSortDepth(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getBatchSortDepth());
+	return 1;
+}
+
+int w_precompilePipeline(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Shader *shader = Shader::standardShaders[Shader::STANDARD_DEFAULT];
+	if (!lua_isnoneornil(L, 1))
+		shader = luax_checkshader(L, 1);
+
+	VertexAttributes attributes;
+
+	if (lua_isnoneornil(L, 2))
+	{
+		// The format used by textures, text and sprite batches.
+		attributes.setCommonFormat(CommonFormat::XYf_STf_RGBAub, 0);
+	}
+	else
+	{
+		std::vector<Buffer::DataDeclaration> format;
+		luax_checkbufferformat(L, 2, format);
+
+		uint16 offset = 0;
+		for (const auto &decl : format)
+		{
+			int attributeindex = -1;
+
+			BuiltinVertexAttribute builtinattrib;
+			if (getConstant(decl.name.c_str(), builtinattrib))
+				attributeindex = (int) builtinattrib;
+			else if (shader != nullptr)
+				attributeindex = shader->getVertexAttributeIndex(decl.name);
+
+			if (attributeindex >= 0)
+				attributes.set(attributeindex, decl.format, offset, 0);
+
+			offset += (uint16) getDataFormatInfo(decl.format).size;
+		}
+
+		attributes.setBufferLayout(0, offset);
+	}
+
+	PrimitiveType primitive = PRIMITIVE_TRIANGLES;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!getConstant(str, primitive))
+			return luax_enumerror(L, "primitive type", getConstants(primitive), str);
+	}
+
+	luax_catchexcept(L, [&](){ instance()->precompilePipeline(shader, attributes, primitive); });
+	return 0;
+}
+
+int w_getPrecompilingPipelineCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getPrecompilingPipelineCount());
+	return 1;
+}
+
+int w_setPipelineMissLogging(lua_State *L)
+{
+	instance()->setPipelineMissLogging(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isPipelineMissLogging(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isPipelineMissLogging());
+	return 1;
+}
+
+int w_setParallelRenderPassRecording(lua_State *L)
+{
+	instance()->setParallelRenderPassRecording(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isParallelRenderPassRecording(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isParallelRenderPassRecording());
+	return 1;
+}
+
+int w_getDrawList(lua_State *L)
+{
+	luax_pushtype(L, instance()->getRecordingDrawList());
+	return 1;
+}
+
 int w_getStackDepth(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getStackDepth());
@@ -3633,7 +4338,7 @@ int w_push(lua_State *L)
 	if (luax_istype(L, 2, math::Transform::type))
 	{
 		math::Transform *t = luax_totype<math::Transform>(L, 2);
-		luax_catchexcept(L, [&]() { instance()->applyTransform(t->getMatrix()); });
+		luax_catchexcept(L, [&]() { instance()->applyTransform(t->getWorldMatrix()); });
 	}
 
 	return 0;
@@ -3752,14 +4457,204 @@ int w_resetProjection(lua_State */*L*/)
 
 
 // List of functions to wrap.
+// C functions in a struct, necessary for the FFI versions of the hottest
+// graphics functions. They return false instead of raising errors, in which
+// case wrap_Graphics.lua calls the regular function to raise the error.
+struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *texture, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawTransform)(Proxy *drawable, Proxy *transform);
+	bool (*drawQuadTransform)(Proxy *texture, Proxy *quad, Proxy *transform);
+	bool (*rectangle)(const char *mode, float x, float y, float w, float h);
+	void (*setColor)(float r, float g, float b, float a);
+
+	bool (*push)(const char *stacktype);
+	bool (*pop)();
+	void (*translate)(float x, float y);
+	void (*rotate)(float angle);
+	void (*scale)(float sx, float sy);
+};
+
+static FFI_Graphics ffifuncs =
+{
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // draw
+	{
+		Drawable *drawable = luax_ffi_checktype<Drawable>(p);
+		Graphics *graphics = instance();
+		if (drawable == nullptr || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->draw(drawable, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](Proxy *t, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // drawQuad
+	{
+		Texture *texture = luax_ffi_checktype<Texture>(t);
+		Quad *quad = luax_ffi_checktype<Quad>(q);
+		Graphics *graphics = instance();
+		if (texture == nullptr || quad == nullptr || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->draw(texture, quad, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](Proxy *p, Proxy *tf) -> bool // drawTransform
+	{
+		Drawable *drawable = luax_ffi_checktype<Drawable>(p);
+		math::Transform *transform = luax_ffi_checktype<math::Transform>(tf);
+		Graphics *graphics = instance();
+		if (drawable == nullptr || transform == nullptr || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->draw(drawable, transform->getWorldMatrix());
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](Proxy *t, Proxy *q, Proxy *tf) -> bool // drawQuadTransform
+	{
+		Texture *texture = luax_ffi_checktype<Texture>(t);
+		Quad *quad = luax_ffi_checktype<Quad>(q);
+		math::Transform *transform = luax_ffi_checktype<math::Transform>(tf);
+		Graphics *graphics = instance();
+		if (texture == nullptr || quad == nullptr || transform == nullptr || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->draw(texture, quad, transform->getWorldMatrix());
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](const char *str, float x, float y, float w, float h) -> bool // rectangle
+	{
+		Graphics::DrawMode mode;
+		Graphics *graphics = instance();
+		if (str == nullptr || !Graphics::getConstant(str, mode) || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->rectangle(mode, x, y, w, h);
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](float r, float g, float b, float a) // setColor
+	{
+		Graphics *graphics = instance();
+		if (graphics != nullptr)
+			graphics->setColor(Colorf(r, g, b, a));
+	},
+
+	[](const char *str) -> bool // push
+	{
+		Graphics::StackType stype = Graphics::STACK_TRANSFORM;
+		Graphics *graphics = instance();
+		if ((str != nullptr && !Graphics::getConstant(str, stype)) || graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->push(stype);
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[]() -> bool // pop
+	{
+		Graphics *graphics = instance();
+		if (graphics == nullptr)
+			return false;
+
+		try
+		{
+			graphics->pop();
+		}
+		catch (std::exception &)
+		{
+			return false;
+		}
+
+		return true;
+	},
+
+	[](float x, float y) // translate
+	{
+		Graphics *graphics = instance();
+		if (graphics != nullptr)
+			graphics->translate(x, y);
+	},
+
+	[](float angle) // rotate
+	{
+		Graphics *graphics = instance();
+		if (graphics != nullptr)
+			graphics->rotate(angle);
+	},
+
+	[](float sx, float sy) // scale
+	{
+		Graphics *graphics = instance();
+		if (graphics != nullptr)
+			graphics->scale(sx, sy);
+	},
+};
+
 static const luaL_Reg functions[] =
 {
 	{ "reset", w_reset },
 	{ "clear", w_clear },
 	{ "discard", w_discard },
+	{ "beginConditionalRender", w_beginConditionalRender },
+	{ "endConditionalRender", w_endConditionalRender },
 	{ "present", w_present },
 
 	{ "newCanvas", w_newCanvas },
+	{ "getTransientCanvas", w_getTransientCanvas },
+	{ "releaseTransientCanvas", w_releaseTransientCanvas },
 	{ "newTexture", w_newTexture },
 	{ "newCubeTexture", w_newCubeTexture },
 	{ "newArrayTexture", w_newArrayTexture },
@@ -3768,22 +4663,33 @@ static const luaL_Reg functions[] =
 	{ "newFont", w_newFont },
 	{ "newImageFont", w_newImageFont },
 	{ "newSpriteBatch", w_newSpriteBatch },
+	{ "newTileMap", w_newTileMap },
 	{ "newParticleSystem", w_newParticleSystem },
+	{ "newLine", w_newLine },
 	{ "newShader", w_newShader },
 	{ "newComputeShader", w_newComputeShader },
+	{ "newShaderAsync", w_newShaderAsync },
+	{ "newComputeShaderAsync", w_newComputeShaderAsync },
 	{ "newBuffer", w_newBuffer },
 	{ "newVertexBuffer", w_newVertexBuffer },
 	{ "newIndexBuffer", w_newIndexBuffer },
 	{ "newMesh", w_newMesh },
+	{ "newBufferArena", w_newBufferArena },
 	{ "newTextBatch", w_newTextBatch },
+	{ "newDrawList", w_newDrawList },
+	{ "newTimerQuery", w_newTimerQuery },
+	{ "newOcclusionQuery", w_newOcclusionQuery },
 	{ "_newVideo", w_newVideo },
 
 	{ "readbackBuffer", w_readbackBuffer },
 	{ "readbackBufferAsync", w_readbackBufferAsync },
 	{ "readbackTexture", w_readbackTexture },
 	{ "readbackTextureAsync", w_readbackTextureAsync },
+	{ "newReadbackRing", w_newReadbackRing },
+	{ "newVirtualTexture", w_newVirtualTexture },
 
 	{ "validateShader", w_validateShader },
+	{ "compileShaderBundle", w_compileShaderBundle },
 
 	{ "setCanvas", w_setCanvas },
 	{ "getCanvas", w_getCanvas },
@@ -3807,6 +4713,8 @@ static const luaL_Reg functions[] =
 	{ "getDefaultFilter", w_getDefaultFilter },
 	{ "setDefaultMipmapFilter", w_setDefaultMipmapFilter },
 	{ "getDefaultMipmapFilter", w_getDefaultMipmapFilter },
+	{ "setTextureStreamingBudget", w_setTextureStreamingBudget },
+	{ "getTextureStreamingBudget", w_getTextureStreamingBudget },
 	{ "setLineWidth", w_setLineWidth },
 	{ "setLineStyle", w_setLineStyle },
 	{ "setLineJoin", w_setLineJoin },
@@ -3823,6 +4731,8 @@ static const luaL_Reg functions[] =
 	{ "getFrontFaceWinding", w_getFrontFaceWinding },
 	{ "setWireframe", w_setWireframe },
 	{ "isWireframe", w_isWireframe },
+	{ "setDrawCulling", w_setDrawCulling },
+	{ "isDrawCullingEnabled", w_isDrawCullingEnabled },
 
 	{ "setShader", w_setShader },
 	{ "getShader", w_getShader },
@@ -3833,18 +4743,25 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "getMemoryHeaps", w_getMemoryHeaps },
+	{ "defragmentMemory", w_defragmentMemory },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
 	{ "draw", w_draw },
 	{ "drawLayer", w_drawLayer },
 	{ "drawInstanced", w_drawInstanced },
+	{ "drawIndirect", w_drawIndirect },
 	{ "drawShaderVertices", w_drawShaderVertices },
+	{ "drawShaderVerticesIndirect", w_drawShaderVerticesIndirect },
 
 	{ "print", w_print },
 	{ "printf", w_printf },
 
 	{ "dispatchThreadgroups", w_dispatchThreadgroups },
+	{ "dispatchThreadgroupsAsync", w_dispatchThreadgroupsAsync },
+	{ "isComputeFenceComplete", w_isComputeFenceComplete },
+	{ "waitComputeFence", w_waitComputeFence },
 
 	{ "copyBuffer", w_copyBuffer },
 	{ "copyBufferToTexture", w_copyBufferToTexture },
@@ -3878,6 +4795,21 @@ static const luaL_Reg functions[] =
 	{ "polygon", w_polygon },
 
 	{ "flushBatch", w_flushBatch },
+	{ "updateParticleSystems", w_updateParticleSystems },
+
+	{ "beginDrawList", w_beginDrawList },
+	{ "endDrawList", w_endDrawList },
+	{ "getDrawList", w_getDrawList },
+	{ "setBatchSorting", w_setBatchSorting },
+	{ "isBatchSorting", w_isBatchSorting },
+	{ "setSortDepth", w_setSortDepth },
+	{ "getSortDepth", w_getSortDepth },
+	{ "precompilePipeline", w_precompilePipeline },
+	{ "getPrecompilingPipelineCount", w_getPrecompilingPipelineCount },
+	{ "setPipelineMissLogging", w_setPipelineMissLogging },
+	{ "isPipelineMissLogging", w_isPipelineMissLogging },
+	{ "setParallelRenderPassRecording", w_setParallelRenderPassRecording },
+	{ "isParallelRenderPassRecording", w_isParallelRenderPassRecording },
 
 	{ "getStackDepth", w_getStackDepth },
 	{ "push", w_push },
@@ -3921,13 +4853,23 @@ static const lua_CFunction types[] =
 	luaopen_font,
 	luaopen_quad,
 	luaopen_graphicsbuffer,
+	luaopen_bufferarena,
+	luaopen_buffermapping,
 	luaopen_graphicsreadback,
+	luaopen_readbackring,
+	luaopen_virtualtexture,
 	luaopen_spritebatch,
+	luaopen_tilemap,
 	luaopen_particlesystem,
+	luaopen_line,
 	luaopen_shader,
+	luaopen_pendingshader,
 	luaopen_mesh,
 	luaopen_textbatch,
 	luaopen_video,
+	luaopen_drawlist,
+	luaopen_timerquery,
+	luaopen_occlusionquery,
 	0
 };
 
@@ -3950,8 +4892,12 @@ extern "C" int luaopen_love_graphics(lua_State *L)
 
 	int n = luax_register_module(L, w);
 
+	// Execute wrap_Graphics.lua, sending the ffifuncs pointer as an arg.
 	if (luaL_loadbuffer(L, (const char *)graphics_lua, sizeof(graphics_lua), "=[love \"wrap_Graphics.lua\"]") == 0)
-		lua_call(L, 0, 0);
+	{
+		luax_pushpointerasstring(L, &ffifuncs);
+		lua_call(L, 1, 0);
+	}
 	else
 		lua_error(L);
 
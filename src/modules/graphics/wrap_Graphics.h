@@ -26,13 +26,23 @@
 #include "wrap_Texture.h"
 #include "wrap_Quad.h"
 #include "wrap_SpriteBatch.h"
+#include "wrap_TileMap.h"
 #include "wrap_ParticleSystem.h"
 #include "wrap_Shader.h"
 #include "wrap_Mesh.h"
+#include "wrap_Line.h"
 #include "wrap_TextBatch.h"
 #include "wrap_Video.h"
 #include "wrap_Buffer.h"
+#include "wrap_BufferArena.h"
+#include "wrap_BufferMapping.h"
 #include "wrap_GraphicsReadback.h"
+#include "wrap_ReadbackRing.h"
+#include "wrap_VirtualTexture.h"
+#include "wrap_PendingShader.h"
+#include "wrap_DrawList.h"
+#include "wrap_TimerQuery.h"
+#include "wrap_OcclusionQuery.h"
 #include "Graphics.h"
 
 namespace love
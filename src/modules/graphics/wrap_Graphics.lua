@@ -22,6 +22,8 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
+local ffifuncspointer_str = ...
+
 local table_concat = table.concat
 local ipairs = ipairs
 
@@ -85,5 +87,308 @@ function love.graphics._transformGLSLErrorMessages(message)
 	return table_concat(lines, "\n")
 end
 
+
+-- Dynamic resolution scaling. love.run brackets love.draw with the begin and
+-- end functions below, which redirect drawing to the screen into a canvas
+-- with a lower DPI scale when the GPU can't keep up, and upscale it after.
+
+local dynamicres = nil
+
+-- The scale is adjusted in steps of this size, so the canvas is only
+-- recreated when the GPU load changes noticeably.
+local DYNAMICRES_STEP = 0.05
+
+-- Frames between scale adjustments.
+local DYNAMICRES_INTERVAL = 15
+
+function love.graphics.setDynamicResolution(settings)
+	if settings == nil or settings == false then
+		dynamicres = nil
+		return
+	end
+
+	if type(settings) ~= "table" then error("bad argument #1 to setDynamicResolution (expected table)", 2) end
+
+	local minscale = settings.minscale or 0.5
+	local maxscale = settings.maxscale or 1
+	if minscale <= 0 or maxscale < minscale then
+		error("Invalid dynamic resolution scale range: the minimum scale must be greater than 0 and not greater than the maximum scale.", 2)
+	end
+
+	local filter = settings.filter or "linear"
+	if filter ~= "linear" and filter ~= "nearest" then
+		error("Invalid filter mode '" .. tostring(filter) .. "', expected one of: 'linear', 'nearest'", 2)
+	end
+
+	local targetframetime = settings.targetframetime or 1/60
+	if targetframetime <= 0 then
+		error("Invalid target frame time: must be greater than 0.", 2)
+	end
+
+	dynamicres = {
+		targetframetime = targetframetime,
+		minscale = minscale,
+		maxscale = maxscale,
+		filter = filter,
+		scale = maxscale,
+		frametime = targetframetime,
+		frames = 0,
+		stats = {},
+		target = nil,
+		active = false,
+	}
+end
+
+function love.graphics.getDynamicResolution()
+	if not dynamicres then return nil end
+
+	return {
+		targetframetime = dynamicres.targetframetime,
+		minscale = dynamicres.minscale,
+		maxscale = dynamicres.maxscale,
+		filter = dynamicres.filter,
+	}
+end
+
+function love.graphics.getDynamicResolutionScale()
+	return dynamicres and dynamicres.scale or 1
+end
+
+local function updatedynamicresscale(d)
+	-- The GPU frame time comes from timestamp queries, and lags a few frames
+	-- behind. Without them the whole frame time is the best guess.
+	local frametime = love.graphics.getStats(d.stats).gpuframetime
+	if frametime <= 0 and love.timer then
+		frametime = love.timer.getDelta()
+	end
+
+	d.frametime = d.frametime + (frametime - d.frametime) * 0.1
+	d.frames = d.frames + 1
+
+	if d.frames < DYNAMICRES_INTERVAL or d.frametime <= 0 then
+		return
+	end
+	d.frames = 0
+
+	-- Leave some headroom below the target, and don't bother scaling back up
+	-- until there's plenty.
+	local target = d.targetframetime
+	if d.frametime < target * 0.95 and d.frametime > target * 0.75 then
+		return
+	end
+
+	-- GPU time is roughly proportional to the pixel count.
+	local scale = d.scale * math.sqrt(target * 0.85 / d.frametime)
+	scale = math.max(d.scale - 0.1, math.min(d.scale + 0.1, scale))
+	scale = math.floor(scale / DYNAMICRES_STEP + 0.5) * DYNAMICRES_STEP
+	d.scale = math.max(d.minscale, math.min(d.maxscale, scale))
+end
+
+local _setCanvas = love.graphics.setCanvas
+local _getCanvas = love.graphics.getCanvas
+
+function love.graphics._beginDynamicResolution()
+	local d = dynamicres
+	if not d then return end
+
+	updatedynamicresscale(d)
+
+	if d.scale == 1 then
+		d.target = nil
+		return
+	end
+
+	local w, h = love.graphics.getDimensions()
+	local dpiscale = love.graphics.getDPIScale() * d.scale
+
+	if not d.target or d.width ~= w or d.height ~= h or d.dpiscale ~= dpiscale then
+		local canvas = love.graphics.newCanvas(w, h, {dpiscale = dpiscale})
+		canvas:setFilter(d.filter, d.filter)
+
+		local _, _, flags = love.window.getMode()
+		d.target = {canvas, stencil = flags.stencil, depth = flags.depth > 0}
+		d.width, d.height, d.dpiscale = w, h, dpiscale
+	end
+
+	d.active = true
+	_setCanvas(d.target)
+end
+
+function love.graphics._endDynamicResolution()
+	local d = dynamicres
+	if not d or not d.active then return end
+
+	d.active = false
+	_setCanvas()
+
+	love.graphics.push("all")
+	love.graphics.reset()
+	love.graphics.setBlendMode("replace")
+	love.graphics.draw(d.target[1])
+	love.graphics.pop()
+end
+
+-- Code drawing to the screen while dynamic resolution is active is really
+-- drawing to its canvas.
+function love.graphics.setCanvas(...)
+	if dynamicres and dynamicres.active and (...) == nil then
+		return _setCanvas(dynamicres.target)
+	end
+	return _setCanvas(...)
+end
+
+function love.graphics.getCanvas()
+	if dynamicres and dynamicres.active and _getCanvas() == dynamicres.target[1] then
+		return nil
+	end
+	return _getCanvas()
+end
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Graphics
+{
+	bool (*draw)(Proxy *drawable, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *texture, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawTransform)(Proxy *drawable, Proxy *transform);
+	bool (*drawQuadTransform)(Proxy *texture, Proxy *quad, Proxy *transform);
+	bool (*rectangle)(const char *mode, float x, float y, float w, float h);
+	void (*setColor)(float r, float g, float b, float a);
+
+	bool (*push)(const char *stacktype);
+	bool (*pop)();
+	void (*translate)(float x, float y);
+	void (*rotate)(float angle);
+	void (*scale)(float sx, float sy);
+} FFI_Graphics;
+]])
+
+local ffifuncs = ffi.cast("FFI_Graphics **", ffifuncspointer_str)[0]
+
+local type = type
+
+local function isnumberornil(v)
+	return v == nil or type(v) == "number"
+end
+
+local function istransformargs(x, y, a, sx, sy, ox, oy, kx, ky)
+	return isnumberornil(x) and isnumberornil(y) and isnumberornil(a)
+		and isnumberornil(sx) and isnumberornil(sy) and isnumberornil(ox)
+		and isnumberornil(oy) and isnumberornil(kx) and isnumberornil(ky)
+end
+
+
+-- Overwrite some regular love.graphics functions with FFI implementations.
+-- Anything the FFI versions don't handle, including errors, goes through the
+-- regular functions.
+
+local _draw = love.graphics.draw
+local _rectangle = love.graphics.rectangle
+local _setColor = love.graphics.setColor
+local _push = love.graphics.push
+local _pop = love.graphics.pop
+local _translate = love.graphics.translate
+local _rotate = love.graphics.rotate
+local _scale = love.graphics.scale
+
+function love.graphics.draw(drawable, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10)
+	if type(drawable) == "userdata" then
+		if type(a1) == "userdata" then
+			if type(a2) == "userdata" then
+				-- draw(texture, quad, transform)
+				if a3 == nil and ffifuncs.drawQuadTransform(drawable, a1, a2) then
+					return
+				end
+			elseif istransformargs(a2, a3, a4, a5, a6, a7, a8, a9, a10) then
+				-- draw(texture, quad, x, y, r, sx, sy, ox, oy, kx, ky)
+				local sx = a5 or 1
+				if ffifuncs.drawQuad(drawable, a1, a2 or 0, a3 or 0, a4 or 0, sx, a6 or sx, a7 or 0, a8 or 0, a9 or 0, a10 or 0) then
+					return
+				end
+
+				-- draw(drawable, transform)
+				if a2 == nil and ffifuncs.drawTransform(drawable, a1) then
+					return
+				end
+			end
+		elseif a10 == nil and istransformargs(a1, a2, a3, a4, a5, a6, a7, a8, a9) then
+			-- draw(drawable, x, y, r, sx, sy, ox, oy, kx, ky)
+			local sx = a4 or 1
+			if ffifuncs.draw(drawable, a1 or 0, a2 or 0, a3 or 0, sx, a5 or sx, a6 or 0, a7 or 0, a8 or 0, a9 or 0) then
+				return
+			end
+		end
+	end
+	return _draw(drawable, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10)
+end
+
+function love.graphics.rectangle(mode, x, y, w, h, rx, ry, segments)
+	if rx == nil and type(mode) == "string" and type(x) == "number" and type(y) == "number"
+		and type(w) == "number" and type(h) == "number" then
+		if ffifuncs.rectangle(mode, x, y, w, h) then
+			return
+		end
+	end
+	return _rectangle(mode, x, y, w, h, rx, ry, segments)
+end
+
+function love.graphics.setColor(r, g, b, a)
+	if type(r) == "number" and type(g) == "number" and type(b) == "number" and isnumberornil(a) then
+		ffifuncs.setColor(r, g, b, a or 1)
+	else
+		return _setColor(r, g, b, a)
+	end
+end
+
+function love.graphics.push(stacktype, transform)
+	if transform == nil and (stacktype == nil or type(stacktype) == "string") then
+		if ffifuncs.push(stacktype) then
+			return
+		end
+	end
+	return _push(stacktype, transform)
+end
+
+function love.graphics.pop()
+	if not ffifuncs.pop() then
+		return _pop()
+	end
+end
+
+function love.graphics.translate(x, y)
+	if type(x) == "number" and type(y) == "number" then
+		ffifuncs.translate(x, y)
+	else
+		return _translate(x, y)
+	end
+end
+
+function love.graphics.rotate(angle)
+	if type(angle) == "number" then
+		ffifuncs.rotate(angle)
+	else
+		return _rotate(angle)
+	end
+end
+
+function love.graphics.scale(sx, sy)
+	if isnumberornil(sx) and isnumberornil(sy) then
+		sx = sx or 1
+		ffifuncs.scale(sx, sy or sx)
+	else
+		return _scale(sx, sy)
+	end
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_Line.h"
+#include "common/Data.h"
+
+// C++
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+
+Line *luax_checkline(lua_State *L, int idx)
+{
+	return luax_checktype<Line>(L, idx);
+}
+
+void luax_checklinepoints(lua_State *L, int idx, std::vector<Vector2> &points)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		size_t count = data->getSize() / sizeof(Vector2);
+
+		points.resize(count);
+		if (count > 0)
+			memcpy(points.data(), data->getData(), count * sizeof(Vector2));
+	}
+	else
+	{
+		luaL_checktype(L, idx, LUA_TTABLE);
+		int components = (int) luax_objlen(L, idx);
+
+		if (components % 2 != 0)
+			luaL_error(L, "Number of vertex components must be a multiple of two.");
+
+		points.resize(components / 2);
+
+		for (int i = 0; i < components / 2; i++)
+		{
+			lua_rawgeti(L, idx, (i * 2) + 1);
+			lua_rawgeti(L, idx, (i * 2) + 2);
+			points[i].x = luax_checkfloat(L, -2);
+			points[i].y = luax_checkfloat(L, -1);
+			lua_pop(L, 2);
+		}
+	}
+
+	if (points.size() < 2)
+		luaL_error(L, "Need at least two vertices to draw a line.");
+}
+
+int w_Line_setPoints(lua_State *L)
+{
+	Line *t = luax_checkline(L, 1);
+	std::vector<Vector2> points;
+	luax_checklinepoints(L, 2, points);
+	luax_catchexcept(L, [&](){ t->setPoints(points.data(), points.size()); });
+	return 0;
+}
+
+int w_Line_getPoints(lua_State *L)
+{
+	Line *t = luax_checkline(L, 1);
+	const std::vector<Vector2> &points = t->getPoints();
+
+	lua_createtable(L, (int) points.size() * 2, 0);
+
+	for (int i = 0; i < (int) points.size(); i++)
+	{
+		lua_pushnumber(L, points[i].x);
+		lua_rawseti(L, -2, (i * 2) + 1);
+		lua_pushnumber(L, points[i].y);
+		lua_rawseti(L, -2, (i * 2) + 2);
+	}
+
+	return 1;
+}
+
+int w_Line_getPointCount(lua_State *L)
+{
+	Line *t = luax_checkline(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getPoints().size());
+	return 1;
+}
+
+int w_Line_isGPUExpanded(lua_State *L)
+{
+	Line *t = luax_checkline(L, 1);
+	luax_pushboolean(L, t->isGPUExpanded());
+	return 1;
+}
+
+static const luaL_Reg w_Line_functions[] =
+{
+	{ "setPoints", w_Line_setPoints },
+	{ "getPoints", w_Line_getPoints },
+	{ "getPointCount", w_Line_getPointCount },
+	{ "isGPUExpanded", w_Line_isGPUExpanded },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_line(lua_State *L)
+{
+	return luax_register_type(L, &Line::type, w_Line_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -23,6 +23,7 @@
 #include "wrap_Buffer.h"
 #include "Texture.h"
 #include "wrap_Texture.h"
+#include "math/Transform.h"
 
 // C++
 #include <algorithm>
@@ -316,6 +317,10 @@ int w_Mesh_attachAttribute(lua_State *L)
 	const char *attachname = luaL_optstring(L, 5, name);
 	int startindex = (int) luaL_optinteger(L, 6, 1) - 1;
 
+	// Meshes from a BufferArena start partway into their vertex buffer.
+	if (mesh != nullptr)
+		startindex += (int) mesh->getVertexBufferOffset();
+
 	luax_catchexcept(L, [&](){ t->attachAttribute(name, buffer, mesh, attachname, startindex, step); });
 	return 0;
 }
@@ -482,6 +487,13 @@ int w_Mesh_getIndexBuffer(lua_State *L)
 	return 1;
 }
 
+int w_Mesh_optimize(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	luax_catchexcept(L, [&](){ t->optimize(); });
+	return 0;
+}
+
 int w_Mesh_setTexture(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -565,6 +577,75 @@ int w_Mesh_getDrawRange(lua_State *L)
 	return 2;
 }
 
+static void luax_checkbonetransform(lua_State *L, int idx, float *transform)
+{
+	if (luax_istype(L, idx, math::Transform::type))
+	{
+		const float *e = luax_totype<math::Transform>(L, idx)->getWorldMatrix().getElements();
+		transform[0] = e[0];
+		transform[1] = e[1];
+		transform[2] = e[4];
+		transform[3] = e[5];
+		transform[4] = e[12];
+		transform[5] = e[13];
+	}
+	else
+	{
+		for (int i = 0; i < 6; i++)
+			transform[i] = (float) luaL_checknumber(L, idx + i);
+	}
+}
+
+int w_Mesh_setBoneTransforms(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+	{
+		luax_catchexcept(L, [&](){ t->setBoneTransforms(nullptr, 0); });
+		return 0;
+	}
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	int count = (int) luax_objlen(L, 2);
+
+	if (count > Mesh::MAX_BONES)
+		return luaL_error(L, "Too many bone transforms: %d (the maximum is %d)", count, Mesh::MAX_BONES);
+
+	std::vector<float> transforms((size_t) count * 6);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		if (!luax_istype(L, -1, math::Transform::type))
+			return luaL_error(L, "Expected a Transform at index %d of the bone transform table.", i + 1);
+		luax_checkbonetransform(L, -1, &transforms[(size_t) i * 6]);
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ t->setBoneTransforms(transforms.data(), count); });
+	return 0;
+}
+
+int w_Mesh_setBoneTransform(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	float transform[6];
+	luax_checkbonetransform(L, 3, transform);
+
+	luax_catchexcept(L, [&](){ t->setBoneTransform(index, transform); });
+	return 0;
+}
+
+int w_Mesh_getBoneCount(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	lua_pushinteger(L, t->getBoneCount());
+	return 1;
+}
+
 static const luaL_Reg w_Mesh_functions[] =
 {
 	{ "setVertices", w_Mesh_setVertices },
@@ -585,12 +666,16 @@ static const luaL_Reg w_Mesh_functions[] =
 	{ "getVertexMap", w_Mesh_getVertexMap },
 	{ "setIndexBuffer", w_Mesh_setIndexBuffer },
 	{ "getIndexBuffer", w_Mesh_getIndexBuffer },
+	{ "optimize", w_Mesh_optimize },
 	{ "setTexture", w_Mesh_setTexture },
 	{ "getTexture", w_Mesh_getTexture },
 	{ "setDrawMode", w_Mesh_setDrawMode },
 	{ "getDrawMode", w_Mesh_getDrawMode },
 	{ "setDrawRange", w_Mesh_setDrawRange },
 	{ "getDrawRange", w_Mesh_getDrawRange },
+	{ "setBoneTransforms", w_Mesh_setBoneTransforms },
+	{ "setBoneTransform", w_Mesh_setBoneTransform },
+	{ "getBoneCount", w_Mesh_getBoneCount },
 	{ 0, 0 }
 };
 
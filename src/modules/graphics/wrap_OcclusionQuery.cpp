@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+
+OcclusionQuery *luax_checkocclusionquery(lua_State *L, int idx)
+{
+	return luax_checktype<OcclusionQuery>(L, idx);
+}
+
+int w_OcclusionQuery_start(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&]() { q->start(); });
+	return 0;
+}
+
+int w_OcclusionQuery_stop(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&]() { q->stop(); });
+	return 0;
+}
+
+int w_OcclusionQuery_isRunning(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, q->isRunning());
+	return 1;
+}
+
+int w_OcclusionQuery_isComplete(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	q->update();
+	luax_pushboolean(L, q->isComplete());
+	return 1;
+}
+
+int w_OcclusionQuery_isPrecise(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, q->isPrecise());
+	return 1;
+}
+
+int w_OcclusionQuery_getSampleCount(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	q->update();
+
+	if (q->isComplete())
+		lua_pushnumber(L, (lua_Number) q->getSampleCount());
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+int w_OcclusionQuery_isVisible(lua_State *L)
+{
+	OcclusionQuery *q = luax_checkocclusionquery(L, 1);
+	q->update();
+
+	if (q->isComplete())
+		luax_pushboolean(L, q->getSampleCount() > 0);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+static const luaL_Reg w_OcclusionQuery_functions[] =
+{
+	{ "start", w_OcclusionQuery_start },
+	{ "stop", w_OcclusionQuery_stop },
+	{ "isRunning", w_OcclusionQuery_isRunning },
+	{ "isComplete", w_OcclusionQuery_isComplete },
+	{ "isPrecise", w_OcclusionQuery_isPrecise },
+	{ "getSampleCount", w_OcclusionQuery_getSampleCount },
+	{ "isVisible", w_OcclusionQuery_isVisible },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_occlusionquery(lua_State *L)
+{
+	return luax_register_type(L, &OcclusionQuery::type, w_OcclusionQuery_functions, nullptr);
+}
+
+} // graphics
+} // love
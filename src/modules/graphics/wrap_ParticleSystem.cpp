@@ -186,6 +186,15 @@ int w_ParticleSystem_moveTo(lua_State *L)
 	return 0;
 }
 
+int w_ParticleSystem_translateOrigin(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	float x = (float)luaL_checknumber(L, 2);
+	float y = (float)luaL_checknumber(L, 3);
+	t->translateOrigin(x, y);
+	return 0;
+}
+
 int w_ParticleSystem_setEmissionArea(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -597,7 +606,7 @@ int w_ParticleSystem_setQuads(lua_State *L)
 		}
 	}
 
-	t->setQuads(quads);
+	luax_catchexcept(L, [&](){ t->setQuads(quads); });
 	return 0;
 }
 
@@ -688,6 +697,13 @@ int w_ParticleSystem_isPaused(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_isGPU(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	luax_pushboolean(L, t->isGPU());
+	return 1;
+}
+
 int w_ParticleSystem_isStopped(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -721,6 +737,7 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "setPosition", w_ParticleSystem_setPosition },
 	{ "getPosition", w_ParticleSystem_getPosition },
 	{ "moveTo", w_ParticleSystem_moveTo },
+	{ "translateOrigin", w_ParticleSystem_translateOrigin },
 	{ "setEmissionArea", w_ParticleSystem_setEmissionArea },
 	{ "getEmissionArea", w_ParticleSystem_getEmissionArea },
 	{ "setDirection", w_ParticleSystem_setDirection },
@@ -764,6 +781,7 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "isActive", w_ParticleSystem_isActive },
 	{ "isPaused", w_ParticleSystem_isPaused },
 	{ "isStopped", w_ParticleSystem_isStopped },
+	{ "isGPU", w_ParticleSystem_isGPU },
 	{ "update", w_ParticleSystem_update },
 
 	{ 0, 0 }
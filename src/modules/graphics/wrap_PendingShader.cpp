@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_PendingShader.h"
+
+namespace love
+{
+namespace graphics
+{
+
+PendingShader *luax_checkpendingshader(lua_State *L, int idx)
+{
+	return luax_checktype<PendingShader>(L, idx);
+}
+
+int w_PendingShader_isReady(lua_State *L)
+{
+	PendingShader *s = luax_checkpendingshader(L, 1);
+	bool ready = false;
+	luax_catchexcept(L, [&]() { ready = s->isReady(); });
+	luax_pushboolean(L, ready);
+	return 1;
+}
+
+int w_PendingShader_getShader(lua_State *L)
+{
+	PendingShader *s = luax_checkpendingshader(L, 1);
+
+	bool should_error = false;
+	try
+	{
+		luax_pushtype(L, s->getShader());
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	return 1;
+}
+
+static const luaL_Reg w_PendingShader_functions[] =
+{
+	{ "isReady", w_PendingShader_isReady },
+	{ "getShader", w_PendingShader_getShader },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_pendingshader(lua_State *L)
+{
+	return luax_register_type(L, &PendingShader::type, w_PendingShader_functions, nullptr);
+}
+
+} // graphics
+} // love
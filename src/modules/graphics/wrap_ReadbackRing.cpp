@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_ReadbackRing.h"
+#include "wrap_Buffer.h"
+#include "wrap_Texture.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ReadbackRing *luax_checkreadbackring(lua_State *L, int idx)
+{
+	return luax_checktype<ReadbackRing>(L, idx);
+}
+
+static void pushReadbackID(lua_State *L, uint64 id)
+{
+	if (id != 0)
+		lua_pushnumber(L, (lua_Number) id);
+	else
+		lua_pushnil(L);
+}
+
+int w_ReadbackRing_readbackBuffer(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	Buffer *b = luax_checkbuffer(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	lua_Integer size = luaL_optinteger(L, 4, b->getSize() - offset);
+
+	uint64 id = 0;
+	luax_catchexcept(L, [&]() { id = r->readbackBuffer(b, offset, size); });
+
+	pushReadbackID(L, id);
+	return 1;
+}
+
+int w_ReadbackRing_readbackTexture(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	Texture *t = luax_checktexture(L, 2);
+
+	int slice = 0;
+	if (t->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	Rect rect = {0, 0, t->getPixelWidth(mipmap), t->getPixelHeight(mipmap)};
+	if (!lua_isnoneornil(L, 5))
+	{
+		rect.x = (int) luaL_checkinteger(L, 5);
+		rect.y = (int) luaL_checkinteger(L, 6);
+		rect.w = (int) luaL_checkinteger(L, 7);
+		rect.h = (int) luaL_checkinteger(L, 8);
+	}
+
+	uint64 id = 0;
+	luax_catchexcept(L, [&]() { id = r->readbackTexture(t, slice, mipmap, rect); });
+
+	pushReadbackID(L, id);
+	return 1;
+}
+
+int w_ReadbackRing_getLatest(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+
+	uint64 id = 0;
+	GraphicsReadback *readback = nullptr;
+	luax_catchexcept(L, [&]() { readback = r->getLatest(id); });
+
+	if (readback == nullptr)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	if (readback->getImageData() != nullptr)
+		luax_pushtype(L, readback->getImageData());
+	else
+		luax_pushtype(L, readback->getBufferData());
+
+	pushReadbackID(L, id);
+	return 2;
+}
+
+int w_ReadbackRing_getSlotCount(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, r->getSlotCount());
+	return 1;
+}
+
+int w_ReadbackRing_getPendingCount(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, r->getPendingCount());
+	return 1;
+}
+
+static const luaL_Reg w_ReadbackRing_functions[] =
+{
+	{ "readbackBuffer", w_ReadbackRing_readbackBuffer },
+	{ "readbackTexture", w_ReadbackRing_readbackTexture },
+	{ "getLatest", w_ReadbackRing_getLatest },
+	{ "getSlotCount", w_ReadbackRing_getSlotCount },
+	{ "getPendingCount", w_ReadbackRing_getPendingCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_readbackring(lua_State *L)
+{
+	return luax_register_type(L, &ReadbackRing::type, w_ReadbackRing_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -39,6 +39,42 @@ Shader *luax_checkshader(lua_State *L, int idx)
 	return luax_checktype<Shader>(L, idx);
 }
 
+void luax_checkshaderdefines(lua_State *L, int idx, int argidx, std::map<std::string, std::string> &defines)
+{
+	// Convert to absolute index if necessary.
+	if (idx < 0 && idx > LUA_REGISTRYINDEX)
+		idx += lua_gettop(L) + 1;
+
+	lua_pushnil(L);
+	while (lua_next(L, idx))
+	{
+		std::string defname;
+		std::string defval;
+
+		if (lua_type(L, -2) == LUA_TNUMBER && lua_type(L, -1) == LUA_TSTRING)
+			defname = luaL_checkstring(L, -1);
+		else if (lua_type(L, -2) != LUA_TSTRING)
+			luaL_argerror(L, argidx, "all fields in the 'defines' table must use string keys.");
+		else
+		{
+			defname = luaL_checkstring(L, -2);
+			if (lua_type(L, -1) == LUA_TBOOLEAN)
+				defval = luax_toboolean(L, -1) ? "1" : "0";
+			else
+			{
+				const char *val = lua_tostring(L, -1);
+				if (val == nullptr)
+					luaL_argerror(L, argidx, "'defines' table values must be strings, numbers, or booleans.");
+				defval = val;
+			}
+		}
+
+		defines[defname] = defval;
+
+		lua_pop(L, 1);
+	}
+}
+
 int w_Shader_getWarnings(lua_State *L)
 {
 	Shader *shader = luax_checkshader(L, 1);
@@ -321,6 +357,7 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 		return w_Shader_sendTextures(L, startidx, shader, info);
 	case Shader::UNIFORM_TEXELBUFFER:
 	case Shader::UNIFORM_STORAGEBUFFER:
+	case Shader::UNIFORM_UNIFORMBUFFER:
 		return w_Shader_sendBuffers(L, startidx, shader, info);
 	default:
 		return luaL_error(L, "Unknown variable type for shader uniform '%s", name);
@@ -330,7 +367,8 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const Shader::UniformInfo *info, bool colors)
 {
 	if (info->baseType == Shader::UNIFORM_SAMPLER || info->baseType == Shader::UNIFORM_STORAGETEXTURE
-		|| info->baseType == Shader::UNIFORM_TEXELBUFFER || info->baseType == Shader::UNIFORM_STORAGEBUFFER)
+		|| info->baseType == Shader::UNIFORM_TEXELBUFFER || info->baseType == Shader::UNIFORM_STORAGEBUFFER
+		|| info->baseType == Shader::UNIFORM_UNIFORMBUFFER)
 		return luaL_error(L, "Only value types (floats, ints, vectors, matrices, etc) be sent to Shaders via Data objects.");
 
 	math::Transform::MatrixLayout layout = math::Transform::MATRIX_ROW_MAJOR;
@@ -499,6 +537,23 @@ int w_Shader_hasStage(lua_State* L)
 	return 1;
 }
 
+int w_Shader_getVariant(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	std::map<std::string, std::string> defines;
+	luax_checkshaderdefines(L, 2, 2, defines);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	Shader *variant = nullptr;
+	luax_catchexcept(L, [&]() { variant = gfx->getShaderVariant(shader, defines); });
+
+	luax_pushtype(L, variant);
+	return 1;
+}
+
 int w_Shader_getLocalThreadgroupSize(lua_State* L)
 {
 	Shader *shader = luax_checkshader(L, 1);
@@ -524,6 +579,7 @@ static const luaL_Reg w_Shader_functions[] =
 	{ "sendColor",               w_Shader_sendColors },
 	{ "hasUniform",              w_Shader_hasUniform },
 	{ "hasStage",                w_Shader_hasStage },
+	{ "getVariant",              w_Shader_getVariant },
 	{ "getLocalThreadgroupSize", w_Shader_getLocalThreadgroupSize },
 	{ 0, 0 }
 };
@@ -30,6 +30,7 @@ namespace graphics
 {
 
 Shader *luax_checkshader(lua_State *L, int idx);
+void luax_checkshaderdefines(lua_State *L, int idx, int argidx, std::map<std::string, std::string> &defines);
 extern "C" int luaopen_shader(lua_State *L);
 
 } // graphics
@@ -22,6 +22,15 @@
 #include "wrap_SpriteBatch.h"
 #include "Texture.h"
 #include "wrap_Texture.h"
+#include "common/Data.h"
+
+// C++
+#include <vector>
+
+// Put the Lua code directly into a raw string literal.
+static const char spritebatch_lua[] =
+#include "wrap_SpriteBatch.lua"
+;
 
 namespace love
 {
@@ -127,6 +136,145 @@ int w_SpriteBatch_setLayer(lua_State *L)
 	return 0;
 }
 
+static int w_SpriteBatch_addTransforms_or_setTransforms(lua_State *L, SpriteBatch *t, int startidx, int index)
+{
+	// Each sprite is x, y, angle, scale x and scale y.
+	const int components = 5;
+
+	std::vector<float> values;
+	const float *transforms = nullptr;
+	int count = 0;
+
+	if (luax_istype(L, startidx, Data::type))
+	{
+		Data *d = luax_checktype<Data>(L, startidx);
+		transforms = (const float *) d->getData();
+		count = (int) (d->getSize() / (sizeof(float) * components));
+	}
+	else
+	{
+		luaL_checktype(L, startidx, LUA_TTABLE);
+
+		int length = (int) luax_objlen(L, startidx);
+		if (length % components != 0)
+			return luaL_error(L, "The transforms table must have %d values per sprite.", components);
+
+		values.resize(length);
+		for (int i = 0; i < length; i++)
+		{
+			lua_rawgeti(L, startidx, i + 1);
+			values[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		transforms = values.data();
+		count = length / components;
+	}
+
+	Quad *quad = nullptr;
+	if (!lua_isnoneornil(L, startidx + 1))
+		quad = luax_checktype<Quad>(L, startidx + 1);
+
+	luax_catchexcept(L, [&]() { index = t->setTransforms(index, transforms, count, quad); });
+	return index;
+}
+
+int w_SpriteBatch_addTransforms(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+
+	int index = w_SpriteBatch_addTransforms_or_setTransforms(L, t, 2, -1);
+	lua_pushinteger(L, index + 1);
+
+	return 1;
+}
+
+int w_SpriteBatch_setTransforms(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	w_SpriteBatch_addTransforms_or_setTransforms(L, t, 3, index);
+
+	return 0;
+}
+
+template <typename T>
+static const T *luax_getspritearray(lua_State *L, int idx, const char *name, int count)
+{
+	lua_getfield(L, idx, name);
+
+	const T *values = nullptr;
+
+	if (!lua_isnoneornil(L, -1))
+	{
+		Data *d = luax_checktype<Data>(L, -1);
+
+		if (d->getSize() < sizeof(T) * (size_t) count)
+			luaL_error(L, "The '%s' Data is too small for %d sprites.", name, count);
+
+		values = (const T *) d->getData();
+	}
+
+	lua_pop(L, 1);
+	return values;
+}
+
+static int w_SpriteBatch_addArrays_or_setArrays(lua_State *L, SpriteBatch *t, int startidx, int index)
+{
+	int count = (int) luaL_checkinteger(L, startidx);
+	luaL_checktype(L, startidx + 1, LUA_TTABLE);
+
+	// The Data objects stay referenced by the table while the sprites are set.
+	SpriteBatch::SpriteArrays arrays;
+	arrays.x = luax_getspritearray<float>(L, startidx + 1, "x", count);
+	arrays.y = luax_getspritearray<float>(L, startidx + 1, "y", count);
+	arrays.angle = luax_getspritearray<float>(L, startidx + 1, "angle", count);
+	arrays.sx = luax_getspritearray<float>(L, startidx + 1, "sx", count);
+	arrays.sy = luax_getspritearray<float>(L, startidx + 1, "sy", count);
+	arrays.ox = luax_getspritearray<float>(L, startidx + 1, "ox", count);
+	arrays.oy = luax_getspritearray<float>(L, startidx + 1, "oy", count);
+	arrays.quad = luax_getspritearray<uint16>(L, startidx + 1, "quad", count);
+	arrays.color = luax_getspritearray<Color32>(L, startidx + 1, "color", count);
+
+	std::vector<Quad *> quads;
+	if (!lua_isnoneornil(L, startidx + 2))
+	{
+		luaL_checktype(L, startidx + 2, LUA_TTABLE);
+
+		int length = (int) luax_objlen(L, startidx + 2);
+		for (int i = 1; i <= length; i++)
+		{
+			lua_rawgeti(L, startidx + 2, i);
+			quads.push_back(luax_checktype<Quad>(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { index = t->setArrays(index, count, arrays, quads); });
+	return index;
+}
+
+int w_SpriteBatch_addArrays(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+
+	int index = w_SpriteBatch_addArrays_or_setArrays(L, t, 2, -1);
+	lua_pushinteger(L, index + 1);
+
+	return 1;
+}
+
+int w_SpriteBatch_setArrays(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	w_SpriteBatch_addArrays_or_setArrays(L, t, 3, index);
+
+	return 0;
+}
+
 int w_SpriteBatch_clear(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -212,6 +360,13 @@ int w_SpriteBatch_getBufferSize(lua_State *L)
 	return 1;
 }
 
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
 int w_SpriteBatch_attachAttribute(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -229,6 +384,8 @@ int w_SpriteBatch_attachAttribute(lua_State *L)
 		buffer = mesh->getVertexBuffer();
 		if (buffer == nullptr)
 			return luaL_error(L, "Mesh does not have its own vertex buffer.");
+		if (mesh->getVertexBufferOffset() != 0)
+			return luaL_error(L, "Meshes created from a BufferArena cannot be attached to a SpriteBatch.");
 	}
 
 	luax_catchexcept(L, [&](){ t->attachAttribute(name, buffer, mesh); });
@@ -265,12 +422,84 @@ int w_SpriteBatch_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_SpriteBatch_sortSpatially(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	float cellsize = (float) luaL_checknumber(L, 2);
+	luax_catchexcept(L, [&](){ t->sortSpatially(cellsize); });
+	return 0;
+}
+
+int w_SpriteBatch_isSpatiallySorted(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isSpatiallySorted());
+	return 1;
+}
+
+int w_SpriteBatch_translateOrigin(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	t->translateOrigin(x, y);
+	return 0;
+}
+
+// C functions in a struct, necessary for the FFI versions of SpriteBatch
+// methods. They return 0 instead of raising errors.
+struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	int (*addQuad)(Proxy *p, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+};
+
+static FFI_SpriteBatch ffifuncs =
+{
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> int // add
+	{
+		SpriteBatch *t = luax_ffi_checktype<SpriteBatch>(p);
+		if (t == nullptr)
+			return 0;
+
+		try
+		{
+			return t->add(Matrix4(x, y, a, sx, sy, ox, oy, kx, ky)) + 1;
+		}
+		catch (std::exception &)
+		{
+			return 0;
+		}
+	},
+
+	[](Proxy *p, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> int // addQuad
+	{
+		SpriteBatch *t = luax_ffi_checktype<SpriteBatch>(p);
+		Quad *quad = luax_ffi_checktype<Quad>(q);
+		if (t == nullptr || quad == nullptr)
+			return 0;
+
+		try
+		{
+			return t->add(quad, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky)) + 1;
+		}
+		catch (std::exception &)
+		{
+			return 0;
+		}
+	},
+};
+
 static const luaL_Reg w_SpriteBatch_functions[] =
 {
 	{ "add", w_SpriteBatch_add },
 	{ "set", w_SpriteBatch_set },
 	{ "addLayer", w_SpriteBatch_addLayer },
 	{ "setLayer", w_SpriteBatch_setLayer },
+	{ "addTransforms", w_SpriteBatch_addTransforms },
+	{ "setTransforms", w_SpriteBatch_setTransforms },
+	{ "addArrays", w_SpriteBatch_addArrays },
+	{ "setArrays", w_SpriteBatch_setArrays },
 	{ "clear", w_SpriteBatch_clear },
 	{ "flush", w_SpriteBatch_flush },
 	{ "setTexture", w_SpriteBatch_setTexture },
@@ -279,15 +508,23 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "getColor", w_SpriteBatch_getColor },
 	{ "getCount", w_SpriteBatch_getCount },
 	{ "getBufferSize", w_SpriteBatch_getBufferSize },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
+	{ "sortSpatially", w_SpriteBatch_sortSpatially },
+	{ "isSpatiallySorted", w_SpriteBatch_isSpatiallySorted },
+	{ "translateOrigin", w_SpriteBatch_translateOrigin },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_spritebatch(lua_State *L)
 {
-	return luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+	int n = luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+
+	luax_runwrapper(L, spritebatch_lua, sizeof(spritebatch_lua), "SpriteBatch.lua", SpriteBatch::type, &ffifuncs);
+
+	return n;
 }
 
 } // graphics
@@ -35,7 +35,7 @@ static void luax_checkstandardtransform(lua_State *L, int idx, const T &func)
 	if (luax_istype(L, idx, math::Transform::type))
 	{
 		math::Transform *tf = luax_totype<math::Transform>(L, idx);
-		func(tf->getMatrix());
+		func(tf->getWorldMatrix());
 	}
 	else
 	{
@@ -0,0 +1,88 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2023 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local SpriteBatch_mt, ffifuncspointer_str = ...
+local SpriteBatch = SpriteBatch_mt.__index
+
+local type = type
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	int (*addQuad)(Proxy *p, Proxy *quad, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+} FFI_SpriteBatch;
+]])
+
+local ffifuncs = ffi.cast("FFI_SpriteBatch **", ffifuncspointer_str)[0]
+
+local function isnumberornil(v)
+	return v == nil or type(v) == "number"
+end
+
+local function istransformargs(x, y, a, sx, sy, ox, oy, kx, ky)
+	return isnumberornil(x) and isnumberornil(y) and isnumberornil(a)
+		and isnumberornil(sx) and isnumberornil(sy) and isnumberornil(ox)
+		and isnumberornil(oy) and isnumberornil(kx) and isnumberornil(ky)
+end
+
+
+-- Overwrite some regular SpriteBatch methods with FFI implementations. The
+-- FFI functions return 0 when they can't handle the call, in which case the
+-- regular method is used (and raises any error).
+
+local _add = SpriteBatch.add
+
+function SpriteBatch:add(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10)
+	if type(self) == "userdata" then
+		if type(a1) == "userdata" then
+			-- add(quad, x, y, r, sx, sy, ox, oy, kx, ky)
+			if istransformargs(a2, a3, a4, a5, a6, a7, a8, a9, a10) then
+				local sx = a5 or 1
+				local index = ffifuncs.addQuad(self, a1, a2 or 0, a3 or 0, a4 or 0, sx, a6 or sx, a7 or 0, a8 or 0, a9 or 0, a10 or 0)
+				if index > 0 then return index end
+			end
+		elseif a10 == nil and istransformargs(a1, a2, a3, a4, a5, a6, a7, a8, a9) then
+			-- add(x, y, r, sx, sy, ox, oy, kx, ky)
+			local sx = a4 or 1
+			local index = ffifuncs.add(self, a1 or 0, a2 or 0, a3 or 0, sx, a5 or sx, a6 or 0, a7 or 0, a8 or 0, a9 or 0)
+			if index > 0 then return index end
+		end
+	end
+	return _add(self, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -74,7 +74,7 @@ int w_TextBatch_add(lua_State *L)
 	if (luax_istype(L, 3, math::Transform::type))
 	{
 		math::Transform *tf = luax_totype<math::Transform>(L, 3);
-		luax_catchexcept(L, [&](){ index = t->add(text, tf->getMatrix()); });
+		luax_catchexcept(L, [&](){ index = t->add(text, tf->getWorldMatrix()); });
 	}
 	else
 	{
@@ -116,7 +116,7 @@ int w_TextBatch_addf(lua_State *L)
 	if (luax_istype(L, 5, math::Transform::type))
 	{
 		math::Transform *tf = luax_totype<math::Transform>(L, 5);
-		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, tf->getMatrix()); });
+		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, tf->getWorldMatrix()); });
 	}
 	else
 	{
@@ -138,6 +138,32 @@ int w_TextBatch_addf(lua_State *L)
 	return 1;
 }
 
+int w_TextBatch_replace(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	int i = (int) luaL_checkinteger(L, 3) - 1;
+	int j = (int) luaL_checkinteger(L, 4) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 5, text);
+
+	luax_catchexcept(L, [&](){ t->replace(index, i, j - i + 1, text); });
+	return 0;
+}
+
+int w_TextBatch_append(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	luax_catchexcept(L, [&](){ t->append(index, text); });
+	return 0;
+}
+
 int w_TextBatch_clear(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
@@ -192,6 +218,8 @@ static const luaL_Reg w_TextBatch_functions[] =
 	{ "setf", w_TextBatch_setf },
 	{ "add", w_TextBatch_add },
 	{ "addf", w_TextBatch_addf },
+	{ "replace", w_TextBatch_replace },
+	{ "append", w_TextBatch_append },
 	{ "clear", w_TextBatch_clear },
 	{ "setFont", w_TextBatch_setFont },
 	{ "getFont", w_TextBatch_getFont },
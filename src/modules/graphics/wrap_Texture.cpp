@@ -300,6 +300,20 @@ int w_Texture_isReadable(lua_State *L)
 	return 1;
 }
 
+int w_Texture_isMemoryless(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isMemoryless());
+	return 1;
+}
+
+int w_Texture_isReady(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->isReady());
+	return 1;
+}
+
 int w_Texture_setDepthSampleMode(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
@@ -350,7 +364,8 @@ int w_Texture_getMipmapMode(lua_State *L)
 int w_Texture_generateMipmaps(lua_State *L)
 {
 	Texture *t = luax_checktexture(L, 1);
-	luax_catchexcept(L, [&]() { t->generateMipmaps(); });
+	bool compute = luax_optboolean(L, 2, false);
+	luax_catchexcept(L, [&]() { t->generateMipmaps(compute); });
 	return 0;
 }
 
@@ -379,6 +394,19 @@ int w_Texture_replacePixels(lua_State *L)
 			reloadmipmaps = luax_optboolean(L, 7, reloadmipmaps);
 	}
 
+	// An optional sub-rectangle of the ImageData, uploaded without a copy.
+	if (!lua_isnoneornil(L, 8))
+	{
+		Rect sourcerect;
+		sourcerect.x = (int) luaL_checkinteger(L, 8);
+		sourcerect.y = (int) luaL_checkinteger(L, 9);
+		sourcerect.w = (int) luaL_checkinteger(L, 10);
+		sourcerect.h = (int) luaL_checkinteger(L, 11);
+
+		luax_catchexcept(L, [&](){ t->replacePixels(id, sourcerect, slice, mipmap, x, y, reloadmipmaps); });
+		return 0;
+	}
+
 	luax_catchexcept(L, [&](){ t->replacePixels(id, slice, mipmap, x, y, reloadmipmaps); });
 	return 0;
 }
@@ -500,6 +528,8 @@ const luaL_Reg w_Texture_functions[] =
 	{ "isRenderTarget", w_Texture_isRenderTarget },
 	{ "isComputeWritable", w_Texture_isComputeWritable },
 	{ "isReadable", w_Texture_isReadable },
+	{ "isMemoryless", w_Texture_isMemoryless },
+	{ "isReady", w_Texture_isReady },
 	{ "getMipmapMode", w_Texture_getMipmapMode },
 	{ "getDepthSampleMode", w_Texture_getDepthSampleMode },
 	{ "setDepthSampleMode", w_Texture_setDepthSampleMode },
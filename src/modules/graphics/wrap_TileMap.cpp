@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_TileMap.h"
+#include "wrap_Texture.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+TileMap *luax_checktilemap(lua_State *L, int idx)
+{
+	return luax_checktype<TileMap>(L, idx);
+}
+
+static uint16 luax_checktileid(lua_State *L, int idx)
+{
+	lua_Integer tile = luaL_checkinteger(L, idx);
+	if (tile < 0 || tile > LOVE_UINT16_MAX)
+		luaL_error(L, "Invalid tile id: %d", (int) tile);
+	return (uint16) tile;
+}
+
+int w_TileMap_setTile(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	uint16 tile = luax_checktileid(L, 4);
+	luax_catchexcept(L, [&](){ t->setTile(x, y, tile); });
+	return 0;
+}
+
+int w_TileMap_getTile(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	uint16 tile = 0;
+	luax_catchexcept(L, [&](){ tile = t->getTile(x, y); });
+	lua_pushinteger(L, tile);
+	return 1;
+}
+
+int w_TileMap_setTiles(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int w = (int) luaL_checkinteger(L, 4);
+	int h = (int) luaL_checkinteger(L, 5);
+	luaL_checktype(L, 6, LUA_TTABLE);
+
+	if (w < 0 || h < 0)
+		return luaL_error(L, "Invalid tile rectangle dimensions: %d x %d", w, h);
+
+	std::vector<uint16> tiles((size_t) w * (size_t) h);
+
+	for (size_t i = 0; i < tiles.size(); i++)
+	{
+		lua_rawgeti(L, 6, (int) i + 1);
+		if (!lua_isnil(L, -1))
+			tiles[i] = luax_checktileid(L, -1);
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ t->setTiles(x, y, w, h, tiles.data()); });
+	return 0;
+}
+
+int w_TileMap_fill(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	uint16 tile = luax_checktileid(L, 2);
+	t->fill(tile);
+	return 0;
+}
+
+int w_TileMap_setTexture(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	Texture *tex = luax_checktexture(L, 2);
+	luax_catchexcept(L, [&](){ t->setTexture(tex); });
+	return 0;
+}
+
+int w_TileMap_getTexture(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	luax_pushtype(L, t->getTexture());
+	return 1;
+}
+
+int w_TileMap_getDimensions(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	lua_pushinteger(L, t->getWidth());
+	lua_pushinteger(L, t->getHeight());
+	return 2;
+}
+
+int w_TileMap_getTileDimensions(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	lua_pushinteger(L, t->getTileWidth());
+	lua_pushinteger(L, t->getTileHeight());
+	return 2;
+}
+
+int w_TileMap_getChunkSize(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	lua_pushinteger(L, t->getChunkSize());
+	return 1;
+}
+
+int w_TileMap_getTilesetCount(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	lua_pushinteger(L, t->getTilesetCount());
+	return 1;
+}
+
+int w_TileMap_getDrawStats(lua_State *L)
+{
+	TileMap *t = luax_checktilemap(L, 1);
+	int drawn = 0;
+	int rebuilt = 0;
+	t->getLastDrawStats(drawn, rebuilt);
+	lua_pushinteger(L, drawn);
+	lua_pushinteger(L, rebuilt);
+	return 2;
+}
+
+static const luaL_Reg w_TileMap_functions[] =
+{
+	{ "setTile", w_TileMap_setTile },
+	{ "getTile", w_TileMap_getTile },
+	{ "setTiles", w_TileMap_setTiles },
+	{ "fill", w_TileMap_fill },
+	{ "setTexture", w_TileMap_setTexture },
+	{ "getTexture", w_TileMap_getTexture },
+	{ "getDimensions", w_TileMap_getDimensions },
+	{ "getTileDimensions", w_TileMap_getTileDimensions },
+	{ "getChunkSize", w_TileMap_getChunkSize },
+	{ "getTilesetCount", w_TileMap_getTilesetCount },
+	{ "getDrawStats", w_TileMap_getDrawStats },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_tilemap(lua_State *L)
+{
+	return luax_register_type(L, &TileMap::type, w_TileMap_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_TimerQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+
+TimerQuery *luax_checktimerquery(lua_State *L, int idx)
+{
+	return luax_checktype<TimerQuery>(L, idx);
+}
+
+int w_TimerQuery_start(lua_State *L)
+{
+	TimerQuery *t = luax_checktimerquery(L, 1);
+	luax_catchexcept(L, [&]() { t->start(); });
+	return 0;
+}
+
+int w_TimerQuery_stop(lua_State *L)
+{
+	TimerQuery *t = luax_checktimerquery(L, 1);
+	luax_catchexcept(L, [&]() { t->stop(); });
+	return 0;
+}
+
+int w_TimerQuery_isRunning(lua_State *L)
+{
+	TimerQuery *t = luax_checktimerquery(L, 1);
+	luax_pushboolean(L, t->isRunning());
+	return 1;
+}
+
+int w_TimerQuery_isComplete(lua_State *L)
+{
+	TimerQuery *t = luax_checktimerquery(L, 1);
+	t->update();
+	luax_pushboolean(L, t->isComplete());
+	return 1;
+}
+
+int w_TimerQuery_getTime(lua_State *L)
+{
+	TimerQuery *t = luax_checktimerquery(L, 1);
+	t->update();
+
+	if (t->isComplete())
+		lua_pushnumber(L, t->getTime());
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+static const luaL_Reg w_TimerQuery_functions[] =
+{
+	{ "start", w_TimerQuery_start },
+	{ "stop", w_TimerQuery_stop },
+	{ "isRunning", w_TimerQuery_isRunning },
+	{ "isComplete", w_TimerQuery_isComplete },
+	{ "getTime", w_TimerQuery_getTime },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_timerquery(lua_State *L)
+{
+	return luax_register_type(L, &TimerQuery::type, w_TimerQuery_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_VirtualTexture.h"
+#include "wrap_Texture.h"
+#include "image/wrap_ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+VirtualTexture *luax_checkvirtualtexture(lua_State *L, int idx)
+{
+	return luax_checktype<VirtualTexture>(L, idx);
+}
+
+int w_VirtualTexture_requestPage(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+	luax_catchexcept(L, [&]() { t->requestPage(x, y, mipmap); });
+	return 0;
+}
+
+int w_VirtualTexture_processFeedback(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	love::image::ImageData *feedback = love::image::luax_checkimagedata(L, 2);
+
+	int requests = 0;
+	luax_catchexcept(L, [&]() { requests = t->processFeedback(feedback); });
+
+	lua_pushinteger(L, requests);
+	return 1;
+}
+
+int w_VirtualTexture_getPendingPages(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int maxcount = (int) luaL_optinteger(L, 2, LOVE_INT32_MAX);
+
+	std::vector<VirtualTexture::Page> pages;
+	t->getPendingPages(maxcount, pages);
+
+	lua_createtable(L, (int) pages.size(), 0);
+
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		lua_createtable(L, 3, 0);
+
+		lua_pushinteger(L, pages[i].x);
+		lua_rawseti(L, -2, 1);
+		lua_pushinteger(L, pages[i].y);
+		lua_rawseti(L, -2, 2);
+		lua_pushinteger(L, pages[i].mipmap + 1);
+		lua_rawseti(L, -2, 3);
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_VirtualTexture_cancelPage(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+	luax_catchexcept(L, [&]() { t->cancelPage(x, y, mipmap); });
+	return 0;
+}
+
+int w_VirtualTexture_setPage(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int mipmap = (int) luaL_checkinteger(L, 4) - 1;
+	love::image::ImageData *data = love::image::luax_checkimagedata(L, 5);
+	luax_catchexcept(L, [&]() { t->setPage(x, y, mipmap, data); });
+	return 0;
+}
+
+int w_VirtualTexture_isPageResident(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	bool resident = false;
+	luax_catchexcept(L, [&]() { resident = t->isPageResident(x, y, mipmap); });
+
+	luax_pushboolean(L, resident);
+	return 1;
+}
+
+int w_VirtualTexture_update(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	luax_catchexcept(L, [&]() { t->update(); });
+	return 0;
+}
+
+int w_VirtualTexture_getDimensions(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getWidth());
+	lua_pushinteger(L, t->getHeight());
+	return 2;
+}
+
+int w_VirtualTexture_getPageSize(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getPageSize());
+	return 1;
+}
+
+int w_VirtualTexture_getPageCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	int mipmap = (int) luaL_optinteger(L, 2, 1) - 1;
+	if (mipmap < 0 || mipmap >= t->getMipmapCount())
+		return luaL_error(L, "Invalid mipmap index %d.", mipmap + 1);
+	lua_pushinteger(L, t->getPagesX(mipmap));
+	lua_pushinteger(L, t->getPagesY(mipmap));
+	return 2;
+}
+
+int w_VirtualTexture_getMipmapCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getMipmapCount());
+	return 1;
+}
+
+int w_VirtualTexture_getCachePageCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getCachePageCount());
+	return 1;
+}
+
+int w_VirtualTexture_getResidentPageCount(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	lua_pushinteger(L, t->getResidentPageCount());
+	return 1;
+}
+
+int w_VirtualTexture_getCacheTexture(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	luax_pushtype(L, t->getCacheTexture());
+	return 1;
+}
+
+int w_VirtualTexture_getPageTable(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	luax_pushtype(L, t->getPageTable());
+	return 1;
+}
+
+int w_VirtualTexture_getSamplingParameters(lua_State *L)
+{
+	VirtualTexture *t = luax_checkvirtualtexture(L, 1);
+	float params[4];
+	t->getSamplingParameters(params);
+	for (int i = 0; i < 4; i++)
+		lua_pushnumber(L, params[i]);
+	return 4;
+}
+
+int w_VirtualTexture_getShaderCode(lua_State *L)
+{
+	luax_checkvirtualtexture(L, 1);
+	lua_pushstring(L, VirtualTexture::getShaderCode());
+	return 1;
+}
+
+static const luaL_Reg w_VirtualTexture_functions[] =
+{
+	{ "requestPage", w_VirtualTexture_requestPage },
+	{ "processFeedback", w_VirtualTexture_processFeedback },
+	{ "getPendingPages", w_VirtualTexture_getPendingPages },
+	{ "cancelPage", w_VirtualTexture_cancelPage },
+	{ "setPage", w_VirtualTexture_setPage },
+	{ "isPageResident", w_VirtualTexture_isPageResident },
+	{ "update", w_VirtualTexture_update },
+	{ "getDimensions", w_VirtualTexture_getDimensions },
+	{ "getPageSize", w_VirtualTexture_getPageSize },
+	{ "getPageCount", w_VirtualTexture_getPageCount },
+	{ "getMipmapCount", w_VirtualTexture_getMipmapCount },
+	{ "getCachePageCount", w_VirtualTexture_getCachePageCount },
+	{ "getResidentPageCount", w_VirtualTexture_getResidentPageCount },
+	{ "getCacheTexture", w_VirtualTexture_getCacheTexture },
+	{ "getPageTable", w_VirtualTexture_getPageTable },
+	{ "getSamplingParameters", w_VirtualTexture_getSamplingParameters },
+	{ "getShaderCode", w_VirtualTexture_getShaderCode },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_virtualtexture(lua_State *L)
+{
+	return luax_register_type(L, &VirtualTexture::type, w_VirtualTexture_functions, nullptr);
+}
+
+} // graphics
+} // love
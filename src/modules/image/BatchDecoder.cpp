@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "BatchDecoder.h"
+#include "Image.h"
+#include "common/Exception.h"
+#include "thread/JobSystem.h"
+
+namespace love
+{
+namespace image
+{
+
+BatchDecoder::BatchDecoder(Image *image, const std::vector<Data *> &files, love::thread::Channel *channel)
+	: image(image)
+	, channel(channel)
+	, decodedCount(0)
+{
+	for (Data *data : files)
+		this->files.emplace_back(data);
+
+	love::thread::JobSystem *jobsystem = love::thread::JobSystem::getInstance();
+
+	for (size_t i = 0; i < this->files.size(); i++)
+		jobsystem->submit([this, i]() { decodeFile(i); }, &counter);
+}
+
+BatchDecoder::~BatchDecoder()
+{
+	// decodeFile reports decoding errors through the channel, anything else
+	// can't be reported from a destructor.
+	try
+	{
+		wait();
+	}
+	catch (std::exception &)
+	{
+	}
+}
+
+bool BatchDecoder::isFinished() const
+{
+	return decodedCount == files.size();
+}
+
+void BatchDecoder::wait()
+{
+	love::thread::JobSystem::getInstance()->wait(counter);
+}
+
+void BatchDecoder::decodeFile(size_t index)
+{
+	Variant::SharedTable *result = new Variant::SharedTable();
+	result->pairs.emplace_back(Variant(std::string("index")), Variant((double) (index + 1)));
+
+	// Only this job touches this file's entry.
+	StrongRef<Data> data = files[index];
+	files[index].set(nullptr);
+
+	try
+	{
+		if (image->isCompressed(data))
+		{
+			StrongRef<CompressedImageData> decoded(image->newCompressedData(data), Acquire::NORETAIN);
+			result->pairs.emplace_back(Variant(std::string("data")), Variant(&CompressedImageData::type, decoded.get()));
+		}
+		else
+		{
+			StrongRef<ImageData> decoded(image->newImageData(data), Acquire::NORETAIN);
+			result->pairs.emplace_back(Variant(std::string("data")), Variant(&ImageData::type, decoded.get()));
+		}
+	}
+	catch (std::exception &e)
+	{
+		result->pairs.emplace_back(Variant(std::string("error")), Variant(std::string(e.what())));
+	}
+
+	channel->push(Variant(result));
+	decodedCount++;
+}
+
+} // image
+} // love
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/Channel.h"
+#include "thread/JobSystem.h"
+
+// C++
+#include <atomic>
+#include <vector>
+
+namespace love
+{
+namespace image
+{
+
+class Image;
+
+/**
+ * Decodes a list of encoded image files in jobs, one per file. Each result is
+ * pushed to a Channel as a table with an 'index' field (1-based position in
+ * the list) and either a 'data' field holding the ImageData or
+ * CompressedImageData, or an 'error' field with the error message.
+ **/
+class BatchDecoder : public love::Object
+{
+public:
+
+	BatchDecoder(Image *image, const std::vector<Data *> &files, love::thread::Channel *channel);
+	virtual ~BatchDecoder();
+
+	bool isFinished() const;
+
+	/**
+	 * Blocks until all files have been decoded.
+	 **/
+	void wait();
+
+private:
+
+	void decodeFile(size_t index);
+
+	Image *image;
+
+	std::vector<StrongRef<Data>> files;
+	StrongRef<love::thread::Channel> channel;
+
+	love::thread::JobSystem::Counter counter;
+
+	std::atomic<size_t> decodedCount;
+
+}; // BatchDecoder
+
+} // image
+} // love
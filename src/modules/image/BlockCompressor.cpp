@@ -0,0 +1,288 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "BlockCompressor.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <cstdlib>
+
+namespace love
+{
+namespace image
+{
+namespace blockcompressor
+{
+
+static inline uint8 toUnorm8(float v)
+{
+	return (uint8) (std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// Gets a 4x4 block of pixels, repeating the last row or column for blocks
+// which go past the edge of the image.
+static void getBlock(const Colorf *pixels, int width, int height, int bx, int by, uint8 block[16][4])
+{
+	for (int y = 0; y < 4; y++)
+	{
+		int py = std::min(by * 4 + y, height - 1);
+		for (int x = 0; x < 4; x++)
+		{
+			int px = std::min(bx * 4 + x, width - 1);
+			const Colorf &c = pixels[py * width + px];
+			uint8 *out = block[y * 4 + x];
+			out[0] = toUnorm8(c.r);
+			out[1] = toUnorm8(c.g);
+			out[2] = toUnorm8(c.b);
+			out[3] = toUnorm8(c.a);
+		}
+	}
+}
+
+static inline uint16 packRGB565(const int c[3])
+{
+	return (uint16) (((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static inline void unpackRGB565(uint16 v, int c[3])
+{
+	int r = (v >> 11) & 0x1F;
+	int g = (v >> 5) & 0x3F;
+	int b = v & 0x1F;
+	c[0] = (r << 3) | (r >> 2);
+	c[1] = (g << 2) | (g >> 4);
+	c[2] = (b << 3) | (b >> 2);
+}
+
+static void writeLE(uint8 *dst, uint64 value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		dst[i] = (uint8) ((value >> (i * 8)) & 0xFF);
+}
+
+// 8 bytes: two RGB565 endpoints and 2 bit indices, always in 4-color mode.
+static void encodeColorBlock(const uint8 block[16][4], uint8 *dst)
+{
+	int mn[3] = {255, 255, 255};
+	int mx[3] = {0, 0, 0};
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			mn[c] = std::min(mn[c], (int) block[i][c]);
+			mx[c] = std::max(mx[c], (int) block[i][c]);
+		}
+	}
+
+	// Inset the bounding box a little, the endpoints are rarely the best
+	// representation of the outermost colors.
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (mx[c] - mn[c]) >> 4;
+		mn[c] = std::min(mn[c] + inset, 255);
+		mx[c] = std::max(mx[c] - inset, 0);
+	}
+
+	// Pick the bounding box diagonal that best follows the colors, based on
+	// how green and blue vary relative to red.
+	int center[3] = {(mn[0] + mx[0]) / 2, (mn[1] + mx[1]) / 2, (mn[2] + mx[2]) / 2};
+	int covg = 0;
+	int covb = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int dr = block[i][0] - center[0];
+		covg += dr * (block[i][1] - center[1]);
+		covb += dr * (block[i][2] - center[2]);
+	}
+
+	if (covg < 0)
+		std::swap(mn[1], mx[1]);
+	if (covb < 0)
+		std::swap(mn[2], mx[2]);
+
+	uint16 c0 = packRGB565(mx);
+	uint16 c1 = packRGB565(mn);
+
+	if (c0 < c1)
+		std::swap(c0, c1);
+
+	uint32 indices = 0;
+
+	if (c0 != c1)
+	{
+		int palette[4][3];
+		unpackRGB565(c0, palette[0]);
+		unpackRGB565(c1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0;
+			int bestdist = 0x7FFFFFFF;
+			for (int p = 0; p < 4; p++)
+			{
+				int dist = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int d = block[i][c] - palette[p][c];
+					dist += d * d;
+				}
+				if (dist < bestdist)
+				{
+					best = p;
+					bestdist = dist;
+				}
+			}
+			indices |= (uint32) best << (i * 2);
+		}
+	}
+
+	writeLE(dst + 0, c0, 2);
+	writeLE(dst + 2, c1, 2);
+	writeLE(dst + 4, indices, 4);
+}
+
+// 8 bytes: two 8 bit endpoints and 3 bit indices, always in 8-value mode.
+// Used for BC3 alpha and BC4/BC5 channels.
+static void encodeChannelBlock(const uint8 block[16][4], int channel, uint8 *dst)
+{
+	int mn = 255;
+	int mx = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		mn = std::min(mn, (int) block[i][channel]);
+		mx = std::max(mx, (int) block[i][channel]);
+	}
+
+	uint64 indices = 0;
+
+	if (mx != mn)
+	{
+		int palette[8];
+		palette[0] = mx;
+		palette[1] = mn;
+		for (int p = 1; p < 7; p++)
+			palette[p + 1] = ((7 - p) * mx + p * mn) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int v = block[i][channel];
+			int best = 0;
+			int bestdist = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int dist = std::abs(v - palette[p]);
+				if (dist < bestdist)
+				{
+					best = p;
+					bestdist = dist;
+				}
+			}
+			indices |= (uint64) best << (i * 3);
+		}
+	}
+
+	dst[0] = (uint8) mx;
+	dst[1] = (uint8) mn;
+	writeLE(dst + 2, indices, 6);
+}
+
+// 8 bytes: explicit 4 bit alpha values.
+static void encodeExplicitAlphaBlock(const uint8 block[16][4], uint8 *dst)
+{
+	uint64 alpha = 0;
+	for (int i = 0; i < 16; i++)
+		alpha |= (uint64) ((block[i][3] * 15 + 127) / 255) << (i * 4);
+
+	writeLE(dst, alpha, 8);
+}
+
+bool isFormatSupported(PixelFormat format)
+{
+	switch (format)
+	{
+	case PIXELFORMAT_DXT1_UNORM:
+	case PIXELFORMAT_DXT3_UNORM:
+	case PIXELFORMAT_DXT5_UNORM:
+	case PIXELFORMAT_BC4_UNORM:
+	case PIXELFORMAT_BC5_UNORM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void compress(PixelFormat format, const Colorf *pixels, int width, int height, uint8 *dst)
+{
+	if (!isFormatSupported(format))
+		throw love::Exception("Runtime compression to this pixel format is not supported.");
+
+	int blocksx = (width + 3) / 4;
+	int blocksy = (height + 3) / 4;
+
+	uint8 block[16][4];
+
+	for (int by = 0; by < blocksy; by++)
+	{
+		for (int bx = 0; bx < blocksx; bx++)
+		{
+			getBlock(pixels, width, height, bx, by, block);
+
+			switch (format)
+			{
+			case PIXELFORMAT_DXT1_UNORM:
+				encodeColorBlock(block, dst);
+				dst += 8;
+				break;
+			case PIXELFORMAT_DXT3_UNORM:
+				encodeExplicitAlphaBlock(block, dst);
+				encodeColorBlock(block, dst + 8);
+				dst += 16;
+				break;
+			case PIXELFORMAT_DXT5_UNORM:
+				encodeChannelBlock(block, 3, dst);
+				encodeColorBlock(block, dst + 8);
+				dst += 16;
+				break;
+			case PIXELFORMAT_BC4_UNORM:
+				encodeChannelBlock(block, 0, dst);
+				dst += 8;
+				break;
+			case PIXELFORMAT_BC5_UNORM:
+				encodeChannelBlock(block, 0, dst);
+				encodeChannelBlock(block, 1, dst + 8);
+				dst += 16;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+} // blockcompressor
+} // image
+} // love
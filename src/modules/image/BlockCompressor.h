@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "common/pixelformat.h"
+#include "common/Color.h"
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * Fast block encoders for the BC1-BC5 formats, used to compress ImageData at
+ * runtime. They use bounding box endpoint selection, which is much quicker but
+ * lower quality than what offline texture compression tools produce.
+ **/
+namespace blockcompressor
+{
+
+bool isFormatSupported(PixelFormat format);
+
+/**
+ * Compresses a width x height image of pixels with values in [0, 1] into dst,
+ * which must be getPixelFormatSliceSize(format, width, height) bytes.
+ **/
+void compress(PixelFormat format, const Colorf *pixels, int width, int height, uint8 *dst);
+
+} // blockcompressor
+} // image
+} // love
@@ -19,6 +19,11 @@
  **/
 
 #include "CompressedImageData.h"
+#include "BlockCompressor.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
 
 namespace love
 {
@@ -57,6 +62,83 @@ CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &forma
 		throw love::Exception("Could not parse compressed data: No valid data?");
 }
 
+CompressedImageData::CompressedImageData(ImageData *data, PixelFormat format, bool mipmaps)
+	: format(format)
+	, sRGB(isPixelFormatSRGB(data->getFormat()))
+{
+	if (!blockcompressor::isFormatSupported(format))
+	{
+		const char *fstr = "unknown";
+		love::getConstant(format, fstr);
+		throw love::Exception("Compressing ImageData to the %s pixel format is not supported.", fstr);
+	}
+
+	int width = data->getWidth();
+	int height = data->getHeight();
+
+	std::vector<Colorf> pixels((size_t) width * height);
+
+	{
+		love::thread::Lock lock(data->getMutex());
+
+		ImageData::PixelGetFunction getpixel = data->getPixelGetFunction();
+		const uint8 *src = (const uint8 *) data->getData();
+		size_t pixelsize = data->getPixelSize();
+
+		for (size_t i = 0; i < pixels.size(); i++)
+			getpixel((const ImageData::Pixel *) (src + i * pixelsize), pixels[i]);
+	}
+
+	int mipcount = 1;
+	if (mipmaps)
+		mipcount = (int) log2(std::max(width, height)) + 1;
+
+	size_t totalsize = 0;
+	for (int mip = 0; mip < mipcount; mip++)
+		totalsize += getPixelFormatSliceSize(format, std::max(width >> mip, 1), std::max(height >> mip, 1));
+
+	memory.set(new ByteData(totalsize, false), Acquire::NORETAIN);
+
+	size_t offset = 0;
+
+	for (int mip = 0; mip < mipcount; mip++)
+	{
+		if (mip > 0)
+		{
+			// 2x2 box filter from the previous level.
+			int w = std::max(width >> 1, 1);
+			int h = std::max(height >> 1, 1);
+			std::vector<Colorf> next((size_t) w * h);
+
+			for (int y = 0; y < h; y++)
+			{
+				int y0 = std::min(y * 2, height - 1);
+				int y1 = std::min(y * 2 + 1, height - 1);
+				for (int x = 0; x < w; x++)
+				{
+					int x0 = std::min(x * 2, width - 1);
+					int x1 = std::min(x * 2 + 1, width - 1);
+					next[y * w + x] = (pixels[y0 * width + x0] + pixels[y0 * width + x1]
+						+ pixels[y1 * width + x0] + pixels[y1 * width + x1]) * 0.25f;
+				}
+			}
+
+			pixels.swap(next);
+			width = w;
+			height = h;
+		}
+
+		size_t size = getPixelFormatSliceSize(format, width, height);
+		blockcompressor::compress(format, pixels.data(), width, height, (uint8 *) memory->getData() + offset);
+
+		auto slice = new CompressedSlice(format, width, height, memory, offset, size);
+		dataImages.push_back(slice);
+		slice->release();
+
+		offset += size;
+	}
+}
+
 CompressedImageData::CompressedImageData(const CompressedImageData &c)
 	: format(c.format)
 	, sRGB(c.sRGB)
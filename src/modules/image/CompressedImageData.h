@@ -27,6 +27,7 @@
 #include "common/pixelformat.h"
 #include "CompressedSlice.h"
 #include "FormatHandler.h"
+#include "ImageData.h"
 
 // STL
 #include <vector>
@@ -49,6 +50,12 @@ public:
 	static love::Type type;
 
 	CompressedImageData(const std::list<FormatHandler *> &formats, Data *filedata);
+
+	/**
+	 * Compresses the ImageData into the given block compressed format,
+	 * optionally with a full mipmap chain generated with a box filter.
+	 **/
+	CompressedImageData(ImageData *data, PixelFormat format, bool mipmaps);
 	CompressedImageData(const CompressedImageData &c);
 	virtual ~CompressedImageData();
 
@@ -103,7 +110,7 @@ protected:
 	bool sRGB;
 
 	// Single block of memory containing all of the sub-images.
-	StrongRef<ByteData> memory;
+	StrongRef<Data> memory;
 
 	// Texture info for each mipmap level.
 	std::vector<StrongRef<CompressedSlice>> dataImages;
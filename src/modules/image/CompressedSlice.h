@@ -39,7 +39,7 @@ class CompressedSlice : public ImageDataBase
 {
 public:
 
-	CompressedSlice(PixelFormat format, int width, int height, ByteData *memory, size_t offset, size_t size);
+	CompressedSlice(PixelFormat format, int width, int height, Data *memory, size_t offset, size_t size);
 	CompressedSlice(const CompressedSlice &slice);
 	virtual ~CompressedSlice();
 
@@ -51,7 +51,7 @@ public:
 
 private:
 
-	StrongRef<ByteData> memory;
+	StrongRef<Data> memory;
 	size_t offset;
 	size_t dataSize;
 	bool sRGB;
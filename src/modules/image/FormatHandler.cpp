@@ -55,12 +55,22 @@ FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, E
 	throw love::Exception("Image encoding is not implemented for this format backend.");
 }
 
+bool FormatHandler::canEncodeStream(PixelFormat /*rawFormat*/, EncodedFormat /*encodedFormat*/)
+{
+	return false;
+}
+
+void FormatHandler::encodeStream(const DecodedImage& /*img*/, EncodedFormat /*format*/, Stream* /*stream*/)
+{
+	throw love::Exception("Streaming image encoding is not implemented for this format backend.");
+}
+
 bool FormatHandler::canParseCompressed(Data* /*data*/)
 {
 	return false;
 }
 
-StrongRef<ByteData> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/, bool& /*sRGB*/)
+StrongRef<Data> FormatHandler::parseCompressed(Data* /*filedata*/, std::vector<StrongRef<CompressedSlice>>& /*images*/, PixelFormat& /*format*/, bool& /*sRGB*/)
 {
 	throw love::Exception("Compressed image parsing is not implemented for this format backend.");
 }
@@ -23,6 +23,7 @@
 // LOVE
 #include "common/Object.h"
 #include "common/Data.h"
+#include "common/Stream.h"
 #include "common/pixelformat.h"
 #include "CompressedSlice.h"
 
@@ -90,6 +91,18 @@ public:
 	 **/
 	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
 
+	/**
+	 * Whether this format handler can encode raw pixels directly to a Stream.
+	 **/
+	virtual bool canEncodeStream(PixelFormat rawFormat, EncodedFormat encodedFormat);
+
+	/**
+	 * Encodes an image from raw pixel data into a particular format, writing
+	 * the output to the Stream in pieces instead of holding all of it in
+	 * memory at once.
+	 **/
+	virtual void encodeStream(const DecodedImage &img, EncodedFormat format, Stream *stream);
+
 	/**
 	 * Whether this format handler can parse the given Data into a
 	 * CompressedImageData object.
@@ -98,7 +111,10 @@ public:
 
 	/**
 	 * Parses compressed image data into a list of sub-images and returns a
-	 * single block of memory containing all the images.
+	 * single block of memory containing all the images. The returned memory
+	 * may be the passed in data itself, when the sub-images can be used
+	 * in-place without copying. That avoids a second copy of every mipmap
+	 * level, which keeps peak memory down for large textures.
 	 *
 	 * @param[in] filedata The data to parse.
 	 * @param[out] images The list of sub-images generated. Byte data is a
@@ -108,7 +124,7 @@ public:
 	 *
 	 * @return The single block of memory containing the parsed images.
 	 **/
-	virtual StrongRef<ByteData> parseCompressed(Data *filedata,
+	virtual StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format, bool &sRGB);
 
@@ -29,9 +29,13 @@
 #include "magpie/ddsHandler.h"
 #include "magpie/PVRHandler.h"
 #include "magpie/KTXHandler.h"
+#include "magpie/KTX2Handler.h"
 #include "magpie/PKMHandler.h"
 #include "magpie/ASTCHandler.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace image
@@ -52,6 +56,7 @@ Image::Image()
 		new DDSHandler,
 		new PVRHandler,
 		new KTXHandler,
+		new KTX2Handler,
 		new PKMHandler,
 		new ASTCHandler,
 	};
@@ -59,6 +64,9 @@ Image::Image()
 
 Image::~Image()
 {
+	// Decoding threads use the FormatHandlers.
+	batchDecoders.clear();
+
 	// ImageData objects reference the FormatHandlers in our list, so we should
 	// release them instead of deleting them completely here.
 	for (FormatHandler *handler : formatHandlers)
@@ -90,6 +98,25 @@ love::image::CompressedImageData *Image::newCompressedData(Data *data)
 	return new CompressedImageData(formatHandlers, data);
 }
 
+love::image::CompressedImageData *Image::newCompressedData(ImageData *data, PixelFormat format, bool mipmaps)
+{
+	return new CompressedImageData(data, format, mipmaps);
+}
+
+void Image::decodeBatch(const std::vector<Data *> &files, love::thread::Channel *channel)
+{
+	batchDecoders.erase(std::remove_if(batchDecoders.begin(), batchDecoders.end(), [](const StrongRef<BatchDecoder> &b)
+	{
+		return b->isFinished();
+	}), batchDecoders.end());
+
+	if (files.empty())
+		return;
+
+	StrongRef<BatchDecoder> decoder(new BatchDecoder(this, files, channel), Acquire::NORETAIN);
+	batchDecoders.push_back(decoder);
+}
+
 bool Image::isCompressed(Data *data)
 {
 	for (FormatHandler *handler : formatHandlers)
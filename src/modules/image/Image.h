@@ -27,6 +27,7 @@
 #include "filesystem/File.h"
 #include "ImageData.h"
 #include "CompressedImageData.h"
+#include "BatchDecoder.h"
 
 // C++
 #include <list>
@@ -89,12 +90,27 @@ public:
 	 **/
 	CompressedImageData *newCompressedData(Data *data);
 
+	/**
+	 * Compresses ImageData into a block compressed format at runtime.
+	 * @param data The ImageData to compress.
+	 * @param format The compressed pixel format to use.
+	 * @param mipmaps Whether to generate and compress a full mipmap chain.
+	 * @return The new CompressedImageData.
+	 **/
+	CompressedImageData *newCompressedData(ImageData *data, PixelFormat format, bool mipmaps);
+
 	/**
 	 * Determines whether a FileData is Compressed image data or not.
 	 * @param data The FileData to test.
 	 **/
 	bool isCompressed(Data *data);
 
+	/**
+	 * Decodes the given files on worker threads, pushing each result to the
+	 * Channel as it finishes. See BatchDecoder.
+	 **/
+	void decodeBatch(const std::vector<Data *> &files, love::thread::Channel *channel);
+
 	std::vector<StrongRef<ImageData>> newCubeFaces(ImageData *src);
 	std::vector<StrongRef<ImageData>> newVolumeLayers(ImageData *src);
 
@@ -107,6 +123,9 @@ private:
 	// Image format handlers we can use for decoding and encoding ImageData.
 	std::list<FormatHandler *> formatHandlers;
 
+	// Batches which may still be decoding.
+	std::vector<StrongRef<BatchDecoder>> batchDecoders;
+
 }; // Image
 
 } // image
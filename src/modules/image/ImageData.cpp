@@ -19,10 +19,19 @@
  **/
 
 #include "ImageData.h"
+#include "common/Trace.h"
 #include "Image.h"
 #include "filesystem/Filesystem.h"
+#include "math/MathModule.h"
+#include "thread/JobSystem.h"
 
 #include <algorithm> // min/max
+#include <functional>
+#include <vector>
+
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
 
 using love::thread::Lock;
 
@@ -71,6 +80,8 @@ ImageData::ImageData(const ImageData &c)
 
 ImageData::~ImageData()
 {
+	unregisterResident();
+
 	if (decodeHandler.get())
 		decodeHandler->freeRawPixels(data);
 	else
@@ -82,6 +93,24 @@ love::image::ImageData *ImageData::clone() const
 	return new ImageData(*this);
 }
 
+void ImageData::releaseResidentBytes()
+{
+	if (decodeHandler.get())
+		decodeHandler->freeRawPixels(data);
+	else
+		delete[] data;
+
+	data = nullptr;
+
+	// Decompressed bytes are always allocated with new[].
+	decodeHandler = nullptr;
+}
+
+void ImageData::restoreResidentBytes(char *bytes)
+{
+	data = (unsigned char *) bytes;
+}
+
 void ImageData::create(int width, int height, PixelFormat format, void *data)
 {
 	size_t datasize = getPixelFormatSliceSize(format, width, height);
@@ -107,6 +136,8 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 
 void ImageData::decode(Data *data)
 {
+	LOVE_TRACE_ZONE("ImageData::decode");
+
 	FormatHandler *decoder = nullptr;
 	FormatHandler::DecodedImage decodedimage;
 
@@ -172,7 +203,8 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	rawimage.width = width;
 	rawimage.height = height;
 	rawimage.size = getSize();
-	rawimage.data = data;
+	Pin pin(this);
+	rawimage.data = (unsigned char *) getData();
 	rawimage.format = format;
 
 	auto module = Module::getInstance<Image>(Module::M_IMAGE);
@@ -237,6 +269,48 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	return filedata;
 }
 
+void ImageData::encode(FormatHandler::EncodedFormat encodedFormat, Stream *stream) const
+{
+	if (!stream->isWritable())
+		throw love::Exception("The stream must be writable in order to encode an ImageData to it.");
+
+	auto module = Module::getInstance<Image>(Module::M_IMAGE);
+
+	if (module == nullptr)
+		throw love::Exception("love.image must be loaded in order to encode an ImageData.");
+
+	FormatHandler *encoder = nullptr;
+
+	for (FormatHandler *handler : module->getFormatHandlers())
+	{
+		if (handler->canEncodeStream(format, encodedFormat))
+		{
+			encoder = handler;
+			break;
+		}
+	}
+
+	// Fall back to encoding the whole image in memory.
+	if (encoder == nullptr)
+	{
+		StrongRef<love::filesystem::FileData> filedata(encode(encodedFormat, "", false), Acquire::NORETAIN);
+		if (!stream->write(filedata))
+			throw love::Exception("Could not write encoded ImageData to the stream.");
+		return;
+	}
+
+	FormatHandler::DecodedImage rawimage;
+	rawimage.width = width;
+	rawimage.height = height;
+	rawimage.size = getSize();
+	Pin pin(this);
+	rawimage.data = (unsigned char *) getData();
+	rawimage.format = format;
+
+	thread::Lock lock(mutex);
+	encoder->encodeStream(rawimage, encodedFormat, stream);
+}
+
 size_t ImageData::getSize() const
 {
 	return size_t(getWidth() * getHeight()) * getPixelSize();
@@ -244,6 +318,7 @@ size_t ImageData::getSize() const
 
 void *ImageData::getData() const
 {
+	makeResident();
 	return data;
 }
 
@@ -532,6 +607,8 @@ void ImageData::setPixel(int x, int y, const Colorf &c)
 	if (!inside(x, y))
 		throw love::Exception("Attempt to set out-of-range pixel!");
 
+	Pin pin(this);
+
 	size_t pixelsize = getPixelSize();
 	Pixel *p = (Pixel *) (data + ((y * width + x) * pixelsize));
 
@@ -548,6 +625,8 @@ void ImageData::getPixel(int x, int y, Colorf &c) const
 	if (!inside(x, y))
 		throw love::Exception("Attempt to get out-of-range pixel!");
 
+	Pin pin(this);
+
 	size_t pixelsize = getPixelSize();
 	const Pixel *p = (const Pixel *) (data + ((y * width + x) * pixelsize));
 
@@ -588,7 +667,27 @@ static void pasteRGBA8toRGBA16F(Row src, Row dst, int w)
 
 static void pasteRGBA8toRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 divisor = _mm_set1_ps(255.0f);
+
+	// 4 pixels per iteration.
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (src.u8 + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+		_mm_storeu_ps(dst.f32 + i + 0, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), divisor));
+		_mm_storeu_ps(dst.f32 + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), divisor));
+		_mm_storeu_ps(dst.f32 + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), divisor));
+		_mm_storeu_ps(dst.f32 + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), divisor));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.f32[i] = src.u8[i] / 255.0f;
 }
 
@@ -630,7 +729,32 @@ static void pasteRGBA16FtoRGBA32F(Row src, Row dst, int w)
 
 static void pasteRGBA32FtoRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	// 4 pixels per iteration.
+	for (; i + 16 <= w * 4; i += 16)
+	{
+		__m128i c[4];
+		for (int j = 0; j < 4; j++)
+		{
+			__m128 f = _mm_loadu_ps(src.f32 + i + j * 4);
+			f = _mm_min_ps(_mm_max_ps(f, zero), one);
+			c[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+		}
+
+		__m128i lo = _mm_packs_epi32(c[0], c[1]);
+		__m128i hi = _mm_packs_epi32(c[2], c[3]);
+		_mm_storeu_si128((__m128i *) (dst.u8 + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+
+	for (; i < w * 4; i++)
 		dst.u8[i] = (uint8) (clamp01(src.f32[i]) * 255.0f + 0.5f);
 }
 
@@ -646,6 +770,155 @@ static void pasteRGBA32FtoRGBA16F(Row src, Row dst, int w)
 		dst.f16[i] = float32to16(src.f32[i]);
 }
 
+static void pasteR8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i];
+		dst.u8[i * 4 + 1] = 0;
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+static void pasteRG8toRGBA8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 4 + 0] = src.u8[i * 2 + 0];
+		dst.u8[i * 4 + 1] = src.u8[i * 2 + 1];
+		dst.u8[i * 4 + 2] = 0;
+		dst.u8[i * 4 + 3] = 255;
+	}
+}
+
+static void pasteRGBA8toR8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+		dst.u8[i] = src.u8[i * 4];
+}
+
+static void pasteRGBA8toRG8(Row src, Row dst, int w)
+{
+	for (int i = 0; i < w; i++)
+	{
+		dst.u8[i * 2 + 0] = src.u8[i * 4 + 0];
+		dst.u8[i * 2 + 1] = src.u8[i * 4 + 1];
+	}
+}
+
+typedef void (*PasteRowFunction)(Row src, Row dst, int w);
+
+static PasteRowFunction getPasteRowFunction(PixelFormat srcformat, PixelFormat dstformat)
+{
+	if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA8toRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA8toRGBA16F;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA8toRGBA32F;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_R8_UNORM)
+		return pasteRGBA8toR8;
+	else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RG8_UNORM)
+		return pasteRGBA8toRG8;
+
+	else if (srcformat == PIXELFORMAT_R8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteR8toRGBA8;
+	else if (srcformat == PIXELFORMAT_RG8_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRG8toRGBA8;
+
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA16toRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA16toRGBA16F;
+	else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA16toRGBA32F;
+
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA16FtoRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA16FtoRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA32_FLOAT)
+		return pasteRGBA16FtoRGBA32F;
+
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
+		return pasteRGBA32FtoRGBA8;
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
+		return pasteRGBA32FtoRGBA16;
+	else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_FLOAT)
+		return pasteRGBA32FtoRGBA16F;
+
+	return nullptr;
+}
+
+// Per-pixel work covering at least this many pixels is split across threads.
+static const int PARALLEL_MIN_PIXELS = 512 * 512;
+static const int PARALLEL_MIN_JOB_PIXELS = 64 * 1024;
+
+struct PasteRegion
+{
+	const uint8 *src;
+	uint8 *dst;
+
+	size_t srcStride;
+	size_t dstStride;
+
+	size_t srcPixelSize;
+	size_t dstPixelSize;
+
+	int width;
+
+	PasteRowFunction rowFunction;
+	ImageData::PixelGetFunction getFunction;
+	ImageData::PixelSetFunction setFunction;
+};
+
+static void pasteRows(const PasteRegion &r, int rowstart, int rowend)
+{
+	for (int y = rowstart; y < rowend; y++)
+	{
+		Row rowsrc = {(uint8 *) r.src + y * r.srcStride};
+		Row rowdst = {r.dst + y * r.dstStride};
+
+		if (r.rowFunction != nullptr)
+		{
+			r.rowFunction(rowsrc, rowdst, r.width);
+			continue;
+		}
+
+		// Slow path: convert src -> Colorf -> dst.
+		Colorf c;
+		for (int x = 0; x < r.width; x++)
+		{
+			auto srcp = (const ImageData::Pixel *) (rowsrc.u8 + x * r.srcPixelSize);
+			auto dstp = (ImageData::Pixel *) (rowdst.u8 + x * r.dstPixelSize);
+			r.getFunction(srcp, c);
+			r.setFunction(c, dstp);
+		}
+	}
+}
+
+/**
+ * Calls func with disjoint [rowstart, rowend) ranges covering all rows. Regions
+ * with enough pixels are split into jobs, and the calling thread helps run
+ * them.
+ **/
+static void processRows(int width, int height, const std::function<void(int, int)> &func)
+{
+	if ((int64) width * height < PARALLEL_MIN_PIXELS)
+	{
+		func(0, height);
+		return;
+	}
+
+	size_t minrows = (size_t) std::max(PARALLEL_MIN_JOB_PIXELS / std::max(width, 1), 1);
+
+	love::thread::JobSystem::getInstance()->parallelFor((size_t) height, minrows, [&](size_t begin, size_t end)
+	{
+		func((int) begin, (int) end);
+	});
+}
+
 void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh)
 {
 	PixelFormat dstformat = getFormat();
@@ -702,77 +975,227 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	if (sy + sh > srcH)
 		sh = srcH - sy;
 
+	if (sw <= 0 || sh <= 0)
+		return;
+
+	PasteRowFunction rowfunction = nullptr;
+
+	if (srcformat != dstformat)
+	{
+		rowfunction = getPasteRowFunction(srcformat, dstformat);
+
+		if (rowfunction == nullptr && src->pixelGetFunction == nullptr)
+			throw love::Exception("ImageData:paste does not currently support converting from the %s pixel format.", getPixelFormatName(srcformat));
+		else if (rowfunction == nullptr && pixelSetFunction == nullptr)
+			throw love::Exception("ImageData:paste does not currently support converting to the %s pixel format.", getPixelFormatName(dstformat));
+	}
+
+	Pin srcpin(src);
+	Pin dstpin(this);
+
 	Lock lock2(src->mutex);
 	Lock lock1(mutex);
 
-	uint8 *s = (uint8 *) src->getData();
-	uint8 *d = (uint8 *) getData();
+	size_t srcstride = srcW * srcpixelsize;
+	size_t dststride = dstW * dstpixelsize;
 
-	auto getfunction = src->pixelGetFunction;
-	auto setfunction = pixelSetFunction;
+	const uint8 *s = (const uint8 *) src->getData() + sy * srcstride + sx * srcpixelsize;
+	uint8 *d = (uint8 *) getData() + dy * dststride + dx * dstpixelsize;
 
-	// If the dimensions match up, copy the entire memory stream in one go
-	if (srcformat == dstformat && (sw == dstW && dstW == srcW && sh == dstH && dstH == srcH))
+	if (srcformat == dstformat)
 	{
-		memcpy(d, s, srcpixelsize * sw * sh);
+		// If the region spans the full width of both images its rows are
+		// contiguous in memory, so it can be copied in one go.
+		if (sw == srcW && sw == dstW)
+			memcpy(d, s, srcpixelsize * sw * sh);
+		else
+		{
+			for (int y = 0; y < sh; y++)
+				memcpy(d + y * dststride, s + y * srcstride, srcpixelsize * sw);
+		}
+
+		return;
 	}
-	else if (sw > 0)
+
+	PasteRegion region = {
+		s, d,
+		srcstride, dststride,
+		srcpixelsize, dstpixelsize,
+		sw,
+		rowfunction, src->pixelGetFunction, pixelSetFunction,
+	};
+
+	processRows(sw, sh, [&](int rowstart, int rowend) { pasteRows(region, rowstart, rowend); });
+}
+
+// Applies an operation to a row of RGBA float pixels. The loops are kept
+// simple so the compiler can vectorize them.
+static void applyPixelOperation(const ImageData::PixelOperation &op, float *c, int w)
+{
+	const float k[4] = {op.color.r, op.color.g, op.color.b, op.color.a};
+
+	switch (op.type)
+	{
+	case ImageData::PIXELOP_MULTIPLY:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			for (int j = 0; j < 4; j++)
+				c[i + j] *= k[j];
+		}
+		break;
+	case ImageData::PIXELOP_ADD:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			for (int j = 0; j < 4; j++)
+				c[i + j] += k[j];
+		}
+		break;
+	case ImageData::PIXELOP_LERP:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			for (int j = 0; j < 4; j++)
+				c[i + j] += (k[j] - c[i + j]) * op.amount;
+		}
+		break;
+	case ImageData::PIXELOP_LUT:
 	{
-		// Otherwise, copy each row individually.
-		for (int i = 0; i < sh; i++)
+		int last = (int) op.lut.size() - 1;
+		for (int i = 0; i < w * 4; i += 4)
 		{
-			Row rowsrc = {s + (sx + (i + sy) * srcW) * srcpixelsize};
-			Row rowdst = {d + (dx + (i + dy) * dstW) * dstpixelsize};
-
-			if (srcformat == dstformat)
-				memcpy(rowdst.u8, rowsrc.u8, srcpixelsize * sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA8toRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA8toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA8toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA16toRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA16toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_UNORM && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA16toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA16FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA16FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16_FLOAT && dstformat == PIXELFORMAT_RGBA32_FLOAT)
-				pasteRGBA16FtoRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA8_UNORM)
-				pasteRGBA32FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_UNORM)
-				pasteRGBA32FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32_FLOAT && dstformat == PIXELFORMAT_RGBA16_FLOAT)
-				pasteRGBA32FtoRGBA16F(rowsrc, rowdst, sw);
-
-			else if (getfunction != nullptr && setfunction != nullptr)
+			for (int j = 0; j < 3; j++)
+			{
+				float v = clamp01(c[i + j]) * last;
+				int index = std::min((int) v, last - 1);
+				float t = v - index;
+				c[i + j] = op.lut[index] + (op.lut[index + 1] - op.lut[index]) * t;
+			}
+		}
+		break;
+	}
+	case ImageData::PIXELOP_SWIZZLE:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			float p[4] = {c[i + 0], c[i + 1], c[i + 2], c[i + 3]};
+			for (int j = 0; j < 4; j++)
+				c[i + j] = p[op.swizzle[j]];
+		}
+		break;
+	case ImageData::PIXELOP_GAMMA_TO_LINEAR:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			for (int j = 0; j < 3; j++)
+				c[i + j] = math::gammaToLinear(c[i + j]);
+		}
+		break;
+	case ImageData::PIXELOP_LINEAR_TO_GAMMA:
+		for (int i = 0; i < w * 4; i += 4)
+		{
+			for (int j = 0; j < 3; j++)
+				c[i + j] = math::linearToGamma(c[i + j]);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void ImageData::applyPixelOperations(const std::vector<PixelOperation> &ops, int x, int y, int w, int h)
+{
+	if (!(inside(x, y) && inside(x + w - 1, y + h - 1)))
+		throw love::Exception("Invalid rectangle dimensions.");
+
+	if (pixelGetFunction == nullptr || pixelSetFunction == nullptr)
+		throw love::Exception("ImageData:applyPixelOperations does not currently support the %s pixel format.", getPixelFormatName(format));
+
+	for (const PixelOperation &op : ops)
+	{
+		if (op.type == PIXELOP_LUT && op.lut.size() < 2)
+			throw love::Exception("Lookup table pixel operations must have at least 2 entries.");
+
+		if (op.type == PIXELOP_SWIZZLE)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				if (op.swizzle[i] < 0 || op.swizzle[i] > 3)
+					throw love::Exception("Invalid swizzle channel index: %d", op.swizzle[i]);
+			}
+		}
+	}
+
+	Pin pin(this);
+
+	Lock lock(mutex);
+
+	size_t pixelsize = getPixelSize();
+	size_t stride = getWidth() * pixelsize;
+	uint8 *start = data + y * stride + x * pixelsize;
+
+	auto getfunction = pixelGetFunction;
+	auto setfunction = pixelSetFunction;
+
+	processRows(w, h, [&](int rowstart, int rowend)
+	{
+		std::vector<float> row(w * 4);
+
+		for (int r = rowstart; r < rowend; r++)
+		{
+			uint8 *rowdata = start + r * stride;
+
+			for (int i = 0; i < w; i++)
 			{
-				// Slow path: convert src -> Colorf -> dst.
 				Colorf c;
-				for (int x = 0; x < sw; x++)
-				{
-					auto srcp = (const Pixel *) (rowsrc.u8 + x * srcpixelsize);
-					auto dstp = (Pixel *) (rowdst.u8 + x * dstpixelsize);
-					getfunction(srcp, c);
-					setfunction(c, dstp);
-				}
+				getfunction((const Pixel *) (rowdata + i * pixelsize), c);
+				row[i * 4 + 0] = c.r;
+				row[i * 4 + 1] = c.g;
+				row[i * 4 + 2] = c.b;
+				row[i * 4 + 3] = c.a;
+			}
+
+			for (const PixelOperation &op : ops)
+				applyPixelOperation(op, row.data(), w);
+
+			for (int i = 0; i < w; i++)
+			{
+				Colorf c(row[i * 4 + 0], row[i * 4 + 1], row[i * 4 + 2], row[i * 4 + 3]);
+				setfunction(c, (Pixel *) (rowdata + i * pixelsize));
 			}
-			else if (getfunction == nullptr)
-				throw love::Exception("ImageData:paste does not currently support converting from the %s pixel format.", getPixelFormatName(srcformat));
-			else
-				throw love::Exception("ImageData:paste does not currently support converting to the %s pixel format.", getPixelFormatName(dstformat));
 		}
+	});
+}
+
+void ImageData::fillNoise(const love::math::NoiseSettings &settings)
+{
+	if (pixelSetFunction == nullptr)
+		throw love::Exception("ImageData:fillNoise does not currently support the %s pixel format.", getPixelFormatName(format));
+
+	Pin pin(this);
+
+	Lock lock(mutex);
+
+	if (format == PIXELFORMAT_R32_FLOAT)
+	{
+		love::math::generateNoise(settings, width, height, (float *) data);
+		return;
 	}
+
+	size_t pixelsize = getPixelSize();
+	size_t stride = getWidth() * pixelsize;
+	auto setfunction = pixelSetFunction;
+
+	processRows(width, height, [&](int rowstart, int rowend)
+	{
+		for (int r = rowstart; r < rowend; r++)
+		{
+			uint8 *rowdata = data + r * stride;
+			double y = settings.y + r * settings.dy;
+
+			for (int i = 0; i < width; i++)
+			{
+				float v = (float) love::math::fractalNoise(settings, settings.x + i * settings.dx, y, settings.z, settings.w);
+				setfunction(Colorf(v, v, v, 1.0f), (Pixel *) (rowdata + i * pixelsize));
+			}
+		}
+	});
 }
 
 love::thread::Mutex *ImageData::getMutex() const
@@ -855,6 +1278,21 @@ std::vector<std::string> ImageData::getConstants(FormatHandler::EncodedFormat)
 	return encodedFormats.getNames();
 }
 
+bool ImageData::getConstant(const char *in, PixelOperationType &out)
+{
+	return pixelOperations.find(in, out);
+}
+
+bool ImageData::getConstant(PixelOperationType in, const char *&out)
+{
+	return pixelOperations.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(PixelOperationType)
+{
+	return pixelOperations.getNames();
+}
+
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry ImageData::encodedFormatEntries[] =
 {
 	{"tga", FormatHandler::ENCODED_TGA},
@@ -864,5 +1302,18 @@ StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry
 
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> ImageData::encodedFormats(ImageData::encodedFormatEntries, sizeof(ImageData::encodedFormatEntries));
 
+StringMap<ImageData::PixelOperationType, ImageData::PIXELOP_MAX_ENUM>::Entry ImageData::pixelOperationEntries[] =
+{
+	{"multiply", PIXELOP_MULTIPLY},
+	{"add", PIXELOP_ADD},
+	{"lerp", PIXELOP_LERP},
+	{"lut", PIXELOP_LUT},
+	{"swizzle", PIXELOP_SWIZZLE},
+	{"gammatolinear", PIXELOP_GAMMA_TO_LINEAR},
+	{"lineartogamma", PIXELOP_LINEAR_TO_GAMMA},
+};
+
+StringMap<ImageData::PixelOperationType, ImageData::PIXELOP_MAX_ENUM> ImageData::pixelOperations(ImageData::pixelOperationEntries, sizeof(ImageData::pixelOperationEntries));
+
 } // image
 } // love
@@ -29,6 +29,7 @@
 #include "common/Color.h"
 #include "filesystem/FileData.h"
 #include "thread/threads.h"
+#include "data/ResidentData.h"
 #include "ImageDataBase.h"
 #include "FormatHandler.h"
 
@@ -36,13 +37,18 @@ using love::thread::Mutex;
 
 namespace love
 {
+namespace math
+{
+struct NoiseSettings;
+}
+
 namespace image
 {
 
 /**
  * Represents raw pixel data.
  **/
-class ImageData : public ImageDataBase
+class ImageData : public ImageDataBase, public love::data::ResidentData
 {
 public:
 
@@ -59,6 +65,38 @@ public:
 	typedef void (*PixelSetFunction)(const Colorf &c, Pixel *p);
 	typedef void (*PixelGetFunction)(const Pixel *p, Colorf &c);
 
+	enum PixelOperationType
+	{
+		PIXELOP_MULTIPLY,
+		PIXELOP_ADD,
+		PIXELOP_LERP,
+		PIXELOP_LUT,
+		PIXELOP_SWIZZLE,
+		PIXELOP_GAMMA_TO_LINEAR,
+		PIXELOP_LINEAR_TO_GAMMA,
+		PIXELOP_MAX_ENUM
+	};
+
+	/**
+	 * A single per-pixel operation, applied to colors in [0, 1] floating point.
+	 **/
+	struct PixelOperation
+	{
+		PixelOperationType type = PIXELOP_MULTIPLY;
+
+		// Multiply/add operand, or the lerp target.
+		Colorf color = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
+
+		// Lerp factor.
+		float amount = 0.0f;
+
+		// Source channel index for each destination channel.
+		int swizzle[4] = {0, 1, 2, 3};
+
+		// Evenly spaced curve over [0, 1], applied to the RGB channels.
+		std::vector<float> lut;
+	};
+
 	static love::Type type;
 
 	ImageData(Data *data);
@@ -79,6 +117,18 @@ public:
 	 **/
 	void paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh);
 
+	/**
+	 * Applies a sequence of per-pixel operations to the given region, in order.
+	 * Large regions are processed on multiple threads.
+	 **/
+	void applyPixelOperations(const std::vector<PixelOperation> &ops, int x, int y, int w, int h);
+
+	/**
+	 * Fills the ImageData with fractal noise, with pixel (x, y) sampled at grid
+	 * position (x, y). The value goes in all color channels and alpha is 1.
+	 **/
+	void fillNoise(const love::math::NoiseSettings &settings);
+
 	/**
 	 * Checks whether a position is inside this ImageData. Useful for checking bounds.
 	 * @param x The position along the x-axis.
@@ -110,6 +160,13 @@ public:
 	 **/
 	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
 
+	/**
+	 * Encodes raw pixel data into a given format and writes it to a Stream.
+	 * Formats with a streaming encoder are written in pieces, so the complete
+	 * encoded image is never held in memory.
+	 **/
+	void encode(FormatHandler::EncodedFormat format, Stream *stream) const;
+
 	love::thread::Mutex *getMutex() const;
 
 	// Implements ImageDataBase.
@@ -132,6 +189,18 @@ public:
 	static bool getConstant(FormatHandler::EncodedFormat in, const char *&out);
 	static std::vector<std::string> getConstants(FormatHandler::EncodedFormat);
 
+	static bool getConstant(const char *in, PixelOperationType &out);
+	static bool getConstant(PixelOperationType in, const char *&out);
+	static std::vector<std::string> getConstants(PixelOperationType);
+
+protected:
+
+	// Implements ResidentData.
+	void *getResidentBytes() const override { return data; }
+	size_t getResidentSize() const override { return getSize(); }
+	void releaseResidentBytes() override;
+	void restoreResidentBytes(char *bytes) override;
+
 private:
 
 	// Create imagedata. Initialize with data if not null.
@@ -155,6 +224,9 @@ private:
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry encodedFormatEntries[];
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> encodedFormats;
 
+	static StringMap<PixelOperationType, PIXELOP_MAX_ENUM>::Entry pixelOperationEntries[];
+	static StringMap<PixelOperationType, PIXELOP_MAX_ENUM> pixelOperations;
+
 }; // ImageData
 
 } // image
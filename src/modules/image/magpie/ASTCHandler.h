@@ -43,7 +43,7 @@ public:
 	// Implements FormatHandler.
 	bool canParseCompressed(Data *data) override;
 
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format, bool &sRGB) override;
 
@@ -0,0 +1,364 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+// LOVE
+#include "KTX2Handler.h"
+#include "common/int.h"
+#include "common/Exception.h"
+
+// zlib
+#include <zlib.h>
+
+// C
+#include <string.h>
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+namespace
+{
+
+#define KTX2_IDENTIFIER_REF {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A}
+#define KTX2_HEADER_SIZE    (80)
+
+// KTX2 files are always little-endian.
+struct KTX2Header
+{
+	uint8  identifier[12];
+	uint32 vkFormat;
+	uint32 typeSize;
+	uint32 pixelWidth;
+	uint32 pixelHeight;
+	uint32 pixelDepth;
+	uint32 layerCount;
+	uint32 faceCount;
+	uint32 levelCount;
+	uint32 supercompressionScheme;
+
+	uint32 dfdByteOffset;
+	uint32 dfdByteLength;
+	uint32 kvdByteOffset;
+	uint32 kvdByteLength;
+	uint64 sgdByteOffset;
+	uint64 sgdByteLength;
+};
+
+static_assert(sizeof(KTX2Header) == KTX2_HEADER_SIZE, "Real size of KTX2 header doesn't match struct size!");
+
+struct KTX2LevelIndex
+{
+	uint64 byteOffset;
+	uint64 byteLength;
+	uint64 uncompressedByteLength;
+};
+
+enum KTX2SupercompressionScheme
+{
+	KTX2_SUPERCOMPRESSION_NONE    = 0,
+	KTX2_SUPERCOMPRESSION_BASISLZ = 1,
+	KTX2_SUPERCOMPRESSION_ZSTD    = 2,
+	KTX2_SUPERCOMPRESSION_ZLIB    = 3,
+};
+
+enum KTX2VkFormat
+{
+	KTX2_VK_FORMAT_UNDEFINED = 0,
+
+	// BC1-BC7.
+	KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK  = 131,
+	KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK   = 132,
+	KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
+	KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK  = 134,
+	KTX2_VK_FORMAT_BC2_UNORM_BLOCK      = 135,
+	KTX2_VK_FORMAT_BC2_SRGB_BLOCK       = 136,
+	KTX2_VK_FORMAT_BC3_UNORM_BLOCK      = 137,
+	KTX2_VK_FORMAT_BC3_SRGB_BLOCK       = 138,
+	KTX2_VK_FORMAT_BC4_UNORM_BLOCK      = 139,
+	KTX2_VK_FORMAT_BC4_SNORM_BLOCK      = 140,
+	KTX2_VK_FORMAT_BC5_UNORM_BLOCK      = 141,
+	KTX2_VK_FORMAT_BC5_SNORM_BLOCK      = 142,
+	KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK    = 143,
+	KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK    = 144,
+	KTX2_VK_FORMAT_BC7_UNORM_BLOCK      = 145,
+	KTX2_VK_FORMAT_BC7_SRGB_BLOCK       = 146,
+
+	// ETC2 and EAC.
+	KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK   = 147,
+	KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK    = 148,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK  = 150,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+	KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK  = 152,
+	KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK       = 153,
+	KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK       = 154,
+	KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK    = 155,
+	KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK    = 156,
+
+	// ASTC. Each block size has a UNORM variant followed by an SRGB variant.
+	KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK    = 157,
+	KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK   = 184,
+};
+
+PixelFormat convertFormat(uint32 vkformat, bool &sRGB)
+{
+	sRGB = false;
+
+	if (vkformat >= KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkformat <= KTX2_VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		static const PixelFormat astcformats[] =
+		{
+			PIXELFORMAT_ASTC_4x4,
+			PIXELFORMAT_ASTC_5x4,
+			PIXELFORMAT_ASTC_5x5,
+			PIXELFORMAT_ASTC_6x5,
+			PIXELFORMAT_ASTC_6x6,
+			PIXELFORMAT_ASTC_8x5,
+			PIXELFORMAT_ASTC_8x6,
+			PIXELFORMAT_ASTC_8x8,
+			PIXELFORMAT_ASTC_10x5,
+			PIXELFORMAT_ASTC_10x6,
+			PIXELFORMAT_ASTC_10x8,
+			PIXELFORMAT_ASTC_10x10,
+			PIXELFORMAT_ASTC_12x10,
+			PIXELFORMAT_ASTC_12x12,
+		};
+
+		uint32 index = vkformat - KTX2_VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+		sRGB = (index & 1) != 0;
+		return astcformats[index / 2];
+	}
+
+	switch (vkformat)
+	{
+	// DXT.
+	case KTX2_VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case KTX2_VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		return PIXELFORMAT_DXT1_UNORM;
+	case KTX2_VK_FORMAT_BC2_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_BC2_UNORM_BLOCK:
+		return PIXELFORMAT_DXT3_UNORM;
+	case KTX2_VK_FORMAT_BC3_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_BC3_UNORM_BLOCK:
+		return PIXELFORMAT_DXT5_UNORM;
+
+	// BC4 and BC5.
+	case KTX2_VK_FORMAT_BC4_UNORM_BLOCK:
+		return PIXELFORMAT_BC4_UNORM;
+	case KTX2_VK_FORMAT_BC4_SNORM_BLOCK:
+		return PIXELFORMAT_BC4_SNORM;
+	case KTX2_VK_FORMAT_BC5_UNORM_BLOCK:
+		return PIXELFORMAT_BC5_UNORM;
+	case KTX2_VK_FORMAT_BC5_SNORM_BLOCK:
+		return PIXELFORMAT_BC5_SNORM;
+
+	// BC6 and BC7.
+	case KTX2_VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_UFLOAT;
+	case KTX2_VK_FORMAT_BC6H_SFLOAT_BLOCK:
+		return PIXELFORMAT_BC6H_FLOAT;
+	case KTX2_VK_FORMAT_BC7_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_BC7_UNORM_BLOCK:
+		return PIXELFORMAT_BC7_UNORM;
+
+	// ETC2 and EAC.
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGB_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA1_UNORM;
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+		sRGB = true;
+		// fallthrough
+	case KTX2_VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+		return PIXELFORMAT_ETC2_RGBA_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_R_SNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_UNORM;
+	case KTX2_VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+		return PIXELFORMAT_EAC_RG_SNORM;
+
+	default:
+		return PIXELFORMAT_UNKNOWN;
+	}
+}
+
+} // Anonymous namespace.
+
+bool KTX2Handler::canParseCompressed(Data *data)
+{
+	if (data->getSize() < sizeof(KTX2Header))
+		return false;
+
+	KTX2Header *header = (KTX2Header *) data->getData();
+	uint8 ktx2identifier[12] = KTX2_IDENTIFIER_REF;
+
+	if (memcmp(header->identifier, ktx2identifier, 12) != 0)
+		return false;
+
+	return true;
+}
+
+StrongRef<Data> KTX2Handler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+{
+	if (!canParseCompressed(filedata))
+		throw love::Exception("Could not decode compressed data (not a KTX2 file?)");
+
+	KTX2Header header = *(KTX2Header *) filedata->getData();
+
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_BASISLZ || header.vkFormat == KTX2_VK_FORMAT_UNDEFINED)
+		throw love::Exception("Basis Universal KTX2 files are not supported (the texture must be transcoded to a GPU block format before loading).");
+
+	if (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE && header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZLIB)
+		throw love::Exception("Unsupported supercompression scheme in KTX2 file (only zlib is supported).");
+
+	bool isSRGB = false;
+	PixelFormat cformat = convertFormat(header.vkFormat, isSRGB);
+
+	if (cformat == PIXELFORMAT_UNKNOWN)
+		throw love::Exception("Unsupported image format in KTX2 file.");
+
+	if (header.layerCount > 0)
+		throw love::Exception("Texture arrays in KTX2 files are not supported.");
+
+	if (header.pixelDepth > 1)
+		throw love::Exception("3D textures in KTX2 files are not supported.");
+
+	if (header.faceCount > 1)
+		throw love::Exception("Cubemap textures in KTX2 files are not supported.");
+
+	// A level count of 0 means the loader should generate mipmaps, so there's
+	// still exactly one level in the file.
+	uint32 levelcount = std::max(header.levelCount, 1u);
+
+	// More levels than that would shift the dimensions by 32 or more bits.
+	if (levelcount > 32)
+		throw love::Exception("Could not parse KTX2 file: invalid mipmap level count.");
+
+	size_t filesize = filedata->getSize();
+	const uint8 *filebytes = (uint8 *) filedata->getData();
+
+	if (sizeof(KTX2Header) + levelcount * sizeof(KTX2LevelIndex) > filesize)
+		throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+
+	std::vector<KTX2LevelIndex> levels(levelcount);
+	memcpy(levels.data(), filebytes + sizeof(KTX2Header), levelcount * sizeof(KTX2LevelIndex));
+
+	if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelWidth > LOVE_UINT16_MAX || header.pixelHeight > LOVE_UINT16_MAX)
+		throw love::Exception("Could not parse KTX2 file: invalid dimensions.");
+
+	// Everything here comes from the file, so each level is checked against the
+	// file size and the size its dimensions need before it's used.
+	for (uint32 i = 0; i < levelcount; i++)
+	{
+		const KTX2LevelIndex &level = levels[i];
+
+		if (level.byteOffset > filesize || level.byteLength > filesize - level.byteOffset)
+			throw love::Exception("Could not parse KTX2 file: unexpected EOF.");
+
+		int width = (int) std::max(header.pixelWidth >> i, 1u);
+		int height = (int) std::max(header.pixelHeight >> i, 1u);
+		uint64 size = header.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE ? level.byteLength : level.uncompressedByteLength;
+
+		if (size != getPixelFormatSliceSize(cformat, width, height))
+			throw love::Exception("Could not parse KTX2 file: invalid size for mipmap level %d.", i + 1);
+	}
+
+	StrongRef<Data> memory;
+
+	if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE)
+	{
+		// Like KTX1, uncompressed levels reference the file's memory directly.
+		memory.set(filedata);
+
+		for (uint32 i = 0; i < levelcount; i++)
+		{
+			int width = (int) std::max(header.pixelWidth >> i, 1u);
+			int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+			auto slice = new CompressedSlice(cformat, width, height, memory, (size_t) levels[i].byteOffset, (size_t) levels[i].byteLength);
+			images.push_back(slice);
+			slice->release();
+		}
+	}
+	else
+	{
+		size_t totalsize = 0;
+		for (const KTX2LevelIndex &level : levels)
+			totalsize += (size_t) level.uncompressedByteLength;
+
+		memory.set(new ByteData(totalsize, false), Acquire::NORETAIN);
+		uint8 *dst = (uint8 *) memory->getData();
+
+		size_t dataoffset = 0;
+
+		for (uint32 i = 0; i < levelcount; i++)
+		{
+			uLongf destlen = (uLongf) levels[i].uncompressedByteLength;
+			int status = uncompress(dst + dataoffset, &destlen, filebytes + levels[i].byteOffset, (uLong) levels[i].byteLength);
+
+			if (status != Z_OK || destlen != levels[i].uncompressedByteLength)
+				throw love::Exception("Could not decompress zlib-supercompressed KTX2 mipmap level %d.", i + 1);
+
+			int width = (int) std::max(header.pixelWidth >> i, 1u);
+			int height = (int) std::max(header.pixelHeight >> i, 1u);
+
+			auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, (size_t) destlen);
+			images.push_back(slice);
+			slice->release();
+
+			dataoffset += (size_t) destlen;
+		}
+	}
+
+	format = cformat;
+	sRGB = isSRGB;
+
+	return memory;
+}
+
+} // magpie
+} // image
+} // love
@@ -298,7 +298,7 @@ bool KTXHandler::canParseCompressed(Data *data)
 	return true;
 }
 
-StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+StrongRef<Data> KTXHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
 {
 	if (!canParseCompressed(filedata))
 		throw love::Exception("Could not decode compressed data (not a KTX file?)");
@@ -331,9 +331,9 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 	size_t fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
 	const uint8 *filebytes = (uint8 *) filedata->getData();
-	size_t totalsize = 0;
 
-	// Calculate the total size needed to hold the data in memory.
+	StrongRef<Data> memory(filedata);
+
 	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
 	{
 		if (fileoffset + sizeof(uint32) > filedata->getSize())
@@ -346,43 +346,21 @@ StrongRef<ByteData> KTXHandler::parseCompressed(Data *filedata, std::vector<Stro
 
 		fileoffset += sizeof(uint32);
 
+		if (fileoffset + mipsize > filedata->getSize())
+			throw love::Exception("Could not parse KTX file: unexpected EOF.");
+
 		// All mipsize fields are at a file offset that's a multiple of 4, so
 		// there might be some padding after the actual data in this mip level.
 		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
 
-		totalsize += mipsizepadded;
-		fileoffset += mipsizepadded;
-	}
-
-	StrongRef<ByteData> memory(new ByteData(totalsize, false), Acquire::NORETAIN);
-
-	// Reset the file offset to the start of the file's image data.
-	fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
-	size_t dataoffset = 0;
-
-	// Copy each mipmap level of the image from the file to our block of memory.
-	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
-	{
-		uint32 mipsize = *(uint32 *) (filebytes + fileoffset);
-
-		if (header.endianness == KTX_ENDIAN_REF_REV)
-			mipsize = swapuint32(mipsize);
-
-		fileoffset += sizeof(uint32);
-
-		uint32 mipsizepadded = (mipsize + 3) & ~uint32(3);
-
 		int width = (int) std::max(header.pixelWidth >> i, 1u);
 		int height = (int) std::max(header.pixelHeight >> i, 1u);
 
-		memcpy((uint8 *) memory->getData() + dataoffset, filebytes + fileoffset, mipsize);
-
-		auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, mipsize);
+		auto slice = new CompressedSlice(cformat, width, height, memory, fileoffset, mipsize);
 		images.push_back(slice);
 		slice->release();
 
 		fileoffset += mipsizepadded;
-		dataoffset += mipsizepadded;
 	}
 
 	format = cformat;
@@ -32,9 +32,12 @@
 
 // C++
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 // C
 #include <cstdlib>
+#include <cstring>
 
 namespace love
 {
@@ -43,60 +46,141 @@ namespace image
 namespace magpie
 {
 
-// Custom PNG decompression function for LodePNG, using zlib.
+// Custom PNG decompression function for LodePNG, using zlib. The optional
+// custom_context points to the expected decompressed size, so the image data
+// can usually be inflated in a single pass into a buffer of the right size.
 static unsigned zlibDecompress(unsigned char **out, size_t *outsize, const unsigned char *in,
-                               size_t insize, const LodePNGDecompressSettings* /*settings*/)
+                               size_t insize, const LodePNGDecompressSettings *settings)
 {
-	int status = Z_OK;
+	size_t expectedsize = 0;
+	if (settings != nullptr && settings->custom_context != nullptr)
+		expectedsize = *(const size_t *) settings->custom_context;
+
+	// The context is shared with zlib-compressed text and ICC chunks, so don't
+	// trust it beyond deflate's maximum compression ratio.
+	size_t capacity = std::max(insize * 2, (size_t) 64);
+	if (expectedsize > 0)
+		capacity = std::min(expectedsize, insize * 1032 + 64);
 
-	uLongf outdatasize = insize;
-	size_t sizemultiplier = 0;
+	// LodePNG uses malloc, realloc, and free.
+	// Since version 2014-08-23, LodePNG passes in an existing pointer in the
+	// 'out' argument that it expects to be realloc'd. Not doing so can result
+	// in a memory leak.
 	unsigned char *outdata = out != nullptr ? *out : nullptr;
+	unsigned char *newdata = (unsigned char *) realloc(outdata, capacity);
+	if (newdata == nullptr)
+	{
+		free(outdata);
+		if (out != nullptr)
+			*out = nullptr;
+		return 83; // "Memory allocation failed" error code for LodePNG.
+	}
+	outdata = newdata;
+
+	z_stream stream = {};
+	if (inflateInit(&stream) != Z_OK)
+	{
+		free(outdata);
+		if (out != nullptr)
+			*out = nullptr;
+		return 10000; // "Unknown error code" for LodePNG.
+	}
+
+	size_t inpos = 0;
+	size_t outpos = 0;
+	int status = Z_OK;
 
-	while (true)
+	while (status == Z_OK)
 	{
-		// Enough size to hold the decompressed data, hopefully.
-		outdatasize = insize << (++sizemultiplier);
+		if (outpos == capacity)
+		{
+			capacity *= 2;
+			newdata = (unsigned char *) realloc(outdata, capacity);
+			if (newdata == nullptr)
+			{
+				status = Z_MEM_ERROR;
+				break;
+			}
+			outdata = newdata;
+		}
 
-		// LodePNG uses malloc, realloc, and free.
-		// Since version 2014-08-23, LodePNG passes in an existing pointer in
-		// the 'out' argument that it expects to be realloc'd. Not doing so can
-		// result in a memory leak.
-		if (outdata != nullptr)
-			outdata = (unsigned char *) realloc(outdata, outdatasize);
-		else
-			outdata = (unsigned char *) malloc(outdatasize);
+		uInt availin = (uInt) std::min(insize - inpos, (size_t) std::numeric_limits<uInt>::max());
+		uInt availout = (uInt) std::min(capacity - outpos, (size_t) std::numeric_limits<uInt>::max());
 
-		if (!outdata)
-			return 83; // "Memory allocation failed" error code for LodePNG.
+		stream.next_in = (Bytef *) (in + inpos);
+		stream.avail_in = availin;
+		stream.next_out = outdata + outpos;
+		stream.avail_out = availout;
 
-		// Use zlib to decompress the PNG data.
-		status = uncompress(outdata, &outdatasize, in, insize);
+		status = inflate(&stream, Z_NO_FLUSH);
 
-		// If the out buffer was big enough, break out of the loop.
-		if (status != Z_BUF_ERROR)
-			break;
+		inpos += availin - stream.avail_in;
+		outpos += availout - stream.avail_out;
 
-		// Otherwise delete the out buffer and try again with a larger size...
-		free(outdata);
-		outdata = nullptr;
+		// Z_BUF_ERROR only means no progress was possible: more output space
+		// is needed, unless the input ran out before the end of the stream.
+		if (status == Z_BUF_ERROR && outpos == capacity)
+			status = Z_OK;
+		else if (status == Z_OK && inpos == insize && stream.avail_out > 0)
+			status = Z_DATA_ERROR;
 	}
 
-	if (status != Z_OK)
+	inflateEnd(&stream);
+
+	if (status != Z_STREAM_END)
 	{
 		free(outdata);
-		return 10000; // "Unknown error code" for LodePNG.
+		if (out != nullptr)
+			*out = nullptr;
+		return status == Z_MEM_ERROR ? 83 : 10000;
 	}
 
 	if (out != nullptr)
 		*out = outdata;
+	else
+		free(outdata);
 
 	if (outsize != nullptr)
-		*outsize = outdatasize;
+		*outsize = outpos;
 
 	return 0; // Success.
 }
 
+/**
+ * Gets the size of a PNG's decompressed (but still filtered) image data.
+ **/
+static size_t getFilteredDataSize(unsigned width, unsigned height, const LodePNGColorMode &color, unsigned interlace)
+{
+	size_t bpp = lodepng_get_bpp(&color);
+
+	auto passsize = [&](size_t w, size_t h) -> size_t
+	{
+		if (w == 0 || h == 0)
+			return 0;
+		// Each scanline starts with a filter type byte.
+		return h * (1 + (w * bpp + 7) / 8);
+	};
+
+	if (interlace == 0)
+		return passsize(width, height);
+
+	// Adam7 passes.
+	static const unsigned startx[7] = {0, 4, 0, 2, 0, 1, 0};
+	static const unsigned starty[7] = {0, 0, 4, 0, 2, 0, 1};
+	static const unsigned stepx[7] = {8, 8, 4, 4, 2, 2, 1};
+	static const unsigned stepy[7] = {8, 8, 8, 4, 4, 2, 2};
+
+	size_t size = 0;
+	for (int i = 0; i < 7; i++)
+	{
+		size_t w = (width + stepx[i] - startx[i] - 1) / stepx[i];
+		size_t h = (height + stepy[i] - starty[i] - 1) / stepy[i];
+		size += passsize(w, h);
+	}
+
+	return size;
+}
+
 // Custom PNG compression function for LodePNG, using zlib.
 static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigned char *in,
                              size_t insize, const LodePNGCompressSettings* /*settings*/)
@@ -128,6 +212,96 @@ static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigne
 	return 0; // Success.
 }
 
+static void writeUint32BE(uint8 *dst, uint32 v)
+{
+	dst[0] = (uint8) (v >> 24);
+	dst[1] = (uint8) (v >> 16);
+	dst[2] = (uint8) (v >> 8);
+	dst[3] = (uint8) (v >> 0);
+}
+
+static void writePNGChunk(Stream *stream, const char *type, const uint8 *data, size_t size)
+{
+	uint8 header[8];
+	writeUint32BE(header, (uint32) size);
+	memcpy(header + 4, type, 4);
+
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, header + 4, 4);
+	if (size > 0)
+		crc = crc32(crc, data, (uInt) size);
+
+	uint8 footer[4];
+	writeUint32BE(footer, (uint32) crc);
+
+	if (!stream->write(header, sizeof(header))
+		|| (size > 0 && !stream->write(data, size))
+		|| !stream->write(footer, sizeof(footer)))
+	{
+		throw love::Exception("Could not write PNG image data.");
+	}
+}
+
+static uint8 paethPredictor(int a, int b, int c)
+{
+	int pa = abs(b - c);
+	int pb = abs(a - c);
+	int pc = abs(a + b - 2 * c);
+
+	if (pa <= pb && pa <= pc)
+		return (uint8) a;
+	else if (pb <= pc)
+		return (uint8) b;
+	else
+		return (uint8) c;
+}
+
+// Applies each PNG filter type to a scanline and returns the filtered line
+// (including its filter type byte) with the smallest sum of absolute values,
+// which is the heuristic LodePNG uses by default.
+static const uint8 *filterPNGScanline(const uint8 *row, const uint8 *prev, size_t rowsize, size_t bpp, uint8 *candidates)
+{
+	const uint8 *best = nullptr;
+	uint64 bestsum = std::numeric_limits<uint64>::max();
+
+	for (int type = 0; type < 5; type++)
+	{
+		uint8 *out = candidates + type * (rowsize + 1);
+		out[0] = (uint8) type;
+
+		uint64 sum = 0;
+
+		for (size_t i = 0; i < rowsize; i++)
+		{
+			int a = i >= bpp ? row[i - bpp] : 0;
+			int b = prev[i];
+			int c = i >= bpp ? prev[i - bpp] : 0;
+
+			uint8 predicted = 0;
+			switch (type)
+			{
+			case 1: predicted = (uint8) a; break;
+			case 2: predicted = (uint8) b; break;
+			case 3: predicted = (uint8) ((a + b) / 2); break;
+			case 4: predicted = paethPredictor(a, b, c); break;
+			default: break;
+			}
+
+			uint8 v = (uint8) (row[i] - predicted);
+			out[i + 1] = v;
+			sum += (uint64) abs((int) (int8) v);
+		}
+
+		if (sum < bestsum)
+		{
+			bestsum = sum;
+			best = out;
+		}
+	}
+
+	return best;
+}
+
 bool PNGHandler::canDecode(Data *data)
 {
 	unsigned int width = 0, height = 0;
@@ -163,7 +337,15 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 		throw love::Exception("Could not decode PNG image (%s)", err);
 	}
 
+	size_t expectedsize = getFilteredDataSize(width, height, state.info_png.color, state.info_png.interlace_method);
+
 	state.decoder.zlibsettings.custom_zlib = zlibDecompress;
+	state.decoder.zlibsettings.custom_context = &expectedsize;
+
+	// zlib already verifies the Adler-32 checksum of the image data, the
+	// per-chunk CRCs are redundant for decoding.
+	state.decoder.ignore_crc = 1;
+
 	state.info_raw.colortype = LCT_RGBA;
 
 	if (state.info_png.color.bitdepth == 16)
@@ -257,6 +439,119 @@ FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedF
 	return encimg;
 }
 
+bool PNGHandler::canEncodeStream(PixelFormat rawFormat, EncodedFormat encodedFormat)
+{
+	return canEncode(rawFormat, encodedFormat);
+}
+
+void PNGHandler::encodeStream(const DecodedImage &img, EncodedFormat encodedFormat, Stream *stream)
+{
+	if (!canEncodeStream(img.format, encodedFormat))
+		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
+
+	// This writes the PNG directly with zlib, one scanline at a time, so only
+	// a few rows and a fixed-size compression buffer are held in memory.
+
+	int bitdepth = img.format == PIXELFORMAT_RGBA16_UNORM ? 16 : 8;
+	size_t bpp = bitdepth / 8 * 4;
+	size_t rowsize = (size_t) img.width * bpp;
+
+	static const uint8 signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+	if (!stream->write(signature, sizeof(signature)))
+		throw love::Exception("Could not write PNG image data.");
+
+	uint8 ihdr[13];
+	writeUint32BE(ihdr + 0, (uint32) img.width);
+	writeUint32BE(ihdr + 4, (uint32) img.height);
+	ihdr[8] = (uint8) bitdepth;
+	ihdr[9] = 6; // RGBA
+	ihdr[10] = 0; // Compression method.
+	ihdr[11] = 0; // Filter method.
+	ihdr[12] = 0; // No interlacing.
+	writePNGChunk(stream, "IHDR", ihdr, sizeof(ihdr));
+
+	std::vector<uint8> rows(rowsize * 2, 0);
+	std::vector<uint8> candidates((rowsize + 1) * 5);
+	std::vector<uint8> out(64 * 1024);
+	size_t outsize = 0;
+
+	uint8 *row = rows.data();
+	uint8 *prev = rows.data() + rowsize;
+
+	z_stream zs = {};
+	if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+		throw love::Exception("Could not initialize PNG compression.");
+
+	auto deflateData = [&](const uint8 *in, size_t size, int flush)
+	{
+		zs.next_in = (Bytef *) in;
+		zs.avail_in = (uInt) size;
+
+		while (true)
+		{
+			zs.next_out = out.data() + outsize;
+			zs.avail_out = (uInt) (out.size() - outsize);
+
+			int status = deflate(&zs, flush);
+			if (status == Z_STREAM_ERROR)
+				throw love::Exception("Could not compress PNG image data.");
+
+			outsize = out.size() - zs.avail_out;
+			bool full = zs.avail_out == 0;
+
+			if (full)
+			{
+				writePNGChunk(stream, "IDAT", out.data(), outsize);
+				outsize = 0;
+			}
+
+			if (flush == Z_FINISH ? status == Z_STREAM_END : (!full && zs.avail_in == 0))
+				break;
+		}
+	};
+
+	try
+	{
+		for (int y = 0; y < img.height; y++)
+		{
+			const uint8 *src = img.data + y * rowsize;
+
+#ifndef LOVE_BIG_ENDIAN
+			// PNG stores 16 bit components in big-endian order.
+			if (bitdepth == 16)
+			{
+				for (size_t i = 0; i < rowsize; i += 2)
+				{
+					row[i + 0] = src[i + 1];
+					row[i + 1] = src[i + 0];
+				}
+			}
+			else
+#endif
+				memcpy(row, src, rowsize);
+
+			const uint8 *filtered = filterPNGScanline(row, prev, rowsize, bpp, candidates.data());
+			deflateData(filtered, rowsize + 1, Z_NO_FLUSH);
+
+			std::swap(row, prev);
+		}
+
+		deflateData(nullptr, 0, Z_FINISH);
+
+		if (outsize > 0)
+			writePNGChunk(stream, "IDAT", out.data(), outsize);
+
+		writePNGChunk(stream, "IEND", nullptr, 0);
+	}
+	catch (love::Exception &)
+	{
+		deflateEnd(&zs);
+		throw;
+	}
+
+	deflateEnd(&zs);
+}
+
 void PNGHandler::freeRawPixels(unsigned char *mem)
 {
 	// LodePNG uses malloc, realloc, and free.
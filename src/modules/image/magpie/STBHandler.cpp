@@ -50,6 +50,10 @@ static void loveSTBIAssert(bool test, const char *teststr)
 // C
 #include <cstdlib>
 
+// C++
+#include <algorithm>
+#include <vector>
+
 namespace love
 {
 namespace image
@@ -108,6 +112,38 @@ FormatHandler::DecodedImage STBHandler::decode(Data *data)
 	return img;
 }
 
+static const size_t TGA_HEADER_SIZE = 18;
+
+static void writeTGAHeader(const FormatHandler::DecodedImage &img, unsigned char *header)
+{
+	// here's the header for the Targa file format.
+	header[0]  = 0; // ID field size
+	header[1]  = 0; // colormap type
+	header[2]  = 2; // image type
+	header[3]  = header[4] = 0; // colormap start
+	header[5]  = header[6] = 0; // colormap length
+	header[7]  = 32; // colormap bits
+	header[8]  = header[9] = 0; // x origin
+	header[10] = header[11] = 0; // y origin
+	// Targa is little endian, so:
+	header[12] = img.width & 255; // least significant byte of width
+	header[13] = img.width >> 8; // most significant byte of width
+	header[14] = img.height & 255; // least significant byte of height
+	header[15] = img.height >> 8; // most significant byte of height
+	header[16] = 4 * 8; // bits per pixel
+	header[17] = 0x20; // descriptor bits (flip bits: 0x10 horizontal, 0x20 vertical)
+}
+
+// Copies RGBA pixels to BGRA.
+static void swizzleTGAPixels(const Color32 *src, Color32 *dst, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Color32 c = src[i];
+		dst[i] = Color32(c.b, c.g, c.r, c.a);
+	}
+}
+
 FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
 {
 	if (!canEncode(img.format, encodedFormat))
@@ -118,10 +154,9 @@ FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedF
 
 	EncodedImage encimg;
 
-	const size_t headerlen = 18;
 	const size_t bpp = 4;
 
-	encimg.size = (img.width * img.height * bpp) + headerlen;
+	encimg.size = (img.width * img.height * bpp) + TGA_HEADER_SIZE;
 
 	try
 	{
@@ -132,42 +167,47 @@ FormatHandler::EncodedImage STBHandler::encode(const DecodedImage &img, EncodedF
 		throw love::Exception("Out of memory.");
 	}
 
-	// here's the header for the Targa file format.
-	encimg.data[0]  = 0; // ID field size
-	encimg.data[1]  = 0; // colormap type
-	encimg.data[2]  = 2; // image type
-	encimg.data[3]  = encimg.data[4] = 0; // colormap start
-	encimg.data[5]  = encimg.data[6] = 0; // colormap length
-	encimg.data[7]  = 32; // colormap bits
-	encimg.data[8]  = encimg.data[9] = 0; // x origin
-	encimg.data[10] = encimg.data[11] = 0; // y origin
-	// Targa is little endian, so:
-	encimg.data[12] = img.width & 255; // least significant byte of width
-	encimg.data[13] = img.width >> 8; // most significant byte of width
-	encimg.data[14] = img.height & 255; // least significant byte of height
-	encimg.data[15] = img.height >> 8; // most significant byte of height
-	encimg.data[16] = bpp * 8; // bits per pixel
-	encimg.data[17] = 0x20; // descriptor bits (flip bits: 0x10 horizontal, 0x20 vertical)
-
-	// header done. write the pixel data to TGA:
-	memcpy(encimg.data + headerlen, img.data, img.width * img.height * bpp);
-
-	// convert the pixels from RGBA to BGRA.
-	Color32 *encodedpixels = (Color32 *) (encimg.data + headerlen);
-	for (int y = 0; y < img.height; y++)
-	{
-		for (int x = 0; x < img.width; x++)
-		{
-			unsigned char r = encodedpixels[y * img.width + x].r;
-			unsigned char b = encodedpixels[y * img.width + x].b;
-			encodedpixels[y * img.width + x].r = b;
-			encodedpixels[y * img.width + x].b = r;
-		}
-	}
+	writeTGAHeader(img, encimg.data);
+
+	// write the pixel data to TGA, converting from RGBA to BGRA.
+	swizzleTGAPixels((const Color32 *) img.data, (Color32 *) (encimg.data + TGA_HEADER_SIZE), img.width * img.height);
 
 	return encimg;
 }
 
+bool STBHandler::canEncodeStream(PixelFormat rawFormat, EncodedFormat encodedFormat)
+{
+	return canEncode(rawFormat, encodedFormat);
+}
+
+void STBHandler::encodeStream(const DecodedImage &img, EncodedFormat encodedFormat, Stream *stream)
+{
+	if (!canEncodeStream(img.format, encodedFormat))
+		throw love::Exception("Invalid format.");
+
+	unsigned char header[TGA_HEADER_SIZE];
+	writeTGAHeader(img, header);
+
+	if (!stream->write(header, TGA_HEADER_SIZE))
+		throw love::Exception("Could not write TGA image data.");
+
+	// Convert and write the pixels in fixed-size pieces.
+	const size_t chunkpixels = 16 * 1024;
+	std::vector<Color32> chunk(chunkpixels);
+
+	const Color32 *pixels = (const Color32 *) img.data;
+	size_t totalpixels = (size_t) img.width * img.height;
+
+	for (size_t offset = 0; offset < totalpixels; offset += chunkpixels)
+	{
+		size_t count = std::min(chunkpixels, totalpixels - offset);
+		swizzleTGAPixels(pixels + offset, chunk.data(), count);
+
+		if (!stream->write(chunk.data(), count * sizeof(Color32)))
+			throw love::Exception("Could not write TGA image data.");
+	}
+}
+
 void STBHandler::freeRawPixels(unsigned char *mem)
 {
 	// The STB decoder gave memory allocated directly by stb_image to the
@@ -50,6 +50,9 @@ public:
 	DecodedImage decode(Data *data) override;
 	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
 
+	bool canEncodeStream(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
+	void encodeStream(const DecodedImage &img, EncodedFormat format, Stream *stream) override;
+
 	void freeRawPixels(unsigned char *mem) override;
 	void freeEncodedImage(unsigned char *mem) override;
 
@@ -229,7 +229,7 @@ bool DDSHandler::canParseCompressed(Data *data)
 	return dds::isCompressedDDS(data->getData(), data->getSize());
 }
 
-StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+StrongRef<Data> DDSHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
 {
 	if (!dds::isCompressedDDS(filedata->getData(), filedata->getSize()))
 		throw love::Exception("Could not decode compressed data (not a DDS file?)");
@@ -238,8 +238,6 @@ StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<Stro
 	bool isSRGB = false;
 	bool bgra = false;
 
-	size_t dataSize = 0;
-
 	images.clear();
 
 	// Attempt to parse the dds file.
@@ -253,30 +251,18 @@ StrongRef<ByteData> DDSHandler::parseCompressed(Data *filedata, std::vector<Stro
 	if (parser.getMipmapCount() == 0)
 		throw love::Exception("Could not parse compressed data: No readable texture data.");
 
-	// Calculate the size of the block of memory we're returning.
-	for (size_t i = 0; i < parser.getMipmapCount(); i++)
-	{
-		const dds::Image *img = parser.getImageData(i);
-		dataSize += img->dataSize;
-	}
-
-	StrongRef<ByteData> memory(new ByteData(dataSize, false), Acquire::NORETAIN);
+	StrongRef<Data> memory(filedata);
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
 
-	size_t dataOffset = 0;
-
-	// Copy the parsed mipmap levels from the FileData to our CompressedImageData.
 	for (size_t i = 0; i < parser.getMipmapCount(); i++)
 	{
 		// Fetch the data for this mipmap level.
 		const dds::Image *img = parser.getImageData(i);
 
-		// Copy the mipmap image from the FileData to our block of memory.
-		memcpy((uint8 *) memory->getData() + dataOffset, img->data, img->dataSize);
+		size_t dataOffset = (const uint8 *) img->data - filebytes;
 
 		auto slice = new CompressedSlice(texformat, img->width, img->height, memory, dataOffset, img->dataSize);
 		images.emplace_back(slice, Acquire::NORETAIN);
-
-		dataOffset += img->dataSize;
 	}
 
 	format = texformat;
@@ -46,7 +46,7 @@ public:
 	bool canDecode(Data *data) override;
 	DecodedImage decode(Data *data) override;
 	bool canParseCompressed(Data *data) override;
-	StrongRef<ByteData> parseCompressed(Data *filedata,
+	StrongRef<Data> parseCompressed(Data *filedata,
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format, bool &sRGB) override;
 
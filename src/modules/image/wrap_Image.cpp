@@ -26,6 +26,7 @@
 #include "Image.h"
 
 #include "filesystem/wrap_Filesystem.h"
+#include "thread/wrap_Channel.h"
 
 namespace love
 {
@@ -105,6 +106,25 @@ int w_newImageData(lua_State *L)
 
 int w_newCompressedData(lua_State *L)
 {
+	if (luax_istype(L, 1, ImageData::type))
+	{
+		ImageData *imagedata = luax_checkimagedata(L, 1);
+
+		const char *fstr = luaL_checkstring(L, 2);
+		PixelFormat format = PIXELFORMAT_UNKNOWN;
+		if (!getConstant(fstr, format))
+			return luax_enumerror(L, "pixel format", fstr);
+
+		bool mipmaps = luax_optboolean(L, 3, false);
+
+		CompressedImageData *t = nullptr;
+		luax_catchexcept(L, [&]() { t = instance()->newCompressedData(imagedata, format, mipmaps); });
+
+		luax_pushtype(L, CompressedImageData::type, t);
+		t->release();
+		return 1;
+	}
+
 	Data *data = love::filesystem::luax_getdata(L, 1);
 
 	CompressedImageData *t = nullptr;
@@ -128,6 +148,36 @@ int w_isCompressed(lua_State *L)
 	return 1;
 }
 
+int w_decodeBatch(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	love::thread::Channel *channel = love::thread::luax_checkchannel(L, 2);
+
+	std::vector<Data *> files;
+	int count = (int) luax_objlen(L, 1);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		if (!filesystem::luax_cangetdata(L, -1))
+		{
+			for (Data *data : files)
+				data->release();
+			return luaL_error(L, "Expected a filename, File, or FileData at index %d of the file list.", i);
+		}
+
+		files.push_back(love::filesystem::luax_getdata(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L,
+		[&]() { instance()->decodeBatch(files, channel); },
+		[&](bool) { for (Data *data : files) data->release(); }
+	);
+
+	return 0;
+}
+
 int w_newCubeFaces(lua_State *L)
 {
 	ImageData *id = luax_checkimagedata(L, 1);
@@ -145,6 +195,7 @@ static const luaL_Reg functions[] =
 	{ "newCompressedData", w_newCompressedData },
 	{ "isCompressed", w_isCompressed },
 	{ "newCubeFaces", w_newCubeFaces },
+	{ "decodeBatch", w_decodeBatch },
 	{ 0, 0 }
 };
 
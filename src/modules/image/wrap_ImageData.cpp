@@ -23,6 +23,12 @@
 #include "data/wrap_Data.h"
 #include "filesystem/File.h"
 #include "filesystem/Filesystem.h"
+#include "filesystem/wrap_Filesystem.h"
+#include "math/MathModule.h"
+#include "math/wrap_Math.h"
+
+// C
+#include <string.h>
 
 // Shove the wrap_ImageData.lua code directly into a raw string literal.
 static const char imagedata_lua[] =
@@ -144,6 +150,28 @@ int w_ImageData_setPixel(lua_State *L)
 	return 0;
 }
 
+int w_ImageData_setIdleCompression(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setIdleCompression(enable); });
+	return 0;
+}
+
+int w_ImageData_hasIdleCompression(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	luax_pushboolean(L, t->hasIdleCompression());
+	return 1;
+}
+
+int w_ImageData_isIdleCompressed(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	luax_pushboolean(L, t->isIdleCompressed());
+	return 1;
+}
+
 // ImageData:mapPixel. Not thread-safe! See wrap_ImageData.lua for the thread-
 // safe wrapper function.
 int w_ImageData__mapPixelUnsafe(lua_State *L)
@@ -168,7 +196,8 @@ int w_ImageData__mapPixelUnsafe(lua_State *L)
 	auto pixelsetfunction = t->getPixelSetFunction();
 	auto pixelgetfunction = t->getPixelGetFunction();
 
-	uint8 *data = (uint8 *) t->getData();
+	uint8 *data = nullptr;
+	luax_catchexcept(L, [&](){ data = (uint8 *) t->getData(); });
 	size_t pixelsize = t->getPixelSize();
 
 	for (int y = sy; y < sy+h; y++)
@@ -209,6 +238,157 @@ int w_ImageData__mapPixelUnsafe(lua_State *L)
 	return 0;
 }
 
+static float getOperationNumber(lua_State *L, int opindex, int n, float def, bool required)
+{
+	lua_rawgeti(L, -1, n);
+	float v = def;
+	if (required || !lua_isnoneornil(L, -1))
+	{
+		if (!lua_isnumber(L, -1))
+			luaL_error(L, "Expected a number for value #%d of pixel operation #%d.", n - 1, opindex);
+		v = (float) lua_tonumber(L, -1);
+	}
+	lua_pop(L, 1);
+	return v;
+}
+
+// Reads the pixel operation table at the top of the stack into op, or only
+// checks it when op is null. All operations are checked before any are read,
+// so a Lua error can't skip the destructors of the ones built so far.
+static void readPixelOperation(lua_State *L, int i, ImageData::PixelOperation *op)
+{
+	if (!lua_istable(L, -1))
+		luaL_error(L, "Expected a table for pixel operation #%d.", i);
+
+	lua_rawgeti(L, -1, 1);
+	const char *typestr = luaL_checkstring(L, -1);
+	lua_pop(L, 1);
+
+	ImageData::PixelOperationType type = ImageData::PIXELOP_MULTIPLY;
+	if (!ImageData::getConstant(typestr, type))
+		luax_enumerror(L, "pixel operation", ImageData::getConstants(type), typestr);
+
+	Colorf color(1.0f, 1.0f, 1.0f, 1.0f);
+	float amount = 0.0f;
+	int swizzle[4] = {0, 1, 2, 3};
+
+	switch (type)
+	{
+	case ImageData::PIXELOP_MULTIPLY:
+	case ImageData::PIXELOP_ADD:
+	{
+		float def = type == ImageData::PIXELOP_MULTIPLY ? 1.0f : 0.0f;
+		color.r = getOperationNumber(L, i, 2, def, true);
+		color.g = getOperationNumber(L, i, 3, color.r, false);
+		color.b = getOperationNumber(L, i, 4, color.r, false);
+		color.a = getOperationNumber(L, i, 5, def, false);
+		break;
+	}
+	case ImageData::PIXELOP_LERP:
+		color.r = getOperationNumber(L, i, 2, 0.0f, true);
+		color.g = getOperationNumber(L, i, 3, 0.0f, true);
+		color.b = getOperationNumber(L, i, 4, 0.0f, true);
+		color.a = getOperationNumber(L, i, 5, 0.0f, true);
+		amount = getOperationNumber(L, i, 6, 0.0f, true);
+		break;
+	case ImageData::PIXELOP_LUT:
+	{
+		lua_rawgeti(L, -1, 2);
+		if (!lua_istable(L, -1))
+			luaL_error(L, "Expected a table of numbers for lookup table pixel operation #%d.", i);
+
+		int lutsize = (int) luax_objlen(L, -1);
+		if (op != nullptr)
+			op->lut.reserve(lutsize);
+
+		for (int j = 1; j <= lutsize; j++)
+		{
+			lua_rawgeti(L, -1, j);
+			if (!lua_isnumber(L, -1))
+				luaL_error(L, "Expected a number for entry #%d of lookup table pixel operation #%d.", j, i);
+			if (op != nullptr)
+				op->lut.push_back((float) lua_tonumber(L, -1));
+			lua_pop(L, 1);
+		}
+
+		lua_pop(L, 1);
+		break;
+	}
+	case ImageData::PIXELOP_SWIZZLE:
+	{
+		lua_rawgeti(L, -1, 2);
+		const char *str = luaL_checkstring(L, -1);
+		const char *channels = "rgba";
+
+		if (strlen(str) != 4)
+			luaL_error(L, "Swizzle pixel operation #%d must have exactly 4 channels (e.g. \"bgra\").", i);
+
+		for (int j = 0; j < 4; j++)
+		{
+			const char *channel = strchr(channels, str[j]);
+			if (channel == nullptr)
+				luaL_error(L, "Invalid swizzle channel '%c' in pixel operation #%d.", str[j], i);
+			swizzle[j] = (int) (channel - channels);
+		}
+
+		lua_pop(L, 1);
+		break;
+	}
+	default:
+		break;
+	}
+
+	if (op != nullptr)
+	{
+		op->type = type;
+		op->color = color;
+		op->amount = amount;
+		for (int j = 0; j < 4; j++)
+			op->swizzle[j] = swizzle[j];
+	}
+}
+
+int w_ImageData_applyPixelOperations(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int x = (int) luaL_optinteger(L, 3, 0);
+	int y = (int) luaL_optinteger(L, 4, 0);
+	int w = (int) luaL_optinteger(L, 5, t->getWidth());
+	int h = (int) luaL_optinteger(L, 6, t->getHeight());
+
+	int count = (int) luax_objlen(L, 2);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		readPixelOperation(L, i, nullptr);
+		lua_pop(L, 1);
+	}
+
+	std::vector<ImageData::PixelOperation> ops(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		readPixelOperation(L, i, &ops[i - 1]);
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ t->applyPixelOperations(ops, x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_fillNoise(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	love::math::NoiseSettings settings;
+	love::math::luax_checknoisesettings(L, 2, settings);
+	luax_catchexcept(L, [&](){ t->fillNoise(settings); });
+	return 0;
+}
+
 int w_ImageData_paste(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -250,6 +430,36 @@ int w_ImageData_encode(lua_State *L)
 	return 1;
 }
 
+int w_ImageData_encodeToFile(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	FormatHandler::EncodedFormat format;
+	const char *fmt = luaL_checkstring(L, 2);
+	if (!ImageData::getConstant(fmt, format))
+		return luax_enumerror(L, "encoded image format", ImageData::getConstants(format), fmt);
+
+	StrongRef<love::filesystem::File> file(love::filesystem::luax_getfile(L, 3), Acquire::NORETAIN);
+
+	luax_catchexcept(L, [&]()
+	{
+		bool opened = false;
+		if (!file->isOpen())
+		{
+			if (!file->open(love::filesystem::File::MODE_WRITE))
+				throw love::Exception("Could not open file %s for writing.", file->getFilename().c_str());
+			opened = true;
+		}
+
+		t->encode(format, file);
+
+		if (opened)
+			file->close();
+	});
+
+	return 0;
+}
+
 int w_ImageData__performAtomic(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -320,7 +530,13 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "getPixel", w_ImageData_getPixel },
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
+	{ "applyPixelOperations", w_ImageData_applyPixelOperations },
+	{ "fillNoise", w_ImageData_fillNoise },
 	{ "encode", w_ImageData_encode },
+	{ "encodeToFile", w_ImageData_encodeToFile },
+	{ "setIdleCompression", w_ImageData_setIdleCompression },
+	{ "hasIdleCompression", w_ImageData_hasIdleCompression },
+	{ "isIdleCompressed", w_ImageData_isIdleCompressed },
 
 	// Used in the Lua wrapper code.
 	{ "_mapPixelUnsafe", w_ImageData__mapPixelUnsafe },
@@ -353,6 +353,11 @@ local _getHeight = ImageData.getHeight
 local _getDimensions = ImageData.getDimensions
 local _getFormat = ImageData.getFormat
 local _release = ImageData.release
+local _getPixel = ImageData.getPixel
+local _setPixel = ImageData.setPixel
+local _mapPixelUnsafe = ImageData._mapPixelUnsafe
+local _setIdleCompression = ImageData.setIdleCompression
+local _hasIdleCompression = ImageData.hasIdleCompression
 
 -- Table which holds ImageData objects as keys, and information about the objects
 -- as values. Uses weak keys so the ImageData objects can still be GC'd properly.
@@ -364,10 +369,18 @@ local objectcache = setmetatable({}, {
 		
 		local conv = conversions[format]
 
+		-- The pixels of ImageData with idle compression can move, so those use
+		-- the regular methods instead of a cached pointer.
+		local idlecompression = _hasIdleCompression(imagedata)
+		if idlecompression then
+			conv = nil
+		end
+
 		local p = {
 			width = width,
 			height = height,
 			format = format,
+			idlecompression = idlecompression,
 			pointer = conv == nil and nil or ffi.cast(conv.pointer, imagedata:getFFIPointer()),
 			tolua = conv == nil and nil or conv.tolua,
 			fromlua = conv == nil and nil or conv.fromlua,
@@ -395,6 +408,8 @@ function ImageData:_mapPixelUnsafe(func, ix, iy, iw, ih)
 	local p = objectcache[self]
 	local idw, idh = p.width, p.height
 
+	if p.idlecompression then return _mapPixelUnsafe(self, func, ix, iy, iw, ih) end
+
 	if p.pointer == nil then error("ImageData:mapPixel does not currently support the "..p.format.." pixel format.", 2) end
 
 	ix = floor(ix)
@@ -423,6 +438,8 @@ function ImageData:getPixel(x, y)
 	y = floor(y)
 
 	local p = objectcache[self]
+	if p.idlecompression then return _getPixel(self, x, y) end
+
 	if not inside(x, y, p.width, p.height) then error("Attempt to get out-of-range pixel!", 2) end
 
 	if p.pointer == nil then error("ImageData:getPixel does not currently support the "..p.format.." pixel format.", 2) end
@@ -453,6 +470,8 @@ function ImageData:setPixel(x, y, r, g, b, a)
 	if a ~= nil and type(a) ~= "number" then error("bad alpha color component argument to ImageData:setPixel (expected number)", 2) end
 
 	local p = objectcache[self]
+	if p.idlecompression then return _setPixel(self, x, y, r, g, b, a) end
+
 	if not inside(x, y, p.width, p.height) then error("Attempt to set out-of-range pixel!", 2) end
 
 	if p.pointer == nil then error("ImageData:setPixel does not currently support the "..p.format.." pixel format.", 2) end
@@ -479,6 +498,11 @@ function ImageData:getFormat()
 	return objectcache[self].format
 end
 
+function ImageData:setIdleCompression(enable)
+	_setIdleCompression(self, enable)
+	objectcache[self] = nil
+end
+
 function ImageData:release()
 	objectcache[self] = nil
 	return _release(self)
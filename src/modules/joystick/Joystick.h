@@ -155,6 +155,18 @@ public:
 		};
 	};
 
+	// A snapshot of every input on the joystick, filled in by getState.
+	struct State
+	{
+		std::vector<float> axes;
+		std::vector<bool> buttons;
+		std::vector<Hat> hats;
+
+		bool gamepad = false;
+		float gamepadAxes[GAMEPAD_AXIS_MAX_ENUM];
+		bool gamepadButtons[GAMEPAD_BUTTON_MAX_ENUM];
+	};
+
 	virtual ~Joystick() {}
 
 	virtual bool open(int deviceindex) = 0;
@@ -174,6 +186,13 @@ public:
 
 	virtual bool isDown(const std::vector<int> &buttonlist) const = 0;
 
+	/**
+	 * Gets the current value of all axes, buttons, hats and (if the joystick
+	 * is a gamepad) gamepad inputs at once. The vectors in the given State are
+	 * reused, so a State kept across frames doesn't allocate.
+	 **/
+	virtual void getState(State &state) const = 0;
+
 	virtual void setPlayerIndex(int index) = 0;
 	virtual int getPlayerIndex() const = 0;
 
@@ -101,6 +101,20 @@ public:
 	 **/
 	virtual std::string getGamepadMappingString(const std::string &guid) const = 0;
 
+	/**
+	 * Enables or disables love.event messages for a type of joystick input.
+	 * Inputs whose events are disabled can still be polled, e.g. via
+	 * Joystick::getState. Applies to both joystick and gamepad events.
+	 **/
+	virtual void setEventsEnabled(Joystick::InputType type, bool enabled) = 0;
+	virtual bool areEventsEnabled(Joystick::InputType type) const = 0;
+
+	/**
+	 * Enables or disables joysticksensorupdated events.
+	 **/
+	virtual void setSensorEventsEnabled(bool enabled) = 0;
+	virtual bool areSensorEventsEnabled() const = 0;
+
 }; // JoystickModule
 
 } // joystick
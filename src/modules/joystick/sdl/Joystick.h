@@ -61,6 +61,8 @@ public:
 
 	bool isDown(const std::vector<int> &buttonlist) const override;
 
+	void getState(State &state) const override;
+
 	void setPlayerIndex(int index) override;
 	int getPlayerIndex() const override;
 
@@ -40,7 +40,11 @@ namespace sdl
 {
 
 JoystickModule::JoystickModule()
+	: sensorEventsEnabled(true)
 {
+	for (bool &enabled : eventsEnabled)
+		enabled = true;
+
 	if (SDL_InitSubSystem(SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER) < 0)
 		throw love::Exception("Could not initialize SDL joystick subsystem (%s)", SDL_GetError());
 
@@ -74,6 +78,33 @@ const char *JoystickModule::getName() const
 	return "love.joystick.sdl";
 }
 
+void JoystickModule::setEventsEnabled(Joystick::InputType type, bool enabled)
+{
+	// Events are filtered when love.event converts them rather than via
+	// SDL_EventState, since SDL's gamepad state tracking relies on joystick
+	// events being delivered in some SDL versions.
+	if (type >= 0 && type < Joystick::INPUT_TYPE_MAX_ENUM)
+		eventsEnabled[type] = enabled;
+}
+
+bool JoystickModule::areEventsEnabled(Joystick::InputType type) const
+{
+	if (type < 0 || type >= Joystick::INPUT_TYPE_MAX_ENUM)
+		return false;
+
+	return eventsEnabled[type];
+}
+
+void JoystickModule::setSensorEventsEnabled(bool enabled)
+{
+	sensorEventsEnabled = enabled;
+}
+
+bool JoystickModule::areSensorEventsEnabled() const
+{
+	return sensorEventsEnabled;
+}
+
 love::joystick::Joystick *JoystickModule::getJoystick(int joyindex)
 {
 	if (joyindex < 0 || (size_t) joyindex >= activeSticks.size())
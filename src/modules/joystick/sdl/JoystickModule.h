@@ -61,6 +61,12 @@ public:
 	std::string getGamepadMappingString(const std::string &guid) const override;
 	std::string saveGamepadMappings() override;
 
+	void setEventsEnabled(Joystick::InputType type, bool enabled) override;
+	bool areEventsEnabled(Joystick::InputType type) const override;
+
+	void setSensorEventsEnabled(bool enabled) override;
+	bool areSensorEventsEnabled() const override;
+
 private:
 
 	std::string stringFromGamepadInput(Joystick::GamepadInput gpinput) const;
@@ -81,6 +87,9 @@ private:
 	// modified at some point.
 	std::map<std::string, bool> recentGamepadGUIDs;
 
+	bool eventsEnabled[Joystick::INPUT_TYPE_MAX_ENUM];
+	bool sensorEventsEnabled;
+
 }; // JoystickModule
 
 } // sdl
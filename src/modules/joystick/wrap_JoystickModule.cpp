@@ -26,6 +26,9 @@
 
 #include "sdl/JoystickModule.h"
 
+// C
+#include <cstring>
+
 namespace love
 {
 namespace joystick
@@ -171,6 +174,209 @@ int w_getGamepadMappingString(lua_State *L)
 	return 1;
 }
 
+// Gets t[name] as a table, creating it if it doesn't exist. The table is
+// pushed onto the stack.
+static void luax_getsubtable(lua_State *L, int idx, const char *name, int narr, int nrec)
+{
+	lua_getfield(L, idx, name);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_createtable(L, narr, nrec);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, idx, name);
+	}
+}
+
+// Removes array entries past the given length from a reused table.
+static void luax_truncatearray(lua_State *L, int idx, int length)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	int oldlength = (int) luax_objlen(L, idx);
+	for (int i = oldlength; i > length; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, idx, i);
+	}
+}
+
+int w_getStates(lua_State *L)
+{
+	int stickcount = instance()->getJoystickCount();
+
+	if (lua_istable(L, 1))
+		lua_settop(L, 1);
+	else
+	{
+		lua_settop(L, 0);
+		lua_createtable(L, stickcount, 0);
+	}
+
+	Joystick::State state;
+
+	for (int i = 0; i < stickcount; i++)
+	{
+		Joystick *stick = instance()->getJoystick(i);
+		luax_catchexcept(L, [&](){ stick->getState(state); });
+
+		lua_rawgeti(L, 1, i + 1);
+		if (!lua_istable(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_createtable(L, 0, 6);
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, 1, i + 1);
+		}
+		int entry = lua_gettop(L);
+
+		luax_pushtype(L, stick);
+		lua_setfield(L, entry, "joystick");
+
+		luax_getsubtable(L, entry, "axes", (int) state.axes.size(), 0);
+		for (size_t j = 0; j < state.axes.size(); j++)
+		{
+			lua_pushnumber(L, state.axes[j]);
+			lua_rawseti(L, -2, (int) j + 1);
+		}
+		luax_truncatearray(L, -1, (int) state.axes.size());
+		lua_pop(L, 1);
+
+		luax_getsubtable(L, entry, "buttons", (int) state.buttons.size(), 0);
+		for (size_t j = 0; j < state.buttons.size(); j++)
+		{
+			lua_pushboolean(L, state.buttons[j]);
+			lua_rawseti(L, -2, (int) j + 1);
+		}
+		luax_truncatearray(L, -1, (int) state.buttons.size());
+		lua_pop(L, 1);
+
+		luax_getsubtable(L, entry, "hats", (int) state.hats.size(), 0);
+		for (size_t j = 0; j < state.hats.size(); j++)
+		{
+			const char *hatstr = nullptr;
+			if (!Joystick::getConstant(state.hats[j], hatstr))
+				hatstr = "c";
+			lua_pushstring(L, hatstr);
+			lua_rawseti(L, -2, (int) j + 1);
+		}
+		luax_truncatearray(L, -1, (int) state.hats.size());
+		lua_pop(L, 1);
+
+		if (state.gamepad)
+		{
+			luax_getsubtable(L, entry, "gamepadaxes", 0, Joystick::GAMEPAD_AXIS_MAX_ENUM);
+			for (int j = 0; j < Joystick::GAMEPAD_AXIS_MAX_ENUM; j++)
+			{
+				const char *name = nullptr;
+				if (!Joystick::getConstant((Joystick::GamepadAxis) j, name))
+					continue;
+				lua_pushnumber(L, state.gamepadAxes[j]);
+				lua_setfield(L, -2, name);
+			}
+			lua_pop(L, 1);
+
+			luax_getsubtable(L, entry, "gamepadbuttons", 0, Joystick::GAMEPAD_BUTTON_MAX_ENUM);
+			for (int j = 0; j < Joystick::GAMEPAD_BUTTON_MAX_ENUM; j++)
+			{
+				const char *name = nullptr;
+				if (!Joystick::getConstant((Joystick::GamepadButton) j, name))
+					continue;
+				lua_pushboolean(L, state.gamepadButtons[j]);
+				lua_setfield(L, -2, name);
+			}
+			lua_pop(L, 1);
+
+			// Only enabled sensors are included, as {x, y, z} tables.
+			luax_getsubtable(L, entry, "sensors", 0, Joystick::Sensor::SENSOR_MAX_ENUM);
+			for (int j = 0; j < Joystick::Sensor::SENSOR_MAX_ENUM; j++)
+			{
+				auto type = (Joystick::Sensor::SensorType) j;
+				const char *name = nullptr;
+				if (!Joystick::Sensor::getConstant(type, name))
+					continue;
+
+				if (!stick->isSensorEnabled(type))
+				{
+					lua_pushnil(L);
+					lua_setfield(L, -2, name);
+					continue;
+				}
+
+				std::vector<float> data;
+				luax_catchexcept(L, [&](){ data = stick->getSensorData(type); });
+
+				luax_getsubtable(L, lua_gettop(L), name, (int) data.size(), 0);
+				for (size_t k = 0; k < data.size(); k++)
+				{
+					lua_pushnumber(L, data[k]);
+					lua_rawseti(L, -2, (int) k + 1);
+				}
+				lua_pop(L, 1);
+			}
+			lua_pop(L, 1);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_setfield(L, entry, "gamepadaxes");
+			lua_pushnil(L);
+			lua_setfield(L, entry, "gamepadbuttons");
+			lua_pushnil(L);
+			lua_setfield(L, entry, "sensors");
+		}
+
+		lua_pop(L, 1); // entry
+	}
+
+	luax_truncatearray(L, 1, stickcount);
+	return 1;
+}
+
+static bool luax_checkeventtype(lua_State *L, int idx, Joystick::InputType &type)
+{
+	const char *str = luaL_checkstring(L, idx);
+	if (strcmp(str, "sensor") == 0)
+		return true;
+
+	if (!Joystick::getConstant(str, type))
+	{
+		std::vector<std::string> types = Joystick::getConstants(type);
+		types.push_back("sensor");
+		luax_enumerror(L, "joystick event type", types, str);
+	}
+
+	return false;
+}
+
+int w_setEventsEnabled(lua_State *L)
+{
+	Joystick::InputType type = Joystick::INPUT_TYPE_MAX_ENUM;
+	bool sensor = luax_checkeventtype(L, 1, type);
+	bool enabled = luax_checkboolean(L, 2);
+
+	if (sensor)
+		instance()->setSensorEventsEnabled(enabled);
+	else
+		instance()->setEventsEnabled(type, enabled);
+
+	return 0;
+}
+
+int w_areEventsEnabled(lua_State *L)
+{
+	Joystick::InputType type = Joystick::INPUT_TYPE_MAX_ENUM;
+	bool sensor = luax_checkeventtype(L, 1, type);
+
+	if (sensor)
+		luax_pushboolean(L, instance()->areSensorEventsEnabled());
+	else
+		luax_pushboolean(L, instance()->areEventsEnabled(type));
+
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -180,6 +386,9 @@ static const luaL_Reg functions[] =
 	{ "loadGamepadMappings", w_loadGamepadMappings },
 	{ "saveGamepadMappings", w_saveGamepadMappings },
 	{ "getGamepadMappingString", w_getGamepadMappingString },
+	{ "getStates", w_getStates },
+	{ "setEventsEnabled", w_setEventsEnabled },
+	{ "areEventsEnabled", w_areEventsEnabled },
 	{ 0, 0 }
 };
 
@@ -117,7 +117,13 @@ love.arg.options = {
 	fused = { a = 0 },
 	game = { a = 1 },
 	renderers = { a = 1 },
+	compileshader = { a = 2 },
 	excluderenderers = { a = 1 },
+	tracestartup = { a = 0 },
+	bench = { a = 1 },
+	benchdt = { a = 1 },
+	benchoutput = { a = 1 },
+	headless = { a = 0 },
 }
 
 love.arg.optionIndices = {}
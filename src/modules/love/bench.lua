@@ -0,0 +1,230 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2023 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local love = require("love")
+
+-- love --bench frames [--benchdt seconds] [--benchoutput path] path/to/game
+-- Runs the game for a fixed number of frames with a fixed dt, then writes
+-- frame time percentiles, graphics stats and memory stats as JSON. Frame
+-- times are in milliseconds.
+
+love.bench = {}
+
+-- Graphics stats which count work done during the current frame, rather
+-- than the current state. These are summed over all frames.
+local perframestats = {
+	"drawcalls",
+	"drawcallsbatched",
+	"canvasswitches",
+	"shaderswitches",
+	"streambufferbytes",
+	"streambufferstalls",
+	"pipelinecreations",
+	"samplercreations",
+	"descriptorwrites",
+	"statecalls",
+	"statecallsskipped",
+	"gpuframetime",
+}
+
+local function percentile(sorted, p)
+	if #sorted == 0 then return 0 end
+	local i = math.max(1, math.min(#sorted, math.ceil(p * #sorted)))
+	return sorted[i]
+end
+
+local function encodejson(value, out)
+	local t = type(value)
+	if t == "table" then
+		if #value > 0 or next(value) == nil then
+			out[#out+1] = "["
+			for i,v in ipairs(value) do
+				if i > 1 then out[#out+1] = "," end
+				encodejson(v, out)
+			end
+			out[#out+1] = "]"
+		else
+			-- Sorted keys keep the output stable, so results can be diffed.
+			local keys = {}
+			for k in pairs(value) do keys[#keys+1] = tostring(k) end
+			table.sort(keys)
+			out[#out+1] = "{"
+			for i,k in ipairs(keys) do
+				if i > 1 then out[#out+1] = "," end
+				encodejson(k, out)
+				out[#out+1] = ":"
+				local v = value[k]
+				if v == nil then v = value[tonumber(k)] end
+				encodejson(v, out)
+			end
+			out[#out+1] = "}"
+		end
+	elseif t == "number" then
+		if value ~= value or value == math.huge or value == -math.huge then
+			out[#out+1] = "null"
+		elseif value == math.floor(value) and math.abs(value) < 2^53 then
+			out[#out+1] = string.format("%d", value)
+		else
+			out[#out+1] = string.format("%.6g", value)
+		end
+	elseif t == "string" then
+		out[#out+1] = '"' .. value:gsub('[%c"\\]', function(c)
+			return string.format("\\u%04x", c:byte())
+		end) .. '"'
+	elseif t == "boolean" then
+		out[#out+1] = tostring(value)
+	else
+		out[#out+1] = "null"
+	end
+end
+
+local function gettime()
+	return rawget(love, "timer") and love.timer.getTime() or os.clock()
+end
+
+local function writeresults(results, outputpath)
+	local out = {}
+	encodejson(results, out)
+	local json = table.concat(out) .. "\n"
+
+	if outputpath then
+		local file, err = io.open(outputpath, "w")
+		if not file then
+			error("Could not open benchmark output file: " .. tostring(err))
+		end
+		file:write(json)
+		file:close()
+	else
+		io.write(json)
+	end
+end
+
+-- Returns a main loop function like love.run's, which stops after the given
+-- number of frames.
+function love.bench.run(frames, dt, outputpath)
+	-- The same random numbers every run, so the game does the same work.
+	math.randomseed(0)
+	if rawget(love, "math") then love.math.setRandomSeed(0) end
+
+	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
+
+	if rawget(love, "timer") then love.timer.step() end
+
+	local frametimes = {}
+	local gputotals = {}
+	local luapeakkb = collectgarbage("count")
+
+	local function finish()
+		local sorted = {}
+		local total = 0
+		for i,t in ipairs(frametimes) do
+			sorted[i] = t * 1000
+			total = total + t * 1000
+		end
+		table.sort(sorted)
+
+		local results = {
+			version = love._version,
+			frames = #frametimes,
+			dt = dt,
+			frametime = {
+				mean = #sorted > 0 and total / #sorted or 0,
+				min = sorted[1] or 0,
+				max = sorted[#sorted] or 0,
+				p50 = percentile(sorted, 0.50),
+				p90 = percentile(sorted, 0.90),
+				p95 = percentile(sorted, 0.95),
+				p99 = percentile(sorted, 0.99),
+			},
+			memory = {
+				luakb = collectgarbage("count"),
+				luapeakkb = luapeakkb,
+				objects = love.getObjectStats and love.getObjectStats() or nil,
+			},
+		}
+
+		if rawget(love, "graphics") and love.graphics.isCreated() then
+			local name, version, vendor, device = love.graphics.getRendererInfo()
+			results.renderer = {name = name, version = version, vendor = vendor, device = device}
+
+			local final = love.graphics.getStats()
+			for i,k in ipairs(perframestats) do
+				final[k] = nil
+			end
+			results.graphics = {totals = gputotals, final = final}
+		end
+
+		writeresults(results, outputpath)
+	end
+
+	return function()
+		local start = gettime()
+
+		if rawget(love, "event") then
+			love.event.pump()
+			for name, a,b,c,d,e,f in love.event.poll() do
+				if name == "quit" then
+					if not love.quit or not love.quit() then
+						finish()
+						return a or 0, b
+					end
+				end
+				love.handlers[name](a,b,c,d,e,f)
+			end
+		end
+
+		-- Keep the timer's own stats going, but always update with a fixed dt.
+		if rawget(love, "timer") then love.timer.step() end
+
+		if love.update then love.update(dt) end
+
+		if rawget(love, "graphics") and love.graphics.isActive() then
+			love.graphics.origin()
+			love.graphics._beginDynamicResolution()
+			love.graphics.clear(love.graphics.getBackgroundColor())
+
+			if love.draw then love.draw() end
+
+			love.graphics._endDynamicResolution()
+
+			local stats = love.graphics.getStats()
+			for i,k in ipairs(perframestats) do
+				gputotals[k] = (gputotals[k] or 0) + (stats[k] or 0)
+			end
+
+			love.graphics.present()
+		end
+
+		frametimes[#frametimes+1] = gettime() - start
+		luapeakkb = math.max(luapeakkb, collectgarbage("count"))
+
+		if #frametimes >= frames then
+			finish()
+			return 0
+		end
+	end
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
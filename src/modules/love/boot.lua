@@ -39,16 +39,85 @@ local no_game_code = false
 local invalid_game_path = nil
 local main_file = "main.lua"
 
+-- love --compileshader path/to/shader.glsl path/to/shader.lshader
+local function compile_shader_bundle(inpath, outpath)
+	if not (inpath and outpath) then
+		error("Usage: love --compileshader path/to/shader.glsl path/to/shader.lshader")
+	end
+
+	require("love.graphics")
+
+	local infile, err = io.open(inpath, "rb")
+	if not infile then
+		error("Could not open shader file: " .. tostring(err))
+	end
+	local code = infile:read("*a")
+	infile:close()
+
+	local bundle = love.graphics.compileShaderBundle(code)
+
+	local outfile
+	outfile, err = io.open(outpath, "wb")
+	if not outfile then
+		error("Could not open output file: " .. tostring(err))
+	end
+	outfile:write(bundle)
+	outfile:close()
+
+	print(string.format("Compiled %s to %s (%d bytes)", inpath, outpath, #bundle))
+end
+
+local function print_startup_report()
+	local stages = love._getStartupStages()
+	if #stages == 0 then return end
+
+	local first, last = stages[1].start, stages[1].start
+	for i,stage in ipairs(stages) do
+		last = math.max(last, stage.start + stage.duration)
+	end
+
+	print(string.format("Startup stages (%.2f ms total):", (last - first) * 1000))
+	print("     start   duration  stage")
+	for i,stage in ipairs(stages) do
+		print(string.format("%10.2f %10.2f  %s%s", (stage.start - first) * 1000, stage.duration * 1000,
+			string.rep("  ", stage.depth), stage.name))
+	end
+end
+
+-- A frame rate cap just below the top of the display's refresh rate range.
+-- Frames finishing faster than the display refreshes either queue up behind
+-- vsync or tear, which takes a variable refresh rate display out of its range.
+local function getvrrframecap()
+	local _, maxrate = love.window.getVariableRefreshRateRange()
+	if not maxrate then
+		local _, _, flags = love.window.getMode()
+		maxrate = flags.refreshrate
+	end
+
+	if not maxrate or maxrate <= 0 then
+		return 0
+	end
+
+	return maxrate - math.max(3, maxrate * 0.02)
+end
+
 -- This can't be overridden.
 function love.boot()
 
+	-- Stages from before a restart aren't part of this startup.
+	love._clearStartupStages()
+
 	-- This is absolutely needed.
+	love._beginStartupStage("filesystem init")
 	require("love.filesystem")
 
 	love.rawGameArguments = arg
 
 	local arg0 = love.arg.getLow(love.rawGameArguments)
 	love.filesystem.init(arg0)
+	love._endStartupStage()
+
+	love._beginStartupStage("game mount")
 
 	local exepath = love.filesystem.getExecutablePath()
 	if #exepath == 0 then
@@ -75,6 +144,12 @@ function love.boot()
 
 	local o = love.arg.options
 
+	-- Command-line tools finish here instead of running a game.
+	if o.compileshader.set then
+		compile_shader_bundle(o.compileshader.arg[1], o.compileshader.arg[2])
+		return true
+	end
+
 	local is_fused_game = can_has_game or love.arg.options.fused.set
 
 	love.filesystem.setFused(is_fused_game)
@@ -134,6 +209,8 @@ function love.boot()
 		no_game_code = true
 	end
 
+	love._endStartupStage()
+
 	if not can_has_game then
         -- when editing this message, change it at love.cpp too
         print([[LÖVE is an *awesome* framework you can use to make 2D games in Lua
@@ -145,6 +222,7 @@ usage:
     love path/to/gamedir            runs the game from the given directory which contains a main.lua file
     love path/to/packagedgame.love  runs the packaged game from the provided .love file
     love path/to/file.lua           runs the game from the given .lua file
+    love --compileshader in out     precompiles the shader code in a file into a bundle for love.graphics.newShader
 ]]);
 		local nogame = require("love.nogame")
 		nogame()
@@ -175,6 +253,10 @@ function love.init()
 			resizable = false,
 			centered = true,
 			usedpiscale = true,
+			hidden = false,
+			framesinflight = 2,
+			lowlatency = false,
+			framecap = 0, -- Frames per second, or "vrr" for just below the display's maximum refresh rate.
 		},
 		modules = {
 			data = true,
@@ -200,6 +282,9 @@ function love.init()
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
 			mic = false, -- Only relevant for Android.
+			frequency = 0, -- Output sample rate, 0 uses the device's default.
+			refresh = 0, -- Device updates per second, 0 uses the device's default.
+			outputmode = "default",
 		},
 		console = false, -- Only relevant for windows.
 		identity = false,
@@ -210,6 +295,9 @@ function love.init()
 		highdpi = false,
 		renderers = nil,
 		excluderenderers = nil,
+		tracestartup = false,
+		headless = false, -- No window, graphics, audio or input, e.g. for dedicated servers.
+		tickrate = 60, -- Updates per second of the main loop in headless mode.
 	}
 
 	-- Console hack, part 1.
@@ -220,6 +308,7 @@ function love.init()
 	end
 
 	-- If config file exists, load it and allow it to update config table.
+	love._beginStartupStage("conf.lua")
 	local confok, conferr
 	if (not love.conf) and love.filesystem and love.filesystem.getInfo("conf.lua") then
 		confok, conferr = pcall(require, "conf")
@@ -232,6 +321,29 @@ function love.init()
 		-- If love.conf errors, we'll trigger the error after loading modules so
 		-- the error message can be displayed in the window.
 	end
+	love._endStartupStage()
+
+	-- Benchmarks shouldn't be limited by the display or get in the way.
+	if love.arg.options.bench.set and c.window then
+		c.window.vsync = 0
+		c.window.hidden = true
+	end
+
+	if love.arg.options.headless.set then
+		c.headless = true
+	end
+
+	-- Headless mode only keeps the modules a server needs, so nothing
+	-- initializes SDL's video subsystem or an audio device.
+	if c.headless then
+		c.window = false
+		for i,v in ipairs{
+			"keyboard", "mouse", "touch", "joystick", "sensor", "image", "graphics",
+			"audio", "sound", "video", "font", "window",
+		} do
+			c.modules[v] = false
+		end
+	end
 
 	-- Console hack, part 2.
 	if c.console and love._openConsole and not openedconsole then
@@ -300,6 +412,25 @@ function love.init()
 		love._requestRecordingPermission(c.audio and c.audio.mic)
 	end
 
+	if love._setAudioDeviceSettings and c.audio then
+		love._setAudioDeviceSettings(c.audio.frequency, c.audio.refresh, c.audio.outputmode)
+	end
+
+	-- Modules which don't depend on the window are created on worker threads
+	-- while the window is set up, and are required once it exists.
+	-- The recording permission request may need the main thread.
+	local preloaded = {}
+	if love._preloadModule then
+		for i,v in ipairs{"audio", "font"} do
+			if c.modules[v] == true and not (v == "audio" and c.audio and c.audio.mic) then
+				preloaded[v] = love._preloadModule(v)
+			end
+		end
+	end
+
+	-- Modules set to "lazy" are only loaded the first time they're used.
+	local lazymodules = {}
+
 	-- Gets desired modules.
 	for k,v in ipairs{
 		"data",
@@ -322,12 +453,29 @@ function love.init()
 		"math",
 		"physics",
 	} do
-		if c.modules[v] then
+		if c.modules[v] == "lazy" then
+			lazymodules[v] = true
+		elseif c.modules[v] and not preloaded[v] then
+			love._beginStartupStage("love." .. v)
 			require("love." .. v)
+			love._endStartupStage()
 		end
 	end
 
-	if love.event then
+	-- From here on, checks for whether a module is loaded use rawget, so they
+	-- don't load lazy modules.
+	if next(lazymodules) then
+		setmetatable(love, {
+			__index = function(t, k)
+				if lazymodules[k] then
+					lazymodules[k] = nil
+					return require("love." .. k)
+				end
+			end,
+		})
+	end
+
+	if rawget(love, "event") then
 		love.createhandlers()
 	end
 
@@ -341,7 +489,7 @@ function love.init()
 
 			print(msg)
 
-			if love.window then
+			if rawget(love, "window") then
 				love.window.showMessageBox("Compatibility Warning", msg, "warning")
 			end
 		end
@@ -353,6 +501,7 @@ function love.init()
 
 	-- Setup window here.
 	if c.window and c.modules.window then
+		love._beginStartupStage("window")
 		love.window.setTitle(c.window.title or c.title)
 		assert(love.window.setMode(c.window.width, c.window.height,
 		{
@@ -372,26 +521,62 @@ function love.init()
 			usedpiscale = c.window.usedpiscale,
 			x = c.window.x,
 			y = c.window.y,
+			hidden = c.window.hidden,
+			framesinflight = c.window.framesinflight,
+			lowlatency = c.window.lowlatency,
 		}), "Could not set window mode")
 		if c.window.icon then
 			assert(love.image, "If an icon is set in love.conf, love.image must be loaded!")
 			love.window.setIcon(love.image.newImageData(c.window.icon))
 		end
+		love._endStartupStage()
+	end
+
+	if c.window and c.window.framecap and c.window.framecap ~= 0 and rawget(love, "timer") then
+		local framecap = c.window.framecap
+		if framecap == "vrr" then
+			framecap = rawget(love, "window") and love.window.isOpen() and getvrrframecap() or 0
+		end
+		love.timer.setTargetFrameRate(tonumber(framecap) or 0)
+	end
+
+	for k,v in ipairs{"audio", "font"} do
+		if preloaded[v] then
+			love._beginStartupStage("love." .. v)
+			require("love." .. v)
+			love._endStartupStage()
+		end
 	end
 
 	-- Our first timestep, because window creation can take some time
-	if love.timer then
+	if rawget(love, "timer") then
 		love.timer.step()
 	end
 
-	if love.filesystem then
+	local defaultrun = love.run
+
+	if rawget(love, "filesystem") then
 		love.filesystem._setAndroidSaveExternal(c.externalstorage)
 		love.filesystem.setIdentity(c.identity or love.filesystem.getIdentity(), c.appendidentity)
 		if love.filesystem.getInfo(main_file) then
+			love._beginStartupStage(main_file)
 			require(main_file:gsub("%.lua$", ""))
+			love._endStartupStage()
 		end
 	end
 
+	if c.tracestartup or love.arg.options.tracestartup.set then
+		-- The default font is otherwise created on first use, so it would
+		-- be missing from the report.
+		if rawget(love, "graphics") and love.graphics.isCreated() then
+			love._beginStartupStage("default font")
+			love.graphics.getFont()
+			love._endStartupStage()
+		end
+
+		print_startup_report()
+	end
+
 	if no_game_code then
 		local opts = love.arg.options
 		local gamepath = opts.game.set and opts.game.arg[1] or ""
@@ -400,6 +585,34 @@ function love.init()
 	elseif invalid_game_path then
 		error("Cannot load game at path '" .. invalid_game_path .. "'.\nMake sure a folder exists at the specified path.")
 	end
+
+	-- Headless mode replaces the default main loop, but not the game's own.
+	if c.headless and love.run == defaultrun and rawget(love, "timer") then
+		local tickrate = tonumber(c.tickrate) or 60
+		if tickrate <= 0 then
+			error("t.tickrate must be greater than 0 in headless mode.")
+		end
+		love.run = function()
+			return love._runHeadless(tickrate)
+		end
+	end
+
+	-- Benchmark mode replaces the main loop, including the game's own.
+	local o = love.arg.options
+	if o.bench.set then
+		local frames = tonumber(o.bench.arg[1])
+		if not frames or frames < 1 then
+			error("--bench needs the number of frames to run.")
+		end
+
+		local dt = o.benchdt.set and tonumber(o.benchdt.arg[1]) or 1/60
+		local outputpath = o.benchoutput.set and o.benchoutput.arg[1] or nil
+
+		require("love.bench")
+		love.run = function()
+			return love.bench.run(frames, dt, outputpath)
+		end
+	end
 end
 
 local print, debug, tostring = print, debug, tostring
@@ -417,6 +630,11 @@ return function()
 	local inerror = false
 
 	local function deferErrhand(...)
+		-- Modules preloaded during a failed love.init are never required.
+		if love._releasePreloadedModules then
+			love._releasePreloadedModules()
+		end
+
 		local errhand = love.errorhandler or love.errhand
 		local handler = (not inerror and errhand) or error_printer
 		inerror = true
@@ -425,8 +643,9 @@ return function()
 
 	local function earlyinit()
 		-- If love.boot fails, return 1 and finish immediately
-		local result = xpcall(love.boot, error_printer)
+		local result, done = xpcall(love.boot, error_printer)
 		if not result then return 1 end
+		if done then return 0 end
 
 		-- If love.init or love.run fails, don't return a value,
 		-- as we want the error handler to take over
@@ -106,6 +106,9 @@ function love.createhandlers()
 		threaderror = function (t, err)
 			if love.threaderror then return love.threaderror(t, err) end
 		end,
+		screenshoterror = function (filename, err)
+			if love.screenshoterror then return love.screenshoterror(filename, err) end
+		end,
 		resize = function (w, h)
 			if love.resize then return love.resize(w, h) end
 		end,
@@ -115,6 +118,9 @@ function love.createhandlers()
 		directorydropped = function (dir)
 			if love.directorydropped then return love.directorydropped(dir) end
 		end,
+		filechanged = function (path, change)
+			if love.filechanged then return love.filechanged(path, change) end
+		end,
 		dropbegan = function ()
 			if love.dropbegan then return love.dropbegan() end
 		end,
@@ -140,6 +146,9 @@ function love.createhandlers()
 		sensorupdated = function (sensorType, x, y, z)
 			if love.sensorupdated then return love.sensorupdated(sensorType, x, y, z) end
 		end,
+		hitch = function (frametime, events, update, draw, present)
+			if love.hitch then return love.hitch(frametime, events, update, draw, present) end
+		end,
 	}, {
 		__index = function(self, name)
 			error("Unknown event: " .. name)
@@ -156,12 +165,14 @@ function love.run()
 	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
 
 	-- We don't want the first frame's dt to include time taken by love.load.
-	if love.timer then love.timer.step() end
+	if rawget(love, "timer") then love.timer.step() end
 
 	-- Main loop time.
 	return function()
+		if rawget(love, "timer") then love.timer.beginPhase("events") end
+
 		-- Process events.
-		if love.event then
+		if rawget(love, "event") then
 			love.event.pump()
 			for name, a,b,c,d,e,f in love.event.poll() do
 				if name == "quit" then
@@ -174,21 +185,69 @@ function love.run()
 		end
 
 		-- Update dt, as we'll be passing it to update
-		local dt = love.timer and love.timer.step() or 0
+		local dt = rawget(love, "timer") and love.timer.step() or 0
 
 		-- Call update and draw
+		if rawget(love, "timer") then love.timer.beginPhase("update") end
 		if love.update then love.update(dt) end -- will pass 0 if love.timer is disabled
 
-		if love.graphics and love.graphics.isActive() then
+		if rawget(love, "graphics") and love.graphics.isActive() then
+			if rawget(love, "timer") then love.timer.beginPhase("draw") end
+
 			love.graphics.origin()
+			love.graphics._beginDynamicResolution()
 			love.graphics.clear(love.graphics.getBackgroundColor())
 
 			if love.draw then love.draw() end
 
+			love.graphics._endDynamicResolution()
+
+			if rawget(love, "timer") then love.timer.beginPhase("present") end
 			love.graphics.present()
 		end
 
-		if love.timer then love.timer.sleep(0.001) end
+		if rawget(love, "timer") then love.timer.pace() end
+	end
+end
+
+-- Main loop for headless mode: love.update is called tickrate times per
+-- second with a fixed dt, and the loop sleeps between ticks. If ticks fall
+-- behind, a few are run back to back before the backlog is dropped.
+function love._runHeadless(tickrate)
+	if love.load then love.load(love.parsedGameArguments, love.rawGameArguments) end
+
+	local timer = love.timer
+	local tickdt = 1 / tickrate
+	local nexttick = timer.getTime()
+	local maxcatchup = 5
+
+	return function()
+		if rawget(love, "event") then
+			love.event.pump()
+			for name, a,b,c,d,e,f in love.event.poll() do
+				if name == "quit" then
+					if not love.quit or not love.quit() then
+						return a or 0, b
+					end
+				end
+				love.handlers[name](a,b,c,d,e,f)
+			end
+		end
+
+		local ticks = 0
+		while timer.getTime() >= nexttick and ticks < maxcatchup do
+			timer.step()
+			if love.update then love.update(tickdt) end
+			nexttick = nexttick + tickdt
+			ticks = ticks + 1
+		end
+
+		local now = timer.getTime()
+		if now >= nexttick then
+			nexttick = now + tickdt
+		end
+
+		timer.sleepUntil(nexttick)
 	end
 end
 
@@ -198,6 +257,10 @@ function love.threaderror(t, err)
 	error("Thread error ("..tostring(t)..")\n\n"..err, 0)
 end
 
+function love.screenshoterror(filename, err)
+	error("Could not save screenshot "..filename..": "..err, 0)
+end
+
 local utf8 = require("utf8")
 
 local function error_printer(msg, layer)
@@ -209,7 +272,7 @@ function love.errhand(msg)
 
 	error_printer(msg, 2)
 
-	if not love.window or not love.graphics or not love.event then
+	if not rawget(love, "window") or not rawget(love, "graphics") or not rawget(love, "event") then
 		return
 	end
 
@@ -221,7 +284,7 @@ function love.errhand(msg)
 	end
 
 	-- Reset state.
-	if love.mouse then
+	if rawget(love, "mouse") then
 		love.mouse.setVisible(true)
 		love.mouse.setGrabbed(false)
 		love.mouse.setRelativeMode(false)
@@ -229,13 +292,13 @@ function love.errhand(msg)
 			love.mouse.setCursor()
 		end
 	end
-	if love.joystick then
+	if rawget(love, "joystick") then
 		-- Stop all joystick vibrations.
 		for i,v in ipairs(love.joystick.getJoysticks()) do
 			v:setVibration()
 		end
 	end
-	if love.audio then love.audio.stop() end
+	if rawget(love, "audio") then love.audio.stop() end
 
 	love.graphics.reset()
 	local font = love.graphics.newFont(14)
@@ -286,12 +349,12 @@ function love.errhand(msg)
 
 	local fullErrorText = p
 	local function copyToClipboard()
-		if not love.system then return end
+		if not rawget(love, "system") then return end
 		love.system.setClipboardText(fullErrorText)
 		p = p .. "\nCopied to clipboard!"
 	end
 
-	if love.system then
+	if rawget(love, "system") then
 		p = p .. "\n\nPress Ctrl+C or tap to copy this error"
 	end
 
@@ -309,7 +372,7 @@ function love.errhand(msg)
 				local name = love.window.getTitle()
 				if #name == 0 or name == "Untitled" then name = "Game" end
 				local buttons = {"OK", "Cancel"}
-				if love.system then
+				if rawget(love, "system") then
 					buttons[3] = "Copy to clipboard"
 				end
 				local pressed = love.window.showMessageBox("Quit "..name.."?", "", buttons)
@@ -323,7 +386,7 @@ function love.errhand(msg)
 
 		draw()
 
-		if love.timer then
+		if rawget(love, "timer") then
 			love.timer.sleep(0.1)
 		end
 	end
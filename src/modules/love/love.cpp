@@ -23,6 +23,7 @@
 #include "common/version.h"
 #include "common/deprecation.h"
 #include "common/runtime.h"
+#include "common/Trace.h"
 #include "modules/window/Window.h"
 
 #include "love.h"
@@ -30,6 +31,9 @@
 // C++
 #include <string>
 #include <sstream>
+#include <vector>
+#include <map>
+#include <cstring>
 
 #ifdef LOVE_WINDOWS
 #include <windows.h>
@@ -65,9 +69,16 @@ extern "C"
 #	include "libraries/lua53/lutf8lib.h"
 #endif
 
-// For love::graphics::setGammaCorrect.
+// For love::graphics::setGammaCorrect, and love.translateOrigin.
 #ifdef LOVE_ENABLE_GRAPHICS
 #	include "graphics/Graphics.h"
+#	include "graphics/ParticleSystem.h"
+#	include "graphics/SpriteBatch.h"
+#endif
+
+// For love.translateOrigin.
+#ifdef LOVE_ENABLE_PHYSICS
+#	include "physics/box2d/World.h"
 #endif
 
 // For love::window::setHighDPIAllowed
@@ -75,9 +86,14 @@ extern "C"
 #	include "window/Window.h"
 #endif
 
-// For love::audio::Audio::setMixWithSystem.
+// For love::audio::Audio::setMixWithSystem and love::audio::preloadModule.
 #ifdef LOVE_ENABLE_AUDIO
-#	include "audio/Audio.h"
+#	include "audio/wrap_Audio.h"
+#endif
+
+// For love::font::preloadModule.
+#ifdef LOVE_ENABLE_FONT
+#	include "font/wrap_Font.h"
 #endif
 
 // For love::system::System::getOS.
@@ -97,6 +113,10 @@ static const char callbacks_lua[] =
 #include "callbacks.lua"
 ;
 
+static const char bench_lua[] =
+#include "bench.lua"
+;
+
 static const char boot_lua[] =
 #include "boot.lua"
 ;
@@ -174,6 +194,7 @@ extern "C"
 	extern int luaopen_love_jitsetup(lua_State*);
 	extern int luaopen_love_arg(lua_State*);
 	extern int luaopen_love_callbacks(lua_State*);
+	extern int luaopen_love_bench(lua_State*);
 	extern int luaopen_love_boot(lua_State*);
 
 #ifdef LOVE_ENABLE_LUAHTTPS
@@ -246,6 +267,7 @@ static const luaL_Reg modules[] = {
 	{ "love.jitsetup", luaopen_love_jitsetup },
 	{ "love.arg", luaopen_love_arg },
 	{ "love.callbacks", luaopen_love_callbacks },
+	{ "love.bench", luaopen_love_bench },
 	{ "love.boot", luaopen_love_boot },
 	{ 0, 0 }
 };
@@ -357,6 +379,127 @@ static int w_love_isVersionCompatible(lua_State *L)
 	return 1;
 }
 
+static int w_love_getObjectStats(lua_State *L)
+{
+	const char *groupby = luaL_optstring(L, 1, "type");
+	bool bymodule = strcmp(groupby, "module") == 0;
+	if (!bymodule && strcmp(groupby, "type") != 0)
+		return luaL_error(L, "Invalid object stats grouping '%s', expected 'type' or 'module'.", groupby);
+
+	std::vector<love::Type *> types;
+	love::Type::getTypes(types);
+
+	// Live object count and bytes per group.
+	std::map<std::string, std::pair<love::int64, love::int64>> groups;
+
+	for (love::Type *type : types)
+	{
+		love::int64 count = type->getObjectCount();
+		if (count == 0)
+			continue;
+
+		const char *key = type->getName();
+		if (bymodule)
+			key = type->getModuleName() != nullptr ? type->getModuleName() : "unknown";
+
+		auto &group = groups[key];
+		group.first += count;
+		group.second += type->getObjectBytes();
+	}
+
+	lua_createtable(L, 0, (int) groups.size());
+
+	for (const auto &kvp : groups)
+	{
+		lua_createtable(L, 0, 2);
+		lua_pushnumber(L, (lua_Number) kvp.second.first);
+		lua_setfield(L, -2, "count");
+		lua_pushnumber(L, (lua_Number) kvp.second.second);
+		lua_setfield(L, -2, "bytes");
+		lua_setfield(L, -2, kvp.first.c_str());
+	}
+
+	return 1;
+}
+
+// Moves the origin of the audio listener and Sources and of the given
+// Worlds, ParticleSystems and SpriteBatches to (x, y) in one call.
+static int w_love_translateOrigin(lua_State *L)
+{
+	float x = (float) luaL_checknumber(L, 1);
+	float y = (float) luaL_checknumber(L, 2);
+
+#ifdef LOVE_ENABLE_PHYSICS
+	std::vector<love::physics::box2d::World *> worlds;
+#endif
+#ifdef LOVE_ENABLE_GRAPHICS
+	std::vector<love::graphics::ParticleSystem *> particlesystems;
+	std::vector<love::graphics::SpriteBatch *> spritebatches;
+#endif
+
+	// Check every object before moving any of them.
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		int count = (int) love::luax_objlen(L, 3);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			bool known = false;
+
+#ifdef LOVE_ENABLE_PHYSICS
+			if (love::luax_istype(L, -1, love::physics::box2d::World::type))
+			{
+				worlds.push_back(love::luax_totype<love::physics::box2d::World>(L, -1));
+				known = true;
+			}
+#endif
+#ifdef LOVE_ENABLE_GRAPHICS
+			if (love::luax_istype(L, -1, love::graphics::ParticleSystem::type))
+			{
+				particlesystems.push_back(love::luax_totype<love::graphics::ParticleSystem>(L, -1));
+				known = true;
+			}
+			else if (love::luax_istype(L, -1, love::graphics::SpriteBatch::type))
+			{
+				spritebatches.push_back(love::luax_totype<love::graphics::SpriteBatch>(L, -1));
+				known = true;
+			}
+#endif
+
+			if (!known)
+				return luaL_error(L, "Expected a World, ParticleSystem or SpriteBatch at index %d.", i);
+
+			lua_pop(L, 1);
+		}
+	}
+
+	love::luax_catchexcept(L, [&]()
+	{
+#ifdef LOVE_ENABLE_PHYSICS
+		for (auto world : worlds)
+			world->translateOrigin(x, y);
+#endif
+#ifdef LOVE_ENABLE_GRAPHICS
+		for (auto ps : particlesystems)
+			ps->translateOrigin(x, y);
+		for (auto sb : spritebatches)
+			sb->translateOrigin(x, y);
+#endif
+#ifdef LOVE_ENABLE_AUDIO
+		auto audio = love::Module::getInstance<love::audio::Audio>(love::Module::M_AUDIO);
+		if (audio != nullptr)
+		{
+			float v[3] = {x, y, 0.0f};
+			audio->translateOrigin(v);
+		}
+#endif
+	});
+
+	return 0;
+}
+
 static int w__setGammaCorrect(lua_State *L)
 {
 #ifdef LOVE_ENABLE_GRAPHICS
@@ -463,6 +606,104 @@ static int w__requestRecordingPermission(lua_State *L)
 	return 0;
 }
 
+static int w__setAudioDeviceSettings(lua_State *L)
+{
+#ifdef LOVE_ENABLE_AUDIO
+	love::audio::DeviceSettings settings;
+	settings.frequency = (int) luaL_optinteger(L, 1, 0);
+	settings.refresh = (int) luaL_optinteger(L, 2, 0);
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *modestr = luaL_checkstring(L, 3);
+		if (!love::audio::Audio::getConstant(modestr, settings.outputMode))
+			return love::luax_enumerror(L, "audio output mode", love::audio::Audio::getConstants(settings.outputMode), modestr);
+	}
+
+	love::audio::setDeviceSettings(settings);
+#endif
+	return 0;
+}
+
+static int w__preloadModule(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	bool started = false;
+
+#ifdef LOVE_ENABLE_AUDIO
+	if (strcmp(name, "audio") == 0)
+	{
+		love::audio::preloadModule();
+		started = true;
+	}
+#endif
+#ifdef LOVE_ENABLE_FONT
+	if (strcmp(name, "font") == 0)
+	{
+		love::font::preloadModule();
+		started = true;
+	}
+#endif
+
+	love::luax_pushboolean(L, started);
+	return 1;
+}
+
+static int w__releasePreloadedModules(lua_State *)
+{
+	love::Module::releasePreloadedInstances();
+	return 0;
+}
+
+static int w__beginStartupStage(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	love::trace::beginStartupStage(love::trace::internName(name));
+	return 0;
+}
+
+static int w__endStartupStage(lua_State *)
+{
+	love::trace::endStartupStage();
+	return 0;
+}
+
+static int w__clearStartupStages(lua_State *)
+{
+	love::trace::clearStartupStages();
+	return 0;
+}
+
+static int w__getStartupStages(lua_State *L)
+{
+	std::vector<love::trace::StartupStage> stages = love::trace::getStartupStages();
+
+	lua_createtable(L, (int) stages.size(), 0);
+
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		const love::trace::StartupStage &stage = stages[i];
+
+		lua_createtable(L, 0, 4);
+
+		lua_pushstring(L, stage.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushnumber(L, (double) stage.start / 1e9);
+		lua_setfield(L, -2, "start");
+
+		lua_pushnumber(L, (double) (stage.end - stage.start) / 1e9);
+		lua_setfield(L, -2, "duration");
+
+		lua_pushinteger(L, stage.depth);
+		lua_setfield(L, -2, "depth");
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
 static int w_love_markDeprecated(lua_State *L)
 {
 	int level = (int)luaL_checkinteger(L, 1);
@@ -587,6 +828,23 @@ int luaopen_love(lua_State *L)
 	lua_setfield(L, -2, "_setAudioMixWithSystem");
 	lua_pushcfunction(L, w__requestRecordingPermission);
 	lua_setfield(L, -2, "_requestRecordingPermission");
+	lua_pushcfunction(L, w__setAudioDeviceSettings);
+	lua_setfield(L, -2, "_setAudioDeviceSettings");
+
+	lua_pushcfunction(L, w__preloadModule);
+	lua_setfield(L, -2, "_preloadModule");
+
+	lua_pushcfunction(L, w__releasePreloadedModules);
+	lua_setfield(L, -2, "_releasePreloadedModules");
+
+	lua_pushcfunction(L, w__beginStartupStage);
+	lua_setfield(L, -2, "_beginStartupStage");
+	lua_pushcfunction(L, w__endStartupStage);
+	lua_setfield(L, -2, "_endStartupStage");
+	lua_pushcfunction(L, w__getStartupStages);
+	lua_setfield(L, -2, "_getStartupStages");
+	lua_pushcfunction(L, w__clearStartupStages);
+	lua_setfield(L, -2, "_clearStartupStages");
 
 	lua_newtable(L);
 
@@ -604,6 +862,12 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w_love_isVersionCompatible);
 	lua_setfield(L, -2, "isVersionCompatible");
 
+	lua_pushcfunction(L, w_love_getObjectStats);
+	lua_setfield(L, -2, "getObjectStats");
+
+	lua_pushcfunction(L, w_love_translateOrigin);
+	lua_setfield(L, -2, "translateOrigin");
+
 #ifdef LOVE_ENABLE_SYSTEM
 	lua_pushstring(L, love::system::System::getOS());
 #else
@@ -818,6 +1082,14 @@ int luaopen_love_callbacks(lua_State *L)
 	return 1;
 }
 
+int luaopen_love_bench(lua_State *L)
+{
+	if (luaL_loadbuffer(L, bench_lua, sizeof(bench_lua), "=[love \"bench.lua\"]") == 0)
+		lua_call(L, 0, 1);
+
+	return 1;
+}
+
 int luaopen_love_boot(lua_State *L)
 {
 	if (luaL_loadbuffer(L, boot_lua, sizeof(boot_lua), "=[love \"boot.lua\"]") == 0)
@@ -79,6 +79,70 @@ void subdivide(vector<love::Vector2> &points, int k)
 		points[i-1 + left.size() - 1] = right[right.size() - i - 1];
 }
 
+/**
+ * Squared distance of point p from the segment ab.
+ **/
+float distanceToSegment2(const love::Vector2 &p, const love::Vector2 &a, const love::Vector2 &b)
+{
+	love::Vector2 ab = b - a;
+	love::Vector2 ap = p - a;
+	float len2 = ab.x * ab.x + ab.y * ab.y;
+	float t = len2 > 0.0f ? std::min(std::max((ap.x * ab.x + ap.y * ab.y) / len2, 0.0f), 1.0f) : 0.0f;
+	love::Vector2 d = ap - ab * t;
+	return d.x * d.x + d.y * d.y;
+}
+
+/**
+ * Appends the flattened curve with the given control points, excluding its
+ * first point, along with the curve parameter of each point. The curve is
+ * the part of the original curve between t0 and t1.
+ **/
+void flatten_adaptive(const vector<love::Vector2> &points, double t0, double t1, double tolerance2, int depth, vector<love::Vector2> &out, vector<double> &params)
+{
+	// The curve lies within the convex hull of its control points, so it's
+	// flat enough when the inner control points are close to the chord.
+	bool flat = depth >= 16;
+	if (!flat)
+	{
+		flat = true;
+		for (size_t i = 1; i + 1 < points.size(); ++i)
+		{
+			if (distanceToSegment2(points[i], points.front(), points.back()) > tolerance2)
+			{
+				flat = false;
+				break;
+			}
+		}
+	}
+
+	if (flat)
+	{
+		out.push_back(points.back());
+		params.push_back(t1);
+		return;
+	}
+
+	// Split in half using de casteljau, as in subdivide().
+	vector<love::Vector2> work(points), left, right;
+	left.reserve(points.size());
+	right.reserve(points.size());
+
+	for (size_t step = 1; step < work.size(); ++step)
+	{
+		left.push_back(work[0]);
+		right.push_back(work[work.size() - step]);
+		for (size_t i = 0; i < work.size() - step; ++i)
+			work[i] = (work[i] + work[i+1]) * .5;
+	}
+	left.push_back(work[0]);
+	right.push_back(work[0]);
+	std::reverse(right.begin(), right.end());
+
+	double tm = (t0 + t1) * 0.5;
+	flatten_adaptive(left, t0, tm, tolerance2, depth + 1, out, params);
+	flatten_adaptive(right, tm, t1, tolerance2, depth + 1, out, params);
+}
+
 }
 
 namespace love
@@ -90,7 +154,15 @@ love::Type BezierCurve::type("BezierCurve", &Object::type);
 
 BezierCurve::BezierCurve(const vector<Vector2> &pts)
 	: controlPoints(pts)
+	, renderAccuracy(-1)
+	, flatTolerance(-1.0)
+{
+}
+
+void BezierCurve::invalidate()
 {
+	renderAccuracy = -1;
+	flatTolerance = -1.0;
 }
 
 
@@ -134,6 +206,8 @@ void BezierCurve::setControlPoint(int i, const Vector2 &point)
 		i -= controlPoints.size();
 
 	controlPoints[i] = point;
+
+	invalidate();
 }
 
 void BezierCurve::insertControlPoint(const Vector2 &point, int i)
@@ -148,6 +222,8 @@ void BezierCurve::insertControlPoint(const Vector2 &point, int i)
 		i -= controlPoints.size();
 
 	controlPoints.insert(controlPoints.begin() + i, point);
+
+	invalidate();
 }
 
 void BezierCurve::removeControlPoint(int i)
@@ -162,12 +238,16 @@ void BezierCurve::removeControlPoint(int i)
 		i -= controlPoints.size();
 
 	controlPoints.erase(controlPoints.begin() + i);
+
+	invalidate();
 }
 
 void BezierCurve::translate(const Vector2 &t)
 {
 	for (size_t i = 0; i < controlPoints.size(); ++i)
 		controlPoints[i] += t;
+
+	invalidate();
 }
 
 void BezierCurve::rotate(double phi, const Vector2 &center)
@@ -179,12 +259,16 @@ void BezierCurve::rotate(double phi, const Vector2 &center)
 		controlPoints[i].x = c * v.x - s * v.y + center.x;
 		controlPoints[i].y = s * v.x + c * v.y + center.y;
 	}
+
+	invalidate();
 }
 
 void BezierCurve::scale(double s, const Vector2 &center)
 {
 	for (size_t i = 0; i < controlPoints.size(); ++i)
 		controlPoints[i] = (controlPoints[i] - center) * s + center;
+
+	invalidate();
 }
 
 Vector2 BezierCurve::evaluate(double t) const
@@ -241,13 +325,19 @@ BezierCurve* BezierCurve::getSegment(double t1, double t2) const
 	return new BezierCurve(right);
 }
 
-vector<Vector2> BezierCurve::render(int accuracy) const
+const vector<Vector2> &BezierCurve::render(int accuracy) const
 {
 	if (controlPoints.size() < 2)
 		throw Exception("Invalid Bezier curve: Not enough control points.");
-	vector<Vector2> vertices(controlPoints);
-	subdivide(vertices, accuracy);
-	return vertices;
+
+	if (accuracy != renderAccuracy)
+	{
+		renderPoints = controlPoints;
+		subdivide(renderPoints, accuracy);
+		renderAccuracy = accuracy;
+	}
+
+	return renderPoints;
 }
 
 vector<Vector2> BezierCurve::renderSegment(double start, double end, int accuracy) const
@@ -275,5 +365,69 @@ vector<Vector2> BezierCurve::renderSegment(double start, double end, int accurac
 	return vertices;
 }
 
+const vector<Vector2> &BezierCurve::flatten(double tolerance) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+	if (!(tolerance > 0.0))
+		throw Exception("Invalid flattening tolerance: must be greater than 0");
+
+	if (tolerance == flatTolerance)
+		return flatPoints;
+
+	flatPoints.clear();
+	flatParameters.clear();
+	flatLengths.clear();
+
+	flatPoints.push_back(controlPoints.front());
+	flatParameters.push_back(0.0);
+	flatten_adaptive(controlPoints, 0.0, 1.0, tolerance * tolerance, 0, flatPoints, flatParameters);
+
+	flatLengths.reserve(flatPoints.size());
+	flatLengths.push_back(0.0);
+	for (size_t i = 1; i < flatPoints.size(); i++)
+		flatLengths.push_back(flatLengths.back() + (flatPoints[i] - flatPoints[i - 1]).getLength());
+
+	flatTolerance = tolerance;
+	return flatPoints;
+}
+
+double BezierCurve::getLength(double tolerance) const
+{
+	flatten(tolerance);
+	return flatLengths.back();
+}
+
+size_t BezierCurve::findDistance(double distance, double tolerance, double &fraction) const
+{
+	flatten(tolerance);
+
+	double length = flatLengths.back();
+	distance = std::min(std::max(distance, 0.0), length);
+
+	// First table entry past the distance; the segment ends there.
+	size_t i = std::upper_bound(flatLengths.begin(), flatLengths.end(), distance) - flatLengths.begin();
+	i = std::min(std::max(i, (size_t) 1), flatLengths.size() - 1);
+
+	double seglength = flatLengths[i] - flatLengths[i - 1];
+	fraction = seglength > 0.0 ? (distance - flatLengths[i - 1]) / seglength : 0.0;
+
+	return i - 1;
+}
+
+double BezierCurve::getParameterAtDistance(double distance, double tolerance) const
+{
+	double fraction = 0.0;
+	size_t i = findDistance(distance, tolerance, fraction);
+	return flatParameters[i] + (flatParameters[i + 1] - flatParameters[i]) * fraction;
+}
+
+Vector2 BezierCurve::evaluateAtDistance(double distance, double tolerance) const
+{
+	double fraction = 0.0;
+	size_t i = findDistance(distance, tolerance, fraction);
+	return flatPoints[i] + (flatPoints[i + 1] - flatPoints[i]) * fraction;
+}
+
 } // namespace math
 } // namespace love
@@ -129,7 +129,7 @@ public:
 	 * @param accuracy The 'fineness' of the curve.
 	 * @returns A polygon chain that approximates the bezier curve.
 	 **/
-	std::vector<Vector2> render(int accuracy = 4) const;
+	const std::vector<Vector2> &render(int accuracy = 4) const;
 
 	/**
 	 * Renders a segment of the curve by subdivision.
@@ -140,8 +140,50 @@ public:
 	 **/
 	std::vector<Vector2> renderSegment(double start, double end, int accuracy = 4) const;
 
+	/**
+	 * Flattens the curve by adaptive subdivision: segments are split until
+	 * their control polygon is within the tolerance of a straight line. The
+	 * result is cached until the control points or the tolerance change.
+	 * @param tolerance Maximum distance between the curve and the polyline.
+	 * @returns A polygon chain that approximates the bezier curve.
+	 **/
+	const std::vector<Vector2> &flatten(double tolerance) const;
+
+	/**
+	 * Gets the length of the curve, measured along its flattened polyline.
+	 **/
+	double getLength(double tolerance) const;
+
+	/**
+	 * Gets the curve parameter at a distance along the curve, using the arc
+	 * length table of the flattened polyline. Distances are clamped to
+	 * [0, length].
+	 **/
+	double getParameterAtDistance(double distance, double tolerance) const;
+
+	/**
+	 * Gets the point at a distance along the flattened curve.
+	 **/
+	Vector2 evaluateAtDistance(double distance, double tolerance) const;
+
 private:
+
+	void invalidate();
+
+	// Index of the polyline segment containing a distance, and the fraction
+	// along it.
+	size_t findDistance(double distance, double tolerance, double &fraction) const;
+
 	std::vector<Vector2> controlPoints;
+
+	// Caches, rebuilt on demand after the control points change.
+	mutable std::vector<Vector2> renderPoints;
+	mutable int renderAccuracy;
+
+	mutable std::vector<Vector2> flatPoints;
+	mutable std::vector<double> flatParameters;
+	mutable std::vector<double> flatLengths;
+	mutable double flatTolerance;
 };
 
 }
@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FloatArray.h"
+#include "common/Exception.h"
+#include "common/Vector.h"
+#include "data/ByteData.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace math
+{
+
+// The loops below are kept simple so the compiler can vectorize them.
+template <typename Op>
+static void applyBinary(float *a, size_t count, const FloatArray::Operand &b, Op op)
+{
+	if (b.values != nullptr)
+	{
+		const float *bv = b.values;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bv[i]);
+	}
+	else
+	{
+		float bs = b.scalar;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bs);
+	}
+}
+
+template <typename Op>
+static void applyTernary(float *a, size_t count, const FloatArray::Operand &b, const FloatArray::Operand &c, Op op)
+{
+	if (b.values != nullptr && c.values != nullptr)
+	{
+		const float *bv = b.values;
+		const float *cv = c.values;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bv[i], cv[i]);
+	}
+	else if (b.values != nullptr)
+	{
+		const float *bv = b.values;
+		float cs = c.scalar;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bv[i], cs);
+	}
+	else if (c.values != nullptr)
+	{
+		float bs = b.scalar;
+		const float *cv = c.values;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bs, cv[i]);
+	}
+	else
+	{
+		float bs = b.scalar;
+		float cs = c.scalar;
+		for (size_t i = 0; i < count; i++)
+			a[i] = op(a[i], bs, cs);
+	}
+}
+
+love::Type FloatArray::type("FloatArray", &Data::type);
+
+FloatArray::FloatArray(size_t count)
+	: values(nullptr)
+	, count(count)
+{
+	data.set(new love::data::ByteData(count * sizeof(float)), Acquire::NORETAIN);
+	values = (float *) data->getData();
+}
+
+FloatArray::FloatArray(love::Data *data, size_t offset, size_t count)
+	: data(data)
+	, values(nullptr)
+	, count(count)
+{
+	if (offset > data->getSize() || count > (data->getSize() - offset) / sizeof(float))
+		throw love::Exception("The FloatArray doesn't fit in the given Data.");
+
+	if (((uintptr_t) data->getData() + offset) % alignof(float) != 0)
+		throw love::Exception("FloatArray offset must be aligned to 4 bytes.");
+
+	values = (float *) ((char *) data->getData() + offset);
+}
+
+FloatArray::~FloatArray()
+{
+}
+
+FloatArray *FloatArray::clone() const
+{
+	FloatArray *c = new FloatArray(count);
+	std::copy(values, values + count, c->values);
+	return c;
+}
+
+void *FloatArray::getData() const
+{
+	return values;
+}
+
+size_t FloatArray::getSize() const
+{
+	return count * sizeof(float);
+}
+
+void FloatArray::checkOperand(const Operand &op) const
+{
+	if (op.values != nullptr && op.count < count)
+		throw love::Exception("FloatArray operand is too small (%d values, %d needed).", (int) op.count, (int) count);
+}
+
+void FloatArray::checkComponents(int components) const
+{
+	if (components < 1)
+		throw love::Exception("Invalid component count: %d", components);
+	if (count % components != 0)
+		throw love::Exception("FloatArray length (%d) is not a multiple of the component count (%d).", (int) count, components);
+}
+
+void FloatArray::fill(float value)
+{
+	std::fill(values, values + count, value);
+}
+
+void FloatArray::add(const Operand &b)
+{
+	checkOperand(b);
+	applyBinary(values, count, b, [](float a, float b) { return a + b; });
+}
+
+void FloatArray::subtract(const Operand &b)
+{
+	checkOperand(b);
+	applyBinary(values, count, b, [](float a, float b) { return a - b; });
+}
+
+void FloatArray::multiply(const Operand &b)
+{
+	checkOperand(b);
+	applyBinary(values, count, b, [](float a, float b) { return a * b; });
+}
+
+void FloatArray::divide(const Operand &b)
+{
+	checkOperand(b);
+	applyBinary(values, count, b, [](float a, float b) { return a / b; });
+}
+
+void FloatArray::multiplyAdd(const Operand &b, const Operand &c)
+{
+	checkOperand(b);
+	checkOperand(c);
+	applyTernary(values, count, b, c, [](float a, float b, float c) { return a * b + c; });
+}
+
+void FloatArray::lerp(const Operand &b, const Operand &t)
+{
+	checkOperand(b);
+	checkOperand(t);
+	applyTernary(values, count, b, t, [](float a, float b, float t) { return a + (b - a) * t; });
+}
+
+void FloatArray::clamp(const Operand &min, const Operand &max)
+{
+	checkOperand(min);
+	checkOperand(max);
+	applyTernary(values, count, min, max, [](float a, float lo, float hi) { return std::min(std::max(a, lo), hi); });
+}
+
+void FloatArray::length(int components, FloatArray *dst) const
+{
+	checkComponents(components);
+
+	size_t vectors = count / components;
+	if (dst->count < vectors)
+		throw love::Exception("The destination FloatArray must hold at least %d values.", (int) vectors);
+
+	const float *src = values;
+	float *out = dst->values;
+
+	if (components == 2)
+	{
+		for (size_t i = 0; i < vectors; i++)
+			out[i] = sqrtf(src[i*2+0] * src[i*2+0] + src[i*2+1] * src[i*2+1]);
+	}
+	else
+	{
+		for (size_t i = 0; i < vectors; i++)
+		{
+			float sum = 0.0f;
+			for (int c = 0; c < components; c++)
+				sum += src[i * components + c] * src[i * components + c];
+			out[i] = sqrtf(sum);
+		}
+	}
+}
+
+void FloatArray::normalize(int components)
+{
+	checkComponents(components);
+
+	size_t vectors = count / components;
+	float *v = values;
+
+	for (size_t i = 0; i < vectors; i++)
+	{
+		float *vec = v + i * components;
+
+		float sum = 0.0f;
+		for (int c = 0; c < components; c++)
+			sum += vec[c] * vec[c];
+
+		if (sum > 0.0f)
+		{
+			float invlen = 1.0f / sqrtf(sum);
+			for (int c = 0; c < components; c++)
+				vec[c] *= invlen;
+		}
+	}
+}
+
+void FloatArray::transform(const Matrix4 &m, int components)
+{
+	if (components != 2 && components != 3)
+		throw love::Exception("FloatArray transforms need 2 or 3 components per vector.");
+
+	checkComponents(components);
+
+	int vectors = (int) (count / components);
+
+	if (components == 2)
+	{
+		Vector2 *v = (Vector2 *) values;
+		m.transformXY(v, v, vectors);
+	}
+	else
+	{
+		Vector3 *v = (Vector3 *) values;
+		m.transformXYZ(v, v, vectors);
+	}
+}
+
+} // math
+} // love
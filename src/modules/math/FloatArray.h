@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Data.h"
+#include "common/Matrix.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace math
+{
+
+/**
+ * A fixed-size array of 32 bit floats with elementwise math operations. The
+ * floats live in a Data object, which may be shared with other code.
+ **/
+class FloatArray : public love::Data
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * One side of an elementwise operation: either an array with at least
+	 * as many values as the destination, or a single value used for every
+	 * element.
+	 **/
+	struct Operand
+	{
+		const float *values = nullptr;
+		size_t count = 0;
+		float scalar = 0.0f;
+
+		Operand(float scalar) : scalar(scalar) {}
+		Operand(const FloatArray *array) : values(array->getFloats()), count(array->getCount()) {}
+	};
+
+	FloatArray(size_t count);
+
+	/**
+	 * Uses the memory of an existing Data object, without copying it.
+	 **/
+	FloatArray(love::Data *data, size_t offset, size_t count);
+
+	virtual ~FloatArray();
+
+	// Implements Data.
+	FloatArray *clone() const override;
+	void *getData() const override;
+	size_t getSize() const override;
+
+	float *getFloats() const { return values; }
+	size_t getCount() const { return count; }
+
+	void fill(float value);
+
+	// All operations write to this array: a = a op b.
+	void add(const Operand &b);
+	void subtract(const Operand &b);
+	void multiply(const Operand &b);
+	void divide(const Operand &b);
+
+	// a = a * b + c
+	void multiplyAdd(const Operand &b, const Operand &c);
+
+	// a = a + (b - a) * t
+	void lerp(const Operand &b, const Operand &t);
+
+	void clamp(const Operand &min, const Operand &max);
+
+	/**
+	 * Treats the array as vectors with the given number of components, and
+	 * writes the length of each vector to dst.
+	 **/
+	void length(int components, FloatArray *dst) const;
+
+	/**
+	 * Treats the array as vectors with the given number of components, and
+	 * scales each to unit length. Zero-length vectors are left untouched.
+	 **/
+	void normalize(int components);
+
+	/**
+	 * Transforms the array as 2 or 3 component vectors by a matrix.
+	 **/
+	void transform(const Matrix4 &m, int components);
+
+private:
+
+	void checkOperand(const Operand &op) const;
+	void checkComponents(int components) const;
+
+	StrongRef<love::Data> data;
+	float *values;
+	size_t count;
+
+}; // FloatArray
+
+} // math
+} // love
@@ -25,129 +25,791 @@
 #include "common/StringMap.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "FloatArray.h"
+#include "thread/JobSystem.h"
 
 // STL
 #include <cmath>
-#include <list>
+#include <algorithm>
+#include <deque>
+#include <limits>
 #include <iostream>
 
 // C
 #include <time.h>
 
-using std::list;
 using love::Vector2;
+using love::int32;
+using love::uint32;
 
 namespace
 {
 
-// check if an angle is oriented counter clockwise
-inline bool is_oriented_ccw(const Vector2 &a, const Vector2 &b, const Vector2 &c)
+// Polygon triangulation by ear clipping on a doubly linked vertex list, in the
+// manner of mapbox's earcut. Holes are joined to the outer ring through bridge
+// edges, and on bigger polygons the ear tests only look at vertices near the
+// ear, found through a list sorted along a z-order curve.
+
+struct TriNode
+{
+	uint32 i;
+	double x, y;
+
+	TriNode *prev = nullptr;
+	TriNode *next = nullptr;
+
+	// Position on the z-order curve, and neighbours in z-order.
+	int32 z = 0;
+	TriNode *prevZ = nullptr;
+	TriNode *nextZ = nullptr;
+
+	// Vertex of a single-point hole, which must not be filtered out.
+	bool steiner = false;
+};
+
+class Triangulator
+{
+public:
+
+	Triangulator(const Vector2 *vertices, size_t count, const std::vector<size_t> &holes, std::vector<uint32> &indices)
+		: vertices(vertices)
+		, count(count)
+		, holes(holes)
+		, indices(indices)
+	{
+	}
+
+	void run();
+
+private:
+
+	TriNode *createList(size_t start, size_t end, bool clockwise);
+	TriNode *insertNode(size_t i, TriNode *last);
+	TriNode *filterPoints(TriNode *start, TriNode *end = nullptr);
+	void earcutLinked(TriNode *ear, int pass);
+	bool isEar(const TriNode *ear) const;
+	bool isEarHashed(const TriNode *ear) const;
+	TriNode *cureLocalIntersections(TriNode *start);
+	void splitEarcut(TriNode *start);
+	TriNode *eliminateHoles(TriNode *outer);
+	TriNode *findHoleBridge(TriNode *hole, TriNode *outer) const;
+	TriNode *splitPolygon(TriNode *a, TriNode *b);
+	void indexCurve(TriNode *start);
+	int32 zOrder(double x, double y) const;
+
+	void addTriangle(const TriNode *a, const TriNode *b, const TriNode *c)
+	{
+		indices.push_back(a->i);
+		indices.push_back(b->i);
+		indices.push_back(c->i);
+	}
+
+	const Vector2 *vertices;
+	size_t count;
+	const std::vector<size_t> &holes;
+	std::vector<uint32> &indices;
+
+	// Nodes need stable addresses; splitting adds nodes while others are linked.
+	std::deque<TriNode> nodes;
+
+	bool hashed = false;
+	double minX = 0.0;
+	double minY = 0.0;
+	double invSize = 0.0;
+};
+
+inline double area(const TriNode *p, const TriNode *q, const TriNode *r)
+{
+	return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+inline bool equals(const TriNode *a, const TriNode *b)
+{
+	return a->x == b->x && a->y == b->y;
+}
+
+inline int sign(double v)
 {
-	// return det(b-a, c-a) >= 0
-	return ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) >= 0;
+	return (v > 0.0) - (v < 0.0);
 }
 
-// check if a and b are on the same side of the line c->d
-bool on_same_side(const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d)
+inline bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
 {
-	float px = d.x - c.x, py = d.y - c.y;
-	// return det(p, a-c) * det(p, b-c) >= 0
-	float l = px * (a.y - c.y) - py * (a.x - c.x);
-	float m = px * (b.y - c.y) - py * (b.x - c.x);
-	return l * m >= 0;
+	return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+		&& (ax - px) * (by - py) >= (bx - px) * (ay - py)
+		&& (bx - px) * (cy - py) >= (cx - px) * (by - py);
 }
 
-// checks is p is contained in the triangle abc
-inline bool point_in_triangle(const Vector2 &p, const Vector2 &a, const Vector2 &b, const Vector2 &c)
+// For collinear p, q, r: does q lie on segment pr?
+inline bool onSegment(const TriNode *p, const TriNode *q, const TriNode *r)
 {
-	return on_same_side(p,a, b,c) && on_same_side(p,b, a,c) && on_same_side(p,c, a,b);
+	return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x)
+		&& q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
 }
 
-// checks if any vertex in `vertices' is in the triangle abc.
-bool any_point_in_triangle(const std::list<const Vector2 *> &vertices, const Vector2 &a, const Vector2 &b, const Vector2 &c)
+bool intersects(const TriNode *p1, const TriNode *q1, const TriNode *p2, const TriNode *q2)
 {
-	for (const Vector2 *p : vertices)
+	int o1 = sign(area(p1, q1, p2));
+	int o2 = sign(area(p1, q1, q2));
+	int o3 = sign(area(p2, q2, p1));
+	int o4 = sign(area(p2, q2, q1));
+
+	if (o1 != o2 && o3 != o4)
+		return true;
+
+	return (o1 == 0 && onSegment(p1, p2, q1))
+		|| (o2 == 0 && onSegment(p1, q2, q1))
+		|| (o3 == 0 && onSegment(p2, p1, q2))
+		|| (o4 == 0 && onSegment(p2, q1, q2));
+}
+
+bool intersectsPolygon(const TriNode *a, const TriNode *b)
+{
+	const TriNode *p = a;
+	do
 	{
-		if ((p != &a) && (p != &b) && (p != &c) && point_in_triangle(*p, a,b,c)) // oh god...
+		if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && intersects(p, p->next, a, b))
 			return true;
-	}
+		p = p->next;
+	} while (p != a);
 
 	return false;
 }
 
-inline bool is_ear(const Vector2 &a, const Vector2 &b, const Vector2 &c, const std::list<const Vector2 *> &vertices)
+bool locallyInside(const TriNode *a, const TriNode *b)
 {
-	return is_oriented_ccw(a,b,c) && !any_point_in_triangle(vertices, a,b,c);
+	if (area(a->prev, a, a->next) < 0.0)
+		return area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0;
+	else
+		return area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
 }
 
-} // anonymous namespace
+bool middleInside(const TriNode *a, const TriNode *b)
+{
+	const TriNode *p = a;
+	bool inside = false;
+	double px = (a->x + b->x) / 2.0;
+	double py = (a->y + b->y) / 2.0;
 
-namespace love
+	do
+	{
+		if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+			&& (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+			inside = !inside;
+		p = p->next;
+	} while (p != a);
+
+	return inside;
+}
+
+bool isValidDiagonal(const TriNode *a, const TriNode *b)
 {
-namespace math
+	return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b)
+		&& ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+			&& (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0))
+		|| (equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0));
+}
+
+bool sectorContainsSector(const TriNode *m, const TriNode *p)
 {
+	return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+}
 
-std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+void removeNode(TriNode *p)
 {
-	if (polygon.size() < 3)
-		throw love::Exception("Not a polygon");
-	else if (polygon.size() == 3)
-		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if (p->prevZ)
+		p->prevZ->nextZ = p->nextZ;
+	if (p->nextZ)
+		p->nextZ->prevZ = p->prevZ;
+}
+
+TriNode *getLeftmost(TriNode *start)
+{
+	TriNode *p = start;
+	TriNode *leftmost = start;
+	do
+	{
+		if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+			leftmost = p;
+		p = p->next;
+	} while (p != start);
+
+	return leftmost;
+}
+
+// Merge sort of the z-order list (Simon Tatham's linked list variant).
+TriNode *sortLinked(TriNode *list)
+{
+	int insize = 1;
+	int merges = 0;
+
+	do
+	{
+		TriNode *p = list;
+		TriNode *tail = nullptr;
+		list = nullptr;
+		merges = 0;
+
+		while (p)
+		{
+			merges++;
+			TriNode *q = p;
+			int psize = 0;
+			for (int i = 0; i < insize && q; i++)
+			{
+				psize++;
+				q = q->nextZ;
+			}
+
+			int qsize = insize;
+
+			while (psize > 0 || (qsize > 0 && q))
+			{
+				TriNode *e = nullptr;
+				if (psize != 0 && (qsize == 0 || !q || p->z <= q->z))
+				{
+					e = p;
+					p = p->nextZ;
+					psize--;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					qsize--;
+				}
+
+				if (tail)
+					tail->nextZ = e;
+				else
+					list = e;
+
+				e->prevZ = tail;
+				tail = e;
+			}
+
+			p = q;
+		}
+
+		tail->nextZ = nullptr;
+		insize *= 2;
+	} while (merges > 1);
+
+	return list;
+}
+
+void Triangulator::run()
+{
+	size_t outerEnd = holes.empty() ? count : holes[0];
+
+	TriNode *outer = createList(0, outerEnd, true);
+	if (outer == nullptr || outer->next == outer->prev)
+		return;
+
+	if (!holes.empty())
+		outer = eliminateHoles(outer);
+
+	// Hashing only pays off for bigger polygons.
+	if (count > 80)
+	{
+		double maxX = vertices[0].x;
+		double maxY = vertices[0].y;
+		minX = maxX;
+		minY = maxY;
+
+		for (size_t i = 1; i < outerEnd; i++)
+		{
+			minX = std::min(minX, (double) vertices[i].x);
+			minY = std::min(minY, (double) vertices[i].y);
+			maxX = std::max(maxX, (double) vertices[i].x);
+			maxY = std::max(maxY, (double) vertices[i].y);
+		}
+
+		double size = std::max(maxX - minX, maxY - minY);
+		invSize = size != 0.0 ? 32767.0 / size : 0.0;
+		hashed = invSize != 0.0;
+	}
 
-	// collect list of connections and record leftmost item to check if the polygon
-	// has the expected winding
-	std::vector<size_t> next_idx(polygon.size()), prev_idx(polygon.size());
-	size_t idx_lm = 0;
-	for (size_t i = 0; i < polygon.size(); ++i)
+	earcutLinked(outer, 0);
+}
+
+TriNode *Triangulator::createList(size_t start, size_t end, bool clockwise)
+{
+	double sum = 0.0;
+	for (size_t i = start, j = end - 1; i < end; j = i++)
+		sum += ((double) vertices[j].x - vertices[i].x) * ((double) vertices[i].y + vertices[j].y);
+
+	TriNode *last = nullptr;
+	if (clockwise == (sum > 0.0))
+	{
+		for (size_t i = start; i < end; i++)
+			last = insertNode(i, last);
+	}
+	else
+	{
+		for (size_t i = end; i-- > start;)
+			last = insertNode(i, last);
+	}
+
+	if (last && equals(last, last->next))
 	{
-		const love::Vector2 &lm = polygon[idx_lm], &p = polygon[i];
-		if (p.x < lm.x || (p.x == lm.x && p.y < lm.y))
-			idx_lm = i;
-		next_idx[i] = i+1;
-		prev_idx[i] = i-1;
+		removeNode(last);
+		last = last->next;
 	}
-	next_idx[next_idx.size()-1] = 0;
-	prev_idx[0] = prev_idx.size()-1;
 
-	// check if the polygon has the expected winding and reverse polygon if needed
-	if (!is_oriented_ccw(polygon[prev_idx[idx_lm]], polygon[idx_lm], polygon[next_idx[idx_lm]]))
-		next_idx.swap(prev_idx);
+	return last;
+}
 
-	// collect list of concave polygons
-	std::list<const love::Vector2 *> concave_vertices;
-	for (size_t i = 0; i < polygon.size(); ++i)
+TriNode *Triangulator::insertNode(size_t i, TriNode *last)
+{
+	nodes.emplace_back();
+	TriNode *p = &nodes.back();
+	p->i = (uint32) i;
+	p->x = vertices[i].x;
+	p->y = vertices[i].y;
+
+	if (last == nullptr)
 	{
-		if (!is_oriented_ccw(polygon[prev_idx[i]], polygon[i], polygon[next_idx[i]]))
-			concave_vertices.push_back(&polygon[i]);
+		p->prev = p;
+		p->next = p;
+	}
+	else
+	{
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
 	}
 
-	// triangulation according to kong
-	std::vector<Triangle> triangles;
-	size_t n_vertices = polygon.size();
-	size_t current = 1, skipped = 0, next, prev;
-	while (n_vertices > 3)
-	{
-		next = next_idx[current];
-		prev = prev_idx[current];
-		const Vector2 &a = polygon[prev], &b = polygon[current], &c = polygon[next];
-		if (is_ear(a,b,c, concave_vertices))
+	return p;
+}
+
+// Removes duplicate and collinear points.
+TriNode *Triangulator::filterPoints(TriNode *start, TriNode *end)
+{
+	if (start == nullptr)
+		return start;
+	if (end == nullptr)
+		end = start;
+
+	TriNode *p = start;
+	bool again = false;
+
+	do
+	{
+		again = false;
+
+		if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0))
+		{
+			removeNode(p);
+			p = end = p->prev;
+			if (p == p->next)
+				break;
+			again = true;
+		}
+		else
+			p = p->next;
+	} while (again || p != end);
+
+	return end;
+}
+
+void Triangulator::earcutLinked(TriNode *ear, int pass)
+{
+	if (ear == nullptr)
+		return;
+
+	if (pass == 0 && hashed)
+		indexCurve(ear);
+
+	TriNode *stop = ear;
+
+	while (ear->prev != ear->next)
+	{
+		TriNode *prev = ear->prev;
+		TriNode *next = ear->next;
+
+		if (hashed ? isEarHashed(ear) : isEar(ear))
 		{
-			triangles.push_back(Triangle(a,b,c));
-			next_idx[prev] = next;
-			prev_idx[next] = prev;
-			concave_vertices.remove(&b);
-			--n_vertices;
-			skipped = 0;
+			addTriangle(prev, ear, next);
+			removeNode(ear);
+
+			// Skipping the next vertex leads to less sliver triangles.
+			ear = next->next;
+			stop = next->next;
+			continue;
 		}
-		else if (++skipped > n_vertices)
+
+		ear = next;
+
+		// Went all the way around without finding an ear: try to recover.
+		if (ear == stop)
 		{
-			throw love::Exception("Cannot triangulate polygon.");
+			if (pass == 0)
+				earcutLinked(filterPoints(ear), 1);
+			else if (pass == 1)
+				earcutLinked(cureLocalIntersections(filterPoints(ear)), 2);
+			else
+				splitEarcut(ear);
+			break;
 		}
-		current = next;
 	}
-	next = next_idx[current];
-	prev = prev_idx[current];
-	triangles.push_back(Triangle(polygon[prev], polygon[current], polygon[next]));
+}
+
+bool Triangulator::isEar(const TriNode *ear) const
+{
+	const TriNode *a = ear->prev;
+	const TriNode *b = ear;
+	const TriNode *c = ear->next;
+
+	// Reflex, can't be an ear.
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	for (const TriNode *p = c->next; p != a; p = p->next)
+	{
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0)
+			return false;
+	}
+
+	return true;
+}
+
+bool Triangulator::isEarHashed(const TriNode *ear) const
+{
+	const TriNode *a = ear->prev;
+	const TriNode *b = ear;
+	const TriNode *c = ear->next;
+
+	if (area(a, b, c) >= 0.0)
+		return false;
+
+	double x0 = std::min(a->x, std::min(b->x, c->x));
+	double y0 = std::min(a->y, std::min(b->y, c->y));
+	double x1 = std::max(a->x, std::max(b->x, c->x));
+	double y1 = std::max(a->y, std::max(b->y, c->y));
+
+	// Only vertices inside the triangle's bounding box on the z-order curve
+	// can be in the triangle.
+	int32 minZ = zOrder(x0, y0);
+	int32 maxZ = zOrder(x1, y1);
+
+	auto blocks = [&](const TriNode *p)
+	{
+		return p != a && p != c
+			&& p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+			&& pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+			&& area(p->prev, p, p->next) >= 0.0;
+	};
+
+	const TriNode *p = ear->prevZ;
+	const TriNode *n = ear->nextZ;
+
+	while (p && p->z >= minZ && n && n->z <= maxZ)
+	{
+		if (blocks(p))
+			return false;
+		p = p->prevZ;
+
+		if (blocks(n))
+			return false;
+		n = n->nextZ;
+	}
+
+	for (; p && p->z >= minZ; p = p->prevZ)
+	{
+		if (blocks(p))
+			return false;
+	}
+
+	for (; n && n->z <= maxZ; n = n->nextZ)
+	{
+		if (blocks(n))
+			return false;
+	}
+
+	return true;
+}
+
+TriNode *Triangulator::cureLocalIntersections(TriNode *start)
+{
+	TriNode *p = start;
+	do
+	{
+		TriNode *a = p->prev;
+		TriNode *b = p->next->next;
+
+		if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a))
+		{
+			addTriangle(a, p, b);
+			removeNode(p);
+			removeNode(p->next);
+			p = start = b;
+		}
+
+		p = p->next;
+	} while (p != start);
+
+	return filterPoints(p);
+}
+
+// Splits the polygon along a valid diagonal and triangulates both halves.
+void Triangulator::splitEarcut(TriNode *start)
+{
+	TriNode *a = start;
+	do
+	{
+		TriNode *b = a->next->next;
+		while (b != a->prev)
+		{
+			if (a->i != b->i && isValidDiagonal(a, b))
+			{
+				TriNode *c = splitPolygon(a, b);
+
+				a = filterPoints(a, a->next);
+				c = filterPoints(c, c->next);
+
+				earcutLinked(a, 0);
+				earcutLinked(c, 0);
+				return;
+			}
+			b = b->next;
+		}
+		a = a->next;
+	} while (a != start);
+}
+
+TriNode *Triangulator::eliminateHoles(TriNode *outer)
+{
+	std::vector<TriNode *> queue;
+	queue.reserve(holes.size());
+
+	for (size_t h = 0; h < holes.size(); h++)
+	{
+		size_t start = holes[h];
+		size_t end = h + 1 < holes.size() ? holes[h + 1] : count;
+
+		TriNode *list = createList(start, end, false);
+		if (list == nullptr)
+			continue;
+
+		if (list == list->next)
+			list->steiner = true;
+
+		queue.push_back(getLeftmost(list));
+	}
+
+	std::sort(queue.begin(), queue.end(), [](const TriNode *a, const TriNode *b)
+	{
+		return a->x < b->x;
+	});
+
+	// Bridge holes from left to right.
+	for (TriNode *hole : queue)
+	{
+		TriNode *bridge = findHoleBridge(hole, outer);
+		if (bridge == nullptr)
+			continue;
+
+		TriNode *reverse = splitPolygon(bridge, hole);
+		filterPoints(reverse, reverse->next);
+		outer = filterPoints(bridge, bridge->next);
+	}
+
+	return outer;
+}
+
+// David Eberly's algorithm for finding a bridge between a hole and the outer polygon.
+TriNode *Triangulator::findHoleBridge(TriNode *hole, TriNode *outer) const
+{
+	TriNode *p = outer;
+	double hx = hole->x;
+	double hy = hole->y;
+	double qx = -std::numeric_limits<double>::infinity();
+	TriNode *m = nullptr;
+
+	// Find a segment intersected by a ray from the hole's leftmost point to the
+	// left; the segment's endpoint with lesser x is a potential connection.
+	do
+	{
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+		{
+			double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx)
+			{
+				qx = x;
+				m = p->x < p->next->x ? p : p->next;
+				if (x == hx)
+					return m;
+			}
+		}
+		p = p->next;
+	} while (p != outer);
+
+	if (m == nullptr)
+		return nullptr;
+
+	// Look for points inside the triangle of the hole point, the intersection
+	// point and m; pick the one with the smallest angle to the ray, if any.
+	const TriNode *stop = m;
+	double mx = m->x;
+	double my = m->y;
+	double tanMin = std::numeric_limits<double>::infinity();
+
+	p = m;
+	do
+	{
+		if (hx >= p->x && p->x >= mx && hx != p->x
+			&& pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+		{
+			double tan = fabs(hy - p->y) / (hx - p->x);
+
+			if (locallyInside(p, hole)
+				&& (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))))))
+			{
+				m = p;
+				tanMin = tan;
+			}
+		}
+		p = p->next;
+	} while (p != stop);
+
+	return m;
+}
+
+// Links a and b with a bridge: if they belong to the same ring, splits it in
+// two; if they're in different rings, merges them into one.
+TriNode *Triangulator::splitPolygon(TriNode *a, TriNode *b)
+{
+	nodes.emplace_back(*a);
+	TriNode *a2 = &nodes.back();
+	nodes.emplace_back(*b);
+	TriNode *b2 = &nodes.back();
+
+	a2->prevZ = a2->nextZ = nullptr;
+	b2->prevZ = b2->nextZ = nullptr;
+	a2->z = b2->z = 0;
+
+	TriNode *an = a->next;
+	TriNode *bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+void Triangulator::indexCurve(TriNode *start)
+{
+	TriNode *p = start;
+	do
+	{
+		if (p->z == 0)
+			p->z = zOrder(p->x, p->y);
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	} while (p != start);
+
+	p->prevZ->nextZ = nullptr;
+	p->prevZ = nullptr;
+
+	sortLinked(p);
+}
+
+// Interleaves the bits of 15-bit grid coordinates.
+int32 Triangulator::zOrder(double fx, double fy) const
+{
+	uint32 x = (uint32) ((fx - minX) * invSize);
+	uint32 y = (uint32) ((fy - minY) * invSize);
+
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+
+	y = (y | (y << 8)) & 0x00FF00FF;
+	y = (y | (y << 4)) & 0x0F0F0F0F;
+	y = (y | (y << 2)) & 0x33333333;
+	y = (y | (y << 1)) & 0x55555555;
+
+	return (int32) (x | (y << 1));
+}
+
+} // anonymous namespace
+
+namespace love
+{
+namespace math
+{
+
+void triangulate(const Vector2 *vertices, size_t count, const std::vector<size_t> &holes, std::vector<uint32> &indices)
+{
+	indices.clear();
+
+	if (count < 3)
+		throw love::Exception("Not a polygon");
+
+	for (size_t i = 0; i < holes.size(); i++)
+	{
+		if (holes[i] >= count || (i > 0 && holes[i] <= holes[i - 1]) || holes[0] < 3)
+			throw love::Exception("Invalid polygon hole start index: %d", (int) holes[i]);
+	}
+
+	Triangulator(vertices, count, holes, indices).run();
+}
+
+void triangulate(const std::vector<Polygon> &polygons, std::vector<std::vector<uint32>> &indices)
+{
+	indices.resize(polygons.size());
+
+	love::thread::JobSystem::getInstance()->parallelFor(polygons.size(), 4, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const Polygon &p = polygons[i];
+			triangulate(p.vertices.data(), p.vertices.size(), p.holes, indices[i]);
+		}
+	});
+}
+
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+{
+	if (polygon.size() < 3)
+		throw love::Exception("Not a polygon");
+	else if (polygon.size() == 3)
+		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
+
+	std::vector<uint32> indices;
+	triangulate(polygon.data(), polygon.size(), std::vector<size_t>(), indices);
+
+	if (indices.empty())
+		throw love::Exception("Cannot triangulate polygon.");
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		triangles.push_back(Triangle(polygon[indices[i]], polygon[indices[i + 1]], polygon[indices[i + 2]]));
 
 	return triangles;
 }
@@ -199,6 +861,90 @@ float linearToGamma(float c)
 		return 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
 }
 
+double fractalNoise(const NoiseSettings &settings, double x, double y, double z, double w)
+{
+	double sum = 0.0;
+	double amplitude = 1.0;
+	double total = 0.0;
+
+	for (int i = 0; i < settings.octaves; i++)
+	{
+		double n = 0.0;
+
+		if (settings.type == NOISE_PERLIN)
+		{
+			switch (settings.dimensions)
+			{
+			case 1: n = Noise1234::noise(x); break;
+			case 2: n = Noise1234::noise(x, y); break;
+			case 3: n = Noise1234::noise(x, y, z); break;
+			default: n = Noise1234::noise(x, y, z, w); break;
+			}
+		}
+		else
+		{
+			switch (settings.dimensions)
+			{
+			case 1: n = SimplexNoise1234::noise(x); break;
+			case 2: n = SimplexNoise1234::noise(x, y); break;
+			case 3: n = SimplexNoise1234::noise(x, y, z); break;
+			default: n = SimplexNoise1234::noise(x, y, z, w); break;
+			}
+		}
+
+		sum += n * amplitude;
+		total += amplitude;
+		amplitude *= settings.gain;
+
+		x *= settings.lacunarity;
+		y *= settings.lacunarity;
+		z *= settings.lacunarity;
+		w *= settings.lacunarity;
+	}
+
+	if (total == 0.0)
+		return 0.5;
+
+	return (sum / total) * 0.5 + 0.5;
+}
+
+void generateNoise(const NoiseSettings &settings, int width, int height, float *dst)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	auto rows = [&](size_t begin, size_t end)
+	{
+		for (size_t j = begin; j < end; j++)
+		{
+			double y = settings.y + j * settings.dy;
+			float *row = dst + j * width;
+
+			for (int i = 0; i < width; i++)
+				row[i] = (float) fractalNoise(settings, settings.x + i * settings.dx, y, settings.z, settings.w);
+		}
+	};
+
+	// Roughly the sample count where splitting into jobs starts paying off.
+	const int64 minJobSamples = 16 * 1024;
+
+	if ((int64) width * height * std::max(settings.octaves, 1) < minJobSamples)
+	{
+		rows(0, (size_t) height);
+		return;
+	}
+
+	size_t minrows = (size_t) std::max<int64>(minJobSamples / ((int64) width * std::max(settings.octaves, 1)), 1);
+	love::thread::JobSystem::getInstance()->parallelFor((size_t) height, minrows, rows);
+}
+
+STRINGMAP_BEGIN(NoiseType, NOISE_MAX_ENUM, noiseType)
+{
+	{ "perlin",  NOISE_PERLIN  },
+	{ "simplex", NOISE_SIMPLEX },
+}
+STRINGMAP_END(NoiseType, NOISE_MAX_ENUM, noiseType)
+
 Math::Math()
 	: rng()
 {
@@ -231,5 +977,15 @@ Transform *Math::newTransform(float x, float y, float a, float sx, float sy, flo
 	return new Transform(x, y, a, sx, sy, ox, oy, kx, ky);
 }
 
+FloatArray *Math::newFloatArray(size_t count)
+{
+	return new FloatArray(count);
+}
+
+FloatArray *Math::newFloatArray(love::Data *data, size_t offset, size_t count)
+{
+	return new FloatArray(data, offset, count);
+}
+
 } // math
 } // love
@@ -28,6 +28,8 @@
 #include "common/math.h"
 #include "common/Vector.h"
 #include "common/int.h"
+#include "common/StringMap.h"
+#include "common/Data.h"
 
 // Noise
 #include "libraries/noise1234/noise1234.h"
@@ -43,6 +45,7 @@ namespace math
 
 class BezierCurve;
 class Transform;
+class FloatArray;
 
 struct Triangle
 {
@@ -60,6 +63,28 @@ struct Triangle
  **/
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a simple polygon with holes. The outer ring comes first in the
+ * vertex list, followed by each hole; rings may use either winding.
+ *
+ * @param holes Index of the first vertex of each hole, in increasing order.
+ * @param indices Receives 3 vertex indices per triangle.
+ **/
+void triangulate(const Vector2 *vertices, size_t count, const std::vector<size_t> &holes, std::vector<uint32> &indices);
+
+struct Polygon
+{
+	std::vector<Vector2> vertices;
+	std::vector<size_t> holes;
+};
+
+/**
+ * Triangulates many polygons, spread across the job system.
+ *
+ * @param indices Receives the triangle indices of each polygon.
+ **/
+void triangulate(const std::vector<Polygon> &polygons, std::vector<std::vector<uint32>> &indices);
+
 /**
  * Checks whether a polygon is convex.
  *
@@ -92,6 +117,53 @@ static double perlinNoise2(double x, double y);
 static double perlinNoise3(double x, double y, double z);
 static double perlinNoise4(double x, double y, double z, double w);
 
+enum NoiseType
+{
+	NOISE_PERLIN,
+	NOISE_SIMPLEX,
+	NOISE_MAX_ENUM
+};
+
+/**
+ * Parameters for fractal noise. Grid samples are taken at
+ * (x + i * dx, y + j * dy, z, w), of which the first 'dimensions'
+ * coordinates are used.
+ **/
+struct NoiseSettings
+{
+	NoiseType type = NOISE_SIMPLEX;
+	int dimensions = 2;
+
+	double x = 0.0;
+	double y = 0.0;
+	double z = 0.0;
+	double w = 0.0;
+
+	double dx = 1.0;
+	double dy = 1.0;
+
+	// Each octave has lacunarity times the frequency and gain times the
+	// amplitude of the previous one.
+	int octaves = 1;
+	double lacunarity = 2.0;
+	double gain = 0.5;
+};
+
+/**
+ * Calculate fractal noise for the specified coordinates.
+ *
+ * @return Noise value in the range of [0, 1].
+ **/
+double fractalNoise(const NoiseSettings &settings, double x, double y, double z, double w);
+
+/**
+ * Fills a width * height grid of floats with fractal noise, row by row. Big
+ * grids are split across the job system.
+ **/
+void generateNoise(const NoiseSettings &settings, int width, int height, float *dst);
+
+STRINGMAP_DECLARE(NoiseType);
+
 
 class Math : public Module
 {
@@ -118,6 +190,9 @@ public:
 	Transform *newTransform();
 	Transform *newTransform(float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
 
+	FloatArray *newFloatArray(size_t count);
+	FloatArray *newFloatArray(love::Data *data, size_t offset, size_t count);
+
 	// Implements Module.
 	virtual ModuleType getModuleType() const
 	{
@@ -21,6 +21,7 @@
 #include "RandomGenerator.h"
 
 // C++
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -90,6 +91,122 @@ double RandomGenerator::randomNormal(double stddev)
 	return r * sin(phi) * stddev;
 }
 
+// Numbers are produced in blocks so the raw integers stay in the cache while
+// they're converted.
+static const size_t RANDOM_FILL_BLOCK = 256;
+
+static inline double toUnitDouble(uint64 r)
+{
+	union { uint64 i; double d; } u;
+	u.i = ((0x3FFULL) << 52) | (r >> 12);
+	return u.d - 1.0;
+}
+
+void RandomGenerator::randomFill(double *dst, size_t count, double min, double max)
+{
+	uint64 raw[RANDOM_FILL_BLOCK];
+	double range = max - min;
+
+	for (size_t i = 0; i < count; i += RANDOM_FILL_BLOCK)
+	{
+		size_t n = std::min(count - i, RANDOM_FILL_BLOCK);
+
+		for (size_t j = 0; j < n; j++)
+			raw[j] = rand();
+
+		for (size_t j = 0; j < n; j++)
+			dst[i + j] = toUnitDouble(raw[j]) * range + min;
+	}
+}
+
+void RandomGenerator::randomIntegerFill(double *dst, size_t count, double min, double max)
+{
+	randomFill(dst, count, 0.0, max - min + 1.0);
+
+	for (size_t i = 0; i < count; i++)
+		dst[i] = floor(dst[i]) + min;
+}
+
+void RandomGenerator::randomNormalFill(double *dst, size_t count, double stddev, double mean)
+{
+	size_t i = 0;
+
+	if (count > 0 && last_randomnormal != std::numeric_limits<double>::infinity())
+	{
+		dst[i++] = last_randomnormal * stddev + mean;
+		last_randomnormal = std::numeric_limits<double>::infinity();
+	}
+
+	// Each pair of uniform numbers gives two normal ones, in the same order
+	// randomNormal returns them.
+	double uniform[RANDOM_FILL_BLOCK];
+
+	while (i + 1 < count)
+	{
+		size_t pairs = std::min((count - i) / 2, RANDOM_FILL_BLOCK / 2);
+		randomFill(uniform, pairs * 2, 0.0, 1.0);
+
+		for (size_t j = 0; j < pairs; j++)
+		{
+			double r   = sqrt(-2.0 * log(1. - uniform[j * 2 + 0]));
+			double phi = 2.0 * LOVE_M_PI * (1. - uniform[j * 2 + 1]);
+
+			dst[i + j * 2 + 0] = r * sin(phi) * stddev + mean;
+			dst[i + j * 2 + 1] = r * cos(phi) * stddev + mean;
+		}
+
+		i += pairs * 2;
+	}
+
+	if (i < count)
+		dst[i] = randomNormal(stddev) + mean;
+}
+
+void RandomGenerator::jump()
+{
+	// Xorshift is linear over GF(2), so stepping it 2^32 times is a fixed
+	// 64x64 bit matrix. Each column is the image of one state bit; the matrix
+	// is built by squaring the single step matrix 32 times.
+	static const struct JumpMatrix
+	{
+		uint64 columns[64];
+
+		static uint64 apply(const uint64 *m, uint64 x)
+		{
+			uint64 r = 0;
+			for (int i = 0; i < 64; i++)
+			{
+				if (x & (1ULL << i))
+					r ^= m[i];
+			}
+			return r;
+		}
+
+		JumpMatrix()
+		{
+			for (int i = 0; i < 64; i++)
+			{
+				uint64 x = 1ULL << i;
+				x ^= (x >> 12);
+				x ^= (x << 25);
+				x ^= (x >> 27);
+				columns[i] = x;
+			}
+
+			for (int n = 0; n < 32; n++)
+			{
+				uint64 squared[64];
+				for (int i = 0; i < 64; i++)
+					squared[i] = apply(columns, columns[i]);
+				std::copy(squared, squared + 64, columns);
+			}
+		}
+	} matrix;
+
+	rng_state.b64 = JumpMatrix::apply(matrix.columns, rng_state.b64);
+	last_randomnormal = std::numeric_limits<double>::infinity();
+}
+
 void RandomGenerator::setSeed(RandomGenerator::Seed newseed)
 {
 	seed = newseed;
@@ -112,6 +112,32 @@ public:
 	 **/
 	double randomNormal(double stddev);
 
+	/**
+	 * Fill an array with the results of count consecutive random(min, max)
+	 * calls. The generator is stepped in one tight loop and the conversion to
+	 * doubles is a separate pass the compiler can vectorize.
+	 **/
+	void randomFill(double *dst, size_t count, double min, double max);
+
+	/**
+	 * Fill an array with pseudo random integers in [min, max], consuming
+	 * the sequence the same way as random(min, max) does in Lua.
+	 **/
+	void randomIntegerFill(double *dst, size_t count, double min, double max);
+
+	/**
+	 * Fill an array with the results of count consecutive randomNormal calls,
+	 * offset by mean.
+	 **/
+	void randomNormalFill(double *dst, size_t count, double stddev, double mean);
+
+	/**
+	 * Advance the state by 2^32 steps, as if rand() was called that many
+	 * times. Copies of a generator that are jumped a different number of
+	 * times produce non-overlapping streams, e.g. one for each thread.
+	 **/
+	void jump();
+
 	/**
 	 * Set pseudo-random seed.
 	 * It's up to the implementation how to use this.
@@ -19,6 +19,7 @@
  **/
 
 #include "Transform.h"
+#include "common/Exception.h"
 
 namespace love
 {
@@ -31,6 +32,10 @@ Transform::Transform()
 	: matrix()
 	, inverseDirty(true)
 	, inverseMatrix()
+	, parent(nullptr)
+	, children()
+	, worldDirty(true)
+	, worldMatrix()
 {
 }
 
@@ -38,6 +43,10 @@ Transform::Transform(const Matrix4 &m)
 	: matrix(m)
 	, inverseDirty(true)
 	, inverseMatrix()
+	, parent(nullptr)
+	, children()
+	, worldDirty(true)
+	, worldMatrix()
 {
 }
 
@@ -45,16 +54,26 @@ Transform::Transform(float x, float y, float a, float sx, float sy, float ox, fl
 	: matrix(x, y, a, sx, sy, ox, oy, kx, ky)
 	, inverseDirty(true)
 	, inverseMatrix()
+	, parent(nullptr)
+	, children()
+	, worldDirty(true)
+	, worldMatrix()
 {
 }
 
 Transform::~Transform()
 {
+	for (const StrongRef<Transform> &child : children)
+	{
+		child->parent = nullptr;
+		child->setWorldDirty();
+	}
 }
 
 Transform *Transform::clone()
 {
-	return new Transform(*this);
+	// Only the matrix is copied; the clone isn't part of any hierarchy.
+	return new Transform(matrix);
 }
 
 Transform *Transform::inverse()
@@ -65,43 +84,43 @@ Transform *Transform::inverse()
 void Transform::apply(Transform *other)
 {
 	matrix *= other->getMatrix();
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::translate(float x, float y)
 {
 	matrix.translate(x, y);
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::rotate(float angle)
 {
 	matrix.rotate(angle);
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::scale(float x, float y)
 {
 	matrix.scale(x, y);
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::shear(float x, float y)
 {
 	matrix.shear(x, y);
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::reset()
 {
 	matrix.setIdentity();
-	inverseDirty = true;
+	setDirty();
 }
 
 void Transform::setTransformation(float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky)
 {
 	matrix.setTransformation(x, y, a, sx, sy, ox, oy, kx, ky);
-	inverseDirty = true;
+	setDirty();
 }
 
 love::Vector2 Transform::transformPoint(love::Vector2 p) const
@@ -126,7 +145,94 @@ const Matrix4 &Transform::getMatrix() const
 void Transform::setMatrix(const Matrix4 &m)
 {
 	matrix = m;
+	setDirty();
+}
+
+void Transform::setDirty()
+{
 	inverseDirty = true;
+	setWorldDirty();
+}
+
+void Transform::setWorldDirty()
+{
+	// A dirty Transform's descendants are always dirty as well, so there's no
+	// need to visit them again.
+	if (worldDirty)
+		return;
+
+	worldDirty = true;
+	for (const StrongRef<Transform> &child : children)
+		child->setWorldDirty();
+}
+
+void Transform::setParent(Transform *newparent)
+{
+	if (newparent == parent)
+		return;
+
+	for (Transform *p = newparent; p != nullptr; p = p->parent)
+	{
+		if (p == this)
+			throw love::Exception("A Transform cannot be parented to itself or one of its children.");
+	}
+
+	// Keep this object alive while it moves between parents.
+	StrongRef<Transform> self(this);
+
+	if (parent != nullptr)
+	{
+		auto &siblings = parent->children;
+		for (auto it = siblings.begin(); it != siblings.end(); ++it)
+		{
+			if (it->get() == this)
+			{
+				siblings.erase(it);
+				break;
+			}
+		}
+	}
+
+	parent = newparent;
+
+	if (parent != nullptr)
+		parent->children.push_back(self);
+
+	setWorldDirty();
+}
+
+Transform *Transform::getParent() const
+{
+	return parent;
+}
+
+const std::vector<StrongRef<Transform>> &Transform::getChildren() const
+{
+	return children;
+}
+
+const Matrix4 &Transform::getWorldMatrix()
+{
+	if (parent == nullptr)
+	{
+		worldDirty = false;
+		return matrix;
+	}
+
+	if (worldDirty)
+	{
+		Matrix4::multiply(parent->getWorldMatrix(), matrix, worldMatrix);
+		worldDirty = false;
+	}
+
+	return worldMatrix;
+}
+
+love::Vector2 Transform::transformPointToWorld(love::Vector2 p)
+{
+	love::Vector2 result;
+	getWorldMatrix().transformXY(&result, &p, 1);
+	return result;
 }
 
 bool Transform::getConstant(const char *in, MatrixLayout &out)
@@ -26,6 +26,9 @@
 #include "common/Vector.h"
 #include "common/StringMap.h"
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace math
@@ -69,6 +72,25 @@ public:
 	const Matrix4 &getMatrix() const;
 	void setMatrix(const Matrix4 &m);
 
+	/**
+	 * Attaches this Transform to a parent, or detaches it when the parent is
+	 * null. A parent keeps its children alive. Throws if the new parent is
+	 * this Transform or one of its descendants.
+	 **/
+	void setParent(Transform *newparent);
+	Transform *getParent() const;
+
+	const std::vector<StrongRef<Transform>> &getChildren() const;
+
+	/**
+	 * Gets the parent's world matrix combined with this Transform's own
+	 * matrix. World matrices are cached, and only recomputed for the subtree
+	 * below a Transform which changed since the last call.
+	 **/
+	const Matrix4 &getWorldMatrix();
+
+	love::Vector2 transformPointToWorld(love::Vector2 p);
+
 	static bool getConstant(const char *in, MatrixLayout &out);
 	static bool getConstant(MatrixLayout in, const char *&out);
 	static std::vector<std::string> getConstants(MatrixLayout);
@@ -85,11 +107,22 @@ private:
 
 		return inverseMatrix;
 	}
-	
+
+	// Called whenever the local matrix changes.
+	void setDirty();
+	void setWorldDirty();
+
 	Matrix4 matrix;
 	bool inverseDirty;
 	Matrix4 inverseMatrix;
 
+	// Not retained: a child is always released before its parent goes away.
+	Transform *parent;
+	std::vector<StrongRef<Transform>> children;
+
+	bool worldDirty;
+	Matrix4 worldMatrix;
+
 	static StringMap<MatrixLayout, MATRIX_MAX_ENUM>::Entry matrixLayoutEntries[];
 	static StringMap<MatrixLayout, MATRIX_MAX_ENUM> matrixLayouts;
 
@@ -176,15 +176,15 @@ int w_BezierCurve_render(lua_State *L)
 	BezierCurve *curve = luax_checkbeziercurve(L, 1);
 	int accuracy = (int) luaL_optinteger(L, 2, 5);
 
-	std::vector<Vector2> points;
-	luax_catchexcept(L, [&](){ points = curve->render(accuracy); });
+	const std::vector<Vector2> *points = nullptr;
+	luax_catchexcept(L, [&](){ points = &curve->render(accuracy); });
 
-	lua_createtable(L, (int) points.size() * 2, 0);
-	for (int i = 0; i < (int) points.size(); ++i)
+	lua_createtable(L, (int) points->size() * 2, 0);
+	for (int i = 0; i < (int) points->size(); ++i)
 	{
-		lua_pushnumber(L, points[i].x);
+		lua_pushnumber(L, (*points)[i].x);
 		lua_rawseti(L, -2, 2*i+1);
-		lua_pushnumber(L, points[i].y);
+		lua_pushnumber(L, (*points)[i].y);
 		lua_rawseti(L, -2, 2*i+2);
 	}
 
@@ -213,6 +213,65 @@ int w_BezierCurve_renderSegment(lua_State *L)
 	return 1;
 }
 
+int w_BezierCurve_flatten(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double tolerance = luaL_optnumber(L, 2, 0.25);
+
+	const std::vector<Vector2> *points = nullptr;
+	luax_catchexcept(L, [&](){ points = &curve->flatten(tolerance); });
+
+	lua_createtable(L, (int) points->size() * 2, 0);
+	for (int i = 0; i < (int) points->size(); ++i)
+	{
+		lua_pushnumber(L, (*points)[i].x);
+		lua_rawseti(L, -2, 2*i+1);
+		lua_pushnumber(L, (*points)[i].y);
+		lua_rawseti(L, -2, 2*i+2);
+	}
+
+	return 1;
+}
+
+int w_BezierCurve_getLength(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double tolerance = luaL_optnumber(L, 2, 0.25);
+
+	double length = 0.0;
+	luax_catchexcept(L, [&](){ length = curve->getLength(tolerance); });
+
+	lua_pushnumber(L, length);
+	return 1;
+}
+
+int w_BezierCurve_getParameterAtDistance(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double distance = luaL_checknumber(L, 2);
+	double tolerance = luaL_optnumber(L, 3, 0.25);
+
+	double t = 0.0;
+	luax_catchexcept(L, [&](){ t = curve->getParameterAtDistance(distance, tolerance); });
+
+	lua_pushnumber(L, t);
+	return 1;
+}
+
+int w_BezierCurve_evaluateAtDistance(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double distance = luaL_checknumber(L, 2);
+	double tolerance = luaL_optnumber(L, 3, 0.25);
+
+	Vector2 v;
+	luax_catchexcept(L, [&](){ v = curve->evaluateAtDistance(distance, tolerance); });
+
+	lua_pushnumber(L, v.x);
+	lua_pushnumber(L, v.y);
+	return 2;
+}
+
 static const luaL_Reg w_BezierCurve_functions[] =
 {
 	{"getDegree", w_BezierCurve_getDegree},
@@ -229,6 +288,10 @@ static const luaL_Reg w_BezierCurve_functions[] =
 	{"getSegment", w_BezierCurve_getSegment},
 	{"render", w_BezierCurve_render},
 	{"renderSegment", w_BezierCurve_renderSegment},
+	{"flatten", w_BezierCurve_flatten},
+	{"getLength", w_BezierCurve_getLength},
+	{"getParameterAtDistance", w_BezierCurve_getParameterAtDistance},
+	{"evaluateAtDistance", w_BezierCurve_evaluateAtDistance},
 	{ 0, 0 }
 };
 
@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_FloatArray.h"
+#include "wrap_Transform.h"
+#include "data/wrap_Data.h"
+
+namespace love
+{
+namespace math
+{
+
+FloatArray *luax_checkfloatarray(lua_State *L, int idx)
+{
+	return luax_checktype<FloatArray>(L, idx);
+}
+
+// Numbers are used for every element, FloatArrays elementwise.
+static FloatArray::Operand luax_checkoperand(lua_State *L, int idx)
+{
+	if (lua_type(L, idx) == LUA_TNUMBER)
+		return FloatArray::Operand((float) lua_tonumber(L, idx));
+	return FloatArray::Operand(luax_checkfloatarray(L, idx));
+}
+
+static size_t luax_checkindex(lua_State *L, int idx, FloatArray *a)
+{
+	lua_Integer i = luaL_checkinteger(L, idx);
+	if (i < 1 || (size_t) i > a->getCount())
+		luaL_error(L, "Invalid FloatArray index: %d (array has %d values)", (int) i, (int) a->getCount());
+	return (size_t) (i - 1);
+}
+
+int w_FloatArray_clone(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray *c = nullptr;
+	luax_catchexcept(L, [&](){ c = a->clone(); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_FloatArray_getCount(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	lua_pushinteger(L, (lua_Integer) a->getCount());
+	return 1;
+}
+
+int w_FloatArray_get(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	size_t i = luax_checkindex(L, 2, a);
+	lua_pushnumber(L, a->getFloats()[i]);
+	return 1;
+}
+
+int w_FloatArray_set(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	size_t i = luax_checkindex(L, 2, a);
+	a->getFloats()[i] = (float) luaL_checknumber(L, 3);
+	return 0;
+}
+
+int w_FloatArray_fill(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	a->fill((float) luaL_checknumber(L, 2));
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_add(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	luax_catchexcept(L, [&](){ a->add(b); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_subtract(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	luax_catchexcept(L, [&](){ a->subtract(b); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_multiply(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	luax_catchexcept(L, [&](){ a->multiply(b); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_divide(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	luax_catchexcept(L, [&](){ a->divide(b); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_multiplyAdd(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	FloatArray::Operand c = luax_checkoperand(L, 3);
+	luax_catchexcept(L, [&](){ a->multiplyAdd(b, c); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_lerp(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand b = luax_checkoperand(L, 2);
+	FloatArray::Operand t = luax_checkoperand(L, 3);
+	luax_catchexcept(L, [&](){ a->lerp(b, t); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_clamp(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	FloatArray::Operand min = luax_checkoperand(L, 2);
+	FloatArray::Operand max = luax_checkoperand(L, 3);
+	luax_catchexcept(L, [&](){ a->clamp(min, max); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_length(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	int components = (int) luaL_checkinteger(L, 2);
+
+	if (components < 1)
+		return luaL_error(L, "Invalid component count: %d", components);
+
+	StrongRef<FloatArray> dst;
+	if (!lua_isnoneornil(L, 3))
+		dst.set(luax_checkfloatarray(L, 3));
+	else
+		luax_catchexcept(L, [&](){ dst.set(new FloatArray(a->getCount() / components), Acquire::NORETAIN); });
+
+	luax_catchexcept(L, [&](){ a->length(components, dst); });
+
+	luax_pushtype(L, dst.get());
+	return 1;
+}
+
+int w_FloatArray_normalize(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	int components = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ a->normalize(components); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_FloatArray_transform(lua_State *L)
+{
+	FloatArray *a = luax_checkfloatarray(L, 1);
+	Transform *t = luax_checktransform(L, 2);
+	int components = (int) luaL_optinteger(L, 3, 2);
+	luax_catchexcept(L, [&](){ a->transform(t->getWorldMatrix(), components); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+static const luaL_Reg w_FloatArray_functions[] =
+{
+	{ "clone", w_FloatArray_clone },
+	{ "getCount", w_FloatArray_getCount },
+	{ "get", w_FloatArray_get },
+	{ "set", w_FloatArray_set },
+	{ "fill", w_FloatArray_fill },
+	{ "add", w_FloatArray_add },
+	{ "subtract", w_FloatArray_subtract },
+	{ "multiply", w_FloatArray_multiply },
+	{ "divide", w_FloatArray_divide },
+	{ "multiplyAdd", w_FloatArray_multiplyAdd },
+	{ "lerp", w_FloatArray_lerp },
+	{ "clamp", w_FloatArray_clamp },
+	{ "length", w_FloatArray_length },
+	{ "normalize", w_FloatArray_normalize },
+	{ "transform", w_FloatArray_transform },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_floatarray(lua_State *L)
+{
+	int ret = luax_register_type(L, &FloatArray::type, data::w_Data_functions, w_FloatArray_functions, nullptr);
+	love::data::luax_rundatawrapper(L, FloatArray::type);
+	return ret;
+}
+
+} // math
+} // love
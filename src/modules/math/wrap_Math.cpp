@@ -22,9 +22,13 @@
 #include "wrap_RandomGenerator.h"
 #include "wrap_BezierCurve.h"
 #include "wrap_Transform.h"
+#include "wrap_FloatArray.h"
 #include "MathModule.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "FloatArray.h"
+#include "data/ByteData.h"
+#include "data/wrap_Data.h"
 
 #include <cmath>
 #include <iostream>
@@ -145,26 +149,112 @@ int w_newTransform(lua_State *L)
 	return 1;
 }
 
-int w_triangulate(lua_State *L)
+int w_newFloatArray(lua_State *L)
 {
-	std::vector<love::Vector2> vertices;
+	FloatArray *a = nullptr;
+
 	if (lua_istable(L, 1))
 	{
-		int top = (int) luax_objlen(L, 1);
-		vertices.reserve(top / 2);
-		for (int i = 1; i <= top; i += 2)
+		int count = (int) luax_objlen(L, 1);
+
+		// Check the values before the array exists, so an error can't leak it.
+		for (int i = 0; i < count; i++)
 		{
-			lua_rawgeti(L, 1, i);
-			lua_rawgeti(L, 1, i+1);
+			lua_rawgeti(L, 1, i + 1);
+			luaL_optnumber(L, -1, 0.0);
+			lua_pop(L, 1);
+		}
 
-			Vector2 v;
-			v.x = (float) luaL_checknumber(L, -2);
-			v.y = (float) luaL_checknumber(L, -1);
-			vertices.push_back(v);
+		luax_catchexcept(L, [&](){ a = instance()->newFloatArray(count); });
 
-			lua_pop(L, 2);
+		float *values = a->getFloats();
+		for (int i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 1, i + 1);
+			values[i] = (float) lua_tonumber(L, -1);
+			lua_pop(L, 1);
 		}
 	}
+	else if (luax_istype(L, 1, love::Data::type))
+	{
+		love::Data *data = data::luax_checkdata(L, 1);
+		lua_Integer offset = luaL_optinteger(L, 2, 0);
+		if (offset < 0)
+			return luaL_error(L, "Invalid Data offset: %d", (int) offset);
+
+		size_t available = (size_t) offset <= data->getSize() ? (data->getSize() - (size_t) offset) / sizeof(float) : 0;
+		lua_Integer count = luaL_optinteger(L, 3, (lua_Integer) available);
+		if (count < 0)
+			return luaL_error(L, "Invalid FloatArray count: %d", (int) count);
+
+		luax_catchexcept(L, [&](){ a = instance()->newFloatArray(data, (size_t) offset, (size_t) count); });
+	}
+	else
+	{
+		lua_Integer count = luaL_checkinteger(L, 1);
+		if (count < 0)
+			return luaL_error(L, "Invalid FloatArray count: %d", (int) count);
+
+		luax_catchexcept(L, [&](){ a = instance()->newFloatArray((size_t) count); });
+	}
+
+	luax_pushtype(L, a);
+	a->release();
+	return 1;
+}
+
+// Appends the vertices of a flat {x1, y1, x2, y2, ...} table.
+static void checkVertexTable(lua_State *L, int idx, std::vector<love::Vector2> &vertices)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	int top = (int) luax_objlen(L, idx);
+	vertices.reserve(vertices.size() + top / 2);
+	for (int i = 1; i <= top; i += 2)
+	{
+		lua_rawgeti(L, idx, i);
+		lua_rawgeti(L, idx, i+1);
+
+		Vector2 v;
+		v.x = (float) luaL_checknumber(L, -2);
+		v.y = (float) luaL_checknumber(L, -1);
+		vertices.push_back(v);
+
+		lua_pop(L, 2);
+	}
+}
+
+// Appends each hole in a table of vertex tables, recording where they start.
+static void checkHoleTables(lua_State *L, int idx, Polygon &polygon)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, idx);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		polygon.holes.push_back(polygon.vertices.size());
+		checkVertexTable(L, lua_gettop(L), polygon.vertices);
+		lua_pop(L, 1);
+
+		if (polygon.vertices.size() - polygon.holes.back() < 3)
+			luaL_error(L, "Need at least 3 vertices in each hole");
+	}
+}
+
+int w_triangulate(lua_State *L)
+{
+	Polygon polygon;
+	std::vector<love::Vector2> &vertices = polygon.vertices;
+	if (lua_istable(L, 1))
+	{
+		checkVertexTable(L, 1, vertices);
+		if (vertices.size() >= 3)
+			checkHoleTables(L, 2, polygon);
+	}
 	else
 	{
 		int top = (int) lua_gettop(L);
@@ -186,8 +276,15 @@ int w_triangulate(lua_State *L)
 	luax_catchexcept(L, [&]() {
 		if (vertices.size() == 3)
 			triangles.push_back(Triangle(vertices[0], vertices[1], vertices[2]));
-		else
+		else if (polygon.holes.empty())
 			triangles = triangulate(vertices);
+		else
+		{
+			std::vector<uint32> indices;
+			triangulate(vertices.data(), vertices.size(), polygon.holes, indices);
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				triangles.push_back(Triangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]));
+		}
 	});
 
 	lua_createtable(L, (int) triangles.size(), 0);
@@ -215,6 +312,61 @@ int w_triangulate(lua_State *L)
 	return 1;
 }
 
+int w_triangulateBatch(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 1);
+	std::vector<Polygon> polygons(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 1, i + 1);
+		int idx = lua_gettop(L);
+
+		checkVertexTable(L, idx, polygons[i].vertices);
+		if (polygons[i].vertices.size() < 3)
+			return luaL_error(L, "Need at least 3 vertices to triangulate polygon #%d", i + 1);
+
+		lua_getfield(L, idx, "holes");
+		checkHoleTables(L, idx + 1, polygons[i]);
+		lua_pop(L, 2);
+	}
+
+	std::vector<std::vector<uint32>> indices;
+	luax_catchexcept(L, [&](){ triangulate(polygons, indices); });
+
+	// Flat lists of triangle corners: {x1, y1, x2, y2, x3, y3, x1, y1, ...}.
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		const std::vector<love::Vector2> &vertices = polygons[i].vertices;
+		const std::vector<uint32> &tris = indices[i];
+
+		lua_createtable(L, (int) tris.size() * 2, 0);
+		for (int j = 0; j < (int) tris.size(); j++)
+		{
+			const love::Vector2 &v = vertices[tris[j]];
+			lua_pushnumber(L, v.x);
+			lua_rawseti(L, -2, j * 2 + 1);
+			lua_pushnumber(L, v.y);
+			lua_rawseti(L, -2, j * 2 + 2);
+		}
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	// Whether each polygon is convex, e.g. to use it as a physics shape as is.
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushboolean(L, polygons[i].holes.empty() && isConvex(polygons[i].vertices));
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 2;
+}
+
 int w_isConvex(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
@@ -408,6 +560,69 @@ int w_simplexNoise(lua_State* L)
 	return 1;
 }
 
+void luax_checknoisesettings(lua_State *L, int idx, NoiseSettings &s)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "type");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!getConstant(str, s.type))
+			luax_enumerror(L, "noise type", getConstants(s.type), str);
+	}
+	lua_pop(L, 1);
+
+	s.dimensions = luax_intflag(L, idx, "dimensions", s.dimensions);
+	if (s.dimensions < 1 || s.dimensions > 4)
+		luaL_error(L, "Noise dimensions must be between 1 and 4.");
+
+	s.x = luax_numberflag(L, idx, "x", s.x);
+	s.y = luax_numberflag(L, idx, "y", s.y);
+	s.z = luax_numberflag(L, idx, "z", s.z);
+	s.w = luax_numberflag(L, idx, "w", s.w);
+	s.dx = luax_numberflag(L, idx, "dx", s.dx);
+	s.dy = luax_numberflag(L, idx, "dy", s.dy);
+
+	s.octaves = luax_intflag(L, idx, "octaves", s.octaves);
+	if (s.octaves < 1)
+		luaL_error(L, "Noise octave count must be at least 1.");
+
+	s.lacunarity = luax_numberflag(L, idx, "lacunarity", s.lacunarity);
+	s.gain = luax_numberflag(L, idx, "gain", s.gain);
+}
+
+int w_generateNoise(lua_State *L)
+{
+	int width = (int) luaL_checkinteger(L, 1);
+	int height = (int) luaL_optinteger(L, 2, 1);
+	if (width <= 0 || height <= 0)
+		return luaL_error(L, "Invalid noise dimensions: %dx%d", width, height);
+
+	NoiseSettings settings;
+	luax_checknoisesettings(L, 3, settings);
+
+	size_t size = (size_t) width * height * sizeof(float);
+
+	StrongRef<Data> data;
+	if (!lua_isnoneornil(L, 4))
+	{
+		data.set(luax_checktype<Data>(L, 4));
+		if (data->getSize() < size)
+			return luaL_error(L, "Data is too small to hold %dx%d noise values (needs %d bytes.)", width, height, (int) size);
+	}
+	else
+		luax_catchexcept(L, [&](){ data.set(new love::data::ByteData(size, false), Acquire::NORETAIN); });
+
+	luax_catchexcept(L, [&](){ generateNoise(settings, width, height, (float *) data->getData()); });
+
+	luax_pushtype(L, data.get());
+	return 1;
+}
+
 // C functions in a struct, necessary for the FFI versions of math functions.
 struct FFI_Math
 {
@@ -449,13 +664,16 @@ static const luaL_Reg functions[] =
 	{ "newRandomGenerator", w_newRandomGenerator },
 	{ "newBezierCurve", w_newBezierCurve },
 	{ "newTransform", w_newTransform },
+	{ "newFloatArray", w_newFloatArray },
 	{ "triangulate", w_triangulate },
+	{ "triangulateBatch", w_triangulateBatch },
 	{ "isConvex", w_isConvex },
 	{ "gammaToLinear", w_gammaToLinear },
 	{ "linearToGamma", w_linearToGamma },
 	{ "noise", w_noise },
 	{ "perlinNoise", w_perlinNoise },
 	{ "simplexNoise", w_simplexNoise },
+	{ "generateNoise", w_generateNoise },
 
 	{ 0, 0 }
 };
@@ -465,6 +683,7 @@ static const lua_CFunction types[] =
 	luaopen_randomgenerator,
 	luaopen_beziercurve,
 	luaopen_transform,
+	luaopen_floatarray,
 	0
 };
 
@@ -30,6 +30,9 @@ namespace love
 namespace math
 {
 
+struct NoiseSettings;
+
+void luax_checknoisesettings(lua_State *L, int idx, NoiseSettings &settings);
 extern "C" LOVE_EXPORT int luaopen_love_math(lua_State *L);
 
 } // random
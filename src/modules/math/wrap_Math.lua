@@ -42,6 +42,14 @@ function love_math.randomNormal(stddev, mean)
 	return rng:randomNormal(stddev, mean)
 end
 
+function love_math.randomFill(data, l, u)
+	return rng:randomFill(data, l, u)
+end
+
+function love_math.randomNormalFill(data, stddev, mean)
+	return rng:randomNormalFill(data, stddev, mean)
+end
+
 function love_math.setRandomSeed(low, high)
 	return rng:setSeed(low, high)
 end
@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_RandomGenerator.h"
+#include "data/ByteData.h"
 
 #include <cmath>
 #include <algorithm>
@@ -85,6 +86,72 @@ int w_RandomGenerator_randomNormal(lua_State *L)
 	return 1;
 }
 
+// Bulk fills take either a Data to fill with doubles, or a count.
+static void checkFillData(lua_State *L, int idx, StrongRef<Data> &data, size_t &count)
+{
+	if (lua_type(L, idx) == LUA_TNUMBER)
+	{
+		lua_Integer n = luaL_checkinteger(L, idx);
+		if (n < 0)
+			luaL_error(L, "Invalid random number count: %d", (int) n);
+
+		count = (size_t) n;
+		luax_catchexcept(L, [&](){ data.set(new love::data::ByteData(std::max(count, (size_t) 1) * sizeof(double), false), Acquire::NORETAIN); });
+	}
+	else
+	{
+		data.set(luax_checktype<Data>(L, idx));
+		count = data->getSize() / sizeof(double);
+	}
+}
+
+int w_RandomGenerator_randomFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+
+	StrongRef<Data> data;
+	size_t count = 0;
+	checkFillData(L, 2, data, count);
+
+	double *dst = (double *) data->getData();
+
+	// Same ranges as RandomGenerator:random.
+	if (!lua_isnoneornil(L, 4))
+		rng->randomIntegerFill(dst, count, luaL_checknumber(L, 3), luaL_checknumber(L, 4));
+	else if (!lua_isnoneornil(L, 3))
+		rng->randomIntegerFill(dst, count, 1.0, luaL_checknumber(L, 3));
+	else
+		rng->randomFill(dst, count, 0.0, 1.0);
+
+	luax_pushtype(L, data.get());
+	lua_pushinteger(L, (lua_Integer) count);
+	return 2;
+}
+
+int w_RandomGenerator_randomNormalFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+
+	StrongRef<Data> data;
+	size_t count = 0;
+	checkFillData(L, 2, data, count);
+
+	double stddev = luaL_optnumber(L, 3, 1.0);
+	double mean = luaL_optnumber(L, 4, 0.0);
+	rng->randomNormalFill((double *) data->getData(), count, stddev, mean);
+
+	luax_pushtype(L, data.get());
+	lua_pushinteger(L, (lua_Integer) count);
+	return 2;
+}
+
+int w_RandomGenerator_jump(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	rng->jump();
+	return 0;
+}
+
 int w_RandomGenerator_setSeed(lua_State *L)
 {
 	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
@@ -141,6 +208,9 @@ static const luaL_Reg w_RandomGenerator_functions[] =
 {
 	{ "_random", w_RandomGenerator__random }, // random() is defined in wrap_RandomGenerator.lua.
 	{ "randomNormal", w_RandomGenerator_randomNormal },
+	{ "randomFill", w_RandomGenerator_randomFill },
+	{ "randomNormalFill", w_RandomGenerator_randomNormalFill },
+	{ "jump", w_RandomGenerator_jump },
 	{ "setSeed", w_RandomGenerator_setSeed },
 	{ "getSeed", w_RandomGenerator_getSeed },
 	{ "setState", w_RandomGenerator_setState },
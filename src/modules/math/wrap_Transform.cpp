@@ -281,6 +281,65 @@ int w_Transform_inverseTransformPoint(lua_State *L)
 	return 2;
 }
 
+int w_Transform_setParent(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	Transform *parent = nullptr;
+	if (!lua_isnoneornil(L, 2))
+		parent = luax_checktransform(L, 2);
+	luax_catchexcept(L, [&]() { t->setParent(parent); });
+	lua_pushvalue(L, 1);
+	return 1;
+}
+
+int w_Transform_getParent(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	luax_pushtype(L, t->getParent());
+	return 1;
+}
+
+int w_Transform_getChildren(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	const auto &children = t->getChildren();
+
+	lua_createtable(L, (int) children.size(), 0);
+	for (int i = 0; i < (int) children.size(); i++)
+	{
+		luax_pushtype(L, children[i].get());
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_Transform_getWorldMatrix(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	const float *elements = t->getWorldMatrix().getElements();
+
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+			lua_pushnumber(L, elements[column * 4 + row]);
+	}
+
+	return 16;
+}
+
+int w_Transform_transformPointToWorld(lua_State *L)
+{
+	Transform *t = luax_checktransform(L, 1);
+	love::Vector2 p;
+	p.x = (float) luaL_checknumber(L, 2);
+	p.y = (float) luaL_checknumber(L, 3);
+	p = t->transformPointToWorld(p);
+	lua_pushnumber(L, p.x);
+	lua_pushnumber(L, p.y);
+	return 2;
+}
+
 int w_Transform__mul(lua_State *L)
 {
 	Transform *t1 = luax_checktransform(L, 1);
@@ -307,6 +366,11 @@ static const luaL_Reg functions[] =
 	{ "getMatrix", w_Transform_getMatrix },
 	{ "transformPoint", w_Transform_transformPoint },
 	{ "inverseTransformPoint", w_Transform_inverseTransformPoint },
+	{ "setParent", w_Transform_setParent },
+	{ "getParent", w_Transform_getParent },
+	{ "getChildren", w_Transform_getChildren },
+	{ "getWorldMatrix", w_Transform_getWorldMatrix },
+	{ "transformPointToWorld", w_Transform_transformPointToWorld },
 	{ "__mul", w_Transform__mul },
 	{ 0, 0 }
 };
@@ -45,12 +45,13 @@ Body::Body(World *world, b2Vec2 p, Body::Type type)
 	udata->ref = nullptr;
 	b2BodyDef def;
 	def.position = Physics::scaleDown(p);
-	def.userData.pointer = (uintptr_t)udata;
+	def.userData.pointer = (uintptr_t)this;
 	body = world->world->CreateBody(&def);
+	previousPosition = body->GetPosition();
+	previousAngle = body->GetAngle();
 	// Box2D body holds a reference to the love Body.
 	this->retain();
 	this->setType(type);
-	world->registerObject(body, this);
 }
 
 Body::~Body()
@@ -479,7 +480,7 @@ int Body::getFixtures(lua_State *L) const
 	{
 		if (!f)
 			break;
-		Fixture *fixture = (Fixture *)world->findObject(f);
+		Fixture *fixture = World::findFixture(f);
 		if (!fixture)
 			throw love::Exception("A fixture has escaped Memoizer!");
 		luax_pushtype(L, fixture);
@@ -501,7 +502,7 @@ int Body::getJoints(lua_State *L) const
 		if (!je)
 			break;
 
-		Joint *joint = (Joint *) world->findObject(je->joint);
+		Joint *joint = World::findJoint(je->joint);
 		if (!joint)
 			throw love::Exception("A joint has escaped Memoizer!");
 
@@ -550,7 +551,6 @@ void Body::destroy()
 	}
 
 	world->world->DestroyBody(body);
-	world->unregisterObject(body);
 	body = NULL;
 
 	// Remove userdata reference to avoid it sticking around after GC
@@ -566,10 +566,7 @@ int Body::setUserData(lua_State *L)
 	love::luax_assert_argc(L, 1, 1);
 
 	if (udata == nullptr)
-	{
 		udata = new bodyudata();
-		body->GetUserData().pointer = (uintptr_t)udata;
-	}
 
 	if(!udata->ref)
 		udata->ref = new Reference();
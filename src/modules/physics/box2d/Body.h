@@ -68,6 +68,7 @@ public:
 	friend class PolygonShape;
 	friend class Shape;
 	friend class Fixture;
+	friend class World;
 
 	// Public because joints et al ask for b2body
 	b2Body *body;
@@ -443,6 +444,10 @@ private:
 
 	bodyudata *udata;
 
+	// The transform before the World's last fixed step, in Box2D units.
+	b2Vec2 previousPosition;
+	float previousAngle;
+
 }; // Body
 
 } // box2d
@@ -38,18 +38,26 @@ namespace box2d
 love::Type Fixture::type("Fixture", &Object::type);
 
 Fixture::Fixture(Body *body, Shape *shape, float density)
+	: Fixture(body, shape->shape, density, true)
+{
+}
+
+Fixture::Fixture(Body *body, const b2Shape *shape, float density, bool resetMass)
 	: body(body)
 	, fixture(nullptr)
 {
 	udata = new fixtureudata();
 	udata->ref = nullptr;
 	b2FixtureDef def;
-	def.shape = shape->shape;
-	def.userData.pointer = (uintptr_t)udata;
-	def.density = density;
+	def.shape = shape;
+	def.userData.pointer = (uintptr_t)this;
+	// b2Body::CreateFixture only recomputes the mass when the density is
+	// non-zero, so the density is applied afterwards when that's unwanted.
+	def.density = resetMass ? density : 0.0f;
 	fixture = body->body->CreateFixture(&def);
+	if (!resetMass)
+		fixture->SetDensity(density);
 	this->retain();
-	body->world->registerObject(fixture, this);
 }
 
 Fixture::~Fixture()
@@ -260,10 +268,7 @@ int Fixture::setUserData(lua_State *L)
 	love::luax_assert_argc(L, 1, 1);
 
 	if (udata == nullptr)
-	{
 		udata = new fixtureudata();
-		fixture->GetUserData().pointer = (uintptr_t)udata;
-	}
 
 	if(!udata->ref)
 		udata->ref = new Reference();
@@ -348,7 +353,6 @@ void Fixture::destroy(bool implicit)
 
 	if (!implicit && fixture != nullptr)
 		body->body->DestroyFixture(fixture);
-	body->world->unregisterObject(fixture);
 	fixture = nullptr;
 
 	// Remove userdata reference to avoid it sticking around after GC
@@ -70,6 +70,13 @@ public:
 	 **/
 	Fixture(Body *body, Shape *shape, float density);
 
+	/**
+	 * Creates a Fixture from a raw Box2D shape, which is copied. With
+	 * resetMass false the Body's mass is left for the caller to recompute,
+	 * so many Fixtures can be added without updating it every time.
+	 **/
+	Fixture(Body *body, const b2Shape *shape, float density, bool resetMass);
+
 	virtual ~Fixture();
 
 	/**
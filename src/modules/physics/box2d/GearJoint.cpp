@@ -68,7 +68,7 @@ Joint *GearJoint::getJointA() const
 	if (b2joint == nullptr)
 		return nullptr;
 
-	Joint *j = (Joint *) world->findObject(b2joint);
+	Joint *j = World::findJoint(b2joint);
 	if (j == nullptr)
 		throw love::Exception("A joint has escaped Memoizer!");
 
@@ -81,7 +81,7 @@ Joint *GearJoint::getJointB() const
 	if (b2joint == nullptr)
 		return nullptr;
 
-	Joint *j = (Joint *) world->findObject(b2joint);
+	Joint *j = World::findJoint(b2joint);
 	if (j == nullptr)
 		throw love::Exception("A joint has escaped Memoizer!");
 
@@ -104,7 +104,7 @@ Body *Joint::getBodyA() const
 	if (b2body == nullptr)
 		return nullptr;
 
-	Body *body = (Body *) world->findObject(b2body);
+	Body *body = World::findBody(b2body);
 	if (body == nullptr)
 		throw love::Exception("A body has escaped Memoizer!");
 
@@ -117,7 +117,7 @@ Body *Joint::getBodyB() const
 	if (b2body == nullptr)
 		return nullptr;
 
-	Body *body = (Body *) world->findObject(b2body);
+	Body *body = World::findBody(b2body);
 	if (body == nullptr)
 		throw love::Exception("A body has escaped Memoizer!");
 
@@ -154,9 +154,8 @@ float Joint::getReactionTorque(float dt)
 
 b2Joint *Joint::createJoint(b2JointDef *def)
 {
-	def->userData.pointer = (uintptr_t)udata;
+	def->userData.pointer = (uintptr_t)this;
 	joint = world->world->CreateJoint(def);
-	world->registerObject(joint, this);
 	// Box2D joint has a reference to this love Joint.
 	this->retain();
 	return joint;
@@ -174,7 +173,6 @@ void Joint::destroyJoint(bool implicit)
 
 	if (!implicit && joint != nullptr)
 		world->world->DestroyJoint(joint);
-	world->unregisterObject(joint);
 	joint = NULL;
 
 	// Remove userdata reference to avoid it sticking around after GC
@@ -200,10 +198,7 @@ int Joint::setUserData(lua_State *L)
 	love::luax_assert_argc(L, 1, 1);
 
 	if (udata == nullptr)
-	{
 		udata = new jointudata();
-		joint->GetUserData().pointer = (uintptr_t)udata;
-	}
 
 	if(!udata->ref)
 		udata->ref = new Reference();
@@ -313,6 +313,58 @@ Fixture *Physics::newFixture(Body *body, Shape *shape, float density)
 	return new Fixture(body, shape, density);
 }
 
+template <typename F>
+static void createFixturesBulk(Body *body, int count, float density, std::vector<Fixture *> &fixtures, F create)
+{
+	World *world = body->getWorld();
+	if (world->isLocked())
+		throw love::Exception("World is locked.");
+
+	size_t first = fixtures.size();
+	fixtures.reserve(first + count);
+
+	world->beginBulkCreate();
+	try
+	{
+		for (int i = 0; i < count; i++)
+			fixtures.push_back(create(i));
+	}
+	catch (...)
+	{
+		// Fixtures created so far stay attached to the Body.
+		for (size_t i = first; i < fixtures.size(); i++)
+			fixtures[i]->release();
+		fixtures.resize(first);
+
+		world->endBulkCreate();
+		body->resetMassData();
+		throw;
+	}
+	world->endBulkCreate();
+
+	if (density != 0.0f)
+		body->resetMassData();
+}
+
+void Physics::newFixtures(Body *body, const std::vector<Shape *> &shapes, float density, std::vector<Fixture *> &fixtures)
+{
+	createFixturesBulk(body, (int) shapes.size(), density, fixtures, [&](int i)
+	{
+		return new Fixture(body, shapes[i]->shape, density, false);
+	});
+}
+
+void Physics::newRectangleFixtures(Body *body, const float *rects, int count, float density, std::vector<Fixture *> &fixtures)
+{
+	createFixturesBulk(body, count, density, fixtures, [&](int i)
+	{
+		const float *r = rects + i * 4;
+		b2PolygonShape s;
+		s.SetAsBox(Physics::scaleDown(r[2]/2.0f), Physics::scaleDown(r[3]/2.0f), Physics::scaleDown(b2Vec2(r[0], r[1])), 0.0f);
+		return new Fixture(body, &s, density, false);
+	});
+}
+
 int Physics::getDistance(lua_State *L)
 {
 	Fixture *fixtureA = luax_checktype<Fixture>(L, 1);
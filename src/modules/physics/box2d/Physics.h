@@ -282,6 +282,19 @@ public:
 
 	Fixture *newFixture(Body *body, Shape *shape, float density);
 
+	/**
+	 * Creates a Fixture on body for each shape. The broad-phase is built in
+	 * one pass and the Body's mass is only computed once at the end.
+	 * @param[out] fixtures Receives the new Fixtures, each with one reference.
+	 **/
+	void newFixtures(Body *body, const std::vector<Shape *> &shapes, float density, std::vector<Fixture *> &fixtures);
+
+	/**
+	 * Like newFixtures, but creates an axis-aligned box Fixture for each rect
+	 * in rects, given as (center x, center y, width, height) groups of four.
+	 **/
+	void newRectangleFixtures(Body *body, const float *rects, int count, float density, std::vector<Fixture *> &fixtures);
+
 	/**
 	 * Calculates the distance between two Fixtures.
 	 * @param fixtureA The first Fixture.
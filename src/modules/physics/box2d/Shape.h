@@ -46,6 +46,7 @@ class Shape : public love::physics::Shape
 public:
 
 	friend class Fixture;
+	friend class Physics;
 
 	/**
 	 * Creates a Shape.
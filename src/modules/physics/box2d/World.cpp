@@ -25,6 +25,13 @@
 #include "Contact.h"
 #include "Physics.h"
 #include "common/Reference.h"
+#include "common/Trace.h"
+#include "thread/JobSystem.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
@@ -60,7 +67,7 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 
 		// Push first fixture.
 		{
-			Fixture *a = (Fixture *)world->findObject(contact->GetFixtureA());
+			Fixture *a = findFixture(contact->GetFixtureA());
 			if (a != nullptr)
 				luax_pushtype(L, a);
 			else
@@ -69,7 +76,7 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 
 		// Push second fixture.
 		{
-			Fixture *b = (Fixture *)world->findObject(contact->GetFixtureB());
+			Fixture *b = findFixture(contact->GetFixtureB());
 			if (b != nullptr)
 				luax_pushtype(L, b);
 			else
@@ -158,7 +165,7 @@ bool World::QueryCallback::ReportFixture(b2Fixture *fixture)
 	if (L != nullptr)
 	{
 		lua_pushvalue(L, funcidx);
-		Fixture *f = (Fixture *)world->findObject(fixture);
+		Fixture *f = findFixture(fixture);
 		if (!f)
 			throw love::Exception("A fixture has escaped Memoizer!");
 		luax_pushtype(L, f);
@@ -184,7 +191,7 @@ World::CollectCallback::~CollectCallback()
 
 bool World::CollectCallback::ReportFixture(b2Fixture *f)
 {
-	Fixture *fixture = (Fixture *)world->findObject(f);
+	Fixture *fixture = findFixture(f);
 	if (!fixture)
 		throw love::Exception("A fixture has escaped Memoizer!");
 	luax_pushtype(L, fixture);
@@ -210,7 +217,7 @@ float World::RayCastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &po
 	if (L != nullptr)
 	{
 		lua_pushvalue(L, funcidx);
-		Fixture *f = (Fixture *)world->findObject(fixture);
+		Fixture *f = findFixture(fixture);
 		if (!f)
 			throw love::Exception("A fixture has escaped Memoizer!");
 		luax_pushtype(L, f);
@@ -233,18 +240,26 @@ float World::RayCastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &po
 
 void World::SayGoodbye(b2Fixture *fixture)
 {
-	Fixture *f = (Fixture *)findObject(fixture);
+	Fixture *f = findFixture(fixture);
 	// Hint implicit destruction with true.
 	if (f) f->destroy(true);
 }
 
 void World::SayGoodbye(b2Joint *joint)
 {
-	Joint *j = (Joint *)findObject(joint);
+	Joint *j = findJoint(joint);
 	// Hint implicit destruction with true.
 	if (j) j->destroyJoint(true);
 }
 
+void World::TaskExecutor::ParallelFor(int32 count, int32 minRange, b2TaskFunction *task, void *context)
+{
+	love::thread::JobSystem::getInstance()->parallelFor((size_t) count, (size_t) minRange, [&](size_t begin, size_t end)
+	{
+		task((int32) begin, (int32) end, context);
+	});
+}
+
 World::World()
 	: world(nullptr)
 	, destructWorld(false)
@@ -252,6 +267,10 @@ World::World()
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, bufferContactEvents(false)
+	, fixedTimestep(0.0f)
+	, maxFixedSteps(8)
+	, accumulator(0.0)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -270,6 +289,10 @@ World::World(b2Vec2 gravity, bool sleep)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, bufferContactEvents(false)
+	, fixedTimestep(0.0f)
+	, maxFixedSteps(8)
+	, accumulator(0.0)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -292,6 +315,103 @@ void World::update(float dt)
 }
 
 void World::update(float dt, int velocityIterations, int positionIterations)
+{
+	LOVE_TRACE_ZONE("World::update");
+
+	if (fixedTimestep <= 0.0f)
+	{
+		step(dt, velocityIterations, positionIterations);
+		return;
+	}
+
+	accumulator += dt;
+
+	int steps = std::min((int) (accumulator / fixedTimestep), maxFixedSteps);
+	accumulator -= steps * (double) fixedTimestep;
+
+	// Don't let a backlog the step limit couldn't get through carry over.
+	if (accumulator >= fixedTimestep)
+		accumulator = fmod(accumulator, (double) fixedTimestep);
+
+	for (int i = 0; i < steps && world != nullptr; i++)
+	{
+		// Interpolation only needs the transforms from before the last step.
+		if (i == steps - 1)
+		{
+			for (b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+			{
+				Body *body = findBody(b);
+				if (body != nullptr)
+				{
+					body->previousPosition = b->GetPosition();
+					body->previousAngle = b->GetAngle();
+				}
+			}
+		}
+
+		step(fixedTimestep, velocityIterations, positionIterations);
+	}
+}
+
+void World::setFixedTimestep(float dt, int maxSteps)
+{
+	if (dt < 0.0f)
+		throw love::Exception("The fixed timestep must not be negative.");
+	if (maxSteps < 1)
+		throw love::Exception("The maximum number of fixed steps must be at least 1.");
+
+	fixedTimestep = dt;
+	maxFixedSteps = maxSteps;
+	accumulator = 0.0;
+}
+
+float World::getFixedTimestep(int &maxSteps) const
+{
+	maxSteps = maxFixedSteps;
+	return fixedTimestep;
+}
+
+float World::getInterpolationAlpha() const
+{
+	if (fixedTimestep <= 0.0f)
+		return 1.0f;
+	return std::min((float) (accumulator / fixedTimestep), 1.0f);
+}
+
+void World::getInterpolatedBodyStates(Body * const *bodies, int count, float *states) const
+{
+	float alpha = getInterpolationAlpha();
+
+	auto write = [&](const Body *body)
+	{
+		const b2Body *b = body->body;
+		b2Vec2 p = body->previousPosition + alpha * (b->GetPosition() - body->previousPosition);
+		p = Physics::scaleUp(p);
+		states[0] = p.x;
+		states[1] = p.y;
+		states[2] = body->previousAngle + alpha * (b->GetAngle() - body->previousAngle);
+		states += 3;
+	};
+
+	if (bodies == nullptr)
+	{
+		for (b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+		{
+			if (b != groundBody)
+				write(findBody(b));
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (bodies[i]->body->GetWorld() != world)
+			throw love::Exception("Body does not belong to this World.");
+		write(bodies[i]);
+	}
+}
+
+void World::step(float dt, int velocityIterations, int positionIterations)
 {
 	world->Step(dt, velocityIterations, positionIterations);
 
@@ -322,14 +442,41 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 		destroy();
 }
 
+void World::recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	Fixture *a = findFixture(contact->GetFixtureA());
+	Fixture *b = findFixture(contact->GetFixtureB());
+	if (a == nullptr || b == nullptr)
+		throw love::Exception("A fixture has escaped Memoizer!");
+
+	contactEvents.emplace_back();
+	ContactEvent &event = contactEvents.back();
+	event.type = type;
+	event.a.set(a);
+	event.b.set(b);
+	event.impulseCount = impulse != nullptr ? impulse->count : 0;
+
+	for (int i = 0; i < event.impulseCount; i++)
+	{
+		event.normalImpulses[i] = Physics::scaleUp(impulse->normalImpulses[i]);
+		event.tangentImpulses[i] = Physics::scaleUp(impulse->tangentImpulses[i]);
+	}
+}
+
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (bufferContactEvents)
+		recordContactEvent(CONTACT_EVENT_BEGIN, contact, nullptr);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (bufferContactEvents)
+		recordContactEvent(CONTACT_EVENT_END, contact, nullptr);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
 	Contact *c = (Contact *)findObject(contact);
@@ -345,14 +492,17 @@ void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (bufferContactEvents)
+		recordContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+	else
+		postsolve.process(contact, impulse);
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
 {
 	// Fixtures should be memoized, if we created them
-	Fixture *a = (Fixture *)findObject(fixtureA);
-	Fixture *b = (Fixture *)findObject(fixtureB);
+	Fixture *a = findFixture(fixtureA);
+	Fixture *b = findFixture(fixtureB);
 	if (!a || !b)
 		throw love::Exception("A fixture has escaped Memoizer!");
 	return filter.process(a, b);
@@ -430,6 +580,54 @@ void World::setCallbacksL(lua_State *L)
 	begin.L = end.L = presolve.L = postsolve.L = filter.L = L;
 }
 
+void World::setContactEventsBuffered(bool buffered)
+{
+	bufferContactEvents = buffered;
+	if (!buffered)
+		contactEvents.clear();
+}
+
+bool World::isContactEventsBuffered() const
+{
+	return bufferContactEvents;
+}
+
+int World::getContactEvents(lua_State *L)
+{
+	lua_createtable(L, (int) contactEvents.size(), 0);
+
+	for (size_t i = 0; i < contactEvents.size(); i++)
+	{
+		const ContactEvent &event = contactEvents[i];
+
+		lua_createtable(L, 3 + event.impulseCount * 2, 0);
+
+		const char *typestr = nullptr;
+		getConstant(event.type, typestr);
+		lua_pushstring(L, typestr);
+		lua_rawseti(L, -2, 1);
+
+		luax_pushtype(L, event.a.get());
+		lua_rawseti(L, -2, 2);
+
+		luax_pushtype(L, event.b.get());
+		lua_rawseti(L, -2, 3);
+
+		for (int c = 0; c < event.impulseCount; c++)
+		{
+			lua_pushnumber(L, event.normalImpulses[c]);
+			lua_rawseti(L, -2, 4 + c * 2);
+			lua_pushnumber(L, event.tangentImpulses[c]);
+			lua_rawseti(L, -2, 5 + c * 2);
+		}
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	contactEvents.clear();
+	return 1;
+}
+
 int World::setContactFilter(lua_State *L)
 {
 	if (!lua_isnoneornil(L, 1))
@@ -476,6 +674,16 @@ bool World::isSleepingAllowed() const
 	return world->GetAllowSleeping();
 }
 
+void World::setMultithreaded(bool enable)
+{
+	world->SetTaskExecutor(enable ? &executor : nullptr);
+}
+
+bool World::isMultithreaded() const
+{
+	return world->GetTaskExecutor() != nullptr;
+}
+
 bool World::isLocked() const
 {
 	return world->IsLocked();
@@ -507,7 +715,7 @@ int World::getBodies(lua_State *L) const
 			break;
 		if (b == groundBody)
 			continue;
-		Body *body = (Body *)findObject(b);
+		Body *body = findBody(b);
 		if (!body)
 			throw love::Exception("A body has escaped Memoizer!");
 		luax_pushtype(L, body);
@@ -518,6 +726,136 @@ int World::getBodies(lua_State *L) const
 	return 1;
 }
 
+void World::getBodyStates(Body * const *bodies, int count, float *states) const
+{
+	auto write = [&](const b2Body *b)
+	{
+		b2Vec2 p = Physics::scaleUp(b->GetPosition());
+		b2Vec2 v = Physics::scaleUp(b->GetLinearVelocity());
+		states[0] = p.x;
+		states[1] = p.y;
+		states[2] = b->GetAngle();
+		states[3] = v.x;
+		states[4] = v.y;
+		states[5] = b->GetAngularVelocity();
+		states += BODY_STATE_COMPONENTS;
+	};
+
+	if (bodies == nullptr)
+	{
+		for (const b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+		{
+			if (b != groundBody)
+				write(b);
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (bodies[i]->body->GetWorld() != world)
+			throw love::Exception("Body does not belong to this World.");
+		write(bodies[i]->body);
+	}
+}
+
+void World::setBodyStates(Body * const *bodies, int count, const float *states)
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	auto read = [&](b2Body *b)
+	{
+		b2Vec2 p = Physics::scaleDown(b2Vec2(states[0], states[1]));
+		float angle = states[2];
+
+		// Moving a body updates its broad-phase proxies, so only do it when
+		// the transform actually changed.
+		if (p != b->GetPosition() || angle != b->GetAngle())
+			b->SetTransform(p, angle);
+
+		b->SetLinearVelocity(Physics::scaleDown(b2Vec2(states[3], states[4])));
+		b->SetAngularVelocity(states[5]);
+		states += BODY_STATE_COMPONENTS;
+	};
+
+	if (bodies == nullptr)
+	{
+		for (b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+		{
+			if (b != groundBody)
+				read(b);
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (bodies[i]->body->GetWorld() != world)
+			throw love::Exception("Body does not belong to this World.");
+		read(bodies[i]->body);
+	}
+}
+
+size_t World::getStateSize() const
+{
+	return (size_t) world->SaveState(nullptr);
+}
+
+void World::saveState(void *data) const
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	world->SaveState(data);
+}
+
+void World::beginBulkCreate()
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	world->BeginBulkCreate();
+}
+
+void World::endBulkCreate()
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	world->EndBulkCreate();
+}
+
+void World::rebuildBroadPhase()
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	world->RebuildBroadPhase();
+}
+
+void World::restoreState(const void *data, size_t size)
+{
+	if (world->IsLocked())
+		throw love::Exception("World is locked.");
+
+	// Contact objects still point at the current b2Contacts, which are
+	// destroyed when the saved contacts are put back.
+	std::vector<Contact *> contacts;
+	for (b2Contact *c = world->GetContactList(); c; c = c->GetNext())
+	{
+		Contact *contact = (Contact *)findObject(c);
+		if (contact != nullptr)
+			contacts.push_back(contact);
+	}
+
+	if (size > (size_t) std::numeric_limits<int32>::max() || !world->RestoreState(data, (int32) size))
+		throw love::Exception("The state does not match this World's bodies, fixtures and joints.");
+
+	for (Contact *contact : contacts)
+		contact->invalidate();
+}
+
 int World::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -526,7 +864,7 @@ int World::getJoints(lua_State *L) const
 	do
 	{
 		if (!j) break;
-		Joint *joint = (Joint *)findObject(j);
+		Joint *joint = findJoint(j);
 		if (!joint) throw love::Exception("A joint has escaped Memoizer!");
 		luax_pushjoint(L, joint);
 		lua_rawseti(L, -2, i);
@@ -606,6 +944,138 @@ int World::rayCast(lua_State *L)
 	return 0;
 }
 
+namespace
+{
+
+// Rays and boxes per job in the batched queries.
+const int QUERY_BATCH_SIZE = 64;
+
+class BatchRayCastCallback : public b2RayCastCallback
+{
+public:
+
+	BatchRayCastCallback(World::RayCastHit &hit, World::RayCastMode mode)
+		: hit(hit)
+		, mode(mode)
+	{
+	}
+
+	float ReportFixture(b2Fixture *fixture, const b2Vec2 &point, const b2Vec2 &normal, float fraction) override
+	{
+		hit.fixture = World::findFixture(fixture);
+		if (hit.fixture == nullptr)
+			throw love::Exception("A fixture has escaped Memoizer!");
+
+		b2Vec2 p = Physics::scaleUp(point);
+		hit.x = p.x;
+		hit.y = p.y;
+		hit.nx = normal.x;
+		hit.ny = normal.y;
+		hit.fraction = fraction;
+
+		// Clipping the ray to this hit leaves the closest one at the end.
+		return mode == World::RAYCAST_ANY ? 0.0f : fraction;
+	}
+
+private:
+
+	World::RayCastHit &hit;
+	World::RayCastMode mode;
+};
+
+class BatchQueryCallback : public b2QueryCallback
+{
+public:
+
+	BatchQueryCallback(std::vector<Fixture *> &fixtures)
+		: fixtures(fixtures)
+	{
+	}
+
+	bool ReportFixture(b2Fixture *fixture) override
+	{
+		Fixture *f = World::findFixture(fixture);
+		if (f == nullptr)
+			throw love::Exception("A fixture has escaped Memoizer!");
+		fixtures.push_back(f);
+		return true;
+	}
+
+private:
+
+	std::vector<Fixture *> &fixtures;
+};
+
+} // anonymous namespace
+
+void World::rayCastBatch(const float *rays, int count, RayCastMode mode, RayCastHit *hits) const
+{
+	auto cast = [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const float *ray = rays + i * 4;
+			RayCastHit &hit = hits[i];
+			hit = RayCastHit();
+
+			b2Vec2 v1 = Physics::scaleDown(b2Vec2(ray[0], ray[1]));
+			b2Vec2 v2 = Physics::scaleDown(b2Vec2(ray[2], ray[3]));
+
+			// Box2D asserts on zero-length rays.
+			if (v1 == v2)
+				continue;
+
+			BatchRayCastCallback callback(hit, mode);
+			world->RayCast(&callback, v1, v2);
+		}
+	};
+
+	if (isMultithreaded())
+		love::thread::JobSystem::getInstance()->parallelFor((size_t) count, QUERY_BATCH_SIZE, cast);
+	else
+		cast(0, (size_t) count);
+}
+
+void World::queryBoundingBoxBatch(const float *boxes, int count, std::vector<Fixture *> &fixtures, std::vector<int> &counts) const
+{
+	counts.resize(count);
+
+	// Each job collects into its own list, and the lists are joined in box
+	// order afterwards.
+	int jobs = (count + QUERY_BATCH_SIZE - 1) / QUERY_BATCH_SIZE;
+	std::vector<std::vector<Fixture *>> results(jobs);
+
+	auto query = [&](size_t begin, size_t end)
+	{
+		for (size_t job = begin; job < end; job++)
+		{
+			BatchQueryCallback callback(results[job]);
+			int last = std::min((int) job * QUERY_BATCH_SIZE + QUERY_BATCH_SIZE, count);
+
+			for (int i = (int) job * QUERY_BATCH_SIZE; i < last; i++)
+			{
+				const float *box = boxes + i * 4;
+				b2AABB aabb;
+				aabb.lowerBound = Physics::scaleDown(b2Vec2(box[0], box[1]));
+				aabb.upperBound = Physics::scaleDown(b2Vec2(box[2], box[3]));
+
+				size_t before = results[job].size();
+				world->QueryAABB(&callback, aabb);
+				counts[i] = (int) (results[job].size() - before);
+			}
+		}
+	};
+
+	if (isMultithreaded())
+		love::thread::JobSystem::getInstance()->parallelFor((size_t) jobs, 1, query);
+	else
+		query(0, (size_t) jobs);
+
+	fixtures.clear();
+	for (const auto &result : results)
+		fixtures.insert(fixtures.end(), result.begin(), result.end());
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
@@ -635,7 +1105,7 @@ void World::destroy()
 		b = b->GetNext();
 		if (t == groundBody)
 			continue;
-		Body *body = (Body *)findObject(t);
+		Body *body = findBody(t);
 		if (!body)
 			throw love::Exception("A body has escaped Memoizer!");
 		body->destroy();
@@ -646,6 +1116,8 @@ void World::destroy()
 
 	delete world;
 	world = nullptr;
+
+	contactEvents.clear();
 }
 
 void World::registerObject(void *b2object, love::Object *object)
@@ -667,6 +1139,21 @@ love::Object *World::findObject(void *b2object) const
 		return nullptr;
 }
 
+STRINGMAP_CLASS_BEGIN(World, World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM, contactEventType)
+{
+	{ "begin",     World::CONTACT_EVENT_BEGIN     },
+	{ "end",       World::CONTACT_EVENT_END       },
+	{ "postsolve", World::CONTACT_EVENT_POSTSOLVE },
+}
+STRINGMAP_CLASS_END(World, World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM, contactEventType)
+
+STRINGMAP_CLASS_BEGIN(World, World::RayCastMode, World::RAYCAST_MAX_ENUM, rayCastMode)
+{
+	{ "closest", World::RAYCAST_CLOSEST },
+	{ "any",     World::RAYCAST_ANY     },
+}
+STRINGMAP_CLASS_END(World, World::RayCastMode, World::RAYCAST_MAX_ENUM, rayCastMode)
+
 } // box2d
 } // physics
 } // love
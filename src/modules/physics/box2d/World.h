@@ -25,6 +25,7 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/StringMap.h"
 
 // STD
 #include <vector>
@@ -69,6 +70,51 @@ public:
 
 	static love::Type type;
 
+	// Number of floats per body in getBodyStates and setBodyStates: x, y,
+	// angle, linear velocity x and y, and angular velocity.
+	static const int BODY_STATE_COMPONENTS = 6;
+
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_POSTSOLVE,
+		CONTACT_EVENT_MAX_ENUM
+	};
+
+	/**
+	 * A begin, end or postsolve event recorded during update, when contact
+	 * events are buffered.
+	 **/
+	struct ContactEvent
+	{
+		ContactEventType type;
+		StrongRef<Fixture> a;
+		StrongRef<Fixture> b;
+		int impulseCount;
+		float normalImpulses[b2_maxManifoldPoints];
+		float tangentImpulses[b2_maxManifoldPoints];
+	};
+
+	enum RayCastMode
+	{
+		RAYCAST_CLOSEST,
+		RAYCAST_ANY,
+		RAYCAST_MAX_ENUM
+	};
+
+	/**
+	 * The result of one ray in rayCastBatch. The fixture is null if the ray
+	 * didn't hit anything.
+	 **/
+	struct RayCastHit
+	{
+		Fixture *fixture;
+		float x, y;
+		float nx, ny;
+		float fraction;
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -126,6 +172,15 @@ public:
 		int funcidx;
 	};
 
+	/**
+	 * Runs Box2D's parallel work on love's job system.
+	 **/
+	class TaskExecutor : public b2TaskExecutor
+	{
+	public:
+		void ParallelFor(int32 count, int32 minRange, b2TaskFunction *task, void *context) override;
+	};
+
 	/**
 	 * Creates a new world.
 	 **/
@@ -151,6 +206,30 @@ public:
 	void update(float dt);
 	void update(float dt, int velocityIterations, int positionIterations);
 
+	/**
+	 * Makes update advance the simulation in steps of a fixed length. The
+	 * time passed to update is accumulated, and as many whole steps as fit
+	 * are taken, up to maxSteps per update. Any further backlog is dropped.
+	 * @param dt The length of each step, or 0 to step by the time passed
+	 *           to update instead.
+	 * @param maxSteps The most steps a single update may take.
+	 **/
+	void setFixedTimestep(float dt, int maxSteps);
+	float getFixedTimestep(int &maxSteps) const;
+
+	/**
+	 * Returns how far the accumulated time is between the last fixed step
+	 * and the next one, from 0 to 1. Always 1 without a fixed timestep.
+	 **/
+	float getInterpolationAlpha() const;
+
+	/**
+	 * Writes the position and angle of bodies, interpolated between the
+	 * last two fixed steps, into a packed array of three floats per body:
+	 * x, y and angle. Bodies are selected as in getBodyStates.
+	 **/
+	void getInterpolatedBodyStates(Body * const *bodies, int count, float *states) const;
+
 	// From b2ContactListener
 	void BeginContact(b2Contact *contact);
 	void EndContact(b2Contact *contact);
@@ -189,6 +268,27 @@ public:
 	 **/
 	void setCallbacksL(lua_State *L);
 
+	/**
+	 * Sets whether begin, end and postsolve events are recorded during update
+	 * instead of calling the Lua callbacks, to be fetched afterwards with
+	 * getContactEvents. Presolve and the contact filter are always called
+	 * directly, since they can change the outcome of the step.
+	 **/
+	void setContactEventsBuffered(bool buffered);
+	bool isContactEventsBuffered() const;
+
+	/**
+	 * Pushes a table with every event recorded since the last call, in the
+	 * order they happened, and clears the buffer. Each event is an array in
+	 * the form of the matching callback's arguments, with the event type in
+	 * place of the Contact: {type, fixtureA, fixtureB, normalimpulse1,
+	 * tangentimpulse1, ...}.
+	 **/
+	int getContactEvents(lua_State *L);
+
+	STRINGMAP_CLASS_DECLARE(ContactEventType);
+	STRINGMAP_CLASS_DECLARE(RayCastMode);
+
 	/**
 	 * Sets the ContactFilter callback.
 	 **/
@@ -232,6 +332,20 @@ public:
 	 **/
 	bool isSleepingAllowed() const;
 
+	/**
+	 * Sets whether update solves independent groups of touching or jointed
+	 * bodies, and finds new contacts, on several threads. The simulation is
+	 * the same either way, but postSolve callbacks are only made once every
+	 * group has been solved.
+	 * @param enable True to use the job system's threads.
+	 **/
+	void setMultithreaded(bool enable);
+
+	/**
+	 * Returns whether this World steps on several threads.
+	 **/
+	bool isMultithreaded() const;
+
 	/**
 	 * Returns whether this World is currently locked.
 	 * If it's locked, it's in the middle of a timestep.
@@ -263,6 +377,55 @@ public:
 	 **/
 	int getBodies(lua_State *L) const;
 
+	/**
+	 * Writes the position, angle and velocities of bodies into a packed array
+	 * of BODY_STATE_COMPONENTS floats per body.
+	 * @param bodies The bodies to read, or null for all bodies in the same
+	 *               order as getBodies.
+	 * @param count The number of bodies in the list. Ignored for all bodies.
+	 * @param states Receives the states. Must have room for every body.
+	 **/
+	void getBodyStates(Body * const *bodies, int count, float *states) const;
+
+	/**
+	 * Sets the position, angle and velocities of bodies from a packed array
+	 * in the layout written by getBodyStates.
+	 **/
+	void setBodyStates(Body * const *bodies, int count, const float *states);
+
+	/**
+	 * Gets the number of bytes saveState currently writes.
+	 **/
+	size_t getStateSize() const;
+
+	/**
+	 * Writes the complete simulation state of the World (body motion, fixture
+	 * properties, joint solver data, contacts and the broad-phase) so it can be
+	 * restored later, e.g. for rollback.
+	 * @param data Receives the state. Must have room for getStateSize bytes.
+	 **/
+	void saveState(void *data) const;
+
+	/**
+	 * Restores a state written by saveState. The World must still contain the
+	 * same Bodies, Fixtures and Joints; no objects are created or destroyed
+	 * apart from Contacts, which are replaced by the saved ones.
+	 **/
+	void restoreState(const void *data, size_t size);
+
+	/**
+	 * Starts adding many Fixtures at once. Their broad-phase proxies are not
+	 * inserted into the tree until endBulkCreate, which builds it top-down.
+	 **/
+	void beginBulkCreate();
+	void endBulkCreate();
+
+	/**
+	 * Rebuilds the broad-phase tree top-down from its current proxies, e.g.
+	 * after a large number of static Fixtures were added incrementally.
+	 **/
+	void rebuildBroadPhase();
+
 	/**
 	 * Get an array of all the Joints in the World.
 	 * @return An array of Joints.
@@ -296,6 +459,25 @@ public:
 	 **/
 	int rayCast(lua_State *L);
 
+	/**
+	 * Casts many rays at once. The queries are read-only, so they're spread
+	 * over the job system's threads when the World is multithreaded.
+	 * @param rays Four floats per ray: x1, y1, x2, y2.
+	 * @param count The number of rays.
+	 * @param mode Whether to find the closest hit, or stop at the first one.
+	 * @param hits Receives one result per ray.
+	 **/
+	void rayCastBatch(const float *rays, int count, RayCastMode mode, RayCastHit *hits) const;
+
+	/**
+	 * Finds the fixtures overlapping each of many bounding boxes.
+	 * @param boxes Four floats per box: lower x, lower y, upper x, upper y.
+	 * @param count The number of boxes.
+	 * @param fixtures Receives the fixtures of every box, one box after another.
+	 * @param counts Receives the number of fixtures found for each box.
+	 **/
+	void queryBoundingBoxBatch(const float *boxes, int count, std::vector<Fixture *> &fixtures, std::vector<int> &counts) const;
+
 	/**
 	 * Destroy this world.
 	 **/
@@ -305,8 +487,20 @@ public:
 	void unregisterObject(void *b2object);
 	love::Object *findObject(void *b2object) const;
 
+	/**
+	 * Box2D bodies, fixtures and joints point to their love objects through
+	 * their user data, so these don't need a map lookup. They return null for
+	 * objects created outside of love, like the ground body.
+	 **/
+	static Body *findBody(b2Body *body) { return (Body *) body->GetUserData().pointer; }
+	static Fixture *findFixture(b2Fixture *fixture) { return (Fixture *) fixture->GetUserData().pointer; }
+	static Joint *findJoint(b2Joint *joint) { return (Joint *) joint->GetUserData().pointer; }
+
 private:
 
+	void step(float dt, int velocityIterations, int positionIterations);
+	void recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse);
+
 	// Pointer to the Box2D world.
 	b2World *world;
 
@@ -319,10 +513,20 @@ private:
 	std::vector<Joint *> destructJoints;
 	bool destructWorld;
 
+	TaskExecutor executor;
+
 	// Contact callbacks.
 	ContactCallback begin, end, presolve, postsolve;
+
+	bool bufferContactEvents;
+	std::vector<ContactEvent> contactEvents;
+
+	float fixedTimestep;
+	int maxFixedSteps;
+	double accumulator;
 	ContactFilter filter;
 
+	// Contacts and the world itself, which have no user data to point back with.
 	std::unordered_map<void *, love::Object *> box2dObjectMap;
 
 }; // World
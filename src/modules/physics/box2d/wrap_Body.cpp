@@ -21,6 +21,11 @@
 #include "wrap_Body.h"
 #include "wrap_Physics.h"
 
+// Put the Lua code directly into a raw string literal.
+static const char body_lua[] =
+#include "wrap_Body.lua"
+;
+
 namespace love
 {
 namespace physics
@@ -654,6 +659,26 @@ int w_Body_getUserData(lua_State *L)
 	return t->getUserData(L);
 }
 
+// C functions in a struct, necessary for the FFI versions of Body methods.
+// They return false instead of raising errors.
+struct FFI_Body
+{
+	bool (*getPosition)(Proxy *p, float *out);
+};
+
+static FFI_Body ffifuncs =
+{
+	[](Proxy *p, float *out) -> bool // getPosition
+	{
+		Body *b = luax_ffi_checktype<Body>(p);
+		if (b == nullptr || b->body == nullptr)
+			return false;
+
+		b->getPosition(out[0], out[1]);
+		return true;
+	},
+};
+
 static const luaL_Reg w_Body_functions[] =
 {
 	{ "getX", w_Body_getX },
@@ -726,7 +751,11 @@ static const luaL_Reg w_Body_functions[] =
 
 extern "C" int luaopen_body(lua_State *L)
 {
-	return luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+	int n = luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+
+	luax_runwrapper(L, body_lua, sizeof(body_lua), "Body.lua", Body::type, &ffifuncs);
+
+	return n;
 }
 
 } // box2d
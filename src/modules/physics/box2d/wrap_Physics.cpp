@@ -95,6 +95,62 @@ int w_newFixture(lua_State *L)
 	return 1;
 }
 
+static int pushFixtureList(lua_State *L, std::vector<Fixture *> &fixtures)
+{
+	lua_createtable(L, (int) fixtures.size(), 0);
+	for (size_t i = 0; i < fixtures.size(); i++)
+	{
+		luax_pushtype(L, fixtures[i]);
+		fixtures[i]->release();
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	return 1;
+}
+
+int w_newFixtures(lua_State *L)
+{
+	Body *body = luax_checkbody(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	float density = (float)luaL_optnumber(L, 3, 1.0f);
+
+	int count = (int) luax_objlen(L, 2);
+	std::vector<Shape *> shapes;
+	shapes.reserve(count);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		shapes.push_back(luax_checkshape(L, -1));
+		lua_pop(L, 1);
+	}
+
+	std::vector<Fixture *> fixtures;
+	luax_catchexcept(L, [&](){ instance()->newFixtures(body, shapes, density, fixtures); });
+	return pushFixtureList(L, fixtures);
+}
+
+int w_newRectangleFixtures(lua_State *L)
+{
+	Body *body = luax_checkbody(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	float density = (float)luaL_optnumber(L, 3, 1.0f);
+
+	int length = (int) luax_objlen(L, 2);
+	if (length % 4 != 0)
+		return luaL_error(L, "Number of rectangle components must be a multiple of 4 (x, y, width, height.)");
+
+	std::vector<float> rects(length);
+	for (int i = 0; i < length; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		rects[i] = (float)luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	std::vector<Fixture *> fixtures;
+	luax_catchexcept(L, [&](){ instance()->newRectangleFixtures(body, rects.data(), length / 4, density, fixtures); });
+	return pushFixtureList(L, fixtures);
+}
+
 int w_newCircleShape(lua_State *L)
 {
 	int top = lua_gettop(L);
@@ -574,6 +630,8 @@ static const luaL_Reg functions[] =
 	{ "newWorld", w_newWorld },
 	{ "newBody", w_newBody },
 	{ "newFixture", w_newFixture },
+	{ "newFixtures", w_newFixtures },
+	{ "newRectangleFixtures", w_newRectangleFixtures },
 	{ "newCircleShape", w_newCircleShape },
 	{ "newRectangleShape", w_newRectangleShape },
 	{ "newPolygonShape", w_newPolygonShape },
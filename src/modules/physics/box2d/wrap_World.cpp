@@ -19,6 +19,11 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Body.h"
+#include "data/ByteData.h"
+
+#include <vector>
+#include <string.h>
 
 namespace love
 {
@@ -55,6 +60,32 @@ int w_World_update(lua_State *L)
 	return 0;
 }
 
+int w_World_setFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float dt = (float) luaL_optnumber(L, 2, 0.0);
+	int maxsteps = (int) luaL_optinteger(L, 3, 8);
+	luax_catchexcept(L, [&](){ t->setFixedTimestep(dt, maxsteps); });
+	return 0;
+}
+
+int w_World_getFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int maxsteps = 0;
+	float dt = t->getFixedTimestep(maxsteps);
+	lua_pushnumber(L, dt);
+	lua_pushinteger(L, maxsteps);
+	return 2;
+}
+
+int w_World_getInterpolationAlpha(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushnumber(L, t->getInterpolationAlpha());
+	return 1;
+}
+
 int w_World_setCallbacks(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -69,6 +100,27 @@ int w_World_getCallbacks(lua_State *L)
 	return t->getCallbacks(L);
 }
 
+int w_World_setContactEventsBuffered(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool b = luax_checkboolean(L, 2);
+	t->setContactEventsBuffered(b);
+	return 0;
+}
+
+int w_World_isContactEventsBuffered(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isContactEventsBuffered());
+	return 1;
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	return t->getContactEvents(L);
+}
+
 int w_World_setContactFilter(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -123,6 +175,21 @@ int w_World_isSleepingAllowed(lua_State *L)
 	return 1;
 }
 
+int w_World_setMultithreaded(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool b = luax_checkboolean(L, 2);
+	t->setMultithreaded(b);
+	return 0;
+}
+
+int w_World_isMultithreaded(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isMultithreaded());
+	return 1;
+}
+
 int w_World_isLocked(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -160,6 +227,142 @@ int w_World_getBodies(lua_State *L)
 	return ret;
 }
 
+// Reads an optional list of bodies. Returns false if the argument is nil,
+// meaning all bodies in the World.
+static bool checkBodyList(lua_State *L, int idx, std::vector<Body *> &bodies)
+{
+	if (lua_isnoneornil(L, idx))
+		return false;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	bodies.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		bodies.push_back(luax_checkbody(L, -1));
+		lua_pop(L, 1);
+	}
+
+	return true;
+}
+
+// Gets the Data to write body states into: the one at idx if it's given and
+// big enough, or a new ByteData.
+static void checkStateData(lua_State *L, int idx, int count, size_t size, StrongRef<Data> &data)
+{
+	if (!lua_isnoneornil(L, idx))
+	{
+		data.set(luax_checktype<Data>(L, idx));
+		if (data->getSize() < size)
+			luaL_error(L, "Data is too small to hold %d body states (needs %d bytes.)", count, (int) size);
+	}
+	else
+		luax_catchexcept(L, [&](){ data.set(new love::data::ByteData(size, false), Acquire::NORETAIN); });
+}
+
+int w_World_getBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	std::vector<Body *> bodies;
+	bool list = checkBodyList(L, 2, bodies);
+
+	int count = list ? (int) bodies.size() : t->getBodyCount();
+	size_t size = (size_t) count * World::BODY_STATE_COMPONENTS * sizeof(float);
+
+	StrongRef<Data> data;
+	checkStateData(L, 3, count, size, data);
+
+	luax_catchexcept(L, [&](){ t->getBodyStates(list ? bodies.data() : nullptr, count, (float *) data->getData()); });
+
+	luax_pushtype(L, data.get());
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+int w_World_setBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	std::vector<Body *> bodies;
+	bool list = checkBodyList(L, 3, bodies);
+
+	int count = list ? (int) bodies.size() : t->getBodyCount();
+	size_t size = (size_t) count * World::BODY_STATE_COMPONENTS * sizeof(float);
+
+	if (data->getSize() < size)
+		return luaL_error(L, "Data is too small to hold %d body states (needs %d bytes.)", count, (int) size);
+
+	luax_catchexcept(L, [&](){ t->setBodyStates(list ? bodies.data() : nullptr, count, (const float *) data->getData()); });
+	return 0;
+}
+
+int w_World_getInterpolatedBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	std::vector<Body *> bodies;
+	bool list = checkBodyList(L, 2, bodies);
+
+	int count = list ? (int) bodies.size() : t->getBodyCount();
+	size_t size = (size_t) count * 3 * sizeof(float);
+
+	StrongRef<Data> data;
+	checkStateData(L, 3, count, size, data);
+
+	luax_catchexcept(L, [&](){ t->getInterpolatedBodyStates(list ? bodies.data() : nullptr, count, (float *) data->getData()); });
+
+	luax_pushtype(L, data.get());
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+int w_World_saveState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	size_t size = t->getStateSize();
+
+	StrongRef<Data> data;
+	if (!lua_isnoneornil(L, 2))
+	{
+		data.set(luax_checktype<Data>(L, 2));
+		if (data->getSize() < size)
+			return luaL_error(L, "Data is too small to hold the World state (needs %d bytes.)", (int) size);
+	}
+	else
+		luax_catchexcept(L, [&](){ data.set(new love::data::ByteData(size, false), Acquire::NORETAIN); });
+
+	luax_catchexcept(L, [&](){ t->saveState(data->getData()); });
+
+	luax_pushtype(L, data.get());
+	lua_pushinteger(L, (lua_Integer) size);
+	return 2;
+}
+
+int w_World_restoreState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	size_t size = data->getSize();
+	if (!lua_isnoneornil(L, 3))
+	{
+		lua_Integer n = luaL_checkinteger(L, 3);
+		if (n < 0 || (size_t) n > size)
+			return luaL_error(L, "Invalid state size: %d", (int) n);
+		size = (size_t) n;
+	}
+
+	luax_catchexcept(L, [&](){ t->restoreState(data->getData(), size); });
+	return 0;
+}
+
+int w_World_rebuildBroadPhase(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_catchexcept(L, [&](){ t->rebuildBroadPhase(); });
+	return 0;
+}
+
 int w_World_getJoints(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -203,6 +406,104 @@ int w_World_rayCast(lua_State *L)
 	return ret;
 }
 
+// Reads groups of numbers from a flat table, or from a Data holding floats.
+static int checkFloatGroups(lua_State *L, int idx, int components, std::vector<float> &values)
+{
+	if (lua_istable(L, idx))
+	{
+		int length = (int) luax_objlen(L, idx);
+		if (length % components != 0)
+			luaL_error(L, "Expected %d numbers per entry, got a table of length %d.", components, length);
+
+		values.resize(length);
+		for (int i = 0; i < length; i++)
+		{
+			lua_rawgeti(L, idx, i + 1);
+			values[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		size_t count = data->getSize() / (sizeof(float) * components);
+		values.resize(count * components);
+		memcpy(values.data(), data->getData(), values.size() * sizeof(float));
+	}
+
+	return (int) values.size() / components;
+}
+
+int w_World_rayCastBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	std::vector<float> rays;
+	int count = checkFloatGroups(L, 2, 4, rays);
+
+	World::RayCastMode mode = World::RAYCAST_CLOSEST;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!World::getConstant(str, mode))
+			return luax_enumerror(L, "ray cast mode", World::getConstants(mode), str);
+	}
+
+	std::vector<World::RayCastHit> hits(count);
+	luax_catchexcept(L, [&](){ t->rayCastBatch(rays.data(), count, mode, hits.data()); });
+
+	StrongRef<love::data::ByteData> data;
+	luax_catchexcept(L, [&](){ data.set(new love::data::ByteData(count * 5 * sizeof(float), false), Acquire::NORETAIN); });
+	float *points = (float *) data->getData();
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		const World::RayCastHit &hit = hits[i];
+
+		if (hit.fixture != nullptr)
+			luax_pushtype(L, hit.fixture);
+		else
+			lua_pushboolean(L, 0);
+		lua_rawseti(L, -2, i + 1);
+
+		points[i * 5 + 0] = hit.x;
+		points[i * 5 + 1] = hit.y;
+		points[i * 5 + 2] = hit.nx;
+		points[i * 5 + 3] = hit.ny;
+		points[i * 5 + 4] = hit.fraction;
+	}
+
+	luax_pushtype(L, data.get());
+	return 2;
+}
+
+int w_World_queryBoundingBoxBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	std::vector<float> boxes;
+	int count = checkFloatGroups(L, 2, 4, boxes);
+
+	std::vector<Fixture *> fixtures;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&](){ t->queryBoundingBoxBatch(boxes.data(), count, fixtures, counts); });
+
+	lua_createtable(L, (int) fixtures.size(), 0);
+	for (size_t i = 0; i < fixtures.size(); i++)
+	{
+		luax_pushtype(L, fixtures[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushinteger(L, counts[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 2;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -220,25 +521,41 @@ int w_World_isDestroyed(lua_State *L)
 static const luaL_Reg w_World_functions[] =
 {
 	{ "update", w_World_update },
+	{ "setFixedTimestep", w_World_setFixedTimestep },
+	{ "getFixedTimestep", w_World_getFixedTimestep },
+	{ "getInterpolationAlpha", w_World_getInterpolationAlpha },
 	{ "setCallbacks", w_World_setCallbacks },
 	{ "getCallbacks", w_World_getCallbacks },
 	{ "setContactFilter", w_World_setContactFilter },
+	{ "setContactEventsBuffered", w_World_setContactEventsBuffered },
+	{ "isContactEventsBuffered", w_World_isContactEventsBuffered },
+	{ "getContactEvents", w_World_getContactEvents },
 	{ "getContactFilter", w_World_getContactFilter },
 	{ "setGravity", w_World_setGravity },
 	{ "getGravity", w_World_getGravity },
 	{ "translateOrigin", w_World_translateOrigin },
 	{ "setSleepingAllowed", w_World_setSleepingAllowed },
 	{ "isSleepingAllowed", w_World_isSleepingAllowed },
+	{ "setMultithreaded", w_World_setMultithreaded },
+	{ "isMultithreaded", w_World_isMultithreaded },
 	{ "isLocked", w_World_isLocked },
 	{ "getBodyCount", w_World_getBodyCount },
 	{ "getJointCount", w_World_getJointCount },
 	{ "getContactCount", w_World_getContactCount },
 	{ "getBodies", w_World_getBodies },
+	{ "getBodyStates", w_World_getBodyStates },
+	{ "setBodyStates", w_World_setBodyStates },
+	{ "getInterpolatedBodyStates", w_World_getInterpolatedBodyStates },
+	{ "saveState", w_World_saveState },
+	{ "restoreState", w_World_restoreState },
+	{ "rebuildBroadPhase", w_World_rebuildBroadPhase },
 	{ "getJoints", w_World_getJoints },
 	{ "getContacts", w_World_getContacts },
 	{ "queryBoundingBox", w_World_queryBoundingBox },
 	{ "getFixturesInArea", w_World_getFixturesInArea },
 	{ "rayCast", w_World_rayCast },
+	{ "rayCastBatch", w_World_rayCastBatch },
+	{ "queryBoundingBoxBatch", w_World_queryBoundingBoxBatch },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
@@ -73,6 +73,13 @@ public:
 
 	virtual const char *getSensorName(SensorType type) = 0;
 
+	/**
+	 * Enables or disables sensorupdated events. Enabled sensors can still be
+	 * polled with getData while their events are disabled.
+	 **/
+	virtual void setEventsEnabled(bool enabled) = 0;
+	virtual bool areEventsEnabled() const = 0;
+
 	STRINGMAP_CLASS_DECLARE(SensorType);
 
 }; // Sensor
@@ -34,6 +34,7 @@ namespace sdl
 
 Sensor::Sensor()
 : sensors()
+, eventsEnabled(true)
 {
 	if (SDL_InitSubSystem(SDL_INIT_SENSOR) < 0)
 		throw love::Exception("Could not initialize SDL sensor subsystem (%s)", SDL_GetError());
@@ -143,6 +144,16 @@ const char *Sensor::getSensorName(SensorType type)
 	return SDL_SensorGetName(sensors[type]);
 }
 
+void Sensor::setEventsEnabled(bool enabled)
+{
+	eventsEnabled = enabled;
+}
+
+bool Sensor::areEventsEnabled() const
+{
+	return eventsEnabled;
+}
+
 Sensor::SensorType Sensor::convert(SDL_SensorType type)
 {
 	switch (type)
@@ -52,12 +52,15 @@ public:
 	std::vector<float> getData(SensorType type) override;
 	std::vector<void*> getHandles() override;
 	const char *getSensorName(SensorType type) override;
+	void setEventsEnabled(bool enabled) override;
+	bool areEventsEnabled() const override;
 
 	static SensorType convert(SDL_SensorType type);
 	static SDL_SensorType convert(SensorType type);
 
 private:
 	std::map<SensorType, SDL_Sensor*> sensors;
+	bool eventsEnabled;
 
 }; // Sensor
 
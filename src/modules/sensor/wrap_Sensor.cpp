@@ -88,6 +88,19 @@ static int w_getName(lua_State *L)
 	return 1;
 }
 
+static int w_setEventsEnabled(lua_State *L)
+{
+	bool enabled = luax_checkboolean(L, 1);
+	instance()->setEventsEnabled(enabled);
+	return 0;
+}
+
+static int w_areEventsEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->areEventsEnabled());
+	return 1;
+}
+
 static const luaL_Reg functions[] =
 {
 	{ "hasSensor", w_hasSensor },
@@ -95,6 +108,8 @@ static const luaL_Reg functions[] =
 	{ "setEnabled", w_setEnabled },
 	{ "getData", w_getData },
 	{ "getName", w_getName },
+	{ "setEventsEnabled", w_setEventsEnabled },
+	{ "areEventsEnabled", w_areEventsEnabled },
 	{ nullptr, nullptr }
 };
 
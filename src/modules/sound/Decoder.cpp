@@ -21,6 +21,10 @@
 #include "Decoder.h"
 
 #include "common/Exception.h"
+#include "libraries/xxHash/xxhash.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace love
 {
@@ -75,6 +79,38 @@ bool Decoder::isFinished()
 	return eof;
 }
 
+uint64 Decoder::getStreamKey()
+{
+	const int64 headSize = 65536;
+	const int64 tailSize = 4096;
+
+	int64 position = stream->tell();
+	int64 size = stream->getSize();
+
+	std::vector<char> bytes((size_t) (std::min(size, headSize) + std::min(size, tailSize)));
+	int64 read = 0;
+
+	if (stream->seek(0))
+		read += std::max<int64>(0, stream->read(bytes.data(), std::min(size, headSize)));
+
+	if (stream->seek(std::max<int64>(0, size - tailSize)))
+		read += std::max<int64>(0, stream->read(bytes.data() + read, std::min(size, tailSize)));
+
+	stream->seek(position);
+
+	return XXH3_64bits_withSeed(bytes.data(), (size_t) read, (uint64) size);
+}
+
+int64 Decoder::getSampleCount()
+{
+	return -1;
+}
+
+bool Decoder::seekSample(int64 sample)
+{
+	return seek((double) sample / (double) getSampleRate());
+}
+
 STRINGMAP_CLASS_BEGIN(Decoder, Decoder::StreamSource, Decoder::STREAM_MAX_ENUM, streamSource)
 {
 	{ "memory", Decoder::STREAM_MEMORY },
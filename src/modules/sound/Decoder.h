@@ -25,6 +25,7 @@
 #include "common/Object.h"
 #include "common/Stream.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 
 #include <string>
 
@@ -58,6 +59,11 @@ public:
 	 **/
 	static const int DEFAULT_BUFFER_SIZE = 16384;
 
+	/**
+	 * Buffer size for Decoders made just to decode a whole file at once.
+	 **/
+	static const int FULL_DECODE_BUFFER_SIZE = 262144;
+
 	/**
 	 * Indicates the quality of the sound.
 	 **/
@@ -151,10 +157,29 @@ public:
 	 **/
 	virtual double getDuration() = 0;
 
+	/**
+	 * Gets the exact number of sample frames in the stream, or -1 if it can't
+	 * be determined without decoding it.
+	 **/
+	virtual int64 getSampleCount();
+
+	/**
+	 * Seeks to an exact sample frame. Decoders which can't do that seek to
+	 * the nearest time instead.
+	 **/
+	virtual bool seekSample(int64 sample);
+
 	STRINGMAP_CLASS_DECLARE(StreamSource);
 
 protected:
 
+	/**
+	 * Identifies the stream's contents, so data derived from a file (such as
+	 * a seek table) can be shared by every Decoder reading it. Based on the
+	 * stream's size and its first and last bytes.
+	 **/
+	uint64 getStreamKey();
+
 	// A readable stream containing the encoded data.
 	StrongRef<Stream> stream;
 
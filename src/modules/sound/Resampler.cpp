@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Resampler.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace love
+{
+namespace sound
+{
+
+static int64 gcd(int64 a, int64 b)
+{
+	while (b != 0)
+	{
+		int64 t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser
+// window.
+static double besselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double halfx = x * 0.5;
+
+	for (int k = 1; k < 64; k++)
+	{
+		term *= (halfx / k) * (halfx / k);
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+
+	return sum;
+}
+
+Resampler::Resampler(int inRate, int outRate)
+{
+	if (inRate <= 0 || outRate <= 0)
+		throw love::Exception("Invalid sample rate.");
+
+	int64 divisor = gcd(inRate, outRate);
+	up = outRate / divisor;
+	down = inRate / divisor;
+
+	phases = (int) std::min<int64>(up, MAX_PHASES);
+
+	// Cutoff relative to the input rate's Nyquist frequency, with a little
+	// headroom for the transition band.
+	double ratio = std::min(1.0, (double) outRate / (double) inRate);
+	double cutoff = 0.95 * ratio;
+
+	taps = (int) std::ceil(BASE_TAPS / ratio);
+	taps = std::min(MAX_TAPS, (taps + 3) & ~3);
+
+	const double pi = 3.14159265358979323846;
+	const double beta = 8.6; // Roughly 90 dB of stopband attenuation.
+	const double i0beta = besselI0(beta);
+	const int half = taps / 2;
+
+	filters.resize((size_t) phases * taps);
+
+	for (int p = 0; p < phases; p++)
+	{
+		double frac = (double) p / (double) phases;
+		float *filter = &filters[(size_t) p * taps];
+		double sum = 0.0;
+
+		for (int k = 0; k < taps; k++)
+		{
+			// Distance from the output position to this tap's input sample.
+			double d = frac + half - 1 - k;
+			double x = d * cutoff;
+			double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+
+			double w = d / half;
+			double window = std::abs(w) >= 1.0 ? 0.0 : besselI0(beta * std::sqrt(1.0 - w * w)) / i0beta;
+
+			double h = sinc * window;
+			filter[k] = (float) h;
+			sum += h;
+		}
+
+		// Unity gain at DC for every phase.
+		for (int k = 0; k < taps; k++)
+			filter[k] = (float) (filter[k] / sum);
+	}
+}
+
+int64 Resampler::getOutputLength(int64 inputLength) const
+{
+	return (inputLength * up + down - 1) / down;
+}
+
+static inline float dot(const float *a, const float *b, int count)
+{
+#if defined(LOVE_SIMD_SSE2)
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+	}
+
+	for (; i + 4 <= count; i += 4)
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+	float sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+	for (; i < count; i++)
+		sum += a[i] * b[i];
+
+	return sum;
+#else
+	float sum = 0.0f;
+	for (int i = 0; i < count; i++)
+		sum += a[i] * b[i];
+	return sum;
+#endif
+}
+
+void Resampler::process(const float *in, int64 inputLength, float *out, int64 first, int64 last) const
+{
+	const int half = taps / 2;
+	float edge[MAX_TAPS];
+
+	for (int64 n = first; n < last; n++)
+	{
+		int64 position = n * down;
+		int64 index = position / up;
+		int phase = (int) ((position % up) * phases / up);
+
+		const float *filter = &filters[(size_t) phase * taps];
+		int64 start = index - half + 1;
+
+		if (start >= 0 && start + taps <= inputLength)
+			out[n] = dot(in + start, filter, taps);
+		else
+		{
+			// Near the ends, pad the input with silence.
+			for (int k = 0; k < taps; k++)
+			{
+				int64 j = start + k;
+				edge[k] = (j >= 0 && j < inputLength) ? in[j] : 0.0f;
+			}
+
+			out[n] = dot(edge, filter, taps);
+		}
+	}
+}
+
+} // sound
+} // love
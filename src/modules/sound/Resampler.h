@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_RESAMPLER_H
+#define LOVE_SOUND_RESAMPLER_H
+
+// LOVE
+#include "common/int.h"
+
+// STL
+#include <vector>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * Polyphase windowed-sinc resampler for whole buffers of float samples. The
+ * ratio between the rates is reduced to out/in, and each fractional input
+ * position an output sample can land on gets its own precomputed filter.
+ * Instances are immutable once created, so one can be shared by threads.
+ **/
+class Resampler
+{
+public:
+
+	// Taps per phase when not downsampling. Downsampling widens the filters
+	// so the transition band stays the same relative to the output rate.
+	static const int BASE_TAPS = 32;
+	static const int MAX_TAPS = 256;
+
+	// Rate ratios needing more phases than this round to the nearest one.
+	static const int MAX_PHASES = 1024;
+
+	Resampler(int inRate, int outRate);
+
+	/**
+	 * Number of output samples produced from the given number of input ones.
+	 **/
+	int64 getOutputLength(int64 inputLength) const;
+
+	/**
+	 * Resamples output samples [first, last) from the whole input signal.
+	 * Ranges can be processed independently, e.g. on different threads.
+	 * Samples outside the input are treated as silence.
+	 **/
+	void process(const float *in, int64 inputLength, float *out, int64 first, int64 last) const;
+
+private:
+
+	int64 up;
+	int64 down;
+	int phases;
+	int taps;
+
+	// phases * taps coefficients, one row per phase.
+	std::vector<float> filters;
+
+}; // Resampler
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_RESAMPLER_H
@@ -19,16 +19,26 @@
  **/
 
 #include "SoundData.h"
+#include "Resampler.h"
+#include "common/config.h"
+#include "thread/JobSystem.h"
 
 // C
 #include <cstdlib>
 #include <cstring>
 
 // C++
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
 #include <iostream>
 #include <vector>
 
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace love
 {
 namespace sound
@@ -46,7 +56,21 @@ SoundData::SoundData(Decoder *decoder)
 	if (decoder->getBitDepth() != 8 && decoder->getBitDepth() != 16)
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
+	channels = decoder->getChannelCount();
+	bitDepth = decoder->getBitDepth();
+	sampleRate = decoder->getSampleRate();
+
+	if (decodeParallel(decoder))
+		return;
+
 	size_t bufferSize = 524288; // 0x80000
+
+	// Avoid growing the buffer when the final size is known up front.
+	int64 samples = decoder->getSampleCount();
+	size_t frameSize = (size_t) (channels * (bitDepth / 8));
+	if (samples > 0 && (uint64) samples < std::numeric_limits<size_t>::max() / frameSize)
+		bufferSize = std::max(bufferSize, (size_t) samples * frameSize);
+
 	int decoded = decoder->decode();
 
 	while (decoded > 0)
@@ -82,10 +106,95 @@ SoundData::SoundData(Decoder *decoder)
 	// Shrink buffer if necessary.
 	if (data && bufferSize > size)
 		data = (uint8 *) realloc(data, size);
+}
 
-	channels = decoder->getChannelCount();
-	bitDepth = decoder->getBitDepth();
-	sampleRate = decoder->getSampleRate();
+bool SoundData::decodeParallel(Decoder *decoder)
+{
+	// Shorter streams aren't worth the cost of cloning the decoder.
+	const int64 minSegmentSeconds = 10;
+
+	if (!decoder->isSeekable())
+		return false;
+
+	int64 samples = decoder->getSampleCount();
+	int64 minSegmentSamples = minSegmentSeconds * (int64) decoder->getSampleRate();
+	if (samples <= 0 || minSegmentSamples <= 0)
+		return false;
+
+	love::thread::JobSystem *jobs = love::thread::JobSystem::getInstance();
+	int64 segments = std::min((int64) jobs->getWorkerCount() + 1, samples / minSegmentSamples);
+	if (segments < 2)
+		return false;
+
+	size_t frameSize = (size_t) (decoder->getChannelCount() * (decoder->getBitDepth() / 8));
+	if ((uint64) samples > std::numeric_limits<size_t>::max() / frameSize)
+		return false;
+
+	size_t totalSize = (size_t) samples * frameSize;
+
+	// Each segment needs its own decoder. Cloning can touch the original's
+	// stream, so it's done here rather than in the jobs.
+	std::vector<StrongRef<Decoder>> decoders((size_t) segments);
+	try
+	{
+		for (auto &d : decoders)
+			d.set(decoder->clone(), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	uint8 *buffer = (uint8 *) malloc(totalSize);
+	if (buffer == nullptr)
+		throw love::Exception("Not enough memory.");
+
+	std::atomic<bool> success(true);
+
+	jobs->parallelFor((size_t) segments, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			Decoder *d = decoders[i].get();
+			int64 first = samples * (int64) i / segments;
+			int64 last = samples * (int64) (i + 1) / segments;
+
+			if (!d->seekSample(first))
+			{
+				success = false;
+				continue;
+			}
+
+			size_t offset = (size_t) first * frameSize;
+			size_t remaining = (size_t) (last - first) * frameSize;
+
+			while (remaining > 0)
+			{
+				int decoded = d->decode();
+				if (decoded <= 0)
+					break;
+
+				size_t n = std::min(remaining, (size_t) decoded);
+				memcpy(buffer + offset, d->getBuffer(), n);
+				offset += n;
+				remaining -= n;
+			}
+
+			// The stream was shorter than its header said.
+			if (remaining > 0)
+				success = false;
+		}
+	});
+
+	if (!success)
+	{
+		free(buffer);
+		return false;
+	}
+
+	data = buffer;
+	size = totalSize;
+	return true;
 }
 
 SoundData::SoundData(int samples, int sampleRate, int bitDepth, int channels)
@@ -120,6 +229,8 @@ SoundData::SoundData(const SoundData &c)
 
 SoundData::~SoundData()
 {
+	unregisterResident();
+
 	if (data != 0)
 		free(data);
 }
@@ -171,9 +282,29 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 
 void *SoundData::getData() const
 {
+	makeResident();
 	return (void *)data;
 }
 
+void SoundData::releaseResidentBytes()
+{
+	free(data);
+	data = nullptr;
+}
+
+void SoundData::restoreResidentBytes(char *bytes)
+{
+	data = (uint8 *) malloc(size);
+
+	if (data != nullptr)
+		memcpy(data, bytes, size);
+
+	delete[] bytes;
+
+	if (data == nullptr)
+		throw love::Exception("Not enough memory.");
+}
+
 size_t SoundData::getSize() const
 {
 	return size;
@@ -210,6 +341,8 @@ void SoundData::setSample(int i, float sample)
 	if (i < 0 || (size_t) i >= size/(bitDepth/8))
 		throw love::Exception("Attempt to set out-of-range sample!");
 
+	Pin pin(this);
+
 	if (bitDepth == 16)
 	{
 		// 16-bit sample values are signed.
@@ -237,6 +370,8 @@ float SoundData::getSample(int i) const
 	if (i < 0 || (size_t) i >= size/(bitDepth/8))
 		throw love::Exception("Attempt to get out-of-range sample!");
 
+	Pin pin(this);
+
 	if (bitDepth == 16)
 	{
 		// 16-bit sample values are signed.
@@ -272,6 +407,9 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 	if (srcStart < 0 || (srcStart+count) * srcBytesPerSample > src->size)
 		throw love::Exception("Source out-of-range!");
 
+	Pin dstpin(this);
+	Pin srcpin(src);
+
 	if (bitDepth != src->bitDepth)
 	{
 		// Bit depth mismatch, use get/setSample at loop
@@ -285,6 +423,207 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 		memcpy(data + dstStart * bytesPerSample, src->data + srcStart * bytesPerSample, count * bytesPerSample);
 }
 
+// Converts interleaved integer samples to one float array per channel.
+static void deinterleave(const uint8 *src, int bitDepth, int channels, size_t frames, std::vector<std::vector<float>> &out)
+{
+	out.assign((size_t) channels, std::vector<float>(frames));
+	size_t i = 0;
+
+	if (bitDepth == 16)
+	{
+		const int16 *s = (const int16 *) src;
+		const float scale = 1.0f / (float) LOVE_INT16_MAX;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 scale4 = _mm_set1_ps(scale);
+
+		if (channels == 1)
+		{
+			float *o = out[0].data();
+			for (; i + 8 <= frames; i += 8)
+			{
+				__m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+				__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+				__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+				_mm_storeu_ps(o + i, _mm_mul_ps(lo, scale4));
+				_mm_storeu_ps(o + i + 4, _mm_mul_ps(hi, scale4));
+			}
+		}
+		else if (channels == 2)
+		{
+			float *l = out[0].data();
+			float *r = out[1].data();
+			for (; i + 4 <= frames; i += 4)
+			{
+				// L0 R0 L1 R1 | L2 R2 L3 R3
+				__m128i v = _mm_loadu_si128((const __m128i *) (s + i * 2));
+				__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+				__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+				_mm_storeu_ps(l + i, _mm_mul_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), scale4));
+				_mm_storeu_ps(r + i, _mm_mul_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)), scale4));
+			}
+		}
+#endif
+
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channels; c++)
+				out[c][i] = (float) s[i * channels + c] * scale;
+		}
+	}
+	else
+	{
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channels; c++)
+				out[c][i] = ((float) src[i * channels + c] - 128.0f) / 127.0f;
+		}
+	}
+}
+
+// Converts one float array per channel to interleaved integer samples.
+static void interleave(const std::vector<std::vector<float>> &in, int bitDepth, size_t frames, uint8 *dst)
+{
+	int channels = (int) in.size();
+	size_t i = 0;
+
+	if (bitDepth == 16)
+	{
+		int16 *d = (int16 *) dst;
+		const float scale = (float) LOVE_INT16_MAX;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 scale4 = _mm_set1_ps(scale);
+		const __m128 max4 = _mm_set1_ps(scale);
+		const __m128 min4 = _mm_set1_ps(-scale);
+
+		if (channels == 1)
+		{
+			const float *m = in[0].data();
+			for (; i + 8 <= frames; i += 8)
+			{
+				__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(m + i), scale4), min4), max4);
+				__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(m + i + 4), scale4), min4), max4);
+				_mm_storeu_si128((__m128i *) (d + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+			}
+		}
+		else if (channels == 2)
+		{
+			const float *l = in[0].data();
+			const float *r = in[1].data();
+			for (; i + 4 <= frames; i += 4)
+			{
+				__m128 l4 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(l + i), scale4), min4), max4);
+				__m128 r4 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(r + i), scale4), min4), max4);
+				__m128i a = _mm_cvtps_epi32(_mm_unpacklo_ps(l4, r4));
+				__m128i b = _mm_cvtps_epi32(_mm_unpackhi_ps(l4, r4));
+				_mm_storeu_si128((__m128i *) (d + i * 2), _mm_packs_epi32(a, b));
+			}
+		}
+#endif
+
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				float v = std::min(std::max(in[c][i] * scale, -scale), scale);
+				d[i * channels + c] = (int16) std::lrint(v);
+			}
+		}
+	}
+	else
+	{
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				float v = std::min(std::max(in[c][i], -1.0f), 1.0f);
+				dst[i * channels + c] = (uint8) std::lrint(v * 127.0f + 128.0f);
+			}
+		}
+	}
+}
+
+SoundData *SoundData::convert(int newSampleRate, int newBitDepth, int newChannels) const
+{
+	if (newSampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", newSampleRate);
+
+	if (newBitDepth != 8 && newBitDepth != 16)
+		throw love::Exception("Invalid bit depth: %d", newBitDepth);
+
+	if (newChannels <= 0)
+		throw love::Exception("Invalid channel count: %d", newChannels);
+
+	if (newChannels != channels && newChannels != 1 && channels != 1)
+		throw love::Exception("Can only convert to mono, or from mono to more channels.");
+
+	size_t frames = (size_t) getSampleCount();
+
+	Pin pin(this);
+
+	std::vector<std::vector<float>> planes;
+	deinterleave(data, bitDepth, channels, frames, planes);
+
+	if (newChannels != channels)
+	{
+		if (newChannels == 1)
+		{
+			// Mix everything down into the first channel.
+			float *m = planes[0].data();
+			for (int c = 1; c < channels; c++)
+			{
+				const float *s = planes[c].data();
+				for (size_t i = 0; i < frames; i++)
+					m[i] += s[i];
+			}
+
+			float gain = 1.0f / (float) channels;
+			for (size_t i = 0; i < frames; i++)
+				m[i] *= gain;
+
+			planes.resize(1);
+		}
+		else
+		{
+			std::vector<float> mono = planes[0];
+			planes.resize((size_t) newChannels, mono);
+		}
+	}
+
+	size_t newFrames = frames;
+
+	if (newSampleRate != sampleRate)
+	{
+		Resampler resampler(sampleRate, newSampleRate);
+
+		int64 outLength = resampler.getOutputLength((int64) frames);
+		if (outLength > std::numeric_limits<int>::max())
+			throw love::Exception("Data is too big!");
+
+		newFrames = (size_t) outLength;
+
+		love::thread::JobSystem *jobs = love::thread::JobSystem::getInstance();
+
+		for (auto &plane : planes)
+		{
+			std::vector<float> resampled(newFrames);
+
+			jobs->parallelFor(newFrames, 16384, [&](size_t begin, size_t end)
+			{
+				resampler.process(plane.data(), (int64) frames, resampled.data(), (int64) begin, (int64) end);
+			});
+
+			plane.swap(resampled);
+		}
+	}
+
+	SoundData *result = new SoundData((int) newFrames, newSampleRate, newBitDepth, newChannels);
+	interleave(planes, newBitDepth, newFrames, result->data);
+
+	return result;
+}
+
 SoundData *SoundData::slice(int start, int length) const
 {
 	int totalSamples = getSampleCount();
@@ -297,6 +636,8 @@ SoundData *SoundData::slice(int start, int length) const
 	if (start < 0 || start + length > totalSamples)
 		throw love::Exception("Attempt to slice at out-of-range position!");
 
+	Pin pin(this);
+
 	return new SoundData(data + start * channels * bitDepth/8, length, sampleRate, bitDepth, channels);
 }
 
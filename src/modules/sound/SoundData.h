@@ -24,6 +24,7 @@
 // LOVE
 #include "filesystem/File.h"
 #include "common/int.h"
+#include "data/ResidentData.h"
 #include "Decoder.h"
 
 namespace love
@@ -31,7 +32,7 @@ namespace love
 namespace sound
 {
 
-class SoundData : public love::Data
+class SoundData : public love::Data, public love::data::ResidentData
 {
 public:
 
@@ -64,10 +65,32 @@ public:
 	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
 	SoundData *slice(int start, int length = -1) const;
 
+	/**
+	 * Creates a copy with a different sample rate, bit depth or channel
+	 * count. Channels can be mixed down to mono or a mono SoundData spread to
+	 * more channels. Resampling uses a polyphase windowed-sinc filter.
+	 **/
+	SoundData *convert(int newSampleRate, int newBitDepth, int newChannels) const;
+
+protected:
+
+	// Implements ResidentData.
+	void *getResidentBytes() const override { return data; }
+	size_t getResidentSize() const override { return size; }
+	void releaseResidentBytes() override;
+	void restoreResidentBytes(char *bytes) override;
+
 private:
 
 	void load(int samples, int sampleRate, int bitDepth, int channels, const void *newData = 0);
 
+	/**
+	 * Decodes a long seekable stream in segments on several threads, using
+	 * clones of the decoder. Returns false without changing anything if the
+	 * stream isn't suited to it.
+	 **/
+	bool decodeParallel(Decoder *decoder);
+
 	uint8 *data;
 	size_t size;
 
@@ -118,6 +118,21 @@ double FLACDecoder::getDuration()
 	return ((double) flac->totalPCMFrameCount) / ((double) flac->sampleRate);
 }
 
+int64 FLACDecoder::getSampleCount()
+{
+	// Streams can leave the total out of their header.
+	return flac->totalPCMFrameCount > 0 ? (int64) flac->totalPCMFrameCount : -1;
+}
+
+bool FLACDecoder::seekSample(int64 sample)
+{
+	drflac_bool32 result = drflac_seek_to_pcm_frame(flac, (drflac_uint64) sample);
+	if (result)
+		eof = false;
+
+	return result;
+}
+
 } // lullaby
 } // sound
 } // love
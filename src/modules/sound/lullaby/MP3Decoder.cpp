@@ -21,6 +21,7 @@
 #define DR_MP3_IMPLEMENTATION
 #define DR_MP3_NO_STDIO
 #include "MP3Decoder.h"
+#include "StreamCache.h"
 #include "common/Exception.h"
 
 namespace love
@@ -135,6 +136,12 @@ drmp3_bool32 MP3Decoder::onSeek(void *pUserData, int offset, drmp3_seek_origin o
 	return decoder->stream->seek(pos, Stream::SEEKORIGIN_BEGIN) ? DRMP3_TRUE : DRMP3_FALSE;
 }
 
+static StreamCache<MP3SeekInfo> &getSeekInfoCache()
+{
+	static StreamCache<MP3SeekInfo> cache;
+	return cache;
+}
+
 MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 : Decoder(stream, bufferSize)
 {
@@ -143,32 +150,49 @@ MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 	if (offset == -1)
 		throw love::Exception("Could not find first valid mp3 header.");
 
+	uint64 key = getStreamKey();
+
 	// initialize mp3 handle
 	if (!drmp3_init(&mp3, onRead, onSeek, this, nullptr, nullptr))
 		throw love::Exception("Could not read mp3 data.");
 
 	sampleRate = mp3.sampleRate;
 
-	// calculate duration
-	drmp3_uint64 pcmCount, mp3FrameCount;
-	if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &pcmCount))
-	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not calculate mp3 duration.");
-	}
-	duration = ((double) pcmCount) / ((double) mp3.sampleRate);
+	// Finding the length and seek points means scanning the whole file, so
+	// it's only done for the first decoder of each file.
+	seekInfo = getSeekInfoCache().get(key);
 
-	// create seek table
-	drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
-	seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
-	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable.data()))
+	if (!seekInfo)
 	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not calculate mp3 seek table");
+		auto info = std::make_shared<MP3SeekInfo>();
+
+		// calculate duration
+		drmp3_uint64 mp3FrameCount;
+		if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &info->pcmFrameCount))
+		{
+			drmp3_uninit(&mp3);
+			throw love::Exception("Could not calculate mp3 duration.");
+		}
+
+		// create seek table
+		drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
+		info->seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
+		if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, info->seekTable.data()))
+		{
+			drmp3_uninit(&mp3);
+			throw love::Exception("Could not calculate mp3 seek table");
+		}
+		info->seekTable.resize(mp3FrameInt);
+
+		seekInfo = info;
+		getSeekInfoCache().add(key, info);
 	}
 
-	// bind seek table
-	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, seekTable.data()))
+	duration = ((double) seekInfo->pcmFrameCount) / ((double) mp3.sampleRate);
+	sampleCount = (int64) seekInfo->pcmFrameCount;
+
+	// bind seek table. dr_mp3 only reads from it.
+	if (!drmp3_bind_seek_table(&mp3, (drmp3_uint32) seekInfo->seekTable.size(), seekInfo->seekTable.data()))
 	{
 		drmp3_uninit(&mp3);
 		throw love::Exception("Could not bind mp3 seek table");
@@ -234,6 +258,21 @@ double MP3Decoder::getDuration()
 	return duration;
 }
 
+int64 MP3Decoder::getSampleCount()
+{
+	return sampleCount;
+}
+
+bool MP3Decoder::seekSample(int64 sample)
+{
+	drmp3_bool32 success = drmp3_seek_to_pcm_frame(&mp3, (drmp3_uint64) sample);
+
+	if (success)
+		eof = false;
+
+	return success;
+}
+
 } // lullaby
 } // sound
 } // love
@@ -28,6 +28,7 @@
 // dr_mp3
 #include "dr/dr_mp3.h"
 
+#include <memory>
 #include <vector>
 
 namespace love
@@ -37,6 +38,13 @@ namespace sound
 namespace lullaby
 {
 
+// Found by scanning the whole file, so shared by all decoders of that file.
+struct MP3SeekInfo
+{
+	std::vector<drmp3_seek_point> seekTable;
+	drmp3_uint64 pcmFrameCount;
+};
+
 class MP3Decoder: public love::sound::Decoder
 {
 public:
@@ -52,6 +60,8 @@ public:
 	int getChannelCount() const override;
 	int getBitDepth() const override;
 	double getDuration() override;
+	int64 getSampleCount() override;
+	bool seekSample(int64 sample) override;
 
 private:
 	static size_t onRead(void *pUserData, void *pBufferOut, size_t bytesToRead);
@@ -60,11 +70,12 @@ private:
 	// MP3 handle
 	drmp3 mp3;
 	// Used for fast seeking
-	std::vector<drmp3_seek_point> seekTable;
+	std::shared_ptr<MP3SeekInfo> seekInfo;
 	// Position of first MP3 frame found
 	int64 offset;
 
 	double duration;
+	int64 sampleCount;
 }; // MP3Decoder
 
 } // lullaby
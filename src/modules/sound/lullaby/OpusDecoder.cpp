@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OpusDecoder.h"
+
+#ifdef LOVE_ENABLE_OPUS
+
+#include "common/Exception.h"
+
+#include <stdio.h>
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+static int opusRead(void *datasource, unsigned char *ptr, int nbytes)
+{
+	auto stream = (Stream *) datasource;
+	return (int) stream->read(ptr, nbytes);
+}
+
+static int opusSeek(void *datasource, opus_int64 offset, int whence)
+{
+	auto stream = (Stream *) datasource;
+	auto origin = Stream::SEEKORIGIN_BEGIN;
+
+	switch (whence)
+	{
+	case SEEK_SET:
+		origin = Stream::SEEKORIGIN_BEGIN;
+		break;
+	case SEEK_CUR:
+		origin = Stream::SEEKORIGIN_CURRENT;
+		break;
+	case SEEK_END:
+		origin = Stream::SEEKORIGIN_END;
+		break;
+	default:
+		break;
+	};
+
+	return stream->seek(offset, origin) ? 0 : -1;
+}
+
+static opus_int64 opusTell(void *datasource)
+{
+	auto stream = (Stream *) datasource;
+	return (opus_int64) stream->tell();
+}
+
+OpusDecoder::OpusDecoder(Stream *stream, int bufferSize)
+	: Decoder(stream, bufferSize)
+	, handle(nullptr)
+	, channels(2)
+{
+	OpusFileCallbacks callbacks = {};
+	callbacks.read = opusRead;
+	callbacks.seek = opusSeek;
+	callbacks.tell = opusTell;
+	callbacks.close = nullptr; // The stream is closed elsewhere.
+
+	int error = 0;
+	handle = op_open_callbacks(stream, &callbacks, nullptr, 0, &error);
+	if (handle == nullptr)
+		throw love::Exception("Could not read Opus bitstream");
+
+	if (op_link_count(handle) == 1 && op_channel_count(handle, -1) == 1)
+		channels = 1;
+
+	sampleRate = OPUS_SAMPLE_RATE;
+}
+
+OpusDecoder::~OpusDecoder()
+{
+	op_free(handle);
+}
+
+love::sound::Decoder *OpusDecoder::clone()
+{
+	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
+	return new OpusDecoder(s, bufferSize);
+}
+
+int OpusDecoder::decode()
+{
+	opus_int16 *pcm = (opus_int16 *) buffer;
+	int total = bufferSize / (int) sizeof(opus_int16);
+	total -= total % channels;
+
+	int size = 0;
+
+	while (size < total)
+	{
+		int result = 0;
+
+		// Both return samples per channel.
+		if (channels == 1)
+			result = op_read(handle, pcm + size, total - size, nullptr);
+		else
+			result = op_read_stereo(handle, pcm + size, total - size);
+
+		if (result == OP_HOLE)
+			continue;
+		else if (result < 0)
+			return -1;
+		else if (result == 0)
+		{
+			eof = true;
+			break;
+		}
+
+		size += result * channels;
+	}
+
+	return size * (int) sizeof(opus_int16);
+}
+
+bool OpusDecoder::seek(double s)
+{
+	return seekSample((int64) (s * OPUS_SAMPLE_RATE));
+}
+
+bool OpusDecoder::rewind()
+{
+	if (op_raw_seek(handle, 0) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::isSeekable()
+{
+	return op_seekable(handle) != 0;
+}
+
+int OpusDecoder::getChannelCount() const
+{
+	return channels;
+}
+
+int OpusDecoder::getBitDepth() const
+{
+	return 16;
+}
+
+int OpusDecoder::getSampleRate() const
+{
+	return OPUS_SAMPLE_RATE;
+}
+
+double OpusDecoder::getDuration()
+{
+	int64 samples = getSampleCount();
+	return samples < 0 ? -1.0 : (double) samples / (double) OPUS_SAMPLE_RATE;
+}
+
+int64 OpusDecoder::getSampleCount()
+{
+	ogg_int64_t total = op_pcm_total(handle, -1);
+	return total < 0 ? -1 : (int64) total;
+}
+
+bool OpusDecoder::seekSample(int64 sample)
+{
+	if (op_pcm_seek(handle, (ogg_int64_t) sample) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_ENABLE_OPUS
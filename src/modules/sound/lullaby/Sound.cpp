@@ -24,12 +24,15 @@
 #include <sstream>
 
 #include "Sound.h"
+#include "data/BufferedStream.h"
+#include "data/DataStream.h"
 
 #include "ModPlugDecoder.h"
 #include "VorbisDecoder.h"
 #include "WaveDecoder.h"
 #include "FLACDecoder.h"
 #include "MP3Decoder.h"
+#include "OpusDecoder.h"
 
 #ifdef LOVE_SUPPORT_COREAUDIO
 #	include "CoreAudioDecoder.h"
@@ -77,6 +80,9 @@ sound::Decoder *Sound::newDecoder(Stream *stream, int bufferSize)
 		DecoderImplFor<WaveDecoder>(),
 		DecoderImplFor<FLACDecoder>(),
 		DecoderImplFor<VorbisDecoder>(),
+#ifdef LOVE_ENABLE_OPUS
+		DecoderImplFor<OpusDecoder>(),
+#endif
 #ifdef LOVE_SUPPORT_COREAUDIO
 		DecoderImplFor<CoreAudioDecoder>(),
 #endif
@@ -86,6 +92,15 @@ sound::Decoder *Sound::newDecoder(Stream *stream, int bufferSize)
 #endif
 	};
 
+	// Decoders make lots of small reads and seeks, which are slow on files.
+	// Streams over memory don't need the extra copy.
+	StrongRef<Stream> buffered;
+	if (stream->isSeekable() && dynamic_cast<data::DataStream *>(stream) == nullptr)
+	{
+		buffered.set(new data::BufferedStream(stream), Acquire::NORETAIN);
+		stream = buffered.get();
+	}
+
 	std::stringstream decodingErrors;
 	decodingErrors << "Failed to determine file type:\n";
 	for (DecoderImpl &possibleDecoder : possibleDecoders)
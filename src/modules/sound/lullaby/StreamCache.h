@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_LULLABY_STREAM_CACHE_H
+#define LOVE_SOUND_LULLABY_STREAM_CACHE_H
+
+// LOVE
+#include "common/int.h"
+#include "thread/threads.h"
+
+// STL
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+/**
+ * Per-file data which every Decoder of the same file can share, keyed by
+ * Decoder::getStreamKey. Only the most recently added files are kept, but
+ * Decoders hold on to what they got for as long as they need it.
+ **/
+template <typename T>
+class StreamCache
+{
+public:
+
+	std::shared_ptr<T> get(uint64 key)
+	{
+		thread::Lock lock(mutex);
+
+		for (const auto &entry : entries)
+		{
+			if (entry.first == key)
+				return entry.second;
+		}
+
+		return nullptr;
+	}
+
+	void add(uint64 key, const std::shared_ptr<T> &value)
+	{
+		thread::Lock lock(mutex);
+
+		for (auto &entry : entries)
+		{
+			if (entry.first == key)
+			{
+				entry.second = value;
+				return;
+			}
+		}
+
+		entries.emplace_back(key, value);
+
+		if (entries.size() > MAX_ENTRIES)
+			entries.pop_front();
+	}
+
+private:
+
+	static const size_t MAX_ENTRIES = 32;
+
+	thread::MutexRef mutex;
+	std::deque<std::pair<uint64, std::shared_ptr<T>>> entries;
+
+}; // StreamCache
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_SOUND_LULLABY_STREAM_CACHE_H
@@ -19,8 +19,11 @@
  **/
 
 #include "VorbisDecoder.h"
+#include "StreamCache.h"
 
 #include <string.h>
+#include <algorithm>
+#include <cmath>
 #include "common/config.h"
 #include "common/Exception.h"
 
@@ -75,6 +78,12 @@ static long vorbisTell(void *datasource)
  * END CALLBACK FUNCTIONS
  **/
 
+static StreamCache<VorbisSeekIndex> &getSeekIndexCache()
+{
+	static StreamCache<VorbisSeekIndex> cache;
+	return cache;
+}
+
 VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
 	: Decoder(stream, bufferSize)
 	, duration(-2.0)
@@ -85,11 +94,26 @@ VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
 	callbacks.read_func  = vorbisRead;
 	callbacks.tell_func  = vorbisTell;
 
+	uint64 key = 0;
+	if (stream->isSeekable())
+		key = getStreamKey();
+
 	// Open Vorbis handle
 	if (ov_open_callbacks(stream, &handle, nullptr, 0, callbacks) < 0)
 		throw love::Exception("Could not read Ogg bitstream");
 
 	vorbisInfo = ov_info(&handle, -1);
+
+	if (isSeekable())
+	{
+		seekIndex = getSeekIndexCache().get(key);
+
+		if (!seekIndex)
+		{
+			seekIndex = std::make_shared<VorbisSeekIndex>();
+			getSeekIndexCache().add(key, seekIndex);
+		}
+	}
 }
 
 VorbisDecoder::~VorbisDecoder()
@@ -127,12 +151,110 @@ int VorbisDecoder::decode()
 			break;
 		}
 		else if (result > 0)
+		{
 			size += result;
+			addCheckpoint();
+		}
 	}
 
 	return size;
 }
 
+void VorbisDecoder::addCheckpoint()
+{
+	if (!seekIndex)
+		return;
+
+	// ov_raw_tell is only meaningful right after a page boundary, which is
+	// where ov_raw_seek restarts decoding from anyway.
+	VorbisSeekIndex::Checkpoint point = {ov_pcm_tell(&handle), ov_raw_tell(&handle)};
+	if (point.pcm < 0 || point.raw < 0)
+		return;
+
+	thread::Lock lock(seekIndex->mutex);
+	auto &points = seekIndex->checkpoints;
+
+	auto it = std::upper_bound(points.begin(), points.end(), point.pcm, [](int64 pcm, const VorbisSeekIndex::Checkpoint &p)
+	{
+		return pcm < p.pcm;
+	});
+
+	// About one checkpoint per second is plenty.
+	int64 spacing = vorbisInfo->rate;
+	if (it != points.begin() && point.pcm - (it - 1)->pcm < spacing)
+		return;
+	if (it != points.end() && it->pcm - point.pcm < spacing)
+		return;
+
+	points.insert(it, point);
+}
+
+bool VorbisDecoder::seekCheckpoint(int64 sample)
+{
+	if (!seekIndex)
+		return false;
+
+	std::vector<VorbisSeekIndex::Checkpoint> candidates;
+
+	{
+		thread::Lock lock(seekIndex->mutex);
+		const auto &points = seekIndex->checkpoints;
+
+		auto it = std::upper_bound(points.begin(), points.end(), sample, [](int64 pcm, const VorbisSeekIndex::Checkpoint &p)
+		{
+			return pcm < p.pcm;
+		});
+
+		// Only worth it if the checkpoint is close to the target, otherwise
+		// libvorbis' own bisection is faster than decoding up to it.
+		while (it != points.begin() && candidates.size() < 2)
+		{
+			--it;
+			if (sample - it->pcm > 4 * (int64) vorbisInfo->rate)
+				break;
+			candidates.push_back(*it);
+		}
+	}
+
+	for (const auto &point : candidates)
+	{
+		if (ov_raw_seek(&handle, point.raw) != 0)
+			continue;
+
+		int64 pcm = ov_pcm_tell(&handle);
+		if (pcm < 0 || pcm > sample)
+			continue;
+
+		// Decode and discard up to the exact sample.
+		int frameSize = getChannelCount() * (getBitDepth() / 8);
+		int64 remaining = (sample - pcm) * frameSize;
+
+#ifdef LOVE_BIG_ENDIAN
+		int endian = 1;
+#else
+		int endian = 0;
+#endif
+
+		while (remaining > 0)
+		{
+			int chunk = (int) std::min<int64>(remaining, bufferSize);
+			long result = ov_read(&handle, (char *) buffer, chunk, endian, 2, 1, 0);
+
+			if (result == OV_HOLE)
+				continue;
+			else if (result <= 0)
+				break;
+
+			remaining -= result;
+		}
+
+		if (remaining == 0)
+			return true;
+	}
+
+	return false;
+}
+
 bool VorbisDecoder::seek(double s)
 {
 	int result = 0;
@@ -141,9 +263,16 @@ bool VorbisDecoder::seek(double s)
 	// a bug in libvorbis <= 1.3.4 when seeking to PCM 0 in multiplexed streams.
 	if (s <= 0.000001)
 		result = ov_raw_seek(&handle, 0);
+	else if (seekCheckpoint((int64) std::floor(s * vorbisInfo->rate + 0.5)))
+		result = 0;
 	else
+	{
 		result = ov_time_seek(&handle, s);
 
+		if (result == 0)
+			addCheckpoint();
+	}
+
 	if (result == 0)
 	{
 		eof = false;
@@ -25,12 +25,17 @@
 #include "common/Stream.h"
 #include "common/int.h"
 #include "sound/Decoder.h"
+#include "thread/threads.h"
 
 // vorbis
 #define OV_EXCLUDE_STATIC_CALLBACKS
 #include <vorbis/codec.h>
 #include <vorbis/vorbisfile.h>
 
+// STL
+#include <memory>
+#include <vector>
+
 namespace love
 {
 namespace sound
@@ -38,6 +43,21 @@ namespace sound
 namespace lullaby
 {
 
+// Positions in a file that decoding can restart from. Filled in while the
+// file is played, and shared by all decoders of that file.
+struct VorbisSeekIndex
+{
+	struct Checkpoint
+	{
+		int64 pcm;
+		int64 raw;
+	};
+
+	thread::MutexRef mutex;
+	// Sorted by pcm.
+	std::vector<Checkpoint> checkpoints;
+};
+
 class VorbisDecoder : public Decoder
 {
 public:
@@ -57,10 +77,17 @@ public:
 
 private:
 
+	void addCheckpoint();
+	bool seekCheckpoint(int64 sample);
+
 	OggVorbis_File handle;
 	vorbis_info *vorbisInfo;
 	double duration;
 
+	// Null if the stream isn't seekable.
+	std::shared_ptr<VorbisSeekIndex> seekIndex;
+
+
 }; // VorbisDecoder
 
 } // lullaby
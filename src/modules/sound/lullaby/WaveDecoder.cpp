@@ -171,6 +171,24 @@ double WaveDecoder::getDuration()
 	return (double) info.length / (double) info.sample_rate;
 }
 
+int64 WaveDecoder::getSampleCount()
+{
+	return (int64) info.length;
+}
+
+bool WaveDecoder::seekSample(int64 sample)
+{
+	int wuff_status = wuff_seek(handle, (wuff_uint64) sample);
+
+	if (wuff_status >= 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
 } // lullaby
 } // sound
 } // love
@@ -50,6 +50,8 @@ public:
 	int getBitDepth() const override;
 	int getSampleRate() const override;
 	double getDuration() override;
+	int64 getSampleCount() override;
+	bool seekSample(int64 sample) override;
 
 private:
 
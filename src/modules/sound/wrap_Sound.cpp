@@ -100,9 +100,12 @@ int w_newSoundData(lua_State *L)
 	// Must be string or decoder.
 	else
 	{
-		// Convert to Decoder, if necessary.
+		// Convert to Decoder, if necessary. It's only used to decode the
+		// whole file, so bigger chunks mean fewer decode calls.
 		if (!luax_istype(L, 1, Decoder::type))
 		{
+			lua_settop(L, 1);
+			lua_pushinteger(L, Decoder::FULL_DECODE_BUFFER_SIZE);
 			w_newDecoder(L);
 			lua_replace(L, 1);
 		}
@@ -146,6 +146,41 @@ int w_SoundData_slice(lua_State *L)
 	return 1;
 }
 
+int w_SoundData_convert(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int sampleRate = (int) luaL_checkinteger(L, 2);
+	int bitDepth = (int) luaL_optinteger(L, 3, t->getBitDepth());
+	int channels = (int) luaL_optinteger(L, 4, t->getChannelCount());
+
+	luax_catchexcept(L, [&](){ c = t->convert(sampleRate, bitDepth, channels); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_setIdleCompression(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setIdleCompression(enable); });
+	return 0;
+}
+
+int w_SoundData_hasIdleCompression(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	luax_pushboolean(L, t->hasIdleCompression());
+	return 1;
+}
+
+int w_SoundData_isIdleCompressed(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	luax_pushboolean(L, t->isIdleCompressed());
+	return 1;
+}
+
 static const luaL_Reg w_SoundData_functions[] =
 {
 	{ "clone", w_SoundData_clone },
@@ -158,6 +193,10 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "getSample", w_SoundData_getSample },
 	{ "copyFrom", w_SoundData_copyFrom },
 	{ "slice", w_SoundData_slice },
+	{ "convert", w_SoundData_convert },
+	{ "setIdleCompression", w_SoundData_setIdleCompression },
+	{ "hasIdleCompression", w_SoundData_hasIdleCompression },
+	{ "isIdleCompressed", w_SoundData_isIdleCompressed },
 
 	{ 0, 0 }
 };
@@ -48,6 +48,10 @@ local _getSampleRate = SoundData.getSampleRate
 local _getChannelCount = SoundData.getChannelCount
 local _getDuration = SoundData.getDuration
 local _release = SoundData.release
+local _getSample = SoundData.getSample
+local _setSample = SoundData.setSample
+local _setIdleCompression = SoundData.setIdleCompression
+local _hasIdleCompression = SoundData.hasIdleCompression
 
 -- Table which holds SoundData objects as keys, and information about the objects
 -- as values. Uses weak keys so the SoundData objects can still be GC'd properly.
@@ -55,10 +59,18 @@ local objectcache = setmetatable({}, {
 	__mode = "k",
 	__index = function(self, sounddata)
 		local bytedepth = _getBitDepth(sounddata) / 8
-		local pointer = ffi.cast(datatypes[bytedepth], sounddata:getFFIPointer())
+
+		-- The samples of SoundData with idle compression can move, so those
+		-- use the regular methods instead of a cached pointer.
+		local idlecompression = _hasIdleCompression(sounddata)
+		local pointer = nil
+		if not idlecompression then
+			pointer = ffi.cast(datatypes[bytedepth], sounddata:getFFIPointer())
+		end
 
 		local p = {
 			bytedepth = bytedepth,
+			idlecompression = idlecompression,
 			pointer = pointer,
 			size = sounddata:getSize(),
 			maxvalue = typemaxvals[bytedepth],
@@ -80,9 +92,16 @@ function SoundData:getSample(i, channel)
 	if type(i) ~= "number" then error("bad argument #1 to SoundData:getSample (expected number)", 2) end
 	if channel ~= nil and type(channel) ~= "number" then error("bad argument #2 to SoundData:getSample (expected number)", 2) end
 
-	i = floor(i)
-
 	local p = objectcache[self]
+	if p.idlecompression then
+		if channel then
+			return _getSample(self, i, channel)
+		else
+			return _getSample(self, i)
+		end
+	end
+
+	i = floor(i)
 
 	if channel then
 		if channel < 1 or channel > p.channels then
@@ -113,9 +132,16 @@ function SoundData:setSample(i, channel, sample)
 	end
 	if type(sample) ~= "number" then error("bad argument #2 to SoundData:setSample (expected number)", 2) end
 
-	i = floor(i)
-
 	local p = objectcache[self]
+	if p.idlecompression then
+		if channel then
+			return _setSample(self, i, channel, sample)
+		else
+			return _setSample(self, i, sample)
+		end
+	end
+
+	i = floor(i)
 
 	if channel then
 		if channel < 1 or channel > p.channels then
@@ -159,6 +185,11 @@ function SoundData:getDuration()
 	return objectcache[self].duration
 end
 
+function SoundData:setIdleCompression(enable)
+	_setIdleCompression(self, enable)
+	objectcache[self] = nil
+end
+
 function SoundData:release()
 	objectcache[self] = nil
 	return _release(self)
@@ -19,6 +19,9 @@
  **/
 
 #include "Channel.h"
+#include "common/Data.h"
+#include "common/Exception.h"
+#include "common/Trace.h"
 
 #include <timer/Timer.h>
 
@@ -29,30 +32,268 @@ namespace thread
 
 love::Type Channel::type("Channel", &Object::type);
 
+/**
+ * Counts the threads blocked in supply or demand, so lock-free pushes and pops
+ * only need to lock the mutex to wake them when there are any. Together with
+ * the fence in notifyWaiters, either the waiting thread sees the new value
+ * before it sleeps, or the notifying thread sees it waiting.
+ **/
+class WaitCounter
+{
+public:
+
+	WaitCounter(std::atomic<int> &waiting)
+		: waiting(waiting)
+	{
+		waiting++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	~WaitCounter()
+	{
+		waiting--;
+	}
+
+private:
+
+	std::atomic<int> &waiting;
+
+}; // WaitCounter
+
+static void getMessageBytes(const Variant &var, size_t maxSize, const char *&bytes, size_t &size)
+{
+	const Variant::Data &data = var.getData();
+
+	switch (var.getType())
+	{
+	case Variant::STRING:
+		bytes = data.string->str;
+		size = data.string->len;
+		break;
+	case Variant::SMALLSTRING:
+		bytes = data.smallstring.str;
+		size = data.smallstring.len;
+		break;
+	case Variant::LOVEOBJECT:
+		if (data.objectproxy.type != nullptr && data.objectproxy.type->isa(love::Data::type))
+		{
+			love::Data *d = (love::Data *) data.objectproxy.object;
+			bytes = (const char *) d->getData();
+			size = d->getSize();
+			break;
+		}
+		// fallthrough
+	default:
+		throw love::Exception("Only strings and Data can be pushed to a channel with a fixed message size.");
+	}
+
+	if (size > maxSize)
+		throw love::Exception("Message is larger than the channel's message size (%d bytes, maximum is %d bytes.)", (int) size, (int) maxSize);
+}
+
 Channel::Channel()
-	: sent(0)
+	: messageSize(0)
+	, capacity(0)
+	, ringHead(0)
+	, ringCount(0)
+	, waiting(0)
+	, sent(0)
 	, received(0)
 {
 }
 
+Channel::Channel(size_t messageSize, size_t capacity, bool lockFree)
+	: messageSize(messageSize)
+	, capacity(capacity)
+	, ringHead(0)
+	, ringCount(0)
+	, waiting(0)
+	, sent(0)
+	, received(0)
+{
+	if (capacity == 0)
+		throw love::Exception("Channel capacity must be greater than 0.");
+
+	if (lockFree && messageSize > 0)
+		throw love::Exception("Lock-free channels can't have a fixed message size.");
+
+	if (messageSize > 0 && capacity > SIZE_MAX / messageSize)
+		throw love::Exception("Channel message size and capacity are too large.");
+
+	if (lockFree && capacity > ((size_t) 1 << 30))
+		throw love::Exception("Channel capacity is too large.");
+
+	try
+	{
+		if (lockFree)
+		{
+			lockFreeQueue.reset(new LockFreeQueue<Variant>(capacity));
+			this->capacity = lockFreeQueue->getCapacity();
+		}
+		else if (messageSize > 0)
+		{
+			ring.resize(messageSize * capacity);
+			ringSizes.resize(capacity);
+		}
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+}
+
 Channel::~Channel()
 {
 }
 
-uint64 Channel::push(const Variant &var)
+uint64 Channel::tryPush(Variant &var)
 {
-	Lock l(mutex);
+	if (lockFreeQueue)
+	{
+		size_t position = 0;
+		if (!lockFreeQueue->push(var, position))
+			return 0;
 
-	queue.push(var);
-	cond->broadcast();
+		return (uint64) position + 1;
+	}
+
+	if (messageSize > 0)
+	{
+		if (ringCount == capacity)
+			return 0;
+
+		const char *bytes = nullptr;
+		size_t size = 0;
+		getMessageBytes(var, messageSize, bytes, size);
+
+		size_t slot = (ringHead + ringCount) % capacity;
+		memcpy(&ring[slot * messageSize], bytes, size);
+		ringSizes[slot] = size;
+		ringCount++;
+	}
+	else
+	{
+		if (capacity > 0 && queue.size() >= capacity)
+			return 0;
+
+		queue.push(std::move(var));
+	}
 
 	return ++sent;
 }
 
+bool Channel::tryPop(Variant *var)
+{
+	if (lockFreeQueue)
+	{
+		if (!lockFreeQueue->pop(*var))
+			return false;
+	}
+	else if (messageSize > 0)
+	{
+		if (ringCount == 0)
+			return false;
+
+		*var = Variant(&ring[ringHead * messageSize], ringSizes[ringHead]);
+		ringHead = (ringHead + 1) % capacity;
+		ringCount--;
+	}
+	else
+	{
+		if (queue.empty())
+			return false;
+
+		*var = std::move(queue.front());
+		queue.pop();
+	}
+
+	received++;
+	return true;
+}
+
+void Channel::signal()
+{
+	if (lockFreeQueue)
+		notifyWaiters();
+	else
+		cond->broadcast();
+}
+
+void Channel::notifyWaiters()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiting.load() > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+uint64 Channel::push(const Variant &var)
+{
+	Variant v(var);
+	return push(std::move(v));
+}
+
+uint64 Channel::push(Variant &&var)
+{
+	EmptyLock lock;
+	if (!lockFreeQueue)
+		lock.setLock(mutex);
+
+	uint64 id = tryPush(var);
+	if (id != 0)
+		signal();
+
+	return id;
+}
+
+uint64 Channel::pushMany(std::vector<Variant> &vars, size_t &count)
+{
+	EmptyLock lock;
+	if (!lockFreeQueue)
+		lock.setLock(mutex);
+
+	uint64 id = 0;
+
+	try
+	{
+		for (count = 0; count < vars.size(); count++)
+		{
+			uint64 newid = tryPush(vars[count]);
+			if (newid == 0)
+				break;
+			id = newid;
+		}
+	}
+	catch (love::Exception &)
+	{
+		// Values pushed before the one which failed still need to be seen.
+		if (count > 0)
+			signal();
+		throw;
+	}
+
+	if (count > 0)
+		signal();
+
+	return id;
+}
+
 bool Channel::supply(const Variant &var)
 {
+	LOVE_TRACE_ZONE("Channel::supply");
+
 	Lock l(mutex);
-	uint64 id = push(var);
+	WaitCounter counter(waiting);
+	Variant v(var);
+
+	uint64 id = 0;
+	while ((id = tryPush(v)) == 0)
+		cond->wait(mutex);
+
+	signal();
 
 	while (received < id)
 		cond->wait(mutex);
@@ -62,12 +303,20 @@ bool Channel::supply(const Variant &var)
 
 bool Channel::supply(const Variant &var, double timeout)
 {
+	LOVE_TRACE_ZONE("Channel::supply");
+
 	Lock l(mutex);
-	uint64 id = push(var);
+	WaitCounter counter(waiting);
+	Variant v(var);
+
+	uint64 id = 0;
 
 	while (timeout >= 0)
 	{
-		if (received >= id)
+		if (id == 0 && (id = tryPush(v)) != 0)
+			signal();
+
+		if (id != 0 && received >= id)
 			return true;
 
 		double start = love::timer::Timer::getTime();
@@ -82,23 +331,44 @@ bool Channel::supply(const Variant &var, double timeout)
 
 bool Channel::pop(Variant *var)
 {
-	Lock l(mutex);
+	EmptyLock lock;
+	if (!lockFreeQueue)
+		lock.setLock(mutex);
 
-	if (queue.empty())
+	if (!tryPop(var))
 		return false;
 
-	*var = queue.front();
-	queue.pop();
+	signal();
+	return true;
+}
 
-	received++;
-	cond->broadcast();
+size_t Channel::popMany(std::vector<Variant> &vars, size_t max)
+{
+	EmptyLock lock;
+	if (!lockFreeQueue)
+		lock.setLock(mutex);
 
-	return true;
+	size_t count = 0;
+	Variant var;
+
+	while (count < max && tryPop(&var))
+	{
+		vars.push_back(std::move(var));
+		count++;
+	}
+
+	if (count > 0)
+		signal();
+
+	return count;
 }
 
 bool Channel::demand(Variant *var)
 {
+	LOVE_TRACE_ZONE("Channel::demand");
+
 	Lock l(mutex);
+	WaitCounter counter(waiting);
 
 	while (!pop(var))
 		cond->wait(mutex);
@@ -108,7 +378,10 @@ bool Channel::demand(Variant *var)
 
 bool Channel::demand(Variant *var, double timeout)
 {
+	LOVE_TRACE_ZONE("Channel::demand");
+
 	Lock l(mutex);
+	WaitCounter counter(waiting);
 
 	while (timeout >= 0)
 	{
@@ -127,8 +400,21 @@ bool Channel::demand(Variant *var, double timeout)
 
 bool Channel::peek(Variant *var)
 {
+	// Another thread could pop the value while it's being copied.
+	if (lockFreeQueue)
+		throw love::Exception("Lock-free channels do not support peek.");
+
 	Lock l(mutex);
 
+	if (messageSize > 0)
+	{
+		if (ringCount == 0)
+			return false;
+
+		*var = Variant(&ring[ringHead * messageSize], ringSizes[ringHead]);
+		return true;
+	}
+
 	if (queue.empty())
 		return false;
 
@@ -138,8 +424,11 @@ bool Channel::peek(Variant *var)
 
 int Channel::getCount() const
 {
+	if (lockFreeQueue)
+		return (int) lockFreeQueue->getCount();
+
 	Lock l(mutex);
-	return (int) queue.size();
+	return (int) (messageSize > 0 ? ringCount : queue.size());
 }
 
 bool Channel::hasRead(uint64 id) const
@@ -150,20 +439,47 @@ bool Channel::hasRead(uint64 id) const
 
 void Channel::clear()
 {
+	if (lockFreeQueue)
+	{
+		Variant var;
+		while (pop(&var))
+		{
+		}
+		return;
+	}
+
 	Lock l(mutex);
 
 	// We're already empty.
-	if (queue.empty())
+	if (queue.empty() && ringCount == 0)
 		return;
 
 	while (!queue.empty())
 		queue.pop();
 
+	ringHead = 0;
+	ringCount = 0;
+
 	// Finish all the supply waits
 	received = sent;
 	cond->broadcast();
 }
 
+size_t Channel::getMessageSize() const
+{
+	return messageSize;
+}
+
+size_t Channel::getCapacity() const
+{
+	return capacity;
+}
+
+bool Channel::isLockFree() const
+{
+	return lockFreeQueue.get() != nullptr;
+}
+
 void Channel::lockMutex()
 {
 	mutex->lock();
@@ -22,12 +22,16 @@
 #define LOVE_THREAD_CHANNEL_H
 
 // STL
+#include <atomic>
+#include <memory>
 #include <queue>
+#include <vector>
 
 // LOVE
 #include "common/Variant.h"
 #include "common/int.h"
 #include "threads.h"
+#include "LockFreeQueue.h"
 
 namespace love
 {
@@ -41,30 +45,100 @@ public:
 	static love::Type type;
 
 	Channel();
+
+	/**
+	 * Creates a channel which holds a limited number of values. Pushing to a
+	 * full channel fails, and supply waits for space.
+	 *
+	 * @param messageSize If non-zero, the channel stores up to capacity
+	 *        messages of at most this many bytes each, in a ring buffer
+	 *        allocated up front. Only strings and Data can be pushed to it,
+	 *        and messages are popped as strings.
+	 * @param capacity The maximum number of values in the channel.
+	 * @param lockFree Whether push and pop should work without locking, so
+	 *        many threads can use the channel without contending on its
+	 *        mutex. The capacity is rounded up to a power of two. Lock-free
+	 *        channels don't support peek, and performAtomic doesn't keep
+	 *        other threads from pushing or popping.
+	 **/
+	Channel(size_t messageSize, size_t capacity, bool lockFree = false);
+
 	~Channel();
 
+	/**
+	 * Pushes a value onto the channel. Returns an ID for use with hasRead, or
+	 * 0 if the channel has a fixed capacity and is full.
+	 **/
 	uint64 push(const Variant &var);
+	uint64 push(Variant &&var);
 	bool supply(const Variant &var); // blocking push
 	bool supply(const Variant &var, double timeout);
 	bool pop(Variant *var);
 	bool demand(Variant *var); // blocking pop
 	bool demand(Variant *var, double timeout); // blocking pop
 	bool peek(Variant *var);
+
+	/**
+	 * Pushes values in order until they've all been pushed or the channel is
+	 * full, locking and waking waiting threads only once.
+	 *
+	 * @param[in,out] vars The values to push. Pushed values are moved from.
+	 * @param[out] count The number of values pushed.
+	 * @return The ID of the last pushed value, or 0 if none were pushed.
+	 **/
+	uint64 pushMany(std::vector<Variant> &vars, size_t &count);
+
+	/**
+	 * Pops up to max values, locking and waking waiting threads only once.
+	 *
+	 * @param[out] vars The popped values are appended to this.
+	 * @return The number of values popped.
+	 **/
+	size_t popMany(std::vector<Variant> &vars, size_t max);
+
 	int getCount() const;
 	bool hasRead(uint64 id) const;
 	void clear();
 
+	size_t getMessageSize() const;
+	size_t getCapacity() const;
+	bool isLockFree() const;
+
 	void lockMutex();
 	void unlockMutex();
 
 private:
 
+	// Moves var into the channel if there's room. The mutex must be locked,
+	// unless the channel is lock-free.
+	uint64 tryPush(Variant &var);
+	bool tryPop(Variant *var);
+
+	// Wakes threads waiting in supply or demand. The mutex must be locked,
+	// unless the channel is lock-free.
+	void signal();
+
+	// Wakes threads waiting in supply or demand after a lock-free push or pop.
+	void notifyWaiters();
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
 
+	// Used instead of the queue for fixed-size messages.
+	size_t messageSize;
+	size_t capacity;
+	std::vector<char> ring;
+	std::vector<size_t> ringSizes;
+	size_t ringHead;
+	size_t ringCount;
+
+	// Used instead of the queue by lock-free channels.
+	std::unique_ptr<LockFreeQueue<Variant>> lockFreeQueue;
+	std::atomic<int> waiting;
+
 	uint64 sent;
-	uint64 received;
+	std::atomic<uint64> received;
 
 }; // Channel
 
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_FUTURE_H
+#define LOVE_THREAD_FUTURE_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "JobSystem.h"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * The eventual result of a job: either a list of values or an error message.
+ * The job fills it in before its counter reaches zero, so the results can be
+ * read without locking once isDone returns true.
+ **/
+class Future : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	Future();
+	virtual ~Future();
+
+	bool isDone() const;
+
+	/**
+	 * Waits for the job to finish, running other jobs in the meantime.
+	 * A negative timeout waits forever. Returns whether the job is done.
+	 **/
+	bool wait(double timeout = -1.0);
+
+	bool hasError() const { return haserror; }
+	const std::string &getError() const { return error; }
+	const std::vector<Variant> &getResults() const { return results; }
+
+	// Only called by the job.
+	void setResults(std::vector<Variant> &&results);
+	void setError(const std::string &error);
+
+	JobSystem::Counter &getCounter() { return counter; }
+
+private:
+
+	JobSystem::Counter counter;
+
+	std::vector<Variant> results;
+	std::string error;
+	bool haserror;
+
+}; // Future
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_FUTURE_H
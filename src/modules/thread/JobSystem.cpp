@@ -0,0 +1,402 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "JobSystem.h"
+#include "timer/Timer.h"
+#include "common/Trace.h"
+
+// STL
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+// Index of the worker owned by the calling thread, or -1.
+static thread_local int currentWorker = -1;
+
+class JobSystem::Worker : public Threadable
+{
+public:
+
+	Worker(JobSystem *system, int index)
+		: system(system)
+		, index(index)
+	{
+		threadName = "JobWorker";
+	}
+
+	void threadFunction() override
+	{
+		system->workerFunction(index);
+	}
+
+private:
+
+	JobSystem *system;
+	int index;
+
+}; // Worker
+
+JobSystem *JobSystem::getInstance()
+{
+	// Never destroyed: joining the workers during static destruction could
+	// happen after SDL has shut down. stopWorkers does that instead.
+	static JobSystem *instance = new JobSystem();
+	return instance;
+}
+
+bool JobSystem::isWorkerThread()
+{
+	return currentWorker >= 0;
+}
+
+JobSystem::JobSystem()
+	: queuedTasks(0)
+	, quit(false)
+{
+	int cores = (int) std::thread::hardware_concurrency();
+
+	// Always have at least one worker, so submitted jobs run even when
+	// nobody waits on them.
+	int workercount = std::max(cores - 1, 1);
+
+	for (int i = 0; i < workercount + 1; i++)
+		queues.emplace_back(new Queue());
+
+	startWorkers();
+}
+
+JobSystem::~JobSystem()
+{
+	stopWorkers();
+}
+
+void JobSystem::startWorkers()
+{
+	if (!workers.empty())
+		return;
+
+	quit = false;
+
+	int workercount = (int) queues.size() - 1;
+
+	for (int i = 0; i < workercount; i++)
+	{
+		StrongRef<Worker> worker(new Worker(this, (int) workers.size()), Acquire::NORETAIN);
+
+		// Without threads, jobs only run on threads waiting for them.
+		if (!worker->start())
+			break;
+
+		workers.push_back(worker);
+	}
+}
+
+void JobSystem::stopWorkers()
+{
+	{
+		Lock lock(sleepMutex);
+		quit = true;
+		sleepCond->broadcast();
+	}
+
+	for (const auto &worker : workers)
+		worker->wait();
+
+	workers.clear();
+}
+
+int JobSystem::getWorkerCount() const
+{
+	return (int) workers.size();
+}
+
+void JobSystem::submit(const Job &job, Counter *counter)
+{
+	if (counter != nullptr)
+		counter->pending++;
+
+	Queue *queue = currentWorker >= 0 ? queues[currentWorker].get() : queues.back().get();
+
+	{
+		Lock lock(queue->mutex);
+		queue->tasks.push_back({job, counter});
+	}
+
+	queuedTasks++;
+
+	Lock lock(sleepMutex);
+	sleepCond->signal();
+}
+
+void JobSystem::wait(Counter &counter)
+{
+	while (!counter.isDone())
+	{
+		Task task;
+		if (findTask(task))
+		{
+			runTask(task);
+			continue;
+		}
+
+		// The remaining jobs are running elsewhere. Wake up now and then in
+		// case they queue more jobs we could help with.
+		Lock lock(doneMutex);
+		if (!counter.isDone())
+			doneCond->wait(doneMutex, 1);
+	}
+
+	rethrowError(counter);
+}
+
+bool JobSystem::wait(Counter &counter, double timeout)
+{
+	double end = love::timer::Timer::getTime() + timeout;
+
+	while (!counter.isDone())
+	{
+		if (love::timer::Timer::getTime() >= end)
+			return false;
+
+		Task task;
+		if (findTask(task))
+		{
+			runTask(task);
+			continue;
+		}
+
+		Lock lock(doneMutex);
+		if (!counter.isDone())
+			doneCond->wait(doneMutex, 1);
+	}
+
+	rethrowError(counter);
+	return true;
+}
+
+void JobSystem::rethrowError(Counter &counter)
+{
+	std::exception_ptr error;
+
+	{
+		Lock lock(doneMutex);
+		std::swap(error, counter.error);
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+struct JobSystem::ParallelFor
+{
+	const std::function<void(size_t, size_t)> *func;
+	size_t count;
+	size_t rangeSize;
+	size_t ranges;
+
+	std::atomic<size_t> next;
+	std::atomic<size_t> done;
+
+	MutexRef errorMutex;
+	std::exception_ptr error;
+};
+
+void JobSystem::parallelFor(size_t count, size_t minRange, const std::function<void(size_t, size_t)> &func)
+{
+	if (count == 0)
+		return;
+
+	// A few ranges per thread, so threads which finish early can take more.
+	size_t maxranges = (size_t) (workers.size() + 1) * 4;
+	size_t ranges = std::min(count / std::max(minRange, (size_t) 1), maxranges);
+
+	if (ranges <= 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	// Helpers can start after this returns, if the workers are busy with
+	// other jobs, so they share ownership of the state. They only use func
+	// after claiming a range, which this waits for.
+	auto state = std::make_shared<ParallelFor>();
+	state->func = &func;
+	state->count = count;
+	state->rangeSize = (count + ranges - 1) / ranges;
+	state->ranges = (count + state->rangeSize - 1) / state->rangeSize;
+	state->next = 0;
+	state->done = 0;
+
+	size_t helpers = std::min(state->ranges - 1, workers.size());
+	for (size_t i = 0; i < helpers; i++)
+		submit([this, state]() { runRanges(*state); });
+
+	// Ranges no helper has claimed yet are run here, rather than waiting for
+	// a worker to get to them.
+	runRanges(*state);
+
+	{
+		Lock lock(doneMutex);
+		while (state->done.load() < state->ranges)
+			doneCond->wait(doneMutex);
+	}
+
+	if (state->error)
+		std::rethrow_exception(state->error);
+}
+
+void JobSystem::runRanges(ParallelFor &state)
+{
+	size_t finished = 0;
+
+	for (size_t i = state.next++; i < state.ranges; i = state.next++)
+	{
+		size_t begin = i * state.rangeSize;
+		size_t end = std::min(begin + state.rangeSize, state.count);
+
+		try
+		{
+			(*state.func)(begin, end);
+		}
+		catch (...)
+		{
+			Lock lock(state.errorMutex);
+			if (!state.error)
+				state.error = std::current_exception();
+		}
+
+		finished++;
+	}
+
+	if (finished > 0 && (state.done += finished) == state.ranges)
+	{
+		Lock lock(doneMutex);
+		doneCond->broadcast();
+	}
+}
+
+void JobSystem::workerFunction(int index)
+{
+	currentWorker = index;
+
+	std::string tracename = "Job worker " + std::to_string(index);
+	love::trace::setThreadName(tracename.c_str());
+
+	while (true)
+	{
+		Task task;
+		if (findTask(task))
+		{
+			runTask(task);
+			continue;
+		}
+
+		Lock lock(sleepMutex);
+
+		if (quit)
+			break;
+
+		if (queuedTasks.load() == 0)
+			sleepCond->wait(sleepMutex);
+	}
+
+	currentWorker = -1;
+}
+
+bool JobSystem::findTask(Task &task)
+{
+	if (queuedTasks.load() == 0)
+		return false;
+
+	int self = currentWorker;
+
+	// Our own newest job first, since its data is most likely still cached.
+	if (self >= 0)
+	{
+		Queue *queue = queues[self].get();
+		Lock lock(queue->mutex);
+		if (!queue->tasks.empty())
+		{
+			task = std::move(queue->tasks.back());
+			queue->tasks.pop_back();
+			queuedTasks--;
+			return true;
+		}
+	}
+
+	// Then jobs from non-worker threads, then other workers' oldest jobs.
+	// Thieves start at different queues so they don't all contend on one.
+	int count = (int) queues.size();
+	int shared = count - 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		int index = i == 0 ? shared : (self + i) % shared;
+		if (index == self || (i > 0 && index == shared))
+			continue;
+
+		Queue *queue = queues[index].get();
+		Lock lock(queue->mutex);
+		if (!queue->tasks.empty())
+		{
+			task = std::move(queue->tasks.front());
+			queue->tasks.pop_front();
+			queuedTasks--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::runTask(Task &task)
+{
+	try
+	{
+		task.job();
+	}
+	catch (...)
+	{
+		// Stored before the counter is decremented, so waiters see it.
+		if (task.counter != nullptr)
+		{
+			Lock lock(doneMutex);
+			if (!task.counter->error)
+				task.counter->error = std::current_exception();
+		}
+	}
+
+	// The job may hold the last reference to whatever owns the counter, so
+	// the job is only released by the caller after this.
+	if (task.counter != nullptr && --task.counter->pending == 0)
+	{
+		Lock lock(doneMutex);
+		doneCond->broadcast();
+	}
+}
+
+} // thread
+} // love
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_JOB_SYSTEM_H
+#define LOVE_THREAD_JOB_SYSTEM_H
+
+// LOVE
+#include "threads.h"
+
+// STL
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A process-wide pool of worker threads which run short jobs. There is one
+ * worker per core minus one (the calling thread is expected to help), and
+ * each worker has its own queue: workers run their newest job first and steal
+ * the oldest jobs from other workers when they run out.
+ *
+ * The first exception escaping a job in a counter's group is rethrown by
+ * wait once the group has finished. Exceptions from jobs submitted without a
+ * counter are discarded, since nothing waits on them.
+ *
+ * The thread module starts the workers and stops them when it's destroyed,
+ * so they aren't left running past SDL's shutdown.
+ **/
+class JobSystem
+{
+public:
+
+	typedef std::function<void()> Job;
+
+	/**
+	 * Keeps track of the unfinished jobs in a group.
+	 **/
+	class Counter
+	{
+	public:
+
+		Counter() : pending(0) {}
+
+		bool isDone() const { return pending.load() == 0; }
+
+	private:
+
+		friend class JobSystem;
+		std::atomic<int> pending;
+
+		// Guarded by the job system's doneMutex.
+		std::exception_ptr error;
+
+	}; // Counter
+
+	/**
+	 * Gets the shared job system, creating its workers on first use.
+	 **/
+	static JobSystem *getInstance();
+
+	/**
+	 * Starts the workers if they aren't running. Called by the thread module
+	 * when it's created, e.g. after a restart.
+	 **/
+	void startWorkers();
+
+	/**
+	 * Stops and joins the workers. Jobs which are still queued only run on
+	 * threads waiting for them afterwards. Called by the thread module when
+	 * it's destroyed.
+	 **/
+	void stopWorkers();
+
+	/**
+	 * Returns true if the calling thread is one of the job system's workers.
+	 **/
+	static bool isWorkerThread();
+
+	int getWorkerCount() const;
+
+	/**
+	 * Queues a job. Jobs submitted from a worker go to that worker's queue.
+	 *
+	 * @param counter Optional. Incremented now and decremented once the job
+	 *                has finished.
+	 **/
+	void submit(const Job &job, Counter *counter = nullptr);
+
+	/**
+	 * Runs queued jobs on the calling thread until every job in the counter's
+	 * group has finished, then rethrows the first exception thrown by one of
+	 * them, if any.
+	 **/
+	void wait(Counter &counter);
+
+	/**
+	 * Like wait(Counter&), but gives up after the timeout (in seconds).
+	 * Returns whether the group has finished.
+	 **/
+	bool wait(Counter &counter, double timeout);
+
+	/**
+	 * Splits [0, count) into ranges of at least minRange items and calls func
+	 * on each range, using the calling thread as well as the workers. Returns
+	 * once every range is done. Unlike wait, the calling thread only runs
+	 * ranges of this loop, never unrelated jobs, so it's safe to use from
+	 * latency-sensitive threads. An exception thrown by func is rethrown here
+	 * after the other ranges finish.
+	 **/
+	void parallelFor(size_t count, size_t minRange, const std::function<void(size_t begin, size_t end)> &func);
+
+private:
+
+	class Worker;
+	struct ParallelFor;
+
+	struct Task
+	{
+		Job job;
+		Counter *counter;
+	};
+
+	struct Queue
+	{
+		MutexRef mutex;
+		std::deque<Task> tasks;
+	};
+
+	JobSystem();
+	~JobSystem();
+
+	void workerFunction(int index);
+
+	bool findTask(Task &task);
+	void runTask(Task &task);
+	void rethrowError(Counter &counter);
+	void runRanges(ParallelFor &state);
+
+	std::vector<StrongRef<Worker>> workers;
+
+	// One queue per worker, then a shared queue for jobs from other threads.
+	std::vector<std::unique_ptr<Queue>> queues;
+
+	// Number of jobs waiting in queues, not counting ones being run.
+	std::atomic<int> queuedTasks;
+	bool quit;
+
+	MutexRef sleepMutex;
+	ConditionalRef sleepCond;
+
+	MutexRef doneMutex;
+	ConditionalRef doneCond;
+
+}; // JobSystem
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_SYSTEM_H
@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LOCK_FREE_QUEUE_H
+#define LOVE_THREAD_LOCK_FREE_QUEUE_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A bounded queue which any number of threads can push to and pop from
+ * without locking. Based on Dmitry Vyukov's bounded MPMC queue: each cell has
+ * a sequence number which tells producers and consumers whether it's ready
+ * for them, so threads only contend on the queue's head or tail position.
+ **/
+template <typename T>
+class LockFreeQueue
+{
+public:
+
+	/**
+	 * @param capacity The maximum number of values in the queue. Rounded up
+	 *                 to a power of two.
+	 **/
+	LockFreeQueue(size_t capacity)
+		: mask(0)
+		, enqueuePos(0)
+		, dequeuePos(0)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+
+		cells.reset(new Cell[size]);
+		mask = size - 1;
+
+		for (size_t i = 0; i < size; i++)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Moves value into the queue, unless it's full.
+	 *
+	 * @param[in,out] value The value to push. Only moved from on success.
+	 * @param[out] position The number of values pushed before this one.
+	 * @return Whether the value was pushed.
+	 **/
+	bool push(T &value, size_t &position)
+	{
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		Cell *cell = nullptr;
+
+		while (true)
+		{
+			cell = &cells[pos & mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) pos;
+
+			if (diff == 0)
+			{
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; // Full.
+			else
+				pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+
+		cell->value = std::move(value);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+
+		position = pos;
+		return true;
+	}
+
+	/**
+	 * Moves the oldest value out of the queue, unless it's empty.
+	 **/
+	bool pop(T &value)
+	{
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		Cell *cell = nullptr;
+
+		while (true)
+		{
+			cell = &cells[pos & mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) (pos + 1);
+
+			if (diff == 0)
+			{
+				if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; // Empty.
+			else
+				pos = dequeuePos.load(std::memory_order_relaxed);
+		}
+
+		value = std::move(cell->value);
+		cell->value = T();
+		cell->sequence.store(pos + mask + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * Gets the number of values in the queue. Only approximate while other
+	 * threads are pushing or popping.
+	 **/
+	size_t getCount() const
+	{
+		size_t enqueued = enqueuePos.load(std::memory_order_relaxed);
+		size_t dequeued = dequeuePos.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return mask + 1;
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+
+	// Kept on separate cache lines so producers and consumers don't slow
+	// each other down.
+	alignas(64) std::atomic<size_t> enqueuePos;
+	alignas(64) std::atomic<size_t> dequeuePos;
+
+}; // LockFreeQueue
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LOCK_FREE_QUEUE_H
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "LuaJob.h"
+#include "common/config.h"
+#include "common/Exception.h"
+#include "common/runtime.h"
+
+#ifdef LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love(lua_State * L);
+#endif // LOVE_BUILD_STANDALONE
+
+namespace love
+{
+namespace thread
+{
+
+// Registry key of the table mapping code strings to compiled functions.
+static const char JOB_CHUNKS_KEY[] = "_love_jobchunks";
+
+// Never closed: the modules its objects belong to may be gone by the time
+// the thread exits.
+static thread_local lua_State *jobState = nullptr;
+
+static lua_State *getJobState()
+{
+	if (jobState != nullptr)
+		return jobState;
+
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+#ifdef LOVE_BUILD_STANDALONE
+	luax_preload(L, luaopen_love, "love");
+	luax_require(L, "love");
+	lua_pop(L, 1);
+#endif // LOVE_BUILD_STANDALONE
+
+	luax_require(L, "love.thread");
+	lua_pop(L, 1);
+
+	// See LuaThread::threadFunction.
+	luax_require(L, "love.filesystem");
+	lua_pop(L, 1);
+
+	lua_newtable(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, JOB_CHUNKS_KEY);
+
+	jobState = L;
+	return L;
+}
+
+static void runJob(const std::string &name, love::Data *code, const std::vector<Variant> &args, Future *future)
+{
+	lua_State *L = getJobState();
+
+	// Jobs can run inside other jobs which are waiting on a Future.
+	int top = lua_gettop(L);
+
+	lua_pushcfunction(L, luax_traceback);
+	int tracebackidx = lua_gettop(L);
+
+	lua_getfield(L, LUA_REGISTRYINDEX, JOB_CHUNKS_KEY);
+	lua_pushlstring(L, (const char *) code->getData(), code->getSize());
+	lua_pushvalue(L, -1);
+	lua_rawget(L, -3);
+
+	if (lua_isnil(L, -1))
+	{
+		lua_pop(L, 1);
+
+		if (luaL_loadbuffer(L, (const char *) code->getData(), code->getSize(), name.c_str()) != 0)
+		{
+			future->setError(luax_tostring(L, -1));
+			lua_settop(L, top);
+			return;
+		}
+
+		lua_pushvalue(L, -2);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, -5);
+	}
+
+	for (const Variant &arg : args)
+		luax_pushvariant(L, arg);
+
+	int funcidx = lua_gettop(L) - (int) args.size();
+
+	if (lua_pcall(L, (int) args.size(), LUA_MULTRET, tracebackidx) != 0)
+	{
+		future->setError(luax_tostring(L, -1));
+		lua_settop(L, top);
+		return;
+	}
+
+	std::vector<Variant> results;
+	int resultcount = lua_gettop(L) - funcidx + 1;
+
+	try
+	{
+		for (int i = 0; i < resultcount; i++)
+		{
+			results.push_back(luax_checkvariant(L, funcidx + i));
+			if (results.back().getType() == Variant::UNKNOWN)
+				throw love::Exception("Job result #%d must be a boolean, number, string, love type, or flat table.", i + 1);
+		}
+
+		future->setResults(std::move(results));
+	}
+	catch (love::Exception &e)
+	{
+		future->setError(e.what());
+	}
+
+	lua_settop(L, top);
+}
+
+Future *runLuaJob(const std::string &name, love::Data *code, const std::vector<Variant> &args)
+{
+	Future *future = new Future();
+
+	StrongRef<love::Data> coderef(code);
+	StrongRef<Future> futureref(future);
+
+	JobSystem::getInstance()->submit([=]() { runJob(name, coderef, args, futureref); }, &future->getCounter());
+
+	return future;
+}
+
+} // thread
+} // love
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUAJOB_H
+#define LOVE_THREAD_LUAJOB_H
+
+// LOVE
+#include "common/Data.h"
+#include "common/Variant.h"
+#include "Future.h"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Queues Lua code to run on the job system. Each thread that runs Lua jobs
+ * keeps its own Lua state (with love.thread and love.filesystem loaded) for
+ * the lifetime of the program, and caches the compiled code in it, so globals
+ * set by one job can be seen by later jobs on the same thread.
+ *
+ * The code's return values become the Future's results.
+ **/
+Future *runLuaJob(const std::string &name, love::Data *code, const std::vector<Variant> &args);
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUAJOB_H
@@ -22,6 +22,7 @@
 #include "event/Event.h"
 #include "common/config.h"
 #include "common/runtime.h"
+#include "common/Trace.h"
 
 #ifdef LOVE_BUILD_STANDALONE
 extern "C" int luaopen_love(lua_State * L);
@@ -51,6 +52,8 @@ void LuaThread::threadFunction()
 	error.clear();
 	haserror = false;
 
+	love::trace::setThreadName(name.c_str());
+
 	lua_State *L = luaL_newstate();
 	luaL_openlibs(L);
 
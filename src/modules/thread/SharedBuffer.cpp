@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SharedBuffer.h"
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace thread
+{
+
+love::Type SharedBuffer::type("SharedBuffer", &Data::type);
+
+SharedBuffer::SharedBuffer(size_t size)
+	: size(size)
+{
+	create();
+	memset(data, 0, size);
+}
+
+SharedBuffer::SharedBuffer(const SharedBuffer &other)
+	: size(other.size)
+{
+	create();
+	memcpy(data, other.data, size);
+}
+
+SharedBuffer::~SharedBuffer()
+{
+	delete[] data;
+}
+
+void SharedBuffer::create()
+{
+	if (size == 0)
+		throw love::Exception("SharedBuffer size must be greater than 0.");
+
+	// new[] memory is aligned for any fundamental type, so atomic values at
+	// aligned offsets are aligned in memory too.
+	try
+	{
+		data = new char[size];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+}
+
+SharedBuffer *SharedBuffer::clone() const
+{
+	return new SharedBuffer(*this);
+}
+
+void *SharedBuffer::getData() const
+{
+	return data;
+}
+
+size_t SharedBuffer::getSize() const
+{
+	return size;
+}
+
+STRINGMAP_CLASS_BEGIN(SharedBuffer, SharedBuffer::AtomicType, SharedBuffer::ATOMIC_MAX_ENUM, atomicType)
+{
+	{ "int32", SharedBuffer::ATOMIC_INT32 },
+	{ "int64", SharedBuffer::ATOMIC_INT64 },
+	{ "float", SharedBuffer::ATOMIC_FLOAT },
+}
+STRINGMAP_CLASS_END(SharedBuffer, SharedBuffer::AtomicType, SharedBuffer::ATOMIC_MAX_ENUM, atomicType)
+
+} // thread
+} // love
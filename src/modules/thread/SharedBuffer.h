@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_SHARED_BUFFER_H
+#define LOVE_THREAD_SHARED_BUFFER_H
+
+// LOVE
+#include "common/Data.h"
+#include "common/Exception.h"
+#include "common/int.h"
+#include "common/StringMap.h"
+
+// STL
+#include <atomic>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A block of memory which several threads can use at once. Passing it through
+ * a Channel shares the memory rather than copying it. Plain reads and writes
+ * (e.g. through Data:getFFIPointer) aren't synchronized; the atomic methods
+ * are, and can be used to coordinate access to the rest of the buffer.
+ **/
+class SharedBuffer : public love::Data
+{
+public:
+
+	enum AtomicType
+	{
+		ATOMIC_INT32,
+		ATOMIC_INT64,
+		ATOMIC_FLOAT,
+		ATOMIC_MAX_ENUM
+	};
+
+	static love::Type type;
+
+	SharedBuffer(size_t size);
+	SharedBuffer(const SharedBuffer &other);
+	virtual ~SharedBuffer();
+
+	// Implements Data.
+	SharedBuffer *clone() const override;
+	void *getData() const override;
+	size_t getSize() const override;
+
+	/**
+	 * Atomic operations on the value at a byte offset, which must be a
+	 * multiple of the value's size. Floats are compared bitwise.
+	 **/
+	template <typename T>
+	T atomicLoad(size_t offset) const
+	{
+		return getAtomic<T>(offset)->load();
+	}
+
+	template <typename T>
+	void atomicStore(size_t offset, T value)
+	{
+		getAtomic<T>(offset)->store(value);
+	}
+
+	// Returns the value from before the addition.
+	template <typename T>
+	T atomicAdd(size_t offset, T value)
+	{
+		std::atomic<T> *a = getAtomic<T>(offset);
+		T old = a->load();
+		while (!a->compare_exchange_weak(old, old + value));
+		return old;
+	}
+
+	// Sets expected to the previous value.
+	template <typename T>
+	bool atomicCompareExchange(size_t offset, T &expected, T desired)
+	{
+		return getAtomic<T>(offset)->compare_exchange_strong(expected, desired);
+	}
+
+	STRINGMAP_CLASS_DECLARE(AtomicType);
+
+private:
+
+	template <typename T>
+	std::atomic<T> *getAtomic(size_t offset) const
+	{
+		static_assert(sizeof(std::atomic<T>) == sizeof(T), "Atomic values must have the same layout as plain values.");
+
+		if (offset % sizeof(T) != 0)
+			throw love::Exception("Offset %d is not a multiple of the value size (%d bytes).", (int) offset, (int) sizeof(T));
+
+		if (offset >= size || size - offset < sizeof(T))
+			throw love::Exception("Offset %d is out of range for a SharedBuffer of %d bytes.", (int) offset, (int) size);
+
+		return reinterpret_cast<std::atomic<T> *>(data + offset);
+	}
+
+	void create();
+
+	char *data;
+	size_t size;
+
+}; // SharedBuffer
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_SHARED_BUFFER_H
@@ -19,12 +19,23 @@
  **/
 
 #include "ThreadModule.h"
+#include "LuaJob.h"
 
 namespace love
 {
 namespace thread
 {
 
+ThreadModule::ThreadModule()
+{
+	JobSystem::getInstance()->startWorkers();
+}
+
+ThreadModule::~ThreadModule()
+{
+	JobSystem::getInstance()->stopWorkers();
+}
+
 LuaThread *ThreadModule::newThread(const std::string &name, love::Data *data)
 {
 	return new LuaThread(name, data);
@@ -35,6 +46,11 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+Channel *ThreadModule::newChannel(size_t messageSize, size_t capacity, bool lockFree)
+{
+	return new Channel(messageSize, capacity, lockFree);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	Lock lock(namedChannelMutex);
@@ -48,6 +64,21 @@ Channel *ThreadModule::getChannel(const std::string &name)
 	return c;
 }
 
+SharedBuffer *ThreadModule::newSharedBuffer(size_t size)
+{
+	return new SharedBuffer(size);
+}
+
+Future *ThreadModule::runJob(const std::string &name, love::Data *code, const std::vector<Variant> &args)
+{
+	return runLuaJob(name, code, args);
+}
+
+int ThreadModule::getJobWorkerCount() const
+{
+	return JobSystem::getInstance()->getWorkerCount();
+}
+
 const char *ThreadModule::getName() const
 {
 	return "love.thread.sdl";
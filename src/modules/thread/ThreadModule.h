@@ -24,6 +24,7 @@
 // STL
 #include <string>
 #include <map>
+#include <vector>
 
 // LOVE
 #include "common/Data.h"
@@ -32,7 +33,9 @@
 
 #include "Thread.h"
 #include "Channel.h"
+#include "Future.h"
 #include "LuaThread.h"
+#include "SharedBuffer.h"
 #include "threads.h"
 
 namespace love
@@ -43,10 +46,19 @@ class ThreadModule : public love::Module
 {
 public:
 
-	virtual ~ThreadModule() {}
+	ThreadModule();
+	virtual ~ThreadModule();
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual Channel *newChannel(size_t messageSize, size_t capacity, bool lockFree);
 	virtual Channel *getChannel(const std::string &name);
+	virtual SharedBuffer *newSharedBuffer(size_t size);
+
+	/**
+	 * Runs Lua code on the shared job system. See runLuaJob.
+	 **/
+	virtual Future *runJob(const std::string &name, love::Data *code, const std::vector<Variant> &args);
+	virtual int getJobWorkerCount() const;
 
 	// Implements Module.
 	virtual const char *getName() const;
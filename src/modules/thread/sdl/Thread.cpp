@@ -20,6 +20,15 @@
 
 #include "Thread.h"
 
+#if defined(LOVE_WINDOWS)
+#include <windows.h>
+#elif defined(LOVE_MACOS) || defined(LOVE_IOS)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
 namespace love
 {
 namespace thread
@@ -77,11 +86,63 @@ bool Thread::isRunning()
 	return running;
 }
 
+// Must be called from the thread the settings apply to.
+static void applySettings(const Threadable *t)
+{
+	Threadable::Priority priority = t->getPriority();
+
+	if (priority != Threadable::PRIORITY_NORMAL)
+	{
+		SDL_ThreadPriority sdlpriority = SDL_THREAD_PRIORITY_NORMAL;
+		if (priority == Threadable::PRIORITY_LOW)
+			sdlpriority = SDL_THREAD_PRIORITY_LOW;
+		else if (priority == Threadable::PRIORITY_HIGH)
+			sdlpriority = SDL_THREAD_PRIORITY_HIGH;
+		else if (priority == Threadable::PRIORITY_TIME_CRITICAL)
+			sdlpriority = SDL_THREAD_PRIORITY_TIME_CRITICAL;
+
+		SDL_SetThreadPriority(sdlpriority);
+
+#if defined(LOVE_MACOS) || defined(LOVE_IOS)
+		// The QoS class also decides which cores the thread is scheduled on.
+		qos_class_t qos = QOS_CLASS_UTILITY;
+		if (priority == Threadable::PRIORITY_HIGH)
+			qos = QOS_CLASS_USER_INITIATED;
+		else if (priority == Threadable::PRIORITY_TIME_CRITICAL)
+			qos = QOS_CLASS_USER_INTERACTIVE;
+
+		pthread_set_qos_class_self_np(qos, 0);
+#endif
+	}
+
+	uint64 mask = t->getAffinityMask();
+
+	if (mask != 0)
+	{
+#if defined(LOVE_WINDOWS)
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) mask);
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int i = 0; i < 64 && i < CPU_SETSIZE; i++)
+		{
+			if (mask & (1ULL << i))
+				CPU_SET(i, &set);
+		}
+
+		// 0 is the calling thread.
+		sched_setaffinity(0, sizeof(set), &set);
+#endif
+	}
+}
+
 int Thread::thread_runner(void *data)
 {
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 	self->t->retain();
 
+	applySettings(self->t);
+
 	self->t->threadFunction();
 
 	{
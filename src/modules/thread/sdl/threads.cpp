@@ -28,24 +28,44 @@ namespace thread
 namespace sdl
 {
 
+#ifdef LOVE_ENABLE_TRACY
+static constexpr tracy::SourceLocationData mutexSourceLocation { "love::thread::Mutex", "Mutex", __FILE__, __LINE__, 0 };
+#endif
+
 Mutex::Mutex()
 {
 	mutex = SDL_CreateMutex();
+#ifdef LOVE_ENABLE_TRACY
+	lockContext = new tracy::LockableCtx(&mutexSourceLocation);
+#endif
 }
 
 Mutex::~Mutex()
 {
+#ifdef LOVE_ENABLE_TRACY
+	delete lockContext;
+#endif
 	SDL_DestroyMutex(mutex);
 }
 
 void Mutex::lock()
 {
+#ifdef LOVE_ENABLE_TRACY
+	bool run = lockContext->BeforeLock();
+	SDL_LockMutex(mutex);
+	if (run)
+		lockContext->AfterLock();
+#else
 	SDL_LockMutex(mutex);
+#endif
 }
 
 void Mutex::unlock()
 {
 	SDL_UnlockMutex(mutex);
+#ifdef LOVE_ENABLE_TRACY
+	lockContext->AfterUnlock();
+#endif
 }
 
 Conditional::Conditional()
@@ -74,10 +94,26 @@ bool Conditional::wait(thread::Mutex *_mutex, int timeout)
 	// however, you're asking for it if you're
 	// mixing thread implementations.
 	Mutex *mutex = (Mutex *) _mutex;
+
+#ifdef LOVE_ENABLE_TRACY
+	// The wait releases the mutex and takes it again before returning. Time
+	// spent waiting for the signal isn't lock contention, so the lock is only
+	// reported as taken again once the wait is over.
+	mutex->lockContext->AfterUnlock();
+#endif
+
+	bool signaled;
 	if (timeout < 0)
-		return !SDL_CondWait(cond, mutex->mutex);
+		signaled = !SDL_CondWait(cond, mutex->mutex);
 	else
-		return (SDL_CondWaitTimeout(cond, mutex->mutex, timeout) == 0);
+		signaled = (SDL_CondWaitTimeout(cond, mutex->mutex, timeout) == 0);
+
+#ifdef LOVE_ENABLE_TRACY
+	if (mutex->lockContext->BeforeLock())
+		mutex->lockContext->AfterLock();
+#endif
+
+	return signaled;
 }
 
 } // sdl
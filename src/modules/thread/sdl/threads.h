@@ -26,6 +26,10 @@
 
 #include <SDL_thread.h>
 
+#ifdef LOVE_ENABLE_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
 namespace love
 {
 namespace thread
@@ -50,6 +54,11 @@ private:
 	SDL_mutex *mutex;
 	Mutex(const Mutex&/* mutex*/) {}
 
+#ifdef LOVE_ENABLE_TRACY
+	// Reports waits for and ownership of the lock to Tracy.
+	tracy::LockableCtx *lockContext;
+#endif
+
 	friend class Conditional;
 
 }; // Mutex
@@ -24,6 +24,14 @@
 #include <signal.h>
 #endif
 
+// BSDs also define LOVE_LINUX, but have no sysfs.
+#if defined(__linux__)
+#include <algorithm>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
 namespace love
 {
 namespace thread
@@ -88,6 +96,8 @@ void EmptyLock::setLock(Mutex &m)
 love::Type Threadable::type("Threadable", &Object::type);
 
 Threadable::Threadable()
+	: priority(PRIORITY_NORMAL)
+	, affinityMask(0)
 {
 	owner = newThread(this);
 }
@@ -117,6 +127,40 @@ const char *Threadable::getThreadName() const
 	return threadName.empty() ? nullptr : threadName.c_str();
 }
 
+void Threadable::setThreadName(const std::string &name)
+{
+	threadName = name;
+}
+
+void Threadable::setPriority(Priority priority)
+{
+	this->priority = priority;
+}
+
+Threadable::Priority Threadable::getPriority() const
+{
+	return priority;
+}
+
+void Threadable::setAffinityMask(uint64 mask)
+{
+	affinityMask = mask;
+}
+
+uint64 Threadable::getAffinityMask() const
+{
+	return affinityMask;
+}
+
+STRINGMAP_CLASS_BEGIN(Threadable, Threadable::Priority, Threadable::PRIORITY_MAX_ENUM, priority)
+{
+	{ "low",          Threadable::PRIORITY_LOW           },
+	{ "normal",       Threadable::PRIORITY_NORMAL        },
+	{ "high",         Threadable::PRIORITY_HIGH          },
+	{ "timecritical", Threadable::PRIORITY_TIME_CRITICAL },
+}
+STRINGMAP_CLASS_END(Threadable, Threadable::Priority, Threadable::PRIORITY_MAX_ENUM, priority)
+
 MutexRef::MutexRef()
 	: mutex(newMutex())
 {
@@ -157,6 +201,62 @@ Conditional *ConditionalRef::operator->() const
 	return conditional;
 }
 
+uint64 getCoreMask(CoreType type)
+{
+#if defined(__linux__)
+	// Cores are told apart by their maximum frequency: on big.LITTLE style
+	// CPUs the performance cores are the ones which clock highest.
+	long corecount = sysconf(_SC_NPROCESSORS_CONF);
+	if (corecount <= 1)
+		return 0;
+
+	corecount = std::min(corecount, 64L);
+
+	std::vector<long> frequencies((size_t) corecount, 0);
+	long highest = 0;
+
+	for (long i = 0; i < corecount; i++)
+	{
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cpufreq/cpuinfo_max_freq", i);
+
+		FILE *file = fopen(path, "r");
+		if (file == nullptr)
+			return 0;
+
+		if (fscanf(file, "%ld", &frequencies[i]) != 1)
+			frequencies[i] = 0;
+
+		fclose(file);
+		highest = std::max(highest, frequencies[i]);
+	}
+
+	uint64 mask = 0;
+	for (long i = 0; i < corecount; i++)
+	{
+		bool fast = frequencies[i] == highest;
+		if (fast == (type == CORE_PERFORMANCE))
+			mask |= 1ULL << i;
+	}
+
+	// Every core is the same, or no core matched.
+	if (mask == 0 || mask == (corecount == 64 ? ~0ULL : (1ULL << corecount) - 1))
+		return 0;
+
+	return mask;
+#else
+	LOVE_UNUSED(type);
+	return 0;
+#endif
+}
+
+STRINGMAP_BEGIN(CoreType, CORE_MAX_ENUM, coreType)
+{
+	{ "performance", CORE_PERFORMANCE },
+	{ "efficiency",  CORE_EFFICIENCY  },
+}
+STRINGMAP_END(CoreType, CORE_MAX_ENUM, coreType)
+
 #if defined(LOVE_LINUX)
 static sigset_t oldset;
 
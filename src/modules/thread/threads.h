@@ -23,6 +23,8 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/int.h"
+#include "common/StringMap.h"
 #include "Thread.h"
 
 // C++
@@ -82,6 +84,15 @@ class Threadable : public love::Object
 public:
 	static love::Type type;
 
+	enum Priority
+	{
+		PRIORITY_LOW,
+		PRIORITY_NORMAL,
+		PRIORITY_HIGH,
+		PRIORITY_TIME_CRITICAL,
+		PRIORITY_MAX_ENUM
+	};
+
 	Threadable();
 	virtual ~Threadable();
 
@@ -92,10 +103,27 @@ public:
 	bool isRunning() const;
 	const char *getThreadName() const;
 
+	/**
+	 * Scheduling settings, applied by the thread itself when it starts. The
+	 * OS may refuse them (e.g. raised priorities without permission), in
+	 * which case the thread runs with its defaults.
+	 **/
+	void setThreadName(const std::string &name);
+	void setPriority(Priority priority);
+	Priority getPriority() const;
+
+	// Bit i allows the thread to run on core i. 0 allows every core.
+	void setAffinityMask(uint64 mask);
+	uint64 getAffinityMask() const;
+
+	STRINGMAP_CLASS_DECLARE(Priority);
+
 protected:
 
 	Thread *owner;
 	std::string threadName;
+	Priority priority;
+	uint64 affinityMask;
 
 };
 
@@ -125,10 +153,25 @@ private:
 	Conditional *conditional;
 };
 
+enum CoreType
+{
+	CORE_PERFORMANCE,
+	CORE_EFFICIENCY,
+	CORE_MAX_ENUM
+};
+
 Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * Gets an affinity mask of the cores of one type, on CPUs which mix fast and
+ * slow cores. Returns 0 (no restriction) when the cores can't be told apart.
+ **/
+uint64 getCoreMask(CoreType type);
+
+STRINGMAP_DECLARE(CoreType);
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -33,16 +33,72 @@ Channel *luax_checkchannel(lua_State *L, int idx)
 int w_Channel_push(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
+	bool transfer = luax_optboolean(L, 3, false);
+
+	if (transfer && lua_type(L, 2) != LUA_TUSERDATA)
+		return luaL_argerror(L, 2, "love type expected when transferring ownership");
+
+	uint64 id = 0;
 	luax_catchexcept(L, [&]() {
 		Variant var = luax_checkvariant(L, 2);
 		if (var.getType() == Variant::UNKNOWN)
 			luaL_argerror(L, 2, "boolean, number, string, love type, or table expected");
-		uint64 id = c->push(var);
-		lua_pushnumber(L, (lua_Number) id);
+		id = c->push(std::move(var));
 	});
+
+	if (id == 0)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	// The channel now holds its own reference to the object. Releasing the
+	// pushing thread's reference means only the receiver can use it, so the
+	// data can't be changed while the receiver is reading it.
+	if (transfer)
+	{
+		lua_getfield(L, 2, "release");
+		lua_pushvalue(L, 2);
+		lua_call(L, 1, 0);
+	}
+
+	lua_pushnumber(L, (lua_Number) id);
 	return 1;
 }
 
+int w_Channel_pushMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 2);
+
+	// Convert everything before touching the channel, so it's only locked
+	// once.
+	std::vector<Variant> vars;
+	vars.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		luax_catchexcept(L, [&]() { vars.push_back(luax_checkvariant(L, -1)); });
+		if (vars.back().getType() == Variant::UNKNOWN)
+			return luaL_error(L, "Expected a boolean, number, string, love type, or table at index %d.", i);
+		lua_pop(L, 1);
+	}
+
+	size_t pushed = 0;
+	uint64 id = 0;
+	luax_catchexcept(L, [&]() { id = c->pushMany(vars, pushed); });
+
+	lua_pushnumber(L, (lua_Number) pushed);
+	if (pushed > 0)
+		lua_pushnumber(L, (lua_Number) id);
+	else
+		lua_pushnil(L);
+	return 2;
+}
+
 int w_Channel_supply(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -72,6 +128,31 @@ int w_Channel_pop(lua_State *L)
 	return 1;
 }
 
+int w_Channel_popMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	size_t max = SIZE_MAX;
+	if (!lua_isnoneornil(L, 2))
+	{
+		lua_Integer n = luaL_checkinteger(L, 2);
+		if (n < 0)
+			return luaL_argerror(L, 2, "maximum count must not be negative");
+		max = (size_t) n;
+	}
+
+	std::vector<Variant> vars;
+	size_t count = c->popMany(vars, max);
+
+	lua_createtable(L, (int) count, 0);
+	for (size_t i = 0; i < count; i++)
+	{
+		luax_pushvariant(L, vars[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
 int w_Channel_demand(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -94,7 +175,9 @@ int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	Variant var;
-	if (c->peek(&var))
+	bool result = false;
+	luax_catchexcept(L, [&]() { result = c->peek(&var); });
+	if (result)
 		luax_pushvariant(L, var);
 	else
 		lua_pushnil(L);
@@ -123,6 +206,35 @@ int w_Channel_clear(lua_State *L)
 	return 0;
 }
 
+int w_Channel_getMessageSize(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	size_t size = c->getMessageSize();
+	if (size > 0)
+		lua_pushnumber(L, (lua_Number) size);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_Channel_getCapacity(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	size_t capacity = c->getCapacity();
+	if (capacity > 0)
+		lua_pushnumber(L, (lua_Number) capacity);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_Channel_isLockFree(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luax_pushboolean(L, c->isLockFree());
+	return 1;
+}
+
 int w_Channel_performAtomic(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -153,13 +265,18 @@ int w_Channel_performAtomic(lua_State *L)
 static const luaL_Reg w_Channel_functions[] =
 {
 	{ "push", w_Channel_push },
+	{ "pushMany", w_Channel_pushMany },
 	{ "supply", w_Channel_supply },
 	{ "pop", w_Channel_pop },
+	{ "popMany", w_Channel_popMany },
 	{ "demand", w_Channel_demand },
 	{ "peek", w_Channel_peek },
 	{ "getCount", w_Channel_getCount },
 	{ "hasRead", w_Channel_hasRead },
 	{ "clear", w_Channel_clear },
+	{ "getMessageSize", w_Channel_getMessageSize },
+	{ "getCapacity", w_Channel_getCapacity },
+	{ "isLockFree", w_Channel_isLockFree },
 	{ "performAtomic", w_Channel_performAtomic },
 	{ 0, 0 }
 };
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Future.h"
+
+namespace love
+{
+namespace thread
+{
+
+Future *luax_checkfuture(lua_State *L, int idx)
+{
+	return luax_checktype<Future>(L, idx);
+}
+
+int w_Future_isDone(lua_State *L)
+{
+	Future *f = luax_checkfuture(L, 1);
+	luax_pushboolean(L, f->isDone());
+	return 1;
+}
+
+int w_Future_wait(lua_State *L)
+{
+	Future *f = luax_checkfuture(L, 1);
+	double timeout = luaL_optnumber(L, 2, -1.0);
+	bool done = false;
+	luax_catchexcept(L, [&](){ done = f->wait(timeout); });
+	luax_pushboolean(L, done);
+	return 1;
+}
+
+int w_Future_getResults(lua_State *L)
+{
+	Future *f = luax_checkfuture(L, 1);
+
+	if (!f->isDone())
+		return luaL_error(L, "The job has not finished yet.");
+
+	if (f->hasError())
+		return luaL_error(L, "%s", f->getError().c_str());
+
+	const std::vector<Variant> &results = f->getResults();
+	if (!lua_checkstack(L, (int) results.size()))
+		return luaL_error(L, "Too many return values");
+
+	for (const Variant &v : results)
+		luax_pushvariant(L, v);
+
+	return (int) results.size();
+}
+
+int w_Future_getError(lua_State *L)
+{
+	Future *f = luax_checkfuture(L, 1);
+	if (f->isDone() && f->hasError())
+		luax_pushstring(L, f->getError());
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+static const luaL_Reg w_Future_functions[] =
+{
+	{ "isDone", w_Future_isDone },
+	{ "wait", w_Future_wait },
+	{ "getResults", w_Future_getResults },
+	{ "getError", w_Future_getError },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_future(lua_State *L)
+{
+	return luax_register_type(L, &Future::type, w_Future_functions, nullptr);
+}
+
+} // thread
+} // love
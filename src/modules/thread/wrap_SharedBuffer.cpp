@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_SharedBuffer.h"
+
+#include "data/wrap_Data.h"
+
+namespace love
+{
+namespace thread
+{
+
+SharedBuffer *luax_checksharedbuffer(lua_State *L, int idx)
+{
+	return luax_checktype<SharedBuffer>(L, idx);
+}
+
+static SharedBuffer::AtomicType luax_checkatomictype(lua_State *L, int idx)
+{
+	const char *str = luaL_checkstring(L, idx);
+	SharedBuffer::AtomicType type = SharedBuffer::ATOMIC_MAX_ENUM;
+	if (!SharedBuffer::getConstant(str, type))
+		luax_enumerror(L, "atomic value type", SharedBuffer::getConstants(type), str);
+	return type;
+}
+
+int w_SharedBuffer_clone(lua_State *L)
+{
+	SharedBuffer *t = luax_checksharedbuffer(L, 1);
+	SharedBuffer *c = nullptr;
+	luax_catchexcept(L, [&](){ c = t->clone(); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SharedBuffer_atomicLoad(lua_State *L)
+{
+	SharedBuffer *t = luax_checksharedbuffer(L, 1);
+	SharedBuffer::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = (size_t) luaL_checkinteger(L, 3);
+
+	luax_catchexcept(L, [&]() {
+		switch (type)
+		{
+		case SharedBuffer::ATOMIC_INT32:
+			lua_pushinteger(L, t->atomicLoad<int32>(offset));
+			break;
+		case SharedBuffer::ATOMIC_INT64:
+			lua_pushinteger(L, (lua_Integer) t->atomicLoad<int64>(offset));
+			break;
+		case SharedBuffer::ATOMIC_FLOAT:
+		default:
+			lua_pushnumber(L, t->atomicLoad<float>(offset));
+			break;
+		}
+	});
+
+	return 1;
+}
+
+int w_SharedBuffer_atomicStore(lua_State *L)
+{
+	SharedBuffer *t = luax_checksharedbuffer(L, 1);
+	SharedBuffer::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = (size_t) luaL_checkinteger(L, 3);
+
+	if (type == SharedBuffer::ATOMIC_FLOAT)
+	{
+		float value = (float) luaL_checknumber(L, 4);
+		luax_catchexcept(L, [&]() { t->atomicStore<float>(offset, value); });
+	}
+	else
+	{
+		int64 value = (int64) luaL_checkinteger(L, 4);
+		luax_catchexcept(L, [&]() {
+			if (type == SharedBuffer::ATOMIC_INT32)
+				t->atomicStore<int32>(offset, (int32) value);
+			else
+				t->atomicStore<int64>(offset, value);
+		});
+	}
+
+	return 0;
+}
+
+int w_SharedBuffer_atomicAdd(lua_State *L)
+{
+	SharedBuffer *t = luax_checksharedbuffer(L, 1);
+	SharedBuffer::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = (size_t) luaL_checkinteger(L, 3);
+
+	if (type == SharedBuffer::ATOMIC_FLOAT)
+	{
+		float value = (float) luaL_checknumber(L, 4);
+		float old = 0.0f;
+		luax_catchexcept(L, [&]() { old = t->atomicAdd<float>(offset, value); });
+		lua_pushnumber(L, old);
+	}
+	else
+	{
+		int64 value = (int64) luaL_checkinteger(L, 4);
+		int64 old = 0;
+		luax_catchexcept(L, [&]() {
+			if (type == SharedBuffer::ATOMIC_INT32)
+				old = t->atomicAdd<int32>(offset, (int32) value);
+			else
+				old = t->atomicAdd<int64>(offset, value);
+		});
+		lua_pushinteger(L, (lua_Integer) old);
+	}
+
+	return 1;
+}
+
+int w_SharedBuffer_atomicCompareExchange(lua_State *L)
+{
+	SharedBuffer *t = luax_checksharedbuffer(L, 1);
+	SharedBuffer::AtomicType type = luax_checkatomictype(L, 2);
+	size_t offset = (size_t) luaL_checkinteger(L, 3);
+	bool success = false;
+
+	if (type == SharedBuffer::ATOMIC_FLOAT)
+	{
+		float expected = (float) luaL_checknumber(L, 4);
+		float desired = (float) luaL_checknumber(L, 5);
+		luax_catchexcept(L, [&]() { success = t->atomicCompareExchange<float>(offset, expected, desired); });
+		luax_pushboolean(L, success);
+		lua_pushnumber(L, expected);
+	}
+	else if (type == SharedBuffer::ATOMIC_INT32)
+	{
+		int32 expected = (int32) luaL_checkinteger(L, 4);
+		int32 desired = (int32) luaL_checkinteger(L, 5);
+		luax_catchexcept(L, [&]() { success = t->atomicCompareExchange<int32>(offset, expected, desired); });
+		luax_pushboolean(L, success);
+		lua_pushinteger(L, expected);
+	}
+	else
+	{
+		int64 expected = (int64) luaL_checkinteger(L, 4);
+		int64 desired = (int64) luaL_checkinteger(L, 5);
+		luax_catchexcept(L, [&]() { success = t->atomicCompareExchange<int64>(offset, expected, desired); });
+		luax_pushboolean(L, success);
+		lua_pushinteger(L, (lua_Integer) expected);
+	}
+
+	return 2;
+}
+
+static const luaL_Reg w_SharedBuffer_functions[] =
+{
+	{ "clone", w_SharedBuffer_clone },
+	{ "atomicLoad", w_SharedBuffer_atomicLoad },
+	{ "atomicStore", w_SharedBuffer_atomicStore },
+	{ "atomicAdd", w_SharedBuffer_atomicAdd },
+	{ "atomicCompareExchange", w_SharedBuffer_atomicCompareExchange },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_sharedbuffer(lua_State *L)
+{
+	int ret = luax_register_type(L, &SharedBuffer::type, data::w_Data_functions, w_SharedBuffer_functions, nullptr);
+	love::data::luax_rundatawrapper(L, SharedBuffer::type);
+	return ret;
+}
+
+} // thread
+} // love
@@ -22,6 +22,8 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_Future.h"
+#include "wrap_SharedBuffer.h"
 #include "ThreadModule.h"
 
 #include "filesystem/File.h"
@@ -37,45 +39,110 @@ namespace thread
 
 #define instance() (Module::getInstance<ThreadModule>(Module::M_THREAD))
 
-int w_newThread(lua_State *L)
+// Converts the Lua code argument of newThread and runJob (a filename, a
+// string of code, a File, or a Data) into a Data and chunk name.
+static love::Data *checkCode(lua_State *L, int idx, std::string &name)
 {
-	std::string name = "Thread code";
 	love::Data *data = nullptr;
 
-	if (lua_isstring(L, 1))
+	if (lua_isstring(L, idx))
 	{
 		size_t slen = 0;
-		const char *str = lua_tolstring(L, 1, &slen);
+		const char *str = lua_tolstring(L, idx, &slen);
 
 		// Treat the string as Lua code if it's long or has a newline.
 		if (slen >= 1024 || memchr(str, '\n', slen))
 		{
 			// Construct a FileData from the string.
-			lua_pushvalue(L, 1);
+			lua_pushvalue(L, idx);
 			lua_pushstring(L, "string");
 			int idxs[] = {lua_gettop(L) - 1, lua_gettop(L)};
 			luax_convobj(L, idxs, 2, "filesystem", "newFileData");
 			lua_pop(L, 1);
-			lua_replace(L, 1);
+			lua_replace(L, idx);
 		}
 		else
-			luax_convobj(L, 1, "filesystem", "newFileData");
+			luax_convobj(L, idx, "filesystem", "newFileData");
 	}
-	else if (luax_istype(L, 1, love::filesystem::File::type))
-		luax_convobj(L, 1, "filesystem", "newFileData");
+	else if (luax_istype(L, idx, love::filesystem::File::type))
+		luax_convobj(L, idx, "filesystem", "newFileData");
 
-	if (luax_istype(L, 1, love::filesystem::FileData::type))
+	if (luax_istype(L, idx, love::filesystem::FileData::type))
 	{
-		love::filesystem::FileData *fdata = luax_checktype<love::filesystem::FileData>(L, 1);
+		love::filesystem::FileData *fdata = luax_checktype<love::filesystem::FileData>(L, idx);
 		name = std::string("@") + fdata->getFilename();
 		data = fdata;
 	}
 	else
 	{
-		data = luax_checktype<love::Data>(L, 1);
+		data = luax_checktype<love::Data>(L, idx);
+	}
+
+	return data;
+}
+
+int w_newThread(lua_State *L)
+{
+	std::string name = "Thread code";
+	love::Data *data = checkCode(L, 1, name);
+
+	std::string threadname = name;
+	Threadable::Priority priority = Threadable::PRIORITY_NORMAL;
+	uint64 affinitymask = 0;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_getfield(L, 2, "name");
+		if (!lua_isnoneornil(L, -1))
+			threadname = luax_checkstring(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "priority");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!Threadable::getConstant(str, priority))
+				return luax_enumerror(L, "thread priority", Threadable::getConstants(priority), str);
+		}
+		lua_pop(L, 1);
+
+		// Either a core type, or a list of 0-based core numbers.
+		lua_getfield(L, 2, "affinity");
+		if (lua_type(L, -1) == LUA_TSTRING)
+		{
+			const char *str = lua_tostring(L, -1);
+			CoreType coretype = CORE_MAX_ENUM;
+			if (!getConstant(str, coretype))
+				return luax_enumerror(L, "core type", getConstants(coretype), str);
+			affinitymask = getCoreMask(coretype);
+		}
+		else if (lua_istable(L, -1))
+		{
+			int count = (int) luax_objlen(L, -1);
+			for (int i = 1; i <= count; i++)
+			{
+				lua_rawgeti(L, -1, i);
+				lua_Integer core = luaL_checkinteger(L, -1);
+				lua_pop(L, 1);
+
+				if (core < 0 || core >= 64)
+					return luaL_error(L, "Invalid core number: %d", (int) core);
+
+				affinitymask |= 1ULL << core;
+			}
+		}
+		else if (!lua_isnoneornil(L, -1))
+			return luaL_error(L, "Thread affinity must be a core type or a table of core numbers.");
+		lua_pop(L, 1);
 	}
 
 	LuaThread *t = instance()->newThread(name, data);
+	t->setThreadName(threadname);
+	t->setPriority(priority);
+	t->setAffinityMask(affinitymask);
+
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
@@ -83,7 +150,27 @@ int w_newThread(lua_State *L)
 
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	Channel *c = nullptr;
+
+	if (lua_istable(L, 1))
+	{
+		lua_getfield(L, 1, "messagesize");
+		size_t messagesize = (size_t) luaL_optinteger(L, -1, 0);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 1, "capacity");
+		size_t capacity = (size_t) luaL_checkinteger(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 1, "lockfree");
+		bool lockfree = luax_optboolean(L, -1, false);
+		lua_pop(L, 1);
+
+		luax_catchexcept(L, [&]() { c = instance()->newChannel(messagesize, capacity, lockfree); });
+	}
+	else
+		c = instance()->newChannel();
+
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
@@ -97,18 +184,69 @@ int w_getChannel(lua_State *L)
 	return 1;
 }
 
+int w_newSharedBuffer(lua_State *L)
+{
+	lua_Integer size = luaL_checkinteger(L, 1);
+	if (size <= 0)
+		return luaL_error(L, "Invalid SharedBuffer size: %d", (int) size);
+
+	SharedBuffer *b = nullptr;
+	luax_catchexcept(L, [&]() { b = instance()->newSharedBuffer((size_t) size); });
+	luax_pushtype(L, b);
+	b->release();
+	return 1;
+}
+
+int w_runJob(lua_State *L)
+{
+	std::string name = "Job code";
+	love::Data *data = checkCode(L, 1, name);
+
+	std::vector<Variant> args;
+	int nargs = lua_gettop(L) - 1;
+
+	for (int i = 0; i < nargs; ++i)
+	{
+		luax_catchexcept(L, [&]() {
+			args.push_back(luax_checkvariant(L, i+2));
+		});
+
+		if (args.back().getType() == Variant::UNKNOWN)
+		{
+			args.clear();
+			return luaL_argerror(L, i+2, "boolean, number, string, love type, or flat table expected");
+		}
+	}
+
+	Future *f = instance()->runJob(name, data, args);
+	luax_pushtype(L, f);
+	f->release();
+	return 1;
+}
+
+int w_getJobWorkerCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getJobWorkerCount());
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg module_functions[] =
 {
 	{ "newThread", w_newThread },
 	{ "newChannel", w_newChannel },
 	{ "getChannel", w_getChannel },
+	{ "newSharedBuffer", w_newSharedBuffer },
+	{ "runJob", w_runJob },
+	{ "getJobWorkerCount", w_getJobWorkerCount },
 	{ 0, 0 }
 };
 
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_future,
+	luaopen_sharedbuffer,
 	0
 };
 
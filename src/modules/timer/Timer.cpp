@@ -23,19 +23,28 @@
 #include "common/int.h"
 #include "common/delay.h"
 #include "Timer.h"
+#include "event/Event.h"
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #if defined(LOVE_WINDOWS)
 #include <windows.h>
 #elif defined(LOVE_MACOS) || defined(LOVE_IOS)
 #include <mach/mach_time.h>
 #include <sys/time.h>
+#include <time.h>
 #elif defined(LOVE_LINUX)
 #include <unistd.h>
 #include <time.h>
 #include <sys/time.h>
 #endif
 
+#if defined(LOVE_WINDOWS) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 namespace love
 {
 namespace timer
@@ -49,8 +58,37 @@ Timer::Timer()
 	, fpsUpdateFrequency(1)
 	, frames(0)
 	, dt(0)
+	, sleepMargin(0.002)
+	, sleepOvershootMean(0.001)
+	, sleepOvershootVariance(0.0)
+#ifdef LOVE_WINDOWS
+	, waitableTimer(nullptr)
+#endif
+	, targetFrameRate(0.0)
+	, nextFrameTime(0.0)
+	, lastPaceTime(-1.0)
+	, frameSamples(DEFAULT_FRAME_TIME_WINDOW)
+	, frameSampleNext(0)
+	, frameSampleCount(0)
+	, phaseTimes()
+	, currentPhase(PHASE_MAX_ENUM)
+	, phaseStartTime(0.0)
+	, hitchThreshold(0.0)
 {
 	prevFpsUpdate = currTime = getTime();
+
+#ifdef LOVE_WINDOWS
+	// Only available on Windows 10 1803 and newer.
+	waitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+Timer::~Timer()
+{
+#ifdef LOVE_WINDOWS
+	if (waitableTimer != nullptr)
+		CloseHandle((HANDLE) waitableTimer);
+#endif
 }
 
 double Timer::step()
@@ -86,6 +124,234 @@ void Timer::sleep(double seconds) const
 		love::sleep((unsigned int)(seconds*1000));
 }
 
+void Timer::sleepOS(double seconds)
+{
+#if defined(LOVE_WINDOWS)
+	if (waitableTimer != nullptr)
+	{
+		// Relative due times are negative, in 100ns units.
+		LARGE_INTEGER due;
+		due.QuadPart = -(LONGLONG)(seconds * 1.0e7);
+		if (SetWaitableTimer((HANDLE) waitableTimer, &due, 0, nullptr, nullptr, FALSE))
+		{
+			WaitForSingleObject((HANDLE) waitableTimer, INFINITE);
+			return;
+		}
+	}
+
+	unsigned int ms = (unsigned int) (seconds * 1000);
+	if (ms > 0)
+		love::sleep(ms);
+	else
+		std::this_thread::yield();
+#else
+	timespec t;
+	t.tv_sec = (time_t) seconds;
+	t.tv_nsec = (long) ((seconds - (double) t.tv_sec) * 1.0e9);
+	nanosleep(&t, nullptr);
+#endif
+}
+
+void Timer::sleepUntil(double time)
+{
+	double now = getTime();
+
+	while (time - now > sleepMargin)
+	{
+		double requested = time - now - sleepMargin;
+		sleepOS(requested);
+
+		double after = getTime();
+		double overshoot = std::max((after - now) - requested, 0.0);
+		now = after;
+
+		// Exponentially weighted, so the margin adapts when the system's
+		// timer behavior changes (e.g. power saving modes).
+		const double weight = 0.05;
+		double diff = overshoot - sleepOvershootMean;
+		sleepOvershootMean += weight * diff;
+		sleepOvershootVariance = (1.0 - weight) * (sleepOvershootVariance + weight * diff * diff);
+
+		sleepMargin = std::min(sleepOvershootMean + 2.0 * sqrt(sleepOvershootVariance), 0.004);
+	}
+
+	while (now < time)
+	{
+		std::this_thread::yield();
+		now = getTime();
+	}
+}
+
+void Timer::setTargetFrameRate(double fps)
+{
+	targetFrameRate = std::max(fps, 0.0);
+	nextFrameTime = 0.0;
+}
+
+double Timer::getTargetFrameRate() const
+{
+	return targetFrameRate;
+}
+
+void Timer::pace()
+{
+	double now = getTime();
+
+	endPhase(now);
+
+	if (lastPaceTime >= 0.0)
+		recordFrame(now - lastPaceTime);
+
+	for (double &t : phaseTimes)
+		t = 0.0;
+
+	lastPaceTime = now;
+
+	if (targetFrameRate <= 0.0)
+	{
+		sleep(0.001);
+		return;
+	}
+
+	double period = 1.0 / targetFrameRate;
+
+	// After a frame more than a whole period late, start a new schedule
+	// instead of rushing the next frames to catch up.
+	if (nextFrameTime < now - period)
+		nextFrameTime = now;
+	else
+		sleepUntil(nextFrameTime);
+
+	nextFrameTime += period;
+}
+
+void Timer::beginPhase(Phase phase)
+{
+	double now = getTime();
+	endPhase(now);
+	currentPhase = phase;
+	phaseStartTime = now;
+}
+
+void Timer::endPhase(double now)
+{
+	if (currentPhase != PHASE_MAX_ENUM)
+		phaseTimes[currentPhase] += now - phaseStartTime;
+	currentPhase = PHASE_MAX_ENUM;
+}
+
+void Timer::recordFrame(double frametime)
+{
+	FrameSample &sample = frameSamples[frameSampleNext];
+	sample.total = frametime;
+	for (int i = 0; i < PHASE_MAX_ENUM; i++)
+		sample.phases[i] = phaseTimes[i];
+
+	frameSampleNext = (frameSampleNext + 1) % frameSamples.size();
+	frameSampleCount = std::min(frameSampleCount + 1, frameSamples.size());
+
+	if (hitchThreshold > 0.0 && frametime > hitchThreshold)
+	{
+		auto eventModule = Module::getInstance<event::Event>(Module::M_EVENT);
+		if (eventModule)
+		{
+			std::vector<Variant> vargs;
+			vargs.emplace_back(frametime);
+			for (int i = 0; i < PHASE_MAX_ENUM; i++)
+				vargs.emplace_back(phaseTimes[i]);
+
+			StrongRef<event::Message> msg(new event::Message("hitch", vargs), Acquire::NORETAIN);
+			eventModule->push(msg);
+		}
+	}
+}
+
+double Timer::getFrameTimePercentile(double percentile)
+{
+	if (frameSampleCount == 0)
+		return 0.0;
+
+	sortedFrameTimes.resize(frameSampleCount);
+	for (size_t i = 0; i < frameSampleCount; i++)
+		sortedFrameTimes[i] = frameSamples[i].total;
+
+	double p = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+	size_t index = (size_t) (p * (frameSampleCount - 1) + 0.5);
+
+	std::nth_element(sortedFrameTimes.begin(), sortedFrameTimes.begin() + index, sortedFrameTimes.end());
+	return sortedFrameTimes[index];
+}
+
+void Timer::setFrameTimeWindow(size_t frames)
+{
+	frameSamples.assign(std::max(frames, (size_t) 1), FrameSample());
+	frameSampleNext = 0;
+	frameSampleCount = 0;
+}
+
+size_t Timer::getFrameTimeWindow() const
+{
+	return frameSamples.size();
+}
+
+Timer::FrameTimeStats Timer::getFrameTimeStats(Phase phase)
+{
+	FrameTimeStats stats;
+	stats.count = frameSampleCount;
+
+	if (frameSampleCount == 0)
+		return stats;
+
+	sortedFrameTimes.resize(frameSampleCount);
+	for (size_t i = 0; i < frameSampleCount; i++)
+	{
+		const FrameSample &sample = frameSamples[i];
+		sortedFrameTimes[i] = phase == PHASE_MAX_ENUM ? sample.total : sample.phases[phase];
+	}
+
+	std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+	auto percentile = [&](double p) -> double
+	{
+		return sortedFrameTimes[(size_t) (p * (frameSampleCount - 1) + 0.5)];
+	};
+
+	double sum = 0.0;
+	for (double t : sortedFrameTimes)
+		sum += t;
+
+	stats.p50 = percentile(0.50);
+	stats.p95 = percentile(0.95);
+	stats.p99 = percentile(0.99);
+	stats.max = sortedFrameTimes.back();
+	stats.mean = sum / frameSampleCount;
+
+	return stats;
+}
+
+void Timer::getFrameTimeHistogram(double binwidth, int bins, std::vector<int> &counts) const
+{
+	counts.assign(std::max(bins, 0), 0);
+	if (bins <= 0 || binwidth <= 0.0)
+		return;
+
+	for (size_t i = 0; i < frameSampleCount; i++)
+	{
+		double bin = frameSamples[i].total / binwidth;
+		counts[bin < (double) bins ? (int) bin : bins - 1]++;
+	}
+}
+
+void Timer::setHitchThreshold(double seconds)
+{
+	hitchThreshold = std::max(seconds, 0.0);
+}
+
+double Timer::getHitchThreshold() const
+{
+	return hitchThreshold;
+}
+
 double Timer::getDelta() const
 {
 	return dt;
@@ -187,5 +453,14 @@ double Timer::getTime()
 
 #endif
 
+STRINGMAP_CLASS_BEGIN(Timer, Timer::Phase, Timer::PHASE_MAX_ENUM, phase)
+{
+	{ "events",  Timer::PHASE_EVENTS  },
+	{ "update",  Timer::PHASE_UPDATE  },
+	{ "draw",    Timer::PHASE_DRAW    },
+	{ "present", Timer::PHASE_PRESENT },
+}
+STRINGMAP_CLASS_END(Timer, Timer::Phase, Timer::PHASE_MAX_ENUM, phase)
+
 } // timer
 } // love
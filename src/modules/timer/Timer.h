@@ -22,7 +22,12 @@
 #define LOVE_TIMER_TIMER_H
 
 // LOVE
+#include "common/config.h"
 #include "common/Module.h"
+#include "common/StringMap.h"
+
+// C++
+#include <vector>
 
 namespace love
 {
@@ -33,8 +38,29 @@ class Timer : public Module
 {
 public:
 
+	// Parts of a frame in love.run, timed separately when marked with
+	// beginPhase.
+	enum Phase
+	{
+		PHASE_EVENTS,
+		PHASE_UPDATE,
+		PHASE_DRAW,
+		PHASE_PRESENT,
+		PHASE_MAX_ENUM
+	};
+
+	struct FrameTimeStats
+	{
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double mean = 0.0;
+		size_t count = 0;
+	};
+
 	Timer();
-	virtual ~Timer() {}
+	virtual ~Timer();
 
 	// Implements Module.
 	ModuleType getModuleType() const override { return M_TIMER; }
@@ -53,6 +79,72 @@ public:
 	 **/
 	void sleep(double seconds) const;
 
+	/**
+	 * Sleeps until the given time (see getTime), more precisely than sleep.
+	 * Sleeps with the OS for as long as it can do so without overshooting,
+	 * based on how late its past sleeps woke up, then yields in a loop until
+	 * the time is reached.
+	 **/
+	void sleepUntil(double time);
+
+	/**
+	 * Sets the frame rate pace() aims for. 0 disables pacing.
+	 **/
+	void setTargetFrameRate(double fps);
+	double getTargetFrameRate() const;
+
+	/**
+	 * Meant to be called once per frame, right after the frame is presented.
+	 * Records the time since the previous call, then waits until the next
+	 * frame is due when a target frame rate is set. Otherwise sleeps for 1ms.
+	 * Frames which finish late don't shorten the following frames.
+	 **/
+	void pace();
+
+	/**
+	 * Gets a percentile of the recent intervals between pace() calls.
+	 * @param percentile In [0, 100]; 50 is the median.
+	 * @return The interval in seconds, or 0 if there aren't any yet.
+	 **/
+	double getFrameTimePercentile(double percentile);
+
+	/**
+	 * Sets how many recent frames the frame time statistics cover. Clears
+	 * the frames recorded so far.
+	 **/
+	void setFrameTimeWindow(size_t frames);
+	size_t getFrameTimeWindow() const;
+
+	/**
+	 * Gets statistics of the recent frame times, or of the time spent in one
+	 * phase of each frame when phase isn't PHASE_MAX_ENUM.
+	 **/
+	FrameTimeStats getFrameTimeStats(Phase phase = PHASE_MAX_ENUM);
+
+	/**
+	 * Counts the recent frame times in bins of the given width. The last bin
+	 * also counts all longer frames.
+	 **/
+	void getFrameTimeHistogram(double binwidth, int bins, std::vector<int> &counts) const;
+
+	/**
+	 * Ends the current phase of the frame, if any, and starts a new one. The
+	 * frame's last phase ends when pace() is called.
+	 **/
+	void beginPhase(Phase phase);
+
+	/**
+	 * Frames which take longer than this push a "hitch" event, with the
+	 * frame time and the time spent in each phase. 0 disables it.
+	 **/
+	void setHitchThreshold(double seconds);
+	double getHitchThreshold() const;
+
+	STRINGMAP_CLASS_DECLARE(Phase);
+
+	// Default number of recent frames kept for frame time statistics.
+	static const size_t DEFAULT_FRAME_TIME_WINDOW = 1024;
+
 	/**
 	 * Gets the time between the last two frames, assuming step is called
 	 * each frame.
@@ -101,6 +193,45 @@ private:
 	// The current timestep.
 	double dt;
 
+	// Sleeps with the OS, possibly for less than the given time.
+	void sleepOS(double seconds);
+
+	// Estimated OS sleep overshoot, and its running mean and variance.
+	double sleepMargin;
+	double sleepOvershootMean;
+	double sleepOvershootVariance;
+
+#ifdef LOVE_WINDOWS
+	// High resolution waitable timer, if the system supports them.
+	void *waitableTimer;
+#endif
+
+	struct FrameSample
+	{
+		double total;
+		double phases[PHASE_MAX_ENUM];
+	};
+
+	void endPhase(double now);
+	void recordFrame(double frametime);
+
+	double targetFrameRate;
+	double nextFrameTime;
+	double lastPaceTime;
+
+	// Ring buffer of recent frames, between pace() calls.
+	std::vector<FrameSample> frameSamples;
+	size_t frameSampleNext;
+	size_t frameSampleCount;
+	std::vector<double> sortedFrameTimes;
+
+	// Phase timing for the current frame.
+	double phaseTimes[PHASE_MAX_ENUM];
+	Phase currentPhase;
+	double phaseStartTime;
+
+	double hitchThreshold;
+
 }; // Timer
 
 } // timer
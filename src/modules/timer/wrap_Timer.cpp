@@ -22,6 +22,14 @@
 
 // LOVE
 #include "wrap_Timer.h"
+#include "common/Trace.h"
+
+// C++
+#include <map>
+#include <string>
+
+// C
+#include <stdio.h>
 
 namespace love
 {
@@ -66,6 +74,242 @@ int w_getTime(lua_State *L)
 	return 1;
 }
 
+int w_sleepUntil(lua_State *L)
+{
+	instance()->sleepUntil(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_setTargetFrameRate(lua_State *L)
+{
+	instance()->setTargetFrameRate(luaL_optnumber(L, 1, 0.0));
+	return 0;
+}
+
+int w_getTargetFrameRate(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getTargetFrameRate());
+	return 1;
+}
+
+int w_pace(lua_State *L)
+{
+	instance()->pace();
+	return 0;
+}
+
+int w_getFrameTimePercentile(lua_State *L)
+{
+	double percentile = luaL_checknumber(L, 1);
+	lua_pushnumber(L, instance()->getFrameTimePercentile(percentile));
+	return 1;
+}
+
+int w_setFrameTimeWindow(lua_State *L)
+{
+	lua_Integer frames = luaL_checkinteger(L, 1);
+	if (frames < 1)
+		return luaL_error(L, "Frame time window must contain at least one frame.");
+	instance()->setFrameTimeWindow((size_t) frames);
+	return 0;
+}
+
+int w_getFrameTimeWindow(lua_State *L)
+{
+	lua_pushinteger(L, (lua_Integer) instance()->getFrameTimeWindow());
+	return 1;
+}
+
+int w_getFrameTimeStats(lua_State *L)
+{
+	Timer::Phase phase = Timer::PHASE_MAX_ENUM;
+	if (!lua_isnoneornil(L, 1))
+	{
+		const char *str = luaL_checkstring(L, 1);
+		if (!Timer::getConstant(str, phase))
+			return luax_enumerror(L, "frame phase", Timer::getConstants(phase), str);
+	}
+
+	Timer::FrameTimeStats stats = instance()->getFrameTimeStats(phase);
+
+	// Multiple returns instead of a table, to avoid creating garbage.
+	lua_pushnumber(L, stats.p50);
+	lua_pushnumber(L, stats.p95);
+	lua_pushnumber(L, stats.p99);
+	lua_pushnumber(L, stats.max);
+	lua_pushnumber(L, stats.mean);
+	lua_pushinteger(L, (lua_Integer) stats.count);
+	return 6;
+}
+
+int w_getFrameTimeHistogram(lua_State *L)
+{
+	double binwidth = luaL_checknumber(L, 1);
+	int bins = (int) luaL_checkinteger(L, 2);
+
+	if (binwidth <= 0.0)
+		return luaL_error(L, "Histogram bin width must be greater than 0.");
+	if (bins < 1)
+		return luaL_error(L, "Histogram must have at least one bin.");
+
+	std::vector<int> counts;
+	instance()->getFrameTimeHistogram(binwidth, bins, counts);
+
+	lua_createtable(L, bins, 0);
+	for (int i = 0; i < bins; i++)
+	{
+		lua_pushinteger(L, counts[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_beginPhase(lua_State *L)
+{
+	const char *str = luaL_checkstring(L, 1);
+	Timer::Phase phase;
+	if (!Timer::getConstant(str, phase))
+		return luax_enumerror(L, "frame phase", Timer::getConstants(phase), str);
+
+	instance()->beginPhase(phase);
+	return 0;
+}
+
+int w_setHitchThreshold(lua_State *L)
+{
+	instance()->setHitchThreshold(luaL_optnumber(L, 1, 0.0));
+	return 0;
+}
+
+int w_getHitchThreshold(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getHitchThreshold());
+	return 1;
+}
+
+int w_setTracingEnabled(lua_State *L)
+{
+	love::trace::setEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isTracingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, love::trace::isEnabled());
+	return 1;
+}
+
+int w_pushZone(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { love::trace::push(love::trace::internName(name)); });
+	return 0;
+}
+
+int w_popZone(lua_State *L)
+{
+	if (!love::trace::pop())
+		return luaL_error(L, "No trace zone to pop (more pops than pushes).");
+	return 0;
+}
+
+// Zones started by the Lua call hook on this thread, so returns from functions
+// entered before the hook was set don't pop zones pushed with pushZone.
+static thread_local int luaCallZones = 0;
+
+// Per-thread cache of interned zone names, to avoid taking the global intern
+// lock for every call.
+static thread_local std::map<std::string, const char *, std::less<>> luaCallNames;
+
+static void pushLuaCallZone(lua_State *L, lua_Debug *ar)
+{
+	lua_getinfo(L, "Sn", ar);
+
+	char name[256];
+	snprintf(name, sizeof(name), "%s (%s:%d)", ar->name != nullptr ? ar->name : "?", ar->short_src, ar->linedefined);
+
+	auto it = luaCallNames.find(std::string_view(name));
+	if (it == luaCallNames.end())
+		it = luaCallNames.emplace(name, love::trace::internName(name)).first;
+
+	love::trace::push(it->second);
+	luaCallZones++;
+}
+
+static void popLuaCallZone()
+{
+	if (luaCallZones > 0)
+	{
+		luaCallZones--;
+		love::trace::pop();
+	}
+}
+
+static void luaCallHook(lua_State *L, lua_Debug *ar)
+{
+	switch (ar->event)
+	{
+	case LUA_HOOKCALL:
+		pushLuaCallZone(L, ar);
+		break;
+	case LUA_HOOKRET:
+		popLuaCallZone();
+		break;
+#ifdef LUA_HOOKTAILRET
+	// Lua 5.1 and LuaJIT report an extra return for each elided tail call.
+	case LUA_HOOKTAILRET:
+		popLuaCallZone();
+		break;
+#endif
+#ifdef LUA_HOOKTAILCALL
+	// Lua 5.2+ replaces the caller's frame, and only reports one return.
+	case LUA_HOOKTAILCALL:
+		popLuaCallZone();
+		pushLuaCallZone(L, ar);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+int w_setLuaCallTracing(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+
+	if (enable)
+		lua_sethook(L, luaCallHook, LUA_MASKCALL | LUA_MASKRET, 0);
+	else
+	{
+		lua_sethook(L, nullptr, 0, 0);
+		while (luaCallZones > 0)
+			popLuaCallZone();
+	}
+
+	return 0;
+}
+
+int w_isLuaCallTracing(lua_State *L)
+{
+	luax_pushboolean(L, lua_gethook(L) == luaCallHook);
+	return 1;
+}
+
+int w_clearTrace(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { love::trace::clear(); });
+	return 0;
+}
+
+int w_getTrace(lua_State *L)
+{
+	std::string json;
+	luax_catchexcept(L, [&]() { json = love::trace::getChromeTraceJSON(); });
+	luax_pushstring(L, json);
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -75,6 +319,26 @@ static const luaL_Reg functions[] =
 	{ "getAverageDelta", w_getAverageDelta },
 	{ "sleep", w_sleep },
 	{ "getTime", w_getTime },
+	{ "sleepUntil", w_sleepUntil },
+	{ "setTargetFrameRate", w_setTargetFrameRate },
+	{ "getTargetFrameRate", w_getTargetFrameRate },
+	{ "pace", w_pace },
+	{ "getFrameTimePercentile", w_getFrameTimePercentile },
+	{ "setFrameTimeWindow", w_setFrameTimeWindow },
+	{ "getFrameTimeWindow", w_getFrameTimeWindow },
+	{ "getFrameTimeStats", w_getFrameTimeStats },
+	{ "getFrameTimeHistogram", w_getFrameTimeHistogram },
+	{ "beginPhase", w_beginPhase },
+	{ "setHitchThreshold", w_setHitchThreshold },
+	{ "getHitchThreshold", w_getHitchThreshold },
+	{ "setTracingEnabled", w_setTracingEnabled },
+	{ "isTracingEnabled", w_isTracingEnabled },
+	{ "pushZone", w_pushZone },
+	{ "popZone", w_popZone },
+	{ "setLuaCallTracing", w_setLuaCallTracing },
+	{ "isLuaCallTracing", w_isLuaCallTracing },
+	{ "clearTrace", w_clearTrace },
+	{ "getTrace", w_getTrace },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FrameQueue.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace video
+{
+
+FrameQueue::FrameQueue(int width, int height, int chromaWidth, int chromaHeight)
+	: width(width)
+	, height(height)
+	, chromaWidth(chromaWidth)
+	, chromaHeight(chromaHeight)
+	, front(nullptr)
+	, capacity(DEFAULT_CAPACITY)
+{
+	// Black until the first frame is decoded.
+	front = newFrame();
+	memset(front->yplane, 16, front->yw * front->yh);
+	memset(front->cbplane, 128, front->cw * front->ch);
+	memset(front->crplane, 128, front->cw * front->ch);
+}
+
+FrameQueue::~FrameQueue()
+{
+	clear();
+
+	for (VideoStream::Frame *frame : freeFrames)
+		delete frame;
+
+	delete front;
+}
+
+VideoStream::Frame *FrameQueue::newFrame() const
+{
+	VideoStream::Frame *frame = new VideoStream::Frame();
+
+	frame->yw = width;
+	frame->yh = height;
+	frame->cw = chromaWidth;
+	frame->ch = chromaHeight;
+
+	frame->yplane = new unsigned char[frame->yw * frame->yh + 2 * frame->cw * frame->ch];
+	frame->cbplane = frame->yplane + frame->yw * frame->yh;
+	frame->crplane = frame->cbplane + frame->cw * frame->ch;
+
+	return frame;
+}
+
+void FrameQueue::setCapacity(int capacity)
+{
+	love::thread::Lock l(mutex);
+	this->capacity = std::max(capacity, 1);
+
+	// Frames past the new limit are freed as they come back.
+	while (!freeFrames.empty() && (int) (queue.size() + freeFrames.size()) > this->capacity)
+	{
+		delete freeFrames.back();
+		freeFrames.pop_back();
+	}
+}
+
+int FrameQueue::getCapacity() const
+{
+	love::thread::Lock l(mutex);
+	return capacity;
+}
+
+VideoStream::Frame *FrameQueue::acquire(double position)
+{
+	love::thread::Lock l(mutex);
+	dropLateFrames(position);
+
+	if ((int) queue.size() >= capacity)
+		return nullptr;
+
+	if (!freeFrames.empty())
+	{
+		VideoStream::Frame *frame = freeFrames.back();
+		freeFrames.pop_back();
+		return frame;
+	}
+
+	return newFrame();
+}
+
+void FrameQueue::release(VideoStream::Frame *frame)
+{
+	love::thread::Lock l(mutex);
+	freeFrames.push_back(frame);
+}
+
+void FrameQueue::push(VideoStream::Frame *frame, double time)
+{
+	love::thread::Lock l(mutex);
+	queue.push_back({frame, time});
+}
+
+void FrameQueue::clear()
+{
+	love::thread::Lock l(mutex);
+
+	for (const QueuedFrame &queued : queue)
+		freeFrames.push_back(queued.frame);
+
+	queue.clear();
+}
+
+bool FrameQueue::isEmpty() const
+{
+	love::thread::Lock l(mutex);
+	return queue.empty();
+}
+
+bool FrameQueue::swap(double position)
+{
+	love::thread::Lock l(mutex);
+	dropLateFrames(position);
+
+	if (queue.empty() || queue.front().time > position)
+		return false;
+
+	freeFrames.push_back(front);
+	front = queue.front().frame;
+	queue.pop_front();
+
+	return true;
+}
+
+void FrameQueue::dropLateFrames(double position)
+{
+	// A frame is late once the frame after it is due, it would never be
+	// displayed.
+	while (queue.size() >= 2 && queue[1].time <= position)
+	{
+		freeFrames.push_back(queue.front().frame);
+		queue.pop_front();
+	}
+}
+
+} // video
+} // love
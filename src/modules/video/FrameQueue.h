@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_VIDEO_FRAME_QUEUE_H
+#define LOVE_VIDEO_FRAME_QUEUE_H
+
+// LOVE
+#include "VideoStream.h"
+#include "thread/threads.h"
+
+// STL
+#include <deque>
+#include <vector>
+
+namespace love
+{
+namespace video
+{
+
+/**
+ * Frames decoded ahead of the one being displayed. A decoding thread fills
+ * the queue, and the thread displaying the video swaps frames out of it once
+ * they're due. Frames are recycled rather than reallocated.
+ **/
+class FrameQueue
+{
+public:
+
+	static const int DEFAULT_CAPACITY = 4;
+
+	FrameQueue(int width, int height, int chromaWidth, int chromaHeight);
+	~FrameQueue();
+
+	void setCapacity(int capacity);
+	int getCapacity() const;
+
+	/**
+	 * Gets a frame to decode into, or null if the queue is full. Frames
+	 * which are already late at the given position are dropped first.
+	 **/
+	VideoStream::Frame *acquire(double position);
+
+	// Hands back an acquired frame which didn't end up being used.
+	void release(VideoStream::Frame *frame);
+
+	// Queues an acquired frame, to be displayed from the given time.
+	void push(VideoStream::Frame *frame, double time);
+
+	// Drops every queued frame, e.g. after seeking.
+	void clear();
+
+	bool isEmpty() const;
+
+	/**
+	 * Makes the newest frame which is due at the given position the front
+	 * frame. Returns false if no queued frame is due yet.
+	 **/
+	bool swap(double position);
+
+	// Only valid on the thread calling swap.
+	const VideoStream::Frame *getFront() const { return front; }
+
+private:
+
+	struct QueuedFrame
+	{
+		VideoStream::Frame *frame;
+		double time;
+	};
+
+	VideoStream::Frame *newFrame() const;
+
+	// Expects the mutex to be locked.
+	void dropLateFrames(double position);
+
+	int width;
+	int height;
+	int chromaWidth;
+	int chromaHeight;
+
+	VideoStream::Frame *front;
+	std::deque<QueuedFrame> queue;
+	std::vector<VideoStream::Frame *> freeFrames;
+	int capacity;
+
+	love::thread::MutexRef mutex;
+
+}; // FrameQueue
+
+} // video
+} // love
+
+#endif // LOVE_VIDEO_FRAME_QUEUE_H
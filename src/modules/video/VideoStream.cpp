@@ -74,8 +74,6 @@ VideoStream::Frame::Frame()
 VideoStream::Frame::~Frame()
 {
 	delete[] yplane;
-	delete[] cbplane;
-	delete[] crplane;
 }
 
 void VideoStream::FrameSync::copyState(const VideoStream::FrameSync *other)
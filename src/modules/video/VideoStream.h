@@ -44,6 +44,12 @@ public:
 	 **/
 	virtual void fillBackBuffer() {}
 
+	/**
+	 * Decodes ahead of playback. Called repeatedly from the stream's own
+	 * worker thread, dt is the time since the previous call.
+	 **/
+	virtual void threadedDecode(double /*dt*/) {}
+
 	/**
 	 * Get the front buffer, Streams are supposed to be (at least) double-buffered
 	 **/
@@ -65,6 +71,13 @@ public:
 	virtual int getHeight() const = 0;
 	virtual const std::string &getFilename() const = 0;
 
+	/**
+	 * How many frames may be decoded ahead of the one being displayed.
+	 * Larger queues smooth out decoding hitches, at the cost of memory.
+	 **/
+	virtual void setFrameQueueSize(int size) = 0;
+	virtual int getFrameQueueSize() const = 0;
+
 	// Playback api
 	virtual void play();
 	virtual void pause();
@@ -80,6 +93,8 @@ public:
 	virtual FrameSync *getSync() const;
 
 	// Data structures
+	// The planes are stored back to back in one allocation, starting at
+	// yplane, so a whole frame can be uploaded at once.
 	struct Frame
 	{
 		Frame();
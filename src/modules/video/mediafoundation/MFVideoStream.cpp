@@ -0,0 +1,712 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "MFVideoStream.h"
+
+#ifdef LOVE_VIDEO_MEDIAFOUNDATION
+
+// LOVE
+#include "common/Exception.h"
+
+// Media Foundation
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <mferror.h>
+#include <d3d11.h>
+#include <d3d10.h>
+
+// STL
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace video
+{
+namespace mediafoundation
+{
+
+template <typename T>
+static void safeRelease(T *&object)
+{
+	if (object != nullptr)
+	{
+		object->Release();
+		object = nullptr;
+	}
+}
+
+// The outcome of a read, handed from BeginRead to EndRead.
+class ReadResult : public IUnknown
+{
+public:
+
+	ReadResult(ULONG bytesRead)
+		: refCount(1)
+		, bytesRead(bytesRead)
+	{}
+
+	virtual ~ReadResult() {}
+
+	STDMETHODIMP QueryInterface(REFIID riid, void **object) override
+	{
+		if (object == nullptr)
+			return E_POINTER;
+
+		if (riid == __uuidof(IUnknown))
+		{
+			*object = static_cast<IUnknown *>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		*object = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	STDMETHODIMP_(ULONG) AddRef() override
+	{
+		return ++refCount;
+	}
+
+	STDMETHODIMP_(ULONG) Release() override
+	{
+		ULONG count = --refCount;
+		if (count == 0)
+			delete this;
+		return count;
+	}
+
+	std::atomic<ULONG> refCount;
+	ULONG bytesRead;
+};
+
+// Lets Media Foundation read from a File, so videos can be played from
+// anywhere love.filesystem can see, including inside .love archives.
+class FileByteStream : public IMFByteStream
+{
+public:
+
+	FileByteStream(love::filesystem::File *file)
+		: refCount(1)
+		, file(file)
+		, position(0)
+	{}
+
+	virtual ~FileByteStream() {}
+
+	STDMETHODIMP QueryInterface(REFIID riid, void **object) override
+	{
+		if (object == nullptr)
+			return E_POINTER;
+
+		if (riid == __uuidof(IUnknown) || riid == __uuidof(IMFByteStream))
+		{
+			*object = static_cast<IMFByteStream *>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		*object = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	STDMETHODIMP_(ULONG) AddRef() override
+	{
+		return ++refCount;
+	}
+
+	STDMETHODIMP_(ULONG) Release() override
+	{
+		ULONG count = --refCount;
+		if (count == 0)
+			delete this;
+		return count;
+	}
+
+	STDMETHODIMP GetCapabilities(DWORD *capabilities) override
+	{
+		*capabilities = MFBYTESTREAM_IS_READABLE | MFBYTESTREAM_IS_SEEKABLE;
+		return S_OK;
+	}
+
+	STDMETHODIMP GetLength(QWORD *length) override
+	{
+		love::thread::Lock l(mutex);
+		int64 size = file->getSize();
+		if (size < 0)
+			return E_FAIL;
+		*length = (QWORD) size;
+		return S_OK;
+	}
+
+	STDMETHODIMP SetLength(QWORD) override
+	{
+		return E_NOTIMPL;
+	}
+
+	STDMETHODIMP GetCurrentPosition(QWORD *current) override
+	{
+		love::thread::Lock l(mutex);
+		*current = position;
+		return S_OK;
+	}
+
+	STDMETHODIMP SetCurrentPosition(QWORD newPosition) override
+	{
+		love::thread::Lock l(mutex);
+		position = newPosition;
+		return S_OK;
+	}
+
+	STDMETHODIMP IsEndOfStream(BOOL *endOfStream) override
+	{
+		love::thread::Lock l(mutex);
+		*endOfStream = (int64) position >= file->getSize();
+		return S_OK;
+	}
+
+	STDMETHODIMP Read(BYTE *buffer, ULONG size, ULONG *read) override
+	{
+		love::thread::Lock l(mutex);
+
+		if (!file->seek((int64) position))
+			return E_FAIL;
+
+		int64 result = file->read(buffer, size);
+		if (result < 0)
+			return E_FAIL;
+
+		position += (QWORD) result;
+		*read = (ULONG) result;
+		return S_OK;
+	}
+
+	STDMETHODIMP BeginRead(BYTE *buffer, ULONG size, IMFAsyncCallback *callback, IUnknown *state) override
+	{
+		// Reading is quick enough to do right away, only the completion is
+		// reported asynchronously.
+		ULONG bytesRead = 0;
+		HRESULT status = Read(buffer, size, &bytesRead);
+
+		ReadResult *readResult = new ReadResult(bytesRead);
+		IMFAsyncResult *result = nullptr;
+		HRESULT hr = MFCreateAsyncResult(readResult, callback, state, &result);
+		readResult->Release();
+
+		if (FAILED(hr))
+			return hr;
+
+		result->SetStatus(status);
+		hr = MFInvokeCallback(result);
+		result->Release();
+
+		return hr;
+	}
+
+	STDMETHODIMP EndRead(IMFAsyncResult *result, ULONG *read) override
+	{
+		IUnknown *object = nullptr;
+		HRESULT hr = result->GetObject(&object);
+		if (FAILED(hr))
+			return hr;
+
+		*read = static_cast<ReadResult *>(object)->bytesRead;
+		object->Release();
+
+		return result->GetStatus();
+	}
+
+	STDMETHODIMP Write(const BYTE *, ULONG, ULONG *) override
+	{
+		return E_NOTIMPL;
+	}
+
+	STDMETHODIMP BeginWrite(const BYTE *, ULONG, IMFAsyncCallback *, IUnknown *) override
+	{
+		return E_NOTIMPL;
+	}
+
+	STDMETHODIMP EndWrite(IMFAsyncResult *, ULONG *) override
+	{
+		return E_NOTIMPL;
+	}
+
+	STDMETHODIMP Seek(MFBYTESTREAM_SEEK_ORIGIN origin, LONGLONG offset, DWORD, QWORD *newPosition) override
+	{
+		love::thread::Lock l(mutex);
+
+		LONGLONG target = offset;
+		if (origin == msoCurrent)
+			target += (LONGLONG) position;
+
+		if (target < 0)
+			return E_INVALIDARG;
+
+		position = (QWORD) target;
+		if (newPosition != nullptr)
+			*newPosition = position;
+
+		return S_OK;
+	}
+
+	STDMETHODIMP Flush() override
+	{
+		return S_OK;
+	}
+
+	STDMETHODIMP Close() override
+	{
+		return S_OK;
+	}
+
+private:
+
+	std::atomic<ULONG> refCount;
+	StrongRef<love::filesystem::File> file;
+	QWORD position;
+	love::thread::MutexRef mutex;
+};
+
+MFVideoStream::MFVideoStream(love::filesystem::File *file)
+	: file(file)
+	, device(nullptr)
+	, deviceManager(nullptr)
+	, reader(nullptr)
+	, surfaceWidth(0)
+	, surfaceHeight(0)
+	, surfacePitch(0)
+	, cropX(0)
+	, cropY(0)
+	, width(0)
+	, height(0)
+	, frames(nullptr)
+	, lastPosition(0)
+	, eos(false)
+{
+	if (FAILED(MFStartup(MF_VERSION, MFSTARTUP_LITE)))
+		throw love::Exception("Could not initialize Media Foundation.");
+
+	try
+	{
+		createReader();
+	}
+	catch (love::Exception &)
+	{
+		cleanup();
+		throw;
+	}
+
+	frames = new FrameQueue(width, height, (width + 1) / 2, (height + 1) / 2);
+
+	frameSync.set(new DeltaSync(), Acquire::NORETAIN);
+}
+
+MFVideoStream::~MFVideoStream()
+{
+	cleanup();
+}
+
+void MFVideoStream::cleanup()
+{
+	safeRelease(reader);
+	safeRelease(deviceManager);
+	safeRelease(device);
+
+	delete frames;
+	frames = nullptr;
+
+	MFShutdown();
+}
+
+void MFVideoStream::createDevice()
+{
+	// Hardware decoding needs a Direct3D 11 device. Without one, Media
+	// Foundation uses software decoders instead.
+	UINT flags = D3D11_CREATE_DEVICE_VIDEO_SUPPORT | D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+	HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, flags, nullptr, 0, D3D11_SDK_VERSION, &device, nullptr, nullptr);
+
+	if (FAILED(hr))
+		return;
+
+	// The decoder uses the device from its own threads.
+	ID3D10Multithread *multithread = nullptr;
+	if (SUCCEEDED(device->QueryInterface(IID_PPV_ARGS(&multithread))))
+	{
+		multithread->SetMultithreadProtected(TRUE);
+		multithread->Release();
+	}
+
+	UINT token = 0;
+	hr = MFCreateDXGIDeviceManager(&token, &deviceManager);
+
+	if (SUCCEEDED(hr))
+		hr = deviceManager->ResetDevice(device, token);
+
+	if (FAILED(hr))
+	{
+		safeRelease(deviceManager);
+		safeRelease(device);
+	}
+}
+
+void MFVideoStream::createReader()
+{
+	createDevice();
+
+	IMFByteStream *byteStream = new FileByteStream(file);
+	IMFAttributes *attributes = nullptr;
+
+	HRESULT hr = MFCreateAttributes(&attributes, 3);
+
+	if (SUCCEEDED(hr) && deviceManager != nullptr)
+		hr = attributes->SetUnknown(MF_SOURCE_READER_D3D_MANAGER, deviceManager);
+
+	if (SUCCEEDED(hr))
+		hr = attributes->SetUINT32(MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, TRUE);
+
+	// Lets the reader convert to NV12 if the decoder outputs something else.
+	if (SUCCEEDED(hr))
+		hr = attributes->SetUINT32(MF_SOURCE_READER_ENABLE_ADVANCED_VIDEO_PROCESSING, TRUE);
+
+	if (SUCCEEDED(hr))
+		hr = MFCreateSourceReaderFromByteStream(byteStream, attributes, &reader);
+
+	safeRelease(attributes);
+	byteStream->Release();
+
+	if (FAILED(hr))
+		throw love::Exception("Invalid video file, the format isn't supported on this system.");
+
+	reader->SetStreamSelection((DWORD) MF_SOURCE_READER_ALL_STREAMS, FALSE);
+
+	if (FAILED(reader->SetStreamSelection((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, TRUE)))
+		throw love::Exception("Invalid video file, it has no video stream.");
+
+	IMFMediaType *type = nullptr;
+	hr = MFCreateMediaType(&type);
+
+	if (SUCCEEDED(hr))
+		hr = type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
+
+	if (SUCCEEDED(hr))
+		hr = type->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_NV12);
+
+	if (SUCCEEDED(hr))
+		hr = reader->SetCurrentMediaType((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, nullptr, type);
+
+	safeRelease(type);
+
+	if (FAILED(hr))
+		throw love::Exception("Invalid video file, no decoder on this system supports its video codec.");
+
+	if (!readMediaType())
+		throw love::Exception("Could not get the video's dimensions.");
+
+	width = std::max(surfaceWidth - cropX, 0);
+	height = std::max(surfaceHeight - cropY, 0);
+
+	MFVideoArea area = {};
+	IMFMediaType *current = nullptr;
+	if (SUCCEEDED(reader->GetCurrentMediaType((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, &current)))
+	{
+		if (SUCCEEDED(current->GetBlob(MF_MT_MINIMUM_DISPLAY_APERTURE, (UINT8 *) &area, sizeof(area), nullptr)))
+		{
+			width = std::min((int) area.Area.cx, width);
+			height = std::min((int) area.Area.cy, height);
+		}
+
+		current->Release();
+	}
+
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid video file, it has no picture.");
+}
+
+bool MFVideoStream::readMediaType()
+{
+	IMFMediaType *type = nullptr;
+	if (FAILED(reader->GetCurrentMediaType((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, &type)))
+		return false;
+
+	UINT32 w = 0;
+	UINT32 h = 0;
+	HRESULT hr = MFGetAttributeSize(type, MF_MT_FRAME_SIZE, &w, &h);
+
+	if (SUCCEEDED(hr))
+	{
+		surfaceWidth = (int) w;
+		surfaceHeight = (int) h;
+
+		UINT32 stride = 0;
+		if (SUCCEEDED(type->GetUINT32(MF_MT_DEFAULT_STRIDE, &stride)) && (INT32) stride > 0)
+			surfacePitch = (int) stride;
+		else
+			surfacePitch = surfaceWidth;
+
+		// Decoders output whole macroblocks, e.g. 1088 rows for 1080p.
+		MFVideoArea area = {};
+		if (SUCCEEDED(type->GetBlob(MF_MT_MINIMUM_DISPLAY_APERTURE, (UINT8 *) &area, sizeof(area), nullptr)))
+		{
+			// Chroma is subsampled, so the offsets have to be even.
+			cropX = (int) area.OffsetX.value & ~1;
+			cropY = (int) area.OffsetY.value & ~1;
+		}
+		else
+			cropX = cropY = 0;
+	}
+
+	type->Release();
+	return SUCCEEDED(hr);
+}
+
+void MFVideoStream::seekReader(double target)
+{
+	// Positions are in 100 nanosecond units.
+	PROPVARIANT var;
+	PropVariantInit(&var);
+	var.vt = VT_I8;
+	var.hVal.QuadPart = (LONGLONG) (std::max(target, 0.0) * 10000000.0);
+
+	if (SUCCEEDED(reader->SetCurrentPosition(GUID_NULL, var)))
+		eos = false;
+
+	PropVariantClear(&var);
+}
+
+bool MFVideoStream::copySample(IMFSample *sample, Frame *frame)
+{
+	IMFMediaBuffer *buffer = nullptr;
+	if (FAILED(sample->GetBufferByIndex(0, &buffer)))
+		return false;
+
+	// Buffers backed by GPU surfaces are read back by Lock2D.
+	IMF2DBuffer *buffer2D = nullptr;
+	BYTE *data = nullptr;
+	LONG pitch = 0;
+	bool locked = false;
+
+	if (SUCCEEDED(buffer->QueryInterface(IID_PPV_ARGS(&buffer2D))))
+		locked = SUCCEEDED(buffer2D->Lock2D(&data, &pitch));
+	else
+	{
+		DWORD length = 0;
+		locked = SUCCEEDED(buffer->Lock(&data, nullptr, &length));
+		pitch = surfacePitch;
+	}
+
+	bool copied = false;
+
+	if (locked && pitch > 0)
+	{
+		int rows = std::min(frame->yh, surfaceHeight - cropY);
+		int columns = std::min(frame->yw, surfaceWidth - cropX);
+
+		for (int y = 0; y < rows; y++)
+			memcpy(frame->yplane + frame->yw * y, data + pitch * (y + cropY) + cropX, columns);
+
+		// NV12 has a single plane of interleaved Cb and Cr samples after the
+		// luma plane.
+		const BYTE *chroma = data + (size_t) pitch * surfaceHeight;
+
+		int chromaRows = std::min(frame->ch, (surfaceHeight - cropY) / 2);
+		int chromaColumns = std::min(frame->cw, (surfaceWidth - cropX) / 2);
+
+		for (int y = 0; y < chromaRows; y++)
+		{
+			const BYTE *src = chroma + pitch * (y + cropY / 2) + cropX;
+			unsigned char *cb = frame->cbplane + frame->cw * y;
+			unsigned char *cr = frame->crplane + frame->cw * y;
+
+			for (int x = 0; x < chromaColumns; x++)
+			{
+				cb[x] = src[x * 2 + 0];
+				cr[x] = src[x * 2 + 1];
+			}
+		}
+
+		copied = true;
+	}
+
+	if (locked)
+	{
+		if (buffer2D != nullptr)
+			buffer2D->Unlock2D();
+		else
+			buffer->Unlock();
+	}
+
+	safeRelease(buffer2D);
+	buffer->Release();
+
+	return copied;
+}
+
+void MFVideoStream::threadedDecode(double dt)
+{
+	StrongRef<FrameSync> sync;
+	{
+		love::thread::Lock l(syncMutex);
+		sync = frameSync;
+	}
+
+	// Synchronize
+	sync->update(dt);
+	double position = sync->getPosition();
+
+	// Seeking backwards, everything decoded so far is in the future.
+	if (position < lastPosition)
+	{
+		frames->clear();
+		seekReader(position);
+	}
+
+	lastPosition = position;
+
+	bool failedSeek = false;
+
+	while (!eos)
+	{
+		Frame *frame = frames->acquire(position);
+		if (frame == nullptr)
+			break;
+
+		DWORD flags = 0;
+		LONGLONG timestamp = 0;
+		IMFSample *sample = nullptr;
+
+		HRESULT hr = reader->ReadSample((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, nullptr, &flags, &timestamp, &sample);
+
+		if (FAILED(hr) || (flags & (MF_SOURCE_READERF_ERROR | MF_SOURCE_READERF_ENDOFSTREAM)) != 0)
+			eos = true;
+
+		if ((flags & MF_SOURCE_READERF_CURRENTMEDIATYPECHANGED) != 0)
+			readMediaType();
+
+		if (sample == nullptr)
+		{
+			frames->release(frame);
+			continue;
+		}
+
+		// Timestamps are in 100 nanosecond units.
+		LONGLONG duration = 0;
+		sample->GetSampleDuration(&duration);
+
+		double time = timestamp / 10000000.0;
+		double end = (timestamp + duration) / 10000000.0;
+
+		if (duration > 0 && end <= position)
+		{
+			// Late already, no point in reading it back.
+			sample->Release();
+			frames->release(frame);
+
+			// If we're far behind, skip ahead to the keyframe closest to
+			// where we should be.
+			if (!failedSeek && position - end > 1.0)
+			{
+				frames->clear();
+				seekReader(position);
+				failedSeek = true;
+			}
+
+			continue;
+		}
+
+		bool copied = copySample(sample, frame);
+		sample->Release();
+
+		if (copied)
+			frames->push(frame, time);
+		else
+			frames->release(frame);
+	}
+}
+
+const void *MFVideoStream::getFrontBuffer() const
+{
+	return frames->getFront();
+}
+
+size_t MFVideoStream::getSize() const
+{
+	return sizeof(Frame);
+}
+
+bool MFVideoStream::swapBuffers()
+{
+	double position = 0.0;
+
+	{
+		love::thread::Lock l(syncMutex);
+
+		if (!frameSync->isPlaying())
+			return false;
+
+		position = frameSync->getPosition();
+	}
+
+	return frames->swap(position);
+}
+
+int MFVideoStream::getWidth() const
+{
+	return width;
+}
+
+int MFVideoStream::getHeight() const
+{
+	return height;
+}
+
+const std::string &MFVideoStream::getFilename() const
+{
+	return file->getFilename();
+}
+
+void MFVideoStream::setSync(FrameSync *frameSync)
+{
+	love::thread::Lock l(syncMutex);
+	this->frameSync = frameSync;
+}
+
+void MFVideoStream::setFrameQueueSize(int size)
+{
+	frames->setCapacity(size);
+}
+
+int MFVideoStream::getFrameQueueSize() const
+{
+	return frames->getCapacity();
+}
+
+bool MFVideoStream::isPlaying() const
+{
+	love::thread::Lock l(syncMutex);
+	return frameSync->isPlaying() && !(eos && frames->isEmpty());
+}
+
+} // mediafoundation
+} // video
+} // love
+
+#endif // LOVE_VIDEO_MEDIAFOUNDATION
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2006-2023 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_VIDEO_MEDIAFOUNDATION_MF_VIDEO_STREAM_H
+#define LOVE_VIDEO_MEDIAFOUNDATION_MF_VIDEO_STREAM_H
+
+#include "common/config.h"
+
+#ifdef LOVE_VIDEO_MEDIAFOUNDATION
+
+// LOVE
+#include "filesystem/File.h"
+#include "thread/threads.h"
+#include "video/FrameQueue.h"
+#include "video/VideoStream.h"
+
+// STL
+#include <atomic>
+
+struct ID3D11Device;
+struct IMFDXGIDeviceManager;
+struct IMFSample;
+struct IMFSourceReader;
+
+namespace love
+{
+namespace video
+{
+namespace mediafoundation
+{
+
+/**
+ * Plays any video format Windows has a Media Foundation decoder for, such as
+ * H.264, HEVC, VP9 and AV1 in MP4 or MKV files. Decoding is done by the GPU
+ * when the system supports it.
+ **/
+class MFVideoStream : public love::video::VideoStream
+{
+public:
+
+	MFVideoStream(love::filesystem::File *file);
+	virtual ~MFVideoStream();
+
+	const void *getFrontBuffer() const override;
+	size_t getSize() const override;
+	bool swapBuffers() override;
+
+	int getWidth() const override;
+	int getHeight() const override;
+	const std::string &getFilename() const override;
+	void setSync(FrameSync *frameSync) override;
+
+	void setFrameQueueSize(int size) override;
+	int getFrameQueueSize() const override;
+
+	bool isPlaying() const override;
+
+	void threadedDecode(double dt) override;
+
+private:
+
+	void createDevice();
+	void createReader();
+	bool readMediaType();
+	void seekReader(double target);
+	bool copySample(IMFSample *sample, Frame *frame);
+	void cleanup();
+
+	StrongRef<love::filesystem::File> file;
+
+	ID3D11Device *device;
+	IMFDXGIDeviceManager *deviceManager;
+	IMFSourceReader *reader;
+
+	// Size and row pitch of the decoded NV12 surfaces.
+	int surfaceWidth;
+	int surfaceHeight;
+	int surfacePitch;
+
+	// The part of the surface which is displayed.
+	int cropX;
+	int cropY;
+	int width;
+	int height;
+
+	FrameQueue *frames;
+
+	// Guards the sync object, which setSync can replace at any time.
+	love::thread::MutexRef syncMutex;
+
+	double lastPosition;
+	std::atomic<bool> eos;
+
+}; // MFVideoStream
+
+} // mediafoundation
+} // video
+} // love
+
+#endif // LOVE_VIDEO_MEDIAFOUNDATION
+
+#endif // LOVE_VIDEO_MEDIAFOUNDATION_MF_VIDEO_STREAM_H
@@ -37,26 +37,22 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
+	, frames(nullptr)
 	, lastFrame(0)
 	, nextFrame(0)
+	, lastPosition(0)
 {
 	if (demuxer.findStream() != OggDemuxer::TYPE_THEORA)
 		throw love::Exception("Invalid video file, video is not theora");
 
 	th_info_init(&videoInfo);
 
-	frontBuffer = new Frame();
-	backBuffer = new Frame();
-
 	try
 	{
 		parseHeader();
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
-		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
 	}
@@ -71,8 +67,7 @@ TheoraVideoStream::~TheoraVideoStream()
 
 	th_info_clear(&videoInfo);
 
-	delete frontBuffer;
-	delete backBuffer;
+	delete frames;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -102,9 +97,19 @@ void TheoraVideoStream::setSync(FrameSync *frameSync)
 	this->frameSync = frameSync;
 }
 
+void TheoraVideoStream::setFrameQueueSize(int size)
+{
+	frames->setCapacity(size);
+}
+
+int TheoraVideoStream::getFrameQueueSize() const
+{
+	return frames->getCapacity();
+}
+
 const void *TheoraVideoStream::getFrontBuffer() const
 {
-	return frontBuffer;
+	return frames->getFront();
 }
 
 size_t TheoraVideoStream::getSize() const
@@ -114,7 +119,8 @@ size_t TheoraVideoStream::getSize() const
 
 bool TheoraVideoStream::isPlaying() const
 {
-	return frameSync->isPlaying() && !demuxer.isEos();
+	love::thread::Lock l(bufferMutex);
+	return frameSync->isPlaying() && !(demuxer.isEos() && frames->isEmpty());
 }
 
 template<typename T>
@@ -162,28 +168,16 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
-
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
-	{
-		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
-		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
-
-		scaleFormat(videoInfo.pixel_fmt, buffers[i]->cw, buffers[i]->ch);
+	unsigned int cw = videoInfo.pic_width;
+	unsigned int ch = videoInfo.pic_height;
+	scaleFormat(videoInfo.pixel_fmt, cw, ch);
 
-		buffers[i]->yplane = new unsigned char[buffers[i]->yw * buffers[i]->yh];
-		buffers[i]->cbplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-		buffers[i]->crplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-
-		memset(buffers[i]->yplane, 16, buffers[i]->yw * buffers[i]->yh);
-		memset(buffers[i]->cbplane, 128, buffers[i]->cw * buffers[i]->ch);
-		memset(buffers[i]->crplane, 128, buffers[i]->cw * buffers[i]->ch);
-	}
+	frames = new FrameQueue(videoInfo.pic_width, videoInfo.pic_height, cw, ch);
 
 	headerParsed = true;
 	th_decode_packetin(decoder, &packet, nullptr);
@@ -203,34 +197,81 @@ void TheoraVideoStream::seekDecoder(double target)
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 }
 
-void TheoraVideoStream::threadedFillBackBuffer(double dt)
+void TheoraVideoStream::copyFrame(const th_ycbcr_buffer &bufferinfo, Frame *frame) const
 {
+	for (int y = 0; y < frame->yh; ++y)
+	{
+		memcpy(frame->yplane+frame->yw*y,
+				bufferinfo[0].data+
+					bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+				frame->yw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->cbplane+frame->cw*y,
+				bufferinfo[1].data+
+					bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->crplane+frame->cw*y,
+				bufferinfo[2].data+
+					bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+}
+
+void TheoraVideoStream::threadedDecode(double dt)
+{
+	StrongRef<FrameSync> sync;
+	{
+		love::thread::Lock l(bufferMutex);
+		sync = frameSync;
+	}
+
 	// Synchronize
-	frameSync->update(dt);
-	double position = frameSync->getPosition();
+	sync->update(dt);
+	double position = sync->getPosition();
 
-	// Seeking backwards
-	if (position < lastFrame)
+	// Seeking backwards, everything decoded so far is in the future.
+	if (position < lastPosition)
+	{
+		frames->clear();
 		seekDecoder(position);
+	}
 
-	th_ycbcr_buffer bufferinfo;
-	bool hasFrame = false;
+	lastPosition = position;
 
-	// Until we are at the end of the stream, or we are displaying the right frame
+	// Until we are at the end of the stream, or the queue is full
 	unsigned int framesBehind = 0;
 	bool failedSeek = false;
-	while (!demuxer.isEos() && position >= nextFrame)
+	while (!demuxer.isEos())
 	{
 		// If we can't catch up, seek
-		if (framesBehind++ > 5 && !failedSeek)
+		if (nextFrame >= 0 && position >= nextFrame && framesBehind++ > 5 && !failedSeek)
 		{
+			frames->clear();
 			seekDecoder(position);
 			framesBehind = 0;
 			failedSeek = true;
 		}
 
-		th_decode_ycbcr_out(decoder, bufferinfo);
-		hasFrame = true;
+		// The decoder's current frame is invalid right after a seek.
+		if (nextFrame >= 0)
+		{
+			Frame *frame = frames->acquire(position);
+			if (frame == nullptr)
+				break;
+
+			th_ycbcr_buffer bufferinfo;
+			th_decode_ycbcr_out(decoder, bufferinfo);
+			copyFrame(bufferinfo, frame);
+
+			frames->push(frame, nextFrame);
+		}
 
 		ogg_int64_t granulePosition;
 		do
@@ -241,46 +282,6 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 		lastFrame = nextFrame;
 		nextFrame = th_granule_time(decoder, granulePosition);
 	}
-
-	// Only swap once, even if we read many frames to get here
-	if (hasFrame)
-	{
-		// Don't swap whilst we're writing to the backbuffer
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = false;
-		}
-
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
-
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
-
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
-
-		// Re-enable swapping
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = true;
-		}
-	}
 }
 
 void TheoraVideoStream::fillBackBuffer()
@@ -290,22 +291,18 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
+	double position = 0.0;
 
-	if (!frameSync->isPlaying())
-		return false;
+	{
+		love::thread::Lock l(bufferMutex);
 
-	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
-		return false;
-	frameReady = false;
+		if (!frameSync->isPlaying())
+			return false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+		position = frameSync->getPosition();
+	}
 
-	return true;
+	return frames->swap(position);
 }
 
 } // theora
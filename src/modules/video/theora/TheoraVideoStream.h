@@ -27,6 +27,7 @@
 #include "common/int.h"
 #include "filesystem/File.h"
 #include "thread/threads.h"
+#include "video/FrameQueue.h"
 #include "OggDemuxer.h"
 
 // OGG/Theora
@@ -57,9 +58,12 @@ public:
 	const std::string &getFilename() const;
 	void setSync(FrameSync *frameSync);
 
+	void setFrameQueueSize(int size);
+	int getFrameQueueSize() const;
+
 	bool isPlaying() const;
 
-	void threadedFillBackBuffer(double dt);
+	void threadedDecode(double dt) override;
 
 private:
 	OggDemuxer demuxer;
@@ -71,21 +75,23 @@ private:
 	th_info videoInfo;
 	th_dec_ctx *decoder;
 
-	Frame *frontBuffer;
-	Frame *backBuffer;
+	FrameQueue *frames;
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
+	// Guards the sync object, which setSync can replace at any time.
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
 	double lastFrame;
 	double nextFrame;
+	double lastPosition;
 
 	void parseHeader();
 	void seekDecoder(double target);
+
+	void copyFrame(const th_ycbcr_buffer &bufferinfo, Frame *frame) const;
 }; // TheoraVideoStream
 
 } // theora
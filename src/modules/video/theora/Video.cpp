@@ -24,6 +24,7 @@
 // LOVE
 #include "Video.h"
 #include "common/delay.h"
+#include "video/mediafoundation/MFVideoStream.h"
 #include "timer/Timer.h"
 
 namespace love
@@ -35,19 +36,49 @@ namespace theora
 
 Video::Video()
 {
-	workerThread = new Worker();
-	workerThread->start();
 }
 
 Video::~Video()
 {
-	delete workerThread;
+	for (Worker *worker : workers)
+		delete worker;
 }
 
 VideoStream *Video::newVideoStream(love::filesystem::File *file)
 {
-	TheoraVideoStream *stream = new TheoraVideoStream(file);
-	workerThread->addStream(stream);
+	// Clean up after streams which have been released.
+	for (auto it = workers.begin(); it != workers.end();)
+	{
+		if (!(*it)->isRunning())
+		{
+			delete *it;
+			it = workers.erase(it);
+		}
+		else
+			++it;
+	}
+
+	VideoStream *stream = nullptr;
+
+	try
+	{
+		stream = new TheoraVideoStream(file);
+	}
+	catch (love::Exception &)
+	{
+#ifdef LOVE_VIDEO_MEDIAFOUNDATION
+		// Anything other than Ogg Theora is left to the system's decoders.
+		file->seek(0);
+		stream = new mediafoundation::MFVideoStream(file);
+#else
+		throw;
+#endif
+	}
+
+	Worker *worker = new Worker(stream);
+	worker->start();
+	workers.push_back(worker);
+
 	return stream;
 }
 
@@ -56,8 +87,9 @@ const char *Video::getName() const
 	return "love.video.theora";
 }
 
-Worker::Worker()
-	: stopping(false)
+Worker::Worker(VideoStream *stream)
+	: stream(stream)
+	, stopping(false)
 {
 	threadName = "VideoWorker";
 }
@@ -67,19 +99,11 @@ Worker::~Worker()
 	stop();
 }
 
-void Worker::addStream(TheoraVideoStream *stream)
-{
-	love::thread::Lock l(mutex);
-	streams.push_back(stream);
-	cond->broadcast();
-}
-
 void Worker::stop()
 {
 	{
 		love::thread::Lock l(mutex);
 		stopping = true;
-		cond->broadcast();
 	}
 
 	owner->wait();
@@ -93,33 +117,24 @@ void Worker::threadFunction()
 	{
 		love::sleep(2);
 
-		love::thread::Lock l(mutex);
-
-		while (!stopping && streams.empty())
 		{
-			cond->wait(mutex);
-			lastFrame = love::timer::Timer::getTime();
+			love::thread::Lock l(mutex);
+			if (stopping)
+				return;
 		}
 
-		if (stopping)
+		if (stream->getReferenceCount() == 1)
+		{
+			// We're the only ones left
+			stream.set(nullptr);
 			return;
+		}
 
 		double curFrame = love::timer::Timer::getTime();
 		double dt = curFrame-lastFrame;
 		lastFrame = curFrame;
 
-		for (auto it = streams.begin(); it != streams.end(); ++it)
-		{
-			TheoraVideoStream *stream = *it;
-			if (stream->getReferenceCount() == 1)
-			{
-				// We're the only ones left
-				streams.erase(it);
-				break;
-			}
-
-			stream->threadedFillBackBuffer(dt);
-		}
+		stream->threadedDecode(dt);
 	}
 }
 
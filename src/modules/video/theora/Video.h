@@ -52,29 +52,26 @@ public:
 	VideoStream *newVideoStream(love::filesystem::File* file);
 
 private:
-	Worker *workerThread;
+	// One per stream, so streams don't hold each other up.
+	std::vector<Worker *> workers;
 }; // Video
 
 class Worker : public love::thread::Threadable
 {
 public:
-	Worker();
+	Worker(VideoStream *stream);
 	virtual ~Worker();
 
 	// Implements Threadable
 	void threadFunction();
 
-	void addStream(TheoraVideoStream *stream);
-	// Frees itself!
 	void stop();
 
 private:
 
-	std::vector<StrongRef<TheoraVideoStream>> streams;
+	StrongRef<VideoStream> stream;
 
 	love::thread::MutexRef mutex;
-	love::thread::ConditionalRef cond;
-
 	bool stopping;
 }; // Worker
 
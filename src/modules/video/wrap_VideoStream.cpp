@@ -66,6 +66,23 @@ int w_VideoStream_getFilename(lua_State *L)
 	return 1;
 }
 
+int w_VideoStream_setFrameQueueSize(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	int size = (int) luaL_checkinteger(L, 2);
+	if (size < 1)
+		return luaL_error(L, "Frame queue size must be at least 1.");
+	stream->setFrameQueueSize(size);
+	return 0;
+}
+
+int w_VideoStream_getFrameQueueSize(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getFrameQueueSize());
+	return 1;
+}
+
 int w_VideoStream_play(lua_State *L)
 {
 	auto stream = luax_checkvideostream(L, 1);
@@ -113,6 +130,8 @@ static const luaL_Reg videostream_functions[] =
 {
 	{ "setSync", w_VideoStream_setSync },
 	{ "getFilename", w_VideoStream_getFilename },
+	{ "setFrameQueueSize", w_VideoStream_setFrameQueueSize },
+	{ "getFrameQueueSize", w_VideoStream_getFrameQueueSize },
 	{ "play", w_VideoStream_play },
 	{ "pause", w_VideoStream_pause },
 	{ "seek", w_VideoStream_seek },
@@ -126,6 +126,9 @@ StringMap<Window::Setting, Window::SETTING_MAX_ENUM>::Entry Window::settingEntri
 	{"refreshrate", SETTING_REFRESHRATE},
 	{"x", SETTING_X},
 	{"y", SETTING_Y},
+	{"hidden", SETTING_HIDDEN},
+	{"framesinflight", SETTING_FRAMES_IN_FLIGHT},
+	{"lowlatency", SETTING_LOW_LATENCY},
 };
 
 StringMap<Window::Setting, Window::SETTING_MAX_ENUM> Window::settings(Window::settingEntries, sizeof(Window::settingEntries));
@@ -76,6 +76,9 @@ public:
 		SETTING_REFRESHRATE,
 		SETTING_X,
 		SETTING_Y,
+		SETTING_HIDDEN,
+		SETTING_FRAMES_IN_FLIGHT,
+		SETTING_LOW_LATENCY,
 		SETTING_MAX_ENUM
 	};
 
@@ -152,6 +155,14 @@ public:
 
 	virtual DisplayOrientation getDisplayOrientation(int displayindex) const = 0;
 
+	/**
+	 * Gets the range of refresh rates the window's display can vary between,
+	 * for displays with variable refresh rate (adaptive sync) support.
+	 * Returns false if the display doesn't support it, or if it can't be
+	 * determined on this platform.
+	 **/
+	virtual bool getVariableRefreshRateRange(double &minrate, double &maxrate) const = 0;
+
 	virtual std::vector<WindowSize> getFullscreenSizes(int displayindex) const = 0;
 
 	virtual void getDesktopDimensions(int displayindex, int &width, int &height) const = 0;
@@ -271,6 +282,9 @@ struct WindowSettings
 	bool useposition = false;
 	int x = 0;
 	int y = 0;
+	bool hidden = false;
+	int framesinflight = 2;
+	bool lowlatency = false;
 };
 
 } // window
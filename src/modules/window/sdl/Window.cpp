@@ -114,6 +114,9 @@ Window::~Window()
 void Window::setGraphics(graphics::Graphics *graphics)
 {
 	this->graphics.set(graphics);
+
+	if (graphics != nullptr)
+		graphics->setFrameLatency(settings.framesinflight, settings.lowlatency);
 }
 
 void Window::setGLFramebufferAttributes(bool sRGB)
@@ -574,6 +577,14 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 
 		if (this->settings.borderless != f.borderless)
 			SDL_SetWindowBordered(window, f.borderless ? SDL_FALSE : SDL_TRUE);
+
+		if (this->settings.hidden != f.hidden)
+		{
+			if (f.hidden)
+				SDL_HideWindow(window);
+			else
+				SDL_ShowWindow(window);
+		}
 	}
 	else
 	{
@@ -593,6 +604,9 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 		if (f.borderless)
 			 sdlflags |= SDL_WINDOW_BORDERLESS;
 
+		if (f.hidden)
+			sdlflags |= SDL_WINDOW_HIDDEN;
+
 		// Note: this flag is ignored on Windows.
 		 if (isHighDPIAllowed())
 			 sdlflags |= SDL_WINDOW_ALLOW_HIGHDPI;
@@ -615,10 +629,14 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 	if (this->settings.displayindex != f.displayindex || f.useposition || f.centered)
 		SDL_SetWindowPosition(window, x, y);
 
-	SDL_RaiseWindow(window);
+	if (!f.hidden)
+		SDL_RaiseWindow(window);
 
 	setVSync(f.vsync);
 
+	if (graphics.get())
+		graphics->setFrameLatency(f.framesinflight, f.lowlatency);
+
 	updateSettings(f, false);
 
 	windowRenderer = renderer;
@@ -740,6 +758,7 @@ void Window::updateSettings(const WindowSettings &newsettings, bool updateGraphi
 
 	settings.resizable = (wflags & SDL_WINDOW_RESIZABLE) != 0;
 	settings.borderless = (wflags & SDL_WINDOW_BORDERLESS) != 0;
+	settings.hidden = (wflags & SDL_WINDOW_HIDDEN) != 0;
 	settings.centered = newsettings.centered;
 
 	getPosition(settings.x, settings.y, settings.displayindex);
@@ -756,6 +775,17 @@ void Window::updateSettings(const WindowSettings &newsettings, bool updateGraphi
 
 	settings.vsync = getVSync();
 
+	if (graphics.get())
+	{
+		settings.framesinflight = graphics->getFramesInFlight();
+		settings.lowlatency = graphics->isLowLatency();
+	}
+	else
+	{
+		settings.framesinflight = newsettings.framesinflight;
+		settings.lowlatency = newsettings.lowlatency;
+	}
+
 	settings.stencil = newsettings.stencil;
 	settings.depth = newsettings.depth;
 
@@ -908,6 +938,22 @@ Window::DisplayOrientation Window::getDisplayOrientation(int displayindex) const
 	return ORIENTATION_UNKNOWN;
 }
 
+bool Window::getVariableRefreshRateRange(double &minrate, double &maxrate) const
+{
+	if (window == nullptr)
+		return false;
+
+#ifdef LOVE_MACOS
+	return love::macos::getWindowRefreshRateRange(window, minrate, maxrate);
+#else
+	// SDL doesn't expose adaptive sync support, and there's no portable way to
+	// query it on other platforms.
+	LOVE_UNUSED(minrate);
+	LOVE_UNUSED(maxrate);
+	return false;
+#endif
+}
+
 std::vector<Window::WindowSize> Window::getFullscreenSizes(int displayindex) const
 {
 	std::vector<WindowSize> sizes;
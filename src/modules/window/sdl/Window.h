@@ -61,6 +61,8 @@ public:
 
 	DisplayOrientation getDisplayOrientation(int displayindex) const override;
 
+	bool getVariableRefreshRateRange(double &minrate, double &maxrate) const override;
+
 	std::vector<WindowSize> getFullscreenSizes(int displayindex) const override;
 
 	void getDesktopDimensions(int displayindex, int &width, int &height) const override;
@@ -75,6 +75,9 @@ static int readWindowSettings(lua_State *L, int idx, WindowSettings &settings)
 	settings.borderless = luax_boolflag(L, idx, settingName(Window::SETTING_BORDERLESS), settings.borderless);
 	settings.centered = luax_boolflag(L, idx, settingName(Window::SETTING_CENTERED), settings.centered);
 	settings.usedpiscale = luax_boolflag(L, idx, settingName(Window::SETTING_USE_DPISCALE), settings.usedpiscale);
+	settings.hidden = luax_boolflag(L, idx, settingName(Window::SETTING_HIDDEN), settings.hidden);
+	settings.framesinflight = luax_intflag(L, idx, settingName(Window::SETTING_FRAMES_IN_FLIGHT), settings.framesinflight);
+	settings.lowlatency = luax_boolflag(L, idx, settingName(Window::SETTING_LOW_LATENCY), settings.lowlatency);
 
 	settings.displayindex = luax_intflag(L, idx, settingName(Window::SETTING_DISPLAYINDEX), settings.displayindex + 1) - 1;
 	lua_getfield(L, idx, settingName(Window::SETTING_DISPLAY));
@@ -231,6 +234,15 @@ int w_getMode(lua_State *L)
 	lua_pushinteger(L, settings.y);
 	lua_setfield(L, -2, settingName(Window::SETTING_Y));
 
+	luax_pushboolean(L, settings.hidden);
+	lua_setfield(L, -2, settingName(Window::SETTING_HIDDEN));
+
+	lua_pushinteger(L, settings.framesinflight);
+	lua_setfield(L, -2, settingName(Window::SETTING_FRAMES_IN_FLIGHT));
+
+	luax_pushboolean(L, settings.lowlatency);
+	lua_setfield(L, -2, settingName(Window::SETTING_LOW_LATENCY));
+
 	return 3;
 }
 
@@ -259,6 +271,21 @@ int w_getDisplayOrientation(lua_State *L)
 	return 1;
 }
 
+int w_getVariableRefreshRateRange(lua_State *L)
+{
+	double minrate = 0.0;
+	double maxrate = 0.0;
+	if (!instance()->getVariableRefreshRateRange(minrate, maxrate))
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_pushnumber(L, minrate);
+	lua_pushnumber(L, maxrate);
+	return 2;
+}
+
 int w_getFullscreenModes(lua_State *L)
 {
 	int displayindex = 0;
@@ -641,6 +668,7 @@ static const luaL_Reg functions[] =
 	{ "getMode", w_getMode },
 	{ "isHighDPIAllowed", w_isHighDPIAllowed },
 	{ "getDisplayOrientation", w_getDisplayOrientation },
+	{ "getVariableRefreshRateRange", w_getVariableRefreshRateRange },
 	{ "getFullscreenModes", w_getFullscreenModes },
 	{ "setFullscreen", w_setFullscreen },
 	{ "getFullscreen", w_getFullscreen },